@@ -122,6 +122,10 @@ class Field(common.SourceLocation):
         self.bindata_subtype = None  # type: unicode
         self.default = None  # type: unicode
 
+        # Properties specific to fields which are strings. An unowned string is stored as a
+        # StringData pointing into the BSON it was parsed from, which must outlive the struct.
+        self.unowned = False  # type: bool
+
         # Properties specific to fields which are structs.
         self.struct_type = None  # type: unicode
 
@@ -480,6 +480,14 @@ def _validate_doc_sequence_field(ctxt, ast_field):
         ctxt.add_bad_non_object_as_doc_sequence_error(ast_field, ast_field.name)
 
 
+def _validate_unowned_field(ctxt, ast_field):
+    # type: (errors.ParserContext, ast.Field) -> None
+    """Validate an unowned field is a string, or an array of strings."""
+    if ast_field.cpp_type != 'std::string' or ast_field.enum_type:
+        ctxt.add_bad_unowned_field_error(ast_field, ast_field.name, ast_field.cpp_type or
+                                         ast_field.struct_type)
+
+
 def _normalize_method_name(cpp_type_name, cpp_method_name):
     # type: (unicode, unicode) -> unicode
     """Normalize the method name to be fully-qualified with the type name."""
@@ -598,6 +606,10 @@ def _bind_field(ctxt, parsed_spec, field):
         # Validation doc_sequence types
         _validate_doc_sequence_field(ctxt, ast_field)
 
+    if field.unowned:
+        ast_field.unowned = True
+        _validate_unowned_field(ctxt, ast_field)
+
     return ast_field
 
 
@@ -277,6 +277,22 @@ class _CppTypeView(CppTypeBase):
         )
 
 
+class _CppTypeUnownedView(_CppTypeView):
+    """C++ View Type information for a view type stored as the view type itself."""
+
+    def __init__(self, field, view_type):
+        # type: (ast.Field, unicode) -> None
+        super(_CppTypeUnownedView, self).__init__(field, view_type, view_type)
+
+    def get_transform_to_storage_type(self, expression):
+        # type: (unicode) -> Optional[unicode]
+        return None
+
+    def get_setter_body(self, member_name):
+        # type: (unicode) -> unicode
+        return common.template_args('${member_name} = value;', member_name=member_name)
+
+
 class _CppTypeVector(CppTypeBase):
     """Base type for C++ Std::Vector Types information."""
 
@@ -505,7 +521,9 @@ def get_cpp_type(field):
 
     cpp_type_info = None  # type: Any
 
-    if field.cpp_type == 'std::string':
+    if field.cpp_type == 'std::string' and field.unowned:
+        cpp_type_info = _CppTypeUnownedView(field, 'StringData')
+    elif field.cpp_type == 'std::string':
         cpp_type_info = _CppTypeView(field, 'std::string', 'StringData')
     elif field.cpp_type == 'std::vector<std::uint8_t>':
         cpp_type_info = _CppTypeVector(field)
@@ -85,6 +85,7 @@ ERROR_ID_IS_NODE_VALID_INT = "ID0049"
 ERROR_ID_IS_NODE_VALID_NON_NEGATIVE_INT = "ID0050"
 ERROR_ID_IS_DUPLICATE_COMPARISON_ORDER = "ID0051"
 ERROR_ID_IS_COMMAND_TYPE_EXTRANEOUS = "ID0052"
+ERROR_ID_BAD_UNOWNED_FIELD = "ID0053"
 
 
 class IDLError(Exception):
@@ -665,6 +666,13 @@ class ParserContext(object):
             ("Command '%s' cannot have a 'type' property unless namespace equals 'type'.") %
             (command_name))
 
+    def add_bad_unowned_field_error(self, location, field_name, cpp_type):
+        # type: (common.SourceLocation, unicode, unicode) -> None
+        """Add an error about a field marked as unowned whose type is not a std::string."""
+        self._add_error(location, ERROR_ID_BAD_UNOWNED_FIELD,
+                        ("Field '%s' cannot be marked as unowned since its C++ type '%s' is not "
+                         "'std::string'.") % (field_name, cpp_type))
+
 
 def _assert_unique_error_messages():
     # type: () -> None
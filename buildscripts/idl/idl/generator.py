@@ -755,6 +755,9 @@ class _CppSourceFileWriter(_CppFileWriterBase):
                                     (_get_field_constant_name(field)))
             self._writer.write_line('const auto localObject = %s.Obj();' % (element_name))
             return '%s::parse(tempContext, localObject)' % (common.title_case(field.struct_type))
+        elif field.unowned:
+            # View the string in place instead of copying it out of the BSON.
+            return '%s.valueStringData()' % (element_name)
         elif field.deserializer and 'BSONElement::' in field.deserializer:
             method_name = writer.get_method_name(field.deserializer)
             return '%s.%s()' % (element_name, method_name)
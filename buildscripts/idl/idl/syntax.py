@@ -286,6 +286,7 @@ class Field(common.SourceLocation):
         self.default = None  # type: unicode
         self.supports_doc_sequence = False  # type: bool
         self.comparison_order = -1  # type: int
+        self.unowned = False  # type: bool
 
         # Internal fields - not generated by parser
         self.serialize_op_msg_request_only = False  # type: bool
@@ -1581,6 +1581,84 @@ class TestBinder(testcase.IDLTestcase):
                     field1: string
             """), idl.errors.ERROR_ID_UNKNOWN_TYPE)
 
+    def test_field_unowned_positive(self):
+        # type: () -> None
+        """Positive unowned field tests."""
+
+        test_preamble = textwrap.dedent("""
+        types:
+            string:
+                description: foo
+                cpp_type: std::string
+                bson_serialization_type: string
+                deserializer: foo
+        """)
+
+        # Strings, optional strings and arrays of strings can be unowned
+        self.assert_bind(test_preamble + textwrap.dedent("""
+            structs:
+                foo:
+                    description: foo
+                    fields:
+                        foo1:
+                            type: string
+                            unowned: true
+                        foo2:
+                            type: string
+                            optional: true
+                            unowned: true
+                        foo3:
+                            type: array<string>
+                            unowned: true
+            """))
+
+    def test_field_unowned_negative(self):
+        # type: () -> None
+        """Negative unowned field tests."""
+
+        test_preamble = textwrap.dedent("""
+        types:
+            string:
+                description: foo
+                cpp_type: std::string
+                bson_serialization_type: string
+                deserializer: foo
+
+            int:
+                description: foo
+                cpp_type: std::int32_t
+                bson_serialization_type: int
+                deserializer: foo
+        """)
+
+        # Only strings can be unowned
+        self.assert_bind_fail(test_preamble + textwrap.dedent("""
+            structs:
+                foo:
+                    description: foo
+                    fields:
+                        foo:
+                            type: int
+                            unowned: true
+            """), idl.errors.ERROR_ID_BAD_UNOWNED_FIELD)
+
+        # Structs are not strings, even when they only contain strings
+        self.assert_bind_fail(test_preamble + textwrap.dedent("""
+            structs:
+                bar:
+                    description: foo
+                    fields:
+                        foo: string
+
+                foo:
+                    description: foo
+                    fields:
+                        foo:
+                            type: bar
+                            unowned: true
+            """), idl.errors.ERROR_ID_BAD_UNOWNED_FIELD)
+
+
 
 if __name__ == '__main__':
 
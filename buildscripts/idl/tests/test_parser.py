@@ -1037,6 +1037,39 @@ class TestParser(testcase.IDLTestcase):
                         supports_doc_sequence: foo
             """), idl.errors.ERROR_ID_IS_NODE_VALID_BOOL)
 
+    def test_field_unowned_positive(self):
+        # type: () -> None
+        """Positive unowned test cases."""
+
+        # unowned can be false or true
+        for unowned in ['false', 'true']:
+            self.assert_parse(
+                textwrap.dedent("""
+            structs:
+                foo:
+                    description: foo
+                    fields:
+                        foo:
+                            type: string
+                            unowned: %s
+                """ % (unowned)))
+
+    def test_field_unowned_negative(self):
+        # type: () -> None
+        """Negative unowned test cases."""
+
+        # unowned must be a bool
+        self.assert_parse_fail(
+            textwrap.dedent("""
+        structs:
+            foo:
+                description: foo
+                fields:
+                    foo:
+                        type: string
+                        unowned: foo
+            """), idl.errors.ERROR_ID_IS_NODE_VALID_BOOL)
+
     def test_command_type_positive(self):
         # type: () -> None
         """Positive command custom type test cases."""
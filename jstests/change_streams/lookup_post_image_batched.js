@@ -0,0 +1,58 @@
+// Tests that update events read together by a change stream with fullDocument: "updateLookup" are
+// returned in order, each with the current version of its own document.
+//
+// The $changeStream stage is not allowed within a $facet stage.
+// @tags: [do_not_wrap_aggregations_in_facets]
+(function() {
+    "use strict";
+
+    load("jstests/libs/collection_drop_recreate.js");  // For assert[Drop|Create]Collection.
+
+    const coll = assertDropAndRecreateCollection(db, "change_post_image_batched");
+    const changeStream = coll.watch([], {fullDocument: "updateLookup"});
+
+    // Make all of the writes before reading any events, so that the updates are available to be
+    // looked up together.
+    for (let i = 0; i < 5; i++) {
+        assert.writeOK(coll.insert({_id: i, x: 0}));
+    }
+    for (let i = 0; i < 5; i++) {
+        assert.writeOK(coll.update({_id: i}, {$inc: {x: 1}}));
+    }
+    assert.writeOK(coll.update({_id: 0}, {$inc: {x: 1}}));
+    assert.writeOK(coll.remove({_id: 4}));
+
+    function nextChange() {
+        assert.soon(() => changeStream.hasNext());
+        return changeStream.next();
+    }
+
+    for (let i = 0; i < 5; i++) {
+        const change = nextChange();
+        assert.eq("insert", change.operationType, tojson(change));
+        assert.eq({_id: i, x: 0}, change.fullDocument, tojson(change));
+    }
+
+    // Each update carries the latest version of its document, or null once it has been deleted.
+    const expectedPostImages = [
+        {_id: 0, x: 2},
+        {_id: 1, x: 1},
+        {_id: 2, x: 1},
+        {_id: 3, x: 1},
+        null,
+        {_id: 0, x: 2}
+    ];
+    const expectedKeys = [0, 1, 2, 3, 4, 0];
+    for (let i = 0; i < expectedKeys.length; i++) {
+        const change = nextChange();
+        assert.eq("update", change.operationType, tojson(change));
+        assert.eq(expectedKeys[i], change.documentKey._id, tojson(change));
+        assert.eq(expectedPostImages[i], change.fullDocument, tojson(change));
+    }
+
+    const change = nextChange();
+    assert.eq("delete", change.operationType, tojson(change));
+    assert.eq(4, change.documentKey._id, tojson(change));
+
+    changeStream.close();
+})();
@@ -0,0 +1,73 @@
+// Tests that the analyze command gathers statistics on a collection's indexes, and that the planner
+// uses them to pick a clearly cheaper plan without a trial run.
+// @tags: [
+//   assumes_against_mongod_not_mongos,
+//   assumes_unsharded_collection,
+//   does_not_support_stepdowns,
+//   incompatible_with_embedded,
+//   requires_fastcount,
+// ]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    var coll = db.analyze_cardinality;
+    coll.drop();
+
+    // 'a' is 0 in almost every document, while 'b' is unique.
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({a: i < 990 ? 0 : i, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    var query = {a: 0, b: {$gte: 10, $lt: 15}};
+    function explainQuery() {
+        var explain = coll.find(query).explain();
+        assert.commandWorked(explain);
+        return explain.queryPlanner;
+    }
+
+    // Without statistics, the candidate plans are compared in a trial run.
+    var queryPlanner = explainQuery();
+    assert.eq(1, queryPlanner.rejectedPlans.length, tojson(queryPlanner));
+
+    var res = assert.commandWorked(db.runCommand({analyze: coll.getName()}));
+    assert.eq(1000, res.sampledDocuments, tojson(res));
+    var indexStats = {};
+    res.indexes.forEach(function(index) {
+        indexStats[index.name] = index;
+    });
+    assert.eq(1, indexStats.a_1.keysPerDocument, tojson(res));
+    assert.eq(11, indexStats.a_1.leadingField.distinctValues, tojson(res));
+    assert.eq(1000, indexStats.b_1.leadingField.distinctValues, tojson(res));
+    assert(indexStats._id_, tojson(res));
+
+    // With statistics, the plan on 'b' is picked outright.
+    queryPlanner = explainQuery();
+    assert.eq(0, queryPlanner.rejectedPlans.length, tojson(queryPlanner));
+    var ixscan = getPlanStage(queryPlanner.winningPlan, "IXSCAN");
+    assert.eq({b: 1}, ixscan.keyPattern, tojson(queryPlanner));
+    assert.eq(5, coll.find(query).itcount());
+
+    // A close call still runs a trial.
+    assert.eq(1, coll.find({a: 0, b: {$gte: 0}}).explain().queryPlanner.rejectedPlans.length);
+
+    // Statistics are dropped with their index.
+    assert.commandWorked(coll.dropIndex({b: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+    queryPlanner = explainQuery();
+    assert.eq(1, queryPlanner.rejectedPlans.length, tojson(queryPlanner));
+
+    // A smaller sample can be requested.
+    res = assert.commandWorked(db.runCommand({analyze: coll.getName(), sampleSize: 100}));
+    assert.eq(100, res.sampledDocuments, tojson(res));
+
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), sampleSize: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(db.runCommand({analyze: "analyze_cardinality_missing"}),
+                                 ErrorCodes.NamespaceNotFound);
+})();
@@ -0,0 +1,42 @@
+// Tests the "min" and "max" _id bounds of the dbHash command.
+// @tags: [incompatible_with_embedded]
+(function() {
+    "use strict";
+
+    var testDB = db.getSiblingDB("dbhash_range");
+    assert.commandWorked(testDB.dropDatabase());
+    var coll = testDB.coll;
+    for (var i = 0; i < 20; i++) {
+        assert.writeOK(coll.insert({_id: i, x: i}));
+    }
+
+    function collHash(range) {
+        var res = testDB.runCommand(Object.extend({dbHash: 1, collections: ["coll"]}, range));
+        assert.commandWorked(res);
+        return res.collections.coll;
+    }
+
+    // Bounds that cover the whole collection hash the same as no bounds at all.
+    var fullHash = collHash({});
+    assert.eq(fullHash, collHash({min: {_id: MinKey}, max: {_id: MaxKey}}));
+    assert.eq(fullHash, collHash({min: {_id: 0}}));
+
+    // The bounds are [min, max), so adjacent ranges don't overlap.
+    var lowHash = collHash({max: {_id: 10}});
+    var highHash = collHash({min: {_id: 10}});
+    assert.neq(lowHash, highHash);
+    assert.neq(fullHash, lowHash);
+    assert.eq(lowHash, collHash({min: {_id: 0}, max: {_id: 10}}));
+
+    // Writes outside a range leave its hash unchanged.
+    assert.writeOK(coll.insert({_id: 100}));
+    assert.writeOK(coll.update({_id: 15}, {$set: {x: -1}}));
+    assert.eq(lowHash, collHash({max: {_id: 10}}));
+    assert.neq(highHash, collHash({min: {_id: 10}}));
+
+    // A bound must be a document with only an _id field.
+    assert.commandFailedWithCode(
+        testDB.runCommand({dbHash: 1, collections: ["coll"], min: {x: 1}}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(testDB.runCommand({dbHash: 1, collections: ["coll"], max: 1}),
+                                 ErrorCodes.BadValue);
+})();
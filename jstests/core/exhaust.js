@@ -23,4 +23,23 @@
         assert.eq(e.code, 18526);
     }
 
+    // The streamed batches return every document once and in order, with or without a limit.
+    const sorted = c.find().sort({a: 1}).toArray();
+    [1, 2, 3, 10].forEach(function(batchSize) {
+        [0, 3].forEach(function(limit) {
+            try {
+                const docs = c.find()
+                                 .sort({a: 1})
+                                 .batchSize(batchSize)
+                                 .limit(limit)
+                                 .addOption(DBQuery.Option.exhaust)
+                                 .toArray();
+                const expected = limit ? sorted.slice(0, limit) : sorted;
+                assert.eq(expected, docs, tojson({batchSize: batchSize, limit: limit}));
+            } catch (e) {
+                assert.eq(e.code, 18526);
+            }
+        });
+    });
+
 }());
@@ -0,0 +1,29 @@
+// Tests that explain reports a 'queryHash' which identifies the query's shape.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    "use strict";
+
+    const coll = db.jstests_explain_query_hash;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+    assert.writeOK(coll.insert({a: 1, b: 1}));
+
+    function getQueryHash(filter, sort) {
+        const explain = assert.commandWorked(coll.find(filter).sort(sort).explain());
+        assert(explain.queryPlanner.hasOwnProperty("queryHash"), tojson(explain));
+        const queryHash = explain.queryPlanner.queryHash;
+        assert.eq("string", typeof queryHash, tojson(explain));
+        assert.eq(16, queryHash.length, tojson(explain));
+        return queryHash;
+    }
+
+    // Queries which differ only in their constants have the same shape.
+    const hash = getQueryHash({a: 1, b: 1}, {});
+    assert.eq(hash, getQueryHash({a: 5, b: "foo"}, {}));
+
+    // Changing the predicates or the sort changes the shape.
+    assert.neq(hash, getQueryHash({a: 1}, {}));
+    assert.neq(hash, getQueryHash({a: 1, b: 1}, {a: 1}));
+})();
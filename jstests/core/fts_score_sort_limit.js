@@ -0,0 +1,58 @@
+// Test that a text score sort with a limit returns the same documents and scores as sorting all of
+// the results, when the text stage only computes the top scoring documents.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    var t = db.getSiblingDB("test").getCollection("fts_score_sort_limit");
+    t.drop();
+
+    var words = ["alpha", "beta", "gamma", "delta"];
+    for (var i = 0; i < 200; i++) {
+        var text = [];
+        for (var j = 0; j < words.length; j++) {
+            for (var k = 0; k < (i * (j + 3)) % 7; k++) {
+                text.push(words[j]);
+            }
+        }
+        text.push("filler" + i);
+        assert.writeOK(t.insert({_id: i, a: text.join(" ")}));
+    }
+    assert.commandWorked(t.ensureIndex({a: "text"}));
+
+    function topScores(search, limit) {
+        var cursor = t.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+                         .sort({score: {$meta: "textScore"}});
+        if (limit) {
+            cursor = cursor.limit(limit);
+        }
+        return cursor.toArray().map(function(doc) {
+            return doc.score;
+        });
+    }
+
+    ["alpha", "alpha beta", "beta gamma delta"].forEach(function(search) {
+        [1, 5, 20].forEach(function(limit) {
+            assert.eq(topScores(search).slice(0, limit), topScores(search, limit), search);
+        });
+    });
+
+    // The text stage should only be asked for the top scoring documents when nothing between it
+    // and the sort can discard results.
+    var explain = t.find({$text: {$search: "alpha beta"}}, {score: {$meta: "textScore"}})
+                      .sort({score: {$meta: "textScore"}})
+                      .limit(5)
+                      .explain("executionStats");
+    var textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    assert.neq(null, textOr, tojson(explain));
+    assert.eq(5, textOr.topK, tojson(explain));
+
+    explain = t.find({$text: {$search: "alpha -beta"}}, {score: {$meta: "textScore"}})
+                  .sort({score: {$meta: "textScore"}})
+                  .limit(5)
+                  .explain("executionStats");
+    textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    assert.neq(null, textOr, tojson(explain));
+    assert(!textOr.hasOwnProperty("topK"), tojson(explain));
+}());
@@ -0,0 +1,37 @@
+// Tests that a batch insert containing failing documents inserts every other document, reports the
+// errors at the right indexes, and for an ordered insert stops at the first error.
+(function() {
+    "use strict";
+
+    var coll = db.insert_batch_errors;
+    var docs = [];
+    for (var i = 0; i < 200; i++) {
+        docs.push({_id: i});
+    }
+    // Duplicate the _ids at indexes 10, 11 and 150.
+    docs[11] = {_id: 10};
+    docs[150] = {_id: 149};
+    docs.push({_id: 0});
+
+    // Unordered: everything except the duplicates is inserted.
+    coll.drop();
+    var res = db.runCommand({insert: coll.getName(), documents: docs, ordered: false});
+    assert.commandWorked(res);
+    assert.eq(docs.length - 3, res.n, tojson(res));
+    assert.eq([11, 150, 200],
+              res.writeErrors.map(function(err) {
+                  assert.eq(ErrorCodes.DuplicateKey, err.code, tojson(err));
+                  return err.index;
+              }));
+    assert.eq(docs.length - 3, coll.count());
+
+    // Ordered: everything before the first duplicate is inserted, and nothing after it.
+    coll.drop();
+    res = db.runCommand({insert: coll.getName(), documents: docs, ordered: true});
+    assert.commandWorked(res);
+    assert.eq(11, res.n, tojson(res));
+    assert.eq(1, res.writeErrors.length, tojson(res));
+    assert.eq(11, res.writeErrors[0].index, tojson(res));
+    assert.eq(11, coll.count());
+    assert.eq(0, coll.find({_id: {$gt: 10}}).itcount());
+})();
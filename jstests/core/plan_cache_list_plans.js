@@ -106,4 +106,14 @@
         }
         assert(plans[i].reason.stats.hasOwnProperty('stage'), 'no stats inserted for plan ' + i);
     }
+
+    // The shape's planning history lists the winning plan, and no replans have happened yet.
+    let res = t.runCommand('planCacheListPlans',
+                           {query: {a: 3, b: 3}, sort: {a: -1}, projection: {_id: 0, a: 1}});
+    assert.commandWorked(res);
+    assert(res.hasOwnProperty('history'), 'history missing from planCacheListPlans');
+    assert.eq(0, res.history.replans, tojson(res.history));
+    assert.eq(0, res.history.flips, tojson(res.history));
+    assert.eq(1, res.history.winners.length, tojson(res.history));
+    assert.eq(plans[0].details.solution, res.history.winners[0].solution, tojson(res.history));
 })();
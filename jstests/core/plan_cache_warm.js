@@ -0,0 +1,56 @@
+// Test populating the plan cache with the planCacheWarm command, using shapes produced by
+// planCacheListQueryShapes.
+//
+// @tags: [
+//   # This test attempts to perform queries and introspect/manipulate the server's plan cache
+//   # entries. The former operation may be routed to a secondary in the replica set, whereas the
+//   # latter must be routed to the primary.
+//   assumes_read_preference_unchanged,
+//   does_not_support_stepdowns,
+// ]
+(function() {
+    "use strict";
+
+    const t = db.jstests_plan_cache_warm;
+    t.drop();
+
+    assert.writeOK(t.insert({a: 1, b: 1}));
+    assert.writeOK(t.insert({a: 1, b: 2}));
+    assert.writeOK(t.insert({a: 2, b: 2}));
+
+    // We need two indices so that the MultiPlanRunner is executed.
+    assert.commandWorked(t.createIndex({a: 1}));
+    assert.commandWorked(t.createIndex({a: 1, b: 1}));
+
+    // Populate the cache with two shapes and save them.
+    assert.eq(1, t.find({a: 1, b: 1}).itcount());
+    assert.eq(2, t.find({a: 1}).sort({b: 1}).itcount());
+    const shapes = t.getPlanCache().listQueryShapes();
+    assert.eq(2, shapes.length, tojson(shapes));
+
+    // Warming an empty cache re-creates both entries.
+    t.getPlanCache().clear();
+    assert.eq(0, t.getPlanCache().listQueryShapes().length);
+    let res = t.getPlanCache().warm(shapes);
+    assert.eq(2, res.warmed, tojson(res));
+    assert.eq(0, res.alreadyCached, tojson(res));
+    assert.sameMembers(shapes, t.getPlanCache().listQueryShapes());
+
+    // Shapes that are already cached are left alone.
+    res = t.getPlanCache().warm(shapes);
+    assert.eq(0, res.warmed, tojson(res));
+    assert.eq(2, res.alreadyCached, tojson(res));
+
+    // A shape with a single candidate plan is planned but not cached.
+    res = assert.commandWorked(
+        t.runCommand("planCacheWarm", {shapes: [{query: {b: 1}, sort: {}, projection: {}}]}));
+    assert.eq(1, res.notCached, tojson(res));
+    assert.eq(2, t.getPlanCache().listQueryShapes().length);
+
+    // A malformed shape fails the command without warming the other shapes.
+    t.getPlanCache().clear();
+    assert.commandFailedWithCode(
+        t.runCommand("planCacheWarm", {shapes: [shapes[0], {query: 1}]}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(t.runCommand("planCacheWarm", {shapes: {}}), ErrorCodes.BadValue);
+    assert.eq(0, t.getPlanCache().listQueryShapes().length);
+})();
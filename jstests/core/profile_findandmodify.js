@@ -116,6 +116,30 @@
     assert.eq(profileObj.planSummary, "IDHACK", tojson(profileObj));
     assert.eq(profileObj.appName, "MongoDB Shell", tojson(profileObj));
 
+    //
+    // Idhack update and remove as findAndModify with projection.
+    //
+    coll.drop();
+    for (var i = 0; i < 3; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+
+    assert.eq({a: 3},
+              coll.findAndModify(
+                  {query: {_id: 2}, update: {$inc: {a: 1}}, fields: {_id: 0, a: 1}, new: true}));
+    profileObj = getLatestProfilerEntry(testDB);
+    assert.eq(profileObj.keysExamined, 1, tojson(profileObj));
+    assert.eq(profileObj.docsExamined, 1, tojson(profileObj));
+    assert.eq(profileObj.nModified, 1, tojson(profileObj));
+    assert.eq(profileObj.planSummary, "IDHACK", tojson(profileObj));
+
+    assert.eq({_id: 1}, coll.findAndModify({query: {_id: 1}, remove: true, fields: {a: 0}}));
+    profileObj = getLatestProfilerEntry(testDB);
+    assert.eq(profileObj.keysExamined, 1, tojson(profileObj));
+    assert.eq(profileObj.docsExamined, 1, tojson(profileObj));
+    assert.eq(profileObj.ndeleted, 1, tojson(profileObj));
+    assert.eq(profileObj.planSummary, "IDHACK", tojson(profileObj));
+
     //
     // Update as findAndModify with projection.
     //
@@ -0,0 +1,40 @@
+// @tags: [
+//     does_not_support_stepdowns,
+//     # Uses $where operator
+//     requires_scripting,
+// ]
+
+// Confirms that a profiled $where query reports the time spent compiling and running JavaScript.
+
+(function() {
+    "use strict";
+
+    // For getLatestProfilerEntry.
+    load("jstests/libs/profiler.js");
+
+    var testDB = db.getSiblingDB("profile_where");
+    assert.commandWorked(testDB.dropDatabase());
+    var coll = testDB.getCollection("test");
+
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({a: i}));
+    }
+
+    testDB.setProfilingLevel(2);
+
+    // The function is busy for a while on each document, so its execution time can't round down
+    // to zero.
+    var where = "var x = 0; for (var j = 0; j < 1000; j++) { x += j; } return this.a % 2 == 0;";
+    assert.eq(50, coll.find({$where: where}).itcount());
+    var profileObj = getLatestProfilerEntry(testDB, {op: "query"});
+    assert.gt(profileObj.jsExecutionMicros, 0, tojson(profileObj));
+    if (profileObj.hasOwnProperty("jsCompileMicros")) {
+        assert.gt(profileObj.jsCompileMicros, 0, tojson(profileObj));
+    }
+
+    // Queries without JavaScript report neither.
+    assert.eq(1, coll.find({a: 1}).itcount());
+    profileObj = getLatestProfilerEntry(testDB, {op: "query"});
+    assert(!profileObj.hasOwnProperty("jsCompileMicros"), tojson(profileObj));
+    assert(!profileObj.hasOwnProperty("jsExecutionMicros"), tojson(profileObj));
+})();
@@ -107,6 +107,7 @@
         addShard: {skip: isUnrelated},
         addShardToZone: {skip: isUnrelated},
         aggregate: {command: {aggregate: "view", pipeline: [{$match: {}}], cursor: {}}},
+        analyze: {command: {analyze: "view"}, expectFailure: true, skipSharded: true},
         appendOplogNote: {skip: isUnrelated},
         applyOps: {
             command: {applyOps: [{op: "i", o: {_id: 1}, ns: "test.view"}]},
@@ -407,9 +408,15 @@
         planCacheListQueryShapes:
             {command: {planCacheListQueryShapes: "view"}, expectFailure: true},
         planCacheSetFilter: {command: {planCacheSetFilter: "view"}, expectFailure: true},
+        planCacheWarm: {command: {planCacheWarm: "view", shapes: []}, expectFailure: true},
         prepareTransaction: {skip: isUnrelated},
         profile: {skip: isUnrelated},
         refreshLogicalSessionCacheNow: {skip: isAnInternalCommand},
+        refreshMaterializedView: {
+            command: {refreshMaterializedView: "view"},
+            expectFailure: true,
+            expectedErrorCode: ErrorCodes.InvalidOptions
+        },
         reapLogicalSessionCacheNow: {skip: isAnInternalCommand},
         refreshSessions: {skip: isUnrelated},
         refreshSessionsInternal: {skip: isAnInternalCommand},
@@ -0,0 +1,75 @@
+// Test that a wildcard index answers equality and range predicates on any path beneath its prefix
+// with the same results as a collection scan, and that documents stay correctly indexed across
+// updates and removes.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    var t = db.getSiblingDB("test").getCollection("wildcard_index_basic");
+    t.drop();
+
+    var colors = ["red", "green", "blue"];
+    for (var i = 0; i < 100; i++) {
+        var attrs = {size: i % 10, color: colors[i % 3], dims: {h: i % 7, w: [i % 4, i % 5]}};
+        if (i % 2 === 0) {
+            attrs.tags = ["t" + (i % 3), {k: i % 6}];
+        }
+        if (i % 11 === 0) {
+            attrs = i;
+        }
+        assert.writeOK(t.insert({_id: i, attrs: attrs, other: i}));
+    }
+    assert.writeOK(t.insert({_id: 100}));
+    assert.commandWorked(t.createIndex({attrs: "wildcard"}));
+
+    function assertUsesWildcardIndex(query) {
+        var explain = t.find(query).explain();
+        var ixscan = getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+        assert.neq(null, ixscan, tojson(explain));
+        assert.eq("attrs_wildcard", ixscan.indexName, tojson(ixscan));
+        assert(ixscan.keyPattern.hasOwnProperty("$_path"), tojson(ixscan));
+    }
+
+    function assertSameResults(query) {
+        var indexed = t.find(query).sort({_id: 1}).toArray();
+        var scanned = t.find(query).sort({_id: 1}).hint({$natural: 1}).toArray();
+        assert.eq(scanned, indexed, tojson(query));
+    }
+
+    [{"attrs.color": "red"},
+     {"attrs.size": {$gte: 3, $lt: 6}},
+     {"attrs.dims.h": {$in: [1, 2]}},
+     {"attrs.dims.w": 3},
+     {"attrs.tags": "t1"},
+     {"attrs.tags.k": {$gt: 3}},
+     {"attrs.tags": {$elemMatch: {k: {$gte: 2, $lte: 4}}}},
+     {"attrs.color": "blue", "attrs.size": {$lte: 4}},
+     {attrs: {$lt: 50}},
+    ].forEach(function(query) {
+        assertUsesWildcardIndex(query);
+        assertSameResults(query);
+    });
+
+    // Predicates which could match documents without keys for the path must not use the index.
+    [{"attrs.color": null}, {"attrs.tags": {$exists: true}}, {"attrs.size": {$ne: 3}}].forEach(
+        function(query) {
+            var explain = t.find(query).explain();
+            assert(isCollscan(db, explain.queryPlanner.winningPlan), tojson(explain));
+            assertSameResults(query);
+        });
+
+    // Updates move documents between paths and values.
+    assert.writeOK(t.update({_id: 1}, {$set: {"attrs.color": "purple", "attrs.extra.x": 1}}));
+    assert.writeOK(t.update({_id: 2}, {$unset: {"attrs.color": 1}}));
+    assert.writeOK(t.remove({_id: 4}));
+    [{"attrs.color": "purple"}, {"attrs.extra.x": 1}, {"attrs.color": colors[2]}].forEach(
+        function(query) {
+            assertUsesWildcardIndex(query);
+            assertSameResults(query);
+        });
+
+    // A wildcard index has only one field and cannot be unique.
+    assert.commandFailed(t.createIndex({attrs: "wildcard", other: 1}));
+    assert.commandFailed(t.createIndex({other: "wildcard"}, {unique: true}));
+})();
@@ -0,0 +1,94 @@
+// Tests that change streams served from the shared oplog buffer return the same events, and the
+// same resume tokens, as change streams reading the oplog with their own cursors.
+// This test uses the WiredTiger storage engine, which does not support running without journaling.
+// @tags: [requires_replication,requires_journaling]
+(function() {
+    "use strict";
+    load("jstests/replsets/rslib.js");  // For startSetIfSupportsReadMajority.
+
+    const rst = new ReplSetTest({
+        nodes: 1,
+        nodeOptions: {
+            setParameter: {
+                internalChangeStreamUseSharedOplogReader: true,
+                // Keep the buffer small so that slower streams fall behind it and must read the
+                // gap from the oplog themselves.
+                internalChangeStreamSharedOplogBufferMaxBytes: 4 * 1024,
+            }
+        }
+    });
+    if (!startSetIfSupportsReadMajority(rst)) {
+        jsTestLog("Skipping test since storage engine doesn't support majority read concern.");
+        rst.stopSet();
+        return;
+    }
+    rst.initiate();
+
+    const db = rst.getPrimary().getDB(jsTestName());
+    const kNumCollections = 5;
+    const kNumDocs = 50;
+
+    function readEvents(cursor, count) {
+        const events = [];
+        assert.soon(() => {
+            while (events.length < count && cursor.hasNext()) {
+                events.push(cursor.next());
+            }
+            return events.length === count;
+        });
+        return events;
+    }
+
+    // Open one stream per collection, then interleave writes across all of them.
+    const streams = [];
+    for (let i = 0; i < kNumCollections; ++i) {
+        assert.commandWorked(db.createCollection("coll" + i));
+        streams.push(db["coll" + i].watch());
+    }
+    for (let j = 0; j < kNumDocs; ++j) {
+        for (let i = 0; i < kNumCollections; ++i) {
+            assert.writeOK(db["coll" + i].insert({_id: j, pad: "x".repeat(100)}));
+        }
+    }
+
+    // Drain the streams one at a time, so that the later ones have fallen behind the buffer.
+    const firstTokens = [];
+    for (let i = 0; i < kNumCollections; ++i) {
+        const events = readEvents(streams[i], kNumDocs);
+        for (let j = 0; j < kNumDocs; ++j) {
+            assert.eq(events[j].operationType, "insert", tojson(events[j]));
+            assert.eq(events[j].ns, {db: db.getName(), coll: "coll" + i}, tojson(events[j]));
+            assert.eq(events[j].documentKey, {_id: j}, tojson(events[j]));
+        }
+        assert(!streams[i].hasNext());
+        firstTokens.push(events[0]._id);
+    }
+
+    // Resuming from a token returns the events which followed it, whether or not the shared
+    // reader is in use.
+    for (let useShared of [true, false]) {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalChangeStreamUseSharedOplogReader: useShared}));
+        for (let i = 0; i < kNumCollections; ++i) {
+            const cursor = db["coll" + i].watch([], {resumeAfter: firstTokens[i]});
+            const events = readEvents(cursor, kNumDocs - 1);
+            assert.eq(events[0].documentKey, {_id: 1}, tojson(events[0]));
+            assert.eq(events[kNumDocs - 2].documentKey, {_id: kNumDocs - 1});
+            cursor.close();
+        }
+    }
+
+    // A stream which has fallen behind the buffer, to a point which is no longer in the oplog,
+    // fails instead of silently skipping the lost events. The streams above have moved the buffer
+    // past the start of the oplog.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalChangeStreamUseSharedOplogReader: true}));
+    assert.commandFailedWithCode(db.runCommand({
+        aggregate: "coll0",
+        pipeline: [{$changeStream: {startAtOperationTime: Timestamp(1, 0)}}],
+        cursor: {}
+    }),
+                                 ErrorCodes.ChangeStreamHistoryLost);
+
+    rst.stopSet();
+}());
@@ -0,0 +1,50 @@
+/**
+ * Tests that concurrent $inc updates of the same document may be combined into fewer writes when
+ * internalUpdateCoalesceIncrements is enabled, without losing increments or changing what each
+ * update reports.
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest(
+        {nodes: 1, nodeOptions: {setParameter: {internalUpdateCoalesceIncrements: true}}});
+    rst.startSet();
+    rst.initiate();
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    assert.commandWorked(testDB.counters.insert({_id: "hot", n: 0, m: NumberLong(0)}));
+
+    // Every update reports that it matched and modified the counter.
+    const kNumShells = 4;
+    const kNumWrites = 250;
+    let shells = [];
+    for (let i = 0; i < kNumShells; ++i) {
+        shells.push(startParallelShell(
+            "for (let j = 0; j < " + kNumWrites + "; ++j) {" +
+                "    const res = db.getSiblingDB('test').counters.update(" +
+                "        {_id: 'hot'}, {$inc: {n: 1, m: NumberLong(2)}});" +
+                "    assert.writeOK(res);" +
+                "    assert.eq(1, res.nMatched, tojson(res));" +
+                "    assert.eq(1, res.nModified, tojson(res));" +
+                "}",
+            primary.port));
+    }
+    shells.forEach((awaitShell) => awaitShell());
+
+    const doc = testDB.counters.findOne({_id: "hot"});
+    assert.eq(kNumShells * kNumWrites, doc.n, tojson(doc));
+    assert.eq(NumberLong(2 * kNumShells * kNumWrites), doc.m, tojson(doc));
+
+    // Combined updates replicate as one oplog entry each.
+    const oplogEntries =
+        primary.getDB("local").oplog.rs.find({ns: "test.counters", op: "u", "o2._id": "hot"});
+    assert.lte(oplogEntries.itcount(), kNumShells * kNumWrites);
+
+    // An update of a missing document matches nothing, alone or combined.
+    const res = testDB.counters.update({_id: "missing"}, {$inc: {n: 1}});
+    assert.writeOK(res);
+    assert.eq(0, res.nMatched, tojson(res));
+    assert.eq(null, testDB.counters.findOne({_id: "missing"}));
+
+    rst.stopSet();
+}());
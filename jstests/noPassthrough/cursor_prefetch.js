@@ -0,0 +1,69 @@
+// Tests that with "cursorPrefetchBytes" set, find cursors read ahead between getMores without
+// changing the results, and that the prefetched results are accounted for in serverStatus.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {cursorPrefetchBytes: 1024 * 1024}});
+    const db = conn.getDB("test");
+    const coll = db.cursor_prefetch;
+    coll.drop();
+
+    const numDocs = 1000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i, x: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+
+    function prefetchMetrics() {
+        return db.serverStatus().metrics.cursor.prefetch;
+    }
+
+    // Iterating in small batches, pausing between them, returns every document in order.
+    const before = prefetchMetrics();
+    let res = assert.commandWorked(
+        db.runCommand({find: coll.getName(), sort: {_id: 1}, batchSize: 10}));
+    let cursorId = res.cursor.id;
+    let docs = res.cursor.firstBatch;
+    while (cursorId != 0) {
+        sleep(5);
+        res = assert.commandWorked(
+            db.runCommand({getMore: cursorId, collection: coll.getName(), batchSize: 10}));
+        cursorId = res.cursor.id;
+        docs = docs.concat(res.cursor.nextBatch);
+    }
+    assert.eq(numDocs, docs.length);
+    docs.forEach(function(doc, i) {
+        assert.eq(i, doc._id, tojson(doc));
+    });
+
+    const after = prefetchMetrics();
+    assert.gt(after.docs, before.docs, tojson(after));
+    assert.gt(after.hits, before.hits, tojson(after));
+    assert.gt(after.docsReturned, before.docsReturned, tojson(after));
+
+    // A cursor killed while it may be prefetching is gone afterwards.
+    res = assert.commandWorked(db.runCommand({find: coll.getName(), filter: {x: 3}, batchSize: 2}));
+    assert.neq(0, res.cursor.id);
+    assert.commandWorked(db.runCommand({killCursors: coll.getName(), cursors: [res.cursor.id]}));
+    assert.commandFailedWithCode(
+        db.runCommand({getMore: res.cursor.id, collection: coll.getName()}),
+        ErrorCodes.CursorNotFound);
+
+    // Tailable cursors are never prefetched.
+    const capped = db.cursor_prefetch_capped;
+    capped.drop();
+    assert.commandWorked(db.createCollection(capped.getName(), {capped: true, size: 1024 * 1024}));
+    for (let i = 0; i < 20; i++) {
+        assert.writeOK(capped.insert({_id: i}));
+    }
+    const beforeTailable = prefetchMetrics();
+    res = assert.commandWorked(
+        db.runCommand({find: capped.getName(), tailable: true, batchSize: 5}));
+    res = assert.commandWorked(
+        db.runCommand({getMore: res.cursor.id, collection: capped.getName(), batchSize: 5}));
+    assert.eq(5, res.cursor.nextBatch.length);
+    assert.eq(beforeTailable.docs, prefetchMetrics().docs);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,53 @@
+// Tests that the inMemory storage engine supports committed reads, but keeps nothing across a
+// restart and writes no data files to the dbpath.
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var buildEngines = conn.getDB("admin").serverBuildInfo().storageEngines;
+    MongoRunner.stopMongod(conn);
+    if (!Array.contains(buildEngines, "inMemory")) {
+        jsTestLog("Skipping test because this build does not include the inMemory storage engine");
+        return;
+    }
+
+    var dbpath = MongoRunner.dataPath + "in_memory_storage_engine";
+    resetDbpath(dbpath);
+
+    var options = {
+        storageEngine: "inMemory",
+        inMemorySizeGB: 0.25,
+        dbpath: dbpath,
+        noCleanData: true,
+    };
+    conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, "mongod failed to start with the inMemory storage engine");
+
+    var testDB = conn.getDB("test");
+    var engine = testDB.serverStatus().storageEngine;
+    assert.eq("inMemory", engine.name, tojson(engine));
+    assert.eq(false, engine.persistent, tojson(engine));
+    assert.eq(true, engine.supportsCommittedReads, tojson(engine));
+
+    assert.writeOK(testDB.coll.insert({_id: 1}));
+    assert.commandWorked(testDB.coll.createIndex({a: 1}));
+    assert.eq(1, testDB.coll.find({a: {$exists: false}}).itcount());
+
+    // No WiredTiger data files or journal are written.
+    var files = listFiles(dbpath).map(function(file) {
+        return file.baseName;
+    });
+    files.forEach(function(file) {
+        assert(!/\.wt$/.test(file), "unexpected data file " + file + ": " + tojson(files));
+    });
+    assert(!Array.contains(files, "journal"), tojson(files));
+
+    MongoRunner.stopMongod(conn);
+
+    // Restarting an inMemory node starts from an empty data set.
+    conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, "mongod failed to restart with the inMemory storage engine");
+    assert.eq(0, conn.getDB("test").coll.find().itcount());
+    MongoRunner.stopMongod(conn);
+}());
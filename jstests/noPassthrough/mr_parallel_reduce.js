@@ -0,0 +1,56 @@
+// Tests that a mapReduce whose in-memory map is reduced on several threads returns the same
+// results as one reduced on the command's own scope.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: {mapReduceReduceThreads: 4}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var db = conn.getDB("test");
+    var coll = db.mr_parallel_reduce;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 20000; i++) {
+        bulk.insert({key: i % 50, value: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    var map = function() {
+        emit(this.key, {count: 1, total: this.value * multiplier});
+    };
+    var reduce = function(key, values) {
+        var out = {count: 0, total: 0};
+        values.forEach(function(value) {
+            out.count += value.count;
+            out.total += value.total;
+        });
+        return out;
+    };
+
+    function runMapReduce() {
+        var res = db.runCommand({
+            mapReduce: coll.getName(),
+            map: map,
+            reduce: reduce,
+            out: {inline: 1},
+            scope: {multiplier: 2}
+        });
+        assert.commandWorked(res);
+        return res.results.sort(function(a, b) {
+            return a._id - b._id;
+        });
+    }
+
+    var parallel = runMapReduce();
+    assert.eq(50, parallel.length, tojson(parallel));
+    parallel.forEach(function(result) {
+        assert.eq(400, result.value.count, tojson(result));
+    });
+
+    assert.commandWorked(db.adminCommand({setParameter: 1, mapReduceReduceThreads: 1}));
+    assert.eq(runMapReduce(), parallel);
+
+    assert.commandFailed(db.adminCommand({setParameter: 1, mapReduceReduceThreads: 0}));
+
+    MongoRunner.stopMongod(conn);
+})();
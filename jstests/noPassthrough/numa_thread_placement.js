@@ -0,0 +1,31 @@
+// Tests that numaThreadPlacement places connection threads on NUMA nodes, and that serverStatus
+// reports the threads on each node.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: {numaThreadPlacement: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var db = conn.getDB("test");
+
+    var numa = db.serverStatus().numa;
+    assert(numa.enabled, tojson(numa));
+    assert.gte(numa.nodes.length, 1, tojson(numa));
+
+    // Placement is only implemented on Linux. Elsewhere every attempt fails and is counted.
+    if (numa.failedPlacements === 0) {
+        var connections = numa.nodes.reduce(function(total, node) {
+            assert.gt(node.cpus, 0, tojson(node));
+            return total + node.connections;
+        }, 0);
+        // The shell's connection runs on a thread of its own in the default service executor.
+        assert.gte(connections, 1, tojson(numa));
+    }
+
+    MongoRunner.stopMongod(conn);
+
+    // Placement is off by default.
+    conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    assert(!conn.getDB("test").serverStatus().numa.enabled);
+    MongoRunner.stopMongod(conn);
+})();
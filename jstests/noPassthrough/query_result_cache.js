@@ -0,0 +1,44 @@
+// Tests that repeated finds on a collection listed in "queryResultCacheNamespaces" are answered
+// from the query result cache, and that writes to the collection invalidate the cached results.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: {queryResultCacheNamespaces: "test.coll"}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var db = conn.getDB("test");
+    var coll = db.coll;
+    var otherColl = db.other;
+
+    function cacheHits() {
+        return db.serverStatus().metrics.queryResultCache.hits;
+    }
+
+    assert.writeOK(coll.insert([{_id: 1, a: 1}, {_id: 2, a: 1}, {_id: 3, a: 2}]));
+    assert.writeOK(otherColl.insert({_id: 1, a: 1}));
+
+    // The second identical find is a hit and returns the same documents.
+    var hits = cacheHits();
+    assert.eq(2, coll.find({a: 1}).itcount());
+    assert.eq(hits, cacheHits());
+    assert.eq(2, coll.find({a: 1}).itcount());
+    assert.eq(hits + 1, cacheHits());
+
+    // A write to the collection invalidates its results.
+    assert.writeOK(coll.insert({_id: 4, a: 1}));
+    assert.eq(3, coll.find({a: 1}).itcount());
+    assert.eq(hits + 1, cacheHits());
+    assert.eq(3, coll.find({a: 1}).itcount());
+    assert.eq(hits + 2, cacheHits());
+
+    // Collections that were not opted in are never cached.
+    otherColl.find({a: 1}).itcount();
+    otherColl.find({a: 1}).itcount();
+    assert.eq(hits + 2, cacheHits());
+
+    // The set of cached namespaces can be changed at runtime.
+    assert.commandWorked(db.adminCommand({setParameter: 1, queryResultCacheNamespaces: ""}));
+    coll.find({a: 1}).itcount();
+    assert.eq(hits + 2, cacheHits());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,73 @@
+// Tests creating a time-series collection, inserting measurements into it, querying them back with
+// filters on the time and meta fields, and dropping it.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    const testDB = conn.getDB("timeseries_basic");
+    const coll = testDB.weather;
+    const bucketsColl = testDB.getCollection("system.buckets.weather");
+
+    assert.commandFailedWithCode(
+        testDB.createCollection("bad", {timeseries: {metaField: "station"}}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        testDB.createCollection("bad", {timeseries: {timeField: "t"}, capped: true, size: 100}),
+        ErrorCodes.InvalidOptions);
+
+    assert.commandWorked(testDB.createCollection(
+        coll.getName(), {timeseries: {timeField: "t", metaField: "station"}}));
+    const bucketIndexes = bucketsColl.getIndexes();
+    assert(bucketIndexes.some(function(index) {
+        return bsonWoCompare(index.key, {meta: 1, "control.min.t": 1, "control.max.t": 1}) === 0;
+    }),
+           tojson(bucketIndexes));
+
+    // Two stations reporting every minute for three hours.
+    const start = ISODate("2018-06-01T00:00:00Z");
+    const minute = 60 * 1000;
+    const docs = [];
+    for (let i = 0; i < 180; i++) {
+        ["north", "south"].forEach(function(station) {
+            docs.push({t: new Date(start.getTime() + i * minute), station: station, temp: i});
+        });
+    }
+    assert.commandWorked(coll.insert(docs, {ordered: false}));
+    assert.eq(docs.length, coll.find().itcount());
+
+    // The measurements are grouped into one bucket per station and hour.
+    assert.eq(6, bucketsColl.find().itcount());
+
+    const secondHour = {
+        $gte: new Date(start.getTime() + 60 * minute),
+        $lt: new Date(start.getTime() + 120 * minute)
+    };
+    assert.eq(120, coll.find({t: secondHour}).itcount());
+    assert.eq(60, coll.find({t: secondHour, station: "north"}).itcount());
+    const doc = coll.findOne({t: new Date(start.getTime() + 90 * minute), station: "south"});
+    assert.eq(90, doc.temp, tojson(doc));
+    assert.eq("south", doc.station, tojson(doc));
+
+    // The filter on the measurements selects the buckets to read, too.
+    const explain = coll.explain("executionStats").find({t: secondHour, station: "north"}).finish();
+    const stages = explain.stages || [explain];
+    const cursorStats = stages[0].$cursor.executionStats;
+    assert.eq(1, cursorStats.nReturned, tojson(explain));
+
+    // Measurements must have a date as their time.
+    let res = coll.insert([{t: 1}, {t: new Date(), station: "east"}], {ordered: true});
+    assert.writeErrorWithCode(res, ErrorCodes.BadValue);
+    assert.eq(0, coll.find({station: "east"}).itcount());
+    res = coll.insert([{station: "west"}, {t: new Date(), station: "west"}], {ordered: false});
+    assert.writeErrorWithCode(res, ErrorCodes.BadValue);
+    assert.eq(1, coll.find({station: "west"}).itcount());
+
+    // Dropping the collection drops its buckets.
+    assert(coll.drop());
+    assert.eq(null, testDB.getCollectionInfos({name: bucketsColl.getName()})[0]);
+    assert.commandWorked(testDB.createCollection(coll.getName(), {timeseries: {timeField: "t"}}));
+    assert.commandWorked(coll.insert({t: start, temp: 1}));
+    assert.eq([{t: start, temp: 1}], coll.find({}, {_id: 0}).toArray());
+
+    MongoRunner.stopMongod(conn);
+})();
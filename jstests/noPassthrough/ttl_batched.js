@@ -0,0 +1,51 @@
+// Test that the TTL monitor deletes in bounded batches, taking turns between TTL indexes, and
+// reports its progress on each index in serverStatus.
+(function() {
+    "use strict";
+    // Launch mongod with a short TTL monitor sleep interval and small batches.
+    var runner = MongoRunner.runMongod(
+        {setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorBatchSize: 7}});
+    var db = runner.getDB("test");
+    var collA = db.ttl_batched_a;
+    var collB = db.ttl_batched_b;
+    collA.drop();
+    collB.drop();
+
+    var past = new Date(0);
+    var bulkA = collA.initializeUnorderedBulkOp();
+    var bulkB = collB.initializeUnorderedBulkOp();
+    for (var i = 0; i < 50; i++) {
+        bulkA.insert({x: past});
+        bulkB.insert({x: past});
+    }
+    bulkA.insert({x: new Date(), keep: true});
+    bulkB.insert({x: new Date(), keep: true});
+    assert.writeOK(bulkA.execute());
+    assert.writeOK(bulkB.execute());
+
+    assert.commandWorked(collA.createIndex({x: 1}, {expireAfterSeconds: 3600}));
+    assert.commandWorked(collB.createIndex({x: 1}, {expireAfterSeconds: 3600}));
+
+    // A single pass deletes every expired document, even though each turn is bounded.
+    assert.soon(function() {
+        return collA.count() === 1 && collB.count() === 1;
+    }, "TTL monitor didn't delete the expired documents before timing out.");
+    assert.eq(1, collA.find({keep: true}).itcount());
+    assert.eq(1, collB.find({keep: true}).itcount());
+
+    // Both indexes are reported, with no backlog left.
+    var ttlPass = db.serverStatus().metrics.ttl.passes;
+    assert.soon(function() {
+        return db.serverStatus().metrics.ttl.passes >= ttlPass + 1;
+    }, "TTL monitor didn't run before timing out.");
+    var indexes = db.serverStatus().metrics.ttl.indexes;
+    [collA, collB].forEach(function(coll) {
+        var entry = indexes.find(function(index) {
+            return index.ns === coll.getFullName() && index.name === "x_1";
+        });
+        assert(entry, tojson(indexes));
+        assert.eq(0, entry.backlog, tojson(entry));
+    });
+
+    MongoRunner.stopMongod(runner);
+})();
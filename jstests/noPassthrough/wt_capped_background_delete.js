@@ -0,0 +1,44 @@
+// Tests that with wiredTigerCappedDeleteInBackground, a capped collection limited by size is
+// brought back under its size by the background capped deleter, and that inserts keep succeeding
+// meanwhile.
+(function() {
+    "use strict";
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTestLog("Skipping test because storageEngine is not wiredTiger");
+        return;
+    }
+
+    var conn = MongoRunner.runMongod({setParameter: {wiredTigerCappedDeleteInBackground: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var db = conn.getDB("test");
+
+    var maxSize = 1024 * 1024;
+    assert.commandWorked(db.createCollection("capped", {capped: true, size: maxSize}));
+    var coll = db.capped;
+
+    var padding = "x".repeat(1024);
+    for (var i = 0; i < 5000; i++) {
+        assert.writeOK(coll.insert({_id: i, padding: padding}));
+    }
+
+    // The oldest documents go and the newest stay.
+    assert.soon(function() {
+        return coll.stats().size <= maxSize;
+    }, function() {
+        return "capped collection was not trimmed: " + tojson(coll.stats());
+    });
+    assert.eq(1, coll.find({_id: 4999}).itcount());
+    assert.eq(0, coll.find({_id: 0}).itcount());
+
+    // Documents remain in insertion order with no gaps.
+    var ids = coll.find().sort({$natural: 1}).toArray().map(function(doc) {
+        return doc._id;
+    });
+    assert.eq(4999, ids[ids.length - 1]);
+    for (var j = 1; j < ids.length; j++) {
+        assert.eq(ids[j - 1] + 1, ids[j]);
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
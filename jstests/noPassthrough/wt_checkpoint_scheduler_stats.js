@@ -0,0 +1,40 @@
+/**
+ * Tests that the WiredTiger checkpoint thread reports its scheduling statistics in serverStatus,
+ * and that the early checkpoint parameters are validated.
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({syncdelay: 1});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+
+    function schedulerStats() {
+        const stats = assert.commandWorked(testDB.serverStatus()).wiredTiger.checkpointScheduler;
+        assert.neq(undefined, stats, "missing wiredTiger.checkpointScheduler in serverStatus");
+        return stats;
+    }
+
+    assert.writeOK(testDB.coll.insert({a: "x".repeat(1024)}));
+
+    const before = schedulerStats();
+    assert.soon(() => {
+        const stats = schedulerStats();
+        return stats.scheduledCheckpoints > before.scheduledCheckpoints &&
+            stats.totalBytesWritten > 0;
+    }, () => "periodic checkpoints were not reported: " + tojson(schedulerStats()));
+
+    const stats = schedulerStats();
+    assert.eq(0, stats.earlyCheckpoints, tojson(stats));
+    assert.gte(stats.totalDurationMillis, stats.lastDurationMillis, tojson(stats));
+
+    assert.commandFailed(
+        testDB.adminCommand({setParameter: 1, wiredTigerCheckpointTargetDurationSecs: -1}));
+    assert.commandFailed(
+        testDB.adminCommand({setParameter: 1, wiredTigerCheckpointMinIntervalSecs: 0}));
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, wiredTigerCheckpointTargetDurationSecs: 5}));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,58 @@
+/**
+ * Tests that $collStats reports the WiredTiger cache residency of a collection and its indexes
+ * once the cache statistics sampler is enabled.
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.wt_coll_stats_cache_stats;
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i, padding: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    function cacheStats() {
+        const res = coll.aggregate([{$collStats: {cacheStats: {}}}]).toArray();
+        assert.eq(1, res.length, tojson(res));
+        return res[0].cacheStats;
+    }
+
+    // The sampler is off by default, so there is nothing to report beyond the empty index map.
+    let stats = cacheStats();
+    assert.eq(undefined, stats.bytesInCache, tojson(stats));
+    assert.eq({}, stats.indexDetails, tojson(stats));
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, wiredTigerCacheStatsSampleIntervalSecs: 1}));
+
+    assert.soon(() => {
+        stats = cacheStats();
+        return stats.bytesInCache !== undefined && stats.indexDetails._id_ !== undefined &&
+            stats.indexDetails.a_1 !== undefined;
+    }, () => "cache stats were never sampled: " + tojson(stats));
+
+    assert.gt(stats.bytesInCache, 0, tojson(stats));
+    assert.gt(stats.indexDetails.a_1.bytesInCache, 0, tojson(stats));
+    for (let field of ["pagesReadIntoCache", "pagesEvicted", "pagesEvictedPerSec"]) {
+        assert.gte(stats[field], 0, tojson(stats));
+    }
+
+    assert.commandFailedWithCode(
+        testDB.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$collStats: {cacheStats: 1}}], cursor: {}}),
+        50858);
+
+    // Turning the sampler off discards the samples it has taken.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, wiredTigerCacheStatsSampleIntervalSecs: 0}));
+    assert.soon(() => cacheStats().bytesInCache === undefined);
+
+    MongoRunner.stopMongod(conn);
+}());
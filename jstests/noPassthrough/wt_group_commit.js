@@ -0,0 +1,56 @@
+/**
+ * Tests that journaled writes from concurrent clients are group committed, and that the group
+ * commit statistics are reported in serverStatus.
+ * @tags: [requires_wiredtiger, requires_journaling]
+ */
+(function() {
+    "use strict";
+
+    const conn =
+        MongoRunner.runMongod({setParameter: {wiredTigerGroupCommitMaxWindowMicros: 2000}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+
+    function groupCommitStats() {
+        const stats = assert.commandWorked(testDB.serverStatus()).wiredTiger.groupCommit;
+        assert.neq(undefined, stats, "missing wiredTiger.groupCommit in serverStatus");
+        return stats;
+    }
+
+    const before = groupCommitStats();
+    for (let field of ["flushes", "waiters", "lastBatchSize", "avgFlushMicros", "windowMicros"]) {
+        assert(before.hasOwnProperty(field), tojson(before));
+    }
+
+    // Every flush covers at least the caller that issued it.
+    assert.writeOK(testDB.coll.insert({_id: "single"}, {writeConcern: {j: true}}));
+    let after = groupCommitStats();
+    assert.gt(after.flushes, before.flushes, tojson(after));
+    assert.gte(after.waiters - before.waiters, after.flushes - before.flushes, tojson(after));
+
+    // Journaled writes from several connections at once all succeed and are durable.
+    const kNumShells = 4;
+    const kNumWrites = 200;
+    let shells = [];
+    for (let i = 0; i < kNumShells; ++i) {
+        shells.push(startParallelShell(
+            "for (let j = 0; j < " + kNumWrites + "; ++j) {" +
+                "    assert.writeOK(db.getSiblingDB('test').coll.insert(" +
+                "        {shell: " + i + ", j: j}, {writeConcern: {j: true}}));" +
+                "}",
+            conn.port));
+    }
+    shells.forEach((awaitShell) => awaitShell());
+
+    assert.eq(kNumShells * kNumWrites, testDB.coll.find({shell: {$exists: true}}).itcount());
+    after = groupCommitStats();
+    assert.gte(after.waiters - before.waiters, kNumShells * kNumWrites, tojson(after));
+
+    // Disabling the window is allowed at runtime.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, wiredTigerGroupCommitMaxWindowMicros: 0}));
+    assert.writeOK(testDB.coll.insert({_id: "noWindow"}, {writeConcern: {j: true}}));
+    assert.eq(0, groupCommitStats().windowMicros);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,44 @@
+/**
+ * Tests that a primary reports how long oplog writes take to become visible to oplog readers in
+ * serverStatus.
+ * @tags: [requires_wiredtiger, requires_replication]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+
+    function visibilityStats() {
+        const stats = assert.commandWorked(testDB.serverStatus()).wiredTiger.oplogVisibility;
+        assert.neq(undefined, stats, "missing wiredTiger.oplogVisibility in serverStatus");
+        return stats;
+    }
+
+    function histogramTotal(stats) {
+        return Object.keys(stats.latencyHistogram)
+            .map(bucket => stats.latencyHistogram[bucket])
+            .reduce((a, b) => a + b, 0);
+    }
+
+    const before = visibilityStats();
+    assert.eq(before.refreshes, histogramTotal(before), tojson(before));
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(testDB.coll.insert({_id: i}));
+    }
+
+    // Tailing the oplog waits for every earlier write to become visible.
+    const oplog = primary.getDB("local").oplog.rs;
+    assert.gte(oplog.find({ns: "test.coll"}).itcount(), 100);
+
+    const after = visibilityStats();
+    assert.gt(after.refreshes, before.refreshes, tojson(after));
+    assert.gte(after.totalLatencyMicros, before.totalLatencyMicros, tojson(after));
+    assert.eq(after.refreshes, histogramTotal(after), tojson(after));
+
+    rst.stopSet();
+}());
@@ -0,0 +1,55 @@
+/**
+ * Tests that collections can be created with the WiredTiger zstd block compressor, and that their
+ * data is readable after a restart. The compressor is only available in builds against the system
+ * zstd library, so the test is a no-op elsewhere.
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    "use strict";
+
+    const dbpath = MongoRunner.dataPath + "wt_zstd_block_compressor";
+    resetDbpath(dbpath);
+
+    let conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, "mongod was unable to start up");
+    let testDB = conn.getDB("test");
+
+    const res = testDB.createCollection(
+        "zstd", {storageEngine: {wiredTiger: {configString: "block_compressor=zstd"}}});
+    if (!res.ok) {
+        jsTestLog("Skipping test because this build has no zstd compressor: " + tojson(res));
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    const doc = {a: "x".repeat(1000), b: [1, 2, 3]};
+    const bulk = testDB.zstd.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert(Object.extend({_id: i}, doc));
+    }
+    assert.writeOK(bulk.execute());
+
+    const stats = assert.commandWorked(testDB.runCommand({collStats: "zstd"}));
+    assert(stats.wiredTiger.creationString.includes("block_compressor=zstd"), tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, "mongod was unable to restart");
+    testDB = conn.getDB("test");
+
+    assert.eq(1000, testDB.zstd.find().itcount());
+    assert.eq(doc.a, testDB.zstd.findOne({_id: 500}).a);
+
+    // zstd is also accepted as the default collection compressor.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(
+        {dbpath: dbpath, noCleanData: true, wiredTigerCollectionBlockCompressor: "zstd"});
+    assert.neq(null, conn, "mongod was unable to start with zstd as the default compressor");
+    testDB = conn.getDB("test");
+    assert.commandWorked(testDB.createCollection("zstdDefault"));
+    const defaultStats = assert.commandWorked(testDB.runCommand({collStats: "zstdDefault"}));
+    assert(defaultStats.wiredTiger.creationString.includes("block_compressor=zstd"),
+           tojson(defaultStats));
+
+    MongoRunner.stopMongod(conn);
+}());
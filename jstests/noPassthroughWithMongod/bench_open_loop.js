@@ -0,0 +1,52 @@
+// Tests the "targetOpsPerSecond" and "reportIntervalSecs" options to benchRun(), and the latency
+// percentiles it reports.
+(function() {
+    "use strict";
+
+    var coll = db.bench_open_loop;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 1, x: 1}));
+
+    var benchArgs = {
+        ops: [{op: "findOne", ns: coll.getFullName(), query: {_id: 1}, readCmd: true}],
+        parallel: 2,
+        seconds: 4,
+        targetOpsPerSecond: 50,
+        reportIntervalSecs: 1,
+        host: db.getMongo().host
+    };
+    if (jsTest.options().auth) {
+        benchArgs['db'] = 'admin';
+        benchArgs['username'] = jsTest.options().authUser;
+        benchArgs['password'] = jsTest.options().authPassword;
+    }
+    var res = benchRun(benchArgs);
+
+    // The workers issue operations on a schedule instead of as fast as they can.
+    assert.eq(50, res["targetOps/s"], tojson(res));
+    assert.gt(res.findOne, 25, tojson(res));
+    assert.lt(res.findOne, 75, tojson(res));
+
+    var percentiles = res.findOneLatencyPercentilesMicros;
+    assert(percentiles, tojson(res));
+    assert.lte(percentiles.p50, percentiles.p90, tojson(percentiles));
+    assert.lte(percentiles.p90, percentiles.p99, tojson(percentiles));
+    assert.lte(percentiles.p99, percentiles.p99_9, tojson(percentiles));
+    assert.lte(percentiles.p99_9, percentiles.max, tojson(percentiles));
+
+    // Every operation falls into exactly one reporting interval.
+    assert.gte(res.intervals.length, 4, tojson(res));
+    var intervalOps = 0;
+    res.intervals.forEach(function(interval, i) {
+        assert.eq(i, interval.startSecs, tojson(interval));
+        assert.lte(interval.latencyPercentilesMicros.p50,
+                   interval.latencyPercentilesMicros.max,
+                   tojson(interval));
+        intervalOps += interval.totalOps;
+    });
+    assert.eq(res.totalOps, intervalOps, tojson(res));
+
+    assert.throws(function() {
+        benchRun(Object.extend(Object.extend({}, benchArgs), {targetOpsPerSecond: -1}));
+    });
+})();
@@ -0,0 +1,77 @@
+// Test that a blocking sort in a find command spills to disk when 'allowDiskUse' is set, instead of
+// failing once it exceeds the internal sort memory limit.
+//
+// Note that this test sets the server parameter "internalQueryExecMaxBlockingSortBytes", and
+// restores the original value of the parameter before exiting.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    // Spilling a blocking sort requires document-level locking.
+    if (db.serverStatus().storageEngine.name === "mmapv1") {
+        return;
+    }
+
+    var coll = db.find_sort_allow_disk_use;
+    coll.drop();
+
+    // Set the internal sort memory limit to 1MB.
+    var result = db.adminCommand({getParameter: 1, internalQueryExecMaxBlockingSortBytes: 1});
+    assert.commandWorked(result);
+    var oldSortLimit = result.internalQueryExecMaxBlockingSortBytes;
+    var newSortLimit = 1024 * 1024;
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryExecMaxBlockingSortBytes: newSortLimit}));
+
+    try {
+        // Insert ~3MB of data.
+        var largeStr = new Array(32 * 1024).join('x');
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 100; ++i) {
+            bulk.insert({_id: i, a: largeStr, b: 99 - i});
+        }
+        assert.writeOK(bulk.execute());
+
+        // Without 'allowDiskUse', the unindexed sort fails.
+        assert.commandFailed(coll.runCommand("find", {sort: {b: 1}}));
+
+        // With 'allowDiskUse', the results come back fully sorted.
+        function checkSorted(cmdExtra, expectedCount) {
+            var cmd = Object.extend({sort: {b: 1}, batchSize: 1000, allowDiskUse: true}, cmdExtra);
+            var res = coll.runCommand("find", cmd);
+            assert.commandWorked(res);
+            var cursor = new DBCommandCursor(db, res);
+            var docs = cursor.toArray();
+            assert.eq(expectedCount, docs.length);
+            for (var i = 0; i < docs.length; ++i) {
+                assert.eq(i, docs[i].b, tojson(docs[i].b));
+            }
+        }
+        checkSorted({}, 100);
+
+        // A top-K sort whose K results do not fit in memory also spills.
+        checkSorted({limit: 80}, 80);
+
+        // Explain reports that the sort stage spilled.
+        var explain = db.runCommand({
+            explain: {find: coll.getName(), sort: {b: 1}, allowDiskUse: true},
+            verbosity: "executionStats"
+        });
+        assert.commandWorked(explain);
+        var sortStage = getPlanStage(explain.executionStats.executionStages, "SORT");
+        assert.neq(null, sortStage, tojson(explain));
+        assert.eq(true, sortStage.usedDisk, tojson(sortStage));
+        assert.gt(sortStage.spilledBytes, 0, tojson(sortStage));
+        // The documents are highly compressible.
+        assert.gt(sortStage.spilledBytesUncompressed, sortStage.spilledBytes, tojson(sortStage));
+        assert.eq(0, sortStage.spillMergePasses, tojson(sortStage));
+        assert.gt(sortStage.spills, 0, tojson(sortStage));
+        assert.gt(sortStage.peakMemUsage, 0, tojson(sortStage));
+        assert.lte(sortStage.peakMemUsage, 2 * newSortLimit, tojson(sortStage));
+    } finally {
+        // Restore the orginal sort memory limit.
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryExecMaxBlockingSortBytes: oldSortLimit}));
+    }
+}());
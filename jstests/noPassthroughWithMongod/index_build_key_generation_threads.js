@@ -0,0 +1,59 @@
+// Tests that foreground builds of several indexes produce the same indexes when their keys are
+// generated on several threads, and that the 'keyGenerationThreads' option is validated.
+(function() {
+    "use strict";
+
+    const coll = db.index_build_key_generation_threads;
+    coll.drop();
+
+    const kNumDocs = 5000;
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumDocs; ++i) {
+        bulk.insert({_id: i, a: i % 100, b: [i, -i], c: "str" + i, d: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+
+    const indexes = [
+        {key: {a: 1}, name: "a_1"},
+        {key: {b: 1}, name: "b_1"},
+        {key: {c: 1, a: -1}, name: "c_1_a_-1"},
+        {key: {a: 1, b: 1}, name: "partial", partialFilterExpression: {d: 1}},
+        {key: {c: "hashed"}, name: "c_hashed"},
+    ];
+    assert.commandWorked(
+        db.runCommand({createIndexes: coll.getName(), indexes: indexes, keyGenerationThreads: 3}));
+
+    const validateRes = assert.commandWorked(coll.validate(true));
+    assert(validateRes.valid, tojson(validateRes));
+
+    assert.eq(kNumDocs, coll.find({a: {$gte: 0}}).hint("a_1").itcount());
+    assert.eq(2 * kNumDocs - 1, coll.find().hint("b_1").returnKey().itcount());
+    assert.eq(kNumDocs, coll.find({c: {$gte: ""}}).hint("c_1_a_-1").itcount());
+    assert.eq(kNumDocs / 2, coll.find({d: 1, a: {$gte: 0}}).hint("partial").itcount());
+    assert.eq(1, coll.find({c: "str42"}).hint("c_hashed").itcount());
+
+    // The index on the array field is marked multikey.
+    const explain = coll.find({b: 5}).hint("b_1").explain();
+    assert(tojson(explain).indexOf('"isMultiKey" : true') >= 0, tojson(explain));
+
+    // Key generation errors fail the build.
+    assert.writeOK(coll.insert({_id: "parallel", a: [1, 2], b: [1, 2]}));
+    assert.commandFailedWithCode(db.runCommand({
+        createIndexes: coll.getName(),
+        indexes: [{key: {a: 1, b: 1}, name: "parallelArrays"}, {key: {d: 1}, name: "d_1"}],
+        keyGenerationThreads: 2
+    }),
+                                 ErrorCodes.CannotIndexParallelArrays);
+
+    for (let invalid of [0, -1, 65, "2"]) {
+        assert.commandFailedWithCode(db.runCommand({
+            createIndexes: coll.getName(),
+            indexes: [{key: {d: 1}, name: "d_1"}],
+            keyGenerationThreads: invalid
+        }),
+                                     ErrorCodes.BadValue);
+    }
+
+    assert.commandFailedWithCode(
+        db.adminCommand({setParameter: 1, indexBuildKeyGenerationThreads: 0}), ErrorCodes.BadValue);
+}());
@@ -0,0 +1,96 @@
+// Test that a localField/foreignField $lookup returns the same results when it joins against an
+// in-memory hash table of the foreign collection as when it queries the foreign collection once
+// per input document.
+//
+// Note that this test sets the server parameter "internalDocumentSourceLookupHashJoinMaxSizeBytes",
+// and restores the original value of the parameter before exiting.
+(function() {
+    "use strict";
+
+    const local = db.lookup_hash_join_local;
+    const foreign = db.lookup_hash_join_foreign;
+    local.drop();
+    foreign.drop();
+
+    assert.writeOK(local.insert([
+        {_id: 0, a: 1},
+        {_id: 1, a: [1, 2, 2]},
+        {_id: 2, a: null},
+        {_id: 3},
+        {_id: 4, a: "x"},
+        {_id: 5, a: [[1, 2]]},
+        {_id: 6, a: {c: 1}},
+        {_id: 7, a: 3},
+        {_id: 8, a: NumberLong(2)},
+    ]));
+    assert.writeOK(foreign.insert([
+        {_id: 0, b: 1, c: 1},
+        {_id: 1, b: [1, 2], c: 2},
+        {_id: 2, b: 2, c: 3},
+        {_id: 3, c: 4},
+        {_id: 4, b: null, c: 5},
+        {_id: 5, b: "x", c: 6},
+        {_id: 6, b: {c: 1}, c: 7},
+        {_id: 7, b: [[1, 2]], c: 8},
+        {_id: 8, b: 2.0, c: 9},
+    ]));
+
+    const result =
+        db.adminCommand({getParameter: 1, internalDocumentSourceLookupHashJoinMaxSizeBytes: 1});
+    assert.commandWorked(result);
+    const oldMaxSize = result.internalDocumentSourceLookupHashJoinMaxSizeBytes;
+
+    function setMaxSize(maxSize) {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalDocumentSourceLookupHashJoinMaxSizeBytes: maxSize}));
+    }
+
+    // Sorts each joined array by _id, since the strategies may return matches in different orders.
+    function runLookup(pipeline) {
+        return local.aggregate(pipeline).toArray().map(function(doc) {
+            if (Array.isArray(doc.joined)) {
+                doc.joined.sort((x, y) => x._id - y._id);
+            }
+            return doc;
+        });
+    }
+
+    const pipelines = [
+        [
+          {$lookup: {from: foreign.getName(), localField: "a", foreignField: "b", as: "joined"}},
+          {$sort: {_id: 1}}
+        ],
+        [
+          {$sort: {_id: 1}},
+          {$lookup: {from: foreign.getName(), localField: "a", foreignField: "b", as: "joined"}},
+          {$unwind: "$joined"},
+          {$match: {"joined.c": {$gt: 1}}},
+          {$sort: {_id: 1, "joined._id": 1}}
+        ],
+        [
+          {$sort: {_id: 1}},
+          {$lookup: {from: foreign.getName(), localField: "a", foreignField: "b", as: "joined"}},
+          {$unwind: {path: "$joined", preserveNullAndEmptyArrays: true}},
+          {$sort: {_id: 1, "joined._id": 1}}
+        ],
+    ];
+
+    try {
+        setMaxSize(0);
+        const expected = pipelines.map(runLookup);
+
+        // With a table large enough to hold the foreign collection, the results are unchanged.
+        setMaxSize(16 * 1024 * 1024);
+        pipelines.forEach(function(pipeline, i) {
+            assert.eq(expected[i], runLookup(pipeline), tojson(pipeline));
+        });
+
+        // If the foreign collection does not fit, the stage falls back to per-document queries.
+        setMaxSize(64);
+        pipelines.forEach(function(pipeline, i) {
+            assert.eq(expected[i], runLookup(pipeline), tojson(pipeline));
+        });
+    } finally {
+        setMaxSize(oldMaxSize);
+    }
+}());
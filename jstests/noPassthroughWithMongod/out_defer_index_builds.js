@@ -0,0 +1,55 @@
+// Tests that $out produces the same indexes, and reports the same duplicate key errors, when it
+// defers building the target collection's secondary indexes until all results are inserted.
+//
+// Note that this test sets the server parameter "internalQueryOutDeferIndexBuilds", and restores
+// the original value of the parameter before exiting.
+(function() {
+    "use strict";
+
+    const source = db.out_defer_index_builds_source;
+    const target = db.out_defer_index_builds_target;
+    source.drop();
+    target.drop();
+
+    const result = db.adminCommand({getParameter: 1, internalQueryOutDeferIndexBuilds: 1});
+    assert.commandWorked(result);
+    const originalValue = result.internalQueryOutDeferIndexBuilds;
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryOutDeferIndexBuilds: true}));
+
+    try {
+        const bulk = source.initializeUnorderedBulkOp();
+        for (let i = 0; i < 1000; ++i) {
+            bulk.insert({_id: i, a: i, b: i % 10, c: "str" + i});
+        }
+        assert.writeOK(bulk.execute());
+
+        assert.commandWorked(target.insert({_id: "placeholder"}));
+        assert.commandWorked(target.createIndex({a: 1}, {unique: true}));
+        assert.commandWorked(target.createIndex({b: 1, c: -1}, {name: "b_c"}));
+        assert.commandWorked(target.createIndex({c: "text"}));
+
+        function indexNames() {
+            return target.getIndexes().map(spec => spec.name).sort();
+        }
+        const expectedIndexes = indexNames();
+
+        // The indexes of the target collection are rebuilt on the new contents.
+        source.aggregate([{$out: target.getName()}]);
+        assert.eq(1000, target.find().itcount());
+        assert.eq(expectedIndexes, indexNames());
+        assert.eq(1, target.find({a: 500}).hint({a: 1}).itcount());
+        assert.eq(100, target.find({b: 3}).hint("b_c").itcount());
+        assert.eq(1, target.find({$text: {$search: "str42"}}).itcount());
+
+        // A result which violates a unique index fails the $out and leaves the target unchanged.
+        const err = assert.throws(
+            () => source.aggregate([{$project: {a: {$mod: ["$a", 2]}}}, {$out: target.getName()}]));
+        assert.eq(50853, err.code, tojson(err));
+        assert.eq(1000, target.find().itcount());
+        assert.eq(expectedIndexes, indexNames());
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryOutDeferIndexBuilds: originalValue}));
+    }
+}());
@@ -0,0 +1,110 @@
+// Tests that a materialized view serves the stored results of its pipeline once refreshed, that
+// refreshing applies newly inserted documents incrementally from the oplog, and that it falls
+// back to recomputing the results when the oplog entries cannot be applied.
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 2});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    const coll = testDB.materialized_view_refresh;
+    let pipeline = [
+        {$match: {x: {$gte: 0}}},
+        {$group: {_id: "$k", n: {$sum: 1}, total: {$sum: "$x"}, lo: {$min: "$x"}, hi: {$max: "$x"}}}
+    ];
+
+    function expectedGroups() {
+        return coll.aggregate(pipeline.concat([{$sort: {_id: 1}}])).toArray();
+    }
+
+    function viewGroups() {
+        return testDB.mv.aggregate([{$sort: {_id: 1}}]).toArray();
+    }
+
+    function refresh(expectIncremental) {
+        const res = assert.commandWorked(testDB.runCommand({refreshMaterializedView: "mv"}));
+        assert.eq(expectIncremental, res.incremental, tojson(res));
+        assert.eq(expectedGroups(), viewGroups());
+        return res;
+    }
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({k: i % 5, x: i}));
+    }
+    assert.writeOK(coll.insert({k: 0, x: -1}));
+
+    assert.commandWorked(testDB.runCommand(
+        {create: "mv", viewOn: coll.getName(), pipeline: pipeline, materialized: true}));
+
+    // A non-decomposable pipeline is rejected.
+    assert.commandFailedWithCode(
+        testDB.runCommand({
+            create: "badMv",
+            viewOn: coll.getName(),
+            pipeline: [{$group: {_id: "$k", avg: {$avg: "$x"}}}],
+            materialized: true
+        }),
+        ErrorCodes.OptionNotSupportedOnView);
+
+    // Until the first refresh, reads run the pipeline.
+    assert.eq(expectedGroups(), viewGroups());
+    let res = refresh(false);
+    assert.eq(5, res.nGroupsWritten, tojson(res));
+    assert.eq(5, testDB.getCollection("system.materialized.mv").find().itcount());
+
+    // The stored results are what reads are served from, so they lag the collection until the
+    // next refresh.
+    assert.writeOK(coll.insert({k: 0, x: 1000}));
+    assert.neq(tojson(expectedGroups()), tojson(viewGroups()));
+
+    // New documents, including ones in new groups and ones filtered out, are applied from the
+    // oplog.
+    assert.writeOK(coll.insert([{k: 1, x: -5}, {k: 7, x: 3}, {k: 2, x: NumberLong(4)}]));
+    res = refresh(true);
+    assert.eq(3, res.nGroupsWritten, tojson(res));
+
+    // Refreshing with nothing new writes nothing.
+    res = refresh(true);
+    assert.eq(0, res.nGroupsWritten, tojson(res));
+
+    // Deletes and updates cannot be applied from the oplog, so the results are recomputed.
+    assert.writeOK(coll.remove({k: 7}));
+    refresh(false);
+    assert.writeOK(coll.update({k: 1}, {$inc: {x: 1}}, {multi: true}));
+    refresh(false);
+    assert.writeOK(coll.insert({k: 3, x: 50}));
+    res = refresh(true);
+
+    // The stored results replicate to the secondary, which serves them as well.
+    rst.awaitReplication();
+    const secondaryDB = rst.getSecondary().getDB("test");
+    secondaryDB.getMongo().setSlaveOk();
+    assert.eq(viewGroups(), secondaryDB.mv.aggregate([{$sort: {_id: 1}}]).toArray());
+    assert.commandFailedWithCode(secondaryDB.runCommand({refreshMaterializedView: "mv"}),
+                                 ErrorCodes.NotMaster);
+
+    // listCollections reports how far the stored results reach.
+    const mvInfo = testDB.getCollectionInfos({name: "mv"})[0];
+    assert.eq(true, mvInfo.options.materialized, tojson(mvInfo));
+    assert.eq(0, timestampCmp(res.refreshedAt, mvInfo.info.refreshedAt), tojson(mvInfo));
+
+    // Modifying the pipeline falls back to running it until the next refresh.
+    pipeline = [{$group: {_id: "$k", n: {$sum: 1}}}];
+    assert.commandWorked(testDB.runCommand({collMod: "mv", pipeline: pipeline}));
+    assert.eq(expectedGroups(), viewGroups());
+    refresh(false);
+
+    // Refreshing a view which is not materialized fails.
+    assert.commandWorked(testDB.createView("plainView", coll.getName(), []));
+    assert.commandFailedWithCode(testDB.runCommand({refreshMaterializedView: "plainView"}),
+                                 ErrorCodes.InvalidOptions);
+
+    // Dropping the view drops its stored results.
+    assert(testDB.mv.drop());
+    assert.eq(0, testDB.getCollectionInfos({name: "system.materialized.mv"}).length);
+
+    rst.stopSet();
+}());
@@ -0,0 +1,47 @@
+// Tests that updates which change a few elements of a large array are logged as $set entries on
+// those elements rather than on the whole array, and that secondaries apply them correctly.
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 2});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB("test").oplog_array_delta;
+
+    function lastOplogEntry() {
+        return primary.getDB("local").oplog.rs.find({ns: coll.getFullName()}).sort({$natural: -1})
+            .limit(1)
+            .next();
+    }
+
+    const arr = [];
+    for (let i = 0; i < 500; i++) {
+        arr.push(i);
+    }
+    assert.writeOK(coll.insert({_id: 1, arr: arr, sub: {arr: arr, x: 1}}));
+
+    // $addToSet only appends to the array.
+    assert.writeOK(coll.update({_id: 1}, {$addToSet: {arr: 500}}));
+    assert.docEq({$v: 1, $set: {"arr.500": 500}}, lastOplogEntry().o);
+
+    // Replacing a large array with one that differs in a single element.
+    arr[10] = -10;
+    assert.writeOK(coll.update({_id: 1}, {$set: {"sub.arr": arr}}));
+    assert.docEq({$v: 1, $set: {"sub.arr.10": -10}}, lastOplogEntry().o);
+
+    // Replacing a large object with one that differs in a single field.
+    assert.writeOK(coll.update({_id: 1}, {$set: {sub: {arr: arr, x: 2}}}));
+    assert.docEq({$v: 1, $set: {"sub.x": 2}}, lastOplogEntry().o);
+
+    // Removing elements can't be logged as a delta.
+    assert.writeOK(coll.update({_id: 1}, {$pull: {arr: 0}}));
+    assert.eq(500, lastOplogEntry().o.$set.arr.length);
+
+    rst.awaitReplication();
+    const secondaryColl = rst.getSecondary().getCollection(coll.getFullName());
+    assert.docEq(coll.findOne({_id: 1}), secondaryColl.findOne({_id: 1}));
+
+    rst.stopSet();
+})();
@@ -0,0 +1,51 @@
+/**
+ * Tests that with buildIndexesInBackgroundOnSecondaries, a secondary builds an index the primary
+ * built in the foreground as a background build, and keeps applying oplog entries meanwhile.
+ */
+(function() {
+    'use strict';
+
+    load('jstests/libs/check_log.js');
+
+    const rst = new ReplSetTest({
+        nodes: [
+            {},
+            {rsConfig: {priority: 0}, setParameter: {buildIndexesInBackgroundOnSecondaries: true}}
+        ]
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    secondary.setSlaveOk();
+    const testDB = primary.getDB('test');
+    const coll = testDB.secondary_index_build_in_background;
+
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({_id: i, x: i}));
+    }
+    rst.awaitReplication();
+
+    // Hold the secondary's index build partway through.
+    assert.commandWorked(secondary.adminCommand(
+        {configureFailPoint: 'hangAfterStartingIndexBuild', mode: 'alwaysOn'}));
+    assert.commandWorked(coll.createIndex({x: 1}, {background: false}));
+    checkLog.contains(secondary, 'Hanging index build due to failpoint');
+
+    // Writes to the same collection keep replicating while the index build is held.
+    assert.commandWorked(testDB.runCommand(
+        {insert: coll.getName(), documents: [{_id: 100, x: 100}], writeConcern: {w: 2}}));
+
+    assert.commandWorked(secondary.adminCommand(
+        {configureFailPoint: 'hangAfterStartingIndexBuild', mode: 'off'}));
+    rst.awaitReplication();
+
+    const secondaryColl = secondary.getDB('test')[coll.getName()];
+    assert.eq(101, secondaryColl.find().itcount());
+    assert.soon(function() {
+        return secondaryColl.getIndexes().length === 2;
+    }, () => tojson(secondaryColl.getIndexes()));
+
+    rst.stopSet();
+})();
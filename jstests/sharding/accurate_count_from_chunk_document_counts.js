@@ -0,0 +1,56 @@
+/**
+ * Tests that an unfiltered count() of a sharded collection, which the shards answer from their
+ * per-chunk document counts when countFromChunkDocumentCounts is set, leaves out orphans and stays
+ * exact through writes, splits and migrations.
+ */
+(function() {
+    "use strict";
+
+    const st = new ShardingTest(
+        {shards: 2, rs: {nodes: 1, setParameter: {countFromChunkDocumentCounts: true}}});
+    const mongosDB = st.s.getDB("test");
+    const mongosColl = mongosDB.chunkcount;
+    const ns = mongosColl.getFullName();
+    const shard0Coll = st.rs0.getPrimary().getCollection(ns);
+
+    // Shard 0 owns [MinKey, 50) and shard 1 owns [50, MaxKey).
+    assert.commandWorked(mongosDB.adminCommand({enableSharding: "test"}));
+    st.ensurePrimaryShard("test", st.shard0.shardName);
+    assert.commandWorked(mongosDB.adminCommand({shardCollection: ns, key: {x: 1}}));
+    assert.commandWorked(mongosDB.adminCommand({split: ns, middle: {x: 50}}));
+    assert.commandWorked(mongosDB.adminCommand(
+        {moveChunk: ns, find: {x: 50}, to: st.shard1.shardName, _waitForDelete: true}));
+
+    const bulk = mongosColl.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Insert orphans into shard 0, in the range shard 1 owns. An unversioned count on the shard
+    // still includes them.
+    for (let i = 100; i < 105; i++) {
+        assert.writeOK(shard0Coll.insert({_id: i, x: i}));
+    }
+    assert.eq(55, shard0Coll.count());
+    assert.eq(100, mongosColl.count());
+
+    // Writes after the chunks were counted adjust their counts. The orphans are out of range of
+    // the remove, which is only routed to shard 1.
+    assert.writeOK(mongosColl.insert({_id: 200, x: 10}));
+    assert.writeOK(mongosColl.remove({x: {$gte: 90}}));
+    assert.eq(91, mongosColl.count());
+
+    // Split and migrated chunks are counted again.
+    assert.commandWorked(mongosDB.adminCommand({split: ns, middle: {x: 25}}));
+    assert.eq(91, mongosColl.count());
+    assert.commandWorked(mongosDB.adminCommand(
+        {moveChunk: ns, find: {x: 0}, to: st.shard1.shardName, _waitForDelete: true}));
+    assert.eq(91, mongosColl.count());
+
+    // Skip and limit apply to the total.
+    assert.eq(41, mongosColl.find().skip(50).count(true));
+    assert.eq(10, mongosColl.find().limit(10).count(true));
+
+    st.stop();
+})();
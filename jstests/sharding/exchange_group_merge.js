@@ -0,0 +1,72 @@
+// Tests that when internalQueryExchangeNumMergingShards is set, a $group over a sharded collection
+// is merged by several shards in parallel, each merging its own share of the group keys, and that
+// the results are the same as when merged by a single node.
+(function() {
+    "use strict";
+
+    const st = new ShardingTest({shards: 3, mongos: 1});
+    const mongosDB = st.s0.getDB("exchange_group_merge");
+    const coll = mongosDB.coll;
+
+    assert.commandWorked(st.s0.adminCommand({enableSharding: mongosDB.getName()}));
+    st.ensurePrimaryShard(mongosDB.getName(), st.shard0.shardName);
+    assert.commandWorked(
+        st.s0.adminCommand({shardCollection: coll.getFullName(), key: {_id: "hashed"}}));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 3000; ++i) {
+        bulk.insert({_id: i, k: i % 500, v: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipeline = [
+        {$group: {_id: "$k", total: {$sum: "$v"}, count: {$sum: 1}}},
+        {$match: {count: {$gt: 0}}},
+        {$project: {total: 1}}
+    ];
+
+    function runAggregation(comment) {
+        return coll.aggregate(pipeline, {comment: comment})
+            .toArray()
+            .sort((a, b) => a._id - b._id);
+    }
+
+    // Collect the results when merging on a single node.
+    const expected = runAggregation("exchange_group_merge_single");
+    assert.eq(500, expected.length);
+
+    const shardDBs =
+        [st.shard0, st.shard1, st.shard2].map(shard => shard.getDB(mongosDB.getName()));
+    for (let shardDB of shardDBs) {
+        assert.commandWorked(shardDB.setProfilingLevel(2));
+    }
+
+    assert.commandWorked(
+        st.s0.adminCommand({setParameter: 1, internalQueryExchangeNumMergingShards: 3}));
+    try {
+        assert.eq(expected, runAggregation("exchange_group_merge_exchange"));
+
+        // Each shard ran a merging copy of the $group.
+        for (let shardDB of shardDBs) {
+            assert.eq(1,
+                      shardDB.system.profile
+                          .find({
+                              "command.comment": "exchange_group_merge_exchange",
+                              "command.pipeline.0.$mergeCursors": {$exists: true}
+                          })
+                          .itcount(),
+                      shardDB.getMongo().host);
+        }
+
+        // A pipeline whose merging half cannot be run separately on each partition is merged as
+        // usual.
+        const sorted = coll.aggregate(pipeline.concat([{$sort: {total: -1}}, {$limit: 5}]))
+                           .toArray();
+        assert.eq(expected.sort((a, b) => b.total - a.total).slice(0, 5), sorted);
+    } finally {
+        assert.commandWorked(
+            st.s0.adminCommand({setParameter: 1, internalQueryExchangeNumMergingShards: 0}));
+    }
+
+    st.stop();
+})();
@@ -0,0 +1,80 @@
+// Tests that a $lookup from a sharded collection into another sharded collection runs on the shards
+// when the two collections are sharded on the joined fields with the same chunks on the same
+// shards, and is rejected otherwise.
+(function() {
+    "use strict";
+
+    const st = new ShardingTest({shards: 2, mongos: 1});
+
+    const mongosDB = st.s0.getDB(jsTestName());
+    const orders = mongosDB.orders;
+    const customers = mongosDB.customers;
+
+    assert.commandWorked(mongosDB.dropDatabase());
+    assert.commandWorked(mongosDB.adminCommand({enableSharding: mongosDB.getName()}));
+    st.ensurePrimaryShard(mongosDB.getName(), st.shard0.shardName);
+
+    // Shard both collections on the joined fields, split them at the same point and move the upper
+    // chunk of each to shard1.
+    function shardAndDistribute(coll, key, middle) {
+        assert.commandWorked(
+            mongosDB.adminCommand({shardCollection: coll.getFullName(), key: key}));
+        assert.commandWorked(mongosDB.adminCommand({split: coll.getFullName(), middle: middle}));
+        assert.commandWorked(mongosDB.adminCommand(
+            {moveChunk: coll.getFullName(), find: middle, to: st.shard1.shardName}));
+    }
+    shardAndDistribute(orders, {customerId: 1}, {customerId: 10});
+    shardAndDistribute(customers, {_id: 1}, {_id: 10});
+
+    for (let i = 0; i < 20; i++) {
+        assert.writeOK(orders.insert({_id: i, customerId: i}));
+        assert.writeOK(orders.insert({_id: i + 100, customerId: i}));
+        assert.writeOK(customers.insert({_id: i, name: "customer" + i}));
+    }
+
+    const lookupStage = {
+        $lookup:
+            {from: customers.getName(), localField: "customerId", foreignField: "_id", as: "c"}
+    };
+
+    // Every order joins with its customer, which lives on the same shard.
+    let results = orders.aggregate([lookupStage]).toArray();
+    assert.eq(40, results.length);
+    results.forEach(function(order) {
+        assert.eq([{_id: order.customerId, name: "customer" + order.customerId}],
+                  order.c,
+                  tojson(order));
+    });
+
+    // The $lookup runs on the shards, as part of the shards' half of the pipeline.
+    let explain = orders.explain().aggregate([lookupStage, {$sort: {_id: 1}}]);
+    assert(explain.hasOwnProperty("splitPipeline"), tojson(explain));
+    assert.eq(true,
+              explain.splitPipeline.shardsPart[0].$lookup.$shardLocal,
+              tojson(explain.splitPipeline));
+
+    // A stage which modifies the local field before the $lookup prevents running it shard-locally.
+    assert.commandFailedWithCode(mongosDB.runCommand({
+        aggregate: orders.getName(),
+        pipeline: [{$addFields: {customerId: {$add: ["$customerId", 1]}}}, lookupStage],
+        cursor: {}
+    }),
+                                 28769);
+
+    // So does a $lookup with the pipeline syntax.
+    assert.commandFailedWithCode(mongosDB.runCommand({
+        aggregate: orders.getName(),
+        pipeline: [{$lookup: {from: customers.getName(), pipeline: [], as: "c"}}],
+        cursor: {}
+    }),
+                                 28769);
+
+    // Once the chunks are no longer on the same shards, the collections are no longer co-located.
+    assert.commandWorked(mongosDB.adminCommand(
+        {moveChunk: customers.getFullName(), find: {_id: 10}, to: st.shard0.shardName}));
+    assert.commandFailedWithCode(
+        mongosDB.runCommand({aggregate: orders.getName(), pipeline: [lookupStage], cursor: {}}),
+        28769);
+
+    st.stop();
+})();
@@ -0,0 +1,54 @@
+// Tests that a $sample over a sharded collection is split across the shards in proportion to their
+// document counts, and that the merged sample is still complete.
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 2});
+    var testDB = st.s.getDB("test");
+    var coll = testDB.sample_split_across_shards;
+
+    assert.commandWorked(st.s.adminCommand({enableSharding: testDB.getName()}));
+    st.ensurePrimaryShard(testDB.getName(), st.shard0.shardName);
+    assert.commandWorked(st.s.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+
+    // Put 900 documents on shard0 and 100 on shard1.
+    assert.commandWorked(st.s.adminCommand({split: coll.getFullName(), middle: {_id: 900}}));
+    assert.commandWorked(st.s.adminCommand(
+        {moveChunk: coll.getFullName(), find: {_id: 900}, to: st.shard1.shardName}));
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    function checkSample(size) {
+        var ids = coll.aggregate([{$sample: {size: size}}]).toArray().map(function(doc) {
+            return doc._id;
+        });
+        assert.eq(size, ids.length, tojson(ids));
+        assert.eq(size, new Set(ids).size, tojson(ids));
+    }
+
+    // Each shard draws its share of the sample plus 4 standard deviations, up to the full size.
+    st.shard0.getDB(testDB.getName()).setProfilingLevel(2);
+    st.shard1.getDB(testDB.getName()).setProfilingLevel(2);
+    checkSample(100);
+
+    function shardSampleSize(shard) {
+        var entry = shard.getDB(testDB.getName()).system.profile.findOne(
+            {ns: coll.getFullName(), "command.pipeline.0.$sample": {$exists: true}});
+        assert(entry, "no $sample found in the profiler of " + shard.shardName);
+        return entry.command.pipeline[0].$sample.size;
+    }
+    // shard1's share is 10, and 10 + 4 * sqrt(10) is rounded up to 23.
+    assert.eq(100, shardSampleSize(st.shard0));
+    assert.between(22, shardSampleSize(st.shard1), 23);
+
+    // A negative margin sends every shard the full sample size.
+    assert.commandWorked(
+        st.s.adminCommand({setParameter: 1, internalQuerySampleShardOversampleStdDevs: -1}));
+    checkSample(100);
+    checkSample(1000);
+
+    st.stop();
+})();
@@ -0,0 +1,37 @@
+/**
+ * Test that TLS handshakes are counted in serverStatus, with how many resumed an earlier session.
+ */
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({
+        sslMode: "requireSSL",
+        sslPEMKeyFile: "jstests/libs/server.pem",
+        sslCAFile: "jstests/libs/ca.pem",
+    });
+
+    function tlsHandshakes() {
+        var network = assert.commandWorked(conn.adminCommand({serverStatus: 1})).network;
+        assert(network.hasOwnProperty("tlsHandshakes"), tojson(network));
+        return network.tlsHandshakes;
+    }
+
+    var before = tlsHandshakes();
+    ["ingress", "egress"].forEach(function(direction) {
+        ["total", "resumed", "totalMicros"].forEach(function(field) {
+            assert(before[direction].hasOwnProperty(field), tojson(before));
+        });
+    });
+    assert.gte(before.ingress.total, 1, tojson(before));
+
+    // Every new connection handshakes, whether or not it resumes a session.
+    for (var i = 0; i < 5; i++) {
+        var other = new Mongo(conn.host);
+        assert.commandWorked(other.adminCommand({ping: 1}));
+    }
+    var after = tlsHandshakes();
+    assert.gte(after.ingress.total - before.ingress.total, 5, tojson(after));
+    assert.lte(after.ingress.resumed, after.ingress.total, tojson(after));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns a document with 'numFields' fields named "a0", "a1", ..., alternating between integers,
+ * strings and subdocuments.
+ */
+BSONObj makeObj(int numFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; ++i) {
+        const std::string fieldName = str::stream() << "a" << i;
+        switch (i % 3) {
+            case 0:
+                builder.append(fieldName, i);
+                break;
+            case 1:
+                builder.append(fieldName, "a string value of moderate length");
+                break;
+            case 2:
+                builder.append(fieldName, BSON("x" << i << "y" << 1.5));
+                break;
+        }
+    }
+    return builder.obj();
+}
+
+/**
+ * Benchmark building a document with a mix of field types.
+ */
+void BM_BSONObjBuilder(benchmark::State& state) {
+    const int numFields = state.range(0);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(makeObj(numFields));
+    }
+}
+
+/**
+ * Benchmark looking up the last field of a document by name, which scans every field before it.
+ */
+void BM_BSONObjGetField(benchmark::State& state) {
+    const int numFields = state.range(0);
+    const BSONObj obj = makeObj(numFields);
+    const std::string lastField = str::stream() << "a" << (numFields - 1);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(obj.getField(lastField));
+    }
+}
+
+/**
+ * Benchmark validating a document, as is done for every document received from the network.
+ */
+void BM_ValidateBSON(benchmark::State& state) {
+    const BSONObj obj = makeObj(state.range(0));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+/**
+ * Benchmark parsing a document from extended JSON, as the shell and tools do.
+ */
+void BM_FromJSON(benchmark::State& state) {
+    const std::string json = makeObj(state.range(0)).jsonString(Strict);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(fromjson(json));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+/**
+ * Benchmark parsing a document whose string values contain escape sequences.
+ */
+void BM_FromJSONEscapedStrings(benchmark::State& state) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < state.range(0); ++i) {
+        builder.append(str::stream() << "a" << i, "a \"quoted\"\tvalue\nwith escapes");
+    }
+    const std::string json = builder.obj().jsonString(Strict);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(fromjson(json));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+BENCHMARK(BM_BSONObjBuilder)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_BSONObjGetField)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_ValidateBSON)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_FromJSON)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_FromJSONEscapedStrings)->Arg(10);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bson_field_index.h"
+
+namespace mongo {
+
+namespace {
+
+// FNV-1a. Field names are short, so a simple byte at a time hash is enough.
+size_t hashFieldName(StringData name) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : name) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+}  // namespace
+
+BSONElement BSONFieldIndex::getField(StringData name) {
+    if (++_numLookups == 2) {
+        _buildIndex();
+    }
+
+    if (_slots.empty()) {
+        return _obj.getField(name);
+    }
+
+    const size_t mask = _slots.size() - 1;
+    for (size_t i = hashFieldName(name) & mask;; i = (i + 1) & mask) {
+        const BSONElement& elem = _slots[i];
+        if (elem.eoo() || elem.fieldNameStringData() == name) {
+            return elem;
+        }
+    }
+}
+
+void BSONFieldIndex::_buildIndex() {
+    const int numFields = _obj.nFields();
+    if (numFields < kMinIndexedFields) {
+        return;
+    }
+
+    // Keep the table at most half full so that probe sequences stay short.
+    size_t numSlots = 1;
+    while (numSlots < 2 * static_cast<size_t>(numFields)) {
+        numSlots *= 2;
+    }
+    _slots.resize(numSlots);
+
+    const size_t mask = numSlots - 1;
+    for (auto&& elem : _obj) {
+        const StringData name = elem.fieldNameStringData();
+        for (size_t i = hashFieldName(name) & mask;; i = (i + 1) & mask) {
+            if (_slots[i].eoo()) {
+                _slots[i] = elem;
+                break;
+            }
+            if (_slots[i].fieldNameStringData() == name) {
+                // Only the first of several fields with the same name can be found.
+                break;
+            }
+        }
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * Looks up top level fields of a BSONObj by name. BSONObj::getField() scans the object's elements,
+ * so looking up many fields of a large object costs O(fields x lookups). On the second lookup,
+ * objects with at least kMinIndexedFields fields are indexed with a hash table of their
+ * elements, after which each lookup is O(1). The first lookup, and every lookup on smaller
+ * objects, is a plain getField() call.
+ *
+ * As with getField(), the first of several elements with the same name is returned. The object
+ * must outlive the index, which is meant to live on the stack of a single multi-field lookup such
+ * as index key generation.
+ */
+class BSONFieldIndex {
+    MONGO_DISALLOW_COPYING(BSONFieldIndex);
+
+public:
+    // Objects with fewer fields are cheaper to scan than to index.
+    static const int kMinIndexedFields = 16;
+
+    explicit BSONFieldIndex(const BSONObj& obj) : _obj(obj) {}
+
+    /**
+     * Returns the first field named 'name', or an eoo element if there is none.
+     */
+    BSONElement getField(StringData name);
+
+private:
+    void _buildIndex();
+
+    const BSONObj& _obj;
+    int _numLookups = 0;
+
+    // Open addressing hash table with linear probing. Empty slots hold eoo elements. Stays empty
+    // if the object has too few fields to be worth indexing.
+    std::vector<BSONElement> _slots;
+};
+
+}  // namespace mongo
@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bson_field_index.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeObj(int numFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; i++) {
+        builder.append(str::stream() << "field" << i, i);
+    }
+    return builder.obj();
+}
+
+void assertMatchesGetField(const BSONObj& obj, int numFields) {
+    BSONFieldIndex index(obj);
+    // Look up every field twice, so that both the unindexed and the indexed paths are used.
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < numFields; i++) {
+            const std::string name = str::stream() << "field" << i;
+            ASSERT_EQ(obj.getField(name).rawdata(), index.getField(name).rawdata());
+        }
+        ASSERT_TRUE(index.getField("missing").eoo());
+        ASSERT_TRUE(index.getField("").eoo());
+    }
+}
+
+TEST(BSONFieldIndex, SmallObjectMatchesGetField) {
+    assertMatchesGetField(makeObj(3), 3);
+}
+
+TEST(BSONFieldIndex, LargeObjectMatchesGetField) {
+    assertMatchesGetField(makeObj(100), 100);
+}
+
+TEST(BSONFieldIndex, EmptyObject) {
+    BSONObj obj;
+    BSONFieldIndex index(obj);
+    ASSERT_TRUE(index.getField("a").eoo());
+    ASSERT_TRUE(index.getField("a").eoo());
+}
+
+TEST(BSONFieldIndex, ReturnsFirstOfDuplicateFields) {
+    BSONObjBuilder builder;
+    builder.append("dup", 1);
+    for (int i = 0; i < BSONFieldIndex::kMinIndexedFields; i++) {
+        builder.append(str::stream() << "field" << i, i);
+    }
+    builder.append("dup", 2);
+    BSONObj obj = builder.obj();
+
+    BSONFieldIndex index(obj);
+    ASSERT_EQ(1, index.getField("dup").numberInt());
+    ASSERT_EQ(1, index.getField("dup").numberInt());
+}
+
+}  // namespace
+}  // namespace mongo
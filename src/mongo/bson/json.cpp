@@ -65,7 +65,7 @@ enum {
     ID_RESERVE_SIZE = 64,
     PAT_RESERVE_SIZE = 4096,
     OPT_RESERVE_SIZE = 64,
-    FIELD_RESERVE_SIZE = 4096,
+    FIELD_RESERVE_SIZE = 64,
     STRINGVAL_RESERVE_SIZE = 4096,
     BINDATA_RESERVE_SIZE = 4096,
     BINDATATYPE_RESERVE_SIZE = 4096,
@@ -95,6 +95,18 @@ Status JParse::parseError(StringData msg) {
 
 Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
     MONGO_JSON_DEBUG("fieldName: " << fieldName);
+    // Plain numbers and strings are the most common values, and none of the keywords below start
+    // like them. Check for them first rather than after every keyword.
+    while (_input < _input_end && isspace(*reinterpret_cast<const unsigned char*>(_input))) {
+        ++_input;
+    }
+    if (_input < _input_end &&
+        (isdigit(*reinterpret_cast<const unsigned char*>(_input)) ||
+         (*_input == '-' && _input + 1 < _input_end &&
+          isdigit(*reinterpret_cast<const unsigned char*>(_input + 1))))) {
+        return number(fieldName, builder);
+    }
+
     if (peekToken(LBRACE)) {
         Status ret = object(fieldName, builder);
         if (ret != Status::OK()) {
@@ -151,13 +163,13 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
             return ret;
         }
     } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
-        std::string valueString;
-        valueString.reserve(STRINGVAL_RESERVE_SIZE);
-        Status ret = quotedString(&valueString);
+        _stringValue.clear();
+        _stringValue.reserve(STRINGVAL_RESERVE_SIZE);
+        Status ret = quotedString(&_stringValue);
         if (ret != Status::OK()) {
             return ret;
         }
-        builder.append(fieldName, valueString);
+        builder.append(fieldName, _stringValue);
     } else if (readToken("true")) {
         builder.append(fieldName, true);
     } else if (readToken("false")) {
@@ -314,9 +326,10 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        // Reuse the first field's storage for the rest of the field names.
+        std::string& fieldName = firstField;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
+            fieldName.clear();
             Status fieldRet = field(&fieldName);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
@@ -1183,6 +1196,14 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
                     // TODO: check for escaped control characters
             }
             ++q;
+        } else if (allowedSet == NULL) {
+            // Copy the run of characters which need no unescaping or checks in one go.
+            const char* runStart = q++;
+            while (q < _input_end && *q != '\\' && !(0x00 <= *q && *q <= 0x1F) &&
+                   !match(*q, terminalSet)) {
+                ++q;
+            }
+            result->append(runStart, q);
         } else {
             result->push_back(*q++);
         }
@@ -492,6 +492,9 @@ private:
     const char* const _buf;
     const char* _input;
     const char* const _input_end;
+
+    // Holds each quoted string value while it is unescaped, so that its capacity is reused.
+    std::string _stringValue;
 };
 
 }  // namespace mongo
@@ -52,6 +52,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/itoa.h"
 #include "mongo/util/shared_buffer.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 
@@ -90,11 +91,33 @@ public:
     SharedBufferAllocator(SharedBufferAllocator&&) = default;
     SharedBufferAllocator& operator=(SharedBufferAllocator&&) = default;
 
+    // Buffers in the pooled size range come from SharedBufferPool, so builders that are released
+    // into BSONObjs and then destroyed recycle their memory instead of going back to malloc.
     void malloc(size_t sz) {
-        _buf = SharedBuffer::allocate(sz);
+        auto& pool = SharedBufferPool::get();
+        if (pool.isPooledSize(sz)) {
+            _buf = pool.allocate(sz, SharedBufferPool::Consumer::kBufBuilder);
+        } else {
+            _buf = SharedBuffer::allocate(sz);
+        }
     }
     void realloc(size_t sz) {
-        _buf.realloc(sz);
+        if (sz <= _buf.capacity()) {
+            // A pooled buffer may be larger than was asked for.
+            return;
+        }
+
+        auto& pool = SharedBufferPool::get();
+        if (!pool.isPooledSize(sz)) {
+            _buf.realloc(sz);
+            return;
+        }
+
+        auto newBuf = pool.allocate(sz, SharedBufferPool::Consumer::kBufBuilder);
+        if (_buf) {
+            memcpy(newBuf.get(), _buf.get(), _buf.capacity());
+        }
+        _buf = std::move(newBuf);
     }
     void free() {
         _buf = {};
@@ -44,6 +44,7 @@
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata.h"
 #include "mongo/rpc/object_check.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/bufreader.h"
@@ -117,13 +118,17 @@ Message DBClientCursor::_assembleInit() {
                                                 nToSkip,
                                                 nextBatchSize(),
                                                 opts);
-        if (qr.isOK() && !qr.getValue()->isExplain() && !qr.getValue()->isExhaust()) {
+        if (qr.isOK() && !qr.getValue()->isExplain()) {
             BSONObj cmd = qr.getValue()->asFindCommand();
             if (auto readPref = query["$readPreference"]) {
                 // QueryRequest doesn't handle $readPreference.
                 cmd = BSONObjBuilder(std::move(cmd)).append(readPref).obj();
             }
-            return assembleCommandRequest(_client, ns.db(), opts, std::move(cmd));
+            auto toSend = assembleCommandRequest(_client, ns.db(), opts, std::move(cmd));
+            // An exhaust find needs OP_MSG, since only OP_MSG replies can say more are coming.
+            if (!qr.getValue()->isExhaust() || _setExhaustFlag(&toSend)) {
+                return toSend;
+            }
         }
         // else use legacy OP_QUERY request.
     }
@@ -144,13 +149,30 @@ Message DBClientCursor::_assembleGetMore() {
                                   boost::none,   // awaitDataTimeout
                                   boost::none,   // term
                                   boost::none);  // lastKnownCommittedOptime
-        return assembleCommandRequest(_client, ns.db(), opts, gmr.toBSON());
+        auto toSend = assembleCommandRequest(_client, ns.db(), opts, gmr.toBSON());
+        if (opts & QueryOption_Exhaust) {
+            _setExhaustFlag(&toSend);
+        }
+        return toSend;
     } else {
         // Assemble a legacy getMore request.
         return makeGetMoreMessage(ns.ns(), cursorId, nextBatchSize(), opts);
     }
 }
 
+bool DBClientCursor::_setExhaustFlag(Message* toSend) const {
+    if (toSend->operation() != dbMsg) {
+        return false;
+    }
+
+    // The server streams batches sized by the request until the cursor is exhausted, so a limit
+    // is left to ordinary getMores, which shrink their batch size as the limit approaches.
+    if (!haveLimit) {
+        OpMsg::setFlag(toSend, OpMsg::kExhaustSupported);
+    }
+    return true;
+}
+
 bool DBClientCursor::init() {
     invariant(!_connectionHasPendingReplies);
     Message toSend = _assembleInit();
@@ -204,7 +226,8 @@ bool DBClientCursor::initLazyFinish(bool& retry) {
 }
 
 void DBClientCursor::requestMore() {
-    if (opts & QueryOption_Exhaust) {
+    // Once an exhaust stream is going, the server sends batches without being asked.
+    if ((opts & QueryOption_Exhaust) && _connectionHasPendingReplies) {
         return exhaustReceiveMore();
     }
 
@@ -233,10 +256,13 @@ void DBClientCursor::requestMore() {
     });
 }
 
-/** with QueryOption_Exhaust, the server just blasts data at us (marked at end with cursorid==0). */
+/**
+ * With QueryOption_Exhaust, the server just blasts data at us: over OP_QUERY until a reply has
+ * cursorid==0, and over OP_MSG until a reply lacks the moreToCome flag.
+ */
 void DBClientCursor::exhaustReceiveMore() {
     verify(cursorId && batch.pos == batch.objs.size());
-    uassert(40675, "Cannot have limit for exhaust query", !haveLimit);
+    uassert(40675, "Cannot have limit for exhaust query", !haveLimit || _useFindCommand);
     Message response;
     verify(_client);
     if (!_client->recv(response, _lastRequestId)) {
@@ -284,6 +310,12 @@ void DBClientCursor::dataReceived(const Message& reply, bool& retry, string& hos
         cursorId = cr.getCursorId();
         ns = cr.getNSS();  // Unlike OP_REPLY, find command can change the ns to use for getMores.
         batch.objs = cr.releaseBatch();
+
+        if (opts & QueryOption_Exhaust) {
+            // Each reply of an OP_MSG exhaust stream claims to answer the previous one.
+            _connectionHasPendingReplies = OpMsg::isFlagSet(reply, OpMsg::kMoreToCome);
+            _lastRequestId = reply.header().getId();
+        }
         return;
     }
 
@@ -275,6 +275,12 @@ private:
     // init pieces
     Message _assembleInit();
     Message _assembleGetMore();
+
+    /**
+     * Asks the server to stream the rest of the cursor's batches in response to 'toSend'. Returns
+     * false if 'toSend' is not an OP_MSG, which is the only command protocol that supports it.
+     */
+    bool _setExhaustFlag(Message* toSend) const;
 };
 
 /** iterate over objects in current batch only - will not cause a network call
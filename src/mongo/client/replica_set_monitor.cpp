@@ -42,6 +42,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/bson_extract_optime.h"
 #include "mongo/db/server_options.h"
+#include "mongo/executor/remote_command_request.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -164,6 +165,18 @@ struct HostNotIn {
  * Replica set refresh period on the task executor.
  */
 const Seconds kRefreshPeriod(30);
+
+// Same bound as the socket timeout used when contacting hosts through DBClient connections.
+const Milliseconds kIsMasterTimeout(static_cast<long long>(socketTimeoutSecs * 1000));
+
+/**
+ * The task executor's network interface neither goes through the connection hook that tests use
+ * to mock out hosts, nor applies the per-connection options that a set's MongoURI can carry, so
+ * sets depending on either are refreshed synchronously through DBClient connections instead.
+ */
+bool canRefreshAsync(const SetState& set) {
+    return !set.setUri.isValid() && !ConnectionString::getConnectionHook();
+}
 }  // namespace
 
 // If we cannot find a host after 15 seconds of refreshing, give up
@@ -225,9 +238,15 @@ void ReplicaSetMonitor::_refresh(const CallbackArgs& cbArgs) {
         return;
     }
 
-    Timer t;
-    startOrContinueRefresh().refreshAll();
-    LOG(1) << "Refreshing replica set " << getName() << " took " << t.millis() << " msec";
+    if (canRefreshAsync(*_state)) {
+        // Never blocks, so one slow or unreachable host holds up neither the rest of this set nor
+        // the refresh of any other set sharing the executor.
+        startOrContinueRefresh().refreshAllAsync(_executor);
+    } else {
+        Timer t;
+        startOrContinueRefresh().refreshAll();
+        LOG(1) << "Refreshing replica set " << getName() << " took " << t.millis() << " msec";
+    }
 
     // Reschedule the refresh
     invariant(_executor);
@@ -284,6 +303,11 @@ StatusWith<HostAndPort> ReplicaSetMonitor::getHostOrRefresh(const ReadPreference
         // make sure all hosts are contacted at least once (possibly by other threads) before this
         // function gives up.
         Refresher refresher(startOrContinueRefresh());
+        if (_executor && canRefreshAsync(*_state)) {
+            // Contact every host at once, so that the wait below is bounded by the slowest reply
+            // rather than by the sum of them.
+            refresher.refreshAllAsync(_executor);
+        }
 
         HostAndPort out = refresher.refreshUntilMatches(criteria);
         if (!out.empty())
@@ -321,6 +345,12 @@ Refresher ReplicaSetMonitor::startOrContinueRefresh() {
     return out;
 }
 
+std::vector<HostAndPort> ReplicaSetMonitor::getMatchingHosts(
+    const ReadPreferenceSetting& readPref) const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    return _state->getMatchingHosts(readPref);
+}
+
 void ReplicaSetMonitor::failedHost(const HostAndPort& host, const Status& status) {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
@@ -493,6 +523,70 @@ void Refresher::refreshAll() {
     _refreshUntilMatches(nullptr);
 }
 
+void Refresher::refreshAllAsync(TaskExecutor* executor) {
+    std::vector<HostAndPort> hosts;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_set->mutex);
+        hosts = _takeHostsToContact();
+    }
+
+    for (const auto& host : hosts) {
+        _contactHostAsync(executor, host);
+    }
+}
+
+std::vector<HostAndPort> Refresher::_takeHostsToContact() {
+    std::vector<HostAndPort> hosts;
+    while (true) {
+        const NextStep ns = getNextStep();
+        if (ns.step != NextStep::CONTACT_HOST)
+            break;
+        hosts.push_back(ns.host);
+    }
+    DEV _set->checkInvariants();
+    return hosts;
+}
+
+void Refresher::_contactHostAsync(TaskExecutor* executor, const HostAndPort& host) {
+    const executor::RemoteCommandRequest request(
+        host, "admin", BSON("isMaster" << 1), nullptr, kIsMasterTimeout);
+
+    // The copy of this Refresher keeps the SetState alive and bound to this scan even if the
+    // ReplicaSetMonitor goes away before the reply arrives.
+    Refresher refresher(*this);
+    const Timer timer;
+    auto status = executor->scheduleRemoteCommand(
+        request,
+        [refresher, host, timer, executor](
+            const TaskExecutor::RemoteCommandCallbackArgs& cbArgs) mutable {
+            std::vector<HostAndPort> hosts;
+            {
+                stdx::lock_guard<stdx::mutex> lk(refresher._set->mutex);
+
+                // Ignore the reply if this is no longer the current scan.
+                if (refresher._scan != refresher._set->currentScan)
+                    return;
+
+                if (cbArgs.response.isOK())
+                    refresher.receivedIsMaster(host, timer.micros(), cbArgs.response.data);
+                else
+                    refresher.failedHost(host, cbArgs.response.status);
+
+                hosts = refresher._takeHostsToContact();
+            }
+
+            for (const auto& next : hosts) {
+                refresher._contactHostAsync(executor, next);
+            }
+        });
+
+    if (!status.isOK()) {
+        stdx::lock_guard<stdx::mutex> lk(_set->mutex);
+        if (_scan == _set->currentScan)
+            failedHost(host, status.getStatus());
+    }
+}
+
 Refresher::NextStep Refresher::getNextStep() {
     // No longer the current scan
     if (_scan != _set->currentScan) {
@@ -1063,117 +1157,169 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
         // The difference between these is handled by Node::matches
         case ReadPreference::SecondaryOnly:
         case ReadPreference::Nearest: {
-            stdx::function<bool(const Node&)> matchNode = [](const Node& node) -> bool {
-                return true;
-            };
-            // build comparator
-            if (criteria.maxStalenessSeconds.count()) {
-                auto masterIt = std::find_if(nodes.begin(), nodes.end(), isMaster);
-                if (masterIt == nodes.end() || !masterIt->lastWriteDate.toMillisSinceEpoch()) {
-                    auto writeDateCmp = [](const Node* a, const Node* b) -> bool {
-                        return a->lastWriteDate < b->lastWriteDate;
-                    };
-                    // use only non failed nodes
-                    std::vector<const Node*> upNodes;
-                    for (auto nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt) {
-                        if (nodeIt->isUp && nodeIt->lastWriteDate.toMillisSinceEpoch()) {
-                            upNodes.push_back(&(*nodeIt));
-                        }
-                    }
-                    auto latestSecNode =
-                        std::max_element(upNodes.begin(), upNodes.end(), writeDateCmp);
-                    if (latestSecNode == upNodes.end()) {
-                        matchNode = [](const Node& node) -> bool { return false; };
-                    } else {
-                        Date_t maxWriteTime = (*latestSecNode)->lastWriteDate;
-                        matchNode = [=](const Node& node) -> bool {
-                            return duration_cast<Seconds>(maxWriteTime - node.lastWriteDate) +
-                                kRefreshPeriod <=
-                                criteria.maxStalenessSeconds;
-                        };
-                    }
-                } else {
-                    Seconds primaryStaleness = duration_cast<Seconds>(
-                        masterIt->lastWriteDateUpdateTime - masterIt->lastWriteDate);
-                    matchNode = [=](const Node& node) -> bool {
-                        return duration_cast<Seconds>(node.lastWriteDateUpdateTime -
-                                                      node.lastWriteDate) -
-                            primaryStaleness + kRefreshPeriod <=
-                            criteria.maxStalenessSeconds;
-                    };
+            std::vector<const Node*> matchingNodes = getMatchingNodes(criteria);
+            if (matchingNodes.empty()) {
+                return HostAndPort();
+            }
+            if (matchingNodes.size() == 1) {
+                return matchingNodes.front()->host;
+            }
+
+            // Don't consider hosts further than a threshold from the closest.
+            for (size_t i = 1; i < matchingNodes.size(); i++) {
+                int64_t distance =
+                    matchingNodes[i]->latencyMicros - matchingNodes[0]->latencyMicros;
+                if (distance >= latencyThresholdMicros) {
+                    // this node and all remaining ones are too far away
+                    matchingNodes.erase(matchingNodes.begin() + i, matchingNodes.end());
+                    break;
                 }
             }
 
-            BSONForEach(tagElem, criteria.tags.getTagBSON()) {
-                uassert(16358, "Tags should be a BSON object", tagElem.isABSONObj());
-                BSONObj tag = tagElem.Obj();
+            // of the remaining nodes, pick one at random (or use round-robin)
+            if (ReplicaSetMonitor::useDeterministicHostSelection) {
+                // only in tests
+                return matchingNodes[roundRobin++ % matchingNodes.size()]->host;
+            } else {
+                // normal case
+                return matchingNodes[rand.nextInt32(matchingNodes.size())]->host;
+            };
+        }
 
-                std::vector<const Node*> matchingNodes;
-                for (size_t i = 0; i < nodes.size(); i++) {
-                    if (nodes[i].matches(criteria.pref) && nodes[i].matches(tag) &&
-                        matchNode(nodes[i])) {
-                        matchingNodes.push_back(&nodes[i]);
-                    }
-                }
+        default:
+            uassert(16337, "Unknown read preference", false);
+            break;
+    }
+}
 
-                // don't do more complicated selection if not needed
-                if (matchingNodes.empty()) {
-                    continue;
-                }
-                if (matchingNodes.size() == 1) {
-                    return matchingNodes.front()->host;
-                }
+std::vector<HostAndPort> SetState::getMatchingHosts(const ReadPreferenceSetting& criteria) const {
+    switch (criteria.pref) {
+        case ReadPreference::PrimaryPreferred: {
+            auto out =
+                getMatchingHosts(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+            if (!out.empty())
+                return out;
+            return getMatchingHosts(ReadPreferenceSetting(
+                ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
+        }
 
-                // Only consider nodes that satisfy the minOpTime
-                if (!criteria.minOpTime.isNull()) {
-                    std::sort(matchingNodes.begin(), matchingNodes.end(), opTimeGreater);
-                    for (size_t i = 0; i < matchingNodes.size(); i++) {
-                        if (matchingNodes[i]->opTime < criteria.minOpTime) {
-                            if (i == 0) {
-                                // If no nodes satisfy the minOpTime criteria, we ignore the
-                                // minOpTime requirement.
-                                break;
-                            }
-                            matchingNodes.erase(matchingNodes.begin() + i, matchingNodes.end());
-                            break;
-                        }
-                    }
+        case ReadPreference::SecondaryPreferred: {
+            auto out = getMatchingHosts(ReadPreferenceSetting(
+                ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
+            if (!out.empty())
+                return out;
+            return getMatchingHosts(
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+        }
 
-                    if (matchingNodes.size() == 1) {
-                        return matchingNodes.front()->host;
-                    }
+        case ReadPreference::PrimaryOnly: {
+            HostAndPort out = getMatchingHost(criteria);
+            if (out.empty())
+                return {};
+            return {std::move(out)};
+        }
+
+        case ReadPreference::SecondaryOnly:
+        case ReadPreference::Nearest: {
+            std::vector<HostAndPort> out;
+            for (const Node* node : getMatchingNodes(criteria)) {
+                out.push_back(node->host);
+            }
+            return out;
+        }
+
+        default:
+            uassert(50860, "Unknown read preference", false);
+            break;
+    }
+}
+
+std::vector<const Node*> SetState::getMatchingNodes(const ReadPreferenceSetting& criteria) const {
+    invariant(criteria.pref == ReadPreference::SecondaryOnly ||
+              criteria.pref == ReadPreference::Nearest);
+
+    stdx::function<bool(const Node&)> matchNode = [](const Node& node) -> bool { return true; };
+    // build comparator
+    if (criteria.maxStalenessSeconds.count()) {
+        auto masterIt = std::find_if(nodes.begin(), nodes.end(), isMaster);
+        if (masterIt == nodes.end() || !masterIt->lastWriteDate.toMillisSinceEpoch()) {
+            auto writeDateCmp = [](const Node* a, const Node* b) -> bool {
+                return a->lastWriteDate < b->lastWriteDate;
+            };
+            // use only non failed nodes
+            std::vector<const Node*> upNodes;
+            for (auto nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt) {
+                if (nodeIt->isUp && nodeIt->lastWriteDate.toMillisSinceEpoch()) {
+                    upNodes.push_back(&(*nodeIt));
                 }
+            }
+            auto latestSecNode = std::max_element(upNodes.begin(), upNodes.end(), writeDateCmp);
+            if (latestSecNode == upNodes.end()) {
+                matchNode = [](const Node& node) -> bool { return false; };
+            } else {
+                Date_t maxWriteTime = (*latestSecNode)->lastWriteDate;
+                matchNode = [=](const Node& node) -> bool {
+                    return duration_cast<Seconds>(maxWriteTime - node.lastWriteDate) +
+                        kRefreshPeriod <=
+                        criteria.maxStalenessSeconds;
+                };
+            }
+        } else {
+            Seconds primaryStaleness =
+                duration_cast<Seconds>(masterIt->lastWriteDateUpdateTime - masterIt->lastWriteDate);
+            matchNode = [=](const Node& node) -> bool {
+                return duration_cast<Seconds>(node.lastWriteDateUpdateTime - node.lastWriteDate) -
+                    primaryStaleness + kRefreshPeriod <=
+                    criteria.maxStalenessSeconds;
+            };
+        }
+    }
+
+    BSONForEach(tagElem, criteria.tags.getTagBSON()) {
+        uassert(16358, "Tags should be a BSON object", tagElem.isABSONObj());
+        BSONObj tag = tagElem.Obj();
+
+        std::vector<const Node*> matchingNodes;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i].matches(criteria.pref) && nodes[i].matches(tag) && matchNode(nodes[i])) {
+                matchingNodes.push_back(&nodes[i]);
+            }
+        }
 
-                // If there are multiple nodes satisfying the minOpTime, next order by latency
-                // and don't consider hosts further than a threshold from the closest.
-                std::sort(matchingNodes.begin(), matchingNodes.end(), compareLatencies);
-                for (size_t i = 1; i < matchingNodes.size(); i++) {
-                    int64_t distance =
-                        matchingNodes[i]->latencyMicros - matchingNodes[0]->latencyMicros;
-                    if (distance >= latencyThresholdMicros) {
-                        // this node and all remaining ones are too far away
-                        matchingNodes.erase(matchingNodes.begin() + i, matchingNodes.end());
+        // don't do more complicated selection if not needed
+        if (matchingNodes.empty()) {
+            continue;
+        }
+        if (matchingNodes.size() == 1) {
+            return matchingNodes;
+        }
+
+        // Only consider nodes that satisfy the minOpTime
+        if (!criteria.minOpTime.isNull()) {
+            std::sort(matchingNodes.begin(), matchingNodes.end(), opTimeGreater);
+            for (size_t i = 0; i < matchingNodes.size(); i++) {
+                if (matchingNodes[i]->opTime < criteria.minOpTime) {
+                    if (i == 0) {
+                        // If no nodes satisfy the minOpTime criteria, we ignore the
+                        // minOpTime requirement.
                         break;
                     }
+                    matchingNodes.erase(matchingNodes.begin() + i, matchingNodes.end());
+                    break;
                 }
-
-                // of the remaining nodes, pick one at random (or use round-robin)
-                if (ReplicaSetMonitor::useDeterministicHostSelection) {
-                    // only in tests
-                    return matchingNodes[roundRobin++ % matchingNodes.size()]->host;
-                } else {
-                    // normal case
-                    return matchingNodes[rand.nextInt32(matchingNodes.size())]->host;
-                };
             }
 
-            return HostAndPort();
+            if (matchingNodes.size() == 1) {
+                return matchingNodes;
+            }
         }
 
-        default:
-            uassert(16337, "Unknown read preference", false);
-            break;
+        // If there are multiple nodes satisfying the minOpTime, next order by latency.
+        std::sort(matchingNodes.begin(), matchingNodes.end(), compareLatencies);
+        return matchingNodes;
     }
+
+    return {};
 }
 
 Node* SetState::findNode(const HostAndPort& host) {
@@ -32,6 +32,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
@@ -102,6 +103,13 @@ public:
      */
     HostAndPort getMasterOrUassert();
 
+    /**
+     * Returns all hosts which match the given read preference, based only on the current view of
+     * the set. Does not refresh and never blocks on the network, so the result may be empty or
+     * stale.
+     */
+    std::vector<HostAndPort> getMatchingHosts(const ReadPreferenceSetting& readPref) const;
+
     /**
      * Returns a refresher object that can be used to update our view of the set.
      * If a refresh is currently in-progress, the returned Refresher will participate in the
@@ -278,7 +286,7 @@ private:
     executor::TaskExecutor::CallbackHandle _refresherHandle;
 
     const SetStatePtr _state;
-    executor::TaskExecutor* _executor;
+    executor::TaskExecutor* _executor = nullptr;
     AtomicBool _isRemovedFromManager{false};
 };
 
@@ -312,6 +320,16 @@ public:
      */
     void refreshAll();
 
+    /**
+     * Sends isMaster to every host the current scan can contact, all at once, through 'executor'
+     * and returns without waiting for any replies. Each reply is applied as it arrives and
+     * dispatches whatever hosts it adds to the scan, so a scan takes about as long as the slowest
+     * host's round trip rather than the sum of all of them, and never ties up the executor.
+     *
+     * Handles own locking.
+     */
+    void refreshAllAsync(executor::TaskExecutor* executor);
+
     //
     // Remaining methods are only for testing and internal use.
     // Callers are responsible for holding SetState::mutex before calling any of these methods.
@@ -390,6 +408,18 @@ private:
      */
     HostAndPort _refreshUntilMatches(const ReadPreferenceSetting* criteria);
 
+    /**
+     * Takes every host that getNextStep() says to contact right now. Returns an empty vector once
+     * the scan is either waiting on outstanding replies or done.
+     */
+    std::vector<HostAndPort> _takeHostsToContact();
+
+    /**
+     * Schedules an isMaster to 'host' on 'executor', whose reply is applied to this scan and then
+     * continues it via refreshAllAsync().
+     */
+    void _contactHostAsync(executor::TaskExecutor* executor, const HostAndPort& host);
+
     // Both pointers are never NULL
     SetStatePtr _set;
     ScanStatePtr _scan;  // May differ from _set->currentScan if a new scan has started.
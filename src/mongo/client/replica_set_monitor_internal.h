@@ -153,6 +153,20 @@ public:
      */
     HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
 
+    /**
+     * Returns every known host matching criteria, or an empty vector if no known host matches.
+     * Unlike getMatchingHost, hosts outside the latency window are included.
+     *
+     * Note: Uses only local data and does not go over the network.
+     */
+    std::vector<HostAndPort> getMatchingHosts(const ReadPreferenceSetting& criteria) const;
+
+    /**
+     * Returns the nodes matching a SecondaryOnly or Nearest criteria, ordered by latency. Only the
+     * first tag set with a match is used.
+     */
+    std::vector<const Node*> getMatchingNodes(const ReadPreferenceSetting& criteria) const;
+
     /**
      * Returns the Node with the given host, or NULL if no Node has that host.
      */
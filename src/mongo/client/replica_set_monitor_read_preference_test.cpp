@@ -298,6 +298,53 @@ TEST(ReplSetMonitorReadPref, NearestOneLocal) {
     ASSERT(!isPrimarySelected);
 }
 
+TEST(ReplSetMonitorReadPref, MatchingHostsIncludeHostsOutsideLatencyWindow) {
+    set<HostAndPort> seeds;
+    seeds.insert(HostAndPort("a"));
+
+    SetState set("name", seeds);
+    set.nodes = getThreeMemberWithTags();
+    set.latencyThresholdMicros = 3 * 1000;
+    set.nodes[0].latencyMicros = 30 * 1000;
+    set.nodes[1].latencyMicros = 20 * 1000;
+    set.nodes[2].latencyMicros = 10 * 1000;
+
+    // Ordered by latency, and not limited to the latency window.
+    auto hosts = set.getMatchingHosts(
+        ReadPreferenceSetting(mongo::ReadPreference::Nearest, TagSet(getDefaultTagSet())));
+    ASSERT_EQUALS(3U, hosts.size());
+    ASSERT_EQUALS("c", hosts[0].host());
+    ASSERT_EQUALS("b", hosts[1].host());
+    ASSERT_EQUALS("a", hosts[2].host());
+
+    hosts = set.getMatchingHosts(
+        ReadPreferenceSetting(mongo::ReadPreference::SecondaryOnly, TagSet(getP2TagSet())));
+    ASSERT_EQUALS(1U, hosts.size());
+    ASSERT_EQUALS("c", hosts[0].host());
+}
+
+TEST(ReplSetMonitorReadPref, MatchingHostsFallBackLikeMatchingHost) {
+    set<HostAndPort> seeds;
+    seeds.insert(HostAndPort("a"));
+
+    SetState set("name", seeds);
+    set.nodes = getThreeMemberWithTags();
+
+    auto hosts = set.getMatchingHosts(ReadPreferenceSetting(
+        mongo::ReadPreference::PrimaryPreferred, TagSet(getDefaultTagSet())));
+    ASSERT_EQUALS(1U, hosts.size());
+    ASSERT_EQUALS("b", hosts[0].host());
+
+    set.nodes[1].markFailed({ErrorCodes::InternalError, "Test error"});
+    hosts = set.getMatchingHosts(ReadPreferenceSetting(mongo::ReadPreference::PrimaryPreferred,
+                                                       TagSet(getDefaultTagSet())));
+    ASSERT_EQUALS(2U, hosts.size());
+
+    hosts = set.getMatchingHosts(
+        ReadPreferenceSetting(mongo::ReadPreference::PrimaryOnly, TagSet(getDefaultTagSet())));
+    ASSERT(hosts.empty());
+}
+
 TEST(ReplSetMonitorReadPref, PriOnlyWithTagsNoMatch) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getP2TagSet());
@@ -28,8 +28,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include <map>
+
 #include "mongo/client/replica_set_monitor.h"
 #include "mongo/client/replica_set_monitor_internal.h"
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/executor/thread_pool_task_executor_test_fixture.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -1913,5 +1917,85 @@ TEST(ReplicaSetMonitor, MinOpTimeIgnored) {
     ASSERT_EQUALS(notStale.host(), "c");
 }
 
+class ReplicaSetMonitorAsyncRefreshTest : public executor::ThreadPoolExecutorTest {
+protected:
+    void setUp() override {
+        executor::ThreadPoolExecutorTest::setUp();
+        launchExecutorThread();
+    }
+};
+
+TEST_F(ReplicaSetMonitorAsyncRefreshTest, ContactsAllHostsConcurrently) {
+    using NetworkOperationIterator = executor::NetworkInterfaceMock::NetworkOperationIterator;
+
+    SetStatePtr state = std::make_shared<SetState>("name", basicSeedsSet);
+    Refresher refresher(state);
+    refresher.refreshAllAsync(&getExecutor());
+
+    auto net = getNet();
+    std::map<HostAndPort, NetworkOperationIterator> requests;
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+
+        // Every seed is contacted before any of them has replied.
+        while (net->hasReadyRequests()) {
+            NetworkOperationIterator noi = net->getNextReadyRequest();
+            ASSERT_EQUALS("isMaster", noi->getRequest().cmdObj.firstElementFieldNameStringData());
+            requests[noi->getRequest().target] = noi;
+        }
+        ASSERT_EQUALS(basicSeeds.size(), requests.size());
+
+        // "a" and "b" reply while "c" hangs.
+        for (const auto& host : {HostAndPort("a"), HostAndPort("b")}) {
+            const bool primary = host.host() == "a";
+            net->scheduleSuccessfulResponse(requests[host],
+                                            executor::RemoteCommandResponse(
+                                                BSON("setName"
+                                                     << "name"
+                                                     << "ismaster"
+                                                     << primary
+                                                     << "secondary"
+                                                     << !primary
+                                                     << "hosts"
+                                                     << BSON_ARRAY("a"
+                                                                   << "b"
+                                                                   << "c")
+                                                     << "ok"
+                                                     << true),
+                                                BSONObj(),
+                                                Milliseconds(1)));
+        }
+        net->runReadyNetworkOperations();
+    }
+
+    {
+        // Entering the network waits for the executor to apply the replies.
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+        ASSERT_FALSE(net->hasReadyRequests());
+
+        stdx::lock_guard<stdx::mutex> lk(state->mutex);
+        ASSERT(state->currentScan);
+        ASSERT_EQUALS(state->getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly)),
+                      HostAndPort("a"));
+    }
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+        net->scheduleErrorResponse(requests[HostAndPort("c")],
+                                   Status(ErrorCodes::HostUnreachable, "unreachable"));
+        net->runReadyNetworkOperations();
+    }
+
+    executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+    ASSERT_FALSE(net->hasReadyRequests());
+
+    // The last reply completed the scan.
+    stdx::lock_guard<stdx::mutex> lk(state->mutex);
+    ASSERT(!state->currentScan);
+    ASSERT(state->findNode(HostAndPort("a"))->isUp);
+    ASSERT(state->findNode(HostAndPort("b"))->isUp);
+    ASSERT(!state->findNode(HostAndPort("c"))->isUp);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -62,10 +62,12 @@
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -119,10 +121,10 @@ MONGO_REGISTER_SHIM(AuthorizationManager::create)()->std::unique_ptr<Authorizati
 }
 
 /**
- * Guard object for synchronizing accesses to data cached in AuthorizationManager instances.
- * This guard allows one thread to access the cache at a time, and provides an exception-safe
- * mechanism for a thread to release the cache mutex while performing network or disk operations
- * while allowing other readers to proceed.
+ * Guard object for synchronizing accesses to a shard of the user cache of AuthorizationManager
+ * instances.  This guard allows one thread to access the shard at a time, and provides an
+ * exception-safe mechanism for a thread to release the shard's mutex while performing network or
+ * disk operations while allowing other readers to proceed.
  *
  * There are two ways to use this guard.  One may simply instantiate the guard like a
  * std::lock_guard, and perform reads or writes of the cache.
@@ -140,7 +142,7 @@ MONGO_REGISTER_SHIM(AuthorizationManager::create)()->std::unique_ptr<Authorizati
  * and all guards using no fetch phase are totally ordered with respect to one another, but
  * there is not a total ordering among all guard objects.
  *
- * The cached data has an associated counter, called the cache generation.  If the cache
+ * Each shard has an associated counter, called the cache generation.  If the cache
  * generation changes while a guard is in fetch phase, the fetched data should not be stored
  * into the cache, because some invalidation event occurred during the fetch phase.
  *
@@ -155,98 +157,95 @@ public:
     enum FetchSynchronization { fetchSynchronizationAutomatic, fetchSynchronizationManual };
 
     /**
-     * Constructs a cache guard, locking the mutex that synchronizes user cache accesses.
+     * Constructs a cache guard, locking the mutex that synchronizes accesses to 'shard'.
      */
-    CacheGuard(AuthorizationManagerImpl* authzManager,
+    CacheGuard(UserCacheShard* shard,
                const FetchSynchronization sync = fetchSynchronizationAutomatic)
-        : _isThisGuardInFetchPhase(false),
-          _authzManager(authzManager),
-          _lock(authzManager->_cacheMutex) {
+        : _isThisGuardInFetchPhase(false), _shard(shard), _lock(shard->mutex) {
         if (fetchSynchronizationAutomatic == sync) {
             synchronizeWithFetchPhase();
         }
     }
 
     /**
-     * Releases the mutex that synchronizes user cache access, if held, and notifies
-     * any threads waiting for their own opportunity to update the user cache.
+     * Releases the mutex that synchronizes accesses to the shard, if held, and notifies
+     * any threads waiting for their own opportunity to update the shard.
      */
     ~CacheGuard() {
         if (!_lock.owns_lock()) {
             _lock.lock();
         }
         if (_isThisGuardInFetchPhase) {
-            fassert(17190, _authzManager->_isFetchPhaseBusy);
-            _authzManager->_isFetchPhaseBusy = false;
-            _authzManager->_fetchPhaseIsReady.notify_all();
+            fassert(17190, _shard->isFetchPhaseBusy);
+            _shard->isFetchPhaseBusy = false;
+            _shard->fetchPhaseIsReady.notify_all();
         }
     }
 
     /**
-     * Returns true of the authzManager reports that it is in fetch phase.
+     * Returns true of the shard reports that it is in fetch phase.
      */
     bool otherUpdateInFetchPhase() {
-        return _authzManager->_isFetchPhaseBusy;
+        return _shard->isFetchPhaseBusy;
     }
 
     /**
-     * Waits on the _authzManager->_fetchPhaseIsReady condition.
+     * Waits on the _shard->fetchPhaseIsReady condition.
      */
     void wait() {
         fassert(17222, !_isThisGuardInFetchPhase);
-        _authzManager->_fetchPhaseIsReady.wait(_lock);
+        _shard->fetchPhaseIsReady.wait(_lock);
     }
 
     /**
-     * Enters fetch phase, releasing the _authzManager->_cacheMutex after recording the current
-     * cache generation.
+     * Enters fetch phase, releasing the _shard->mutex after recording the current cache
+     * generation.
      */
     void beginFetchPhase() {
-        fassert(17191, !_authzManager->_isFetchPhaseBusy);
+        fassert(17191, !_shard->isFetchPhaseBusy);
         _isThisGuardInFetchPhase = true;
-        _authzManager->_isFetchPhaseBusy = true;
-        _startGeneration = _authzManager->_cacheGeneration;
+        _shard->isFetchPhaseBusy = true;
+        _startGeneration = _shard->generation;
         _lock.unlock();
     }
 
     /**
-     * Exits the fetch phase, reacquiring the _authzManager->_cacheMutex.
+     * Exits the fetch phase, reacquiring the _shard->mutex.
      */
     void endFetchPhase() {
         _lock.lock();
-        // We do not clear _authzManager->_isFetchPhaseBusy or notify waiters until
-        // ~CacheGuard(), for two reasons.  First, there's no value to notifying the waiters
-        // before you're ready to release the mutex, because they'll just go to sleep on the
-        // mutex.  Second, in order to meaningfully check the preconditions of
-        // isSameCacheGeneration(), we need a state that means "fetch phase was entered and now
-        // has been exited."  That state is _isThisGuardInFetchPhase == true and
-        // _lock.owns_lock() == true.
+        // We do not clear _shard->isFetchPhaseBusy or notify waiters until ~CacheGuard(), for
+        // two reasons.  First, there's no value to notifying the waiters before you're ready to
+        // release the mutex, because they'll just go to sleep on the mutex.  Second, in order to
+        // meaningfully check the preconditions of isSameCacheGeneration(), we need a state that
+        // means "fetch phase was entered and now has been exited."  That state is
+        // _isThisGuardInFetchPhase == true and _lock.owns_lock() == true.
     }
 
     /**
-     * Returns true if _authzManager->_cacheGeneration remained the same while this guard was
-     * in fetch phase.  Behavior is undefined if this guard never entered fetch phase.
+     * Returns true if _shard->generation remained the same while this guard was in fetch
+     * phase.  Behavior is undefined if this guard never entered fetch phase.
      *
      * If this returns true, do not update the cached data with this
      */
     bool isSameCacheGeneration() const {
         fassert(17223, _isThisGuardInFetchPhase);
         fassert(17231, _lock.owns_lock());
-        return _startGeneration == _authzManager->_cacheGeneration;
+        return _startGeneration == _shard->generation;
     }
 
 private:
     void synchronizeWithFetchPhase() {
         while (otherUpdateInFetchPhase())
             wait();
-        fassert(17192, !_authzManager->_isFetchPhaseBusy);
+        fassert(17192, !_shard->isFetchPhaseBusy);
         _isThisGuardInFetchPhase = true;
-        _authzManager->_isFetchPhaseBusy = true;
+        _shard->isFetchPhaseBusy = true;
     }
 
-    OID _startGeneration;
+    unsigned long long _startGeneration;
     bool _isThisGuardInFetchPhase;
-    AuthorizationManagerImpl* _authzManager;
+    UserCacheShard* _shard;
     stdx::unique_lock<stdx::mutex> _lock;
 };
 
@@ -260,16 +259,21 @@ AuthorizationManagerImpl::AuthorizationManagerImpl(
       _privilegeDocsExist(false),
       _externalState(std::move(externalState)),
       _version(schemaVersionInvalid),
-      _isFetchPhaseBusy(false) {
-    _updateCacheGeneration_inlock();
+      _versionGeneration(0) {
+    for (auto& shard : _userCacheShards) {
+        shard.published.store(new UserMap());
+    }
+    _updateCacheGeneration();
 }
 
 AuthorizationManagerImpl::~AuthorizationManagerImpl() {
-    for (stdx::unordered_map<UserName, User*>::iterator it = _userCache.begin();
-         it != _userCache.end();
-         ++it) {
-        fassert(17265, it->second != internalSecurity.user);
-        delete it->second;
+    for (auto& shard : _userCacheShards) {
+        for (const auto& entry : shard.users) {
+            fassert(17265, entry.second != internalSecurity.user);
+            entry.second->removeCacheRef();
+            delete entry.second;
+        }
+        delete shard.published.load();
     }
 }
 
@@ -288,14 +292,13 @@ bool AuthorizationManagerImpl::shouldValidateAuthSchemaOnStartup() {
 }
 
 Status AuthorizationManagerImpl::getAuthorizationVersion(OperationContext* opCtx, int* version) {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    stdx::unique_lock<stdx::mutex> lk(_versionMutex);
     int newVersion = _version;
     if (schemaVersionInvalid == newVersion) {
-        while (guard.otherUpdateInFetchPhase())
-            guard.wait();
-        guard.beginFetchPhase();
+        const auto versionGeneration = _versionGeneration;
+        lk.unlock();
         Status status = _externalState->getStoredAuthorizationVersion(opCtx, &newVersion);
-        guard.endFetchPhase();
+        lk.lock();
         if (!status.isOK()) {
             warning() << "Problem fetching the stored schema version of authorization data: "
                       << redact(status);
@@ -303,7 +306,7 @@ Status AuthorizationManagerImpl::getAuthorizationVersion(OperationContext* opCtx
             return status;
         }
 
-        if (guard.isSameCacheGeneration()) {
+        if (versionGeneration == _versionGeneration) {
             _version = newVersion;
         }
     }
@@ -312,7 +315,7 @@ Status AuthorizationManagerImpl::getAuthorizationVersion(OperationContext* opCtx
 }
 
 OID AuthorizationManagerImpl::getCacheGeneration() {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    stdx::lock_guard<stdx::mutex> lk(_cacheGenerationMutex);
     return _cacheGeneration;
 }
 
@@ -421,18 +424,23 @@ Status AuthorizationManagerImpl::acquireUser(OperationContext* opCtx,
         return Status::OK();
     }
 
-    stdx::unordered_map<UserName, User*>::iterator it;
+    if (User* user = _acquireCachedUser(userName)) {
+        *acquiredUser = user;
+        return Status::OK();
+    }
 
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
-    while ((_userCache.end() == (it = _userCache.find(userName))) &&
+    auto& shard = _getShard(userName);
+    UserMap::iterator it;
+
+    CacheGuard guard(&shard, CacheGuard::fetchSynchronizationManual);
+    while ((shard.users.end() == (it = shard.users.find(userName))) &&
            guard.otherUpdateInFetchPhase()) {
         guard.wait();
     }
 
-    if (it != _userCache.end()) {
+    if (it != shard.users.end()) {
         fassert(16914, it->second);
         fassert(17003, it->second->isValid());
-        fassert(17008, it->second->getRefCount() > 0);
         it->second->incrementRefCount();
         *acquiredUser = it->second;
         return Status::OK();
@@ -440,7 +448,13 @@ Status AuthorizationManagerImpl::acquireUser(OperationContext* opCtx,
 
     std::unique_ptr<User> user;
 
-    int authzVersion = _version;
+    int authzVersion;
+    unsigned long long versionGeneration;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_versionMutex);
+        authzVersion = _version;
+        versionGeneration = _versionGeneration;
+    }
     guard.beginFetchPhase();
 
     // Number of times to retry a user document that fetches due to transient
@@ -490,8 +504,12 @@ Status AuthorizationManagerImpl::acquireUser(OperationContext* opCtx,
     user->incrementRefCount();
     // NOTE: It is not safe to throw an exception from here to the end of the method.
     if (guard.isSameCacheGeneration()) {
-        _userCache.insert(std::make_pair(userName, user.get()));
-        if (_version == schemaVersionInvalid)
+        user->addCacheRef();
+        shard.users.insert(std::make_pair(userName, user.get()));
+        _publishShard_inlock(shard);
+
+        stdx::lock_guard<stdx::mutex> lk(_versionMutex);
+        if (_version == schemaVersionInvalid && _versionGeneration == versionGeneration)
             _version = authzVersion;
     } else {
         // If the cache generation changed while this thread was in fetch mode, the data
@@ -530,63 +548,120 @@ void AuthorizationManagerImpl::releaseUser(User* user) {
         return;
     }
 
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
-    user->decrementRefCount();
-    if (user->getRefCount() == 0) {
-        // If it's been invalidated then it's not in the _userCache anymore.
-        if (user->isValid()) {
-            MONGO_COMPILER_VARIABLE_UNUSED bool erased = _userCache.erase(user->getName());
-            dassert(erased);
-        }
+    // A cached user holds a reference for the cache, so this only drops the last reference of a
+    // user which was invalidated and removed from the cache.
+    if (user->decrementRefCount()) {
         delete user;
     }
 }
 
-void AuthorizationManagerImpl::invalidateUserByName(const UserName& userName) {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
-    _updateCacheGeneration_inlock();
-    stdx::unordered_map<UserName, User*>::iterator it = _userCache.find(userName);
-    if (it == _userCache.end()) {
-        return;
-    }
+AuthorizationManagerImpl::UserCacheShard& AuthorizationManagerImpl::_getShard(
+    const UserName& userName) {
+    return _userCacheShards[std::hash<UserName>()(userName) % kNumUserCacheShards];
+}
+
+User* AuthorizationManagerImpl::_acquireCachedUser(const UserName& userName) {
+    auto& slot =
+        _readerSlots[std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % kNumReaderSlots];
+    auto& shard = _getShard(userName);
 
-    User* user = it->second;
-    _userCache.erase(it);
-    user->invalidate();
+    while (true) {
+        // Announce the reader in the current epoch. If the epoch advanced in the meantime, a
+        // writer may not have seen the announcement, so try again in the new epoch.
+        const auto epoch = _epoch.load();
+        auto& active = slot.active[epoch % 2];
+        active.fetchAndAdd(1);
+        ON_BLOCK_EXIT([&] { active.subtractAndFetch(1); });
+        if (_epoch.load() != epoch) {
+            continue;
+        }
+
+        // The user cannot be freed before the reader leaves the epoch, because the cache holds a
+        // reference on it until the copies which contain it can no longer be read.
+        const auto& users = *shard.published.load();
+        auto it = users.find(userName);
+        if (it == users.end()) {
+            return nullptr;
+        }
+        it->second->incrementRefCount();
+        return it->second;
+    }
 }
 
-void AuthorizationManagerImpl::invalidateUsersFromDB(const std::string& dbname) {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
-    _updateCacheGeneration_inlock();
-    stdx::unordered_map<UserName, User*>::iterator it = _userCache.begin();
-    while (it != _userCache.end()) {
-        User* user = it->second;
-        if (user->getName().getDB() == dbname) {
-            _userCache.erase(it++);
-            user->invalidate();
-        } else {
-            ++it;
+void AuthorizationManagerImpl::_publishShard_inlock(UserCacheShard& shard) {
+    const UserMap* previous = shard.published.swap(new UserMap(shard.users));
+
+    // Readers that enter from now on see the new copy. Wait for the ones that entered before.
+    const auto previousEpoch = _epoch.fetchAndAdd(1);
+    for (auto&& readerSlot : _readerSlots) {
+        while (readerSlot.active[previousEpoch % 2].load() > 0) {
+            stdx::this_thread::yield();
+        }
+    }
+    delete previous;
+}
+
+void AuthorizationManagerImpl::_invalidateUsers(
+    UserCacheShard& shard, const stdx::function<bool(const User&)>& shouldInvalidate) {
+    std::vector<User*> removed;
+    {
+        CacheGuard guard(&shard, CacheGuard::fetchSynchronizationManual);
+        ++shard.generation;
+        for (auto it = shard.users.begin(); it != shard.users.end();) {
+            if (shouldInvalidate(*it->second)) {
+                removed.push_back(it->second);
+                shard.users.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+        if (!removed.empty()) {
+            _publishShard_inlock(shard);
+        }
+    }
+
+    // No cache hit can find the removed users anymore, so drop the cache's references on them.
+    for (User* user : removed) {
+        fassert(17266, user != internalSecurity.user);
+        user->invalidate();
+        if (user->removeCacheRef()) {
+            delete user;
         }
     }
 }
 
-void AuthorizationManagerImpl::invalidateUserCache() {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
-    _invalidateUserCache_inlock();
+void AuthorizationManagerImpl::invalidateUserByName(const UserName& userName) {
+    _updateCacheGeneration();
+    _invalidateUsers(_getShard(userName),
+                     [&](const User& user) { return user.getName() == userName; });
+}
+
+void AuthorizationManagerImpl::invalidateUsersFromDB(const std::string& dbname) {
+    _updateCacheGeneration();
+    for (auto& shard : _userCacheShards) {
+        _invalidateUsers(shard, [&](const User& user) { return user.getName().getDB() == dbname; });
+    }
 }
 
-void AuthorizationManagerImpl::_invalidateUserCache_inlock() {
-    _updateCacheGeneration_inlock();
-    for (stdx::unordered_map<UserName, User*>::iterator it = _userCache.begin();
-         it != _userCache.end();
-         ++it) {
-        fassert(17266, it->second != internalSecurity.user);
-        it->second->invalidate();
+void AuthorizationManagerImpl::_invalidateUsersWithRole(const RoleName& roleName) {
+    _updateCacheGeneration();
+    for (auto& shard : _userCacheShards) {
+        _invalidateUsers(shard,
+                         [&](const User& user) { return user.hasRoleOrIndirectRole(roleName); });
     }
-    _userCache.clear();
+}
 
-    // Reread the schema version before acquiring the next user.
-    _version = schemaVersionInvalid;
+void AuthorizationManagerImpl::invalidateUserCache() {
+    _updateCacheGeneration();
+    {
+        // Reread the schema version before acquiring the next user.
+        stdx::lock_guard<stdx::mutex> lk(_versionMutex);
+        _version = schemaVersionInvalid;
+        ++_versionGeneration;
+    }
+    for (auto& shard : _userCacheShards) {
+        _invalidateUsers(shard, [](const User&) { return true; });
+    }
 }
 
 Status AuthorizationManagerImpl::initialize(OperationContext* opCtx) {
@@ -664,9 +739,25 @@ StatusWith<UserName> extractUserNameFromIdString(StringData idstr) {
         UserName(idstr.substr(splitPoint + 1), idstr.substr(0, splitPoint)));
 }
 
+// Role documents have an _id of the form "<dbname>.<rolename>".  This function extracts the
+// RoleName from that string.
+StatusWith<RoleName> extractRoleNameFromIdString(StringData idstr) {
+    size_t splitPoint = idstr.find('.');
+    if (splitPoint == string::npos) {
+        return StatusWith<RoleName>(ErrorCodes::FailedToParse,
+                                    mongoutils::str::stream()
+                                        << "_id entries for role documents must be of "
+                                           "the form <dbname>.<rolename>.  Found: "
+                                        << idstr);
+    }
+    return StatusWith<RoleName>(
+        RoleName(idstr.substr(splitPoint + 1), idstr.substr(0, splitPoint)));
+}
+
 }  // namespace
 
-void AuthorizationManagerImpl::_updateCacheGeneration_inlock() {
+void AuthorizationManagerImpl::_updateCacheGeneration() {
+    stdx::lock_guard<stdx::mutex> lk(_cacheGenerationMutex);
     _cacheGeneration = OID::gen();
 }
 
@@ -674,8 +765,23 @@ void AuthorizationManagerImpl::_invalidateRelevantCacheData(const char* op,
                                                             const NamespaceString& ns,
                                                             const BSONObj& o,
                                                             const BSONObj* o2) {
-    if (ns == AuthorizationManager::rolesCollectionNamespace ||
-        ns == AuthorizationManager::versionCollectionNamespace) {
+    if (ns == AuthorizationManager::versionCollectionNamespace) {
+        invalidateUserCache();
+        return;
+    }
+
+    if (ns == AuthorizationManager::rolesCollectionNamespace) {
+        // A change to a role only affects the users which have it, directly or through role
+        // inheritance.
+        if (*op == 'i' || *op == 'd' || *op == 'u') {
+            StatusWith<RoleName> roleName = (*op == 'u')
+                ? extractRoleNameFromIdString((*o2)["_id"].str())
+                : extractRoleNameFromIdString(o["_id"].str());
+            if (roleName.isOK()) {
+                _invalidateUsersWithRole(roleName.getValue());
+                return;
+            }
+        }
         invalidateUserCache();
         return;
     }
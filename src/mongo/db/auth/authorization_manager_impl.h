@@ -30,6 +30,7 @@
 
 #include "mongo/db/auth/authorization_manager.h"
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -48,6 +49,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -139,16 +141,89 @@ public:
 
 private:
     /**
-     * Type used to guard accesses and updates to the user cache.
+     * Type used to guard accesses and updates to a shard of the user cache.
      */
     class CacheGuard;
     friend class AuthorizationManagerImpl::CacheGuard;
 
+    using UserMap = stdx::unordered_map<UserName, User*>;
+
+    /**
+     * One shard of the cache of User objects.  Users are assigned to shards by the hash of their
+     * name, so that authentications of different users rarely contend on the same mutex, and
+     * fetches of different users from disk or the network can proceed in parallel.
+     *
+     * Every cached User holds a reference on behalf of the cache, so that it stays alive while
+     * it is in the cache, even when no AuthorizationSession uses it.
+     */
+    struct UserCacheShard {
+        /**
+         * Protects users, generation and isFetchPhaseBusy.  Manipulated via CacheGuard.
+         */
+        stdx::mutex mutex;
+
+        UserMap users;
+
+        /**
+         * Updated every time users of this shard get invalidated.  A user fetched while the
+         * generation changed must not be stored in the cache.
+         */
+        unsigned long long generation = 0;
+
+        /**
+         * True if there is an update to this shard in progress, and that update is currently in
+         * the "fetch phase", during which it does not hold the mutex.
+         */
+        bool isFetchPhaseBusy = false;
+
+        /**
+         * Condition used to signal that it is OK for another CacheGuard to enter a fetch phase on
+         * this shard.
+         */
+        stdx::condition_variable fetchPhaseIsReady;
+
+        /**
+         * Immutable copy of 'users', for the cache hits that take no lock.  Replaced while
+         * holding the mutex.
+         */
+        AtomicWord<const UserMap*> published;
+    };
+
+    // Counts the readers of the published users that entered in an even and in an odd epoch.
+    // Each slot is on its own cache line, so that readers on different cores don't contend.
+    struct alignas(64) ReaderSlot {
+        std::array<AtomicWord<long long>, 2> active;
+    };
+
+    static const size_t kNumUserCacheShards = 16;
+    static const size_t kNumReaderSlots = 16;
+
+    UserCacheShard& _getShard(const UserName& userName);
+
+    /**
+     * Looks 'userName' up in the published copy of its shard without taking any lock.  If the
+     * user is cached, increments its reference count and returns it, otherwise returns nullptr.
+     */
+    User* _acquireCachedUser(const UserName& userName);
+
+    /**
+     * Publishes a copy of 'shard.users', and frees the previous copy once no reader can be using
+     * it.  Should only be called when already holding the shard's mutex.
+     */
+    void _publishShard_inlock(UserCacheShard& shard);
+
+    /**
+     * Removes the users of 'shard' for which 'shouldInvalidate' returns true from the cache,
+     * and invalidates them.  Any fetch in progress on the shard is not stored in the cache.
+     */
+    void _invalidateUsers(UserCacheShard& shard,
+                          const stdx::function<bool(const User&)>& shouldInvalidate);
+
     /**
-     * Invalidates all User objects in the cache and removes them from the cache.
-     * Should only be called when already holding _cacheMutex.
+     * Invalidates the cached users which are members of 'roleName', directly or through role
+     * inheritance.
      */
-    void _invalidateUserCache_inlock();
+    void _invalidateUsersWithRole(const RoleName& roleName);
 
     /**
      * Given the objects describing an oplog entry that affects authorization data, invalidates
@@ -163,7 +238,7 @@ private:
     /**
      * Updates _cacheGeneration to a new OID
      */
-    void _updateCacheGeneration_inlock();
+    void _updateCacheGeneration();
 
     /**
      * Fetches user information from a v2-schema user document for the named user,
@@ -203,44 +278,35 @@ private:
      * Cached value of the authorization schema version.
      *
      * May be set by acquireUser() and getAuthorizationVersion().  Invalidated by
-     * invalidateUserCache().
+     * invalidateUserCache(), which also updates _versionGeneration so that a version fetched
+     * meanwhile is not stored.
      *
-     * Reads and writes guarded by CacheGuard.
+     * Reads and writes guarded by _versionMutex.
      */
     int _version;
+    unsigned long long _versionGeneration;
+    stdx::mutex _versionMutex;
 
     /**
      * Caches User objects with information about user privileges, to avoid the need to
      * go to disk to read user privilege documents whenever possible.  Every User object
      * has a reference count - the AuthorizationManager must not delete a User object in the
-     * cache unless its reference count is zero.
+     * cache, and must not delete a User object removed from the cache unless its reference
+     * count is zero.
+     *
+     * Cache hits read the published copy of a shard: a reader announces itself in the current
+     * epoch, and a thread which replaces a shard's copy advances the epoch and waits until no
+     * reader of the previous epoch is still active before freeing the previous copy.
      */
-    stdx::unordered_map<UserName, User*> _userCache;
+    std::array<UserCacheShard, kNumUserCacheShards> _userCacheShards;
+    std::array<ReaderSlot, kNumReaderSlots> _readerSlots;
+    AtomicWord<unsigned long long> _epoch{0};
 
     /**
      * Current generation of cached data.  Updated every time part of the cache gets
-     * invalidated.  Protected by CacheGuard.
+     * invalidated.  Protected by _cacheGenerationMutex.
      */
     OID _cacheGeneration;
-
-    /**
-     * True if there is an update to the _userCache in progress, and that update is currently in
-     * the "fetch phase", during which it does not hold the _cacheMutex.
-     *
-     * Manipulated via CacheGuard.
-     */
-    bool _isFetchPhaseBusy;
-
-    /**
-     * Protects _userCache, _cacheGeneration, _version and _isFetchPhaseBusy.  Manipulated
-     * via CacheGuard.
-     */
-    stdx::mutex _cacheMutex;
-
-    /**
-     * Condition used to signal that it is OK for another CacheGuard to enter a fetch phase.
-     * Manipulated via CacheGuard.
-     */
-    stdx::condition_variable _fetchPhaseIsReady;
+    stdx::mutex _cacheGenerationMutex;
 };
 }  // namespace mongo
@@ -165,6 +165,68 @@ TEST_F(AuthorizationManagerTest, testAcquireV2User) {
     authzManager->releaseUser(v2cluster);
 }
 
+TEST_F(AuthorizationManagerTest, testRoleChangeOnlyInvalidatesUsersWithTheRole) {
+    OperationContextNoop opCtx;
+
+    const auto insertUser = [&](StringData user, StringData role) {
+        ASSERT_OK(externalState->insertPrivilegeDocument(&opCtx,
+                                                         BSON("_id"
+                                                              << "test." + user.toString()
+                                                              << "user"
+                                                              << user
+                                                              << "db"
+                                                              << "test"
+                                                              << "credentials"
+                                                              << credentials
+                                                              << "roles"
+                                                              << BSON_ARRAY(BSON("role"
+                                                                                 << role
+                                                                                 << "db"
+                                                                                 << "test"))),
+                                                         BSONObj()));
+    };
+    insertUser("reader", "read");
+    insertUser("writer", "readWrite");
+
+    User* reader;
+    ASSERT_OK(authzManager->acquireUser(&opCtx, UserName("reader", "test"), &reader));
+    User* writer;
+    ASSERT_OK(authzManager->acquireUser(&opCtx, UserName("writer", "test"), &writer));
+
+    // Acquiring a cached user returns the same User object.
+    User* readerAgain;
+    ASSERT_OK(authzManager->acquireUser(&opCtx, UserName("reader", "test"), &readerAgain));
+    ASSERT_EQUALS(reader, readerAgain);
+    ASSERT_EQUALS(2U, reader->getRefCount());
+    authzManager->releaseUser(readerAgain);
+
+    // An update to the "read" role only invalidates the user which has it.
+    const auto oldGeneration = authzManager->getCacheGeneration();
+    const BSONObj roleId = BSON("_id"
+                                << "test.read");
+    authzManager->logOp(&opCtx,
+                        "u",
+                        AuthorizationManager::rolesCollectionNamespace,
+                        BSON("$set" << BSON("privileges" << BSONArray())),
+                        &roleId);
+    ASSERT_NOT_EQUALS(oldGeneration, authzManager->getCacheGeneration());
+    ASSERT_FALSE(reader->isValid());
+    ASSERT_TRUE(writer->isValid());
+
+    // The invalidated user is fetched again, while the other one is still cached.
+    ASSERT_OK(authzManager->acquireUser(&opCtx, UserName("reader", "test"), &readerAgain));
+    ASSERT_NOT_EQUALS(reader, readerAgain);
+    ASSERT_TRUE(readerAgain->isValid());
+    User* writerAgain;
+    ASSERT_OK(authzManager->acquireUser(&opCtx, UserName("writer", "test"), &writerAgain));
+    ASSERT_EQUALS(writer, writerAgain);
+
+    authzManager->releaseUser(reader);
+    authzManager->releaseUser(readerAgain);
+    authzManager->releaseUser(writer);
+    authzManager->releaseUser(writerAgain);
+}
+
 #ifdef MONGO_CONFIG_SSL
 TEST_F(AuthorizationManagerTest, testLocalX509Authorization) {
     ServiceContextNoop serviceContext;
@@ -889,6 +889,7 @@ void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx)
 }
 
 void AuthorizationSessionImpl::_buildAuthenticatedRolesVector() {
+    _authorizationDecisions.clear();
     _authenticatedRoleNames.clear();
     for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
          ++it) {
@@ -967,6 +968,27 @@ bool AuthorizationSessionImpl::isAuthorizedForAnyActionOnResource(const Resource
 
 
 bool AuthorizationSessionImpl::_isAuthorizedForPrivilege(const Privilege& privilege) {
+    PrivilegeVector defaultPrivileges = getDefaultPrivileges();
+    if (!defaultPrivileges.empty()) {
+        return _resolvePrivilege(privilege, defaultPrivileges);
+    }
+
+    AuthorizationDecisionKey key{privilege.getResourcePattern(), privilege.getActions()};
+    auto it = _authorizationDecisions.find(key);
+    if (it != _authorizationDecisions.end()) {
+        return it->second;
+    }
+
+    const bool authorized = _resolvePrivilege(privilege, defaultPrivileges);
+    if (_authorizationDecisions.size() >= kMaxAuthorizationDecisions) {
+        _authorizationDecisions.clear();
+    }
+    _authorizationDecisions.emplace(std::move(key), authorized);
+    return authorized;
+}
+
+bool AuthorizationSessionImpl::_resolvePrivilege(const Privilege& privilege,
+                                                 const PrivilegeVector& defaultPrivileges) {
     const ResourcePattern& target(privilege.getResourcePattern());
 
     ResourcePattern resourceSearchList[resourceSearchListCapacity];
@@ -974,8 +996,8 @@ bool AuthorizationSessionImpl::_isAuthorizedForPrivilege(const Privilege& privil
 
     ActionSet unmetRequirements = privilege.getActions();
 
-    PrivilegeVector defaultPrivileges = getDefaultPrivileges();
-    for (PrivilegeVector::iterator it = defaultPrivileges.begin(); it != defaultPrivileges.end();
+    for (PrivilegeVector::const_iterator it = defaultPrivileges.begin();
+         it != defaultPrivileges.end();
          ++it) {
         for (int i = 0; i < resourceSearchListLength; ++i) {
             if (!(it->getResourcePattern() == resourceSearchList[i]))
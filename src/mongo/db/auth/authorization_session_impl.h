@@ -41,9 +41,11 @@
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authz_session_external_state.h"
 #include "mongo/db/auth/privilege.h"
+#include "mongo/db/auth/resource_pattern.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -199,8 +201,9 @@ public:
 
 protected:
     // Builds a vector of all roles held by users who are authenticated on this connection. The
-    // vector is stored in _authenticatedRoleNames. This function is called when users are
-    // logged in or logged out, as well as when the user cache is determined to be out of date.
+    // vector is stored in _authenticatedRoleNames, and the memoized authorization decisions are
+    // dropped. This function is called when users are logged in or logged out, as well as when
+    // the user cache is determined to be out of date.
     void _buildAuthenticatedRolesVector();
 
     // All Users who have been authenticated on this connection.
@@ -221,12 +224,39 @@ private:
     // lock on the admin database (to update out-of-date user privilege information).
     bool _isAuthorizedForPrivilege(const Privilege& privilege);
 
+    // Resolves whether the default privileges or the privileges of the authenticated users grant
+    // the given Privilege.
+    bool _resolvePrivilege(const Privilege& privilege, const PrivilegeVector& defaultPrivileges);
+
     std::tuple<std::vector<UserName>*, std::vector<RoleName>*> _getImpersonations() override {
         return std::make_tuple(&_impersonatedUserNames, &_impersonatedRoleNames);
     }
 
     std::unique_ptr<AuthzSessionExternalState> _externalState;
 
+    struct AuthorizationDecisionKey {
+        bool operator==(const AuthorizationDecisionKey& other) const {
+            return resource == other.resource && actions == other.actions;
+        }
+
+        ResourcePattern resource;
+        ActionSet actions;
+    };
+
+    struct AuthorizationDecisionKeyHash {
+        size_t operator()(const AuthorizationDecisionKey& key) const {
+            return key.resource.hash() ^ key.actions.hash();
+        }
+    };
+
+    static const size_t kMaxAuthorizationDecisions = 64;
+
+    // The decisions of _isAuthorizedForPrivilege when there are no default privileges, in which
+    // case they only depend on the authenticated users. Cleared whenever those users change, so
+    // that repeated checks of the same command shape are a single lookup.
+    stdx::unordered_map<AuthorizationDecisionKey, bool, AuthorizationDecisionKeyHash>
+        _authorizationDecisions;
+
     // A vector of impersonated UserNames and a vector of those users' RoleNames.
     // These are used in the auditing system. They are not used for authz checks.
     std::vector<UserName> _impersonatedUserNames;
@@ -51,11 +51,13 @@ SHA256Block computeDigest(const UserName& name) {
 
 }  // namespace
 
+constexpr uint32_t User::kCacheRef;
+
 User::User(const UserName& name)
     : _name(name), _digest(computeDigest(_name)), _refCount(0), _isValid(1) {}
 
 User::~User() {
-    dassert(_refCount == 0);
+    dassert(_refCount.load() == 0);
 }
 
 template <>
@@ -88,6 +90,10 @@ bool User::hasRole(const RoleName& roleName) const {
     return _roles.count(roleName);
 }
 
+bool User::hasRoleOrIndirectRole(const RoleName& roleName) const {
+    return hasRole(roleName) || sequenceContains(_indirectRoles, roleName);
+}
+
 const User::CredentialData& User::getCredentials() const {
     return _credentials;
 }
@@ -97,7 +103,7 @@ bool User::isValid() const {
 }
 
 uint32_t User::getRefCount() const {
-    return _refCount;
+    return _refCount.load() & ~kCacheRef;
 }
 
 const ActionSet User::getActionsForResource(const ResourcePattern& resource) const {
@@ -175,11 +181,21 @@ void User::invalidate() {
 }
 
 void User::incrementRefCount() {
-    ++_refCount;
+    _refCount.fetchAndAdd(1);
+}
+
+bool User::decrementRefCount() {
+    dassert(getRefCount() > 0);
+    return _refCount.subtractAndFetch(1) == 0;
+}
+
+void User::addCacheRef() {
+    dassert(!(_refCount.load() & kCacheRef));
+    _refCount.fetchAndAdd(kCacheRef);
 }
 
-void User::decrementRefCount() {
-    dassert(_refCount > 0);
-    --_refCount;
+bool User::removeCacheRef() {
+    dassert(_refCount.load() & kCacheRef);
+    return _refCount.subtractAndFetch(kCacheRef) == 0;
 }
 }  // namespace mongo
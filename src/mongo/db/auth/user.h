@@ -133,6 +133,12 @@ public:
      */
     bool hasRole(const RoleName& roleName) const;
 
+    /**
+     * Returns true if this user is a member of the given role, either directly or through role
+     * inheritance.
+     */
+    bool hasRoleOrIndirectRole(const RoleName& roleName) const;
+
     /**
      * Returns a reference to the information about the user's privileges.
      */
@@ -163,8 +169,9 @@ public:
     bool isValid() const;
 
     /**
-     * This returns the reference count for this User.  The AuthorizationManager should be the
-     * only caller of this.
+     * This returns the reference count for this User, not counting the reference held by the
+     * AuthorizationManager's user cache.  The AuthorizationManager should be the only caller of
+     * this.
      */
     uint32_t getRefCount() const;
 
@@ -242,12 +249,28 @@ public:
 
     /**
      * Decrements the reference count for this User object, which records how many threads have
-     * a reference to it.  Once the reference count goes to zero, the AuthorizationManager is
-     * allowed to destroy this instance.
+     * a reference to it.  Returns true if no reference is left, including the user cache's, in
+     * which case the AuthorizationManager is allowed to destroy this instance.
+     *
+     * This method should *only* be called by the AuthorizationManager.
+     */
+    bool decrementRefCount();
+
+    /**
+     * Records that the AuthorizationManager's user cache holds this User object, which keeps it
+     * alive even when no thread has a reference to it.
      *
      * This method should *only* be called by the AuthorizationManager.
      */
-    void decrementRefCount();
+    void addCacheRef();
+
+    /**
+     * Drops the reference held by the user cache.  Returns true if no reference is left, in which
+     * case the AuthorizationManager is allowed to destroy this instance.
+     *
+     * This method should *only* be called by the AuthorizationManager.
+     */
+    bool removeCacheRef();
 
 private:
     UserName _name;
@@ -270,10 +293,14 @@ private:
     // Restrictions which must be met by a Client in order to authenticate as this user.
     RestrictionDocuments _restrictions;
 
+    // The bit of _refCount which records the reference held by the user cache.
+    static constexpr uint32_t kCacheRef = 1U << 31;
+
     // _refCount and _isInvalidated are modified exclusively by the AuthorizationManager
     // _isInvalidated can be read by any consumer of User, but _refCount can only be
-    // meaningfully read by the AuthorizationManager, as _refCount is guarded by the AM's _lock
-    uint32_t _refCount;
+    // meaningfully read by the AuthorizationManager. _refCount is atomic, because the
+    // AuthorizationManager takes references on cached users without holding any lock.
+    AtomicUInt32 _refCount;
     AtomicUInt32 _isValid;  // Using as a boolean
 };
 
@@ -226,6 +226,13 @@ public:
                                     bool noWarn,
                                     StoreDeletedDoc storeDeletedDoc) = 0;
 
+        virtual void deleteDocuments(OperationContext* opCtx,
+                                     StmtId stmtId,
+                                     const std::vector<RecordId>& locs,
+                                     OpDebug* opDebug,
+                                     bool fromMigrate,
+                                     bool noWarn) = 0;
+
         virtual Status insertDocuments(OperationContext* opCtx,
                                        std::vector<InsertStatement>::const_iterator begin,
                                        std::vector<InsertStatement>::const_iterator end,
@@ -256,7 +263,8 @@ public:
                                         bool enforceQuota,
                                         bool indexesAffected,
                                         OpDebug* opDebug,
-                                        OplogUpdateEntryArgs* args) = 0;
+                                        OplogUpdateEntryArgs* args,
+                                        const std::vector<std::string>* modifiedIndexedPaths) = 0;
 
         virtual bool updateWithDamagesSupported() const = 0;
 
@@ -463,6 +471,23 @@ public:
             opCtx, stmtId, loc, opDebug, fromMigrate, noWarn, storeDeletedDoc);
     }
 
+    /**
+     * Deletes the documents with the given RecordIds from the collection, as deleteDocument()
+     * would. When the deletes are not replicated, and so not timestamped, their index keys are
+     * removed together in one sorted pass per index. Otherwise each document's keys are removed
+     * after its oplog entry is logged, at that entry's timestamp. The caller must
+     * hold a WriteUnitOfWork around the call, so all of the deletes and their oplog entries
+     * commit as a single storage transaction. Deleted documents are never stored in the oplog.
+     */
+    inline void deleteDocuments(OperationContext* const opCtx,
+                                StmtId stmtId,
+                                const std::vector<RecordId>& locs,
+                                OpDebug* const opDebug,
+                                const bool fromMigrate = false,
+                                const bool noWarn = false) {
+        return this->_impl().deleteDocuments(opCtx, stmtId, locs, opDebug, fromMigrate, noWarn);
+    }
+
     /*
      * Inserts all documents inside one WUOW.
      * Caller should ensure vector is appropriately sized for this.
@@ -524,18 +549,30 @@ public:
      * Sets 'args.updatedDoc' to the updated version of the document with damages applied, on
      * success.
      * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
+     * 'modifiedIndexedPaths' Optional argument. When not null and 'indexesAffected' is true, only
+     * the indexes which might index one of these paths are updated, as for
+     * UpdateIndexData::mightBeIndexed().
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
-    inline RecordId updateDocument(OperationContext* const opCtx,
-                                   const RecordId& oldLocation,
-                                   const Snapshotted<BSONObj>& oldDoc,
-                                   const BSONObj& newDoc,
-                                   const bool enforceQuota,
-                                   const bool indexesAffected,
-                                   OpDebug* const opDebug,
-                                   OplogUpdateEntryArgs* const args) {
-        return this->_impl().updateDocument(
-            opCtx, oldLocation, oldDoc, newDoc, enforceQuota, indexesAffected, opDebug, args);
+    inline RecordId updateDocument(
+        OperationContext* const opCtx,
+        const RecordId& oldLocation,
+        const Snapshotted<BSONObj>& oldDoc,
+        const BSONObj& newDoc,
+        const bool enforceQuota,
+        const bool indexesAffected,
+        OpDebug* const opDebug,
+        OplogUpdateEntryArgs* const args,
+        const std::vector<std::string>* const modifiedIndexedPaths = nullptr) {
+        return this->_impl().updateDocument(opCtx,
+                                            oldLocation,
+                                            oldDoc,
+                                            newDoc,
+                                            enforceQuota,
+                                            indexesAffected,
+                                            opDebug,
+                                            args,
+                                            modifiedIndexedPaths);
     }
 
     inline bool updateWithDamagesSupported() const {
@@ -34,6 +34,8 @@
 
 #include "mongo/db/catalog/collection_impl.h"
 
+#include <algorithm>
+
 #include "mongo/base/counter.h"
 #include "mongo/base/init.h"
 #include "mongo/base/owned_pointer_map.h"
@@ -48,14 +50,19 @@
 #include "mongo/db/catalog/index_consistency.h"
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/catalog/namespace_uuid_cache.h"
+#include "mongo/db/catalog/partial_filter_set.h"
 #include "mongo/db/catalog/uuid_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/concurrency/write_conflict_stats.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/schema/json_schema_compiler.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/update_request.h"
@@ -67,10 +74,12 @@
 #include "mongo/db/storage/mmap_v1/mmap_v1_options.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/update/update_driver.h"
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/rpc/object_check.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -129,6 +138,33 @@ std::unique_ptr<CollatorInterface> parseCollation(OperationContext* opCtx,
 
     return std::move(collator.getValue());
 }
+
+// Returns a compiled form of 'validatorDoc' if it consists of a single $jsonSchema which can be
+// compiled, or null otherwise. The validator must already have been parsed successfully.
+std::unique_ptr<CompiledJSONSchema> compileValidator(const BSONObj& validatorDoc) {
+    if (validatorDoc.nFields() != 1) {
+        return {nullptr};
+    }
+
+    auto jsonSchemaElt = validatorDoc.firstElement();
+    if (jsonSchemaElt.fieldNameStringData() != "$jsonSchema"_sd ||
+        jsonSchemaElt.type() != BSONType::Object) {
+        return {nullptr};
+    }
+    return CompiledJSONSchema::compile(jsonSchemaElt.embeddedObject());
+}
+
+// Runs 'writeRecord', a write of the record at 'loc', and reports 'loc' to the write conflict
+// stats if the write conflicts with another operation.
+template <typename F>
+auto sampleWriteConflicts(const NamespaceString& nss, const RecordId& loc, F&& writeRecord) {
+    try {
+        return writeRecord();
+    } catch (const WriteConflictException&) {
+        WriteConflictStats::get().recordConflictingDocument(nss.ns(), loc);
+        throw;
+    }
+}
 }  // namespace
 
 using std::unique_ptr;
@@ -157,6 +193,7 @@ CollectionImpl::CollectionImpl(Collection* _this_init,
       _validatorDoc(_details->getCollectionOptions(opCtx).validator.getOwned()),
       _validator(uassertStatusOK(
           parseValidator(opCtx, _validatorDoc, MatchExpressionParser::kAllowAllSpecialFeatures))),
+      _compiledValidator(compileValidator(_validatorDoc)),
       _validationAction(uassertStatusOK(
           parseValidationAction(_details->getCollectionOptions(opCtx).validationAction))),
       _validationLevel(uassertStatusOK(
@@ -258,7 +295,9 @@ Status CollectionImpl::checkValidation(OperationContext* opCtx, const BSONObj& d
     if (documentValidationDisabled(opCtx))
         return Status::OK();
 
-    if (_validator->matchesBSON(document))
+    const bool matches = _compiledValidator ? _compiledValidator->matches(document)
+                                            : _validator->matchesBSON(document);
+    if (matches)
         return Status::OK();
 
     if (_validationAction == ValidationAction::WARN) {
@@ -581,12 +620,73 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
         opDebug->keysDeleted += keysDeleted;
     }
 
-    _recordStore->deleteRecord(opCtx, loc);
+    sampleWriteConflicts(ns(), loc, [&] { _recordStore->deleteRecord(opCtx, loc); });
 
     getGlobalServiceContext()->getOpObserver()->onDelete(
         opCtx, ns(), uuid(), stmtId, fromMigrate, deletedDoc);
 }
 
+void CollectionImpl::deleteDocuments(OperationContext* opCtx,
+                                     StmtId stmtId,
+                                     const std::vector<RecordId>& locs,
+                                     OpDebug* opDebug,
+                                     bool fromMigrate,
+                                     bool noWarn) {
+    if (isCapped()) {
+        log() << "failing remove on a capped ns " << _ns;
+        uasserted(10089, "cannot remove from a capped collection");
+        return;
+    }
+
+    std::vector<Snapshotted<BSONObj>> docs;
+    docs.reserve(locs.size());
+    std::vector<BsonRecord> bsonRecords;
+    bsonRecords.reserve(locs.size());
+    for (auto&& loc : locs) {
+        docs.push_back(docFor(opCtx, loc));
+        /* check if any cursors point to us.  if so, advance them. */
+        _cursorManager.invalidateDocument(opCtx, loc, INVALIDATION_DELETION);
+    }
+    for (size_t i = 0; i < locs.size(); ++i) {
+        bsonRecords.push_back({locs[i], Timestamp(), &docs[i].value()});
+    }
+
+    // Each oplog entry sets the timestamp of the writes which follow it in the storage
+    // transaction. When the deletes are replicated, each document's entry is therefore logged
+    // before its record and index keys are removed, so that they are removed at that entry's
+    // timestamp. Otherwise nothing is timestamped, and the keys of the whole batch are removed
+    // together.
+    const bool timestamped =
+        !repl::ReplicationCoordinator::get(opCtx)->isOplogDisabledFor(opCtx, _ns);
+
+    int64_t keysDeleted = 0;
+    if (!timestamped) {
+        _indexCatalog.unindexRecords(opCtx, bsonRecords, noWarn, &keysDeleted);
+    }
+
+    // The observer keeps the state captured by aboutToDelete() only until the matching onDelete(),
+    // so the two are paired per document.
+    auto opObserver = getGlobalServiceContext()->getOpObserver();
+    for (size_t i = 0; i < locs.size(); ++i) {
+        opObserver->aboutToDelete(opCtx, ns(), docs[i].value());
+        if (timestamped) {
+            opObserver->onDelete(opCtx, ns(), uuid(), stmtId, fromMigrate, boost::none);
+
+            int64_t docKeysDeleted;
+            _indexCatalog.unindexRecords(opCtx, {bsonRecords[i]}, noWarn, &docKeysDeleted);
+            keysDeleted += docKeysDeleted;
+            _recordStore->deleteRecord(opCtx, locs[i]);
+        } else {
+            _recordStore->deleteRecord(opCtx, locs[i]);
+            opObserver->onDelete(opCtx, ns(), uuid(), stmtId, fromMigrate, boost::none);
+        }
+    }
+
+    if (opDebug) {
+        opDebug->keysDeleted += keysDeleted;
+    }
+}
+
 Counter64 moveCounter;
 ServerStatusMetricField<Counter64> moveCounterDisplay("record.moves", &moveCounter);
 
@@ -597,7 +697,8 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                         bool enforceQuota,
                                         bool indexesAffected,
                                         OpDebug* opDebug,
-                                        OplogUpdateEntryArgs* args) {
+                                        OplogUpdateEntryArgs* args,
+                                        const std::vector<std::string>* modifiedIndexedPaths) {
     {
         auto status = checkValidation(opCtx, newDoc);
         if (!status.isOK()) {
@@ -647,19 +748,36 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                 << " != "
                                 << newDoc.objsize());
 
-    // At the end of this step, we will have a map of UpdateTickets, one per index, which
+    // At the end of this step, we will have a map of UpdateTickets, one per affected index, which
     // represent the index updates needed to be done, based on the changes between oldDoc and
-    // newDoc.
+    // newDoc. Indexes none of whose paths were modified keep their keys, so they get no ticket.
     OwnedPointerMap<IndexDescriptor*, UpdateTicket> updateTickets;
     if (indexesAffected) {
+        // The partial filters of all indexes are evaluated together against each version of the
+        // document, the first time an affected index turns out to have one.
+        const PartialFilterSet& partialFilters = _indexCatalog.getPartialFilterSet();
+        boost::optional<PartialFilterSet::Matches> oldFilterMatches;
+        boost::optional<PartialFilterSet::Matches> newFilterMatches;
+
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(opCtx, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
+            if (modifiedIndexedPaths &&
+                !_indexMightBeAffected(opCtx, descriptor, *modifiedIndexedPaths)) {
+                continue;
+            }
+
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
             InsertDeleteOptions options;
             IndexCatalog::prepareInsertDeleteOptions(opCtx, descriptor, &options);
+            const MatchExpression* filter = entry->getFilterExpression();
+            if (filter && !oldFilterMatches) {
+                oldFilterMatches = partialFilters.evaluate(oldDoc.value());
+                newFilterMatches = partialFilters.evaluate(newDoc);
+            }
+
             UpdateTicket* updateTicket = new UpdateTicket();
             updateTickets.mutableMap()[descriptor] = updateTicket;
             uassertStatusOK(iam->validateUpdate(opCtx,
@@ -668,14 +786,21 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                                 oldLocation,
                                                 options,
                                                 updateTicket,
-                                                entry->getFilterExpression()));
+                                                !filter || oldFilterMatches->matched(filter),
+                                                !filter || newFilterMatches->matched(filter)));
         }
     }
 
     args->preImageDoc = oldDoc.value().getOwned();
 
-    Status updateStatus = _recordStore->updateRecord(
-        opCtx, oldLocation, newDoc.objdata(), newDoc.objsize(), _enforceQuota(enforceQuota), this);
+    Status updateStatus = sampleWriteConflicts(ns(), oldLocation, [&] {
+        return _recordStore->updateRecord(opCtx,
+                                          oldLocation,
+                                          newDoc.objdata(),
+                                          newDoc.objsize(),
+                                          _enforceQuota(enforceQuota),
+                                          this);
+    });
 
     if (updateStatus == ErrorCodes::NeedsDocumentMove) {
         return uassertStatusOK(_updateDocumentWithMove(
@@ -688,12 +813,15 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(opCtx, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
+            auto ticket = updateTickets.mutableMap().find(descriptor);
+            if (ticket == updateTickets.mutableMap().end()) {
+                continue;
+            }
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
             int64_t keysInserted;
             int64_t keysDeleted;
-            uassertStatusOK(iam->update(
-                opCtx, *updateTickets.mutableMap()[descriptor], &keysInserted, &keysDeleted));
+            uassertStatusOK(iam->update(opCtx, *ticket->second, &keysInserted, &keysDeleted));
             if (opDebug) {
                 opDebug->keysInserted += keysInserted;
                 opDebug->keysDeleted += keysDeleted;
@@ -709,6 +837,20 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
     return {oldLocation};
 }
 
+bool CollectionImpl::_indexMightBeAffected(
+    OperationContext* opCtx,
+    const IndexDescriptor* descriptor,
+    const std::vector<std::string>& modifiedIndexedPaths) const {
+    const UpdateIndexData* indexedPaths =
+        _infoCache.getIndexKeys(opCtx, descriptor->indexName());
+    if (!indexedPaths) {
+        return true;
+    }
+    return std::any_of(modifiedIndexedPaths.begin(),
+                       modifiedIndexedPaths.end(),
+                       [&](const std::string& path) { return indexedPaths->mightBeIndexed(path); });
+}
+
 StatusWith<RecordId> CollectionImpl::_updateDocumentWithMove(OperationContext* opCtx,
                                                              const RecordId& oldLocation,
                                                              const Snapshotted<BSONObj>& oldDoc,
@@ -793,8 +935,9 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
     // Broadcast the mutation so that query results stay correct.
     _cursorManager.invalidateDocument(opCtx, loc, INVALIDATION_MUTATION);
 
-    auto newRecStatus =
-        _recordStore->updateWithDamages(opCtx, loc, oldRec.value(), damageSource, damages);
+    auto newRecStatus = sampleWriteConflicts(ns(), loc, [&] {
+        return _recordStore->updateWithDamages(opCtx, loc, oldRec.value(), damageSource, damages);
+    });
 
     if (newRecStatus.isOK()) {
         args->updatedDoc = newRecStatus.getValue().toBson();
@@ -929,12 +1072,15 @@ Status CollectionImpl::setValidator(OperationContext* opCtx, BSONObj validatorDo
     opCtx->recoveryUnit()->onRollback([
         this,
         oldValidator = std::move(_validator),
+        oldCompiledValidator = std::move(_compiledValidator),
         oldValidatorDoc = std::move(_validatorDoc)
     ]() mutable {
         this->_validator = std::move(oldValidator);
+        this->_compiledValidator = std::move(oldCompiledValidator);
         this->_validatorDoc = std::move(oldValidatorDoc);
     });
     _validator = std::move(statusWithMatcher.getValue());
+    _compiledValidator = _validator ? compileValidator(validatorDoc) : nullptr;
     _validatorDoc = std::move(validatorDoc);
     return Status::OK();
 }
@@ -1036,11 +1182,13 @@ Status CollectionImpl::updateValidator(OperationContext* opCtx,
     opCtx->recoveryUnit()->onRollback([
         this,
         oldValidator = std::move(_validator),
+        oldCompiledValidator = std::move(_compiledValidator),
         oldValidatorDoc = std::move(_validatorDoc),
         oldValidationLevel = _validationLevel,
         oldValidationAction = _validationAction
     ]() mutable {
         this->_validator = std::move(oldValidator);
+        this->_compiledValidator = std::move(oldCompiledValidator);
         this->_validatorDoc = std::move(oldValidatorDoc);
         this->_validationLevel = oldValidationLevel;
         this->_validationAction = oldValidationAction;
@@ -1055,6 +1203,7 @@ Status CollectionImpl::updateValidator(OperationContext* opCtx,
         return validatorSW.getStatus();
     }
     _validator = std::move(validatorSW.getValue());
+    _compiledValidator = _validator ? compileValidator(_validatorDoc) : nullptr;
 
     auto levelSW = parseValidationLevel(newLevel);
     if (!levelSW.isOK()) {
@@ -1099,48 +1248,147 @@ void _validateRecordStore(OperationContext* opCtx,
     }
 }
 
+// The most threads that a foreground validate scans indexes on at the same time.
+MONGO_EXPORT_SERVER_PARAMETER(validateIndexScanThreads, int, 4)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "validateIndexScanThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+// What validating a single index found. Indexes may be scanned on separate threads, so each scan
+// works on its own copy of the index's results and they are merged back in afterwards.
+struct IndexScanResults {
+    ValidateResults results;
+    bool checkCounts = false;
+    int64_t numTraversedKeys = 0;
+    int64_t numValidatedKeys = 0;
+};
+
+void _scanIndex(OperationContext* opCtx,
+                IndexCatalog* indexCatalog,
+                const IndexDescriptor* descriptor,
+                RecordStoreValidateAdaptor* indexValidator,
+                ValidateCmdLevel level,
+                IndexScanResults* scan) {
+    log(LogComponent::kIndex) << "validating index " << descriptor->indexNamespace() << endl;
+    IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
+
+    if (level == kValidateFull) {
+        iam->validate(opCtx, &scan->numValidatedKeys, &scan->results);
+        scan->checkCounts = true;
+    }
+
+    if (scan->results.valid) {
+        indexValidator->traverseIndex(
+            opCtx, iam, descriptor, &scan->results, &scan->numTraversedKeys);
+    }
+}
+
+void _scanIndexes(OperationContext* opCtx,
+                  IndexCatalog* indexCatalog,
+                  const std::vector<const IndexDescriptor*>& descriptors,
+                  RecordStoreValidateAdaptor* indexValidator,
+                  ValidateCmdLevel level,
+                  bool background,
+                  std::vector<IndexScanResults>* scans) {
+    const size_t numThreads =
+        std::min(descriptors.size(), static_cast<size_t>(validateIndexScanThreads.load()));
+
+    // The scans on other threads read without locks, relying on this operation's exclusive
+    // collection lock to keep writers out. MMAPv1 needs every reader to hold the flush lock, so it
+    // scans one index at a time, as does a background validation.
+    const bool isMmapV1 = opCtx->getServiceContext()->getStorageEngine()->isMmapV1();
+    if (numThreads <= 1 || background || isMmapV1) {
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            opCtx->checkForInterrupt();
+            _scanIndex(opCtx, indexCatalog, descriptors[i], indexValidator, level, &(*scans)[i]);
+        }
+        return;
+    }
+
+    // Declared before the pool, whose destructor waits for any scheduled scans to return.
+    std::vector<Status> statuses(descriptors.size(), Status::OK());
+
+    ThreadPool::Options options;
+    options.poolName = "ValidateIndexScanners";
+    options.threadNamePrefix = "ValidateIndexScanner-";
+    options.maxThreads = numThreads;
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThreadIfNotAlready(threadName);
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    for (size_t i = 0; i < descriptors.size(); ++i) {
+        uassertStatusOK(pool.schedule([&, i] {
+            try {
+                auto scanOpCtx = cc().makeOperationContext();
+                _scanIndex(scanOpCtx.get(),
+                           indexCatalog,
+                           descriptors[i],
+                           indexValidator,
+                           level,
+                           &(*scans)[i]);
+            } catch (const DBException& ex) {
+                statuses[i] = ex.toStatus();
+            }
+        }));
+    }
+    pool.shutdown();
+    pool.join();
+
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+}
+
 void _validateIndexes(OperationContext* opCtx,
                       IndexCatalog* indexCatalog,
                       BSONObjBuilder* keysPerIndex,
                       RecordStoreValidateAdaptor* indexValidator,
                       ValidateCmdLevel level,
+                      bool background,
                       ValidateResultsMap* indexNsResultsMap,
                       ValidateResults* results) {
 
+    std::vector<const IndexDescriptor*> descriptors;
     IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator(opCtx, false);
+    while (i.more()) {
+        descriptors.push_back(i.next());
+    }
+
+    // Each scan starts from what the collection scan found for its index.
+    std::vector<IndexScanResults> scans(descriptors.size());
+    for (size_t idx = 0; idx < descriptors.size(); ++idx) {
+        scans[idx].results = (*indexNsResultsMap)[descriptors[idx]->indexNamespace()];
+    }
 
     // Validate Indexes.
-    while (i.more()) {
-        opCtx->checkForInterrupt();
-        const IndexDescriptor* descriptor = i.next();
-        log(LogComponent::kIndex) << "validating index " << descriptor->indexNamespace() << endl;
-        IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
-        ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
-        bool checkCounts = false;
-        int64_t numTraversedKeys;
-        int64_t numValidatedKeys;
+    _scanIndexes(opCtx, indexCatalog, descriptors, indexValidator, level, background, &scans);
 
-        if (level == kValidateFull) {
-            iam->validate(opCtx, &numValidatedKeys, &curIndexResults);
-            checkCounts = true;
-        }
+    for (size_t idx = 0; idx < descriptors.size(); ++idx) {
+        const IndexDescriptor* descriptor = descriptors[idx];
+        IndexScanResults& scan = scans[idx];
+        ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
+        curIndexResults = std::move(scan.results);
 
         if (curIndexResults.valid) {
-            indexValidator->traverseIndex(iam, descriptor, &curIndexResults, &numTraversedKeys);
-
-            if (checkCounts && (numValidatedKeys != numTraversedKeys)) {
+            if (scan.checkCounts && (scan.numValidatedKeys != scan.numTraversedKeys)) {
                 curIndexResults.valid = false;
                 string msg = str::stream()
-                    << "number of traversed index entries (" << numTraversedKeys
-                    << ") does not match the number of expected index entries (" << numValidatedKeys
-                    << ")";
+                    << "number of traversed index entries (" << scan.numTraversedKeys
+                    << ") does not match the number of expected index entries ("
+                    << scan.numValidatedKeys << ")";
                 results->errors.push_back(msg);
                 results->valid = false;
             }
 
             if (curIndexResults.valid) {
                 keysPerIndex->appendNumber(descriptor->indexNamespace(),
-                                           static_cast<long long>(numTraversedKeys));
+                                           static_cast<long long>(scan.numTraversedKeys));
             } else {
                 results->valid = false;
             }
@@ -1312,6 +1560,7 @@ Status CollectionImpl::validate(OperationContext* opCtx,
                              &keysPerIndex,
                              &indexValidator,
                              level,
+                             background,
                              &indexNsResultsMap,
                              results);
 
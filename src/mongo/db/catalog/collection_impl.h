@@ -35,6 +35,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 
 namespace mongo {
+class CompiledJSONSchema;
 class IndexConsistency;
 class UUIDCatalog;
 class CollectionImpl final : virtual public Collection::Impl,
@@ -154,6 +155,17 @@ public:
         bool noWarn = false,
         Collection::StoreDeletedDoc storeDeletedDoc = Collection::StoreDeletedDoc::Off) final;
 
+    /**
+     * Deletes the documents at 'locs', removing their index keys in one sorted pass per index
+     * unless the deletes are timestamped. Must be called within a WriteUnitOfWork.
+     */
+    void deleteDocuments(OperationContext* opCtx,
+                         StmtId stmtId,
+                         const std::vector<RecordId>& locs,
+                         OpDebug* opDebug,
+                         bool fromMigrate = false,
+                         bool noWarn = false) final;
+
     /*
      * Inserts all documents inside one WUOW.
      * Caller should ensure vector is appropriately sized for this.
@@ -216,7 +228,8 @@ public:
                             bool enforceQuota,
                             bool indexesAffected,
                             OpDebug* opDebug,
-                            OplogUpdateEntryArgs* args) final;
+                            OplogUpdateEntryArgs* args,
+                            const std::vector<std::string>* modifiedIndexedPaths) final;
 
     bool updateWithDamagesSupported() const final;
 
@@ -415,6 +428,14 @@ private:
                                                  OplogUpdateEntryArgs* args,
                                                  const SnapshotId& sid);
 
+    /**
+     * Returns true if 'descriptor' might index one of 'modifiedIndexedPaths', or if nothing is
+     * known about the paths it indexes.
+     */
+    bool _indexMightBeAffected(OperationContext* opCtx,
+                               const IndexDescriptor* descriptor,
+                               const std::vector<std::string>& modifiedIndexedPaths) const;
+
     bool _enforceQuota(bool userEnforeQuota) const;
 
     int _magic;
@@ -441,6 +462,10 @@ private:
     // Points into _validatorDoc. Null means no filter.
     std::unique_ptr<MatchExpression> _validator;
 
+    // A faster equivalent of _validator, used instead of it when the validator is a $jsonSchema
+    // which can be compiled. Null otherwise.
+    std::unique_ptr<CompiledJSONSchema> _compiledValidator;
+
     ValidationAction _validationAction;
     ValidationLevel _validationLevel;
 
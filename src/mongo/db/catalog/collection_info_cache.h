@@ -30,6 +30,7 @@
 
 #include "mongo/base/shim.h"
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -54,8 +55,13 @@ public:
 
         virtual QuerySettings* getQuerySettings() const = 0;
 
+        virtual CollectionStatistics* getCollectionStatistics() const = 0;
+
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
+        virtual const UpdateIndexData* getIndexKeys(OperationContext* opCtx,
+                                                    StringData indexName) const = 0;
+
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
 
         virtual void init(OperationContext* opCtx) = 0;
@@ -103,6 +109,13 @@ public:
         return this->_impl().getQuerySettings();
     }
 
+    /**
+     * Get the index statistics the analyze command gathered for this collection.
+     */
+    inline CollectionStatistics* getCollectionStatistics() const {
+        return this->_impl().getCollectionStatistics();
+    }
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -110,6 +123,15 @@ public:
         return this->_impl().getIndexKeys(opCtx);
     }
 
+    /**
+     * Get the set of paths indexed by the index named 'indexName' alone, or nullptr if there is
+     * no such index.
+     */
+    inline const UpdateIndexData* getIndexKeys(OperationContext* const opCtx,
+                                               const StringData indexName) const {
+        return this->_impl().getIndexKeys(opCtx, indexName);
+    }
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
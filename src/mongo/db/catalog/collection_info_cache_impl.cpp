@@ -61,6 +61,7 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(stdx::make_unique<PlanCache>(ns.ns())),
       _querySettings(stdx::make_unique<QuerySettings>()),
+      _collectionStatistics(stdx::make_unique<CollectionStatistics>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
@@ -78,8 +79,68 @@ const UpdateIndexData& CollectionInfoCacheImpl::getIndexKeys(OperationContext* o
     return _indexedPaths;
 }
 
+const UpdateIndexData* CollectionInfoCacheImpl::getIndexKeys(OperationContext* opCtx,
+                                                             StringData indexName) const {
+    dassert(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
+    invariant(_keysComputed);
+    auto it = _indexedPathsByIndex.find(indexName);
+    return it == _indexedPathsByIndex.end() ? nullptr : &it->second;
+}
+
+namespace {
+
+/**
+ * Adds the paths which can affect the keys or the membership of the index 'descriptor' to
+ * 'indexedPaths'.
+ */
+void addIndexedPaths(const IndexDescriptor* descriptor,
+                     const IndexCatalogEntry* entry,
+                     UpdateIndexData* indexedPaths) {
+    if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
+        BSONObjIterator j(descriptor->keyPattern());
+        while (j.more()) {
+            BSONElement e = j.next();
+            indexedPaths->addPath(e.fieldName());
+        }
+    } else {
+        fts::FTSSpec ftsSpec(descriptor->infoObj());
+
+        if (ftsSpec.wildcard()) {
+            indexedPaths->allPathsIndexed();
+        } else {
+            for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
+                indexedPaths->addPath(ftsSpec.extraBefore(i));
+            }
+            for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
+                 it != ftsSpec.weights().end();
+                 ++it) {
+                indexedPaths->addPath(it->first);
+            }
+            for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
+                indexedPaths->addPath(ftsSpec.extraAfter(i));
+            }
+            // Any update to a path containing "language" as a component could change the
+            // language of a subdocument.  Add the override field as a path component.
+            indexedPaths->addPathComponent(ftsSpec.languageOverrideField());
+        }
+    }
+
+    // handle partial indexes
+    const MatchExpression* filter = entry->getFilterExpression();
+    if (filter) {
+        stdx::unordered_set<std::string> paths;
+        QueryPlannerIXSelect::getFields(filter, "", &paths);
+        for (auto it = paths.begin(); it != paths.end(); ++it) {
+            indexedPaths->addPath(*it);
+        }
+    }
+}
+
+}  // namespace
+
 void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
     _indexedPaths.clear();
+    _indexedPathsByIndex.clear();
 
     bool hadTTLIndex = _hasTTLIndex;
     _hasTTLIndex = false;
@@ -87,51 +148,15 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
     IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(opCtx, true);
     while (i.more()) {
         IndexDescriptor* descriptor = i.next();
+        const IndexCatalogEntry* entry = i.catalogEntry(descriptor);
 
-        if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
-            BSONObj key = descriptor->keyPattern();
-            const BSONObj& infoObj = descriptor->infoObj();
-            if (infoObj.hasField("expireAfterSeconds")) {
-                _hasTTLIndex = true;
-            }
-            BSONObjIterator j(key);
-            while (j.more()) {
-                BSONElement e = j.next();
-                _indexedPaths.addPath(e.fieldName());
-            }
-        } else {
-            fts::FTSSpec ftsSpec(descriptor->infoObj());
-
-            if (ftsSpec.wildcard()) {
-                _indexedPaths.allPathsIndexed();
-            } else {
-                for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraBefore(i));
-                }
-                for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
-                     it != ftsSpec.weights().end();
-                     ++it) {
-                    _indexedPaths.addPath(it->first);
-                }
-                for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraAfter(i));
-                }
-                // Any update to a path containing "language" as a component could change the
-                // language of a subdocument.  Add the override field as a path component.
-                _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
-            }
+        if (descriptor->getAccessMethodName() != IndexNames::TEXT &&
+            descriptor->infoObj().hasField("expireAfterSeconds")) {
+            _hasTTLIndex = true;
         }
 
-        // handle partial indexes
-        const IndexCatalogEntry* entry = i.catalogEntry(descriptor);
-        const MatchExpression* filter = entry->getFilterExpression();
-        if (filter) {
-            stdx::unordered_set<std::string> paths;
-            QueryPlannerIXSelect::getFields(filter, "", &paths);
-            for (auto it = paths.begin(); it != paths.end(); ++it) {
-                _indexedPaths.addPath(*it);
-            }
-        }
+        addIndexedPaths(descriptor, entry, &_indexedPaths);
+        addIndexedPaths(descriptor, entry, &_indexedPathsByIndex[descriptor->indexName()]);
     }
 
     TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
@@ -174,6 +199,10 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+CollectionStatistics* CollectionInfoCacheImpl::getCollectionStatistics() const {
+    return _collectionStatistics.get();
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<IndexEntry> indexEntries;
 
@@ -231,6 +260,7 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
 
     rebuildIndexData(opCtx);
     _indexUsageTracker.unregisterIndex(indexName);
+    _collectionStatistics->remove(indexName);
 }
 
 void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
@@ -32,9 +32,11 @@
 
 #include "mongo/base/shim.h"
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -62,11 +64,22 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the index statistics the analyze command gathered for this collection.
+     */
+    CollectionStatistics* getCollectionStatistics() const;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
     const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const;
 
+    /**
+     * Get the set of paths indexed by the index named 'indexName' alone, or nullptr if there is
+     * no such index.
+     */
+    const UpdateIndexData* getIndexKeys(OperationContext* opCtx, StringData indexName) const;
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -124,6 +137,8 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    // The same paths, split up by the name of the index which depends on them.
+    StringMap<UpdateIndexData> _indexedPathsByIndex;
 
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
@@ -132,6 +147,9 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Index statistics for cardinality estimates.
+    std::unique_ptr<CollectionStatistics> _collectionStatistics;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
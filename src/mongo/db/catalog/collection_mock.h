@@ -138,6 +138,15 @@ public:
         std::abort();
     }
 
+    void deleteDocuments(OperationContext* opCtx,
+                         StmtId stmtId,
+                         const std::vector<RecordId>& locs,
+                         OpDebug* opDebug,
+                         bool fromMigrate,
+                         bool noWarn) {
+        std::abort();
+    }
+
     Status insertDocuments(OperationContext* opCtx,
                            std::vector<InsertStatement>::const_iterator begin,
                            std::vector<InsertStatement>::const_iterator end,
@@ -176,7 +185,8 @@ public:
                             bool enforceQuota,
                             bool indexesAffected,
                             OpDebug* opDebug,
-                            OplogUpdateEntryArgs* args) {
+                            OplogUpdateEntryArgs* args,
+                            const std::vector<std::string>* modifiedIndexedPaths) {
         std::abort();
     }
 
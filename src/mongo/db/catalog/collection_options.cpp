@@ -38,6 +38,7 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -250,6 +251,12 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             }
 
             pipeline = e.Obj().getOwned();
+        } else if (fieldName == "materialized") {
+            if (!e.isBoolean()) {
+                return Status(ErrorCodes::BadValue, "'materialized' has to be a boolean.");
+            }
+
+            materialized = e.boolean();
         } else if (fieldName == "idIndex" && kind == parseForCommand) {
             if (e.type() != mongo::Object) {
                 return Status(ErrorCodes::TypeMismatch, "'idIndex' has to be an object.");
@@ -261,6 +268,17 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             }
 
             idIndex = std::move(tempIdIndex);
+        } else if (fieldName == "timeseries" && kind == parseForCommand) {
+            if (e.type() != mongo::Object) {
+                return Status(ErrorCodes::TypeMismatch, "'timeseries' has to be an object.");
+            }
+
+            auto swTimeseriesOptions = timeseries::TimeseriesOptions::parse(e.Obj());
+            if (!swTimeseriesOptions.isOK()) {
+                return swTimeseriesOptions.getStatus().withContext("Error in timeseries");
+            }
+
+            timeseries = e.Obj().getOwned();
         } else if (!createdOn24OrEarlier && !mongo::isGenericArgument(fieldName)) {
             return Status(ErrorCodes::InvalidOptions,
                           str::stream() << "The field '" << fieldName
@@ -273,6 +291,15 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (viewOn.empty() && materialized) {
+        return Status(ErrorCodes::BadValue, "'materialized' cannot be specified without 'viewOn'");
+    }
+
+    if (!timeseries.isEmpty() && (!viewOn.empty() || capped)) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "'timeseries' cannot be specified with 'viewOn' or 'capped'");
+    }
+
     return Status::OK();
 }
 
@@ -341,9 +368,17 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
         builder->appendArray("pipeline", pipeline);
     }
 
+    if (materialized) {
+        builder->appendBool("materialized", true);
+    }
+
     if (!idIndex.isEmpty()) {
         builder->append("idIndex", idIndex);
     }
+
+    if (!timeseries.isEmpty()) {
+        builder->append("timeseries", timeseries);
+    }
 }
 
 bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
@@ -430,6 +465,14 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (materialized != other.materialized) {
+        return false;
+    }
+
+    if (timeseries.woCompare(other.timeseries) != 0) {
+        return false;
+    }
+
     return true;
 }
 }
@@ -154,5 +154,13 @@ struct CollectionOptions {
     std::string viewOn;
     // The aggregation pipeline that defines this view.
     BSONObj pipeline;
+    // Whether the results of the view's pipeline are stored and refreshed incrementally, rather
+    // than computed on every read.
+    bool materialized = false;
+
+    // Time-series options, if the create command asked for a time-series collection. Like
+    // 'idIndex', this is only accepted from the create command: the namespace itself becomes a view
+    // over a collection of buckets, and neither of them stores this option.
+    BSONObj timeseries;
 };
 }
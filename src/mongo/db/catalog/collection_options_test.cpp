@@ -252,6 +252,45 @@ TEST(CollectionOptions, PipelineFieldRequiresViewOn) {
     ASSERT_NOT_OK(options.parse(fromjson("{pipeline: [{$match: {}}]}")));
 }
 
+TEST(CollectionOptions, MaterializedViewParsesCorrectly) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{viewOn: 'c', pipeline: [], materialized: true}")));
+    ASSERT_EQ(options.viewOn, "c");
+    ASSERT_TRUE(options.materialized);
+    ASSERT_TRUE(options.toBSON()["materialized"].trueValue());
+}
+
+TEST(CollectionOptions, MaterializedFieldRequiresViewOn) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{materialized: true}")));
+}
+
+TEST(CollectionOptions, MaterializedFieldMustBeBoolean) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{viewOn: 'c', materialized: 1}")));
+}
+
+TEST(CollectionOptions, TimeseriesParsesCorrectly) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{timeseries: {timeField: 't', metaField: 'm'}}")));
+    ASSERT_BSONOBJ_EQ(options.timeseries, fromjson("{timeField: 't', metaField: 'm'}"));
+    ASSERT_BSONOBJ_EQ(options.toBSON(), fromjson("{timeseries: {timeField: 't', metaField: 'm'}}"));
+}
+
+TEST(CollectionOptions, TimeseriesOnlyAcceptedForCommand) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't'}}"),
+                                CollectionOptions::parseForStorage));
+}
+
+TEST(CollectionOptions, InvalidTimeseriesOptionsFailToParse) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: 1}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {metaField: 'm'}}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't'}, viewOn: 'c'}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: {timeField: 't'}, capped: true, size: 1}")));
+}
+
 TEST(CollectionOptions, UnknownTopLevelOptionFailsToParse) {
     CollectionOptions options;
     auto status = options.parse(fromjson("{invalidOption: 1}"));
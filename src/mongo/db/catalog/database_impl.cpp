@@ -53,6 +53,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/introspect.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
@@ -69,6 +70,7 @@
 #include "mongo/db/storage/storage_engine_init.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/system_index.h"
+#include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/cannot_implicitly_create_collection_info.h"
@@ -758,7 +760,12 @@ Status DatabaseImpl::createView(OperationContext* opCtx,
         return Status(ErrorCodes::InvalidNamespace,
                       str::stream() << "invalid namespace name for a view: " + nss.toString());
 
-    return _views.createView(opCtx, nss, viewOnNss, BSONArray(options.pipeline), options.collation);
+    return _views.createView(opCtx,
+                             nss,
+                             viewOnNss,
+                             BSONArray(options.pipeline),
+                             options.collation,
+                             options.materialized);
 }
 
 Collection* DatabaseImpl::createCollection(OperationContext* opCtx,
@@ -945,6 +952,65 @@ MONGO_REGISTER_SHIM(Database::dropDatabase)(OperationContext* opCtx, Database* d
     return DatabaseImpl::dropDatabase(opCtx, db);
 }
 
+namespace {
+
+/**
+ * Creates the time-series collection 'nss' as a view over a new collection of buckets, indexed by
+ * series and by the time range each bucket covers.
+ */
+Status createTimeseries(OperationContext* opCtx,
+                        Database* db,
+                        const NamespaceString& nss,
+                        const CollectionOptions& options) {
+    using namespace timeseries;
+
+    const auto timeseriesOptions = uassertStatusOK(TimeseriesOptions::parse(options.timeseries));
+    const auto bucketsNss = nss.makeTimeseriesBucketsNamespace();
+    if (db->getCollection(opCtx, bucketsNss) ||
+        db->getViewCatalog()->lookup(opCtx, bucketsNss.ns())) {
+        return Status(ErrorCodes::NamespaceExists,
+                      str::stream() << "the buckets collection '" << bucketsNss.ns()
+                                    << "' of a time-series collection already exists");
+    }
+
+    CollectionOptions bucketsOptions;
+    bucketsOptions.storageEngine = options.storageEngine;
+    bucketsOptions.indexOptionDefaults = options.indexOptionDefaults;
+    Collection* buckets = db->createCollection(opCtx, bucketsNss.ns(), bucketsOptions);
+    invariant(buckets);
+
+    BSONObjBuilder keyBuilder;
+    if (timeseriesOptions.metaField) {
+        keyBuilder.append(kBucketMetaFieldName, 1);
+    }
+    for (auto&& bound : {kBucketControlMinFieldName, kBucketControlMaxFieldName}) {
+        const std::string boundPath = str::stream() << kBucketControlFieldName << '.' << bound
+                                                    << '.'
+                                                    << timeseriesOptions.timeField;
+        keyBuilder.append(boundPath, 1);
+    }
+
+    BSONObjBuilder specBuilder;
+    specBuilder.append("v", static_cast<int>(IndexDescriptor::getDefaultIndexVersion()));
+    specBuilder.append("key", keyBuilder.obj());
+    specBuilder.append("name", "timeseries_bucket_range");
+    specBuilder.append("ns", bucketsNss.ns());
+    auto spec = buckets->getIndexCatalog()->createIndexOnEmptyCollection(opCtx, specBuilder.obj());
+    if (!spec.isOK()) {
+        return spec.getStatus();
+    }
+    opCtx->getServiceContext()->getOpObserver()->onCreateIndex(
+        opCtx, bucketsNss, buckets->uuid(), spec.getValue(), false);
+
+    CollectionOptions viewOptions;
+    viewOptions.viewOn = bucketsNss.coll().toString();
+    viewOptions.pipeline = BSON_ARRAY(BSON("$_internalUnpackBucket" << timeseriesOptions.toBSON()));
+    viewOptions.collation = options.collation;
+    return db->createView(opCtx, nss.ns(), viewOptions);
+}
+
+}  // namespace
+
 MONGO_REGISTER_SHIM(Database::userCreateNS)
 (OperationContext* opCtx,
  Database* db,
@@ -1043,7 +1109,10 @@ MONGO_REGISTER_SHIM(Database::userCreateNS)
         }
     }
 
-    if (collectionOptions.isView()) {
+    if (!collectionOptions.timeseries.isEmpty()) {
+        invariant(parseKind == CollectionOptions::parseForCommand);
+        return createTimeseries(opCtx, db, NamespaceString(ns), collectionOptions);
+    } else if (collectionOptions.isView()) {
         invariant(parseKind == CollectionOptions::parseForCommand);
         uassertStatusOK(db->createView(opCtx, ns, collectionOptions));
     } else {
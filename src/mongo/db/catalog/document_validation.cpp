@@ -32,5 +32,5 @@
 
 namespace mongo {
 const OperationContext::Decoration<bool> documentValidationDisabled =
-    OperationContext::declareDecoration<bool>();
+    OperationContext::declareHotDecoration<bool>();
 }
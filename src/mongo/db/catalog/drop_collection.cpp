@@ -42,6 +42,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/util/log.h"
 
@@ -106,6 +107,28 @@ Status dropCollection(OperationContext* opCtx,
             if (!status.isOK()) {
                 return status;
             }
+
+            // The stored results of a materialized view go with it. Its drop is replicated
+            // separately, so secondaries leave it to their own oplog entry.
+            if (view->isMaterialized() && opCtx->writesAreReplicated() &&
+                db->getCollection(opCtx, view->materializedNss())) {
+                status = db->dropCollectionEvenIfSystem(opCtx, view->materializedNss());
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+
+            // Likewise for the buckets of a time-series collection, whose open buckets are
+            // forgotten on every node.
+            if (view->isTimeseries()) {
+                BucketCatalog::get(opCtx).clear(view->viewOn());
+                if (opCtx->writesAreReplicated() && db->getCollection(opCtx, view->viewOn())) {
+                    status = db->dropCollectionEvenIfSystem(opCtx, view->viewOn());
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+            }
         }
         wunit.commit();
 
@@ -47,6 +47,7 @@ class Collection;
 
 class IndexDescriptor;
 class IndexAccessMethod;
+class PartialFilterSet;
 struct InsertDeleteOptions;
 
 struct BsonRecord {
@@ -227,6 +228,8 @@ public:
         virtual MultikeyPaths getMultikeyPaths(OperationContext* opCtx,
                                                const IndexDescriptor* idx) = 0;
 
+        virtual const PartialFilterSet& getPartialFilterSet() const = 0;
+
         virtual Status indexRecords(OperationContext* opCtx,
                                     const std::vector<BsonRecord>& bsonRecords,
                                     int64_t* keysInsertedOut) = 0;
@@ -237,6 +240,11 @@ public:
                                    bool noWarn,
                                    int64_t* keysDeletedOut) = 0;
 
+        virtual void unindexRecords(OperationContext* opCtx,
+                                    const std::vector<BsonRecord>& bsonRecords,
+                                    bool noWarn,
+                                    int64_t* keysDeletedOut) = 0;
+
         virtual std::string getAccessMethodName(OperationContext* opCtx,
                                                 const BSONObj& keyPattern) = 0;
 
@@ -503,6 +511,14 @@ public:
 
     // ----- data modifiers ------
 
+    /**
+     * Returns the partial filters of every index, including unfinished ones, so that writers can
+     * evaluate them against a document in one pass.
+     */
+    inline const PartialFilterSet& getPartialFilterSet() const {
+        return this->_impl().getPartialFilterSet();
+    }
+
     /**
      * When 'keysInsertedOut' is not null, it will be set to the number of index keys inserted by
      * this operation.
@@ -527,6 +543,20 @@ public:
         return this->_impl().unindexRecord(opCtx, obj, loc, noWarn, keysDeletedOut);
     }
 
+    /**
+     * Removes the index keys of all of 'bsonRecords' at once, sorting each index's keys so that
+     * they are removed in a single pass over that index.
+     *
+     * When 'keysDeletedOut' is not null, it will be set to the number of index keys removed by
+     * this operation.
+     */
+    inline void unindexRecords(OperationContext* const opCtx,
+                               const std::vector<BsonRecord>& bsonRecords,
+                               const bool noWarn,
+                               int64_t* const keysDeletedOut) {
+        return this->_impl().unindexRecords(opCtx, bsonRecords, noWarn, keysDeletedOut);
+    }
+
     // ------- temp internal -------
 
     inline std::string getAccessMethodName(OperationContext* const opCtx,
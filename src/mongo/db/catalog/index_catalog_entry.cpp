@@ -100,8 +100,17 @@ IndexCatalogEntry* IndexCatalogEntryContainer::release(const IndexDescriptor* de
             continue;
         IndexCatalogEntry* e = i->release();
         _entries.erase(i);
+        _rebuildPartialFilterSet();
         return e;
     }
     return nullptr;
 }
+
+void IndexCatalogEntryContainer::_rebuildPartialFilterSet() {
+    std::vector<const MatchExpression*> filters;
+    for (auto&& entry : _entries) {
+        filters.push_back(entry->getFilterExpression());
+    }
+    _partialFilterSet = PartialFilterSet(std::move(filters));
+}
 }  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/base/shim.h"
 #include "mongo/bson/ordering.h"
 #include "mongo/bson/timestamp.h"
+#include "mongo/db/catalog/partial_filter_set.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
@@ -318,9 +319,21 @@ public:
     // pass ownership to EntryContainer
     void add(IndexCatalogEntry* entry) {
         _entries.push_back(std::unique_ptr<IndexCatalogEntry>{entry});
+        _rebuildPartialFilterSet();
+    }
+
+    /**
+     * Returns the partial filters of all entries, for evaluating them together on the write path.
+     * Rebuilt whenever an entry is added or released.
+     */
+    const PartialFilterSet& getPartialFilterSet() const {
+        return _partialFilterSet;
     }
 
 private:
+    void _rebuildPartialFilterSet();
+
     std::vector<std::unique_ptr<IndexCatalogEntry>> _entries;
+    PartialFilterSet _partialFilterSet;
 };
 }  // namespace mongo
@@ -676,7 +676,7 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
 
         string pluginName = IndexNames::findPluginName(key);
         if ((pluginName != IndexNames::BTREE) && (pluginName != IndexNames::GEO_2DSPHERE) &&
-            (pluginName != IndexNames::HASHED)) {
+            (pluginName != IndexNames::HASHED) && (pluginName != IndexNames::WILDCARD)) {
             return Status(ErrorCodes::CannotCreateIndex,
                           str::stream() << "Index type '" << pluginName
                                         << "' does not support collation: "
@@ -1400,15 +1400,17 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
 Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        IndexCatalogEntry* index,
                                        const std::vector<BsonRecord>& bsonRecords,
+                                       const std::vector<PartialFilterSet::Matches>& filterMatches,
                                        int64_t* keysInsertedOut) {
     const MatchExpression* filter = index->getFilterExpression();
     if (!filter)
         return _indexFilteredRecords(opCtx, index, bsonRecords, keysInsertedOut);
 
+    invariant(filterMatches.size() == bsonRecords.size());
     std::vector<BsonRecord> filteredBsonRecords;
-    for (auto bsonRecord : bsonRecords) {
-        if (filter->matchesBSON(*(bsonRecord.docPtr)))
-            filteredBsonRecords.push_back(bsonRecord);
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        if (filterMatches[i].matched(filter))
+            filteredBsonRecords.push_back(bsonRecords[i]);
     }
 
     return _indexFilteredRecords(opCtx, index, filteredBsonRecords, keysInsertedOut);
@@ -1455,9 +1457,20 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
         *keysInsertedOut = 0;
     }
 
+    // Evaluate the partial filters of all indexes together, once per record, rather than once per
+    // record for each partial index.
+    const PartialFilterSet& partialFilters = _entries.getPartialFilterSet();
+    std::vector<PartialFilterSet::Matches> filterMatches;
+    if (!partialFilters.empty()) {
+        filterMatches.reserve(bsonRecords.size());
+        for (auto&& bsonRecord : bsonRecords) {
+            filterMatches.push_back(partialFilters.evaluate(*bsonRecord.docPtr));
+        }
+    }
+
     for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
          ++i) {
-        Status s = _indexRecords(opCtx, i->get(), bsonRecords, keysInsertedOut);
+        Status s = _indexRecords(opCtx, i->get(), bsonRecords, filterMatches, keysInsertedOut);
         if (!s.isOK())
             return s;
     }
@@ -1484,6 +1497,38 @@ void IndexCatalogImpl::unindexRecord(OperationContext* opCtx,
     }
 }
 
+void IndexCatalogImpl::unindexRecords(OperationContext* opCtx,
+                                      const std::vector<BsonRecord>& bsonRecords,
+                                      bool noWarn,
+                                      int64_t* keysDeletedOut) {
+    if (keysDeletedOut) {
+        *keysDeletedOut = 0;
+    }
+
+    for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
+         ++i) {
+        IndexCatalogEntry* entry = i->get();
+
+        InsertDeleteOptions options;
+        prepareInsertDeleteOptions(opCtx, entry->descriptor(), &options);
+        // If it's a background index, we DO NOT want to log anything.
+        options.logIfError = entry->isReady(opCtx) ? !noWarn : false;
+        // See _unindexRecord() for why in-progress indexes can't do blind deletes.
+        options.dupsAllowed = options.dupsAllowed || !entry->isReady(opCtx);
+
+        int64_t removed;
+        Status status = entry->accessMethod()->removeMany(opCtx, bsonRecords, options, &removed);
+        if (!status.isOK()) {
+            log() << "Couldn't unindex " << bsonRecords.size() << " records from collection "
+                  << _collection->ns() << ". Status: " << redact(status);
+        }
+
+        if (keysDeletedOut) {
+            *keysDeletedOut += removed;
+        }
+    }
+}
+
 BSONObj IndexCatalogImpl::fixIndexKey(const BSONObj& key) {
     if (IndexDescriptor::isIdIndexPattern(key)) {
         return _idObj;
@@ -337,6 +337,10 @@ public:
      *
      * This method may throw.
      */
+    const PartialFilterSet& getPartialFilterSet() const override {
+        return _entries.getPartialFilterSet();
+    }
+
     Status indexRecords(OperationContext* opCtx,
                         const std::vector<BsonRecord>& bsonRecords,
                         int64_t* keysInsertedOut) override;
@@ -351,6 +355,17 @@ public:
                        bool noWarn,
                        int64_t* keysDeletedOut) override;
 
+    /**
+     * Removes the keys of all of 'bsonRecords' from each index in one sorted pass.
+     *
+     * When 'keysDeletedOut' is not null, it will be set to the number of index keys removed by
+     * this operation.
+     */
+    void unindexRecords(OperationContext* opCtx,
+                        const std::vector<BsonRecord>& bsonRecords,
+                        bool noWarn,
+                        int64_t* keysDeletedOut) override;
+
     // ------- temp internal -------
 
     inline std::string getAccessMethodName(OperationContext* opCtx,
@@ -392,9 +407,14 @@ private:
                                  const std::vector<BsonRecord>& bsonRecords,
                                  int64_t* keysInsertedOut);
 
+    /**
+     * 'filterMatches' holds the partial filter results for each of 'bsonRecords', and may be empty
+     * when no index has a partial filter.
+     */
     Status _indexRecords(OperationContext* opCtx,
                          IndexCatalogEntry* index,
                          const std::vector<BsonRecord>& bsonRecords,
+                         const std::vector<PartialFilterSet::Matches>& filterMatches,
                          int64_t* keysInsertedOut);
 
     Status _unindexRecord(OperationContext* opCtx,
@@ -61,6 +61,7 @@ IndexConsistency::IndexConsistency(OperationContext* opCtx,
       _recordStore(recordStore),
       _collLk(std::move(collLk)),
       _isBackground(background),
+      _indexKeyCount(kNumHashBuckets),
       _tracker(opCtx->getServiceContext()->getFastClockSource(),
                internalQueryExecYieldIterations.load(),
                Milliseconds(internalQueryExecYieldPeriodMS.load())) {
@@ -76,7 +77,8 @@ IndexConsistency::IndexConsistency(OperationContext* opCtx,
 
         _indexNumber[descriptor->indexNamespace()] = indexNumber;
 
-        IndexInfo indexInfo;
+        // The counters start at zero.
+        IndexInfo& indexInfo = _indexesInfo[indexNumber];
 
         indexInfo.isReady =
             _collection->getCatalogEntry()->isIndexReady(opCtx, descriptor->indexName());
@@ -86,13 +88,6 @@ IndexConsistency::IndexConsistency(OperationContext* opCtx,
         indexInfo.indexNsHash = indexNsHash;
         indexInfo.indexScanFinished = false;
 
-        indexInfo.numKeys = 0;
-        indexInfo.numLongKeys = 0;
-        indexInfo.numRecords = 0;
-        indexInfo.numExtraIndexKeys = 0;
-
-        _indexesInfo[indexNumber] = indexInfo;
-
         indexNumber++;
     }
 }
@@ -103,8 +98,7 @@ void IndexConsistency::addDocKey(const KeyString& ks, int indexNumber) {
         return;
     }
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    _addDocKey_inlock(ks, indexNumber);
+    _addDocKey(ks, indexNumber);
 }
 
 void IndexConsistency::removeDocKey(const KeyString& ks, int indexNumber) {
@@ -113,8 +107,7 @@ void IndexConsistency::removeDocKey(const KeyString& ks, int indexNumber) {
         return;
     }
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    _removeDocKey_inlock(ks, indexNumber);
+    _removeDocKey(ks, indexNumber);
 }
 
 void IndexConsistency::addIndexKey(const KeyString& ks, int indexNumber) {
@@ -123,8 +116,7 @@ void IndexConsistency::addIndexKey(const KeyString& ks, int indexNumber) {
         return;
     }
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    _addIndexKey_inlock(ks, indexNumber);
+    _addIndexKey(ks, indexNumber);
 }
 
 void IndexConsistency::removeIndexKey(const KeyString& ks, int indexNumber) {
@@ -133,56 +125,50 @@ void IndexConsistency::removeIndexKey(const KeyString& ks, int indexNumber) {
         return;
     }
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    _removeIndexKey_inlock(ks, indexNumber);
+    _removeIndexKey(ks, indexNumber);
 }
 
 void IndexConsistency::addLongIndexKey(int indexNumber) {
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
     if (indexNumber < 0 || indexNumber >= static_cast<int>(_indexesInfo.size())) {
         return;
     }
 
-    _indexesInfo[indexNumber].numRecords++;
-    _indexesInfo[indexNumber].numLongKeys++;
+    _indexesInfo.at(indexNumber).numRecords.fetchAndAdd(1);
+    _indexesInfo.at(indexNumber).numLongKeys.fetchAndAdd(1);
 }
 
 int64_t IndexConsistency::getNumKeys(int indexNumber) const {
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
     if (indexNumber < 0 || indexNumber >= static_cast<int>(_indexesInfo.size())) {
         return 0;
     }
 
-    return _indexesInfo.at(indexNumber).numKeys;
+    return _indexesInfo.at(indexNumber).numKeys.load();
 }
 
 int64_t IndexConsistency::getNumLongKeys(int indexNumber) const {
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
     if (indexNumber < 0 || indexNumber >= static_cast<int>(_indexesInfo.size())) {
         return 0;
     }
 
-    return _indexesInfo.at(indexNumber).numLongKeys;
+    return _indexesInfo.at(indexNumber).numLongKeys.load();
 }
 
 int64_t IndexConsistency::getNumRecords(int indexNumber) const {
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
     if (indexNumber < 0 || indexNumber >= static_cast<int>(_indexesInfo.size())) {
         return 0;
     }
 
-    return _indexesInfo.at(indexNumber).numRecords;
+    return _indexesInfo.at(indexNumber).numRecords.load();
 }
 
 bool IndexConsistency::haveEntryMismatch() const {
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    for (auto iterator = _indexKeyCount.begin(); iterator != _indexKeyCount.end(); iterator++) {
-        if (iterator->second != 0) {
+    for (const auto& count : _indexKeyCount) {
+        if (count.load() != 0) {
             return true;
         }
     }
@@ -192,12 +178,11 @@ bool IndexConsistency::haveEntryMismatch() const {
 
 int64_t IndexConsistency::getNumExtraIndexKeys(int indexNumber) const {
 
-    stdx::lock_guard<stdx::mutex> lock(_classMutex);
     if (indexNumber < 0 || indexNumber >= static_cast<int>(_indexesInfo.size())) {
         return 0;
     }
 
-    return _indexesInfo.at(indexNumber).numExtraIndexKeys;
+    return _indexesInfo.at(indexNumber).numExtraIndexKeys.load();
 }
 
 void IndexConsistency::applyChange(const IndexDescriptor* descriptor,
@@ -231,18 +216,18 @@ void IndexConsistency::applyChange(const IndexDescriptor* descriptor,
                     static_cast<int64_t>(KeyString::TypeBits::kMaxKeyBytes)) {
                     // Index keys >= 1024 bytes are not indexed but are stored in the document key
                     // set.
-                    _indexesInfo[indexNumber].numRecords++;
-                    _indexesInfo[indexNumber].numLongKeys++;
+                    _indexesInfo.at(indexNumber).numRecords.fetchAndAdd(1);
+                    _indexesInfo.at(indexNumber).numLongKeys.fetchAndAdd(1);
                 } else {
-                    _addDocKey_inlock(ks, indexNumber);
+                    _addDocKey(ks, indexNumber);
                 }
             } else if (operation == ValidationOperation::REMOVE) {
                 if (indexEntry->key.objsize() >=
                     static_cast<int64_t>(KeyString::TypeBits::kMaxKeyBytes)) {
-                    _indexesInfo[indexNumber].numRecords--;
-                    _indexesInfo[indexNumber].numLongKeys--;
+                    _indexesInfo.at(indexNumber).numRecords.fetchAndSubtract(1);
+                    _indexesInfo.at(indexNumber).numLongKeys.fetchAndSubtract(1);
                 } else {
-                    _removeDocKey_inlock(ks, indexNumber);
+                    _removeDocKey(ks, indexNumber);
                 }
             }
         }
@@ -268,11 +253,11 @@ void IndexConsistency::applyChange(const IndexDescriptor* descriptor,
             // happens after the cursor, OR, we are scanning this index namespace,
             // and an event occured after our cursor
             if (operation == ValidationOperation::INSERT) {
-                _removeIndexKey_inlock(ks, indexNumber);
-                _indexesInfo.at(indexNumber).numExtraIndexKeys++;
+                _removeIndexKey(ks, indexNumber);
+                _indexesInfo.at(indexNumber).numExtraIndexKeys.fetchAndAdd(1);
             } else if (operation == ValidationOperation::REMOVE) {
-                _addIndexKey_inlock(ks, indexNumber);
-                _indexesInfo.at(indexNumber).numExtraIndexKeys--;
+                _addIndexKey(ks, indexNumber);
+                _indexesInfo.at(indexNumber).numExtraIndexKeys.fetchAndSubtract(1);
             }
         }
     }
@@ -395,7 +380,7 @@ bool IndexConsistency::scanLimitHit() {
     return _isBackground && _tracker.intervalHasElapsed();
 }
 
-void IndexConsistency::_addDocKey_inlock(const KeyString& ks, int indexNumber) {
+void IndexConsistency::_addDocKey(const KeyString& ks, int indexNumber) {
 
     // Ignore indexes that weren't ready before we started validation.
     if (!_indexesInfo.at(indexNumber).isReady) {
@@ -403,11 +388,11 @@ void IndexConsistency::_addDocKey_inlock(const KeyString& ks, int indexNumber) {
     }
 
     const uint32_t hash = _hashKeyString(ks, indexNumber);
-    _indexKeyCount[hash]++;
-    _indexesInfo.at(indexNumber).numRecords++;
+    _indexKeyCount[hash].fetchAndAdd(1);
+    _indexesInfo.at(indexNumber).numRecords.fetchAndAdd(1);
 }
 
-void IndexConsistency::_removeDocKey_inlock(const KeyString& ks, int indexNumber) {
+void IndexConsistency::_removeDocKey(const KeyString& ks, int indexNumber) {
 
     // Ignore indexes that weren't ready before we started validation.
     if (!_indexesInfo.at(indexNumber).isReady) {
@@ -415,11 +400,11 @@ void IndexConsistency::_removeDocKey_inlock(const KeyString& ks, int indexNumber
     }
 
     const uint32_t hash = _hashKeyString(ks, indexNumber);
-    _indexKeyCount[hash]--;
-    _indexesInfo.at(indexNumber).numRecords--;
+    _indexKeyCount[hash].fetchAndSubtract(1);
+    _indexesInfo.at(indexNumber).numRecords.fetchAndSubtract(1);
 }
 
-void IndexConsistency::_addIndexKey_inlock(const KeyString& ks, int indexNumber) {
+void IndexConsistency::_addIndexKey(const KeyString& ks, int indexNumber) {
 
     // Ignore indexes that weren't ready before we started validation.
     if (!_indexesInfo.at(indexNumber).isReady) {
@@ -427,11 +412,11 @@ void IndexConsistency::_addIndexKey_inlock(const KeyString& ks, int indexNumber)
     }
 
     const uint32_t hash = _hashKeyString(ks, indexNumber);
-    _indexKeyCount[hash]--;
-    _indexesInfo.at(indexNumber).numKeys++;
+    _indexKeyCount[hash].fetchAndSubtract(1);
+    _indexesInfo.at(indexNumber).numKeys.fetchAndAdd(1);
 }
 
-void IndexConsistency::_removeIndexKey_inlock(const KeyString& ks, int indexNumber) {
+void IndexConsistency::_removeIndexKey(const KeyString& ks, int indexNumber) {
 
     // Ignore indexes that weren't ready before we started validation.
     if (!_indexesInfo.at(indexNumber).isReady) {
@@ -439,8 +424,8 @@ void IndexConsistency::_removeIndexKey_inlock(const KeyString& ks, int indexNumb
     }
 
     const uint32_t hash = _hashKeyString(ks, indexNumber);
-    _indexKeyCount[hash]++;
-    _indexesInfo.at(indexNumber).numKeys--;
+    _indexKeyCount[hash].fetchAndAdd(1);
+    _indexesInfo.at(indexNumber).numKeys.fetchAndSubtract(1);
 }
 
 bool IndexConsistency::_isIndexFinished_inlock(int indexNumber) const {
@@ -501,7 +486,7 @@ uint32_t IndexConsistency::_hashKeyString(const KeyString& ks, int indexNumber)
     MurmurHash3_x86_32(
         ks.getTypeBits().getBuffer(), ks.getTypeBits().getSize(), indexNsHash, &indexNsHash);
     MurmurHash3_x86_32(ks.getBuffer(), ks.getSize(), indexNsHash, &indexNsHash);
-    return indexNsHash % (1U << 22);
+    return indexNsHash % kNumHashBuckets;
 }
 
 Status IndexConsistency::_throwExceptionIfError() {
@@ -28,11 +28,14 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/elapsed_tracker.h"
 
 namespace mongo {
@@ -60,7 +63,8 @@ enum class ValidationOperation { INSERT, REMOVE };
  */
 
 /**
- * Contains all the index information and stats throughout the validation.
+ * Contains all the index information and stats throughout the validation. The counters are atomic
+ * so that the indexes can be scanned on separate threads.
  */
 struct IndexInfo {
     // Informs us if the index was ready or not for consumption during the start of validation.
@@ -70,15 +74,15 @@ struct IndexInfo {
     // True if the index has finished scanning from the index scan stage, otherwise false.
     bool indexScanFinished;
     // The number of index entries belonging to the index.
-    int64_t numKeys;
+    AtomicInt64 numKeys;
     // The number of long keys that are not indexed for the index.
-    int64_t numLongKeys;
+    AtomicInt64 numLongKeys;
     // The number of records that have a key in their document that referenced back to the
     // this index
-    int64_t numRecords;
+    AtomicInt64 numRecords;
     // Keeps track of how many indexes were removed (-1) and added (+1) after the
     // point of validity was set for this index.
-    int64_t numExtraIndexKeys;
+    AtomicInt64 numExtraIndexKeys;
 };
 
 class IndexConsistency final {
@@ -92,7 +96,8 @@ public:
 
     /**
      * Helper functions for `_addDocKey`, `_removeDocKey`, `_addIndexKey`,
-     * and `_removeIndexKey` for concurrency control.
+     * and `_removeIndexKey` for concurrency control. They only update atomic counters, so the
+     * record store and the indexes may be scanned on different threads at the same time.
      */
     void addDocKey(const KeyString& ks, int indexNumber);
     void removeDocKey(const KeyString& ks, int indexNumber);
@@ -256,7 +261,9 @@ private:
     //       are too few index entries.
     //     - If the count is < 0 in the bucket at the end of the validation pass, then there
     //       are too many index entries.
-    std::map<uint32_t, uint32_t> _indexKeyCount;
+    // There is a counter for every possible hash, so buckets are updated without locking.
+    static const uint32_t kNumHashBuckets = 1U << 22;
+    std::vector<AtomicUInt32> _indexKeyCount;
 
     // Contains the corresponding index number for each index namespace
     std::map<std::string, int> _indexNumber;
@@ -288,32 +295,32 @@ private:
     // The current number of errors that are recorded.
     int _numErrorsRecorded = 0;
 
-    // Only one thread can use the class at a time
+    // Protects the stage, the scan positions and the yield points. The key counts are atomic.
     mutable stdx::mutex _classMutex;
 
     /**
      * Given the document's key KeyString, increment the corresponding `_indexKeyCount`
      * by hashing it.
      */
-    void _addDocKey_inlock(const KeyString& ks, int indexNumber);
+    void _addDocKey(const KeyString& ks, int indexNumber);
 
     /**
      * Given the document's key KeyString, decrement the corresponding `_indexKeyCount`
      * by hashing it.
      */
-    void _removeDocKey_inlock(const KeyString& ks, int indexNumber);
+    void _removeDocKey(const KeyString& ks, int indexNumber);
 
     /**
      * Given the index entry's KeyString, decrement the corresponding `_indexKeyCount`
      * by hashing it.
      */
-    void _addIndexKey_inlock(const KeyString& ks, int indexNumber);
+    void _addIndexKey(const KeyString& ks, int indexNumber);
 
     /**
      * Given the index entry's KeyString, increment the corresponding `_indexKeyCount`
      * by hashing it.
      */
-    void _removeIndexKey_inlock(const KeyString& ks, int indexNumber);
+    void _removeIndexKey(const KeyString& ks, int indexNumber);
 
     /**
      * Returns true if the index for the given `indexNs` has finished being scanned by
@@ -60,6 +60,10 @@ class OperationContext;
  */
 class MultiIndexBlock {
 public:
+    // Upper bound for setKeyGenerationThreads() and the "indexBuildKeyGenerationThreads" server
+    // parameter.
+    static constexpr int kMaxKeyGenerationThreads = 64;
+
     class Impl {
     public:
         virtual ~Impl() = 0;
@@ -70,6 +74,8 @@ public:
 
         virtual void ignoreUniqueConstraint() = 0;
 
+        virtual void setKeyGenerationThreads(int numThreads) = 0;
+
         virtual void removeExistingIndexes(std::vector<BSONObj>* specs) const = 0;
 
         virtual StatusWith<std::vector<BSONObj>> init(const std::vector<BSONObj>& specs) = 0;
@@ -159,6 +165,16 @@ public:
         return this->_impl().ignoreUniqueConstraint();
     }
 
+    /**
+     * Sets the number of worker threads that generate and sort index keys in
+     * insertAllDocumentsInCollection. By default this is the value of the
+     * "indexBuildKeyGenerationThreads" server parameter. Only foreground builds of more than one
+     * index use worker threads; each index's keys are always generated by a single thread.
+     */
+    inline void setKeyGenerationThreads(const int numThreads) {
+        return this->_impl().setKeyGenerationThreads(numThreads);
+    }
+
     /**
      * Removes pre-existing indexes from 'specs'. If this isn't done, init() may fail with
      * IndexAlreadyExists.
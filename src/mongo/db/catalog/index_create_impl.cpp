@@ -52,6 +52,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -94,6 +95,19 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// The default number of worker threads that generate and sort index keys during a foreground build
+// of more than one index. Can be overridden for each build with setKeyGenerationThreads().
+MONGO_EXPORT_SERVER_PARAMETER(indexBuildKeyGenerationThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > MultiIndexBlock::kMaxKeyGenerationThreads) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "indexBuildKeyGenerationThreads must be between 1 and "
+                                        << MultiIndexBlock::kMaxKeyGenerationThreads);
+        }
+
+        return Status::OK();
+    });
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -129,12 +143,143 @@ private:
     MultiIndexBlockImpl* const _indexer;
 };
 
+/**
+ * Generates and sorts the keys of a foreground index build on worker threads, while the thread
+ * driving the build keeps scanning the collection. Documents are handed over in batches, and each
+ * worker owns a fixed subset of the indexes, so that a bulk builder is only ever used by one
+ * thread. A batch is only handed over once the workers are done with the previous one.
+ */
+class MultiIndexBlockImpl::ParallelKeyGenerator {
+    MONGO_DISALLOW_COPYING(ParallelKeyGenerator);
+
+public:
+    ParallelKeyGenerator(MultiIndexBlockImpl* indexer, size_t numWorkers)
+        : _indexer(indexer),
+          _numWorkers(numWorkers),
+          _pool(_makePoolOptions(numWorkers)),
+          _workerStatuses(numWorkers, Status::OK()) {
+        _pool.startup();
+    }
+
+    ~ParallelKeyGenerator() {
+        _pool.shutdown();
+        _pool.join();
+    }
+
+    /**
+     * Queues a copy of 'doc' to have its keys generated. Returns an error if generating the keys of
+     * an earlier batch failed.
+     */
+    Status add(const BSONObj& doc, const RecordId& loc) {
+        _filling.emplace_back(doc.getOwned(), loc);
+        _fillingBytes += doc.objsize();
+        if (_filling.size() < kMaxBatchDocs && _fillingBytes < kMaxBatchBytes) {
+            return Status::OK();
+        }
+        return _dispatch();
+    }
+
+    /**
+     * Generates the keys of all queued documents and waits for the workers to finish.
+     */
+    Status finish() {
+        Status status = _dispatch();
+        if (!status.isOK()) {
+            return status;
+        }
+        return _waitForBatch();
+    }
+
+private:
+    static const size_t kMaxBatchDocs = 1000;
+    static const size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+    static ThreadPool::Options _makePoolOptions(size_t numWorkers) {
+        ThreadPool::Options options;
+        options.poolName = "IndexBuildKeyGenerators";
+        options.threadNamePrefix = "IndexBuildKeyGenerator-";
+        options.minThreads = options.maxThreads = numWorkers;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThreadIfNotAlready(threadName);
+        };
+        return options;
+    }
+
+    Status _waitForBatch() {
+        _pool.waitForIdle();
+        for (auto&& status : _workerStatuses) {
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        return Status::OK();
+    }
+
+    Status _dispatch() {
+        Status status = _waitForBatch();
+        if (!status.isOK() || _filling.empty()) {
+            return status;
+        }
+
+        _inFlight.swap(_filling);
+        _filling.clear();
+        _fillingBytes = 0;
+
+        for (size_t worker = 0; worker < _numWorkers; ++worker) {
+            status = _pool.schedule([this, worker] { _workerStatuses[worker] = _run(worker); });
+            if (!status.isOK()) {
+                // Don't return while the workers that were scheduled may still read '_inFlight'.
+                _pool.waitForIdle();
+                return status;
+            }
+        }
+        return Status::OK();
+    }
+
+    Status _run(size_t worker) {
+        auto& indexes = _indexer->_indexes;
+        try {
+            for (auto&& docAndLoc : _inFlight) {
+                for (size_t i = worker; i < indexes.size(); i += _numWorkers) {
+                    const BSONObj& doc = docAndLoc.first;
+                    if (indexes[i].filterExpression &&
+                        !indexes[i].filterExpression->matchesBSON(doc)) {
+                        continue;
+                    }
+
+                    int64_t unused;
+                    Status status = indexes[i].bulk->insert(
+                        _indexer->_opCtx, doc, docAndLoc.second, indexes[i].options, &unused);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+            }
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+        return Status::OK();
+    }
+
+    MultiIndexBlockImpl* const _indexer;
+    const size_t _numWorkers;
+    ThreadPool _pool;
+
+    // Documents being queued by the scanning thread, and documents being processed by the
+    // workers. Each worker writes only its own status.
+    std::vector<std::pair<BSONObj, RecordId>> _filling;
+    size_t _fillingBytes = 0;
+    std::vector<std::pair<BSONObj, RecordId>> _inFlight;
+    std::vector<Status> _workerStatuses;
+};
+
 MultiIndexBlockImpl::MultiIndexBlockImpl(OperationContext* opCtx, Collection* collection)
     : _collection(collection),
       _opCtx(opCtx),
       _buildInBackground(false),
       _allowInterruption(false),
       _ignoreUnique(false),
+      _keyGenerationThreads(indexBuildKeyGenerationThreads.load()),
       _needToCleanup(true) {}
 
 MultiIndexBlockImpl::~MultiIndexBlockImpl() {
@@ -353,6 +498,15 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
     auto exec =
         InternalPlanner::collectionScan(_opCtx, _collection->ns().ns(), _collection, yieldPolicy);
 
+    // Foreground builds of several indexes can generate each index's keys on its own thread. Bulk
+    // inserts don't write to storage, so this doesn't need a WriteUnitOfWork per document.
+    std::unique_ptr<ParallelKeyGenerator> keyGenerator;
+    const size_t numKeyGenerators =
+        std::min(static_cast<size_t>(_keyGenerationThreads), _indexes.size());
+    if (!_buildInBackground && numKeyGenerators > 1) {
+        keyGenerator = stdx::make_unique<ParallelKeyGenerator>(this, numKeyGenerators);
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -383,19 +537,26 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
             // Done before insert so we can retry document if it WCEs.
             progress->setTotalWhileRunning(_collection->numRecords(_opCtx));
 
-            WriteUnitOfWork wunit(_opCtx);
-            Status ret = insert(objToIndex.value(), loc);
-            if (_buildInBackground)
-                exec->saveState();
-            if (ret.isOK()) {
-                wunit.commit();
-            } else if (dupsOut && ret.code() == ErrorCodes::DuplicateKey) {
-                // If dupsOut is non-null, we should only fail the specific insert that
-                // led to a DuplicateKey rather than the whole index build.
-                dupsOut->insert(loc);
+            if (keyGenerator) {
+                Status ret = keyGenerator->add(objToIndex.value(), loc);
+                if (!ret.isOK()) {
+                    return ret;
+                }
             } else {
-                // Fail the index build hard.
-                return ret;
+                WriteUnitOfWork wunit(_opCtx);
+                Status ret = insert(objToIndex.value(), loc);
+                if (_buildInBackground)
+                    exec->saveState();
+                if (ret.isOK()) {
+                    wunit.commit();
+                } else if (dupsOut && ret.code() == ErrorCodes::DuplicateKey) {
+                    // If dupsOut is non-null, we should only fail the specific insert that
+                    // led to a DuplicateKey rather than the whole index build.
+                    dupsOut->insert(loc);
+                } else {
+                    // Fail the index build hard.
+                    return ret;
+                }
             }
             if (_buildInBackground) {
                 auto restoreStatus = exec->restoreState();  // Handles any WCEs internally.
@@ -429,6 +590,13 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
         return WorkingSetCommon::getMemberObjectStatus(objToIndex.value());
     }
 
+    if (keyGenerator) {
+        Status status = keyGenerator->finish();
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
     if (MONGO_FAIL_POINT(hangAfterStartingIndexBuildUnlocked)) {
         // Unlock before hanging so replication recognizes we've completed.
         Locker::LockSnapshot lockInfo;
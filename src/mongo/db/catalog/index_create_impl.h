@@ -101,6 +101,16 @@ public:
         _ignoreUnique = true;
     }
 
+    /**
+     * Sets the number of worker threads that generate and sort index keys in
+     * insertAllDocumentsInCollection. Only foreground builds of more than one index use worker
+     * threads; each index's keys are always generated by a single thread.
+     */
+    void setKeyGenerationThreads(int numThreads) override {
+        invariant(numThreads > 0);
+        _keyGenerationThreads = numThreads;
+    }
+
     /**
      * Removes pre-existing indexes from 'specs'. If this isn't done, init() may fail with
      * IndexAlreadyExists.
@@ -191,6 +201,7 @@ public:
 private:
     class SetNeedToCleanupOnRollback;
     class CleanupIndexesVectorOnRollback;
+    class ParallelKeyGenerator;
 
     struct IndexToBuild {
         std::unique_ptr<IndexCatalogImpl::IndexBuildBlock> block;
@@ -215,6 +226,7 @@ private:
     bool _buildInBackground;
     bool _allowInterruption;
     bool _ignoreUnique;
+    int _keyGenerationThreads;
 
     bool _needToCleanup;
 };
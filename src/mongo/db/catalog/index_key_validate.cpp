@@ -209,6 +209,25 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
     return Status::OK();
 }
 
+bool requiresFullyUpgradedFCV(const BSONObj& keyPattern) {
+    for (auto&& keyElem : keyPattern) {
+        if (keyElem.type() != BSONType::String) {
+            continue;
+        }
+
+        // A wildcard index, e.g. {a: "wildcard"}.
+        if (keyElem.valueStringData() == IndexNames::WILDCARD) {
+            return true;
+        }
+
+        // A hashed field alongside other fields, e.g. {a: "hashed", b: 1}.
+        if (keyElem.valueStringData() == IndexNames::HASHED && keyPattern.nFields() > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
 StatusWith<BSONObj> validateIndexSpec(
     OperationContext* opCtx,
     const BSONObj& indexSpec,
@@ -257,6 +276,14 @@ StatusWith<BSONObj> validateIndexSpec(
                 return keyPatternValidateStatus;
             }
 
+            if (requiresFullyUpgradedFCV(indexSpecElem.Obj()) &&
+                featureCompatibility.getVersionUnsafe() !=
+                    ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo40) {
+                return {ErrorCodes::CannotCreateIndex,
+                        str::stream() << "Index key pattern " << indexSpecElem.Obj()
+                                      << " requires featureCompatibilityVersion 4.0"};
+            }
+
             hasKeyPatternField = true;
         } else if (IndexDescriptor::kIndexNameFieldName == indexSpecElemFieldName) {
             if (indexSpecElem.type() != BSONType::String) {
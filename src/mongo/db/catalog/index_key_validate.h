@@ -47,6 +47,13 @@ namespace index_key_validate {
  */
 Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion indexVersion);
 
+/**
+ * Returns true if binaries before 4.0 fail to load an index with the key pattern 'keyPattern'.
+ * Such indexes may only be created once the featureCompatibilityVersion is fully upgraded to 4.0,
+ * and must be dropped before it is downgraded.
+ */
+bool requiresFullyUpgradedFCV(const BSONObj& keyPattern);
+
 /**
  * Validates the index specification 'indexSpec' and returns an equivalent index specification that
  * has any missing attributes filled in. If the index specification is malformed, then an error
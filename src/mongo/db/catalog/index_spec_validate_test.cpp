@@ -771,6 +771,51 @@ TEST(IndexSpecCollationValidateTest, FillsInCollationFieldWithCollectionDefaultI
                       sorted(result.getValue()));
 }
 
+TEST(IndexSpecValidateTest, CompoundHashedIndexRequiresFullyUpgradedFCV) {
+    const auto spec = BSON("key" << BSON("a"
+                                         << "hashed"
+                                         << "b"
+                                         << 1)
+                                 << "name"
+                                 << "indexName");
+
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo40);
+    ASSERT_OK(validateIndexSpec(kDefaultOpCtx, spec, kTestNamespace, featureCompatibility));
+
+    featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kUpgradingTo40);
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+              validateIndexSpec(kDefaultOpCtx, spec, kTestNamespace, featureCompatibility));
+
+    // A hashed index on a single field is allowed at any featureCompatibilityVersion.
+    ASSERT_OK(validateIndexSpec(kDefaultOpCtx,
+                                BSON("key" << BSON("a"
+                                                   << "hashed")
+                                           << "name"
+                                           << "indexName"),
+                                kTestNamespace,
+                                featureCompatibility));
+}
+
+TEST(IndexSpecValidateTest, WildcardIndexRequiresFullyUpgradedFCV) {
+    const auto spec = BSON("key" << BSON("a"
+                                         << "wildcard")
+                                 << "name"
+                                 << "indexName");
+
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo40);
+    ASSERT_OK(validateIndexSpec(kDefaultOpCtx, spec, kTestNamespace, featureCompatibility));
+
+    featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kFullyDowngradedTo36);
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+              validateIndexSpec(kDefaultOpCtx, spec, kTestNamespace, featureCompatibility));
+}
+
 TEST(IndexSpecPartialFilterTest, FailsIfPartialFilterIsNotAnObject) {
     auto result = validateIndexSpec(kDefaultOpCtx,
                                     BSON("key" << BSON("field" << 1) << "name"
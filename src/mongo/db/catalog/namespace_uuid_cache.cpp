@@ -45,7 +45,7 @@ namespace mongo {
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(debugCollectionUUIDs, bool, false);
 
 const OperationContext::Decoration<NamespaceUUIDCache> NamespaceUUIDCache::get =
-    OperationContext::declareDecoration<NamespaceUUIDCache>();
+    OperationContext::declareLazyDecoration<NamespaceUUIDCache>();
 
 void NamespaceUUIDCache::ensureNamespaceInCache(const NamespaceString& nss, CollectionUUID uuid) {
     StringData ns(nss.ns());
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/partial_filter_set.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+using FilterLess = std::less<const MatchExpression*>;
+
+/**
+ * Returns true for the leaves a partial filter may contain, all of which match a document exactly
+ * when matchesSingleElement() is true for the single non-array element at their path.
+ */
+bool isSplittableLeaf(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::EXISTS:
+        case MatchExpression::TYPE_OPERATOR:
+            return !expr->path().empty();
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+bool PartialFilterSet::Matches::matched(const MatchExpression* filter) const {
+    if (!filter)
+        return true;
+
+    invariant(_set);
+    const auto& filters = _set->_filters;
+    auto it = std::lower_bound(
+        filters.begin(), filters.end(), filter, [](const Filter& lhs, const MatchExpression* rhs) {
+            return FilterLess()(lhs.expr, rhs);
+        });
+    invariant(it != filters.end() && it->expr == filter);
+    return _matched[it - filters.begin()];
+}
+
+PartialFilterSet::PartialFilterSet(std::vector<const MatchExpression*> filters) {
+    std::sort(filters.begin(), filters.end(), FilterLess());
+    filters.erase(std::unique(filters.begin(), filters.end()), filters.end());
+
+    for (auto&& expr : filters) {
+        if (!expr)
+            continue;
+
+        std::vector<const MatchExpression*> leaves;
+        if (expr->matchType() == MatchExpression::AND) {
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                leaves.push_back(expr->getChild(i));
+            }
+        } else {
+            leaves.push_back(expr);
+        }
+
+        Filter filter{expr, {}};
+        if (std::all_of(leaves.begin(), leaves.end(), isSplittableLeaf)) {
+            for (auto&& leaf : leaves) {
+                filter.leaves.push_back({leaf, _addPath(leaf->path())});
+            }
+        }
+        _filters.push_back(std::move(filter));
+    }
+}
+
+size_t PartialFilterSet::_addPath(StringData dottedPath) {
+    auto existing = std::find(_pathNames.begin(), _pathNames.end(), dottedPath);
+    if (existing != _pathNames.end())
+        return existing - _pathNames.begin();
+
+    FieldRef fieldRef(dottedPath);
+    const StringData topLevelField = fieldRef.getPart(0);
+    auto topLevel = std::find(_topLevelFields.begin(), _topLevelFields.end(), topLevelField);
+    if (topLevel == _topLevelFields.end())
+        topLevel = _topLevelFields.insert(topLevel, topLevelField.toString());
+
+    Path path{static_cast<size_t>(topLevel - _topLevelFields.begin()), {}};
+    for (size_t i = 1; i < fieldRef.numParts(); ++i) {
+        path.rest.push_back(fieldRef.getPart(i).toString());
+    }
+
+    _paths.push_back(std::move(path));
+    _pathNames.push_back(dottedPath.toString());
+    return _paths.size() - 1;
+}
+
+PartialFilterSet::Matches PartialFilterSet::evaluate(const BSONObj& doc) const {
+    Matches matches;
+    matches._set = this;
+    matches._matched.resize(_filters.size());
+    if (_filters.empty())
+        return matches;
+
+    // Find every top-level field referenced by a filter in a single scan of the document. Like
+    // BSONObj::getField(), the first of several fields with the same name wins.
+    std::vector<BSONElement> topLevel(_topLevelFields.size());
+    size_t numFound = 0;
+    for (auto&& elem : doc) {
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < topLevel.size(); ++i) {
+            if (topLevel[i].eoo() && fieldName == _topLevelFields[i]) {
+                topLevel[i] = elem;
+                ++numFound;
+                break;
+            }
+        }
+        if (numFound == topLevel.size())
+            break;
+    }
+
+    // Resolve each path through embedded objects. A path left EOO is either missing or crosses
+    // an array, and the filters which reference it have to use the matcher's path traversal.
+    std::vector<BSONElement> elements(_paths.size());
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        BSONElement elem = topLevel[_paths[i].topLevelField];
+        for (auto&& part : _paths[i].rest) {
+            if (elem.type() != BSONType::Object) {
+                elem = BSONElement();
+                break;
+            }
+            elem = elem.embeddedObject().getField(part);
+        }
+        if (elem.type() != BSONType::Array)
+            elements[i] = elem;
+    }
+
+    for (size_t i = 0; i < _filters.size(); ++i) {
+        const Filter& filter = _filters[i];
+        if (filter.leaves.empty()) {
+            matches._matched[i] = filter.expr->matchesBSON(doc);
+            continue;
+        }
+
+        // A leaf which fails on a resolved element fails the whole $and, whatever the leaves which
+        // need the fallback would say.
+        bool matched = true;
+        bool needsFallback = false;
+        for (auto&& leaf : filter.leaves) {
+            const BSONElement& elem = elements[leaf.path];
+            if (elem.eoo()) {
+                needsFallback = true;
+            } else if (!leaf.expr->matchesSingleElement(elem)) {
+                matched = false;
+                break;
+            }
+        }
+        matches._matched[i] = matched && (!needsFallback || filter.expr->matchesBSON(doc));
+    }
+
+    return matches;
+}
+
+}  // namespace mongo
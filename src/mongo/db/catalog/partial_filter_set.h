@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class MatchExpression;
+
+/**
+ * Evaluates the partial filters of every index on a collection against a document in one pass.
+ *
+ * Partial filters are restricted to a top-level $and of simple comparisons, $exists and $type, so
+ * each filter is split into leaves over a set of dotted paths shared by all filters. Each path is
+ * looked up once per document and every leaf is checked against the element found there. A filter
+ * falls back to a full MatchExpression::matchesBSON() when one of its paths is missing or crosses
+ * an array, since those cases need the matcher's path traversal rules.
+ *
+ * The set does not own the filters, which must outlive it.
+ */
+class PartialFilterSet {
+public:
+    /**
+     * The outcome of evaluating every filter in a set against one document. Only valid for as long
+     * as the set which produced it.
+     */
+    class Matches {
+    public:
+        /**
+         * Returns whether the document matched 'filter', which must be one of the filters of the
+         * set. A null filter matches every document.
+         */
+        bool matched(const MatchExpression* filter) const;
+
+    private:
+        friend class PartialFilterSet;
+
+        const PartialFilterSet* _set = nullptr;
+        std::vector<char> _matched;
+    };
+
+    PartialFilterSet() = default;
+
+    /**
+     * Builds a set over 'filters'. Null and repeated entries are ignored.
+     */
+    explicit PartialFilterSet(std::vector<const MatchExpression*> filters);
+
+    bool empty() const {
+        return _filters.empty();
+    }
+
+    /**
+     * Evaluates every filter against 'doc'.
+     */
+    Matches evaluate(const BSONObj& doc) const;
+
+private:
+    struct Leaf {
+        const MatchExpression* expr;
+        size_t path;
+    };
+
+    struct Filter {
+        const MatchExpression* expr;
+
+        // Empty if the filter has a shape the set cannot split, in which case it is always
+        // evaluated with matchesBSON().
+        std::vector<Leaf> leaves;
+    };
+
+    struct Path {
+        size_t topLevelField;
+        std::vector<std::string> rest;
+    };
+
+    size_t _addPath(StringData dottedPath);
+
+    // Sorted by filter pointer, so that Matches can look filters up without a map.
+    std::vector<Filter> _filters;
+
+    std::vector<Path> _paths;
+    std::vector<std::string> _pathNames;
+    std::vector<std::string> _topLevelFields;
+};
+
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/partial_filter_set.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parseFilter(const char* json) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto statusWithMatcher = MatchExpressionParser::parse(fromjson(json), expCtx);
+    ASSERT_OK(statusWithMatcher.getStatus());
+    return std::move(statusWithMatcher.getValue());
+}
+
+/**
+ * Checks that the set agrees with matchesBSON() for every filter on every document.
+ */
+void assertMatchesAgree(const std::vector<const char*>& filterJson,
+                        const std::vector<const char*>& docJson) {
+    std::vector<std::unique_ptr<MatchExpression>> owned;
+    std::vector<const MatchExpression*> filters;
+    for (auto&& json : filterJson) {
+        owned.push_back(parseFilter(json));
+        filters.push_back(owned.back().get());
+    }
+
+    PartialFilterSet set(filters);
+    for (auto&& json : docJson) {
+        BSONObj doc = fromjson(json);
+        auto matches = set.evaluate(doc);
+        for (size_t i = 0; i < filters.size(); ++i) {
+            ASSERT_EQ(filters[i]->matchesBSON(doc), matches.matched(filters[i]))
+                << "filter: " << filterJson[i] << ", document: " << json;
+        }
+    }
+}
+
+TEST(PartialFilterSetTest, EmptySetMatchesNullFilter) {
+    PartialFilterSet set;
+    ASSERT_TRUE(set.empty());
+    ASSERT_TRUE(set.evaluate(BSON("a" << 1)).matched(nullptr));
+
+    PartialFilterSet nullOnly({nullptr});
+    ASSERT_TRUE(nullOnly.empty());
+}
+
+TEST(PartialFilterSetTest, SingleLeafFilters) {
+    assertMatchesAgree({"{a: {$gt: 5}}", "{a: {$exists: true}}", "{b: {$type: 'string'}}"},
+                       {"{a: 6, b: 'x'}", "{a: 5, b: 1}", "{b: 'y'}", "{}", "{a: null}"});
+}
+
+TEST(PartialFilterSetTest, ConjunctionsSharingPaths) {
+    assertMatchesAgree({"{a: {$gte: 1}, b: {$lt: 10}}", "{a: {$lte: 3}, c: 'x'}", "{b: 2}"},
+                       {"{a: 1, b: 2, c: 'x'}",
+                        "{a: 4, b: 2, c: 'x'}",
+                        "{a: 2, b: 20}",
+                        "{b: 2}",
+                        "{c: 'x', a: 3, b: 9}"});
+}
+
+TEST(PartialFilterSetTest, DottedPaths) {
+    assertMatchesAgree({"{'a.b': {$gt: 0}}", "{'a.c.d': {$exists: true}}", "{'a.b': 1, e: 1}"},
+                       {"{a: {b: 1, c: {d: 1}}, e: 1}",
+                        "{a: {b: -1}}",
+                        "{a: 1}",
+                        "{a: {c: 5}}",
+                        "{a: {b: {c: 1}}}"});
+}
+
+TEST(PartialFilterSetTest, ArraysFallBackToMatcher) {
+    assertMatchesAgree({"{a: 2}", "{'a.b': {$gt: 1}}", "{a: {$type: 'array'}}", "{a: [1, 2]}"},
+                       {"{a: [1, 2]}",
+                        "{a: [{b: 0}, {b: 2}]}",
+                        "{a: {b: [0, 3]}}",
+                        "{a: [[1, 2]]}",
+                        "{a: 2}"});
+}
+
+TEST(PartialFilterSetTest, MissingPathsFallBackToMatcher) {
+    assertMatchesAgree({"{a: null}", "{a: null, b: 1}", "{'a.b': null}"},
+                       {"{}", "{b: 1}", "{a: null, b: 1}", "{a: 5}", "{a: {c: 1}}"});
+}
+
+TEST(PartialFilterSetTest, DuplicateFieldNamesUseFirst) {
+    assertMatchesAgree({"{a: 1}"}, {"{a: 1, a: 2}", "{a: 2, a: 1}"});
+}
+
+TEST(PartialFilterSetTest, RepeatedFilterIsEvaluatedOnce) {
+    auto filter = parseFilter("{a: {$lt: 5}}");
+    PartialFilterSet set({filter.get(), nullptr, filter.get()});
+    ASSERT_FALSE(set.empty());
+    ASSERT_TRUE(set.evaluate(BSON("a" << 1)).matched(filter.get()));
+    ASSERT_FALSE(set.evaluate(BSON("a" << 7)).matched(filter.get()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/catalog/index_consistency.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -117,10 +118,12 @@ Status RecordStoreValidateAdaptor::validate(const RecordId& recordId,
     return status;
 }
 
-void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
+void RecordStoreValidateAdaptor::traverseIndex(OperationContext* opCtx,
+                                               const IndexAccessMethod* iam,
                                                const IndexDescriptor* descriptor,
                                                ValidateResults* results,
                                                int64_t* numTraversedKeys) {
+    const int interruptInterval = 4096;
     auto indexNs = descriptor->indexNamespace();
     int indexNumber = _indexConsistency->getIndexNumber(indexNs);
     int64_t numKeys = 0;
@@ -131,9 +134,12 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
     std::unique_ptr<KeyString> prevIndexKeyString = nullptr;
     bool isFirstEntry = true;
 
-    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(_opCtx, true);
+    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(opCtx, true);
     // Seeking to BSONObj() is equivalent to seeking to the first entry of an index.
     for (auto indexEntry = cursor->seek(BSONObj(), true); indexEntry; indexEntry = cursor->next()) {
+        if (!(numKeys % interruptInterval)) {
+            _checkForInterrupt(opCtx);
+        }
 
         // We want to use the latest version of KeyString here.
         std::unique_ptr<KeyString> indexKeyString =
@@ -158,6 +164,21 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
     *numTraversedKeys = numKeys;
 }
 
+void RecordStoreValidateAdaptor::_checkForInterrupt(OperationContext* opCtx) const {
+    opCtx->checkForInterrupt();
+    if (opCtx == _opCtx) {
+        return;
+    }
+
+    // Killing the validate command only marks its own operation, so scans on other threads have
+    // to look for it there.
+    stdx::lock_guard<Client> lk(*_opCtx->getClient());
+    const auto killStatus = _opCtx->getKillStatus();
+    if (killStatus != ErrorCodes::OK) {
+        uasserted(killStatus, "validate was interrupted");
+    }
+}
+
 void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
                                                      ValidateCmdLevel level,
                                                      ValidateResults* results,
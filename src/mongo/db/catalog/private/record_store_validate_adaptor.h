@@ -70,9 +70,11 @@ public:
 
     /**
      * Traverses the index getting index entriess to validate them and keep track of the index keys
-     * for index consistency.
+     * for index consistency. 'opCtx' may belong to another thread than the one the adaptor was
+     * created on, so that several indexes can be traversed at once.
      */
-    void traverseIndex(const IndexAccessMethod* iam,
+    void traverseIndex(OperationContext* opCtx,
+                       const IndexAccessMethod* iam,
                        const IndexDescriptor* descriptor,
                        ValidateResults* results,
                        int64_t* numTraversedKeys);
@@ -92,6 +94,11 @@ public:
     void validateIndexKeyCount(IndexDescriptor* idx, int64_t numRecs, ValidateResults& results);
 
 private:
+    /**
+     * Throws if either 'opCtx' or the operation the adaptor was created for has been killed.
+     */
+    void _checkForInterrupt(OperationContext* opCtx) const;
+
     OperationContext* _opCtx;             // Not owned.
     IndexConsistency* _indexConsistency;  // Not owned.
     ValidateCmdLevel _level;
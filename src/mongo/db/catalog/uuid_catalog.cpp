@@ -34,8 +34,11 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -102,6 +105,18 @@ repl::OpTime UUIDCatalogObserver::onRenameCollection(OperationContext* opCtx,
     return {};
 }
 
+UUIDCatalog::UUIDCatalog() {
+    for (auto&& shard : _published) {
+        shard.store(new PublishedShard());
+    }
+}
+
+UUIDCatalog::~UUIDCatalog() {
+    for (auto&& shard : _published) {
+        delete shard.load();
+    }
+}
+
 UUIDCatalog& UUIDCatalog::get(ServiceContext* svcCtx) {
     return getCatalog(svcCtx);
 }
@@ -169,21 +184,74 @@ void UUIDCatalog::onOpenCatalog() {
     _shadowCatalog.reset();
 }
 
+template <typename Reader>
+auto UUIDCatalog::_readPublished(CollectionUUID uuid, Reader&& reader) const
+    -> decltype(reader(std::declval<const PublishedShard&>())) {
+    auto& slot = _readerSlots[std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) %
+                              kNumReaderSlots];
+    auto& shard = _published[CollectionUUID::Hash()(uuid) % kNumPublishedShards];
+
+    while (true) {
+        // Announce the reader in the current epoch. If the epoch advanced in the meantime, a
+        // writer may not have seen the announcement, so try again in the new epoch.
+        const auto epoch = _epoch.load();
+        auto& active = slot.active[epoch % 2];
+        active.fetchAndAdd(1);
+        ON_BLOCK_EXIT([&] { active.subtractAndFetch(1); });
+        if (_epoch.load() == epoch) {
+            return reader(*shard.load());
+        }
+    }
+}
+
+void UUIDCatalog::_publish_inlock(CollectionUUID uuid,
+                                  Collection* coll,
+                                  const stdx::lock_guard<stdx::mutex>&) {
+    auto& shard = _published[CollectionUUID::Hash()(uuid) % kNumPublishedShards];
+    auto updated = stdx::make_unique<PublishedShard>(*shard.load());
+    if (coll) {
+        (*updated)[uuid] = {coll, coll->ns()};
+    } else {
+        updated->erase(uuid);
+    }
+    const PublishedShard* previous = shard.swap(updated.release());
+
+    // Readers that enter from now on see the new copy. Wait for the ones that entered before.
+    const auto previousEpoch = _epoch.fetchAndAdd(1);
+    for (auto&& readerSlot : _readerSlots) {
+        while (readerSlot.active[previousEpoch % 2].load() > 0) {
+            stdx::this_thread::yield();
+        }
+    }
+    delete previous;
+}
+
 Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    return foundIt == _catalog.end() ? nullptr : foundIt->second;
+    return _readPublished(uuid, [&](const PublishedShard& shard) -> Collection* {
+        auto foundIt = shard.find(uuid);
+        return foundIt == shard.end() ? nullptr : foundIt->second.collection;
+    });
 }
 
 NamespaceString UUIDCatalog::lookupNSSByUUID(CollectionUUID uuid) const {
+    auto nss = _readPublished(uuid, [&](const PublishedShard& shard) {
+        boost::optional<NamespaceString> found;
+        auto foundIt = shard.find(uuid);
+        if (foundIt != shard.end())
+            found = foundIt->second.nss;
+        return found;
+    });
+    if (nss)
+        return *nss;
+
+    // Only in the case that the catalog is closed and a UUID is currently unknown, resolve it
+    // using the pre-close state. This ensures that any tasks reloading the catalog can see their
+    // own updates.
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     auto foundIt = _catalog.find(uuid);
     if (foundIt != _catalog.end())
         return foundIt->second->ns();
 
-    // Only in the case that the catalog is closed and a UUID is currently unknown, resolve it
-    // using the pre-close state. This ensures that any tasks reloading the catalog can see their
-    // own updates.
     if (_shadowCatalog) {
         auto shadowIt = _shadowCatalog->find(uuid);
         if (shadowIt != _shadowCatalog->end())
@@ -202,6 +270,7 @@ void UUIDCatalog::registerUUIDCatalogEntry(CollectionUUID uuid, Collection* coll
         std::pair<CollectionUUID, Collection*> entry = std::make_pair(uuid, coll);
         LOG(2) << "registering collection " << coll->ns() << " with UUID " << uuid.toString();
         invariant(_catalog.insert(entry).second == true);
+        _publish_inlock(uuid, coll, lock);
     }
 }
 
@@ -218,6 +287,7 @@ Collection* UUIDCatalog::removeUUIDCatalogEntry(CollectionUUID uuid) {
     auto foundCol = foundIt->second;
     LOG(2) << "unregistering collection " << foundCol->ns() << " with UUID " << uuid.toString();
     _catalog.erase(foundIt);
+    _publish_inlock(uuid, nullptr, lock);
     return foundCol;
 }
 
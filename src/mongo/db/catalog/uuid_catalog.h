@@ -28,12 +28,15 @@
 
 #pragma once
 
+#include <array>
 #include <unordered_map>
+#include <utility>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/uuid.h"
 
@@ -121,7 +124,8 @@ class UUIDCatalog {
 public:
     static UUIDCatalog& get(ServiceContext* svcCtx);
     static UUIDCatalog& get(OperationContext* opCtx);
-    UUIDCatalog() = default;
+    UUIDCatalog();
+    ~UUIDCatalog();
 
     /**
      * This function inserts the entry for uuid, coll into the UUID Collection. It is called by
@@ -158,6 +162,8 @@ public:
      * CollectionUUID uuid. The required locks should be obtained prior
      * to calling this function, or else the found Collection pointer
      * might no longer be valid when the call returns.
+     *
+     * Like lookupNSSByUUID, this does not take the catalog's mutex.
      */
     Collection* lookupCollectionByUUID(CollectionUUID uuid) const;
 
@@ -198,6 +204,38 @@ private:
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
                                                            const stdx::lock_guard<stdx::mutex>&);
 
+    struct PublishedEntry {
+        Collection* collection;
+        NamespaceString nss;
+    };
+    using PublishedShard =
+        mongo::stdx::unordered_map<CollectionUUID, PublishedEntry, CollectionUUID::Hash>;
+
+    // Counts the readers that entered in an even and in an odd epoch. Each slot is on its own
+    // cache line, so that readers on different cores don't contend.
+    struct alignas(64) ReaderSlot {
+        std::array<AtomicWord<long long>, 2> active;
+    };
+
+    static const size_t kNumPublishedShards = 64;
+    static const size_t kNumReaderSlots = 16;
+
+    /**
+     * Runs 'reader' on the published shard holding 'uuid', without taking _catalogLock. The shard
+     * cannot be freed until 'reader' returns.
+     */
+    template <typename Reader>
+    auto _readPublished(CollectionUUID uuid, Reader&& reader) const
+        -> decltype(reader(std::declval<const PublishedShard&>()));
+
+    /**
+     * Publishes a copy of the shard holding 'uuid' with the entry for 'uuid' set to 'coll', or
+     * removed if 'coll' is null, and frees the previous copy once no reader can be using it.
+     */
+    void _publish_inlock(CollectionUUID uuid,
+                         Collection* coll,
+                         const stdx::lock_guard<stdx::mutex>&);
+
     mutable mongo::stdx::mutex _catalogLock;
     /**
      * When present, indicates that the catalog is in closed state, and contains a map from UUID
@@ -215,6 +253,16 @@ private:
      */
     StringMap<std::vector<CollectionUUID>> _orderedCollections;
     mongo::stdx::unordered_map<CollectionUUID, Collection*, CollectionUUID::Hash> _catalog;
+
+    /**
+     * Immutable copies of _catalog, split into shards by UUID, for the lookups that don't take
+     * _catalogLock. Writers, which hold _catalogLock, replace a shard's copy and then wait for a
+     * grace period: they advance _epoch, and wait until no reader that entered in the previous
+     * epoch is still active.
+     */
+    std::array<AtomicWord<const PublishedShard*>, kNumPublishedShards> _published;
+    mutable std::array<ReaderSlot, kNumReaderSlots> _readerSlots;
+    AtomicWord<unsigned long long> _epoch{0};
 };
 
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/catalog/collection_mock.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 using namespace mongo;
@@ -230,4 +231,37 @@ TEST_F(UUIDCatalogTest, LookupNSSByUUIDForClosedCatalogReturnsFreshestNSS) {
     ASSERT_EQUALS(catalog.lookupCollectionByUUID(colUUID), &newCol);
     ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), newNss);
 }
+
+TEST_F(UUIDCatalogTest, LookupsRaceWithCreateAndDrop) {
+    NamespaceString newNss(nss.db(), "newcol");
+    Collection newCol(stdx::make_unique<CollectionMock>(newNss));
+    auto newUUID = CollectionUUID::gen();
+
+    AtomicWord<bool> done{false};
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                // The registered collection is always found, and the one being created and
+                // dropped is either found whole or not at all.
+                ASSERT_EQUALS(catalog.lookupCollectionByUUID(colUUID), &col);
+                ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), nss);
+                auto found = catalog.lookupCollectionByUUID(newUUID);
+                ASSERT(found == nullptr || found == &newCol);
+                auto foundNss = catalog.lookupNSSByUUID(newUUID);
+                ASSERT(foundNss == NamespaceString() || foundNss == newNss);
+            }
+        });
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        catalog.onCreateCollection(&opCtx, &newCol, newUUID);
+        catalog.onDropCollection(&opCtx, newUUID);
+    }
+    done.store(true);
+    for (auto&& reader : readers) {
+        reader.join();
+    }
+    ASSERT(catalog.lookupCollectionByUUID(newUUID) == nullptr);
+}
 }  // namespace
@@ -30,6 +30,7 @@
 
 #include "mongo/db/clientcursor.h"
 
+#include <algorithm>
 #include <string>
 #include <time.h>
 #include <vector>
@@ -71,6 +72,20 @@ static ServerStatusMetricField<Counter64> dCursorStatsOpenNoTimeout("cursor.open
 static ServerStatusMetricField<Counter64> dCursorStatusTimedout("cursor.timedOut",
                                                                 &cursorStatsTimedOut);
 
+static Counter64 cursorStatsPrefetchDocs;
+static Counter64 cursorStatsPrefetchDocsReturned;
+static Counter64 cursorStatsPrefetchHits;
+static Counter64 cursorStatsPrefetchMisses;
+
+static ServerStatusMetricField<Counter64> dCursorStatsPrefetchDocs("cursor.prefetch.docs",
+                                                                   &cursorStatsPrefetchDocs);
+static ServerStatusMetricField<Counter64> dCursorStatsPrefetchDocsReturned(
+    "cursor.prefetch.docsReturned", &cursorStatsPrefetchDocsReturned);
+static ServerStatusMetricField<Counter64> dCursorStatsPrefetchHits("cursor.prefetch.hits",
+                                                                   &cursorStatsPrefetchHits);
+static ServerStatusMetricField<Counter64> dCursorStatsPrefetchMisses("cursor.prefetch.misses",
+                                                                     &cursorStatsPrefetchMisses);
+
 long long ClientCursor::totalOpen() {
     return cursorStatsOpen.get();
 }
@@ -116,6 +131,36 @@ ClientCursor::~ClientCursor() {
     }
 }
 
+void ClientCursor::PrefetchStats::recordPrefetch(long long numDocs) {
+    ++numPrefetches;
+    docsPrefetched += numDocs;
+    docsWaiting += numDocs;
+    cursorStatsPrefetchDocs.increment(numDocs);
+}
+
+void ClientCursor::PrefetchStats::recordGetMore(long long numReturned, bool expectedPrefetch) {
+    if (docsWaiting > 0) {
+        const long long served = std::min(numReturned, docsWaiting);
+        docsWaiting -= served;
+        docsReturned += served;
+        ++getMoreHits;
+        cursorStatsPrefetchDocsReturned.increment(served);
+        cursorStatsPrefetchHits.increment();
+    } else if (expectedPrefetch) {
+        ++getMoreMisses;
+        cursorStatsPrefetchMisses.increment();
+    }
+}
+
+void ClientCursor::PrefetchStats::append(BSONObjBuilder* builder) const {
+    builder->append("numPrefetches", numPrefetches);
+    builder->append("docsPrefetched", docsPrefetched);
+    builder->append("docsReturned", docsReturned);
+    builder->append("docsWaiting", docsWaiting);
+    builder->append("getMoreHits", getMoreHits);
+    builder->append("getMoreMisses", getMoreMisses);
+}
+
 void ClientCursor::markAsKilled(Status killStatus) {
     _exec->markAsKilled(killStatus);
 }
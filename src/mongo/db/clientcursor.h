@@ -211,6 +211,45 @@ public:
         _leftoverMaxTimeMicros = leftoverMaxTimeMicros;
     }
 
+    //
+    // Prefetching.
+    //
+
+    /**
+     * Counts how the results prefetched for this cursor between getMores were used. Only accessed
+     * by the operation which has the cursor pinned.
+     */
+    struct PrefetchStats {
+        // Results prefetched and not yet returned by a getMore.
+        long long docsWaiting = 0;
+
+        long long numPrefetches = 0;
+        long long docsPrefetched = 0;
+        // Prefetched results returned by getMores.
+        long long docsReturned = 0;
+        // getMores which found prefetched results waiting, and those which found none.
+        long long getMoreHits = 0;
+        long long getMoreMisses = 0;
+
+        /**
+         * Records that a prefetch stashed 'numDocs' more results.
+         */
+        void recordPrefetch(long long numDocs);
+
+        /**
+         * Records that a getMore returned 'numReturned' results, serving them from the prefetched
+         * results first. A getMore which finds nothing prefetched only counts as a miss if
+         * 'expectedPrefetch' is true.
+         */
+        void recordGetMore(long long numReturned, bool expectedPrefetch);
+
+        void append(BSONObjBuilder* builder) const;
+    };
+
+    PrefetchStats& getPrefetchStats() {
+        return _prefetchStats;
+    }
+
     /**
      * Returns the server-wide the count of living cursors. Such a cursor is called an "open
      * cursor".
@@ -310,6 +349,8 @@ private:
     // Unused maxTime budget for this cursor.
     Microseconds _leftoverMaxTimeMicros = Microseconds::max();
 
+    PrefetchStats _prefetchStats;
+
     // The underlying query execution machinery. Must be non-null.
     std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> _exec;
 
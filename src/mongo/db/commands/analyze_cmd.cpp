@@ -0,0 +1,220 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultSampleSize = 10000;
+
+/**
+ * Returns a uniform sample of up to 'sampleSize' of the documents of 'collection'.
+ */
+std::vector<BSONObj> sampleDocuments(OperationContext* opCtx,
+                                     Collection* collection,
+                                     long long sampleSize) {
+    std::vector<BSONObj> docs;
+
+    // A random cursor only pays off when it skips most of the collection.
+    std::unique_ptr<RecordCursor> randomCursor;
+    if (collection->numRecords(opCtx) > sampleSize) {
+        randomCursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    }
+    if (randomCursor) {
+        while (static_cast<long long>(docs.size()) < sampleSize) {
+            auto record = randomCursor->next();
+            if (!record) {
+                break;
+            }
+            docs.push_back(record->data.toBson().getOwned());
+        }
+        return docs;
+    }
+
+    // Otherwise scan the whole collection and keep a reservoir sample of it.
+    PseudoRandom random(SecureRandom::create()->nextInt64());
+    auto cursor = collection->getCursor(opCtx);
+    long long numSeen = 0;
+    while (auto record = cursor->next()) {
+        ++numSeen;
+        if (static_cast<long long>(docs.size()) < sampleSize) {
+            docs.push_back(record->data.toBson().getOwned());
+            continue;
+        }
+        const long long slot = random.nextInt64(numSeen);
+        if (slot < sampleSize) {
+            docs[slot] = record->data.toBson().getOwned();
+        }
+    }
+    return docs;
+}
+
+/**
+ * Gathers statistics on the keys that 'docs' generate for the index 'desc'.
+ */
+std::shared_ptr<IndexStatistics> analyzeIndex(Collection* collection,
+                                              const IndexDescriptor* desc,
+                                              const std::vector<BSONObj>& docs) {
+    const IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    const IndexAccessMethod* iam = indexCatalog->getIndex(desc);
+    const MatchExpression* filter =
+        desc->isPartial() ? indexCatalog->getEntry(desc)->getFilterExpression() : nullptr;
+
+    std::vector<BSONObj> leadingValues;
+    for (auto&& doc : docs) {
+        if (filter && !filter->matchesBSON(doc)) {
+            continue;
+        }
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        iam->getKeys(doc, IndexAccessMethod::GetKeysMode::kRelaxConstraints, &keys, nullptr);
+        for (auto&& key : keys) {
+            leadingValues.push_back(key.firstElement().wrap(""));
+        }
+    }
+
+    auto stats = std::make_shared<IndexStatistics>();
+    stats->keyPattern = desc->keyPattern().getOwned();
+    stats->keysPerDocument = static_cast<double>(leadingValues.size()) / docs.size();
+    stats->sampledDocuments = docs.size();
+    stats->leadingField = FieldHistogram::make(std::move(leadingValues));
+    return stats;
+}
+
+class AnalyzeCmd : public BasicCommand {
+public:
+    AnalyzeCmd() : BasicCommand("analyze") {}
+
+    std::string help() const override {
+        return "Samples a collection to gather statistics on its indexes for the query planner.\n"
+               "{analyze: <collection>, sampleSize: <number of documents, default 10000>}";
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kOptIn;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::planCacheWrite);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        long long sampleSize = kDefaultSampleSize;
+        if (auto sampleSizeElt = cmdObj["sampleSize"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "sampleSize must be a number",
+                    sampleSizeElt.isNumber());
+            sampleSize = sampleSizeElt.safeNumberLong();
+            uassert(ErrorCodes::BadValue, "sampleSize must be positive", sampleSize > 0);
+        }
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "ns does not exist: " << nss.ns(),
+                collection);
+
+        const std::vector<BSONObj> docs = sampleDocuments(opCtx, collection, sampleSize);
+        result.append("sampledDocuments", static_cast<long long>(docs.size()));
+
+        // With nothing sampled there is nothing to estimate from, so existing statistics are
+        // left as they are.
+        if (docs.empty()) {
+            return true;
+        }
+
+        CollectionStatistics* collectionStats = collection->infoCache()->getCollectionStatistics();
+        BSONArrayBuilder indexesBuilder(result.subarrayStart("indexes"));
+        auto it = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (it.more()) {
+            const IndexDescriptor* desc = it.next();
+            if (IndexNames::nameToType(desc->getAccessMethodName()) != INDEX_BTREE) {
+                continue;
+            }
+
+            auto stats = analyzeIndex(collection, desc, docs);
+
+            BSONObjBuilder indexBuilder(indexesBuilder.subobjStart());
+            indexBuilder.append("name", desc->indexName());
+            indexBuilder.append("keysPerDocument", stats->keysPerDocument);
+            {
+                BSONObjBuilder histogramBuilder(indexBuilder.subobjStart("leadingField"));
+                stats->leadingField.serialize(&histogramBuilder);
+            }
+            indexBuilder.doneFast();
+
+            collectionStats->set(desc->indexName(), std::move(stats));
+        }
+        indexesBuilder.doneFast();
+
+        // Plans cached before the statistics existed skip the estimates, so let them be
+        // chosen again.
+        collection->infoCache()->clearQueryCache();
+        return true;
+    }
+};
+
+MONGO_INITIALIZER(RegisterAnalyzeCmd)(InitializerContext* context) {
+    new AnalyzeCmd();
+    return Status::OK();
+}
+
+}  // namespace
+}  // namespace mongo
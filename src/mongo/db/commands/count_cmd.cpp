@@ -30,6 +30,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
@@ -41,6 +44,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/view_response_formatter.h"
+#include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/util/log.h"
 
@@ -199,6 +203,32 @@ public:
             return true;
         }
 
+        // An unfiltered count of a sharded collection can be answered from the per-chunk document
+        // counts, which leave out orphans and the documents of chunks being migrated in.
+        const auto& countRequest = request.getValue();
+        auto css = CollectionShardingState::get(opCtx, nss);
+        if (countRequest.getQuery().isEmpty() && countRequest.getHint().isEmpty() &&
+            css->canCountOwnedDocuments(opCtx)) {
+            auto ownedCount = css->getOwnedDocumentCount(opCtx);
+            if (!ownedCount) {
+                // Counting the missing chunks locks writers out of the collection, which must not
+                // be done while holding our intent lock.
+                ctx.reset();
+                CollectionShardingState::countUncountedChunks(opCtx, nss);
+                ctx.emplace(opCtx, nss, AutoGetCollection::ViewMode::kViewsPermitted);
+                uassert(ErrorCodes::CommandNotSupportedOnView,
+                        str::stream() << "Namespace " << nss.ns() << " became a view",
+                        !ctx->getView());
+
+                ownedCount = CollectionShardingState::get(opCtx, nss)->getOwnedDocumentCount(opCtx);
+            }
+
+            if (ownedCount) {
+                result.appendNumber("n", applySkipLimit(*ownedCount, countRequest));
+                return true;
+            }
+        }
+
         Collection* const collection = ctx->getCollection();
 
         // Prevent chunks from being cleaned up during yields - this allows us to only check the
@@ -244,6 +274,23 @@ public:
         return true;
     }
 
+private:
+    /**
+     * Applies the skip and limit of 'request' to a count of 'num' documents, as the CountStage
+     * would have while counting them.
+     */
+    static long long applySkipLimit(long long num, const CountRequest& request) {
+        num = std::max(0LL, num - request.getSkip());
+
+        // A limit of 0 means no limit, and a negative limit is treated like a positive one
+        const long long limit = std::abs(request.getLimit());
+        if (limit != 0 && limit < num) {
+            num = limit;
+        }
+
+        return num;
+    }
+
 } cmdCount;
 
 }  // namespace
@@ -67,6 +67,7 @@ using IndexVersion = IndexDescriptor::IndexVersion;
 namespace {
 
 const StringData kIndexesFieldName = "indexes"_sd;
+const StringData kKeyGenerationThreadsFieldName = "keyGenerationThreads"_sd;
 const StringData kCommandName = "createIndexes"_sd;
 
 /**
@@ -130,6 +131,16 @@ StatusWith<std::vector<BSONObj>> parseAndValidateIndexSpecs(
             }
 
             hasIndexesField = true;
+        } else if (kKeyGenerationThreadsFieldName == cmdElemFieldName) {
+            if (!cmdElem.isNumber() || cmdElem.safeNumberLong() < 1 ||
+                cmdElem.safeNumberLong() > MultiIndexBlock::kMaxKeyGenerationThreads) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "The field '" << kKeyGenerationThreadsFieldName
+                                      << "' must be a number between 1 and "
+                                      << MultiIndexBlock::kMaxKeyGenerationThreads
+                                      << ", but got "
+                                      << cmdElem};
+            }
         } else if (kCommandName == cmdElemFieldName || isGenericArgument(cmdElemFieldName)) {
             continue;
         } else {
@@ -303,6 +314,9 @@ public:
         MultiIndexBlock indexer(opCtx, collection);
         indexer.allowBackgroundBuilding();
         indexer.allowInterruption();
+        if (auto keyGenerationThreads = cmdObj[kKeyGenerationThreadsFieldName]) {
+            indexer.setKeyGenerationThreads(keyGenerationThreads.safeNumberLong());
+        }
 
         const size_t origSpecsSize = specs.size();
         indexer.removeExistingIndexes(&specs);
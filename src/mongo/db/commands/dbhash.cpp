@@ -32,21 +32,26 @@
 
 #include "mongo/platform/basic.h"
 
-#include <boost/optional.hpp>
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
-#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
-#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/net/socket_utils.h"
@@ -56,6 +61,132 @@ namespace mongo {
 
 namespace {
 
+// The most collections that a dbHash reading from a snapshot hashes at the same time.
+MONGO_EXPORT_SERVER_PARAMETER(dbHashCollectionThreads, int, 4)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue, "dbHashCollectionThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+/**
+ * Returns the _id index key for the 'fieldName' bound of a dbHash command, or an empty object if
+ * the command has no such bound.
+ */
+BSONObj parseIdBound(const BSONObj& cmdObj, StringData fieldName) {
+    BSONElement bound = cmdObj[fieldName];
+    if (bound.eoo()) {
+        return BSONObj();
+    }
+
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "'" << fieldName << "' must be an object of the form {_id: <value>}",
+            bound.type() == Object && bound.Obj().nFields() == 1 && bound.Obj()["_id"]);
+    return BSON("" << bound.Obj()["_id"]);
+}
+
+/**
+ * Returns the MD5 of the documents in 'collection', in _id order, whose _id falls in
+ * ['minKey', 'maxKey'). An empty bound leaves that end of the collection unbounded. Capped
+ * collections without an _id index are hashed in natural order, but only in full.
+ *
+ * Reads directly from the storage engine through 'opCtx', which may belong to another thread than
+ * the one holding the locks on 'collection'.
+ */
+std::string hashCollection(OperationContext* opCtx,
+                           Collection* collection,
+                           const BSONObj& minKey,
+                           const BSONObj& maxKey) {
+    const std::string fullCollectionName = collection->ns().ns();
+    const bool isRange = !minKey.isEmpty() || !maxKey.isEmpty();
+
+    IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
+    if (!desc && (!collection->isCapped() || isRange)) {
+        log() << "can't find _id index for: " << fullCollectionName;
+        return "no _id _index";
+    }
+
+    md5_state_t st;
+    md5_init(&st);
+
+    auto appendRecord = [&](const RecordData& data) {
+        BSONObj obj = data.toBson();
+        md5_append(&st, (const md5_byte_t*)obj.objdata(), obj.objsize());
+    };
+
+    auto recordCursor = collection->getRecordStore()->getCursor(opCtx, true);
+    if (desc) {
+        auto indexCursor = collection->getIndexCatalog()->getIndex(desc)->newCursor(opCtx);
+        if (!maxKey.isEmpty()) {
+            indexCursor->setEndPosition(maxKey, false);
+        }
+
+        for (auto entry = indexCursor->seek(minKey, true); entry; entry = indexCursor->next()) {
+            auto record = recordCursor->seekExact(entry->loc);
+            if (!record) {
+                warning() << "error while hashing, db dropped? ns=" << fullCollectionName;
+                uasserted(34371,
+                          str::stream() << "dbHash found an _id index entry without a document "
+                                        << "in " << fullCollectionName);
+            }
+            appendRecord(record->data);
+        }
+    } else {
+        while (auto record = recordCursor->next()) {
+            appendRecord(record->data);
+        }
+    }
+
+    md5digest d;
+    md5_finish(&st, d);
+    return digestToString(d);
+}
+
+/**
+ * Hashes every collection in 'collections' on up to 'dbHashCollectionThreads' threads, filling in
+ * the corresponding entries of 'hashes'. Each thread reads at 'readTimestamp' through its own
+ * OperationContext; the caller's locks keep the collections from being dropped meanwhile.
+ */
+void hashCollectionsInParallel(const std::vector<Collection*>& collections,
+                               Timestamp readTimestamp,
+                               const BSONObj& minKey,
+                               const BSONObj& maxKey,
+                               std::vector<std::string>* hashes) {
+    // Declared before the pool, whose destructor waits for any scheduled hashes to finish.
+    std::vector<Status> statuses(collections.size(), Status::OK());
+
+    ThreadPool::Options options;
+    options.poolName = "DBHash";
+    options.threadNamePrefix = "DBHash-";
+    options.maxThreads =
+        std::min(collections.size(), static_cast<size_t>(dbHashCollectionThreads.load()));
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThreadIfNotAlready(threadName);
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    for (size_t i = 0; i < collections.size(); ++i) {
+        uassertStatusOK(pool.schedule([&, i] {
+            try {
+                auto opCtx = cc().makeOperationContext();
+                opCtx->recoveryUnit()->setTimestampReadSource(
+                    RecoveryUnit::ReadSource::kProvided, readTimestamp);
+                (*hashes)[i] = hashCollection(opCtx.get(), collections[i], minKey, maxKey);
+            } catch (const DBException& ex) {
+                statuses[i] = ex.toStatus();
+            }
+        }));
+    }
+    pool.shutdown();
+    pool.join();
+
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+}
+
 class DBHashCmd : public ErrmsgCommandDeprecated {
 public:
     DBHashCmd() : ErrmsgCommandDeprecated("dbHash", "dbhash") {}
@@ -107,6 +238,11 @@ public:
             }
         }
 
+        // Optionally hash only the documents with an _id in [min, max), so that ranges of a
+        // collection, such as chunks, can be compared on their own.
+        const BSONObj minKey = parseIdBound(cmdObj, "min");
+        const BSONObj maxKey = parseIdBound(cmdObj, "max");
+
         const std::string ns = parseNs(dbname, cmdObj);
         uassert(ErrorCodes::InvalidNamespace,
                 str::stream() << "Invalid db name: " << ns,
@@ -147,7 +283,11 @@ public:
         BSONArrayBuilder cappedCollections;
         BSONObjBuilder collectionsByUUID;
 
-        BSONObjBuilder bb(result.subobjStart("collections"));
+        // The collections to hash, in order. A null entry hashes to the empty string.
+        std::vector<NamespaceString> hashedNss;
+        std::vector<Collection*> hashedCollections;
+        std::vector<Lock::CollectionLock> collLocks;
+
         for (const auto& collectionName : colls) {
 
             NamespaceString collNss(collectionName);
@@ -186,11 +326,47 @@ public:
                 }
             }
 
-            // Compute the hash for this collection.
-            std::string hash = _hashCollection(opCtx, db, collNss.toString());
+            hashedNss.push_back(collNss);
+            hashedCollections.push_back(_prepareToHash(opCtx, db, collNss, &collLocks));
+        }
 
-            bb.append(collNss.coll(), hash);
-            md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
+        // Compute the hash for each collection. A snapshot read only holds intent locks, so the
+        // collections can be hashed on other threads reading at the same timestamp, unless this
+        // transaction has uncommitted writes, which the other threads can't see.
+        std::vector<std::string> hashes(hashedCollections.size());
+        std::vector<Collection*> collectionsToHash;
+        for (auto collection : hashedCollections) {
+            if (collection) {
+                collectionsToHash.push_back(collection);
+            }
+        }
+        if (collectionsToHash.size() > 1 && dbHashCollectionThreads.load() > 1 && session &&
+            session->inSnapshotReadOrMultiDocumentTransaction() &&
+            !session->transactionHasOperations()) {
+            std::vector<std::string> parallelHashes(collectionsToHash.size());
+            hashCollectionsInParallel(collectionsToHash,
+                                      *opCtx->recoveryUnit()->getPointInTimeReadTimestamp(),
+                                      minKey,
+                                      maxKey,
+                                      &parallelHashes);
+            auto nextHash = parallelHashes.begin();
+            for (size_t i = 0; i < hashedCollections.size(); ++i) {
+                if (hashedCollections[i]) {
+                    hashes[i] = std::move(*nextHash++);
+                }
+            }
+        } else {
+            for (size_t i = 0; i < hashedCollections.size(); ++i) {
+                if (hashedCollections[i]) {
+                    hashes[i] = hashCollection(opCtx, hashedCollections[i], minKey, maxKey);
+                }
+            }
+        }
+
+        BSONObjBuilder bb(result.subobjStart("collections"));
+        for (size_t i = 0; i < hashedNss.size(); ++i) {
+            bb.append(hashedNss[i].coll(), hashes[i]);
+            md5_append(&globalState, (const md5_byte_t*)hashes[i].c_str(), hashes[i].size());
         }
         bb.done();
 
@@ -208,17 +384,18 @@ public:
     }
 
 private:
-    std::string _hashCollection(OperationContext* opCtx,
-                                Database* db,
-                                const std::string& fullCollectionName) {
-
-        NamespaceString ns(fullCollectionName);
-
+    /**
+     * Returns the collection to hash, or null if it doesn't exist, after taking whatever locks
+     * reading it needs. Those are added to 'collLocks' so that they last until the hash is done.
+     */
+    Collection* _prepareToHash(OperationContext* opCtx,
+                               Database* db,
+                               const NamespaceString& ns,
+                               std::vector<Lock::CollectionLock>* collLocks) {
         Collection* collection = db->getCollection(opCtx, ns);
         if (!collection)
-            return "";
+            return nullptr;
 
-        boost::optional<Lock::CollectionLock> collLock;
         auto* session = OperationContextSession::get(opCtx);
         if (session && session->inSnapshotReadOrMultiDocumentTransaction()) {
             // When inside a multi-statement transaction or using snapshot reads, we are only
@@ -227,7 +404,7 @@ private:
             // any catalog operations on the collection.
             invariant(
                 opCtx->lockState()->isDbLockedForMode(db->name(), getLockModeForQuery(opCtx)));
-            collLock.emplace(opCtx->lockState(), fullCollectionName, getLockModeForQuery(opCtx));
+            collLocks->emplace_back(opCtx->lockState(), ns.ns(), getLockModeForQuery(opCtx));
 
             auto minSnapshot = collection->getMinimumVisibleSnapshot();
             auto mySnapshot = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
@@ -245,49 +422,7 @@ private:
             invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_S));
         }
 
-        IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
-
-        std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
-        if (desc) {
-            exec = InternalPlanner::indexScan(opCtx,
-                                              collection,
-                                              desc,
-                                              BSONObj(),
-                                              BSONObj(),
-                                              BoundInclusion::kIncludeStartKeyOnly,
-                                              PlanExecutor::NO_YIELD,
-                                              InternalPlanner::FORWARD,
-                                              InternalPlanner::IXSCAN_FETCH);
-        } else if (collection->isCapped()) {
-            exec = InternalPlanner::collectionScan(
-                opCtx, fullCollectionName, collection, PlanExecutor::NO_YIELD);
-        } else {
-            log() << "can't find _id index for: " << fullCollectionName;
-            return "no _id _index";
-        }
-
-        md5_state_t st;
-        md5_init(&st);
-
-        long long n = 0;
-        PlanExecutor::ExecState state;
-        BSONObj c;
-        verify(NULL != exec.get());
-        while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
-            md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
-            n++;
-        }
-        if (PlanExecutor::IS_EOF != state) {
-            warning() << "error while hashing, db dropped? ns=" << fullCollectionName;
-            uasserted(34371,
-                      "Plan executor error while running dbHash command: " +
-                          WorkingSetCommon::toStatusString(c));
-        }
-        md5digest d;
-        md5_finish(&st, d);
-        std::string hash = digestToString(d);
-
-        return hash;
+        return collection;
     }
 
 } dbhashCmd;
@@ -36,6 +36,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/run_aggregate.h"
 #include "mongo/db/curop_failpoint_helpers.h"
+#include "mongo/db/cursor_prefetcher.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
@@ -44,6 +45,7 @@
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query_result_cache.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_parameters.h"
@@ -306,6 +308,36 @@ public:
 
         Collection* const collection = ctx->getCollection();
 
+        // Serve repeated reads of an opted-in collection from the query result cache. Capped
+        // collections are excluded because their documents age out without a write to observe,
+        // and sharded collections because the results depend on the chunks this shard owns.
+        auto& resultCache = QueryResultCache::get(opCtx->getServiceContext());
+        BSONObj resultCacheKey;
+        uint64_t resultCacheVersion = 0;
+        if (collection && collection->uuid() && !collection->isCapped() &&
+            resultCache.isEnabled(nss) &&
+            !CollectionShardingState::get(opCtx, nss)->getMetadata(opCtx)) {
+            resultCacheKey = QueryResultCache::makeKey(opCtx, *collection->uuid(), cmdObj);
+        }
+        if (!resultCacheKey.isEmpty()) {
+            if (auto cached = resultCache.lookup(nss, resultCacheKey)) {
+                CollectionShardingState::get(opCtx, nss)->checkShardVersionOrThrow(opCtx);
+
+                auto curOp = CurOp::get(opCtx);
+                curOp->debug().nreturned = cached->size();
+                curOp->debug().cursorid = -1;
+                curOp->debug().cursorExhausted = true;
+
+                CursorResponseBuilder firstBatch(/*isInitialResponse*/ true, &result);
+                for (const auto& obj : *cached) {
+                    firstBatch.append(obj);
+                }
+                firstBatch.done(0, nss.ns());
+                return true;
+            }
+            resultCacheVersion = resultCache.getVersion(nss);
+        }
+
         // Get the execution plan for the query.
         auto statusWithPlanExecutor = getExecutorFind(opCtx, collection, nss, std::move(cq));
         uassertStatusOK(statusWithPlanExecutor.getStatus());
@@ -337,6 +369,7 @@ public:
         BSONObj obj;
         PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
         long long numResults = 0;
+        QueryResultCache::Results resultsToCache;
         while (!FindCommon::enoughForFirstBatch(originalQR, numResults) &&
                PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
             // If we can't fit this result inside the current batch, then we stash it for later.
@@ -348,6 +381,10 @@ public:
             // Add result to output buffer.
             firstBatch.append(obj);
             numResults++;
+
+            if (!resultCacheKey.isEmpty()) {
+                resultsToCache.push_back(obj);
+            }
         }
 
         // Throw an assertion if query execution fails for any reason.
@@ -396,8 +433,20 @@ public:
 
             // Fill out curop based on the results.
             endQueryOp(opCtx, collection, *cursorExec, numResults, cursorId);
+
+            // Start reading the next batch while the client is busy with this one.
+            if (CursorPrefetcher::isEligible(opCtx, *pinnedCursor.getCursor())) {
+                pinnedCursor.release();
+                CursorPrefetcher::get(opCtx->getServiceContext())->schedule(nss, cursorId);
+            }
         } else {
             endQueryOp(opCtx, collection, *exec, numResults, cursorId);
+
+            // Only complete result sets are cached, so that a hit never needs a cursor.
+            if (!resultCacheKey.isEmpty() && PlanExecutor::IS_EOF == state) {
+                resultCache.insert(
+                    nss, resultCacheKey, resultCacheVersion, std::move(resultsToCache));
+            }
         }
 
         // Generate the response object to send to the client.
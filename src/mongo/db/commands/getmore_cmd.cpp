@@ -42,6 +42,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/cursor_manager.h"
+#include "mongo/db/cursor_prefetcher.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/cursor_response.h"
@@ -229,6 +230,13 @@ public:
             uassertStatusOK(status);
         }
 
+        // A background prefetch may have the cursor pinned. Stop it before taking any locks, and
+        // serve this batch from whatever it has read so far.
+        if (!CursorManager::isGloballyManagedCursor(request.cursorid)) {
+            CursorPrefetcher::get(opCtx->getServiceContext())
+                ->waitForPrefetch(opCtx, request.cursorid);
+        }
+
         // Cursors come in one of two flavors:
         // - Cursors owned by the collection cursor manager, such as those generated via the find
         //   command. For these cursors, we hold the appropriate collection lock for the duration of
@@ -426,6 +434,16 @@ public:
         Status batchStatus = generateBatch(opCtx, cursor, request, &nextBatch, &state, &numResults);
         uassertStatusOK(batchStatus);
 
+        const bool prefetchEligible = CursorPrefetcher::isEligible(opCtx, *cursor);
+        auto& prefetchStats = cursor->getPrefetchStats();
+        prefetchStats.recordGetMore(numResults, prefetchEligible);
+        if (prefetchStats.numPrefetches > 0) {
+            BSONObjBuilder prefetchBob;
+            prefetchStats.append(&prefetchBob);
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            curOp->setCursorPrefetchStats_inlock(prefetchBob.obj());
+        }
+
         PlanSummaryStats postExecutionStats;
         Explain::getSummaryStats(*exec, &postExecutionStats);
         postExecutionStats.totalKeysExamined -= preExecutionStats.totalKeysExamined;
@@ -476,6 +494,12 @@ public:
                 dropAndReaquireReadLock);
         }
 
+        // Start reading the next batch while the client is busy with this one.
+        if (respondWithId && prefetchEligible) {
+            ccPin.getValue().release();
+            CursorPrefetcher::get(opCtx->getServiceContext())->schedule(request.nss, respondWithId);
+        }
+
         return true;
     }
 
@@ -518,9 +542,9 @@ public:
             while (!FindCommon::enoughForGetMore(request.batchSize.value_or(0), *numResults) &&
                    PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
                 // If adding this object will cause us to exceed the message size limit, then we
-                // stash it for later.
+                // stash it for later, ahead of any results prefetched after it.
                 if (!FindCommon::haveSpaceForNext(obj, *numResults, nextBatch->bytesUsed())) {
-                    exec->enqueue(obj);
+                    exec->requeue(obj);
                     break;
                 }
 
@@ -147,10 +147,17 @@ BSONObj buildViewBson(const ViewDefinition& view, bool nameOnly) {
     if (view.defaultCollator()) {
         optionsBuilder.append("collation", view.defaultCollator()->getSpec().toBSON());
     }
+    if (view.isMaterialized()) {
+        optionsBuilder.append("materialized", true);
+    }
     optionsBuilder.doneFast();
 
-    BSONObj info = BSON("readOnly" << true);
-    b.append("info", info);
+    BSONObjBuilder info(b.subobjStart("info"));
+    info.append("readOnly", true);
+    if (view.isMaterialized() && !view.refreshedAt().isNull()) {
+        info.append("refreshedAt", view.refreshedAt());
+    }
+    info.doneFast();
     return b.obj();
 }
 
@@ -64,6 +64,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/parallel.h"
@@ -74,6 +75,7 @@
 #include "mongo/s/stale_exception.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
@@ -92,6 +94,24 @@ using IndexVersion = IndexDescriptor::IndexVersion;
 namespace dps = ::mongo::dotted_path_support;
 
 namespace mr {
+namespace {
+
+const int kMaxReduceThreads = 16;
+
+}  // namespace
+
+// The number of threads, each with its own JavaScript scope, that reduce the in-memory map of a
+// mapReduce when it is not in jsMode. With 1, the map is reduced on the command's own scope.
+MONGO_EXPORT_SERVER_PARAMETER(mapReduceReduceThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > kMaxReduceThreads) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "mapReduceReduceThreads must be between 1 and "
+                                        << kMaxReduceThreads);
+        }
+
+        return Status::OK();
+    });
 
 AtomicUInt32 Config::JOB_NUMBER;
 
@@ -104,7 +124,11 @@ JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
 }
 
 void JSFunction::init(State* state) {
-    _scope = state->scope();
+    init(state->scope());
+}
+
+void JSFunction::init(Scope* scope) {
+    _scope = scope;
     verify(_scope);
     _scope->init(&_wantedScope);
 
@@ -153,6 +177,10 @@ void JSReducer::init(State* state) {
     _func.init(state);
 }
 
+void JSReducer::init(Scope* scope) {
+    _func.init(scope);
+}
+
 /**
  * Reduces a list of tuple objects (key, value) to a single tuple {"0": key, "1": value}
  */
@@ -320,6 +348,7 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
 
         mapper.reset(new JSMapper(cmdObj["map"]));
         reducer.reset(new JSReducer(cmdObj["reduce"]));
+        reduceCode = cmdObj["reduce"].wrap();
         if (cmdObj["finalize"].type() && cmdObj["finalize"].trueValue())
             finalizer.reset(new JSFinalizer(cmdObj["finalize"]));
 
@@ -831,6 +860,11 @@ bool State::sourceExists() {
 }
 
 State::~State() {
+    if (_reducePool) {
+        _reducePool->shutdown();
+        _reducePool->join();
+    }
+
     if (_onDisk) {
         try {
             dropTempCollections();
@@ -870,12 +904,43 @@ void State::init() {
     if (!_config.scopeSetup.isEmpty())
         _scope->init(&_config.scopeSetup);
 
+    Timer compileTimer;
     _config.mapper->init(this);
     _config.reducer->init(this);
     if (_config.finalizer)
         _config.finalizer->init(this);
+    CurOp::get(_opCtx)->debug().jsCompileMicros += compileTimer.micros();
     _scope->setBoolean("_doFinal", _config.finalizer.get() != 0);
 
+    // Each reducer thread gets a scope set up like the command's own. These are proxy scopes, so
+    // they can be set up here and then called from the pool's threads.
+    const size_t numReduceThreads = mapReduceReduceThreads.load();
+    if (numReduceThreads > 1) {
+        for (size_t i = 0; i < numReduceThreads; ++i) {
+            _reduceScopes.emplace_back(getGlobalScriptEngine()->newScope());
+            Scope* scope = _reduceScopes.back().get();
+            scope->requireOwnedObjects();
+            scope->setLocalDB(_config.dbname);
+            scope->loadStored(_opCtx, true);
+            if (!_config.scopeSetup.isEmpty())
+                scope->init(&_config.scopeSetup);
+
+            _parallelReducers.push_back(
+                stdx::make_unique<JSReducer>(_config.reduceCode.firstElement()));
+            _parallelReducers.back()->init(scope);
+        }
+
+        ThreadPool::Options options;
+        options.poolName = "MapReduceReducers";
+        options.threadNamePrefix = "MapReduceReducer-";
+        options.minThreads = options.maxThreads = numReduceThreads;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThreadIfNotAlready(threadName);
+        };
+        _reducePool = stdx::make_unique<ThreadPool>(options);
+        _reducePool->startup();
+    }
+
     switchMode(_config.jsMode);  // set up js-mode based on Config
 
     // global JS map/reduce hashmap
@@ -1204,6 +1269,13 @@ void State::reduceInMemory() {
         return;
     }
 
+    // with reducer threads, all the keys with several values are reduced up front
+    std::vector<BSONObj> reduced;
+    if (_reducePool) {
+        reduced = _reduceInMemoryInParallel();
+    }
+    auto nextReduced = reduced.begin();
+
     unique_ptr<InMemory> n(new InMemory());  // for new data
     long nSize = 0;
     _dupCount = 0;
@@ -1222,7 +1294,7 @@ void State::reduceInMemory() {
             }
         } else if (all.size() > 1) {
             // several values, reduce and add to map
-            BSONObj res = _config.reducer->reduce(all);
+            BSONObj res = _reducePool ? *nextReduced++ : _config.reducer->reduce(all);
             nSize += _add(n.get(), res);
         }
     }
@@ -1232,6 +1304,48 @@ void State::reduceInMemory() {
     _size = nSize;
 }
 
+std::vector<BSONObj> State::_reduceInMemoryInParallel() {
+    std::vector<const BSONList*> toReduce;
+    for (auto&& keyAndTuples : *_temp) {
+        if (keyAndTuples.second.size() > 1) {
+            toReduce.push_back(&keyAndTuples.second);
+        }
+    }
+
+    // Worker 'w' reduces every key whose position is congruent to 'w', so that the keys are spread
+    // evenly whatever their distribution. Each worker writes only its own results and status.
+    const size_t numWorkers = _parallelReducers.size();
+    std::vector<BSONObj> reduced(toReduce.size());
+    std::vector<Status> statuses(numWorkers, Status::OK());
+    for (size_t worker = 0; worker < numWorkers; ++worker) {
+        Status scheduled = _reducePool->schedule([&, worker] {
+            try {
+                JSReducer* reducer = _parallelReducers[worker].get();
+                for (size_t i = worker; i < toReduce.size(); i += numWorkers) {
+                    if (_opCtx->isKillPending()) {
+                        statuses[worker] = Status(_opCtx->getKillStatus(), "mapReduce killed");
+                        return;
+                    }
+                    reduced[i] = reducer->reduce(*toReduce[i]);
+                }
+            } catch (const DBException& ex) {
+                statuses[worker] = ex.toStatus();
+            }
+        });
+        if (!scheduled.isOK()) {
+            // Don't return while the workers that were scheduled may still use 'toReduce'.
+            _reducePool->waitForIdle();
+            uassertStatusOK(scheduled);
+        }
+    }
+    _reducePool->waitForIdle();
+
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+    return reduced;
+}
+
 /**
  * Dumps the entire in memory map to the inc collection.
  */
@@ -1538,11 +1652,9 @@ public:
                     }
 
                     // do map
-                    if (config.verbose)
-                        mt.reset();
+                    mt.reset();
                     config.mapper->map(o);
-                    if (config.verbose)
-                        mapTime += mt.micros();
+                    mapTime += mt.micros();
 
                     // Check if the state accumulated so far needs to be written to a
                     // collection. This may yield the DB lock temporarily and then
@@ -1612,6 +1724,7 @@ public:
                 shouldHaveData = true;
 
             timingBuilder.appendNumber("mapTime", mapTime / 1000);
+            curOp->debug().jsExecutionMicros += mapTime;
             timingBuilder.append("emitLoop", t.millis());
 
             {
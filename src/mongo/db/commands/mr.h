@@ -46,6 +46,7 @@ namespace mongo {
 class Collection;
 class Database;
 class OperationContext;
+class ThreadPool;
 
 namespace mr {
 
@@ -117,6 +118,11 @@ public:
 
     virtual void init(State* state);
 
+    /**
+     * Compiles the function in 'scope', which must outlive this JSFunction.
+     */
+    void init(Scope* scope);
+
     Scope* scope() const {
         return _scope;
     }
@@ -148,6 +154,7 @@ class JSReducer : public Reducer {
 public:
     JSReducer(const BSONElement& code) : _func("_reduce", code) {}
     virtual void init(State* state);
+    void init(Scope* scope);
 
     virtual BSONObj reduce(const BSONList& tuples);
     virtual BSONObj finalReduce(const BSONList& tuples, Finalizer* finalizer);
@@ -219,6 +226,9 @@ public:
     BSONObj mapParams;
     BSONObj scopeSetup;
 
+    // {reduce: <code>}, kept to build the reducers of the parallel in-memory reduce
+    BSONObj reduceCode;
+
     // output tables
     NamespaceString incLong;
     NamespaceString tempNamespace;
@@ -362,7 +372,11 @@ public:
     long long numReduces() const {
         if (_jsMode)
             return _scope->getNumberLongLong("_redCt");
-        return _config.reducer->numReduces;
+        long long numReduces = _config.reducer->numReduces;
+        for (auto&& reducer : _parallelReducers) {
+            numReduces += reducer->numReduces;
+        }
+        return numReduces;
     }
     long long numInMemKeys() const {
         if (_jsMode)
@@ -393,6 +407,12 @@ protected:
      */
     int _add(InMemory* im, const BSONObj& a);
 
+    /**
+     * Reduces every key of _temp that has several values, spreading the keys across the
+     * reducer threads. Returns the reduced tuples in the iteration order of _temp.
+     */
+    std::vector<BSONObj> _reduceInMemoryInParallel();
+
     OperationContext* _opCtx;
     std::unique_ptr<Scope> _scope;
     bool _onDisk;  // if the end result of this map reduce is disk or not
@@ -408,6 +428,12 @@ protected:
     ScriptingFunction _reduceAndEmit;
     ScriptingFunction _reduceAndFinalize;
     ScriptingFunction _reduceAndFinalizeAndInsert;
+
+    // Used by reduceInMemory() when mapReduceReduceThreads is more than 1. Each reducer has its
+    // own scope and is only ever run by one pool task at a time.
+    std::vector<std::unique_ptr<Scope>> _reduceScopes;
+    std::vector<std::unique_ptr<JSReducer>> _parallelReducers;
+    std::unique_ptr<ThreadPool> _reducePool;
 };
 
 BSONObj fast_emit(const BSONObj& args, void* data);
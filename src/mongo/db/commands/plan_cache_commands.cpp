@@ -45,6 +45,7 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/util/log.h"
 
@@ -92,6 +93,7 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(SetupPlanCacheCommands, MONGO_NO_PREREQUISI
     new PlanCacheListQueryShapes();
     new PlanCacheClear();
     new PlanCacheListPlans();
+    new PlanCacheWarm();
 
     return Status::OK();
 }
@@ -443,6 +445,108 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
     // Append the time the entry was inserted into the plan cache.
     bob->append("timeOfCreation", entry->timeOfCreation);
 
+    // Append the planning history of the query shape, which outlives individual entries.
+    const PlanCacheShapeHistory& history = entry->shapeHistory;
+    BSONObjBuilder historyBob(bob->subobjStart("history"));
+    historyBob.append("since", history.since);
+    historyBob.append("replans", history.replans);
+    historyBob.append("flips", history.flips);
+    historyBob.appendNumber("worksFloor", static_cast<long long>(history.worksFloor));
+    BSONArrayBuilder winnersBob(historyBob.subarrayStart("winners"));
+    for (const auto& winner : history.winners) {
+        BSONObjBuilder winnerBob(winnersBob.subobjStart());
+        winnerBob.append("solution", winner.solution);
+        winnerBob.appendNumber("works", static_cast<long long>(winner.works));
+    }
+    winnersBob.doneFast();
+    historyBob.doneFast();
+
+    return Status::OK();
+}
+
+PlanCacheWarm::PlanCacheWarm()
+    : PlanCacheCommand("planCacheWarm",
+                       "Populates the plan cache by planning the given query shapes.",
+                       ActionType::planCacheWrite) {}
+
+Status PlanCacheWarm::runPlanCacheCommand(OperationContext* opCtx,
+                                          const std::string& ns,
+                                          const BSONObj& cmdObj,
+                                          BSONObjBuilder* bob) {
+    // This is a read lock. The query cache is owned by the collection.
+    AutoGetCollectionForReadCommand ctx(opCtx, NamespaceString(ns));
+
+    PlanCache* planCache;
+    Status status = getPlanCache(opCtx, ctx.getCollection(), ns, &planCache);
+    if (!status.isOK()) {
+        // No collection - nothing to warm.
+        return status;
+    }
+    return warm(opCtx, ctx.getCollection(), *planCache, ns, cmdObj, bob);
+}
+
+// static
+Status PlanCacheWarm::warm(OperationContext* opCtx,
+                           Collection* collection,
+                           const PlanCache& planCache,
+                           const std::string& ns,
+                           const BSONObj& cmdObj,
+                           BSONObjBuilder* bob) {
+    invariant(collection);
+    invariant(bob);
+
+    BSONElement shapesElt = cmdObj.getField("shapes");
+    if (shapesElt.type() != BSONType::Array) {
+        return Status(ErrorCodes::BadValue, "required field shapes must be an array");
+    }
+
+    // Validate every shape before planning any of them, so that a malformed request does not
+    // leave the cache partially warmed.
+    vector<unique_ptr<CanonicalQuery>> queries;
+    for (auto&& shapeElt : shapesElt.Obj()) {
+        if (!shapeElt.isABSONObj()) {
+            return Status(ErrorCodes::BadValue, "each element of shapes must be an object");
+        }
+        auto statusWithCQ = canonicalize(opCtx, ns, shapeElt.Obj());
+        if (!statusWithCQ.isOK()) {
+            return statusWithCQ.getStatus();
+        }
+        queries.push_back(std::move(statusWithCQ.getValue()));
+    }
+
+    const NamespaceString nss(ns);
+    int numWarmed = 0;
+    int numAlreadyCached = 0;
+    int numNotCached = 0;
+    for (auto&& cq : queries) {
+        if (planCache.contains(*cq)) {
+            ++numAlreadyCached;
+            continue;
+        }
+
+        // Building the executor runs plan selection, which caches the winning plan if the query
+        // has more than one candidate. The executor itself is discarded without being run.
+        const CanonicalQuery& query = *cq;
+        LOG(1) << ns << ": warming plan cache for " << redact(query.getQueryObj())
+               << "(sort: " << query.getQueryRequest().getSort()
+               << "; projection: " << query.getQueryRequest().getProj()
+               << "; collation: " << query.getQueryRequest().getCollation() << ")";
+        auto statusWithExec = getExecutorFind(opCtx, collection, nss, std::move(cq));
+        if (!statusWithExec.isOK()) {
+            return statusWithExec.getStatus();
+        }
+
+        if (planCache.contains(query)) {
+            ++numWarmed;
+        } else {
+            ++numNotCached;
+        }
+    }
+
+    bob->append("warmed", numWarmed);
+    bob->append("alreadyCached", numAlreadyCached);
+    bob->append("notCached", numNotCached);
+
     return Status::OK();
 }
 
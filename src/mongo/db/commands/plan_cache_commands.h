@@ -178,4 +178,39 @@ public:
                        BSONObjBuilder* bob);
 };
 
+/**
+ * planCacheWarm
+ *
+ * {
+ *     planCacheWarm: <collection>,
+ *     shapes: [ { query: <query>, sort: <sort>, projection: <projection>,
+ *                 collation: <collation> }, ... ]
+ * }
+ *
+ * Plans each listed query shape against the collection's current indexes so that the winning
+ * plan is added to the plan cache before the first user query of that shape arrives. The shapes
+ * array has the same format as the output of planCacheListQueryShapes, which allows the cache of
+ * one node to be dumped and replayed on another node, or on the same node after a restart.
+ */
+class PlanCacheWarm : public PlanCacheCommand {
+public:
+    PlanCacheWarm();
+    virtual Status runPlanCacheCommand(OperationContext* opCtx,
+                                       const std::string& ns,
+                                       const BSONObj& cmdObj,
+                                       BSONObjBuilder* bob);
+
+    /**
+     * Runs plan selection for every shape in the 'shapes' array of the command object which is
+     * not already cached. Appends the number of shapes that were newly cached, already cached,
+     * or not cacheable (for example because only one plan was available) to the BSON builder.
+     */
+    static Status warm(OperationContext* opCtx,
+                       Collection* collection,
+                       const PlanCache& planCache,
+                       const std::string& ns,
+                       const BSONObj& cmdObj,
+                       BSONObjBuilder* bob);
+};
+
 }  // namespace mongo
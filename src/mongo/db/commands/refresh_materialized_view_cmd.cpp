@@ -0,0 +1,363 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/aggregation_request.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/pipeline/pipeline_d.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/views/view.h"
+#include "mongo/db/views/view_catalog.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+// The number of recomputed groups inserted into a materialized view per unit of work.
+const size_t kRecomputeInsertBatchSize = 1000;
+
+boost::intrusive_ptr<ExpressionContext> makeExpressionContext(
+    OperationContext* opCtx,
+    const NamespaceString& nss,
+    const std::vector<BSONObj>& rawPipeline,
+    const ViewDefinition& view) {
+    AggregationRequest request(nss, rawPipeline);
+    request.setAllowDiskUse(true);
+    return new ExpressionContext(opCtx,
+                                 request,
+                                 CollatorInterface::cloneCollator(view.defaultCollator()),
+                                 std::make_shared<PipelineD::MongoDInterface>(opCtx),
+                                 StringMap<ExpressionContext::ResolvedNamespace>{},
+                                 boost::none);
+}
+
+/**
+ * Combines the group 'stored' in a materialized view with the output 'delta' of its $group over
+ * new documents, using the accumulators named in 'groupSpec'. The pipeline of a materialized view
+ * only allows $sum, $min and $max, whose results can themselves be accumulated.
+ */
+BSONObj mergeGroups(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                    const BSONObj& groupSpec,
+                    const BSONObj& stored,
+                    const BSONObj& delta) {
+    BSONObjBuilder merged;
+    merged.append(stored["_id"]);
+    for (auto&& field : groupSpec) {
+        const auto fieldName = field.fieldNameStringData();
+        if (fieldName == "_id") {
+            continue;
+        }
+
+        auto factory =
+            AccumulationStatement::getFactory(field.Obj().firstElementFieldNameStringData());
+        auto accumulator = factory(expCtx);
+        accumulator->process(Value(stored[fieldName]), false);
+        accumulator->process(Value(delta[fieldName]), false);
+        accumulator->getValue(false).addToBsonObj(&merged, fieldName);
+    }
+    return merged.obj();
+}
+
+/**
+ * Returns true if the stored results of 'view' can be brought up to 'upTo' from the oplog. That
+ * requires the oplog to still hold every entry after the view was last refreshed, none of which
+ * may update, delete, drop or rename the documents of the collection the view is defined on.
+ */
+bool canRefreshIncrementally(OperationContext* opCtx,
+                             Database* db,
+                             const ViewDefinition& view,
+                             Timestamp upTo) {
+    if (view.refreshedAt().isNull() || !db->getCollection(opCtx, view.materializedNss())) {
+        return false;
+    }
+
+    BSONObj oldest;
+    if (!Helpers::getSingleton(opCtx, NamespaceString::kRsOplogNamespace.ns().c_str(), oldest) ||
+        oldest["ts"].timestamp() > view.refreshedAt()) {
+        return false;
+    }
+
+    const auto& source = view.viewOn();
+    const BSONObj filter = BSON(
+        "ts" << BSON("$gt" << view.refreshedAt() << "$lte" << upTo) << "$or"
+             << BSON_ARRAY(
+                    BSON("ns" << source.ns() << "op" << BSON("$in" << BSON_ARRAY("u"
+                                                                               << "d")))
+                    << BSON("op"
+                            << "c"
+                            << "o.applyOps"
+                            << BSON("$exists" << true))
+                    << BSON("ns" << source.getCommandNS().ns() << "$or"
+                                 << BSON_ARRAY(BSON("o.drop" << source.coll())
+                                               << BSON("o.emptycapped" << source.coll())
+                                               << BSON("o.renameCollection" << source.ns())
+                                               << BSON("o.to" << source.ns())))));
+
+    DBDirectClient client(opCtx);
+    return client
+        .findOne(NamespaceString::kRsOplogNamespace.ns(),
+                 Query(filter),
+                 nullptr,
+                 QueryOption_OplogReplay)
+        .isEmpty();
+}
+
+/**
+ * Runs the pipeline of 'view' over the documents inserted into its collection after it was last
+ * refreshed and up to 'upTo', as recorded in the oplog, and merges the resulting groups into the
+ * stored results. Returns the number of groups written.
+ */
+long long refreshIncrementally(OperationContext* opCtx,
+                               Database* db,
+                               const ViewDefinition& view,
+                               Timestamp upTo) {
+    BSONObjBuilder match;
+    match.append("ts", BSON("$gt" << view.refreshedAt() << "$lte" << upTo));
+    match.append("ns", view.viewOn().ns());
+    if (auto source = db->getCollection(opCtx, view.viewOn())) {
+        // Matching on the UUID keeps a non-simple collation from matching other namespaces.
+        if (auto uuid = source->uuid()) {
+            uuid->appendToBuilder(&match, "ui");
+        }
+    }
+    match.append("op", "i");
+
+    std::vector<BSONObj> rawPipeline{BSON("$match" << match.obj()),
+                                     BSON("$replaceRoot" << BSON("newRoot"
+                                                                 << "$o"))};
+    rawPipeline.insert(rawPipeline.end(), view.pipeline().begin(), view.pipeline().end());
+
+    auto expCtx =
+        makeExpressionContext(opCtx, NamespaceString::kRsOplogNamespace, rawPipeline, view);
+    auto pipeline =
+        uassertStatusOK(expCtx->mongoProcessInterface->makePipeline(rawPipeline, expCtx));
+
+    const auto backingNss = view.materializedNss();
+    const BSONObj groupSpec = view.pipeline().back().firstElement().Obj();
+    long long nGroups = 0;
+    while (auto delta = pipeline->getNext()) {
+        BSONObj group = delta->toBson();
+        BSONObj stored;
+        if (Helpers::findById(opCtx, db, backingNss.ns(), BSON("_id" << group["_id"]), stored)) {
+            group = mergeGroups(expCtx, groupSpec, stored, group);
+        }
+        Helpers::upsert(opCtx, backingNss.ns(), group);
+        ++nGroups;
+    }
+    return nGroups;
+}
+
+/**
+ * Replaces the stored results of 'view' with the output of its pipeline over the whole collection
+ * it is defined on. Returns the number of groups written.
+ */
+long long recompute(OperationContext* opCtx, Database* db, const ViewDefinition& view) {
+    const auto backingNss = view.materializedNss();
+
+    writeConflictRetry(opCtx, "refreshMaterializedView", backingNss.ns(), [&] {
+        WriteUnitOfWork wunit(opCtx);
+        // Until the recomputed results are complete, reads of the view run its pipeline instead.
+        uassertStatusOK(db->getViewCatalog()->setRefreshedAt(opCtx, view.name(), Timestamp()));
+        if (db->getCollection(opCtx, backingNss)) {
+            uassertStatusOK(db->dropCollectionEvenIfSystem(opCtx, backingNss));
+        }
+        wunit.commit();
+    });
+
+    writeConflictRetry(opCtx, "refreshMaterializedView", backingNss.ns(), [&] {
+        WriteUnitOfWork wunit(opCtx);
+        // The groups are keyed by _id under the view's collation.
+        CollectionOptions options;
+        if (view.defaultCollator()) {
+            options.collation = view.defaultCollator()->getSpec().toBSON();
+        }
+        invariant(db->createCollection(opCtx, backingNss.ns(), options));
+        wunit.commit();
+    });
+
+    auto expCtx = makeExpressionContext(opCtx, view.viewOn(), view.pipeline(), view);
+    auto pipeline =
+        uassertStatusOK(expCtx->mongoProcessInterface->makePipeline(view.pipeline(), expCtx));
+
+    long long nGroups = 0;
+    std::vector<InsertStatement> batch;
+    auto insertBatch = [&] {
+        writeConflictRetry(opCtx, "refreshMaterializedView", backingNss.ns(), [&] {
+            WriteUnitOfWork wunit(opCtx);
+            Collection* collection = db->getCollection(opCtx, backingNss);
+            const bool enforceQuota = true;
+            uassertStatusOK(collection->insertDocuments(
+                opCtx, batch.begin(), batch.end(), nullptr, enforceQuota));
+            wunit.commit();
+        });
+        nGroups += batch.size();
+        batch.clear();
+    };
+
+    while (auto group = pipeline->getNext()) {
+        batch.emplace_back(group->toBson());
+        if (batch.size() >= kRecomputeInsertBatchSize) {
+            insertBatch();
+        }
+    }
+    if (!batch.empty()) {
+        insertBatch();
+    }
+    return nGroups;
+}
+
+class CmdRefreshMaterializedView : public BasicCommand {
+public:
+    CmdRefreshMaterializedView() : BasicCommand("refreshMaterializedView") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kNever;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return true;
+    }
+
+    std::string help() const override {
+        return "Brings the stored results of a materialized view up to date with the collection it "
+               "is defined on. { refreshMaterializedView: <view> }";
+    }
+
+    std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const override {
+        return CommandHelpers::parseNsCollectionRequired(dbname, cmdObj).ns();
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        const NamespaceString nss(parseNs(dbname, cmdObj));
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnNamespace(
+                nss, ActionType::collMod)) {
+            return Status(ErrorCodes::Unauthorized, "unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString viewNss(parseNs(dbname, cmdObj));
+
+        // The database stays exclusively locked for the whole refresh, so that no write to the
+        // collection the view is defined on can land between reading it, or its oplog entries,
+        // and recording how far the stored results reach.
+        AutoGetDb autoDb(opCtx, dbname, MODE_X);
+        Database* db = autoDb.getDb();
+        auto view = db ? db->getViewCatalog()->lookup(opCtx, viewNss.ns()) : nullptr;
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "view " << viewNss.ns() << " does not exist",
+                view);
+        uassert(ErrorCodes::InvalidOptions,
+                str::stream() << "view " << viewNss.ns() << " is not materialized",
+                view->isMaterialized());
+        uassert(ErrorCodes::OptionNotSupportedOnView,
+                str::stream() << "materialized view " << viewNss.ns()
+                              << " must be defined on a collection, but "
+                              << view->viewOn().ns()
+                              << " is a view",
+                !db->getViewCatalog()->lookup(opCtx, view->viewOn().ns()));
+        uassert(ErrorCodes::NotMaster,
+                str::stream() << "Not primary while refreshing materialized view "
+                              << viewNss.ns(),
+                repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, viewNss));
+
+        Timestamp refreshedAt;
+        bool incremental = false;
+        if (repl::ReplicationCoordinator::get(opCtx)->getReplicationMode() ==
+            repl::ReplicationCoordinator::modeReplSet) {
+            // Every write to the collection has committed, but may not be visible in the oplog.
+            repl::StorageInterface::get(opCtx)->waitForAllEarlierOplogWritesToBeVisible(opCtx);
+            const auto oplogNs = NamespaceString::kRsOplogNamespace.ns();
+            BSONObj newest;
+            uassert(ErrorCodes::NamespaceNotFound,
+                    "cannot refresh a materialized view without an oplog",
+                    Helpers::getLast(opCtx, oplogNs.c_str(), newest));
+            refreshedAt = newest["ts"].timestamp();
+            incremental = canRefreshIncrementally(opCtx, db, *view, refreshedAt);
+        } else {
+            // Without an oplog the results are always recomputed, and only need to be marked as
+            // computed.
+            refreshedAt = Timestamp(
+                Seconds(durationCount<Seconds>(Date_t::now().toDurationSinceEpoch())), 1);
+        }
+
+        long long nGroups = 0;
+        if (incremental) {
+            // The merged groups and the new refresh timestamp commit together, so that a failed
+            // refresh leaves the stored results as they were.
+            writeConflictRetry(opCtx, "refreshMaterializedView", viewNss.ns(), [&] {
+                WriteUnitOfWork wunit(opCtx);
+                nGroups = refreshIncrementally(opCtx, db, *view, refreshedAt);
+                uassertStatusOK(db->getViewCatalog()->setRefreshedAt(opCtx, viewNss, refreshedAt));
+                wunit.commit();
+            });
+        } else {
+            nGroups = recompute(opCtx, db, *view);
+            writeConflictRetry(opCtx, "refreshMaterializedView", viewNss.ns(), [&] {
+                WriteUnitOfWork wunit(opCtx);
+                uassertStatusOK(db->getViewCatalog()->setRefreshedAt(opCtx, viewNss, refreshedAt));
+                wunit.commit();
+            });
+        }
+
+        LOG(1) << "refreshed materialized view " << viewNss << (incremental ? " incrementally" : "")
+               << " up to " << refreshedAt << ", writing " << nGroups << " groups";
+
+        result.append("incremental", incremental);
+        result.append("nGroupsWritten", nGroups);
+        result.append("refreshedAt", refreshedAt);
+        return true;
+    }
+} cmdRefreshMaterializedView;
+
+}  // namespace
+}  // namespace mongo
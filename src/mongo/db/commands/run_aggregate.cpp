@@ -37,6 +37,7 @@
 
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/commands.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/pipeline_proxy.h"
@@ -45,6 +46,7 @@
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
@@ -288,6 +290,95 @@ Status collatorCompatibleWithPipeline(OperationContext* opCtx,
     return Status::OK();
 }
 
+/**
+ * Hands 'pipeline' to an Exchange described by 'spec' and returns one executor per consumer of the
+ * exchange, each running a pipeline which reads that consumer's share of the results.
+ */
+std::vector<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createExchangeExecutors(
+    OperationContext* opCtx,
+    const NamespaceString& nss,
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+    ExchangeSpec spec) {
+    const auto numConsumers = spec.consumers;
+    boost::intrusive_ptr<Exchange> exchange = new Exchange(std::move(spec), std::move(pipeline));
+
+    std::vector<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> execs;
+
+    // The exchange disposes its pipeline along with its last consumer, so make sure every consumer
+    // is disposed if we fail part way.
+    ScopeGuard consumersDisposer = MakeGuard([&] {
+        for (size_t consumerId = 0; consumerId < numConsumers; ++consumerId) {
+            exchange->dispose(opCtx, consumerId);
+        }
+    });
+
+    for (size_t consumerId = 0; consumerId < numConsumers; ++consumerId) {
+        // Each consumer is attached to the OperationContext of its own getMores, so it cannot
+        // share an ExpressionContext or a MongoProcessInterface with the others.
+        auto consumerExpCtx = expCtx->copyWith(expCtx->ns, expCtx->uuid);
+        consumerExpCtx->mongoProcessInterface =
+            std::make_shared<PipelineD::MongoDInterface>(opCtx);
+
+        auto consumerPipeline = uassertStatusOK(Pipeline::create(
+            {DocumentSourceExchange::create(consumerExpCtx, exchange, consumerId)},
+            consumerExpCtx));
+        auto ws = make_unique<WorkingSet>();
+        auto proxy =
+            make_unique<PipelineProxyStage>(opCtx, std::move(consumerPipeline), ws.get());
+        execs.push_back(uassertStatusOK(PlanExecutor::make(
+            opCtx, std::move(ws), std::move(proxy), nss, PlanExecutor::NO_YIELD)));
+    }
+
+    consumersDisposer.Dismiss();
+    return execs;
+}
+
+/**
+ * Registers a cursor for each of 'execs' and reports them in 'result' as an array of cursor
+ * responses, in consumer order. No results are returned in the initial batches, since producing
+ * a result for one consumer may require the others to make room for theirs.
+ */
+void registerExchangeCursors(OperationContext* opCtx,
+                             const NamespaceString& nsForCursor,
+                             const BSONObj& cmdObj,
+                             std::vector<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> execs,
+                             BSONObjBuilder& result) {
+    std::vector<ClientCursorPin> pins;
+    ScopeGuard cursorsFreer = MakeGuard([&] {
+        for (auto&& pin : pins) {
+            pin.deleteUnderlying();
+        }
+    });
+
+    for (auto&& exec : execs) {
+        ClientCursorParams cursorParams(
+            std::move(exec),
+            nsForCursor,
+            AuthorizationSession::get(opCtx->getClient())->getAuthenticatedUserNames(),
+            repl::ReadConcernArgs::get(opCtx).getLevel(),
+            cmdObj);
+        auto cursorManager = CursorManager::getGlobalCursorManager();
+        pins.push_back(cursorManager->registerCursor(opCtx, std::move(cursorParams)));
+    }
+
+    BSONArrayBuilder cursorsBuilder(result.subarrayStart("cursors"));
+    for (auto&& pin : pins) {
+        auto cursor = pin.getCursor();
+        cursor->setLeftoverMaxTimeMicros(opCtx->getRemainingMaxTimeMicros());
+        cursor->getExecutor()->saveState();
+        cursor->getExecutor()->detachFromOperationContext();
+
+        BSONObjBuilder cursorResult(cursorsBuilder.subobjStart());
+        CursorResponseBuilder responseBuilder(true, &cursorResult);
+        responseBuilder.done(cursor->cursorid(), nsForCursor.ns());
+        CommandHelpers::appendSimpleCommandStatus(cursorResult, true);
+    }
+    cursorsBuilder.doneFast();
+
+    cursorsFreer.Dismiss();
+}
+
 /**
  * Resolves the collator to either the user-specified collation or, if none was specified, to the
  * collection-default collation.
@@ -323,6 +414,7 @@ Status runAggregate(OperationContext* opCtx,
     boost::optional<UUID> uuid;
 
     unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
+    std::vector<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> exchangeExecs;
     boost::intrusive_ptr<ExpressionContext> expCtx;
     Pipeline* unownedPipeline;
     auto curOp = CurOp::get(opCtx);
@@ -486,27 +578,46 @@ Status runAggregate(OperationContext* opCtx,
         // this process uses the correct collation if it does any string comparisons.
         pipeline->optimizePipeline();
 
-        // Transfer ownership of the Pipeline to the PipelineProxyStage.
-        unownedPipeline = pipeline.get();
-        auto ws = make_unique<WorkingSet>();
-        auto proxy = make_unique<PipelineProxyStage>(opCtx, std::move(pipeline), ws.get());
-
-        // This PlanExecutor will simply forward requests to the Pipeline, so does not need to
-        // yield or to be registered with any collection's CursorManager to receive invalidations.
-        // The Pipeline may contain PlanExecutors which *are* yielding PlanExecutors and which *are*
-        // registered with their respective collection's CursorManager
-        auto statusWithPlanExecutor =
-            PlanExecutor::make(opCtx, std::move(ws), std::move(proxy), nss, PlanExecutor::NO_YIELD);
-        invariant(statusWithPlanExecutor.isOK());
-        exec = std::move(statusWithPlanExecutor.getValue());
-
-        {
-            auto planSummary = Explain::getPlanSummary(exec.get());
-            stdx::lock_guard<Client> lk(*opCtx->getClient());
-            curOp->setPlanSummary_inlock(std::move(planSummary));
+        // If mongos asked for the output of the shards part to be partitioned across several
+        // merging shards, hand the pipeline to an exchange which feeds one cursor per merger.
+        if (!request.getExchangeSpec().isEmpty()) {
+            uassert(50854,
+                    "An exchange cannot be used with explain or with a tailable cursor",
+                    !expCtx->explain && expCtx->tailableMode == TailableModeEnum::kNormal);
+            exchangeExecs = createExchangeExecutors(opCtx,
+                                                    nss,
+                                                    expCtx,
+                                                    std::move(pipeline),
+                                                    ExchangeSpec::parse(request.getExchangeSpec()));
+        } else {
+            // Transfer ownership of the Pipeline to the PipelineProxyStage.
+            unownedPipeline = pipeline.get();
+            auto ws = make_unique<WorkingSet>();
+            auto proxy = make_unique<PipelineProxyStage>(opCtx, std::move(pipeline), ws.get());
+
+            // This PlanExecutor will simply forward requests to the Pipeline, so does not need to
+            // yield or to be registered with any collection's CursorManager to receive
+            // invalidations. The Pipeline may contain PlanExecutors which *are* yielding
+            // PlanExecutors and which *are* registered with their respective collection's
+            // CursorManager
+            auto statusWithPlanExecutor = PlanExecutor::make(
+                opCtx, std::move(ws), std::move(proxy), nss, PlanExecutor::NO_YIELD);
+            invariant(statusWithPlanExecutor.isOK());
+            exec = std::move(statusWithPlanExecutor.getValue());
+
+            {
+                auto planSummary = Explain::getPlanSummary(exec.get());
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                curOp->setPlanSummary_inlock(std::move(planSummary));
+            }
         }
     }
 
+    if (!exchangeExecs.empty()) {
+        registerExchangeCursors(opCtx, origNss, cmdObj, std::move(exchangeExecs), result);
+        return Status::OK();
+    }
+
     // Having released the collection lock, we can now create a cursor that returns results from the
     // pipeline. This cursor owns no collection state, and thus we register it with the global
     // cursor manager. The global cursor manager does not deliver invalidations or kill
@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/sampling_profiler.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// Leaves room in the 16MB reply for the command's other fields.
+const int kMaxProfileBytes = 8 * 1024 * 1024;
+
+/**
+ * Samples the CPU stacks of every thread for a while and returns them aggregated in collapsed
+ * flamegraph format, tagged with the command each thread was running:
+ *
+ *     { sampleCpuProfile: 1, hz: <samples per CPU second>, durationSecs: <seconds> }
+ */
+class SampleCpuProfileCmd : public BasicCommand {
+public:
+    SampleCpuProfileCmd() : BasicCommand("sampleCpuProfile") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "samples CPU stacks for durationSecs seconds (default 10) at hz samples per CPU "
+               "second (default 100) and returns them in collapsed flamegraph format";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        long long hz;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(cmdObj, "hz", 100, &hz));
+        uassert(ErrorCodes::BadValue, "hz must be between 1 and 1000", hz >= 1 && hz <= 1000);
+
+        long long durationSecs;
+        uassertStatusOK(
+            bsonExtractIntegerFieldWithDefault(cmdObj, "durationSecs", 10, &durationSecs));
+        uassert(ErrorCodes::BadValue,
+                "durationSecs must be between 1 and 300",
+                durationSecs >= 1 && durationSecs <= 300);
+
+        uassertStatusOK(SamplingProfiler::start(hz));
+        auto stopGuard = MakeGuard([] { SamplingProfiler::stop(); });
+
+        // Holds no locks while sampling. An interrupted profile is discarded.
+        opCtx->sleepFor(Seconds(durationSecs));
+
+        stopGuard.Dismiss();
+        SamplingProfiler::stop().append(&result, kMaxProfileBytes);
+        return true;
+    }
+
+} sampleCpuProfileCmd;
+
+}  // namespace
+}  // namespace mongo
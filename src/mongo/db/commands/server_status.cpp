@@ -50,11 +50,14 @@
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/util/log.h"
+#include "mongo/util/memory_usage_tracker.h"
 #include "mongo/util/net/hostname_canonicalization.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/numa_placement.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
+#include "mongo/util/shared_buffer_pool.h"
 #include "mongo/util/time_support.h"
 #include "mongo/util/version.h"
 
@@ -180,6 +183,11 @@ public:
         _sections[section->getSectionName()] = section;
     }
 
+    const ServerStatusSection* findSection(const string& sectionName) const {
+        auto it = _sections.find(sectionName);
+        return it == _sections.end() ? nullptr : it->second;
+    }
+
 private:
     const Date_t _started;
     bool _runCalled;
@@ -210,6 +218,10 @@ ServerStatusSection::ServerStatusSection(const string& sectionName) : _sectionNa
     CmdServerStatusInstantiator::getInstance().addSection(this);
 }
 
+const ServerStatusSection* findServerStatusSection(const string& sectionName) {
+    return CmdServerStatusInstantiator::getInstance().findSection(sectionName);
+}
+
 OpCounterServerStatusSection::OpCounterServerStatusSection(const string& sectionName,
                                                            OpCounters* counters)
     : ServerStatusSection(sectionName), _counters(counters) {}
@@ -299,6 +311,25 @@ public:
         BSONObjBuilder b;
         networkCounter.append(b);
         appendMessageCompressionStats(&b);
+
+        const auto bufferPoolStats = SharedBufferPool::get().getStats();
+        BSONObjBuilder bufferPool(b.subobjStart("messageBufferPool"));
+        bufferPool.append("hits", bufferPoolStats.hits);
+        bufferPool.append("misses", bufferPoolStats.misses);
+        bufferPool.append("unpooled", bufferPoolStats.unpooled);
+        bufferPool.append("pooledBytes", bufferPoolStats.pooledBytes);
+        bufferPool.append("maxPooledBytes", bufferPoolStats.maxPooledBytes);
+        bufferPool.done();
+
+        // BufBuilders share the message buffer pool's memory and cap. Sizes outside the pool's
+        // range bypass it without being counted.
+        const auto builderPoolStats =
+            SharedBufferPool::get().getStats(SharedBufferPool::Consumer::kBufBuilder);
+        BSONObjBuilder builderPool(b.subobjStart("bufBuilderPool"));
+        builderPool.append("hits", builderPoolStats.hits);
+        builderPool.append("misses", builderPoolStats.misses);
+        builderPool.done();
+
         auto executor = opCtx->getServiceContext()->getServiceExecutor();
         if (executor)
             executor->appendStats(&b);
@@ -347,6 +378,34 @@ public:
     }
 } memBase;
 
+class TrackedMemory : public ServerStatusSection {
+public:
+    TrackedMemory() : ServerStatusSection("trackedMemory") {}
+    virtual bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
+        BSONObjBuilder b;
+        MemoryUsageTracker::get().report(&b);
+        return b.obj();
+    }
+} trackedMemory;
+
+class NumaSection : public ServerStatusSection {
+public:
+    NumaSection() : ServerStatusSection("numa") {}
+    virtual bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
+        BSONObjBuilder b;
+        NumaPlacement::get().report(&b);
+        return b.obj();
+    }
+} numaSection;
+
 class AdvisoryHostFQDNs final : public ServerStatusSection {
 public:
     AdvisoryHostFQDNs() : ServerStatusSection("advisoryHostFQDNs") {}
@@ -108,6 +108,13 @@ private:
     const std::string _sectionName;
 };
 
+/**
+ * Returns the server status section named 'sectionName', or nullptr if no such section has been
+ * registered. Lets callers which only need a few sections generate them without running the whole
+ * serverStatus command.
+ */
+const ServerStatusSection* findServerStatusSection(const std::string& sectionName);
+
 class OpCounterServerStatusSection : public ServerStatusSection {
 public:
     OpCounterServerStatusSection(const std::string& sectionName, OpCounters* counters);
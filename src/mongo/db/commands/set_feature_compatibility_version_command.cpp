@@ -32,6 +32,8 @@
 #include "mongo/db/catalog/coll_mod.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/commands/feature_compatibility_version_command_parser.h"
@@ -39,10 +41,12 @@
 #include "mongo/db/commands/feature_compatibility_version_parser.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/s/config/sharding_catalog_manager.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog_cache.h"
@@ -58,6 +62,42 @@ namespace {
 
 MONGO_FAIL_POINT_DEFINE(featureCompatibilityDowngrade);
 MONGO_FAIL_POINT_DEFINE(featureCompatibilityUpgrade);
+
+/**
+ * Fails if any collection has an index which binaries before 4.0 can't load.
+ */
+void checkIndexesLoadableBy36(OperationContext* opCtx) {
+    std::vector<std::string> dbNames;
+    opCtx->getServiceContext()->getStorageEngine()->listDatabases(&dbNames);
+
+    for (const auto& dbName : dbNames) {
+        AutoGetDb autoDb(opCtx, dbName, MODE_IS);
+        auto db = autoDb.getDb();
+        if (!db) {
+            continue;
+        }
+
+        for (auto&& collection : *db) {
+            Lock::CollectionLock collLock(opCtx->lockState(), collection->ns().ns(), MODE_IS);
+            auto it = collection->getIndexCatalog()->getIndexIterator(opCtx, true);
+            while (it.more()) {
+                const auto descriptor = it.next();
+                uassert(ErrorCodes::IllegalOperation,
+                        str::stream() << "cannot downgrade featureCompatibilityVersion to 3.6 "
+                                         "while index "
+                                      << descriptor->indexName()
+                                      << " on collection "
+                                      << collection->ns().ns()
+                                      << " has key pattern "
+                                      << descriptor->keyPattern()
+                                      << ", which requires 4.0. Drop the index, then run "
+                                         "setFeatureCompatibilityVersion again.",
+                        !index_key_validate::requiresFullyUpgradedFCV(descriptor->keyPattern()));
+            }
+        }
+    }
+}
+
 /**
  * Sets the minimum allowed version for the cluster. If it is 3.4, then the node should not use 3.6
  * features.
@@ -254,6 +294,9 @@ public:
                 Lock::GlobalLock lk(opCtx, MODE_S);
             }
 
+            // No new indexes needing 4.0 can be created now that the downgrade has started.
+            checkIndexesLoadableBy36(opCtx);
+
             // Downgrade shards before config finishes its downgrade.
             if (serverGlobalParams.clusterRole == ClusterRole::ConfigServer) {
                 uassertStatusOK(
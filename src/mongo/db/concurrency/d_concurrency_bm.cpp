@@ -34,12 +34,13 @@
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/storage/recovery_unit_noop.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/mutex.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
 namespace {
 
-const int kMaxPerfThreads = 16;  // max number of threads to use for lock perf
+const int kMaxPerfThreads = 128;  // max number of threads to use for lock perf
 
 
 class DConcurrencyTest : public benchmark::Fixture {
@@ -74,6 +75,14 @@ BENCHMARK_DEFINE_F(DConcurrencyTest, BM_StdMutex)(benchmark::State& state) {
     }
 }
 
+BENCHMARK_DEFINE_F(DConcurrencyTest, BM_SimpleMutex)(benchmark::State& state) {
+    static SimpleMutex mtx;
+
+    for (auto keepRunning : state) {
+        stdx::lock_guard<SimpleMutex> lk(mtx);
+    }
+}
+
 BENCHMARK_DEFINE_F(DConcurrencyTest, BM_ResourceMutexShared)(benchmark::State& state) {
     static Lock::ResourceMutex mtx("testMutex");
 
@@ -90,6 +99,34 @@ BENCHMARK_DEFINE_F(DConcurrencyTest, BM_ResourceMutexExclusive)(benchmark::State
     }
 }
 
+BENCHMARK_DEFINE_F(DConcurrencyTest, BM_GlobalIntentSharedLock)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        makeKClientsWithLockers<DefaultLockerImpl>(state.threads);
+    }
+
+    for (auto keepRunning : state) {
+        Lock::GlobalLock globalLk(clients[state.thread_index].second.get(), MODE_IS);
+    }
+
+    if (state.thread_index == 0) {
+        clients.clear();
+    }
+}
+
+BENCHMARK_DEFINE_F(DConcurrencyTest, BM_GlobalIntentExclusiveLock)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        makeKClientsWithLockers<DefaultLockerImpl>(state.threads);
+    }
+
+    for (auto keepRunning : state) {
+        Lock::GlobalLock globalLk(clients[state.thread_index].second.get(), MODE_IX);
+    }
+
+    if (state.thread_index == 0) {
+        clients.clear();
+    }
+}
+
 BENCHMARK_DEFINE_F(DConcurrencyTest, BM_CollectionIntentSharedLock)(benchmark::State& state) {
     std::unique_ptr<ForceSupportsDocLocking> supportDocLocking;
 
@@ -128,6 +165,49 @@ BENCHMARK_DEFINE_F(DConcurrencyTest, BM_CollectionIntentExclusiveLock)(benchmark
     }
 }
 
+BENCHMARK_DEFINE_F(DConcurrencyTest, BM_CollectionConflictingModes)(benchmark::State& state) {
+    std::unique_ptr<ForceSupportsDocLocking> supportDocLocking;
+
+    if (state.thread_index == 0) {
+        makeKClientsWithLockers<DefaultLockerImpl>(state.threads);
+        supportDocLocking = std::make_unique<ForceSupportsDocLocking>(true);
+    }
+
+    // One in every four threads takes the collection exclusively, so that the others keep having
+    // to queue behind it and be granted in bulk once it is released.
+    const LockMode collMode = state.thread_index % 4 == 0 ? MODE_X : MODE_IS;
+    const LockMode dbMode = collMode == MODE_X ? MODE_IX : MODE_IS;
+    for (auto keepRunning : state) {
+        Lock::DBLock dlk(clients[state.thread_index].second.get(), "test", dbMode);
+        Lock::CollectionLock clk(
+            clients[state.thread_index].second->lockState(), "test.coll", collMode);
+    }
+
+    if (state.thread_index == 0) {
+        clients.clear();
+    }
+}
+
+BENCHMARK_DEFINE_F(DConcurrencyTest, BM_SaveAndRestoreLockStateForYield)(benchmark::State& state) {
+    std::unique_ptr<ForceSupportsDocLocking> supportDocLocking;
+
+    if (state.thread_index == 0) {
+        makeKClientsWithLockers<DefaultLockerImpl>(state.threads);
+        supportDocLocking = std::make_unique<ForceSupportsDocLocking>(true);
+    }
+
+    auto opCtx = clients[state.thread_index].second.get();
+    Lock::DBLock dlk(opCtx, "test", MODE_IS);
+    Lock::CollectionLock clk(opCtx->lockState(), "test.coll", MODE_IS);
+
+    // This is what a query does on every yield, as well as when its cursor is saved for getMore.
+    Locker::LockSnapshot snapshot;
+    for (auto keepRunning : state) {
+        invariant(opCtx->lockState()->saveLockStateAndUnlock(&snapshot));
+        opCtx->lockState()->restoreLockState(opCtx, snapshot);
+    }
+}
+
 BENCHMARK_DEFINE_F(DConcurrencyTest, BM_MMAPv1CollectionSharedLock)(benchmark::State& state) {
     std::unique_ptr<ForceSupportsDocLocking> supportDocLocking;
 
@@ -167,15 +247,25 @@ BENCHMARK_DEFINE_F(DConcurrencyTest, BM_MMAPv1CollectionExclusiveLock)(benchmark
 }
 
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_StdMutex)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_SimpleMutex)->ThreadRange(1, kMaxPerfThreads);
 
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_ResourceMutexShared)->ThreadRange(1, kMaxPerfThreads);
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_ResourceMutexExclusive)->ThreadRange(1, kMaxPerfThreads);
 
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_GlobalIntentSharedLock)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_GlobalIntentExclusiveLock)
+    ->ThreadRange(1, kMaxPerfThreads);
+
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentSharedLock)
     ->ThreadRange(1, kMaxPerfThreads);
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentExclusiveLock)
     ->ThreadRange(1, kMaxPerfThreads);
 
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionConflictingModes)
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_SaveAndRestoreLockStateForYield)
+    ->ThreadRange(1, kMaxPerfThreads);
+
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_MMAPv1CollectionSharedLock)
     ->ThreadRange(1, kMaxPerfThreads);
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_MMAPv1CollectionExclusiveLock)
@@ -33,7 +33,7 @@
 namespace mongo {
 
 const OperationContext::Decoration<GlobalLockAcquisitionTracker> GlobalLockAcquisitionTracker::get =
-    OperationContext::declareDecoration<GlobalLockAcquisitionTracker>();
+    OperationContext::declareHotDecoration<GlobalLockAcquisitionTracker>();
 
 bool GlobalLockAcquisitionTracker::getGlobalExclusiveLockTaken() const {
     return _globalExclusiveLockTaken;
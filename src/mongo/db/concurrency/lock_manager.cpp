@@ -34,6 +34,10 @@
 
 #include <third_party/murmurhash3/MurmurHash3.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/static_assert.h"
@@ -41,6 +45,7 @@
 #include "mongo/config.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -410,13 +415,28 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+// Balance scalability of intent locks against potential added cost of conflicting locks, which
+// have to visit every partition holding the resource. Must be powers of two.
+const unsigned LockManager::_minPartitions = 32;
+const unsigned LockManager::_maxPartitions = 128;
+
+namespace {
+
+unsigned computeNumPartitions(unsigned minPartitions, unsigned maxPartitions) {
+    unsigned numPartitions = minPartitions;
+    const unsigned numCPUs = stdx::thread::hardware_concurrency();
+    while (numPartitions < numCPUs && numPartitions < maxPartitions) {
+        numPartitions *= 2;
+    }
+    return numPartitions;
+}
 
-LockManager::LockManager() {
+}  // namespace
+
+LockManager::LockManager()
+    : _numPartitions(computeNumPartitions(_minPartitions, _maxPartitions)),
+      _partitions(_numPartitions) {
     _lockBuckets = new LockBucket[_numLockBuckets];
-    _partitions = new Partition[_numPartitions];
 }
 
 LockManager::~LockManager() {
@@ -428,7 +448,6 @@ LockManager::~LockManager() {
     }
 
     delete[] _lockBuckets;
-    delete[] _partitions;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -441,7 +460,7 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
-        Partition* partition = _getPartition(request);
+        Partition* partition = _choosePartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
 
         // Fast path for intent locks
@@ -809,8 +828,22 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
 
+LockManager::Partition* LockManager::_choosePartition(LockRequest* request) {
+    unsigned index = 0;
+#if defined(__linux__)
+    // The CPU may change right after this call, which only costs some locality; the chosen
+    // partition is remembered in the request so lock and unlock always agree.
+    const int cpu = sched_getcpu();
+    index = cpu >= 0 ? static_cast<unsigned>(cpu) : request->locker->getId();
+#else
+    index = request->locker->getId();
+#endif
+    request->partitionIndex = index & (_numPartitions - 1);
+    return _getPartition(request);
+}
+
 LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+    return const_cast<AlignedPartition*>(&_partitions[request->partitionIndex]);
 }
 
 void LockManager::dump() const {
@@ -1174,6 +1207,7 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
     next = nullptr;
     status = STATUS_NEW;
     partitioned = false;
+    partitionIndex = 0;
     mode = MODE_NONE;
     convertMode = MODE_NONE;
 }
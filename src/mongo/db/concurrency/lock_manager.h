@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/align/aligned_allocator.hpp>
 #include <cstdint>
 #include <deque>
 #include <map>
@@ -43,6 +44,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -147,9 +149,10 @@ private:
         LockHead* findOrInsert(ResourceId resId);
     };
 
-    // Each locker maps to a partition that is used for resources acquired in intent modes
-    // modes and potentially other modes that don't conflict with themselves. This avoids
-    // contention on the regular LockHead in the lock manager.
+    // Each intent-mode request is placed in a partition, chosen by the CPU the requesting thread
+    // is running on, that is used for resources acquired in intent modes and potentially other
+    // modes that don't conflict with themselves. This avoids contention on the regular LockHead in
+    // the lock manager.
     struct Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
@@ -166,7 +169,14 @@ private:
 
 
     /**
-     * Retrieves the Partition that a particular LockRequest should use for intent locking.
+     * Picks the Partition that a new intent-mode LockRequest will use, and records it in the
+     * request. Threads running on different CPUs get different partitions, so that uncontended
+     * intent locks taken concurrently do not share a mutex or a cache line.
+     */
+    Partition* _choosePartition(LockRequest* request);
+
+    /**
+     * Retrieves the Partition that _choosePartition() picked for a particular LockRequest.
      */
     Partition* _getPartition(LockRequest* request) const;
 
@@ -214,8 +224,14 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
-    Partition* _partitions;
+    // One partition per CPU, rounded up to a power of two and kept within
+    // [_minPartitions, _maxPartitions]. Each partition gets its own cache line.
+    static const unsigned _minPartitions;
+    static const unsigned _maxPartitions;
+    const unsigned _numPartitions;
+    using AlignedPartition = CacheAligned<Partition>;
+    std::vector<AlignedPartition, boost::alignment::aligned_allocator<AlignedPartition>>
+        _partitions;
 };
 
 
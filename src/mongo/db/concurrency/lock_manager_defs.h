@@ -365,6 +365,15 @@ struct LockRequest {
     // No synchronization
     bool partitioned;
 
+    // Index of the LockManager partition used by this request while it is partitioned. Chosen
+    // when the request is first locked, so that the unlock goes to the same partition even if the
+    // Locker thread has since moved to a different CPU.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    unsigned partitionIndex;
+
     // How many times has LockManager::lock been called for this request. Locks are released when
     // their recursive count drops to zero.
     //
@@ -32,14 +32,21 @@
 
 #include "mongo/db/concurrency/lock_state.h"
 
+#include <boost/align/aligned_allocator.hpp>
 #include <vector>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/cycle_tick_source.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -49,39 +56,57 @@ namespace mongo {
 namespace {
 
 /**
- * Partitioned global lock statistics, so we don't hit the same bucket.
+ * Partitioned global lock statistics, so we don't hit the same bucket. There is one partition per
+ * CPU, and each acquisition is accounted in the partition of the CPU it is running on, so the
+ * counters are almost never shared between cores. The partitions are only summed up when the
+ * statistics are reported.
  */
 class PartitionedInstanceWideLockStats {
     MONGO_DISALLOW_COPYING(PartitionedInstanceWideLockStats);
 
 public:
-    PartitionedInstanceWideLockStats() {}
+    PartitionedInstanceWideLockStats() : _partitions(_computeNumPartitions()) {}
 
     void recordAcquisition(LockerId id, ResourceId resId, LockMode mode) {
-        _get(id).recordAcquisition(resId, mode);
+        _get(id).stats.recordAcquisition(resId, mode);
     }
 
     void recordWait(LockerId id, ResourceId resId, LockMode mode) {
-        _get(id).recordWait(resId, mode);
+        _get(id).stats.recordWait(resId, mode);
     }
 
     void recordWaitTime(LockerId id, ResourceId resId, LockMode mode, uint64_t waitMicros) {
-        _get(id).recordWaitTime(resId, mode, waitMicros);
+        _get(id).stats.recordWaitTime(resId, mode, waitMicros);
+    }
+
+    /**
+     * Records the total time spent waiting for one acquisition, which may span multiple calls to
+     * recordWaitTime.
+     */
+    void recordTotalWaitTime(LockerId id, ResourceId resId, LockMode mode, uint64_t waitMicros) {
+        _get(id).waitTimeHistograms.recordWaitTime(resId, mode, waitMicros);
     }
 
-    void recordDeadlock(ResourceId resId, LockMode mode) {
-        _get(resId).recordDeadlock(resId, mode);
+    void recordDeadlock(LockerId id, ResourceId resId, LockMode mode) {
+        _get(id).stats.recordDeadlock(resId, mode);
     }
 
     void report(SingleThreadedLockStats* outStats) const {
-        for (int i = 0; i < NumPartitions; i++) {
-            outStats->append(_partitions[i].stats);
+        for (const auto& partition : _partitions) {
+            outStats->append(partition.stats);
+        }
+    }
+
+    void report(SingleThreadedLockWaitTimeHistograms* outHistograms) const {
+        for (const auto& partition : _partitions) {
+            outHistograms->append(partition.waitTimeHistograms);
         }
     }
 
     void reset() {
-        for (int i = 0; i < NumPartitions; i++) {
-            _partitions[i].stats.reset();
+        for (auto& partition : _partitions) {
+            partition.stats.reset();
+            partition.waitTimeHistograms.reset();
         }
     }
 
@@ -90,17 +115,35 @@ private:
     // separate page/cache line in order to avoid false sharing.
     struct alignas(stdx::hardware_destructive_interference_size) AlignedLockStats {
         AtomicLockStats stats;
+        AtomicLockWaitTimeHistograms waitTimeHistograms;
     };
 
-    enum { NumPartitions = 8 };
+    // Must be powers of two.
+    enum { MinPartitions = 8, MaxPartitions = 64 };
 
+    static size_t _computeNumPartitions() {
+        size_t numPartitions = MinPartitions;
+        const size_t numCPUs = stdx::thread::hardware_concurrency();
+        while (numPartitions < numCPUs && numPartitions < MaxPartitions) {
+            numPartitions *= 2;
+        }
+        return numPartitions;
+    }
 
-    AtomicLockStats& _get(LockerId id) {
-        return _partitions[id % NumPartitions].stats;
+    AlignedLockStats& _get(LockerId id) {
+        size_t index = id;
+#if defined(__linux__)
+        const int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            index = cpu;
+        }
+#endif
+        return _partitions[index & (_partitions.size() - 1)];
     }
 
 
-    AlignedLockStats _partitions[NumPartitions];
+    std::vector<AlignedLockStats, boost::alignment::aligned_allocator<AlignedLockStats>>
+        _partitions;
 };
 
 
@@ -243,6 +286,7 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 
 namespace {
 TicketHolder* ticketHolders[LockModesCount] = {};
+TicketHolder* priorityTicketHolders[LockModesCount] = {};
 }  // namespace
 
 
@@ -257,6 +301,17 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
     ticketHolders[MODE_IX] = writing;
 }
 
+/* static */
+void Locker::setGlobalThrottling(class TicketHolder* reading,
+                                 class TicketHolder* writing,
+                                 class TicketHolder* priorityReading,
+                                 class TicketHolder* priorityWriting) {
+    setGlobalThrottling(reading, writing);
+    priorityTicketHolders[MODE_S] = priorityReading;
+    priorityTicketHolders[MODE_IS] = priorityReading;
+    priorityTicketHolders[MODE_IX] = priorityWriting;
+}
+
 template <bool IsForMMAPV1>
 LockerImpl<IsForMMAPV1>::LockerImpl()
     : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {}
@@ -334,13 +389,25 @@ LockResult LockerImpl<IsForMMAPV1>::_acquireTicket(OperationContext* opCtx,
 
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = MakeGuard([&] { _clientState.store(kInactive); });
-        if (deadline == Date_t::max()) {
-            holder->waitForTicket(opCtx);
-        } else if (!holder->waitForTicketUntil(opCtx, deadline)) {
-            return LOCK_TIMEOUT;
+
+        // Prioritized lockers only take a regular ticket if one is free, and otherwise wait on the
+        // much shorter queue of the priority pool instead of behind user operations.
+        auto priorityHolder =
+            prioritizedTicketAcquisition() ? priorityTicketHolders[mode] : nullptr;
+        if (!priorityHolder || !holder->tryAcquire()) {
+            if (priorityHolder) {
+                holder = priorityHolder;
+            }
+
+            if (deadline == Date_t::max()) {
+                holder->waitForTicket(opCtx);
+            } else if (!holder->waitForTicketUntil(opCtx, deadline)) {
+                return LOCK_TIMEOUT;
+            }
         }
         restoreStateOnErrorGuard.Dismiss();
     }
+    _ticketHolder = holder;
     _clientState.store(reader ? kActiveReader : kActiveWriter);
     return LOCK_OK;
 }
@@ -845,8 +912,18 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(
     // Don't go sleeping without bound in order to be able to report long waits or wake up for
     // deadlock detection.
     Milliseconds waitTime = std::min(timeout, DeadlockTimeout);
-    const uint64_t startOfTotalWaitTime = curTimeMicros64();
-    uint64_t startOfCurrentWaitTime = startOfTotalWaitTime;
+    // Waits are timed with CycleTickSource, which is monotonic and far cheaper to read than the
+    // system clock.
+    const TickSource::Tick startOfTotalWaitTime = CycleTickSource::now();
+    TickSource::Tick startOfCurrentWaitTime = startOfTotalWaitTime;
+
+    // Account the whole wait in the histograms once, however it ends.
+    ON_BLOCK_EXIT([&] {
+        const auto totalWaitTime =
+            CycleTickSource::ticksToMicros(CycleTickSource::now() - startOfTotalWaitTime);
+        globalStats.recordTotalWaitTime(
+            _id, resId, mode, durationCount<Microseconds>(totalWaitTime));
+    });
 
     // Clean up the state on any failed lock attempts.
     auto unlockOnErrorGuard = MakeGuard([&] {
@@ -867,9 +944,10 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(
         }
 
         // Account for the time spent waiting on the notification object
-        const uint64_t curTimeMicros = curTimeMicros64();
-        const uint64_t elapsedTimeMicros = curTimeMicros - startOfCurrentWaitTime;
-        startOfCurrentWaitTime = curTimeMicros;
+        const TickSource::Tick curTime = CycleTickSource::now();
+        const uint64_t elapsedTimeMicros = durationCount<Microseconds>(
+            CycleTickSource::ticksToMicros(curTime - startOfCurrentWaitTime));
+        startOfCurrentWaitTime = curTime;
 
         globalStats.recordWaitTime(_id, resId, mode, elapsedTimeMicros);
         _stats.recordWaitTime(resId, mode, elapsedTimeMicros);
@@ -882,7 +960,7 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(
             if (wfg.check().hasCycle()) {
                 warning() << "Deadlock found: " << wfg.toString();
 
-                globalStats.recordDeadlock(resId, mode);
+                globalStats.recordDeadlock(_id, resId, mode);
                 _stats.recordDeadlock(resId, mode);
 
                 result = LOCK_DEADLOCK;
@@ -896,7 +974,7 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(
         }
 
         const auto totalBlockTime = duration_cast<Milliseconds>(
-            Microseconds(int64_t(curTimeMicros - startOfTotalWaitTime)));
+            CycleTickSource::ticksToMicros(curTime - startOfTotalWaitTime));
         waitTime = (totalBlockTime < timeout) ? std::min(timeout - totalBlockTime, DeadlockTimeout)
                                               : Milliseconds(0);
 
@@ -932,9 +1010,9 @@ void LockerImpl<IsForMMAPV1>::releaseTicket() {
 
 template <bool IsForMMAPV1>
 void LockerImpl<IsForMMAPV1>::_releaseTicket() {
-    auto holder = shouldAcquireTicket() ? ticketHolders[_modeForTicket] : nullptr;
-    if (holder) {
-        holder->release();
+    if (_ticketHolder) {
+        _ticketHolder->release();
+        _ticketHolder = nullptr;
     }
     _clientState.store(kInactive);
 }
@@ -1093,6 +1171,10 @@ void reportGlobalLockingStats(SingleThreadedLockStats* outStats) {
     globalStats.report(outStats);
 }
 
+void reportGlobalLockWaitTimeHistograms(SingleThreadedLockWaitTimeHistograms* outHistograms) {
+    globalStats.report(outHistograms);
+}
+
 void resetGlobalLockStats() {
     globalStats.reset();
 }
@@ -38,6 +38,8 @@
 
 namespace mongo {
 
+class TicketHolder;
+
 /**
  * Notfication callback, which stores the last notification result and signals a condition
  * variable, which can be waited on.
@@ -334,6 +336,10 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // The TicketHolder the current ticket was taken from, if any. This is either the regular or,
+    // for prioritized lockers, the priority holder for '_modeForTicket'.
+    TicketHolder* _ticketHolder = nullptr;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
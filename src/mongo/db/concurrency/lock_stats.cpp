@@ -30,6 +30,7 @@
 
 #include "mongo/db/concurrency/lock_stats.h"
 
+#include "mongo/base/static_assert.h"
 #include "mongo/bson/bsonobjbuilder.h"
 
 namespace mongo {
@@ -147,8 +148,103 @@ void LockStats<CounterType>::reset() {
 }
 
 
+namespace {
+
+// Upper bounds of the wait time histogram buckets, in microseconds. The last bucket is unbounded.
+const int64_t kWaitTimeBucketBoundsMicros[] = {100, 1000, 10000, 100000, 1000000, 10000000};
+const char* const kWaitTimeBucketNames[] = {
+    "lt100us", "lt1ms", "lt10ms", "lt100ms", "lt1s", "lt10s", "ge10s"};
+
+}  // namespace
+
+template <typename CounterType>
+constexpr int LockWaitTimeHistograms<CounterType>::kNumBuckets;
+
+template <typename CounterType>
+LockWaitTimeHistograms<CounterType>::LockWaitTimeHistograms() {
+    MONGO_STATIC_ASSERT(sizeof(kWaitTimeBucketNames) / sizeof(kWaitTimeBucketNames[0]) ==
+                        kNumBuckets);
+    MONGO_STATIC_ASSERT(sizeof(kWaitTimeBucketBoundsMicros) /
+                            sizeof(kWaitTimeBucketBoundsMicros[0]) ==
+                        kNumBuckets - 1);
+    reset();
+}
+
+template <typename CounterType>
+int LockWaitTimeHistograms<CounterType>::bucketFor(int64_t waitMicros) {
+    int bucket = 0;
+    while (bucket < kNumBuckets - 1 && waitMicros >= kWaitTimeBucketBoundsMicros[bucket]) {
+        bucket++;
+    }
+    return bucket;
+}
+
+template <typename CounterType>
+void LockWaitTimeHistograms<CounterType>::report(BSONObjBuilder* builder) const {
+    // Same as LockStats, position 0 is a sentinel for invalid resource/no lock.
+    for (int i = 1; i < ResourceTypesCount; i++) {
+        _report(builder, resourceTypeName(static_cast<ResourceType>(i)), _histograms[i]);
+    }
+
+    _report(builder, "oplog", _oplogHistograms);
+}
+
+template <typename CounterType>
+void LockWaitTimeHistograms<CounterType>::_report(
+    BSONObjBuilder* builder,
+    const char* sectionName,
+    const Buckets (&perMode)[LockModesCount]) const {
+    std::unique_ptr<BSONObjBuilder> section;
+
+    for (int mode = 1; mode < LockModesCount; mode++) {
+        long long values[kNumBuckets];
+        long long total = 0;
+        for (int b = 0; b < kNumBuckets; b++) {
+            values[b] = CounterOps::get(perMode[mode][b]);
+            total += values[b];
+        }
+
+        if (total == 0) {
+            continue;
+        }
+
+        if (!section) {
+            section.reset(new BSONObjBuilder(builder->subobjStart(sectionName)));
+        }
+
+        // Report every bucket of a mode which has seen waits, so the shape of the document does
+        // not change from sample to sample.
+        BSONObjBuilder modeBuilder(
+            section->subobjStart(legacyModeName(static_cast<LockMode>(mode))));
+        for (int b = 0; b < kNumBuckets; b++) {
+            modeBuilder.append(kWaitTimeBucketNames[b], values[b]);
+        }
+    }
+}
+
+template <typename CounterType>
+void LockWaitTimeHistograms<CounterType>::reset() {
+    for (int i = 0; i < ResourceTypesCount; i++) {
+        for (int mode = 0; mode < LockModesCount; mode++) {
+            for (int b = 0; b < kNumBuckets; b++) {
+                CounterOps::set(_histograms[i][mode][b], 0);
+            }
+        }
+    }
+
+    for (int mode = 0; mode < LockModesCount; mode++) {
+        for (int b = 0; b < kNumBuckets; b++) {
+            CounterOps::set(_oplogHistograms[mode][b], 0);
+        }
+    }
+}
+
+
 // Ensures that there are instances compiled for LockStats for AtomicInt64 and int64_t
 template class LockStats<int64_t>;
 template class LockStats<AtomicInt64>;
 
+template class LockWaitTimeHistograms<int64_t>;
+template class LockWaitTimeHistograms<AtomicInt64>;
+
 }  // namespace mongo
@@ -190,13 +190,102 @@ typedef LockStats<int64_t> SingleThreadedLockStats;
 typedef LockStats<AtomicInt64> AtomicLockStats;
 
 
+/**
+ * Histograms of the total time lock acquisitions spent waiting, split per resource type and mode
+ * the same way as LockStats. Only acquisitions which actually had to wait are recorded, so these
+ * are only kept instance-wide and never touched on the uncontended path.
+ */
+template <typename CounterType>
+class LockWaitTimeHistograms {
+public:
+    // Each bucket counts the waits shorter than its upper bound and at least as long as the
+    // previous bucket's bound. The last bucket has no upper bound.
+    static constexpr int kNumBuckets = 7;
+
+    /**
+     * Initializes all the histograms with zeroes (calls reset).
+     */
+    LockWaitTimeHistograms();
+
+    void recordWaitTime(ResourceId resId, LockMode mode, int64_t waitMicros) {
+        CounterOps::add(_get(resId, mode)[bucketFor(waitMicros)], 1);
+    }
+
+    int64_t getBucket(ResourceId resId, LockMode mode, int bucket) const {
+        return CounterOps::get(_get(resId, mode)[bucket]);
+    }
+
+    /**
+     * Returns the index of the bucket to which a wait of 'waitMicros' belongs.
+     */
+    static int bucketFor(int64_t waitMicros);
+
+    template <typename OtherType>
+    void append(const LockWaitTimeHistograms<OtherType>& other) {
+        for (int i = 0; i < ResourceTypesCount; i++) {
+            for (int mode = 0; mode < LockModesCount; mode++) {
+                _appendBuckets(_histograms[i][mode], other._histograms[i][mode]);
+            }
+        }
+
+        for (int mode = 0; mode < LockModesCount; mode++) {
+            _appendBuckets(_oplogHistograms[mode], other._oplogHistograms[mode]);
+        }
+    }
+
+    void report(BSONObjBuilder* builder) const;
+    void reset();
+
+private:
+    template <typename T>
+    friend class LockWaitTimeHistograms;
+
+    typedef CounterType Buckets[kNumBuckets];
+
+    template <typename OtherBuckets>
+    static void _appendBuckets(Buckets& buckets, const OtherBuckets& other) {
+        for (int b = 0; b < kNumBuckets; b++) {
+            CounterOps::add(buckets[b], other[b]);
+        }
+    }
+
+    Buckets& _get(ResourceId resId, LockMode mode) {
+        if (resId == resourceIdOplog) {
+            return _oplogHistograms[mode];
+        }
+
+        return _histograms[resId.getType()][mode];
+    }
+
+    const Buckets& _get(ResourceId resId, LockMode mode) const {
+        return const_cast<LockWaitTimeHistograms*>(this)->_get(resId, mode);
+    }
+
+    void _report(BSONObjBuilder* builder,
+                 const char* sectionName,
+                 const Buckets (&perMode)[LockModesCount]) const;
+
+
+    Buckets _histograms[ResourceTypesCount][LockModesCount];
+    Buckets _oplogHistograms[LockModesCount];
+};
+
+typedef LockWaitTimeHistograms<int64_t> SingleThreadedLockWaitTimeHistograms;
+typedef LockWaitTimeHistograms<AtomicInt64> AtomicLockWaitTimeHistograms;
+
+
 /**
  * Reports instance-wide locking statistics, which can then be converted to BSON or logged.
  */
 void reportGlobalLockingStats(SingleThreadedLockStats* outStats);
 
 /**
- * Currently used for testing only.
+ * Reports the instance-wide histograms of lock wait times.
+ */
+void reportGlobalLockWaitTimeHistograms(SingleThreadedLockWaitTimeHistograms* outHistograms);
+
+/**
+ * Resets both the locking statistics and the wait time histograms. Currently used for testing only.
  */
 void resetGlobalLockStats();
 
@@ -82,6 +82,53 @@ TEST(LockStats, Wait) {
     ASSERT_EQUALS(1, stats.get(resId, MODE_S).numAcquisitions);
     ASSERT_EQUALS(1, stats.get(resId, MODE_S).numWaits);
     ASSERT_GREATER_THAN(stats.get(resId, MODE_S).combinedWaitTimeMicros, 0);
+
+    // The single wait lands in exactly one histogram bucket, however many times it slept
+    SingleThreadedLockWaitTimeHistograms histograms;
+    reportGlobalLockWaitTimeHistograms(&histograms);
+
+    int64_t totalWaits = 0;
+    for (int b = 0; b < SingleThreadedLockWaitTimeHistograms::kNumBuckets; b++) {
+        totalWaits += histograms.getBucket(resId, MODE_S, b);
+    }
+    ASSERT_EQUALS(1, totalWaits);
+}
+
+TEST(LockStats, WaitTimeHistogramBuckets) {
+    ASSERT_EQUALS(0, SingleThreadedLockWaitTimeHistograms::bucketFor(0));
+    ASSERT_EQUALS(0, SingleThreadedLockWaitTimeHistograms::bucketFor(99));
+    ASSERT_EQUALS(1, SingleThreadedLockWaitTimeHistograms::bucketFor(100));
+    ASSERT_EQUALS(2, SingleThreadedLockWaitTimeHistograms::bucketFor(1000));
+    ASSERT_EQUALS(5, SingleThreadedLockWaitTimeHistograms::bucketFor(9999999));
+    ASSERT_EQUALS(6, SingleThreadedLockWaitTimeHistograms::bucketFor(10000000));
+    ASSERT_EQUALS(6, SingleThreadedLockWaitTimeHistograms::bucketFor(1LL << 40));
+
+    const ResourceId resId(RESOURCE_DATABASE, std::string("LockStats.Histograms"));
+    SingleThreadedLockWaitTimeHistograms histograms;
+    histograms.recordWaitTime(resId, MODE_IX, 50);
+    histograms.recordWaitTime(resId, MODE_IX, 5000);
+
+    AtomicLockWaitTimeHistograms atomicHistograms;
+    atomicHistograms.recordWaitTime(resId, MODE_IX, 5000);
+    histograms.append(atomicHistograms);
+
+    ASSERT_EQUALS(1, histograms.getBucket(resId, MODE_IX, 0));
+    ASSERT_EQUALS(2, histograms.getBucket(resId, MODE_IX, 2));
+
+    BSONObjBuilder builder;
+    histograms.report(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("Database" << BSON("w" << BSON("lt100us" << 1LL << "lt1ms" << 0LL
+                                                                     << "lt10ms"
+                                                                     << 2LL
+                                                                     << "lt100ms"
+                                                                     << 0LL
+                                                                     << "lt1s"
+                                                                     << 0LL
+                                                                     << "lt10s"
+                                                                     << 0LL
+                                                                     << "ge10s"
+                                                                     << 0LL))),
+                      builder.obj());
 }
 
 TEST(LockStats, Reporting) {
@@ -73,6 +73,17 @@ public:
      */
     static void setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing);
 
+    /**
+     * Like setGlobalThrottling(reading, writing), and additionally gives the lockers which use
+     * prioritized ticket acquisition separate 'priorityReading' and 'priorityWriting' pools to fall
+     * back to when the regular pool for their mode is exhausted, so that they never queue behind
+     * user operations.
+     */
+    static void setGlobalThrottling(class TicketHolder* reading,
+                                    class TicketHolder* writing,
+                                    class TicketHolder* priorityReading,
+                                    class TicketHolder* priorityWriting);
+
     /**
      * State for reporting the number of active and queued reader and writer clients.
      */
@@ -433,6 +444,19 @@ public:
     bool shouldAcquireTicket() const {
         return _shouldAcquireTicket;
     }
+
+    /**
+     * If set to true, a ticket is taken from the regular pool only when one is free right away,
+     * and otherwise from the priority pool. This is meant for internal work, such as oplog
+     * application and chunk migration, which user load should not be able to starve.
+     */
+    void setPrioritizedTicketAcquisition(bool newValue) {
+        invariant(!isLocked() || isNoop());
+        _prioritizedTicketAcquisition = newValue;
+    }
+    bool prioritizedTicketAcquisition() const {
+        return _prioritizedTicketAcquisition;
+    }
     /**
      * This function is for unit testing only.
      */
@@ -460,6 +484,7 @@ protected:
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    bool _prioritizedTicketAcquisition = false;
 };
 
 /**
@@ -517,4 +542,26 @@ private:
     const bool _originalShouldConflict;
 };
 
+/**
+ * RAII-style class to let the global lock acquisitions of a Locker use the priority ticket pools
+ * while in scope. See Locker::setPrioritizedTicketAcquisition.
+ */
+class PrioritizedTicketAcquisitionBlock {
+    MONGO_DISALLOW_COPYING(PrioritizedTicketAcquisitionBlock);
+
+public:
+    explicit PrioritizedTicketAcquisitionBlock(Locker* lockState)
+        : _lockState(lockState), _originalPrioritized(_lockState->prioritizedTicketAcquisition()) {
+        _lockState->setPrioritizedTicketAcquisition(true);
+    }
+
+    ~PrioritizedTicketAcquisitionBlock() {
+        _lockState->setPrioritizedTicketAcquisition(_originalPrioritized);
+    }
+
+private:
+    Locker* const _lockState;
+    const bool _originalPrioritized;
+};
+
 }  // namespace mongo
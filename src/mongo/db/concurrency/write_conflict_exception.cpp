@@ -31,11 +31,49 @@
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kWrite
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
+
+#include <algorithm>
+#include <random>
+
+#include "mongo/db/concurrency/write_conflict_stats.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stacktrace.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
+namespace {
+
+// The first few retries only yield the processor. After that, each retry sleeps for a random time
+// between half of and the whole of a limit that starts at kMinBackoffMicros and doubles with every
+// attempt, up to kMaxBackoffMicros. The randomness keeps writers that conflicted with each other
+// from waking up together and conflicting again.
+const int kRetriesWithoutSleep = 4;
+const long long kMinBackoffMicros = 100;
+const long long kMaxBackoffMicros = 10 * 1000;
+
+long long computeBackoffMicros(int attempt) {
+    if (attempt < kRetriesWithoutSleep) {
+        return 0;
+    }
+
+    const int doublings = std::min(attempt - kRetriesWithoutSleep, 16);
+    const long long limit = std::min(kMaxBackoffMicros, kMinBackoffMicros << doublings);
+
+    static stdx::mutex randomMutex;
+    static std::default_random_engine randomEngine = [] {
+        std::random_device seed;
+        return std::default_random_engine(seed());
+    }();
+    std::uniform_int_distribution<long long> backoffDist(limit / 2, limit);
+
+    stdx::lock_guard<stdx::mutex> lk(randomMutex);
+    return backoffDist(randomEngine);
+}
+
+}  // namespace
 
 AtomicBool WriteConflictException::trace(false);
 
@@ -47,18 +85,16 @@ WriteConflictException::WriteConflictException()
 }
 
 void WriteConflictException::logAndBackoff(int attempt, StringData operation, StringData ns) {
+    const long long backoffMicros = computeBackoffMicros(attempt);
+    WriteConflictStats::get().recordRetry(ns, backoffMicros);
+
     LOG(1) << "Caught WriteConflictException doing " << operation << " on " << ns
-           << ", attempt: " << attempt << " retrying";
-
-    // All numbers below chosen by guess and check against a few random benchmarks.
-    if (attempt < 4) {
-        // no-op
-    } else if (attempt < 10) {
-        sleepmillis(1);
-    } else if (attempt < 100) {
-        sleepmillis(5);
+           << ", attempt: " << attempt << " retrying in " << backoffMicros << " micros";
+
+    if (backoffMicros == 0) {
+        stdx::this_thread::yield();
     } else {
-        sleepmillis(10);
+        sleepmicros(backoffMicros);
     }
 }
 
@@ -48,8 +48,9 @@ public:
     WriteConflictException();
 
     /**
-     * Will log a message if sensible and will do an exponential backoff to make sure
-     * we don't hammer the same doc over and over.
+     * Will log a message if sensible and will do a randomized exponential backoff to make sure
+     * we don't hammer the same doc over and over. Counts the retry against 'ns' in the
+     * "writeConflicts" serverStatus section.
      * @param attempt - what attempt is this, 1 based
      * @param operation - e.g. "update"
      */
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/write_conflict_stats.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+
+constexpr size_t WriteConflictStats::kMaxNamespaces;
+constexpr size_t WriteConflictStats::kMaxHotDocuments;
+
+WriteConflictStats& WriteConflictStats::get() {
+    static WriteConflictStats stats;
+    return stats;
+}
+
+void WriteConflictStats::recordRetry(StringData ns, long long backoffMicros) {
+    _totalRetries.fetchAndAdd(1);
+    _totalBackoffMicros.fetchAndAdd(backoffMicros);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _retriesByNamespace.find(ns);
+    if (it != _retriesByNamespace.end()) {
+        ++it->second;
+    } else if (_retriesByNamespace.size() < kMaxNamespaces) {
+        _retriesByNamespace[ns] = 1;
+    } else {
+        ++_otherNamespaceRetries;
+    }
+}
+
+void WriteConflictStats::recordConflictingDocument(StringData ns, const RecordId& id) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = std::find_if(_hotDocuments.begin(), _hotDocuments.end(), [&](const HotDocument& doc) {
+        return doc.id == id && doc.ns == ns;
+    });
+    if (it != _hotDocuments.end()) {
+        ++it->conflicts;
+        return;
+    }
+
+    if (_hotDocuments.size() < kMaxHotDocuments) {
+        _hotDocuments.push_back({ns.toString(), id, 1, 0});
+        return;
+    }
+
+    auto coldest = std::min_element(
+        _hotDocuments.begin(), _hotDocuments.end(), [](const HotDocument& a, const HotDocument& b) {
+            return a.conflicts < b.conflicts;
+        });
+    *coldest = {ns.toString(), id, coldest->conflicts + 1, coldest->conflicts};
+}
+
+void WriteConflictStats::report(BSONObjBuilder* builder) const {
+    builder->append("retries", _totalRetries.load());
+    builder->append("backoffMicros", _totalBackoffMicros.load());
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    {
+        BSONObjBuilder namespacesBuilder(builder->subobjStart("namespaces"));
+        for (auto&& entry : _retriesByNamespace) {
+            namespacesBuilder.append(entry.first, entry.second);
+        }
+    }
+    builder->append("otherNamespaces", _otherNamespaceRetries);
+
+    std::vector<const HotDocument*> hottest;
+    for (auto&& doc : _hotDocuments) {
+        hottest.push_back(&doc);
+    }
+    std::sort(hottest.begin(), hottest.end(), [](const HotDocument* a, const HotDocument* b) {
+        return a->conflicts > b->conflicts;
+    });
+
+    BSONArrayBuilder hotDocumentsBuilder(builder->subarrayStart("hotDocuments"));
+    for (auto&& doc : hottest) {
+        BSONObjBuilder docBuilder(hotDocumentsBuilder.subobjStart());
+        docBuilder.append("ns", doc->ns);
+        docBuilder.append("recordId", doc->id.repr());
+        docBuilder.append("conflicts", doc->conflicts);
+        docBuilder.append("overcount", doc->overcount);
+    }
+}
+
+}  // namespace mongo
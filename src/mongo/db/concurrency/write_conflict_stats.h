@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Process-wide record of WriteConflictExceptions: how many were retried on each namespace, and a
+ * sample of the documents that conflicted most often. Reported in serverStatus as
+ * "writeConflicts".
+ *
+ * Conflicts are rare next to the writes that succeed, and a thread that records one is about to
+ * back off anyway, so the stats are kept under a single mutex.
+ */
+class WriteConflictStats {
+    MONGO_DISALLOW_COPYING(WriteConflictStats);
+
+public:
+    // At most this many namespaces are counted separately. Conflicts on further namespaces are
+    // counted together.
+    static constexpr size_t kMaxNamespaces = 100;
+
+    // The number of hot documents tracked.
+    static constexpr size_t kMaxHotDocuments = 16;
+
+    WriteConflictStats() = default;
+
+    static WriteConflictStats& get();
+
+    /**
+     * Records that a write on 'ns' hit a conflict and will be retried after backing off for
+     * 'backoffMicros'.
+     */
+    void recordRetry(StringData ns, long long backoffMicros);
+
+    /**
+     * Records that writing the document at 'id' in 'ns' hit a conflict.
+     */
+    void recordConflictingDocument(StringData ns, const RecordId& id);
+
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    struct HotDocument {
+        std::string ns;
+        RecordId id;
+
+        // An upper bound on the conflicts on the document, and how much it may overcount.
+        long long conflicts;
+        long long overcount;
+    };
+
+    AtomicInt64 _totalRetries{0};
+    AtomicInt64 _totalBackoffMicros{0};
+
+    mutable stdx::mutex _mutex;
+    StringMap<long long> _retriesByNamespace;
+    long long _otherNamespaceRetries = 0;
+
+    // The documents that conflicted most often, found with the space-saving algorithm: when a
+    // document not being tracked conflicts and the list is full, it replaces the entry with the
+    // fewest conflicts and inherits its count.
+    std::vector<HotDocument> _hotDocuments;
+};
+
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/write_conflict_stats.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(WriteConflictStats, CountsRetriesPerNamespace) {
+    WriteConflictStats stats;
+    stats.recordRetry("test.a", 0);
+    stats.recordRetry("test.a", 100);
+    stats.recordRetry("test.b", 50);
+
+    BSONObjBuilder builder;
+    stats.report(&builder);
+    BSONObj report = builder.obj();
+    ASSERT_EQ(3, report["retries"].numberLong());
+    ASSERT_EQ(150, report["backoffMicros"].numberLong());
+    ASSERT_EQ(2, report["namespaces"].Obj().nFields());
+    ASSERT_EQ(2, report["namespaces"]["test.a"].numberLong());
+    ASSERT_EQ(1, report["namespaces"]["test.b"].numberLong());
+    ASSERT_EQ(0, report["otherNamespaces"].numberLong());
+}
+
+TEST(WriteConflictStats, CountsNamespacesBeyondTheLimitTogether) {
+    WriteConflictStats stats;
+    for (size_t i = 0; i < WriteConflictStats::kMaxNamespaces + 3; ++i) {
+        stats.recordRetry("test.c" + std::to_string(i), 0);
+    }
+    stats.recordRetry("test.c0", 0);
+
+    BSONObjBuilder builder;
+    stats.report(&builder);
+    BSONObj report = builder.obj();
+    ASSERT_EQ(static_cast<int>(WriteConflictStats::kMaxNamespaces),
+              report["namespaces"].Obj().nFields());
+    ASSERT_EQ(2, report["namespaces"]["test.c0"].numberLong());
+    ASSERT_EQ(3, report["otherNamespaces"].numberLong());
+}
+
+TEST(WriteConflictStats, HotDocumentsAreReportedHottestFirst) {
+    WriteConflictStats stats;
+
+    // Fill the list, then keep conflicting on one document while cold documents cycle through.
+    for (size_t i = 0; i < WriteConflictStats::kMaxHotDocuments * 4; ++i) {
+        stats.recordConflictingDocument("test.hot", RecordId(1));
+        stats.recordConflictingDocument("test.hot", RecordId(100 + i));
+    }
+    stats.recordConflictingDocument("test.other", RecordId(1));
+
+    BSONObjBuilder builder;
+    stats.report(&builder);
+    BSONObj report = builder.obj();
+    std::vector<BSONElement> hotDocuments = report["hotDocuments"].Array();
+    ASSERT_EQ(WriteConflictStats::kMaxHotDocuments, hotDocuments.size());
+
+    BSONObj hottest = hotDocuments[0].Obj();
+    ASSERT_EQ("test.hot", hottest["ns"].str());
+    ASSERT_EQ(1, hottest["recordId"].numberLong());
+    ASSERT_EQ(static_cast<long long>(WriteConflictStats::kMaxHotDocuments * 4),
+              hottest["conflicts"].numberLong());
+    ASSERT_EQ(0, hottest["overcount"].numberLong());
+    for (size_t i = 1; i < hotDocuments.size(); ++i) {
+        ASSERT_LTE(hotDocuments[i]["conflicts"].numberLong(),
+                   hotDocuments[i - 1]["conflicts"].numberLong());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -34,7 +34,10 @@
 
 #include "mongo/db/curop.h"
 
+#include <time.h>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/init.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
@@ -43,9 +46,12 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/storage/recovery_unit.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
+#include "mongo/util/hex.h"
 #include "mongo/util/log.h"
+#include "mongo/util/memory_usage_tracker.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/stringutils.h"
 
@@ -70,6 +76,48 @@ const std::vector<const char*> kDollarQueryModifiers = {
     "$maxTimeMS",
 };
 
+// The memory held in MemoryUsageTracker categories on behalf of each operation.
+const auto operationMemoryUsage =
+    OperationContext::declareDecoration<MemoryUsageTracker::OperationUsage>();
+
+MONGO_INITIALIZER(OperationMemoryUsageTracking)(InitializerContext* context) {
+    MemoryUsageTracker::setCurrentOperationUsageFn([]() -> MemoryUsageTracker::OperationUsage* {
+        const auto client = Client::getCurrent();
+        const auto opCtx = client ? client->getOperationContext() : nullptr;
+        return opCtx ? &operationMemoryUsage(opCtx) : nullptr;
+    });
+    return Status::OK();
+}
+
+/**
+ * Returns the CPU time consumed so far by the calling thread, or -1 if the platform cannot measure
+ * it.
+ */
+long long getThreadCpuTimeNanos() {
+#if defined(_WIN32)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return -1;
+    }
+
+    // FILETIME counts 100 nanosecond intervals.
+    const auto toNanos = [](const FILETIME& time) {
+        return static_cast<long long>((static_cast<unsigned long long>(time.dwHighDateTime) << 32) |
+                                      time.dwLowDateTime) *
+            100;
+    };
+    return toNanos(kernelTime) + toNanos(userTime);
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return -1;
+    }
+    return static_cast<long long>(time.tv_sec) * 1000 * 1000 * 1000 + time.tv_nsec;
+#else
+    return -1;
+#endif
+}
+
 }  // namespace
 
 BSONObj upconvertQueryEntry(const BSONObj& query,
@@ -271,6 +319,19 @@ void CurOp::reportCurrentOpForClient(OperationContext* opCtx,
         }
 
         CurOp::get(clientOpCtx)->reportState(infoBuilder, truncateOps);
+
+        // The operation's recovery unit can be swapped out without the client lock, so report the
+        // copy of its statistics which the operation keeps under the lock instead.
+        const auto& storageStats = CurOp::get(clientOpCtx)->debug().storageStats;
+        if (!storageStats.isEmpty()) {
+            infoBuilder->append("storage", storageStats);
+        }
+
+        const auto memoryUsage = operationMemoryUsage(clientOpCtx).get();
+        if (memoryUsage.peakBytes > 0) {
+            infoBuilder->append("trackedMemBytes", memoryUsage.currentBytes);
+            infoBuilder->append("peakTrackedMemBytes", memoryUsage.peakBytes);
+        }
     }
 }
 
@@ -332,7 +393,8 @@ void CurOp::setNS_inlock(StringData ns) {
 
 void CurOp::ensureStarted() {
     if (_start == 0) {
-        _start = curTimeMicros64();
+        _start = CycleTickSource::now();
+        _startCpuNanos = getThreadCpuTimeNanos();
     }
 }
 
@@ -344,6 +406,19 @@ void CurOp::enter_inlock(const char* ns, boost::optional<int> dbProfileLevel) {
     }
 }
 
+void CurOp::updateStorageStats(OperationContext* opCtx) {
+    auto recoveryUnit = opCtx->recoveryUnit();
+    if (!recoveryUnit) {
+        return;
+    }
+
+    BSONObjBuilder storageStats;
+    recoveryUnit->appendOperationStatistics(&storageStats);
+
+    stdx::lock_guard<Client> lk(*opCtx->getClient());
+    _debug.storageStats = storageStats.obj();
+}
+
 void CurOp::raiseDbProfileLevel(int dbProfileLevel) {
     _dbprofile = std::max(dbProfileLevel, _dbprofile);
 }
@@ -365,9 +440,24 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     }
 
     // Obtain the total execution time of this operation.
-    _end = curTimeMicros64();
+    _end = CycleTickSource::now();
     _debug.executionTimeMicros = durationCount<Microseconds>(elapsedTimeExcludingPauses());
 
+    // Record the resources consumed by this operation, which runs on this thread from start to end.
+    if (_startCpuNanos >= 0) {
+        const long long endCpuNanos = getThreadCpuTimeNanos();
+        if (endCpuNanos >= _startCpuNanos) {
+            _debug.cpuNanos = endCpuNanos - _startCpuNanos;
+        }
+    }
+
+    updateStorageStats(opCtx);
+
+    const auto memoryUsage = operationMemoryUsage(opCtx).get();
+    if (memoryUsage.peakBytes > 0) {
+        _debug.peakTrackedMemBytes = memoryUsage.peakBytes;
+    }
+
     const bool shouldSample =
         client->getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
 
@@ -466,6 +556,10 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
         builder->append("planSummary", _planSummary);
     }
 
+    if (!_cursorPrefetchStats.isEmpty()) {
+        builder->append("cursorPrefetch", _cursorPrefetchStats);
+    }
+
     if (!_message.empty()) {
         if (_progressMeter.isActive()) {
             StringBuilder buf;
@@ -553,6 +647,10 @@ string OpDebug::report(Client* client,
         s << " planSummary: " << redact(curop.getPlanSummary().toString());
     }
 
+    if (queryHash) {
+        s << " queryHash: " << unsignedIntToFixedLengthHex(*queryHash);
+    }
+
     OPDEBUG_TOSTRING_HELP(nShards);
     OPDEBUG_TOSTRING_HELP(cursorid);
     OPDEBUG_TOSTRING_HELP(ntoreturn);
@@ -592,6 +690,14 @@ string OpDebug::report(Client* client,
         s << " writeConflicts:" << writeConflicts;
     }
 
+    if (jsCompileMicros > 0) {
+        s << " jsCompileMicros:" << jsCompileMicros;
+    }
+
+    if (jsExecutionMicros > 0) {
+        s << " jsExecutionMicros:" << jsExecutionMicros;
+    }
+
     s << " numYields:" << curop.numYields();
     OPDEBUG_TOSTRING_HELP(nreturned);
 
@@ -614,6 +720,15 @@ string OpDebug::report(Client* client,
         s << " locks:" << locks.obj().toString();
     }
 
+    if (!storageStats.isEmpty()) {
+        s << " storage:" << storageStats.toString();
+    }
+
+    OPDEBUG_TOSTRING_HELP(cpuNanos);
+    OPDEBUG_TOSTRING_HELP(peakTrackedMemBytes);
+    OPDEBUG_TOSTRING_HELP(peakStageMemBytes);
+    OPDEBUG_TOSTRING_HELP(stageSpills);
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
@@ -684,6 +799,14 @@ void OpDebug::append(const CurOp& curop,
         b.appendNumber("writeConflicts", writeConflicts);
     }
 
+    if (jsCompileMicros > 0) {
+        b.appendNumber("jsCompileMicros", jsCompileMicros);
+    }
+
+    if (jsExecutionMicros > 0) {
+        b.appendNumber("jsExecutionMicros", jsExecutionMicros);
+    }
+
     b.appendNumber("numYield", curop.numYields());
     OPDEBUG_APPEND_NUMBER(nreturned);
 
@@ -692,6 +815,15 @@ void OpDebug::append(const CurOp& curop,
         lockStats.report(&locks);
     }
 
+    if (!storageStats.isEmpty()) {
+        b.append("storage", storageStats);
+    }
+
+    OPDEBUG_APPEND_NUMBER(cpuNanos);
+    OPDEBUG_APPEND_NUMBER(peakTrackedMemBytes);
+    OPDEBUG_APPEND_NUMBER(peakStageMemBytes);
+    OPDEBUG_APPEND_NUMBER(stageSpills);
+
     if (!errInfo.isOK()) {
         b.appendNumber("ok", 0.0);
         if (!errInfo.reason().empty()) {
@@ -707,6 +839,10 @@ void OpDebug::append(const CurOp& curop,
     }
     b.appendIntOrLL("millis", executionTimeMicros / 1000);
 
+    if (queryHash) {
+        b.append("queryHash", unsignedIntToFixedLengthHex(*queryHash));
+    }
+
     if (!curop.getPlanSummary().empty()) {
         b.append("planSummary", curop.getPlanSummary());
     }
@@ -722,6 +858,11 @@ void OpDebug::setPlanSummaryMetrics(const PlanSummaryStats& planSummaryStats) {
     hasSortStage = planSummaryStats.hasSortStage;
     fromMultiPlanner = planSummaryStats.fromMultiPlanner;
     replanned = planSummaryStats.replanned;
+    queryHash = planSummaryStats.queryHash;
+    if (planSummaryStats.peakStageMemUsage > 0 || planSummaryStats.stageSpills > 0) {
+        peakStageMemBytes = planSummaryStats.peakStageMemUsage;
+        stageSpills = planSummaryStats.stageSpills;
+    }
 }
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/cycle_tick_source.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/time_support.h"
 
@@ -101,6 +102,9 @@ public:
     // True if a replan was triggered during the execution of this operation.
     bool replanned{false};
 
+    // The fingerprint of the query shape, if this operation planned a canonical query.
+    boost::optional<std::uint64_t> queryHash;
+
     long long nMatched{-1};   // number of records that match the query
     long long nModified{-1};  // number of records written (no no-ops)
     long long ninserted{-1};
@@ -118,6 +122,27 @@ public:
     long long prepareReadConflicts{0};  // Number of read conflicts caused by a prepared transaction
     long long writeConflicts{0};
 
+    // Time spent compiling JavaScript functions and running them, for $where and mapReduce.
+    long long jsCompileMicros{0};
+    long long jsExecutionMicros{0};
+
+    // CPU time consumed by the thread executing the operation, or -1 if the platform cannot
+    // measure per-thread CPU time.
+    long long cpuNanos{-1};
+
+    // The most memory the operation held at once in MemoryUsageTracker categories, such as sort
+    // and $group buffers, or -1 if it held none.
+    long long peakTrackedMemBytes{-1};
+
+    // The largest peak memory usage of any plan or pipeline stage which buffers data, and the
+    // number of times such stages spilled to disk, or -1 if no stage buffered anything.
+    long long peakStageMemBytes{-1};
+    long long stageSpills{-1};
+
+    // Storage engine statistics for the operation, as last reported by its recovery unit. Owned
+    // here. Other threads must lock the client to read it.
+    BSONObj storageStats;
+
     BSONObj execStats;  // Owned here.
 
     // Details of any error (whether from an exception or a command returning failure).
@@ -317,20 +342,20 @@ public:
     }
 
     //
-    // Methods for getting/setting elapsed time. Note that the observed elapsed time may be
-    // negative, if the system time has been reset during the course of this operation.
+    // Methods for getting/setting elapsed time. Times are taken from CycleTickSource, which is
+    // monotonic and cheap enough to read at every operation boundary.
     //
 
     void ensureStarted();
     bool isStarted() const {
         return _start > 0;
     }
-    long long startTime() {  // micros
+    long long startTime() {  // CycleTickSource ticks
         ensureStarted();
         return _start;
     }
     void done() {
-        _end = curTimeMicros64();
+        _end = CycleTickSource::now();
     }
     bool isDone() const {
         return _end > 0;
@@ -346,7 +371,7 @@ public:
     void pauseTimer() {
         invariant(isStarted());
         invariant(_lastPauseTime == 0);
-        _lastPauseTime = curTimeMicros64();
+        _lastPauseTime = CycleTickSource::now();
     }
 
     /**
@@ -357,7 +382,7 @@ public:
         invariant(isStarted());
         invariant(_lastPauseTime > 0);
         _totalPausedDuration +=
-            Microseconds{static_cast<long long>(curTimeMicros64()) - _lastPauseTime};
+            CycleTickSource::ticksToMicros(CycleTickSource::now() - _lastPauseTime);
         _lastPauseTime = 0;
     }
 
@@ -375,9 +400,9 @@ public:
         }
 
         if (!_end) {
-            return Microseconds{static_cast<long long>(curTimeMicros64() - startTime())};
+            return CycleTickSource::ticksToMicros(CycleTickSource::now() - startTime());
         } else {
-            return Microseconds{static_cast<long long>(_end - startTime())};
+            return CycleTickSource::ticksToMicros(_end - startTime());
         }
     }
 
@@ -414,6 +439,13 @@ public:
         _originatingCommand = commandObj.getOwned();
     }
 
+    /**
+     * Sets how the getMore cursor's prefetched results have been used, reported by currentOp.
+     */
+    void setCursorPrefetchStats_inlock(const BSONObj& stats) {
+        _cursorPrefetchStats = stats.getOwned();
+    }
+
     const Command* getCommand() const {
         return _command;
     }
@@ -464,6 +496,13 @@ public:
         _numYields++;
     }  // Should be _inlock()?
 
+    /**
+     * Copies the statistics of the operation's recovery unit into debug().storageStats, where
+     * $currentOp can read them under the client lock. Must be called on the thread executing the
+     * operation, which is the only one that may touch its recovery unit.
+     */
+    void updateStorageStats(OperationContext* opCtx);
+
     /**
      * Returns the number of times yielded() was called.  Callers on threads other
      * than the one executing the operation must lock the client.
@@ -502,12 +541,17 @@ private:
     CurOp* _parent{nullptr};
     const Command* _command{nullptr};
 
-    // The time at which this CurOp instance was marked as started.
+    // The time at which this CurOp instance was marked as started, in CycleTickSource ticks like
+    // the other times below.
     long long _start{0};
 
     // The time at which this CurOp instance was marked as done.
     long long _end{0};
 
+    // The CPU time of the executing thread when this CurOp instance was marked as started, or -1
+    // if it is not available.
+    long long _startCpuNanos{-1};
+
     // The time at which this CurOp instance had its timer paused, or 0 if the timer is not
     // currently paused.
     long long _lastPauseTime{0};
@@ -526,7 +570,8 @@ private:
     int _dbprofile{0};  // 0=off, 1=slow, 2=all
     std::string _ns;
     BSONObj _opDescription;
-    BSONObj _originatingCommand;  // Used by getMore to display original command.
+    BSONObj _originatingCommand;   // Used by getMore to display original command.
+    BSONObj _cursorPrefetchStats;  // Used by getMore to display the cursor's prefetch stats.
     OpDebug _debug;
     std::string _message;
     ProgressMeter _progressMeter;
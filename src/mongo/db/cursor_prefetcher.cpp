@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/cursor_prefetcher.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/clientcursor.h"
+#include "mongo/db/cursor_manager.h"
+#include "mongo/db/cursor_server_params.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const auto getCursorPrefetcher = ServiceContext::declareDecoration<CursorPrefetcher>();
+
+}  // namespace
+
+CursorPrefetcher::~CursorPrefetcher() = default;
+
+CursorPrefetcher* CursorPrefetcher::get(ServiceContext* serviceContext) {
+    return &getCursorPrefetcher(serviceContext);
+}
+
+bool CursorPrefetcher::isEligible(OperationContext* opCtx, const ClientCursor& cursor) {
+    return getCursorPrefetchBytes() > 0 && !opCtx->getClient()->isInDirectClient() &&
+        !CursorManager::isGloballyManagedCursor(cursor.cursorid()) && !cursor.isTailable() &&
+        !cursor.getTxnNumber() &&
+        cursor.getReadConcernLevel() != repl::ReadConcernLevel::kSnapshotReadConcern;
+}
+
+void CursorPrefetcher::schedule(const NamespaceString& nss, CursorId cursorId) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_inShutdown || _inProgress.count(cursorId)) {
+        return;
+    }
+
+    if (!_pool) {
+        ThreadPool::Options options;
+        options.poolName = "CursorPrefetcher";
+        options.threadNamePrefix = "CursorPrefetcher-";
+        options.minThreads = 0;
+        options.maxThreads = getCursorPrefetchThreads();
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName);
+        };
+        _pool = stdx::make_unique<ThreadPool>(options);
+        _pool->startup();
+    }
+
+    auto stop = std::make_shared<AtomicBool>(false);
+    _inProgress.emplace(cursorId, stop);
+    Status status = _pool->schedule([this, nss, cursorId, stop] {
+        try {
+            _prefetch(nss, cursorId, *stop);
+        } catch (const DBException& ex) {
+            LOG(1) << "Prefetch for cursor " << cursorId << " on " << nss << " failed: "
+                   << redact(ex);
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inProgress.erase(cursorId);
+        _prefetchDone.notify_all();
+    });
+    if (!status.isOK()) {
+        _inProgress.erase(cursorId);
+    }
+}
+
+bool CursorPrefetcher::waitForPrefetch(OperationContext* opCtx, CursorId cursorId) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto it = _inProgress.find(cursorId);
+    if (it == _inProgress.end()) {
+        return false;
+    }
+
+    // The prefetch stops before its next result, so the wait is for at most one more result.
+    it->second->store(true);
+    opCtx->waitForConditionOrInterrupt(
+        _prefetchDone, lk, [&] { return _inProgress.find(cursorId) == _inProgress.end(); });
+    return true;
+}
+
+void CursorPrefetcher::shutdown() {
+    ThreadPool* pool;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_inShutdown) {
+            return;
+        }
+        _inShutdown = true;
+        for (auto&& entry : _inProgress) {
+            entry.second->store(true);
+        }
+        pool = _pool.get();
+    }
+
+    if (pool) {
+        pool->shutdown();
+        pool->join();
+    }
+}
+
+void CursorPrefetcher::_prefetch(const NamespaceString& nss,
+                                 CursorId cursorId,
+                                 const AtomicBool& stop) {
+    if (stop.load()) {
+        return;
+    }
+
+    auto opCtx = cc().makeOperationContext();
+
+    // As in getMore, the lock is taken before the pin so that the pin is released under it.
+    AutoGetCollectionForRead readLock(opCtx.get(), nss);
+    Collection* collection = readLock.getCollection();
+    if (!collection) {
+        return;
+    }
+
+    // Fails if the cursor has been killed, or if a getMore got to it first.
+    auto pinStatus = collection->getCursorManager()->pinCursor(
+        opCtx.get(), cursorId, CursorManager::kNoCheckSession);
+    if (!pinStatus.isOK()) {
+        return;
+    }
+    ClientCursorPin& pin = pinStatus.getValue();
+    ClientCursor* cursor = pin.getCursor();
+
+    // If this operation is interrupted, get rid of the cursor, as an interrupted getMore would.
+    ScopeGuard cursorFreer = MakeGuard(&ClientCursorPin::deleteUnderlying, &pin);
+
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx.get());
+    if (replCoord->getReplicationMode() == repl::ReplicationCoordinator::modeReplSet &&
+        cursor->getReadConcernLevel() == repl::ReadConcernLevel::kMajorityReadConcern) {
+        opCtx->recoveryUnit()->setTimestampReadSource(
+            RecoveryUnit::ReadSource::kMajorityCommitted);
+        uassertStatusOK(opCtx->recoveryUnit()->obtainMajorityCommittedSnapshot());
+    }
+
+    // If the executor was killed, leave it to the next getMore to report that.
+    PlanExecutor* exec = cursor->getExecutor();
+    exec->reattachToOperationContext(opCtx.get());
+    if (exec->restoreState().isOK()) {
+        const long long numDocs =
+            exec->prefetch(getCursorPrefetchBytes(), [&stop] { return stop.load(); });
+        cursor->getPrefetchStats().recordPrefetch(numDocs);
+    }
+    exec->saveState();
+    exec->detachFromOperationContext();
+
+    uassertStatusOK(opCtx->checkForInterruptNoAssert());
+    cursorFreer.Dismiss();
+}
+
+}  // namespace mongo
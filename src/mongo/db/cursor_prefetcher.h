@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/cursor_id.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+class ClientCursor;
+class OperationContext;
+class ServiceContext;
+class ThreadPool;
+
+/**
+ * Fills the stash of idle find cursors in the background, so that while the client is busy with
+ * one batch the next is already being read from storage.
+ *
+ * After a find or getMore leaves a cursor open and unpins it, it calls schedule(). A prefetcher
+ * thread then pins the cursor, runs its plan until "cursorPrefetchBytes" worth of results are
+ * stashed in the PlanExecutor, and unpins it again. The next getMore must call waitForPrefetch()
+ * before it takes any locks; this cuts short a prefetch still in progress and waits for it to
+ * release the cursor, so the getMore is served from whatever was stashed.
+ */
+class CursorPrefetcher {
+    MONGO_DISALLOW_COPYING(CursorPrefetcher);
+
+public:
+    CursorPrefetcher() = default;
+    ~CursorPrefetcher();
+
+    static CursorPrefetcher* get(ServiceContext* serviceContext);
+
+    /**
+     * Returns whether results may be prefetched for 'cursor', which is pinned by 'opCtx'. Cursors
+     * in transactions or on snapshot read concern must keep to their own snapshot, and tailable
+     * and DBDirectClient cursors are driven from their own operation, so none of these are.
+     */
+    static bool isEligible(OperationContext* opCtx, const ClientCursor& cursor);
+
+    /**
+     * Starts prefetching for the cursor 'cursorId' on 'nss'. The caller must have checked that the
+     * cursor is eligible, and must have unpinned it.
+     */
+    void schedule(const NamespaceString& nss, CursorId cursorId);
+
+    /**
+     * Stops any prefetch in progress for 'cursorId' and waits for it to unpin the cursor. Returns
+     * whether there was one. Must not be called while holding locks.
+     */
+    bool waitForPrefetch(OperationContext* opCtx, CursorId cursorId);
+
+    /**
+     * Stops accepting new prefetches and waits for those in progress to finish.
+     */
+    void shutdown();
+
+private:
+    void _prefetch(const NamespaceString& nss, CursorId cursorId, const AtomicBool& stop);
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _prefetchDone;
+
+    // Prefetches scheduled or running, each with the flag asking it to stop.
+    stdx::unordered_map<CursorId, std::shared_ptr<AtomicBool>> _inProgress;
+
+    // Started by the first call to schedule().
+    std::unique_ptr<ThreadPool> _pool;
+    bool _inShutdown = false;
+};
+
+}  // namespace mongo
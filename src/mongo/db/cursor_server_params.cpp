@@ -41,6 +41,20 @@ MONGO_EXPORT_SERVER_PARAMETER(clientCursorMonitorFrequencySecs, int, 4);
 MONGO_EXPORT_SERVER_PARAMETER(cursorTimeoutMillis,
                               long long,
                               durationCount<Milliseconds>(kDefaultCursorTimeoutMinutes));
+MONGO_EXPORT_SERVER_PARAMETER(cursorPrefetchBytes, long long, 0)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "cursorPrefetchBytes must not be negative");
+        }
+        return Status::OK();
+    });
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(cursorPrefetchThreads, int, 4)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue, "cursorPrefetchThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
 
 }  // namespace
 
@@ -56,4 +70,12 @@ Milliseconds getDefaultCursorTimeoutMillis() {
     return kDefaultCursorTimeoutMinutes;
 }
 
+long long getCursorPrefetchBytes() {
+    return cursorPrefetchBytes.load();
+}
+
+int getCursorPrefetchThreads() {
+    return cursorPrefetchThreads;
+}
+
 }  // namespace mongo
@@ -40,4 +40,13 @@ long long getCursorTimeoutMillis();
 
 Milliseconds getDefaultCursorTimeoutMillis();
 
+// Bytes of results to prefetch for an idle cursor after each batch, so that its next getMore can be
+// served without waiting on storage. Zero, the default, disables prefetching. Configurable with
+// server parameter "cursorPrefetchBytes".
+long long getCursorPrefetchBytes();
+
+// Number of threads prefetching for idle cursors. Configurable at startup with server parameter
+// "cursorPrefetchThreads".
+int getCursorPrefetchThreads();
+
 }  // namespace mongo
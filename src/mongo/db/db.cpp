@@ -65,6 +65,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/cursor_prefetcher.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/dbhelpers.h"
@@ -97,6 +98,7 @@
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
 #include "mongo/db/periodic_runner_job_decrease_snapshot_cache_pressure.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query_result_cache_op_observer.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
 #include "mongo/db/repl/oplog.h"
@@ -163,6 +165,7 @@
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/ntservice.h"
+#include "mongo/util/numa_placement.h"
 #include "mongo/util/options_parser/startup_options.h"
 #include "mongo/util/periodic_runner.h"
 #include "mongo/util/periodic_runner_factory.h"
@@ -195,6 +198,9 @@ namespace {
 const NamespaceString startupLogCollectionName("local.startup_log");
 const NamespaceString kSystemReplSetCollection("local.system.replset");
 
+// Whether connection and worker threads are bound to NUMA nodes, spread round-robin across them.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(numaThreadPlacement, bool, false);
+
 #ifdef _WIN32
 const ntservice::NtServiceDefaultStrings defaultServiceStrings = {
     L"MongoDB", L"MongoDB", L"MongoDB Server"};
@@ -283,6 +289,7 @@ ExitCode _initAndListen(int listenPort) {
     auto opObserverRegistry = stdx::make_unique<OpObserverRegistry>();
     opObserverRegistry->addObserver(stdx::make_unique<OpObserverImpl>());
     opObserverRegistry->addObserver(stdx::make_unique<UUIDCatalogObserver>());
+    opObserverRegistry->addObserver(stdx::make_unique<QueryResultCacheOpObserver>());
 
     if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
         opObserverRegistry->addObserver(stdx::make_unique<ShardServerOpObserver>());
@@ -319,6 +326,13 @@ ExitCode _initAndListen(int listenPort) {
 
     logProcessDetails();
 
+    if (numaThreadPlacement) {
+        auto& numaPlacement = NumaPlacement::get();
+        numaPlacement.setEnabled(true);
+        log() << "Placing connection and worker threads on " << numaPlacement.nodes().size()
+              << " NUMA node(s)";
+    }
+
     createLockFile(serviceContext);
 
     serviceContext->setServiceEntryPoint(
@@ -889,6 +903,9 @@ void shutdownTask() {
 
     serviceContext->setKillAllOperations();
 
+    // Stop prefetching for idle cursors.
+    CursorPrefetcher::get(serviceContext)->shutdown();
+
     // Shut down the background periodic task runner
     if (auto runner = serviceContext->getPeriodicRunner()) {
         runner->shutdown();
@@ -32,13 +32,16 @@
 
 #include "mongo/db/db_raii.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -46,6 +49,18 @@ namespace {
 
 const boost::optional<int> kDoNotChangeProfilingLevel = boost::none;
 
+// Number of reads on secondaries served at the last applied timestamp without conflicting with
+// batch application.
+Counter64 secondaryReadsAtLastAppliedCounter;
+ServerStatusMetricField<Counter64> displaySecondaryReadsAtLastApplied(
+    "repl.secondaryReads.atLastApplied", &secondaryReadsAtLastAppliedCounter);
+
+// Reads on secondaries which could not be served at the last applied timestamp because of pending
+// catalog changes, and the time they spent reacquiring their locks behind batch application.
+TimerStats secondaryReadsWaitedStats;
+ServerStatusMetricField<TimerStats> displaySecondaryReadsWaitedForBatchApplication(
+    "repl.secondaryReads.waitedForBatchApplication", &secondaryReadsWaitedStats);
+
 }  // namespace
 
 // If true, do not take the PBWM lock in AutoGetCollectionForRead on secondaries during batch
@@ -142,6 +157,9 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
 
         auto minSnapshot = coll->getMinimumVisibleSnapshot();
         if (!_conflictingCatalogChanges(opCtx, minSnapshot, lastAppliedTimestamp)) {
+            if (readAtLastAppliedTimestamp) {
+                secondaryReadsAtLastAppliedCounter.increment();
+            }
             return;
         }
 
@@ -160,12 +178,14 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
         // initial sync finishes, if we waited instead of retrying, readers would block indefinitely
         // waiting for the lastAppliedTimestamp to move forward. Instead we force the reader take
         // the PBWM lock and retry.
+        boost::optional<TimerHolder> waitForBatchApplicationTimer;
         if (lastAppliedTimestamp) {
             LOG(2) << "Tried reading at last-applied time: " << *lastAppliedTimestamp
                    << " on nss: " << nss.ns() << ", but future catalog changes are pending at time "
                    << *minSnapshot << ". Trying again without reading at last-applied time.";
             _shouldNotConflictWithSecondaryBatchApplicationBlock = boost::none;
             opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kNone);
+            waitForBatchApplicationTimer.emplace(&secondaryReadsWaitedStats);
         }
 
         if (readSource == RecoveryUnit::ReadSource::kMajorityCommitted) {
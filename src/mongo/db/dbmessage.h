@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/client/constants.h"
@@ -446,6 +448,10 @@ Message makeGetMoreMessage(StringData ns, long long cursorId, int nToReturn, int
 struct DbResponse {
     Message response;       // If empty, nothing will be returned to the client.
     std::string exhaustNS;  // Namespace of cursor if exhaust mode, else "".
+
+    // For an OP_MSG request with the kExhaustSupported flag, the command that produces the next
+    // reply of the exhaust stream, including its $db. Unset if the stream ends with this reply.
+    boost::optional<BSONObj> nextInvocation;
 };
 
 /**
@@ -214,9 +214,16 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
+    if (!filterMayContain(member->recordId)) {
+        // Child's output wasn't in every previous child.  Throw it out.
+        _ws->free(*out);
+        return PlanStage::NEED_TIME;
+    }
+
     DataMap::iterator it = _dataMap.find(member->recordId);
     if (_dataMap.end() == it) {
         // Child's output wasn't in every previous child.  Throw it out.
+        ++_specificStats.filterFalsePositives;
         _ws->free(*out);
         return PlanStage::NEED_TIME;
     } else {
@@ -272,6 +279,7 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
 
         // Update memory stats.
         _memUsage += member->getMemUsage();
+        _specificStats.peakMemUsage = std::max(_specificStats.peakMemUsage, _memUsage);
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::IS_EOF == childStatus) {
@@ -285,6 +293,7 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         }
 
         _specificStats.mapAfterChild.push_back(_dataMap.size());
+        rebuildFilter();
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
@@ -319,7 +328,9 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         }
 
         verify(member->hasRecordId());
-        if (_dataMap.end() == _dataMap.find(member->recordId)) {
+        if (!filterMayContain(member->recordId)) {
+            // Ignore.  It's not in any previous child.
+        } else if (_dataMap.end() == _dataMap.find(member->recordId)) {
             // Ignore.  It's not in any previous child.
         } else {
             // We have a hit.  Copy data into the WSM we already have.
@@ -332,6 +343,7 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
 
             // Update memory stats.
             _memUsage += olderMember->getMemUsage() - memUsageBefore;
+            _specificStats.peakMemUsage = std::max(_specificStats.peakMemUsage, _memUsage);
         }
         _ws->free(id);
         return PlanStage::NEED_TIME;
@@ -369,6 +381,8 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
             return PlanStage::IS_EOF;
         }
 
+        rebuildFilter();
+
         // We've finished scanning all children.  Return results with the next call to work().
         if (_currentChild == _children.size()) {
             _hashingChildren = false;
@@ -390,6 +404,23 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
     }
 }
 
+void AndHashStage::rebuildFilter() {
+    _filter.reset(_dataMap.size());
+    for (const auto& entry : _dataMap) {
+        _filter.add(entry.first);
+    }
+    _specificStats.filterMemUsage = _filter.memUsage();
+}
+
+bool AndHashStage::filterMayContain(const RecordId& rid) {
+    ++_specificStats.filterTested;
+    if (!_filter.mayContain(rid)) {
+        ++_specificStats.filterRejected;
+        return false;
+    }
+    return true;
+}
+
 void AndHashStage::doInvalidate(OperationContext* opCtx,
                                 const RecordId& dl,
                                 InvalidationType type) {
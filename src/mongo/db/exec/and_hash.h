@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bloom_filter.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
@@ -45,6 +46,10 @@ namespace mongo {
  *
  * Preconditions: Valid RecordId.  More than one child.
  *
+ * Once a child has been hashed, a Bloom filter over the surviving RecordIds is built and consulted
+ * before probing the hash table with the results of subsequent children, so that most of the
+ * non-matching results are discarded without touching the table.
+ *
  * Any RecordId that we keep a reference to that is invalidated before we are able to return it
  * is fetched and added to the WorkingSet as "flagged for further review."  Because this stage
  * operates with RecordIds, we are unable to evaluate the AND for the invalidated RecordId, and it
@@ -92,6 +97,16 @@ private:
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
 
+    /**
+     * Rebuilds '_filter' from the RecordIds currently in '_dataMap'.
+     */
+    void rebuildFilter();
+
+    /**
+     * Returns false if 'rid' is definitely not in '_dataMap', updating the filter stats.
+     */
+    bool filterMayContain(const RecordId& rid);
+
     // Not owned by us.
     const Collection* _collection;
 
@@ -113,6 +128,9 @@ private:
     typedef stdx::unordered_set<RecordId, RecordId::Hasher> SeenMap;
     SeenMap _seenMap;
 
+    // Approximates the key set of _dataMap. Rebuilt every time a child has been intersected.
+    RecordIdBloomFilter _filter;
+
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
 
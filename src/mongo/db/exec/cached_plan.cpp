@@ -75,7 +75,8 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // Adds the amount of time taken by pickBestPlan() to executionTimeMillis. There's lots of
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedCycleTimer timer(
+        1, &_commonStats.executionTimeTicks, &_commonStats.executionTimeMillis);
 
     // If we work this many times during the trial period, then we will replan the
     // query from scratch.
@@ -170,6 +171,11 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
            << redact(_canonicalQuery->toStringShort())
            << " plan summary before replan: " << redact(Explain::getPlanSummary(child().get()));
 
+    // Let the cache know how far the evicted plan got, so that a shape which flips back and forth
+    // between plans gets more room before its next eviction.
+    PlanCache* cache = _collection->infoCache()->getPlanCache();
+    cache->recordReplan(*_canonicalQuery, maxWorksBeforeReplan).ignore();
+
     const bool shouldCache = true;
     return replan(yieldPolicy, shouldCache);
 }
@@ -234,6 +234,12 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
     }
 }
 
+PlanStage::StageState CollectionScan::doWorkBatch(size_t maxBatchSize,
+                                                  std::vector<WorkingSetID>* batch,
+                                                  WorkingSetID* out) {
+    return doWorkBatchUsingDoWork(_workingSet, maxBatchSize, batch, out);
+}
+
 bool CollectionScan::isEOF() {
     return _commonStats.isEOF || _isDead;
 }
@@ -56,6 +56,9 @@ public:
                    const MatchExpression* filter);
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
     bool isEOF() final;
 
     void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
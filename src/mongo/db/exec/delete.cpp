@@ -32,6 +32,8 @@
 
 #include "mongo/db/exec/delete.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
@@ -40,9 +42,11 @@
 #include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -66,6 +70,15 @@ bool shouldRestartDeleteIfNoLongerMatches(const DeleteStageParams& params) {
     return params.returnDeleted && !params.sort.isEmpty();
 };
 
+/**
+ * Returns true if the documents to delete can be buffered and deleted in batches. Only a multi
+ * delete which doesn't return what it deleted can batch. Batching also relies on re-fetching a
+ * buffered document after a yield, rather than on invalidations, to notice that it changed.
+ */
+bool canBatchDeletes(const DeleteStageParams& params) {
+    return params.isMulti && !params.returnDeleted && !params.isExplain && supportsDocLocking();
+}
+
 }  // namespace
 
 // static
@@ -81,7 +94,10 @@ DeleteStage::DeleteStage(OperationContext* opCtx,
       _ws(ws),
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
-      _idReturning(WorkingSet::INVALID_ID) {
+      _idReturning(WorkingSet::INVALID_ID),
+      _batchSize(canBatchDeletes(params)
+                     ? std::max(1, internalQueryExecDeleteBatchSize.load())
+                     : 1) {
     _children.emplace_back(child);
 }
 
@@ -92,8 +108,11 @@ bool DeleteStage::isEOF() {
     if (!_params.isMulti && _specificStats.docsDeleted > 0) {
         return true;
     }
+    if (_params.limit > 0 && static_cast<long long>(_specificStats.docsDeleted) >= _params.limit) {
+        return true;
+    }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
-        child()->isEOF();
+        _pendingDeletes.empty() && child()->isEOF();
 }
 
 PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
@@ -116,6 +135,11 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
+    if (_retryingFlush) {
+        _retryingFlush = false;
+        return flushPendingDeletes(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     if (_idRetrying != WorkingSet::INVALID_ID) {
@@ -144,6 +168,9 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
                 return status;
 
             case PlanStage::IS_EOF:
+                if (!_pendingDeletes.empty()) {
+                    return flushPendingDeletes(out);
+                }
                 return status;
 
             default:
@@ -154,6 +181,27 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     // We advanced, or are retrying, and id is set to the WSM to work on.
     WorkingSetMember* member = _ws->get(id);
 
+    if (_batchSize > 1) {
+        if (!member->hasRecordId()) {
+            ++_specificStats.nInvalidateSkips;
+            _ws->free(id);
+            return PlanStage::NEED_TIME;
+        }
+        invariant(member->hasObj());
+
+        // The document is only checked against the query when the batch is deleted. Own it now,
+        // since our child may reuse the memory it points to as soon as it moves on.
+        member->makeObjOwnedIfNeeded();
+        _pendingDeletes.push_back(id);
+        const bool reachedLimit = _params.limit > 0 &&
+            static_cast<long long>(_specificStats.docsDeleted + _pendingDeletes.size()) >=
+                _params.limit;
+        if (_pendingDeletes.size() < _batchSize && !reachedLimit) {
+            return PlanStage::NEED_TIME;
+        }
+        return flushPendingDeletes(out);
+    }
+
     // We want to free this member when we return, unless we need to retry deleting or returning it.
     ScopeGuard memberFreer = MakeGuard(&WorkingSet::free, _ws, id);
 
@@ -296,6 +344,69 @@ long long DeleteStage::getNumDeleted(const PlanExecutor& exec) {
     return deleteStats->docsDeleted;
 }
 
+PlanStage::StageState DeleteStage::flushPendingDeletes(WorkingSetID* out) {
+    // Ensure each document still exists and matches the predicate. A buffered document is
+    // re-fetched if we have yielded since it was buffered. A document our child returned twice is
+    // only deleted once.
+    std::vector<RecordId> recordIds;
+    recordIds.reserve(_pendingDeletes.size());
+    stdx::unordered_set<RecordId, RecordId::Hasher> seen;
+    try {
+        for (auto id : _pendingDeletes) {
+            if (!write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                continue;
+            }
+            const RecordId& recordId = _ws->get(id)->recordId;
+            if (seen.insert(recordId).second) {
+                recordIds.push_back(recordId);
+            }
+        }
+    } catch (const WriteConflictException&) {
+        _retryingFlush = true;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    if (!recordIds.empty()) {
+        try {
+            WriteUnitOfWork wunit(getOpCtx());
+            _collection->deleteDocuments(
+                getOpCtx(), _params.stmtId, recordIds, _params.opDebug, _params.fromMigrate);
+            wunit.commit();
+        } catch (const WriteConflictException&) {
+            // Keep the buffered members so we can retry deleting them.
+            _retryingFlush = true;
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+    }
+    _specificStats.docsDeleted += recordIds.size();
+
+    for (auto id : _pendingDeletes) {
+        _ws->free(id);
+    }
+    _pendingDeletes.clear();
+
+    // As in the unbatched case, restore our child outside of the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // The deletes have already been committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 PlanStage::StageState DeleteStage::prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out) {
     _idRetrying = idToRetry;
     *out = WorkingSet::INVALID_ID;
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/logical_session_id.h"
@@ -73,6 +75,9 @@ struct DeleteStageParams {
 
     // Optional. When not null, delete metrics are recorded here.
     OpDebug* opDebug;
+
+    // If positive, a multi delete stops after deleting this many documents.
+    long long limit = 0;
 };
 
 /**
@@ -122,6 +127,14 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Deletes the documents buffered in '_pendingDeletes' which still exist and match the query,
+     * all in one WriteUnitOfWork. If that hits a WriteConflictException, the buffered documents
+     * are kept, '_retryingFlush' is set and NEED_YIELD is returned so that the flush is retried on
+     * the next call to work().
+     */
+    StageState flushPendingDeletes(WorkingSetID* out);
+
     DeleteStageParams _params;
 
     // Not owned by us.
@@ -138,6 +151,17 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // The most documents to buffer before deleting them together. A value of 1 means documents are
+    // deleted one at a time, as they arrive from the child.
+    size_t _batchSize;
+
+    // Documents from the child waiting to be deleted as a batch, in the order they arrived.
+    std::vector<WorkingSetID> _pendingDeletes;
+
+    // True if deleting '_pendingDeletes' failed with a write conflict and has to be retried before
+    // asking our child for anything else.
+    bool _retryingFlush = false;
+
     // Stats
     DeleteStats _specificStats;
 };
@@ -71,7 +71,7 @@ bool FetchStage::isEOF() {
         return false;
     }
 
-    return child()->isEOF();
+    return !hasBufferedIds() && child()->isEOF();
 }
 
 PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
@@ -79,58 +79,23 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    // Either retry the last WSM we worked on or get a new one from our child.
+    // Either retry the last WSM we worked on, take one left over from a batch, or get a new one
+    // from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (hasBufferedIds()) {
+        status = ADVANCED;
+        id = _bufferedIds[_nextBufferedId++];
+    } else {
+        status = child()->work(&id);
     }
 
     if (PlanStage::ADVANCED == status) {
-        WorkingSetMember* member = _ws->get(id);
-
-        // If there's an obj there, there is no fetching to perform.
-        if (member->hasObj()) {
-            ++_specificStats.alreadyHasObj;
-        } else {
-            // We need a valid RecordId to fetch from and this is the only state that has one.
-            verify(WorkingSetMember::RID_AND_IDX == member->getState());
-            verify(member->hasRecordId());
-
-            try {
-                if (!_cursor)
-                    _cursor = _collection->getCursor(getOpCtx());
-
-                if (auto fetcher = _cursor->fetcherForId(member->recordId)) {
-                    // There's something to fetch. Hand the fetcher off to the WSM, and pass up
-                    // a fetch request.
-                    _idRetrying = id;
-                    member->setFetcher(fetcher.release());
-                    *out = id;
-                    return NEED_YIELD;
-                }
-
-                // The doc is already in memory, so go ahead and grab it. Now we have a RecordId
-                // as well as an unowned object
-                if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
-                    _ws->free(id);
-                    return NEED_TIME;
-                }
-            } catch (const WriteConflictException&) {
-                // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
-                // be freed when we yield.
-                member->makeObjOwnedIfNeeded();
-                _idRetrying = id;
-                *out = WorkingSet::INVALID_ID;
-                return NEED_YIELD;
-            }
-        }
-
-        return returnIfMatches(member, id, out);
+        return fetchAndFilter(id, out);
     } else if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
         // The stage which produces a failure is responsible for allocating a working set member
         // with error details.
@@ -144,9 +109,117 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatch(size_t maxBatchSize,
+                                              std::vector<WorkingSetID>* batch,
+                                              WorkingSetID* out) {
+    if (isEOF()) {
+        ++_commonStats.works;
+        return PlanStage::IS_EOF;
+    }
+
+    if (_idRetrying == WorkingSet::INVALID_ID && !hasBufferedIds()) {
+        _bufferedIds.clear();
+        _nextBufferedId = 0;
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState status = child()->workBatch(maxBatchSize, &_bufferedIds, &id);
+        if (PlanStage::ADVANCED != status) {
+            ++_commonStats.works;
+            if (PlanStage::NEED_TIME == status) {
+                ++_commonStats.needTime;
+            }
+            *out = id;
+            return status;
+        }
+    }
+
+    const size_t sizeBefore = batch->size();
+    for (size_t i = 0; i < maxBatchSize; ++i) {
+        WorkingSetID id;
+        if (_idRetrying != WorkingSet::INVALID_ID) {
+            id = _idRetrying;
+            _idRetrying = WorkingSet::INVALID_ID;
+        } else if (hasBufferedIds()) {
+            id = _bufferedIds[_nextBufferedId++];
+        } else {
+            break;
+        }
+
+        // Fetching the next document repositions '_cursor', which the previous result may point
+        // into.
+        if (batch->size() > sizeBefore) {
+            _ws->get(batch->back())->makeObjOwnedIfNeeded();
+        }
+
+        ++_commonStats.works;
+
+        WorkingSetID result = WorkingSet::INVALID_ID;
+        StageState status = fetchAndFilter(id, &result);
+        if (PlanStage::ADVANCED == status) {
+            batch->push_back(result);
+        } else if (PlanStage::NEED_TIME == status) {
+            ++_commonStats.needTime;
+        } else {
+            invariant(PlanStage::NEED_YIELD == status);
+            *out = result;
+            return status;
+        }
+    }
+
+    return batch->size() > sizeBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
+PlanStage::StageState FetchStage::fetchAndFilter(WorkingSetID id, WorkingSetID* out) {
+    WorkingSetMember* member = _ws->get(id);
+
+    // If there's an obj there, there is no fetching to perform.
+    if (member->hasObj()) {
+        ++_specificStats.alreadyHasObj;
+    } else {
+        // We need a valid RecordId to fetch from and this is the only state that has one.
+        verify(WorkingSetMember::RID_AND_IDX == member->getState());
+        verify(member->hasRecordId());
+
+        try {
+            if (!_cursor)
+                _cursor = _collection->getCursor(getOpCtx());
+
+            if (auto fetcher = _cursor->fetcherForId(member->recordId)) {
+                // There's something to fetch. Hand the fetcher off to the WSM, and pass up
+                // a fetch request.
+                _idRetrying = id;
+                member->setFetcher(fetcher.release());
+                *out = id;
+                return NEED_YIELD;
+            }
+
+            // The doc is already in memory, so go ahead and grab it. Now we have a RecordId
+            // as well as an unowned object
+            if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
+                _ws->free(id);
+                return NEED_TIME;
+            }
+        } catch (const WriteConflictException&) {
+            // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
+            // be freed when we yield.
+            member->makeObjOwnedIfNeeded();
+            _idRetrying = id;
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+    }
+
+    return returnIfMatches(member, id, out);
+}
+
 void FetchStage::doSaveState() {
     if (_cursor)
         _cursor->saveUnpositioned();
+
+    // Buffered results may point into our child's storage, which can go away while we're saved.
+    for (size_t i = _nextBufferedId; i < _bufferedIds.size(); ++i) {
+        _ws->get(_bufferedIds[i])->makeObjOwnedIfNeeded();
+    }
 }
 
 void FetchStage::doRestoreState() {
@@ -174,6 +247,14 @@ void FetchStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inval
             WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
         }
     }
+
+    // The same goes for any results buffered from our child.
+    for (size_t i = _nextBufferedId; i < _bufferedIds.size(); ++i) {
+        WorkingSetMember* member = _ws->get(_bufferedIds[i]);
+        if (member->hasRecordId() && (member->recordId == dl)) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+        }
+    }
 }
 
 PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
@@ -59,6 +60,9 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
 
     void doSaveState() final;
     void doRestoreState() final;
@@ -77,6 +81,20 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Fetches the document for the member with id 'id' if it doesn't have one already and passes
+     * it through our filter. Returns ADVANCED, NEED_TIME or NEED_YIELD with the same meaning as
+     * doWork().
+     */
+    StageState fetchAndFilter(WorkingSetID id, WorkingSetID* out);
+
+    /**
+     * Returns true if there are results left over from the last batch obtained from our child.
+     */
+    bool hasBufferedIds() const {
+        return _nextBufferedId < _bufferedIds.size();
+    }
+
     /**
      * If the member (with id memberID) passes our filter, set *out to memberID and return that
      * ADVANCED.  Otherwise, free memberID and return NEED_TIME.
@@ -98,6 +116,11 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // Results obtained from our child by doWorkBatch() that we haven't fetched yet. The ones
+    // before '_nextBufferedId' have already been consumed.
+    std::vector<WorkingSetID> _bufferedIds;
+    size_t _nextBufferedId = 0;
+
     // Stats
     FetchStats _specificStats;
 };
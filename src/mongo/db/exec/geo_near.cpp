@@ -71,6 +71,26 @@ static const double kMetersPerDegreeAtEquator = kCircOfEarthInMeters / 360;
 
 namespace {
 
+/**
+ * Returns the width of the next annulus to search, given the width 'boundsIncrement' of the last
+ * annulus searched and its stats.
+ */
+double nextBoundsIncrement(double boundsIncrement, const IntervalStats& lastIntervalStats) {
+    if (lastIntervalStats.numResultsBuffered == 0) {
+        // Nothing at all was found in the last annulus, as happens when searching out from a dense
+        // area into a sparse one. Rather than searching the empty annuli beyond it one at a time,
+        // each with its own index scan, cover the next few with a single wider scan.
+        return boundsIncrement * 4;
+    }
+
+    // TODO: Generally we want small numbers of results fast, then larger numbers later
+    if (lastIntervalStats.numResultsReturned < 300)
+        return boundsIncrement * 2;
+    else if (lastIntervalStats.numResultsReturned > 600)
+        return boundsIncrement / 2;
+    return boundsIncrement;
+}
+
 /**
  * Structure that holds BSON addresses (BSONElements) and the corresponding geometry parsed
  * at those locations.
@@ -609,13 +629,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement =
+            nextBoundsIncrement(_boundsIncrement, _specificStats.intervalStats.back());
     }
 
     _boundsIncrement =
@@ -1042,13 +1057,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement =
+            nextBoundsIncrement(_boundsIncrement, _specificStats.intervalStats.back());
     }
 
     invariant(_boundsIncrement > 0.0);
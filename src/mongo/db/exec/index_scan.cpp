@@ -66,7 +66,8 @@ IndexScan::IndexScan(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _workingSet(workingSet),
       _iam(params.descriptor->getIndexCatalog()->getIndex(params.descriptor)),
-      _keyPattern(params.descriptor->keyPattern().getOwned()),
+      _keyPattern(params.keyPattern.isEmpty() ? params.descriptor->keyPattern().getOwned()
+                                              : params.keyPattern.getOwned()),
       _scanState(INITIALIZING),
       _filter(filter),
       _shouldDedup(true),
@@ -155,7 +156,7 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
         // In debug mode, check that the cursor isn't lying to us.
         if (kDebugBuild && !_startKey.isEmpty()) {
             int cmp = kv->key.woCompare(_startKey,
-                                        Ordering::make(_params.descriptor->keyPattern()),
+                                        Ordering::make(_keyPattern),
                                         /*compareFieldNames*/ false);
             if (cmp == 0)
                 dassert(_startKeyInclusive);
@@ -164,7 +165,7 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
 
         if (kDebugBuild && !_endKey.isEmpty()) {
             int cmp = kv->key.woCompare(_endKey,
-                                        Ordering::make(_params.descriptor->keyPattern()),
+                                        Ordering::make(_keyPattern),
                                         /*compareFieldNames*/ false);
             if (cmp == 0)
                 dassert(_endKeyInclusive);
@@ -236,6 +237,12 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+PlanStage::StageState IndexScan::doWorkBatch(size_t maxBatchSize,
+                                             std::vector<WorkingSetID>* batch,
+                                             WorkingSetID* out) {
+    return doWorkBatchUsingDoWork(_workingSet, maxBatchSize, batch, out);
+}
+
 bool IndexScan::isEOF() {
     return _commonStats.isEOF;
 }
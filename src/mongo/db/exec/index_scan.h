@@ -51,6 +51,10 @@ struct IndexScanParams {
 
     const IndexDescriptor* descriptor;
 
+    // The key pattern which 'bounds' refer to. Empty means the descriptor's key pattern, which only
+    // differs for indexes whose keys don't follow it, like wildcard indexes.
+    BSONObj keyPattern;
+
     IndexBounds bounds;
 
     int direction;
@@ -96,6 +100,9 @@ public:
               const MatchExpression* filter);
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
     bool isEOF() final;
     void doSaveState() final;
     void doRestoreState() final;
@@ -26,6 +26,8 @@
  *    it in the license file.
  */
 
+#include <algorithm>
+
 #include "mongo/db/exec/limit.h"
 
 #include "mongo/db/exec/scoped_timer.h"
@@ -78,6 +80,35 @@ PlanStage::StageState LimitStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState LimitStage::doWorkBatch(size_t maxBatchSize,
+                                              std::vector<WorkingSetID>* batch,
+                                              WorkingSetID* out) {
+    if (0 == _numToReturn) {
+        ++_commonStats.works;
+        return PlanStage::IS_EOF;
+    }
+
+    // Never ask our child for more results than we are going to return.
+    const size_t sizeBefore = batch->size();
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(
+        std::min(maxBatchSize, static_cast<size_t>(_numToReturn)), batch, &id);
+
+    if (PlanStage::ADVANCED == status) {
+        const size_t numAdvanced = batch->size() - sizeBefore;
+        _commonStats.works += numAdvanced;
+        _numToReturn -= numAdvanced;
+        return status;
+    }
+
+    ++_commonStats.works;
+    if (PlanStage::NEED_TIME == status) {
+        ++_commonStats.needTime;
+    }
+    *out = id;
+    return status;
+}
+
 unique_ptr<PlanStageStats> LimitStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_LIMIT);
@@ -205,10 +205,12 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // Adds the amount of time taken by pickBestPlan() to executionTimeMillis. There's lots of
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedCycleTimer timer(
+        1, &_commonStats.executionTimeTicks, &_commonStats.executionTimeMillis);
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
+    const size_t pruneWorks = std::max(0, internalQueryPlanEvaluationPruneWorks.load());
 
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
@@ -217,6 +219,10 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
         if (!moreToDo) {
             break;
         }
+
+        if (pruneWorks > 0 && ix + 1 == pruneWorks) {
+            pruneUnproductivePlans();
+        }
     }
 
     if (_failure) {
@@ -342,7 +348,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.pruned) {
             continue;
         }
 
@@ -410,6 +416,25 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+void MultiPlanStage::pruneUnproductivePlans() {
+    const bool anyProductive =
+        std::any_of(_candidates.begin(), _candidates.end(), [](const CandidatePlan& candidate) {
+            return !candidate.failed && !candidate.results.empty();
+        });
+    if (!anyProductive) {
+        return;
+    }
+
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        CandidatePlan& candidate = _candidates[ix];
+        if (!candidate.failed && candidate.results.empty()) {
+            LOG(5) << "Pruning candidate " << ix << " which produced no results during the first "
+                   << internalQueryPlanEvaluationPruneWorks.load() << " works";
+            candidate.pruned = true;
+        }
+    }
+}
+
 namespace {
 
 void invalidateHelper(OperationContext* opCtx,
@@ -168,6 +168,14 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Stops working the candidate plans which haven't produced a result yet, provided that some
+     * other candidate has. Since all candidates do the same amount of work during the trial
+     * period, such plans are very unlikely to be ranked best, and working them only delays the
+     * end of the trial.
+     */
+    void pruneUnproductivePlans();
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -34,16 +34,38 @@
 
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 
 namespace mongo {
 
+namespace {
+
+/**
+ * Returns the weight to time the next call into a stage with, given how many calls it has had so
+ * far: with a sample interval of N, one call in N is timed and stands in for the other N - 1.
+ */
+long long timerWeight(size_t works) {
+    const long long interval = internalQueryExecStageTimingSampleInterval.load();
+    if (interval <= 1) {
+        return 1;
+    }
+    return (works % interval) == 0 ? interval : 0;
+}
+
+}  // namespace
+
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedCycleTimer timer(timerWeight(_commonStats.works),
+                           &_commonStats.executionTimeTicks,
+                           &_commonStats.executionTimeMillis);
     ++_commonStats.works;
 
-    StageState workResult = doWork(out);
+    StageState workResult;
+    if (!takeDeferredState(&workResult, out)) {
+        workResult = doWork(out);
+    }
 
     if (StageState::ADVANCED == workResult) {
         ++_commonStats.advanced;
@@ -56,6 +78,109 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     return workResult;
 }
 
+PlanStage::StageState PlanStage::workBatch(size_t maxBatchSize,
+                                           std::vector<WorkingSetID>* batch,
+                                           WorkingSetID* out) {
+    invariant(_opCtx);
+    invariant(maxBatchSize > 0);
+    ScopedCycleTimer timer(timerWeight(_commonStats.works),
+                           &_commonStats.executionTimeTicks,
+                           &_commonStats.executionTimeMillis);
+
+    StageState workResult;
+    if (takeDeferredState(&workResult, out)) {
+        ++_commonStats.works;
+        if (StageState::NEED_YIELD == workResult) {
+            ++_commonStats.needYield;
+        }
+        return workResult;
+    }
+
+    const size_t sizeBefore = batch->size();
+    WorkingSetID stateResult = WorkingSet::INVALID_ID;
+    workResult = doWorkBatch(maxBatchSize, batch, &stateResult);
+    const size_t numAdvanced = batch->size() - sizeBefore;
+    _commonStats.advanced += numAdvanced;
+
+    if (numAdvanced > 0) {
+        if (StageState::ADVANCED != workResult && StageState::NEED_TIME != workResult) {
+            _hasDeferredState = true;
+            _deferredState = workResult;
+            _deferredResult = stateResult;
+        }
+        return StageState::ADVANCED;
+    }
+
+    invariant(StageState::ADVANCED != workResult);
+    if (StageState::NEED_YIELD == workResult) {
+        ++_commonStats.needYield;
+    }
+    *out = stateResult;
+    return workResult;
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(size_t maxBatchSize,
+                                             std::vector<WorkingSetID>* batch,
+                                             WorkingSetID* out) {
+    for (size_t i = 0; i < maxBatchSize; ++i) {
+        ++_commonStats.works;
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = doWork(&id);
+        if (StageState::ADVANCED == state) {
+            batch->push_back(id);
+            return state;
+        } else if (StageState::NEED_TIME != state) {
+            *out = id;
+            return state;
+        }
+
+        ++_commonStats.needTime;
+    }
+
+    return StageState::NEED_TIME;
+}
+
+PlanStage::StageState PlanStage::doWorkBatchUsingDoWork(WorkingSet* ws,
+                                                         size_t maxBatchSize,
+                                                         std::vector<WorkingSetID>* batch,
+                                                         WorkingSetID* out) {
+    const size_t sizeBefore = batch->size();
+    for (size_t i = 0; i < maxBatchSize; ++i) {
+        // Producing another result may reposition the cursor the previous one points into.
+        if (batch->size() > sizeBefore) {
+            ws->get(batch->back())->makeObjOwnedIfNeeded();
+        }
+
+        ++_commonStats.works;
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = doWork(&id);
+        if (StageState::ADVANCED == state) {
+            batch->push_back(id);
+        } else if (StageState::NEED_TIME == state) {
+            ++_commonStats.needTime;
+        } else {
+            *out = id;
+            return state;
+        }
+    }
+
+    return batch->size() > sizeBefore ? StageState::ADVANCED : StageState::NEED_TIME;
+}
+
+bool PlanStage::takeDeferredState(StageState* state, WorkingSetID* out) {
+    if (!_hasDeferredState) {
+        return false;
+    }
+
+    _hasDeferredState = false;
+    *state = _deferredState;
+    *out = _deferredResult;
+    _deferredResult = WorkingSet::INVALID_ID;
+    return true;
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
@@ -188,6 +188,27 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Batch-at-a-time counterpart to work(). Performs at most 'maxBatchSize' units of work and
+     * appends every result produced along the way to 'batch'. The caller owns each appended
+     * WorkingSetID exactly as if it had been returned by work(), and must free them from the
+     * working set when done with them.
+     *
+     * Returns ADVANCED if at least one result was appended. Otherwise 'batch' is left untouched
+     * and the return value and '*out' have the same meaning as for work(). If a stage encounters
+     * a state other than ADVANCED or NEED_TIME after it has already produced results, the results
+     * are handed back first and that state is returned by the next call to work() or workBatch().
+     *
+     * Every appended result except the last one remains valid across subsequent calls to this
+     * stage. The last one has the same lifetime as a result returned by work().
+     *
+     * Stages that do not override doWorkBatch() fall back to calling doWork() until they produce
+     * a single result, so it is always safe to call workBatch() on any stage. It is legal to
+     * interleave calls to work() and workBatch() on the same stage. PlanExecutor::getNext() drives
+     * the root stage through workBatch() and buffers the results it doesn't return right away.
+     */
+    StageState workBatch(size_t maxBatchSize, std::vector<WorkingSetID>* batch, WorkingSetID* out);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -347,6 +368,27 @@ protected:
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxBatchSize' units of work, appending results to 'batch'. See the comment
+     * at workBatch() above.
+     *
+     * Unlike doWork(), implementations are responsible for incrementing '_commonStats.works' once
+     * per unit of work and '_commonStats.needTime' once per unit of work that did not produce a
+     * result; workBatch() accounts for 'advanced' and 'needYield'. Implementations may return a
+     * state other than ADVANCED or NEED_TIME after appending results to 'batch', in which case
+     * workBatch() takes care of deferring that state to the next call.
+     *
+     * Implementations must make sure that every appended result other than the last one remains
+     * valid, e.g. by calling makeObjOwnedIfNeeded() on a member before repositioning the cursor
+     * that produced it.
+     *
+     * The default implementation calls doWork() until it produces one result, reaches
+     * 'maxBatchSize' units of work, or reaches any other state.
+     */
+    virtual StageState doWorkBatch(size_t maxBatchSize,
+                                   std::vector<WorkingSetID>* batch,
+                                   WorkingSetID* out);
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -386,6 +428,16 @@ protected:
      */
     virtual void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) {}
 
+    /**
+     * Helper for stages whose doWork() produces a result without consulting any other stage
+     * (e.g. scans). Calls doWork() up to 'maxBatchSize' times, accounting for stats as described
+     * at doWorkBatch() and making every result but the last one owned.
+     */
+    StageState doWorkBatchUsingDoWork(WorkingSet* ws,
+                                      size_t maxBatchSize,
+                                      std::vector<WorkingSetID>* batch,
+                                      WorkingSetID* out);
+
     ClockSource* getClock() const;
 
     OperationContext* getOpCtx() const {
@@ -396,7 +448,19 @@ protected:
     CommonStats _commonStats;
 
 private:
+    /**
+     * If a previous call to workBatch() deferred a state, returns true and sets '*state' and
+     * '*out' to the deferred values, clearing them.
+     */
+    bool takeDeferredState(StageState* state, WorkingSetID* out);
+
     OperationContext* _opCtx;
+
+    // A state reached by doWorkBatch() after it had already produced results, to be returned
+    // from the next call to work() or workBatch(). Only meaningful if '_hasDeferredState' is true.
+    bool _hasDeferredState = false;
+    StageState _deferredState = ADVANCED;
+    WorkingSetID _deferredResult = WorkingSet::INVALID_ID;
 };
 
 }  // namespace mongo
@@ -0,0 +1,228 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+//
+// This file contains tests for the batch-at-a-time PlanStage::workBatch() protocol.
+//
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/exec/limit.h"
+#include "mongo/db/exec/projection.h"
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/skip.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/json.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+using namespace mongo;
+
+namespace {
+
+using stdx::make_unique;
+
+class PlanStageBatchTest : public unittest::Test {
+public:
+    PlanStageBatchTest() {
+        _service = stdx::make_unique<ServiceContextNoop>();
+        _service->setFastClockSource(stdx::make_unique<ClockSourceMock>());
+        _client = _service->makeClient("test");
+        _opCtxNoop = _client->makeOperationContext();
+        _opCtx = _opCtxNoop.get();
+    }
+
+protected:
+    OperationContext* getOpCtx() {
+        return _opCtx;
+    }
+
+    /**
+     * Returns a QueuedDataStage which produces the documents {a: 0}, ..., {a: numDocs - 1}.
+     */
+    std::unique_ptr<QueuedDataStage> makeSource(WorkingSet* ws, int numDocs) {
+        auto source = make_unique<QueuedDataStage>(getOpCtx(), ws);
+        for (int i = 0; i < numDocs; ++i) {
+            source->pushBack(makeMember(ws, BSON("a" << i << "b" << i)));
+        }
+        return source;
+    }
+
+    WorkingSetID makeMember(WorkingSet* ws, BSONObj obj) {
+        WorkingSetID id = ws->allocate();
+        WorkingSetMember* member = ws->get(id);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), obj);
+        member->transitionToOwnedObj();
+        return id;
+    }
+
+private:
+    OperationContext* _opCtx;
+
+    // Members of a class are destroyed in reverse order of declaration.
+    // The UniqueClient must be destroyed before the ServiceContextNoop is destroyed.
+    // The OperationContextNoop must be destroyed before the UniqueClient is destroyed.
+    std::unique_ptr<ServiceContextNoop> _service;
+    ServiceContext::UniqueClient _client;
+    ServiceContext::UniqueOperationContext _opCtxNoop;
+};
+
+TEST_F(PlanStageBatchTest, LeafStageFillsWholeBatch) {
+    WorkingSet ws;
+    auto source = makeSource(&ws, 5);
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, source->workBatch(3, &batch, &out));
+    ASSERT_EQUALS(3U, batch.size());
+    ASSERT_EQUALS(PlanStage::ADVANCED, source->workBatch(3, &batch, &out));
+    ASSERT_EQUALS(5U, batch.size());
+    ASSERT_EQUALS(PlanStage::IS_EOF, source->workBatch(3, &batch, &out));
+    ASSERT_EQUALS(5U, batch.size());
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(BSON("a" << static_cast<int>(i) << "b" << static_cast<int>(i)),
+                          ws.get(batch[i])->obj.value());
+    }
+
+    // The second batch reached EOF after two results, and that EOF was handed back by the third
+    // call, which counts as a unit of work of its own.
+    const CommonStats* stats = source->getCommonStats();
+    ASSERT_EQUALS(7U, stats->works);
+    ASSERT_EQUALS(5U, stats->advanced);
+    ASSERT_EQUALS(0U, stats->needTime);
+}
+
+TEST_F(PlanStageBatchTest, NeedTimeCountsTowardsBatchSize) {
+    WorkingSet ws;
+    auto source = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    source->pushBack(PlanStage::NEED_TIME);
+    source->pushBack(PlanStage::NEED_TIME);
+    source->pushBack(makeMember(&ws, BSON("a" << 1)));
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::NEED_TIME, source->workBatch(2, &batch, &out));
+    ASSERT(batch.empty());
+    ASSERT_EQUALS(PlanStage::ADVANCED, source->workBatch(2, &batch, &out));
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_EQUALS(2U, source->getCommonStats()->needTime);
+}
+
+TEST_F(PlanStageBatchTest, StateAfterResultsIsDeferredToNextCall) {
+    WorkingSet ws;
+    auto source = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    source->pushBack(makeMember(&ws, BSON("a" << 1)));
+    source->pushBack(makeMember(&ws, BSON("a" << 2)));
+    source->pushBack(PlanStage::FAILURE);
+    source->pushBack(makeMember(&ws, BSON("a" << 3)));
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, source->workBatch(10, &batch, &out));
+    ASSERT_EQUALS(2U, batch.size());
+    ASSERT_EQUALS(WorkingSet::INVALID_ID, out);
+
+    // The deferred state is also returned by a call to work().
+    ASSERT_EQUALS(PlanStage::FAILURE, source->work(&out));
+    ASSERT_NOT_EQUALS(WorkingSet::INVALID_ID, out);
+
+    ASSERT_EQUALS(PlanStage::ADVANCED, source->workBatch(10, &batch, &out));
+    ASSERT_EQUALS(3U, batch.size());
+}
+
+TEST_F(PlanStageBatchTest, LimitNeverExceedsLimit) {
+    WorkingSet ws;
+    auto limit = make_unique<LimitStage>(getOpCtx(), 4, &ws, makeSource(&ws, 10).release());
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, limit->workBatch(3, &batch, &out));
+    ASSERT_EQUALS(3U, batch.size());
+    ASSERT_EQUALS(PlanStage::ADVANCED, limit->workBatch(3, &batch, &out));
+    ASSERT_EQUALS(4U, batch.size());
+    ASSERT_EQUALS(PlanStage::IS_EOF, limit->workBatch(3, &batch, &out));
+    ASSERT_TRUE(limit->isEOF());
+    ASSERT_EQUALS(4U, limit->getCommonStats()->advanced);
+}
+
+TEST_F(PlanStageBatchTest, SkipDropsLeadingResults) {
+    WorkingSet ws;
+    auto skip = make_unique<SkipStage>(getOpCtx(), 3, &ws, makeSource(&ws, 5).release());
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::NEED_TIME, skip->workBatch(2, &batch, &out));
+    ASSERT(batch.empty());
+    ASSERT_EQUALS(PlanStage::ADVANCED, skip->workBatch(2, &batch, &out));
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 3 << "b" << 3), ws.get(batch[0])->obj.value());
+    ASSERT_EQUALS(PlanStage::ADVANCED, skip->workBatch(2, &batch, &out));
+    ASSERT_EQUALS(2U, batch.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 4 << "b" << 4), ws.get(batch[1])->obj.value());
+    ASSERT_EQUALS(PlanStage::IS_EOF, skip->workBatch(2, &batch, &out));
+}
+
+TEST_F(PlanStageBatchTest, ProjectionTransformsWholeBatch) {
+    WorkingSet ws;
+    ProjectionStageParams params;
+    params.projImpl = ProjectionStageParams::SIMPLE_DOC;
+    params.projObj = fromjson("{_id: 0, a: 1}");
+    auto proj =
+        make_unique<ProjectionStage>(getOpCtx(), params, &ws, makeSource(&ws, 4).release());
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, proj->workBatch(10, &batch, &out));
+    ASSERT_EQUALS(4U, batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(BSON("a" << static_cast<int>(i)), ws.get(batch[i])->obj.value());
+    }
+    ASSERT_EQUALS(PlanStage::IS_EOF, proj->workBatch(10, &batch, &out));
+}
+
+TEST_F(PlanStageBatchTest, WorkAndWorkBatchCanBeInterleaved) {
+    WorkingSet ws;
+    auto source = makeSource(&ws, 3);
+    auto limit = make_unique<LimitStage>(getOpCtx(), 10, &ws, source.release());
+
+    // Drive the tree with work() to check that mixing the two protocols is fine.
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, limit->work(&out));
+
+    std::vector<WorkingSetID> batch;
+    ASSERT_EQUALS(PlanStage::ADVANCED, limit->workBatch(10, &batch, &out));
+    ASSERT_EQUALS(2U, batch.size());
+}
+
+}  // namespace
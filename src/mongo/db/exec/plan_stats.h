@@ -65,6 +65,7 @@ struct CommonStats {
           needTime(0),
           needYield(0),
           executionTimeMillis(0),
+          executionTimeTicks(0),
           isEOF(false) {}
     // String giving the type of the stage. Not owned.
     const char* stageTypeStr;
@@ -87,6 +88,9 @@ struct CommonStats {
     // Time elapsed while working inside this stage.
     long long executionTimeMillis;
 
+    // The same time in CycleTickSource ticks, from which 'executionTimeMillis' is derived.
+    long long executionTimeTicks;
+
     // TODO: have some way of tracking WSM sizes (or really any series of #s).  We can measure
     // the size of our inputs and the size of our outputs.  We can do a lot with the WS here.
 
@@ -138,7 +142,15 @@ private:
 };
 
 struct AndHashStats : public SpecificStats {
-    AndHashStats() : flaggedButPassed(0), flaggedInProgress(0), memUsage(0), memLimit(0) {}
+    AndHashStats()
+        : flaggedButPassed(0),
+          flaggedInProgress(0),
+          memUsage(0),
+          memLimit(0),
+          filterTested(0),
+          filterRejected(0),
+          filterFalsePositives(0),
+          filterMemUsage(0) {}
 
     SpecificStats* clone() const final {
         AndHashStats* specific = new AndHashStats(*this);
@@ -163,8 +175,23 @@ struct AndHashStats : public SpecificStats {
     // What's our current memory usage?
     size_t memUsage;
 
+    // What's the most memory we have used at once?
+    size_t peakMemUsage = 0;
+
     // What's our memory limit?
     size_t memLimit;
+
+    // How many results from the children after the first were checked against the Bloom filter
+    // over the hashed RecordIds, and how many of those the filter rejected without probing the
+    // hash table?
+    size_t filterTested;
+    size_t filterRejected;
+
+    // How many results passed the filter but were not found in the hash table?
+    size_t filterFalsePositives;
+
+    // The size in bytes of the Bloom filter's bit array. Not included in 'memUsage'.
+    size_t filterMemUsage;
 };
 
 struct AndSortedStats : public SpecificStats {
@@ -513,7 +540,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), usedDisk(false) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -526,9 +553,24 @@ struct SortStats : public SpecificStats {
     // What's our current memory usage?
     size_t memUsage;
 
+    // What's the most memory we have used at once, counting the external sorter's buffer?
+    size_t peakMemUsage = 0;
+
     // What's our memory limit?
     size_t memLimit;
 
+    // Did we hand our buffered results over to the external sorter?
+    bool usedDisk;
+
+    // How many times did the external sorter write its buffer to disk?
+    size_t spills = 0;
+
+    // Bytes the external sorter wrote to disk, their size before compression, and the number of
+    // passes that merged spilled runs into larger ones before the final merge.
+    long long spilledBytes = 0;
+    long long spilledBytesUncompressed = 0;
+    int spillMergePasses = 0;
+
     // The number of results to return from the sort.
     size_t limit;
 
@@ -682,6 +724,14 @@ struct TextOrStats : public SpecificStats {
     }
 
     size_t fetches;
+
+    // The number of top scoring documents returned, or zero if the stage returns all of them.
+    size_t topK = 0;
+
+    // The memory held by the scores and documents buffered before results are returned, now and
+    // at most.
+    size_t memUsage = 0;
+    size_t peakMemUsage = 0;
 };
 
 }  // namespace mongo
@@ -94,6 +94,7 @@ ProjectionStage::ProjectionStage(OperationContext* opCtx,
                     // If we are including this key field store its field name.
                     _keyFieldNames.push_back(fieldIt->first);
                     _includeKey.push_back(true);
+                    _numKeyFieldsToRead = _includeKey.size();
                 }
             }
         } else {
@@ -130,14 +131,18 @@ void ProjectionStage::getSimpleInclusionFields(const BSONObj& projObj, FieldSet*
 void ProjectionStage::transformSimpleInclusion(const BSONObj& in,
                                                const FieldSet& includedFields,
                                                BSONObjBuilder& bob) {
-    // Look at every field in the source document and see if we're including it.
+    // Look at every field in the source document and see if we're including it. Field names are
+    // unique within a document, so we can stop as soon as every included field has been found
+    // rather than walking the remainder of a wide document.
+    size_t fieldsRemaining = includedFields.size();
     BSONObjIterator inputIt(in);
-    while (inputIt.more()) {
+    while (fieldsRemaining > 0 && inputIt.more()) {
         BSONElement elt = inputIt.next();
         auto fieldIt = includedFields.find(elt.fieldNameStringData());
         if (includedFields.end() != fieldIt) {
             // If so, add it to the builder.
             bob.append(elt);
+            --fieldsRemaining;
         }
     }
 }
@@ -148,8 +153,6 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
         return _exec->transform(member);
     }
 
-    BSONObjBuilder bob;
-
     // Note that even if our fast path analysis is bug-free something that is
     // covered might be invalidated and just be an obj.  In this case we just go
     // through the SIMPLE_DOC path which is still correct if the covered data
@@ -161,16 +164,27 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
         invariant(member->hasObj());
 
         // Apply the SIMPLE_DOC projection.
+        BSONObjBuilder bob;
         transformSimpleInclusion(member->obj.value(), _includedFields, bob);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), bob.obj());
     } else {
         invariant(ProjectionStageParams::COVERED_ONE_INDEX == _projImpl);
         // We're pulling data out of the key.
         invariant(1 == member->keyData.size());
+        const BSONObj& keyObj = member->keyData[0].keyData;
         size_t keyIndex = 0;
 
-        // Look at every key element...
-        BSONObjIterator keyIterator(member->keyData[0].keyData);
-        while (keyIterator.more()) {
+        // The output is at most the size of the key plus the field names of the included key
+        // fields, so size the builder accordingly rather than using the default buffer size.
+        int outputSize = keyObj.objsize();
+        for (auto&& fieldName : _keyFieldNames) {
+            outputSize += fieldName.size();
+        }
+        BSONObjBuilder bob(outputSize);
+
+        // Look at every key element up to the last one we include...
+        BSONObjIterator keyIterator(keyObj);
+        while (keyIndex < _numKeyFieldsToRead && keyIterator.more()) {
             BSONElement elt = keyIterator.next();
             // If we're supposed to include it...
             if (_includeKey[keyIndex]) {
@@ -179,11 +193,11 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
             }
             ++keyIndex;
         }
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), bob.obj());
     }
 
     member->keyData.clear();
     member->recordId = RecordId();
-    member->obj = Snapshotted<BSONObj>(SnapshotId(), bob.obj());
     member->transitionToOwnedObj();
     return Status::OK();
 }
@@ -221,6 +235,43 @@ PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::doWorkBatch(size_t maxBatchSize,
+                                                   std::vector<WorkingSetID>* batch,
+                                                   WorkingSetID* out) {
+    const size_t sizeBefore = batch->size();
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(maxBatchSize, batch, &id);
+
+    if (PlanStage::ADVANCED != status) {
+        ++_commonStats.works;
+        if (PlanStage::NEED_TIME == status) {
+            ++_commonStats.needTime;
+        }
+        *out = id;
+        return status;
+    }
+
+    _commonStats.works += batch->size() - sizeBefore;
+
+    // Every projected result is owned, so the whole batch stays valid after this loop.
+    for (size_t i = sizeBefore; i < batch->size(); ++i) {
+        Status projStatus = transform(_ws->get((*batch)[i]));
+        if (!projStatus.isOK()) {
+            warning() << "Couldn't execute projection, status = " << redact(projStatus);
+
+            // Hand back what was already projected and discard the rest of the batch.
+            for (size_t j = i; j < batch->size(); ++j) {
+                _ws->free((*batch)[j]);
+            }
+            batch->resize(i);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, projStatus);
+            return PlanStage::FAILURE;
+        }
+    }
+
+    return PlanStage::ADVANCED;
+}
+
 unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_PROJECTION);
@@ -82,6 +82,9 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
 
     StageType stageType() const final {
         return STAGE_PROJECTION;
@@ -144,6 +147,10 @@ private:
 
     // If the i-th entry of _includeKey is true this is the field name for the i-th key field.
     std::vector<StringData> _keyFieldNames;
+
+    // One past the position of the last key field which is included in the projection. Key
+    // fields at or after this position are never read.
+    size_t _numKeyFieldsToRead = 0;
 };
 
 }  // namespace mongo
@@ -70,6 +70,12 @@ PlanStage::StageState QueuedDataStage::doWork(WorkingSetID* out) {
     return state;
 }
 
+PlanStage::StageState QueuedDataStage::doWorkBatch(size_t maxBatchSize,
+                                                   std::vector<WorkingSetID>* batch,
+                                                   WorkingSetID* out) {
+    return doWorkBatchUsingDoWork(_ws, maxBatchSize, batch, out);
+}
+
 bool QueuedDataStage::isEOF() {
     return _results.empty();
 }
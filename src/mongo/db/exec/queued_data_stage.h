@@ -50,6 +50,9 @@ public:
     QueuedDataStage(OperationContext* opCtx, WorkingSet* ws);
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* batch,
+                           WorkingSetID* out) final;
 
     bool isEOF() final;
 
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A compact, approximate set of RecordIds. mayContain() never returns false for a RecordId that
+ * was added, but may return true for one that was not.
+ *
+ * Stages which buffer a large set of RecordIds in a hash table can consult the filter before
+ * probing the table: a negative answer only touches a small bit array, which is much more likely
+ * to stay in cache than the buckets of the hash table.
+ */
+class RecordIdBloomFilter {
+public:
+    // Bits allotted per expected element. Ten bits with seven probes gives a false positive rate
+    // of about 1%.
+    static const size_t kBitsPerElement = 10;
+    static const size_t kNumProbes = 7;
+
+    RecordIdBloomFilter() = default;
+
+    /**
+     * Discards the contents of the filter and sizes it to hold 'expectedElements' RecordIds.
+     */
+    void reset(size_t expectedElements) {
+        size_t numBits = 64;
+        while (numBits < expectedElements * kBitsPerElement) {
+            numBits <<= 1;
+        }
+        _words.assign(numBits / 64, 0);
+        _mask = numBits - 1;
+    }
+
+    void add(const RecordId& rid) {
+        uint64_t h1, h2;
+        hash(rid, &h1, &h2);
+        for (size_t i = 0; i < kNumProbes; ++i) {
+            const uint64_t bit = (h1 + i * h2) & _mask;
+            _words[bit >> 6] |= uint64_t(1) << (bit & 63);
+        }
+    }
+
+    /**
+     * Returns false if 'rid' was definitely not added to the filter. An empty (never reset)
+     * filter contains everything.
+     */
+    bool mayContain(const RecordId& rid) const {
+        if (_words.empty()) {
+            return true;
+        }
+        uint64_t h1, h2;
+        hash(rid, &h1, &h2);
+        for (size_t i = 0; i < kNumProbes; ++i) {
+            const uint64_t bit = (h1 + i * h2) & _mask;
+            if (!(_words[bit >> 6] & (uint64_t(1) << (bit & 63)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Returns the number of bytes used by the bit array.
+     */
+    size_t memUsage() const {
+        return _words.size() * sizeof(uint64_t);
+    }
+
+private:
+    /**
+     * Derives the two hashes used for double hashing from a 64-bit finalizer (splitmix64) of the
+     * RecordId. The second hash is forced odd so that the probes cover the whole power-of-two
+     * table.
+     */
+    static void hash(const RecordId& rid, uint64_t* h1, uint64_t* h2) {
+        uint64_t x = static_cast<uint64_t>(rid.repr()) + 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        x = x ^ (x >> 31);
+        *h1 = x;
+        *h2 = (x >> 32) | (x << 32) | 1;
+    }
+
+    std::vector<uint64_t> _words;
+    uint64_t _mask = 0;
+};
+
+}  // namespace mongo
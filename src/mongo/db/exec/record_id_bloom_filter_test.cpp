@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bloom_filter.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdBloomFilterTest, EmptyFilterContainsEverything) {
+    RecordIdBloomFilter filter;
+    ASSERT_TRUE(filter.mayContain(RecordId(1)));
+    ASSERT_EQUALS(0U, filter.memUsage());
+}
+
+TEST(RecordIdBloomFilterTest, ResetFilterContainsNothing) {
+    RecordIdBloomFilter filter;
+    filter.reset(10);
+    for (int i = 1; i <= 100; ++i) {
+        ASSERT_FALSE(filter.mayContain(RecordId(i)));
+    }
+}
+
+TEST(RecordIdBloomFilterTest, NoFalseNegatives) {
+    RecordIdBloomFilter filter;
+    filter.reset(1000);
+    for (int i = 1; i <= 1000; ++i) {
+        filter.add(RecordId(i * 7));
+    }
+    for (int i = 1; i <= 1000; ++i) {
+        ASSERT_TRUE(filter.mayContain(RecordId(i * 7)));
+    }
+}
+
+TEST(RecordIdBloomFilterTest, FalsePositiveRateIsLow) {
+    const int kNumElements = 10000;
+    RecordIdBloomFilter filter;
+    filter.reset(kNumElements);
+    for (int i = 1; i <= kNumElements; ++i) {
+        filter.add(RecordId(i));
+    }
+
+    int falsePositives = 0;
+    for (int i = kNumElements + 1; i <= 2 * kNumElements; ++i) {
+        if (filter.mayContain(RecordId(i))) {
+            ++falsePositives;
+        }
+    }
+
+    // The filter is sized for roughly a 1% false positive rate; allow plenty of slack.
+    ASSERT_LT(falsePositives, kNumElements / 20);
+}
+
+TEST(RecordIdBloomFilterTest, MemUsageRoundsUpToPowerOfTwoBits) {
+    RecordIdBloomFilter filter;
+    filter.reset(0);
+    ASSERT_EQUALS(8U, filter.memUsage());
+    filter.reset(100);
+    ASSERT_EQUALS(1024U / 8, filter.memUsage());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/util/clock_source.h"
+#include "mongo/util/cycle_tick_source.h"
 
 namespace mongo {
 
@@ -41,4 +42,23 @@ ScopedTimer::~ScopedTimer() {
     *_counter += elapsed;
 }
 
+ScopedCycleTimer::ScopedCycleTimer(long long weight, long long* ticks, long long* millis)
+    : _weight(weight), _ticks(ticks), _millis(millis) {
+    if (_weight) {
+        _start = CycleTickSource::now();
+    }
+}
+
+ScopedCycleTimer::~ScopedCycleTimer() {
+    if (!_weight) {
+        return;
+    }
+
+    // The tick rate is fixed once the global initializers have run.
+    static const double millisPerTick = 1000.0 / CycleTickSource::get()->getTicksPerSecond();
+
+    *_ticks += (CycleTickSource::now() - _start) * _weight;
+    *_millis = static_cast<long long>(*_ticks * millisPerTick);
+}
+
 }  // namespace mongo
@@ -57,4 +57,29 @@ private:
     const Date_t _start;
 };
 
+/**
+ * Times its scope with CycleTickSource and adds the elapsed ticks, multiplied by 'weight', to
+ * '*ticks'. '*millis' is then refreshed from the total tick count, so that callers can keep
+ * reporting milliseconds while the measurement keeps sub-millisecond precision.
+ *
+ * A weight of N lets a caller time only one in N calls and still produce an estimate of the
+ * total. A weight of zero disables the timer entirely, without reading the tick source.
+ */
+class ScopedCycleTimer {
+    MONGO_DISALLOW_COPYING(ScopedCycleTimer);
+
+public:
+    ScopedCycleTimer(long long weight, long long* ticks, long long* millis);
+
+    ~ScopedCycleTimer();
+
+private:
+    const long long _weight;
+    long long* const _ticks;
+    long long* const _millis;
+
+    // Tick count at which the timer was constructed. Only set if '_weight' is non-zero.
+    long long _start = 0;
+};
+
 }  // namespace mongo
@@ -56,6 +56,10 @@ ShardFilterStage::ShardFilterStage(OperationContext* opCtx,
                                    PlanStage* child)
     : PlanStage(kStageType, opCtx), _ws(ws), _metadata(std::move(metadata)) {
     _children.emplace_back(child);
+
+    if (_metadata) {
+        _shardKeyPattern = make_unique<ShardKeyPattern>(_metadata->getKeyPattern());
+    }
 }
 
 ShardFilterStage::~ShardFilterStage() {}
@@ -77,10 +81,9 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
         // including pending documents from in-progress migrations and orphaned documents from
         // aborted migrations
         if (_metadata) {
-            ShardKeyPattern shardKeyPattern(_metadata->getKeyPattern());
             WorkingSetMember* member = _ws->get(*out);
             WorkingSetMatchableDocument matchable(member);
-            BSONObj shardKey = shardKeyPattern.extractShardKeyFromMatchable(matchable);
+            BSONObj shardKey = _shardKeyPattern->extractShardKeyFromMatchable(matchable);
 
             if (shardKey.isEmpty()) {
                 // We can't find a shard key for this document - this should never happen with
@@ -106,7 +109,7 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
                           << "document may have been inserted manually into shard";
             }
 
-            if (!_metadata->keyBelongsToMe(shardKey)) {
+            if (!_keyBelongsToMe(shardKey)) {
                 _ws->free(*out);
                 ++_specificStats.chunkSkips;
                 return PlanStage::NEED_TIME;
@@ -121,6 +124,22 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+bool ShardFilterStage::_keyBelongsToMe(const BSONObj& shardKey) {
+    if (shardKey.isEmpty())
+        return false;
+
+    const auto keyString = _metadata->encodeKey(shardKey);
+    if (_lastOwnedRange && _lastOwnedRange->contains(keyString))
+        return true;
+
+    if (const auto ownedRange = _metadata->findOwnedRange(keyString)) {
+        _lastOwnedRange = ownedRange;
+        return true;
+    }
+
+    return false;
+}
+
 unique_ptr<PlanStageStats> ShardFilterStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret =
@@ -30,6 +30,7 @@
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/s/metadata_manager.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 
@@ -90,6 +91,12 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Returns true if the document with shard key 'shardKey' is owned by this shard. Empty keys
+     * are never owned.
+     */
+    bool _keyBelongsToMe(const BSONObj& shardKey);
+
     WorkingSet* _ws;
 
     // Stats
@@ -98,6 +105,15 @@ private:
     // Note: it is important that this is the metadata from the time this stage is constructed.
     // See class comment for details.
     ScopedCollectionMetadata _metadata;
+
+    // Built once from the metadata's key pattern rather than for every document. Only set if the
+    // collection is sharded.
+    std::unique_ptr<ShardKeyPattern> _shardKeyPattern;
+
+    // The owned range which contained the last document to pass the filter. Index scans return
+    // keys in order, so consecutive documents usually fall in the same range and are accepted by
+    // comparing against its bounds instead of searching the owned ranges again.
+    const CollectionMetadata::OwnedRange* _lastOwnedRange{nullptr};
 };
 
 }  // namespace mongo
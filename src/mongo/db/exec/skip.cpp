@@ -26,6 +26,8 @@
 *    it in the license file.
 */
 
+#include <algorithm>
+
 #include "mongo/db/exec/skip.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -81,6 +83,41 @@ PlanStage::StageState SkipStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState SkipStage::doWorkBatch(size_t maxBatchSize,
+                                             std::vector<WorkingSetID>* batch,
+                                             WorkingSetID* out) {
+    const size_t sizeBefore = batch->size();
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(maxBatchSize, batch, &id);
+
+    if (PlanStage::ADVANCED != status) {
+        ++_commonStats.works;
+        if (PlanStage::NEED_TIME == status) {
+            ++_commonStats.needTime;
+        }
+        *out = id;
+        return status;
+    }
+
+    const size_t numFromChild = batch->size() - sizeBefore;
+    _commonStats.works += numFromChild;
+
+    // Drop the leading results that we are still skipping.
+    const size_t numToDrop = std::min(numFromChild, static_cast<size_t>(_toSkip));
+    if (numToDrop > 0) {
+        auto dropBegin = batch->begin() + sizeBefore;
+        auto dropEnd = dropBegin + numToDrop;
+        for (auto it = dropBegin; it != dropEnd; ++it) {
+            _ws->free(*it);
+        }
+        batch->erase(dropBegin, dropEnd);
+        _toSkip -= numToDrop;
+        _commonStats.needTime += numToDrop;
+    }
+
+    return batch->size() > sizeBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
 unique_ptr<PlanStageStats> SkipStage::getStats() {
     _commonStats.isEOF = isEOF();
     _specificStats.skip = _toSkip;
@@ -41,6 +41,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -51,13 +52,32 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// The most fields an Ordering can describe. Ordering::make() uasserts on longer patterns.
+const int kMaxOrderingFields = 32;
+
+/**
+ * Returns the ordering of 'pattern', or none if it has more fields than an Ordering can describe.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const BSONObj& pattern) {
+    const BSONObj spec = FindCommon::transformSortSpec(pattern);
+    if (spec.nFields() > kMaxOrderingFields) {
+        return boost::none;
+    }
+    return Ordering::make(spec);
+}
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
-SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
-
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
+    if (!lhs.encodedKey.empty()) {
+        return lhs.encodedKey < rhs.encodedKey;
+    }
     // False means ignore field names.
     int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
@@ -67,6 +87,48 @@ bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
     return lhs.recordId < rhs.recordId;
 }
 
+int SortStage::SpillComparator::operator()(const SpillableSorter::Data& lhs,
+                                           const SpillableSorter::Data& rhs) const {
+    if (!lhs.first.encodedKey.empty()) {
+        return lhs.first.encodedKey.compare(rhs.first.encodedKey);
+    }
+    // False means ignore field names.
+    int result = lhs.first.sortKey.woCompare(rhs.first.sortKey, pattern, false);
+    if (0 != result) {
+        return result;
+    }
+    return lhs.first.recordId.compare(rhs.first.recordId);
+}
+
+void SortStage::SpillableSortKey::serializeForSorter(BufBuilder& buf) const {
+    buf.appendNum(static_cast<int>(encodedKey.size()));
+    if (encodedKey.empty()) {
+        sortKey.serializeForSorter(buf);
+        buf.appendNum(static_cast<long long>(recordId.repr()));
+        return;
+    }
+    buf.appendBuf(encodedKey.data(), encodedKey.size());
+    buf.appendBuf(typeBits.data(), typeBits.size());
+}
+
+SortStage::SpillableSortKey SortStage::SpillableSortKey::deserializeForSorter(
+    BufReader& buf, const SorterDeserializeSettings& settings) {
+    SpillableSortKey key;
+    const int size = buf.read<LittleEndian<int>>();
+    if (size == 0) {
+        key.sortKey = BSONObj::deserializeForSorter(buf, BSONObj::SorterDeserializeSettings());
+        key.recordId = RecordId(buf.read<LittleEndian<long long>>());
+        return key;
+    }
+    key.encodedKey.assign(static_cast<const char*>(buf.skip(size)), size);
+
+    // The type bits know their own length.
+    const char* typeBitsStart = static_cast<const char*>(buf.pos());
+    KeyString::TypeBits::fromBuffer(KeyString::kLatestVersion, &buf);
+    key.typeBits.assign(typeBitsStart, static_cast<const char*>(buf.pos()) - typeBitsStart);
+    return key;
+}
+
 SortStage::SortStage(OperationContext* opCtx,
                      const SortStageParams& params,
                      WorkingSet* ws,
@@ -76,19 +138,17 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
       _sorted(false),
+      _sortKeyOrdering(makeSortKeyOrdering(_pattern)),
       _resultIterator(_data.end()),
       _memUsage(0) {
     _children.emplace_back(child);
 
-    BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
-    _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
-
     // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
     // fetching from the child stage.
     if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
+        _dataSet.reset(new SortableDataItemSet(WorkingSetComparator(_pattern)));
     }
 }
 
@@ -97,18 +157,33 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    if (_sorterIterator) {
+        return !_sorterIterator->more();
+    }
+    return _data.end() == _resultIterator;
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
     if (_memUsage > maxBytes) {
-        mongoutils::str::stream ss;
-        ss << "Sort operation used more than the maximum " << maxBytes
-           << " bytes of RAM. Add an index, or specify a smaller limit.";
-        Status status(ErrorCodes::OperationFailed, ss);
-        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
-        return PlanStage::FAILURE;
+        if (!_allowDiskUse) {
+            mongoutils::str::stream ss;
+            ss << "Sort operation used more than the maximum " << maxBytes
+               << " bytes of RAM. Add an index, specify a smaller limit, or set allowDiskUse to"
+               << " true to opt in to external sorting.";
+            Status status(ErrorCodes::OperationFailed, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
+
+        Status status = spillToSorter();
+        if (!status.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
     }
 
     if (isEOF()) {
@@ -129,33 +204,53 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
             // Planner must put a fetch before we get here.
             verify(member->hasObj());
 
-            // We might be sorting something that was invalidated at some point.
-            if (member->hasRecordId()) {
-                _wsidByRecordId[member->recordId] = id;
-            }
-
-            SortableDataItem item;
-            item.wsid = id;
-
             // We extract the sort key from the WSM's computed data. This must have been generated
             // by a SortKeyGeneratorStage descendent in the execution tree.
             auto sortKeyComputedData =
                 static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY));
-            item.sortKey = sortKeyComputedData->getSortKey();
 
+            // Once we have spilled, every further result goes straight to the external sorter.
+            if (_sorter) {
+                if (!isSpillable(member)) {
+                    Status status(ErrorCodes::OperationFailed,
+                                  "Sort operation exceeded the memory limit and cannot spill "
+                                  "results carrying computed metadata to disk.");
+                    _ws->free(id);
+                    *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                    return PlanStage::FAILURE;
+                }
+                addToSorter(id);
+                updateMemoryStats();
+                return PlanStage::NEED_TIME;
+            }
+
+            // We might be sorting something that was invalidated at some point.
             if (member->hasRecordId()) {
-                // The RecordId breaks ties when sorting two WSMs with the same sort key.
-                item.recordId = member->recordId;
+                _wsidByRecordId[member->recordId] = id;
             }
 
-            addToBuffer(item);
+            // The RecordId breaks ties when sorting two WSMs with the same sort key.
+            addToBuffer(makeDataItem(id,
+                                     sortKeyComputedData->getSortKey(),
+                                     member->hasRecordId() ? member->recordId : RecordId()));
+            updateMemoryStats();
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
-            _resultIterator = _data.begin();
+            if (_sorter) {
+                _sorterIterator.reset(_sorter->done());
+                updateMemoryStats();
+                const SorterSpillStats spillStats = _sorter->spillStats();
+                _specificStats.spilledBytes = spillStats.bytesSpilled;
+                _specificStats.spilledBytesUncompressed = spillStats.bytesSpilledUncompressed;
+                _specificStats.spillMergePasses = spillStats.mergePasses;
+                _sorter.reset();
+            } else {
+                sortBuffer();
+                _resultIterator = _data.begin();
+            }
             _sorted = true;
             return PlanStage::NEED_TIME;
         } else if (PlanStage::FAILURE == code || PlanStage::DEAD == code) {
@@ -172,6 +267,36 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
+    if (_sorterIterator) {
+        auto next = _sorterIterator->next();
+
+        *out = _ws->allocate();
+        WorkingSetMember* member = _ws->get(*out);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), next.second.obj.getOwned());
+
+        RecordId recordId;
+        if (_sortKeyOrdering) {
+            const std::string& encodedKey = next.first.encodedKey;
+            BufReader typeBitsReader(next.first.typeBits.data(), next.first.typeBits.size());
+            const auto typeBits =
+                KeyString::TypeBits::fromBuffer(KeyString::kLatestVersion, &typeBitsReader);
+            member->addComputed(new SortKeyComputedData(KeyString::toBson(
+                encodedKey.data(), encodedKey.size(), *_sortKeyOrdering, typeBits)));
+            recordId = KeyString::decodeRecordIdAtEnd(encodedKey.data(), encodedKey.size());
+        } else {
+            member->addComputed(new SortKeyComputedData(next.first.sortKey.getOwned()));
+            recordId = next.first.recordId;
+        }
+
+        if (recordId.isNull()) {
+            member->transitionToOwnedObj();
+        } else {
+            member->recordId = recordId;
+            _ws->transitionToRecordIdAndObj(*out);
+        }
+        return PlanStage::ADVANCED;
+    }
+
     verify(_resultIterator != _data.end());
     verify(_sorted);
     *out = _resultIterator->wsid;
@@ -229,6 +354,32 @@ const SpecificStats* SortStage::getSpecificStats() const {
     return &_specificStats;
 }
 
+void SortStage::encodeSortKey(const BSONObj& sortKey, const RecordId& recordId) {
+    invariant(_sortKeyOrdering);
+    _keyString.resetToKey(sortKey, *_sortKeyOrdering, recordId);
+}
+
+SortStage::SortableDataItem SortStage::makeDataItem(WorkingSetID id,
+                                                    const BSONObj& sortKey,
+                                                    const RecordId& recordId) {
+    SortableDataItem item;
+    item.wsid = id;
+    if (_sortKeyOrdering) {
+        // Encode the sort key once, so that every comparison made while sorting is a memcmp.
+        encodeSortKey(sortKey, recordId);
+        item.encodedKey.assign(_keyString.getBuffer(), _keyString.getSize());
+    } else {
+        // The sort key is owned by the member's computed data, which outlives the item.
+        item.sortKey = sortKey;
+        item.recordId = recordId;
+    }
+    return item;
+}
+
+size_t SortStage::getMemUsage(const SortableDataItem& item) const {
+    return _ws->get(item.wsid)->getMemUsage() + item.encodedKey.size();
+}
+
 /**
  * addToBuffer() and sortBuffer() work differently based on the
  * configured limit. addToBuffer() is also responsible for
@@ -258,22 +409,25 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         member->makeObjOwnedIfNeeded();
         _data.push_back(item);
-        _memUsage += member->getMemUsage();
+        _memUsage += getMemUsage(item);
+        _trackedMemory.set(_memUsage);
     } else if (_limit == 1) {
         if (_data.empty()) {
             member->makeObjOwnedIfNeeded();
             _data.push_back(item);
-            _memUsage = member->getMemUsage();
+            _memUsage = getMemUsage(item);
+            _trackedMemory.set(_memUsage);
             return;
         }
         wsidToFree = item.wsid;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        const WorkingSetComparator cmp(_pattern);
         // Compare new item with existing item in vector.
         if (cmp(item, _data[0])) {
             wsidToFree = _data[0].wsid;
             member->makeObjOwnedIfNeeded();
             _data[0] = item;
-            _memUsage = member->getMemUsage();
+            _memUsage = getMemUsage(item);
+            _trackedMemory.set(_memUsage);
         }
     } else {
         // Update data item set instead of vector
@@ -282,7 +436,8 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         if (_dataSet->size() < limit) {
             member->makeObjOwnedIfNeeded();
             _dataSet->insert(item);
-            _memUsage += member->getMemUsage();
+            _memUsage += getMemUsage(item);
+            _trackedMemory.set(_memUsage);
             return;
         }
         // Limit will be exceeded - compare with item with lowest key
@@ -291,10 +446,11 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         wsidToFree = item.wsid;
         SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
         const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        const WorkingSetComparator cmp(_pattern);
         if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-            _memUsage += member->getMemUsage();
+            _memUsage -= getMemUsage(lastItem);
+            _memUsage += getMemUsage(item);
+            _trackedMemory.set(_memUsage);
             wsidToFree = lastItem.wsid;
             // According to std::set iterator validity rules,
             // it does not matter which of erase()/insert() happens first.
@@ -319,8 +475,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
 
 void SortStage::sortBuffer() {
     if (_limit == 0) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        std::sort(_data.begin(), _data.end(), cmp);
+        std::sort(_data.begin(), _data.end(), WorkingSetComparator(_pattern));
     } else if (_limit == 1) {
         // Buffer contains either 0 or 1 item so it is already in a sorted state.
         return;
@@ -334,4 +489,110 @@ void SortStage::sortBuffer() {
     }
 }
 
+bool SortStage::isSpillable(const WorkingSetMember* member) {
+    // The sort key is regenerated from the spilled data, but any other metadata (text score, geo
+    // distance, ...) would be lost.
+    for (auto type : {WSM_COMPUTED_TEXT_SCORE,
+                      WSM_COMPUTED_GEO_DISTANCE,
+                      WSM_INDEX_KEY,
+                      WSM_GEO_NEAR_POINT}) {
+        if (member->hasComputed(type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Status SortStage::spillToSorter() {
+    invariant(!_sorter);
+
+    // Documents handed to the sorter are no longer visible to doInvalidate(), which is only safe
+    // if storage engine guarantees that the RecordIds we return remain meaningful across yields.
+    if (!supportsDocLocking()) {
+        return {ErrorCodes::OperationFailed,
+                "Sort operation exceeded the memory limit and the storage engine does not support "
+                "spilling blocking sorts to disk."};
+    }
+
+    std::vector<SortableDataItem> items;
+    if (_dataSet) {
+        items.assign(_dataSet->begin(), _dataSet->end());
+    } else {
+        items.swap(_data);
+    }
+
+    for (const auto& item : items) {
+        if (!isSpillable(_ws->get(item.wsid))) {
+            // Restore the buffer so that the members are freed along with the working set.
+            if (!_dataSet) {
+                _data.swap(items);
+            }
+            return {ErrorCodes::OperationFailed,
+                    "Sort operation exceeded the memory limit and cannot spill results carrying "
+                    "computed metadata to disk."};
+        }
+    }
+
+    SortOptions opts;
+    opts.limit = _limit;
+    opts.maxMemoryUsageBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+    opts.extSortAllowed = true;
+    opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+    _sorter.reset(SpillableSorter::make(opts, SpillComparator(_pattern)));
+
+    for (const auto& item : items) {
+        addToSorter(item.wsid);
+    }
+
+    _data.clear();
+    _dataSet.reset();
+    _wsidByRecordId.clear();
+    _memUsage = 0;
+    _trackedMemory.set(_memUsage);
+    _specificStats.usedDisk = true;
+    return Status::OK();
+}
+
+void SortStage::addToSorter(WorkingSetID id) {
+    WorkingSetMember* member = _ws->get(id);
+    auto sortKeyComputedData =
+        static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY));
+
+    RecordId recordId;
+    if (member->hasRecordId()) {
+        recordId = member->recordId;
+        _wsidByRecordId.erase(member->recordId);
+    }
+
+    // The key carries the RecordId, so the spilled document is just the object. The sorter holds
+    // on to what it is given, so the key and the document must be owned before the member is
+    // freed.
+    SpillableSortKey key;
+    if (_sortKeyOrdering) {
+        encodeSortKey(sortKeyComputedData->getSortKey(), recordId);
+        key.encodedKey.assign(_keyString.getBuffer(), _keyString.getSize());
+        const auto& typeBits = _keyString.getTypeBits();
+        key.typeBits.assign(reinterpret_cast<const char*>(typeBits.getBuffer()),
+                            typeBits.getSize());
+    } else {
+        key.sortKey = sortKeyComputedData->getSortKey().getOwned();
+        key.recordId = recordId;
+    }
+
+    _sorter->add(key, {member->obj.value().getOwned()});
+    _ws->free(id);
+}
+
+void SortStage::updateMemoryStats() {
+    size_t peakMemUsage = static_cast<size_t>(_trackedMemory.peakBytes());
+    if (_sorter) {
+        peakMemUsage = std::max(peakMemUsage, _sorter->peakMemUsed());
+        _specificStats.spills = _sorter->spillStats().spills;
+    }
+    _specificStats.peakMemUsage = std::max(_specificStats.peakMemUsage, peakMemUsage);
+}
+
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
@@ -37,7 +39,10 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/memory_usage_tracker.h"
 
 namespace mongo {
 
@@ -46,7 +51,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,6 +61,10 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // Whether the stage may spill to disk through the external Sorter once the buffered data
+    // exceeds internalQueryExecMaxBlockingSortBytes, rather than failing the query.
+    bool allowDiskUse;
 };
 
 /**
@@ -65,6 +74,11 @@ public:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
  *   -- All WSMs produced by the child stage must have the sort key available as WSM computed data.
+ *
+ * Results are buffered in memory. If 'allowDiskUse' is set and the buffered data outgrows the
+ * blocking sort memory limit, the buffered results are handed over to an external Sorter, which
+ * spills to temporary files under the dbpath. Spilling requires a storage engine supporting
+ * document-level locking, since spilled documents are no longer tracked for invalidations.
  */
 class SortStage final : public PlanStage {
 public:
@@ -106,6 +120,9 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // Whether we may switch to the external sorter when we run out of memory.
+    bool _allowDiskUse;
+
     //
     // Data storage
     //
@@ -117,27 +134,51 @@ private:
     // Collection of working set members to sort with their respective sort key.
     struct SortableDataItem {
         WorkingSetID wsid;
+
+        // The sort key as a KeyString in the sort pattern's ordering, followed by the member's
+        // RecordId. Since we must replicate the behavior of a covered sort as much as possible we
+        // use the RecordId to break sort key ties, the same way the indices do. See sorta.js.
+        // Empty if the sort pattern has too many fields to be encoded.
+        std::string encodedKey;
+
+        // Only set when 'encodedKey' is empty.
         BSONObj sortKey;
-        // Since we must replicate the behavior of a covered sort as much as possible we use the
-        // RecordId to break sortKey ties.
-        // See sorta.js.
         RecordId recordId;
     };
 
-    // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
-    // This is also how the items are ordered in the indices. Keys are compared using
-    // BSONObj::woCompare() with RecordId as a tie-breaker.
+    // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc)
+    // with a single memcmp of their encoded keys or, for sort patterns which cannot be encoded,
+    // using BSONObj::woCompare() with RecordId as a tie-breaker.
     //
     // We are comparing keys generated by the SortKeyGenerator, which are already ordered with
     // respect the collation. Therefore, we explicitly avoid comparing using a collator here.
     struct WorkingSetComparator {
-        explicit WorkingSetComparator(BSONObj p);
+        explicit WorkingSetComparator(BSONObj p) : pattern(p) {}
 
         bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
 
         BSONObj pattern;
     };
 
+    /**
+     * Encodes 'sortKey' and 'recordId' into '_keyString', from which the caller copies out the
+     * encoded key and, if needed, its type bits. Must only be called if '_sortKeyOrdering' is set.
+     */
+    void encodeSortKey(const BSONObj& sortKey, const RecordId& recordId);
+
+    /**
+     * Returns a SortableDataItem for the member 'id', holding either its encoded sort key or, if
+     * the sort pattern cannot be encoded, its BSON sort key and RecordId.
+     */
+    SortableDataItem makeDataItem(WorkingSetID id,
+                                  const BSONObj& sortKey,
+                                  const RecordId& recordId);
+
+    /**
+     * Returns the memory accounted to 'item': its working set member and its encoded key.
+     */
+    size_t getMemUsage(const SortableDataItem& item) const;
+
     /**
      * Inserts one item into data buffer (vector or set).
      * If limit is exceeded, remove item with lowest key.
@@ -152,9 +193,13 @@ private:
      */
     void sortBuffer();
 
-    // Comparator for data buffer
-    // Initialization follows sort key generator
-    std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
+    // The ordering of the sort pattern, used to encode and decode the sort keys. Not set if the
+    // pattern has more fields than an Ordering can describe, in which case the sort keys are kept
+    // as BSON and compared with BSONObj::woCompare().
+    const boost::optional<Ordering> _sortKeyOrdering;
+
+    // Reused to encode the sort key of every item, so that its buffer is allocated only once.
+    KeyString _keyString{KeyString::kLatestVersion};
 
     // The data we buffer and sort.
     // _data will contain sorted data when all data is gathered
@@ -178,6 +223,106 @@ private:
 
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+    TrackedMemory _trackedMemory{MemoryUsageTracker::Category::kBlockingSort};
+
+    //
+    // External sort
+    //
+
+    // The encoded sort key of a WorkingSetMember handed to the external Sorter, along with the
+    // type bits needed to decode it back into the BSON sort key. The member's RecordId is
+    // recovered from the end of the encoded key. If the sort pattern cannot be encoded, the BSON
+    // sort key and the RecordId are stored instead.
+    struct SpillableSortKey {
+        struct SorterDeserializeSettings {};  // unused
+
+        void serializeForSorter(BufBuilder& buf) const;
+
+        static SpillableSortKey deserializeForSorter(BufReader& buf,
+                                                     const SorterDeserializeSettings& settings);
+
+        int memUsageForSorter() const {
+            return sizeof(SpillableSortKey) + encodedKey.size() + typeBits.size() +
+                sortKey.objsize();
+        }
+
+        SpillableSortKey getOwned() const {
+            return {encodedKey, typeBits, sortKey.getOwned(), recordId};
+        }
+
+        std::string encodedKey;
+
+        // The buffer of a KeyString::TypeBits, in the format described by its getBuffer().
+        std::string typeBits;
+
+        // Only set when 'encodedKey' is empty.
+        BSONObj sortKey;
+        RecordId recordId;
+    };
+
+    // The state of a WorkingSetMember that is preserved when handing it to the external Sorter.
+    // Only members whose sole computed data is the sort key can be spilled.
+    struct SpillableDocument {
+        struct SorterDeserializeSettings {};  // unused
+
+        void serializeForSorter(BufBuilder& buf) const {
+            obj.serializeForSorter(buf);
+        }
+
+        static SpillableDocument deserializeForSorter(BufReader& buf,
+                                                      const SorterDeserializeSettings& settings) {
+            return {BSONObj::deserializeForSorter(buf, BSONObj::SorterDeserializeSettings())};
+        }
+
+        int memUsageForSorter() const {
+            return sizeof(SpillableDocument) + obj.objsize();
+        }
+
+        SpillableDocument getOwned() const {
+            return {obj.getOwned()};
+        }
+
+        BSONObj obj;
+    };
+
+    using SpillableSorter = Sorter<SpillableSortKey, SpillableDocument>;
+
+    // Orders (sortKey, document) pairs the same way as WorkingSetComparator.
+    struct SpillComparator {
+        explicit SpillComparator(BSONObj p) : pattern(p) {}
+
+        int operator()(const SpillableSorter::Data& lhs, const SpillableSorter::Data& rhs) const;
+
+        BSONObj pattern;
+    };
+
+    /**
+     * Returns true if 'member' can be reconstructed from a SpillableDocument and its sort key.
+     */
+    static bool isSpillable(const WorkingSetMember* member);
+
+    /**
+     * Creates '_sorter' and moves every item buffered so far into it, freeing the corresponding
+     * working set members. Returns a non-OK status if any buffered member cannot be spilled.
+     */
+    Status spillToSorter();
+
+    /**
+     * Adds the member 'id' to '_sorter' and frees it from the working set.
+     */
+    void addToSorter(WorkingSetID id);
+
+    /**
+     * Updates the peak memory usage and spill count in '_specificStats' from our buffer and, once
+     * we have spilled, from '_sorter'.
+     */
+    void updateMemoryStats();
+
+    // Non-null once we have switched to the external sorter. Reset when the input is exhausted.
+    std::unique_ptr<SpillableSorter> _sorter;
+
+    // Non-null if the results are being returned from the external sorter.
+    std::unique_ptr<SpillableSorter::Iterator> _sorterIterator;
 };
 
 }  // namespace mongo
@@ -33,6 +33,7 @@
 #include "mongo/db/exec/sort.h"
 
 #include <boost/optional.hpp>
+#include <string>
 
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
@@ -283,6 +284,14 @@ TEST_F(SortStageTest, SortDescendingWithLimitOfOne) {
     testWork("{a: -1}", nullptr, 1, "{input: [{a: 2}, {a: 1}, {a: 3}]}", "{output: [{a: 3}]}");
 }
 
+TEST_F(SortStageTest, SortCompoundKeyOfMixedTypes) {
+    testWork("{a: 1, b: -1}",
+             nullptr,
+             0,
+             "{input: [{a: 'x', b: 1}, {a: 1, b: 2}, {a: 1.5, b: 3}, {a: NumberLong(0)}, {}]}",
+             "{output: [{}, {a: NumberLong(0)}, {a: 1, b: 2}, {a: 1.5, b: 3}, {a: 'x', b: 1}]}");
+}
+
 TEST_F(SortStageTest, SortAscendingWithCollation) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     testWork("{a: 1}",
@@ -300,4 +309,23 @@ TEST_F(SortStageTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+TEST_F(SortStageTest, SortPatternWithTooManyFieldsToEncode) {
+    // An Ordering describes at most 32 fields, so this pattern cannot be sorted on encoded keys.
+    // The descending field comes after the 32nd field.
+    std::string pattern = "{a: 1";
+    for (int i = 0; i < 32; ++i) {
+        pattern += ", b" + std::to_string(i) + ": 1";
+    }
+    pattern += ", c: -1}";
+
+    const char* input = "{input: [{a: 1, c: 1}, {a: 1, c: 2}, {a: 0, c: 0}]}";
+    testWork(pattern.c_str(),
+             nullptr,
+             0,
+             input,
+             "{output: [{a: 0, c: 0}, {a: 1, c: 2}, {a: 1, c: 1}]}");
+    testWork(pattern.c_str(), nullptr, 1, input, "{output: [{a: 0, c: 0}]}");
+    testWork(pattern.c_str(), nullptr, 2, input, "{output: [{a: 0, c: 0}, {a: 1, c: 2}]}");
+}
 }  // namespace
@@ -46,6 +46,7 @@
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
@@ -113,6 +114,11 @@ Status SubplanStage::planSubqueries() {
         LOG(5) << "Subplanner: index " << i << " is " << ie;
     }
 
+    // The first uncached branch of each shape. Branches of an $or often differ only in their
+    // constants, so a later branch of the same shape reuses that branch's plan.
+    PlanCache* planCache = _collection->infoCache()->getPlanCache();
+    stdx::unordered_map<PlanCacheKey, size_t> uncachedShapes;
+
     for (size_t i = 0; i < _orExpression->numChildren(); ++i) {
         // We need a place to shove the results from planning this branch.
         _branchResults.push_back(stdx::make_unique<BranchPlanningResult>());
@@ -133,41 +139,53 @@ Status SubplanStage::planSubqueries() {
 
         // Plan the i-th child. We might be able to find a plan for the i-th child in the plan
         // cache. If there's no cached plan, then we generate and rank plans using the MPS.
+        const bool cacheable = PlanCache::shouldCacheQuery(*branchResult->canonicalQuery);
         CachedSolution* rawCS;
-        if (PlanCache::shouldCacheQuery(*branchResult->canonicalQuery) &&
-            _collection->infoCache()
-                ->getPlanCache()
-                ->get(*branchResult->canonicalQuery, &rawCS)
-                .isOK()) {
+        if (cacheable && planCache->get(*branchResult->canonicalQuery, &rawCS).isOK()) {
             // We have a CachedSolution. Store it for later.
             LOG(5) << "Subplanner: cached plan found for child " << i << " of "
                    << _orExpression->numChildren();
 
             branchResult->cachedSolution.reset(rawCS);
-        } else {
-            // No CachedSolution found. We'll have to plan from scratch.
-            LOG(5) << "Subplanner: planning child " << i << " of " << _orExpression->numChildren();
-
-            // We don't set NO_TABLE_SCAN because peeking at the cache data will keep us from
-            // considering any plan that's a collscan.
-            invariant(branchResult->solutions.empty());
-            auto solutions = QueryPlanner::plan(*branchResult->canonicalQuery, _plannerParams);
-            if (!solutions.isOK()) {
-                mongoutils::str::stream ss;
-                ss << "Can't plan for subchild " << branchResult->canonicalQuery->toString() << " "
-                   << solutions.getStatus().reason();
-                return Status(ErrorCodes::BadValue, ss);
+            continue;
+        }
+
+        if (cacheable) {
+            auto inserted =
+                uncachedShapes.emplace(planCache->computeKey(*branchResult->canonicalQuery), i);
+            if (!inserted.second) {
+                // An earlier branch has the same shape. Its winning plan will be used for this
+                // branch too, just as the plan cache would once that plan is cached.
+                LOG(5) << "Subplanner: child " << i << " of " << _orExpression->numChildren()
+                       << " has the same shape as child " << inserted.first->second;
+
+                branchResult->sameShapeAs = inserted.first->second;
+                continue;
             }
-            branchResult->solutions = std::move(solutions.getValue());
+        }
 
-            LOG(5) << "Subplanner: got " << branchResult->solutions.size() << " solutions";
+        // No CachedSolution found. We'll have to plan from scratch.
+        LOG(5) << "Subplanner: planning child " << i << " of " << _orExpression->numChildren();
 
-            if (0 == branchResult->solutions.size()) {
-                // If one child doesn't have an indexed solution, bail out.
-                mongoutils::str::stream ss;
-                ss << "No solutions for subchild " << branchResult->canonicalQuery->toString();
-                return Status(ErrorCodes::BadValue, ss);
-            }
+        // We don't set NO_TABLE_SCAN because peeking at the cache data will keep us from
+        // considering any plan that's a collscan.
+        invariant(branchResult->solutions.empty());
+        auto solutions = QueryPlanner::plan(*branchResult->canonicalQuery, _plannerParams);
+        if (!solutions.isOK()) {
+            mongoutils::str::stream ss;
+            ss << "Can't plan for subchild " << branchResult->canonicalQuery->toString() << " "
+               << solutions.getStatus().reason();
+            return Status(ErrorCodes::BadValue, ss);
+        }
+        branchResult->solutions = std::move(solutions.getValue());
+
+        LOG(5) << "Subplanner: got " << branchResult->solutions.size() << " solutions";
+
+        if (0 == branchResult->solutions.size()) {
+            // If one child doesn't have an indexed solution, bail out.
+            mongoutils::str::stream ss;
+            ss << "No solutions for subchild " << branchResult->canonicalQuery->toString();
+            return Status(ErrorCodes::BadValue, ss);
         }
     }
 
@@ -233,6 +251,16 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
             if (!tagStatus.isOK()) {
                 return tagStatus;
             }
+        } else if (branchResult->sameShapeAs) {
+            // Reuse the plan picked for the earlier branch of the same shape.
+            const auto& sameShapeCacheData =
+                _branchResults[*branchResult->sameShapeAs]->chosenCacheData;
+            invariant(sameShapeCacheData);
+            Status tagStatus = tagOrChildAccordingToCache(
+                cacheData.get(), sameShapeCacheData.get(), orChild, _indexMap);
+            if (!tagStatus.isOK()) {
+                return tagStatus;
+            }
         } else if (1 == branchResult->solutions.size()) {
             QuerySolution* soln = branchResult->solutions.front().get();
             Status tagStatus = tagOrChildAccordingToCache(
@@ -240,6 +268,7 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
             if (!tagStatus.isOK()) {
                 return tagStatus;
             }
+            branchResult->chosenCacheData.reset(soln->cacheData->clone());
         } else {
             // N solutions, rank them.
 
@@ -318,6 +347,7 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
             }
 
             cacheData->children.push_back(bestSoln->cacheData->tree->clone());
+            branchResult->chosenCacheData.reset(bestSoln->cacheData->clone());
         }
     }
 
@@ -428,7 +458,8 @@ Status SubplanStage::choosePlanWholeQuery(PlanYieldPolicy* yieldPolicy) {
 Status SubplanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // Adds the amount of time taken by pickBestPlan() to executionTimeMillis. There's lots of
     // work that happens here, so this is needed for the time accounting to make sense.
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedCycleTimer timer(
+        1, &_commonStats.executionTimeTicks, &_commonStats.executionTimeMillis);
 
     // Plan each branch of the $or.
     Status subplanningStatus = planSubqueries();
@@ -486,6 +517,10 @@ bool SubplanStage::branchPlannedFromCache(size_t i) const {
     return NULL != _branchResults[i]->cachedSolution.get();
 }
 
+bool SubplanStage::branchSharedPlan(size_t i) const {
+    return static_cast<bool>(_branchResults[i]->sameShapeAs);
+}
+
 const SpecificStats* SubplanStage::getSpecificStats() const {
     return NULL;
 }
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
 #include <string>
 #include <vector>
@@ -117,6 +118,12 @@ public:
      */
     bool branchPlannedFromCache(size_t i) const;
 
+    /**
+     * Returns true if the i-th branch was given the plan picked for an earlier branch of the same
+     * shape, rather than being planned on its own.
+     */
+    bool branchSharedPlan(size_t i) const;
+
     /**
      * Provide access to the query solution for our composite solution. Does not relinquish
      * ownership.
@@ -147,6 +154,15 @@ private:
 
         // Query solutions resulting from planning the $or branch.
         std::vector<std::unique_ptr<QuerySolution>> solutions;
+
+        // If set, the branch has the same plan cache shape as the branch at this index, which was
+        // not in the cache either. The branch is given that branch's winning plan instead of
+        // being planned again.
+        boost::optional<size_t> sameShapeAs;
+
+        // The cache data of the plan picked for the branch, kept for later branches of the same
+        // shape. Not set for branches planned from the cache.
+        std::unique_ptr<SolutionCacheData> chosenCacheData;
     };
 
     /**
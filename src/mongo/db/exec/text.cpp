@@ -121,7 +121,23 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
     if (wantTextScore) {
         // We use a TEXT_OR stage to get the union of the results from the index scans and then
         // compute their text scores. This is a blocking operation.
-        auto textScorer = make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, _params.index);
+        //
+        // When only the top scoring documents are needed, the TEXT_OR stage can stop reading the
+        // index scans early. That requires every document it keeps to be a final result, so it is
+        // only done if the TEXT_MATCH stage cannot reject any of them: the query must not have
+        // phrases or negations, or be case or diacritic sensitive.
+        const FTSQueryImpl& query = _params.query;
+        const bool canReturnTopK = query.getNegatedTerms().empty() &&
+            query.getPositivePhr().empty() && query.getNegatedPhr().empty() &&
+            !query.getCaseSensitive() && !query.getDiacriticSensitive();
+        const size_t topK = canReturnTopK ? _params.limit : 0;
+        auto textScorer = make_unique<TextOrStage>(opCtx,
+                                                   _params.spec,
+                                                   ws,
+                                                   filter,
+                                                   _params.index,
+                                                   topK,
+                                                   query.getTermsForBounds());
 
         textScorer->addChildren(std::move(indexScanList));
 
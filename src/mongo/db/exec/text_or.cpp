@@ -57,11 +57,15 @@ TextOrStage::TextOrStage(OperationContext* opCtx,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         IndexDescriptor* index)
+                         IndexDescriptor* index,
+                         size_t topK,
+                         std::set<std::string> terms)
     : PlanStage(kStageType, opCtx),
       _ftsSpec(ftsSpec),
       _ws(ws),
       _scoreIterator(_scores.end()),
+      _topK(topK),
+      _terms(std::move(terms)),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID),
       _index(index) {}
@@ -106,12 +110,14 @@ void TextOrStage::doReattachToOperationContext() {
 
 void TextOrStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) {
     // Remove the RecordID from the ScoreMap.
-    ScoreMap::iterator scoreIt = _scores.find(dl);
+    ScoreMap::const_iterator scoreIt = _scores.find(dl);
     if (scoreIt != _scores.end()) {
         if (scoreIt == _scoreIterator) {
             _scoreIterator++;
         }
+        _docMemUsage -= scoreIt->second.memUsage;
         _scores.erase(scoreIt);
+        updateMemUsage();
     }
 }
 
@@ -124,6 +130,8 @@ std::unique_ptr<PlanStageStats> TextOrStage::getStats() {
         _commonStats.filter = bob.obj();
     }
 
+    _specificStats.topK = _topK;
+
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_TEXT_OR);
     ret->specific = make_unique<TextOrStats>(_specificStats);
 
@@ -168,6 +176,7 @@ PlanStage::StageState TextOrStage::initStage(WorkingSetID* out) {
     *out = WorkingSet::INVALID_ID;
     try {
         _recordCursor = _index->getCollection()->getCursor(getOpCtx());
+        _termScoreBounds.assign(_children.size(), fts::MAX_WEIGHT);
         _internalState = State::kReadingTerms;
         return PlanStage::NEED_TIME;
     } catch (const WriteConflictException&) {
@@ -197,8 +206,22 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        if (!_topK) {
+            return addTerm(id, out);
+        }
+
+        StageState stageState = addTermTopK(id, out);
+        if (PlanStage::NEED_YIELD == stageState) {
+            // Stay on this child so that the same key is retried after yielding.
+            return stageState;
+        }
+        return nextChildTopK();
     } else if (PlanStage::IS_EOF == childState) {
+        if (_topK) {
+            _termScoreBounds[_currentChild] = 0;
+            return nextChildTopK();
+        }
+
         // Done with this child.
         ++_currentChild;
 
@@ -208,6 +231,7 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
         }
 
         // If we're here we are done reading results.  Move to the next state.
+        updateMemUsage();
         _scoreIterator = _scores.begin();
         _internalState = State::kReturningResults;
 
@@ -300,6 +324,7 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
 
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         wsm->makeObjOwnedIfNeeded();
+        keepDocument(textRecordData, wsm);
     } else {
         // We already have a working set member for this RecordId. Free the new WSM and retrieve the
         // old one. Note that since we don't keep all index keys, we could get a score that doesn't
@@ -310,8 +335,142 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
+    // Aggregate relevance score, term keys.
+    textRecordData->score += getTermScore(newKeyData.keyData);
+    return NEED_TIME;
+}
+
+PlanStage::StageState TextOrStage::addTermTopK(WorkingSetID wsid, WorkingSetID* out) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+    invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
+    invariant(1 == wsm->keyData.size());
+    const IndexKeyDatum& keyDatum = wsm->keyData.back();
+
+    // The child returns keys in descending order of score, so no document it has yet to return can
+    // score any higher for its term.
+    _termScoreBounds[_currentChild] = getTermScore(keyDatum.keyData);
+
+    TextRecordData* textRecordData = &_scores[wsm->recordId];
+    if (textRecordData->score < 0 || WorkingSet::INVALID_ID != textRecordData->wsid) {
+        // We have already scored this document in full, and either kept it or rejected it.
+        _ws->free(wsid);
+        return NEED_TIME;
+    }
+
+    if (!Filter::passes(keyDatum.keyData, keyDatum.indexKeyPattern, _filter)) {
+        _ws->free(wsid);
+        textRecordData->score = -1;
+        return NEED_TIME;
+    }
+
+    try {
+        if (!WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor)) {
+            _ws->free(wsid);
+            textRecordData->score = -1;
+            return NEED_TIME;
+        }
+        ++_specificStats.fetches;
+    } catch (const WriteConflictException&) {
+        wsm->makeObjOwnedIfNeeded();
+        _idRetrying = wsid;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    // Score the document for every term up front, rather than waiting for the other children to
+    // reach it, so that it can be compared against the bounds straight away.
+    fts::TermFrequencyMap termScores;
+    _ftsSpec.scoreDocument(wsm->obj.value(), &termScores);
+    double score = 0;
+    for (const auto& term : _terms) {
+        auto termScore = termScores.find(term);
+        if (termScore != termScores.end()) {
+            score += termScore->second;
+        }
+    }
+
+    if (_topKHeap.size() == _topK) {
+        if (score <= _topKHeap.top().score) {
+            _ws->free(wsid);
+            textRecordData->score = -1;
+            return NEED_TIME;
+        }
+
+        // Make room by dropping the lowest scoring document kept so far. Its entry in the score map
+        // may be gone if it was invalidated in the meantime.
+        const TopKEntry& dropped = _topKHeap.top();
+        auto droppedIt = _scores.find(dropped.recordId);
+        if (droppedIt != _scores.end() && droppedIt->second.wsid == dropped.wsid) {
+            droppedIt->second.wsid = WorkingSet::INVALID_ID;
+            droppedIt->second.score = -1;
+            releaseDocument(&droppedIt->second);
+        }
+        _ws->free(dropped.wsid);
+        _topKHeap.pop();
+    }
+
+    textRecordData->wsid = wsid;
+    textRecordData->score = score;
+    _topKHeap.push({score, wsm->recordId, wsid});
+
+    // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
+    wsm->makeObjOwnedIfNeeded();
+    keepDocument(textRecordData, wsm);
+    return NEED_TIME;
+}
+
+PlanStage::StageState TextOrStage::nextChildTopK() {
+    if (!topKComplete()) {
+        for (size_t i = 1; i <= _children.size(); ++i) {
+            const size_t nextChild = (_currentChild + i) % _children.size();
+            if (!_children[nextChild]->isEOF()) {
+                _currentChild = nextChild;
+                return PlanStage::NEED_TIME;
+            }
+        }
+    }
+
+    // Either every child is exhausted or the remaining keys cannot change the top k, so we are
+    // done reading results.
+    updateMemUsage();
+    _scoreIterator = _scores.begin();
+    _internalState = State::kReturningResults;
+    return PlanStage::NEED_TIME;
+}
+
+bool TextOrStage::topKComplete() const {
+    if (_topKHeap.size() < _topK) {
+        return false;
+    }
+
+    double unseenScoreBound = 0;
+    for (double termScoreBound : _termScoreBounds) {
+        unseenScoreBound += termScoreBound;
+    }
+    return _topKHeap.top().score >= unseenScoreBound;
+}
+
+void TextOrStage::updateMemUsage() {
+    _specificStats.memUsage = _docMemUsage + _scores.size() * sizeof(ScoreMap::value_type);
+    _specificStats.peakMemUsage =
+        std::max(_specificStats.peakMemUsage, _specificStats.memUsage);
+}
+
+void TextOrStage::keepDocument(TextRecordData* textRecordData, WorkingSetMember* wsm) {
+    textRecordData->memUsage = wsm->getMemUsage();
+    _docMemUsage += textRecordData->memUsage;
+    updateMemUsage();
+}
+
+void TextOrStage::releaseDocument(TextRecordData* textRecordData) {
+    _docMemUsage -= textRecordData->memUsage;
+    textRecordData->memUsage = 0;
+    updateMemUsage();
+}
+
+double TextOrStage::getTermScore(const BSONObj& key) const {
     // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
+    BSONObjIterator keyIt(key);
     for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
         keyIt.next();
     }
@@ -319,11 +478,7 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     keyIt.next();  // Skip past 'term'.
 
     BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
-
-    // Aggregate relevance score, term keys.
-    textRecordData->score += documentTermScore;
-    return NEED_TIME;
+    return scoreElement.number();
 }
 
 }  // namespace mongo
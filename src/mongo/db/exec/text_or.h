@@ -29,6 +29,12 @@
 #pragma once
 
 #include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <third_party/murmurhash3/MurmurHash3.h>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -36,6 +42,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/util/unordered_fast_key_table_traits_helpers.h"
 
 namespace mongo {
 
@@ -48,6 +55,13 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * If constructed with a nonzero 'topK', the stage only returns the 'topK' documents with the
+ * highest scores. Each child must then scan the keys for one term in descending order of score, so
+ * that the last score read from a child bounds the score of the term in every document not yet seen
+ * by it. The children are read in turn, and each new document is scored in full from its fetched
+ * contents. Reading stops as soon as the 'topK' best scores found so far are no lower than the sum
+ * of those bounds, since no unseen document could score any higher.
  */
 class TextOrStage final : public PlanStage {
 public:
@@ -72,7 +86,9 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                IndexDescriptor* index);
+                IndexDescriptor* index,
+                size_t topK = 0,
+                std::set<std::string> terms = {});
     ~TextOrStage();
 
     void addChild(std::unique_ptr<PlanStage> child);
@@ -123,6 +139,41 @@ private:
      */
     StageState returnResults(WorkingSetID* out);
 
+    /**
+     * Top-k counterpart of addTerm, which scores each newly seen document in full and keeps only
+     * the best '_topK' of them.
+     */
+    StageState addTermTopK(WorkingSetID wsid, WorkingSetID* out);
+
+    /**
+     * Moves on to the next child which still has keys to read for top-k, or to returning results
+     * if reading further cannot change the top k.
+     */
+    StageState nextChildTopK();
+
+    /**
+     * Returns the score of the term in the text index key 'key'.
+     */
+    double getTermScore(const BSONObj& key) const;
+
+    /**
+     * Returns true once no document which has not been seen yet can score higher than the
+     * '_topK' best documents seen so far.
+     */
+    bool topKComplete() const;
+
+    /**
+     * Records in the stats the memory held by the score map and the buffered documents, and raises
+     * the peak if needed.
+     */
+    void updateMemUsage();
+
+    /**
+     * Starts or stops accounting for the document buffered in 'textRecordData'.
+     */
+    void keepDocument(TextRecordData* textRecordData, WorkingSetMember* wsm);
+    void releaseDocument(TextRecordData* textRecordData);
+
     // The index spec used to determine where to find the score.
     FTSSpec _ftsSpec;
 
@@ -141,15 +192,54 @@ private:
      *  Map each buffered record id to this data.
      */
     struct TextRecordData {
-        TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0) {}
+        TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0), memUsage(0) {}
         WorkingSetID wsid;
         double score;
+
+        // The memory held by the buffered working set member, if there is one.
+        size_t memUsage;
+    };
+
+    // RecordId::Hasher leaves sequential ids in sequential buckets, which would crowd them into
+    // the same probe groups, so mix the bits first.
+    struct ScoreMapHasher {
+        uint32_t operator()(const RecordId& rid) const {
+            const int64_t repr = rid.repr();
+            uint32_t hash;
+            MurmurHash3_x86_32(&repr, sizeof(repr), 0, &hash);
+            return hash;
+        }
     };
 
-    typedef stdx::unordered_map<RecordId, TextRecordData, RecordId::Hasher> ScoreMap;
+    using ScoreMap = UnorderedFastKeyTableTraitsFactoryForValueKey<RecordId, ScoreMapHasher>::type<
+        TextRecordData>;
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // The number of documents to return, or zero to return every matching document.
+    const size_t _topK;
+
+    // The terms searched for by the children. Only needed for top-k.
+    const std::set<std::string> _terms;
+
+    // For top-k, the score of the last key read from each child, or zero once it is exhausted.
+    std::vector<double> _termScoreBounds;
+
+    // For top-k, the best documents seen so far, ordered with the lowest score on top.
+    struct TopKEntry {
+        bool operator>(const TopKEntry& other) const {
+            return score > other.score;
+        }
+
+        double score;
+        RecordId recordId;
+        WorkingSetID wsid;
+    };
+    std::priority_queue<TopKEntry, std::vector<TopKEntry>, std::greater<TopKEntry>> _topKHeap;
+
+    // The memory held by the documents buffered in '_scores'.
+    size_t _docMemUsage = 0;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
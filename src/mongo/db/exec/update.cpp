@@ -43,6 +43,7 @@
 #include "mongo/db/op_observer.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -144,6 +145,18 @@ const std::vector<std::unique_ptr<FieldRef>>* getImmutableFields(OperationContex
     return NULL;
 }
 
+/**
+ * Returns true if the documents to update can be buffered and updated in batches. Only a multi
+ * update which doesn't return documents can batch, and not inside a multi-statement transaction,
+ * which already writes everything in one unit of work. Batching also relies on re-fetching a
+ * buffered document after a yield, rather than on invalidations, to notice that it changed.
+ */
+bool canBatchUpdates(OperationContext* opCtx, const UpdateStageParams& params) {
+    return params.request->isMulti() && !params.request->shouldReturnAnyDocs() &&
+        !params.request->isExplain() && supportsDocLocking() &&
+        !opCtx->lockState()->inAWriteUnitOfWork();
+}
+
 OplogUpdateEntryArgs::StoreDocOption getStoreDocMode(const UpdateRequest& updateRequest) {
     if (updateRequest.shouldReturnNewDocs()) {
         return OplogUpdateEntryArgs::StoreDocOption::PostImage;
@@ -173,7 +186,10 @@ UpdateStage::UpdateStage(OperationContext* opCtx,
       _idRetrying(WorkingSet::INVALID_ID),
       _idReturning(WorkingSet::INVALID_ID),
       _updatedRecordIds(params.request->isMulti() ? new RecordIdSet() : NULL),
-      _doc(params.driver->getDocument()) {
+      _doc(params.driver->getDocument()),
+      _batchSize(canBatchUpdates(opCtx, params)
+                     ? std::max(1, internalQueryExecUpdateBatchSize.load())
+                     : 1) {
     _children.emplace_back(child);
 
     // Should the modifiers validate their embedded docs via storage_validation::storageValid()?
@@ -336,7 +352,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                                           true,
                                                           driver->modsAffectIndices(),
                                                           _params.opDebug,
-                                                          &args);
+                                                          &args,
+                                                          driver->getModifiedIndexedPaths());
             }
         }
 
@@ -350,9 +367,14 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         // it again.  For an example, see the comment above near declaration of
         // updatedRecordIds.
         //
-        // This must be done after the wunit commits so we are sure we won't be rolling back.
+        // This must be done after the wunit commits so we are sure we won't be rolling back. When
+        // the update is one of a batch, the batch's enclosing WriteUnitOfWork may still roll back,
+        // and then the document hasn't been updated after all.
         if (_updatedRecordIds && (newRecordId != recordId || driver->modsAffectIndices())) {
-            _updatedRecordIds->insert(newRecordId);
+            if (_updatedRecordIds->insert(newRecordId).second && _inBatchUnitOfWork) {
+                getOpCtx()->recoveryUnit()->onRollback(
+                    [this, newRecordId] { _updatedRecordIds->erase(newRecordId); });
+            }
         }
     }
 
@@ -485,6 +507,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _pendingUpdates.empty() &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -554,15 +577,31 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
-    // Either retry the last WSM we worked on or get a new one from our child.
+    // Either retry the last WSM we worked on, take the next one from a batch which has to be
+    // updated one document at a time, or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    bool mayBuffer = false;
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (_updatePendingIndividually) {
+        invariant(!_pendingUpdates.empty());
+        status = ADVANCED;
+        id = _pendingUpdates.front();
+        _pendingUpdates.erase(_pendingUpdates.begin());
+        if (_pendingUpdates.empty()) {
+            _updatePendingIndividually = false;
+            _pendingBytes = 0;
+        }
+    } else {
+        status = child()->work(&id);
+        mayBuffer = _batchSize > 1;
+    }
+
+    if (PlanStage::IS_EOF == status && !_pendingUpdates.empty()) {
+        return flushPendingUpdates(out);
     }
 
     if (PlanStage::ADVANCED == status) {
@@ -594,6 +633,20 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             return PlanStage::NEED_TIME;
         }
 
+        if (mayBuffer) {
+            // The document is only checked against the query when the batch is updated. Own it
+            // now, since our child may reuse the memory it points to as soon as it moves on.
+            member->makeObjOwnedIfNeeded();
+            memberFreer.Dismiss();
+            _pendingUpdates.push_back(id);
+            _pendingBytes += member->obj.value().objsize();
+            if (_pendingUpdates.size() < _batchSize &&
+                _pendingBytes < static_cast<size_t>(insertVectorMaxBytes)) {
+                return PlanStage::NEED_TIME;
+            }
+            return flushPendingUpdates(out);
+        }
+
         bool docStillMatches;
         try {
             docStillMatches = write_stage_common::ensureStillMatches(
@@ -710,6 +763,72 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState UpdateStage::flushPendingUpdates(WorkingSetID* out) {
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    const auto nMatchedBefore = _specificStats.nMatched;
+    const auto nModifiedBefore = _specificStats.nModified;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        _inBatchUnitOfWork = true;
+        ON_BLOCK_EXIT([&] { _inBatchUnitOfWork = false; });
+
+        for (auto id : _pendingUpdates) {
+            WorkingSetMember* member = _ws->get(id);
+            RecordId recordId = member->recordId;
+
+            // An earlier update, possibly in this batch, may have moved this document to where our
+            // child found it again.
+            if (_updatedRecordIds->count(recordId) > 0) {
+                continue;
+            }
+
+            // Ensure the document still exists and matches the predicate. A buffered document is
+            // re-fetched if we have yielded since it was buffered.
+            if (!write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                continue;
+            }
+
+            transformAndUpdate(member->obj, recordId);
+            ++_specificStats.nMatched;
+        }
+
+        wunit.commit();
+    } catch (const WriteConflictException&) {
+        // Nothing in the batch was written. Rather than retrying all of it together, which may
+        // keep conflicting, update its documents one at a time, each retried on its own.
+        _specificStats.nMatched = nMatchedBefore;
+        _specificStats.nModified = nModifiedBefore;
+        _updatePendingIndividually = true;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    for (auto id : _pendingUpdates) {
+        _ws->free(id);
+    }
+    _pendingUpdates.clear();
+    _pendingBytes = 0;
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // The updates have already been committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 void UpdateStage::doRestoreState() {
     const UpdateRequest& request = *_params.request;
     const NamespaceString& nsString(request.getNamespaceString());
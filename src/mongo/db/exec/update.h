@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -176,6 +177,14 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Updates the documents buffered in '_pendingUpdates' which still exist and match the query,
+     * all in one WriteUnitOfWork. If that hits a WriteConflictException, nothing is written,
+     * '_updatePendingIndividually' is set and NEED_YIELD is returned, so that the buffered
+     * documents are updated one at a time by the following calls to work().
+     */
+    StageState flushPendingUpdates(WorkingSetID* out);
+
     UpdateStageParams _params;
 
     // Not owned by us.
@@ -214,6 +223,22 @@ private:
     // These get reused for each update.
     mutablebson::Document& _doc;
     mutablebson::DamageVector _damages;
+
+    // The most documents to buffer before updating them together in one WriteUnitOfWork. A value
+    // of 1 means documents are updated one at a time, as they arrive from the child.
+    size_t _batchSize;
+
+    // Documents from the child waiting to be updated as a batch, in the order they arrived, and
+    // their total size in bytes.
+    std::vector<WorkingSetID> _pendingUpdates;
+    size_t _pendingBytes = 0;
+
+    // True if updating '_pendingUpdates' together hit a write conflict, so they are being updated
+    // one at a time instead.
+    bool _updatePendingIndividually = false;
+
+    // True while flushPendingUpdates() has a WriteUnitOfWork open around several updates.
+    bool _inBatchUnitOfWork = false;
 };
 
 }  // namespace mongo
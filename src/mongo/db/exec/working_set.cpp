@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include <algorithm>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
@@ -39,15 +41,32 @@ using std::string;
 
 namespace dps = ::mongo::dotted_path_support;
 
+const size_t WorkingSet::kMinMemberBlockSize;
+const size_t WorkingSet::kMaxMemberBlockSize;
+
 WorkingSet::MemberHolder::MemberHolder() : member(NULL) {}
 WorkingSet::MemberHolder::~MemberHolder() {}
 
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+WorkingSet::~WorkingSet() {}
+
+WorkingSetMember* WorkingSet::allocateFromBlocks() {
+    while (_currentMemberBlock < _memberBlocks.size() &&
+           _membersUsedInCurrentBlock == _memberBlocks[_currentMemberBlock].size) {
+        ++_currentMemberBlock;
+        _membersUsedInCurrentBlock = 0;
     }
+
+    if (_currentMemberBlock == _memberBlocks.size()) {
+        const size_t size = _memberBlocks.empty()
+            ? kMinMemberBlockSize
+            : std::min(2 * _memberBlocks.back().size, kMaxMemberBlockSize);
+        _memberBlocks.push_back({std::unique_ptr<WorkingSetMember[]>(new WorkingSetMember[size]),
+                                 size});
+    }
+
+    return &_memberBlocks[_currentMemberBlock].members[_membersUsedInCurrentBlock++];
 }
 
 WorkingSetID WorkingSet::allocate() {
@@ -58,7 +77,7 @@ WorkingSetID WorkingSet::allocate() {
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = allocateFromBlocks();
         return id;
     }
 
@@ -97,10 +116,16 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 
 void WorkingSet::clear() {
     for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+        if (_data[i].nextFreeOrSelf == i) {
+            _data[i].member->clear();
+        }
     }
     _data.clear();
 
+    // Hand out the existing members again, starting from the first block.
+    _currentMemberBlock = 0;
+    _membersUsedInCurrentBlock = 0;
+
     // Since working set is now empty, the free list pointer should
     // point to nothing.
     _freeList = INVALID_ID;
@@ -147,6 +172,8 @@ void WorkingSetMember::clear() {
 
     keyData.clear();
     obj.reset();
+    isSuspicious = false;
+    _fetcher.reset();
     _state = WorkingSetMember::INVALID;
 }
 
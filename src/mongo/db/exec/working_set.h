@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -112,7 +113,8 @@ public:
     const stdx::unordered_set<WorkingSetID>& getFlagged() const;
 
     /**
-     * Removes and deallocates all members of this working set.
+     * Removes all members of this working set. The storage backing the members is kept and
+     * reused by subsequent calls to allocate().
      */
     void clear();
 
@@ -146,10 +148,38 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into one of the blocks in '_memberBlocks'.
         WorkingSetMember* member;
     };
 
+    /**
+     * A contiguous array of members. Members are constructed a block at a time rather than one at
+     * a time, and are never destroyed before the WorkingSet itself. A recycled member keeps the
+     * capacity of its 'keyData' vector.
+     */
+    struct MemberBlock {
+        std::unique_ptr<WorkingSetMember[]> members;
+        size_t size;
+    };
+
+    /**
+     * Returns the next unused member from '_memberBlocks', adding a new block if all existing
+     * blocks are in use.
+     */
+    WorkingSetMember* allocateFromBlocks();
+
+    // Blocks grow geometrically from the minimum to the maximum size, so that a query which only
+    // ever uses a handful of members does not pay for a large block.
+    static const size_t kMinMemberBlockSize = 8;
+    static const size_t kMaxMemberBlockSize = 256;
+
+    std::vector<MemberBlock> _memberBlocks;
+
+    // The block from which the next new member is handed out, and how many of its members are
+    // already handed out. Both are reset by clear() so that the blocks are reused.
+    size_t _currentMemberBlock = 0;
+    size_t _membersUsedInCurrentBlock = 0;
+
     // All WorkingSetIDs are indexes into this, except for INVALID_ID.
     // Elements are added to _freeList rather than removed when freed.
     std::vector<MemberHolder> _data;
@@ -31,6 +31,9 @@
  */
 
 
+#include <set>
+#include <vector>
+
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
@@ -154,4 +157,47 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST(WorkingSetTest, MembersRemainValidWhileOtherMembersAreAllocated) {
+    WorkingSet ws;
+    std::vector<WorkingSetID> ids;
+    std::vector<WorkingSetMember*> members;
+    for (int i = 0; i < 1000; ++i) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("x" << i));
+        ws.transitionToOwnedObj(id);
+        ids.push_back(id);
+        members.push_back(member);
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQUALS(members[i], ws.get(ids[i]));
+        ASSERT_EQUALS(i, members[i]->obj.value()["x"].numberInt());
+    }
+}
+
+TEST(WorkingSetTest, ClearResetsAndReusesMembers) {
+    WorkingSet ws;
+    std::set<WorkingSetMember*> members;
+    for (int i = 0; i < 100; ++i) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->keyData.push_back(IndexKeyDatum(BSON("a" << 1), BSON("" << i), NULL));
+        member->isSuspicious = true;
+        ws.transitionToRecordIdAndIdx(id);
+        members.insert(member);
+    }
+
+    ws.clear();
+
+    for (int i = 0; i < 100; ++i) {
+        WorkingSetMember* member = ws.get(ws.allocate());
+        ASSERT(members.count(member));
+        ASSERT_EQUALS(WorkingSetMember::INVALID, member->getState());
+        ASSERT(member->keyData.empty());
+        ASSERT_GREATER_THAN_OR_EQUALS(member->keyData.capacity(), 1U);
+        ASSERT_FALSE(member->isSuspicious);
+    }
+}
+
 }  // namespace
@@ -37,6 +37,7 @@
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
@@ -45,6 +46,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/text.h"
 
 namespace mongo {
 
@@ -52,6 +54,10 @@ namespace {
 
 const auto getFTDCController = ServiceContext::declareDecoration<std::unique_ptr<FTDCController>>();
 
+// Controller for the optional high frequency channel, see startHighFrequencyFTDC.
+const auto getHighFrequencyFTDCController =
+    ServiceContext::declareDecoration<std::unique_ptr<FTDCController>>();
+
 FTDCController* getGlobalFTDCController() {
     if (!hasGlobalServiceContext()) {
         return nullptr;
@@ -60,6 +66,14 @@ FTDCController* getGlobalFTDCController() {
     return getFTDCController(getGlobalServiceContext()).get();
 }
 
+FTDCController* getGlobalHighFrequencyFTDCController() {
+    if (!hasGlobalServiceContext()) {
+        return nullptr;
+    }
+
+    return getHighFrequencyFTDCController(getGlobalServiceContext()).get();
+}
+
 AtomicBool localEnabledFlag(FTDCConfig::kEnabledDefault);
 
 class ExportedFTDCEnabledParameter
@@ -72,6 +86,14 @@ public:
               &localEnabledFlag) {}
 
     virtual Status validate(const bool& potentialNewValue) {
+        auto highFrequencyController = getGlobalHighFrequencyFTDCController();
+        if (highFrequencyController) {
+            Status status = highFrequencyController->setEnabled(potentialNewValue);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+
         auto controller = getGlobalFTDCController();
         if (controller) {
             return controller->setEnabled(potentialNewValue);
@@ -241,6 +263,68 @@ public:
     }
 
 } exportedFTDCInterimChunkSizeParameter;
+
+/**
+ * Period of the high frequency FTDC channel. The channel is disabled when this is 0, the default.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(diagnosticDataCollectionHighFrequencyPeriodMillis, int, 0)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue != 0 && (potentialNewValue < 10 || potentialNewValue >= 1000)) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyPeriodMillis must be 0 (disabled) "
+                          "or between 10 and 999");
+        }
+
+        return Status::OK();
+    });
+
+/**
+ * Comma separated list of the serverStatus sections sampled by the high frequency FTDC channel. The
+ * defaults do not take any locks which foreground operations need.
+ */
+std::string highFrequencySections =
+    "locks,lockWaitTimeHistograms,wiredTigerConcurrentTransactions";
+
+ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>
+    exportedFTDCHighFrequencySectionsParameter(ServerParameterSet::getGlobal(),
+                                               "diagnosticDataCollectionHighFrequencySections",
+                                               &highFrequencySections);
+
+/**
+ * Starts the high frequency channel, which samples a small set of serverStatus sections into its
+ * own files under the kFTDCHighFrequencyDirectory subdirectory of 'path'. The channel uses the
+ * same compressor and file management as the main channel, but runs on its own thread so a slow
+ * main sample cannot delay it.
+ */
+void startHighFrequencyFTDC(const boost::filesystem::path& path, const FTDCConfig& mainConfig) {
+    const int periodMillis = diagnosticDataCollectionHighFrequencyPeriodMillis.load();
+    if (periodMillis == 0) {
+        return;
+    }
+
+    FTDCConfig config = mainConfig;
+    config.period = Milliseconds(periodMillis);
+
+    auto controller =
+        stdx::make_unique<FTDCController>(path / kFTDCHighFrequencyDirectory.toString(), config);
+
+    std::vector<std::string> sections;
+    for (auto&& section : StringSplitter::split(highFrequencySections, ",")) {
+        if (!section.empty()) {
+            sections.push_back(section);
+        }
+    }
+
+    controller->addPeriodicCollector(stdx::make_unique<FTDCServerStatusSectionsCollector>(
+        "serverStatusHighFrequency", std::move(sections)));
+
+    auto& staticFTDC = getHighFrequencyFTDCController(getGlobalServiceContext());
+
+    staticFTDC = std::move(controller);
+
+    staticFTDC->start();
+}
+
 }  // namespace
 
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
@@ -261,6 +345,28 @@ std::string FTDCSimpleInternalCommandCollector::name() const {
     return _name;
 }
 
+FTDCServerStatusSectionsCollector::FTDCServerStatusSectionsCollector(
+    StringData name, std::vector<std::string> sections)
+    : _name(name.toString()), _sections(std::move(sections)) {}
+
+void FTDCServerStatusSectionsCollector::collect(OperationContext* opCtx,
+                                                BSONObjBuilder& builder) {
+    // Sections are looked up on every sample since storage engine sections are registered after
+    // FTDC starts.
+    for (const auto& sectionName : _sections) {
+        auto section = findServerStatusSection(sectionName);
+        if (!section) {
+            continue;
+        }
+
+        section->appendSection(opCtx, BSONElement(), &builder);
+    }
+}
+
+std::string FTDCServerStatusSectionsCollector::name() const {
+    return _name;
+}
+
 // Register the FTDC system
 // Note: This must be run before the server parameters are parsed during startup
 // so that the FTDCController is initialized.
@@ -296,7 +402,8 @@ void startFTDC(boost::filesystem::path& path,
         "serverStatus",
         "serverStatus",
         "",
-        BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false)));
+        BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false << "opLatencies"
+                            << BSON("percentiles" << true))));
 
     registerCollectors(controller.get());
 
@@ -324,9 +431,19 @@ void startFTDC(boost::filesystem::path& path,
     staticFTDC = std::move(controller);
 
     staticFTDC->start();
+
+    if (startupMode == FTDCStartMode::kStart) {
+        startHighFrequencyFTDC(path, config);
+    }
 }
 
 void stopFTDC() {
+    auto highFrequencyController = getGlobalHighFrequencyFTDCController();
+
+    if (highFrequencyController) {
+        highFrequencyController->stop();
+    }
+
     auto controller = getGlobalFTDCController();
 
     if (controller) {
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
@@ -71,6 +72,12 @@ void startFTDC(boost::filesystem::path& path,
                FTDCStartMode startupMode,
                RegisterCollectorsFunction registerCollectors);
 
+/**
+ * Subdirectory of the FTDC directory where the high frequency channel writes its files, if enabled
+ * with the diagnosticDataCollectionHighFrequencyPeriodMillis startup parameter.
+ */
+constexpr StringData kFTDCHighFrequencyDirectory = "highFrequency"_sd;
+
 /**
  * Stop Full Time Data Capture
  *
@@ -96,4 +103,20 @@ private:
     const OpMsgRequest _request;
 };
 
+/**
+ * An FTDC Collector that generates the named server status sections directly, rather than running
+ * the whole serverStatus command. Sections which are not registered are skipped.
+ */
+class FTDCServerStatusSectionsCollector : public FTDCCollectorInterface {
+public:
+    FTDCServerStatusSectionsCollector(StringData name, std::vector<std::string> sections);
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override;
+    std::string name() const override;
+
+private:
+    std::string _name;
+    const std::vector<std::string> _sections;
+};
+
 }  // namespace mongo
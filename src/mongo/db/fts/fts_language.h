@@ -35,6 +35,7 @@
 #include "mongo/db/fts/fts_phrase_matcher.h"
 #include "mongo/db/fts/fts_unicode_phrase_matcher.h"
 #include "mongo/db/fts/fts_util.h"
+#include "mongo/db/fts/stem_cache.h"
 
 #include <string>
 
@@ -95,6 +96,13 @@ public:
      */
     virtual const FTSPhraseMatcher& getPhraseMatcher() const = 0;
 
+    /**
+     * Returns the cache of stemmed words shared by every Stemmer for this language.
+     */
+    StemCache& getStemCache() const {
+        return _stemCache;
+    }
+
     /**
      * Register std::string 'languageName' as a new language with the text index version
      * 'textIndexVersion'.  Saves the resulting language to out-argument 'languageOut'.
@@ -134,6 +142,9 @@ public:
 private:
     // std::string representation of language in canonical form.
     std::string _canonicalName;
+
+    // Languages are process-wide constants, but their stem cache fills up as words are stemmed.
+    mutable StemCache _stemCache;
 };
 
 typedef StatusWith<const FTSLanguage*> StatusWithFTSLanguage;
@@ -30,11 +30,14 @@
 
 #include "mongo/db/fts/fts_unicode_tokenizer.h"
 
+#include <algorithm>
+
 #include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
 #include "mongo/db/fts/stop_words.h"
 #include "mongo/db/fts/tokenizer.h"
+#include "mongo/db/fts/unicode/byte_vector.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/stringutils.h"
@@ -57,7 +60,16 @@ UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
 void UnicodeFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
     _pos = 0;
-    _document.resetData(document);  // Validates that document is valid UTF8.
+
+    // Most text is pure ASCII, which can be delimited and case folded a byte at a time without
+    // decoding it first. Turkish case folds 'I' to a non-ASCII codepoint, so it always decodes.
+    _isAscii =
+        _caseFoldMode != unicode::CaseFoldMode::kTurkish && unicode::String::isAscii(document);
+    if (_isAscii) {
+        _asciiDocument = document;
+    } else {
+        _document.resetData(document);  // Validates that document is valid UTF8.
+    }
 
     // Skip any leading delimiters (and handle the case where the document is entirely delimiters).
     _skipDelimiters();
@@ -65,16 +77,19 @@ void UnicodeFTSTokenizer::reset(StringData document, Options options) {
 
 bool UnicodeFTSTokenizer::moveNext() {
     while (true) {
-        if (_pos >= _document.size()) {
+        if (_pos >= _documentSize()) {
             _word = "";
             return false;
         }
 
         // Traverse through non-delimiters and build the next token.
         size_t start = _pos++;
-        while (_pos < _document.size() &&
-               (!unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage))) {
-            ++_pos;
+        if (_isAscii) {
+            _pos = _findAsciiDelimiter(_pos);
+        } else {
+            while (_pos < _document.size() && !_isDelimiter(_pos)) {
+                ++_pos;
+            }
         }
         const size_t len = _pos - start;
 
@@ -83,14 +98,23 @@ bool UnicodeFTSTokenizer::moveNext() {
 
         // Stop words are case-sensitive and diacritic sensitive, so we need them to be lower cased
         // but with diacritics not removed to check against the stop word list.
-        _word = _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
+        if (_isAscii) {
+            _word = unicode::String::caseFoldAndStripDiacritics(
+                &_wordBuf,
+                _asciiDocument.substr(start, len),
+                unicode::String::kDiacriticSensitive,
+                _caseFoldMode);
+        } else {
+            _word = _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
+        }
 
         if ((_options & kFilterStopWords) && _stopWords->isStopWord(_word)) {
             continue;
         }
 
         if (_options & kGenerateCaseSensitiveTokens) {
-            _word = _document.substrToBuf(&_wordBuf, start, len);
+            _word = _isAscii ? _asciiDocument.substr(start, len)
+                             : _document.substrToBuf(&_wordBuf, start, len);
         }
 
         // The stemmer is diacritic sensitive, so stem the word before removing diacritics.
@@ -111,11 +135,46 @@ StringData UnicodeFTSTokenizer::get() const {
 }
 
 void UnicodeFTSTokenizer::_skipDelimiters() {
-    while (_pos < _document.size() &&
-           unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage)) {
+    while (_pos < _documentSize() && _isDelimiter(_pos)) {
         ++_pos;
     }
 }
 
+bool UnicodeFTSTokenizer::_isDelimiter(size_t pos) const {
+    const char32_t codepoint =
+        _isAscii ? static_cast<unsigned char>(_asciiDocument[pos]) : _document[pos];
+    return unicode::codepointIsDelimiter(codepoint, _delimListLanguage);
+}
+
+size_t UnicodeFTSTokenizer::_findAsciiDelimiter(size_t pos) const {
+    const size_t size = _asciiDocument.size();
+    while (pos < size) {
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+        // ASCII letters and digits are never delimiters, so skip over them 16 bytes at a time and
+        // only look up the other characters.
+        using unicode::ByteVector;
+        if (size - pos >= ByteVector::size) {
+            auto bytes = ByteVector::load(_asciiDocument.rawData() + pos);
+            auto lowered = bytes | ByteVector(0x20);
+            ByteVector::Mask alnumMask =
+                ((lowered.compareGT('a' - 1) & lowered.compareLT('z' + 1)) |
+                 (bytes.compareGT('0' - 1) & bytes.compareLT('9' + 1)))
+                    .maskAny();
+            const uint32_t alnumBytes =
+                ByteVector::countInitialZeros(static_cast<ByteVector::Mask>(~alnumMask));
+            pos += std::min<uint32_t>(alnumBytes, ByteVector::size);
+            if (alnumBytes >= static_cast<uint32_t>(ByteVector::size)) {
+                continue;
+            }
+        }
+#endif
+        if (_isDelimiter(pos)) {
+            return pos;
+        }
+        ++pos;
+    }
+    return size;
+}
+
 }  // namespace fts
 }  // namespace mongo
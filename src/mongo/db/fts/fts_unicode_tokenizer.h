@@ -53,6 +53,9 @@ class StopWords;
  *
  * For each word returns a stem version of a word optimized for full text indexing.
  * Optionally supports returning case sensitive search terms.
+ *
+ * Documents which are entirely ASCII are tokenized directly from their bytes rather than being
+ * decoded to UTF-32, in which case the document must stay valid until the next call to reset().
  */
 class UnicodeFTSTokenizer final : public FTSTokenizer {
     MONGO_DISALLOW_COPYING(UnicodeFTSTokenizer);
@@ -73,6 +76,24 @@ private:
      */
     void _skipDelimiters();
 
+    /**
+     * Returns the number of codepoints in the document.
+     */
+    size_t _documentSize() const {
+        return _isAscii ? _asciiDocument.size() : _document.size();
+    }
+
+    /**
+     * Returns whether the codepoint at 'pos' in the document is a delimiter.
+     */
+    bool _isDelimiter(size_t pos) const;
+
+    /**
+     * Returns the position of the first delimiter at or after 'pos' in an ASCII document, or the
+     * size of the document if there is none.
+     */
+    size_t _findAsciiDelimiter(size_t pos) const;
+
     const FTSLanguage* const _language;
     const Stemmer _stemmer;
     const StopWords* const _stopWords;
@@ -80,6 +101,12 @@ private:
     const unicode::CaseFoldMode _caseFoldMode;
 
     unicode::String _document;
+
+    // Whether the document is pure ASCII, in which case it is read from '_asciiDocument' instead of
+    // being decoded into '_document'.
+    bool _isAscii = false;
+    StringData _asciiDocument;
+
     size_t _pos;
     StringData _word;
     Options _options;
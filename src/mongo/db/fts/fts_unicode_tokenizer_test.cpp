@@ -241,5 +241,49 @@ TEST(FtsUnicodeTokenizer, FrenchStopWordsAndDiacriticSensitive) {
     ASSERT_EQUALS("excit", terms[4]);
 }
 
+// Ensure that ASCII documents, which skip decoding, tokenize the same way as documents which need
+// it. Appending a non-ASCII word forces the latter.
+TEST(FtsUnicodeTokenizer, AsciiMatchesUnicode) {
+    const std::string ascii =
+        "The QUICK brown-fox's 2 dogs were RUNNING_around... (again)   and\tagain; "
+        "antidisestablishmentarianism is a word^with `odd` punctuation!";
+    const std::string unicode = ascii + " caf\xc3\xa9";
+
+    const FTSTokenizer::Options allOptions[] = {
+        FTSTokenizer::kNone,
+        FTSTokenizer::kFilterStopWords,
+        FTSTokenizer::kGenerateCaseSensitiveTokens,
+        FTSTokenizer::kGenerateDiacriticSensitiveTokens,
+        FTSTokenizer::kFilterStopWords | FTSTokenizer::kGenerateCaseSensitiveTokens |
+            FTSTokenizer::kGenerateDiacriticSensitiveTokens,
+    };
+
+    for (const char* language : {"english", "french", "none"}) {
+        for (auto options : allOptions) {
+            std::vector<std::string> asciiTerms =
+                tokenizeString(ascii.c_str(), language, options);
+            std::vector<std::string> unicodeTerms =
+                tokenizeString(unicode.c_str(), language, options);
+
+            ASSERT_EQUALS(asciiTerms.size() + 1, unicodeTerms.size());
+            unicodeTerms.pop_back();
+            ASSERT(asciiTerms == unicodeTerms) << language << " " << static_cast<int>(options);
+        }
+    }
+}
+
+// Ensure that words stemmed through the stem cache match the first stemming.
+TEST(FtsUnicodeTokenizer, RepeatedWordsStemTheSame) {
+    std::vector<std::string> terms = tokenizeString(
+        "running Running runners running RUNNING", "english", FTSTokenizer::kNone);
+
+    ASSERT_EQUALS(5U, terms.size());
+    ASSERT_EQUALS("run", terms[0]);
+    ASSERT_EQUALS("run", terms[1]);
+    ASSERT_EQUALS("runner", terms[2]);
+    ASSERT_EQUALS("run", terms[3]);
+    ASSERT_EQUALS("run", terms[4]);
+}
+
 }  // namespace fts
 }  // namespace mongo
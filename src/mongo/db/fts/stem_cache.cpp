@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/fts/stem_cache.h"
+
+namespace mongo {
+namespace fts {
+
+const size_t StemCache::kMaxEntries;
+const size_t StemCache::kMaxWordSize;
+
+StemCache::Shard& StemCache::_getShard(StringData word) {
+    // The shard's hash table buckets words by the low bits of the same hash, so pick the shard
+    // from the high bits.
+    static_assert(kNumShards == 16, "shard selection assumes 16 shards");
+    return _shards[StringMapTraits::hash(word) >> 28];
+}
+
+bool StemCache::find(StringData word, std::string* stemOut) {
+    if (word.size() > kMaxWordSize) {
+        return false;
+    }
+
+    Shard& shard = _getShard(word);
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+    auto it = shard.index.find(word);
+    if (it == shard.index.end()) {
+        return false;
+    }
+
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    stemOut->assign(it->second->second);
+    return true;
+}
+
+void StemCache::insert(StringData word, StringData stem) {
+    if (word.size() > kMaxWordSize) {
+        return;
+    }
+
+    Shard& shard = _getShard(word);
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+    if (shard.index.find(word) != shard.index.end()) {
+        // Another stemmer cached the same word concurrently.
+        return;
+    }
+
+    if (shard.entries.size() >= kMaxEntriesPerShard) {
+        shard.index.erase(shard.entries.back().first);
+        shard.entries.pop_back();
+    }
+
+    shard.entries.emplace_front(word.toString(), stem.toString());
+    shard.index[word] = shard.entries.begin();
+}
+
+size_t StemCache::size() const {
+    size_t size = 0;
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        size += shard.entries.size();
+    }
+    return size;
+}
+
+}  // namespace fts
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <list>
+#include <string>
+#include <utility>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace fts {
+
+/**
+ * A bounded cache of words and their stems, shared by all of the stemmers for one language. Text
+ * tends to reuse a small vocabulary, so most words only need to go through the Snowball stemmer
+ * once.
+ *
+ * The cache is split into shards with their own locks and least recently used lists, so that
+ * concurrent index builds and queries rarely contend. Words longer than kMaxWordSize bytes are
+ * not cached.
+ */
+class StemCache {
+    MONGO_DISALLOW_COPYING(StemCache);
+
+public:
+    static const size_t kMaxEntries = 8 * 1024;
+    static const size_t kMaxWordSize = 64;
+
+    StemCache() = default;
+
+    /**
+     * Copies the cached stem of 'word' into 'stemOut' and returns true, or returns false if 'word'
+     * is not cached.
+     */
+    bool find(StringData word, std::string* stemOut);
+
+    /**
+     * Caches 'stem' as the stem of 'word', evicting the least recently used word in its shard if
+     * the shard is full.
+     */
+    void insert(StringData word, StringData stem);
+
+    /**
+     * Returns the number of cached words.
+     */
+    size_t size() const;
+
+private:
+    static const size_t kNumShards = 16;
+    static const size_t kMaxEntriesPerShard = kMaxEntries / kNumShards;
+
+    struct Shard {
+        // Pairs of (word, stem), most recently used first.
+        using EntryList = std::list<std::pair<std::string, std::string>>;
+
+        mutable stdx::mutex mutex;
+        EntryList entries;
+        StringMap<EntryList::iterator> index;
+    };
+
+    Shard& _getShard(StringData word);
+
+    std::array<Shard, kNumShards> _shards;
+};
+
+}  // namespace fts
+}  // namespace mongo
@@ -0,0 +1,74 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/fts/stem_cache.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace fts {
+namespace {
+
+TEST(StemCacheTest, FindReturnsInsertedStem) {
+    StemCache cache;
+    std::string stem;
+    ASSERT_FALSE(cache.find("running", &stem));
+
+    cache.insert("running", "run");
+    ASSERT_TRUE(cache.find("running", &stem));
+    ASSERT_EQUALS("run", stem);
+    ASSERT_FALSE(cache.find("runs", &stem));
+}
+
+TEST(StemCacheTest, DoesNotCacheLongWords) {
+    StemCache cache;
+    const std::string longWord(StemCache::kMaxWordSize + 1, 'a');
+    cache.insert(longWord, "a");
+
+    std::string stem;
+    ASSERT_FALSE(cache.find(longWord, &stem));
+    ASSERT_EQUALS(0U, cache.size());
+}
+
+TEST(StemCacheTest, SizeIsBounded) {
+    StemCache cache;
+    for (size_t i = 0; i < 4 * StemCache::kMaxEntries; ++i) {
+        cache.insert(std::to_string(i), "x");
+    }
+    ASSERT_LTE(cache.size(), StemCache::kMaxEntries);
+
+    // The most recently inserted word is always kept.
+    std::string stem;
+    ASSERT_TRUE(cache.find(std::to_string(4 * StemCache::kMaxEntries - 1), &stem));
+}
+
+}  // namespace
+}  // namespace fts
+}  // namespace mongo
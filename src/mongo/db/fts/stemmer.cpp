@@ -37,11 +37,9 @@ namespace mongo {
 
 namespace fts {
 
-Stemmer::Stemmer(const FTSLanguage* language) {
-    _stemmer = NULL;
-    if (language->str() != "none")
-        _stemmer = sb_stemmer_new(language->str().c_str(), "UTF_8");
-}
+Stemmer::Stemmer(const FTSLanguage* language)
+    : _language(language),
+      _cache(language->str() != "none" ? &language->getStemCache() : nullptr) {}
 
 Stemmer::~Stemmer() {
     if (_stemmer) {
@@ -51,6 +49,17 @@ Stemmer::~Stemmer() {
 }
 
 StringData Stemmer::stem(StringData word) const {
+    if (!_cache)
+        return word;
+
+    if (_cache->find(word, &_cachedStem))
+        return _cachedStem;
+
+    if (!_stemmerCreated) {
+        _stemmer = sb_stemmer_new(_language->str().c_str(), "UTF_8");
+        _stemmerCreated = true;
+    }
+
     if (!_stemmer)
         return word;
 
@@ -62,7 +71,9 @@ StringData Stemmer::stem(StringData word) const {
         MONGO_UNREACHABLE;
     }
 
-    return StringData((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    StringData stemmed((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    _cache->insert(word, stemmed);
+    return stemmed;
 }
 }
 }
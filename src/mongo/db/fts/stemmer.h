@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
@@ -61,7 +63,17 @@ public:
     StringData stem(StringData word) const;
 
 private:
-    struct sb_stemmer* _stemmer;
+    const FTSLanguage* const _language;
+
+    // The language's shared stem cache, or null if the language does not stem words.
+    StemCache* const _cache;
+
+    // The Snowball stemmer is only created once a word misses the cache.
+    mutable struct sb_stemmer* _stemmer = nullptr;
+    mutable bool _stemmerCreated = false;
+
+    // Holds the last stem returned from the cache.
+    mutable std::string _cachedStem;
 };
 }
 }
@@ -148,6 +148,24 @@ StringData String::toLowerToBuf(StackBufBuilder* buffer,
 }
 
 
+bool String::isAscii(StringData utf8) {
+    auto inputIt = utf8.begin();
+    const auto endIt = utf8.end();
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    for (; size_t(endIt - inputIt) >= ByteVector::size; inputIt += ByteVector::size) {
+        if (ByteVector::load(&*inputIt).maskHigh()) {
+            return false;
+        }
+    }
+#endif
+    for (; inputIt != endIt; ++inputIt) {
+        if (static_cast<uint8_t>(*inputIt) > 0x7f) {
+            return false;
+        }
+    }
+    return true;
+}
+
 StringData String::caseFoldAndStripDiacritics(StackBufBuilder* buffer,
                                               StringData utf8,
                                               SubstrMatchOptions options,
@@ -142,6 +142,11 @@ public:
                                                  SubstrMatchOptions options,
                                                  CaseFoldMode mode);
 
+    /**
+     * Returns true if the utf8 input string is entirely ASCII, so that each byte is a codepoint.
+     */
+    static bool isAscii(StringData utf8);
+
 private:
     /**
      * Helper method for converting a UTF-8 string to a UTF-32 string.
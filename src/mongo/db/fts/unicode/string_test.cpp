@@ -157,6 +157,20 @@ TEST(UnicodeString, CaseFoldingAndRemoveDiacritics) {
     TEST_CASE_FOLD_AND_STRIP_DIACRITICS(UTF8("cafe"), test3, 0, kNormal);
 }
 
+TEST(UnicodeString, IsAscii) {
+    ASSERT_TRUE(String::isAscii(""));
+    ASSERT_TRUE(String::isAscii("abc"));
+    ASSERT_TRUE(String::isAscii("The quick brown fox jumps over the lazy dog, 0123456789!"));
+    ASSERT_FALSE(String::isAscii(UTF8("café")));
+
+    // A non-ASCII byte must be found wherever it falls relative to the vectorized blocks.
+    for (size_t pos = 0; pos < 40; ++pos) {
+        std::string str(40, 'a');
+        str[pos] = C(0xC3);
+        ASSERT_FALSE(String::isAscii(str)) << pos;
+    }
+}
+
 TEST(UnicodeString, SubstringMatch) {
     std::string str = UTF8("Одумайся! Престол свой сохрани; И ярость укроти.");
 
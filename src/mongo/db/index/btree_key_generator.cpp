@@ -28,8 +28,10 @@
 
 #include "mongo/db/index/btree_key_generator.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 
+#include "mongo/bson/bson_field_index.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
@@ -248,12 +250,14 @@ BtreeKeyGeneratorV1::BtreeKeyGeneratorV1(std::vector<const char*> fieldNames,
     }
 }
 
-BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
+BSONElement BtreeKeyGeneratorV1::extractNextElement(BSONFieldIndex* objFields,
                                                     const PositionalPathInfo& positionalInfo,
                                                     const char** field,
                                                     bool* arrayNestedArray) const {
-    std::string firstField = mongoutils::str::before(*field, '.');
-    bool haveObjField = !obj.getField(firstField).eoo();
+    const char* dot = strchr(*field, '.');
+    StringData firstField = dot ? StringData(*field, dot - *field) : StringData(*field);
+    BSONElement objField = objFields->getField(firstField);
+    bool haveObjField = !objField.eoo();
     BSONElement arrField = positionalInfo.positionallyIndexedElt;
 
     // An index component field name cannot exist in both a document
@@ -269,7 +273,15 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
 
     *arrayNestedArray = false;
     if (haveObjField) {
-        return dps::extractElementAtPathOrArrayAlongPath(obj, *field);
+        // Continue from the first path component the way
+        // dps::extractElementAtPathOrArrayAlongPath() would, without looking it up again.
+        *field = dot ? dot + 1 : *field + firstField.size();
+        if (objField.type() == Array || **field == '\0') {
+            return objField;
+        } else if (objField.type() == Object) {
+            return dps::extractElementAtPathOrArrayAlongPath(objField.embeddedObject(), *field);
+        }
+        return BSONElement();
     } else if (positionalInfo.hasPositionallyIndexedElt()) {
         if (arrField.type() == Array) {
             *arrayNestedArray = true;
@@ -283,7 +295,7 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
 void BtreeKeyGeneratorV1::_getKeysArrEltFixed(std::vector<const char*>* fieldNames,
                                               std::vector<BSONElement>* fixed,
                                               const BSONElement& arrEntry,
-                                              BSONObjSet* keys,
+                                              KeyArena* keys,
                                               unsigned numNotFound,
                                               const BSONElement& arrObjElt,
                                               const std::set<size_t>& arrIdxs,
@@ -343,15 +355,64 @@ void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
         invariant(multikeyPaths->empty());
         multikeyPaths->resize(fieldNames.size());
     }
-    getKeysImplWithArray(
-        std::move(fieldNames), std::move(fixed), obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
+    KeyArena arena(_arenaSizeTracker.getSize());
+    getKeysImplWithArray(std::move(fieldNames),
+                         std::move(fixed),
+                         obj,
+                         &arena,
+                         0,
+                         _emptyPositionalInfo,
+                         multikeyPaths);
+    _arenaSizeTracker.got(arena.buf.len());
+    _copyKeysToSet(&arena, keys);
+}
+
+void BtreeKeyGeneratorV1::_appendKey(const std::vector<BSONElement>& fixed,
+                                     KeyArena* keys) const {
+    keys->offsets.push_back(keys->buf.len());
+    BSONObjBuilder b(keys->buf);
+    for (const auto& elt : fixed) {
+        CollationIndexKey::collationAwareIndexKeyAppend(elt, _collator, &b);
+    }
+    b.done();
+}
+
+void BtreeKeyGeneratorV1::_copyKeysToSet(KeyArena* arena, BSONObjSet* keys) {
+    if (arena->offsets.empty()) {
+        return;
+    }
+
+    std::vector<BSONObj> generated;
+    generated.reserve(arena->offsets.size());
+    for (int offset : arena->offsets) {
+        generated.push_back(BSONObj(arena->buf.buf() + offset));
+    }
+
+    // Sorting first lets every insertion go at the end of 'keys' in constant time, rather than
+    // searching the tree once per generated key. The sort is stable so that of several equivalent
+    // keys, such as those for 0 and NumberLong(0), the first generated is kept, as when the keys
+    // were inserted one at a time.
+    const auto lessThan = keys->key_comp();
+    std::stable_sort(generated.begin(), generated.end(), lessThan);
+    auto last = std::unique(generated.begin(),
+                            generated.end(),
+                            [&](const BSONObj& lhs, const BSONObj& rhs) {
+                                return !lessThan(lhs, rhs) && !lessThan(rhs, lhs);
+                            });
+
+    // Each distinct key gets a buffer of its own. Keys sharing the arena would keep all of it alive
+    // for as long as any one of them, such as in the sorter of an index build, which only accounts
+    // for each key's own size.
+    for (auto it = generated.begin(); it != last; ++it) {
+        keys->insert(keys->end(), it->copy());
+    }
 }
 
 void BtreeKeyGeneratorV1::getKeysImplWithArray(
     std::vector<const char*> fieldNames,
     std::vector<BSONElement> fixed,
     const BSONObj& obj,
-    BSONObjSet* keys,
+    KeyArena* keys,
     unsigned numNotFound,
     const std::vector<PositionalPathInfo>& positionalInfo,
     MultikeyPaths* multikeyPaths) const {
@@ -383,6 +444,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
     // std::vector<boost::optional<size_t>>{{1U}, boost::none}.
     std::vector<boost::optional<size_t>> arrComponents(fieldNames.size());
 
+    BSONFieldIndex objFields(obj);
     bool mayExpandArrayUnembedded = true;
     for (size_t i = 0; i < fieldNames.size(); ++i) {
         if (*fieldNames[i] == '\0') {
@@ -392,7 +454,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
         bool arrayNestedArray;
         // Extract element matching fieldName[ i ] from object xor array.
         BSONElement e =
-            extractNextElement(obj, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
+            extractNextElement(&objFields, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
 
         if (e.eoo()) {
             // if field not present, set to null
@@ -423,11 +485,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
         if (_isSparse && numNotFound == fieldNames.size()) {
             return;
         }
-        BSONObjBuilder b(_sizeTracker);
-        for (std::vector<BSONElement>::iterator i = fixed.begin(); i != fixed.end(); ++i) {
-            CollationIndexKey::collationAwareIndexKeyAppend(*i, _collator, &b);
-        }
-        keys->insert(b.obj());
+        _appendKey(fixed, keys);
     } else if (arrElt.embeddedObject().firstElement().eoo()) {
         // We've encountered an empty array.
         if (multikeyPaths && mayExpandArrayUnembedded) {
@@ -39,6 +39,7 @@
 
 namespace mongo {
 
+class BSONFieldIndex;
 class CollatorInterface;
 
 /**
@@ -112,6 +113,21 @@ public:
     virtual ~BtreeKeyGeneratorV1() {}
 
 private:
+    /**
+     * The keys generated for a single document. They are encoded back to back in one buffer
+     * rather than each in an allocation of its own, and are only sorted and deduplicated once key
+     * generation is done. Only the distinct keys are then copied out, each into its own buffer.
+     * Large multikey documents can generate hundreds of keys, many of them duplicates.
+     */
+    struct KeyArena {
+        explicit KeyArena(int initialSize) : buf(initialSize) {}
+
+        BufBuilder buf;
+
+        // The offset in 'buf' at which each key starts, in the order the keys were generated.
+        std::vector<int> offsets;
+    };
+
     /**
      * Stores info regarding traversal of a positional path. A path through a document is
      * considered positional if this path element names an array element. Generally this means
@@ -191,14 +207,16 @@ private:
     void getKeysImplWithArray(std::vector<const char*> fieldNames,
                               std::vector<BSONElement> fixed,
                               const BSONObj& obj,
-                              BSONObjSet* keys,
+                              KeyArena* keys,
                               unsigned numNotFound,
                               const std::vector<PositionalPathInfo>& positionalInfo,
                               MultikeyPaths* multikeyPaths) const;
     /**
      * A call to getKeysImplWithArray() begins by calling this for each field in the key pattern. It
      * traverses the path '*field' in 'obj' until either reaching the end of the path or an array
-     * element.
+     * element. 'objFields' looks up the top level fields of 'obj', and is shared by the calls for
+     * every field of the key pattern, so that compound indexes on large documents do not rescan
+     * 'obj' for each of their fields.
      *
      * The 'positionalInfo' arg is used for handling a field path where 'obj' has an
      * array indexed by position. See the comments for PositionalPathInfo for more detail.
@@ -228,7 +246,7 @@ private:
      *   set '*field' to "". Similarly, it will return elemtn 99 and set '*field' to "" for
      *   the second array element.
      */
-    BSONElement extractNextElement(const BSONObj& obj,
+    BSONElement extractNextElement(BSONFieldIndex* objFields,
                                    const PositionalPathInfo& positionalInfo,
                                    const char** field,
                                    bool* arrayNestedArray) const;
@@ -241,7 +259,7 @@ private:
     void _getKeysArrEltFixed(std::vector<const char*>* fieldNames,
                              std::vector<BSONElement>* fixed,
                              const BSONElement& arrEntry,
-                             BSONObjSet* keys,
+                             KeyArena* keys,
                              unsigned numNotFound,
                              const BSONElement& arrObjElt,
                              const std::set<size_t>& arrIdxs,
@@ -249,8 +267,22 @@ private:
                              const std::vector<PositionalPathInfo>& positionalInfo,
                              MultikeyPaths* multikeyPaths) const;
 
+    /**
+     * Appends the key made of the elements in 'fixed' to 'keys'.
+     */
+    void _appendKey(const std::vector<BSONElement>& fixed, KeyArena* keys) const;
+
+    /**
+     * Inserts copies of the keys accumulated in 'arena' into 'keys', without duplicates. The
+     * inserted keys own their buffers, so the arena may be discarded afterwards.
+     */
+    static void _copyKeysToSet(KeyArena* arena, BSONObjSet* keys);
+
     const std::vector<PositionalPathInfo> _emptyPositionalInfo;
 
+    // Sizes the buffer of each KeyArena after the recent documents' keys.
+    mutable BSONSizeTracker _arenaSizeTracker;
+
     // A vector with size equal to the number of elements in the index key pattern. Each element in
     // the vector is the number of path components in the indexed field.
     std::vector<size_t> _pathLengths;
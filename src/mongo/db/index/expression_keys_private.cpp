@@ -224,6 +224,73 @@ bool getS2LiteralKeys(const BSONElementSet& elements,
     return foundIndexedArrayValue;
 }
 
+//
+// Helper functions for getWildcardKeys
+//
+
+/**
+ * Adds keys for the value 'elt' at 'path' and everything beneath it. Objects are descended into,
+ * the elements of an array are indexed under the path of the array itself, and every scalar
+ * produces one key. 'inArray' is true for the elements of an array, whose own array elements are
+ * not indexed since the matcher does not traverse nested arrays either.
+ */
+void getWildcardKeysForElement(const BSONElement& elt,
+                               const string& path,
+                               bool inArray,
+                               const CollatorInterface* collator,
+                               BSONObjSet* keys) {
+    switch (elt.type()) {
+        case Object:
+            for (auto&& child : elt.embeddedObject()) {
+                getWildcardKeysForElement(
+                    child, path + "." + child.fieldName(), false, collator, keys);
+            }
+            return;
+        case Array:
+            if (inArray) {
+                return;
+            }
+            for (auto&& child : elt.embeddedObject()) {
+                getWildcardKeysForElement(child, path, true, collator, keys);
+            }
+            return;
+        default: {
+            BSONObjBuilder keyBuilder;
+            keyBuilder.append("", path);
+            CollationIndexKey::collationAwareIndexKeyAppend(elt, collator, &keyBuilder);
+            keys->insert(keyBuilder.obj());
+        }
+    }
+}
+
+/**
+ * Finds the values at 'prefix' in 'obj', starting from path component 'part', and adds keys for
+ * everything beneath them. Arrays along the prefix are traversed one level deep.
+ */
+void getWildcardKeysUnderPrefix(const BSONObj& obj,
+                                const FieldRef& prefix,
+                                size_t part,
+                                const CollatorInterface* collator,
+                                BSONObjSet* keys) {
+    BSONElement elt = obj.getField(prefix.getPart(part));
+    if (elt.eoo()) {
+        return;
+    }
+
+    if (part + 1 == prefix.numParts()) {
+        getWildcardKeysForElement(elt, prefix.dottedField().toString(), false, collator, keys);
+    } else if (elt.type() == Object) {
+        getWildcardKeysUnderPrefix(elt.embeddedObject(), prefix, part + 1, collator, keys);
+    } else if (elt.type() == Array) {
+        for (auto&& child : elt.embeddedObject()) {
+            if (child.type() == Object) {
+                getWildcardKeysUnderPrefix(
+                    child.embeddedObject(), prefix, part + 1, collator, keys);
+            }
+        }
+    }
+}
+
 }  // namespace
 
 namespace mongo {
@@ -338,35 +405,56 @@ void ExpressionKeysPrivate::getFTSKeys(const BSONObj& obj,
 
 // static
 void ExpressionKeysPrivate::getHashKeys(const BSONObj& obj,
-                                        const string& hashedField,
+                                        const BSONObj& keyPattern,
                                         HashSeed seed,
                                         int hashVersion,
                                         bool isSparse,
                                         const CollatorInterface* collator,
                                         BSONObjSet* keys) {
-    const char* cstr = hashedField.c_str();
-    BSONElement fieldVal = dps::extractElementAtPath(obj, cstr);
+    static const BSONObj nullObj = BSON("" << BSONNULL);
+
+    BSONObjBuilder keyBuilder;
+    bool hasFieldValue = false;
+    for (auto&& keyElt : keyPattern) {
+        BSONElement fieldVal = dps::extractElementAtPath(obj, keyElt.fieldName());
+
+        uassert(16766,
+                str::stream() << "Error: hashed indexes do not currently support array values. "
+                                 "Found array at path: "
+                              << keyElt.fieldNameStringData(),
+                fieldVal.type() != Array);
+
+        if (fieldVal.eoo()) {
+            fieldVal = nullObj.firstElement();
+        } else {
+            hasFieldValue = true;
+        }
 
-    // Convert strings to comparison keys.
-    BSONObj fieldValObj;
-    if (!fieldVal.eoo()) {
+        if (keyElt.type() != String) {
+            CollationIndexKey::collationAwareIndexKeyAppend(fieldVal, collator, &keyBuilder);
+            continue;
+        }
+
+        // Convert strings to comparison keys before hashing them.
         BSONObjBuilder bob;
         CollationIndexKey::collationAwareIndexKeyAppend(fieldVal, collator, &bob);
-        fieldValObj = bob.obj();
-        fieldVal = fieldValObj.firstElement();
+        BSONObj fieldValObj = bob.obj();
+        keyBuilder.append("", makeSingleHashKey(fieldValObj.firstElement(), seed, hashVersion));
     }
 
-    uassert(16766,
-            "Error: hashed indexes do not currently support array values",
-            fieldVal.type() != Array);
-
-    if (!fieldVal.eoo()) {
-        BSONObj key = BSON("" << makeSingleHashKey(fieldVal, seed, hashVersion));
-        keys->insert(key);
-    } else if (!isSparse) {
-        BSONObj nullObj = BSON("" << BSONNULL);
-        keys->insert(BSON("" << makeSingleHashKey(nullObj.firstElement(), seed, hashVersion)));
+    if (isSparse && !hasFieldValue) {
+        return;
     }
+    keys->insert(keyBuilder.obj());
+}
+
+// static
+void ExpressionKeysPrivate::getWildcardKeys(const BSONObj& obj,
+                                            const BSONObj& keyPattern,
+                                            const CollatorInterface* collator,
+                                            BSONObjSet* keys) {
+    const FieldRef prefix(keyPattern.firstElementFieldName());
+    getWildcardKeysUnderPrefix(obj, prefix, 0, collator, keys);
 }
 
 // static
@@ -71,10 +71,12 @@ public:
     //
 
     /**
-     * Generates keys for hash access method.
+     * Generates keys for hash access method. The field of 'keyPattern' whose value is "hashed"
+     * contributes the hash of its value to the key, and every other field its value as is.
+     * Missing fields are indexed as null. Array values are not supported.
      */
     static void getHashKeys(const BSONObj& obj,
-                            const std::string& hashedField,
+                            const BSONObj& keyPattern,
                             HashSeed seed,
                             int hashVersion,
                             bool isSparse,
@@ -88,6 +90,22 @@ public:
      */
     static long long int makeSingleHashKey(const BSONElement& e, HashSeed seed, int v);
 
+    //
+    // Wildcard
+    //
+
+    /**
+     * Generates keys for wildcard access method. Every scalar value at or beneath the path of the
+     * single field of 'keyPattern' produces a key {"": <path>, "": <value>}, where <path> is the
+     * dotted path of the value without any array positions. Array elements are indexed under the
+     * path of their array. Documents without the path, empty objects and empty or nested arrays
+     * produce no keys.
+     */
+    static void getWildcardKeys(const BSONObj& obj,
+                                const BSONObj& keyPattern,
+                                const CollatorInterface* collator,
+                                BSONObjSet* keys);
+
     //
     // Haystack
     //
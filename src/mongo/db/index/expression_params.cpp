@@ -90,10 +90,15 @@ void ExpressionParams::parseHashParams(const BSONObj& infoObj,
     // the value of "hashversion" is not a number
     *versionOut = infoObj["hashVersion"].numberInt();
 
-    // Get the hashfield name
-    BSONElement firstElt = infoObj.getObjectField("key").firstElement();
-    massert(16765, "error: no hashed index field", firstElt.str().compare(IndexNames::HASHED) == 0);
-    *fieldOut = firstElt.fieldName();
+    // Get the hashfield name. In a compound hashed index it may be preceded by ordinary
+    // ascending or descending fields.
+    for (auto&& keyElt : infoObj.getObjectField("key")) {
+        if (keyElt.type() == String && keyElt.valueStringData() == IndexNames::HASHED) {
+            *fieldOut = keyElt.fieldName();
+            return;
+        }
+    }
+    msgasserted(16765, "error: no hashed index field");
 }
 
 void ExpressionParams::parseHaystackParams(const BSONObj& infoObj,
@@ -39,10 +39,15 @@ HashAccessMethod::HashAccessMethod(IndexCatalogEntry* btreeState, SortedDataInte
     : IndexAccessMethod(btreeState, btree) {
     const IndexDescriptor* descriptor = btreeState->descriptor();
 
-    // We can change these if the single-field limitation is lifted later.
-    uassert(16763,
-            "Currently only single field hashed index supported.",
-            1 == descriptor->getNumFields());
+    // Exactly one field is hashed. Any others are ordinary ascending or descending fields, which
+    // lets the index serve equality on the hashed field together with ranges on the rest.
+    int numHashedFields = 0;
+    for (auto&& keyElt : descriptor->keyPattern()) {
+        if (keyElt.type() == String) {
+            ++numHashedFields;
+        }
+    }
+    uassert(16763, "A hashed index must have exactly one hashed field.", 1 == numHashedFields);
 
     uassert(16764,
             "Currently hashed indexes cannot guarantee uniqueness. Use a regular index.",
@@ -56,8 +61,13 @@ HashAccessMethod::HashAccessMethod(IndexCatalogEntry* btreeState, SortedDataInte
 void HashAccessMethod::doGetKeys(const BSONObj& obj,
                                  BSONObjSet* keys,
                                  MultikeyPaths* multikeyPaths) const {
-    ExpressionKeysPrivate::getHashKeys(
-        obj, _hashedField, _seed, _hashVersion, _descriptor->isSparse(), _collator, keys);
+    ExpressionKeysPrivate::getHashKeys(obj,
+                                       _descriptor->keyPattern(),
+                                       _seed,
+                                       _hashVersion,
+                                       _descriptor->isSparse(),
+                                       _collator,
+                                       keys);
 }
 
 }  // namespace mongo
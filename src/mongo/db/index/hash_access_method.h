@@ -41,7 +41,8 @@ namespace mongo {
 class CollatorInterface;
 
 /**
- * This is the access method for "hashed" indices.
+ * This is the access method for "hashed" indices. Besides the single hashed field, the key pattern
+ * may contain ordinary ascending or descending fields, e.g. {tenant: "hashed", ts: 1}.
  */
 class HashAccessMethod : public IndexAccessMethod {
 public:
@@ -56,7 +57,7 @@ private:
      */
     void doGetKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const final;
 
-    // Only one of our fields is hashed.  This is the field name for it.
+    // Exactly one of our fields is hashed.  This is the field name for it.
     std::string _hashedField;
 
     // _seed defaults to zero.
@@ -48,6 +48,8 @@ namespace {
 
 const HashSeed kHashSeed = 0;
 const int kHashVersion = 0;
+const BSONObj kHashedKeyPattern = BSON("a"
+                                       << "hashed");
 
 std::string dumpKeyset(const BSONObjSet& objs) {
     std::stringstream ss;
@@ -88,7 +90,7 @@ TEST(HashKeyGeneratorTest, CollationAppliedBeforeHashing) {
     BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     ExpressionKeysPrivate::getHashKeys(
-        obj, "a", kHashSeed, kHashVersion, false, &collator, &actualKeys);
+        obj, kHashedKeyPattern, kHashSeed, kHashVersion, false, &collator, &actualKeys);
 
     BSONObj backwardsObj = fromjson("{a: 'gnirts'}");
     BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
@@ -102,7 +104,7 @@ TEST(HashKeyGeneratorTest, CollationDoesNotAffectNonStringFields) {
     BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     ExpressionKeysPrivate::getHashKeys(
-        obj, "a", kHashSeed, kHashVersion, false, &collator, &actualKeys);
+        obj, kHashedKeyPattern, kHashSeed, kHashVersion, false, &collator, &actualKeys);
 
     BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     expectedKeys.insert(makeHashKey(obj["a"]));
@@ -116,7 +118,7 @@ TEST(HashKeyGeneratorTest, CollatorAppliedBeforeHashingNestedObject) {
     BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     ExpressionKeysPrivate::getHashKeys(
-        obj, "a", kHashSeed, kHashVersion, false, &collator, &actualKeys);
+        obj, kHashedKeyPattern, kHashSeed, kHashVersion, false, &collator, &actualKeys);
 
     BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     expectedKeys.insert(makeHashKey(backwardsObj["a"]));
@@ -128,7 +130,7 @@ TEST(HashKeyGeneratorTest, NoCollation) {
     BSONObj obj = fromjson("{a: 'string'}");
     BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     ExpressionKeysPrivate::getHashKeys(
-        obj, "a", kHashSeed, kHashVersion, false, nullptr, &actualKeys);
+        obj, kHashedKeyPattern, kHashSeed, kHashVersion, false, nullptr, &actualKeys);
 
     BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     expectedKeys.insert(makeHashKey(obj["a"]));
@@ -136,4 +138,80 @@ TEST(HashKeyGeneratorTest, NoCollation) {
     ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
 }
 
+TEST(HashKeyGeneratorTest, CompoundKeyHashesOnlyTheHashedField) {
+    BSONObj obj = fromjson("{tenant: 'acme', ts: 5, other: 1}");
+    BSONObj keyPattern = fromjson("{tenant: 'hashed', ts: -1}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ExpressionKeysPrivate::getHashKeys(
+        obj, keyPattern, kHashSeed, kHashVersion, false, nullptr, &actualKeys);
+
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(BSON("" << BSONElementHasher::hash64(obj["tenant"], kHashSeed) << ""
+                                << 5));
+
+    ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
+}
+
+TEST(HashKeyGeneratorTest, CompoundKeyHashedFieldNeedNotComeFirst) {
+    BSONObj obj = fromjson("{a: 'ab', b: 'cd'}");
+    BSONObj keyPattern = fromjson("{a: 1, b: 'hashed'}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    ExpressionKeysPrivate::getHashKeys(
+        obj, keyPattern, kHashSeed, kHashVersion, false, &collator, &actualKeys);
+
+    // Both fields are collation-aware, and only 'b' is hashed.
+    BSONObj backwardsObj = fromjson("{a: 'ba', b: 'dc'}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(BSON("" << backwardsObj["a"].String() << ""
+                                << BSONElementHasher::hash64(backwardsObj["b"], kHashSeed)));
+
+    ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
+}
+
+TEST(HashKeyGeneratorTest, CompoundKeyMissingFieldsAreNull) {
+    BSONObj obj = fromjson("{ts: 5}");
+    BSONObj keyPattern = fromjson("{tenant: 'hashed', ts: 1, other: 1}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ExpressionKeysPrivate::getHashKeys(
+        obj, keyPattern, kHashSeed, kHashVersion, false, nullptr, &actualKeys);
+
+    BSONObj nullObj = BSON("" << BSONNULL);
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(BSON("" << BSONElementHasher::hash64(nullObj.firstElement(), kHashSeed)
+                                << ""
+                                << 5
+                                << ""
+                                << BSONNULL));
+
+    ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
+}
+
+TEST(HashKeyGeneratorTest, CompoundSparseKeySkipsDocumentsMissingAllFields) {
+    BSONObj keyPattern = fromjson("{tenant: 'hashed', ts: 1}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ExpressionKeysPrivate::getHashKeys(
+        fromjson("{other: 1}"), keyPattern, kHashSeed, kHashVersion, true, nullptr, &actualKeys);
+    ASSERT(actualKeys.empty());
+
+    ExpressionKeysPrivate::getHashKeys(
+        fromjson("{ts: 1}"), keyPattern, kHashSeed, kHashVersion, true, nullptr, &actualKeys);
+    ASSERT_EQ(1U, actualKeys.size());
+}
+
+TEST(HashKeyGeneratorTest, CompoundKeyRejectsArraysInAnyField) {
+    BSONObj keyPattern = fromjson("{tenant: 'hashed', ts: 1}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ASSERT_THROWS_CODE(
+        ExpressionKeysPrivate::getHashKeys(fromjson("{tenant: 'a', ts: [1, 2]}"),
+                                           keyPattern,
+                                           kHashSeed,
+                                           kHashVersion,
+                                           false,
+                                           nullptr,
+                                           &actualKeys),
+        AssertionException,
+        16766);
+}
+
 }  // namespace
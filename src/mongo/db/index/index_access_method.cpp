@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -233,6 +234,45 @@ Status IndexAccessMethod::remove(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexAccessMethod::removeMany(OperationContext* opCtx,
+                                     const std::vector<BsonRecord>& bsonRecords,
+                                     const InsertDeleteOptions& options,
+                                     int64_t* numDeleted) {
+    invariant(numDeleted);
+    *numDeleted = 0;
+
+    std::vector<IndexKeyEntry> entries;
+    BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    for (auto&& bsonRecord : bsonRecords) {
+        keys.clear();
+        getKeys(*bsonRecord.docPtr, GetKeysMode::kRelaxConstraintsUnfiltered, &keys, nullptr);
+        for (auto&& key : keys) {
+            entries.emplace_back(key, bsonRecord.id);
+        }
+    }
+
+    std::sort(entries.begin(),
+              entries.end(),
+              IndexEntryComparison(Ordering::make(_descriptor->keyPattern())));
+
+    // Unlike removeOneKey(), a failure is not swallowed: the index would be left with some of the
+    // batch's keys, and the caller couldn't tell which.
+    try {
+        _newInterface->unindexMany(opCtx, entries, options.dupsAllowed);
+    } catch (const WriteConflictException&) {
+        throw;
+    } catch (const AssertionException& e) {
+        log() << "Assertion failure: _unindex failed " << _descriptor->indexNamespace();
+        log() << "Assertion failure: _unindex failed: " << redact(e)
+              << "  batch of keys: " << entries.size();
+        logContext();
+        throw;
+    }
+
+    *numDeleted = entries.size();
+    return Status::OK();
+}
+
 Status IndexAccessMethod::initializeAsEmpty(OperationContext* opCtx) {
     return _newInterface->initAsEmpty(opCtx);
 }
@@ -300,6 +340,10 @@ bool IndexAccessMethod::appendCustomStats(OperationContext* opCtx,
     return _newInterface->appendCustomStats(opCtx, output, scale);
 }
 
+bool IndexAccessMethod::appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+    return _newInterface->appendCacheStats(opCtx, output);
+}
+
 long long IndexAccessMethod::getSpaceUsedBytes(OperationContext* opCtx) const {
     return _newInterface->getSpaceUsedBytes(opCtx);
 }
@@ -346,8 +390,9 @@ Status IndexAccessMethod::validateUpdate(OperationContext* opCtx,
                                          const RecordId& record,
                                          const InsertDeleteOptions& options,
                                          UpdateTicket* ticket,
-                                         const MatchExpression* indexFilter) {
-    if (!indexFilter || indexFilter->matchesBSON(from)) {
+                                         bool fromMatchesFilter,
+                                         bool toMatchesFilter) {
+    if (fromMatchesFilter) {
         // There's no need to compute the prefixes of the indexed fields that possibly caused the
         // index to be multikey when the old version of the document was written since the index
         // metadata isn't updated when keys are deleted.
@@ -355,7 +400,7 @@ Status IndexAccessMethod::validateUpdate(OperationContext* opCtx,
         getKeys(from, options.getKeysMode, &ticket->oldKeys, multikeyPaths);
     }
 
-    if (!indexFilter || indexFilter->matchesBSON(to)) {
+    if (toMatchesFilter) {
         getKeys(to, options.getKeysMode, &ticket->newKeys, &ticket->newMultikeyPaths);
     }
 
@@ -480,6 +525,14 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
 
     std::unique_ptr<BulkBuilder::Sorter::Iterator> it(bulk->_sorter->done());
 
+    const SorterSpillStats spillStats = bulk->_sorter->spillStats();
+    if (spillStats.bytesSpilled > 0) {
+        log() << "\t external sort spilled " << spillStats.bytesSpilled << " bytes ("
+              << spillStats.bytesSpilledUncompressed << " bytes uncompressed, compression ratio "
+              << spillStats.compressionRatio() << ") and took " << spillStats.mergePasses
+              << " intermediate merge passes";
+    }
+
     stdx::unique_lock<Client> lk(*opCtx->getClient());
     ProgressMeterHolder pm(
         CurOp::get(opCtx)->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
@@ -47,6 +47,7 @@ extern AtomicBool failIndexKeyTooLong;
 class BSONObjBuilder;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertDeleteOptions;
 
 /**
@@ -94,6 +95,17 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numDeleted);
 
+    /**
+     * Analogous to remove(), but for a batch of documents. The keys of every document are
+     * generated first and sorted in index order, then removed from the index in one pass.
+     * 'numDeleted' will be set to the number of keys removed from the index for all of the
+     * documents. Unlike remove(), a failure to remove the keys is thrown to the caller.
+     */
+    Status removeMany(OperationContext* opCtx,
+                      const std::vector<BsonRecord>& bsonRecords,
+                      const InsertDeleteOptions& options,
+                      int64_t* numDeleted);
+
     /**
      * Checks whether the index entries for the document 'from', which is placed at location
      * 'loc' on disk, can be changed to the index entries for the doc 'to'. Provides a ticket
@@ -102,6 +114,10 @@ public:
      * Returns an error if the update is invalid.  The ticket will also be marked as invalid.
      * Returns OK if the update should proceed without error.  The ticket is marked as valid.
      *
+     * 'fromMatchesFilter' and 'toMatchesFilter' say whether each document satisfies the index's
+     * partial filter, and are both true for an index without one. Only the keys of a matching
+     * document are generated.
+     *
      * There is no obligation to perform the update after performing validation.
      */
     Status validateUpdate(OperationContext* opCtx,
@@ -110,7 +126,8 @@ public:
                           const RecordId& loc,
                           const InsertDeleteOptions& options,
                           UpdateTicket* ticket,
-                          const MatchExpression* indexFilter);
+                          bool fromMatchesFilter,
+                          bool toMatchesFilter);
 
     /**
      * Perform a validated update.  The keys for the 'from' object will be removed, and the keys
@@ -176,6 +193,13 @@ public:
      */
     bool appendCustomStats(OperationContext* opCtx, BSONObjBuilder* result, double scale) const;
 
+    /**
+     * Add the storage engine's cache residency statistics for this index to 'result'.
+     *
+     * Returns true if stats were appended.
+     */
+    bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const;
+
     /**
      * @return The number of bytes consumed by this index.
      *         Exactly what is counted is not defined based on padding, re-use, etc...
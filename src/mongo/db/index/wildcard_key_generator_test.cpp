@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/expression_keys_private.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/json.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+
+using namespace mongo;
+
+namespace {
+
+const BSONObj kWildcardKeyPattern = BSON("attrs"
+                                         << "wildcard");
+
+std::string dumpKeyset(const BSONObjSet& objs) {
+    std::stringstream ss;
+    ss << "[ ";
+    for (BSONObjSet::iterator i = objs.begin(); i != objs.end(); ++i) {
+        ss << i->toString() << " ";
+    }
+    ss << "]";
+
+    return ss.str();
+}
+
+bool assertKeysetsEqual(const BSONObjSet& expectedKeys, const BSONObjSet& actualKeys) {
+    if (expectedKeys.size() != actualKeys.size() ||
+        !std::equal(expectedKeys.begin(),
+                    expectedKeys.end(),
+                    actualKeys.begin(),
+                    SimpleBSONObjComparator::kInstance.makeEqualTo())) {
+        log() << "Expected: " << dumpKeyset(expectedKeys) << ", "
+              << "Actual: " << dumpKeyset(actualKeys);
+        return false;
+    }
+
+    return true;
+}
+
+BSONObjSet getKeys(const char* json,
+                   const BSONObj& keyPattern = kWildcardKeyPattern,
+                   const CollatorInterface* collator = nullptr) {
+    BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ExpressionKeysPrivate::getWildcardKeys(fromjson(json), keyPattern, collator, &keys);
+    return keys;
+}
+
+template <typename T>
+BSONObj makeKey(StringData path, const T& value) {
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("", path);
+    keyBuilder.append("", value);
+    return keyBuilder.obj();
+}
+
+BSONObjSet makeKeySet(std::initializer_list<BSONObj> keys) {
+    BSONObjSet set = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    set.insert(keys.begin(), keys.end());
+    return set;
+}
+
+TEST(WildcardKeyGeneratorTest, IndexesEveryScalarBeneathThePrefix) {
+    auto expectedKeys = makeKeySet({makeKey("attrs.color", "red"),
+                                    makeKey("attrs.size", 10),
+                                    makeKey("attrs.dims.h", 2.5)});
+    ASSERT(assertKeysetsEqual(
+        expectedKeys, getKeys("{_id: 1, attrs: {color: 'red', size: 10, dims: {h: 2.5}}, x: 1}")));
+}
+
+TEST(WildcardKeyGeneratorTest, ScalarPrefixIsIndexedAtItsOwnPath) {
+    ASSERT(assertKeysetsEqual(makeKeySet({makeKey("attrs", 7)}), getKeys("{attrs: 7}")));
+}
+
+TEST(WildcardKeyGeneratorTest, MissingPrefixGeneratesNoKeys) {
+    ASSERT(assertKeysetsEqual(makeKeySet({}), getKeys("{other: {a: 1}}")));
+    ASSERT(assertKeysetsEqual(makeKeySet({}), getKeys("{attrs: {}}")));
+    ASSERT(assertKeysetsEqual(makeKeySet({}), getKeys("{attrs: {a: []}}")));
+}
+
+TEST(WildcardKeyGeneratorTest, ArrayElementsAreIndexedUnderTheArrayPath) {
+    auto expectedKeys = makeKeySet({makeKey("attrs.tags", "a"),
+                                    makeKey("attrs.tags", "b"),
+                                    makeKey("attrs.tags.k", 1)});
+    ASSERT(assertKeysetsEqual(expectedKeys,
+                              getKeys("{attrs: {tags: ['a', 'b', {k: 1}, ['nested']]}}")));
+}
+
+TEST(WildcardKeyGeneratorTest, ArraysAlongThePrefixAreTraversed) {
+    auto expectedKeys = makeKeySet({makeKey("a.b.c", 1), makeKey("a.b.c", 2)});
+    ASSERT(assertKeysetsEqual(expectedKeys,
+                              getKeys("{a: [{b: {c: 1}}, {b: {c: 2}}, 3]}",
+                                      BSON("a.b"
+                                           << "wildcard"))));
+}
+
+TEST(WildcardKeyGeneratorTest, CollationAppliesToValuesButNotPaths) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    auto expectedKeys = makeKeySet({makeKey("attrs.name", "gnirts")});
+    ASSERT(assertKeysetsEqual(
+        expectedKeys, getKeys("{attrs: {name: 'string'}}", kWildcardKeyPattern, &collator)));
+}
+
+}  // namespace
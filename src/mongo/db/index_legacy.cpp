@@ -76,9 +76,20 @@ BSONObj IndexLegacy::getMissingField(OperationContext* opCtx,
         // (hash of null was used in the initial release of hashed indexes and changing would
         // alter the data format).  Additionally, in certain places the hashed index code and
         // the index bound calculation code assume null and missing are indexed identically.
+        //
+        // In a compound hashed index only the hashed field holds the hash; the others hold null.
         BSONObj nullObj = BSON("" << BSONNULL);
-        return BSON("" << ExpressionKeysPrivate::makeSingleHashKey(
-                        nullObj.firstElement(), seed, hashVersion));
+        BSONObjBuilder b;
+        for (auto&& keyElt : keyPattern) {
+            if (keyElt.type() == String) {
+                b.append("",
+                         ExpressionKeysPrivate::makeSingleHashKey(
+                             nullObj.firstElement(), seed, hashVersion));
+            } else {
+                b.appendNull("");
+            }
+        }
+        return b.obj();
     } else {
         BSONObjBuilder b;
         b.appendNull("");
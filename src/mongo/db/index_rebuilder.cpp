@@ -32,6 +32,8 @@
 
 #include "mongo/db/index_rebuilder.h"
 
+#include <algorithm>
+#include <exception>
 #include <list>
 #include <string>
 
@@ -43,8 +45,12 @@
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -55,8 +61,20 @@ using std::string;
 using std::vector;
 
 namespace {
-void checkNS(OperationContext* opCtx, const std::list<std::string>& nsToCheck) {
-    bool firstTime = true;
+
+// The most threads that startup recovery uses to check and rebuild databases at the same time.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(startupRecoveryThreads, int, 4)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "startupRecoveryThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+void checkNS(OperationContext* opCtx,
+             const std::list<std::string>& nsToCheck,
+             AtomicWord<bool>* loggedRetryNote) {
     for (std::list<std::string>::const_iterator it = nsToCheck.begin(); it != nsToCheck.end();
          ++it) {
         NamespaceString nss(*it);
@@ -101,10 +119,9 @@ void checkNS(OperationContext* opCtx, const std::list<std::string>& nsToCheck) {
             log() << "found " << indexesToBuild.size() << " interrupted index build(s) on "
                   << nss.ns();
 
-            if (firstTime) {
+            if (!loggedRetryNote->swap(true)) {
                 log() << "note: restart the server with --noIndexBuildRetry "
                       << "to skip index rebuilds";
-                firstTime = false;
             }
 
             if (!serverGlobalParams.indexBuildRetry) {
@@ -141,6 +158,50 @@ void checkNS(OperationContext* opCtx, const std::list<std::string>& nsToCheck) {
 }
 }  // namespace
 
+void forEachDatabaseInParallel(
+    const std::vector<std::string>& dbNames,
+    const std::string& poolName,
+    const stdx::function<void(OperationContext*, const std::string&)>& perDatabase) {
+    if (dbNames.empty()) {
+        return;
+    }
+
+    // Declared before the pool, whose destructor waits for any scheduled calls to return.
+    stdx::mutex mutex;
+    std::exception_ptr firstError;
+
+    ThreadPool::Options options;
+    options.poolName = poolName;
+    options.threadNamePrefix = poolName + "-";
+    options.maxThreads = std::min(dbNames.size(), size_t(startupRecoveryThreads.load()));
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThreadIfNotAlready(threadName);
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    for (const auto& dbName : dbNames) {
+        uassertStatusOK(pool.schedule([&, dbName] {
+            try {
+                auto opCtx = cc().makeOperationContext();
+                perDatabase(opCtx.get(), dbName);
+            } catch (...) {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        }));
+    }
+    pool.shutdown();
+    pool.join();
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
 void restartInProgressIndexesFromLastShutdown(OperationContext* opCtx) {
     AuthorizationSession::get(opCtx->getClient())->grantInternalAuthorization();
 
@@ -149,17 +210,19 @@ void restartInProgressIndexesFromLastShutdown(OperationContext* opCtx) {
     StorageEngine* storageEngine = getGlobalServiceContext()->getStorageEngine();
     storageEngine->listDatabases(&dbNames);
 
+    // Each database is checked on its own thread, holding only its own database lock, so that
+    // interrupted builds in different databases are resumed at the same time.
+    AtomicWord<bool> loggedRetryNote(false);
     try {
-        std::list<std::string> collNames;
-        for (std::vector<std::string>::const_iterator dbName = dbNames.begin();
-             dbName < dbNames.end();
-             ++dbName) {
-            AutoGetDb autoDb(opCtx, *dbName, MODE_S);
-
-            Database* db = autoDb.getDb();
-            db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collNames);
-        }
-        checkNS(opCtx, collNames);
+        forEachDatabaseInParallel(
+            dbNames, "IndexRebuilder", [&](OperationContext* opCtx, const std::string& dbName) {
+                std::list<std::string> collNames;
+                {
+                    AutoGetDb autoDb(opCtx, dbName, MODE_S);
+                    autoDb.getDb()->getDatabaseCatalogEntry()->getCollectionNamespaces(&collNames);
+                }
+                checkNS(opCtx, collNames, &loggedRetryNote);
+            });
     } catch (const DBException& e) {
         error() << "Index verification did not complete: " << redact(e);
         fassertFailedNoTrace(18643);
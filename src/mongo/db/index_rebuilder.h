@@ -28,10 +28,27 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/functional.h"
+
 namespace mongo {
 
 class OperationContext;
 
+/**
+ * Runs 'perDatabase' once for each of 'dbNames', spreading the databases over up to
+ * 'startupRecoveryThreads' threads. Each call gets an OperationContext on a Client of its own, so
+ * it must take whatever locks it needs and the caller must not hold any. Rethrows the first
+ * exception thrown by any call once every call has returned.
+ * Only call this at startup before taking requests.
+ */
+void forEachDatabaseInParallel(
+    const std::vector<std::string>& dbNames,
+    const std::string& poolName,
+    const stdx::function<void(OperationContext*, const std::string&)>& perDatabase);
+
 /**
  * Restarts building indexes that were in progress during shutdown.
  * Only call this at startup before taking requests.
@@ -52,6 +52,15 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(
 
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(disableLogicalSessionCacheRefresh, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(logicalSessionRefreshBatchSize, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0) {
+            return Status(ErrorCodes::BadValue,
+                          "logicalSessionRefreshBatchSize must be greater than 0");
+        }
+        return Status::OK();
+    });
+
 constexpr Minutes LogicalSessionCacheImpl::kLogicalSessionDefaultRefresh;
 
 LogicalSessionCacheImpl::LogicalSessionCacheImpl(
@@ -141,7 +150,7 @@ void LogicalSessionCacheImpl::vivify(OperationContext* opCtx, const LogicalSessi
 
 Status LogicalSessionCacheImpl::refreshNow(Client* client) {
     try {
-        _refresh(client);
+        _refresh(client, false);
     } catch (...) {
         return exceptionToStatus();
     }
@@ -163,7 +172,7 @@ size_t LogicalSessionCacheImpl::size() {
 
 void LogicalSessionCacheImpl::_periodicRefresh(Client* client) {
     try {
-        _refresh(client);
+        _refresh(client, true);
     } catch (...) {
         log() << "Failed to refresh session cache: " << exceptionToStatus();
     }
@@ -238,7 +247,12 @@ Status LogicalSessionCacheImpl::_reap(Client* client) {
     return Status::OK();
 }
 
-void LogicalSessionCacheImpl::_refresh(Client* client) {
+Milliseconds LogicalSessionCacheImpl::_refreshSkipWindow() const {
+    const auto window = duration_cast<Milliseconds>(_sessionTimeout - 2 * _refreshInterval);
+    return std::max(Milliseconds(0), window);
+}
+
+void LogicalSessionCacheImpl::_refresh(Client* client, bool periodic) {
     // Stats for serverStatus:
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
@@ -329,17 +343,72 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         activeSessionRecords.insert(it.second);
     }
 
-    // Refresh the active sessions in the sessions collection.
-    uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
+    // Forget the sessions which were not written recently enough to survive until the next
+    // refresh. A periodic refresh leaves out the ones which were.
+    const auto refreshStart = now();
+    {
+        const auto skipWindow = _refreshSkipWindow();
+        stdx::lock_guard<stdx::mutex> lk(_refreshedMutex);
+        for (auto it = _lastRefreshed.begin(); it != _lastRefreshed.end();) {
+            if (refreshStart - it->second >= skipWindow) {
+                it = _lastRefreshed.erase(it);
+                continue;
+            }
+            if (periodic) {
+                activeSessionRecords.erase(makeLogicalSessionRecord(it->first, refreshStart));
+            }
+            ++it;
+        }
+    }
+
+    // Refresh the active sessions in the sessions collection. A periodic refresh does it in
+    // batches spread over the first half of the refresh interval, so that a large cache does not
+    // turn into a burst of writes.
+    const size_t batchSize = periodic
+        ? static_cast<size_t>(logicalSessionRefreshBatchSize.load())
+        : std::max<size_t>(activeSessionRecords.size(), 1);
+    const size_t numBatches = (activeSessionRecords.size() + batchSize - 1) / batchSize;
+    const Milliseconds pause = numBatches > 1
+        ? duration_cast<Milliseconds>(_refreshInterval) / static_cast<long long>(2 * numBatches)
+        : Milliseconds(0);
+
+    LogicalSessionRecordSet batch;
+    size_t numRefreshed = 0;
+    for (auto it = activeSessionRecords.begin(); it != activeSessionRecords.end();) {
+        batch.insert(*it);
+        if (++it != activeSessionRecords.end() && batch.size() < batchSize) {
+            continue;
+        }
+
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, batch));
+        numRefreshed += batch.size();
+        {
+            stdx::lock_guard<stdx::mutex> lk(_refreshedMutex);
+            for (const auto& record : batch) {
+                _lastRefreshed[record.getId()] = refreshStart;
+            }
+        }
+        batch.clear();
+
+        if (it != activeSessionRecords.end() && pause > Milliseconds(0)) {
+            opCtx->sleepFor(pause);
+        }
+    }
     activeSessionsBackSwapper.Dismiss();
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-        _stats.setLastSessionsCollectionJobEntriesRefreshed(activeSessionRecords.size());
+        _stats.setLastSessionsCollectionJobEntriesRefreshed(numRefreshed);
     }
 
     // Remove the ending sessions from the sessions collection.
     uassertStatusOK(_sessionsColl->removeRecords(opCtx, explicitlyEndingSessions));
     explicitlyEndingBackSwaper.Dismiss();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_refreshedMutex);
+        for (const auto& lsid : explicitlyEndingSessions) {
+            _lastRefreshed.erase(lsid);
+        }
+    }
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         _stats.setLastSessionsCollectionJobEntriesEnded(explicitlyEndingSessions.size());
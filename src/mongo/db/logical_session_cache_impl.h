@@ -46,6 +46,7 @@ class OperationContext;
 class ServiceContext;
 
 extern int logicalSessionRefreshMinutes;
+extern AtomicInt32 logicalSessionRefreshBatchSize;
 
 /**
  * A thread-safe cache structure for logical session records.
@@ -133,7 +134,14 @@ private:
      * session records contained within the cache.
      */
     void _periodicRefresh(Client* client);
-    void _refresh(Client* client);
+
+    /**
+     * Writes the active sessions to the sessions collection and removes the ended ones. A periodic
+     * refresh skips sessions whose records were written recently enough that they cannot expire
+     * before the next refresh, and spreads its writes in batches over half the refresh interval.
+     * An explicit refresh writes every active session at once.
+     */
+    void _refresh(Client* client, bool periodic);
 
     void _periodicReap(Client* client);
     Status _reap(Client* client);
@@ -148,6 +156,13 @@ private:
      */
     void _addToCache(LogicalSessionRecord record);
 
+    /**
+     * Returns how long after its record was last written a session may go without being written
+     * again by a periodic refresh. This leaves one full refresh interval of margin before the
+     * record would expire.
+     */
+    Milliseconds _refreshSkipWindow() const;
+
     const Minutes _refreshInterval;
     const Minutes _sessionTimeout;
 
@@ -167,6 +182,11 @@ private:
 
     LogicalSessionIdSet _endingSessions;
 
+    // The last time each recently refreshed session was written to the sessions collection. Only
+    // used by refreshes, and protected by its own mutex so it is never walked under _cacheMutex.
+    stdx::mutex _refreshedMutex;
+    LogicalSessionIdMap<Date_t> _lastRefreshed;
+
     Date_t lastRefreshTime;
 };
 
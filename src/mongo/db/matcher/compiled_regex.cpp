@@ -0,0 +1,324 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_regex.h"
+
+#include <algorithm>
+
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
+
+namespace mongo {
+
+namespace {
+
+using CompiledRegexCache = LRUCache<std::string, std::shared_ptr<const CompiledRegex>>;
+
+stdx::mutex cacheMutex;
+
+// Created on first use, so that its size can be set with a startup parameter.
+std::unique_ptr<CompiledRegexCache> compiledRegexCache;
+
+pcrecpp::RE_Options flags2options(const char* flags) {
+    pcrecpp::RE_Options options;
+    options.set_utf8(true);
+    while (flags && *flags) {
+        if (*flags == 'i')
+            options.set_caseless(true);
+        else if (*flags == 'm')
+            options.set_multiline(true);
+        else if (*flags == 'x')
+            options.set_extended(true);
+        else if (*flags == 's')
+            options.set_dotall(true);
+        flags++;
+    }
+    return options;
+}
+
+char asciiToLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+bool isAsciiAlnum(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+/**
+ * Returns the position just past the POSIX bracket expression, such as "[:alpha:]", starting at
+ * 'regex[pos]' inside a character class, or 'pos' if there is none there. Follows PCRE, which only
+ * treats "[:", "[." or "[=" as the start of one if the matching ":]", ".]" or "=]" comes before
+ * any other ']'.
+ */
+size_t skipPosixBracketExpression(StringData regex, size_t pos) {
+    if (pos + 1 >= regex.size() || regex[pos] != '[' ||
+        (regex[pos + 1] != ':' && regex[pos + 1] != '.' && regex[pos + 1] != '=')) {
+        return pos;
+    }
+    const char terminator = regex[pos + 1];
+    for (size_t i = pos + 2; i < regex.size(); ++i) {
+        if (regex[i] == '\\' && i + 1 < regex.size() &&
+            (regex[i + 1] == ']' || regex[i + 1] == '\\')) {
+            ++i;
+        } else if (regex[i] == ']' || (regex[i] == '[' && i + 1 < regex.size() &&
+                                       regex[i + 1] == terminator)) {
+            return pos;
+        } else if (regex[i] == terminator && i + 1 < regex.size() && regex[i + 1] == ']') {
+            return i + 2;
+        }
+    }
+    return pos;
+}
+
+/**
+ * Returns the position just past the character class starting at 'regex[pos]', which is a '['.
+ */
+size_t skipCharacterClass(StringData regex, size_t pos) {
+    ++pos;
+    if (pos < regex.size() && regex[pos] == '^') {
+        ++pos;
+    }
+    // A ']' right after the opening bracket is part of the class.
+    if (pos < regex.size() && regex[pos] == ']') {
+        ++pos;
+    }
+    while (pos < regex.size() && regex[pos] != ']') {
+        // The ']' ending a POSIX bracket expression doesn't end the class.
+        const size_t end = skipPosixBracketExpression(regex, pos);
+        if (end != pos) {
+            pos = end;
+        } else {
+            pos += regex[pos] == '\\' ? 2 : 1;
+        }
+    }
+    return pos + 1;
+}
+
+/**
+ * Returns the position just past the group starting at 'regex[pos]', which is a '('.
+ */
+size_t skipGroup(StringData regex, size_t pos) {
+    int depth = 0;
+    while (pos < regex.size()) {
+        const char c = regex[pos];
+        if (c == '\\') {
+            pos += 2;
+            continue;
+        }
+        if (c == '[') {
+            pos = skipCharacterClass(regex, pos);
+            continue;
+        }
+        ++pos;
+        if (c == '(') {
+            ++depth;
+        } else if (c == ')' && --depth == 0) {
+            break;
+        }
+    }
+    return pos;
+}
+
+}  // namespace
+
+std::shared_ptr<const CompiledRegex> CompiledRegex::get(const std::string& regex,
+                                                        const std::string& flags) {
+    const int maxCacheSize = internalQueryRegexCacheSize.load();
+    if (maxCacheSize <= 0) {
+        return std::make_shared<const CompiledRegex>(regex, flags);
+    }
+
+    // Neither the pattern nor the options may contain a null byte, so this key is unambiguous.
+    const std::string key = regex + '\0' + flags;
+    {
+        stdx::lock_guard<stdx::mutex> lk(cacheMutex);
+        if (!compiledRegexCache) {
+            compiledRegexCache = stdx::make_unique<CompiledRegexCache>(maxCacheSize);
+        }
+        auto it = compiledRegexCache->find(key);
+        if (it != compiledRegexCache->end()) {
+            return it->second;
+        }
+    }
+
+    // Compile outside of the mutex. Two queries missing on the same pattern at once both compile
+    // it, and the later one replaces the earlier in the cache.
+    auto compiled = std::make_shared<const CompiledRegex>(regex, flags);
+    if (compiled->error().empty()) {
+        stdx::lock_guard<stdx::mutex> lk(cacheMutex);
+        compiledRegexCache->add(key, compiled);
+    }
+    return compiled;
+}
+
+std::string CompiledRegex::extractRequiredLiteral(StringData regex, StringData flags) {
+    // Extended mode ignores whitespace and comments, while alternation, inline options and quoting
+    // make it hard to tell which characters are required. Leave such patterns alone.
+    if (flags.find('x') != std::string::npos || regex.find('|') != std::string::npos ||
+        regex.find("(?"_sd) != std::string::npos || regex.find("\\Q"_sd) != std::string::npos) {
+        return "";
+    }
+    const bool caseless = flags.find('i') != std::string::npos;
+
+    // Every run of literal characters outside of groups is required. We keep the longest.
+    std::string longest;
+    std::string current;
+    auto endRun = [&] {
+        if (current.size() > longest.size()) {
+            longest = current;
+        }
+        current.clear();
+    };
+    // A quantifier allowing zero repetitions makes the last character of the run optional. A
+    // character may span several bytes in UTF-8, all of which are dropped.
+    auto dropLastCharacter = [&] {
+        while (!current.empty() && (current.back() & 0xC0) == 0x80) {
+            current.pop_back();
+        }
+        if (!current.empty()) {
+            current.pop_back();
+        }
+    };
+    auto appendLiteral = [&](char c) {
+        // Under case-insensitive matching, non-ASCII characters and the letters 'k' and 's' fold
+        // to characters outside of ASCII (the Kelvin sign and the long s), which a byte search
+        // ignoring ASCII case would miss.
+        if (caseless) {
+            c = asciiToLower(c);
+            if ((c & 0x80) || c == 'k' || c == 's') {
+                endRun();
+                return;
+            }
+        }
+        current.push_back(c);
+    };
+
+    size_t pos = 0;
+    while (pos < regex.size()) {
+        const char c = regex[pos];
+        switch (c) {
+            case '\\': {
+                if (pos + 1 >= regex.size()) {
+                    return "";
+                }
+                const char escaped = regex[pos + 1];
+                pos += 2;
+                if (!isAsciiAlnum(escaped)) {
+                    // An escaped metacharacter stands for itself.
+                    appendLiteral(escaped);
+                    break;
+                }
+                // Escape sequences with arguments that look like literals are not worth parsing.
+                if (escaped == 'c' || escaped == 'g' || escaped == 'k' || escaped == 'N' ||
+                    escaped == 'E') {
+                    return "";
+                }
+                // Any other escape stands for a class of characters, an assertion, a
+                // back-reference or a character code, whose digits or name follow it.
+                endRun();
+                while (pos < regex.size() && isAsciiAlnum(regex[pos])) {
+                    ++pos;
+                }
+                break;
+            }
+            case '*':
+            case '?':
+                dropLastCharacter();
+                endRun();
+                ++pos;
+                break;
+            case '{': {
+                // Bounds may allow zero repetitions. If this is not a valid quantifier PCRE reads
+                // it literally, but ending the run is still correct.
+                dropLastCharacter();
+                endRun();
+                const size_t close = regex.find('}', pos);
+                pos = close == std::string::npos ? regex.size() : close + 1;
+                break;
+            }
+            case '+':
+                endRun();
+                ++pos;
+                break;
+            case '[':
+                endRun();
+                pos = skipCharacterClass(regex, pos);
+                break;
+            case '(':
+                endRun();
+                pos = skipGroup(regex, pos);
+                break;
+            case '.':
+            case '^':
+            case '$':
+            case ')':
+                endRun();
+                ++pos;
+                break;
+            default:
+                appendLiteral(c);
+                ++pos;
+        }
+    }
+    endRun();
+    return longest;
+}
+
+CompiledRegex::CompiledRegex(const std::string& regex, const std::string& flags)
+    : _re(regex, flags2options(flags.c_str())),
+      _requiredLiteral(extractRequiredLiteral(regex, flags)),
+      _caseless(flags.find('i') != std::string::npos) {}
+
+bool CompiledRegex::partialMatch(StringData input) const {
+    if (!_requiredLiteral.empty()) {
+        if (!_caseless) {
+            if (input.find(_requiredLiteral) == std::string::npos) {
+                return false;
+            }
+        } else if (std::search(input.begin(),
+                               input.end(),
+                               _requiredLiteral.begin(),
+                               _requiredLiteral.end(),
+                               [](char a, char b) { return asciiToLower(a) == b; }) ==
+                   input.end()) {
+            return false;
+        }
+    }
+
+    // Strings stored in documents can contain embedded NUL bytes. We construct a
+    // pcrecpp::StringPiece instance using the full length of the string to avoid truncating the
+    // input early.
+    pcrecpp::StringPiece data(input.rawData(), input.size());
+    return _re.PartialMatch(data);
+}
+
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <pcrecpp.h>
+#include <string>
+
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * A $regex pattern compiled with its options. Instances are immutable and are shared through a
+ * process-wide cache by every RegexMatchExpression with the same pattern and options, so that a
+ * pattern issued by many queries is only compiled once.
+ *
+ * A compiled pattern also remembers a literal string that every match must contain, if one can be
+ * extracted from the pattern. partialMatch() rejects input lacking that literal with a substring
+ * search, without running the regex engine.
+ */
+class CompiledRegex {
+public:
+    /**
+     * Returns the compiled form of 'regex' with 'flags', from the cache if it was compiled before.
+     * The caller must check error() before matching.
+     */
+    static std::shared_ptr<const CompiledRegex> get(const std::string& regex,
+                                                    const std::string& flags);
+
+    /**
+     * Returns a literal that every string matched by 'regex' with 'flags' contains, or an empty
+     * string if none could be determined. For a case-insensitive pattern the literal is returned
+     * in lower case and must be searched for ignoring case.
+     */
+    static std::string extractRequiredLiteral(StringData regex, StringData flags);
+
+    CompiledRegex(const std::string& regex, const std::string& flags);
+
+    /**
+     * Returns the error encountered compiling the pattern, or an empty string if it is valid.
+     */
+    const std::string& error() const {
+        return _re.error();
+    }
+
+    /**
+     * Returns true if the pattern matches anywhere in 'input'.
+     */
+    bool partialMatch(StringData input) const;
+
+    const std::string& getRequiredLiteral() const {
+        return _requiredLiteral;
+    }
+
+private:
+    pcrecpp::RE _re;
+    std::string _requiredLiteral;
+    bool _caseless;
+};
+
+}  // namespace mongo
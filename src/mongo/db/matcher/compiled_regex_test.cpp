@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_regex.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(CompiledRegexTest, ExtractsLongestRequiredLiteral) {
+    ASSERT_EQ("hello", CompiledRegex::extractRequiredLiteral("hello", ""));
+    ASSERT_EQ("world", CompiledRegex::extractRequiredLiteral("^ab.world$", ""));
+    ASSERT_EQ("a.b", CompiledRegex::extractRequiredLiteral("x\\d+a\\.b", ""));
+    ASSERT_EQ("after", CompiledRegex::extractRequiredLiteral("(optional)?after[a-z]+", ""));
+}
+
+TEST(CompiledRegexTest, QuantifiersMakeTheLastCharacterOptional) {
+    ASSERT_EQ("colo", CompiledRegex::extractRequiredLiteral("colou?r", ""));
+    ASSERT_EQ("abc", CompiledRegex::extractRequiredLiteral("abcd*", ""));
+    ASSERT_EQ("abcd", CompiledRegex::extractRequiredLiteral("abcd+", ""));
+    ASSERT_EQ("abc", CompiledRegex::extractRequiredLiteral("abcd{0,2}", ""));
+    // A multi-byte character is dropped as a whole.
+    ASSERT_EQ("caf", CompiledRegex::extractRequiredLiteral("caf\xc3\xa9?", ""));
+}
+
+TEST(CompiledRegexTest, NoLiteralFromPatternsThatAreHardToAnalyze) {
+    ASSERT_EQ("", CompiledRegex::extractRequiredLiteral("abc|def", ""));
+    ASSERT_EQ("", CompiledRegex::extractRequiredLiteral("abc(?i)def", ""));
+    ASSERT_EQ("", CompiledRegex::extractRequiredLiteral("a b c", "x"));
+    ASSERT_EQ("", CompiledRegex::extractRequiredLiteral("\\Qabc\\E", ""));
+    ASSERT_EQ("", CompiledRegex::extractRequiredLiteral("[abc]+", ""));
+}
+
+TEST(CompiledRegexTest, PosixBracketExpressionsDoNotEndTheCharacterClass) {
+    ASSERT_EQ("abc", CompiledRegex::extractRequiredLiteral("[[:alpha:]x]abc", ""));
+    ASSERT_EQ("end", CompiledRegex::extractRequiredLiteral("[^[:digit:][:space:]]+end", ""));
+    ASSERT_EQ("abc", CompiledRegex::extractRequiredLiteral("[[=a=]]abc", ""));
+    ASSERT_EQ("abc", CompiledRegex::extractRequiredLiteral("[[.a.]]abc", ""));
+
+    // Without the matching ":]" before the next ']', the '[' is an ordinary member of the class.
+    ASSERT_EQ("b]", CompiledRegex::extractRequiredLiteral("[[:a]b]", ""));
+    ASSERT_EQ("b", CompiledRegex::extractRequiredLiteral("[[a]b", ""));
+
+    CompiledRegex posixClass("[[:alpha:]x]abc", "");
+    ASSERT_TRUE(posixClass.partialMatch("zabc"));
+    ASSERT_FALSE(posixClass.partialMatch("1abc"));
+}
+
+TEST(CompiledRegexTest, CaseInsensitiveLiteralIsLowerCaseAscii) {
+    ASSERT_EQ("hello", CompiledRegex::extractRequiredLiteral("HeLLo", "i"));
+    // 's' and 'k' also match non-ASCII characters, so they end the literal.
+    ASSERT_EQ("earch", CompiledRegex::extractRequiredLiteral("Search", "i"));
+    ASSERT_EQ("caf", CompiledRegex::extractRequiredLiteral("caf\xc3\xa9", "i"));
+}
+
+TEST(CompiledRegexTest, PartialMatchAppliesThePrefilter) {
+    CompiledRegex caseSensitive("wor.d", "");
+    ASSERT_EQ("wor", caseSensitive.getRequiredLiteral());
+    ASSERT_TRUE(caseSensitive.partialMatch("hello world"));
+    ASSERT_FALSE(caseSensitive.partialMatch("hello WORLD"));
+    ASSERT_FALSE(caseSensitive.partialMatch("word"));
+
+    CompiledRegex caseInsensitive("wor.d", "i");
+    ASSERT_TRUE(caseInsensitive.partialMatch("hello WORLD"));
+    ASSERT_FALSE(caseInsensitive.partialMatch("hello"));
+
+    // The input may contain null bytes.
+    ASSERT_TRUE(caseSensitive.partialMatch(StringData("a\0world", 7)));
+}
+
+TEST(CompiledRegexTest, CaseInsensitiveMatchesNonAsciiFoldsOfAsciiLetters) {
+    // The Kelvin sign folds to 'k'.
+    CompiledRegex regex("ok", "i");
+    ASSERT_TRUE(regex.partialMatch("o\xe2\x84\xaa"));
+}
+
+TEST(CompiledRegexTest, GetReturnsTheSameCompiledPatternForTheSameOptions) {
+    auto regex = CompiledRegex::get("compiled_regex_test", "i");
+    ASSERT_EQ(regex, CompiledRegex::get("compiled_regex_test", "i"));
+    ASSERT_NE(regex, CompiledRegex::get("compiled_regex_test", ""));
+
+    // Invalid patterns report their error.
+    ASSERT_FALSE(CompiledRegex::get("(", "")->error().empty());
+}
+
+}  // namespace
+}  // namespace mongo
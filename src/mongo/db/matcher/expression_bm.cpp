@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns the filter selected by 'filterShape': 0 for an equality on a top-level field, 1 for a
+ * conjunction of range predicates, 2 for an $in over a dotted path and 3 for an $elemMatch.
+ */
+BSONObj makeFilter(int filterShape) {
+    switch (filterShape) {
+        case 0:
+            return BSON("status"
+                        << "active");
+        case 1:
+            return BSON("age" << BSON("$gte" << 18 << "$lt" << 65) << "score"
+                              << BSON("$gt" << 10.5));
+        case 2:
+            return BSON("address.city" << BSON("$in" << BSON_ARRAY("Paris"
+                                                                   << "London"
+                                                                   << "Dublin"
+                                                                   << "New York")));
+        default:
+            return BSON("items" << BSON("$elemMatch" << BSON("sku"
+                                                             << "abc-7"
+                                                             << "qty"
+                                                             << BSON("$gt" << 1))));
+    }
+}
+
+BSONObj makeDocument() {
+    BSONArrayBuilder items;
+    for (int i = 0; i < 10; ++i) {
+        items.append(BSON("sku" << ("abc-" + std::to_string(i)) << "qty" << i));
+    }
+    return BSON("_id" << 1 << "status"
+                      << "active"
+                      << "age"
+                      << 42
+                      << "score"
+                      << 99.5
+                      << "address"
+                      << BSON("street"
+                              << "1 Main Street"
+                              << "city"
+                              << "Dublin")
+                      << "items"
+                      << items.arr());
+}
+
+/**
+ * Benchmark matching a parsed filter against a document, as a collection scan does for every
+ * document it examines.
+ */
+void BM_MatchesBSON(benchmark::State& state) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto matchExpression = uassertStatusOK(
+        MatchExpressionParser::parse(makeFilter(state.range(0)), expCtx));
+    const BSONObj doc = makeDocument();
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(matchExpression->matchesBSON(doc));
+    }
+}
+
+/**
+ * Benchmark parsing a filter, which every query does before planning.
+ */
+void BM_MatchExpressionParse(benchmark::State& state) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const BSONObj filter = makeFilter(state.range(0));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(MatchExpressionParser::parse(filter, expCtx));
+    }
+}
+
+BENCHMARK(BM_MatchesBSON)->DenseRange(0, 3);
+BENCHMARK(BM_MatchExpressionParse)->DenseRange(0, 3);
+
+}  // namespace
+}  // namespace mongo
@@ -107,6 +107,14 @@ public:
         return *_query;
     }
 
+    /**
+     * Returns the original geo specification provided by the user, e.g.
+     * {$geoWithin: {$geometry: ...}}, without the path it applies to.
+     */
+    const BSONObj& getRawObj() const {
+        return _rawObj;
+    }
+
 private:
     ExpressionOptimizerFunc getOptimizer() const final {
         return [](std::unique_ptr<MatchExpression> expression) { return expression; };
@@ -30,8 +30,8 @@
 
 #include "mongo/db/matcher/expression_leaf.h"
 
+#include <algorithm>
 #include <cmath>
-#include <pcrecpp.h>
 
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonmisc.h"
@@ -39,6 +39,7 @@
 #include "mongo/config.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_regex.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/path.h"
 #include "mongo/db/query/collation/collator_interface.h"
@@ -110,10 +111,74 @@ ComparisonMatchExpression::ComparisonMatchExpression(MatchType type,
         default:
             uasserted(ErrorCodes::BadValue, "bad match type for ComparisonMatchExpression");
     }
+
+    switch (_rhs.type()) {
+        case NumberInt:
+        case NumberLong:
+            _fastPathKind = FastPathKind::kInt64;
+            _rhsInt64 = _rhs.numberLong();
+            break;
+        case NumberDouble:
+            // NaN has special comparison semantics, which are handled by the slow path.
+            if (!std::isnan(_rhs._numberDouble())) {
+                _fastPathKind = FastPathKind::kDouble;
+                _rhsDouble = _rhs._numberDouble();
+            }
+            break;
+        case String:
+            _fastPathKind = FastPathKind::kString;
+            _rhsString = _rhs.valueStringData();
+            break;
+        default:
+            break;
+    }
+}
+
+bool ComparisonMatchExpression::comparisonResultMatches(int cmp) const {
+    switch (matchType()) {
+        case LT:
+            return cmp < 0;
+        case LTE:
+            return cmp <= 0;
+        case EQ:
+            return cmp == 0;
+        case GT:
+            return cmp > 0;
+        case GTE:
+            return cmp >= 0;
+        default:
+            // This is a comparison match expression, so it must be either
+            // a $lt, $lte, $gt, $gte, or equality expression.
+            fassertFailed(16828);
+    }
 }
 
 bool ComparisonMatchExpression::matchesSingleElement(const BSONElement& e,
                                                      MatchDetails* details) const {
+    // Compare directly when the element has the same type as a numeric or string constant. These
+    // produce the same result as the generic comparison below.
+    switch (_fastPathKind) {
+        case FastPathKind::kInt64:
+            if (e.type() == NumberInt || e.type() == NumberLong) {
+                const long long lhs = e.type() == NumberInt ? e._numberInt() : e._numberLong();
+                return comparisonResultMatches(lhs < _rhsInt64 ? -1 : (lhs == _rhsInt64 ? 0 : 1));
+            }
+            break;
+        case FastPathKind::kDouble:
+            if (e.type() == NumberDouble && !std::isnan(e._numberDouble())) {
+                const double lhs = e._numberDouble();
+                return comparisonResultMatches(lhs < _rhsDouble ? -1 : (lhs == _rhsDouble ? 0 : 1));
+            }
+            break;
+        case FastPathKind::kString:
+            if (e.type() == String && !_collator) {
+                return comparisonResultMatches(e.valueStringData().compare(_rhsString));
+            }
+            break;
+        case FastPathKind::kNone:
+            break;
+    }
+
     if (e.canonicalType() != _rhs.canonicalType()) {
         // some special cases
         //  jstNULL and undefined are treated the same
@@ -152,22 +217,7 @@ bool ComparisonMatchExpression::matchesSingleElement(const BSONElement& e,
     int x = BSONElement::compareElements(
         e, _rhs, BSONElement::ComparisonRules::kConsiderFieldName, _collator);
 
-    switch (matchType()) {
-        case LT:
-            return x < 0;
-        case LTE:
-            return x <= 0;
-        case EQ:
-            return x == 0;
-        case GT:
-            return x > 0;
-        case GTE:
-            return x >= 0;
-        default:
-            // This is a comparison match expression, so it must be either
-            // a $lt, $lte, $gt, $gte, or equality expression.
-            fassertFailed(16828);
-    }
+    return comparisonResultMatches(x);
 }
 
 constexpr StringData EqualityMatchExpression::kName;
@@ -175,41 +225,18 @@ constexpr StringData LTMatchExpression::kName;
 constexpr StringData LTEMatchExpression::kName;
 constexpr StringData GTMatchExpression::kName;
 constexpr StringData GTEMatchExpression::kName;
+constexpr size_t InMatchExpression::kMinEqualitiesForHashing;
 
 // ---------------
 
-// TODO: move
-inline pcrecpp::RE_Options flags2options(const char* flags) {
-    pcrecpp::RE_Options options;
-    options.set_utf8(true);
-    while (flags && *flags) {
-        if (*flags == 'i')
-            options.set_caseless(true);
-        else if (*flags == 'm')
-            options.set_multiline(true);
-        else if (*flags == 'x')
-            options.set_extended(true);
-        else if (*flags == 's')
-            options.set_dotall(true);
-        flags++;
-    }
-    return options;
-}
-
 RegexMatchExpression::RegexMatchExpression(StringData path, const BSONElement& e)
-    : LeafMatchExpression(REGEX, path),
-      _regex(e.regex()),
-      _flags(e.regexFlags()),
-      _re(new pcrecpp::RE(_regex.c_str(), flags2options(_flags.c_str()))) {
+    : LeafMatchExpression(REGEX, path), _regex(e.regex()), _flags(e.regexFlags()) {
     uassert(ErrorCodes::BadValue, "regex not a regex", e.type() == RegEx);
     _init();
 }
 
 RegexMatchExpression::RegexMatchExpression(StringData path, StringData regex, StringData options)
-    : LeafMatchExpression(REGEX, path),
-      _regex(regex.toString()),
-      _flags(options.toString()),
-      _re(new pcrecpp::RE(_regex.c_str(), flags2options(_flags.c_str()))) {
+    : LeafMatchExpression(REGEX, path), _regex(regex.toString()), _flags(options.toString()) {
     _init();
 }
 
@@ -222,6 +249,7 @@ void RegexMatchExpression::_init() {
             "Regular expression options string cannot contain an embedded null byte",
             _flags.find('\0') == std::string::npos);
 
+    _re = CompiledRegex::get(_regex, _flags);
     uassert(ErrorCodes::BadValue,
             str::stream() << "Regular expression is invalid: " << _re->error(),
             _re->error().empty());
@@ -241,13 +269,8 @@ bool RegexMatchExpression::equivalent(const MatchExpression* other) const {
 bool RegexMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails* details) const {
     switch (e.type()) {
         case String:
-        case Symbol: {
-            // String values stored in documents can contain embedded NUL bytes. We construct a
-            // pcrecpp::StringPiece instance using the full length of the string to avoid truncating
-            // 'data' early.
-            pcrecpp::StringPiece data(e.valuestr(), e.valuestrsize() - 1);
-            return _re->PartialMatch(data);
-        }
+        case Symbol:
+            return _re->partialMatch(e.valueStringData());
         case RegEx:
             return _regex == e.regex() && _flags == e.regexFlags();
         default:
@@ -373,6 +396,9 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasNull = _hasNull;
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
+    next->_equalityKind = _equalityKind;
+    next->_integerEqualities = _integerEqualities;
+    next->_stringEqualities = _stringEqualities;
     next->_originalEqualityVector = _originalEqualityVector;
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
@@ -386,7 +412,7 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails*
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    if (_equalitySetContains(e)) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -477,7 +503,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
     _eltCmp = BSONElementComparator(BSONElementComparator::FieldNamesMode::kIgnore, _collator);
 
     // We need to re-compute '_equalitySet', since our set comparator has changed.
-    _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    _buildEqualitySet();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -497,11 +523,93 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
     }
     _originalEqualityVector = std::move(equalities);
 
-    _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    _buildEqualitySet();
 
     return Status::OK();
 }
 
+void InMatchExpression::_buildEqualitySet() {
+    _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+
+    _equalityKind = EqualityKind::kMixed;
+    _integerEqualities.clear();
+    _stringEqualities.clear();
+    _integerHashSet.clear();
+    _equalityHashSet = boost::none;
+    if (_equalitySet.empty()) {
+        return;
+    }
+    const bool useHashing = _equalitySet.size() >= kMinEqualitiesForHashing;
+
+    auto isInteger = [](const BSONElement& e) {
+        return e.type() == BSONType::NumberInt || e.type() == BSONType::NumberLong;
+    };
+    auto isString = [](const BSONElement& e) {
+        return e.type() == BSONType::String || e.type() == BSONType::Symbol;
+    };
+
+    if (std::all_of(_equalitySet.begin(), _equalitySet.end(), isInteger)) {
+        _equalityKind = EqualityKind::kIntegers;
+        for (auto&& equality : _equalitySet) {
+            if (useHashing) {
+                _integerHashSet.insert(equality.numberLong());
+            } else {
+                _integerEqualities.push_back(equality.numberLong());
+            }
+        }
+        // '_equalitySet' is already sorted numerically.
+    } else if (!_collator && std::all_of(_equalitySet.begin(), _equalitySet.end(), isString)) {
+        _equalityKind = EqualityKind::kStrings;
+        if (!useHashing) {
+            for (auto&& equality : _equalitySet) {
+                _stringEqualities.push_back(equality.valueStringData());
+            }
+            std::sort(_stringEqualities.begin(), _stringEqualities.end());
+        }
+    }
+
+    // A double or decimal may still equal one of the integers, so the general hash set is
+    // needed for integer lists too.
+    if (useHashing) {
+        _equalityHashSet = _eltCmp.makeBSONEltUnorderedSet();
+        _equalityHashSet->reserve(_equalitySet.size());
+        _equalityHashSet->insert(_equalitySet.begin(), _equalitySet.end());
+    }
+}
+
+bool InMatchExpression::_equalitySetContains(const BSONElement& e) const {
+    switch (_equalityKind) {
+        case EqualityKind::kIntegers:
+            if (e.type() == BSONType::NumberInt || e.type() == BSONType::NumberLong) {
+                if (_equalityHashSet) {
+                    return _integerHashSet.count(e.numberLong()) > 0;
+                }
+                return std::binary_search(
+                    _integerEqualities.begin(), _integerEqualities.end(), e.numberLong());
+            }
+            if (!e.isNumber()) {
+                return false;
+            }
+            // A double or decimal may still equal one of the integers.
+            break;
+        case EqualityKind::kStrings:
+            if (e.type() != BSONType::String && e.type() != BSONType::Symbol) {
+                return false;
+            }
+            if (!_equalityHashSet) {
+                return std::binary_search(
+                    _stringEqualities.begin(), _stringEqualities.end(), e.valueStringData());
+            }
+            break;
+        case EqualityKind::kMixed:
+            break;
+    }
+    if (_equalityHashSet) {
+        return _equalityHashSet->count(e) > 0;
+    }
+    return _equalitySet.find(e) != _equalitySet.end();
+}
+
 Status InMatchExpression::addRegex(std::unique_ptr<RegexMatchExpression> expr) {
     _regexes.push_back(std::move(expr));
     return Status::OK();
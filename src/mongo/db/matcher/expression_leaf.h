@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
@@ -36,14 +38,12 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_map.h"
-
-namespace pcrecpp {
-class RE;
-}  // namespace pcrecpp;
+#include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 
 class CollatorInterface;
+class CompiledRegex;
 
 class LeafMatchExpression : public PathMatchExpression {
 public:
@@ -167,6 +167,24 @@ public:
     virtual ~ComparisonMatchExpression() = default;
 
     bool matchesSingleElement(const BSONElement&, MatchDetails* details = nullptr) const final;
+
+private:
+    // The kinds of constant for which matchesSingleElement() can skip the generic type dispatch
+    // of BSONElement::compareElements() when the element has the same type.
+    enum class FastPathKind { kNone, kInt64, kDouble, kString };
+
+    /**
+     * Returns whether 'cmp', the three-way result of comparing an element against '_rhs',
+     * satisfies this expression's comparison operator.
+     */
+    bool comparisonResultMatches(int cmp) const;
+
+    // Chosen once at construction from the type of '_rhs'. The value of '_rhs' is cached in the
+    // matching member below.
+    FastPathKind _fastPathKind = FastPathKind::kNone;
+    long long _rhsInt64 = 0;
+    double _rhsDouble = 0;
+    StringData _rhsString;
 };
 
 class EqualityMatchExpression final : public ComparisonMatchExpression {
@@ -322,7 +340,7 @@ private:
 
     std::string _regex;
     std::string _flags;
-    std::unique_ptr<pcrecpp::RE> _re;
+    std::shared_ptr<const CompiledRegex> _re;
 };
 
 class ModMatchExpression : public LeafMatchExpression {
@@ -437,6 +455,17 @@ public:
 private:
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Rebuilds '_equalitySet' and the type-specialized copies of the equalities from
+     * '_originalEqualityVector'.
+     */
+    void _buildEqualitySet();
+
+    /**
+     * Returns whether 'e' is equal to one of the equalities.
+     */
+    bool _equalitySetContains(const BSONElement& e) const;
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -457,6 +486,21 @@ private:
     // for this set.
     BSONEltFlatSet _equalitySet;
 
+    // When every equality has the same type, matching compares against a sorted copy of their
+    // values instead of looking each element up in '_equalitySet' with the generic comparator.
+    // Strings only qualify when they are compared without a collator.
+    enum class EqualityKind { kMixed, kIntegers, kStrings };
+    EqualityKind _equalityKind = EqualityKind::kMixed;
+    std::vector<long long> _integerEqualities;
+    std::vector<StringData> _stringEqualities;
+
+    // Lists of at least this many equalities are matched by hashing instead of binary search:
+    // integers through '_integerHashSet', everything else through '_equalityHashSet', whose
+    // hashing follows '_eltCmp'.
+    static constexpr size_t kMinEqualitiesForHashing = 64;
+    stdx::unordered_set<long long> _integerHashSet;
+    boost::optional<BSONEltUnorderedSet> _equalityHashSet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
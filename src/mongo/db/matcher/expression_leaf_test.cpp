@@ -28,6 +28,8 @@
 
 /** Unit tests for MatchMatchExpression operator implementations in match_operators.{h,cpp}. */
 
+#include <limits>
+
 #include "mongo/unittest/unittest.h"
 
 #include "mongo/db/jsobj.h"
@@ -36,6 +38,7 @@
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
 
 namespace mongo {
@@ -84,6 +87,65 @@ TEST(ComparisonMatchExpression, StringMatchingRespectsCollation) {
                           NULL));
 }
 
+TEST(ComparisonMatchExpression, IntegralComparisonsAgreeAcrossIntAndLong) {
+    BSONObj operand = BSON("$lt" << 5LL);
+    LTMatchExpression lt("a", operand["$lt"]);
+    ASSERT(lt.matchesBSON(BSON("a" << 4), nullptr));
+    ASSERT(lt.matchesBSON(BSON("a" << 4LL), nullptr));
+    ASSERT(!lt.matchesBSON(BSON("a" << 5), nullptr));
+    ASSERT(!lt.matchesBSON(BSON("a" << 5LL), nullptr));
+    ASSERT(lt.matchesBSON(BSON("a" << std::numeric_limits<long long>::min()), nullptr));
+    ASSERT(!lt.matchesBSON(BSON("a" << std::numeric_limits<long long>::max()), nullptr));
+    ASSERT(lt.matchesBSON(BSON("a" << 4.5), nullptr));
+    ASSERT(!lt.matchesBSON(BSON("a" << 5.5), nullptr));
+}
+
+TEST(ComparisonMatchExpression, DoubleComparisonsHandleNaNAndOtherNumericTypes) {
+    BSONObj operand = BSON("$gte" << 1.5);
+    GTEMatchExpression gte("a", operand["$gte"]);
+    ASSERT(gte.matchesBSON(BSON("a" << 1.5), nullptr));
+    ASSERT(gte.matchesBSON(BSON("a" << 2.0), nullptr));
+    ASSERT(!gte.matchesBSON(BSON("a" << 1.0), nullptr));
+    ASSERT(!gte.matchesBSON(BSON("a" << std::numeric_limits<double>::quiet_NaN()), nullptr));
+    ASSERT(gte.matchesBSON(BSON("a" << 2), nullptr));
+    ASSERT(!gte.matchesBSON(BSON("a" << 1LL), nullptr));
+    ASSERT(!gte.matchesBSON(BSON("a"
+                                 << "2"),
+                            nullptr));
+}
+
+TEST(ComparisonMatchExpression, StringComparisonsUseCollatorWhenSet) {
+    BSONObj operand = BSON("$gt"
+                           << "abc");
+    GTMatchExpression gt("a", operand["$gt"]);
+    ASSERT(gt.matchesBSON(BSON("a"
+                               << "abd"),
+                          nullptr));
+    ASSERT(!gt.matchesBSON(BSON("a"
+                                << "abc"),
+                           nullptr));
+    ASSERT(gt.matchesBSON(BSON("a"
+                               << "abcd"),
+                          nullptr));
+
+    ASSERT(gt.matchesBSON(BSON("a"
+                               << "ba"),
+                          nullptr));
+    ASSERT(!gt.matchesBSON(BSON("a"
+                                << "aad"),
+                           nullptr));
+
+    // With a collator that compares reversed strings, "cba" is the bound.
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    gt.setCollator(&collator);
+    ASSERT(!gt.matchesBSON(BSON("a"
+                                << "ba"),
+                           nullptr));
+    ASSERT(gt.matchesBSON(BSON("a"
+                               << "aad"),
+                          nullptr));
+}
+
 TEST(EqOp, MatchesElement) {
     BSONObj operand = BSON("a" << 5);
     BSONObj match = BSON("a" << 5.0);
@@ -1258,6 +1320,124 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities().count(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, IntegerEqualitiesMatchAllNumericTypes) {
+    BSONArray operand = BSON_ARRAY(3 << 1LL << 2 << (1LL << 40));
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    for (auto&& elem : operand) {
+        equalities.push_back(elem);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    BSONObj obj = BSON("int" << 2 << "long" << (1LL << 40) << "double" << 3.0 << "decimal"
+                             << Decimal128("1")
+                             << "fraction"
+                             << 2.5
+                             << "missing"
+                             << 4
+                             << "string"
+                             << "3");
+    ASSERT(in.matchesSingleElement(obj["int"]));
+    ASSERT(in.matchesSingleElement(obj["long"]));
+    ASSERT(in.matchesSingleElement(obj["double"]));
+    ASSERT(in.matchesSingleElement(obj["decimal"]));
+    ASSERT(!in.matchesSingleElement(obj["fraction"]));
+    ASSERT(!in.matchesSingleElement(obj["missing"]));
+    ASSERT(!in.matchesSingleElement(obj["string"]));
+}
+
+TEST(InMatchExpression, StringEqualitiesMatchStringsAndSymbols) {
+    BSONArray operand = BSON_ARRAY("b"
+                                   << "a"
+                                   << "c");
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    for (auto&& elem : operand) {
+        equalities.push_back(elem);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    BSONObjBuilder builder;
+    builder.append("string", "c");
+    builder.appendSymbol("symbol", "a");
+    builder.append("prefix", "ab");
+    builder.append("number", 1);
+    BSONObj obj = builder.obj();
+    ASSERT(in.matchesSingleElement(obj["string"]));
+    ASSERT(in.matchesSingleElement(obj["symbol"]));
+    ASSERT(!in.matchesSingleElement(obj["prefix"]));
+    ASSERT(!in.matchesSingleElement(obj["number"]));
+}
+
+TEST(InMatchExpression, ShallowCloneMatchesWithSpecializedEqualities) {
+    BSONArray operand = BSON_ARRAY(1 << 2);
+    auto in = stdx::make_unique<InMatchExpression>("a");
+    std::vector<BSONElement> equalities{operand[0], operand[1]};
+    ASSERT_OK(in->setEqualities(std::move(equalities)));
+    auto clone = in->shallowClone();
+    in.reset();
+    ASSERT(clone->matchesBSON(BSON("a" << 2), nullptr));
+    ASSERT(!clone->matchesBSON(BSON("a" << 3), nullptr));
+}
+
+TEST(InMatchExpression, LargeIntegerListMatchesAllNumericTypes) {
+    BSONArrayBuilder operandBuilder;
+    for (long long i = 0; i < 1000; ++i) {
+        operandBuilder.append(i * 3);
+    }
+    BSONArray operand = operandBuilder.arr();
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    for (auto&& elem : operand) {
+        equalities.push_back(elem);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    BSONObj obj = BSON("int" << 2997 << "long" << 300LL << "double" << 9.0 << "decimal"
+                             << Decimal128("12")
+                             << "missing"
+                             << 4
+                             << "fraction"
+                             << 4.5
+                             << "string"
+                             << "3");
+    ASSERT(in.matchesSingleElement(obj["int"]));
+    ASSERT(in.matchesSingleElement(obj["long"]));
+    ASSERT(in.matchesSingleElement(obj["double"]));
+    ASSERT(in.matchesSingleElement(obj["decimal"]));
+    ASSERT(!in.matchesSingleElement(obj["missing"]));
+    ASSERT(!in.matchesSingleElement(obj["fraction"]));
+    ASSERT(!in.matchesSingleElement(obj["string"]));
+}
+
+TEST(InMatchExpression, LargeMixedListRespectsCollation) {
+    BSONArrayBuilder operandBuilder;
+    for (int i = 0; i < 100; ++i) {
+        operandBuilder.append(i);
+        operandBuilder.append("s" + std::to_string(i));
+    }
+    BSONArray operand = operandBuilder.arr();
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InMatchExpression in("");
+    in.setCollator(&collator);
+    std::vector<BSONElement> equalities;
+    for (auto&& elem : operand) {
+        equalities.push_back(elem);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    BSONObj obj = BSON("number" << 42.0 << "string"
+                                << "S42"
+                                << "missing"
+                                << "s100"
+                                << "other"
+                                << BSON("s" << 1));
+    ASSERT(in.matchesSingleElement(obj["number"]));
+    ASSERT(in.matchesSingleElement(obj["string"]));
+    ASSERT(!in.matchesSingleElement(obj["missing"]));
+    ASSERT(!in.matchesSingleElement(obj["other"]));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
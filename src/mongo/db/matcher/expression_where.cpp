@@ -35,12 +35,14 @@
 #include "mongo/base/init.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/timer.h"
 
 
 namespace mongo {
@@ -65,7 +67,10 @@ WhereMatchExpression::WhereMatchExpression(OperationContext* opCtx,
         AuthorizationSession::get(Client::getCurrent())->getAuthenticatedUserNamesToken();
 
     _scope = getGlobalScriptEngine()->getPooledScope(_opCtx, _dbName, "where" + userToken);
+
+    Timer compileTimer;
     _func = _scope->createFunction(getCode().c_str());
+    CurOp::get(_opCtx)->debug().jsCompileMicros += compileTimer.micros();
 
     uassert(ErrorCodes::BadValue, "$where compile error", _func);
 }
@@ -82,7 +87,9 @@ bool WhereMatchExpression::matches(const MatchableDocument* doc, MatchDetails* d
     _scope->setObject("obj", const_cast<BSONObj&>(obj));
     _scope->setBoolean("fullObject", true);  // this is a hack b/c fullObject used to be relevant
 
+    Timer executionTimer;
     int err = _scope->invoke(_func, 0, &obj, 1000 * 60, false);
+    CurOp::get(_opCtx)->debug().jsExecutionMicros += executionTimer.micros();
     if (err == -3) {  // INVOKE_ERROR
         stringstream ss;
         ss << "error on invocation of $where function:\n" << _scope->getError();
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/schema/json_schema_compiler.h"
+
+#include "mongo/bson/bsontypes.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+constexpr StringData kSchemaBsonTypeKeyword = "bsonType"_sd;
+constexpr StringData kSchemaDescriptionKeyword = "description"_sd;
+constexpr StringData kSchemaPropertiesKeyword = "properties"_sd;
+constexpr StringData kSchemaRequiredKeyword = "required"_sd;
+constexpr StringData kSchemaTitleKeyword = "title"_sd;
+constexpr StringData kSchemaTypeKeyword = "type"_sd;
+}  // namespace
+
+constexpr size_t CompiledJSONSchema::kMaxProperties;
+
+std::unique_ptr<CompiledJSONSchema> CompiledJSONSchema::compile(const BSONObj& schema) {
+    std::unique_ptr<CompiledJSONSchema> compiled(new CompiledJSONSchema());
+    compiled->_source = schema.getOwned();
+    compiled->_root = compileSchema(compiled->_source);
+    if (!compiled->_root) {
+        return nullptr;
+    }
+
+    // Only objects are stored, so a top-level type which excludes "object" matches nothing and
+    // any other top-level type matches everything.
+    auto& rootType = compiled->_root->type;
+    compiled->_matchesNothing = rootType && !rootType->hasType(BSONType::Object);
+    rootType = boost::none;
+    return compiled;
+}
+
+std::unique_ptr<CompiledJSONSchema::Schema> CompiledJSONSchema::compileSchema(
+    const BSONObj& schema) {
+    auto compiled = stdx::make_unique<Schema>();
+
+    auto findOrAddProperty = [&](StringData name) -> Property* {
+        for (auto&& property : compiled->properties) {
+            if (property.name == name) {
+                return &property;
+            }
+        }
+
+        // The interpreted matcher looks properties up by path, so a name containing a dot would
+        // be treated as a path into a subdocument.
+        if (name.empty() || name.find('.') != std::string::npos ||
+            compiled->properties.size() == kMaxProperties) {
+            return nullptr;
+        }
+        compiled->properties.emplace_back();
+        compiled->properties.back().name = name;
+        return &compiled->properties.back();
+    };
+
+    for (auto&& keyword : schema) {
+        auto keywordName = keyword.fieldNameStringData();
+        if (keywordName == kSchemaTitleKeyword || keywordName == kSchemaDescriptionKeyword) {
+            continue;
+        } else if (keywordName == kSchemaTypeKeyword || keywordName == kSchemaBsonTypeKeyword) {
+            auto typeSet = MatcherTypeSet::parse(keyword,
+                                                 keywordName == kSchemaTypeKeyword
+                                                     ? MatcherTypeSet::kJsonSchemaTypeAliasMap
+                                                     : kTypeAliasMap);
+            if (!typeSet.isOK() || typeSet.getValue().isEmpty()) {
+                return nullptr;
+            }
+            compiled->type = std::move(typeSet.getValue());
+        } else if (keywordName == kSchemaPropertiesKeyword) {
+            if (keyword.type() != BSONType::Object) {
+                return nullptr;
+            }
+            for (auto&& propertyElt : keyword.embeddedObject()) {
+                if (propertyElt.type() != BSONType::Object) {
+                    return nullptr;
+                }
+                auto property = findOrAddProperty(propertyElt.fieldNameStringData());
+                if (!property || property->schema) {
+                    return nullptr;
+                }
+                property->schema = compileSchema(propertyElt.embeddedObject());
+                if (!property->schema) {
+                    return nullptr;
+                }
+            }
+        } else if (keywordName == kSchemaRequiredKeyword) {
+            if (keyword.type() != BSONType::Array) {
+                return nullptr;
+            }
+            for (auto&& requiredElt : keyword.embeddedObject()) {
+                if (requiredElt.type() != BSONType::String) {
+                    return nullptr;
+                }
+                auto property = findOrAddProperty(requiredElt.valueStringData());
+                if (!property) {
+                    return nullptr;
+                }
+                property->required = true;
+            }
+        } else {
+            return nullptr;
+        }
+    }
+
+    for (size_t i = 0; i < compiled->properties.size(); ++i) {
+        if (compiled->properties[i].required) {
+            compiled->requiredMask |= uint64_t{1} << i;
+        }
+    }
+    return compiled;
+}
+
+bool CompiledJSONSchema::matches(const BSONObj& doc) const {
+    return !_matchesNothing && matchesObject(*_root, doc);
+}
+
+bool CompiledJSONSchema::matchesObject(const Schema& schema, const BSONObj& obj) {
+    if (schema.properties.empty()) {
+        return true;
+    }
+
+    // Like a path lookup, only the first occurrence of a duplicated field name is considered.
+    uint64_t seen = 0;
+    for (auto&& elem : obj) {
+        auto fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < schema.properties.size(); ++i) {
+            const auto& property = schema.properties[i];
+            if (property.name != fieldName) {
+                continue;
+            }
+
+            const uint64_t bit = uint64_t{1} << i;
+            if (!(seen & bit)) {
+                seen |= bit;
+                if (property.schema && !matchesValue(*property.schema, elem)) {
+                    return false;
+                }
+            }
+            break;
+        }
+    }
+    return (schema.requiredMask & ~seen) == 0;
+}
+
+bool CompiledJSONSchema::matchesValue(const Schema& schema, const BSONElement& elem) {
+    // JSON Schema types do not traverse arrays.
+    if (schema.type && !schema.type->hasType(elem.type())) {
+        return false;
+    }
+
+    // The 'properties' and 'required' keywords only restrict values which are objects.
+    if (elem.type() == BSONType::Object) {
+        return matchesObject(schema, elem.embeddedObject());
+    }
+    return true;
+}
+
+}  // namespace mongo
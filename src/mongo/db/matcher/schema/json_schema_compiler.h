@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/matcher_type_set.h"
+
+namespace mongo {
+
+/**
+ * A $jsonSchema which has been compiled into a form that validates a document in a single pass over
+ * its fields, rather than through the match expression tree produced by JSONSchemaParser. Only the
+ * keywords most commonly used in collection validators are supported: 'type', 'bsonType',
+ * 'required' and 'properties', along with the 'title' and 'description' annotations. Schemas which
+ * use anything else must be evaluated through JSONSchemaParser.
+ */
+class CompiledJSONSchema {
+public:
+    /**
+     * Compiles 'schema', which must already have been accepted by JSONSchemaParser::parse().
+     * Returns nullptr if the schema uses a keyword or construct which cannot be compiled, in which
+     * case the caller should fall back to the parsed match expression.
+     */
+    static std::unique_ptr<CompiledJSONSchema> compile(const BSONObj& schema);
+
+    /**
+     * Returns whether 'doc' matches the schema. Gives the same result as matching 'doc' against the
+     * match expression produced by JSONSchemaParser::parse() for the same schema.
+     */
+    bool matches(const BSONObj& doc) const;
+
+private:
+    // The maximum number of properties, counting those which are only required, that one level of
+    // a schema can have. Each property is tracked by a bit while walking the document.
+    static constexpr size_t kMaxProperties = 64;
+
+    struct Schema;
+
+    struct Property {
+        StringData name;
+        bool required = false;
+
+        // Null if the property is only named by 'required'.
+        std::unique_ptr<Schema> schema;
+    };
+
+    struct Schema {
+        // Unset if the schema has no 'type' or 'bsonType' keyword.
+        boost::optional<MatcherTypeSet> type;
+
+        std::vector<Property> properties;
+
+        // The bits of the properties which must be present.
+        uint64_t requiredMask = 0;
+    };
+
+    static std::unique_ptr<Schema> compileSchema(const BSONObj& schema);
+
+    static bool matchesObject(const Schema& schema, const BSONObj& obj);
+
+    static bool matchesValue(const Schema& schema, const BSONElement& elem);
+
+    CompiledJSONSchema() = default;
+
+    // The compiled schema points into this owned copy of the source schema.
+    BSONObj _source;
+    std::unique_ptr<Schema> _root;
+
+    // Set if the top-level schema requires a type other than "object", so no document matches.
+    bool _matchesNothing = false;
+};
+
+}  // namespace mongo
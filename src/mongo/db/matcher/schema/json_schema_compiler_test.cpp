@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/matcher/schema/json_schema_compiler.h"
+#include "mongo/db/matcher/schema/json_schema_parser.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const std::vector<BSONObj> kDocs = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 1.5, b: 'str'}"),
+    fromjson("{a: 'str'}"),
+    fromjson("{a: null}"),
+    fromjson("{a: [1, 2]}"),
+    fromjson("{a: [{b: 1}]}"),
+    fromjson("{a: {}}"),
+    fromjson("{a: {b: 1}}"),
+    fromjson("{a: {b: 'str', c: {d: 1}}}"),
+    fromjson("{a: {b: 'str', c: {d: 'str'}}}"),
+    fromjson("{a: {c: 1}}"),
+    fromjson("{a: 1, a: 'str'}"),
+    fromjson("{a: 'str', a: 1}"),
+    fromjson("{b: 1, c: 1}"),
+    fromjson("{b: {a: 1}}"),
+    fromjson("{'a.b': 1}"),
+};
+
+/**
+ * Asserts that 'schema' compiles, and that the compiled schema agrees with the parsed match
+ * expression on every document in 'kDocs'.
+ */
+void assertCompiledMatchesParsed(const char* schemaJson) {
+    BSONObj schema = fromjson(schemaJson);
+    auto parsed = JSONSchemaParser::parse(schema);
+    ASSERT_OK(parsed.getStatus());
+    auto compiled = CompiledJSONSchema::compile(schema);
+    ASSERT(compiled) << schemaJson;
+
+    for (auto&& doc : kDocs) {
+        ASSERT_EQ(parsed.getValue()->matchesBSON(doc), compiled->matches(doc))
+            << "schema: " << schemaJson << " doc: " << doc;
+    }
+}
+
+TEST(CompiledJSONSchemaTest, EmptySchemaMatchesEverything) {
+    assertCompiledMatchesParsed("{}");
+    assertCompiledMatchesParsed("{title: 't', description: 'd'}");
+}
+
+TEST(CompiledJSONSchemaTest, TopLevelType) {
+    assertCompiledMatchesParsed("{type: 'object'}");
+    assertCompiledMatchesParsed("{type: 'string'}");
+    assertCompiledMatchesParsed("{bsonType: ['object', 'int']}");
+    assertCompiledMatchesParsed("{bsonType: 'number'}");
+}
+
+TEST(CompiledJSONSchemaTest, Required) {
+    assertCompiledMatchesParsed("{required: ['a']}");
+    assertCompiledMatchesParsed("{required: ['a', 'b']}");
+}
+
+TEST(CompiledJSONSchemaTest, PropertyTypes) {
+    assertCompiledMatchesParsed("{properties: {a: {type: 'number'}}}");
+    assertCompiledMatchesParsed("{properties: {a: {bsonType: 'int'}, b: {bsonType: 'string'}}}");
+    assertCompiledMatchesParsed("{properties: {a: {type: ['string', 'null']}}}");
+    assertCompiledMatchesParsed("{properties: {a: {type: 'array'}}}");
+    assertCompiledMatchesParsed("{properties: {a: {bsonType: 'string'}}, required: ['a']}");
+    assertCompiledMatchesParsed("{properties: {a: {}}, required: ['b']}");
+}
+
+TEST(CompiledJSONSchemaTest, NestedProperties) {
+    assertCompiledMatchesParsed("{properties: {a: {properties: {b: {type: 'string'}}}}}");
+    assertCompiledMatchesParsed("{properties: {a: {type: 'object', required: ['b']}}}");
+    assertCompiledMatchesParsed("{properties: {a: {bsonType: 'int', required: ['b']}}}");
+    assertCompiledMatchesParsed("{properties: {a: {required: ['b']}}, required: ['a']}");
+    assertCompiledMatchesParsed(
+        "{properties: {a: {bsonType: ['object', 'string'], required: ['b'],"
+        "  properties: {c: {properties: {d: {bsonType: 'int'}}}}}}}");
+}
+
+TEST(CompiledJSONSchemaTest, DoesNotCompileUnsupportedKeywords) {
+    ASSERT_FALSE(CompiledJSONSchema::compile(fromjson("{minProperties: 1}")));
+    ASSERT_FALSE(
+        CompiledJSONSchema::compile(fromjson("{properties: {a: {type: 'string', maxLength: 2}}}")));
+    ASSERT_FALSE(CompiledJSONSchema::compile(fromjson("{properties: {'a.b': {type: 'string'}}}")));
+    ASSERT_FALSE(CompiledJSONSchema::compile(fromjson("{required: ['a.b']}")));
+}
+
+TEST(CompiledJSONSchemaTest, DoesNotCompileTooManyProperties) {
+    BSONObjBuilder properties;
+    for (int i = 0; i < 65; ++i) {
+        properties.append(std::to_string(i), BSONObj());
+    }
+    ASSERT_FALSE(CompiledJSONSchema::compile(BSON("properties" << properties.obj())));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,7 +33,7 @@
 namespace mongo {
 
 const OperationContext::Decoration<MultikeyPathTracker> MultikeyPathTracker::get =
-    OperationContext::declareDecoration<MultikeyPathTracker>();
+    OperationContext::declareLazyDecoration<MultikeyPathTracker>();
 
 void MultikeyPathTracker::mergeMultikeyPaths(MultikeyPaths* toMergeInto,
                                              const MultikeyPaths& newPaths) {
@@ -49,6 +49,7 @@ constexpr StringData NamespaceString::kAdminDb;
 constexpr StringData NamespaceString::kLocalDb;
 constexpr StringData NamespaceString::kConfigDb;
 constexpr StringData NamespaceString::kSystemDotViewsCollectionName;
+constexpr StringData NamespaceString::kTimeseriesBucketsCollectionPrefix;
 
 const NamespaceString NamespaceString::kServerConfigurationNamespace(NamespaceString::kAdminDb,
                                                                      "system.version");
@@ -105,6 +106,9 @@ bool NamespaceString::isLegalClientSystemNS() const {
     if (coll() == kSystemDotViewsCollectionName)
         return true;
 
+    if (isTimeseriesBucketsCollection())
+        return true;
+
     return false;
 }
 
@@ -150,6 +154,10 @@ boost::optional<NamespaceString> NamespaceString::getTargetNSForGloballyManagedN
     return NamespaceString{db(), coll().substr(indexOfNextDot + 1)};
 }
 
+NamespaceString NamespaceString::makeTimeseriesBucketsNamespace() const {
+    return {db(), kTimeseriesBucketsCollectionPrefix.toString() + coll()};
+}
+
 bool NamespaceString::isDropPendingNamespace() const {
     return coll().startsWith(dropPendingNSPrefix);
 }
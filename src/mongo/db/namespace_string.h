@@ -60,6 +60,9 @@ public:
     // Name for the system views collection
     static constexpr StringData kSystemDotViewsCollectionName = "system.views"_sd;
 
+    // Prefix for the collections holding the buckets of time-series collections
+    static constexpr StringData kTimeseriesBucketsCollectionPrefix = "system.buckets."_sd;
+
     // Namespace for storing configuration data, which needs to be replicated if the server is
     // running as a replica set. Documents in this collection should represent some configuration
     // state of the server, which needs to be recovered/consulted at startup. Each document in this
@@ -233,6 +236,9 @@ public:
     bool isSystemDotViews() const {
         return coll() == kSystemDotViewsCollectionName;
     }
+    bool isTimeseriesBucketsCollection() const {
+        return coll().startsWith(kTimeseriesBucketsCollectionPrefix);
+    }
     bool isServerConfigurationCollection() const {
         return (db() == kAdminDb) && (coll() == "system.version");
     }
@@ -300,6 +306,15 @@ public:
      */
     boost::optional<NamespaceString> getTargetNSForGloballyManagedNamespace() const;
 
+    /**
+     * Returns the namespace of the collection holding the buckets of the time-series collection
+     * with this namespace.
+     *
+     * Example:
+     *     test.foo -> test.system.buckets.foo
+     */
+    NamespaceString makeTimeseriesBucketsNamespace() const;
+
     /**
      * Returns true if this namespace refers to a drop-pending collection.
      */
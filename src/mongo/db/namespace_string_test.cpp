@@ -224,6 +224,15 @@ TEST(NamespaceStringTest, IsDropPendingNamespace) {
     ASSERT_FALSE(NamespaceString{"$cmd.listCollections"}.isDropPendingNamespace());
 }
 
+TEST(NamespaceStringTest, TimeseriesBucketsNamespace) {
+    const NamespaceString bucketsNss = NamespaceString("test.foo").makeTimeseriesBucketsNamespace();
+    ASSERT_EQUALS(NamespaceString("test.system.buckets.foo"), bucketsNss);
+    ASSERT_TRUE(bucketsNss.isTimeseriesBucketsCollection());
+    ASSERT_TRUE(bucketsNss.isLegalClientSystemNS());
+    ASSERT_FALSE(NamespaceString("test.foo").isTimeseriesBucketsCollection());
+    ASSERT_FALSE(NamespaceString("test.system.buckets").isTimeseriesBucketsCollection());
+}
+
 TEST(NamespaceStringTest, MakeDropPendingNamespace) {
     ASSERT_EQUALS(NamespaceString{"test.system.drop.0i0t-1.foo"},
                   NamespaceString{"test.foo"}.makeDropPendingNamespace(repl::OpTime()));
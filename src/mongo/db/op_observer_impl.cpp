@@ -61,7 +61,7 @@ namespace {
 
 MONGO_FAIL_POINT_DEFINE(failCollectionUpdates);
 
-const auto getDeleteState = OperationContext::declareDecoration<ShardObserverDeleteState>();
+const auto getDeleteState = OperationContext::declareLazyDecoration<ShardObserverDeleteState>();
 
 repl::OpTime logOperation(OperationContext* opCtx,
                           const char* opstr,
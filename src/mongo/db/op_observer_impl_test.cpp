@@ -222,6 +222,43 @@ TEST_F(OpObserverTest, OnDropCollectionReturnsDropOpTime) {
     ASSERT_EQUALS(repl::ReplClientInfo::forClient(&cc()).getLastOp(), dropOpTime);
 }
 
+TEST_F(OpObserverTest, OnInsertsWritesOneOplogEntryPerDocumentInOrder) {
+    OpObserverImpl opObserver;
+    auto opCtx = cc().makeOperationContext();
+    auto uuid = CollectionUUID::gen();
+
+    // A long collection name makes each oplog entry larger than the space initially set aside for
+    // it, so the entries are built across several buffer reallocations.
+    NamespaceString nss("test", std::string(200, 'c'));
+    const int kNumDocs = 20;
+    std::vector<InsertStatement> inserts;
+    for (int i = 0; i < kNumDocs; i++) {
+        inserts.emplace_back(BSON("_id" << i << "x" << std::string(i, 'x')));
+    }
+
+    std::vector<repl::OpTime> reservedOpTimes;
+    {
+        AutoGetDb autoDb(opCtx.get(), nss.db(), MODE_X);
+        WriteUnitOfWork wunit(opCtx.get());
+        opObserver.onInserts(opCtx.get(), nss, uuid, inserts.begin(), inserts.end(), false);
+        reservedOpTimes = OpObserver::Times::get(opCtx.get()).reservedOpTimes;
+        wunit.commit();
+    }
+    ASSERT_EQUALS(static_cast<size_t>(kNumDocs), reservedOpTimes.size());
+
+    // The oplog is iterated from the newest entry to the oldest.
+    repl::OplogInterfaceLocal oplogInterface(opCtx.get(), NamespaceString::kRsOplogNamespace.ns());
+    auto oplogIter = oplogInterface.makeIterator();
+    for (int i = kNumDocs - 1; i >= 0; i--) {
+        auto oplogEntry = unittest::assertGet(oplogIter->next()).first;
+        ASSERT_EQUALS("i", oplogEntry.getStringField("op"));
+        ASSERT_EQUALS(nss.ns(), oplogEntry.getStringField("ns"));
+        ASSERT_BSONOBJ_EQ(inserts[i].doc, oplogEntry.getObjectField("o"));
+        ASSERT_EQUALS(reservedOpTimes[i].getTimestamp(), oplogEntry["ts"].timestamp());
+    }
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, oplogIter->next().getStatus());
+}
+
 TEST_F(OpObserverTest, OnRenameCollectionReturnsRenameOpTime) {
     OpObserverImpl opObserver;
     auto opCtx = cc().makeOperationContext();
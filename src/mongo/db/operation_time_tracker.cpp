@@ -40,7 +40,7 @@ struct OperationTimeTrackerHolder {
 };
 
 const OperationContext::Decoration<OperationTimeTrackerHolder> OperationTimeTrackerHolder::get =
-    OperationContext::declareDecoration<OperationTimeTrackerHolder>();
+    OperationContext::declareLazyDecoration<OperationTimeTrackerHolder>();
 }
 
 std::shared_ptr<OperationTimeTracker> OperationTimeTracker::get(OperationContext* opCtx) {
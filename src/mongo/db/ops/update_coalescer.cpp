@@ -0,0 +1,243 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ops/update_coalescer.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(internalUpdateCoalesceIncrements, bool, false);
+
+constexpr size_t UpdateCoalescer::kMaxBatchSize;
+
+namespace {
+
+const auto getUpdateCoalescer = ServiceContext::declareDecoration<UpdateCoalescer>();
+
+/**
+ * Whether an equality on this _id value matches at most one document, whatever the collation.
+ */
+bool isScalarId(const BSONElement& id) {
+    switch (id.type()) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case NumberDecimal:
+        case String:
+        case jstOID:
+        case Date:
+        case BinData:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+UpdateCoalescer* UpdateCoalescer::get(ServiceContext* service) {
+    return &getUpdateCoalescer(service);
+}
+
+boost::optional<UpdateCoalescer::Update> UpdateCoalescer::parse(
+    const NamespaceString& ns, const write_ops::UpdateOpEntry& op) {
+    if (op.getMulti() || op.getUpsert() || op.getArrayFilters() || op.getCollation()) {
+        return boost::none;
+    }
+
+    const BSONObj& query = op.getQ();
+    if (query.nFields() != 1 || query.firstElementFieldNameStringData() != "_id" ||
+        !isScalarId(query.firstElement())) {
+        return boost::none;
+    }
+
+    const BSONObj& update = op.getU();
+    if (update.nFields() != 1 || update.firstElementFieldNameStringData() != "$inc" ||
+        update.firstElement().type() != Object) {
+        return boost::none;
+    }
+    BSONObj increments = update.firstElement().Obj();
+    if (increments.isEmpty()) {
+        return boost::none;
+    }
+    for (auto&& elem : increments) {
+        // Zero deltas are left out so that every update in a batch modifies the document, and
+        // '$' path components are left out because positional updates depend on the query.
+        if ((elem.type() != NumberInt && elem.type() != NumberLong) ||
+            elem.safeNumberLong() == 0 || elem.fieldNameStringData().empty() ||
+            elem.fieldNameStringData().find('$') != std::string::npos) {
+            return boost::none;
+        }
+    }
+
+    const BSONElement id = query.firstElement();
+    std::string key = ns.ns();
+    key.push_back('\0');
+    key.push_back(static_cast<char>(id.type()));
+    key.append(id.value(), id.valuesize());
+    return Update{std::move(key), std::move(increments)};
+}
+
+StatusWith<BSONObj> UpdateCoalescer::combine(const std::vector<BSONObj>& increments) {
+    struct Sum {
+        std::string path;
+        long long value;
+        bool allInt;
+    };
+    std::vector<Sum> sums;
+    StringMap<size_t> positions;
+
+    for (auto&& inc : increments) {
+        for (auto&& elem : inc) {
+            auto it = positions.find(elem.fieldNameStringData());
+            if (it == positions.end()) {
+                positions[elem.fieldNameStringData()] = sums.size();
+                sums.push_back({elem.fieldName(), elem.safeNumberLong(), elem.type() == NumberInt});
+                continue;
+            }
+
+            auto& sum = sums[it->second];
+            if (mongoSignedAddOverflow64(sum.value, elem.safeNumberLong(), &sum.value)) {
+                return {ErrorCodes::Overflow,
+                        str::stream() << "Combined $inc of '" << sum.path
+                                      << "' overflows a 64-bit integer"};
+            }
+            sum.allInt = sum.allInt && elem.type() == NumberInt;
+        }
+    }
+
+    BSONObjBuilder bob;
+    {
+        BSONObjBuilder incBob(bob.subobjStart("$inc"));
+        for (auto&& sum : sums) {
+            if (sum.allInt && sum.value >= std::numeric_limits<int>::min() &&
+                sum.value <= std::numeric_limits<int>::max()) {
+                incBob.append(sum.path, static_cast<int>(sum.value));
+            } else {
+                incBob.append(sum.path, sum.value);
+            }
+        }
+    }
+    return bob.obj();
+}
+
+boost::optional<UpdateCoalescer::Outcome> UpdateCoalescer::run(const Update& update,
+                                                               const ApplyFn& apply) {
+    Waiter self(update.increments);
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto slotIt = _slots.find(update.key);
+    if (slotIt == _slots.end()) {
+        _slots[update.key];
+        self.leader = true;
+    } else {
+        // The wait is bounded by the current leader's single write, so it is not interruptible.
+        slotIt->second.queue.push_back(&self);
+        self.cv.wait(lk, [&] { return self.leader || self.done; });
+        if (self.done) {
+            return self.outcome;
+        }
+    }
+
+    // Lead a batch of this update and those queued behind it.
+    std::vector<Waiter*> batch{&self};
+    auto& queue = _slots.find(update.key)->second.queue;
+    while (!queue.empty() && batch.size() < kMaxBatchSize) {
+        batch.push_back(queue.front());
+        queue.pop_front();
+    }
+    lk.unlock();
+
+    boost::optional<Outcome> outcome;
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto waiter : batch) {
+            if (waiter != &self) {
+                waiter->outcome = outcome;
+                waiter->done = true;
+                waiter->cv.notify_one();
+            }
+        }
+
+        // Hand the slot to the first update that queued during this batch.
+        auto slotIt = _slots.find(update.key);
+        auto& queue = slotIt->second.queue;
+        if (queue.empty()) {
+            _slots.erase(slotIt);
+            return;
+        }
+        auto next = queue.front();
+        queue.pop_front();
+        next->leader = true;
+        next->cv.notify_one();
+    });
+
+    if (batch.size() == 1) {
+        outcome = apply(BSON("$inc" << update.increments));
+        return outcome;
+    }
+
+    std::vector<BSONObj> increments;
+    increments.reserve(batch.size());
+    for (auto waiter : batch) {
+        increments.push_back(waiter->increments);
+    }
+    auto combined = combine(increments);
+    if (!combined.isOK()) {
+        return boost::none;
+    }
+
+    try {
+        outcome = apply(combined.getValue());
+    } catch (const DBException&) {
+        // One of the increments may be what failed, so each update is retried alone.
+        return boost::none;
+    }
+
+    // The deltas of a batch may cancel out, but each update alone would have modified a document
+    // it matched.
+    outcome->nModified = outcome->nMatched;
+    return outcome;
+}
+
+size_t UpdateCoalescer::numQueued(StringData key) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto slotIt = _slots.find(key);
+    return slotIt == _slots.end() ? 0 : slotIt->second.queue.size();
+}
+
+}  // namespace mongo
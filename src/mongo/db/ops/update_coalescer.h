@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Whether concurrent $inc updates of the same document may be combined into one write. Off by
+ * default.
+ */
+extern AtomicBool internalUpdateCoalesceIncrements;
+
+/**
+ * Combines concurrent single-document $inc updates of the same document into one write.
+ *
+ * The first update of a document to arrive leads a batch. Updates of the same document that arrive
+ * while it runs queue behind it, and the next leader applies the sum of all their increments as a
+ * single update, which produces a single oplog entry. Integer addition is commutative and
+ * associative, so the document ends up as it would have had the updates run one after another,
+ * and each update in a combined batch is told it matched and modified the document if the
+ * combined update matched it. Every delta is non-zero, so each update alone would have modified it.
+ */
+class UpdateCoalescer {
+    MONGO_DISALLOW_COPYING(UpdateCoalescer);
+
+public:
+    /**
+     * An update that may be combined with others: the document it targets and its $inc object.
+     */
+    struct Update {
+        std::string key;
+        BSONObj increments;
+    };
+
+    /**
+     * What applying a batch did, passed on to every update in it.
+     */
+    struct Outcome {
+        long long nMatched = 0;
+        long long nModified = 0;
+
+        // The optime of the combined write, or null if it did not write an oplog entry.
+        repl::OpTime opTime;
+    };
+
+    using ApplyFn = stdx::function<Outcome(const BSONObj& update)>;
+
+    // The most updates combined into one write.
+    static constexpr size_t kMaxBatchSize = 512;
+
+    UpdateCoalescer() = default;
+
+    static UpdateCoalescer* get(ServiceContext* service);
+
+    /**
+     * Returns the coalescable form of 'op', or boost::none if it is not eligible: it must be a
+     * non-multi, non-upsert update without arrayFilters or collation, whose query is exactly an
+     * equality on a scalar _id and whose update is only $inc by non-zero 32 or 64-bit integers.
+     */
+    static boost::optional<Update> parse(const NamespaceString& ns,
+                                         const write_ops::UpdateOpEntry& op);
+
+    /**
+     * Returns the update document that applies every one of 'increments' at once. Fails if a sum
+     * overflows a 64-bit integer. A field whose deltas are all 32-bit integers gets a 32-bit sum
+     * when it fits.
+     */
+    static StatusWith<BSONObj> combine(const std::vector<BSONObj>& increments);
+
+    /**
+     * Applies 'update' together with any concurrent updates of the same document, calling 'apply'
+     * with the combined update if this thread leads the batch. Exceptions from 'apply' for a batch
+     * of one are rethrown. Returns boost::none if the update must be applied alone instead, which
+     * happens when its batch could not be combined or the combined write failed.
+     */
+    boost::optional<Outcome> run(const Update& update, const ApplyFn& apply);
+
+    /**
+     * Returns how many updates are queued behind the batch being applied to the document 'key'.
+     */
+    size_t numQueued(StringData key);
+
+private:
+    struct Waiter {
+        explicit Waiter(BSONObj increments) : increments(std::move(increments)) {}
+
+        const BSONObj increments;
+        bool leader = false;
+        bool done = false;
+        boost::optional<Outcome> outcome;
+        stdx::condition_variable cv;
+    };
+
+    /**
+     * Updates of one document waiting to be applied. A slot exists while some thread leads it.
+     */
+    struct Slot {
+        std::deque<Waiter*> queue;
+    };
+
+    stdx::mutex _mutex;
+    StringMap<Slot> _slots;
+};
+
+}  // namespace mongo
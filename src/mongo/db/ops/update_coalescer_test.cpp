@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ops/update_coalescer.h"
+
+#include "mongo/db/json.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+
+write_ops::UpdateOpEntry buildUpdate(const BSONObj& query, const BSONObj& update) {
+    write_ops::UpdateOpEntry entry;
+    entry.setQ(query);
+    entry.setU(update);
+    return entry;
+}
+
+UpdateCoalescer::Update parseUpdate(const BSONObj& query, const BSONObj& update) {
+    auto parsed = UpdateCoalescer::parse(kNss, buildUpdate(query, update));
+    ASSERT(parsed);
+    return *parsed;
+}
+
+TEST(UpdateCoalescerTest, ParseAcceptsIntegerIncrementsById) {
+    auto update = parseUpdate(BSON("_id" << 1), fromjson("{$inc: {a: 1, 'b.c': -2}}"));
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1, 'b.c': -2}"), update.increments);
+
+    // The key tells documents apart by _id and namespace.
+    ASSERT_EQ(update.key, parseUpdate(BSON("_id" << 1), fromjson("{$inc: {x: 1}}")).key);
+    ASSERT_NE(update.key, parseUpdate(BSON("_id" << 2), fromjson("{$inc: {a: 1}}")).key);
+    ASSERT_NE(update.key, parseUpdate(BSON("_id" << 1LL), fromjson("{$inc: {a: 1}}")).key);
+    ASSERT_NE(update.key,
+              UpdateCoalescer::parse(NamespaceString("test.other"),
+                                     buildUpdate(BSON("_id" << 1), fromjson("{$inc: {a: 1}}")))
+                  ->key);
+}
+
+TEST(UpdateCoalescerTest, ParseRejectsIneligibleUpdates) {
+    auto rejects = [](const write_ops::UpdateOpEntry& op) {
+        return !UpdateCoalescer::parse(kNss, op);
+    };
+    const auto inc = fromjson("{$inc: {a: 1}}");
+
+    ASSERT(rejects(buildUpdate(BSON("_id" << 1 << "x" << 1), inc)));
+    ASSERT(rejects(buildUpdate(BSON("x" << 1), inc)));
+    ASSERT(rejects(buildUpdate(fromjson("{_id: {$gt: 1}}"), inc)));
+    ASSERT(rejects(buildUpdate(fromjson("{_id: [1]}"), inc)));
+    ASSERT(rejects(buildUpdate(BSON("_id" << 1), fromjson("{$inc: {a: 1.5}}"))));
+    ASSERT(rejects(buildUpdate(BSON("_id" << 1), fromjson("{$inc: {a: 0}}"))));
+    ASSERT(rejects(buildUpdate(BSON("_id" << 1), fromjson("{$inc: {'a.$': 1}}"))));
+    ASSERT(rejects(buildUpdate(BSON("_id" << 1), fromjson("{$inc: {}}"))));
+    ASSERT(rejects(buildUpdate(BSON("_id" << 1), fromjson("{$inc: {a: 1}, $set: {b: 1}}"))));
+    ASSERT(rejects(buildUpdate(BSON("_id" << 1), fromjson("{$max: {a: 1}}"))));
+    ASSERT(rejects(buildUpdate(BSON("_id" << 1), fromjson("{a: 1}"))));
+
+    auto upsert = buildUpdate(BSON("_id" << 1), inc);
+    upsert.setUpsert(true);
+    ASSERT(rejects(upsert));
+
+    auto collation = buildUpdate(BSON("_id" << 1), inc);
+    collation.setCollation(BSON("locale"
+                                << "fr"));
+    ASSERT(rejects(collation));
+}
+
+TEST(UpdateCoalescerTest, CombineSumsIncrementsOfEachField) {
+    auto combined = UpdateCoalescer::combine(
+        {fromjson("{a: 1, b: 2}"), BSON("a" << 3LL), fromjson("{b: -2, c: 2147483647}"),
+         BSON("c" << 1)});
+    ASSERT_OK(combined.getStatus());
+
+    // Sums of 32-bit deltas stay 32-bit unless they no longer fit.
+    ASSERT_BSONOBJ_EQ(BSON("$inc" << BSON("a" << 4LL << "b" << 0 << "c" << 2147483648LL)),
+                      combined.getValue());
+    ASSERT_EQ(NumberInt, combined.getValue()["$inc"]["b"].type());
+}
+
+TEST(UpdateCoalescerTest, CombineFailsOnOverflow) {
+    auto combined = UpdateCoalescer::combine(
+        {BSON("a" << std::numeric_limits<long long>::max()), BSON("a" << 1)});
+    ASSERT_EQ(ErrorCodes::Overflow, combined.getStatus());
+}
+
+TEST(UpdateCoalescerTest, UncontendedUpdateAppliesItsOwnIncrements) {
+    UpdateCoalescer coalescer;
+    auto update = parseUpdate(BSON("_id" << 1), fromjson("{$inc: {a: 1}}"));
+
+    BSONObj applied;
+    auto outcome = coalescer.run(update, [&](const BSONObj& combinedUpdate) {
+        applied = combinedUpdate.getOwned();
+        UpdateCoalescer::Outcome outcome;
+        outcome.nMatched = 1;
+        outcome.nModified = 1;
+        return outcome;
+    });
+    ASSERT(outcome);
+    ASSERT_BSONOBJ_EQ(fromjson("{$inc: {a: 1}}"), applied);
+    ASSERT_EQ(1, outcome->nModified);
+    ASSERT_EQ(0U, coalescer.numQueued(update.key));
+
+    // Errors applying a lone update reach its caller.
+    ASSERT_THROWS_CODE(coalescer.run(update,
+                                     [](const BSONObj&) -> UpdateCoalescer::Outcome {
+                                         uasserted(ErrorCodes::TypeMismatch, "not a number");
+                                     }),
+                       AssertionException,
+                       ErrorCodes::TypeMismatch);
+}
+
+TEST(UpdateCoalescerTest, UpdatesQueuedBehindALeaderAreAppliedAsOneWrite) {
+    UpdateCoalescer coalescer;
+    auto first = parseUpdate(BSON("_id" << 1), fromjson("{$inc: {x: 1}}"));
+    auto second = parseUpdate(BSON("_id" << 1), fromjson("{$inc: {x: 2}}"));
+    auto third = parseUpdate(BSON("_id" << 1), BSON("$inc" << BSON("x" << -2 << "y" << 5LL)));
+
+    std::vector<BSONObj> applied;
+    stdx::mutex appliedMutex;
+    auto apply = [&](const BSONObj& combinedUpdate) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(appliedMutex);
+            applied.push_back(combinedUpdate.getOwned());
+        }
+        UpdateCoalescer::Outcome outcome;
+        outcome.nMatched = 1;
+        return outcome;
+    };
+
+    // The first update holds its batch open until the other two have queued behind it.
+    AtomicBool leading(false);
+    boost::optional<UpdateCoalescer::Outcome> firstOutcome;
+    stdx::thread leader([&] {
+        firstOutcome = coalescer.run(first, [&](const BSONObj& combinedUpdate) {
+            leading.store(true);
+            while (coalescer.numQueued(first.key) < 2) {
+                sleepmillis(1);
+            }
+            return apply(combinedUpdate);
+        });
+    });
+    while (!leading.load()) {
+        sleepmillis(1);
+    }
+
+    boost::optional<UpdateCoalescer::Outcome> secondOutcome;
+    boost::optional<UpdateCoalescer::Outcome> thirdOutcome;
+    stdx::thread secondThread([&] { secondOutcome = coalescer.run(second, apply); });
+    stdx::thread thirdThread([&] { thirdOutcome = coalescer.run(third, apply); });
+    leader.join();
+    secondThread.join();
+    thirdThread.join();
+
+    ASSERT_EQ(2U, applied.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{$inc: {x: 1}}"), applied[0]);
+    ASSERT_BSONOBJ_EQ(BSON("$inc" << BSON("x" << 0 << "y" << 5LL)), applied[1]);
+
+    // The second batch's deltas of 'x' cancel out, but each of its updates modified the document.
+    ASSERT(firstOutcome && secondOutcome && thirdOutcome);
+    ASSERT_EQ(1, secondOutcome->nMatched);
+    ASSERT_EQ(1, secondOutcome->nModified);
+    ASSERT_EQ(1, thirdOutcome->nModified);
+    ASSERT_EQ(0U, coalescer.numQueued(first.key));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <map>
 #include <memory>
 
 #include "mongo/base/checked_cast.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/ops/parsed_delete.h"
 #include "mongo/db/ops/parsed_update.h"
+#include "mongo/db/ops/update_coalescer.h"
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/ops/write_ops_exec.h"
@@ -63,11 +65,15 @@
 #include "mongo/db/retryable_writes_stats.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/implicit_create_collection.h"
+#include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/s/shard_filtering_metadata_refresh.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/timeseries_options.h"
+#include "mongo/db/views/view.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/cannot_implicitly_create_collection_info.h"
@@ -75,6 +81,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -369,21 +376,30 @@ void insertDocuments(OperationContext* opCtx,
 
 /**
  * Returns true if caller should try to insert more documents. Does nothing else if batch is empty.
+ *
+ * Sets 'hitWriteConflict' if inserting documents together failed with a write conflict, so that
+ * the caller can make its batches smaller.
+ *
+ * The batch is inserted under 'heldCollection', which the caller may have already acquired in
+ * MODE_IX for the namespace and must reset once this returns.
  */
 bool insertBatchAndHandleErrors(OperationContext* opCtx,
                                 const write_ops::Insert& wholeOp,
                                 std::vector<InsertStatement>& batch,
+                                boost::optional<AutoGetCollection>* heldCollection,
                                 LastOpFixer* lastOpFixer,
-                                WriteResult* out) {
+                                WriteResult* out,
+                                bool* hitWriteConflict) {
     if (batch.empty())
         return true;
 
     auto& curOp = *CurOp::get(opCtx);
 
-    boost::optional<AutoGetCollection> collection;
+    auto& collection = *heldCollection;
     auto acquireCollection = [&] {
         while (true) {
             if (MONGO_FAIL_POINT(hangDuringBatchInsert)) {
+                collection.reset();  // Don't block with the lock held.
                 log() << "batch insert - hangDuringBatchInsert fail point enabled. Blocking until "
                          "fail point is disabled.";
                 MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangDuringBatchInsert);
@@ -393,7 +409,8 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
                 uasserted(ErrorCodes::InternalError, "failAllInserts failpoint active!");
             }
 
-            collection.emplace(opCtx, wholeOp.getNamespace(), MODE_IX);
+            if (!collection)
+                collection.emplace(opCtx, wholeOp.getNamespace(), MODE_IX);
             if (collection->getCollection())
                 break;
 
@@ -405,38 +422,45 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
         assertCanWrite_inlock(opCtx, wholeOp.getNamespace());
     };
 
-    try {
-        acquireCollection();
-        if (!collection->getCollection()->isCapped() && batch.size() > 1) {
-            // First try doing it all together. If all goes well, this is all we need to do.
-            // See Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
+    // Inserts the documents in [begin, end) together in one WriteUnitOfWork. Returns false, having
+    // inserted nothing, if that fails for any reason.
+    using Iterator = std::vector<InsertStatement>::iterator;
+    auto tryInsertTogether = [&](Iterator begin, Iterator end) {
+        try {
+            if (!collection)
+                acquireCollection();
             lastOpFixer->startingOp();
-            insertDocuments(opCtx, collection->getCollection(), batch.begin(), batch.end());
+            insertDocuments(opCtx, collection->getCollection(), begin, end);
             lastOpFixer->finishedOpSuccessfully();
-            globalOpCounters.gotInserts(batch.size());
+            const auto count = std::distance(begin, end);
+            globalOpCounters.gotInserts(count);
             SingleWriteResult result;
             result.setN(1);
 
-            std::fill_n(std::back_inserter(out->results), batch.size(), std::move(result));
-            curOp.debug().ninserted += batch.size();
+            std::fill_n(std::back_inserter(out->results), count, std::move(result));
+            curOp.debug().ninserted += count;
             return true;
-        }
-    } catch (const DBException&) {
+        } catch (const DBException& ex) {
+            // If we cannot abandon the current snapshot, we give up and rethrow the exception.
+            // No WCE retrying is attempted.  This code path is intended for snapshot read concern.
+            if (opCtx->lockState()->inAWriteUnitOfWork()) {
+                throw;
+            }
 
-        // If we cannot abandon the current snapshot, we give up and rethrow the exception.
-        // No WCE retrying is attempted.  This code path is intended for snapshot read concern.
-        if (opCtx->lockState()->inAWriteUnitOfWork()) {
-            throw;
-        }
+            if (ex.code() == ErrorCodes::WriteConflict) {
+                *hitWriteConflict = true;
+            }
 
-        // Otherwise, ignore this failure and behave as-if we never tried to do the combined batch
-        // insert.  The loop below will handle reporting any non-transient errors.
-        collection.reset();
-    }
+            // Otherwise, ignore this failure and behave as-if we never tried to insert these
+            // documents together. Inserting them one-at-a-time reports any non-transient errors.
+            collection.reset();
+            return false;
+        }
+    };
 
-    // Try to insert the batch one-at-a-time. This path is executed both for singular batches, and
-    // for batches that failed all-at-once inserting.
-    for (auto it = batch.begin(); it != batch.end(); ++it) {
+    // Inserts the document at 'it' on its own, retrying write conflicts and reporting any other
+    // error. Returns false if the caller should stop inserting.
+    auto insertOne = [&](Iterator it) {
         globalOpCounters.gotInsert();
         try {
             writeConflictRetry(opCtx, "insert", wholeOp.getNamespace().ns(), [&] {
@@ -461,9 +485,48 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
                 }
             });
         } catch (const DBException& ex) {
-            bool canContinue =
-                handleError(opCtx, ex, wholeOp.getNamespace(), wholeOp.getWriteCommandBase(), out);
-            if (!canContinue)
+            return handleError(
+                opCtx, ex, wholeOp.getNamespace(), wholeOp.getWriteCommandBase(), out);
+        }
+        return true;
+    };
+
+    // See Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
+    bool canInsertTogether = false;
+    try {
+        acquireCollection();
+        canInsertTogether = !collection->getCollection()->isCapped();
+    } catch (const DBException&) {
+        if (opCtx->lockState()->inAWriteUnitOfWork()) {
+            throw;
+        }
+        // Inserting the documents one-at-a-time below will report the error.
+        collection.reset();
+    }
+
+    // First try inserting the whole batch together. If that fails, split the range that failed in
+    // half and try each half together, in order, down to single documents. A batch with one bad
+    // document is then inserted in about 2 * log2(batch size) transactions rather than one per
+    // document, and everything before the bad document is still inserted first, as an ordered
+    // insert requires. 'ranges' is a stack whose top is the next range in document order.
+    std::vector<std::pair<Iterator, Iterator>> ranges;
+    ranges.emplace_back(batch.begin(), batch.end());
+    while (!ranges.empty()) {
+        const auto range = ranges.back();
+        ranges.pop_back();
+
+        const auto count = std::distance(range.first, range.second);
+        if (canInsertTogether && count > 1) {
+            if (!tryInsertTogether(range.first, range.second)) {
+                const auto middle = range.first + count / 2;
+                ranges.emplace_back(middle, range.second);
+                ranges.emplace_back(range.first, middle);
+            }
+            continue;
+        }
+
+        for (auto it = range.first; it != range.second; ++it) {
+            if (!insertOne(it))
                 return false;
         }
     }
@@ -486,6 +549,224 @@ SingleWriteResult makeWriteResultForInsertOrDeleteRetry() {
 
 }  // namespace
 
+static SingleWriteResult applySingleUpdateOp(OperationContext* opCtx,
+                                             const NamespaceString& ns,
+                                             StmtId stmtId,
+                                             const write_ops::UpdateOpEntry& op);
+
+/**
+ * Returns the options of the time-series collection 'autoColl' was acquired for, or boost::none if
+ * it is not one.
+ */
+static boost::optional<timeseries::TimeseriesOptions> getTimeseriesOptions(
+    const AutoGetCollection& autoColl) {
+    auto view = autoColl.getView();
+    if (!view || !view->isTimeseries()) {
+        return boost::none;
+    }
+    return uassertStatusOK(
+        timeseries::TimeseriesOptions::parse(view->pipeline().front().firstElement().Obj()));
+}
+
+/**
+ * Checks that 'measurement' can be stored in a bucket of a time-series collection with 'options',
+ * and returns the placement the bucket catalog gives it.
+ */
+static BucketCatalog::Placement placeMeasurement(OperationContext* opCtx,
+                                                 const NamespaceString& bucketsNss,
+                                                 const timeseries::TimeseriesOptions& options,
+                                                 const BSONObj& measurement,
+                                                 BSONObj* meta) {
+    for (auto&& field : measurement) {
+        const auto fieldName = field.fieldNameStringData();
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "measurements of a time-series collection can't have empty or "
+                                 "dotted field names: '"
+                              << fieldName
+                              << "'",
+                !fieldName.empty() && fieldName.find('.') == std::string::npos);
+    }
+
+    const auto time = measurement[options.timeField];
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "'" << options.timeField
+                          << "' must be present and contain a valid BSON UTC datetime value",
+            time.type() == BSONType::Date);
+
+    *meta = BSONObj();
+    if (options.metaField) {
+        if (auto metaValue = measurement[*options.metaField]) {
+            BSONObjBuilder metaBuilder;
+            metaBuilder.appendAs(metaValue, timeseries::kBucketMetaFieldName);
+            *meta = metaBuilder.obj();
+        }
+    }
+    return BucketCatalog::get(opCtx).insert(bucketsNss, *meta, time.date());
+}
+
+/**
+ * The measurements of a batch that go into one bucket, as the update which adds them to it.
+ */
+struct BucketWrite {
+    BSONObj meta;
+    BSONObjBuilder data;
+    StringMap<BSONElement> min;
+    StringMap<BSONElement> max;
+
+    // The indexes of the measurements within the batch.
+    std::vector<size_t> measurements;
+
+    void add(const BSONObj& measurement, int index) {
+        for (auto&& field : measurement) {
+            const auto fieldName = field.fieldNameStringData();
+            data.appendAs(field,
+                          str::stream() << timeseries::kBucketDataFieldName << '.' << fieldName
+                                        << '.'
+                                        << index);
+
+            auto& fieldMin = min[fieldName];
+            if (fieldMin.eoo() || field.woCompare(fieldMin, false) < 0) {
+                fieldMin = field;
+            }
+            auto& fieldMax = max[fieldName];
+            if (fieldMax.eoo() || field.woCompare(fieldMax, false) > 0) {
+                fieldMax = field;
+            }
+        }
+    }
+
+    BSONObj makeUpdate() {
+        BSONObjBuilder update;
+        {
+            BSONObjBuilder set(update.subobjStart("$set"));
+            set.append(str::stream() << timeseries::kBucketControlFieldName << '.'
+                                     << timeseries::kBucketControlVersionFieldName,
+                       timeseries::kBucketControlVersion);
+            set.appendElements(meta);
+            set.appendElements(data.done());
+        }
+        for (auto&& bound : {std::make_pair(timeseries::kBucketControlMinFieldName, &min),
+                             std::make_pair(timeseries::kBucketControlMaxFieldName, &max)}) {
+            BSONObjBuilder boundBuilder(update.subobjStart(str::stream() << '$' << bound.first));
+            for (auto&& field : *bound.second) {
+                boundBuilder.appendAs(field.second,
+                                      str::stream() << timeseries::kBucketControlFieldName << '.'
+                                                    << bound.first
+                                                    << '.'
+                                                    << field.first);
+            }
+        }
+        return update.obj();
+    }
+};
+
+/**
+ * Inserts into the time-series collection 'wholeOp.getNamespace()' by adding each measurement to
+ * the bucket the bucket catalog places it in. The measurements of the batch that share a bucket
+ * are added to it with a single upsert.
+ *
+ * An ordered insert stops placing measurements at the first one which is invalid, but the writes
+ * to different buckets are independent: if one fails, the measurements of the batch placed in
+ * other buckets may still have been stored.
+ */
+static WriteResult performTimeseriesInserts(OperationContext* opCtx,
+                                            const write_ops::Insert& wholeOp,
+                                            const timeseries::TimeseriesOptions& options) {
+    uassert(ErrorCodes::InvalidOptions,
+            "Cannot insert into a time-series collection in a transaction or as a retryable write",
+            !opCtx->getTxnNumber());
+
+    const auto& docs = wholeOp.getDocuments();
+    const auto bucketsNss = wholeOp.getNamespace().makeTimeseriesBucketsNamespace();
+    LastOpFixer lastOpFixer(opCtx, bucketsNss);
+
+    std::vector<BSONObj> measurements(docs.size());
+    std::vector<Status> statuses(docs.size(), Status::OK());
+    std::map<OID, BucketWrite> bucketWrites;
+    size_t numAttempted = docs.size();
+    for (size_t i = 0; i < docs.size(); ++i) {
+        try {
+            auto fixedDoc =
+                uassertStatusOK(fixDocumentForInsert(opCtx->getServiceContext(), docs[i]));
+            measurements[i] = fixedDoc.isEmpty() ? docs[i] : std::move(fixedDoc);
+
+            BSONObj meta;
+            auto placement = placeMeasurement(opCtx, bucketsNss, options, measurements[i], &meta);
+            auto& bucketWrite = bucketWrites[placement.bucketId];
+            bucketWrite.meta = meta;
+            bucketWrite.add(measurements[i], placement.index);
+            bucketWrite.measurements.push_back(i);
+        } catch (const DBException& ex) {
+            statuses[i] = ex.toStatus();
+            if (wholeOp.getWriteCommandBase().getOrdered()) {
+                numAttempted = i + 1;
+                break;
+            }
+        }
+    }
+
+    for (auto&& bucketWrite : bucketWrites) {
+        write_ops::UpdateOpEntry op;
+        op.setQ(BSON("_id" << bucketWrite.first));
+        op.setU(bucketWrite.second.makeUpdate());
+        op.setUpsert(true);
+
+        globalOpCounters.gotUpdate();
+        auto& parentCurOp = *CurOp::get(opCtx);
+        const Command* cmd = parentCurOp.getCommand();
+        CurOp curOp(opCtx);
+        {
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            curOp.setCommand_inlock(cmd);
+            curOp.setNS_inlock(bucketsNss.ns());
+            curOp.setNetworkOp_inlock(dbUpdate);
+            curOp.setLogicalOp_inlock(LogicalOp::opUpdate);
+            curOp.setOpDescription_inlock(op.toBSON());
+            curOp.ensureStarted();
+        }
+        ON_BLOCK_EXIT([&] { finishCurOp(opCtx, &curOp); });
+
+        Status status = Status::OK();
+        try {
+            lastOpFixer.startingOp();
+            try {
+                applySingleUpdateOp(opCtx, bucketsNss, kUninitializedStmtId, op);
+            } catch (const ExceptionFor<ErrorCodes::DuplicateKey>&) {
+                // A concurrent insert created the bucket first, so it can now be updated.
+                applySingleUpdateOp(opCtx, bucketsNss, kUninitializedStmtId, op);
+            }
+            lastOpFixer.finishedOpSuccessfully();
+        } catch (const DBException& ex) {
+            if (ErrorCodes::isInterruption(ex.code())) {
+                throw;
+            }
+            status = ex.toStatus();
+        }
+        for (auto i : bucketWrite.second.measurements) {
+            statuses[i] = status;
+        }
+    }
+
+    WriteResult out;
+    out.results.reserve(numAttempted);
+    for (size_t i = 0; i < numAttempted; ++i) {
+        globalOpCounters.gotInsert();
+        const auto& status = statuses[i];
+        if (!status.isOK()) {
+            LastError::get(opCtx->getClient()).setLastError(status.code(), status.reason());
+            out.results.emplace_back(status);
+            if (wholeOp.getWriteCommandBase().getOrdered()) {
+                break;
+            }
+            continue;
+        }
+        SingleWriteResult result;
+        result.setN(1);
+        out.results.emplace_back(std::move(result));
+    }
+    return out;
+}
+
 WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& wholeOp) {
     // Insert performs its own retries, so we should only be within a WriteUnitOfWork when run under
     // snapshot read concern or in a transaction.
@@ -522,6 +803,19 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
         return performCreateIndexes(opCtx, wholeOp);
     }
 
+    // Check for a time-series collection under the lock the first batch is then inserted under,
+    // rather than locking the namespace an extra time.
+    boost::optional<AutoGetCollection> collection;
+    collection.emplace(opCtx, wholeOp.getNamespace(), MODE_IX, AutoGetCollection::kViewsPermitted);
+    if (auto timeseriesOptions = getTimeseriesOptions(*collection)) {
+        collection.reset();
+        return performTimeseriesInserts(opCtx, wholeOp, *timeseriesOptions);
+    }
+    if (collection->getView()) {
+        // Inserting into any other view fails when the batch acquires the collection.
+        collection.reset();
+    }
+
     DisableDocumentValidationIfTrue docValidationDisabler(
         opCtx, wholeOp.getWriteCommandBase().getBypassDocumentValidation());
     LastOpFixer lastOpFixer(opCtx, wholeOp.getNamespace());
@@ -535,7 +829,12 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
     size_t stmtIdIndex = 0;
     size_t bytesInBatch = 0;
     std::vector<InsertStatement> batch;
-    const size_t maxBatchSize = internalInsertMaxBatchSize.load();
+    // Batches start at internalInsertMaxBatchSize documents. They double each time a full batch
+    // goes in without a write conflict, up to internalInsertMaxAdaptiveBatchSize, and halve each
+    // time one conflicts.
+    size_t maxBatchSize = std::max(1, internalInsertMaxBatchSize.load());
+    const size_t maxAdaptiveBatchSize =
+        std::max<size_t>(maxBatchSize, internalInsertMaxAdaptiveBatchSize.load());
     batch.reserve(std::min(wholeOp.getDocuments().size(), maxBatchSize));
 
     for (auto&& doc : wholeOp.getDocuments()) {
@@ -566,7 +865,15 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
                 continue;  // Add more to batch before inserting.
         }
 
-        bool canContinue = insertBatchAndHandleErrors(opCtx, wholeOp, batch, &lastOpFixer, &out);
+        bool hitWriteConflict = false;
+        bool canContinue = insertBatchAndHandleErrors(
+            opCtx, wholeOp, batch, &collection, &lastOpFixer, &out, &hitWriteConflict);
+        collection.reset();  // Release the lock between batches.
+        if (hitWriteConflict) {
+            maxBatchSize = std::max<size_t>(1, maxBatchSize / 2);
+        } else if (batch.size() >= maxBatchSize) {
+            maxBatchSize = std::min(maxBatchSize * 2, maxAdaptiveBatchSize);
+        }
         batch.clear();  // We won't need the current batch any more.
         bytesInBatch = 0;
 
@@ -588,27 +895,11 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
     return out;
 }
 
-static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
-                                               const NamespaceString& ns,
-                                               StmtId stmtId,
-                                               const write_ops::UpdateOpEntry& op) {
-    auto session = OperationContextSession::get(opCtx);
-    uassert(ErrorCodes::InvalidOptions,
-            "Cannot use (or request) retryable writes with multi=true",
-            (session && session->inMultiDocumentTransaction()) || !opCtx->getTxnNumber() ||
-                !op.getMulti());
-
-    globalOpCounters.gotUpdate();
+static SingleWriteResult applySingleUpdateOp(OperationContext* opCtx,
+                                             const NamespaceString& ns,
+                                             StmtId stmtId,
+                                             const write_ops::UpdateOpEntry& op) {
     auto& curOp = *CurOp::get(opCtx);
-    {
-        stdx::lock_guard<Client> lk(*opCtx->getClient());
-        curOp.setNS_inlock(ns.ns());
-        curOp.setNetworkOp_inlock(dbUpdate);
-        curOp.setLogicalOp_inlock(LogicalOp::opUpdate);
-        curOp.setOpDescription_inlock(op.toBSON());
-        curOp.ensureStarted();
-    }
-
     UpdateLifecycleImpl updateLifecycle(ns);
     UpdateRequest request(ns);
     request.setLifecycle(&updateLifecycle);
@@ -691,6 +982,93 @@ static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
     return result;
 }
 
+/**
+ * Applies 'op' in one write together with concurrent increments of the same document, if the
+ * update and the operation running it allow that. Returns boost::none if 'op' must be applied
+ * alone.
+ */
+static boost::optional<SingleWriteResult> performCoalescedUpdateOp(
+    OperationContext* opCtx,
+    const NamespaceString& ns,
+    StmtId stmtId,
+    const write_ops::UpdateOpEntry& op) {
+    // The combined write runs on one operation's behalf, so every update in it must need the same
+    // checks. A caller holding locks could also block the leader of its batch.
+    if (!internalUpdateCoalesceIncrements.load() || opCtx->getTxnNumber() ||
+        opCtx->lockState()->isLocked() || documentValidationDisabled(opCtx) ||
+        OperationShardingState::get(opCtx).hasShardVersion() ||
+        repl::ReadConcernArgs::get(opCtx).getLevel() ==
+            repl::ReadConcernLevel::kSnapshotReadConcern) {
+        return boost::none;
+    }
+    auto update = UpdateCoalescer::parse(ns, op);
+    if (!update) {
+        return boost::none;
+    }
+
+    auto& replClientInfo = repl::ReplClientInfo::forClient(opCtx->getClient());
+    auto outcome = UpdateCoalescer::get(opCtx->getServiceContext())
+                       ->run(*update, [&](const BSONObj& combinedUpdate) {
+                           auto combinedOp = op;
+                           combinedOp.setU(combinedUpdate);
+                           const auto lastOpBefore = replClientInfo.getLastOp();
+                           auto result = applySingleUpdateOp(opCtx, ns, stmtId, combinedOp);
+
+                           UpdateCoalescer::Outcome outcome;
+                           outcome.nMatched = result.getN();
+                           outcome.nModified = result.getNModified();
+                           if (replClientInfo.getLastOp() != lastOpBefore) {
+                               outcome.opTime = replClientInfo.getLastOp();
+                           }
+                           return outcome;
+                       });
+    if (!outcome) {
+        return boost::none;
+    }
+
+    // Wait for the combined write's oplog entry when waiting for writeConcern.
+    if (outcome->opTime > replClientInfo.getLastOp()) {
+        replClientInfo.setLastOp(outcome->opTime);
+    }
+
+    auto& curOp = *CurOp::get(opCtx);
+    curOp.debug().nMatched = outcome->nMatched;
+    curOp.debug().nModified = outcome->nModified;
+    LastError::get(opCtx->getClient()).recordUpdate(true, outcome->nMatched, BSONObj());
+
+    SingleWriteResult result;
+    result.setN(outcome->nMatched);
+    result.setNModified(outcome->nModified);
+    return result;
+}
+
+static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
+                                               const NamespaceString& ns,
+                                               StmtId stmtId,
+                                               const write_ops::UpdateOpEntry& op) {
+    auto session = OperationContextSession::get(opCtx);
+    uassert(ErrorCodes::InvalidOptions,
+            "Cannot use (or request) retryable writes with multi=true",
+            (session && session->inMultiDocumentTransaction()) || !opCtx->getTxnNumber() ||
+                !op.getMulti());
+
+    globalOpCounters.gotUpdate();
+    auto& curOp = *CurOp::get(opCtx);
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        curOp.setNS_inlock(ns.ns());
+        curOp.setNetworkOp_inlock(dbUpdate);
+        curOp.setLogicalOp_inlock(LogicalOp::opUpdate);
+        curOp.setOpDescription_inlock(op.toBSON());
+        curOp.ensureStarted();
+    }
+
+    if (auto result = performCoalescedUpdateOp(opCtx, ns, stmtId, op)) {
+        return *result;
+    }
+    return applySingleUpdateOp(opCtx, ns, stmtId, op);
+}
+
 WriteResult performUpdates(OperationContext* opCtx, const write_ops::Update& wholeOp) {
     // Update performs its own retries, so we should not be in a WriteUnitOfWork unless run under
     // snapshot read concern or in a transaction.
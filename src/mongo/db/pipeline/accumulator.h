@@ -60,6 +60,13 @@ public:
         processInternal(input, merging);
     }
 
+    /** Process each of 'inputs' in order, with the same result as calling process() on each.
+     *  Accumulators with a cheaper way to consume a run of inputs override processBatchInternal().
+     */
+    void processBatch(const std::vector<Value>& inputs, bool merging) {
+        processBatchInternal(inputs, merging);
+    }
+
     /** Marks the end of the evaluate() phase and return accumulated result.
      *  toBeMerged should be true when the outputs will be merged by process().
      */
@@ -89,6 +96,13 @@ protected:
     /// Update subclass's internal state based on input
     virtual void processInternal(const Value& input, bool merging) = 0;
 
+    /// Update subclass's internal state based on each of 'inputs' in turn
+    virtual void processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+        for (auto&& input : inputs) {
+            processInternal(input, merging);
+        }
+    }
+
     const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
         return _expCtx;
     }
@@ -166,6 +180,7 @@ public:
     explicit AccumulatorSum(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs, bool merging) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
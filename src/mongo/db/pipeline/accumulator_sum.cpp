@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/util/summation.h"
 
 namespace mongo {
@@ -84,6 +85,52 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorSum::processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+    if (merging) {
+        Accumulator::processBatchInternal(inputs, merging);
+        return;
+    }
+
+    // As long as only integers have been summed, the total is exact, so adding up a run of
+    // integers natively and adding the result to the total gives the same total as adding them
+    // one at a time. The native sum is folded in whenever it would overflow, or before any other
+    // type of input.
+    long long runTotal = 0;
+    for (auto&& input : inputs) {
+        const auto type = input.getType();
+        if ((type == NumberInt || type == NumberLong) &&
+            (totalType == NumberInt || totalType == NumberLong)) {
+            const long long value = input.coerceToLong();
+            long long sum;
+            if (mongoSignedAddOverflow64(runTotal, value, &sum)) {
+                nonDecimalTotal.addLong(runTotal);
+                sum = value;
+            }
+            runTotal = sum;
+            if (type == NumberLong) {
+                totalType = NumberLong;
+            }
+            continue;
+        }
+
+        if (runTotal != 0) {
+            nonDecimalTotal.addLong(runTotal);
+            runTotal = 0;
+        }
+
+        if (type == NumberDouble) {
+            totalType = Value::getWidestNumeric(totalType, NumberDouble);
+            nonDecimalTotal.addDouble(input.getDouble());
+        } else {
+            processInternal(input, false);
+        }
+    }
+
+    if (runTotal != 0) {
+        nonDecimalTotal.addLong(runTotal);
+    }
+}
+
 intrusive_ptr<Accumulator> AccumulatorSum::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorSum(expCtx);
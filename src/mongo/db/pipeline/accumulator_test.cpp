@@ -66,6 +66,15 @@ static void assertExpectedResults(
                 ASSERT_EQUALS(op.second.getType(), result.getType());
             }
 
+            // Asserts that result equals expected result when the input is processed as a batch.
+            {
+                boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
+                accum->processBatch(op.first, false);
+                Value result = accum->getValue(false);
+                ASSERT_VALUE_EQ(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
+
             // Asserts that result equals expected result when all input is on one shard.
             {
                 boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
@@ -59,6 +59,7 @@ constexpr StringData AggregationRequest::kExplainName;
 constexpr StringData AggregationRequest::kAllowDiskUseName;
 constexpr StringData AggregationRequest::kHintName;
 constexpr StringData AggregationRequest::kCommentName;
+constexpr StringData AggregationRequest::kExchangeName;
 
 constexpr long long AggregationRequest::kDefaultBatchSize;
 
@@ -202,6 +203,14 @@ StatusWith<AggregationRequest> AggregationRequest::parseFromBSON(
 
             hasNeedsMergeElem = true;
             request.setNeedsMerge(elem.Bool());
+        } else if (kExchangeName == fieldName) {
+            if (elem.type() != BSONType::Object) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << kExchangeName << " must be an object, not a "
+                                      << typeName(elem.type())};
+            }
+
+            request.setExchangeSpec(elem.embeddedObject());
         } else if (kAllowDiskUseName == fieldName) {
             if (storageGlobalParams.readOnly) {
                 return {ErrorCodes::IllegalOperation,
@@ -256,6 +265,13 @@ StatusWith<AggregationRequest> AggregationRequest::parseFromBSON(
                               << "'"};
     }
 
+    if (!request.getExchangeSpec().isEmpty() && !request.needsMerge()) {
+        return {ErrorCodes::FailedToParse,
+                str::stream() << "Cannot specify '" << kExchangeName << "' without '"
+                              << kNeedsMergeName
+                              << "'"};
+    }
+
     return request;
 }
 
@@ -294,6 +310,8 @@ Document AggregationRequest::serializeToCommandObj() const {
         {kAllowDiskUseName, _allowDiskUse ? Value(true) : Value()},
         {kFromMongosName, _fromMongos ? Value(true) : Value()},
         {kNeedsMergeName, _needsMerge ? Value(true) : Value()},
+        // Only serialize an exchange if one was specified.
+        {kExchangeName, _exchangeSpec.isEmpty() ? Value() : Value(_exchangeSpec)},
         {bypassDocumentValidationCommandOption(),
          _bypassDocumentValidation ? Value(true) : Value()},
         // Only serialize a collation if one was specified.
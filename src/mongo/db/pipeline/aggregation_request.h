@@ -58,6 +58,7 @@ public:
     static constexpr StringData kAllowDiskUseName = "allowDiskUse"_sd;
     static constexpr StringData kHintName = "hint"_sd;
     static constexpr StringData kCommentName = "comment"_sd;
+    static constexpr StringData kExchangeName = "exchange"_sd;
 
     static constexpr long long kDefaultBatchSize = 101;
 
@@ -170,6 +171,14 @@ public:
         return _comment;
     }
 
+    /**
+     * Returns the unparsed exchange specification sent by mongos, or an empty object if the
+     * results should be returned on a single cursor.
+     */
+    const BSONObj& getExchangeSpec() const {
+        return _exchangeSpec;
+    }
+
     boost::optional<ExplainOptions::Verbosity> getExplain() const {
         return _explainMode;
     }
@@ -210,6 +219,10 @@ public:
         _comment = comment;
     }
 
+    void setExchangeSpec(BSONObj exchangeSpec) {
+        _exchangeSpec = exchangeSpec.getOwned();
+    }
+
     void setExplain(boost::optional<ExplainOptions::Verbosity> verbosity) {
         _explainMode = verbosity;
     }
@@ -265,6 +278,10 @@ private:
     // The comment parameter attached to this aggregation, empty if not set.
     std::string _comment;
 
+    // If non-empty, asks the shards part of a split pipeline to partition its output across
+    // several cursors by hash of a key, rather than returning it on a single cursor.
+    BSONObj _exchangeSpec;
+
     BSONObj _readConcern;
 
     // The unwrapped readPreference object, if one was given to us by the mongos command processor.
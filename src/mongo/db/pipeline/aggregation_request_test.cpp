@@ -351,6 +351,34 @@ TEST(AggregationRequestTest, ShouldRejectNeedsMergeIfFromMongosNotPresent) {
     ASSERT_NOT_OK(AggregationRequest::parseFromBSON(nss, inputBson).getStatus());
 }
 
+TEST(AggregationRequestTest, ShouldRejectNonObjectExchange) {
+    NamespaceString nss("a.collection");
+    const BSONObj inputBson = fromjson(
+        "{pipeline: [{$match: {a: 'abc'}}], cursor: {}, needsMerge: true, fromMongos: true, "
+        "exchange: 1}");
+    ASSERT_NOT_OK(AggregationRequest::parseFromBSON(nss, inputBson).getStatus());
+}
+
+TEST(AggregationRequestTest, ShouldRejectExchangeIfNeedsMergeNotPresent) {
+    NamespaceString nss("a.collection");
+    const BSONObj inputBson = fromjson(
+        "{pipeline: [{$match: {a: 'abc'}}], cursor: {}, fromMongos: true, "
+        "exchange: {key: {_id: 1}, consumers: 2}}");
+    ASSERT_NOT_OK(AggregationRequest::parseFromBSON(nss, inputBson).getStatus());
+}
+
+TEST(AggregationRequestTest, ShouldSerializeExchange) {
+    NamespaceString nss("a.collection");
+    const BSONObj inputBson = fromjson(
+        "{pipeline: [{$match: {a: 'abc'}}], cursor: {}, needsMerge: true, fromMongos: true, "
+        "exchange: {key: {_id: 1}, consumers: 2}}");
+    auto request = unittest::assertGet(AggregationRequest::parseFromBSON(nss, inputBson));
+    ASSERT_BSONOBJ_EQ(request.getExchangeSpec(), fromjson("{key: {_id: 1}, consumers: 2}"));
+    ASSERT_BSONOBJ_EQ(
+        request.serializeToCommandObj().toBson()[AggregationRequest::kExchangeName].Obj(),
+        request.getExchangeSpec());
+}
+
 TEST(AggregationRequestTest, ShouldRejectNonBoolNeedsMerge34) {
     NamespaceString nss("a.collection");
     const BSONObj inputBson =
@@ -30,9 +30,13 @@
 
 #include "mongo/db/pipeline/cluster_aggregation_planner.h"
 
+#include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_lookup.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_project.h"
+#include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 
@@ -52,11 +56,12 @@ void findSplitPoint(Pipeline* shardPipe, Pipeline* mergePipe) {
     while (!mergePipe->getSources().empty()) {
         boost::intrusive_ptr<DocumentSource> current = mergePipe->popFront();
 
-        // Check if this source is splittable.
+        // Check if this source is splittable. A shard-local $lookup runs entirely on the shards.
         NeedsMergerDocumentSource* splittable =
             dynamic_cast<NeedsMergerDocumentSource*>(current.get());
+        auto lookup = dynamic_cast<DocumentSourceLookUp*>(current.get());
 
-        if (!splittable) {
+        if (!splittable || (lookup && lookup->isShardLocal())) {
             // Move the source from the merger _sources to the shard _sources.
             shardPipe->pushBack(current);
         } else {
@@ -82,6 +87,39 @@ void findSplitPoint(Pipeline* shardPipe, Pipeline* mergePipe) {
     }
 }
 
+/**
+ * Returns true if 'stage' passes on the value at 'path' of every document unchanged, and under the
+ * same name.
+ */
+bool preservesPath(const DocumentSource& stage, const std::string& path) {
+    auto overlaps = [&](const std::string& other) {
+        return other == path || expression::isPathPrefixOf(other, path) ||
+            expression::isPathPrefixOf(path, other);
+    };
+
+    auto modifiedPaths = stage.getModifiedPaths();
+    for (auto&& rename : modifiedPaths.renames) {
+        if (overlaps(rename.first)) {
+            return false;
+        }
+    }
+    switch (modifiedPaths.type) {
+        case DocumentSource::GetModPathsReturn::Type::kNotSupported:
+        case DocumentSource::GetModPathsReturn::Type::kAllPaths:
+            return false;
+        case DocumentSource::GetModPathsReturn::Type::kFiniteSet:
+            return std::none_of(modifiedPaths.paths.begin(), modifiedPaths.paths.end(), overlaps);
+        case DocumentSource::GetModPathsReturn::Type::kAllExcept:
+            return std::any_of(
+                modifiedPaths.paths.begin(),
+                modifiedPaths.paths.end(),
+                [&](const std::string& preserved) {
+                    return preserved == path || expression::isPathPrefixOf(preserved, path);
+                });
+    }
+    MONGO_UNREACHABLE;
+}
+
 /**
  * If the final stage on shards is to unwind an array, move that stage to the merger. This cuts down
  * on network traffic and allows us to take advantage of reduced copying in unwind.
@@ -136,6 +174,43 @@ void limitFieldsSentFromShardsToMerger(Pipeline* shardPipe, Pipeline* mergePipe)
 }
 }  // namespace
 
+std::set<NamespaceString> markShardLocalLookups(Pipeline* pipeline,
+                                                const IsColocatedFn& isColocated) {
+    std::set<NamespaceString> shardLocalNamespaces;
+    if (pipeline->getContext()->getCollator()) {
+        // Shard key ranges order strings by their binary value, so values which are equal under a
+        // collation may be owned by different shards.
+        return shardLocalNamespaces;
+    }
+
+    // Only stages before the split point run on the shards. Each local field must still hold the
+    // shard key value the document was placed by, so it may not have been modified on the way.
+    std::vector<const DocumentSource*> precedingStages;
+    for (auto&& stage : pipeline->getSources()) {
+        auto lookup = dynamic_cast<DocumentSourceLookUp*>(stage.get());
+        if (lookup && !lookup->wasConstructedWithPipelineSyntax()) {
+            const auto& localField = lookup->getLocalField().fullPath();
+            const bool localFieldIsUnmodified =
+                std::all_of(precedingStages.begin(), precedingStages.end(), [&](auto preceding) {
+                    return preservesPath(*preceding, localField);
+                });
+            if (localFieldIsUnmodified &&
+                isColocated(
+                    lookup->getFromNs(), lookup->getLocalField(), lookup->getForeignField())) {
+                lookup->setShardLocal();
+                shardLocalNamespaces.insert(lookup->getFromNs());
+            }
+        }
+
+        if (dynamic_cast<NeedsMergerDocumentSource*>(stage.get()) &&
+            !(lookup && lookup->isShardLocal())) {
+            break;
+        }
+        precedingStages.push_back(stage.get());
+    }
+    return shardLocalNamespaces;
+}
+
 void performSplitPipelineOptimizations(Pipeline* shardPipeline, Pipeline* mergingPipeline) {
     // The order in which optimizations are applied can have significant impact on the
     // efficiency of the final pipeline. Be Careful!
@@ -164,6 +239,29 @@ boost::optional<BSONObj> popLeadingMergeSort(Pipeline* pipeline) {
     return boost::none;
 }
 
+boost::optional<BSONObj> getExchangeKey(const Pipeline* mergePipeline) {
+    const auto& sources = mergePipeline->getSources();
+    if (sources.empty()) {
+        return boost::none;
+    }
+
+    auto group = dynamic_cast<DocumentSourceGroup*>(sources.front().get());
+    if (!group || !group->doingMerge()) {
+        return boost::none;
+    }
+
+    for (auto it = std::next(sources.begin()); it != sources.end(); ++it) {
+        auto stage = it->get();
+        if (!dynamic_cast<DocumentSourceMatch*>(stage) &&
+            !dynamic_cast<DocumentSourceSingleDocumentTransformation*>(stage) &&
+            !dynamic_cast<DocumentSourceUnwind*>(stage)) {
+            return boost::none;
+        }
+    }
+
+    return BSON("_id" << 1);
+}
+
 void addMergeCursorsSource(Pipeline* mergePipeline,
                            std::vector<RemoteCursor> remoteCursors,
                            executor::TaskExecutor* executor) {
@@ -28,11 +28,34 @@
 
 #pragma once
 
+#include <set>
+
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 namespace cluster_aggregation_planner {
 
+/**
+ * Called with the 'from' namespace, local field and foreign field of a $lookup to decide whether
+ * its two collections are co-located on the joined fields, so that every document can only join
+ * with documents on its own shard.
+ */
+using IsColocatedFn = stdx::function<bool(
+    const NamespaceString& fromNss, const FieldPath& localField, const FieldPath& foreignField)>;
+
+/**
+ * Marks each localField/foreignField $lookup in 'pipeline' which can run on the shards, each shard
+ * joining its own documents with its own part of a sharded 'from' collection. This is the case
+ * when the $lookup would otherwise begin the merging half of the pipeline, the local field reaches
+ * it unmodified, the pipeline uses the simple collation, and 'isColocated' accepts the join.
+ * Returns the 'from' namespaces of the marked $lookups.
+ */
+std::set<NamespaceString> markShardLocalLookups(Pipeline* pipeline,
+                                                const IsColocatedFn& isColocated);
+
 /**
  * Performs optimizations with the aim of reducing computing time and network traffic when a
  * pipeline has been split into two pieces. Modifies 'shardPipeline' and 'mergingPipeline' such that
@@ -46,6 +69,15 @@ void performSplitPipelineOptimizations(Pipeline* shardPipeline, Pipeline* mergin
  */
 boost::optional<BSONObj> popLeadingMergeSort(Pipeline* mergePipeline);
 
+/**
+ * Returns the key by which the output of the shards part of a split pipeline may be partitioned
+ * across several merging shards, or boost::none if 'mergePipeline' cannot be run independently on
+ * each partition with the results simply concatenated. This is the case when the merging half
+ * begins with a $group, which merges the shards' partial groups by _id, and is followed only by
+ * stages which act on each document in isolation.
+ */
+boost::optional<BSONObj> getExchangeKey(const Pipeline* mergePipeline);
+
 /**
  * Creates a new DocumentSourceMergeCursors from the provided 'remoteCursors' and adds it to the
  * front of 'mergePipeline'.
@@ -206,10 +206,28 @@ void DocumentSource::serializeToArray(vector<Value>& array,
                                       boost::optional<ExplainOptions::Verbosity> explain) const {
     Value entry = serialize(explain);
     if (!entry.missing()) {
-        array.push_back(entry);
+        array.push_back(addMemoryStatsForExplain(std::move(entry), explain));
     }
 }
 
+Value DocumentSource::addMemoryStatsForExplain(
+    Value entry, boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (!explain || *explain < ExplainOptions::Verbosity::kExecStats ||
+        entry.getType() != BSONType::Object) {
+        return entry;
+    }
+
+    auto memoryStats = getMemoryStats();
+    if (!memoryStats) {
+        return entry;
+    }
+
+    MutableDocument withStats(entry.getDocument());
+    withStats["peakMemUsage"] = Value(memoryStats->peakMemUsage);
+    withStats["spills"] = Value(memoryStats->spills);
+    return withStats.freezeToValue();
+}
+
 BSONObjSet DocumentSource::allPrefixes(BSONObj obj) {
     BSONObjSet out = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
 
@@ -53,6 +53,7 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/explain_options.h"
+#include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/intrusive_counter.h"
 
@@ -481,6 +482,14 @@ public:
         std::vector<Value>& array,
         boost::optional<ExplainOptions::Verbosity> explain = boost::none) const;
 
+    /**
+     * Returns the memory statistics of this stage if it buffers data, such as $group or $sort, or
+     * boost::none otherwise. Reported by explain with execution stats and in the slow query log.
+     */
+    virtual boost::optional<StageMemoryStats> getMemoryStats() const {
+        return boost::none;
+    }
+
     /**
      * If DocumentSource uses additional collections, it adds the namespaces to the input vector.
      */
@@ -675,6 +684,13 @@ protected:
      */
     virtual void doDispose() {}
 
+    /**
+     * Returns 'entry', the serialization of this stage, with the stage's memory statistics added
+     * if 'explain' asks for execution stats and the stage buffers data.
+     */
+    Value addMemoryStatsForExplain(Value entry,
+                                   boost::optional<ExplainOptions::Verbosity> explain) const;
+
     /*
       Most DocumentSources have an underlying source they get their data
       from.  This is a convenience for them.
@@ -72,12 +72,26 @@ intrusive_ptr<DocumentSource> DocumentSourceCollStats::createFromBson(
                                       << typeName(elem.type()),
                         elem["histograms"].isBoolean());
             }
+            if (!elem["percentiles"].eoo()) {
+                uassert(50866,
+                        str::stream() << "percentiles option to latencyStats must be bool, got "
+                                      << elem
+                                      << "of type "
+                                      << typeName(elem.type()),
+                        elem["percentiles"].isBoolean());
+            }
         } else if ("storageStats" == fieldName) {
             uassert(40279,
                     str::stream() << "storageStats argument must be an object, but got " << elem
                                   << " of type "
                                   << typeName(elem.type()),
                     elem.type() == BSONType::Object);
+        } else if ("cacheStats" == fieldName) {
+            uassert(50858,
+                    str::stream() << "cacheStats argument must be an object, but got " << elem
+                                  << " of type "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::Object);
         } else if ("count" == fieldName) {
             uassert(40480,
                     str::stream() << "count argument must be an object, but got " << elem
@@ -118,11 +132,13 @@ DocumentSource::GetNextResult DocumentSourceCollStats::getNext() {
     if (_collStatsSpec.hasField("latencyStats")) {
         // If the latencyStats field exists, it must have been validated as an object when parsing.
         bool includeHistograms = false;
+        bool includePercentiles = false;
         if (_collStatsSpec["latencyStats"].type() == BSONType::Object) {
             includeHistograms = _collStatsSpec["latencyStats"]["histograms"].boolean();
+            includePercentiles = _collStatsSpec["latencyStats"]["percentiles"].boolean();
         }
         pExpCtx->mongoProcessInterface->appendLatencyStats(
-            pExpCtx->opCtx, pExpCtx->ns, includeHistograms, &builder);
+            pExpCtx->opCtx, pExpCtx->ns, includeHistograms, includePercentiles, &builder);
     }
 
     if (_collStatsSpec.hasField("storageStats")) {
@@ -138,6 +154,19 @@ DocumentSource::GetNextResult DocumentSourceCollStats::getNext() {
         }
     }
 
+    if (_collStatsSpec.hasField("cacheStats")) {
+        // If the cacheStats field exists, it must have been validated as an object when parsing.
+        BSONObjBuilder cacheBuilder(builder.subobjStart("cacheStats"));
+        Status status = pExpCtx->mongoProcessInterface->appendCacheStats(
+            pExpCtx->opCtx, pExpCtx->ns, &cacheBuilder);
+        cacheBuilder.doneFast();
+        if (!status.isOK()) {
+            uasserted(50859,
+                      str::stream() << "Unable to retrieve cacheStats in $collStats stage: "
+                                    << status.reason());
+        }
+    }
+
     if (_collStatsSpec.hasField("count")) {
         Status status = pExpCtx->mongoProcessInterface->appendRecordCount(
             pExpCtx->opCtx, pExpCtx->ns, &builder);
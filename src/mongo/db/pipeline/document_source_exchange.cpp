@@ -0,0 +1,255 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_exchange.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr StringData ExchangeSpec::kKeyFieldName;
+constexpr StringData ExchangeSpec::kConsumersFieldName;
+constexpr StringData DocumentSourceExchange::kStageName;
+
+ExchangeSpec ExchangeSpec::parse(const BSONObj& spec) {
+    ExchangeSpec exchangeSpec;
+    for (auto&& elem : spec) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kKeyFieldName) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "exchange '" << kKeyFieldName
+                                  << "' must be an object, but found: "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::Object);
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "exchange '" << kKeyFieldName << "' must not be empty",
+                    !elem.Obj().isEmpty());
+            for (auto&& keyElem : elem.Obj()) {
+                // Validates the path.
+                FieldPath(keyElem.fieldName());
+            }
+            exchangeSpec.key = elem.Obj().getOwned();
+        } else if (fieldName == kConsumersFieldName) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "exchange '" << kConsumersFieldName
+                                  << "' must be a number, but found: "
+                                  << typeName(elem.type()),
+                    elem.isNumber());
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "exchange '" << kConsumersFieldName
+                                  << "' must be positive, but found: "
+                                  << elem.numberLong(),
+                    elem.numberLong() > 0);
+            exchangeSpec.consumers = elem.numberLong();
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "unrecognized exchange option: " << fieldName);
+        }
+    }
+
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << "exchange requires both '" << kKeyFieldName << "' and '"
+                          << kConsumersFieldName
+                          << "'",
+            !exchangeSpec.key.isEmpty() && exchangeSpec.consumers > 0);
+    return exchangeSpec;
+}
+
+BSONObj ExchangeSpec::toBSON() const {
+    return BSON(kKeyFieldName << key << kConsumersFieldName << static_cast<long long>(consumers));
+}
+
+Exchange::Exchange(ExchangeSpec spec, std::unique_ptr<Pipeline, PipelineDeleter> pipeline)
+    : _spec(std::move(spec)), _pipeline(std::move(pipeline)), _buffers(_spec.consumers) {
+    // The pipeline is run on the OperationContexts of its consumers in turn, so it stays detached
+    // between loads, and disposal is left to whichever consumer is the last to go away.
+    _pipeline.get_deleter().dismissDisposal();
+    _pipeline->detachFromOperationContext();
+
+    for (auto&& keyElem : _spec.key) {
+        _keyPaths.emplace_back(keyElem.fieldName());
+    }
+}
+
+DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx, size_t consumerId) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    invariant(consumerId < _buffers.size());
+    auto& buffer = _buffers[consumerId];
+
+    while (true) {
+        if (!buffer.docs.empty()) {
+            Document next = std::move(buffer.docs.front());
+            buffer.docs.pop_front();
+            buffer.bytes -= next.getApproximateSize();
+
+            // A loader may be waiting for this buffer to drain.
+            _cv.notify_all();
+            return std::move(next);
+        }
+
+        uassertStatusOK(_error);
+        if (_eof) {
+            return DocumentSource::GetNextResult::makeEOF();
+        }
+
+        if (_loading) {
+            opCtx->waitForConditionOrInterrupt(_cv, lk);
+        } else {
+            _loadBatch(opCtx, lk, consumerId);
+        }
+    }
+}
+
+void Exchange::_loadBatch(OperationContext* opCtx,
+                          stdx::unique_lock<stdx::mutex>& lk,
+                          size_t consumerId) {
+    invariant(!_loading);
+    _loading = true;
+    lk.unlock();
+
+    _pipeline->reattachToOperationContext(opCtx);
+    ON_BLOCK_EXIT([&] {
+        _pipeline->detachFromOperationContext();
+        if (!lk.owns_lock()) {
+            lk.lock();
+        }
+        _loading = false;
+        _cv.notify_all();
+    });
+
+    const size_t maxBufferedBytes = internalQueryExchangeMaxBufferedBytesPerConsumer.load();
+    try {
+        while (true) {
+            auto next = _pipeline->getNext();
+
+            lk.lock();
+            if (!next) {
+                _eof = true;
+                return;
+            }
+
+            const auto target = _getTargetConsumer(*next);
+            auto& buffer = _buffers[target];
+            if (target != consumerId) {
+                opCtx->waitForConditionOrInterrupt(_cv, lk, [&] {
+                    return buffer.disposed || buffer.bytes < maxBufferedBytes;
+                });
+            }
+
+            if (!buffer.disposed) {
+                buffer.bytes += next->getApproximateSize();
+                buffer.docs.push_back(std::move(*next));
+                _cv.notify_all();
+            }
+
+            if (target == consumerId) {
+                return;
+            }
+            lk.unlock();
+        }
+    } catch (const DBException& ex) {
+        // This consumer cannot tell which of its results reached the others, so the exchange as a
+        // whole fails rather than let any consumer report a partial set of results.
+        if (!lk.owns_lock()) {
+            lk.lock();
+        }
+        _error = ex.toStatus();
+        throw;
+    }
+}
+
+size_t Exchange::_getTargetConsumer(const Document& doc) const {
+    const auto& comparator = _pipeline->getContext()->getValueComparator();
+
+    size_t hash;
+    if (_keyPaths.size() == 1) {
+        hash = comparator.hash(doc.getNestedField(_keyPaths.front()));
+    } else {
+        std::vector<Value> keyValues;
+        keyValues.reserve(_keyPaths.size());
+        for (auto&& path : _keyPaths) {
+            keyValues.push_back(doc.getNestedField(path));
+        }
+        hash = comparator.hash(Value(std::move(keyValues)));
+    }
+    return hash % _buffers.size();
+}
+
+void Exchange::dispose(OperationContext* opCtx, size_t consumerId) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(consumerId < _buffers.size());
+    auto& buffer = _buffers[consumerId];
+    if (buffer.disposed) {
+        return;
+    }
+
+    buffer.disposed = true;
+    buffer.docs.clear();
+    buffer.bytes = 0;
+    _cv.notify_all();
+
+    if (++_numDisposed == _buffers.size()) {
+        // A consumer cannot be disposed while it is loading, so nobody is using the pipeline.
+        invariant(!_loading);
+        _pipeline->dispose(opCtx);
+    }
+}
+
+boost::intrusive_ptr<DocumentSourceExchange> DocumentSourceExchange::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Exchange> exchange,
+    size_t consumerId) {
+    return new DocumentSourceExchange(expCtx, std::move(exchange), consumerId);
+}
+
+DocumentSourceExchange::DocumentSourceExchange(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Exchange> exchange,
+    size_t consumerId)
+    : DocumentSource(expCtx), _exchange(std::move(exchange)), _consumerId(consumerId) {}
+
+DocumentSource::GetNextResult DocumentSourceExchange::getNext() {
+    pExpCtx->checkForInterrupt();
+    return _exchange->getNext(pExpCtx->opCtx, _consumerId);
+}
+
+Value DocumentSourceExchange::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(DOC(getSourceName() << DOC("consumerId" << static_cast<long long>(_consumerId)
+                                                        << "spec"
+                                                        << _exchange->getSpec().toBSON())));
+}
+
+void DocumentSourceExchange::doDispose() {
+    _exchange->dispose(pExpCtx->opCtx, _consumerId);
+}
+
+}  // namespace mongo
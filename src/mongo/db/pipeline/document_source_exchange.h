@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/intrusive_counter.h"
+
+namespace mongo {
+
+/**
+ * The parsed form of the 'exchange' option of an aggregate command sent by mongos to a shard, of
+ * the form {key: {<path>: 1, ...}, consumers: <N>}. It instructs the shard to redistribute the
+ * output of its pipeline across N cursors by hash of the values at 'key'.
+ */
+struct ExchangeSpec {
+    static constexpr StringData kKeyFieldName = "key"_sd;
+    static constexpr StringData kConsumersFieldName = "consumers"_sd;
+
+    /**
+     * Parses an exchange specification, throwing a user assertion if it is malformed.
+     */
+    static ExchangeSpec parse(const BSONObj& spec);
+
+    BSONObj toBSON() const;
+
+    BSONObj key;
+    size_t consumers = 0;
+};
+
+/**
+ * Runs a single pipeline on behalf of several consumers, routing each result to exactly one of
+ * them by hash of the exchange key. Documents whose keys compare equal under the pipeline's
+ * collation always go to the same consumer, so a downstream $group which merges each consumer's
+ * stream independently sees every partial group for a given key.
+ *
+ * There is no dedicated producer thread. Whichever consumer finds its own buffer empty becomes the
+ * loader: it pulls from the pipeline on its own OperationContext, hands out documents destined for
+ * other consumers, and returns as soon as it has produced one for itself. A loader that meets a
+ * full buffer waits for its owner to drain it, which bounds the memory held on behalf of slow
+ * consumers.
+ */
+class Exchange : public RefCountable {
+public:
+    Exchange(ExchangeSpec spec, std::unique_ptr<Pipeline, PipelineDeleter> pipeline);
+
+    /**
+     * Returns the next document for 'consumerId', or EOF once the pipeline is exhausted and the
+     * consumer's buffer is empty. Blocks while another consumer is loading.
+     */
+    DocumentSource::GetNextResult getNext(OperationContext* opCtx, size_t consumerId);
+
+    /**
+     * Releases the buffer of 'consumerId'. Documents subsequently routed to it are discarded.
+     * The pipeline is disposed along with the last consumer.
+     */
+    void dispose(OperationContext* opCtx, size_t consumerId);
+
+    const ExchangeSpec& getSpec() const {
+        return _spec;
+    }
+
+private:
+    struct ConsumerBuffer {
+        std::deque<Document> docs;
+        size_t bytes = 0;
+        bool disposed = false;
+    };
+
+    size_t _getTargetConsumer(const Document& doc) const;
+
+    /**
+     * Pulls from '_pipeline' until a document for 'consumerId' is produced or the pipeline is
+     * exhausted. Must be called with 'lk' held; the lock is released while the pipeline runs.
+     */
+    void _loadBatch(OperationContext* opCtx, stdx::unique_lock<stdx::mutex>& lk, size_t consumerId);
+
+    const ExchangeSpec _spec;
+    std::vector<FieldPath> _keyPaths;
+    std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
+
+    stdx::mutex _mutex;
+
+    // Signalled whenever a buffer gains or loses documents, a consumer is disposed, or a loader
+    // finishes.
+    stdx::condition_variable _cv;
+
+    std::vector<ConsumerBuffer> _buffers;
+    size_t _numDisposed = 0;
+    bool _loading = false;
+    bool _eof = false;
+
+    // Set if the pipeline throws while loading, and reported to every consumer thereafter.
+    Status _error = Status::OK();
+};
+
+/**
+ * The source stage of each consumer pipeline fed by an Exchange. This stage is never parsed from a
+ * user request; it is constructed by the aggregate command when mongos asks for an exchange.
+ */
+class DocumentSourceExchange final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$exchange"_sd;
+
+    static boost::intrusive_ptr<DocumentSourceExchange> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        boost::intrusive_ptr<Exchange> exchange,
+        size_t consumerId);
+
+    GetNextResult getNext() final;
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+protected:
+    void doDispose() final;
+
+private:
+    DocumentSourceExchange(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                           boost::intrusive_ptr<Exchange> exchange,
+                           size_t consumerId);
+
+    boost::intrusive_ptr<Exchange> _exchange;
+    const size_t _consumerId;
+};
+
+}  // namespace mongo
@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+#include <set>
+
+#include "mongo/db/client.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+using DocumentSourceExchangeTest = AggregationContextFixture;
+
+/**
+ * Returns a mock source producing 'numDocs' documents of the form {_id: <i>, k: <i % numKeys>}.
+ */
+boost::intrusive_ptr<DocumentSourceMock> makeMockSource(int numDocs, int numKeys) {
+    std::deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < numDocs; ++i) {
+        docs.push_back(Document{{"_id", i}, {"k", i % numKeys}});
+    }
+    return DocumentSourceMock::create(std::move(docs));
+}
+
+boost::intrusive_ptr<Exchange> makeExchange(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                            boost::intrusive_ptr<DocumentSourceMock> source,
+                                            size_t consumers) {
+    // The exchange detaches its pipeline from the OperationContext, so give the pipeline its own
+    // ExpressionContext to leave the test's intact.
+    auto pipeline = uassertStatusOK(Pipeline::create({source}, expCtx->copyWith(expCtx->ns)));
+    return new Exchange(ExchangeSpec::parse(BSON("key" << BSON("k" << 1) << "consumers"
+                                                       << static_cast<long long>(consumers))),
+                        std::move(pipeline));
+}
+
+std::vector<Document> drain(OperationContext* opCtx, Exchange* exchange, size_t consumerId) {
+    std::vector<Document> results;
+    for (auto next = exchange->getNext(opCtx, consumerId); !next.isEOF();
+         next = exchange->getNext(opCtx, consumerId)) {
+        results.push_back(next.releaseDocument());
+    }
+    return results;
+}
+
+TEST_F(DocumentSourceExchangeTest, ShouldRejectMalformedSpecs) {
+    ASSERT_THROWS_CODE(
+        ExchangeSpec::parse(BSON("consumers" << 2)), AssertionException, ErrorCodes::FailedToParse);
+    ASSERT_THROWS_CODE(ExchangeSpec::parse(BSON("key" << BSON("k" << 1))),
+                       AssertionException,
+                       ErrorCodes::FailedToParse);
+    ASSERT_THROWS_CODE(ExchangeSpec::parse(BSON("key" << 1 << "consumers" << 2)),
+                       AssertionException,
+                       ErrorCodes::TypeMismatch);
+    ASSERT_THROWS_CODE(ExchangeSpec::parse(BSON("key" << BSONObj() << "consumers" << 2)),
+                       AssertionException,
+                       ErrorCodes::BadValue);
+    ASSERT_THROWS_CODE(ExchangeSpec::parse(BSON("key" << BSON("k" << 1) << "consumers" << 0)),
+                       AssertionException,
+                       ErrorCodes::BadValue);
+    ASSERT_THROWS_CODE(
+        ExchangeSpec::parse(BSON("key" << BSON("k" << 1) << "consumers" << 2 << "foo" << 1)),
+        AssertionException,
+        ErrorCodes::FailedToParse);
+}
+
+TEST_F(DocumentSourceExchangeTest, SpecShouldRoundTrip) {
+    auto spec = BSON("key" << BSON("a.b" << 1 << "c" << 1) << "consumers" << 4LL);
+    ASSERT_BSONOBJ_EQ(spec, ExchangeSpec::parse(spec).toBSON());
+}
+
+TEST_F(DocumentSourceExchangeTest, ShouldRouteEachKeyToExactlyOneConsumer) {
+    const size_t kConsumers = 3;
+    auto exchange = makeExchange(getExpCtx(), makeMockSource(100, 10), kConsumers);
+
+    auto opCtx = getExpCtx()->opCtx;
+    std::set<int> seenIds;
+    std::map<int, size_t> consumerForKey;
+    for (size_t consumerId = 0; consumerId < kConsumers; ++consumerId) {
+        for (auto&& doc : drain(opCtx, exchange.get(), consumerId)) {
+            ASSERT_TRUE(seenIds.insert(doc["_id"].getInt()).second);
+            auto inserted = consumerForKey.emplace(doc["k"].getInt(), consumerId);
+            ASSERT_EQ(inserted.first->second, consumerId);
+        }
+    }
+    ASSERT_EQ(100U, seenIds.size());
+    ASSERT_EQ(10U, consumerForKey.size());
+
+    for (size_t consumerId = 0; consumerId < kConsumers; ++consumerId) {
+        exchange->dispose(opCtx, consumerId);
+    }
+}
+
+TEST_F(DocumentSourceExchangeTest, ShouldDiscardResultsOfDisposedConsumers) {
+    auto opCtx = getExpCtx()->opCtx;
+
+    // Find out how many results consumer 0 receives when both consumers are active.
+    auto unaffectedExchange = makeExchange(getExpCtx(), makeMockSource(100, 10), 2);
+    auto expectedResults = drain(opCtx, unaffectedExchange.get(), 0);
+    unaffectedExchange->dispose(opCtx, 0);
+    unaffectedExchange->dispose(opCtx, 1);
+
+    auto source = makeMockSource(100, 10);
+    auto exchange = makeExchange(getExpCtx(), source, 2);
+    exchange->dispose(opCtx, 1);
+    ASSERT_FALSE(source->isDisposed);
+
+    // Consumer 0 is not handed the results meant for the disposed consumer.
+    auto results = drain(opCtx, exchange.get(), 0);
+    ASSERT_EQ(expectedResults.size(), results.size());
+
+    exchange->dispose(opCtx, 0);
+    ASSERT_TRUE(source->isDisposed);
+}
+
+TEST_F(DocumentSourceExchangeTest, ConsumerStageShouldDisposeItsConsumer) {
+    auto source = makeMockSource(10, 2);
+    auto exchange = makeExchange(getExpCtx(), source, 2);
+
+    auto first = DocumentSourceExchange::create(getExpCtx(), exchange, 0);
+    auto second = DocumentSourceExchange::create(getExpCtx(), exchange, 1);
+
+    first->dispose();
+    ASSERT_FALSE(source->isDisposed);
+    second->dispose();
+    ASSERT_TRUE(source->isDisposed);
+}
+
+TEST_F(DocumentSourceExchangeTest, ShouldWaitForSlowConsumersWhenBuffersAreFull) {
+    const auto originalMaxBufferedBytes = internalQueryExchangeMaxBufferedBytesPerConsumer.load();
+    internalQueryExchangeMaxBufferedBytesPerConsumer.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalQueryExchangeMaxBufferedBytesPerConsumer.store(originalMaxBufferedBytes);
+    });
+
+    const size_t kConsumers = 2;
+    auto exchange = makeExchange(getExpCtx(), makeMockSource(1000, 50), kConsumers);
+
+    // Drain one consumer on another thread. With buffers of a single byte, whichever consumer is
+    // loading has to wait for the other to take every document routed to it.
+    auto serviceContext = getExpCtx()->opCtx->getServiceContext();
+    std::vector<Document> otherResults;
+    stdx::thread otherConsumer([&] {
+        auto client = serviceContext->makeClient("exchangeConsumer");
+        auto opCtx = client->makeOperationContext();
+        otherResults = drain(opCtx.get(), exchange.get(), 1);
+        exchange->dispose(opCtx.get(), 1);
+    });
+
+    auto results = drain(getExpCtx()->opCtx, exchange.get(), 0);
+    otherConsumer.join();
+    exchange->dispose(getExpCtx()->opCtx, 0);
+
+    ASSERT_EQ(1000U, results.size() + otherResults.size());
+}
+
+}  // namespace
+}  // namespace mongo
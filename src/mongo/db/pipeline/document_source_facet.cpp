@@ -30,22 +30,33 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/matcher/expression.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
+#include "mongo/db/client.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -56,18 +67,46 @@ using std::string;
 using std::vector;
 
 DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelines,
-                                         const intrusive_ptr<ExpressionContext>& expCtx)
+                                         const intrusive_ptr<ExpressionContext>& expCtx,
+                                         int maxParallelism)
     : DocumentSource(expCtx),
       _teeBuffer(TeeBuffer::create(facetPipelines.size())),
-      _facets(std::move(facetPipelines)) {
+      _facets(std::move(facetPipelines)),
+      _maxParallelism(maxParallelism) {
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
+        // Sub-pipelines which may run concurrently must not share an ExpressionContext, so each
+        // consumer uses that of its own pipeline.
+        const auto& consumerExpCtx = _maxParallelism > 1 ? facet.pipeline->getContext() : pExpCtx;
         facet.pipeline->addInitialSource(
-            DocumentSourceTeeConsumer::create(pExpCtx, facetId, _teeBuffer));
+            DocumentSourceTeeConsumer::create(consumerExpCtx, facetId, _teeBuffer));
     }
 }
 
 namespace {
+/**
+ * Returns the pool of worker threads shared by all $facet stages. It is created on first use and
+ * intentionally never destroyed.
+ */
+ThreadPool* getFacetWorkerPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "FacetWorkers";
+        options.minThreads = 0;
+        options.maxThreads = std::max(1u, stdx::thread::hardware_concurrency());
+
+        // Ensure all threads have a client
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
 /**
  * Extracts the names of the facets and the vectors of raw BSONObjs representing the stages within
  * that facet's pipeline.
@@ -159,6 +198,11 @@ void DocumentSourceFacet::doDispose() {
         facet.pipeline.get_deleter().dismissDisposal();
         facet.pipeline->dispose(pExpCtx->opCtx);
     }
+
+    // When batches are loaded for the sub-pipelines, disposing of them leaves the buffer to us.
+    if (!_parallelFacets.empty()) {
+        _teeBuffer->releaseIfUnused();
+    }
 }
 
 DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
@@ -168,17 +212,24 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
         return GetNextResult::makeEOF();
     }
 
+    if (_maxParallelism > 1 && _parallelFacets.empty() && _serialFacets.empty()) {
+        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+            (canRunOnWorkerThread(facetId) ? _parallelFacets : _serialFacets).push_back(facetId);
+        }
+    }
+
     vector<vector<Value>> results(_facets.size());
     bool allPipelinesEOF = false;
     while (!allPipelinesEOF) {
+        if (!_parallelFacets.empty()) {
+            _teeBuffer->loadBatchForAll();
+            allPipelinesEOF = drainFacetsInParallel(&results);
+            continue;
+        }
+
         allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
         for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-            const auto& pipeline = _facets[facetId].pipeline;
-            auto next = pipeline->getSources().back()->getNext();
-            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
-                results[facetId].emplace_back(next.releaseDocument());
-            }
-            allPipelinesEOF = allPipelinesEOF && next.isEOF();
+            allPipelinesEOF = drainFacet(facetId, &results[facetId]) && allPipelinesEOF;
         }
     }
 
@@ -191,6 +242,136 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     return resultDoc.freeze();
 }
 
+bool DocumentSourceFacet::drainFacet(size_t facetId, std::vector<Value>* results) {
+    const auto& pipeline = _facets[facetId].pipeline;
+    auto next = pipeline->getSources().back()->getNext();
+    for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+        results->emplace_back(next.releaseDocument());
+    }
+    return next.isEOF();
+}
+
+namespace {
+
+/**
+ * Returns true if the tree rooted at 'expr' contains a $where, which runs JavaScript in the
+ * operation's scope, or an $expr.
+ */
+bool hasWhereOrExpr(const MatchExpression* expr) {
+    if (expr->matchType() == MatchExpression::WHERE ||
+        expr->matchType() == MatchExpression::EXPRESSION) {
+        return true;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (hasWhereOrExpr(expr->getChild(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+bool DocumentSourceFacet::canRunOnWorkerThread(size_t facetId) const {
+    // These stages neither access storage nor use the OperationContext or its Client, other than
+    // to check for interrupts.
+    static const std::set<StringData> kWorkerSafeStages = {"$addFields",
+                                                           "$bucketAuto",
+                                                           "$group",
+                                                           "$limit",
+                                                           "$match",
+                                                           "$project",
+                                                           "$redact",
+                                                           "$replaceRoot",
+                                                           "$skip",
+                                                           "$sort",
+                                                           "$unwind"};
+
+    const auto& pipeline = _facets[facetId].pipeline;
+    if (pipeline->getContext() == pExpCtx) {
+        return false;
+    }
+    const auto& sources = pipeline->getSources();
+    return std::all_of(sources.begin(), sources.end(), [](const auto& source) {
+        // A $where uses the operation's JavaScript scope, which only its own thread may use.
+        auto match = dynamic_cast<DocumentSourceMatch*>(source.get());
+        if (match && hasWhereOrExpr(match->getMatchExpression())) {
+            return false;
+        }
+        return dynamic_cast<DocumentSourceTeeConsumer*>(source.get()) ||
+            kWorkerSafeStages.count(source->getSourceName());
+    });
+}
+
+bool DocumentSourceFacet::drainFacetsInParallel(std::vector<std::vector<Value>>* results) {
+    // Each sub-pipeline is only touched by the thread draining it, so the results and EOF flags can
+    // be written without synchronization until the workers have finished.
+    std::vector<char> eof(_facets.size(), false);
+    AtomicUInt32 nextParallelFacet;
+    auto drainQueuedFacets = [&] {
+        for (size_t i = nextParallelFacet.fetchAndAdd(1); i < _parallelFacets.size();
+             i = nextParallelFacet.fetchAndAdd(1)) {
+            const auto facetId = _parallelFacets[i];
+            eof[facetId] = drainFacet(facetId, &(*results)[facetId]);
+        }
+    };
+
+    stdx::mutex mutex;
+    stdx::condition_variable workersDone;
+    size_t nWorkers = 0;
+    Status workerStatus = Status::OK();
+    auto runWorker = [&] {
+        Status status = Status::OK();
+        try {
+            drainQueuedFacets();
+        } catch (...) {
+            status = exceptionToStatus();
+        }
+
+        // Notify while holding the lock, since the waiting thread destroys these variables as soon
+        // as it is woken.
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (workerStatus.isOK()) {
+            workerStatus = std::move(status);
+        }
+        if (--nWorkers == 0) {
+            workersDone.notify_all();
+        }
+    };
+
+    // This thread also drains queued sub-pipelines, so we need one fewer worker than the number of
+    // sub-pipelines allowed to run at once.
+    const size_t nWorkersWanted =
+        std::min(_parallelFacets.size(), static_cast<size_t>(_maxParallelism - 1));
+    for (size_t i = 0; i < nWorkersWanted; ++i) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        ++nWorkers;
+        if (!getFacetWorkerPool()->schedule(runWorker).isOK()) {
+            --nWorkers;
+            break;
+        }
+    }
+
+    Status status = Status::OK();
+    try {
+        for (auto facetId : _serialFacets) {
+            eof[facetId] = drainFacet(facetId, &(*results)[facetId]);
+        }
+        drainQueuedFacets();
+    } catch (...) {
+        status = exceptionToStatus();
+    }
+
+    // The workers refer to this stage and to the variables above, so we must wait for them even if
+    // this thread failed.
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    workersDone.wait(lk, [&] { return nWorkers == 0; });
+    uassertStatusOK(status);
+    uassertStatusOK(workerStatus);
+
+    return std::all_of(eof.begin(), eof.end(), [](char facetEOF) { return facetEOF; });
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
@@ -296,11 +477,24 @@ intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
     boost::optional<std::string> needsMongoS;
     boost::optional<std::string> needsShard;
 
+    const int maxParallelism = internalQueryFacetMaxParallelism.load();
+
     std::vector<FacetPipeline> facetPipelines;
     for (auto&& rawFacet : extractRawPipelines(elem)) {
         const auto facetName = rawFacet.first;
 
-        auto pipeline = uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, expCtx));
+        // Sub-pipelines which may run concurrently each need their own ExpressionContext, since it
+        // holds state, such as the values of variables, which is modified during execution.
+        auto facetExpCtx = expCtx;
+        if (maxParallelism > 1) {
+            facetExpCtx = expCtx->copyWith(expCtx->ns, expCtx->uuid);
+            facetExpCtx->variables = expCtx->variables;
+            facetExpCtx->variablesParseState =
+                expCtx->variablesParseState.copyWith(facetExpCtx->variables.useIdGenerator());
+        }
+
+        auto pipeline =
+            uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, facetExpCtx));
 
         // Validate that none of the facet pipelines have any conflicting HostTypeRequirements. This
         // verifies both that all stages within each pipeline are consistent, and that the pipelines
@@ -321,6 +515,6 @@ intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
         facetPipelines.emplace_back(facetName, std::move(pipeline));
     }
 
-    return new DocumentSourceFacet(std::move(facetPipelines), expCtx);
+    return new DocumentSourceFacet(std::move(facetPipelines), expCtx, maxParallelism);
 }
 }  // namespace mongo
@@ -143,14 +143,46 @@ protected:
     void doDispose() final;
 
 private:
+    /**
+     * If 'maxParallelism' is greater than 1, up to that many of the sub-pipelines may run
+     * concurrently, in which case each one must have been parsed with its own ExpressionContext.
+     */
     DocumentSourceFacet(std::vector<FacetPipeline> facetPipelines,
-                        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+                        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                        int maxParallelism = 1);
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns true if every stage in the sub-pipeline at 'facetId' depends only on its input and
+     * its own ExpressionContext, and so may run on a worker thread.
+     */
+    bool canRunOnWorkerThread(size_t facetId) const;
+
+    /**
+     * Appends the results of the sub-pipeline at 'facetId' to 'results' until it pauses or is
+     * exhausted. Returns true if it is exhausted.
+     */
+    bool drainFacet(size_t facetId, std::vector<Value>* results);
+
+    /**
+     * Drains every sub-pipeline through the current batch of '_teeBuffer', running those which
+     * canRunOnWorkerThread() on a shared pool of worker threads and the rest on this thread.
+     * Returns true if all of them are exhausted.
+     */
+    bool drainFacetsInParallel(std::vector<std::vector<Value>>* results);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
+    const int _maxParallelism;
+
+    // The sub-pipelines which may run on worker threads, and those which must run on the thread
+    // executing this stage. Only used if '_maxParallelism' is greater than 1, and populated by the
+    // first call to getNext(), after the sub-pipelines have been optimized.
+    std::vector<size_t> _parallelFacets;
+    std::vector<size_t> _serialFacets;
+
     bool _done = false;
 };
 }  // namespace mongo
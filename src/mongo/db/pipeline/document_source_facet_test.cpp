@@ -43,8 +43,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -296,6 +298,53 @@ TEST_F(DocumentSourceFacetTest, MultipleFacetsShouldSeeTheSameDocuments) {
     ASSERT(facetStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceFacetTest, ShouldProduceSameResultsWhenRunningSubPipelinesInParallel) {
+    const int oldMaxParallelism = internalQueryFacetMaxParallelism.load();
+    const int oldBufferSizeBytes = internalQueryFacetBufferSizeBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryFacetMaxParallelism.store(oldMaxParallelism);
+        internalQueryFacetBufferSizeBytes.store(oldBufferSizeBytes);
+    });
+
+    // Give each input document its own batch, so the sub-pipelines run through several rounds.
+    internalQueryFacetBufferSizeBytes.store(1);
+
+    auto ctx = getExpCtx();
+    auto spec = fromjson(
+        "{$facet: {"
+        "  count: [{$group: {_id: null, n: {$sum: 1}}}],"
+        "  big: [{$match: {x: {$gt: 1}}}, {$project: {_id: 0, x: 1}}],"
+        "  first: [{$limit: 1}],"
+        "  rest: [{$skip: 2}, {$addFields: {y: {$let: {vars: {v: '$x'}, in: {$add: ['$$v', 1]}}}}}]"
+        "}}");
+
+    auto runFacet = [&](int maxParallelism) {
+        internalQueryFacetMaxParallelism.store(maxParallelism);
+        auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+        auto mock = DocumentSourceMock::create({Document{{"_id", 0}, {"x", 0}},
+                                                Document{{"_id", 1}, {"x", 1}},
+                                                Document{{"_id", 2}, {"x", 2}},
+                                                Document{{"_id", 3}, {"x", 3}}});
+        facetStage->setSource(mock.get());
+
+        auto output = facetStage->getNext();
+        ASSERT(output.isAdvanced());
+        ASSERT(facetStage->getNext().isEOF());
+        facetStage->dispose();
+        ASSERT(mock->isDisposed);
+        return output.releaseDocument();
+    };
+
+    const auto expected = runFacet(1);
+    ASSERT_DOCUMENT_EQ(expected,
+                       Document(fromjson("{count: [{_id: null, n: 4}],"
+                                         " big: [{x: 2}, {x: 3}],"
+                                         " first: [{_id: 0, x: 0}],"
+                                         " rest: [{_id: 2, x: 2, y: 3}, {_id: 3, x: 3, y: 4}]}")));
+    ASSERT_DOCUMENT_EQ(runFacet(2), expected);
+    ASSERT_DOCUMENT_EQ(runFacet(4), expected);
+}
+
 TEST_F(DocumentSourceFacetTest,
        ShouldCorrectlyHandleSubPipelinesYieldingDifferentNumbersOfResults) {
     auto ctx = getExpCtx();
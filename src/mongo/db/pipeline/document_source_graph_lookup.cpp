@@ -39,6 +39,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/stdx/memory.h"
 
@@ -104,11 +105,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (auto next = popVisited()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(std::move(*next)));
     }
 
     MutableDocument output(*_input);
@@ -127,7 +126,8 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        auto next = popVisited();
+        if (!next) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -140,10 +140,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
             performSearch();
             _visitedUsageBytes = 0;
             _outputIndex = 0;
+            next = popVisited();
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!next) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -157,23 +158,41 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(std::move(*next)));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
     }
 }
 
+boost::optional<Document> DocumentSourceGraphLookUp::popVisited() {
+    if (!_visited.empty()) {
+        auto it = _visited.begin();
+        Document result = std::move(it->second);
+        _visited.erase(it);
+        return result;
+    }
+
+    while (!_spilledVisited.empty()) {
+        auto& spilled = _spilledVisited.back();
+        if (spilled->more()) {
+            return spilled->next().second;
+        }
+        _spilledVisited.pop_back();
+    }
+    return boost::none;
+}
+
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    _spilledIds.clear();
+    _spilledVisited.clear();
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -233,7 +252,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() || _spilledIds.find(id) != _spilledIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -347,6 +366,10 @@ void DocumentSourceGraphLookUp::performSearch() {
     }
 
     doBreadthFirstSearch();
+
+    // The spilled '_id' values are only needed to de-duplicate during the search.
+    _spilledIds.clear();
+    _spilledIdsUsageBytes = 0;
 }
 
 DocumentSource::GetModPathsReturn DocumentSourceGraphLookUp::getModifiedPaths() const {
@@ -388,13 +411,43 @@ BSONObjSet DocumentSourceGraphLookUp::getOutputSorts() {
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if (_allowDiskUse && !_visited.empty() &&
+        (_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes) {
+        spill();
+    }
+
     uassert(40099,
-            "$graphLookup reached maximum memory consumption",
+            str::stream() << "$graphLookup reached maximum memory consumption"
+                          << (_allowDiskUse ? "" : ". Pass allowDiskUse:true to opt in."),
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spill() {
+    std::vector<const ValueUnorderedMap<Document>::value_type*> ptrs;
+    ptrs.reserve(_visited.size());
+    for (auto&& entry : _visited) {
+        ptrs.push_back(&entry);
+    }
+
+    // Spilled runs are written in key order, though they are read back in no particular order.
+    const auto& comparator = ValueComparator::kInstance;
+    std::sort(ptrs.begin(), ptrs.end(), [&comparator](const auto* lhs, const auto* rhs) {
+        return comparator.evaluate(lhs->first < rhs->first);
+    });
+
+    SortedFileWriter<Value, Document> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    for (auto&& entry : ptrs) {
+        writer.addAlreadySorted(entry->first, entry->second);
+        _spilledIds.insert(entry->first);
+        _spilledIdsUsageBytes += entry->first.getApproximateSize();
+    }
+    _spilledVisited.emplace_back(writer.done());
+
+    _visited.clear();
+    _visitedUsageBytes = _spilledIdsUsageBytes;
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -464,8 +517,11 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
+      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _spilledIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
@@ -602,3 +658,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
     return std::move(newSource);
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -57,7 +58,8 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     _allowDiskUse ? DiskUseRequirement::kWritesTmpData
+                                                   : DiskUseRequirement::kNoDiskUse,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed);
 
@@ -157,10 +159,24 @@ private:
 
     /**
      * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'. If disk use
+     * is allowed, '_visited' is spilled rather than exceeding the limit.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the documents in '_visited' to a file on disk and empties it. Only their '_id' values
+     * are kept in memory, in '_spilledIds', so that the search can still de-duplicate against them.
+     */
+    void spill();
+
+    /**
+     * Removes and returns one of the documents found by the most recent search, taking it from
+     * '_visited' if any remain there and from the spilled files otherwise. Returns boost::none
+     * once every document has been returned.
+     */
+    boost::optional<Document> popVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -186,7 +202,10 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    size_t _maxMemoryUsageBytes;
+
+    // Whether '_visited' may be spilled to disk when it would exceed '_maxMemoryUsageBytes'.
+    bool _allowDiskUse;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -200,6 +219,14 @@ private:
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // The '_id' values of the nodes discovered by the current search which have been spilled to
+    // disk, compared using the simple collation like the keys of '_visited'.
+    ValueUnorderedSet _spilledIds;
+    size_t _spilledIdsUsageBytes = 0;
+
+    // The spilled documents which have not yet been returned.
+    std::vector<std::shared_ptr<Sorter<Value, Document>::Iterator>> _spilledVisited;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
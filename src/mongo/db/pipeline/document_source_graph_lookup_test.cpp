@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <numeric>
 
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document.h"
@@ -37,9 +38,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -615,5 +619,115 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+/**
+ * Returns a $graphLookup over a chain of 'chainLength' documents, each connected to the next and
+ * each large enough that only a few of them fit within a 10KB memory limit.
+ */
+boost::intrusive_ptr<DocumentSourceGraphLookUp> makeLargeChainGraphLookup(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    int chainLength,
+    boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwind) {
+    const std::string largeStr(2 * 1024, 'x');
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (int i = 0; i < chainLength; ++i) {
+        fromContents.push_back(
+            Document{{"_id", i}, {"to", i}, {"from", i + 1}, {"largeStr", largeStr}});
+    }
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    return DocumentSourceGraphLookUp::create(expCtx,
+                                             fromNs,
+                                             "results",
+                                             "from",
+                                             "to",
+                                             ExpressionFieldPath::create(expCtx, "_id"),
+                                             boost::none,
+                                             boost::none,
+                                             boost::none,
+                                             unwind);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldErrorWhenExceedingMemoryLimitWithoutAllowDiskUse) {
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(10 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    auto expCtx = getExpCtx();
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}});
+    auto graphLookupStage = makeLargeChainGraphLookup(expCtx, 20, boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillToDiskWhenExceedingMemoryLimitWithAllowDiskUse) {
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(10 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const int chainLength = 20;
+    auto inputMock = DocumentSourceMock::create({Document{{"_id", 0}}, Document{{"_id", 10}}});
+    auto graphLookupStage = makeLargeChainGraphLookup(expCtx, chainLength, boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    // Each search should find every document from its starting point to the end of the chain
+    // exactly once, whether or not that document was spilled.
+    for (int start : {0, 10}) {
+        auto next = graphLookupStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+
+        auto resultsValue = next.getDocument().getField("results");
+        ASSERT(resultsValue.isArray());
+        std::vector<int> ids;
+        for (auto&& result : resultsValue.getArray()) {
+            ids.push_back(result.getDocument().getField("_id").getInt());
+        }
+        std::sort(ids.begin(), ids.end());
+
+        std::vector<int> expectedIds(chainLength - start);
+        std::iota(expectedIds.begin(), expectedIds.end(), start);
+        ASSERT(ids == expectedIds);
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldReturnSpilledDocumentsWhenUnwinding) {
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(10 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const int chainLength = 20;
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}});
+    auto unwindStage = DocumentSourceUnwind::create(expCtx, "results", false, boost::none);
+    auto graphLookupStage = makeLargeChainGraphLookup(expCtx, chainLength, unwindStage);
+    graphLookupStage->setSource(inputMock.get());
+
+    std::vector<int> ids;
+    for (auto next = graphLookupStage->getNext(); next.isAdvanced();
+         next = graphLookupStage->getNext()) {
+        ids.push_back(next.getDocument().getNestedField("results._id").getInt());
+    }
+    std::sort(ids.begin(), ids.end());
+
+    std::vector<int> expectedIds(chainLength);
+    std::iota(expectedIds.begin(), expectedIds.end(), 0);
+    ASSERT(ids == expectedIds);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -33,11 +33,13 @@
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -66,14 +68,19 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
         invariant(initializationResult.isEOF());
     }
 
+    if (_streaming && !_streamingInputExhausted) {
+        // The group being accumulated may span several calls if the input pauses.
+        return getNextStreaming();
+    }
+
     for (auto&& accum : _currentAccumulators) {
         accum->reset();  // Prep accumulators for a new group.
     }
 
-    if (_spilled) {
+    if (_partitioned) {
+        return getNextPartitioned();
+    } else if (_spilled) {
         return getNextSpilled();
-    } else if (_streaming) {
-        return getNextStreaming();
     } else {
         return getNextStandard();
     }
@@ -85,25 +92,18 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
         return GetNextResult::makeEOF();
 
     _currentId = _firstPartOfNextGroup.first;
-    const size_t numAccumulators = _accumulatedFields.size();
     while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
         // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
         // At loop exit, it is the first value to be processed in the next group.
-        switch (numAccumulators) {  // mirrors switch in spill()
-            case 1:                 // Single accumulators serialize as a single Value.
-                _currentAccumulators[0]->process(_firstPartOfNextGroup.second, true);
-            case 0:  // No accumulators so no Values.
-                break;
-            default: {  // Multiple accumulators serialize as an array of Values.
-                const vector<Value>& accumulatorStates = _firstPartOfNextGroup.second.getArray();
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    _currentAccumulators[i]->process(accumulatorStates[i], true);
-                }
-            }
-        }
+        mergeSpillState(_firstPartOfNextGroup.second, _currentAccumulators);
 
         if (!_sorterIterator->more()) {
-            dispose();
+            if (_partitioned) {
+                // Only this partition is done; getNextPartitioned() moves on to the next one.
+                _sorterIterator.reset();
+            } else {
+                dispose();
+            }
             break;
         }
 
@@ -126,53 +126,99 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     return std::move(out);
 }
 
-DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
-    // Streaming optimization is active.
-    if (!_firstDocOfNextGroup) {
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
-            return nextInput;
+DocumentSource::GetNextResult DocumentSourceGroup::getNextPartitioned() {
+    while (true) {
+        if (_sorterIterator) {
+            // The current partition did not fit in memory and was spilled as sorted runs.
+            return getNextSpilled();
         }
-        _firstDocOfNextGroup = nextInput.releaseDocument();
-    }
 
-    Value id;
-    do {
-        // Add to the current accumulator(s).
-        for (size_t i = 0; i < _currentAccumulators.size(); i++) {
-            _currentAccumulators[i]->process(
-                _accumulatedFields[i].expression->evaluate(*_firstDocOfNextGroup), _doingMerge);
+        if (groupsIterator != _groups->end()) {
+            Document out =
+                makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+            ++groupsIterator;
+            return std::move(out);
         }
 
-        // Retrieve the next document.
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
+        if (!loadNextPartition()) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
+    }
+}
+
+DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
+    // Streaming optimization is active. A group is returned as soon as the first document of the
+    // next group arrives, while documents with a group key that is not guaranteed to be consecutive
+    // in the input are set aside in the groups map, which is returned once the input is exhausted.
+    while (true) {
+        auto nextInput = getNextInput();
+        if (nextInput.isPaused()) {
             return nextInput;
         }
 
-        _firstDocOfNextGroup = nextInput.releaseDocument();
+        if (nextInput.isEOF()) {
+            _streamingInputExhausted = true;
+            boost::optional<Document> lastGroup;
+            if (_streamingGroupStarted) {
+                processQueuedInputs();
+                lastGroup = makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+                _streamingGroupStarted = false;
+            }
 
+            // The groups map may have spilled, in which case the merge needs a fresh set of
+            // accumulators.
+            _currentAccumulators.clear();
+            prepareToOutputGroups();
 
-        // Compute the id. If it does not match _currentId, we will exit the loop, leaving
-        // _firstDocOfNextGroup set for the next time getNext() is called.
-        id = computeId(*_firstDocOfNextGroup);
-    } while (pExpCtx->getValueComparator().evaluate(_currentId == id));
+            if (lastGroup) {
+                return std::move(*lastGroup);
+            }
+            return getNext();
+        }
 
-    Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
-    _currentId = std::move(id);
+        auto rootDocument = nextInput.releaseDocument();
+        Value id = computeId(rootDocument);
+        if (!canStreamId(id)) {
+            accumulateIntoGroups(rootDocument, id);
+            continue;
+        }
 
-    return std::move(out);
+        boost::optional<Document> out;
+        if (!_streamingGroupStarted) {
+            _currentId = std::move(id);
+            _streamingGroupStarted = true;
+        } else if (!pExpCtx->getValueComparator().evaluate(_currentId == id)) {
+            // 'rootDocument' starts the next group, so the current one is complete.
+            processQueuedInputs();
+            out = makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+            for (auto&& accum : _currentAccumulators) {
+                accum->reset();
+            }
+            _currentId = std::move(id);
+        }
+
+        queueForAccumulation(&_currentAccumulators, false, rootDocument);
+
+        if (out) {
+            return std::move(*out);
+        }
+    }
 }
 
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _partitionWriters.clear();
+    _queuedGroup = nullptr;
+    _queuedInputs.clear();
+    _trackedMemory.set(0);
 
     // Make us look done.
     groupsIterator = _groups->end();
 
-    _firstDocOfNextGroup = boost::none;
+    _streamingGroupStarted = false;
 }
 
 intrusive_ptr<DocumentSource> DocumentSourceGroup::optimize() {
@@ -221,12 +267,60 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
+    if (explain && _unwindSrc) {
+        // Our output does not have to be parseable, so show the absorbed $unwind inside.
+        insides["$unwinding"] = _unwindSrc->serialize(explain)[_unwindSrc->getSourceName()];
+    }
+
     if (explain && findRelevantInputSort()) {
         return Value(DOC("$streamingGroup" << insides.freeze()));
     }
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
+void DocumentSourceGroup::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (_unwindSrc && !explain) {
+        _unwindSrc->serializeToArray(array);
+    }
+    DocumentSource::serializeToArray(array, explain);
+}
+
+void DocumentSourceGroup::setSource(DocumentSource* source) {
+    DocumentSource::setSource(source);
+    if (_unwindSrc) {
+        // The streaming path still pulls the unwound documents through the $unwind.
+        _unwindSrc->setSource(source);
+    }
+}
+
+bool DocumentSourceGroup::absorbUnwind(const intrusive_ptr<DocumentSourceUnwind>& unwind) {
+    if (_unwindSrc || _doingMerge) {
+        return false;
+    }
+    _unwindSrc = unwind;
+
+    // An unwound document only needs the top-level fields we read, which now include the path
+    // being unwound. Leaving out the rest makes the copy taken of each input document cheaper.
+    DepsTracker deps;
+    getDependencies(&deps);
+    if (!deps.needWholeDocument) {
+        std::set<std::string> fieldNames;
+        for (auto&& field : deps.fields) {
+            fieldNames.insert(FieldPath(field).getFieldName(0).toString());
+        }
+        _unwindInputFields.emplace(fieldNames.begin(), fieldNames.end());
+    }
+    return true;
+}
+
+boost::optional<StageMemoryStats> DocumentSourceGroup::getMemoryStats() const {
+    StageMemoryStats memoryStats;
+    memoryStats.peakMemUsage = _trackedMemory.peakBytes();
+    memoryStats.spills = _numSpills;
+    return memoryStats;
+}
+
 DocumentSource::GetDepsReturn DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
     // add the _id
     for (size_t i = 0; i < _idExpressions.size(); i++) {
@@ -238,6 +332,10 @@ DocumentSource::GetDepsReturn DocumentSourceGroup::getDependencies(DepsTracker*
         accumulatedField.expression->addDependencies(deps);
     }
 
+    if (_unwindSrc) {
+        _unwindSrc->getDependencies(deps);
+    }
+
     return EXHAUSTIVE_ALL;
 }
 
@@ -266,6 +364,8 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _initialized(false),
       _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
+      _numSpillPartitions(
+          std::min(std::max(internalDocumentSourceGroupSpillPartitions.load(), 0), 1024)),
       _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {}
 
 void DocumentSourceGroup::addAccumulator(AccumulationStatement accumulationStatement) {
@@ -405,26 +505,27 @@ bool containsOnlyFieldPathsAndConstants(ExpressionObject* expressionObj) {
     return true;
 }
 
-void getFieldPathMap(ExpressionObject* expressionObj,
-                     std::string prefix,
-                     StringMap<std::string>* fields) {
-    // Given an expression with only constant and FieldPath leaf nodes, such as {x: {y: "$a.b"}},
-    // attempt to compute a map from each FieldPath leaf to the path of that leaf. In the example,
-    // this method would return: {"a.b" : "x.y"}.
-
-    for (auto&& it : expressionObj->getChildExpressions()) {
-        intrusive_ptr<Expression> childExp = it.second;
-        ExpressionObject* expObj = dynamic_cast<ExpressionObject*>(childExp.get());
-        ExpressionFieldPath* expPath = dynamic_cast<ExpressionFieldPath*>(childExp.get());
-
-        std::string newPrefix = prefix.empty() ? it.first : prefix + "." + it.first;
-
-        if (expObj) {
-            getFieldPathMap(expObj, newPrefix, fields);
-        } else if (expPath) {
-            (*fields)[expPath->getFieldPath().tail().fullPath()] = newPrefix;
+/**
+ * Returns whether the value 'key' computed by 'exp', which contains only field paths and constants,
+ * takes its place in a sort on those field paths. A field that is null, undefined, missing or an
+ * array does not, so documents with such a key are not necessarily consecutive in sorted input.
+ */
+bool isStreamableGroupKey(Expression* exp, const Value& key) {
+    if (dynamic_cast<ExpressionConstant*>(exp)) {
+        return true;
+    } else if (auto expObj = dynamic_cast<ExpressionObject*>(exp)) {
+        // A missing field is left out of the evaluated object, so look up each child by name.
+        invariant(key.getType() == BSONType::Object);
+        const Document subKey = key.getDocument();
+        for (auto&& it : expObj->getChildExpressions()) {
+            if (!isStreamableGroupKey(it.second.get(), subKey[it.first])) {
+                return false;
+            }
         }
+        return true;
     }
+    invariant(dynamic_cast<ExpressionFieldPath*>(exp));
+    return !key.nullish() && !key.isArray();
 }
 
 void getFieldPathListForSpilled(ExpressionObject* expressionObj,
@@ -457,22 +558,11 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         _streaming = true;
         _inputSort = *inputSort;
 
-        // Set up accumulators.
+        // Set up accumulators. The input is consumed by getNextStreaming().
         _currentAccumulators.reserve(numAccumulators);
         for (auto&& accumulatedField : _accumulatedFields) {
             _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
         }
-
-        // We only need to load the first document.
-        auto firstInput = pSource->getNext();
-        if (!firstInput.isAdvanced()) {
-            // Leave '_firstDocOfNextGroup' uninitialized and return.
-            return firstInput;
-        }
-        _firstDocOfNextGroup = firstInput.releaseDocument();
-
-        // Compute the _id value.
-        _currentId = computeId(*_firstDocOfNextGroup);
         _initialized = true;
         return DocumentSource::GetNextResult::makeEOF();
     }
@@ -481,105 +571,196 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     GetNextResult input = pSource->getNext();
     for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
-        }
-
         // We release the result document here so that it does not outlive the end of this loop
         // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
+        accumulateInput(input.releaseDocument());
+    }
 
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
+    switch (input.getStatus()) {
+        case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
+            MONGO_UNREACHABLE;  // We consumed all advances above.
+        }
+        case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
+            return input;  // Propagate pause.
+        }
+        case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
+            // Do any final steps necessary to prepare to output results.
+            prepareToOutputGroups();
 
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
+            // This must happen last so that, unless control gets here, we will re-enter
+            // initialization after getting a GetNextResult::ResultState::kPauseExecution.
+            _initialized = true;
+            return input;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
 
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+DocumentSource::GetNextResult DocumentSourceGroup::getNextInput() {
+    return _unwindSrc ? _unwindSrc->getNext() : pSource->getNext();
+}
+
+void DocumentSourceGroup::accumulateInput(const Document& rootDocument) {
+    if (!_unwindSrc) {
+        accumulateIntoGroups(rootDocument, computeId(rootDocument));
+        return;
+    }
+
+    Document unwindInput = rootDocument;
+    if (_unwindInputFields) {
+        MutableDocument trimmed(_unwindInputFields->size());
+        for (auto&& fieldName : *_unwindInputFields) {
+            Value value = rootDocument[fieldName];
+            if (!value.missing()) {
+                trimmed.addField(fieldName, std::move(value));
             }
         }
+        trimmed.copyMetaDataFrom(rootDocument);
+        unwindInput = trimmed.freeze();
+    }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
+    // Each unwound document is only referenced while its inputs are evaluated, so the $unwind can
+    // update the same document in place for every element of the array.
+    _unwindSrc->unwindDocument(unwindInput, [this](const Document& unwound) {
+        accumulateIntoGroups(unwound, computeId(unwound));
+    });
+}
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
+void DocumentSourceGroup::accumulateIntoGroups(const Document& rootDocument, const Value& id) {
+    if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        // The queued inputs belong to a group which is about to be spilled.
+        processQueuedInputs();
+        uassert(16945,
+                "Exceeded memory limit for $group, but didn't allow external sort."
+                " Pass allowDiskUse:true to opt in.",
+                _allowDiskUse);
+        if (_numSpillPartitions > 1) {
+            spillToPartitions();
+        } else {
+            _sortedFiles.push_back(spill());
+        }
+        _memoryUsageBytes = 0;
+    }
 
-            _memoryUsageBytes += group[i]->memUsageForSorter();
+    bool inserted;
+    Accumulators& group = getOrCreateGroup(id, &inserted);
+    dassert(_accumulatedFields.size() == group.size());
+
+    if (inserted) {
+        // Account for the new accumulators now, so that processQueuedInputs() can treat every
+        // group in the map alike.
+        for (auto&& groupObj : group) {
+            _memoryUsageBytes += groupObj->memUsageForSorter();
         }
+    }
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+    queueForAccumulation(&group, true, rootDocument);
+    _trackedMemory.set(_memoryUsageBytes);
 
-                _sortedFiles.push_back(spill());
-            }
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&                 // is a dup
+            !pExpCtx->inMongos &&        // can't spill to disk in mongos
+            !_allowDiskUse &&            // don't change behavior when testing external sort
+            _sortedFiles.size() < 20) {  // don't open too many FDs
+
+            processQueuedInputs();
+            _sortedFiles.push_back(spill());
         }
     }
+}
 
-    switch (input.getStatus()) {
-        case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
-            MONGO_UNREACHABLE;  // We consumed all advances above.
+void DocumentSourceGroup::queueForAccumulation(Accumulators* group,
+                                               bool inGroupsMap,
+                                               const Document& rootDocument) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    if (numAccumulators == 0) {
+        return;
+    }
+
+    if (group != _queuedGroup) {
+        processQueuedInputs();
+        _queuedGroup = group;
+        _queuedGroupInGroupsMap = inGroupsMap;
+        _queuedInputs.resize(numAccumulators);
+    }
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        _queuedInputs[i].push_back(_accumulatedFields[i].expression->evaluate(rootDocument));
+    }
+
+    if (_queuedInputs.front().size() >= kMaxQueuedInputs) {
+        processQueuedInputs();
+    }
+}
+
+void DocumentSourceGroup::processQueuedInputs() {
+    if (!_queuedGroup) {
+        return;
+    }
+
+    /* tickle all the accumulators for the group we queued inputs for */
+    auto& group = *_queuedGroup;
+    for (size_t i = 0; i < group.size(); i++) {
+        if (_queuedGroupInGroupsMap) {
+            // subtract old mem usage. New usage added back after processing.
+            _memoryUsageBytes -= group[i]->memUsageForSorter();
         }
-        case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
-            return input;  // Propagate pause.
+
+        group[i]->processBatch(_queuedInputs[i], _doingMerge);
+        _queuedInputs[i].clear();
+
+        if (_queuedGroupInGroupsMap) {
+            _memoryUsageBytes += group[i]->memUsageForSorter();
         }
-        case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
-            // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
-                _spilled = true;
-                if (!_groups->empty()) {
-                    _sortedFiles.push_back(spill());
-                }
+    }
+    _trackedMemory.set(_memoryUsageBytes);
 
-                // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    _queuedGroup = nullptr;
+}
 
-                _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
-                    _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
+void DocumentSourceGroup::prepareToOutputGroups() {
+    processQueuedInputs();
 
-                // prepare current to accumulate data
-                _currentAccumulators.reserve(numAccumulators);
-                for (auto&& accumulatedField : _accumulatedFields) {
-                    _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
-                }
+    if (!_partitionWriters.empty()) {
+        _partitioned = true;
+        if (!_groups->empty()) {
+            spillToPartitions();
+        }
 
-                verify(_sorterIterator->more());  // we put data in, we should get something out.
-                _firstPartOfNextGroup = _sorterIterator->next();
-            } else {
-                // start the group iterator
-                groupsIterator = _groups->begin();
-            }
+        // prepare current to accumulate data, in case a partition has to be merged from
+        // sorted runs.
+        _currentAccumulators.reserve(_accumulatedFields.size());
+        for (auto&& accumulatedField : _accumulatedFields) {
+            _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
 
-            // This must happen last so that, unless control gets here, we will re-enter
-            // initialization after getting a GetNextResult::ResultState::kPauseExecution.
-            _initialized = true;
-            return input;
+        // The partitions are loaded one at a time by getNextPartitioned().
+        groupsIterator = _groups->end();
+    } else if (!_sortedFiles.empty()) {
+        _spilled = true;
+        if (!_groups->empty()) {
+            _sortedFiles.push_back(spill());
+        }
+
+        // We won't be using groups again so free its memory.
+        _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+
+        _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
+            _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
+
+        // prepare current to accumulate data
+        _currentAccumulators.reserve(_accumulatedFields.size());
+        for (auto&& accumulatedField : _accumulatedFields) {
+            _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
         }
+
+        verify(_sorterIterator->more());  // we put data in, we should get something out.
+        _firstPartOfNextGroup = _sorterIterator->next();
+    } else {
+        // start the group iterator
+        groupsIterator = _groups->begin();
     }
-    MONGO_UNREACHABLE;
 }
 
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
@@ -592,50 +773,174 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
 
     SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
-            }
-            break;
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        writer.addAlreadySorted(ptrs[i]->first, getSpillState(ptrs[i]->second));
+    }
 
-        case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+    _groups->clear();
+    ++_numSpills;
+
+    return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
+}
+
+void DocumentSourceGroup::spillToPartitions() {
+    if (_partitionWriters.empty()) {
+        _partitionWriters.reserve(_numSpillPartitions);
+        for (size_t i = 0; i < _numSpillPartitions; ++i) {
+            _partitionWriters.push_back(stdx::make_unique<SortedFileWriter<Value, Value>>(
+                SortOptions().TempDir(pExpCtx->tempDir)));
+        }
+        _partitionCounts.assign(_numSpillPartitions, 0);
+    }
+
+    const auto& valueComparator = pExpCtx->getValueComparator();
+    for (auto&& group : *_groups) {
+        // The groups map buckets keys by the same hash, so scramble it before picking a partition
+        // to keep the partitions from inheriting the map's bucket distribution.
+        const uint64_t hash =
+            static_cast<uint64_t>(valueComparator.hash(group.first)) * 0x9E3779B97F4A7C15ULL;
+        const size_t partition = (hash >> 32) % _numSpillPartitions;
+
+        _partitionWriters[partition]->addAlreadySorted(group.first, getSpillState(group.second));
+        ++_partitionCounts[partition];
+    }
+
+    _groups->clear();
+    ++_numSpills;
+}
+
+bool DocumentSourceGroup::loadNextPartition() {
+    _groups->clear();
+    _memoryUsageBytes = 0;
+    _trackedMemory.set(0);
+
+    while (_nextPartition < _partitionWriters.size()) {
+        const size_t partitionNo = _nextPartition++;
+        auto writer = std::move(_partitionWriters[partitionNo]);
+        if (_partitionCounts[partitionNo] == 0) {
+            continue;  // An empty file can't be read back, so skip it entirely.
+        }
+
+        std::unique_ptr<Sorter<Value, Value>::Iterator> partition(writer->done());
+        writer.reset();
+
+        vector<shared_ptr<Sorter<Value, Value>::Iterator>> sortedRuns;
+        while (partition->more()) {
+            pExpCtx->checkForInterrupt();
+
+            if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+                sortedRuns.push_back(spill());
+                _memoryUsageBytes = 0;
             }
-            break;
 
-        default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
+            auto next = partition->next();
+            bool inserted;
+            Accumulators& group = getOrCreateGroup(next.first, &inserted);
+            if (!inserted) {
+                for (auto&& groupObj : group) {
+                    _memoryUsageBytes -= groupObj->memUsageForSorter();
                 }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
             }
-            break;
+
+            mergeSpillState(next.second, group);
+
+            for (auto&& groupObj : group) {
+                _memoryUsageBytes += groupObj->memUsageForSorter();
+            }
+            _trackedMemory.set(_memoryUsageBytes);
+        }
+
+        if (!sortedRuns.empty()) {
+            // This partition alone exceeded the memory limit. Merge its sorted runs on the way
+            // out, like a $group spilled without partitioning.
+            if (!_groups->empty()) {
+                sortedRuns.push_back(spill());
+            }
+            _memoryUsageBytes = 0;
+            _trackedMemory.set(0);
+
+            _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
+                sortedRuns, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
+            verify(_sorterIterator->more());
+            _firstPartOfNextGroup = _sorterIterator->next();
+            groupsIterator = _groups->end();
+            return true;
+        }
+
+        groupsIterator = _groups->begin();
+        return true;
     }
 
-    _groups->clear();
+    return false;
+}
 
-    return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
+DocumentSourceGroup::Accumulators& DocumentSourceGroup::getOrCreateGroup(const Value& id,
+                                                                         bool* inserted) {
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in '_groups' multiple times.
+    const size_t oldSize = _groups->size();
+    Accumulators& group = (*_groups)[id];
+    *inserted = _groups->size() != oldSize;
+
+    if (*inserted) {
+        _memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        group.reserve(_accumulatedFields.size());
+        for (auto&& accumulatedField : _accumulatedFields) {
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
+    }
+
+    return group;
 }
 
-boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
-    if (true) {
-        // Until streaming $group correctly handles nullish values, the streaming behavior is
-        // disabled. See SERVER-23318.
-        return boost::none;
+Value DocumentSourceGroup::getSpillState(const Accumulators& accums) const {
+    switch (accums.size()) {
+        case 0:  // no values, essentially a distinct
+            return Value();
+
+        case 1:  // just one value, use optimized serialization as single Value
+            return accums[0]->getValue(/*toBeMerged=*/true);
+
+        default: {  // multiple values, serialize as array-typed Value
+            vector<Value> states;
+            states.reserve(accums.size());
+            for (auto&& accum : accums) {
+                states.push_back(accum->getValue(/*toBeMerged=*/true));
+            }
+            return Value(std::move(states));
+        }
+    }
+}
+
+void DocumentSourceGroup::mergeSpillState(const Value& state, const Accumulators& accums) const {
+    switch (accums.size()) {  // mirrors switch in getSpillState()
+        case 0:               // No accumulators so no Values.
+            break;
+
+        case 1:  // Single accumulators serialize as a single Value.
+            accums[0]->process(state, true);
+            break;
+
+        default: {  // Multiple accumulators serialize as an array of Values.
+            const vector<Value>& accumulatorStates = state.getArray();
+            for (size_t i = 0; i < accums.size(); i++) {
+                accums[i]->process(accumulatorStates[i], true);
+            }
+        }
     }
+}
 
+boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
     if (!pSource) {
         // Sometimes when performing an explain, or using $group as the merge point, 'pSource' will
         // not be set.
         return boost::none;
     }
 
-    BSONObjSet sorts = pSource->getOutputSorts();
+    BSONObjSet sorts = (_unwindSrc ? _unwindSrc.get() : pSource)->getOutputSorts();
 
     // 'sorts' is a BSONObjSet. We need to check if our group pattern is compatible with one of the
     // input sort patterns.
@@ -691,64 +996,20 @@ boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
 BSONObjSet DocumentSourceGroup::getOutputSorts() {
     if (!_initialized) {
         initialize();  // Note this might not finish initializing, but that's OK. We just want to
-                       // do some initialization to try to determine if we are streaming or spilled.
-                       // False negatives are OK.
+                       // do some initialization to try to determine if we have spilled. False
+                       // negatives are OK.
     }
 
-    if (!(_streaming || _spilled)) {
+    // A streaming $group returns the groups it could not stream after all of the others, so its
+    // output is not sorted even though its input is.
+    if (!_spilled) {
         return SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     }
 
     BSONObjBuilder sortOrder;
 
     if (_idFieldNames.empty()) {
-        if (_spilled) {
-            sortOrder.append("_id", 1);
-        } else {
-            // We have an expression like {_id: "$a"}. Check if this is a FieldPath, and if it is,
-            // get the sort order out of it.
-            if (auto obj = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get())) {
-                FieldPath _idSort = obj->getFieldPath();
-
-                sortOrder.append(
-                    "_id",
-                    _inputSort.getIntField(_idSort.getFieldName(_idSort.getPathLength() - 1)));
-            }
-        }
-    } else if (_streaming) {
-        // At this point, we know that _streaming is true, so _id must have only contained
-        // ExpressionObjects, ExpressionConstants or ExpressionFieldPaths. We now process each
-        // '_idExpression'.
-
-        // We populate 'fieldMap' such that each key is a field the input is sorted by, and the
-        // value is where that input field is located within the _id document. For example, if our
-        // _id object is {_id: {x: {y: "$a.b"}}}, 'fieldMap' would be: {'a.b': '_id.x.y'}.
-        StringMap<std::string> fieldMap;
-        for (size_t i = 0; i < _idFieldNames.size(); i++) {
-            intrusive_ptr<Expression> exp = _idExpressions[i];
-            if (auto obj = dynamic_cast<ExpressionObject*>(exp.get())) {
-                // _id is an object containing a nested document, such as: {_id: {x: {y: "$b"}}}.
-                getFieldPathMap(obj, "_id." + _idFieldNames[i], &fieldMap);
-            } else if (auto fieldPath = dynamic_cast<ExpressionFieldPath*>(exp.get())) {
-                FieldPath _idSort = fieldPath->getFieldPath();
-                fieldMap[_idSort.getFieldName(_idSort.getPathLength() - 1)] =
-                    "_id." + _idFieldNames[i];
-            }
-        }
-
-        // Because the order of '_inputSort' is important, we go through each field we are sorted on
-        // and append it to the BSONObjBuilder in order.
-        for (BSONElement sortField : _inputSort) {
-            std::string sortString = sortField.fieldNameStringData().toString();
-
-            auto itr = fieldMap.find(sortString);
-
-            // If our sort order is (a, b, c), we could not have converted to a streaming $group if
-            // our _id was predicated on (a, c) but not 'b'. Verify that this is true.
-            invariant(itr != fieldMap.end());
-
-            sortOrder.append(itr->second, _inputSort.getIntField(sortString));
-        }
+        sortOrder.append("_id", 1);
     } else {
         // We are blocking and have spilled to disk.
         std::vector<std::string> outputSort;
@@ -769,6 +1030,20 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
     return allPrefixes(sortOrder.obj());
 }
 
+bool DocumentSourceGroup::canStreamId(const Value& id) const {
+    if (_idExpressions.size() == 1) {
+        return isStreamableGroupKey(_idExpressions[0].get(), id);
+    }
+
+    const auto& components = id.getArray();
+    dassert(components.size() == _idExpressions.size());
+    for (size_t i = 0; i < _idExpressions.size(); i++) {
+        if (!isStreamableGroupKey(_idExpressions[i].get(), components[i])) {
+            return false;
+        }
+    }
+    return true;
+}
 
 Value DocumentSourceGroup::computeId(const Document& root) {
     // If only one expression, return result directly
@@ -29,15 +29,20 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/util/memory_usage_tracker.h"
 
 namespace mongo {
 
+class DocumentSourceUnwind;
+
 class DocumentSourceGroup final : public DocumentSource, public NeedsMergerDocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
@@ -49,9 +54,14 @@ public:
     boost::intrusive_ptr<DocumentSource> optimize() final;
     GetDepsReturn getDependencies(DepsTracker* deps) const final;
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+    void setSource(DocumentSource* source) final;
     GetNextResult getNext() final;
     const char* getSourceName() const final;
     BSONObjSet getOutputSorts() final;
+    boost::optional<StageMemoryStats> getMemoryStats() const final;
 
     /**
      * Convenience method for creating a new $group stage.
@@ -95,10 +105,25 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Returns true if this $group merges the partial groups produced by $groups on the shards.
+     */
+    bool doingMerge() const {
+        return _doingMerge;
+    }
+
     bool isStreaming() const {
         return _streaming;
     }
 
+    /**
+     * Takes over the work of 'unwind', the stage preceding this one, so that the documents it
+     * would produce are fed to the accumulators as each array element is visited rather than
+     * pulled through the pipeline one at a time. Returns false, leaving the pipeline unchanged, if
+     * this $group cannot absorb it.
+     */
+    bool absorbUnwind(const boost::intrusive_ptr<DocumentSourceUnwind>& unwind);
+
     // Virtuals for NeedsMergerDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final;
@@ -112,13 +137,20 @@ private:
 
     /**
      * getNext() dispatches to one of these three depending on what type of $group it is. All three
-     * of these methods expect '_currentAccumulators' to have been reset before being called, and
-     * also expect initialize() to have been called already.
+     * of these methods expect initialize() to have been called already. The spilled and standard
+     * ones also expect '_currentAccumulators' to have been reset before being called, while
+     * getNextStreaming() resets them itself, since a group may span calls that return a pause.
      */
     GetNextResult getNextStreaming();
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
 
+    /**
+     * Used instead of the above once the groups have been spilled to hash partitions. Returns the
+     * groups of one partition at a time, loading the next partition when the current one is done.
+     */
+    GetNextResult getNextPartitioned();
+
     /**
      * Attempt to identify an input sort order that allows us to turn into a streaming $group. If we
      * find one, return it. Otherwise, return boost::none.
@@ -127,9 +159,9 @@ private:
 
     /**
      * Before returning anything, this source must prepare itself. In a streaming $group,
-     * initialize() requests the first document from the previous source, and uses it to prepare the
-     * accumulators. In an unsorted $group, initialize() exhausts the previous source before
-     * returning. The '_initialized' boolean indicates that initialize() has finished.
+     * initialize() only prepares the accumulators, and the input is consumed by getNextStreaming().
+     * In an unsorted $group, initialize() exhausts the previous source before returning. The
+     * '_initialized' boolean indicates that initialize() has finished.
      *
      * This method may not be able to finish initialization in a single call if 'pSource' returns a
      * DocumentSource::GetNextResult::kPauseExecution, so it returns the last GetNextResult
@@ -137,6 +169,51 @@ private:
      */
     GetNextResult initialize();
 
+    /**
+     * Returns the next input document, from the absorbed $unwind if there is one.
+     */
+    GetNextResult getNextInput();
+
+    /**
+     * Accumulates the input document 'rootDocument' into the groups map, unwinding it first if an
+     * $unwind was absorbed.
+     */
+    void accumulateInput(const Document& rootDocument);
+
+    /**
+     * Adds 'rootDocument' to the group 'id' in the groups map, spilling the map first if it has
+     * exceeded the memory limit.
+     */
+    void accumulateIntoGroups(const Document& rootDocument, const Value& id);
+
+    /**
+     * Evaluates the inputs of 'rootDocument' to each accumulator and queues them for the
+     * accumulators of 'group', which is in the groups map if 'inGroupsMap' is true. Inputs queued
+     * for a different group are processed first, so consecutive documents for the same group are
+     * fed to its accumulators in batches of up to kMaxQueuedInputs.
+     */
+    void queueForAccumulation(Accumulators* group, bool inGroupsMap, const Document& rootDocument);
+
+    /**
+     * Feeds the queued inputs to the accumulators they were queued for. Must be called before
+     * those accumulators are read, reset, spilled or destroyed.
+     */
+    void processQueuedInputs();
+
+    /**
+     * Called once the input is exhausted to set up returning the groups in the groups map, merging
+     * them with anything that has already been spilled to disk.
+     */
+    void prepareToOutputGroups();
+
+    /**
+     * Returns whether documents with the group key 'id' are guaranteed to be consecutive in input
+     * sorted by '_inputSort'. This is not the case when a grouped field is null, undefined or
+     * missing, since these all sort together but form different groups, or when it is an array,
+     * since an array sorts by one of its elements.
+     */
+    bool canStreamId(const Value& id) const;
+
     /**
      * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
      * does not exhaust the previous stage before returning, and thus does not maintain as large a
@@ -144,6 +221,34 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Alternative to spill() used when hash-partitioned spilling is enabled. Appends every group
+     * in the groups map, unsorted, to the on-disk partition selected by the hash of its key, then
+     * clears the map. Each partition holds all of the partial states for the keys it is assigned,
+     * so partitions can later be re-aggregated in memory independently of each other.
+     */
+    void spillToPartitions();
+
+    /**
+     * Reads the next non-empty partition back into the groups map, merging the partial states of
+     * each key. If a single partition does not fit in memory, it falls back to spilling sorted runs
+     * and sets up '_sorterIterator' to merge them. Returns false once all partitions are consumed.
+     */
+    bool loadNextPartition();
+
+    /**
+     * Returns the accumulators for the group 'id', creating the group and accounting for its key
+     * in '_memoryUsageBytes' if it is new. '*inserted' is set to whether the group was created.
+     */
+    Accumulators& getOrCreateGroup(const Value& id, bool* inserted);
+
+    /**
+     * Returns the mergeable state of 'accums' in the format written to disk by spill(), and feeds
+     * such a state back into 'accums'.
+     */
+    Value getSpillState(const Accumulators& accums) const;
+    void mergeSpillState(const Value& state, const Accumulators& accums) const;
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -161,6 +266,7 @@ private:
 
     bool _doingMerge;
     size_t _memoryUsageBytes = 0;
+    TrackedMemory _trackedMemory{MemoryUsageTracker::Category::kGroup};
     size_t _maxMemoryUsageBytes;
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
@@ -180,6 +286,21 @@ private:
     std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
     bool _spilled;
 
+    // The number of times groups were written to disk, as sorted runs or to hash partitions.
+    long long _numSpills = 0;
+
+    // The number of hash partitions to spill to, or 0 to spill sorted runs.
+    const size_t _numSpillPartitions;
+
+    // One writer per hash partition, created on the first spill in that mode. A writer is only
+    // turned into an iterator, which opens its file for reading, when its partition is loaded.
+    std::vector<std::unique_ptr<SortedFileWriter<Value, Value>>> _partitionWriters;
+    std::vector<size_t> _partitionCounts;
+    size_t _nextPartition = 0;
+
+    // True once the input is exhausted and output comes from the spilled partitions.
+    bool _partitioned = false;
+
     // Only used when '_spilled' is false.
     GroupsMap::iterator groupsIterator;
 
@@ -188,8 +309,28 @@ private:
     const bool _allowDiskUse;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
-    // Only used when '_sorted' is true.
-    boost::optional<Document> _firstDocOfNextGroup;
+
+    // Only used when '_streaming' is true. Whether '_currentId' and '_currentAccumulators' hold a
+    // group that has not been returned yet, and whether the input has been exhausted, after which
+    // the groups that could not be streamed are returned from the groups map.
+    bool _streamingGroupStarted = false;
+    bool _streamingInputExhausted = false;
+
+    // The most inputs queued for a group before they are processed.
+    static constexpr size_t kMaxQueuedInputs = 64;
+
+    // The group whose accumulators '_queuedInputs' are destined for, one vector of inputs per
+    // accumulator, or nullptr if no inputs are queued.
+    Accumulators* _queuedGroup = nullptr;
+    bool _queuedGroupInGroupsMap = false;
+    std::vector<std::vector<Value>> _queuedInputs;
+
+    // The $unwind stage that preceded this one, if it was absorbed. Its source is our source.
+    boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
+
+    // The top-level fields of an input document that the absorbed $unwind needs to carry into the
+    // documents it produces for us, or boost::none if we need the whole document.
+    boost::optional<std::vector<std::string>> _unwindInputFields;
 };
 
 }  // namespace mongo
@@ -43,16 +43,19 @@
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -139,6 +142,60 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+/**
+ * Groups documents {_id: i % numKeys, x: i} by '_id', summing 'x', with a small enough memory limit
+ * to force spilling to 'numPartitions' hash partitions, and checks the sum of every group.
+ */
+void assertHashPartitionedSpillIsCorrect(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                         int numPartitions,
+                                         int numKeys,
+                                         int numDocs,
+                                         size_t maxMemoryUsageBytes) {
+    const int oldPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(numPartitions);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupSpillPartitions.store(oldPartitions); });
+
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement sumStatement{"total",
+                                       ExpressionFieldPath::parse(expCtx, "$x", vps),
+                                       AccumulationStatement::getFactory("$sum")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$_id", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {sumStatement}, maxMemoryUsageBytes);
+
+    std::deque<DocumentSource::GetNextResult> inputs;
+    std::map<int, long long> expectedTotals;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.emplace_back(Document{{"_id", i % numKeys}, {"x", i}});
+        expectedTotals[i % numKeys] += i;
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    std::map<int, long long> totals;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        const int id = doc["_id"].coerceToInt();
+        ASSERT_EQ(totals.count(id), 0UL);
+        totals[id] = doc["total"].coerceToLong();
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT(totals == expectedTotals);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldMergePartialGroupsWhenSpillingToHashPartitions) {
+    assertHashPartitionedSpillIsCorrect(getExpCtx(), 8, 40, 400, 1000);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldFallBackToSortedRunsIfHashPartitionDoesNotFitInMemory) {
+    // With two partitions, each one holds far more groups than fit under the memory limit.
+    assertHashPartitionedSpillIsCorrect(getExpCtx(), 2, 200, 1000, 1000);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
@@ -189,6 +246,50 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     ASSERT_THROWS_CODE(group->getNext(), AssertionException, 16945);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldUnwindInputWhenUnwindIsAbsorbed) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement totalStatement{"total",
+                                         ExpressionFieldPath::parse(expCtx, "$items", vps),
+                                         AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement maxIndexStatement{"maxIndex",
+                                            ExpressionFieldPath::parse(expCtx, "$idx", vps),
+                                            AccumulationStatement::getFactory("$max")};
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$customer", vps),
+                                             {totalStatement, maxIndexStatement});
+    auto unwind = DocumentSourceUnwind::create(expCtx, "items", true, std::string("idx"));
+    ASSERT_TRUE(group->absorbUnwind(unwind));
+    ASSERT_FALSE(group->absorbUnwind(unwind));
+
+    // The absorbed $unwind is serialized ahead of the $group, so that the pipeline round trips.
+    vector<Value> serialized;
+    group->serializeToArray(serialized);
+    ASSERT_EQ(2U, serialized.size());
+    ASSERT_VALUE_EQ(Value(Document{{"$unwind", Document{{"path", "$items"_sd},
+                                                        {"preserveNullAndEmptyArrays", true},
+                                                        {"includeArrayIndex", "idx"_sd}}}}),
+                    serialized[0]);
+
+    auto mock =
+        DocumentSourceMock::create({Document{{"customer", "a"_sd},
+                                             {"items", Value(vector<Value>{Value(1), Value(2)})},
+                                             {"unused", "x"_sd}},
+                                    Document{{"customer", "b"_sd}, {"items", vector<Value>{}}},
+                                    Document{{"customer", "a"_sd}, {"items", 4}}});
+    group->setSource(mock.get());
+
+    map<string, Document> results;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        auto doc = next.releaseDocument();
+        results[doc["_id"].getString()] = doc;
+    }
+    ASSERT_EQ(2U, results.size());
+    ASSERT_DOCUMENT_EQ(results["a"], (Document{{"_id", "a"_sd}, {"total", 7}, {"maxIndex", 1}}));
+    ASSERT_DOCUMENT_EQ(results["b"],
+                       (Document{{"_id", "b"_sd}, {"total", 0}, {"maxIndex", BSONNULL}}));
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
@@ -799,10 +900,9 @@ public:
 
         assertEOF(group());
 
+        // Groups which cannot be streamed come last, so the output is not sorted.
         BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 1U);
-
-        ASSERT_EQUALS(outputSort.count(BSON("_id" << 1)), 1U);
+        ASSERT_EQUALS(outputSort.size(), 0U);
     }
 };
 
@@ -835,22 +935,21 @@ public:
 
         assertEOF(source);
 
-        BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 2U);
-
-        BSONObj correctSort = BSON("_id.x" << 1 << "_id.y" << -1);
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id")["x"], Value(2));
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id")["y"], Value(1));
 
-        BSONObj prefixSort = BSON("_id.x" << 1);
-        ASSERT_EQUALS(outputSort.count(prefixSort), 1U);
+        assertEOF(group());
     }
 };
 
 class StreamingWithMultipleLevels : public Base {
 public:
     void run() {
-        auto source = DocumentSourceMock::create(
-            {"{a: {b: {c: 3}}, d: 1}", "{a: {b: {c: 1}}, d: 2}", "{a: {b: {c: 1}}, d: 0}"});
+        auto source = DocumentSourceMock::create({"{a: {b: {c: 3, d: 1}}, d: 1}",
+                                                  "{a: {b: {c: 1, d: 1}}, d: 0}",
+                                                  "{a: {b: {c: 1, d: 1}}, d: 2}"});
         source->sorts = {BSON("a.b.c" << -1 << "a.b.d" << 1 << "d" << 1)};
 
         createGroup(fromjson("{_id: {x: {y: {z: '$a.b.c', q: '$a.b.d'}}, v: '$d'}}"));
@@ -865,20 +964,16 @@ public:
         res = source->getNext();
         ASSERT_TRUE(res.isAdvanced());
         ASSERT_VALUE_EQ(res.getDocument().getField("a")["b"]["c"], Value(1));
+        ASSERT_VALUE_EQ(res.getDocument().getField("d"), Value(2));
 
         assertEOF(source);
 
-        BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 3U);
-
-        BSONObj correctSort = fromjson("{'_id.x.y.z': -1, '_id.x.y.q': 1, '_id.v': 1}");
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
-
-        BSONObj prefixSortTwo = fromjson("{'_id.x.y.z': -1, '_id.x.y.q': 1}");
-        ASSERT_EQUALS(outputSort.count(prefixSortTwo), 1U);
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id")["x"]["y"]["z"], Value(1));
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id")["v"], Value(0));
 
-        BSONObj prefixSortOne = fromjson("{'_id.x.y.z': -1}");
-        ASSERT_EQUALS(outputSort.count(prefixSortOne), 1U);
+        assertEOF(group());
     }
 };
 
@@ -905,15 +1000,12 @@ public:
         ASSERT_VALUE_EQ(res.getDocument().getField("a"), Value(2));
         ASSERT_VALUE_EQ(res.getDocument().getField("b"), Value(3));
 
-        BSONObjSet outputSort = group()->getOutputSorts();
-
-        ASSERT_EQUALS(outputSort.size(), 2U);
-
-        BSONObj correctSort = fromjson("{'_id.sub.z': 1}");
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id")["sub"]["x"], Value(2));
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id")["sub"]["y"], Value(1));
 
-        BSONObj prefixSortTwo = fromjson("{'_id.sub.z': 1, '_id.sub.y': 1}");
-        ASSERT_EQUALS(outputSort.count(prefixSortTwo), 1U);
+        assertEOF(group());
     }
 };
 
@@ -940,14 +1032,9 @@ public:
         ASSERT_VALUE_EQ(res.getDocument().getField("a"), Value(3));
         ASSERT_VALUE_EQ(res.getDocument().getField("b"), Value(1));
 
-        BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 2U);
-
-        BSONObj correctSort = fromjson("{'_id.sub.x': -1}");
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
-
-        BSONObj prefixSortTwo = fromjson("{'_id.sub.x': -1, '_id.sub.y': 1}");
-        ASSERT_EQUALS(outputSort.count(prefixSortTwo), 1U);
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id")["sub"]["y"], Value(2));
     }
 };
 
@@ -960,14 +1047,14 @@ public:
         createGroup(fromjson("{_id: '$$ROOT.a'}"));
         group()->setSource(source.get());
 
-        group()->getNext();
+        auto res = group()->getNext();
         ASSERT_TRUE(group()->isStreaming());
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id"), Value(1));
 
-        BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 1U);
-
-        BSONObj correctSort = fromjson("{_id: 1}");
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
+        res = source->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_VALUE_EQ(res.getDocument().getField("a"), Value(3));
     }
 };
 
@@ -1005,6 +1092,96 @@ public:
     }
 };
 
+/**
+ * Null, missing and array keys sort alongside other keys without being equal to them, so their
+ * groups are held back until the end of the input.
+ */
+class StreamingWithNullishAndArrayIds : public CheckResultsBase {
+public:
+    void run() {
+        auto source = DocumentSourceMock::create(
+            {"{}", "{a: null}", "{a: 1}", "{a: [1, 2]}", "{a: 1}", "{a: 2}", "{a: [2]}"});
+        source->sorts = {BSON("a" << 1)};
+
+        createGroup(fromjson("{_id: '$a', count: {$sum: 1}}"));
+        group()->setSource(source.get());
+
+        auto res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_TRUE(group()->isStreaming());
+        ASSERT_DOCUMENT_EQ(res.getDocument(), Document(fromjson("{_id: 1, count: 2}")));
+
+        checkResultSet(group());
+    }
+
+private:
+    string expectedResultSetString() {
+        return "[{_id: null, count: 2}, {_id: 2, count: 1}, {_id: [1, 2], count: 1},"
+               " {_id: [2], count: 1}]";
+    }
+};
+
+class StreamingWithNullishNestedIdField : public CheckResultsBase {
+public:
+    void run() {
+        auto source = DocumentSourceMock::create({"{a: 1}",
+                                                  "{a: 1, b: null}",
+                                                  "{a: 1, b: 1}",
+                                                  "{a: 1}",
+                                                  "{a: 1, b: 1}",
+                                                  "{a: 2, b: 1}"});
+        source->sorts = {BSON("a" << 1 << "b" << 1)};
+
+        createGroup(fromjson("{_id: {x: {y: '$b'}, z: '$a'}, count: {$sum: 1}}"));
+        group()->setSource(source.get());
+
+        auto res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_TRUE(group()->isStreaming());
+        ASSERT_DOCUMENT_EQ(res.getDocument(),
+                           Document(fromjson("{_id: {x: {y: 1}, z: 1}, count: 2}")));
+
+        checkResultSet(group());
+    }
+
+private:
+    string expectedResultSetString() {
+        return "[{_id: {x: {}, z: 1}, count: 2}, {_id: {x: {y: null}, z: 1}, count: 1},"
+               " {_id: {x: {y: 1}, z: 2}, count: 1}]";
+    }
+};
+
+class StreamingWithPausedInput : public Base {
+public:
+    void run() {
+        auto source =
+            DocumentSourceMock::create({Document{{"a", 1}},
+                                        DocumentSource::GetNextResult::makePauseExecution(),
+                                        Document{{"a", 1}},
+                                        Document{{"a", 2}},
+                                        DocumentSource::GetNextResult::makePauseExecution()});
+        source->sorts = {BSON("a" << 1)};
+
+        createGroup(fromjson("{_id: '$a', count: {$sum: 1}}"));
+        group()->setSource(source.get());
+
+        ASSERT_TRUE(group()->getNext().isPaused());
+        ASSERT_TRUE(group()->isStreaming());
+
+        auto res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_DOCUMENT_EQ(res.getDocument(), (Document{{"_id", 1}, {"count", 2}}));
+
+        ASSERT_TRUE(group()->getNext().isPaused());
+
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_DOCUMENT_EQ(res.getDocument(), (Document{{"_id", 2}, {"count", 1}}));
+
+        assertEOF(group());
+    }
+};
+
 class NoOptimizationIfMissingDoubleSort : public Base {
 public:
     void run() {
@@ -1157,8 +1334,6 @@ public:
         add<Dependencies>();
         add<StringConstantIdAndAccumulatorExpressions>();
         add<ArrayConstantAccumulatorExpression>();
-#if 0
-        // Disabled tests until SERVER-23318 is implemented.
         add<StreamingOptimization>();
         add<StreamingWithMultipleIdFields>();
         add<NoOptimizationIfMissingDoubleSort>();
@@ -1170,7 +1345,9 @@ public:
         add<StreamingWithRootSubfield>();
         add<StreamingWithConstantAndFieldPath>();
         add<StreamingWithFieldRepeated>();
-#endif
+        add<StreamingWithNullishAndArrayIds>();
+        add<StreamingWithNullishNestedIdField>();
+        add<StreamingWithPausedInput>();
     }
 };
 
@@ -0,0 +1,236 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include <map>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalUnpackBucket::createFromBson);
+
+constexpr StringData DocumentSourceInternalUnpackBucket::kStageName;
+
+namespace {
+
+std::string controlPath(StringData bound, StringData field) {
+    return str::stream() << timeseries::kBucketControlFieldName << '.' << bound << '.' << field;
+}
+
+/**
+ * Appends to 'out' the bucket predicates implied by a predicate on the time field, which every
+ * measurement holds as a date. A bucket can only hold a measurement after (before) some time if
+ * its maximum (minimum) time is after (before) it too.
+ */
+void appendTimePredicates(const BSONElement& pred, StringData timeField, BSONArrayBuilder* out) {
+    const std::string minPath = controlPath(timeseries::kBucketControlMinFieldName, timeField);
+    const std::string maxPath = controlPath(timeseries::kBucketControlMaxFieldName, timeField);
+
+    auto appendEquality = [&](const BSONElement& date) {
+        out->append(BSON(minPath << BSON("$lte" << date)));
+        out->append(BSON(maxPath << BSON("$gte" << date)));
+    };
+
+    if (pred.type() == BSONType::Date) {
+        appendEquality(pred);
+        return;
+    }
+    if (pred.type() != BSONType::Object) {
+        return;
+    }
+
+    for (auto&& op : pred.Obj()) {
+        if (op.type() != BSONType::Date) {
+            continue;
+        }
+        const auto opName = op.fieldNameStringData();
+        if (opName == "$gt" || opName == "$gte") {
+            out->append(BSON(maxPath << BSON(opName << op.date())));
+        } else if (opName == "$lt" || opName == "$lte") {
+            out->append(BSON(minPath << BSON(opName << op.date())));
+        } else if (opName == "$eq") {
+            appendEquality(op);
+        }
+    }
+}
+
+bool isPathWithin(StringData path, StringData field) {
+    return path.startsWith(field) && (path.size() == field.size() || path[field.size()] == '.');
+}
+
+void appendBucketPredicates(const BSONObj& query,
+                            const timeseries::TimeseriesOptions& options,
+                            BSONArrayBuilder* out) {
+    for (auto&& pred : query) {
+        const auto path = pred.fieldNameStringData();
+        if (path == "$and" && pred.type() == BSONType::Array) {
+            for (auto&& conjunct : pred.Obj()) {
+                if (conjunct.type() == BSONType::Object) {
+                    appendBucketPredicates(conjunct.Obj(), options, out);
+                }
+            }
+        } else if (path == options.timeField) {
+            appendTimePredicates(pred, options.timeField, out);
+        } else if (options.metaField && isPathWithin(path, *options.metaField)) {
+            // Every measurement of a bucket has the bucket's meta value as its meta field.
+            BSONObjBuilder renamed;
+            renamed.appendAs(pred,
+                             timeseries::kBucketMetaFieldName.toString() +
+                                 path.substr(options.metaField->size()).toString());
+            out->append(renamed.obj());
+        }
+    }
+}
+
+}  // namespace
+
+DocumentSourceInternalUnpackBucket::DocumentSourceInternalUnpackBucket(
+    const intrusive_ptr<ExpressionContext>& expCtx, timeseries::TimeseriesOptions options)
+    : DocumentSource(expCtx), _options(std::move(options)) {}
+
+intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(ErrorCodes::TypeMismatch,
+            str::stream() << kStageName << " must take a nested object but found: " << elem,
+            elem.type() == BSONType::Object);
+
+    auto options = uassertStatusOK(timeseries::TimeseriesOptions::parse(elem.embeddedObject()));
+    return new DocumentSourceInternalUnpackBucket(expCtx, std::move(options));
+}
+
+BSONObj DocumentSourceInternalUnpackBucket::createBucketPredicate(
+    const BSONObj& query, const timeseries::TimeseriesOptions& options) {
+    BSONArrayBuilder conjuncts;
+    appendBucketPredicates(query, options, &conjuncts);
+    if (conjuncts.arrSize() == 0) {
+        return BSONObj();
+    }
+    return BSON("$and" << conjuncts.arr());
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (_nextMeasurement == _measurements.size()) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput;
+        }
+        unpack(nextInput.releaseDocument());
+    }
+    return std::move(_measurements[_nextMeasurement++]);
+}
+
+void DocumentSourceInternalUnpackBucket::unpack(const Document& bucket) {
+    _measurements.clear();
+    _nextMeasurement = 0;
+
+    const Value data = bucket[timeseries::kBucketDataFieldName];
+    uassert(50878,
+            str::stream() << "time-series bucket " << bucket["_id"].toString()
+                          << " must have an object as its data",
+            data.getType() == BSONType::Object);
+
+    // Concurrent inserts may add cells to a column out of order, so the measurements are ordered
+    // by their index rather than by the order of the cells.
+    std::map<int, MutableDocument> measurements;
+    FieldIterator columns(data.getDocument());
+    while (columns.more()) {
+        const Document::FieldPair column = columns.next();
+        uassert(50879,
+                str::stream() << "time-series bucket " << bucket["_id"].toString()
+                              << " must have an object as its column for '"
+                              << column.first
+                              << "'",
+                column.second.getType() == BSONType::Object);
+
+        FieldIterator cells(column.second.getDocument());
+        while (cells.more()) {
+            const Document::FieldPair cell = cells.next();
+            int index;
+            uassert(50880,
+                    str::stream() << "time-series bucket " << bucket["_id"].toString()
+                                  << " has an invalid measurement index '"
+                                  << cell.first
+                                  << "'",
+                    parseNumberFromStringWithBase(cell.first, 10, &index).isOK() && index >= 0);
+            measurements[index].addField(column.first, cell.second);
+        }
+    }
+
+    const Value meta = bucket[timeseries::kBucketMetaFieldName];
+    _measurements.reserve(measurements.size());
+    for (auto&& measurement : measurements) {
+        MutableDocument& doc = measurement.second;
+        if (doc.peek()[_options.timeField].missing()) {
+            continue;
+        }
+        if (_options.metaField && !meta.missing()) {
+            doc.addField(*_options.metaField, meta);
+        }
+        _measurements.push_back(doc.freeze());
+    }
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>((*std::next(itr)).get());
+    if (nextMatch && !nextMatch->isTextQuery() && !_pushedDownBucketPredicate) {
+        const BSONObj bucketPredicate = createBucketPredicate(nextMatch->getQuery(), _options);
+        if (!bucketPredicate.isEmpty()) {
+            // The original $match stays after this stage to filter the measurements themselves.
+            // As with $redact, we must not step backwards onto the new $match, or the pipeline
+            // would be optimized forever.
+            _pushedDownBucketPredicate = true;
+            container->insert(itr, DocumentSourceMatch::create(bucketPredicate, pExpCtx));
+        }
+    }
+    return std::next(itr);
+}
+
+Value DocumentSourceInternalUnpackBucket::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(Document{{getSourceName(), Document(_options.toBSON())}});
+}
+
+}  // namespace mongo
@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/timeseries/timeseries_options.h"
+
+namespace mongo {
+
+/**
+ * The first stage of the view that presents a time-series collection: turns each bucket document
+ * of the underlying buckets collection back into the measurements it holds, one document per
+ * measurement. See timeseries_options.h for the layout of a bucket.
+ */
+class DocumentSourceInternalUnpackBucket final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalUnpackBucket"_sd;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    /**
+     * Translates the parts of the $match filter 'query' that apply to the time or meta field of
+     * the measurements into a filter on their buckets, which matches every bucket holding a
+     * measurement that matches 'query'. Returns an empty object if no part of 'query' translates.
+     */
+    static BSONObj createBucketPredicate(const BSONObj& query,
+                                         const timeseries::TimeseriesOptions& options);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kNoDiskUse,
+                FacetRequirement::kAllowed,
+                TransactionRequirement::kAllowed};
+    }
+
+    GetNextResult getNext() final;
+
+    GetDepsReturn getDependencies(DepsTracker* deps) const final {
+        // Each bucket is needed whole, and its measurements share nothing else with it.
+        deps->needWholeDocument = true;
+        return EXHAUSTIVE_ALL;
+    }
+
+    GetModPathsReturn getModifiedPaths() const final {
+        return {GetModPathsReturn::Type::kAllPaths, std::set<std::string>{}, {}};
+    }
+
+    /**
+     * Copies the bucket-level equivalent of a subsequent $match before this stage, so that the
+     * query system can skip the buckets which cannot hold a matching measurement.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+private:
+    DocumentSourceInternalUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       timeseries::TimeseriesOptions options);
+
+    /**
+     * Replaces '_measurements' with the measurements held by 'bucket', in the order they were
+     * inserted.
+     */
+    void unpack(const Document& bucket);
+
+    const timeseries::TimeseriesOptions _options;
+
+    std::vector<Document> _measurements;
+    size_t _nextMeasurement = 0;
+
+    // Whether the bucket predicate of a subsequent $match was already copied before this stage.
+    bool _pushedDownBucketPredicate = false;
+};
+
+}  // namespace mongo
@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using InternalUnpackBucketStageTest = AggregationContextFixture;
+
+const Date_t t0 = Date_t::fromMillisSinceEpoch(1000);
+const Date_t t1 = Date_t::fromMillisSinceEpoch(2000);
+
+boost::intrusive_ptr<DocumentSource> makeUnpackStage(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto spec = BSON("$_internalUnpackBucket" << BSON("timeField"
+                                                      << "t"
+                                                      << "metaField"
+                                                      << "m"));
+    return DocumentSourceInternalUnpackBucket::createFromBson(spec.firstElement(), expCtx);
+}
+
+timeseries::TimeseriesOptions makeOptions() {
+    return uassertStatusOK(timeseries::TimeseriesOptions::parse(BSON("timeField"
+                                                                     << "t"
+                                                                     << "metaField"
+                                                                     << "m")));
+}
+
+TEST_F(InternalUnpackBucketStageTest, UnpacksEachMeasurementInIndexOrder) {
+    auto unpack = makeUnpackStage(getExpCtx());
+    // The cells of column 'x' were added out of order, and measurement 2 has no time.
+    auto bucket = BSON("_id" << 0 << "control" << BSON("version" << 1) << "meta"
+                             << "sensor"
+                             << "data"
+                             << BSON("t" << BSON("0" << t0 << "1" << t1) << "x"
+                                         << BSON("1" << 20 << "0" << 10 << "2" << 30)));
+    auto mock = DocumentSourceMock::create({Document(bucket)});
+    unpack->setSource(mock.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"t", t0}, {"x", 10}, {"m", "sensor"_sd}}));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"t", t1}, {"x", 20}, {"m", "sensor"_sd}}));
+
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(InternalUnpackBucketStageTest, ShouldPropagatePausesAndSkipEmptyBuckets) {
+    auto unpack = makeUnpackStage(getExpCtx());
+    auto mock = DocumentSourceMock::create(
+        {Document(BSON("_id" << 0 << "data" << BSONObj())),
+         DocumentSource::GetNextResult::makePauseExecution(),
+         Document(BSON("_id" << 1 << "data" << BSON("t" << BSON("0" << t0))))});
+    unpack->setSource(mock.get());
+
+    ASSERT_TRUE(unpack->getNext().isPaused());
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    // A bucket without a meta value gives measurements without a meta field.
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"t", t0}}));
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(InternalUnpackBucketStageTest, RejectsMalformedBuckets) {
+    auto unpack = makeUnpackStage(getExpCtx());
+    auto mock = DocumentSourceMock::create({Document(BSON("_id" << 0 << "data" << 1)),
+                                            Document(BSON("_id" << 1 << "data" << BSON("t" << 1))),
+                                            Document(BSON("_id" << 2 << "data"
+                                                                << BSON("t" << BSON("x" << t0))))});
+    unpack->setSource(mock.get());
+
+    ASSERT_THROWS_CODE(unpack->getNext(), AssertionException, 50878);
+    ASSERT_THROWS_CODE(unpack->getNext(), AssertionException, 50879);
+    ASSERT_THROWS_CODE(unpack->getNext(), AssertionException, 50880);
+}
+
+TEST_F(InternalUnpackBucketStageTest, ShouldRejectInvalidSpecs) {
+    auto notObject = BSON("$_internalUnpackBucket" << 1);
+    ASSERT_THROWS_CODE(
+        DocumentSourceInternalUnpackBucket::createFromBson(notObject.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::TypeMismatch);
+
+    auto noTimeField = BSON("$_internalUnpackBucket" << BSONObj());
+    ASSERT_THROWS_CODE(
+        DocumentSourceInternalUnpackBucket::createFromBson(noTimeField.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::InvalidOptions);
+}
+
+TEST_F(InternalUnpackBucketStageTest, TranslatesTimeAndMetaPredicates) {
+    auto query = BSON("t" << BSON("$gte" << t0 << "$lt" << t1) << "m.region"
+                          << "east"
+                          << "x"
+                          << 5);
+    ASSERT_BSONOBJ_EQ(
+        DocumentSourceInternalUnpackBucket::createBucketPredicate(query, makeOptions()),
+        BSON("$and" << BSON_ARRAY(BSON("control.max.t" << BSON("$gte" << t0))
+                                  << BSON("control.min.t" << BSON("$lt" << t1))
+                                  << BSON("meta.region"
+                                          << "east"))));
+
+    query = BSON("$and" << BSON_ARRAY(BSON("t" << t0) << BSON("m" << 1)));
+    ASSERT_BSONOBJ_EQ(
+        DocumentSourceInternalUnpackBucket::createBucketPredicate(query, makeOptions()),
+        BSON("$and" << BSON_ARRAY(BSON("control.min.t" << BSON("$lte" << t0))
+                                  << BSON("control.max.t" << BSON("$gte" << t0))
+                                  << BSON("meta" << 1))));
+}
+
+TEST_F(InternalUnpackBucketStageTest, IgnoresPredicatesThatDoNotTranslate) {
+    // Neither a non-date time bound nor a field that merely starts with the meta field's name
+    // says anything about the buckets.
+    auto query = fromjson("{t: {$gt: 5}, mx: 1, x: 1, $or: [{m: 1}, {m: 2}]}");
+    ASSERT_BSONOBJ_EQ(
+        DocumentSourceInternalUnpackBucket::createBucketPredicate(query, makeOptions()),
+        BSONObj());
+}
+
+TEST_F(InternalUnpackBucketStageTest, CopiesBucketPredicateBeforeItselfOnce) {
+    Pipeline::SourceContainer pipeline;
+    pipeline.push_back(makeUnpackStage(getExpCtx()));
+    pipeline.push_back(DocumentSourceMatch::create(BSON("m" << 1 << "x" << 2), getExpCtx()));
+
+    auto unpackItr = pipeline.begin();
+    (*unpackItr)->optimizeAt(unpackItr, &pipeline);
+    ASSERT_EQUALS(pipeline.size(), 3U);
+    auto bucketMatch = dynamic_cast<DocumentSourceMatch*>(pipeline.front().get());
+    ASSERT(bucketMatch);
+    ASSERT_BSONOBJ_EQ(bucketMatch->getQuery(), fromjson("{$and: [{meta: 1}]}"));
+
+    (*unpackItr)->optimizeAt(unpackItr, &pipeline);
+    ASSERT_EQUALS(pipeline.size(), 3U);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,9 +30,13 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/path_internal.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
@@ -66,6 +70,7 @@ std::string pipelineToString(const vector<BSONObj>& pipeline) {
 }  // namespace
 
 constexpr size_t DocumentSourceLookUp::kMaxSubPipelineDepth;
+constexpr StringData DocumentSourceLookUp::kShardLocalFieldName;
 
 DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
                                            std::string as,
@@ -99,6 +104,19 @@ DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
     // we'll eventually construct from the input document.
     _resolvedPipeline.reserve(_resolvedPipeline.size() + 1);
     _resolvedPipeline.push_back(BSONObj());
+
+    // Positional path components are matched against both array indexes and field names by the
+    // query system, so only paths without them can be answered from a table keyed on the values
+    // found at '_foreignField'.
+    _canProbeForeignValues = true;
+    for (size_t i = 0; i < _foreignField->getPathLength(); ++i) {
+        if (isAllDigits(_foreignField->getFieldName(i))) {
+            _canProbeForeignValues = false;
+        }
+    }
+    if (internalDocumentSourceLookupHashJoinMaxSizeBytes.load() > 0 && _canProbeForeignValues) {
+        _hashJoinState = HashJoinState::kUnbuilt;
+    }
 }
 
 DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
@@ -210,7 +228,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
-    auto nextInput = pSource->getNext();
+    boost::optional<std::vector<Document>> matches;
+    auto nextInput = getNextInput(&matches);
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
@@ -221,29 +240,33 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
-    }
-
-    auto pipeline = buildPipeline(inputDoc);
-
     std::vector<Value> results;
     int objsize = 0;
 
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    auto appendResult = [&](Document result) {
+        objsize += result.getApproximateSize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline "
                               << getUserPipelineDefinition()
                               << " exceeds maximum document size",
                 objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
+        results.emplace_back(std::move(result));
+    };
+
+    if (matches) {
+        for (auto&& result : *matches) {
+            appendResult(std::move(result));
+        }
+    } else {
+        auto pipeline = buildPipeline(inputDoc);
+        while (auto result = pipeline->getNext()) {
+            appendResult(std::move(*result));
+        }
     }
 
+    noteMemUsage(objsize + (_cache ? _cache->sizeBytes() : 0));
+
     MutableDocument output(std::move(inputDoc));
     output.setNestedField(_as, Value(std::move(results)));
     return output.freeze();
@@ -433,6 +456,12 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashJoinState = HashJoinState::kDisabled;
+    _precomputedMatches = boost::none;
+    _hashJoinTable = boost::none;
+    _hashJoinDocs.clear();
+    _bufferedInputs.clear();
+    _bufferedInputsEnd = boost::none;
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -525,35 +554,33 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
-        auto nextInput = pSource->getNext();
+    while (!_nextValue) {
+        auto nextInput = getNextInput(&_precomputedMatches);
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
 
         _input = nextInput.releaseDocument();
-
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
+        noteMemUsage(_cache ? _cache->sizeBytes() : 0);
 
         if (_pipeline) {
             _pipeline->dispose(pExpCtx->opCtx);
+            _pipeline.reset();
         }
 
-        _pipeline = buildPipeline(*_input);
+        if (_precomputedMatches) {
+            _precomputedMatchesIndex = 0;
+        } else {
+            _pipeline = buildPipeline(*_input);
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = getNextUnwindMatch();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -571,7 +598,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = getNextUnwindMatch();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -585,6 +612,245 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+boost::optional<Document> DocumentSourceLookUp::getNextUnwindMatch() {
+    if (_precomputedMatches) {
+        if (_precomputedMatchesIndex == _precomputedMatches->size()) {
+            return boost::none;
+        }
+        return std::move((*_precomputedMatches)[_precomputedMatchesIndex++]);
+    }
+    return _pipeline->getNext();
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextInput(
+    boost::optional<std::vector<Document>>* matches) {
+    *matches = boost::none;
+    if (wasConstructedWithPipelineSyntax()) {
+        return pSource->getNext();
+    }
+
+    if (_bufferedInputs.empty() && !_bufferedInputsEnd) {
+        bufferInputs();
+    }
+
+    if (_bufferedInputs.empty()) {
+        invariant(_bufferedInputsEnd);
+        auto end = std::move(*_bufferedInputsEnd);
+        _bufferedInputsEnd = boost::none;
+        return end;
+    }
+
+    auto& next = _bufferedInputs.front();
+    // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+    _resolvedPipeline.back() = std::move(next.matchStage);
+    *matches = std::move(next.matches);
+    Document inputDoc = std::move(next.doc);
+    _bufferedInputs.pop_front();
+    return std::move(inputDoc);
+}
+
+void DocumentSourceLookUp::bufferInputs() {
+    const BSONObj filter = _additionalFilter.value_or(BSONObj());
+    const size_t batchSize = std::max(1, internalDocumentSourceLookupBatchSize.load());
+
+    std::vector<size_t> unmatched;
+    while (_bufferedInputs.size() < batchSize) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            _bufferedInputsEnd = std::move(nextInput);
+            break;
+        }
+
+        BufferedInput input;
+        input.doc = nextInput.releaseDocument();
+        input.matchStage =
+            makeMatchStageFromInput(input.doc, *_localField, _foreignField->fullPath(), filter);
+        input.matches = hashJoinLookup(input.doc, input.matchStage);
+        if (!input.matches) {
+            unmatched.push_back(_bufferedInputs.size());
+        }
+        _bufferedInputs.push_back(std::move(input));
+    }
+
+    if (unmatched.size() > 1 && _canProbeForeignValues) {
+        batchLookup(unmatched, filter);
+    }
+}
+
+void DocumentSourceLookUp::batchLookup(const std::vector<size_t>& positions,
+                                       const BSONObj& filter) {
+    // Gather the distinct local values of every buffered document the table can answer for,
+    // keeping the $in list well clear of the maximum BSON size.
+    auto seen = _fromExpCtx->getValueComparator().makeUnorderedValueSet();
+    BSONArrayBuilder values;
+    std::vector<size_t> batched;
+    std::vector<Value> probeValues;
+    for (auto position : positions) {
+        if (values.len() > BSONObjMaxUserSize / 2) {
+            break;
+        }
+        if (!getProbeValues(_bufferedInputs[position].doc, &probeValues)) {
+            continue;
+        }
+        for (auto&& value : probeValues) {
+            if (seen.insert(value).second) {
+                values << value;
+            }
+        }
+        batched.push_back(position);
+    }
+
+    if (batched.size() < 2) {
+        return;
+    }
+
+    // Run the view pipeline, if any, followed by a single $match for all of the gathered values.
+    std::vector<BSONObj> batchPipeline(_resolvedPipeline.begin(), _resolvedPipeline.end() - 1);
+    batchPipeline.push_back(BSON(
+        "$match" << BSON("$and" << BSON_ARRAY(
+                             BSON(_foreignField->fullPath() << BSON("$in" << values.arr()))
+                             << filter))));
+    copyVariablesToExpCtx(_variables, _variablesParseState, _fromExpCtx.get());
+    auto pipeline =
+        uassertStatusOK(pExpCtx->mongoProcessInterface->makePipeline(batchPipeline, _fromExpCtx));
+
+    // If the combined results do not fit, each document is looked up on its own.
+    std::vector<BSONObj> docs;
+    auto table = _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    if (!indexForeignDocuments(
+            pipeline.get(), internalDocumentSourceLookupCacheSizeBytes.load(), &docs, &table)) {
+        return;
+    }
+
+    for (auto position : batched) {
+        auto& input = _bufferedInputs[position];
+        input.matches = probeForeignDocuments(docs, table, input.doc, input.matchStage);
+        invariant(input.matches);
+    }
+}
+
+bool DocumentSourceLookUp::indexForeignDocuments(Pipeline* pipeline,
+                                                 size_t maxSizeBytes,
+                                                 std::vector<BSONObj>* docs,
+                                                 ValueUnorderedMap<std::vector<size_t>>* table) {
+    size_t sizeBytes = 0;
+    while (auto next = pipeline->getNext()) {
+        const size_t docIndex = docs->size();
+        docs->push_back(next->toBson());
+        sizeBytes += docs->back().objsize();
+
+        // If an array at the path holds duplicate values, the document is listed only once.
+        document_path_support::visitAllValuesAtPath(
+            Document(docs->back()), *_foreignField, [&](const Value& value) {
+                auto& bucket = (*table)[value];
+                if (bucket.empty() || bucket.back() != docIndex) {
+                    bucket.push_back(docIndex);
+                    sizeBytes += sizeof(size_t) + value.getApproximateSize();
+                }
+            });
+        noteMemUsage(sizeBytes);
+
+        if (sizeBytes > maxSizeBytes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DocumentSourceLookUp::getProbeValues(const Document& inputDoc, std::vector<Value>* values) {
+    // Null and missing values also join with documents which lack the foreign field, regular
+    // expressions may be compared as patterns, and nested arrays may match whole arrays, none of
+    // which a table of the values at '_foreignField' records.
+    values->clear();
+    bool canProbe = true;
+    document_path_support::visitAllValuesAtPath(inputDoc, *_localField, [&](const Value& value) {
+        if (value.nullish() || value.isArray() || value.getType() == BSONType::RegEx) {
+            canProbe = false;
+        }
+        values->push_back(value);
+    });
+    return canProbe && !values->empty();
+}
+
+boost::optional<std::vector<Document>> DocumentSourceLookUp::probeForeignDocuments(
+    const std::vector<BSONObj>& docs,
+    const ValueUnorderedMap<std::vector<size_t>>& table,
+    const Document& inputDoc,
+    const BSONObj& matchStage) {
+    std::vector<Value> probeValues;
+    if (!getProbeValues(inputDoc, &probeValues)) {
+        return boost::none;
+    }
+
+    // Gather the foreign documents holding any of the local values, in the order they were
+    // scanned and without duplicates.
+    std::vector<size_t> candidates;
+    for (auto&& value : probeValues) {
+        auto it = table.find(value);
+        if (it != table.end()) {
+            candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<Document> results;
+    if (candidates.empty()) {
+        return results;
+    }
+
+    // Every candidate is checked against the query the nested loop would have issued, which also
+    // applies any filter absorbed from a following $match.
+    auto matcher = uassertStatusOK(MatchExpressionParser::parse(
+        matchStage.firstElement().embeddedObject(), _fromExpCtx));
+
+    for (auto docIndex : candidates) {
+        const auto& doc = docs[docIndex];
+        if (matcher->matchesBSON(doc)) {
+            results.emplace_back(doc);
+        }
+    }
+    return results;
+}
+
+void DocumentSourceLookUp::buildHashJoinTable() {
+    invariant(_hashJoinState == HashJoinState::kUnbuilt);
+
+    // Unless the whole foreign namespace fits within the limit, we stay with the nested loop.
+    _hashJoinState = HashJoinState::kDisabled;
+
+    // Scan the foreign namespace through any view pipeline, leaving out the placeholder for the
+    // per-document $match at the end of '_resolvedPipeline'.
+    std::vector<BSONObj> scanPipeline(_resolvedPipeline.begin(), _resolvedPipeline.end() - 1);
+    copyVariablesToExpCtx(_variables, _variablesParseState, _fromExpCtx.get());
+    auto pipeline =
+        uassertStatusOK(pExpCtx->mongoProcessInterface->makePipeline(scanPipeline, _fromExpCtx));
+
+    std::vector<BSONObj> docs;
+    auto table = _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    if (!indexForeignDocuments(pipeline.get(),
+                               internalDocumentSourceLookupHashJoinMaxSizeBytes.load(),
+                               &docs,
+                               &table)) {
+        return;
+    }
+
+    _hashJoinDocs = std::move(docs);
+    _hashJoinTable = std::move(table);
+    _hashJoinState = HashJoinState::kBuilt;
+}
+
+boost::optional<std::vector<Document>> DocumentSourceLookUp::hashJoinLookup(
+    const Document& inputDoc, const BSONObj& matchStage) {
+    if (_hashJoinState == HashJoinState::kUnbuilt) {
+        buildHashJoinTable();
+    }
+    if (_hashJoinState != HashJoinState::kBuilt) {
+        return boost::none;
+    }
+    return probeForeignDocuments(_hashJoinDocs, *_hashJoinTable, inputDoc, matchStage);
+}
+
 void DocumentSourceLookUp::copyVariablesToExpCtx(const Variables& vars,
                                                  const VariablesParseState& vps,
                                                  ExpressionContext* expCtx) {
@@ -643,6 +909,9 @@ void DocumentSourceLookUp::serializeToArray(
     }
 
     MutableDocument output(doc);
+    if (_shardLocal) {
+        output[getSourceName()][kShardLocalFieldName] = Value(true);
+    }
     if (explain) {
         if (_unwindSrc) {
             const boost::optional<FieldPath> indexPath = _unwindSrc->indexPath();
@@ -662,7 +931,7 @@ void DocumentSourceLookUp::serializeToArray(
             output[getSourceName()]["matching"] = Value(*_additionalFilter);
         }
 
-        array.push_back(Value(output.freeze()));
+        array.push_back(addMemoryStatsForExplain(Value(output.freeze()), explain));
     } else {
         array.push_back(Value(output.freeze()));
 
@@ -747,6 +1016,7 @@ intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
     std::vector<BSONObj> pipeline;
     bool hasPipeline = false;
     bool hasLet = false;
+    bool shardLocal = false;
 
     for (auto&& argument : elem.Obj()) {
         const auto argName = argument.fieldNameStringData();
@@ -774,6 +1044,16 @@ intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
             continue;
         }
 
+        if (argName == kShardLocalFieldName && pExpCtx->fromMongos) {
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << "$lookup argument '" << argument
+                                  << "' must be a boolean, is type "
+                                  << argument.type(),
+                    argument.type() == BSONType::Bool);
+            shardLocal = argument.Bool();
+            continue;
+        }
+
         uassert(ErrorCodes::FailedToParse,
                 str::stream() << "$lookup argument '" << argument << "' must be a string, is type "
                               << argument.type(),
@@ -816,11 +1096,16 @@ intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
                 "$lookup with a 'let' argument must also specify 'pipeline'",
                 !hasLet);
 
-        return new DocumentSourceLookUp(std::move(fromNs),
-                                        std::move(as),
-                                        std::move(localField),
-                                        std::move(foreignField),
-                                        pExpCtx);
+        intrusive_ptr<DocumentSourceLookUp> lookup(
+            new DocumentSourceLookUp(std::move(fromNs),
+                                     std::move(as),
+                                     std::move(localField),
+                                     std::move(foreignField),
+                                     pExpCtx));
+        if (shardLocal) {
+            lookup->setShardLocal();
+        }
+        return lookup;
     }
 }
 }
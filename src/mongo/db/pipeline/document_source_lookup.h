@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -91,11 +92,19 @@ public:
         std::vector<Value>& array,
         boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    boost::optional<StageMemoryStats> getMemoryStats() const final {
+        StageMemoryStats memoryStats;
+        memoryStats.peakMemUsage = _peakMemUsageBytes;
+        return memoryStats;
+    }
+
     /**
      * Returns the 'as' path, and possibly fields modified by an absorbed $unwind.
      */
     GetModPathsReturn getModifiedPaths() const final;
 
+    static constexpr StringData kShardLocalFieldName = "$shardLocal"_sd;
+
     StageConstraints constraints(Pipeline::SplitState pipeState) const final {
         const bool mayUseDisk = wasConstructedWithPipelineSyntax() &&
             std::any_of(_parsedIntrospectionPipeline->getSources().begin(),
@@ -105,9 +114,12 @@ public:
                                 DiskUseRequirement::kWritesTmpData;
                         });
 
+        // A shard-local $lookup runs on every shard holding documents, but any other must run where
+        // the unsharded 'from' collection lives.
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
-                                     HostTypeRequirement::kPrimaryShard,
+                                     _shardLocal ? HostTypeRequirement::kAnyShard
+                                                 : HostTypeRequirement::kPrimaryShard,
                                      mayUseDisk ? DiskUseRequirement::kWritesTmpData
                                                 : DiskUseRequirement::kNoDiskUse,
                                      FacetRequirement::kAllowed,
@@ -175,6 +187,38 @@ public:
         return !static_cast<bool>(_localField);
     }
 
+    const NamespaceString& getFromNs() const {
+        return _fromNs;
+    }
+
+    /**
+     * Returns the local and foreign fields of a $lookup constructed with localField/foreignField
+     * syntax.
+     */
+    const FieldPath& getLocalField() const {
+        return *_localField;
+    }
+
+    const FieldPath& getForeignField() const {
+        return *_foreignField;
+    }
+
+    /**
+     * Makes this $lookup run on the shards, each joining its own documents with its own part of
+     * the sharded 'from' collection. Only valid for localField/foreignField syntax when the two
+     * collections are co-located on the joined fields, as decided on mongoS by
+     * cluster_aggregation_planner::markShardLocalLookups().
+     */
+    void setShardLocal() {
+        invariant(!wasConstructedWithPipelineSyntax());
+        _shardLocal = true;
+        _fromExpCtx->colocatedWithNss = pExpCtx->ns;
+    }
+
+    bool isShardLocal() const {
+        return _shardLocal;
+    }
+
     const Variables& getVariables_forTest() {
         return _variables;
     }
@@ -244,6 +288,77 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns the next foreign document joined with '_input' when an $unwind has been absorbed,
+     * drawing from either '_precomputedMatches' or '_pipeline'.
+     */
+    boost::optional<Document> getNextUnwindMatch();
+
+    /**
+     * Returns the next result from the source stage. For localField/foreignField syntax, this also
+     * installs the document's $match in '_resolvedPipeline', and sets 'matches' to the foreign
+     * documents it joins with if they were already found by the hash join or a batched lookup.
+     * Otherwise 'matches' is left empty, and the caller must query the foreign namespace.
+     */
+    GetNextResult getNextInput(boost::optional<std::vector<Document>>* matches);
+
+    /**
+     * Reads up to 'internalDocumentSourceLookupBatchSize' documents from the source stage into
+     * '_bufferedInputs', stopping early at the first result which is not a document, and then
+     * finds their matches with a single batched lookup where possible.
+     */
+    void bufferInputs();
+
+    /**
+     * Looks up all of the buffered documents at 'positions' in '_bufferedInputs' with a single
+     * query for the distinct values of their local fields, distributing the foreign documents
+     * found among them. Documents which cannot be answered this way, or whose combined matches
+     * exceed 'internalDocumentSourceLookupCacheSizeBytes', are left to be looked up on their own.
+     */
+    void batchLookup(const std::vector<size_t>& positions, const BSONObj& filter);
+
+    /**
+     * Appends the documents returned by 'pipeline' to 'docs', indexing each one in 'table' by the
+     * values at '_foreignField'. Returns false if they exceed 'maxSizeBytes'.
+     */
+    bool indexForeignDocuments(Pipeline* pipeline,
+                               size_t maxSizeBytes,
+                               std::vector<BSONObj>* docs,
+                               ValueUnorderedMap<std::vector<size_t>>* table);
+
+    /**
+     * Fills 'values' with the values at '_localField' of 'inputDoc'. Returns false if the lookup
+     * for 'inputDoc' cannot be answered by probing a table built by indexForeignDocuments().
+     */
+    bool getProbeValues(const Document& inputDoc, std::vector<Value>* values);
+
+    /**
+     * Returns the documents among 'docs' matching 'matchStage', as built by
+     * makeMatchStageFromInput() for 'inputDoc', by probing 'table'. Returns boost::none if
+     * getProbeValues() rejects 'inputDoc'.
+     */
+    boost::optional<std::vector<Document>> probeForeignDocuments(
+        const std::vector<BSONObj>& docs,
+        const ValueUnorderedMap<std::vector<size_t>>& table,
+        const Document& inputDoc,
+        const BSONObj& matchStage);
+
+    /**
+     * Scans the foreign namespace once, through any view pipeline, and indexes each document by
+     * the values at '_foreignField'. If the documents exceed
+     * 'internalDocumentSourceLookupHashJoinMaxSizeBytes', the table is discarded and the nested
+     * loop strategy is used for the rest of the query.
+     */
+    void buildHashJoinTable();
+
+    /**
+     * Returns the foreign documents matching 'matchStage', as built by makeMatchStageFromInput()
+     * for 'inputDoc', using the hash join table. Returns boost::none if the table is unavailable or
+     * cannot answer this lookup, in which case the caller must query the foreign namespace instead.
+     */
+    boost::optional<std::vector<Document>> hashJoinLookup(const Document& inputDoc,
+                                                          const BSONObj& matchStage);
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -280,6 +395,13 @@ private:
      * with pipeline syntax, the cache has not been frozen or abandoned, and no data has been added
      * to it.
      */
+    /**
+     * Raises '_peakMemUsageBytes' to 'bytes' if it is lower.
+     */
+    void noteMemUsage(size_t bytes) {
+        _peakMemUsageBytes = std::max(_peakMemUsageBytes, static_cast<long long>(bytes));
+    }
+
     void reInitializeCache(size_t maxCacheSizeBytes) {
         invariant(wasConstructedWithPipelineSyntax());
         invariant(!_cache || (_cache->isBuilding() && _cache->sizeBytes() == 0));
@@ -295,6 +417,10 @@ private:
     boost::optional<FieldPath> _localField;
     boost::optional<FieldPath> _foreignField;
 
+    // Whether this $lookup joins each shard's documents with the same shard's part of a sharded,
+    // co-located 'from' collection. See setShardLocal().
+    bool _shardLocal = false;
+
     // Holds 'let' defined variables defined both in this stage and in parent pipelines. These are
     // copied to the '_fromExpCtx' ExpressionContext's 'variables' and 'variablesParseState' for use
     // in foreign pipeline execution.
@@ -307,6 +433,10 @@ private:
     // from a cursor source.
     boost::optional<SequentialDocumentCache> _cache;
 
+    // The most memory held at once by the foreign documents indexed for a hash join or batched
+    // lookup, or by the cache together with the matches gathered for a single input document.
+    long long _peakMemUsageBytes = 0;
+
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
     // namespace.
     boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
@@ -323,6 +453,16 @@ private:
 
     std::vector<LetVariable> _letVariables;
 
+    // State of the hash join used in place of per-document queries for localField/foreignField
+    // syntax, when enabled. '_hashJoinDocs' holds every foreign document, and '_hashJoinTable'
+    // maps each value at '_foreignField' to the positions in '_hashJoinDocs' holding it. Neither
+    // the hash join nor batched lookups are used unless '_canProbeForeignValues' is set.
+    enum class HashJoinState { kDisabled, kUnbuilt, kBuilt };
+    bool _canProbeForeignValues = false;
+    HashJoinState _hashJoinState = HashJoinState::kDisabled;
+    std::vector<BSONObj> _hashJoinDocs;
+    boost::optional<ValueUnorderedMap<std::vector<size_t>>> _hashJoinTable;
+
     boost::intrusive_ptr<DocumentSourceMatch> _matchSrc;
     boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
 
@@ -332,6 +472,21 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+    // Holds the matches for '_input' in place of '_pipeline' when they were found by the hash join
+    // or a batched lookup.
+    boost::optional<std::vector<Document>> _precomputedMatches;
+    size_t _precomputedMatchesIndex = 0;
+
+    // Source documents read ahead for localField/foreignField syntax, each with the $match used to
+    // look it up and its matches if already found. '_bufferedInputsEnd' holds the non-document
+    // result which ended the last read, to be returned once the buffered documents are consumed.
+    struct BufferedInput {
+        Document doc;
+        BSONObj matchStage;
+        boost::optional<std::vector<Document>> matches;
+    };
+    std::deque<BufferedInput> _bufferedInputs;
+    boost::optional<GetNextResult> _bufferedInputsEnd;
 };
 
 }  // namespace mongo
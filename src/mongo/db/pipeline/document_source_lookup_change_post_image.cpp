@@ -30,7 +30,13 @@
 
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
+#include <algorithm>
+#include <tuple>
+
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -53,24 +59,156 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
             val.getType() == expectedType);
     return val;
 }
+
+/**
+ * Returns the document among 'lookedUpDocs' whose fields match every field of 'documentKey', or
+ * boost::none if there is none. Throws if more than one matches.
+ */
+boost::optional<Document> findByDocumentKey(const Document& documentKey,
+                                            const std::vector<Document>& lookedUpDocs) {
+    boost::optional<Document> match;
+    for (auto&& doc : lookedUpDocs) {
+        bool matches = true;
+        for (auto fields = documentKey.fieldIterator(); matches && fields.more();) {
+            auto field = fields.next();
+            matches = ValueComparator().evaluate(doc.getNestedField(FieldPath(field.first)) ==
+                                                 field.second);
+        }
+        if (!matches) {
+            continue;
+        }
+        uassert(ErrorCodes::TooManyMatchingDocuments,
+                str::stream() << "found more than one document with document key "
+                              << documentKey.toString()
+                              << " ["
+                              << match->toString()
+                              << ", "
+                              << doc.toString()
+                              << "]",
+                !match);
+        match = doc;
+    }
+    return match;
+}
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNext() {
     pExpCtx->checkForInterrupt();
 
-    auto input = pSource->getNext();
-    if (!input.isAdvanced()) {
-        return input;
+    if (_bufferedInputs.empty() && !_bufferedInputsEnd) {
+        bufferInputs();
     }
-    auto opTypeVal = assertFieldHasType(
-        input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
-    if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
-        return input;
+    if (!_bufferedInputs.empty()) {
+        auto next = std::move(_bufferedInputs.front());
+        _bufferedInputs.pop_front();
+        return next;
     }
 
-    MutableDocument output(input.releaseDocument());
-    output[kFullDocumentFieldName] = lookupPostImage(output.peek());
-    return output.freeze();
+    auto end = std::move(*_bufferedInputsEnd);
+    _bufferedInputsEnd = boost::none;
+    return end;
+}
+
+void DocumentSourceLookupChangePostImage::bufferInputs() {
+    const size_t batchSize = std::max(1, internalChangeStreamPostImageLookupBatchSize.load());
+
+    // Only the first read may wait for input. Reading further ahead takes just what is ready, so
+    // that the events already read are not held back waiting for more.
+    ON_BLOCK_EXIT([this] { pExpCtx->prefetchingInput = false; });
+
+    // The positions in '_bufferedInputs' of the update events, grouped by collection.
+    std::vector<std::tuple<NamespaceString, UUID, std::vector<size_t>>> updatesByCollection;
+    while (_bufferedInputs.size() < batchSize) {
+        pExpCtx->prefetchingInput = !_bufferedInputs.empty();
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            _bufferedInputsEnd = std::move(nextInput);
+            break;
+        }
+
+        const auto opType = assertFieldHasType(nextInput.getDocument(),
+                                               DocumentSourceChangeStream::kOperationTypeField,
+                                               BSONType::String)
+                                .getString();
+        if (opType == DocumentSourceChangeStream::kUpdateOpType) {
+            auto nss = assertValidNamespace(nextInput.getDocument());
+            auto resumeToken = ResumeToken::parse(
+                nextInput.getDocument()[DocumentSourceChangeStream::kIdField].getDocument());
+            invariant(resumeToken.getData().uuid);
+            const auto& uuid = *resumeToken.getData().uuid;
+
+            auto group = std::find_if(updatesByCollection.begin(),
+                                      updatesByCollection.end(),
+                                      [&](const auto& entry) {
+                                          return std::get<0>(entry) == nss &&
+                                              std::get<1>(entry) == uuid;
+                                      });
+            if (group == updatesByCollection.end()) {
+                group = updatesByCollection.emplace(
+                    updatesByCollection.end(), nss, uuid, std::vector<size_t>{});
+            }
+            std::get<2>(*group).push_back(_bufferedInputs.size());
+        }
+        _bufferedInputs.push_back(nextInput.releaseDocument());
+
+        if (opType == DocumentSourceChangeStream::kInvalidateOpType) {
+            break;
+        }
+    }
+
+    for (auto&& group : updatesByCollection) {
+        batchLookupPostImages(std::get<0>(group), std::get<1>(group), std::get<2>(group));
+    }
+}
+
+void DocumentSourceLookupChangePostImage::batchLookupPostImages(
+    const NamespaceString& nss, const UUID& uuid, const std::vector<size_t>& positions) {
+    // Gather the document keys to look up together, keeping the query well clear of the maximum
+    // BSON size. The lookup reads at or after the latest of the updates, which every post-image
+    // requires.
+    std::vector<Document> documentKeys;
+    Timestamp clusterTime;
+    int keyBytes = 0;
+    for (auto position : positions) {
+        if (keyBytes > BSONObjMaxUserSize / 2) {
+            break;
+        }
+        const auto& updateOp = _bufferedInputs[position];
+        documentKeys.push_back(assertFieldHasType(updateOp,
+                                                  DocumentSourceChangeStream::kDocumentKeyField,
+                                                  BSONType::Object)
+                                   .getDocument());
+        keyBytes += documentKeys.back().getApproximateSize();
+        auto resumeToken =
+            ResumeToken::parse(updateOp[DocumentSourceChangeStream::kIdField].getDocument());
+        clusterTime = std::max(clusterTime, resumeToken.getData().clusterTime);
+    }
+
+    std::vector<Document> lookedUpDocs;
+    if (documentKeys.size() > 1) {
+        const auto readConcern = pExpCtx->inMongos
+            ? boost::optional<BSONObj>(BSON("level"
+                                            << "majority"
+                                            << "afterClusterTime"
+                                            << clusterTime))
+            : boost::none;
+        lookedUpDocs = pExpCtx->mongoProcessInterface->lookupDocuments(
+            pExpCtx, nss, uuid, documentKeys, readConcern);
+    } else {
+        // A lone update gains nothing from a batch.
+        documentKeys.clear();
+    }
+
+    for (size_t i = 0; i < positions.size(); ++i) {
+        MutableDocument output(std::move(_bufferedInputs[positions[i]]));
+        boost::optional<Document> postImage;
+        if (i < documentKeys.size()) {
+            postImage = findByDocumentKey(documentKeys[i], lookedUpDocs);
+        }
+        output[kFullDocumentFieldName] =
+            postImage ? Value(*postImage) : lookupPostImage(output.peek());
+        _bufferedInputs[positions[i]] = output.freeze();
+    }
 }
 
 NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
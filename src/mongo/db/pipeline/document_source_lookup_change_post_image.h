@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include <deque>
+#include <vector>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -35,7 +38,9 @@ namespace mongo {
 
 /**
  * Part of the change stream API machinery used to look up the post-image of a document. Uses
- * the "documentKey" field of the input to look up the new version of the document.
+ * the "documentKey" field of the input to look up the new version of the document. Events which
+ * are already available are read ahead so that the post-images of their updates can be looked up
+ * together, one query per collection.
  *
  * Uses the ExpressionContext to determine what collection to look up into.
  * TODO SERVER-29134 When we allow change streams on multiple collections, this will need to change.
@@ -109,6 +114,24 @@ private:
     DocumentSourceLookupChangePostImage(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : DocumentSource(expCtx) {}
 
+    /**
+     * Reads up to 'internalChangeStreamPostImageLookupBatchSize' events into '_bufferedInputs',
+     * waiting only for the first, and fills in the post-images of the update events among them.
+     * Stops early at the first result which is not a document, or after an invalidate, since a
+     * change stream must not read past its invalidate.
+     */
+    void bufferInputs();
+
+    /**
+     * Looks up the post-images of the update events at 'positions' in '_bufferedInputs', all on
+     * the collection 'nss' with UUID 'uuid', with a single batched lookup. Events left without a
+     * match are looked up on their own, since the document may have been deleted or may not have
+     * fit in the batch.
+     */
+    void batchLookupPostImages(const NamespaceString& nss,
+                               const UUID& uuid,
+                               const std::vector<size_t>& positions);
+
     /**
      * Uses the "documentKey" field from 'updateOp' to look up the current version of the document.
      * Returns Value(BSONNULL) if the document couldn't be found.
@@ -121,6 +144,12 @@ private:
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // Events read ahead, with the post-images of any updates already filled in.
+    // '_bufferedInputsEnd' holds the non-document result which ended the last read, to be returned
+    // once the buffered events are consumed.
+    std::deque<Document> _bufferedInputs;
+    boost::optional<GetNextResult> _bufferedInputsEnd;
 };
 
 }  // namespace mongo
@@ -143,6 +143,29 @@ public:
         return lookedUpDocument;
     }
 
+    std::vector<Document> lookupDocuments(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                          const NamespaceString& nss,
+                                          UUID collectionUUID,
+                                          const std::vector<Document>& documentKeys,
+                                          boost::optional<BSONObj> readConcern) final {
+        ++numBatchedLookups;
+        auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID, boost::none);
+        BSONArrayBuilder keys;
+        for (auto&& documentKey : documentKeys) {
+            keys.append(documentKey.toBson());
+        }
+        auto pipeline = uassertStatusOK(
+            makePipeline({BSON("$match" << BSON("$or" << keys.arr()))}, foreignExpCtx));
+
+        std::vector<Document> lookedUpDocuments;
+        while (auto next = pipeline->getNext()) {
+            lookedUpDocuments.push_back(std::move(*next));
+        }
+        return lookedUpDocuments;
+    }
+
+    int numBatchedLookups = 0;
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
 };
@@ -393,5 +416,98 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldBatchLookupsOfBufferedUpdates) {
+    auto expCtx = getExpCtx();
+
+    // Set up the lookup change post image stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with updates around an insert, one of them to a document since deleted.
+    auto ns = Document{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto makeUpdate = [&](int id) {
+        return Document{{"_id", makeResumeToken(id)},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", "update"_sd},
+                        {"ns", ns}};
+    };
+    auto mockLocalSource =
+        DocumentSourceMock::create({makeUpdate(1),
+                                    Document{{"_id", makeResumeToken(2)},
+                                             {"documentKey", Document{{"_id", 2}}},
+                                             {"operationType", "insert"_sd},
+                                             {"ns", ns},
+                                             {"fullDocument", Document{{"_id", 2}}}},
+                                    makeUpdate(3),
+                                    makeUpdate(0)});
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection, without the document with _id 3.
+    auto mockMongoInterface = std::make_shared<MockMongoInterface>(
+        deque<DocumentSource::GetNextResult>{Document{{"_id", 0}, {"x", 0}},
+                                             Document{{"_id", 1}, {"x", 1}},
+                                             Document{{"_id", 2}, {"x", 2}}});
+    expCtx->mongoProcessInterface = mockMongoInterface;
+
+    // The events are returned in order, with the post-images found by one lookup.
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 1}, {"x", 1}}));
+    ASSERT_EQ(1, mockMongoInterface->numBatchedLookups);
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["operationType"], Value("insert"_sd));
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 2}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["documentKey"], Value(Document{{"_id", 3}}));
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(BSONNULL));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 0}, {"x", 0}}));
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+    ASSERT_EQ(1, mockMongoInterface->numBatchedLookups);
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldNotReadPastInvalidate) {
+    auto expCtx = getExpCtx();
+
+    // Set up the lookup change post image stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with an invalidate followed by an event which must not be read.
+    auto ns = Document{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto makeUpdate = [&](int id) {
+        return Document{{"_id", makeResumeToken(id)},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", "update"_sd},
+                        {"ns", ns}};
+    };
+    auto mockLocalSource = DocumentSourceMock::create(
+        {makeUpdate(0),
+         Document{{"_id", makeResumeToken()}, {"operationType", "invalidate"_sd}},
+         makeUpdate(1)});
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection.
+    getExpCtx()->mongoProcessInterface = stdx::make_unique<MockMongoInterface>(
+        deque<DocumentSource::GetNextResult>{Document{{"_id", 0}}, Document{{"_id", 1}}});
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 0}}));
+    ASSERT_EQ(1u, mockLocalSource->queue.size());
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["operationType"], Value("invalidate"_sd));
+    ASSERT_EQ(1u, mockLocalSource->queue.size());
+}
+
 }  // namespace
 }  // namespace mongo
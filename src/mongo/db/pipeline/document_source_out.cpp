@@ -31,6 +31,7 @@
 #include "mongo/db/pipeline/document_source_out.h"
 
 #include "mongo/db/ops/write_ops.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/destructor_guard.h"
 
@@ -123,11 +124,20 @@ void DocumentSourceOut::initialize() {
     }
 
     // copy indexes to _tempNs
+    const bool deferIndexBuilds = internalQueryOutDeferIndexBuilds.load();
     for (std::list<BSONObj>::const_iterator it = _originalIndexes.begin();
          it != _originalIndexes.end();
          ++it) {
         MutableDocument index((Document(*it)));
         index.remove("_id");  // indexes shouldn't have _ids but some existing ones do
+
+        if (deferIndexBuilds && (*it)["name"].str() != "_id_") {
+            // The collection is empty now, so maintaining this index on each insert would cost
+            // more than building it from all the documents at the end.
+            index.remove("ns");
+            _deferredIndexes.push_back(index.freeze().toBson());
+            continue;
+        }
         index["ns"] = Value(_tempNs.ns());
 
         BSONObj indexBson = index.freeze().toBson();
@@ -144,6 +154,31 @@ void DocumentSourceOut::initialize() {
     _initialized = true;
 }
 
+void DocumentSourceOut::buildDeferredIndexes() {
+    if (_deferredIndexes.empty()) {
+        return;
+    }
+
+    BSONObjBuilder cmd;
+    cmd << "createIndexes" << _tempNs.coll();
+    {
+        BSONArrayBuilder indexes(cmd.subarrayStart("indexes"));
+        for (auto&& spec : _deferredIndexes) {
+            indexes.append(spec);
+        }
+    }
+
+    BSONObj info;
+    DBClientBase* conn = pExpCtx->mongoProcessInterface->directClient();
+    bool ok = conn->runCommand(_outputNs.db().toString(), cmd.done(), info);
+    uassert(50853,
+            str::stream() << "building indexes on temporary $out collection '" << _tempNs.ns()
+                          << "' failed: "
+                          << info.toString(),
+            ok);
+    _deferredIndexes.clear();
+}
+
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
     BSONObj err = pExpCtx->mongoProcessInterface->insert(pExpCtx, _tempNs, toInsert);
     uassert(16996,
@@ -190,6 +225,7 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
             return nextInput;  // Propagate the pause.
         }
         case GetNextResult::ReturnStatus::kEOF: {
+            buildDeferredIndexes();
 
             auto renameCommandObj =
                 BSON("renameCollection" << _tempNs.ns() << "to" << _outputNs.ns() << "dropTarget"
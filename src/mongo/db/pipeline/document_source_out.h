@@ -86,12 +86,20 @@ private:
      * Sets '_tempNs' to a unique temporary namespace, makes sure the output collection isn't
      * sharded or capped, and saves the collection options and indexes of the target collection.
      * Then creates the temporary collection we will insert into by copying the collection options
-     * and indexes from the target collection.
+     * and indexes from the target collection. If index builds are deferred, only the _id index is
+     * created here and the specs of the others are saved in '_deferredIndexes'.
      *
      * Sets '_initialized' to true upon completion.
      */
     void initialize();
 
+    /**
+     * Builds the indexes in '_deferredIndexes' on the temporary collection, which by now holds
+     * every output document. All of them are built together in a single scan of the collection,
+     * with each index bulk-loaded from sorted keys.
+     */
+    void buildDeferredIndexes();
+
     /**
      * Inserts all of 'toInsert' into the temporary collection.
      */
@@ -105,6 +113,10 @@ private:
     BSONObj _originalOutOptions;
     std::list<BSONObj> _originalIndexes;
 
+    // The specs of the secondary indexes which will be built once all results are inserted, when
+    // index builds are deferred.
+    std::vector<BSONObj> _deferredIndexes;
+
     NamespaceString _tempNs;          // output goes here as it is being processed.
     const NamespaceString _outputNs;  // output will go here after all data is processed.
 };
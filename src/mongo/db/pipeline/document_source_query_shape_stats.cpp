@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_query_shape_stats.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(queryShapeStats,
+                         DocumentSourceQueryShapeStats::LiteParsed::parse,
+                         DocumentSourceQueryShapeStats::createFromBson);
+
+const char* DocumentSourceQueryShapeStats::kStageName = "$queryShapeStats";
+
+DocumentSource::GetNextResult DocumentSourceQueryShapeStats::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_entries.empty()) {
+        Document doc(_entries.back());
+        _entries.pop_back();
+        return std::move(doc);
+    }
+
+    return GetNextResult::makeEOF();
+}
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceQueryShapeStats::createFromBson(
+    BSONElement spec, const boost::intrusive_ptr<ExpressionContext>& pExpCtx) {
+
+    uassert(
+        ErrorCodes::InvalidNamespace,
+        str::stream() << kStageName
+                      << " must be run against the database with {aggregate: 1}, not a collection",
+        pExpCtx->ns.isCollectionlessAggregateNS());
+
+    uassert(ErrorCodes::BadValue,
+            str::stream() << kStageName << " must be run as { " << kStageName << ": {}}",
+            spec.isABSONObj() && spec.Obj().isEmpty());
+
+    return new DocumentSourceQueryShapeStats(pExpCtx);
+}
+
+DocumentSourceQueryShapeStats::DocumentSourceQueryShapeStats(
+    const boost::intrusive_ptr<ExpressionContext>& pExpCtx)
+    : DocumentSource(pExpCtx),
+      _entries(QueryShapeStats::get(pExpCtx->opCtx->getServiceContext()).getStats()) {}
+
+}  // namespace mongo
@@ -0,0 +1,182 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_shared_oplog_cursor.h"
+
+#include <limits>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/shared_oplog_buffer.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+constexpr StringData DocumentSourceSharedOplogCursor::kStageName;
+
+namespace {
+
+/**
+ * Returns the greatest timestamp less than 'ts'.
+ */
+Timestamp predecessor(Timestamp ts) {
+    if (ts.getInc() > 0) {
+        return Timestamp(ts.getSecs(), ts.getInc() - 1);
+    }
+    invariant(ts.getSecs() > 0);
+    return Timestamp(ts.getSecs() - 1, std::numeric_limits<unsigned>::max());
+}
+
+}  // namespace
+
+DocumentSourceSharedOplogCursor::DocumentSourceSharedOplogCursor(
+    const intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& oplogFilter)
+    : DocumentSource(expCtx), _filterObj(oplogFilter.getOwned()) {
+    _filter = uassertStatusOK(MatchExpressionParser::parse(_filterObj, pExpCtx));
+
+    // The first clause of the filter is the lower bound on the oplog position, of the form
+    // {ts: {$gte: <startFrom>}} or {ts: {$gt: <startFrom>}}.
+    auto tsBound = _filterObj["$and"].Obj().firstElement().Obj()["ts"].Obj().firstElement();
+    invariant(tsBound.type() == BSONType::bsonTimestamp);
+    _lastSeen = tsBound.fieldNameStringData() == "$gte"_sd ? predecessor(tsBound.timestamp())
+                                                           : tsBound.timestamp();
+    _oldestRequired = tsBound.timestamp();
+}
+
+intrusive_ptr<DocumentSourceSharedOplogCursor> DocumentSourceSharedOplogCursor::create(
+    const intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& oplogFilter) {
+    return new DocumentSourceSharedOplogCursor(expCtx, oplogFilter);
+}
+
+DocumentSource::GetNextResult DocumentSourceSharedOplogCursor::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_currentBatch.empty()) {
+        loadBatch();
+
+        if (_currentBatch.empty())
+            return GetNextResult::makeEOF();
+    }
+
+    Document out = std::move(_currentBatch.front());
+    _currentBatch.pop_front();
+    return std::move(out);
+}
+
+bool DocumentSourceSharedOplogCursor::shouldWaitForInserts() const {
+    auto opCtx = pExpCtx->opCtx;
+    return pExpCtx->isTailableAwaitData() && awaitDataState(opCtx).shouldWaitForInserts &&
+        awaitDataState(opCtx).waitForInsertsDeadline >
+        opCtx->getServiceContext()->getPreciseClockSource()->now();
+}
+
+void DocumentSourceSharedOplogCursor::loadBatch() {
+    auto opCtx = pExpCtx->opCtx;
+
+    // Capture the insert notifier's version before reading, so that an entry which becomes
+    // visible after the read below is empty ends the wait immediately.
+    std::shared_ptr<CappedInsertNotifier> notifier;
+    uint64_t notifierVersion = 0;
+    if (shouldWaitForInserts()) {
+        AutoGetCollectionForRead autoColl(opCtx, NamespaceString::kRsOplogNamespace);
+        if (auto collection = autoColl.getCollection()) {
+            notifier = collection->getCappedInsertNotifier();
+            notifierVersion = notifier->getVersion();
+        }
+    }
+
+    readEntries();
+    if (!_currentBatch.empty() || !notifier) {
+        return;
+    }
+
+    {
+        auto curOp = CurOp::get(opCtx);
+        curOp->pauseTimer();
+        ON_BLOCK_EXIT([curOp] { curOp->resumeTimer(); });
+        notifier->waitUntil(notifierVersion, awaitDataState(opCtx).waitForInsertsDeadline);
+    }
+
+    pExpCtx->checkForInterrupt();
+    readEntries();
+}
+
+void DocumentSourceSharedOplogCursor::readEntries() {
+    auto opCtx = pExpCtx->opCtx;
+    const auto maxBytes = static_cast<size_t>(internalDocumentSourceCursorBatchSizeBytes.load());
+
+    std::vector<BSONObj> entries;
+    Timestamp coverageStart;
+    if (!SharedOplogBuffer::get(opCtx)->readAfter(
+            opCtx, _lastSeen, maxBytes, &entries, &coverageStart)) {
+        // This stream has fallen behind the shared buffer, so read the gap ourselves. The oplog
+        // is only ever truncated from its oldest end, so if it still reaches back to this stream's
+        // position after the scan, nothing the scan should have returned was truncated.
+        SharedOplogBuffer::scanOplog(opCtx, _lastSeen, coverageStart, maxBytes, &entries);
+        uassert(ErrorCodes::ChangeStreamHistoryLost,
+                str::stream() << "Resume of change stream was not possible, as the resume point "
+                              << _oldestRequired.toString()
+                              << " may no longer be in the oplog",
+                SharedOplogBuffer::oldestOplogTimestamp(opCtx) <= _oldestRequired);
+        if (entries.empty()) {
+            _lastSeen = coverageStart;
+            _oldestRequired = _lastSeen;
+            return;
+        }
+    }
+
+    for (auto&& entry : entries) {
+        _lastSeen = entry["ts"].timestamp();
+        _oldestRequired = _lastSeen;
+        if (_filter->matchesBSON(entry)) {
+            _currentBatch.push_back(Document::fromBsonWithMetaData(entry));
+        }
+    }
+}
+
+Value DocumentSourceSharedOplogCursor::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    // Like $cursor, this stage is never parsed, so we only serialize for explain.
+    if (!explain)
+        return Value();
+
+    return Value(DOC(getSourceName() << DOC("filter" << _filterObj)));
+}
+
+}  // namespace mongo
@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * Produces the oplog entries matching a change stream's oplog filter, reading them from the
+ * node-wide SharedOplogBuffer rather than from a private oplog cursor. This stands in for the
+ * $cursor stage which would otherwise absorb the change stream's DocumentSourceOplogMatch, so the
+ * stages which follow it see exactly the same entries, in the same order.
+ */
+class DocumentSourceSharedOplogCursor final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$sharedOplogCursor"_sd;
+
+    /**
+     * Creates a stage returning the oplog entries matched by 'oplogFilter', which must be a filter
+     * produced by DocumentSourceChangeStream::buildMatchFilter().
+     */
+    static boost::intrusive_ptr<DocumentSourceSharedOplogCursor> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& oplogFilter);
+
+    GetNextResult getNext() final;
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+private:
+    DocumentSourceSharedOplogCursor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                    const BSONObj& oplogFilter);
+
+    /**
+     * Fills '_currentBatch' with the next matching entries, waiting for new oplog entries if this
+     * is an awaitData cursor and nothing is available yet.
+     */
+    void loadBatch();
+
+    /**
+     * Reads the entries following '_lastSeen', from the shared buffer if possible, and appends
+     * those matching the filter to '_currentBatch'.
+     */
+    void readEntries();
+
+    bool shouldWaitForInserts() const;
+
+    std::deque<Document> _currentBatch;
+
+    // '_filter' may point into '_filterObj', so it must be declared after it.
+    BSONObj _filterObj;
+    std::unique_ptr<MatchExpression> _filter;
+
+    // The timestamp of the last oplog entry examined. Every entry after it is yet to be read.
+    Timestamp _lastSeen;
+
+    // The oplog must still reach back to this timestamp for no entry after '_lastSeen' to have been
+    // lost. It is '_lastSeen' once an entry has been read, and the starting point before then.
+    Timestamp _oldestRequired;
+};
+
+}  // namespace mongo
@@ -131,12 +131,13 @@ DocumentSource::GetNextResult DocumentSourceSort::getNext() {
 void DocumentSourceSort::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     if (explain) {  // always one Value for combined $sort + $limit
-        array.push_back(Value(DOC(
+        Value entry(DOC(
             kStageName << DOC("sortKey" << sortKeyPattern(SortKeySerialization::kForExplain)
                                         << "mergePresorted"
                                         << (_mergingPresorted ? Value(true) : Value())
                                         << "limit"
-                                        << (_limitSrc ? Value(_limitSrc->getLimit()) : Value())))));
+                                        << (_limitSrc ? Value(_limitSrc->getLimit()) : Value()))));
+        array.push_back(addMemoryStatsForExplain(std::move(entry), explain));
     } else {  // one Value for $sort and maybe a Value for $limit
         MutableDocument inner(sortKeyPattern(SortKeySerialization::kForPipelineSerialization));
         if (_mergingPresorted) {
@@ -150,6 +151,20 @@ void DocumentSourceSort::serializeToArray(
     }
 }
 
+boost::optional<StageMemoryStats> DocumentSourceSort::getMemoryStats() const {
+    if (_mergingPresorted) {
+        return boost::none;
+    }
+    if (!_sorter) {
+        return _sorterMemoryStats;
+    }
+
+    StageMemoryStats memoryStats;
+    memoryStats.peakMemUsage = _sorter->peakMemUsed();
+    memoryStats.spills = _sorter->spillStats().spills;
+    return memoryStats;
+}
+
 void DocumentSourceSort::doDispose() {
     _output.reset();
 }
@@ -362,6 +377,8 @@ void DocumentSourceSort::loadingDone() {
         _sorter.reset(MySorter::make(makeSortOptions(), Comparator(*this)));
     }
     _output.reset(_sorter->done());
+    _sorterMemoryStats.peakMemUsage = _sorter->peakMemUsed();
+    _sorterMemoryStats.spills = _sorter->spillStats().spills;
     _sorter.reset();
     _populated = true;
 }
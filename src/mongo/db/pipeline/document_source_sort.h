@@ -57,6 +57,8 @@ public:
         std::vector<Value>& array,
         boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    boost::optional<StageMemoryStats> getMemoryStats() const final;
+
     GetModPathsReturn getModifiedPaths() const final {
         // A $sort does not modify any paths.
         return {GetModPathsReturn::Type::kFiniteSet, std::set<std::string>{}, {}};
@@ -265,6 +267,9 @@ private:
     bool _mergingPresorted;  // TODO SERVER-34009 Remove this flag.
     std::unique_ptr<MySorter> _sorter;
     std::unique_ptr<MySorter::Iterator> _output;
+
+    // The memory statistics of '_sorter', saved when it is released.
+    StageMemoryStats _sorterMemoryStats;
 };
 
 }  // namespace mongo
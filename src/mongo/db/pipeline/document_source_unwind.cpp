@@ -32,6 +32,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
@@ -206,6 +207,26 @@ DocumentSource::GetNextResult DocumentSourceUnwind::getNext() {
     return nextOut;
 }
 
+void DocumentSourceUnwind::unwindDocument(const Document& input,
+                                          const stdx::function<void(const Document&)>& consume) {
+    _unwinder->resetDocument(input);
+    for (auto next = _unwinder->getNext(); next.isAdvanced(); next = _unwinder->getNext()) {
+        // Release the document so that our reference is dropped before the unwinder reuses it.
+        consume(next.releaseDocument());
+    }
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceUnwind::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextGroup = dynamic_cast<DocumentSourceGroup*>((*std::next(itr)).get());
+    if (nextGroup && nextGroup->absorbUnwind(this)) {
+        return container->erase(itr);
+    }
+    return std::next(itr);
+}
+
 BSONObjSet DocumentSourceUnwind::getOutputSorts() {
     BSONObjSet out = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     std::string unwoundPath = getUnwindPath();
@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -84,6 +85,22 @@ public:
         return _indexPath;
     }
 
+    /**
+     * Unwinds 'input' directly, calling 'consume' with each document this stage would return for
+     * it. Used by a stage that absorbed this $unwind to process the array elements without pulling
+     * each of them through getNext(). The document passed to 'consume' is modified in place for
+     * the next element, unless the consumer kept a reference to it.
+     */
+    void unwindDocument(const Document& input,
+                        const stdx::function<void(const Document&)>& consume);
+
+protected:
+    /**
+     * Attempts to be absorbed by a subsequent $group stage, removing this stage from the pipeline.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     DocumentSourceUnwind(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                          const FieldPath& fieldPath,
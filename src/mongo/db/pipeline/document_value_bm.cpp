@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns a document with 'numFields' integer fields named "a0", "a1", ....
+ */
+Document makeDocument(int numFields) {
+    MutableDocument doc;
+    for (int i = 0; i < numFields; ++i) {
+        doc.addField(str::stream() << "a" << i, Value(i));
+    }
+    return doc.freeze();
+}
+
+/**
+ * Benchmark copying and destroying a Document, which only adjusts the reference count of its
+ * storage.
+ */
+void BM_DocumentCopy(benchmark::State& state) {
+    const Document doc = makeDocument(state.range(0));
+    for (auto keepRunning : state) {
+        Document copy(doc);
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+/**
+ * Benchmark building a Document field by field and then releasing it, as stages producing new
+ * documents, such as $project, do for every result.
+ */
+void BM_DocumentBuildAndRelease(benchmark::State& state) {
+    const int numFields = state.range(0);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(makeDocument(numFields));
+    }
+}
+
+/**
+ * Benchmark appending a field to a copy of a shared Document and releasing the result, as
+ * $addFields does for every input document.
+ */
+void BM_DocumentAddField(benchmark::State& state) {
+    const Document doc = makeDocument(state.range(0));
+    for (auto keepRunning : state) {
+        MutableDocument output(doc);
+        output.addField("added", Value(1));
+        benchmark::DoNotOptimize(output.freeze());
+    }
+}
+
+/**
+ * Benchmark building and releasing an array Value of strings, each of which holds its own
+ * reference-counted storage.
+ */
+void BM_ValueArrayBuildAndRelease(benchmark::State& state) {
+    const std::string str(32, 'x');
+    const int numElements = state.range(0);
+    for (auto keepRunning : state) {
+        std::vector<Value> values;
+        values.reserve(numElements);
+        for (int i = 0; i < numElements; ++i) {
+            values.emplace_back(str);
+        }
+        benchmark::DoNotOptimize(Value(std::move(values)));
+    }
+}
+
+/**
+ * Benchmark converting a BSONObj into a Document and reading every field, as a pipeline does for
+ * each document it receives from a cursor.
+ */
+void BM_DocumentFromBSON(benchmark::State& state) {
+    const BSONObj obj = makeDocument(state.range(0)).toBson();
+    for (auto keepRunning : state) {
+        Document doc(obj);
+        for (FieldIterator it(doc); it.more();) {
+            benchmark::DoNotOptimize(it.next());
+        }
+    }
+}
+
+/**
+ * Benchmark converting a Document back into a BSONObj, as is done for every pipeline result.
+ */
+void BM_DocumentToBSON(benchmark::State& state) {
+    const Document doc = makeDocument(state.range(0));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(doc.toBson());
+    }
+}
+
+BENCHMARK(BM_DocumentCopy)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_DocumentBuildAndRelease)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_DocumentAddField)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_ValueArrayBuildAndRelease)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_DocumentFromBSON)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_DocumentToBSON)->Arg(1)->Arg(10)->Arg(100);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns the expression selected by 'expressionShape': 0 for a field path, 1 for arithmetic over
+ * several fields, 2 for a $cond with a comparison and 3 for string concatenation.
+ */
+BSONObj makeExpression(int expressionShape) {
+    switch (expressionShape) {
+        case 0:
+            return fromjson("{expr: '$a.b'}");
+        case 1:
+            return fromjson(
+                "{expr: {$add: [{$multiply: ['$x', 2]}, '$y', {$subtract: ['$z', 1]}]}}");
+        case 2:
+            return fromjson("{expr: {$cond: [{$gte: ['$x', 10]}, 'high', 'low']}}");
+        default:
+            return fromjson("{expr: {$concat: ['$s', '-', {$toUpper: '$s'}]}}");
+    }
+}
+
+/**
+ * Benchmark evaluating a parsed and optimized expression against a document, as $project and
+ * $addFields do for every document.
+ */
+void BM_ExpressionEvaluate(benchmark::State& state) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto expression =
+        Expression::parseOperand(expCtx, makeExpression(state.range(0))["expr"], vps)->optimize();
+
+    const Document doc(fromjson("{a: {b: 1}, x: 12, y: 3.5, z: 7, s: 'value'}"));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(expression->evaluate(doc));
+    }
+}
+
+BENCHMARK(BM_ExpressionEvaluate)->DenseRange(0, 3);
+
+}  // namespace
+}  // namespace mongo
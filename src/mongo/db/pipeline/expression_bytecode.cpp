@@ -0,0 +1,431 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_bytecode.h"
+
+#include <limits>
+
+#include "mongo/base/compare_numbers.h"
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+void ExpressionBytecode::Register::set(Value val) {
+    switch (val.getType()) {
+        case NumberInt:
+            setInt(val.getInt());
+            break;
+        case NumberLong:
+            setLong(val.getLong());
+            break;
+        case NumberDouble:
+            setDouble(val.getDouble());
+            break;
+        case Bool:
+            setBool(val.getBool());
+            break;
+        default:
+            type = Type::kValue;
+            value = std::move(val);
+    }
+}
+
+void ExpressionBytecode::Register::setInt(int val) {
+    if (type == Type::kValue) {
+        value = Value();  // Don't keep the previous value alive.
+    }
+    type = Type::kInt;
+    intValue = val;
+}
+
+void ExpressionBytecode::Register::setLong(long long val) {
+    if (type == Type::kValue) {
+        value = Value();
+    }
+    type = Type::kLong;
+    longValue = val;
+}
+
+void ExpressionBytecode::Register::setIntOrLong(long long val) {
+    if (val > std::numeric_limits<int>::max() || val < std::numeric_limits<int>::min()) {
+        setLong(val);
+    } else {
+        setInt(static_cast<int>(val));
+    }
+}
+
+void ExpressionBytecode::Register::setDouble(double val) {
+    if (type == Type::kValue) {
+        value = Value();
+    }
+    type = Type::kDouble;
+    doubleValue = val;
+}
+
+void ExpressionBytecode::Register::setBool(bool val) {
+    if (type == Type::kValue) {
+        value = Value();
+    }
+    type = Type::kBool;
+    boolValue = val;
+}
+
+bool ExpressionBytecode::Register::coerceToBool() const {
+    switch (type) {
+        case Type::kInt:
+            return intValue;
+        case Type::kLong:
+            return longValue;
+        case Type::kDouble:
+            return doubleValue;
+        case Type::kBool:
+            return boolValue;
+        case Type::kValue:
+            return value.coerceToBool();
+    }
+    MONGO_UNREACHABLE;
+}
+
+Value ExpressionBytecode::Register::toValue() const {
+    switch (type) {
+        case Type::kInt:
+            return Value(intValue);
+        case Type::kLong:
+            return Value(longValue);
+        case Type::kDouble:
+            return Value(doubleValue);
+        case Type::kBool:
+            return Value(boolValue);
+        case Type::kValue:
+            return value;
+    }
+    MONGO_UNREACHABLE;
+}
+
+std::unique_ptr<ExpressionBytecode> ExpressionBytecode::compile(
+    const boost::intrusive_ptr<Expression>& expression) {
+    std::unique_ptr<ExpressionBytecode> program(new ExpressionBytecode(expression));
+    program->compileInto(expression.get(), program->allocateRegister());
+    if (program->_numNativeInstructions == 0) {
+        return nullptr;
+    }
+
+    program->_registers.resize(program->_numRegisters);
+    return program;
+}
+
+void ExpressionBytecode::compileInto(const Expression* expression, size_t dst) {
+    Instruction instruction;
+    instruction.dst = dst;
+    instruction.node = expression;
+
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expression)) {
+        instruction.opCode = OpCode::kLoadConstant;
+        instruction.constant = constant->getValue();
+        emit(std::move(instruction));
+    } else if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(expression)) {
+        // A path of length two, such as "CURRENT.a", is a top-level field of the root document.
+        // Anything else takes the tree's path traversal, which already has the variable resolved.
+        const FieldPath& path = fieldPath->getFieldPath();
+        if (fieldPath->isRootFieldPath() && path.getPathLength() == 2) {
+            instruction.opCode = OpCode::kLoadField;
+            instruction.fieldName = path.getFieldName(1);
+        } else {
+            instruction.opCode = OpCode::kEvaluateTree;
+        }
+        emit(std::move(instruction));
+    } else if (auto add = dynamic_cast<const ExpressionAdd*>(expression)) {
+        if (add->getOperandList().size() == 2) {
+            compileBinary(OpCode::kAdd, add, dst);
+        } else {
+            instruction.opCode = OpCode::kEvaluateTree;
+            emit(std::move(instruction));
+        }
+    } else if (auto subtract = dynamic_cast<const ExpressionSubtract*>(expression)) {
+        compileBinary(OpCode::kSubtract, subtract, dst);
+    } else if (auto multiply = dynamic_cast<const ExpressionMultiply*>(expression)) {
+        if (multiply->getOperandList().size() == 2) {
+            compileBinary(OpCode::kMultiply, multiply, dst);
+        } else {
+            instruction.opCode = OpCode::kEvaluateTree;
+            emit(std::move(instruction));
+        }
+    } else if (auto compare = dynamic_cast<const ExpressionCompare*>(expression)) {
+        compileBinary(OpCode::kCompare, compare, dst);
+        _instructions.back().cmpOp = compare->getOp();
+    } else if (auto andExpression = dynamic_cast<const ExpressionAnd*>(expression)) {
+        compileLogical(true, andExpression, dst);
+    } else if (auto orExpression = dynamic_cast<const ExpressionOr*>(expression)) {
+        compileLogical(false, orExpression, dst);
+    } else if (auto notExpression = dynamic_cast<const ExpressionNot*>(expression)) {
+        compileInto(notExpression->getOperandList()[0].get(), dst);
+        instruction.opCode = OpCode::kNot;
+        instruction.lhs = dst;
+        emit(std::move(instruction));
+        ++_numNativeInstructions;
+    } else if (auto cond = dynamic_cast<const ExpressionCond*>(expression)) {
+        const auto& operands = cond->getOperandList();
+        compileInto(operands[0].get(), dst);
+
+        Instruction jumpToElse;
+        jumpToElse.opCode = OpCode::kJumpIfFalse;
+        jumpToElse.lhs = dst;
+        const size_t jumpToElseIndex = emit(std::move(jumpToElse));
+
+        compileInto(operands[1].get(), dst);
+        Instruction jumpToEnd;
+        jumpToEnd.opCode = OpCode::kJump;
+        const size_t jumpToEndIndex = emit(std::move(jumpToEnd));
+
+        _instructions[jumpToElseIndex].target = _instructions.size();
+        compileInto(operands[2].get(), dst);
+        _instructions[jumpToEndIndex].target = _instructions.size();
+        ++_numNativeInstructions;
+    } else {
+        instruction.opCode = OpCode::kEvaluateTree;
+        emit(std::move(instruction));
+    }
+}
+
+void ExpressionBytecode::compileBinary(OpCode opCode,
+                                       const ExpressionNary* expression,
+                                       size_t dst) {
+    const auto& operands = expression->getOperandList();
+    invariant(operands.size() == 2);
+
+    // The operands get registers of their own, since the tree may have to evaluate the whole
+    // expression again if they turn out not to have a fast path.
+    Instruction instruction;
+    instruction.opCode = opCode;
+    instruction.dst = dst;
+    instruction.lhs = allocateRegister();
+    instruction.rhs = allocateRegister();
+    instruction.node = expression;
+
+    compileInto(operands[0].get(), instruction.lhs);
+    compileInto(operands[1].get(), instruction.rhs);
+    emit(std::move(instruction));
+    ++_numNativeInstructions;
+}
+
+void ExpressionBytecode::compileLogical(bool isAnd, const ExpressionNary* expression, size_t dst) {
+    // Each operand is left in 'dst' as a boolean. As soon as one of them decides the result, jump
+    // to the end, where 'dst' already holds that result.
+    const auto& operands = expression->getOperandList();
+    if (operands.empty()) {
+        Instruction instruction;
+        instruction.opCode = OpCode::kLoadConstant;
+        instruction.dst = dst;
+        instruction.constant = Value(isAnd);
+        emit(std::move(instruction));
+        return;
+    }
+
+    std::vector<size_t> jumpsToEnd;
+    for (size_t i = 0; i < operands.size(); ++i) {
+        compileInto(operands[i].get(), dst);
+
+        Instruction coerce;
+        coerce.opCode = OpCode::kCoerceToBool;
+        coerce.dst = dst;
+        coerce.lhs = dst;
+        emit(std::move(coerce));
+
+        if (i + 1 < operands.size()) {
+            Instruction jump;
+            jump.opCode = isAnd ? OpCode::kJumpIfFalse : OpCode::kJumpIfTrue;
+            jump.lhs = dst;
+            jumpsToEnd.push_back(emit(std::move(jump)));
+        }
+    }
+
+    for (auto&& jump : jumpsToEnd) {
+        _instructions[jump].target = _instructions.size();
+    }
+    ++_numNativeInstructions;
+}
+
+Value ExpressionBytecode::evaluate(const Document& root) const {
+    size_t pc = 0;
+    while (pc < _instructions.size()) {
+        const Instruction& instruction = _instructions[pc++];
+        switch (instruction.opCode) {
+            case OpCode::kLoadConstant:
+                _registers[instruction.dst].set(instruction.constant);
+                break;
+            case OpCode::kLoadField:
+                _registers[instruction.dst].set(root[instruction.fieldName]);
+                break;
+            case OpCode::kEvaluateTree:
+                _registers[instruction.dst].set(instruction.node->evaluate(root));
+                break;
+            case OpCode::kAdd:
+            case OpCode::kSubtract:
+            case OpCode::kMultiply:
+                if (!evaluateArithmetic(instruction)) {
+                    _registers[instruction.dst].set(instruction.node->evaluate(root));
+                }
+                break;
+            case OpCode::kCompare:
+                if (!evaluateCompare(instruction)) {
+                    _registers[instruction.dst].set(instruction.node->evaluate(root));
+                }
+                break;
+            case OpCode::kNot:
+                _registers[instruction.dst].setBool(!_registers[instruction.lhs].coerceToBool());
+                break;
+            case OpCode::kCoerceToBool:
+                _registers[instruction.dst].setBool(_registers[instruction.lhs].coerceToBool());
+                break;
+            case OpCode::kJump:
+                pc = instruction.target;
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!_registers[instruction.lhs].coerceToBool()) {
+                    pc = instruction.target;
+                }
+                break;
+            case OpCode::kJumpIfTrue:
+                if (_registers[instruction.lhs].coerceToBool()) {
+                    pc = instruction.target;
+                }
+                break;
+        }
+    }
+
+    return _registers[0].toValue();
+}
+
+bool ExpressionBytecode::evaluateArithmetic(const Instruction& instruction) const {
+    using Type = Register::Type;
+    const Register& lhs = _registers[instruction.lhs];
+    const Register& rhs = _registers[instruction.rhs];
+    if (!lhs.isNumeric() || !rhs.isNumeric()) {
+        return false;
+    }
+
+    Register& dst = _registers[instruction.dst];
+    const bool haveDouble = lhs.type == Type::kDouble || rhs.type == Type::kDouble;
+    const bool haveLong = lhs.type == Type::kLong || rhs.type == Type::kLong;
+    long long result;
+
+    switch (instruction.opCode) {
+        case OpCode::kAdd:
+            if (haveDouble) {
+                if (haveLong) {
+                    // $add rounds the exact sum once, which converting the long to a double first
+                    // may not.
+                    return false;
+                }
+                dst.setDouble(lhs.getDouble() + rhs.getDouble());
+                return true;
+            }
+            if (mongoSignedAddOverflow64(lhs.getLong(), rhs.getLong(), &result)) {
+                return false;
+            }
+            break;
+        case OpCode::kSubtract:
+            if (haveDouble) {
+                dst.setDouble(lhs.getDouble() - rhs.getDouble());
+                return true;
+            }
+            if (mongoSignedSubtractOverflow64(lhs.getLong(), rhs.getLong(), &result)) {
+                return false;
+            }
+            break;
+        case OpCode::kMultiply:
+            // On overflow, $multiply falls back to the product of the operands as doubles.
+            if (haveDouble ||
+                mongoSignedMultiplyOverflow64(lhs.getLong(), rhs.getLong(), &result)) {
+                dst.setDouble(lhs.getDouble() * rhs.getDouble());
+                return true;
+            }
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+
+    if (haveLong) {
+        dst.setLong(result);
+    } else {
+        dst.setIntOrLong(result);
+    }
+    return true;
+}
+
+bool ExpressionBytecode::evaluateCompare(const Instruction& instruction) const {
+    using Type = Register::Type;
+    const Register& lhs = _registers[instruction.lhs];
+    const Register& rhs = _registers[instruction.rhs];
+    if (!lhs.isNumeric() || !rhs.isNumeric()) {
+        return false;
+    }
+
+    // Numbers compare the same way under any collation.
+    int cmp;
+    if (lhs.type != Type::kDouble && rhs.type != Type::kDouble) {
+        cmp = compareLongs(lhs.getLong(), rhs.getLong());
+    } else if (lhs.type == Type::kLong) {
+        cmp = compareLongToDouble(lhs.longValue, rhs.getDouble());
+    } else if (rhs.type == Type::kLong) {
+        cmp = compareDoubleToLong(lhs.getDouble(), rhs.longValue);
+    } else {
+        cmp = compareDoubles(lhs.getDouble(), rhs.getDouble());
+    }
+
+    Register& dst = _registers[instruction.dst];
+    switch (instruction.cmpOp) {
+        case ExpressionCompare::EQ:
+            dst.setBool(cmp == 0);
+            break;
+        case ExpressionCompare::NE:
+            dst.setBool(cmp != 0);
+            break;
+        case ExpressionCompare::GT:
+            dst.setBool(cmp > 0);
+            break;
+        case ExpressionCompare::GTE:
+            dst.setBool(cmp >= 0);
+            break;
+        case ExpressionCompare::LT:
+            dst.setBool(cmp < 0);
+            break;
+        case ExpressionCompare::LTE:
+            dst.setBool(cmp <= 0);
+            break;
+        case ExpressionCompare::CMP:
+            dst.setInt(cmp);
+            break;
+    }
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,182 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * A linear, register-based program compiled from an optimized Expression tree. Evaluating the
+ * program produces the same result as evaluating the tree, but it avoids a virtual call and a
+ * boxed Value for each node of the operators it implements natively: constants, top-level field
+ * paths, two-operand $add, $subtract and $multiply, the comparison operators, $and, $or, $not and
+ * $cond. Arithmetic and comparisons on int, long and double operands are done directly on unboxed
+ * registers. Any other operand type, and any other operator, is handed back to the tree, which
+ * remains the reference implementation.
+ *
+ * The program keeps its registers between evaluations, so like the ExpressionContext of the tree,
+ * it must only be used by one thread at a time.
+ */
+class ExpressionBytecode {
+public:
+    /**
+     * Compiles 'expression', which should already have been optimized. Returns nullptr if no part
+     * of the tree would be evaluated natively, since the tree is then just as fast.
+     */
+    static std::unique_ptr<ExpressionBytecode> compile(
+        const boost::intrusive_ptr<Expression>& expression);
+
+    Value evaluate(const Document& root) const;
+
+    /**
+     * Returns the number of instructions in the program, for testing.
+     */
+    size_t getNumInstructions() const {
+        return _instructions.size();
+    }
+
+private:
+    enum class OpCode {
+        kLoadConstant,  // dst = constant
+        kLoadField,     // dst = root[fieldName]
+        kEvaluateTree,  // dst = node->evaluate(root)
+
+        // dst = lhs <op> rhs, or node->evaluate(root) if the operands have no fast path.
+        kAdd,
+        kSubtract,
+        kMultiply,
+        kCompare,
+
+        kNot,           // dst = !coerceToBool(lhs)
+        kCoerceToBool,  // dst = coerceToBool(lhs)
+        kJump,          // continue at target
+        kJumpIfFalse,   // continue at target if !coerceToBool(lhs)
+        kJumpIfTrue,    // continue at target if coerceToBool(lhs)
+    };
+
+    struct Instruction {
+        OpCode opCode;
+        size_t dst = 0;
+        size_t lhs = 0;
+        size_t rhs = 0;
+        size_t target = 0;
+        const Expression* node = nullptr;
+        Value constant;
+        StringData fieldName;
+        ExpressionCompare::CmpOp cmpOp = ExpressionCompare::EQ;
+    };
+
+    /**
+     * Holds numbers and booleans unboxed, and anything else as a Value.
+     */
+    struct Register {
+        enum class Type { kInt, kLong, kDouble, kBool, kValue };
+
+        void set(Value val);
+        void setInt(int val);
+        void setLong(long long val);
+        void setIntOrLong(long long val);
+        void setDouble(double val);
+        void setBool(bool val);
+
+        bool isNumeric() const {
+            return type == Type::kInt || type == Type::kLong || type == Type::kDouble;
+        }
+        long long getLong() const {
+            return type == Type::kInt ? intValue : longValue;
+        }
+        double getDouble() const {
+            switch (type) {
+                case Type::kInt:
+                    return intValue;
+                case Type::kLong:
+                    return static_cast<double>(longValue);
+                default:
+                    return doubleValue;
+            }
+        }
+
+        bool coerceToBool() const;
+        Value toValue() const;
+
+        Type type = Type::kValue;
+        union {
+            int intValue;
+            long long longValue;
+            double doubleValue;
+            bool boolValue;
+        };
+        Value value;
+    };
+
+    explicit ExpressionBytecode(boost::intrusive_ptr<Expression> expression)
+        : _expression(std::move(expression)) {}
+
+    size_t allocateRegister() {
+        return _numRegisters++;
+    }
+    size_t emit(Instruction instruction) {
+        _instructions.push_back(std::move(instruction));
+        return _instructions.size() - 1;
+    }
+
+    /**
+     * Appends instructions that leave the value of 'expression' in register 'dst'.
+     */
+    void compileInto(const Expression* expression, size_t dst);
+    void compileBinary(OpCode opCode, const ExpressionNary* expression, size_t dst);
+    void compileLogical(bool isAnd, const ExpressionNary* expression, size_t dst);
+
+    /**
+     * Runs the fast path of an arithmetic or comparison instruction. Returns false, leaving 'dst'
+     * untouched, if the operands are not numbers or the result does not fit the fast path.
+     */
+    bool evaluateArithmetic(const Instruction& instruction) const;
+    bool evaluateCompare(const Instruction& instruction) const;
+
+    // The tree this program was compiled from, which owns the nodes, constants and field names the
+    // instructions refer to.
+    const boost::intrusive_ptr<Expression> _expression;
+
+    std::vector<Instruction> _instructions;
+    size_t _numRegisters = 0;
+    size_t _numNativeInstructions = 0;
+
+    mutable std::vector<Register> _registers;
+};
+
+}  // namespace mongo
@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression_bytecode.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using ExpressionBytecodeTest = AggregationContextFixture;
+
+boost::intrusive_ptr<Expression> parseAndOptimize(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& obj) {
+    auto expression =
+        Expression::parseOperand(expCtx, obj.firstElement(), expCtx->variablesParseState);
+    return expression->optimize();
+}
+
+/**
+ * Asserts that the compiled program gives the same result, of the same type, as the tree for each
+ * document in 'inputs', or fails with the same error.
+ */
+void assertMatchesTree(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       const BSONObj& spec,
+                       const std::vector<Document>& inputs) {
+    auto expression = parseAndOptimize(expCtx, spec);
+    auto program = ExpressionBytecode::compile(expression);
+    ASSERT(program) << spec;
+
+    for (auto&& input : inputs) {
+        Value expected;
+        boost::optional<ErrorCodes::Error> expectedCode;
+        try {
+            expected = expression->evaluate(input);
+        } catch (const DBException& ex) {
+            expectedCode = ex.code();
+        }
+
+        if (expectedCode) {
+            ASSERT_THROWS_CODE(program->evaluate(input), AssertionException, *expectedCode);
+            continue;
+        }
+
+        auto actual = program->evaluate(input);
+        ASSERT_VALUE_EQ(expected, actual);
+        ASSERT_EQ(expected.getType(), actual.getType()) << spec << " " << input.toString();
+    }
+}
+
+std::vector<Document> makeInputs() {
+    const std::vector<Value> values = {Value(0),
+                                       Value(3),
+                                       Value(-7),
+                                       Value(std::numeric_limits<int>::max()),
+                                       Value(std::numeric_limits<int>::min()),
+                                       Value(5LL),
+                                       Value(std::numeric_limits<long long>::max()),
+                                       Value(std::numeric_limits<long long>::min()),
+                                       Value((1LL << 53) + 1),
+                                       Value(2.5),
+                                       Value(-0.0),
+                                       Value(std::numeric_limits<double>::quiet_NaN()),
+                                       Value(std::numeric_limits<double>::infinity()),
+                                       Value(9007199254740992.0),
+                                       Value(Decimal128("1.5")),
+                                       Value(true),
+                                       Value(false),
+                                       Value(BSONNULL),
+                                       Value(),
+                                       Value("str"_sd),
+                                       Value(Date_t::fromMillisSinceEpoch(1000)),
+                                       Value(std::vector<Value>{Value(1)})};
+
+    std::vector<Document> inputs;
+    for (auto&& a : values) {
+        for (auto&& b : values) {
+            inputs.push_back(Document{{"a", a}, {"b", b}});
+        }
+    }
+    return inputs;
+}
+
+TEST_F(ExpressionBytecodeTest, ArithmeticMatchesTree) {
+    auto inputs = makeInputs();
+    assertMatchesTree(getExpCtx(), fromjson("{x: {$add: ['$a', '$b']}}"), inputs);
+    assertMatchesTree(getExpCtx(), fromjson("{x: {$subtract: ['$a', '$b']}}"), inputs);
+    assertMatchesTree(getExpCtx(), fromjson("{x: {$multiply: ['$a', '$b']}}"), inputs);
+    assertMatchesTree(getExpCtx(),
+                      fromjson("{x: {$multiply: [{$add: ['$a', 1]}, {$subtract: ['$b', 2.5]}]}}"),
+                      inputs);
+}
+
+TEST_F(ExpressionBytecodeTest, ComparisonsMatchTree) {
+    auto inputs = makeInputs();
+    for (auto&& op : {"$eq", "$ne", "$gt", "$gte", "$lt", "$lte", "$cmp"}) {
+        assertMatchesTree(getExpCtx(),
+                          BSON("x" << BSON(op << BSON_ARRAY("$a"
+                                                            << "$b"))),
+                          inputs);
+    }
+}
+
+TEST_F(ExpressionBytecodeTest, LogicalOperatorsMatchTree) {
+    auto inputs = makeInputs();
+    assertMatchesTree(getExpCtx(), fromjson("{x: {$and: ['$a', {$gt: ['$b', 0]}]}}"), inputs);
+    assertMatchesTree(getExpCtx(), fromjson("{x: {$or: [{$lt: ['$a', 0]}, '$b']}}"), inputs);
+    assertMatchesTree(getExpCtx(), fromjson("{x: {$not: [{$eq: ['$a', '$b']}]}}"), inputs);
+    assertMatchesTree(getExpCtx(),
+                      fromjson("{x: {$cond: [{$gte: ['$a', '$b']}, '$a', {$add: ['$b', 1]}]}}"),
+                      inputs);
+}
+
+TEST_F(ExpressionBytecodeTest, UnsupportedOperatorsAreEvaluatedByTree) {
+    auto inputs = makeInputs();
+    assertMatchesTree(getExpCtx(),
+                      fromjson("{x: {$add: [{$abs: '$a'}, {$size: {$ifNull: ['$b', []]}}]}}"),
+                      inputs);
+    assertMatchesTree(getExpCtx(),
+                      fromjson("{x: {$cond: [{$isArray: '$a'}, '$a', {$concat: ['x', 'y']}]}}"),
+                      inputs);
+}
+
+TEST_F(ExpressionBytecodeTest, ShortCircuitSkipsUnusedBranches) {
+    // The divide by zero would fail if the $cond evaluated the branch that is not taken.
+    auto spec = fromjson("{x: {$cond: [{$eq: ['$a', 0]}, 0, {$divide: [1, '$a']}]}}");
+    auto program = ExpressionBytecode::compile(parseAndOptimize(getExpCtx(), spec));
+    ASSERT(program);
+    ASSERT_VALUE_EQ(program->evaluate(Document{{"a", 0}}), Value(0));
+    ASSERT_VALUE_EQ(program->evaluate(Document{{"a", 4}}), Value(0.25));
+}
+
+TEST_F(ExpressionBytecodeTest, DoesNotCompileExpressionWithNothingToDoNatively) {
+    ASSERT_FALSE(ExpressionBytecode::compile(parseAndOptimize(getExpCtx(), fromjson("{x: '$a'}"))));
+    ASSERT_FALSE(ExpressionBytecode::compile(
+        parseAndOptimize(getExpCtx(), fromjson("{x: {$add: ['$a', '$b', '$c']}}"))));
+    ASSERT_FALSE(ExpressionBytecode::compile(
+        parseAndOptimize(getExpCtx(), fromjson("{x: {$toUpper: '$a'}}"))));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -52,6 +52,8 @@
 
 namespace mongo {
 
+class ChunkManager;
+
 class ExpressionContext : public RefCountable {
 public:
     struct ResolvedNamespace {
@@ -204,6 +206,18 @@ public:
     // If known, the UUID of the execution namespace for this aggregation command.
     boost::optional<UUID> uuid;
 
+    // Set on the foreign expression context of a shard-local $lookup to the namespace of the local
+    // collection, with which the sharded foreign collection is co-located. Each shard then reads
+    // only its own part of the foreign collection.
+    boost::optional<NamespaceString> colocatedWithNss;
+
+    // The local collection's routing table, taken the first time a shard-local $lookup attaches a
+    // cursor, and the foreign collection's routing table for which co-location was last confirmed.
+    // The check is repeated only when the foreign collection's version changes, rather than for
+    // every document the $lookup joins.
+    std::shared_ptr<ChunkManager> colocatedWithCm;
+    std::shared_ptr<ChunkManager> colocationConfirmedForCm;
+
     std::string tempDir;  // Defaults to empty to prevent external sorting in mongos.
 
     OperationContext* opCtx;
@@ -225,6 +239,10 @@ public:
 
     TailableModeEnum tailableMode = TailableModeEnum::kNormal;
 
+    // Set while a stage reads ahead of the results it has already returned, so that a tailable,
+    // awaitData source hands back whatever input is ready instead of waiting for more.
+    bool prefetchingInput = false;
+
     // Tracks the depth of nested aggregation sub-pipelines. Used to enforce depth limits.
     size_t subPipelineDepth = 0;
 
@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/mongo_process_common.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
@@ -77,4 +78,25 @@ std::vector<BSONObj> MongoProcessCommon::getCurrentOps(OperationContext* opCtx,
     return ops;
 }
 
+BSONObj MongoProcessCommon::_makeDocumentKeysFilter(const std::vector<BSONObj>& documentKeys) {
+    BSONArrayBuilder ids;
+    BSONArrayBuilder otherKeys;
+    for (auto&& documentKey : documentKeys) {
+        if (documentKey.nFields() == 1 && documentKey.firstElementFieldNameStringData() == "_id") {
+            ids.append(documentKey.firstElement());
+        } else {
+            otherKeys.append(documentKey);
+        }
+    }
+
+    if (ids.arrSize() > 0) {
+        auto idFilter = BSON("_id" << BSON("$in" << ids.arr()));
+        if (otherKeys.arrSize() == 0) {
+            return idFilter;
+        }
+        otherKeys.append(idFilter);
+    }
+    return BSON("$or" << otherKeys.arr());
+}
+
 }  // namespace mongo
@@ -50,6 +50,12 @@ public:
                                        CurrentOpTruncateMode) const final;
 
 protected:
+    /**
+     * Returns a query filter matching any of the given document keys. Keys consisting only of an
+     * _id are combined into a single $in, so that they can be answered from one index scan.
+     */
+    static BSONObj _makeDocumentKeysFilter(const std::vector<BSONObj>& documentKeys);
+
     /**
      * Returns a BSONObj representing a report of the operation which is currently being
      * executed by the supplied client. This method is called by the getCurrentOps method of
@@ -110,6 +110,7 @@ public:
     virtual void appendLatencyStats(OperationContext* opCtx,
                                     const NamespaceString& nss,
                                     bool includeHistograms,
+                                    bool includePercentiles,
                                     BSONObjBuilder* builder) const = 0;
 
     /**
@@ -120,6 +121,13 @@ public:
                                       const BSONObj& param,
                                       BSONObjBuilder* builder) const = 0;
 
+    /**
+     * Appends storage engine cache statistics for collection "nss" and its indexes to "builder".
+     */
+    virtual Status appendCacheStats(OperationContext* opCtx,
+                                    const NamespaceString& nss,
+                                    BSONObjBuilder* builder) const = 0;
+
     /**
      * Appends the record count for collection "nss" to "builder".
      */
@@ -205,6 +213,20 @@ public:
         const Document& documentKey,
         boost::optional<BSONObj> readConcern) = 0;
 
+    /**
+     * Returns the documents matching any of 'documentKeys', in no particular order, using a single
+     * query per targeted host rather than one per key. Each key is treated as in
+     * lookupSingleDocument(), but a key may be left without a match even though a document exists
+     * if the results did not fit in a single batch, so callers should look up any unmatched keys
+     * individually. Returns an empty vector if the given namespace does not exist.
+     */
+    virtual std::vector<Document> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern) = 0;
+
     /**
      * Returns a vector of all local cursors.
      */
@@ -32,6 +32,8 @@
 
 #include <algorithm>
 
+#include "mongo/db/query/query_knobs.h"
+
 namespace mongo {
 
 namespace parsed_aggregation_projection {
@@ -52,6 +54,15 @@ void InclusionNode::optimize() {
     for (auto&& childPair : _children) {
         childPair.second->optimize();
     }
+
+    _compiledExpressions.clear();
+    if (internalQueryEnableExpressionBytecode.load()) {
+        for (auto&& expressionIt : _expressions) {
+            if (auto program = ExpressionBytecode::compile(expressionIt.second)) {
+                _compiledExpressions[expressionIt.first] = std::move(program);
+            }
+        }
+    }
 }
 
 void InclusionNode::serialize(MutableDocument* output,
@@ -148,6 +159,12 @@ void InclusionNode::addComputedFields(MutableDocument* outputDoc, const Document
             outputDoc->setField(field,
                                 childIt->second->addComputedFields(outputDoc->peek()[field], root));
         } else {
+            auto compiledIt = _compiledExpressions.find(field);
+            if (compiledIt != _compiledExpressions.end()) {
+                outputDoc->setField(field, compiledIt->second->evaluate(root));
+                continue;
+            }
+
             auto expressionIt = _expressions.find(field);
             invariant(expressionIt != _expressions.end());
             outputDoc->setField(field, expressionIt->second->evaluate(root));
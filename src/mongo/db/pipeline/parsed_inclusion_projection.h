@@ -31,6 +31,7 @@
 #include <memory>
 
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_bytecode.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
 #include "mongo/stdx/memory.h"
@@ -169,6 +170,11 @@ private:
     std::vector<std::string> _orderToProcessAdditionsAndChildren;
 
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
+
+    // Programs compiled from the entries of '_expressions' by optimize(), when enabled. Fields with
+    // no entry here are evaluated from the tree.
+    StringMap<std::unique_ptr<ExpressionBytecode>> _compiledExpressions;
+
     stdx::unordered_set<std::string> _inclusions;
 
     // TODO use StringMap once SERVER-23700 is resolved.
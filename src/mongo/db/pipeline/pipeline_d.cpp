@@ -62,13 +62,16 @@
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
+#include "mongo/db/pipeline/document_source_shared_oplog_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/repl/optime.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
@@ -226,6 +229,23 @@ BSONObj removeSortKeyMetaProjection(BSONObj projectionObj) {
     }
     return projectionObj.removeField(Document::metaFieldSortKey);
 }
+
+/**
+ * Returns true if 'query' bounds the "ts" field from below with a Timestamp at its top level, so
+ * that a scan of the oplog can seek straight to the first entry in range.
+ */
+bool hasOplogTsLowerBound(const BSONObj& query) {
+    auto ts = query[repl::OpTime::kTimestampFieldName];
+    if (ts.type() != BSONType::Object) {
+        return false;
+    }
+    for (auto&& bound : {ts.Obj()["$gt"], ts.Obj()["$gte"]}) {
+        if (bound.type() == BSONType::bsonTimestamp) {
+            return true;
+        }
+    }
+    return false;
+}
 }  // namespace
 
 void PipelineD::prepareCursorSource(Collection* collection,
@@ -273,11 +293,13 @@ void PipelineD::prepareCursorSource(Collection* collection,
     // Look for an initial match. This works whether we got an initial query or not. If not, it
     // results in a "{}" query, which will be what we want in that case.
     bool oplogReplay = false;
+    bool isChangeStream = false;
     const BSONObj queryObj = pipeline->getInitialQuery();
     if (!queryObj.isEmpty()) {
         auto matchStage = dynamic_cast<DocumentSourceMatch*>(sources.front().get());
         if (matchStage) {
-            oplogReplay = dynamic_cast<DocumentSourceOplogMatch*>(matchStage) != nullptr;
+            isChangeStream = dynamic_cast<DocumentSourceOplogMatch*>(matchStage) != nullptr;
+            oplogReplay = isChangeStream || (nss.isOplog() && hasOplogTsLowerBound(queryObj));
             // If a $match query is pulled into the cursor, the $match is redundant, and can be
             // removed from the pipeline.
             sources.pop_front();
@@ -288,6 +310,16 @@ void PipelineD::prepareCursorSource(Collection* collection,
         }
     }
 
+    if (isChangeStream && internalChangeStreamUseSharedOplogReader.load() && !expCtx->needsMerge &&
+        !expCtx->explain) {
+        // Serve this change stream from the oplog entries shared by every change stream on this
+        // node, instead of giving it a cursor of its own. The stages which follow see the same
+        // entries either way. A merging shard still needs the latest oplog timestamp reported by
+        // $cursor, and explain needs its plan, so both keep the private cursor.
+        pipeline->addInitialSource(DocumentSourceSharedOplogCursor::create(expCtx, queryObj));
+        return;
+    }
+
     // Find the set of fields in the source documents depended on by this pipeline.
     DepsTracker deps = pipeline->getDependencies(DocumentSourceMatch::isTextQuery(queryObj)
                                                      ? DepsTracker::MetadataAvailable::kTextScore
@@ -569,7 +601,10 @@ void PipelineD::getPlanSummaryStats(const Pipeline* pPipeline, PlanSummaryStats*
     for (auto&& source : pPipeline->_sources) {
         if (dynamic_cast<DocumentSourceSort*>(source.get())) {
             hasSortStage = true;
-            break;
+        }
+
+        if (auto memoryStats = source->getMemoryStats()) {
+            statsOut->addStageMemoryStats(*memoryStats);
         }
     }
 
@@ -621,8 +656,10 @@ CollectionIndexUsageMap PipelineD::MongoDInterface::getIndexStats(OperationConte
 void PipelineD::MongoDInterface::appendLatencyStats(OperationContext* opCtx,
                                                     const NamespaceString& nss,
                                                     bool includeHistograms,
+                                                    bool includePercentiles,
                                                     BSONObjBuilder* builder) const {
-    Top::get(opCtx->getServiceContext()).appendLatencyStats(nss.ns(), includeHistograms, builder);
+    Top::get(opCtx->getServiceContext())
+        .appendLatencyStats(nss.ns(), includeHistograms, includePercentiles, builder);
 }
 
 Status PipelineD::MongoDInterface::appendStorageStats(OperationContext* opCtx,
@@ -632,6 +669,12 @@ Status PipelineD::MongoDInterface::appendStorageStats(OperationContext* opCtx,
     return appendCollectionStorageStats(opCtx, nss, param, builder);
 }
 
+Status PipelineD::MongoDInterface::appendCacheStats(OperationContext* opCtx,
+                                                    const NamespaceString& nss,
+                                                    BSONObjBuilder* builder) const {
+    return appendCollectionCacheStats(opCtx, nss, builder);
+}
+
 Status PipelineD::MongoDInterface::appendRecordCount(OperationContext* opCtx,
                                                      const NamespaceString& nss,
                                                      BSONObjBuilder* builder) const {
@@ -705,6 +748,19 @@ Status PipelineD::MongoDInterface::attachCursorSourceToPipeline(
     invariant(pipeline->getSources().empty() ||
               !dynamic_cast<DocumentSourceCursor*>(pipeline->getSources().front().get()));
 
+    // A shard-local $lookup reads only this shard's part of the sharded 'from' collection. Take the
+    // local collection's routing table once per $lookup, and before locking the 'from' collection
+    // so that both are never locked at once.
+    if (expCtx->colocatedWithNss && !expCtx->colocatedWithCm) {
+        AutoGetCollection autoLocalColl(expCtx->opCtx, *expCtx->colocatedWithNss, MODE_IS);
+        auto localMetadata =
+            CollectionShardingState::get(expCtx->opCtx, *expCtx->colocatedWithNss)
+                ->getMetadata(expCtx->opCtx);
+        if (localMetadata) {
+            expCtx->colocatedWithCm = localMetadata->getChunkManager();
+        }
+    }
+
     boost::optional<AutoGetCollectionForReadCommand> autoColl;
     if (expCtx->uuid) {
         try {
@@ -726,9 +782,32 @@ Status PipelineD::MongoDInterface::attachCursorSourceToPipeline(
     // TODO SERVER-24960: Use CollectionShardingState::collectionIsSharded() to confirm sharding
     // state.
     auto css = CollectionShardingState::get(expCtx->opCtx, expCtx->ns);
-    uassert(4567,
-            str::stream() << "from collection (" << expCtx->ns.ns() << ") cannot be sharded",
-            !bool(css->getMetadata(expCtx->opCtx)));
+    auto metadata = css->getMetadata(expCtx->opCtx);
+    if (expCtx->colocatedWithNss) {
+        // The documents this shard owns may only join with 'from' documents on this shard if every
+        // chunk of the local collection on this shard lies on this shard in 'from' too. Otherwise a
+        // migration has broken the co-location mongos relied on, and the join would miss matches.
+        // The local routing table is fixed for the $lookup, so the comparison only needs to be
+        // repeated when the 'from' collection's version changes.
+        const auto& confirmedCm = expCtx->colocationConfirmedForCm;
+        if (!metadata || !confirmedCm ||
+            !confirmedCm->getVersion().equals(metadata->getCollVersion())) {
+            uassert(50877,
+                    str::stream() << "from collection (" << expCtx->ns.ns()
+                                  << ") is no longer co-located with "
+                                  << expCtx->colocatedWithNss->ns()
+                                  << " on this shard",
+                    expCtx->colocatedWithCm && metadata &&
+                        expCtx->colocatedWithCm->isColocatedWith(
+                            *metadata->getChunkManager(),
+                            ShardId(ShardingState::get(expCtx->opCtx)->getShardName())));
+            expCtx->colocationConfirmedForCm = metadata->getChunkManager();
+        }
+    } else {
+        uassert(4567,
+                str::stream() << "from collection (" << expCtx->ns.ns() << ") cannot be sharded",
+                !bool(metadata));
+    }
 
     PipelineD::prepareCursorSource(autoColl->getCollection(), expCtx->ns, nullptr, pipeline);
 
@@ -835,6 +914,39 @@ boost::optional<Document> PipelineD::MongoDInterface::lookupSingleDocument(
     return lookedUpDocument;
 }
 
+std::vector<Document> PipelineD::MongoDInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern) {
+    invariant(!readConcern);  // As in lookupSingleDocument(), only expected on mongos.
+
+    std::vector<BSONObj> keyObjs;
+    keyObjs.reserve(documentKeys.size());
+    for (auto&& documentKey : documentKeys) {
+        keyObjs.push_back(documentKey.toBson());
+    }
+
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        auto foreignExpCtx = expCtx->copyWith(
+            nss,
+            collectionUUID,
+            _getCollectionDefaultCollator(expCtx->opCtx, nss.db(), collectionUUID));
+        pipeline = uassertStatusOK(
+            makePipeline({BSON("$match" << _makeDocumentKeysFilter(keyObjs))}, foreignExpCtx));
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return {};
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    while (auto next = pipeline->getNext()) {
+        lookedUpDocuments.push_back(std::move(*next));
+    }
+    return lookedUpDocuments;
+}
+
 BSONObj PipelineD::MongoDInterface::_reportCurrentOpForClient(
     OperationContext* opCtx, Client* client, CurrentOpTruncateMode truncateOps) const {
     BSONObjBuilder builder;
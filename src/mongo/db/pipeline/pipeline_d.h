@@ -76,11 +76,15 @@ public:
         void appendLatencyStats(OperationContext* opCtx,
                                 const NamespaceString& nss,
                                 bool includeHistograms,
+                                bool includePercentiles,
                                 BSONObjBuilder* builder) const final;
         Status appendStorageStats(OperationContext* opCtx,
                                   const NamespaceString& nss,
                                   const BSONObj& param,
                                   BSONObjBuilder* builder) const final;
+        Status appendCacheStats(OperationContext* opCtx,
+                                const NamespaceString& nss,
+                                BSONObjBuilder* builder) const final;
         Status appendRecordCount(OperationContext* opCtx,
                                  const NamespaceString& nss,
                                  BSONObjBuilder* builder) const final;
@@ -106,6 +110,12 @@ public:
             UUID collectionUUID,
             const Document& documentKey,
             boost::optional<BSONObj> readConcern) final;
+        std::vector<Document> lookupDocuments(
+            const boost::intrusive_ptr<ExpressionContext>& expCtx,
+            const NamespaceString& nss,
+            UUID collectionUUID,
+            const std::vector<Document>& documentKeys,
+            boost::optional<BSONObj> readConcern) final;
         std::vector<GenericCursor> getCursors(
             const boost::intrusive_ptr<ExpressionContext>& expCtx) const final;
 
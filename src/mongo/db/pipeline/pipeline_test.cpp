@@ -34,11 +34,13 @@
 
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/cluster_aggregation_planner.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_internal_split_pipeline.h"
+#include "mongo/db/pipeline/document_source_lookup.h"
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_mock.h"
@@ -330,6 +332,15 @@ TEST(PipelineOptimizationTest, LookupShouldCoalesceWithUnwindOnAsWithIncludeArra
     assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
 }
 
+TEST(PipelineOptimizationTest, GroupShouldAbsorbPrecedingUnwind) {
+    string inputPipe = "[{$unwind: '$a'}, {$group: {_id: '$a.b', n: {$sum: 1}}}]";
+    string outputPipe =
+        "[{$group: {_id: '$a.b', n: {$sum: {$const: 1}}, $unwinding: {path: '$a'}}}]";
+    string serializedPipe =
+        "[{$unwind: {path: '$a'}}, {$group: {_id: '$a.b', n: {$sum: {$const: 1}}}}]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
 TEST(PipelineOptimizationTest, LookupShouldNotCoalesceWithUnwindNotOnAs) {
     string inputPipe =
         "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
@@ -2304,6 +2315,92 @@ TEST_F(PipelineMustRunOnMongoSTest, SplittablePipelineRunsUnsplitOnMongoSIfSplit
 }
 
 }  // namespace mustRunOnMongoS
+
+namespace shardLocalLookup {
+
+class ShardLocalLookupTest : public AggregationContextFixture {
+public:
+    ShardLocalLookupTest() {
+        getExpCtx()->inMongos = true;
+        getExpCtx()->setResolvedNamespace(_fromNss, {_fromNss, std::vector<BSONObj>{}});
+    }
+
+    std::unique_ptr<Pipeline, PipelineDeleter> parse(const std::string& pipelineStr) {
+        std::vector<BSONObj> rawPipeline;
+        for (auto&& stage : fromjson("{pipeline: " + pipelineStr + "}")["pipeline"].Obj()) {
+            rawPipeline.push_back(stage.Obj());
+        }
+        auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, getExpCtx()));
+        pipeline->optimizePipeline();
+        return pipeline;
+    }
+
+    static bool alwaysColocated(const NamespaceString&, const FieldPath&, const FieldPath&) {
+        return true;
+    }
+
+    const NamespaceString _fromNss{"unittests", "lookupColl"};
+};
+
+TEST_F(ShardLocalLookupTest, LookupOnUnmodifiedLocalFieldRunsOnShards) {
+    auto pipeline = parse(
+        "[{$match: {x: 1}}, {$addFields: {y: 1}}, "
+        " {$lookup: {from: 'lookupColl', as: 'asField', localField: 'x', foreignField: '_id'}}, "
+        " {$sort: {x: 1}}]");
+
+    auto marked = cluster_aggregation_planner::markShardLocalLookups(
+        pipeline.get(), &ShardLocalLookupTest::alwaysColocated);
+    ASSERT_EQ(1U, marked.size());
+    ASSERT_EQ(_fromNss, *marked.begin());
+
+    auto shardPipe = pipeline->splitForSharded();
+    auto shardSources = shardPipe->getSources();
+    ASSERT_EQ(4U, shardSources.size());
+    auto lookup = dynamic_cast<DocumentSourceLookUp*>(std::next(shardSources.begin(), 2)->get());
+    ASSERT(lookup);
+    ASSERT_TRUE(lookup->isShardLocal());
+    ASSERT_EQ(1U, pipeline->getSources().size());
+}
+
+TEST_F(ShardLocalLookupTest, LookupAfterLocalFieldIsModifiedRunsOnMerger) {
+    auto pipeline = parse(
+        "[{$addFields: {'x.y': 1}}, "
+        " {$lookup: {from: 'lookupColl', as: 'asField', localField: 'x', foreignField: '_id'}}]");
+    ASSERT_TRUE(cluster_aggregation_planner::markShardLocalLookups(
+                    pipeline.get(), &ShardLocalLookupTest::alwaysColocated)
+                    .empty());
+
+    pipeline = parse(
+        "[{$project: {y: 1}}, "
+        " {$lookup: {from: 'lookupColl', as: 'asField', localField: 'x', foreignField: '_id'}}]");
+    ASSERT_TRUE(cluster_aggregation_planner::markShardLocalLookups(
+                    pipeline.get(), &ShardLocalLookupTest::alwaysColocated)
+                    .empty());
+}
+
+TEST_F(ShardLocalLookupTest, LookupWithPipelineSyntaxRunsOnMerger) {
+    auto pipeline = parse("[{$lookup: {from: 'lookupColl', as: 'asField', pipeline: []}}]");
+    ASSERT_TRUE(cluster_aggregation_planner::markShardLocalLookups(
+                    pipeline.get(), &ShardLocalLookupTest::alwaysColocated)
+                    .empty());
+}
+
+TEST_F(ShardLocalLookupTest, LookupOfCollectionWhichIsNotColocatedRunsOnMerger) {
+    auto pipeline = parse(
+        "[{$lookup: {from: 'lookupColl', as: 'asField', localField: 'x', foreignField: '_id'}}]");
+    ASSERT_TRUE(cluster_aggregation_planner::markShardLocalLookups(
+                    pipeline.get(),
+                    [](const NamespaceString&, const FieldPath&, const FieldPath&) {
+                        return false;
+                    })
+                    .empty());
+
+    auto shardPipe = pipeline->splitForSharded();
+    ASSERT_EQ(0U, shardPipe->getSources().size());
+    ASSERT_EQ(1U, pipeline->getSources().size());
+}
+
+}  // namespace shardLocalLookup
 }  // namespace Sharded
 }  // namespace Optimizations
 
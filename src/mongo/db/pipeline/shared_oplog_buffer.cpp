@@ -0,0 +1,243 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/shared_oplog_buffer.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getSharedOplogBuffer = ServiceContext::declareDecoration<SharedOplogBuffer>();
+
+Timestamp entryTimestamp(const BSONObj& entry) {
+    return entry["ts"].timestamp();
+}
+
+}  // namespace
+
+SharedOplogBuffer* SharedOplogBuffer::get(ServiceContext* serviceContext) {
+    return &getSharedOplogBuffer(serviceContext);
+}
+
+SharedOplogBuffer* SharedOplogBuffer::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool SharedOplogBuffer::readAfter(OperationContext* opCtx,
+                                  Timestamp after,
+                                  size_t maxBytes,
+                                  std::vector<BSONObj>* out,
+                                  Timestamp* coverageStart) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    bool waitedForFill = false;
+    while (true) {
+        if (_entries.empty() && _newest.isNull() && !_filling) {
+            // Nothing has ever been read; start the window at the first reader's position.
+            _reset(lk, after);
+        }
+
+        if (after < _coverageStart) {
+            *coverageStart = _coverageStart;
+            return false;
+        }
+
+        if (_collectAfter(lk, after, maxBytes, out) || waitedForFill) {
+            return true;
+        }
+
+        if (!_filling) {
+            break;
+        }
+
+        // Another operation is already reading from the oplog. Wait for it rather than scanning
+        // the same range a second time.
+        opCtx->waitForConditionOrInterrupt(_fillDone, lk, [this] { return !_filling; });
+        waitedForFill = true;
+    }
+
+    const Timestamp fillFrom = _newest;
+    std::vector<BSONObj> fetched;
+    {
+        _filling = true;
+        lk.unlock();
+        ON_BLOCK_EXIT([&] {
+            if (!lk.owns_lock()) {
+                lk.lock();
+            }
+            _filling = false;
+            _fillDone.notify_all();
+        });
+
+        scanOplog(opCtx,
+                  fillFrom,
+                  Timestamp(),
+                  static_cast<size_t>(internalDocumentSourceCursorBatchSizeBytes.load()),
+                  &fetched);
+        lk.lock();
+    }
+
+    // Only one operation fills at a time, but the buffer may still have been reset while the lock
+    // was released. The entries read no longer follow the buffered ones, so drop them and let the
+    // caller read again.
+    if (_newest != fillFrom) {
+        if (after < _coverageStart) {
+            *coverageStart = _coverageStart;
+            return false;
+        }
+        _collectAfter(lk, after, maxBytes, out);
+        return true;
+    }
+
+    for (auto&& entry : fetched) {
+        _bytes += entry.objsize();
+        _entries.push_back(std::move(entry));
+    }
+    if (!_entries.empty()) {
+        _newest = entryTimestamp(_entries.back());
+    }
+
+    _collectAfter(lk, after, maxBytes, out);
+    _evict(lk);
+    return true;
+}
+
+Timestamp SharedOplogBuffer::scanOplog(OperationContext* opCtx,
+                                       Timestamp after,
+                                       Timestamp upTo,
+                                       size_t maxBytes,
+                                       std::vector<BSONObj>* out) {
+    const auto& nss = NamespaceString::kRsOplogNamespace;
+    AutoGetCollectionForRead autoColl(opCtx, nss);
+    uassertStatusOK(
+        repl::ReplicationCoordinator::get(opCtx)->checkCanServeReadsFor(opCtx, nss, true));
+
+    auto collection = autoColl.getCollection();
+    uassert(ErrorCodes::NamespaceNotFound,
+            str::stream() << "Cannot read change stream events: " << nss.ns() << " does not exist",
+            collection);
+
+    BSONObjBuilder tsBuilder;
+    tsBuilder.append("$gt", after);
+    if (!upTo.isNull()) {
+        tsBuilder.append("$lte", upTo);
+    }
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("ts" << tsBuilder.obj()));
+    qr->setOplogReplay(true);
+
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx, std::move(qr)));
+    auto exec = uassertStatusOK(getExecutorFind(opCtx, collection, nss, std::move(cq)));
+
+    Timestamp last = after;
+    size_t bytesRead = 0;
+    BSONObj entry;
+    PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+    while (bytesRead < maxBytes &&
+           (state = exec->getNext(&entry, nullptr)) == PlanExecutor::ADVANCED) {
+        bytesRead += entry.objsize();
+        last = entryTimestamp(entry);
+        out->push_back(entry.getOwned());
+    }
+
+    if (state == PlanExecutor::DEAD || state == PlanExecutor::FAILURE) {
+        uassertStatusOK(WorkingSetCommon::getMemberObjectStatus(entry).withContext(
+            "Error reading oplog for change stream"));
+    }
+    return last;
+}
+
+Timestamp SharedOplogBuffer::oldestOplogTimestamp(OperationContext* opCtx) {
+    AutoGetCollectionForRead autoColl(opCtx, NamespaceString::kRsOplogNamespace);
+    auto collection = autoColl.getCollection();
+    if (!collection) {
+        return Timestamp();
+    }
+
+    auto record = collection->getCursor(opCtx, /*forward=*/true)->next();
+    return record ? entryTimestamp(record->data.toBson()) : Timestamp();
+}
+
+bool SharedOplogBuffer::_collectAfter(WithLock,
+                                      Timestamp after,
+                                      size_t maxBytes,
+                                      std::vector<BSONObj>* out) const {
+    auto it = std::upper_bound(
+        _entries.begin(), _entries.end(), after, [](const Timestamp& ts, const BSONObj& entry) {
+            return ts < entryTimestamp(entry);
+        });
+
+    size_t bytesCollected = 0;
+    bool collected = false;
+    for (; it != _entries.end() && bytesCollected < maxBytes; ++it) {
+        bytesCollected += it->objsize();
+        out->push_back(*it);
+        collected = true;
+    }
+    return collected;
+}
+
+void SharedOplogBuffer::_evict(WithLock) {
+    const auto maxBytes = static_cast<size_t>(internalChangeStreamSharedOplogBufferMaxBytes.load());
+    while (_bytes > maxBytes && !_entries.empty()) {
+        _coverageStart = entryTimestamp(_entries.front());
+        _bytes -= _entries.front().objsize();
+        _entries.pop_front();
+    }
+}
+
+void SharedOplogBuffer::_reset(WithLock, Timestamp start) {
+    _entries.clear();
+    _bytes = 0;
+    _coverageStart = start;
+    _newest = start;
+}
+
+}  // namespace mongo
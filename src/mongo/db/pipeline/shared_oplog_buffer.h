@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A node-wide window over the most recently read oplog entries, shared by every change stream
+ * running on this node. Rather than each stream scanning the oplog with its own cursor, streams
+ * ask the buffer for the entries following the last timestamp they have seen, and the buffer
+ * reads forward from the oplog at most once for all of them. Each stream then applies its own
+ * filter to the shared entries.
+ *
+ * The buffer holds every oplog entry with a timestamp in the range (coverageStart, newest]. Old
+ * entries are evicted from the front once the buffer exceeds its configured size, which advances
+ * 'coverageStart'. A stream which has fallen behind the start of that range must read the gap
+ * from the oplog itself.
+ *
+ * Only one operation fills the buffer at a time; others wait for it to finish and then consume
+ * the entries it read.
+ */
+class SharedOplogBuffer {
+public:
+    static SharedOplogBuffer* get(ServiceContext* serviceContext);
+    static SharedOplogBuffer* get(OperationContext* opCtx);
+
+    /**
+     * Appends to 'out' the entries with a timestamp strictly greater than 'after', reading more
+     * from the oplog if the buffer has nothing newer. At most 'maxBytes' worth of entries are
+     * returned, though at least one entry is returned if any is available.
+     *
+     * Returns false without modifying 'out' if entries following 'after' have already been
+     * evicted. In that case '*coverageStart' is set to the exclusive lower bound of the buffered
+     * range, and the caller must read (after, coverageStart] directly from the oplog.
+     */
+    bool readAfter(OperationContext* opCtx,
+                   Timestamp after,
+                   size_t maxBytes,
+                   std::vector<BSONObj>* out,
+                   Timestamp* coverageStart);
+
+    /**
+     * Scans the oplog for entries with a timestamp in the range (after, upTo], appending owned
+     * copies of them to 'out' until 'maxBytes' have been read. A null 'upTo' leaves the range
+     * unbounded above. Returns the timestamp of the last entry read, or 'after' if none were.
+     */
+    static Timestamp scanOplog(OperationContext* opCtx,
+                               Timestamp after,
+                               Timestamp upTo,
+                               size_t maxBytes,
+                               std::vector<BSONObj>* out);
+
+    /**
+     * Returns the timestamp of the oldest entry remaining in the oplog, or a null timestamp if the
+     * oplog is empty.
+     */
+    static Timestamp oldestOplogTimestamp(OperationContext* opCtx);
+
+private:
+    /**
+     * Appends the buffered entries following 'after' to 'out'. Must be called while holding
+     * '_mutex'. Returns true if anything was appended.
+     */
+    bool _collectAfter(WithLock, Timestamp after, size_t maxBytes, std::vector<BSONObj>* out) const;
+
+    /**
+     * Drops entries from the front of the buffer until it fits within the configured size.
+     */
+    void _evict(WithLock);
+
+    void _reset(WithLock, Timestamp start);
+
+    mutable stdx::mutex _mutex;
+
+    // Signalled whenever a fill completes.
+    stdx::condition_variable _fillDone;
+
+    // True while some operation is reading from the oplog into the buffer.
+    bool _filling = false;
+
+    // Oplog entries with timestamps in (_coverageStart, _newest], in timestamp order.
+    std::deque<BSONObj> _entries;
+    Timestamp _coverageStart;
+    Timestamp _newest;
+    size_t _bytes = 0;
+};
+
+}  // namespace mongo
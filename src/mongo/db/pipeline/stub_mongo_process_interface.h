@@ -71,6 +71,7 @@ public:
     void appendLatencyStats(OperationContext* opCtx,
                             const NamespaceString& nss,
                             bool includeHistograms,
+                            bool includePercentiles,
                             BSONObjBuilder* builder) const override {
         MONGO_UNREACHABLE;
     }
@@ -82,6 +83,12 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    Status appendCacheStats(OperationContext* opCtx,
+                            const NamespaceString& nss,
+                            BSONObjBuilder* builder) const override {
+        MONGO_UNREACHABLE;
+    }
+
     Status appendRecordCount(OperationContext* opCtx,
                              const NamespaceString& nss,
                              BSONObjBuilder* builder) const override {
@@ -139,6 +146,14 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::vector<Document> lookupDocuments(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                          const NamespaceString& nss,
+                                          UUID collectionUUID,
+                                          const std::vector<Document>& documentKeys,
+                                          boost::optional<BSONObj> readConcern) {
+        MONGO_UNREACHABLE;
+    }
+
     std::vector<GenericCursor> getCursors(
         const boost::intrusive_ptr<ExpressionContext>& expCtx) const {
         MONGO_UNREACHABLE;
@@ -49,13 +49,15 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
-    size_t nConsumersStillProcessingThisBatch =
-        std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-            return info.nLeftToReturn > 0;
-        });
-
-    if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
-        loadNextBatch();
+    if (!_batchesLoadedExternally) {
+        size_t nConsumersStillProcessingThisBatch =
+            std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+                return info.nLeftToReturn > 0;
+            });
+
+        if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
+            loadNextBatch();
+        }
     }
 
     if (_buffer.empty()) {
@@ -75,6 +77,20 @@ DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
     return _buffer[bufferIndex];
 }
 
+bool TeeBuffer::loadBatchForAll() {
+    _batchesLoadedExternally = true;
+
+    if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        })) {
+        releaseIfUnused();
+        return false;
+    }
+
+    loadNextBatch();
+    return !_buffer.empty();
+}
+
 void TeeBuffer::loadNextBatch() {
     _buffer.clear();
     size_t bytesInBuffer = 0;
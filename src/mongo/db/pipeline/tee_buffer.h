@@ -65,6 +65,19 @@ public:
     void dispose(size_t consumerId) {
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
+        if (_batchesLoadedExternally) {
+            // Other consumers may be reading the batch concurrently, so whoever is loading batches
+            // releases the buffer and the source once no consumers remain. See loadBatchForAll().
+            return;
+        }
+        releaseIfUnused();
+    }
+
+    /**
+     * Clears the buffer and disposes of the source if no consumer is still in use. Once batches are
+     * loaded by loadBatchForAll(), dispose() leaves this to the caller.
+     */
+    void releaseIfUnused() {
         if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
                 return info.stillInUse;
             })) {
@@ -82,6 +95,16 @@ public:
      */
     DocumentSource::GetNextResult getNext(size_t consumerId);
 
+    /**
+     * Replaces the current batch with the next one for every consumer still in use, and returns
+     * false if there was nothing left to load. Once this has been called, getNext() never loads a
+     * batch itself, and instead returns kPauseExecution to each consumer at the end of the batch
+     * until the next call. This allows the consumers to call getNext() and dispose() concurrently
+     * on separate threads, provided that no consumer is running while this is called. Returns
+     * false without reading from the source once every consumer has been disposed.
+     */
+    bool loadBatchForAll();
+
 private:
     TeeBuffer(size_t nConsumers, size_t bufferSizeBytes);
 
@@ -102,5 +125,8 @@ private:
         int nLeftToReturn = 0;
     };
     std::vector<ConsumerInfo> _consumers;
+
+    // Set by the first call to loadBatchForAll().
+    bool _batchesLoadedExternally = false;
 };
 }  // namespace mongo
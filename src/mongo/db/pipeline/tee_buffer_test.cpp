@@ -166,5 +166,45 @@ TEST(TeeBufferTest, ShouldAllowOtherConsumersToAdvanceOnceTrailingConsumerIsDisp
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
 }
+
+TEST(TeeBufferTest, ShouldOnlyAdvanceConsumersWhenBatchIsLoadedForAll) {
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"a", 1}}, Document{{"a", 2}}};
+    auto mock = DocumentSourceMock::create(inputs);
+
+    const size_t nConsumers = 2;
+    const size_t bufferBytes = 1;  // Both docs won't fit in a single batch.
+    auto teeBuffer = TeeBuffer::create(nConsumers, bufferBytes);
+    teeBuffer->setSource(mock.get());
+
+    ASSERT_TRUE(teeBuffer->loadBatchForAll());
+    for (size_t consumerId = 0; consumerId < nConsumers; ++consumerId) {
+        auto next = teeBuffer->getNext(consumerId);
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.getDocument(), inputs.front().getDocument());
+
+        // Even once every consumer has finished the batch, they wait for the next one to be loaded.
+        ASSERT_TRUE(teeBuffer->getNext(consumerId).isPaused());
+    }
+    ASSERT_TRUE(teeBuffer->getNext(0).isPaused());
+
+    // Disposing of a consumer leaves the buffer and the source to the caller of loadBatchForAll().
+    teeBuffer->dispose(1);
+    ASSERT_FALSE(mock->isDisposed);
+
+    ASSERT_TRUE(teeBuffer->loadBatchForAll());
+    auto next = teeBuffer->getNext(0);
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(), inputs.back().getDocument());
+    ASSERT_TRUE(teeBuffer->getNext(0).isPaused());
+    ASSERT_TRUE(teeBuffer->getNext(1).isPaused());
+
+    ASSERT_FALSE(teeBuffer->loadBatchForAll());
+    ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
+
+    teeBuffer->dispose(0);
+    ASSERT_FALSE(mock->isDisposed);
+    ASSERT_FALSE(teeBuffer->loadBatchForAll());
+    ASSERT_TRUE(mock->isDisposed);
+}
 }  // namespace
 }  // namespace mongo
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 
 #include "mongo/base/status.h"
 #include "mongo/db/dbmessage.h"
@@ -170,6 +171,18 @@ public:
         return _canHaveNoopMatchNodes;
     }
 
+    /**
+     * The fingerprint of this query's plan cache key, set when the query is prepared for
+     * execution against a collection. See PlanCache::computeQueryHash().
+     */
+    boost::optional<std::uint64_t> getQueryHash() const {
+        return _queryHash;
+    }
+
+    void setQueryHash(std::uint64_t queryHash) {
+        _queryHash = queryHash;
+    }
+
 private:
     // You must go through canonicalize to create a CanonicalQuery.
     CanonicalQuery() {}
@@ -190,6 +203,8 @@ private:
     std::unique_ptr<CollatorInterface> _collator;
 
     bool _canHaveNoopMatchNodes = false;
+
+    boost::optional<std::uint64_t> _queryHash;
 };
 
 }  // namespace mongo
@@ -30,25 +30,246 @@
 
 #include "mongo/db/query/collation/collator_interface_icu.h"
 
+#include <algorithm>
+#include <array>
+#include <map>
 #include <unicode/coll.h>
 #include <unicode/sortkey.h>
+#include <unicode/uniset.h>
+#include <unicode/usetiter.h>
+#include <vector>
 
+#include "mongo/base/simple_string_data_comparator.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+struct CollatorInterfaceICU::AsciiWeights {
+    // The rank of each ASCII character among all of them under the collator, where characters
+    // that compare equal share a rank. Zero for characters which the collator ignores.
+    std::array<uint8_t, 128> ranks{};
+};
+
+class CollatorInterfaceICU::ComparisonKeyMemo {
+public:
+    static const size_t kMaxStringSize = 64;
+
+    bool lookup(StringData stringData, std::string* keyOut) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
+        if (!lk) {
+            // Don't make concurrent users of a shared collator wait on each other.
+            return false;
+        }
+        const auto& entry = _entryFor(stringData);
+        if (!entry.valid || StringData(entry.string) != stringData) {
+            return false;
+        }
+        *keyOut = entry.key;
+        return true;
+    }
+
+    void remember(StringData stringData, const std::string& key) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
+        if (!lk) {
+            return;
+        }
+        auto& entry = _entryFor(stringData);
+        entry.string.assign(stringData.rawData(), stringData.size());
+        entry.key = key;
+        entry.valid = true;
+    }
+
+private:
+    struct Entry {
+        bool valid = false;
+        std::string string;
+        std::string key;
+    };
+
+    Entry& _entryFor(StringData stringData) {
+        return _entries[SimpleStringDataComparator::kInstance.hash(stringData) % _entries.size()];
+    }
+
+    stdx::mutex _mutex;
+    std::array<Entry, 64> _entries;
+};
+
+namespace {
+
+// ASCII strings up to this size have their sort keys computed without any allocations by ICU.
+const size_t kMaxStackAsciiStringSize = 256;
+const size_t kSortKeyBufferSize = 4 * kMaxStackAsciiStringSize + 16;
+
+bool isAscii(StringData stringData) {
+    return std::all_of(
+        stringData.begin(), stringData.end(), [](char c) { return (c & 0x80) == 0; });
+}
+
+UCollationResult compareAscii(const icu::Collator& collator, StringData left, StringData right) {
+    UErrorCode status = U_ZERO_ERROR;
+    auto result = collator.compareUTF8(icu::StringPiece(left.rawData(), left.size()),
+                                       icu::StringPiece(right.rawData(), right.size()),
+                                       status);
+    fassert(50873, U_SUCCESS(status));
+    return result;
+}
+
+/**
+ * Returns the ASCII weights for 'collator', or null if ASCII strings don't compare character by
+ * character under it. The weights are derived by comparing single characters with ICU itself.
+ */
+std::shared_ptr<const CollatorInterfaceICU::AsciiWeights> makeAsciiWeights(
+    const icu::Collator& collator) {
+    // Above secondary strength, the case of each character is compared only after all of them have
+    // compared equal, which a single rank per character can't express. Case level, variable
+    // weighting and numeric ordering all look at more than one character at a time.
+    UErrorCode status = U_ZERO_ERROR;
+    const auto strength = collator.getAttribute(UCOL_STRENGTH, status);
+    if ((strength != UCOL_PRIMARY && strength != UCOL_SECONDARY) ||
+        collator.getAttribute(UCOL_CASE_LEVEL, status) != UCOL_OFF ||
+        collator.getAttribute(UCOL_ALTERNATE_HANDLING, status) != UCOL_NON_IGNORABLE ||
+        collator.getAttribute(UCOL_NUMERIC_COLLATION, status) != UCOL_OFF || U_FAILURE(status)) {
+        return nullptr;
+    }
+
+    // The root collation maps each ASCII character to a single collation element with no
+    // contractions between them, but a tailoring may not: "ch" sorts as one letter in Slovak, for
+    // example. Give up on any tailoring of ASCII characters or strings of them.
+    std::unique_ptr<icu::UnicodeSet> tailored(collator.getTailoredSet(status));
+    if (U_FAILURE(status) || !tailored) {
+        return nullptr;
+    }
+    const icu::UnicodeSet ascii(0, 0x7f);
+    icu::UnicodeSetIterator tailoredIt(*tailored);
+    while (tailoredIt.next()) {
+        if (tailoredIt.isString() ? ascii.containsAll(tailoredIt.getString())
+                                  : ascii.contains(tailoredIt.getCodepoint())) {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<icu::Collator> primary(collator.clone());
+    primary->setStrength(icu::Collator::PRIMARY);
+
+    auto weights = std::make_shared<CollatorInterfaceICU::AsciiWeights>();
+    std::vector<char> ranked;
+    for (int i = 0; i < 128; ++i) {
+        const char c = i;
+        const StringData character(&c, 1);
+        const bool ignorable = compareAscii(collator, character, "") == UCOL_EQUAL;
+        if (ignorable) {
+            weights->ranks[c] = 0;
+        } else if (compareAscii(*primary, character, "") == UCOL_EQUAL) {
+            // Only an accent or the like, which would be compared after the base characters.
+            return nullptr;
+        } else {
+            ranked.push_back(c);
+        }
+    }
+
+    const auto primaryLess = [&](char left, char right) {
+        return compareAscii(*primary, StringData(&left, 1), StringData(&right, 1)) == UCOL_LESS;
+    };
+    std::sort(ranked.begin(), ranked.end(), primaryLess);
+
+    uint8_t rank = 0;
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        const char c = ranked[i];
+        if (i == 0 || primaryLess(ranked[i - 1], c)) {
+            ++rank;
+        } else if (compareAscii(collator, StringData(&ranked[i - 1], 1), StringData(&c, 1)) !=
+                   UCOL_EQUAL) {
+            // Characters with the same base but different accents at secondary strength.
+            return nullptr;
+        }
+        weights->ranks[c] = rank;
+    }
+    return weights;
+}
+
+/**
+ * Returns the weights for 'collator', computing them only for the first collator with its
+ * configuration.
+ */
+std::shared_ptr<const CollatorInterfaceICU::AsciiWeights> getAsciiWeights(
+    const icu::Collator& collator) {
+    static stdx::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const CollatorInterfaceICU::AsciiWeights>>
+        weightsByConfiguration;
+
+    // The hash code covers the collator's attributes and tailoring.
+    UErrorCode status = U_ZERO_ERROR;
+    const icu::Locale locale = collator.getLocale(ULOC_ACTUAL_LOCALE, status);
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    const std::string configuration =
+        std::string(locale.getName()) + '#' + std::to_string(collator.hashCode());
+
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    auto it = weightsByConfiguration.find(configuration);
+    if (it == weightsByConfiguration.end()) {
+        it = weightsByConfiguration.emplace(configuration, makeAsciiWeights(collator)).first;
+    }
+    return it->second;
+}
+
+}  // namespace
+
 CollatorInterfaceICU::CollatorInterfaceICU(CollationSpec spec,
                                            std::unique_ptr<icu::Collator> collator)
-    : CollatorInterface(std::move(spec)), _collator(std::move(collator)) {}
+    : CollatorInterface(std::move(spec)),
+      _collator(std::move(collator)),
+      _asciiWeights(getAsciiWeights(*_collator)) {}
+
+CollatorInterfaceICU::CollatorInterfaceICU(CollationSpec spec,
+                                           std::unique_ptr<icu::Collator> collator,
+                                           std::shared_ptr<const AsciiWeights> asciiWeights,
+                                           bool memoizeComparisonKeys)
+    : CollatorInterface(std::move(spec)),
+      _collator(std::move(collator)),
+      _asciiWeights(std::move(asciiWeights)),
+      _comparisonKeyMemo(memoizeComparisonKeys ? stdx::make_unique<ComparisonKeyMemo>()
+                                               : nullptr) {}
+
+CollatorInterfaceICU::~CollatorInterfaceICU() = default;
 
 std::unique_ptr<CollatorInterface> CollatorInterfaceICU::clone() const {
-    auto clone = stdx::make_unique<CollatorInterfaceICU>(
-        getSpec(), std::unique_ptr<icu::Collator>(_collator->clone()));
+    const bool memoizeComparisonKeys = true;
+    std::unique_ptr<CollatorInterfaceICU> clone(
+        new CollatorInterfaceICU(getSpec(),
+                                 std::unique_ptr<icu::Collator>(_collator->clone()),
+                                 _asciiWeights,
+                                 memoizeComparisonKeys));
     return {std::move(clone)};
 }
 
 int CollatorInterfaceICU::compare(StringData left, StringData right) const {
+    if (_asciiWeights && isAscii(left) && isAscii(right)) {
+        // Compare the ranks of the characters which aren't ignored, in order.
+        const auto& ranks = _asciiWeights->ranks;
+        auto leftIt = left.begin();
+        auto rightIt = right.begin();
+        while (true) {
+            while (leftIt != left.end() && ranks[*leftIt] == 0) {
+                ++leftIt;
+            }
+            while (rightIt != right.end() && ranks[*rightIt] == 0) {
+                ++rightIt;
+            }
+            if (leftIt == left.end() || rightIt == right.end()) {
+                return (leftIt == left.end() ? 0 : 1) - (rightIt == right.end() ? 0 : 1);
+            }
+            const uint8_t leftRank = ranks[*leftIt++];
+            const uint8_t rightRank = ranks[*rightIt++];
+            if (leftRank != rightRank) {
+                return leftRank < rightRank ? -1 : 1;
+            }
+        }
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     auto compareResult = _collator->compareUTF8(icu::StringPiece(left.rawData(), left.size()),
                                                 icu::StringPiece(right.rawData(), right.size()),
@@ -73,6 +294,51 @@ int CollatorInterfaceICU::compare(StringData left, StringData right) const {
 
 CollatorInterface::ComparisonKey CollatorInterfaceICU::getComparisonKey(
     StringData stringData) const {
+    if (!_comparisonKeyMemo || stringData.size() > ComparisonKeyMemo::kMaxStringSize) {
+        return _computeComparisonKey(stringData);
+    }
+
+    std::string key;
+    if (_comparisonKeyMemo->lookup(stringData, &key)) {
+        return makeComparisonKey(std::move(key));
+    }
+    auto comparisonKey = _computeComparisonKey(stringData);
+    _comparisonKeyMemo->remember(stringData, comparisonKey.getKeyData().toString());
+    return comparisonKey;
+}
+
+CollatorInterface::ComparisonKey CollatorInterfaceICU::_computeComparisonKey(
+    StringData stringData) const {
+    if (stringData.size() <= kMaxStackAsciiStringSize && isAscii(stringData)) {
+        // An ASCII string converts to UTF-16 by widening each byte, and its sort key can be
+        // written straight into a buffer, without ICU allocating a UnicodeString and a
+        // CollationKey.
+        std::array<UChar, kMaxStackAsciiStringSize> utf16;
+        std::copy(stringData.begin(), stringData.end(), utf16.begin());
+        const int32_t utf16Length = stringData.size();
+
+        std::array<uint8_t, kSortKeyBufferSize> buffer;
+        const int32_t keyLength =
+            _collator->getSortKey(utf16.data(), utf16Length, buffer.data(), buffer.size());
+
+        // A sort key is only empty if ICU failed to allocate memory.
+        fassert(50874, keyLength > 0);
+
+        std::string key;
+        if (static_cast<size_t>(keyLength) <= buffer.size()) {
+            key.assign(reinterpret_cast<const char*>(buffer.data()), keyLength);
+        } else {
+            key.resize(keyLength);
+            _collator->getSortKey(
+                utf16.data(), utf16Length, reinterpret_cast<uint8_t*>(&key[0]), keyLength);
+        }
+
+        // As below, omit the trailing null byte.
+        invariant(key.back() == '\0');
+        key.pop_back();
+        return makeComparisonKey(std::move(key));
+    }
+
     // A StringPiece is ICU's StringData. They are logically the same abstraction.
     const icu::StringPiece stringPiece(stringData.rawData(), stringData.size());
 
@@ -44,18 +44,55 @@ namespace mongo {
  */
 class CollatorInterfaceICU final : public CollatorInterface {
 public:
+    /**
+     * Weights under which comparing two ASCII strings needs no call into ICU. See
+     * usesAsciiFastPath().
+     */
+    struct AsciiWeights;
+
     CollatorInterfaceICU(CollationSpec spec, std::unique_ptr<icu::Collator> collator);
 
+    ~CollatorInterfaceICU();
+
     std::unique_ptr<CollatorInterface> clone() const final;
 
     int compare(StringData left, StringData right) const final;
 
     ComparisonKey getComparisonKey(StringData stringData) const final;
 
+    /**
+     * Returns whether compare() orders two ASCII strings by a table of the collator's weights for
+     * each ASCII character, rather than by calling into ICU. This is the case when the collator
+     * has primary or secondary strength, does not tailor any ASCII characters, and otherwise
+     * leaves ASCII strings comparing character by character. The table is computed once per
+     * collator configuration.
+     */
+    bool usesAsciiFastPath() const {
+        return static_cast<bool>(_asciiWeights);
+    }
+
 private:
+    class ComparisonKeyMemo;
+
+    CollatorInterfaceICU(CollationSpec spec,
+                         std::unique_ptr<icu::Collator> collator,
+                         std::shared_ptr<const AsciiWeights> asciiWeights,
+                         bool memoizeComparisonKeys);
+
+    ComparisonKey _computeComparisonKey(StringData stringData) const;
+
     // The ICU implementation of the collator to which we delegate interesting work. Const methods
     // on the ICU collator are expected to be thread-safe.
     const std::unique_ptr<icu::Collator> _collator;
+
+    // Null unless compare() can take the ASCII fast path. Shared by every collator with the same
+    // configuration.
+    const std::shared_ptr<const AsciiWeights> _asciiWeights;
+
+    // Recently computed comparison keys. Only clones, which an operation makes of a collection or
+    // query collator for its own use, remember keys, so that repeated values in a sort or $group
+    // are only run through ICU once.
+    const std::unique_ptr<ComparisonKeyMemo> _comparisonKeyMemo;
 };
 
 }  // namespace mongo
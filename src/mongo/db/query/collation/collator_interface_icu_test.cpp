@@ -33,7 +33,9 @@
 #include <iomanip>
 #include <iostream>
 #include <unicode/coll.h>
+#include <vector>
 
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -99,6 +101,72 @@ void assertNotEqualEnUS(StringData left, StringData right) {
     assertEnUSComparison(right, left, ExpectedComparison::NOT_EQUAL);
 }
 
+// Returns a collator for 'locale' with the given strength.
+std::unique_ptr<CollatorInterfaceICU> makeCollator(const char* locale,
+                                                   CollationSpec::StrengthType strength) {
+    CollationSpec collationSpec;
+    collationSpec.localeID = locale;
+    collationSpec.strength = strength;
+
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> coll(
+        icu::Collator::createInstance(icu::Locale::createFromName(locale), status));
+    ASSERT(U_SUCCESS(status));
+    coll->setStrength(static_cast<icu::Collator::ECollationStrength>(
+        static_cast<int>(strength) - 1));
+    return stdx::make_unique<CollatorInterfaceICU>(collationSpec, std::move(coll));
+}
+
+TEST(CollatorInterfaceICUTest, AsciiFastPathOnlyUsedBelowTertiaryStrength) {
+    ASSERT_TRUE(makeCollator("en_US", CollationSpec::StrengthType::kPrimary)->usesAsciiFastPath());
+    ASSERT_TRUE(
+        makeCollator("en_US", CollationSpec::StrengthType::kSecondary)->usesAsciiFastPath());
+    ASSERT_FALSE(
+        makeCollator("en_US", CollationSpec::StrengthType::kTertiary)->usesAsciiFastPath());
+}
+
+TEST(CollatorInterfaceICUTest, AsciiFastPathNotUsedWhenLocaleTailorsAscii) {
+    // Slovak sorts "ch" as a single letter after "h".
+    auto collator = makeCollator("sk", CollationSpec::StrengthType::kSecondary);
+    ASSERT_FALSE(collator->usesAsciiFastPath());
+    ASSERT_GT(collator->compare("ch", "hz"), 0);
+}
+
+TEST(CollatorInterfaceICUTest, AsciiFastPathMatchesComparisonKeys) {
+    auto collator = makeCollator("en_US", CollationSpec::StrengthType::kSecondary);
+    ASSERT_TRUE(collator->usesAsciiFastPath());
+
+    const std::vector<std::string> strings = {
+        "", "a", "A", "ab", "aB", "b", "a-b", "a b", "ab ", "a\x01b", "1", "10", "2", "_", "~",
+        "Z", "z!", "abc", "abcd", "ABC", "\x7f", "a\x7f", "-a", "a\xC3\xA9"};
+    for (auto&& left : strings) {
+        for (auto&& right : strings) {
+            const int cmp = collator->compare(left, right);
+            const int keyCmp = collator->getComparisonKey(left).getKeyData().compare(
+                collator->getComparisonKey(right).getKeyData());
+            ASSERT_EQ(cmp < 0, keyCmp < 0) << left << " vs " << right;
+            ASSERT_EQ(cmp == 0, keyCmp == 0) << left << " vs " << right;
+        }
+    }
+
+    // Case and control characters are ignored at secondary strength.
+    ASSERT_EQ(collator->compare("aBc", "A\x01bC"), 0);
+    ASSERT_LT(collator->compare("ab", "abc"), 0);
+}
+
+TEST(CollatorInterfaceICUTest, ClonedCollatorRemembersComparisonKeys) {
+    auto collator = makeCollator("en_US", CollationSpec::StrengthType::kTertiary);
+    auto clone = collator->clone();
+
+    const std::string longString(1000, 'x');
+    for (int i = 0; i < 3; i++) {
+        for (auto&& str : {"abc", "c\xC3\xB4t\xC3\xA9", "", longString.c_str()}) {
+            ASSERT_EQ(clone->getComparisonKey(str).getKeyData(),
+                      collator->getComparisonKey(str).getKeyData());
+        }
+    }
+}
+
 TEST(CollatorInterfaceICUTest, ClonedCollatorMatchesOriginal) {
     CollationSpec collationSpec;
     collationSpec.localeID = "en_US";
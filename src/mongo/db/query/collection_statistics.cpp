@@ -0,0 +1,275 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+/**
+ * Returns where 'value' lies between 'lower' and 'upper', from 0 to 1. Only numbers can be
+ * interpolated; anything else is assumed to lie halfway.
+ */
+double interpolate(const BSONElement& lower, const BSONElement& upper, const BSONElement& value) {
+    if (!lower.isNumber() || !upper.isNumber() || !value.isNumber()) {
+        return 0.5;
+    }
+    const double width = upper.numberDouble() - lower.numberDouble();
+    if (!(width > 0)) {
+        return 0.5;
+    }
+    const double fraction = (value.numberDouble() - lower.numberDouble()) / width;
+    return std::max(0.0, std::min(1.0, fraction));
+}
+
+/**
+ * Returns true if 'oil' is the single interval of all values, in either direction.
+ */
+bool isAllValues(const OrderedIntervalList& oil) {
+    if (oil.intervals.size() != 1) {
+        return false;
+    }
+    const Interval& interval = oil.intervals.front();
+    if (!interval.startInclusive || !interval.endInclusive) {
+        return false;
+    }
+    return (interval.start.type() == MinKey && interval.end.type() == MaxKey) ||
+        (interval.start.type() == MaxKey && interval.end.type() == MinKey);
+}
+
+}  // namespace
+
+// static
+FieldHistogram FieldHistogram::make(std::vector<BSONObj> values, size_t maxBuckets) {
+    invariant(maxBuckets >= 2);
+
+    FieldHistogram histogram;
+    if (values.empty()) {
+        return histogram;
+    }
+
+    std::sort(values.begin(), values.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return compareValues(lhs.firstElement(), rhs.firstElement()) < 0;
+    });
+    histogram._numValues = values.size();
+
+    const double targetDepth = values.size() / static_cast<double>(maxBuckets - 1);
+    Bucket current;
+    for (size_t runStart = 0; runStart < values.size();) {
+        size_t runEnd = runStart + 1;
+        while (runEnd < values.size() &&
+               compareValues(values[runEnd].firstElement(), values[runStart].firstElement()) == 0) {
+            ++runEnd;
+        }
+        const double runCount = runEnd - runStart;
+        ++histogram._numDistinct;
+
+        // The smallest value gets a bucket of its own, so that the range of every bucket has a
+        // lower bound. The largest value closes the last bucket.
+        const bool isLast = runEnd == values.size();
+        const bool closeBucket = histogram._buckets.empty() || isLast ||
+            (current.rangeCount + runCount >= targetDepth &&
+             histogram._buckets.size() + 1 < maxBuckets);
+        if (closeBucket) {
+            current.upperBound = values[runStart].getOwned();
+            current.boundCount = runCount;
+            histogram._buckets.push_back(std::move(current));
+            current = Bucket();
+        } else {
+            current.rangeCount += runCount;
+            ++current.rangeDistinct;
+        }
+        runStart = runEnd;
+    }
+
+    return histogram;
+}
+
+double FieldHistogram::_countBelow(const BSONElement& value, bool inclusive) const {
+    double count = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        const Bucket& bucket = _buckets[i];
+        const BSONElement upper = bucket.upperBound.firstElement();
+        const int cmp = compareValues(value, upper);
+        if (cmp > 0) {
+            count += bucket.rangeCount + bucket.boundCount;
+            continue;
+        }
+        if (cmp == 0) {
+            return count + bucket.rangeCount + (inclusive ? bucket.boundCount : 0);
+        }
+
+        // 'value' is below this bucket's upper bound. The first bucket has an empty range, so
+        // 'value' is then below every sampled value.
+        if (i == 0 || bucket.rangeCount == 0) {
+            return count;
+        }
+
+        // Assume that the distinct values of the range are equally frequent.
+        const double equalCount = bucket.rangeCount / bucket.rangeDistinct;
+        const BSONElement lower = _buckets[i - 1].upperBound.firstElement();
+        const double lessCount =
+            interpolate(lower, upper, value) * (bucket.rangeCount - equalCount);
+        return count + lessCount + (inclusive ? equalCount : 0);
+    }
+    return count;
+}
+
+double FieldHistogram::estimateFraction(const OrderedIntervalList& oil) const {
+    if (_numValues == 0) {
+        return 0;
+    }
+
+    double count = 0;
+    for (Interval interval : oil.intervals) {
+        // The intervals of a descending index field run from high to low.
+        if (compareValues(interval.start, interval.end) > 0) {
+            interval.reverse();
+        }
+        const double beforeStart = _countBelow(interval.start, !interval.startInclusive);
+        const double throughEnd = _countBelow(interval.end, interval.endInclusive);
+        count += std::max(0.0, throughEnd - beforeStart);
+    }
+    return std::min(1.0, count / _numValues);
+}
+
+void FieldHistogram::serialize(BSONObjBuilder* builder) const {
+    builder->append("sampledValues", static_cast<long long>(_numValues));
+    builder->append("distinctValues", static_cast<long long>(_numDistinct));
+    BSONArrayBuilder bucketsBuilder(builder->subarrayStart("buckets"));
+    for (auto&& bucket : _buckets) {
+        BSONObjBuilder bucketBuilder(bucketsBuilder.subobjStart());
+        bucketBuilder.appendAs(bucket.upperBound.firstElement(), "upperBound");
+        bucketBuilder.append("boundCount", static_cast<long long>(bucket.boundCount));
+        bucketBuilder.append("rangeCount", static_cast<long long>(bucket.rangeCount));
+        bucketBuilder.append("rangeDistinct", static_cast<long long>(bucket.rangeDistinct));
+    }
+}
+
+std::shared_ptr<const IndexStatistics> CollectionStatistics::get(StringData indexName,
+                                                                 const BSONObj& keyPattern) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _indexStats.find(indexName);
+    if (it == _indexStats.end() || it->second->keyPattern.woCompare(keyPattern) != 0) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void CollectionStatistics::set(StringData indexName,
+                               std::shared_ptr<const IndexStatistics> stats) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _indexStats[indexName] = std::move(stats);
+}
+
+void CollectionStatistics::remove(StringData indexName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _indexStats.erase(indexName);
+}
+
+bool CollectionStatistics::empty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _indexStats.empty();
+}
+
+boost::optional<double> estimatePlanWork(const QuerySolutionNode* node,
+                                         const CollectionStatistics& stats,
+                                         long long numRecords) {
+    switch (node->getType()) {
+        case STAGE_COLLSCAN:
+            return static_cast<double>(numRecords);
+
+        case STAGE_IXSCAN: {
+            auto ixscan = static_cast<const IndexScanNode*>(node);
+            if (ixscan->index.type != INDEX_BTREE || ixscan->bounds.isSimpleRange ||
+                ixscan->bounds.fields.empty()) {
+                return boost::none;
+            }
+            auto indexStats = stats.get(ixscan->index.name, ixscan->index.keyPattern);
+            if (!indexStats) {
+                return boost::none;
+            }
+            // Only the leading field has a histogram. Bounds on a later field let the scan skip
+            // keys, so a count from the leading field alone could be far too high.
+            if (!std::all_of(ixscan->bounds.fields.begin() + 1,
+                             ixscan->bounds.fields.end(),
+                             isAllValues)) {
+                return boost::none;
+            }
+            const double keys = indexStats->keysPerDocument * numRecords *
+                indexStats->leadingField.estimateFraction(ixscan->bounds.fields[0]);
+            // A value that is missing from the sample may still be in the index, and looking it
+            // up costs at least one key.
+            return std::max(1.0, keys);
+        }
+
+        case STAGE_FETCH:
+        case STAGE_PROJECTION:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SKIP:
+        case STAGE_LIMIT:
+        case STAGE_KEEP_MUTATIONS:
+        case STAGE_OR:
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED:
+        case STAGE_SORT_MERGE: {
+            double work = 0;
+            for (auto child : node->children) {
+                auto childWork = estimatePlanWork(child, stats, numRecords);
+                if (!childWork) {
+                    return boost::none;
+                }
+                work += *childWork;
+            }
+            // A fetch reads one document for every key its child passes up.
+            if (node->getType() == STAGE_FETCH) {
+                work *= 2;
+            }
+            return work;
+        }
+
+        default:
+            return boost::none;
+    }
+}
+
+}  // namespace mongo
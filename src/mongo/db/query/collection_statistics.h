@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+struct OrderedIntervalList;
+struct QuerySolutionNode;
+
+/**
+ * An equi-depth histogram of a sample of the values of one field. Every bucket holds roughly the
+ * same number of sampled values. A bucket is bounded above by a sampled value, whose frequency is
+ * kept exactly, and covers the values between the previous bucket's bound and its own, which are
+ * only summarized by their count and number of distinct values.
+ *
+ * Values are ordered the way an index orders them, so the histogram of the leading field of an
+ * index's keys can be compared directly with the index bounds of a query.
+ */
+class FieldHistogram {
+public:
+    static const size_t kMaxBuckets = 64;
+
+    struct Bucket {
+        // A single-element object holding the largest value in the bucket.
+        BSONObj upperBound;
+
+        // The number of sampled values equal to 'upperBound'.
+        double boundCount = 0;
+
+        // The number, and the number of distinct, sampled values between the previous bucket's
+        // upper bound and this one, both exclusive.
+        double rangeCount = 0;
+        double rangeDistinct = 0;
+    };
+
+    FieldHistogram() = default;
+
+    /**
+     * Builds a histogram of at most 'maxBuckets' buckets from 'values', each of which is an object
+     * with a single element. The field names are ignored.
+     */
+    static FieldHistogram make(std::vector<BSONObj> values, size_t maxBuckets = kMaxBuckets);
+
+    /**
+     * Returns the estimated fraction, from 0 to 1, of the values that fall within the intervals
+     * of 'oil'. The intervals may be in either direction.
+     */
+    double estimateFraction(const OrderedIntervalList& oil) const;
+
+    double getNumValues() const {
+        return _numValues;
+    }
+
+    double getNumDistinct() const {
+        return _numDistinct;
+    }
+
+    const std::vector<Bucket>& getBuckets() const {
+        return _buckets;
+    }
+
+    void serialize(BSONObjBuilder* builder) const;
+
+private:
+    /**
+     * Returns the estimated number of values less than 'value', or less than or equal to it if
+     * 'inclusive' is true.
+     */
+    double _countBelow(const BSONElement& value, bool inclusive) const;
+
+    std::vector<Bucket> _buckets;
+    double _numValues = 0;
+    double _numDistinct = 0;
+};
+
+/**
+ * Statistics on the keys of one index, gathered from a sample of the collection's documents.
+ */
+struct IndexStatistics {
+    // The key pattern of the index the statistics were gathered for. Statistics are only used
+    // for an index with the same key pattern, so that they are never applied to a rebuilt index
+    // of the same name.
+    BSONObj keyPattern;
+
+    // The histogram of the leading field of the sampled keys.
+    FieldHistogram leadingField;
+
+    // The average number of keys each sampled document generated. It is above 1 for a multikey
+    // index and may be below 1 for a sparse or partial index.
+    double keysPerDocument = 0;
+
+    long long sampledDocuments = 0;
+};
+
+/**
+ * The statistics gathered by the analyze command for the indexes of one collection. Owned by the
+ * collection's CollectionInfoCache. This class is thread-safe.
+ */
+class CollectionStatistics {
+    MONGO_DISALLOW_COPYING(CollectionStatistics);
+
+public:
+    CollectionStatistics() = default;
+
+    /**
+     * Returns the statistics for the index 'indexName', or nullptr if there are none or they were
+     * gathered for a different key pattern.
+     */
+    std::shared_ptr<const IndexStatistics> get(StringData indexName,
+                                               const BSONObj& keyPattern) const;
+
+    void set(StringData indexName, std::shared_ptr<const IndexStatistics> stats);
+
+    void remove(StringData indexName);
+
+    bool empty() const;
+
+private:
+    mutable stdx::mutex _mutex;
+    StringMap<std::shared_ptr<const IndexStatistics>> _indexStats;
+};
+
+/**
+ * Estimates how many index keys and documents the plan rooted at 'node' examines against a
+ * collection of 'numRecords' documents.
+ *
+ * Returns boost::none if the plan has a stage the estimate does not cover, scans an index for
+ * which 'stats' has no statistics, or bounds any index field but the first.
+ */
+boost::optional<double> estimatePlanWork(const QuerySolutionNode* node,
+                                         const CollectionStatistics& stats,
+                                         long long numRecords);
+
+}  // namespace mongo
@@ -0,0 +1,219 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeValues(int first, int last, int copies = 1) {
+    std::vector<BSONObj> values;
+    for (int i = first; i <= last; ++i) {
+        for (int copy = 0; copy < copies; ++copy) {
+            values.push_back(BSON("" << i));
+        }
+    }
+    return values;
+}
+
+OrderedIntervalList makeOIL(const Interval& interval) {
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(interval);
+    return oil;
+}
+
+OrderedIntervalList makePointOIL(int value) {
+    return makeOIL(Interval(BSON("" << value << "" << value), true, true));
+}
+
+TEST(FieldHistogramTest, EmptyHistogramEstimatesNothing) {
+    auto histogram = FieldHistogram::make({});
+    ASSERT_EQ(0U, histogram.getBuckets().size());
+    ASSERT_EQ(0.0, histogram.estimateFraction(makePointOIL(1)));
+}
+
+TEST(FieldHistogramTest, BucketsHoldRoughlyEqualCounts) {
+    auto histogram = FieldHistogram::make(makeValues(0, 999), 11);
+    ASSERT_EQ(1000.0, histogram.getNumValues());
+    ASSERT_EQ(1000.0, histogram.getNumDistinct());
+    ASSERT_EQ(11U, histogram.getBuckets().size());
+
+    // The smallest value has a bucket of its own.
+    ASSERT_EQ(0, histogram.getBuckets()[0].upperBound.firstElement().numberInt());
+    ASSERT_EQ(0.0, histogram.getBuckets()[0].rangeCount);
+    ASSERT_EQ(999, histogram.getBuckets().back().upperBound.firstElement().numberInt());
+    for (size_t i = 1; i + 1 < histogram.getBuckets().size(); ++i) {
+        ASSERT_EQ(100.0, histogram.getBuckets()[i].rangeCount + 1);
+    }
+}
+
+TEST(FieldHistogramTest, EstimatesRangesOfUniformValues) {
+    auto histogram = FieldHistogram::make(makeValues(0, 999));
+    auto range = makeOIL(Interval(BSON("" << 100 << "" << 300), true, false));
+    ASSERT_APPROX_EQUAL(0.2, histogram.estimateFraction(range), 0.01);
+
+    auto all = makeOIL(Interval(BSON("" << MINKEY << "" << MAXKEY), true, true));
+    ASSERT_APPROX_EQUAL(1.0, histogram.estimateFraction(all), 1e-9);
+
+    auto none = makeOIL(Interval(BSON("" << 2000 << "" << 3000), true, true));
+    ASSERT_EQ(0.0, histogram.estimateFraction(none));
+
+    ASSERT_APPROX_EQUAL(0.001, histogram.estimateFraction(makePointOIL(500)), 1e-9);
+}
+
+TEST(FieldHistogramTest, EstimatesFrequentValuesExactly) {
+    // 90% of the values are 1, and the rest are spread over 100 values.
+    auto values = makeValues(1, 1, 900);
+    auto rare = makeValues(2, 101);
+    values.insert(values.end(), rare.begin(), rare.end());
+
+    auto histogram = FieldHistogram::make(values);
+    ASSERT_EQ(101.0, histogram.getNumDistinct());
+    ASSERT_EQ(0.9, histogram.estimateFraction(makePointOIL(1)));
+    ASSERT_APPROX_EQUAL(0.001, histogram.estimateFraction(makePointOIL(50)), 1e-9);
+}
+
+TEST(FieldHistogramTest, AcceptsDescendingIntervals) {
+    auto histogram = FieldHistogram::make(makeValues(0, 999));
+    auto ascending = makeOIL(Interval(BSON("" << 100 << "" << 300), true, true));
+    auto descending = makeOIL(Interval(BSON("" << 300 << "" << 100), true, true));
+    ASSERT_EQ(histogram.estimateFraction(ascending), histogram.estimateFraction(descending));
+}
+
+TEST(FieldHistogramTest, OrdersValuesOfDifferentTypesLikeAnIndex) {
+    auto values = makeValues(0, 9);
+    values.push_back(BSON("" << BSONNULL));
+    values.push_back(BSON(""
+                          << "str"));
+    auto histogram = FieldHistogram::make(values);
+    auto strings = makeOIL(Interval(BSON(""
+                                         << ""
+                                         << "" << BSONObj()),
+                                    true,
+                                    false));
+    ASSERT_APPROX_EQUAL(1.0 / 12, histogram.estimateFraction(strings), 1e-9);
+    ASSERT_APPROX_EQUAL(
+        1.0 / 12,
+        histogram.estimateFraction(makeOIL(Interval(BSON("" << BSONNULL << "" << BSONNULL),
+                                                    true,
+                                                    true))),
+        1e-9);
+}
+
+class EstimatePlanWorkTest : public unittest::Test {
+protected:
+    void setUp() final {
+        auto indexStats = std::make_shared<IndexStatistics>();
+        indexStats->keyPattern = BSON("a" << 1);
+        indexStats->keysPerDocument = 2;
+        indexStats->sampledDocuments = 500;
+        indexStats->leadingField = FieldHistogram::make(makeValues(0, 999));
+        stats.set("a_1", std::move(indexStats));
+    }
+
+    std::unique_ptr<QuerySolutionNode> makeFetch(const BSONObj& keyPattern,
+                                                 const std::string& name,
+                                                 const Interval& interval) {
+        auto ixscan = stdx::make_unique<IndexScanNode>(IndexEntry(keyPattern, name));
+        ixscan->bounds.fields.push_back(makeOIL(interval));
+        auto fetch = stdx::make_unique<FetchNode>();
+        fetch->children.push_back(ixscan.release());
+        return std::move(fetch);
+    }
+
+    CollectionStatistics stats;
+};
+
+TEST_F(EstimatePlanWorkTest, CountsKeysAndFetchedDocuments) {
+    auto fetch =
+        makeFetch(BSON("a" << 1), "a_1", Interval(BSON("" << 0 << "" << 100), true, false));
+    auto work = estimatePlanWork(fetch.get(), stats, 1000);
+    ASSERT(work);
+    // A tenth of the 2000 keys, each of which is fetched.
+    ASSERT_APPROX_EQUAL(400.0, *work, 10.0);
+}
+
+TEST_F(EstimatePlanWorkTest, CollectionScanReadsEveryDocument) {
+    CollectionScanNode collScan;
+    ASSERT_EQ(1000.0, *estimatePlanWork(&collScan, stats, 1000));
+}
+
+TEST_F(EstimatePlanWorkTest, IndexWithoutStatisticsCannotBeEstimated) {
+    auto fetch =
+        makeFetch(BSON("b" << 1), "b_1", Interval(BSON("" << 0 << "" << 100), true, false));
+    ASSERT_FALSE(estimatePlanWork(fetch.get(), stats, 1000));
+
+    // Statistics gathered for another key pattern under the same name are ignored.
+    fetch = makeFetch(
+        BSON("a" << 1 << "b" << 1), "a_1", Interval(BSON("" << 0 << "" << 100), true, false));
+    ASSERT_FALSE(estimatePlanWork(fetch.get(), stats, 1000));
+}
+
+TEST_F(EstimatePlanWorkTest, IndexScanExaminesAtLeastOneKey) {
+    auto fetch =
+        makeFetch(BSON("a" << 1), "a_1", Interval(BSON("" << 5000 << "" << 5000), true, true));
+    ASSERT_EQ(2.0, *estimatePlanWork(fetch.get(), stats, 1000));
+}
+
+TEST_F(EstimatePlanWorkTest, BoundsOnLaterIndexFieldsCannotBeEstimated) {
+    auto indexStats = std::make_shared<IndexStatistics>();
+    indexStats->keyPattern = BSON("a" << 1 << "b" << 1);
+    indexStats->keysPerDocument = 1;
+    indexStats->sampledDocuments = 500;
+    indexStats->leadingField = FieldHistogram::make(makeValues(0, 999));
+    stats.set("a_1_b_1", std::move(indexStats));
+
+    auto fetch = makeFetch(BSON("a" << 1 << "b" << 1),
+                           "a_1_b_1",
+                           Interval(BSON("" << 0 << "" << 100), true, false));
+    auto ixscan = static_cast<IndexScanNode*>(fetch->children[0]);
+    ixscan->bounds.fields.push_back(
+        makeOIL(Interval(BSON("" << MINKEY << "" << MAXKEY), true, true)));
+    ASSERT(estimatePlanWork(fetch.get(), stats, 1000));
+
+    ixscan->bounds.fields.back() = makeOIL(Interval(BSON("" << 5 << "" << 5), true, true));
+    ASSERT_FALSE(estimatePlanWork(fetch.get(), stats, 1000));
+}
+
+TEST_F(EstimatePlanWorkTest, RemovedStatisticsAreGone) {
+    stats.remove("a_1");
+    ASSERT(stats.empty());
+    CollectionScanNode collScan;
+    ASSERT(estimatePlanWork(&collScan, stats, 1000));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/util/hex.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/version.h"
@@ -186,6 +188,33 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     return 0;
 }
 
+/**
+ * Given the SpecificStats object for a stage and the type of the stage, returns the memory
+ * statistics of the stage, or boost::none if the stage does not buffer data.
+ *
+ * This is used to find the largest peak memory usage among the stages of a plan, and the number of
+ * times they spilled, for the slow query log / profiler (in which case this gets called from
+ * Explain::getSummaryStats()).
+ */
+boost::optional<StageMemoryStats> getStageMemoryStats(StageType type,
+                                                      const SpecificStats* specific) {
+    StageMemoryStats memoryStats;
+    if (STAGE_SORT == type) {
+        const SortStats* spec = static_cast<const SortStats*>(specific);
+        memoryStats.peakMemUsage = spec->peakMemUsage;
+        memoryStats.spills = spec->spills;
+    } else if (STAGE_AND_HASH == type) {
+        const AndHashStats* spec = static_cast<const AndHashStats*>(specific);
+        memoryStats.peakMemUsage = spec->peakMemUsage;
+    } else if (STAGE_TEXT_OR == type) {
+        const TextOrStats* spec = static_cast<const TextOrStats*>(specific);
+        memoryStats.peakMemUsage = spec->peakMemUsage;
+    } else {
+        return boost::none;
+    }
+    return memoryStats;
+}
+
 /**
  * Adds to the plan summary string being built by 'sb' for the execution stage 'stage'.
  */
@@ -338,6 +367,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
 
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
+            bob->appendNumber("peakMemUsage", spec->peakMemUsage);
             bob->appendNumber("memLimit", spec->memLimit);
 
             bob->appendNumber("flaggedButPassed", spec->flaggedButPassed);
@@ -346,6 +376,11 @@ void Explain::statsToBSON(const PlanStageStats& stats,
                 bob->appendNumber(string(stream() << "mapAfterChild_" << i),
                                   spec->mapAfterChild[i]);
             }
+
+            bob->appendNumber("filterTested", spec->filterTested);
+            bob->appendNumber("filterRejected", spec->filterRejected);
+            bob->appendNumber("filterFalsePositives", spec->filterFalsePositives);
+            bob->appendNumber("filterMemUsage", spec->filterMemUsage);
         }
     } else if (STAGE_AND_SORTED == stats.stageType) {
         AndSortedStats* spec = static_cast<AndSortedStats*>(stats.specific.get());
@@ -537,7 +572,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
 
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
+            bob->appendNumber("peakMemUsage", spec->peakMemUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendBool("usedDisk", spec->usedDisk);
+            bob->appendNumber("spills", spec->spills);
+            if (spec->usedDisk) {
+                bob->appendNumber("spilledBytes", spec->spilledBytes);
+                bob->appendNumber("spilledBytesUncompressed", spec->spilledBytesUncompressed);
+                bob->appendNumber("spillMergePasses", spec->spillMergePasses);
+            }
         }
 
         if (spec->limit > 0) {
@@ -567,8 +610,14 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_TEXT_OR == stats.stageType) {
         TextOrStats* spec = static_cast<TextOrStats*>(stats.specific.get());
 
+        if (spec->topK) {
+            bob->appendNumber("topK", spec->topK);
+        }
+
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->fetches);
+            bob->appendNumber("memUsage", spec->memUsage);
+            bob->appendNumber("peakMemUsage", spec->peakMemUsage);
         }
     } else if (STAGE_UPDATE == stats.stageType) {
         UpdateStats* spec = static_cast<UpdateStats*>(stats.specific.get());
@@ -649,17 +698,22 @@ void Explain::generatePlannerInfo(PlanExecutor* exec,
     // Find whether there is an index filter set for the query shape. The 'indexFilterSet'
     // field will always be false in the case of EOF or idhack plans.
     bool indexFilterSet = false;
+    boost::optional<std::uint64_t> queryHash;
     if (collection && exec->getCanonicalQuery()) {
         const CollectionInfoCache* infoCache = collection->infoCache();
         const QuerySettings* querySettings = infoCache->getQuerySettings();
         PlanCacheKey planCacheKey =
             infoCache->getPlanCache()->computeKey(*exec->getCanonicalQuery());
+        queryHash = PlanCache::computeQueryHash(planCacheKey);
         if (auto allowedIndicesFilter = querySettings->getAllowedIndicesFilter(planCacheKey)) {
             // Found an index filter set on the query shape.
             indexFilterSet = true;
         }
     }
     plannerBob.append("indexFilterSet", indexFilterSet);
+    if (queryHash) {
+        plannerBob.append("queryHash", unsignedIntToFixedLengthHex(*queryHash));
+    }
 
     // In general we should have a canonical query, but sometimes we may avoid
     // creating a canonical query as an optimization (specifically, the update system
@@ -928,6 +982,10 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
     statsOut->nReturned = common->advanced;
     statsOut->executionTimeMillis = common->executionTimeMillis;
 
+    if (CanonicalQuery* cq = exec.getCanonicalQuery()) {
+        statsOut->queryHash = cq->getQueryHash();
+    }
+
     // The other fields are aggregations over the stages in the plan tree. We flatten
     // the tree into a list and then compute these aggregations.
     std::vector<const PlanStage*> stages;
@@ -935,6 +993,8 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
 
     statsOut->totalKeysExamined = 0;
     statsOut->totalDocsExamined = 0;
+    statsOut->peakStageMemUsage = 0;
+    statsOut->stageSpills = 0;
 
     for (size_t i = 0; i < stages.size(); i++) {
         statsOut->totalKeysExamined +=
@@ -946,6 +1006,11 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             statsOut->hasSortStage = true;
         }
 
+        if (auto memoryStats =
+                getStageMemoryStats(stages[i]->stageType(), stages[i]->getSpecificStats())) {
+            statsOut->addStageMemoryStats(*memoryStats);
+        }
+
         if (STAGE_IXSCAN == stages[i]->stageType()) {
             const IndexScan* ixscan = static_cast<const IndexScan*>(stages[i]);
             const IndexScanStats* ixscanStats =
@@ -59,4 +59,7 @@ extern AtomicInt32 internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern AtomicInt32 internalQueryS2GeoMaxCells;
 
+// The maximum size in bytes of the cached geo query coverings. Zero disables the cache.
+extern AtomicInt32 internalQueryGeoCoveringCacheSizeBytes;
+
 }  // namespace mongo
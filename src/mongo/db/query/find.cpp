@@ -40,6 +40,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/cursor_prefetcher.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -180,7 +181,7 @@ void generateBatch(int ntoreturn,
            PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
         // If we can't fit this result inside the current batch, then we stash it for later.
         if (!FindCommon::haveSpaceForNext(obj, *numResults, bb->len())) {
-            exec->enqueue(obj);
+            exec->requeue(obj);
             break;
         }
 
@@ -235,6 +236,12 @@ Message getMore(OperationContext* opCtx,
 
     const NamespaceString nss(ns);
 
+    // A cursor opened by the find command may be pinned by a background prefetch. Stop it before
+    // taking any locks.
+    if (!CursorManager::isGloballyManagedCursor(cursorid)) {
+        CursorPrefetcher::get(opCtx->getServiceContext())->waitForPrefetch(opCtx, cursorid);
+    }
+
     // Cursors come in one of two flavors:
     // - Cursors owned by the collection cursor manager, such as those generated via the find
     //   command. For these cursors, we hold the appropriate collection lock for the duration of the
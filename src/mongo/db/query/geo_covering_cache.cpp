@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/geo_covering_cache.h"
+
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/query/expression_index_knobs.h"
+
+namespace mongo {
+
+namespace {
+
+GeoCoveringCache globalGeoCoveringCache;
+
+ServerStatusMetricField<Counter64> displayHits("query.geoCoveringCache.hits",
+                                               &globalGeoCoveringCache.hits());
+ServerStatusMetricField<Counter64> displayMisses("query.geoCoveringCache.misses",
+                                                 &globalGeoCoveringCache.misses());
+ServerStatusMetricField<Counter64> displayEvictions("query.geoCoveringCache.evictions",
+                                                    &globalGeoCoveringCache.evictions());
+
+// Approximates the memory held by an entry besides its key and interval bounds: the list node,
+// the hash table slot and the vector and control block headers.
+const long long kEntryOverheadBytes = 128;
+
+long long entrySizeBytes(const std::string& key, const GeoCoveringCache::Intervals& intervals) {
+    long long size = kEntryOverheadBytes + 2 * key.size();
+    for (const auto& interval : intervals) {
+        size += sizeof(Interval) + interval._intervalData.objsize();
+    }
+    return size;
+}
+
+}  // namespace
+
+GeoCoveringCache& GeoCoveringCache::get() {
+    return globalGeoCoveringCache;
+}
+
+std::string GeoCoveringCache::makeKey(StringData indexType,
+                                      const BSONObj& geoSpec,
+                                      const BSONObj& indexInfoObj,
+                                      const BSONObj& coveringParams) {
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("type", indexType);
+    keyBuilder.append("geo", geoSpec);
+    keyBuilder.append("index", indexInfoObj);
+    keyBuilder.append("params", coveringParams);
+    BSONObj keyObj = keyBuilder.done();
+    return std::string(keyObj.objdata(), keyObj.objsize());
+}
+
+std::shared_ptr<const GeoCoveringCache::Intervals> GeoCoveringCache::find(const std::string& key) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        _misses.increment();
+        return nullptr;
+    }
+
+    _hits.increment();
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->intervals;
+}
+
+void GeoCoveringCache::insert(const std::string& key, Intervals intervals) {
+    const long long maxBytes = internalQueryGeoCoveringCacheSizeBytes.load();
+    const long long sizeBytes = entrySizeBytes(key, intervals);
+    if (sizeBytes > maxBytes) {
+        return;
+    }
+
+    auto shared = std::make_shared<const Intervals>(std::move(intervals));
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+        // Another query computed the same covering concurrently.
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return;
+    }
+
+    _evictDownTo(maxBytes - sizeBytes);
+    _entries.push_front({key, std::move(shared), sizeBytes});
+    _index.emplace(key, _entries.begin());
+    _sizeBytes += sizeBytes;
+}
+
+void GeoCoveringCache::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _index.clear();
+    _entries.clear();
+    _sizeBytes = 0;
+}
+
+long long GeoCoveringCache::sizeBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sizeBytes;
+}
+
+void GeoCoveringCache::_evictDownTo(long long maxBytes) {
+    while (!_entries.empty() && _sizeBytes > maxBytes) {
+        const Entry& oldest = _entries.back();
+        _sizeBytes -= oldest.sizeBytes;
+        _index.erase(oldest.key);
+        _entries.pop_back();
+        _evictions.increment();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/counter.h"
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * Caches the index intervals which cover the region of a geo predicate, so that repeated queries
+ * on the same region skip recomputing the covering. Entries are keyed by the predicate's geo
+ * specification together with the index spec and the covering knobs, so an entry is only shared by
+ * queries which would compute identical intervals.
+ *
+ * The cache holds at most internalQueryGeoCoveringCacheSizeBytes worth of entries, evicting the
+ * least recently used first. A size of zero disables it. All methods are thread safe.
+ */
+class GeoCoveringCache {
+    MONGO_DISALLOW_COPYING(GeoCoveringCache);
+
+public:
+    using Intervals = std::vector<Interval>;
+
+    GeoCoveringCache() = default;
+
+    /**
+     * The cache shared by all queries in the process.
+     */
+    static GeoCoveringCache& get();
+
+    /**
+     * Returns the key for the covering of the geo predicate 'geoSpec' against the index described
+     * by 'indexInfoObj', whose field is of type 'indexType'. 'coveringParams' must hold every other
+     * setting which the covering depends on.
+     */
+    static std::string makeKey(StringData indexType,
+                               const BSONObj& geoSpec,
+                               const BSONObj& indexInfoObj,
+                               const BSONObj& coveringParams);
+
+    /**
+     * Returns the intervals cached for 'key', or nullptr on a miss.
+     */
+    std::shared_ptr<const Intervals> find(const std::string& key);
+
+    /**
+     * Caches 'intervals' for 'key', evicting older entries as needed to stay within the size
+     * limit. Entries larger than the whole limit are not cached.
+     */
+    void insert(const std::string& key, Intervals intervals);
+
+    void clear();
+
+    /**
+     * Returns the number of bytes charged for the entries currently cached.
+     */
+    long long sizeBytes() const;
+
+    const Counter64& hits() const {
+        return _hits;
+    }
+
+    const Counter64& misses() const {
+        return _misses;
+    }
+
+    const Counter64& evictions() const {
+        return _evictions;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Intervals> intervals;
+        long long sizeBytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    // Removes the least recently used entries until at most 'maxBytes' remain. Requires '_mutex'.
+    void _evictDownTo(long long maxBytes);
+
+    mutable stdx::mutex _mutex;
+
+    // Most recently used first.
+    EntryList _entries;
+    stdx::unordered_map<std::string, EntryList::iterator> _index;
+    long long _sizeBytes = 0;
+
+    Counter64 _hits;
+    Counter64 _misses;
+    Counter64 _evictions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/geo_covering_cache.h"
+
+#include "mongo/db/query/expression_index_knobs.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Intervals = GeoCoveringCache::Intervals;
+
+Intervals makeIntervals(int count) {
+    Intervals intervals;
+    for (int i = 0; i < count; ++i) {
+        intervals.emplace_back(BSON("" << i << "" << i + 1), true, false);
+    }
+    return intervals;
+}
+
+std::string makeKey(int x) {
+    return GeoCoveringCache::makeKey("2d",
+                                     BSON("$geoWithin" << BSON("$box" << BSON_ARRAY(
+                                                                   BSON_ARRAY(0 << 0)
+                                                                   << BSON_ARRAY(x << x)))),
+                                     BSON("key" << BSON("a"
+                                                        << "2d")),
+                                     BSON("maxCells" << 64));
+}
+
+/**
+ * Sets the cache size limit for the duration of a test, restoring the old value afterwards.
+ */
+class CacheSizeGuard {
+public:
+    explicit CacheSizeGuard(int sizeBytes)
+        : _oldSizeBytes(internalQueryGeoCoveringCacheSizeBytes.load()) {
+        internalQueryGeoCoveringCacheSizeBytes.store(sizeBytes);
+    }
+
+    ~CacheSizeGuard() {
+        internalQueryGeoCoveringCacheSizeBytes.store(_oldSizeBytes);
+    }
+
+private:
+    const int _oldSizeBytes;
+};
+
+TEST(GeoCoveringCacheTest, FindReturnsInsertedIntervals) {
+    GeoCoveringCache cache;
+    ASSERT_FALSE(cache.find(makeKey(1)));
+    ASSERT_EQ(1U, cache.misses().get());
+
+    cache.insert(makeKey(1), makeIntervals(3));
+    auto cached = cache.find(makeKey(1));
+    ASSERT(cached);
+    ASSERT_EQ(3U, cached->size());
+    ASSERT(cached->front().equals(makeIntervals(1).front()));
+    ASSERT_EQ(1U, cache.hits().get());
+
+    ASSERT_FALSE(cache.find(makeKey(2)));
+    ASSERT_EQ(2U, cache.misses().get());
+}
+
+TEST(GeoCoveringCacheTest, KeyDependsOnIndexAndParams) {
+    const BSONObj geo =
+        BSON("$geoWithin" << BSON("$center" << BSON_ARRAY(BSON_ARRAY(0 << 0) << 1)));
+    const BSONObj index = BSON("key" << BSON("a"
+                                             << "2d"));
+    const std::string key = GeoCoveringCache::makeKey("2d", geo, index, BSON("maxCells" << 64));
+
+    ASSERT_EQ(key, GeoCoveringCache::makeKey("2d", geo, index, BSON("maxCells" << 64)));
+    ASSERT_NE(key, GeoCoveringCache::makeKey("2d", geo, index, BSON("maxCells" << 32)));
+    ASSERT_NE(key,
+              GeoCoveringCache::makeKey(
+                  "2d", geo, BSON("key" << BSON("a"
+                                                << "2d")
+                                        << "bits"
+                                        << 20),
+                  BSON("maxCells" << 64)));
+}
+
+TEST(GeoCoveringCacheTest, EvictsLeastRecentlyUsedEntries) {
+    GeoCoveringCache cache;
+    CacheSizeGuard guard(1024 * 1024);
+    cache.insert(makeKey(1), makeIntervals(4));
+    const long long entrySize = cache.sizeBytes();
+    ASSERT_GT(entrySize, 0);
+
+    // Leave room for exactly two entries of the same size.
+    internalQueryGeoCoveringCacheSizeBytes.store(2 * entrySize);
+    cache.insert(makeKey(2), makeIntervals(4));
+    ASSERT(cache.find(makeKey(1)));
+
+    // Key 2 is now the least recently used.
+    cache.insert(makeKey(3), makeIntervals(4));
+    ASSERT_EQ(1U, cache.evictions().get());
+    ASSERT_EQ(2 * entrySize, cache.sizeBytes());
+    ASSERT(cache.find(makeKey(1)));
+    ASSERT_FALSE(cache.find(makeKey(2)));
+    ASSERT(cache.find(makeKey(3)));
+}
+
+TEST(GeoCoveringCacheTest, DoesNotCacheEntriesLargerThanLimit) {
+    GeoCoveringCache cache;
+    CacheSizeGuard guard(1024);
+    cache.insert(makeKey(1), makeIntervals(1000));
+    ASSERT_FALSE(cache.find(makeKey(1)));
+    ASSERT_EQ(0, cache.sizeBytes());
+}
+
+TEST(GeoCoveringCacheTest, ZeroSizeDisablesCache) {
+    GeoCoveringCache cache;
+    CacheSizeGuard guard(0);
+    cache.insert(makeKey(1), makeIntervals(1));
+    ASSERT_FALSE(cache.find(makeKey(1)));
+}
+
+TEST(GeoCoveringCacheTest, ClearRemovesAllEntries) {
+    GeoCoveringCache cache;
+    cache.insert(makeKey(1), makeIntervals(2));
+    cache.insert(makeKey(2), makeIntervals(2));
+    cache.clear();
+    ASSERT_EQ(0, cache.sizeBytes());
+    ASSERT_FALSE(cache.find(makeKey(1)));
+    ASSERT_FALSE(cache.find(makeKey(2)));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -59,6 +59,7 @@
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
@@ -84,6 +85,7 @@
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/stringutils.h"
 
 namespace mongo {
@@ -150,6 +152,7 @@ void fillOutPlannerParams(OperationContext* opCtx,
         QuerySettings* querySettings = collection->infoCache()->getQuerySettings();
         PlanCacheKey planCacheKey =
             collection->infoCache()->getPlanCache()->computeKey(*canonicalQuery);
+        canonicalQuery->setQueryHash(PlanCache::computeQueryHash(planCacheKey));
 
         // Filter index catalog if index filters are specified for query.
         // Also, signal to planner that application hint should be ignored.
@@ -194,6 +197,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
+    if (internalQueryPlannerGenerateSkipScans.load()) {
+        plannerParams->options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     // Doc-level locking storage engines cannot answer predicates implicitly via exact index
@@ -256,6 +263,59 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+/**
+ * Returns the position in 'solutions' of the plan with the least estimated work if the index
+ * statistics of 'collection' make it a clear winner, or boost::none if the candidates have to be
+ * compared in a trial run.
+ */
+boost::optional<size_t> pickSolutionFromEstimates(
+    OperationContext* opCtx,
+    Collection* collection,
+    const CanonicalQuery& canonicalQuery,
+    const std::vector<unique_ptr<QuerySolution>>& solutions) {
+    const double ratio = internalQueryPlanEstimateSkipTrialRatio.load();
+    if (ratio <= 0) {
+        return boost::none;
+    }
+
+    // The estimates are for running each plan to completion. With a sort or a limit, a plan that
+    // does more work in total may still win by producing its first results sooner.
+    const QueryRequest& qr = canonicalQuery.getQueryRequest();
+    if (!qr.getSort().isEmpty() || qr.getLimit() || qr.getNToReturn()) {
+        return boost::none;
+    }
+
+    const CollectionStatistics& stats = *collection->infoCache()->getCollectionStatistics();
+    if (stats.empty()) {
+        return boost::none;
+    }
+
+    const long long numRecords = collection->numRecords(opCtx);
+    boost::optional<size_t> best;
+    double bestWork = 0;
+    double runnerUpWork = std::numeric_limits<double>::infinity();
+    for (size_t ix = 0; ix < solutions.size(); ++ix) {
+        auto work = estimatePlanWork(solutions[ix]->root.get(), stats, numRecords);
+        if (!work) {
+            return boost::none;
+        }
+        if (!best || *work < bestWork) {
+            if (best) {
+                runnerUpWork = bestWork;
+            }
+            best = ix;
+            bestWork = *work;
+        } else {
+            runnerUpWork = std::min(runnerUpWork, *work);
+        }
+    }
+
+    if (runnerUpWork < bestWork * ratio) {
+        return boost::none;
+    }
+    return best;
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -438,6 +498,24 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    if (solutions.size() > 1) {
+        if (auto best =
+                pickSolutionFromEstimates(opCtx, collection, *canonicalQuery, solutions)) {
+            PlanStage* rawRoot;
+            verify(StageBuilder::build(
+                opCtx, collection, *canonicalQuery, *solutions[*best], ws, &rawRoot));
+            root.reset(rawRoot);
+
+            LOG(2) << "Index statistics pick one of " << solutions.size()
+                   << " plans; it will be run without a trial and will not be cached. "
+                   << redact(canonicalQuery->toStringShort())
+                   << ", planSummary: " << redact(Explain::getPlanSummary(root.get()));
+
+            return PrepareExecutionResult(
+                std::move(canonicalQuery), std::move(solutions[*best]), std::move(root));
+        }
+    }
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
@@ -721,24 +799,42 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorLega
 
 namespace {
 
+/**
+ * Returns true if 'proj' uses the positional operator, in which case it can only be validated
+ * and applied against a parsed query expression.
+ */
+bool projectionNeedsQueryExpression(const BSONObj& proj) {
+    for (auto&& elem : proj) {
+        if (str::contains(elem.fieldName(), ".$")) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * Wrap the specified 'root' plan stage in a ProjectionStage. Does not take ownership of any
  * arguments other than root.
  *
+ * 'query' may be null only if the projection does not use the positional operator, as is the
+ * case on the idhack path where no CanonicalQuery is built.
+ *
  * If the projection was valid, then return Status::OK() with a pointer to the newly created
  * ProjectionStage. Otherwise, return a status indicating the error reason.
  */
 StatusWith<unique_ptr<PlanStage>> applyProjection(OperationContext* opCtx,
                                                   const NamespaceString& nsString,
-                                                  CanonicalQuery* cq,
+                                                  const MatchExpression* query,
+                                                  const CollatorInterface* collator,
                                                   const BSONObj& proj,
                                                   bool allowPositional,
                                                   WorkingSet* ws,
                                                   unique_ptr<PlanStage> root) {
     invariant(!proj.isEmpty());
+    invariant(query || !projectionNeedsQueryExpression(proj));
 
     ParsedProjection* rawParsedProj;
-    Status ppStatus = ParsedProjection::make(opCtx, proj.getOwned(), cq->root(), &rawParsedProj);
+    Status ppStatus = ParsedProjection::make(opCtx, proj.getOwned(), query, &rawParsedProj);
     if (!ppStatus.isOK()) {
         return ppStatus;
     }
@@ -760,8 +856,8 @@ StatusWith<unique_ptr<PlanStage>> applyProjection(OperationContext* opCtx,
 
     ProjectionStageParams params;
     params.projObj = proj;
-    params.collator = cq->getCollator();
-    params.fullExpression = cq->root();
+    params.collator = collator;
+    params.fullExpression = query;
     return {make_unique<ProjectionStage>(opCtx, params, ws, root.release())};
 }
 
@@ -843,13 +939,33 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
             CollatorInterface::collatorsMatch(collator.get(), collection->getDefaultCollator());
 
         if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
-            request->getProj().isEmpty() && hasCollectionDefaultCollation) {
+            !projectionNeedsQueryExpression(request->getProj()) &&
+            hasCollectionDefaultCollation) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
             PlanStage* idHackStage = new IDHackStage(
                 opCtx, collection, unparsedQuery["_id"].wrap(), ws.get(), descriptor);
-            unique_ptr<DeleteStage> root = make_unique<DeleteStage>(
+            unique_ptr<PlanStage> root = make_unique<DeleteStage>(
                 opCtx, deleteStageParams, ws.get(), collection, idHackStage);
+
+            if (!request->getProj().isEmpty()) {
+                invariant(request->shouldReturnDeleted());
+
+                const bool allowPositional = true;
+                StatusWith<unique_ptr<PlanStage>> projStatus =
+                    applyProjection(opCtx,
+                                    nss,
+                                    nullptr,
+                                    collection->getDefaultCollator(),
+                                    request->getProj(),
+                                    allowPositional,
+                                    ws.get(),
+                                    std::move(root));
+                if (!projStatus.isOK()) {
+                    return projStatus.getStatus();
+                }
+                root = std::move(projStatus.getValue());
+            }
             return PlanExecutor::make(opCtx, std::move(ws), std::move(root), collection, policy);
         }
 
@@ -883,8 +999,14 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
         invariant(request->shouldReturnDeleted());
 
         const bool allowPositional = true;
-        StatusWith<unique_ptr<PlanStage>> projStatus = applyProjection(
-            opCtx, nss, cq.get(), request->getProj(), allowPositional, ws.get(), std::move(root));
+        StatusWith<unique_ptr<PlanStage>> projStatus = applyProjection(opCtx,
+                                                                       nss,
+                                                                       cq->root(),
+                                                                       cq->getCollator(),
+                                                                       request->getProj(),
+                                                                       allowPositional,
+                                                                       ws.get(),
+                                                                       std::move(root));
         if (!projStatus.isOK()) {
             return projStatus.getStatus();
         }
@@ -994,6 +1116,36 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
                                                      policy);
         }
 
+        // A findAndModify on _id with a non-positional projection can also skip query
+        // canonicalization and planning. The projection is applied on top of the idhack plan.
+        if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
+            !projectionNeedsQueryExpression(request->getProj()) &&
+            hasCollectionDefaultCollation) {
+            LOG(2) << "Using idhack with projection: " << redact(unparsedQuery);
+            invariant(request->shouldReturnAnyDocs());
+
+            PlanStage* idHackStage = new IDHackStage(
+                opCtx, collection, unparsedQuery["_id"].wrap(), ws.get(), descriptor);
+            unique_ptr<PlanStage> root = make_unique<UpdateStage>(
+                opCtx, updateStageParams, ws.get(), collection, idHackStage);
+
+            const bool allowPositional = request->shouldReturnOldDocs();
+            StatusWith<unique_ptr<PlanStage>> projStatus =
+                applyProjection(opCtx,
+                                nss,
+                                nullptr,
+                                parsedUpdate->getCollator(),
+                                request->getProj(),
+                                allowPositional,
+                                ws.get(),
+                                std::move(root));
+            if (!projStatus.isOK()) {
+                return projStatus.getStatus();
+            }
+            return PlanExecutor::make(
+                opCtx, std::move(ws), std::move(projStatus.getValue()), collection, policy);
+        }
+
         // If we're here then we don't have a parsed query, but we're also not eligible for
         // the idhack fast path. We need to force canonicalization now.
         Status cqStatus = parsedUpdate->parseQueryToCQ();
@@ -1028,8 +1180,14 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
         // is invalid to use a positional projection because the query expression need not
         // match the array element after the update has been applied.
         const bool allowPositional = request->shouldReturnOldDocs();
-        StatusWith<unique_ptr<PlanStage>> projStatus = applyProjection(
-            opCtx, nss, cq.get(), request->getProj(), allowPositional, ws.get(), std::move(root));
+        StatusWith<unique_ptr<PlanStage>> projStatus = applyProjection(opCtx,
+                                                                       nss,
+                                                                       cq->root(),
+                                                                       cq->getCollator(),
+                                                                       request->getProj(),
+                                                                       allowPositional,
+                                                                       ws.get(),
+                                                                       std::move(root));
         if (!projStatus.isOK()) {
             return projStatus.getStatus();
         }
@@ -528,6 +528,9 @@ IndexBoundsChecker::KeyState IndexBoundsChecker::checkKey(const BSONObj& key, In
     // Field number 'firstNonContainedField' of the index key is after interval we think it's
     // in.  Fields 0 through 'firstNonContained-1' are within their current intervals and we can
     // ignore them.
+    // The key is known to be ahead of every interval up to and including the current one only
+    // for the first field searched, so only that search can skip ahead.
+    size_t searchFrom = _curInterval[firstNonContainedField];
     while (firstNonContainedField < _curInterval.size()) {
         // Find the interval that contains our field.
         size_t newIntervalForField;
@@ -535,7 +538,9 @@ IndexBoundsChecker::KeyState IndexBoundsChecker::checkKey(const BSONObj& key, In
         Location where = findIntervalForField(keyValues[firstNonContainedField],
                                               _bounds->fields[firstNonContainedField],
                                               _expectedDirection[firstNonContainedField],
-                                              &newIntervalForField);
+                                              &newIntervalForField,
+                                              searchFrom);
+        searchFrom = 0;
 
         if (WITHIN == where) {
             // Found a new interval for field firstNonContainedField.  Move our internal choice
@@ -615,18 +620,34 @@ IndexBoundsChecker::Location IndexBoundsChecker::findIntervalForField(
     const BSONElement& elt,
     const OrderedIntervalList& oil,
     const int expectedDirection,
-    size_t* newIntervalIndex) {
+    size_t* newIntervalIndex,
+    size_t startIndex) {
     // Binary search for interval.
     // Intervals are ordered in the same direction as our keys.
     // Key behind all intervals: [BEHIND, ..., BEHIND]
     // Key ahead of all intervals: [AHEAD, ..., AHEAD]
     // Key within one interval: [AHEAD, ..., WITHIN, BEHIND, ...]
     // Key not in any inteval: [AHEAD, ..., AHEAD, BEHIND, ...]
+    const auto keyAndDirection = std::make_pair(elt, expectedDirection);
+    const size_t numIntervals = oil.intervals.size();
+
+    // Gallop forward from 'startIndex' to bracket the left-most BEHIND/WITHIN interval between
+    // 'low' and 'high'. Scans usually move to a nearby interval, so this takes few comparisons.
+    size_t low = std::min(startIndex, numIntervals);
+    size_t high = numIntervals;
+    for (size_t step = 1; low < numIntervals; step *= 2) {
+        const size_t probe = std::min(low + step, numIntervals) - 1;
+        if (!isKeyAheadOfInterval(oil.intervals[probe], keyAndDirection)) {
+            high = probe + 1;
+            break;
+        }
+        low = probe + 1;
+    }
 
     // Find left-most BEHIND/WITHIN interval.
-    vector<Interval>::const_iterator i = std::lower_bound(oil.intervals.begin(),
-                                                          oil.intervals.end(),
-                                                          std::make_pair(elt, expectedDirection),
+    vector<Interval>::const_iterator i = std::lower_bound(oil.intervals.begin() + low,
+                                                          oil.intervals.begin() + high,
+                                                          keyAndDirection,
                                                           isKeyAheadOfInterval);
 
     // Key ahead of all intervals.
@@ -228,14 +228,17 @@ public:
      *
      * If 'elt' cannot be advanced to any interval, return AHEAD.
      *
-     * Exposed for testing only.
+     * 'elt' must be AHEAD of every interval before 'startIndex'. The search gallops forward from
+     * there, so advancing through a long list of point intervals, as built for a large $in,
+     * costs time logarithmic in the distance moved rather than in the length of the list.
      *
-     * TODO(efficiency): Start search from a given index.
+     * Exposed for testing only.
      */
     static Location findIntervalForField(const BSONElement& elt,
                                          const OrderedIntervalList& oil,
                                          const int expectedDirection,
-                                         size_t* newIntervalIndex);
+                                         size_t* newIntervalIndex,
+                                         size_t startIndex = 0);
 
 private:
     /**
@@ -44,8 +44,10 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/expression_index.h"
 #include "mongo/db/query/expression_index_knobs.h"
+#include "mongo/db/query/geo_covering_cache.h"
 #include "mongo/db/query/indexability.h"
 #include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "third_party/s2/s2cell.h"
@@ -90,6 +92,23 @@ bool stringMayHaveUnescapedPipe(StringData str) {
     return false;
 }
 
+// The point intervals for a $in share buffers of up to this many bytes.
+const int kMaxSharedPointBytes = 1024 * 1024;
+
+/**
+ * Appends a point interval for each element of 'points' to 'oil'. The intervals all refer into
+ * 'points' rather than each owning a separately allocated copy of its point.
+ */
+void appendSharedPointIntervals(const BSONObj& points, OrderedIntervalList* oil) {
+    for (auto&& point : points) {
+        Interval ival;
+        ival._intervalData = points;
+        ival.startInclusive = ival.endInclusive = true;
+        ival.start = ival.end = point;
+        oil->intervals.push_back(std::move(ival));
+    }
+}
+
 }  // namespace
 
 string IndexBoundsBuilder::simpleRegex(const char* regex,
@@ -599,13 +618,31 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
 
         // Create our various intervals.
 
+        // Equalities that are indexed as themselves become point intervals over a few shared
+        // buffers, so a large $in doesn't allocate an object per point.
+        oilOut->intervals.reserve(ime->getEqualities().size());
+        auto pointsBob = stdx::make_unique<BSONObjBuilder>();
         IndexBoundsBuilder::BoundsTightness tightness;
         for (auto&& equality : ime->getEqualities()) {
-            translateEquality(equality, index, isHashed, oilOut, &tightness);
-            if (tightness != IndexBoundsBuilder::EXACT) {
-                *tightnessOut = tightness;
+            if (isHashed || Array == equality.type()) {
+                translateEquality(equality, index, isHashed, oilOut, &tightness);
+                if (tightness != IndexBoundsBuilder::EXACT) {
+                    *tightnessOut = tightness;
+                }
+                continue;
+            }
+
+            CollationIndexKey::collationAwareIndexKeyAppend(
+                equality, index.collator, pointsBob.get());
+            if (equality.isNull()) {
+                *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
+            }
+            if (pointsBob->len() >= kMaxSharedPointBytes) {
+                appendSharedPointIntervals(pointsBob->obj(), oilOut);
+                pointsBob = stdx::make_unique<BSONObjBuilder>();
             }
         }
+        appendSharedPointIntervals(pointsBob->obj(), oilOut);
 
         for (auto&& regex : ime->getRegexes()) {
             translateRegex(regex.get(), index, oilOut, &tightness);
@@ -633,19 +670,47 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
     } else if (MatchExpression::GEO == expr->matchType()) {
         const GeoMatchExpression* gme = static_cast<const GeoMatchExpression*>(expr);
 
+        // Computing a covering is expensive, and the same regions tend to be queried over and
+        // over, so the resulting intervals are cached. Since 'oilOut' starts out empty, they are
+        // exactly the intervals the covering adds.
+        auto& coveringCache = GeoCoveringCache::get();
+
         if (mongoutils::str::equals("2dsphere", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasS2Region());
-            const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
-            S2IndexingParams indexParams;
-            ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            const std::string cacheKey = GeoCoveringCache::makeKey(
+                IndexNames::GEO_2DSPHERE,
+                gme->getRawObj(),
+                index.infoObj,
+                BSON("coarsest" << internalQueryS2GeoCoarsestLevel.load() << "finest"
+                                << internalQueryS2GeoFinestLevel.load()
+                                << "maxCells"
+                                << internalQueryS2GeoMaxCells.load()));
+            if (auto cached = coveringCache.find(cacheKey)) {
+                oilOut->intervals = *cached;
+            } else {
+                const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
+                S2IndexingParams indexParams;
+                ExpressionParams::initialize2dsphereParams(
+                    index.infoObj, index.collator, &indexParams);
+                ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+                coveringCache.insert(cacheKey, oilOut->intervals);
+            }
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
-            const R2Region& region = gme->getGeoExpression().getGeometry().getR2Region();
-
-            ExpressionMapping::cover2d(
-                region, index.infoObj, internalGeoPredicateQuery2DMaxCoveringCells.load(), oilOut);
+            const int maxCoveringCells = internalGeoPredicateQuery2DMaxCoveringCells.load();
+            const std::string cacheKey =
+                GeoCoveringCache::makeKey(IndexNames::GEO_2D,
+                                          gme->getRawObj(),
+                                          index.infoObj,
+                                          BSON("maxCells" << maxCoveringCells));
+            if (auto cached = coveringCache.find(cacheKey)) {
+                oilOut->intervals = *cached;
+            } else {
+                const R2Region& region = gme->getGeoExpression().getGeometry().getR2Region();
+                ExpressionMapping::cover2d(region, index.infoObj, maxCoveringCells, oilOut);
+                coveringCache.insert(cacheKey, oilOut->intervals);
+            }
 
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else {
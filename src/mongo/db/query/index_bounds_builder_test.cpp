@@ -930,6 +930,29 @@ TEST(IndexBoundsBuilderTest, TranslateIn) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
 }
 
+TEST(IndexBoundsBuilderTest, TranslateLargeInSharesPointStorage) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    BSONArrayBuilder inBob;
+    for (int i = 999; i >= 0; --i) {
+        inBob.append(i);
+    }
+    BSONObj obj = BSON("a" << BSON("$in" << inBob.arr()));
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.intervals.size(), 1000U);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                      oil.intervals[i].compare(Interval(BSON("" << i << "" << i), true, true)));
+        ASSERT_FALSE(oil.intervals[i].isEmpty());
+    }
+    ASSERT_EQUALS(oil.intervals.front()._intervalData.objdata(),
+                  oil.intervals.back()._intervalData.objdata());
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
+}
+
 TEST(IndexBoundsBuilderTest, TranslateInArray) {
     IndexEntry testIndex = IndexEntry(BSONObj());
     BSONObj obj = fromjson("{a: {$in: [[1], 2]}}");
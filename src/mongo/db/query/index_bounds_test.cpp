@@ -970,4 +970,32 @@ TEST(IndexBoundsCheckerTest, FindIntervalForField) {
     testFindIntervalForField(0, pointsObj, -1, IndexBoundsChecker::AHEAD, 0U);
 }
 
+TEST(IndexBoundsCheckerTest, FindIntervalForFieldFromStartIndex) {
+    // Point intervals at the even numbers 0 through 198.
+    OrderedIntervalList oil("foo");
+    for (int j = 0; j < 200; j += 2) {
+        oil.intervals.push_back(Interval(BSON("" << j << "" << j), true, true));
+    }
+
+    // Searching from any interval the key is not ahead of gives the same result as searching
+    // from the first.
+    for (int key = -1; key <= 200; ++key) {
+        BSONObj keyObj = BSON("" << key);
+        size_t expectedIndex = 0;
+        IndexBoundsChecker::Location expectedLocation = IndexBoundsChecker::findIntervalForField(
+            keyObj.firstElement(), oil, 1, &expectedIndex);
+        const size_t lastStart =
+            IndexBoundsChecker::AHEAD == expectedLocation ? oil.intervals.size() : expectedIndex;
+        for (size_t start = 0; start <= lastStart; ++start) {
+            size_t index = 0;
+            ASSERT_EQUALS(expectedLocation,
+                          IndexBoundsChecker::findIntervalForField(
+                              keyObj.firstElement(), oil, 1, &index, start));
+            if (IndexBoundsChecker::AHEAD != expectedLocation) {
+                ASSERT_EQUALS(expectedIndex, index);
+            }
+        }
+    }
+}
+
 }  // namespace
@@ -55,7 +55,8 @@ void Interval::init(BSONObj base, bool si, bool ei) {
 }
 
 bool Interval::isEmpty() const {
-    return _intervalData.nFields() == 0;
+    // Several point intervals may share one large '_intervalData', so don't count its fields.
+    return _intervalData.isEmpty();
 }
 
 bool Interval::isPoint() const {
@@ -39,6 +39,7 @@ struct Interval {
     // 'start' may not point at the first field in _intervalData.
     // 'end' may not point at the last field in _intervalData.
     // 'start' and 'end' may point at the same field.
+    // '_intervalData' may be shared by many intervals, such as the points of a large $in.
     BSONObj _intervalData;
 
     // Start and End must be ordered according to the index order.
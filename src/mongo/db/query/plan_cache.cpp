@@ -37,6 +37,10 @@
 #include <memory>
 #include <vector>
 
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/client/dbclientinterface.h"  // For QueryOption_foobar
 #include "mongo/db/matcher/expression_array.h"
@@ -67,7 +71,7 @@ const char kEncodeCollationSection = '#';
  * Encode user-provided string. Cache key delimiters seen in the
  * user string are escaped with a backslash.
  */
-void encodeUserString(StringData s, StringBuilder* keyBuilder) {
+void encodeUserString(StringData s, StackStringBuilder* keyBuilder) {
     for (size_t i = 0; i < s.size(); ++i) {
         char c = s[i];
         switch (c) {
@@ -243,7 +247,7 @@ const char* encodeMatchType(MatchExpression::MatchType mt) {
  * - geometry type
  * - CRS (flat or spherical)
  */
-void encodeGeoMatchExpression(const GeoMatchExpression* tree, StringBuilder* keyBuilder) {
+void encodeGeoMatchExpression(const GeoMatchExpression* tree, StackStringBuilder* keyBuilder) {
     const GeoExpression& geoQuery = tree->getGeoExpression();
 
     // Type of geo query.
@@ -283,7 +287,8 @@ void encodeGeoMatchExpression(const GeoMatchExpression* tree, StringBuilder* key
  * - isNearSphere
  * - CRS (flat or spherical)
  */
-void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree, StringBuilder* keyBuilder) {
+void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree,
+                                  StackStringBuilder* keyBuilder) {
     const GeoNearExpression& nearQuery = tree->getData();
 
     // isNearSphere
@@ -308,6 +313,43 @@ void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree, StringBuil
     }
 }
 
+/**
+ * Appends the winning plan of 'entry' to its shape history. If a replan is in progress and picked
+ * a plan that won for this shape before, other than the plan being replaced, the shape is flipping
+ * between plans whose relative cost depends on the query's constants. Raise the shape's works floor
+ * to what the evicted plan had performed, so that the next cached plan gets that much room before
+ * it is evicted in turn. The floor never exceeds the works a full multi-planning round may take.
+ */
+void recordWinner(PlanCacheEntry* entry) {
+    PlanCacheShapeHistory& history = entry->shapeHistory;
+    PlanCacheShapeHistory::Winner winner{entry->plannerData[0]->toString(),
+                                         entry->decision->stats[0]->common.works};
+
+    if (history.pendingReplanWorks > 0 && !history.winners.empty() &&
+        history.winners.back().solution != winner.solution) {
+        bool wonBefore = std::any_of(history.winners.begin(),
+                                     history.winners.end(),
+                                     [&](const PlanCacheShapeHistory::Winner& previous) {
+                                         return previous.solution == winner.solution;
+                                     });
+        if (wonBefore) {
+            ++history.flips;
+            const size_t maxFloor =
+                static_cast<size_t>(internalQueryPlanEvaluationWorks.load());
+            history.worksFloor = std::max(history.worksFloor,
+                                          std::min(history.pendingReplanWorks, maxFloor));
+        }
+    }
+    history.pendingReplanWorks = 0;
+
+    history.winners.push_back(std::move(winner));
+    const size_t maxWinners =
+        static_cast<size_t>(std::max(1, internalQueryCacheMaxPlanHistory.load()));
+    while (history.winners.size() > maxWinners) {
+        history.winners.pop_front();
+    }
+}
+
 }  // namespace
 
 //
@@ -369,7 +411,8 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
       collation(entry.collation.getOwned()),
-      decisionWorks(entry.decision->stats[0]->common.works) {
+      decisionWorks(std::max(entry.decision->stats[0]->common.works,
+                             entry.shapeHistory.worksFloor)) {
     // CachedSolution should not having any references into
     // cache entry. All relevant data should be cloned/copied.
     for (size_t i = 0; i < entry.plannerData.size(); ++i) {
@@ -432,6 +475,7 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     entry->projection = projection.getOwned();
     entry->collation = collation.getOwned();
     entry->timeOfCreation = timeOfCreation;
+    entry->shapeHistory = shapeHistory;
 
     // Copy performance stats.
     for (size_t i = 0; i < feedback.size(); ++i) {
@@ -565,7 +609,8 @@ PlanCache::~PlanCache() {}
  * Appends an encoding of each node's match type and path name
  * to the output stream.
  */
-void PlanCache::encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const {
+void PlanCache::encodeKeyForMatch(const MatchExpression* tree,
+                                  StackStringBuilder* keyBuilder) const {
     // Encode match type and path.
     *keyBuilder << encodeMatchType(tree->matchType());
 
@@ -623,7 +668,7 @@ void PlanCache::encodeKeyForMatch(const MatchExpression* tree, StringBuilder* ke
  * Sort order is normalized because it provided by
  * QueryRequest.
  */
-void PlanCache::encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const {
+void PlanCache::encodeKeyForSort(const BSONObj& sortObj, StackStringBuilder* keyBuilder) const {
     if (sortObj.isEmpty()) {
         return;
     }
@@ -661,7 +706,7 @@ void PlanCache::encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuild
  * Orders the encoded elements in the projection by field name.
  * This handles all the special projection types ($meta, $elemMatch, etc.)
  */
-void PlanCache::encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const {
+void PlanCache::encodeKeyForProj(const BSONObj& projObj, StackStringBuilder* keyBuilder) const {
     // Sorts the BSON elements by field name using a map.
     std::map<StringData, BSONElement> elements;
 
@@ -747,8 +792,18 @@ Status PlanCache::add(const CanonicalQuery& query,
     }
     entry->projection = projBuilder.obj();
 
+    const PlanCacheKey key = computeKey(query);
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
+
+    PlanCacheEntry* previousEntry;
+    if (_cache.get(key, &previousEntry).isOK()) {
+        entry->shapeHistory = std::move(previousEntry->shapeHistory);
+    } else {
+        entry->shapeHistory.since = now;
+    }
+    recordWinner(entry);
+
+    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, entry);
 
     if (NULL != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
@@ -798,6 +853,22 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     return Status::OK();
 }
 
+Status PlanCache::recordReplan(const CanonicalQuery& cq, size_t works) {
+    PlanCacheKey ck = computeKey(cq);
+
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    PlanCacheEntry* entry;
+    Status cacheStatus = _cache.get(ck, &entry);
+    if (!cacheStatus.isOK()) {
+        return cacheStatus;
+    }
+    invariant(entry);
+
+    ++entry->shapeHistory.replans;
+    entry->shapeHistory.pendingReplanWorks = works;
+    return Status::OK();
+}
+
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     return _cache.remove(computeKey(canonicalQuery));
@@ -809,13 +880,22 @@ void PlanCache::clear() {
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
-    StringBuilder keyBuilder;
+    // Most query shapes encode to well under the size of the stack buffer, so the only heap
+    // allocation made here is for the returned key.
+    StackStringBuilder keyBuilder;
     encodeKeyForMatch(cq.root(), &keyBuilder);
     encodeKeyForSort(cq.getQueryRequest().getSort(), &keyBuilder);
     encodeKeyForProj(cq.getQueryRequest().getProj(), &keyBuilder);
     return keyBuilder.str();
 }
 
+// static
+std::uint64_t PlanCache::computeQueryHash(const PlanCacheKey& key) {
+    char hash[16];
+    MurmurHash3_x64_128(key.data(), key.size(), 0, hash);
+    return ConstDataView(hash).read<LittleEndian<std::uint64_t>>();
+}
+
 Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOut) const {
     PlanCacheKey key = computeKey(query);
     verify(entryOut);
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <deque>
 #include <set>
 
 #include "mongo/db/exec/plan_stats.h"
@@ -190,6 +191,42 @@ struct SolutionCacheData {
 
 class PlanCacheEntry;
 
+/**
+ * Planning history of a query shape. It is carried over whenever the shape's cache entry is
+ * replaced by a replan, so that a shape whose winning plan keeps flipping between a few plans can
+ * be recognized and given more room before the cached plan is evicted again.
+ */
+struct PlanCacheShapeHistory {
+    struct Winner {
+        // String representation of the winning plan's SolutionCacheData.
+        std::string solution;
+
+        // The number of work cycles the plan took to win.
+        size_t works;
+    };
+
+    // The winning plans of the most recent plannings of the shape, oldest first. At most
+    // 'internalQueryCacheMaxPlanHistory' winners are kept.
+    std::deque<Winner> winners;
+
+    // When the shape was first planned.
+    Date_t since;
+
+    // How many times the cached plan was evicted because its trial period ran too long.
+    long long replans = 0;
+
+    // How many replans picked a plan that had already won for this shape before, other than the
+    // plan it replaced.
+    long long flips = 0;
+
+    // The cached plan is given at least this many decision works, no matter how quickly the
+    // current winner was picked. Raised whenever the shape flips back to an earlier plan.
+    size_t worksFloor = 0;
+
+    // The works the evicted plan had performed when it was evicted, if a replan is in progress.
+    size_t pendingReplanWorks = 0;
+};
+
 /**
  * Information returned from a get(...) query.
  */
@@ -219,7 +256,7 @@ public:
     BSONObj collation;
 
     // The number of work cycles taken to decide on a winning plan when the plan was first
-    // cached.
+    // cached, raised to the shape's works floor if the shape has flipped between plans.
     size_t decisionWorks;
 };
 
@@ -280,6 +317,9 @@ public:
     // Annotations from cached runs.  The CachedPlanStage provides these stats about its
     // runs when they complete.
     std::vector<PlanCacheEntryFeedback*> feedback;
+
+    // Winners and replans of this query shape across the entries that have held it.
+    PlanCacheShapeHistory shapeHistory;
 };
 
 /**
@@ -353,6 +393,16 @@ public:
      */
     Status feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* feedback);
 
+    /**
+     * Records that the cached plan for 'cq' performed 'works' work cycles without finishing its
+     * trial period and is about to be replanned. If the replan picks a plan that had already won
+     * for this shape, the shape's works floor is raised to 'works' so that the next cached plan is
+     * not evicted as readily.
+     *
+     * Returns an error if the shape is no longer in the cache.
+     */
+    Status recordReplan(const CanonicalQuery& cq, size_t works);
+
     /**
      * Remove the entry corresponding to 'ck' from the cache.  Returns Status::OK() if the plan
      * was present and removed and an error status otherwise.
@@ -375,6 +425,14 @@ public:
      */
     PlanCacheKey computeKey(const CanonicalQuery&) const;
 
+    /**
+     * Returns a 64-bit fingerprint of 'key' which is cheap to store and to compare. Two queries
+     * with the same shape, planned against the same set of indexes, have the same query hash, so
+     * it is reported in explain output, the profiler and the slow query log as a way to aggregate
+     * operations by shape.
+     */
+    static std::uint64_t computeQueryHash(const PlanCacheKey& key);
+
     /**
      * Returns a copy of a cache entry.
      * Used by planCacheListPlans to display plan details.
@@ -415,9 +473,9 @@ public:
     void notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries);
 
 private:
-    void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
-    void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
-    void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
+    void encodeKeyForMatch(const MatchExpression* tree, StackStringBuilder* keyBuilder) const;
+    void encodeKeyForSort(const BSONObj& sortObj, StackStringBuilder* keyBuilder) const;
+    void encodeKeyForProj(const BSONObj& projObj, StackStringBuilder* keyBuilder) const;
 
     LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
 
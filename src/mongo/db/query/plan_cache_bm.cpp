@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_test_service_context.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.collection");
+
+/**
+ * Returns the query selected by 'queryShape': 0 for a single equality, 1 for a conjunction of
+ * range predicates with a sort and a projection, and 2 for a $or of equalities.
+ */
+std::unique_ptr<QueryRequest> makeQueryRequest(int queryShape) {
+    auto qr = stdx::make_unique<QueryRequest>(kNss);
+    switch (queryShape) {
+        case 0:
+            qr->setFilter(fromjson("{a: 1}"));
+            break;
+        case 1:
+            qr->setFilter(fromjson("{a: {$gt: 1, $lt: 10}, b: {$in: [1, 2, 3]}, c: 'x'}"));
+            qr->setSort(fromjson("{d: -1}"));
+            qr->setProj(fromjson("{_id: 0, a: 1, d: 1}"));
+            break;
+        default:
+            qr->setFilter(fromjson("{$or: [{a: 1}, {b: 2}, {c: 3, d: {$exists: true}}]}"));
+            break;
+    }
+    return qr;
+}
+
+/**
+ * Benchmark computing the plan cache key of a query, and the query hash derived from it, which
+ * every query that can use the plan cache does before planning.
+ */
+void BM_PlanCacheComputeKey(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx.get(),
+                                                           makeQueryRequest(state.range(0)),
+                                                           nullptr,
+                                                           ExtensionsCallbackNoop()));
+
+    PlanCache planCache;
+    planCache.notifyOfIndexEntries({IndexEntry(BSON("a" << 1), "a_1"),
+                                    IndexEntry(BSON("b" << 1 << "c" << 1), "b_1_c_1"),
+                                    IndexEntry(BSON("d" << -1), "d_-1")});
+
+    for (auto keepRunning : state) {
+        PlanCacheKey key = planCache.computeKey(*cq);
+        benchmark::DoNotOptimize(PlanCache::computeQueryHash(key));
+    }
+}
+
+BENCHMARK(BM_PlanCacheComputeKey)->DenseRange(0, 2);
+
+}  // namespace
+}  // namespace mongo
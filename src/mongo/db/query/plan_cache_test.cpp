@@ -446,6 +446,68 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+// A replan that flips back to an earlier winner raises the works the cached plan is given.
+TEST(PlanCacheTest, ReplanFlipRaisesWorksFloor) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QueryTestServiceContext serviceContext;
+
+    QuerySolution collScan;
+    collScan.cacheData.reset(new SolutionCacheData());
+    collScan.cacheData->solnType = SolutionCacheData::COLLSCAN_SOLN;
+    QuerySolution indexed;
+    indexed.cacheData.reset(new SolutionCacheData());
+    indexed.cacheData->tree.reset(new PlanCacheIndexTree());
+
+    auto addWinner = [&](QuerySolution* winner, size_t works) {
+        std::vector<QuerySolution*> solns{winner};
+        PlanRankingDecision* decision = createDecision(1U);
+        decision->stats[0]->common.works = works;
+        ASSERT_OK(planCache.add(*cq, solns, decision, Date_t{}));
+    };
+    auto getDecisionWorks = [&]() {
+        CachedSolution* rawCachedSolution;
+        ASSERT_OK(planCache.get(*cq, &rawCachedSolution));
+        unique_ptr<CachedSolution> cachedSolution(rawCachedSolution);
+        return cachedSolution->decisionWorks;
+    };
+
+    // The shape can't be replanned before it is cached.
+    ASSERT_NOT_OK(planCache.recordReplan(*cq, 10U));
+
+    addWinner(&collScan, 5U);
+    ASSERT_EQUALS(getDecisionWorks(), 5U);
+
+    // Replanning to a plan that never won before is not a flip.
+    ASSERT_OK(planCache.recordReplan(*cq, 50U));
+    addWinner(&indexed, 7U);
+    ASSERT_EQUALS(getDecisionWorks(), 7U);
+
+    // Replanning back to the collection scan is.
+    ASSERT_OK(planCache.recordReplan(*cq, 70U));
+    addWinner(&collScan, 5U);
+    ASSERT_EQUALS(getDecisionWorks(), 70U);
+
+    // Adding the same winner again without a replan leaves the floor alone.
+    addWinner(&collScan, 3U);
+    ASSERT_EQUALS(getDecisionWorks(), 70U);
+
+    PlanCacheEntry* rawEntry;
+    ASSERT_OK(planCache.getEntry(*cq, &rawEntry));
+    unique_ptr<PlanCacheEntry> entry(rawEntry);
+    ASSERT_EQUALS(entry->shapeHistory.replans, 2);
+    ASSERT_EQUALS(entry->shapeHistory.flips, 1);
+    ASSERT_EQUALS(entry->shapeHistory.worksFloor, 70U);
+    ASSERT_EQUALS(entry->shapeHistory.winners.size(), 4U);
+    ASSERT_EQUALS(entry->shapeHistory.winners.front().solution, "(collection scan)");
+    ASSERT_EQUALS(entry->shapeHistory.winners.back().works, 3U);
+
+    // Clearing the cache forgets the shape's history.
+    planCache.clear();
+    addWinner(&indexed, 7U);
+    ASSERT_EQUALS(getDecisionWorks(), 7U);
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -1406,6 +1468,26 @@ TEST(PlanCacheTest, ComputeKeyEscaped) {
     testComputeKey("{}", "{}", "{a: 'foo,[]~|<>'}", "an|ia");
 }
 
+// Keys longer than the encoder's stack buffer must be encoded in full.
+TEST(PlanCacheTest, ComputeKeyLongerThanStackBuffer) {
+    PlanCache planCache;
+    const std::string fieldName(600, 'x');
+    unique_ptr<CanonicalQuery> cq(canonicalize(BSON(fieldName << 1)));
+    ASSERT_EQUALS("eq" + fieldName, planCache.computeKey(*cq));
+}
+
+// Queries with the same shape share a query hash; queries with different shapes do not.
+TEST(PlanCacheTest, ComputeQueryHash) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cqA(canonicalize("{a: 1, b: 1}", "{}", "{}", "{}"));
+    unique_ptr<CanonicalQuery> cqB(canonicalize("{a: 5, b: 'foo'}", "{}", "{}", "{}"));
+    unique_ptr<CanonicalQuery> cqC(canonicalize("{a: 1, b: 1}", "{a: 1}", "{}", "{}"));
+
+    auto hashA = PlanCache::computeQueryHash(planCache.computeKey(*cqA));
+    ASSERT_EQUALS(hashA, PlanCache::computeQueryHash(planCache.computeKey(*cqB)));
+    ASSERT_NOT_EQUALS(hashA, PlanCache::computeQueryHash(planCache.computeKey(*cqC)));
+}
+
 // Cache keys for $geoWithin queries with legacy and GeoJSON coordinates should
 // not be the same.
 TEST(PlanCacheTest, ComputeKeyGeoWithin) {
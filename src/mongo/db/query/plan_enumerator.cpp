@@ -34,6 +34,7 @@
 
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/util/log.h"
 #include "mongo/util/string_map.h"
 
@@ -260,6 +261,7 @@ PlanEnumerator::PlanEnumerator(const PlanEnumeratorParams& params)
     : _root(params.root),
       _indices(params.indices),
       _ixisect(params.intersect),
+      _skipScans(params.skipScans),
       _orLimit(params.maxSolutionsPerOr),
       _intersectLimit(params.maxIntersectPerAnd) {}
 
@@ -983,6 +985,41 @@ void PlanEnumerator::enumerateOneIndex(
             andAssignment->choices.push_back(std::move(state));
         }
     }
+
+    if (!_skipScans) {
+        return;
+    }
+
+    // For each index with predicates over its non-leading fields only, assign those predicates
+    // to it. The access planner fills in all values for the unconstrained leading fields.
+    for (IndexToPredMap::const_iterator it = idxToNotFirst.begin(); it != idxToNotFirst.end();
+         ++it) {
+        if (idxToFirst.find(it->first) != idxToFirst.end()) {
+            continue;
+        }
+
+        const IndexEntry& thisIndex = (*_indices)[it->first];
+        if (!QueryPlannerIXSelect::canUseIndexForSkipScan(thisIndex)) {
+            continue;
+        }
+
+        OneIndexAssignment indexAssign;
+        indexAssign.index = it->first;
+
+        // Outside predicates are not pushed down into a skip scan.
+        for (auto pred : it->second) {
+            if (outsidePreds.find(pred) == outsidePreds.end()) {
+                indexAssign.preds.push_back(pred);
+                indexAssign.positions.push_back(getPosition(thisIndex, pred));
+            }
+        }
+
+        if (!indexAssign.preds.empty()) {
+            AndEnumerableState state;
+            state.assignments.push_back(std::move(indexAssign));
+            andAssignment->choices.push_back(std::move(state));
+        }
+    }
 }
 
 void PlanEnumerator::enumerateAndIntersect(const IndexToPredMap& idxToFirst,
@@ -43,6 +43,7 @@ namespace mongo {
 struct PlanEnumeratorParams {
     PlanEnumeratorParams()
         : intersect(false),
+          skipScans(false),
           maxSolutionsPerOr(internalQueryEnumerationMaxOrSolutions.load()),
           maxIntersectPerAnd(internalQueryEnumerationMaxIntersectPerAnd.load()) {}
 
@@ -50,6 +51,10 @@ struct PlanEnumeratorParams {
     // an indexed solution?
     bool intersect;
 
+    // Do we provide solutions that use a compound index although only its non-leading fields are
+    // constrained? See QueryPlannerIXSelect::canUseIndexForSkipScan().
+    bool skipScans;
+
     // Not owned here.
     MatchExpression* root;
 
@@ -544,6 +549,9 @@ private:
     // Do we output >1 index per AND (index intersection)?
     bool _ixisect;
 
+    // Do we output assignments to indexes with no predicate over their leading field?
+    bool _skipScans;
+
     // How many enumerations are we willing to produce from each OR?
     size_t _orLimit;
 
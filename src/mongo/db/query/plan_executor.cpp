@@ -75,6 +75,10 @@ namespace {
 
 MONGO_FAIL_POINT_DEFINE(planExecutorAlwaysFails);
 
+// The most units of work getNext() asks of the plan in one call, when the plan's results can be
+// buffered. Kept small so that the yield policy is still consulted often.
+const size_t kMaxWorkBatchSize = 16;
+
 /**
  * Constructs a PlanYieldPolicy based on 'policy'.
  */
@@ -508,10 +512,31 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     if (!_stash.empty()) {
         invariant(objOut && !dlOut);
         *objOut = {SnapshotId(), _stash.front()};
-        _stash.pop();
+        _stash.pop_front();
         return PlanExecutor::ADVANCED;
     }
 
+    while (!_batchedResults.empty()) {
+        const WorkingSetID id = _batchedResults.front();
+        _batchedResults.pop_front();
+        if (extractResult(id, objOut, dlOut)) {
+            return PlanExecutor::ADVANCED;
+        }
+    }
+
+    if (_deferredFailure) {
+        if (objOut) {
+            *objOut = {SnapshotId(), _deferredFailure->second};
+        }
+        return _deferredFailure->first;
+    }
+
+    // Buffered results are owned so that they survive yields, but only storage engines with
+    // document-level locking make them owned, and the others would invalidate them behind our
+    // back. So on the latter we only ever ask for one result at a time.
+    const size_t maxBatchSize = supportsDocLocking() ? kMaxWorkBatchSize : 1;
+    std::vector<WorkingSetID> batch;
+
     // When a stage requests a yield for document fetch, it gives us back a RecordFetcher*
     // to use to pull the record into memory. We take ownership of the RecordFetcher here,
     // deleting it after we've had a chance to do the fetch. For timing-based yields, we
@@ -550,47 +575,27 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         fetcher.reset();
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        batch.clear();
+        PlanStage::StageState code = _root->workBatch(maxBatchSize, &batch, &id);
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
 
         if (PlanStage::ADVANCED == code) {
-            WorkingSetMember* member = _workingSet->get(id);
-            bool hasRequestedData = true;
-
-            if (NULL != objOut) {
-                if (WorkingSetMember::RID_AND_IDX == member->getState()) {
-                    if (1 != member->keyData.size()) {
-                        _workingSet->free(id);
-                        hasRequestedData = false;
-                    } else {
-                        // TODO: currently snapshot ids are only associated with documents, and
-                        // not with index keys.
-                        *objOut = Snapshotted<BSONObj>(SnapshotId(), member->keyData[0].keyData);
-                    }
-                } else if (member->hasObj()) {
-                    *objOut = member->obj;
-                } else {
-                    _workingSet->free(id);
-                    hasRequestedData = false;
-                }
+            // Every result but the last one is already owned by the plan.
+            if (batch.size() > 1) {
+                _workingSet->get(batch.back())->makeObjOwnedIfNeeded();
             }
 
-            if (NULL != dlOut) {
-                if (member->hasRecordId()) {
-                    *dlOut = member->recordId;
-                } else {
-                    _workingSet->free(id);
-                    hasRequestedData = false;
+            _batchedResults.insert(_batchedResults.end(), batch.begin(), batch.end());
+            while (!_batchedResults.empty()) {
+                id = _batchedResults.front();
+                _batchedResults.pop_front();
+                if (extractResult(id, objOut, dlOut)) {
+                    return PlanExecutor::ADVANCED;
                 }
             }
-
-            if (hasRequestedData) {
-                _workingSet->free(id);
-                return PlanExecutor::ADVANCED;
-            }
-            // This result didn't have the data the caller wanted, try again.
+            // None of the results had the data the caller wanted, try again.
         } else if (PlanStage::NEED_YIELD == code) {
             if (id == WorkingSet::INVALID_ID) {
                 if (!_yieldPolicy->canAutoYield())
@@ -638,9 +643,42 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     }
 }
 
+bool PlanExecutor::extractResult(WorkingSetID id, Snapshotted<BSONObj>* objOut, RecordId* dlOut) {
+    WorkingSetMember* member = _workingSet->get(id);
+    bool hasRequestedData = true;
+
+    if (NULL != objOut) {
+        if (WorkingSetMember::RID_AND_IDX == member->getState()) {
+            if (1 != member->keyData.size()) {
+                hasRequestedData = false;
+            } else {
+                // TODO: currently snapshot ids are only associated with documents, and
+                // not with index keys.
+                *objOut = Snapshotted<BSONObj>(SnapshotId(), member->keyData[0].keyData);
+            }
+        } else if (member->hasObj()) {
+            *objOut = member->obj;
+        } else {
+            hasRequestedData = false;
+        }
+    }
+
+    if (NULL != dlOut) {
+        if (member->hasRecordId()) {
+            *dlOut = member->recordId;
+        } else {
+            hasRequestedData = false;
+        }
+    }
+
+    _workingSet->free(id);
+    return hasRequestedData;
+}
+
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() ||
+        (_stash.empty() && _batchedResults.empty() && !_deferredFailure && _root->isEOF());
 }
 
 void PlanExecutor::markAsKilled(Status killStatus) {
@@ -695,7 +733,39 @@ Status PlanExecutor::executePlan() {
 
 
 void PlanExecutor::enqueue(const BSONObj& obj) {
-    _stash.push(obj.getOwned());
+    _stash.push_back(obj.getOwned());
+}
+
+void PlanExecutor::requeue(const BSONObj& obj) {
+    _stash.push_front(obj.getOwned());
+}
+
+long long PlanExecutor::prefetch(long long maxBytes, const stdx::function<bool()>& shouldStop) {
+    invariant(_currentState == kUsable);
+
+    // Set the stash aside while running the plan, so that getNext() produces new results rather
+    // than returning stashed ones.
+    std::deque<BSONObj> stash;
+    stash.swap(_stash);
+    const auto restoreStash = MakeGuard([&] { _stash.swap(stash); });
+
+    long long numStashed = 0;
+    long long bytesStashed = 0;
+    BSONObj obj;
+    while (!_deferredFailure && bytesStashed < maxBytes && !shouldStop()) {
+        const ExecState state = getNext(&obj, nullptr);
+        if (state == PlanExecutor::IS_EOF) {
+            break;
+        }
+        if (state != PlanExecutor::ADVANCED) {
+            _deferredFailure.emplace(state, obj.getOwned());
+            break;
+        }
+        stash.push_back(obj.getOwned());
+        bytesStashed += stash.back().objsize();
+        ++numStashed;
+    }
+    return numStashed;
 }
 
 Timestamp PlanExecutor::getLatestOplogTimestamp() {
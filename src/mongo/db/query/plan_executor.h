@@ -29,13 +29,14 @@
 #pragma once
 
 #include <boost/optional.hpp>
-#include <queue>
+#include <deque>
 
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/util/partitioned.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/storage/snapshot.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
@@ -422,6 +423,23 @@ public:
      */
     void enqueue(const BSONObj& obj);
 
+    /**
+     * Stashes 'obj', which was just returned by getNext(), so that the next call to getNext()
+     * returns it again, ahead of any results that were already stashed.
+     */
+    void requeue(const BSONObj& obj);
+
+    /**
+     * Runs the plan ahead of demand, stashing its results to be returned by later calls to
+     * getNext(). Stops once 'maxBytes' worth of results have been stashed, the plan is exhausted,
+     * or 'shouldStop' returns true, which it is asked before each result. Returns the number of
+     * results stashed.
+     *
+     * A failure of the plan is not returned, but deferred until getNext() has returned everything
+     * stashed before it.
+     */
+    long long prefetch(long long maxBytes, const stdx::function<bool()>& shouldStop);
+
     /**
      * Helper method which returns a set of BSONObj, where each represents a sort order of our
      * output.
@@ -496,6 +514,12 @@ private:
 
     ExecState getNextImpl(Snapshotted<BSONObj>* objOut, RecordId* dlOut);
 
+    /**
+     * Fills in 'objOut' and 'dlOut' from the result 'id' produced by the plan, which is freed.
+     * Returns false if the result doesn't have the data the caller asked for.
+     */
+    bool extractResult(WorkingSetID id, Snapshotted<BSONObj>* objOut, RecordId* dlOut);
+
     /**
      * New PlanExecutor instances are created with the static make() methods above.
      */
@@ -568,7 +592,15 @@ private:
     // A stash of results generated by this plan that the user of the PlanExecutor didn't want
     // to consume yet. We empty the queue before retrieving further results from the plan
     // stages.
-    std::queue<BSONObj> _stash;
+    std::deque<BSONObj> _stash;
+
+    // Results produced by a call to workBatch() on the plan and not yet returned by getNext().
+    // Every member is owned, so that it remains valid across yields. These are returned after
+    // the stash and before any further results from the plan stages.
+    std::deque<WorkingSetID> _batchedResults;
+
+    // Set if prefetch() ran into a failure, which is returned by getNext() once the stash is empty.
+    boost::optional<std::pair<ExecState, BSONObj>> _deferredFailure;
 
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
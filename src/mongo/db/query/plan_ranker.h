@@ -70,7 +70,7 @@ public:
  */
 struct CandidatePlan {
     CandidatePlan(std::unique_ptr<QuerySolution> solution, PlanStage* r, WorkingSet* w)
-        : solution(std::move(solution)), root(r), ws(w), failed(false) {}
+        : solution(std::move(solution)), root(r), ws(w), failed(false), pruned(false) {}
 
     std::unique_ptr<QuerySolution> solution;
     PlanStage* root;  // Not owned here.
@@ -80,6 +80,10 @@ struct CandidatePlan {
     std::list<WorkingSetID> results;
 
     bool failed;
+
+    // True if the plan was dropped from the trial period because it fell too far behind the
+    // other candidates. A pruned plan is still ranked based on the work it did before pruning.
+    bool pruned;
 };
 
 /**
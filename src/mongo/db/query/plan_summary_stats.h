@@ -27,10 +27,24 @@
 
 #pragma once
 
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <cstdint>
 #include <string>
 
 namespace mongo {
 
+/**
+ * The memory statistics of a single stage which buffers data, such as a blocking sort or $group.
+ */
+struct StageMemoryStats {
+    // The most memory the stage held at once, in bytes.
+    long long peakMemUsage = 0;
+
+    // The number of times the stage wrote buffered data to disk.
+    long long spills = 0;
+};
+
 /**
  * A container for the summary statistics that the profiler, slow query log, and
  * other non-explain debug mechanisms may want to collect.
@@ -60,6 +74,19 @@ struct PlanSummaryStats {
 
     // Was a replan triggered during the execution of this query?
     bool replanned = false;
+
+    // The fingerprint of the query shape, if the plan was built from a canonical query.
+    boost::optional<std::uint64_t> queryHash;
+
+    // The largest peak memory usage of any stage which buffers data, in bytes, and the number of
+    // times such stages wrote buffered data to disk.
+    long long peakStageMemUsage = 0;
+    long long stageSpills = 0;
+
+    void addStageMemoryStats(const StageMemoryStats& stageStats) {
+        peakStageMemUsage = std::max(peakStageMemUsage, stageStats.peakMemUsage);
+        stageSpills += stageStats.spills;
+    }
 };
 
 }  // namespace mongo
@@ -589,6 +589,11 @@ void QueryPlannerAccess::finishLeafNode(QuerySolutionNode* node, const IndexEntr
         return;
     }
 
+    if (INDEX_WILDCARD == index.type) {
+        finishWildcardIndexScanNode(node, index);
+        return;
+    }
+
     IndexBounds* bounds = NULL;
 
     if (STAGE_GEO_NEAR_2D == type) {
@@ -649,6 +654,29 @@ void QueryPlannerAccess::finishLeafNode(QuerySolutionNode* node, const IndexEntr
     IndexBoundsBuilder::alignBounds(bounds, index.keyPattern);
 }
 
+// static
+void QueryPlannerAccess::finishWildcardIndexScanNode(QuerySolutionNode* node,
+                                                     const IndexEntry& index) {
+    invariant(STAGE_IXSCAN == node->getType());
+    IndexScanNode* scan = static_cast<IndexScanNode*>(node);
+    IndexBounds* bounds = &scan->bounds;
+
+    const BSONElement pathElt = index.keyPattern.firstElement();
+    invariant(1U == bounds->fields.size());
+    if (bounds->fields[0].name.empty()) {
+        IndexBoundsBuilder::allValuesForField(pathElt, &bounds->fields[0]);
+    }
+    IndexBoundsBuilder::alignBounds(bounds, index.keyPattern);
+
+    // Every key of the wildcard index leads with the path of its value.
+    const std::string path = pathElt.fieldName();
+    OrderedIntervalList pathBounds("$_path");
+    pathBounds.intervals.push_back(IndexBoundsBuilder::makePointInterval(path));
+    bounds->fields.insert(bounds->fields.begin(), std::move(pathBounds));
+
+    scan->index.keyPattern = BSON("$_path" << 1 << path << 1);
+}
+
 // static
 void QueryPlannerAccess::findElemMatchChildren(const MatchExpression* node,
                                                vector<MatchExpression*>* out,
@@ -365,6 +365,7 @@ public:
      *
      * If geo, do nothing.
      * If text, punt to finishTextNode.
+     * If wildcard, punt to finishWildcardIndexScanNode.
      */
     static void finishLeafNode(QuerySolutionNode* node, const IndexEntry& index);
 
@@ -386,6 +387,13 @@ public:
 
     static void finishTextNode(QuerySolutionNode* node, const IndexEntry& index);
 
+    /**
+     * Turns a scan of the expanded wildcard index entry {<path>: 1} (see
+     * QueryPlannerIXSelect::expandWildcardIndex) into a scan of the wildcard index's keys, whose
+     * key pattern is {$_path: 1, <path>: 1}, with a point interval on <path> for the first field.
+     */
+    static void finishWildcardIndexScanNode(QuerySolutionNode* node, const IndexEntry& index);
+
     /**
      * Add the filter 'match' to the query solution node 'node'. Takes
      * ownership of 'match'.
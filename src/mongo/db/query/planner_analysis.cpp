@@ -290,6 +290,25 @@ void geoSkipValidationOn(const std::set<StringData>& twoDSphereFields,
     }
 }
 
+/**
+ * If 'sort' is a top-k sort on the text score directly over a TEXT node, lets the TEXT node know
+ * that only the documents with the 'sort->limit' highest scores are needed. Any stage in between,
+ * such as a FETCH with a residual filter, could discard some of those documents, in which case
+ * the TEXT node must return all of its results.
+ */
+void pushLimitIntoText(SortNode* sort) {
+    if (!sort->limit || sort->pattern.nFields() != 1 ||
+        !QueryRequest::isTextScoreMeta(sort->pattern.firstElement())) {
+        return;
+    }
+
+    QuerySolutionNode* keyGen = sort->children[0];
+    invariant(STAGE_SORT_KEY_GENERATOR == keyGen->getType());
+    if (STAGE_TEXT == keyGen->children[0]->getType()) {
+        static_cast<TextNode*>(keyGen->children[0])->limit = sort->limit;
+    }
+}
+
 }  // namespace
 
 // static
@@ -610,6 +629,8 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    pushLimitIntoText(sort);
+
     *blockingSortOut = true;
 
     return solnRoot;
@@ -30,9 +30,11 @@
 
 #include "mongo/db/query/planner_ixselect.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/simple_string_data_comparator.h"
+#include "mongo/db/field_ref.h"
 #include "mongo/db/geo/hash.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/index_names.h"
@@ -41,6 +43,7 @@
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_internal_expr_eq.h"
 #include "mongo/db/matcher/expression_text.h"
+#include "mongo/db/matcher/path_internal.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
@@ -69,6 +72,68 @@ bool elemMatchValueCompatible(const BSONElement& elt,
     return true;
 }
 
+/**
+ * Returns true if a wildcard index with the key pattern field 'prefix' has keys for 'path', so
+ * that it can be expanded into an entry over 'path'. Paths with a numeric component are excluded,
+ * since they may refer to an array position while the keys only record the paths of arrays.
+ */
+bool wildcardIndexCoversPath(StringData prefix, StringData path) {
+    if (!path.startsWith(prefix) || (path.size() > prefix.size() && path[prefix.size()] != '.')) {
+        return false;
+    }
+
+    FieldRef fieldRef(path);
+    for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+        if (isAllDigits(fieldRef.getPart(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Wildcard indexes only have keys for scalar values, and none for documents which lack a path.
+ * They can answer comparisons to scalars, but nothing which may match an object, an array, null
+ * or a missing field.
+ */
+bool isWildcardIndexableValue(const BSONElement& elt) {
+    switch (elt.type()) {
+        case EOO:
+        case MinKey:
+        case MaxKey:
+        case jstNULL:
+        case Undefined:
+        case Object:
+        case Array:
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool compatibleWithWildcardIndex(const MatchExpression* node) {
+    switch (node->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return isWildcardIndexableValue(
+                static_cast<const ComparisonMatchExpressionBase*>(node)->getData());
+        case MatchExpression::MATCH_IN: {
+            const InMatchExpression* expr = static_cast<const InMatchExpression*>(node);
+            const auto& equalities = expr->getEqualities();
+            return expr->getRegexes().empty() &&
+                std::all_of(equalities.begin(), equalities.end(), isWildcardIndexableValue);
+        }
+        case MatchExpression::ELEM_MATCH_VALUE:
+            // Each child is checked separately.
+            return true;
+        default:
+            return false;
+    }
+}
+
 }  // namespace
 
 static double fieldWithDefault(const BSONObj& infoObj, const string& name, double def) {
@@ -174,17 +239,71 @@ void QueryPlannerIXSelect::getFields(const MatchExpression* node,
 // static
 void QueryPlannerIXSelect::findRelevantIndices(const stdx::unordered_set<string>& fields,
                                                const vector<IndexEntry>& allIndices,
+                                               bool allowSkipScans,
                                                vector<IndexEntry>* out) {
     for (size_t i = 0; i < allIndices.size(); ++i) {
+        if (INDEX_WILDCARD == allIndices[i].type) {
+            expandWildcardIndex(allIndices[i], fields, out);
+            continue;
+        }
+
         BSONObjIterator it(allIndices[i].keyPattern);
         verify(it.more());
         BSONElement elt = it.next();
         if (fields.end() != fields.find(elt.fieldName())) {
             out->push_back(allIndices[i]);
+            continue;
+        }
+
+        if (!allowSkipScans || !canUseIndexForSkipScan(allIndices[i])) {
+            continue;
+        }
+
+        while (it.more()) {
+            if (fields.end() != fields.find(it.next().fieldName())) {
+                out->push_back(allIndices[i]);
+                break;
+            }
         }
     }
 }
 
+// static
+void QueryPlannerIXSelect::expandWildcardIndex(const IndexEntry& wildcardIndex,
+                                               const stdx::unordered_set<string>& fields,
+                                               vector<IndexEntry>* out) {
+    invariant(INDEX_WILDCARD == wildcardIndex.type);
+    const StringData prefix = wildcardIndex.keyPattern.firstElementFieldName();
+
+    // Sort the paths so that planning doesn't depend on the iteration order of 'fields'.
+    vector<string> paths;
+    for (auto&& field : fields) {
+        if (wildcardIndexCoversPath(prefix, field)) {
+            paths.push_back(field);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    for (auto&& path : paths) {
+        IndexEntry entry(wildcardIndex);
+        entry.keyPattern = BSON(path << 1);
+
+        // Array elements each have their own key and documents without the path have none, so the
+        // entry behaves like a multikey sparse index over 'path'. Without path-level multikey
+        // information it can never cover a projection.
+        entry.multikey = true;
+        entry.multikeyPaths.clear();
+        entry.sparse = true;
+        out->push_back(std::move(entry));
+    }
+}
+
+// static
+bool QueryPlannerIXSelect::canUseIndexForSkipScan(const IndexEntry& index) {
+    return INDEX_BTREE == index.type && !index.multikey && !index.sparse &&
+        !index.filterExpr && index.keyPattern.nFields() > 1;
+}
+
 // static
 bool QueryPlannerIXSelect::compatible(const BSONElement& elt,
                                       const IndexEntry& index,
@@ -198,6 +317,10 @@ bool QueryPlannerIXSelect::compatible(const BSONElement& elt,
         return false;
     }
 
+    if (INDEX_WILDCARD == index.type) {
+        return compatibleWithWildcardIndex(node);
+    }
+
     // Historically one could create indices with any particular value for the index spec,
     // including values that now indicate a special index.  As such we have to make sure the
     // index type wasn't overridden before we pay attention to the string in the index key
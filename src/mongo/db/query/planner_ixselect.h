@@ -56,11 +56,37 @@ public:
     /**
      * Find all indices prefixed by fields we have predicates over.  Only these indices are
      * useful in answering the query.
+     *
+     * If 'allowSkipScans' is true, also finds the indices which can be used for a skip scan (see
+     * canUseIndexForSkipScan()) and have a non-leading field that we have predicates over.
      */
     static void findRelevantIndices(const stdx::unordered_set<std::string>& fields,
                                     const std::vector<IndexEntry>& indices,
+                                    bool allowSkipScans,
                                     std::vector<IndexEntry>* out);
 
+    /**
+     * Appends to 'out' one entry for each of 'fields' which lies at or beneath the prefix of the
+     * wildcard index 'wildcardIndex'. Each entry has the single field key pattern {<field>: 1} and
+     * keeps the wildcard index's name and type. The planner assigns predicates to these entries
+     * like to any other index, and QueryPlannerAccess turns scans of them into scans of the
+     * wildcard index restricted to the field's path.
+     *
+     * Wildcard indexes found by findRelevantIndices are expanded this way.
+     */
+    static void expandWildcardIndex(const IndexEntry& wildcardIndex,
+                                    const stdx::unordered_set<std::string>& fields,
+                                    std::vector<IndexEntry>* out);
+
+    /**
+     * Returns true if 'index' can answer predicates over its non-leading fields when there are no
+     * predicates over its leading field, by scanning all values of the leading field. This is
+     * limited to compound btree indexes which are neither multikey, sparse nor partial, so that
+     * every document has exactly one key in the index and no predicate assignment rules other
+     * than those for compounding apply.
+     */
+    static bool canUseIndexForSkipScan(const IndexEntry& index);
+
     /**
      * Return true if the index key pattern field 'elt' (which belongs to 'index') can be used
      * to answer the predicate 'node'.
@@ -38,12 +38,18 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationPruneWorks, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEstimateSkipTrialRatio, double, 10.0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictionRatio, double, 10.0);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheMaxPlanHistory, int, 4);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -66,19 +72,59 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecStageTimingSampleInterval, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecDeleteBatchSize, int, 64);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecUpdateBatchSize, int, 64);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetMaxParallelism, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnableExpressionBytecode, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalChangeStreamUseSharedOplogReader, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalChangeStreamSharedOplogBufferMaxBytes,
+                              int,
+                              64 * 1024 * 1024);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
                               int,
                               internalQueryExecYieldIterations.load() / 2);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxAdaptiveBatchSize, int, 1024);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4 * 1024 * 1024);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryOutDeferIndexBuilds, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExchangeMaxBufferedBytesPerConsumer,
+                              int,
+                              16 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxSizeBytes, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupBatchSize, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalChangeStreamPostImageLookupBatchSize, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupSpillPartitions, int, 0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateSkipScans, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitBlockingMergeOnMongoS, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryRegexCacheSize, int, 1000);
 }  // namespace mongo
@@ -48,6 +48,16 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// Once each candidate plan has been worked this many times, stop working the candidates that
+// haven't produced any results yet if another candidate has. Zero disables pruning.
+extern AtomicInt32 internalQueryPlanEvaluationPruneWorks;
+
+// When the analyze command has gathered statistics for every index the candidate plans of an
+// unsorted query scan, the plan with the least estimated work is chosen without a trial run if
+// every other candidate is estimated to do at least this many times more. Close calls are still
+// decided by a trial run. Zero or less always runs a trial.
+extern AtomicDouble internalQueryPlanEstimateSkipTrialRatio;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -72,6 +82,10 @@ extern AtomicInt32 internalQueryCacheFeedbacksStored;
 // and replanning?
 extern AtomicDouble internalQueryCacheEvictionRatio;
 
+// How many of the most recent winning plans do we remember per query shape, to recognize shapes
+// whose winning plan keeps flipping between replans?
+extern AtomicInt32 internalQueryCacheMaxPlanHistory;
+
 //
 // Planning and enumeration.
 //
@@ -95,6 +109,10 @@ extern AtomicInt32 internalQueryMaxScansToExplode;
 // Allow the planner to generate covered whole index scans, rather than falling back to a COLLSCAN.
 extern AtomicBool internalQueryPlannerGenerateCoveredWholeIndexScans;
 
+// Allow the planner to use compound indexes for predicates which only constrain non-leading
+// fields, by scanning all values of the leading fields.
+extern AtomicBool internalQueryPlannerGenerateSkipScans;
+
 // Ignore unknown JSON Schema keywords.
 extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
@@ -110,17 +128,84 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// Time only one in this many calls to each PlanStage's work() and scale the measurement up to
+// estimate execution time. A value of 1 or less times every call.
+extern AtomicInt32 internalQueryExecStageTimingSampleInterval;
+
+// The number of documents a multi-delete removes together, in one storage transaction with one
+// sorted pass over each index. A value of 1 or less deletes documents one at a time.
+extern AtomicInt32 internalQueryExecDeleteBatchSize;
+
+// The number of documents a multi-update updates together in one storage transaction. A value of
+// 1 or less updates documents one at a time.
+extern AtomicInt32 internalQueryExecUpdateBatchSize;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
 // The number of bytes to buffer at once during a $facet stage.
 extern AtomicInt32 internalQueryFacetBufferSizeBytes;
 
+// The maximum number of threads a $facet stage uses to run its sub-pipelines concurrently. Values
+// of 1 or less run every sub-pipeline on the thread executing the $facet.
+extern AtomicInt32 internalQueryFacetMaxParallelism;
+
+// If true, the computed fields of $project and $addFields are compiled to a register-based program
+// when the pipeline is optimized, rather than being evaluated by walking the expression tree.
+extern AtomicBool internalQueryEnableExpressionBytecode;
+
+// If true, change streams on a replica set member read the oplog through a buffer shared by every
+// change stream on the node, rather than each scanning the oplog with its own cursor.
+extern AtomicBool internalChangeStreamUseSharedOplogReader;
+
+// The maximum size in bytes of the oplog entries retained by the shared change stream oplog buffer.
+extern AtomicInt32 internalChangeStreamSharedOplogBufferMaxBytes;
+
 extern AtomicInt32 internalInsertMaxBatchSize;
 
+// The largest number of documents an insert command puts in one batch once its batches have grown
+// after inserting without write conflicts.
+extern AtomicInt32 internalInsertMaxAdaptiveBatchSize;
+
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// The amount of memory $graphLookup may use for its search before it either spills the documents it
+// has found to disk, if allowed to, or fails.
+extern AtomicInt32 internalDocumentSourceGraphLookupMaxMemoryBytes;
+
+// If true, $out creates its temporary collection with only the _id index and builds the target's
+// secondary indexes after all documents have been inserted, rather than maintaining them on every
+// insert.
+extern AtomicBool internalQueryOutDeferIndexBuilds;
+
+// The number of bytes an exchange may buffer for any one of its consumers before the consumer
+// producing results must wait for that consumer to catch up.
+extern AtomicInt32 internalQueryExchangeMaxBufferedBytesPerConsumer;
+
+// When positive, a localField/foreignField $lookup scans the foreign collection once and joins
+// against an in-memory hash table of its documents, provided they fit within this many bytes.
+// Otherwise, the foreign collection is queried once per input document.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMaxSizeBytes;
+
+// When greater than 1, a localField/foreignField $lookup reads ahead this many input documents and
+// looks them up with a single query for the distinct values of their local fields.
+extern AtomicInt32 internalDocumentSourceLookupBatchSize;
+
+// When greater than 1, a change stream with fullDocument: "updateLookup" reads ahead up to this
+// many events which are already available and looks up the post-images of their updates with one
+// query per collection, rather than one per event.
+extern AtomicInt32 internalChangeStreamPostImageLookupBatchSize;
+
+// When greater than 1, a $group that exceeds its memory limit spills its groups to this many
+// hash partitions, which are re-aggregated one at a time, instead of spilling sorted runs that
+// are merged at the end.
+extern AtomicInt32 internalDocumentSourceGroupSpillPartitions;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
+
+// The number of compiled $regex patterns kept for reuse by later queries, or 0 to compile every
+// pattern anew. Read when the first pattern is compiled.
+extern AtomicInt32 internalQueryRegexCacheSize;
 }  // namespace mongo
@@ -136,6 +136,9 @@ string optionString(size_t options) {
             case QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE:
                 ss << "OPLOG_SCAN_WAIT_FOR_VISIBLE ";
                 break;
+            case QueryPlannerParams::GENERATE_SKIP_SCANS:
+                ss << "GENERATE_SKIP_SCANS ";
+                break;
             case QueryPlannerParams::DEFAULT:
                 MONGO_UNREACHABLE;
                 break;
@@ -321,6 +324,12 @@ StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTagge
             return Status(ErrorCodes::BadValue, "can't cache '2d' index");
         }
 
+        // The entries of a wildcard index are expanded per query from the paths of its predicates,
+        // so a cached assignment can't be mapped back onto the catalog's index entries.
+        if (INDEX_WILDCARD == relevantIndices[itag->index].type) {
+            return Status(ErrorCodes::BadValue, "can't cache 'wildcard' index");
+        }
+
         IndexEntry* ientry = new IndexEntry(relevantIndices[itag->index]);
         indexTree->entry.reset(ientry);
         indexTree->index_pos = itag->pos;
@@ -601,7 +610,11 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
     boost::optional<size_t> hintIndexNumber;
 
     if (hintIndex.isEmpty()) {
-        QueryPlannerIXSelect::findRelevantIndices(fields, params.indices, &relevantIndices);
+        QueryPlannerIXSelect::findRelevantIndices(
+            fields,
+            params.indices,
+            params.options & QueryPlannerParams::GENERATE_SKIP_SCANS,
+            &relevantIndices);
     } else {
         // Sigh.  If the hint is specified it might be using the index name.
         BSONElement firstHintElt = hintIndex.firstElement();
@@ -640,6 +653,13 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         if (!hintIndexNumber) {
             return Status(ErrorCodes::BadValue, "bad hint");
         }
+
+        // A hinted wildcard index is planned through its entries for the query's paths.
+        if (INDEX_WILDCARD == params.indices[*hintIndexNumber].type) {
+            relevantIndices.clear();
+            QueryPlannerIXSelect::expandWildcardIndex(
+                params.indices[*hintIndexNumber], fields, &relevantIndices);
+        }
     }
 
     // Deal with the .min() and .max() query options.  If either exist we can only use an index
@@ -818,6 +838,7 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         // The enumerator spits out trees tagged with IndexTag(s).
         PlanEnumeratorParams enumParams;
         enumParams.intersect = params.options & QueryPlannerParams::INDEX_INTERSECTION;
+        enumParams.skipScans = params.options & QueryPlannerParams::GENERATE_SKIP_SCANS;
         enumParams.root = query.root();
         enumParams.indices = &relevantIndices;
 
@@ -890,6 +911,14 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
     // desired behavior when an index is hinted that is not relevant to the query.
     if (!hintIndex.isEmpty()) {
         if (0 == out.size()) {
+            // A wildcard index has no single key pattern to scan in full, and it lacks documents
+            // without any path beneath its prefix.
+            if (INDEX_WILDCARD == params.indices[*hintIndexNumber].type) {
+                return Status(ErrorCodes::BadValue,
+                              "hinted wildcard index cannot answer the query; it can only be used "
+                              "for comparisons to scalars on paths beneath its prefix");
+            }
+
             // Push hinted index solution to output list if found. It is possible to end up without
             // a solution in the case where a filtering QueryPlannerParams argument, such as
             // NO_BLOCKING_SORT, leads to its exclusion.
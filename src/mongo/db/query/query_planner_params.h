@@ -99,6 +99,11 @@ struct QueryPlannerParams {
 
         // Set this so that collection scans on the oplog wait for visibility before reading.
         OPLOG_SCAN_WAIT_FOR_VISIBLE = 1 << 13,
+
+        // Set this to allow index scans over compound indexes whose leading fields are not
+        // constrained by the query. Such a scan uses all values for the leading fields and relies
+        // on the index bounds checker to seek past each distinct prefix to the bounded suffix.
+        GENERATE_SKIP_SCANS = 1 << 14,
     };
 
     // See Options enum above.
@@ -2020,6 +2020,28 @@ TEST_F(QueryPlannerTest, InCantUseHashedIndexWithRegex) {
     ASSERT_EQUALS(getNumSolutions(), 1U);
 }
 
+TEST_F(QueryPlannerTest, CompoundHashedIndexUsesEqualityOnHashedFieldAndRangeOnRest) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a"
+                  << "hashed"
+                  << "b"
+                  << 1));
+    runQuery(fromjson("{a: 5, b: {$gt: 3}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {a: 5}, node: {ixscan: {pattern: {a: 'hashed', b: 1}, filter: null}}}}");
+}
+
+TEST_F(QueryPlannerTest, CompoundHashedIndexCannotAnswerRangeOnHashedField) {
+    addIndex(BSON("a"
+                  << "hashed"
+                  << "b"
+                  << 1));
+    runQuery(fromjson("{a: {$gt: 5}, b: 3}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
 TEST_F(QueryPlannerTest, ExplodeForSortWorksWithShardingFilter) {
     params.options = QueryPlannerParams::NO_TABLE_SCAN;
     params.options |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
@@ -5498,4 +5520,55 @@ TEST_F(QueryPlannerTest, EmptyQueryWithProjectionUsesCollscanIfIndexCollationDif
         "{proj: {spec: {_id: 0, a: 1}, node: "
         "{cscan: {dir: 1}}}}");
 }
+
+//
+// Skip scans
+//
+
+TEST_F(QueryPlannerTest, PredicateOnNonLeadingFieldDoesNotUseIndexIfSkipScansDisabled) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, PredicateOnNonLeadingFieldUsesSkipScanIfEnabled) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    runQuery(fromjson("{b: 5, c: {$gt: 3}}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1, c: 1}, "
+        "bounds: {a: [['MinKey', 'MaxKey', true, true]], b: [[5, 5, true, true]], "
+        "c: [[3, Infinity, false, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanIsNotUsedForMultikeyIndex) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanIsNotUsedForSparseIndex) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), false, true);
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanIsNotGeneratedWhenLeadingFieldIsConstrained) {
+    params.options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{a: 1, b: 5}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, "
+        "bounds: {a: [[1, 1, true, true]], b: [[5, 5, true, true]]}}}}}");
+}
+
 }  // namespace
@@ -472,6 +472,76 @@ TEST_F(QueryPlannerTest, SortKeyMetaProjectionWithTextScoreMetaSort) {
         "{sortKeyGen: {node: {text: {search: 'foo'}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, TextScoreSortWithLimitPushesLimitIntoText) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo'}}, sort: {a: {$meta: 'textScore'}}, "
+        "projection: {a: {$meta: 'textScore'}}, skip: 5, limit: 10}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{skip: {n: 5, node: {proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 15, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', limit: 15}}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, TextScoreSortWithoutLimitDoesNotLimitText) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQuerySortProj(fromjson("{$text: {$search: 'foo'}}"),
+                     fromjson("{a: {$meta: 'textScore'}}"),
+                     fromjson("{a: {$meta: 'textScore'}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 0, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', limit: 0}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, TextLimitNotPushedPastResidualFilter) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo'}, b: 1}, "
+        "sort: {a: {$meta: 'textScore'}}, projection: {a: {$meta: 'textScore'}}, limit: 10}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 10, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {fetch: {filter: {b: 1}, node: "
+        "{text: {search: 'foo', limit: 0}}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, TextLimitNotPushedForCompoundSort) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo'}}, "
+        "sort: {a: {$meta: 'textScore'}, b: 1}, projection: {a: {$meta: 'textScore'}}, "
+        "limit: 10}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 10, pattern: {a: {$meta: 'textScore'}, b: 1}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', limit: 0}}}}}}}}");
+}
+
 TEST_F(QueryPlannerTest, PredicatesOverLeadingFieldsWithSharedPathPrefixHandledCorrectly) {
     const bool multikey = true;
     addIndex(BSON("a.x" << 1 << "a.y" << 1 << "b.x" << 1 << "b.y" << 1 << "_fts"
@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_planner_test_fixture.h"
+
+namespace mongo {
+namespace {
+
+const BSONObj kWildcardKeyPattern = BSON("attrs"
+                                         << "wildcard");
+
+TEST_F(QueryPlannerTest, WildcardIndexAnswersEqualityOnSubpath) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(kWildcardKeyPattern);
+
+    runQuery(fromjson("{'attrs.color': 'red'}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, "
+        "pattern: {$_path: 1, 'attrs.color': 1}, "
+        "bounds: {$_path: [['attrs.color', 'attrs.color', true, true]], "
+        "'attrs.color': [['red', 'red', true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, WildcardIndexAnswersRangeAndInOnSubpath) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(kWildcardKeyPattern);
+
+    runQuery(fromjson("{'attrs.dims.h': {$gt: 5}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, "
+        "pattern: {$_path: 1, 'attrs.dims.h': 1}, "
+        "bounds: {$_path: [['attrs.dims.h', 'attrs.dims.h', true, true]], "
+        "'attrs.dims.h': [[5, Infinity, false, true]]}}}}}");
+
+    runQuery(fromjson("{'attrs.size': {$in: [1, 2]}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, "
+        "pattern: {$_path: 1, 'attrs.size': 1}, "
+        "bounds: {$_path: [['attrs.size', 'attrs.size', true, true]], "
+        "'attrs.size': [[1, 1, true, true], [2, 2, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, WildcardIndexExpandsOncePerPath) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(kWildcardKeyPattern);
+
+    runQuery(fromjson("{'attrs.a': 1, 'attrs.b': 2}"));
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{fetch: {filter: {'attrs.b': 2}, node: {ixscan: {filter: null, "
+        "pattern: {$_path: 1, 'attrs.a': 1}, "
+        "bounds: {$_path: [['attrs.a', 'attrs.a', true, true]], "
+        "'attrs.a': [[1, 1, true, true]]}}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {'attrs.a': 1}, node: {ixscan: {filter: null, "
+        "pattern: {$_path: 1, 'attrs.b': 1}, "
+        "bounds: {$_path: [['attrs.b', 'attrs.b', true, true]], "
+        "'attrs.b': [[2, 2, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, WildcardIndexProvidesSortOnItsPath) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(kWildcardKeyPattern);
+
+    runQuerySortProj(fromjson("{'attrs.a': {$gte: 3}}"), fromjson("{'attrs.a': 1}"), BSONObj());
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, "
+        "pattern: {$_path: 1, 'attrs.a': 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, WildcardIndexCannotAnswerPredicatesWhichMatchMissingOrNonScalars) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(kWildcardKeyPattern);
+
+    runQuery(fromjson("{'attrs.a': null}"));
+    assertNumSolutions(0U);
+
+    runQuery(fromjson("{'attrs.a': {$exists: true}}"));
+    assertNumSolutions(0U);
+
+    runQuery(fromjson("{'attrs.a': {$ne: 1}}"));
+    assertNumSolutions(0U);
+
+    runQuery(fromjson("{'attrs.a': {b: 1}}"));
+    assertNumSolutions(0U);
+
+    runQuery(fromjson("{'attrs.a': [1, 2]}"));
+    assertNumSolutions(0U);
+
+    runQuery(fromjson("{'attrs.a': {$in: [1, null]}}"));
+    assertNumSolutions(0U);
+}
+
+TEST_F(QueryPlannerTest, WildcardIndexIgnoresPathsOutsideItsPrefixOrWithPositions) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(kWildcardKeyPattern);
+
+    runQuery(fromjson("{attrsx: 1}"));
+    assertNumSolutions(0U);
+
+    runQuery(fromjson("{'other.a': 1}"));
+    assertNumSolutions(0U);
+
+    runQuery(fromjson("{'attrs.tags.0': 'x'}"));
+    assertNumSolutions(0U);
+}
+
+TEST_F(QueryPlannerTest, HintedWildcardIndexMustBeUsable) {
+    addIndex(kWildcardKeyPattern);
+
+    runQueryHint(fromjson("{'attrs.a': 1}"), kWildcardKeyPattern);
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, "
+        "pattern: {$_path: 1, 'attrs.a': 1}}}}}");
+
+    runInvalidQueryHint(fromjson("{b: 1}"), kWildcardKeyPattern);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -302,6 +302,14 @@ public:
         _returnKey = returnKey;
     }
 
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
     bool showRecordId() const {
         return _showRecordId;
     }
@@ -495,6 +503,7 @@ private:
 
     bool _returnKey = false;
     bool _showRecordId = false;
+    bool _allowDiskUse = false;
     bool _hasReadPref = false;
 
     // Options that can be specified in the OP_QUERY 'flags' header.
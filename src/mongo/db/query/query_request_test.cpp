@@ -366,6 +366,7 @@ TEST(QueryRequestTest, ParseFromCommandWithOptions) {
         "sort: {a: 1},"
         "projection: {_id: 0, a: 1},"
         "showRecordId: true,"
+        "allowDiskUse: true,"
         "maxScan: 1000}}");
     const NamespaceString nss("test.testns");
     bool isExplain = false;
@@ -374,6 +375,7 @@ TEST(QueryRequestTest, ParseFromCommandWithOptions) {
 
     // Make sure the values from the command BSON are reflected in the QR.
     ASSERT(qr->showRecordId());
+    ASSERT(qr->allowDiskUse());
     ASSERT_EQUALS(1000, qr->getMaxScan());
 }
 
@@ -696,6 +698,17 @@ TEST(QueryRequestTest, ParseFromCommandShowRecordIdWrongType) {
     ASSERT_NOT_OK(result.getStatus());
 }
 
+TEST(QueryRequestTest, ParseFromCommandAllowDiskUseWrongType) {
+    BSONObj cmdObj = fromjson(
+        "{find: 'testns',"
+        "filter:  {a: 1},"
+        "allowDiskUse: 3}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    auto result = QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain);
+    ASSERT_NOT_OK(result.getStatus());
+}
+
 TEST(QueryRequestTest, ParseFromCommandTailableWrongType) {
     BSONObj cmdObj = fromjson(
         "{find: 'testns',"
@@ -995,6 +1008,7 @@ TEST(QueryRequestTest, DefaultQueryParametersCorrect) {
     ASSERT_EQUALS(0, qr->getMaxTimeMS());
     ASSERT_EQUALS(false, qr->returnKey());
     ASSERT_EQUALS(false, qr->showRecordId());
+    ASSERT_EQUALS(false, qr->allowDiskUse());
     ASSERT_EQUALS(false, qr->hasReadPref());
     ASSERT_EQUALS(false, qr->isTailable());
     ASSERT_EQUALS(false, qr->isSlaveOk());
@@ -1157,6 +1171,17 @@ TEST(QueryRequestTest, ConvertToAggregationWithCommentSucceeds) {
     ASSERT_EQ(qr.getComment(), ar.getValue().getComment());
 }
 
+TEST(QueryRequestTest, ConvertToAggregationWithAllowDiskUseSucceeds) {
+    QueryRequest qr(testns);
+    qr.setAllowDiskUse(true);
+    const auto aggCmd = qr.asAggregationCommand();
+    ASSERT_OK(aggCmd);
+
+    auto ar = AggregationRequest::parseFromBSON(testns, aggCmd.getValue());
+    ASSERT_OK(ar.getStatus());
+    ASSERT(ar.getValue().shouldAllowDiskUse());
+}
+
 TEST(QueryRequestTest, ConvertToAggregationWithShowRecordIdFails) {
     QueryRequest qr(testns);
     qr.setShowRecordId(true);
@@ -261,6 +261,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If nonzero, the results are consumed by a SORT on the text score with this limit, so only
+    // the 'limit' documents with the highest scores need to be returned.
+    size_t limit = 0u;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -66,8 +66,9 @@ void QueryYield::yieldAllLocks(OperationContext* opCtx,
     // locks). If we are yielding, we are at a safe place to do so.
     opCtx->recoveryUnit()->abandonSnapshot();
 
-    // Track the number of yields in CurOp.
+    // Track the number of yields in CurOp, and publish its storage statistics for $currentOp.
     CurOp::get(opCtx)->yielded();
+    CurOp::get(opCtx)->updateStorageStats(opCtx);
 
     MONGO_FAIL_POINT_PAUSE_WHILE_SET(setYieldAllLocksHang);
 
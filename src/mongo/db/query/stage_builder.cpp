@@ -99,6 +99,9 @@ PlanStage* buildStages(OperationContext* opCtx,
                 collection->getIndexCatalog()->findIndexByName(opCtx, ixn->index.name);
             invariant(params.descriptor);
 
+            if (INDEX_WILDCARD == ixn->index.type) {
+                params.keyPattern = ixn->index.keyPattern;
+            }
             params.bounds = ixn->bounds;
             params.direction = ixn->direction;
             params.maxScan = ixn->maxScan;
@@ -123,6 +126,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.collection = collection;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            params.allowDiskUse = cq.getQueryRequest().allowDiskUse();
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -287,6 +291,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             // fail in this case (this improvement is being tracked by SERVER-21510).
             params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
             params.wantTextScore = (cq.getProj() && cq.getProj()->wantTextScore());
+            params.limit = node->limit;
             return new TextStage(opCtx, params, ws, node->filter.get());
         }
         case STAGE_SHARDING_FILTER: {
@@ -0,0 +1,373 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query_result_cache.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/text.h"
+
+namespace mongo {
+namespace {
+
+const auto getQueryResultCache = ServiceContext::declareDecoration<QueryResultCache>();
+
+// Namespaces given on the command line, before there is a ServiceContext to hold the cache.
+std::vector<std::string> startupNamespaces;
+
+// The most memory, in bytes, that all cached query results may use together.
+MONGO_EXPORT_SERVER_PARAMETER(queryResultCacheMaxSizeBytes, long long, 64 * 1024 * 1024)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "queryResultCacheMaxSizeBytes must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+// Results larger than this many bytes are not cached.
+MONGO_EXPORT_SERVER_PARAMETER(queryResultCacheMaxEntrySizeBytes, long long, 1024 * 1024)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "queryResultCacheMaxEntrySizeBytes must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+/**
+ * The comma-separated list of namespaces whose query results are cached.
+ */
+class QueryResultCacheNamespacesParameter final : public ServerParameter {
+public:
+    QueryResultCacheNamespacesParameter()
+        : ServerParameter(ServerParameterSet::getGlobal(), "queryResultCacheNamespaces") {}
+
+    void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) final {
+        const auto namespaces = hasGlobalServiceContext()
+            ? QueryResultCache::get(getGlobalServiceContext())->getEnabledNamespaces()
+            : startupNamespaces;
+        b.append(name, StringSplitter::join(namespaces, ","));
+    }
+
+    Status set(const BSONElement& newValueElement) final {
+        if (newValueElement.type() != String) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << name() << " must be a string of comma-separated namespaces"};
+        }
+        return setFromString(newValueElement.str());
+    }
+
+    Status setFromString(const std::string& str) final {
+        std::vector<std::string> namespaces;
+        for (auto&& ns : StringSplitter::split(str, ",")) {
+            if (ns.empty()) {
+                continue;
+            }
+            if (!NamespaceString(ns).isValid()) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << name() << " contains an invalid namespace: " << ns};
+            }
+            namespaces.push_back(ns);
+        }
+        if (hasGlobalServiceContext()) {
+            QueryResultCache::get(getGlobalServiceContext())->setEnabledNamespaces(namespaces);
+        } else {
+            startupNamespaces = std::move(namespaces);
+        }
+        return Status::OK();
+    }
+} queryResultCacheNamespacesParameter;
+
+Counter64 queryResultCacheHits;
+Counter64 queryResultCacheMisses;
+Counter64 queryResultCacheInvalidations;
+Counter64 queryResultCacheEvictions;
+
+ServerStatusMetricField<Counter64> displayQueryResultCacheHits("queryResultCache.hits",
+                                                               &queryResultCacheHits);
+ServerStatusMetricField<Counter64> displayQueryResultCacheMisses("queryResultCache.misses",
+                                                                 &queryResultCacheMisses);
+ServerStatusMetricField<Counter64> displayQueryResultCacheInvalidations(
+    "queryResultCache.invalidations", &queryResultCacheInvalidations);
+ServerStatusMetricField<Counter64> displayQueryResultCacheEvictions("queryResultCache.evictions",
+                                                                    &queryResultCacheEvictions);
+
+}  // namespace
+
+QueryResultCache::QueryResultCache()
+    : _enabledNamespaces(startupNamespaces.begin(), startupNamespaces.end()) {
+    _anyEnabled.store(!_enabledNamespaces.empty());
+}
+
+QueryResultCache* QueryResultCache::get(ServiceContext* serviceContext) {
+    return &getQueryResultCache(serviceContext);
+}
+
+BSONObj QueryResultCache::makeKey(OperationContext* opCtx,
+                                  const UUID& uuid,
+                                  const BSONObj& cmdObj) {
+    // Statements in a transaction read from its snapshot, not the latest data.
+    if (opCtx->getTxnNumber()) {
+        return BSONObj();
+    }
+
+    // Writes invalidate the cache as they happen on this node, so only results read from the
+    // latest data are kept current.
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    const auto level = readConcernArgs.getLevel();
+    if ((level != repl::ReadConcernLevel::kLocalReadConcern &&
+         level != repl::ReadConcernLevel::kAvailableReadConcern) ||
+        readConcernArgs.getArgsOpTime() || readConcernArgs.getArgsAfterClusterTime() ||
+        readConcernArgs.getArgsAtClusterTime()) {
+        return BSONObj();
+    }
+
+    // A read from a timestamp, such as a secondary's last applied optime, can miss a write whose
+    // invalidation has already been observed, and would cache stale results under the new version.
+    if (opCtx->recoveryUnit()->getTimestampReadSource() != RecoveryUnit::ReadSource::kNone) {
+        return BSONObj();
+    }
+
+    BSONObjBuilder keyBuilder;
+    uuid.appendToBuilder(&keyBuilder, "uuid");
+    keyBuilder.append("readConcernLevel", static_cast<int>(level));
+
+    // Skip the collection, which the UUID identifies, and the arguments that don't change the
+    // results.
+    BSONObjIterator it(cmdObj);
+    it.next();
+    while (it.more()) {
+        const auto elem = it.next();
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "tailable" || fieldName == "awaitData") {
+            if (elem.trueValue()) {
+                return BSONObj();
+            }
+            continue;
+        }
+        if (CommandHelpers::isGenericArgument(fieldName) || fieldName == "comment") {
+            continue;
+        }
+        keyBuilder.append(elem);
+    }
+    return keyBuilder.obj();
+}
+
+void QueryResultCache::setEnabledNamespaces(const std::vector<std::string>& namespaces) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    std::set<std::string> enabled(namespaces.begin(), namespaces.end());
+    for (auto&& ns : _enabledNamespaces) {
+        if (!enabled.count(ns)) {
+            _invalidate(NamespaceString(ns));
+        }
+    }
+    _enabledNamespaces = std::move(enabled);
+    _anyEnabled.store(!_enabledNamespaces.empty());
+    log() << "Caching query results for namespaces: "
+          << (namespaces.empty() ? std::string("(none)") : StringSplitter::join(namespaces, ","));
+}
+
+std::vector<std::string> QueryResultCache::getEnabledNamespaces() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return {_enabledNamespaces.begin(), _enabledNamespaces.end()};
+}
+
+bool QueryResultCache::isEnabled(const NamespaceString& nss) const {
+    if (!_anyEnabled.load()) {
+        return false;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _enabledNamespaces.count(nss.ns());
+}
+
+uint64_t QueryResultCache::getVersion(const NamespaceString& nss) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _versions.find(nss.ns());
+    return it == _versions.end() ? 0 : it->second;
+}
+
+std::shared_ptr<const QueryResultCache::Results> QueryResultCache::lookup(
+    const NamespaceString& nss, const BSONObj& key) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _index.find(_indexKey(nss.ns(), key));
+    if (it == _index.end()) {
+        queryResultCacheMisses.increment();
+        return nullptr;
+    }
+
+    queryResultCacheHits.increment();
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->results;
+}
+
+void QueryResultCache::insert(const NamespaceString& nss,
+                              const BSONObj& key,
+                              uint64_t version,
+                              Results results) {
+    int64_t bytes = key.objsize();
+    for (auto&& result : results) {
+        bytes += result.objsize();
+    }
+    if (bytes > queryResultCacheMaxEntrySizeBytes.load()) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_enabledNamespaces.count(nss.ns())) {
+        return;
+    }
+    auto versionIt = _versions.find(nss.ns());
+    if ((versionIt == _versions.end() ? 0 : versionIt->second) != version) {
+        return;  // Written to since the query started.
+    }
+
+    auto indexKey = _indexKey(nss.ns(), key);
+    auto existing = _index.find(indexKey);
+    if (existing != _index.end()) {
+        _erase(existing->second);
+    }
+
+    for (auto&& result : results) {
+        result = result.getOwned();
+    }
+    _entries.push_front(
+        {nss.ns(), key.getOwned(), std::make_shared<const Results>(std::move(results)), bytes});
+    _index.emplace(std::move(indexKey), _entries.begin());
+    _totalBytes += bytes;
+
+    const auto maxBytes = queryResultCacheMaxSizeBytes.load();
+    while (_totalBytes > maxBytes && !_entries.empty()) {
+        _erase(std::prev(_entries.end()));
+        queryResultCacheEvictions.increment();
+    }
+}
+
+void QueryResultCache::invalidate(OperationContext* opCtx, const NamespaceString& nss) {
+    if (!isEnabled(nss)) {
+        return;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _invalidate(nss);
+    }
+
+    // Queries that ran between now and the commit read the data from before the write.
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        opCtx->recoveryUnit()->onCommit([this, nss](boost::optional<Timestamp>) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _invalidate(nss);
+        });
+    }
+}
+
+void QueryResultCache::invalidateDatabase(OperationContext* opCtx, StringData dbName) {
+    if (!_anyEnabled.load()) {
+        return;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _invalidateDatabase(dbName);
+    }
+
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        opCtx->recoveryUnit()->onCommit(
+            [ this, dbName = dbName.toString() ](boost::optional<Timestamp>) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _invalidateDatabase(dbName);
+            });
+    }
+}
+
+void QueryResultCache::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& ns : _enabledNamespaces) {
+        ++_versions[ns];
+    }
+    _entries.clear();
+    _index.clear();
+    _totalBytes = 0;
+}
+
+void QueryResultCache::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->appendNumber("entries", static_cast<long long>(_entries.size()));
+    builder->appendNumber("bytes", static_cast<long long>(_totalBytes));
+}
+
+std::string QueryResultCache::_indexKey(StringData ns, const BSONObj& key) {
+    std::string indexKey = ns.toString();
+    indexKey.push_back('\0');
+    indexKey.append(key.objdata(), key.objsize());
+    return indexKey;
+}
+
+void QueryResultCache::_invalidate(const NamespaceString& nss) {
+    ++_versions[nss.ns()];
+    queryResultCacheInvalidations.increment();
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        auto next = std::next(it);
+        if (it->ns == nss.ns()) {
+            _erase(it);
+        }
+        it = next;
+    }
+}
+
+void QueryResultCache::_invalidateDatabase(StringData dbName) {
+    for (auto&& ns : _enabledNamespaces) {
+        const NamespaceString nss(ns);
+        if (nss.db() == dbName) {
+            _invalidate(nss);
+        }
+    }
+}
+
+void QueryResultCache::_erase(EntryList::iterator it) {
+    _totalBytes -= it->bytes;
+    _index.erase(_indexKey(it->ns, it->key));
+    _entries.erase(it);
+}
+
+}  // namespace mongo
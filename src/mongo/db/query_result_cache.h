@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Caches the complete results of find commands on the collections listed in the
+ * "queryResultCacheNamespaces" server parameter, so that a repeated query is answered without
+ * planning or executing it.
+ *
+ * A cached result is keyed by the collection's UUID and the find command itself, stripped of the
+ * arguments that don't affect which documents it returns. Any write to the collection, and any
+ * drop or rename of it, removes all of its cached results. Writes report this from the OpObserver
+ * hooks, both when they happen and when they commit. Each namespace also carries a version that
+ * every invalidation bumps, so a query that ran concurrently with a write cannot cache results it
+ * read before the write committed: the caller reads the version before it runs the query, and
+ * insert() drops the results if the version has moved since.
+ *
+ * The cache is bounded by "queryResultCacheMaxSizeBytes", evicting the least recently used
+ * results first.
+ */
+class QueryResultCache {
+    MONGO_DISALLOW_COPYING(QueryResultCache);
+
+public:
+    using Results = std::vector<BSONObj>;
+
+    QueryResultCache();
+
+    static QueryResultCache* get(ServiceContext* serviceContext);
+
+    /**
+     * Returns the key under which the results of the find command 'cmdObj' on the collection
+     * 'uuid' may be cached, or an empty object if they may not be. Only queries reading the
+     * latest data outside a transaction, and not from a storage timestamp, can share results.
+     */
+    static BSONObj makeKey(OperationContext* opCtx, const UUID& uuid, const BSONObj& cmdObj);
+
+    /**
+     * Replaces the namespaces whose query results are cached with 'namespaces', dropping any
+     * results cached for the others.
+     */
+    void setEnabledNamespaces(const std::vector<std::string>& namespaces);
+    std::vector<std::string> getEnabledNamespaces() const;
+
+    bool isEnabled(const NamespaceString& nss) const;
+
+    /**
+     * Returns the current version of 'nss', to be passed to insert() along with the results of a
+     * query that starts after this call.
+     */
+    uint64_t getVersion(const NamespaceString& nss) const;
+
+    /**
+     * Returns the cached results for 'key' on 'nss', or null if there are none.
+     */
+    std::shared_ptr<const Results> lookup(const NamespaceString& nss, const BSONObj& key);
+
+    /**
+     * Caches 'results' under 'key' on 'nss', unless 'nss' was invalidated since getVersion()
+     * returned 'version' or the results are larger than "queryResultCacheMaxEntrySizeBytes".
+     */
+    void insert(const NamespaceString& nss, const BSONObj& key, uint64_t version, Results results);
+
+    /**
+     * Drops the results cached for 'nss', now and again when the write unit of work of 'opCtx'
+     * commits.
+     */
+    void invalidate(OperationContext* opCtx, const NamespaceString& nss);
+
+    /**
+     * Drops the results cached for every collection in 'dbName', now and on commit.
+     */
+    void invalidateDatabase(OperationContext* opCtx, StringData dbName);
+
+    /**
+     * Drops everything and bumps every version.
+     */
+    void clear();
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        std::string ns;
+        BSONObj key;
+        std::shared_ptr<const Results> results;
+        int64_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+
+    static std::string _indexKey(StringData ns, const BSONObj& key);
+
+    // Drops results and bumps versions for 'nss', or for every namespace in 'dbName'.
+    void _invalidate(const NamespaceString& nss);
+    void _invalidateDatabase(StringData dbName);
+
+    void _erase(EntryList::iterator it);
+
+    // Checked without the mutex by writes, which only need it when some namespace is enabled.
+    AtomicBool _anyEnabled{false};
+
+    mutable stdx::mutex _mutex;
+
+    std::set<std::string> _enabledNamespaces;
+
+    // Per-namespace versions. A namespace missing from the map is at version 0.
+    stdx::unordered_map<std::string, uint64_t> _versions;
+
+    // Most recently used at the front.
+    EntryList _entries;
+    stdx::unordered_map<std::string, EntryList::iterator> _index;
+    int64_t _totalBytes = 0;
+};
+
+}  // namespace mongo
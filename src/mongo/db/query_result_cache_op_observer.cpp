@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query_result_cache_op_observer.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query_result_cache.h"
+
+namespace mongo {
+namespace {
+
+void invalidate(OperationContext* opCtx, const NamespaceString& nss) {
+    QueryResultCache::get(opCtx->getServiceContext())->invalidate(opCtx, nss);
+}
+
+}  // namespace
+
+void QueryResultCacheOpObserver::onCreateIndex(OperationContext* opCtx,
+                                               const NamespaceString& nss,
+                                               OptionalCollectionUUID uuid,
+                                               BSONObj indexDoc,
+                                               bool fromMigrate) {
+    // Cached queries may hint at indexes, so changes to the indexes may change their outcome.
+    invalidate(opCtx, nss);
+}
+
+void QueryResultCacheOpObserver::onInserts(OperationContext* opCtx,
+                                           const NamespaceString& nss,
+                                           OptionalCollectionUUID uuid,
+                                           std::vector<InsertStatement>::const_iterator begin,
+                                           std::vector<InsertStatement>::const_iterator end,
+                                           bool fromMigrate) {
+    invalidate(opCtx, nss);
+}
+
+void QueryResultCacheOpObserver::onUpdate(OperationContext* opCtx,
+                                          const OplogUpdateEntryArgs& args) {
+    invalidate(opCtx, args.nss);
+}
+
+void QueryResultCacheOpObserver::onDelete(OperationContext* opCtx,
+                                          const NamespaceString& nss,
+                                          OptionalCollectionUUID uuid,
+                                          StmtId stmtId,
+                                          bool fromMigrate,
+                                          const boost::optional<BSONObj>& deletedDoc) {
+    invalidate(opCtx, nss);
+}
+
+void QueryResultCacheOpObserver::onDropDatabase(OperationContext* opCtx,
+                                                const std::string& dbName) {
+    QueryResultCache::get(opCtx->getServiceContext())->invalidateDatabase(opCtx, dbName);
+}
+
+repl::OpTime QueryResultCacheOpObserver::onDropCollection(OperationContext* opCtx,
+                                                          const NamespaceString& collectionName,
+                                                          OptionalCollectionUUID uuid) {
+    invalidate(opCtx, collectionName);
+    return {};
+}
+
+void QueryResultCacheOpObserver::onDropIndex(OperationContext* opCtx,
+                                             const NamespaceString& nss,
+                                             OptionalCollectionUUID uuid,
+                                             const std::string& indexName,
+                                             const BSONObj& indexInfo) {
+    invalidate(opCtx, nss);
+}
+
+repl::OpTime QueryResultCacheOpObserver::onRenameCollection(OperationContext* opCtx,
+                                                            const NamespaceString& fromCollection,
+                                                            const NamespaceString& toCollection,
+                                                            OptionalCollectionUUID uuid,
+                                                            OptionalCollectionUUID dropTargetUUID,
+                                                            bool stayTemp) {
+    invalidate(opCtx, fromCollection);
+    invalidate(opCtx, toCollection);
+    return {};
+}
+
+void QueryResultCacheOpObserver::onEmptyCapped(OperationContext* opCtx,
+                                               const NamespaceString& collectionName,
+                                               OptionalCollectionUUID uuid) {
+    invalidate(opCtx, collectionName);
+}
+
+void QueryResultCacheOpObserver::onReplicationRollback(OperationContext* opCtx,
+                                                       const RollbackObserverInfo& rbInfo) {
+    QueryResultCache::get(opCtx->getServiceContext())->clear();
+}
+
+}  // namespace mongo
@@ -0,0 +1,201 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query_result_cache.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/recovery_unit_noop.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+const NamespaceString kOtherNss("test.other");
+
+BSONObj makeFind(const BSONObj& filter) {
+    return BSON("find" << kNss.coll() << "filter" << filter);
+}
+
+/**
+ * A recovery unit which remembers the timestamp read source it is given.
+ */
+class ReadSourceRecoveryUnit : public RecoveryUnitNoop {
+public:
+    void setTimestampReadSource(ReadSource source, boost::optional<Timestamp> provided) override {
+        _source = source;
+    }
+
+    ReadSource getTimestampReadSource() const override {
+        return _source;
+    }
+
+private:
+    ReadSource _source = ReadSource::kNone;
+};
+
+QueryResultCache::Results makeResults(int n) {
+    QueryResultCache::Results results;
+    for (int i = 0; i < n; ++i) {
+        results.push_back(BSON("_id" << i));
+    }
+    return results;
+}
+
+TEST(QueryResultCacheTest, LookupReturnsInsertedResults) {
+    QueryResultCache cache;
+    cache.setEnabledNamespaces({kNss.ns()});
+    const auto key = BSON("filter" << BSON("a" << 1));
+
+    ASSERT_FALSE(cache.lookup(kNss, key));
+    cache.insert(kNss, key, cache.getVersion(kNss), makeResults(3));
+
+    auto results = cache.lookup(kNss, key);
+    ASSERT(results);
+    ASSERT_EQ(3U, results->size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), results->back());
+    ASSERT_FALSE(cache.lookup(kNss, BSON("filter" << BSON("a" << 2))));
+    ASSERT_FALSE(cache.lookup(kOtherNss, key));
+}
+
+TEST(QueryResultCacheTest, OnlyEnabledNamespacesAreCached) {
+    QueryResultCache cache;
+    const auto key = BSON("filter" << BSONObj());
+    ASSERT_FALSE(cache.isEnabled(kNss));
+    cache.insert(kNss, key, cache.getVersion(kNss), makeResults(1));
+    ASSERT_FALSE(cache.lookup(kNss, key));
+
+    cache.setEnabledNamespaces({kNss.ns()});
+    ASSERT_TRUE(cache.isEnabled(kNss));
+    ASSERT_FALSE(cache.isEnabled(kOtherNss));
+    cache.insert(kNss, key, cache.getVersion(kNss), makeResults(1));
+    ASSERT(cache.lookup(kNss, key));
+
+    // Disabling a namespace drops its results.
+    cache.setEnabledNamespaces({kOtherNss.ns()});
+    ASSERT_FALSE(cache.lookup(kNss, key));
+}
+
+TEST(QueryResultCacheTest, ResultsReadBeforeAnInvalidationAreNotCached) {
+    QueryResultCache cache;
+    cache.setEnabledNamespaces({kNss.ns()});
+    const auto key = BSON("filter" << BSONObj());
+
+    const auto version = cache.getVersion(kNss);
+    cache.clear();
+    cache.insert(kNss, key, version, makeResults(1));
+    ASSERT_FALSE(cache.lookup(kNss, key));
+
+    cache.insert(kNss, key, cache.getVersion(kNss), makeResults(1));
+    ASSERT(cache.lookup(kNss, key));
+    cache.clear();
+    ASSERT_FALSE(cache.lookup(kNss, key));
+}
+
+TEST(QueryResultCacheTest, EvictsLeastRecentlyUsedResults) {
+    QueryResultCache cache;
+    cache.setEnabledNamespaces({kNss.ns()});
+    const auto key1 = BSON("filter" << BSON("a" << 1));
+    const auto key2 = BSON("filter" << BSON("a" << 2));
+    const auto key3 = BSON("filter" << BSON("a" << 3));
+
+    const auto results = makeResults(100);
+    long long entryBytes = key1.objsize();
+    for (auto&& result : results) {
+        entryBytes += result.objsize();
+    }
+    auto maxSize =
+        ServerParameterSet::getGlobal()->getMap().find("queryResultCacheMaxSizeBytes")->second;
+    ASSERT_OK(maxSize->setFromString(std::to_string(2 * entryBytes)));
+
+    cache.insert(kNss, key1, cache.getVersion(kNss), results);
+    cache.insert(kNss, key2, cache.getVersion(kNss), results);
+    ASSERT(cache.lookup(kNss, key1));
+    cache.insert(kNss, key3, cache.getVersion(kNss), results);
+
+    ASSERT(cache.lookup(kNss, key1));
+    ASSERT_FALSE(cache.lookup(kNss, key2));
+    ASSERT(cache.lookup(kNss, key3));
+
+    ASSERT_OK(maxSize->setFromString(std::to_string(64 * 1024 * 1024)));
+}
+
+TEST(QueryResultCacheTest, MakeKeyIgnoresArgumentsThatDontChangeResults) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto uuid = UUID::gen();
+
+    const auto key = QueryResultCache::makeKey(opCtx.get(), uuid, makeFind(BSON("a" << 1)));
+    ASSERT_FALSE(key.isEmpty());
+
+    BSONObjBuilder withGenericArgs(makeFind(BSON("a" << 1)));
+    withGenericArgs.append("maxTimeMS", 100);
+    withGenericArgs.append("comment", "hello");
+    withGenericArgs.append("$db", kNss.db());
+    ASSERT_BSONOBJ_EQ(key, QueryResultCache::makeKey(opCtx.get(), uuid, withGenericArgs.obj()));
+
+    ASSERT_BSONOBJ_NE(key, QueryResultCache::makeKey(opCtx.get(), uuid, makeFind(BSON("a" << 2))));
+    const auto otherUuid = UUID::gen();
+    ASSERT_BSONOBJ_NE(key,
+                      QueryResultCache::makeKey(opCtx.get(), otherUuid, makeFind(BSON("a" << 1))));
+
+    // Tailable cursors are never cached.
+    BSONObjBuilder tailable(makeFind(BSONObj()));
+    tailable.append("tailable", true);
+    ASSERT(QueryResultCache::makeKey(opCtx.get(), uuid, tailable.obj()).isEmpty());
+}
+
+TEST(QueryResultCacheTest, MakeKeyRejectsReadsNotOfTheLatestData) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    repl::ReadConcernArgs::get(opCtx.get()) =
+        repl::ReadConcernArgs(repl::ReadConcernLevel::kMajorityReadConcern);
+    ASSERT(QueryResultCache::makeKey(opCtx.get(), UUID::gen(), makeFind(BSONObj())).isEmpty());
+}
+
+TEST(QueryResultCacheTest, MakeKeyRejectsReadsFromATimestamp) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    opCtx->setRecoveryUnit(new ReadSourceRecoveryUnit(),
+                           WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+    const auto uuid = UUID::gen();
+    ASSERT_FALSE(QueryResultCache::makeKey(opCtx.get(), uuid, makeFind(BSONObj())).isEmpty());
+
+    // Secondaries read from their last applied optime, which can lag the writes already observed.
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kLastApplied);
+    ASSERT(QueryResultCache::makeKey(opCtx.get(), uuid, makeFind(BSONObj())).isEmpty());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/dbhelpers.h"
+#include "mongo/db/index_rebuilder.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database.h"
@@ -241,67 +242,89 @@ void checkForCappedOplog(OperationContext* opCtx, Database* db) {
 }
 
 void rebuildIndexes(OperationContext* opCtx, StorageEngine* storageEngine) {
-    std::vector<StorageEngine::CollectionIndexNamePair> indexesToRebuild =
-        fassert(40593, storageEngine->reconcileCatalogAndIdents(opCtx));
-
-    if (!indexesToRebuild.empty() && serverGlobalParams.indexBuildRetry) {
-        log() << "note: restart the server with --noIndexBuildRetry "
-              << "to skip index rebuilds";
-    }
-
-    if (!serverGlobalParams.indexBuildRetry) {
-        log() << "  not rebuilding interrupted indexes";
-        return;
-    }
-
     // Determine which indexes need to be rebuilt. rebuildIndexesOnCollection() requires that all
-    // indexes on that collection are done at once, so we use a map to group them together.
-    StringMap<IndexNameObjs> nsToIndexNameObjMap;
-    for (auto&& indexNamespace : indexesToRebuild) {
-        NamespaceString collNss(indexNamespace.first);
-        const std::string& indexName = indexNamespace.second;
-
-        DatabaseCatalogEntry* dbce = storageEngine->getDatabaseCatalogEntry(opCtx, collNss.db());
-        invariant(dbce,
-                  str::stream() << "couldn't get database catalog entry for database "
-                                << collNss.db());
-        CollectionCatalogEntry* cce = dbce->getCollectionCatalogEntry(collNss.ns());
-        invariant(cce,
-                  str::stream() << "couldn't get collection catalog entry for collection "
-                                << collNss.toString());
-
-        auto swIndexSpecs = getIndexNameObjs(
-            opCtx, dbce, cce, [&indexName](const std::string& name) { return name == indexName; });
-        if (!swIndexSpecs.isOK() || swIndexSpecs.getValue().first.empty()) {
-            fassert(40590,
-                    {ErrorCodes::InternalError,
-                     str::stream() << "failed to get index spec for index " << indexName
-                                   << " in collection "
-                                   << collNss.toString()});
+    // indexes on that collection are done at once, so we use a map to group them together, and
+    // group the collections by database so that each database can be rebuilt on its own thread.
+    StringMap<StringMap<IndexNameObjs>> dbToNsIndexNameObjMap;
+    {
+        Lock::GlobalWrite lk(opCtx);
+
+        std::vector<StorageEngine::CollectionIndexNamePair> indexesToRebuild =
+            fassert(40593, storageEngine->reconcileCatalogAndIdents(opCtx));
+
+        if (!indexesToRebuild.empty() && serverGlobalParams.indexBuildRetry) {
+            log() << "note: restart the server with --noIndexBuildRetry "
+                  << "to skip index rebuilds";
         }
 
-        auto& indexesToRebuild = swIndexSpecs.getValue();
-        invariant(indexesToRebuild.first.size() == 1 && indexesToRebuild.second.size() == 1,
-                  str::stream() << "Num Index Names: " << indexesToRebuild.first.size()
-                                << " Num Index Objects: "
-                                << indexesToRebuild.second.size());
-        auto& ino = nsToIndexNameObjMap[collNss.ns()];
-        ino.first.emplace_back(std::move(indexesToRebuild.first.back()));
-        ino.second.emplace_back(std::move(indexesToRebuild.second.back()));
-    }
+        if (!serverGlobalParams.indexBuildRetry) {
+            log() << "  not rebuilding interrupted indexes";
+            return;
+        }
 
-    for (const auto& entry : nsToIndexNameObjMap) {
-        NamespaceString collNss(entry.first);
+        for (auto&& indexNamespace : indexesToRebuild) {
+            NamespaceString collNss(indexNamespace.first);
+            const std::string& indexName = indexNamespace.second;
+
+            DatabaseCatalogEntry* dbce =
+                storageEngine->getDatabaseCatalogEntry(opCtx, collNss.db());
+            invariant(dbce,
+                      str::stream() << "couldn't get database catalog entry for database "
+                                    << collNss.db());
+            CollectionCatalogEntry* cce = dbce->getCollectionCatalogEntry(collNss.ns());
+            invariant(cce,
+                      str::stream() << "couldn't get collection catalog entry for collection "
+                                    << collNss.toString());
+
+            auto swIndexSpecs =
+                getIndexNameObjs(opCtx, dbce, cce, [&indexName](const std::string& name) {
+                    return name == indexName;
+                });
+            if (!swIndexSpecs.isOK() || swIndexSpecs.getValue().first.empty()) {
+                fassert(40590,
+                        {ErrorCodes::InternalError,
+                         str::stream() << "failed to get index spec for index " << indexName
+                                       << " in collection "
+                                       << collNss.toString()});
+            }
 
-        auto dbCatalogEntry = storageEngine->getDatabaseCatalogEntry(opCtx, collNss.db());
-        auto collCatalogEntry = dbCatalogEntry->getCollectionCatalogEntry(collNss.toString());
-        for (const auto& indexName : entry.second.first) {
-            log() << "Rebuilding index. Collection: " << collNss << " Index: " << indexName;
+            auto& indexesToRebuild = swIndexSpecs.getValue();
+            invariant(indexesToRebuild.first.size() == 1 && indexesToRebuild.second.size() == 1,
+                      str::stream() << "Num Index Names: " << indexesToRebuild.first.size()
+                                    << " Num Index Objects: "
+                                    << indexesToRebuild.second.size());
+            auto& ino = dbToNsIndexNameObjMap[collNss.db()][collNss.ns()];
+            ino.first.emplace_back(std::move(indexesToRebuild.first.back()));
+            ino.second.emplace_back(std::move(indexesToRebuild.second.back()));
         }
-        fassert(40592,
-                rebuildIndexesOnCollection(
-                    opCtx, dbCatalogEntry, collCatalogEntry, std::move(entry.second)));
     }
+
+    std::vector<std::string> dbNames;
+    for (const auto& entry : dbToNsIndexNameObjMap) {
+        dbNames.push_back(entry.first);
+    }
+
+    // No database has been opened yet, so an exclusive database lock is all a rebuild needs. The
+    // rebuilds in different databases then proceed at the same time.
+    forEachDatabaseInParallel(
+        dbNames, "StartupIndexRebuilder", [&](OperationContext* opCtx, const std::string& dbName) {
+            Lock::DBLock dbLock(opCtx, dbName, MODE_X);
+
+            auto dbCatalogEntry = storageEngine->getDatabaseCatalogEntry(opCtx, dbName);
+            for (const auto& entry : dbToNsIndexNameObjMap.find(dbName)->second) {
+                NamespaceString collNss(entry.first);
+
+                auto collCatalogEntry =
+                    dbCatalogEntry->getCollectionCatalogEntry(collNss.toString());
+                for (const auto& indexName : entry.second.first) {
+                    log() << "Rebuilding index. Collection: " << collNss
+                          << " Index: " << indexName;
+                }
+                fassert(40592,
+                        rebuildIndexesOnCollection(
+                            opCtx, dbCatalogEntry, collCatalogEntry, std::move(entry.second)));
+            }
+        });
 }
 
 }  // namespace
@@ -315,16 +338,17 @@ StatusWith<bool> repairDatabasesAndCheckVersion(OperationContext* opCtx) {
 
     auto const storageEngine = opCtx->getServiceContext()->getStorageEngine();
 
+    // Rebuilding indexes must be done before a database can be opened. The rebuilds take their
+    // own locks on other threads, so they must finish before the global lock is taken here.
+    if (!storageGlobalParams.readOnly) {
+        rebuildIndexes(opCtx, storageEngine);
+    }
+
     Lock::GlobalWrite lk(opCtx);
 
     std::vector<std::string> dbNames;
     storageEngine->listDatabases(&dbNames);
 
-    // Rebuilding indexes must be done before a database can be opened.
-    if (!storageGlobalParams.readOnly) {
-        rebuildIndexes(opCtx, storageEngine);
-    }
-
     bool repairVerifiedAllCollectionsHaveUUIDs = false;
 
     // Repair all databases first, so that we do not try to open them if they are in bad shape
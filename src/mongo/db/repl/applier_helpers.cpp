@@ -53,6 +53,13 @@ const auto kInsertGroupMaxBatchSize = insertVectorMaxBytes;
 // Limit number of ops in a single group.
 constexpr auto kInsertGroupMaxBatchCount = 64;
 
+// Limit the number of ops, and so the size of the storage transaction, in an update/delete group.
+constexpr auto kUpdateDeleteGroupMaxBatchCount = 64;
+
+bool isUpdateOrDelete(const OplogEntry& entry) {
+    return entry.getOpType() == OpTypeEnum::kUpdate || entry.getOpType() == OpTypeEnum::kDelete;
+}
+
 }  // namespace
 
 // static
@@ -211,5 +218,63 @@ StatusWith<InsertGroup::ConstIterator> InsertGroup::groupAndApplyInserts(ConstIt
     MONGO_UNREACHABLE;
 }
 
+using UpdateDeleteGroup = ApplierHelpers::UpdateDeleteGroup;
+
+UpdateDeleteGroup::UpdateDeleteGroup(ApplierHelpers::OperationPtrs* ops,
+                                     OperationContext* opCtx,
+                                     UpdateDeleteGroup::Mode mode)
+    : _doNotGroupBeforePoint(ops->cbegin()), _end(ops->cend()), _opCtx(opCtx), _mode(mode) {}
+
+StatusWith<UpdateDeleteGroup::ConstIterator> UpdateDeleteGroup::groupAndApplyUpdatesAndDeletes(
+    ConstIterator it) {
+    const auto& entry = **it;
+
+    if (!isUpdateOrDelete(entry)) {
+        return Status(ErrorCodes::TypeMismatch, "Can only group update and delete operations.");
+    }
+    if (it <= _doNotGroupBeforePoint) {
+        return Status(ErrorCodes::InvalidPath,
+                      "Cannot group an operation that we previously attempted to group.");
+    }
+
+    // The group ends at the first op which is not an update or delete on the same collection.
+    auto batchCount = OperationPtrs::size_type(1);
+    auto endOfGroupableOpsIterator =
+        std::find_if(it + 1, _end, [&](const OplogEntry* nextEntry) -> bool {
+            batchCount += 1;
+            return !isUpdateOrDelete(*nextEntry) ||
+                nextEntry->getNamespace() != entry.getNamespace() ||
+                nextEntry->getUuid() != entry.getUuid() ||
+                batchCount > kUpdateDeleteGroupMaxBatchCount;
+        });
+
+    if (std::distance(it, endOfGroupableOpsIterator) == 1) {
+        return Status(ErrorCodes::NoSuchKey,
+                      "Not able to create a group with more than a single update or delete");
+    }
+
+    const OperationPtrs group(it, endOfGroupableOpsIterator);
+    Status status = Status::OK();
+    try {
+        status = SyncTail::syncApplyUpdatesAndDeletes(_opCtx, group, _mode);
+    } catch (...) {
+        status = mongo::exceptionToStatus();
+    }
+
+    if (status.isOK()) {
+        return endOfGroupableOpsIterator - 1;
+    }
+
+    // Errors such as updates of missing documents during initial sync are expected here and are
+    // handled, or reported, when the ops are applied individually.
+    LOG(1) << "Error applying " << group.size() << " updates and deletes as a group "
+           << causedBy(redact(status)) << ". Trying first operation alone: " << redact(entry.raw);
+
+    // Avoid quadratic run time by not regrouping until we are beyond this group of ops.
+    _doNotGroupBeforePoint = endOfGroupableOpsIterator - 1;
+
+    return status.withContext("Error applying updates and deletes as a group");
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -51,6 +51,7 @@ public:
     static void stableSortByNamespace(OperationPtrs* oplogEntryPointers);
 
     class InsertGroup;
+    class UpdateDeleteGroup;
 };
 
 /**
@@ -88,5 +89,39 @@ private:
     Mode _mode;
 };
 
+/**
+ * Groups consecutive update and delete operations on the same collection and applies them under a
+ * single WriteUnitOfWork, sharing the collection lookup and locking between them.
+ * Advances the the MultiApplier::OperationPtrs iterator if the group is applied successfully.
+ */
+class ApplierHelpers::UpdateDeleteGroup {
+    MONGO_DISALLOW_COPYING(UpdateDeleteGroup);
+
+public:
+    using ConstIterator = OperationPtrs::const_iterator;
+    using Mode = OplogApplication::Mode;
+
+    UpdateDeleteGroup(OperationPtrs* ops, OperationContext* opCtx, Mode mode);
+
+    /**
+     * Attempts to group update and delete operations starting at 'iter'.
+     * If the group is applied successfully, returns the iterator to the last operation included in
+     * it. Otherwise none of the group's writes are kept and the operations must be applied one at
+     * a time.
+     */
+    StatusWith<ConstIterator> groupAndApplyUpdatesAndDeletes(ConstIterator iter);
+
+private:
+    // Marks the final op of a failed group, so the ops in it are not grouped again.
+    ConstIterator _doNotGroupBeforePoint;
+
+    // Used for constructing search bounds when grouping operations.
+    ConstIterator _end;
+
+    // Passed to SyncTail::syncApplyUpdatesAndDeletes when applying a group.
+    OperationContext* _opCtx;
+    Mode _mode;
+};
+
 }  // namespace repl
 }  // namespace mongo
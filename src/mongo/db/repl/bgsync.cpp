@@ -54,6 +54,7 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
 #include "mongo/stdx/memory.h"
@@ -156,6 +157,11 @@ static ServerStatusMetricField<Counter64> displayBufferSize("repl.buffer.sizeByt
 static Counter64 bufferMaxSizeGauge;
 static ServerStatusMetricField<Counter64> displayBufferMaxSize("repl.buffer.maxSizeBytes",
                                                                &bufferMaxSizeGauge);
+// Number and time of the waits for space in the buffer before adding fetched documents to it.
+// Time spent here means application is not keeping up with fetching.
+static TimerStats bufferSpaceWaitStats;
+static ServerStatusMetricField<TimerStats> displayBufferSpaceWaits("repl.buffer.spaceWaits",
+                                                                   &bufferSpaceWaitStats);
 
 
 BackgroundSync::BackgroundSync(
@@ -533,7 +539,10 @@ Status BackgroundSync::_enqueueDocuments(Fetcher::Documents::const_iterator begi
     auto opCtx = cc().makeOperationContext();
 
     // Wait for enough space.
-    _oplogBuffer->waitForSpace(opCtx.get(), info.toApplyDocumentBytes);
+    {
+        TimerHolder timer(&bufferSpaceWaitStats);
+        _oplogBuffer->waitForSpace(opCtx.get(), info.toApplyDocumentBytes);
+    }
 
     {
         // Don't add more to the buffer if we are in shutdown. Continue holding the lock until we
@@ -42,6 +42,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/collection_bulk_loader_impl.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/log.h"
@@ -144,33 +145,42 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
     return _runTaskReleaseResourcesOnFailure([&]() -> Status {
         UnreplicatedWritesBlock uwb(_opCtx.get());
 
-        for (auto iter = begin; iter != end; ++iter) {
-            std::vector<MultiIndexBlock*> indexers;
-            if (_idIndexBlock) {
-                indexers.push_back(_idIndexBlock.get());
-            }
-            if (_secondaryIndexesBlock) {
-                indexers.push_back(_secondaryIndexesBlock.get());
-            }
+        std::vector<MultiIndexBlock*> indexers;
+        if (_idIndexBlock) {
+            indexers.push_back(_idIndexBlock.get());
+        }
+        if (_secondaryIndexesBlock) {
+            indexers.push_back(_secondaryIndexesBlock.get());
+        }
+
+        // Insert the documents in batches, each in its own WriteUnitOfWork, so that the storage
+        // engine's per-transaction and per-insert bookkeeping is paid once per batch.
+        const size_t maxBatchSize = std::max(1, internalInsertMaxBatchSize.load());
+        auto batchBegin = begin;
+        while (batchBegin != end) {
+            const auto batchEnd =
+                batchBegin + std::min<size_t>(maxBatchSize, std::distance(batchBegin, end));
 
             Status status = writeConflictRetry(
                 _opCtx.get(), "CollectionBulkLoaderImpl::insertDocuments", _nss.ns(), [&] {
                     WriteUnitOfWork wunit(_opCtx.get());
-                    if (!indexers.empty()) {
-                        // This flavor of insertDocument will not update any pre-existing indexes,
-                        // only the indexers passed in.
-                        const auto status = _autoColl->getCollection()->insertDocument(
-                            _opCtx.get(), *iter, indexers, false);
-                        if (!status.isOK()) {
-                            return status;
-                        }
-                    } else {
-                        // For capped collections, we use regular insertDocument, which will update
-                        // pre-existing indexes.
-                        const auto status = _autoColl->getCollection()->insertDocument(
-                            _opCtx.get(), InsertStatement(*iter), nullptr, false);
-                        if (!status.isOK()) {
-                            return status;
+                    for (auto iter = batchBegin; iter != batchEnd; ++iter) {
+                        if (!indexers.empty()) {
+                            // This flavor of insertDocument will not update any pre-existing
+                            // indexes, only the indexers passed in.
+                            const auto status = _autoColl->getCollection()->insertDocument(
+                                _opCtx.get(), *iter, indexers, false);
+                            if (!status.isOK()) {
+                                return status;
+                            }
+                        } else {
+                            // For capped collections, we use regular insertDocument, which will
+                            // update pre-existing indexes.
+                            const auto status = _autoColl->getCollection()->insertDocument(
+                                _opCtx.get(), InsertStatement(*iter), nullptr, false);
+                            if (!status.isOK()) {
+                                return status;
+                            }
                         }
                     }
 
@@ -183,7 +193,8 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
                 return status;
             }
 
-            ++count;
+            count += std::distance(batchBegin, batchEnd);
+            batchBegin = batchEnd;
         }
         return Status::OK();
     });
@@ -32,6 +32,7 @@
 
 #include "mongo/db/repl/collection_cloner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/base/string_data.h"
@@ -68,8 +69,22 @@ MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionCountAttempts, int, 3);
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListIndexesAttempts, int, 3);
 // The number of attempts for the find command, which gets the data.
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionFindAttempts, int, 3);
+
+// The number of _id values sampled for each range when choosing the range boundaries.
+const int kIdRangeSamplesPerRange = 100;
 }  // namespace
 
+// Collections with enough documents are split into at most
+// maxNumInitialSyncCollectionClonerCursors _id ranges of at least this many documents each.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncCollectionClonerMinDocsPerIdRange, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "initialSyncCollectionClonerMinDocsPerIdRange must be non-negative");
+        }
+        return Status::OK();
+    });
+
 // Failpoint which causes initial sync to hang before establishing its cursor to clone the
 // 'namespace' collection.
 MONGO_FAIL_POINT_DEFINE(initialSyncHangBeforeCollectionClone);
@@ -268,6 +283,12 @@ void CollectionCloner::_cancelRemainingWork_inlock() {
     if (_verifyCollectionDroppedScheduler) {
         _verifyCollectionDroppedScheduler->shutdown();
     }
+    if (_sampleIdsScheduler) {
+        _sampleIdsScheduler->shutdown();
+    }
+    for (auto&& idRangeCursorScheduler : _idRangeCursorSchedulers) {
+        idRangeCursorScheduler->shutdown();
+    }
     _dbWorkTaskRunner.cancel();
 }
 
@@ -477,6 +498,63 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
 
     _collLoader = std::move(collectionBulkLoader.getValue());
 
+    Client::initThreadIfNotAlready();
+    auto opCtx = cc().getOperationContext();
+
+    MONGO_FAIL_POINT_BLOCK(initialSyncHangBeforeCollectionClone, options) {
+        const BSONObj& data = options.getData();
+        if (data["namespace"].String() == _destNss.ns()) {
+            log() << "initial sync - initialSyncHangBeforeCollectionClone fail point "
+                     "enabled. Blocking until fail point is disabled.";
+            while (MONGO_FAIL_POINT(initialSyncHangBeforeCollectionClone) && !_isShuttingDown()) {
+                mongo::sleepsecs(1);
+            }
+        }
+    }
+
+    Status scheduleStatus = Status::OK();
+    const auto numIdRanges = _numIdRangesToClone();
+    if (numIdRanges > 1) {
+        // Sample the _id values of the remote collection, sorted in _id index order, to choose
+        // the boundaries of the ranges.
+        const int sampleSize = numIdRanges * kIdRangeSamplesPerRange;
+        BSONObjBuilder cmdObj;
+        cmdObj.append("aggregate", _sourceNss.coll());
+        cmdObj.append("pipeline",
+                      BSON_ARRAY(BSON("$sample" << BSON("size" << sampleSize))
+                                 << BSON("$project" << BSON("_id" << 1))
+                                 << BSON("$sort" << BSON("_id" << 1))));
+        cmdObj.append("cursor", BSON("batchSize" << sampleSize + 1));
+
+        _sampleIdsScheduler = stdx::make_unique<RemoteCommandRetryScheduler>(
+            _executor,
+            RemoteCommandRequest(_source,
+                                 _sourceNss.db().toString(),
+                                 cmdObj.obj(),
+                                 ReadPreferenceSetting::secondaryPreferredMetadata(),
+                                 opCtx,
+                                 RemoteCommandRequest::kNoTimeout),
+            [=](const RemoteCommandCallbackArgs& rcbd) { _sampleIdsCallback(rcbd, numIdRanges); },
+            RemoteCommandRetryScheduler::makeRetryPolicy(
+                numInitialSyncCollectionFindAttempts.load(),
+                executor::RemoteCommandRequest::kNoTimeout,
+                RemoteCommandRetryScheduler::kAllRetriableErrors));
+        scheduleStatus = _sampleIdsScheduler->startup();
+        LOG(1) << "Sampling " << sampleSize << " _id values to split " << _sourceNss.ns()
+               << " into " << numIdRanges << " ranges";
+    } else {
+        scheduleStatus = _scheduleEstablishCollectionCursors(opCtx);
+    }
+
+    if (!scheduleStatus.isOK()) {
+        _sampleIdsScheduler.reset();
+        _establishCollectionCursorsScheduler.reset();
+        _finishCallback(scheduleStatus);
+        return;
+    }
+}
+
+Status CollectionCloner::_scheduleEstablishCollectionCursors(OperationContext* opCtx) {
     BSONObjBuilder cmdObj;
     EstablishCursorsCommand cursorCommand;
     // The 'find' command is used when the number of cloning cursors is 1 to ensure
@@ -497,20 +575,6 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
         cursorCommand = ParallelCollScan;
     }
 
-    Client::initThreadIfNotAlready();
-    auto opCtx = cc().getOperationContext();
-
-    MONGO_FAIL_POINT_BLOCK(initialSyncHangBeforeCollectionClone, options) {
-        const BSONObj& data = options.getData();
-        if (data["namespace"].String() == _destNss.ns()) {
-            log() << "initial sync - initialSyncHangBeforeCollectionClone fail point "
-                     "enabled. Blocking until fail point is disabled.";
-            while (MONGO_FAIL_POINT(initialSyncHangBeforeCollectionClone) && !_isShuttingDown()) {
-                mongo::sleepsecs(1);
-            }
-        }
-    }
-
     _establishCollectionCursorsScheduler = stdx::make_unique<RemoteCommandRetryScheduler>(
         _executor,
         RemoteCommandRequest(_source,
@@ -528,12 +592,203 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
             RemoteCommandRetryScheduler::kAllRetriableErrors));
     auto scheduleStatus = _establishCollectionCursorsScheduler->startup();
     LOG(1) << "Attempting to establish cursors with maxNumClonerCursors: " << _maxNumClonerCursors;
+    return scheduleStatus;
+}
 
-    if (!scheduleStatus.isOK()) {
-        _establishCollectionCursorsScheduler.reset();
-        _finishCallback(scheduleStatus);
+size_t CollectionCloner::_numIdRangesToClone() const {
+    const long long minDocsPerRange = initialSyncCollectionClonerMinDocsPerIdRange.load();
+    if (minDocsPerRange <= 0 || _maxNumClonerCursors <= 1) {
+        return 0;
+    }
+
+    // Ranges are read through the _id index in the simple collation order the sample is sorted
+    // in, and capped collections must keep insertion order.
+    if (_idIndexSpec.isEmpty() || _options.capped || !_options.collation.isEmpty()) {
+        return 0;
+    }
+
+    LockGuard lk(_mutex);
+    const auto numRanges = std::min<long long>(_maxNumClonerCursors,
+                                               static_cast<long long>(_stats.documentToCopy) /
+                                                   minDocsPerRange);
+    return numRanges > 1 ? numRanges : 0;
+}
+
+void CollectionCloner::_sampleIdsCallback(const RemoteCommandCallbackArgs& rcbd,
+                                          size_t numRanges) {
+    if (_isShuttingDown()) {
+        _finishCallback({ErrorCodes::CallbackCanceled, "Cloner shutting down."});
         return;
     }
+
+    // Any problem with the sample only costs the parallelism, so clone through the regular
+    // cursors instead of failing.
+    auto fallBack = [this](const Status& reason) {
+        log() << "Not splitting " << _sourceNss.ns() << " into _id ranges for cloning: "
+              << redact(reason);
+        auto scheduleStatus = _scheduleEstablishCollectionCursors(nullptr);
+        if (!scheduleStatus.isOK()) {
+            _finishCallback(scheduleStatus);
+        }
+    };
+
+    if (!rcbd.response.isOK()) {
+        fallBack(rcbd.response.status);
+        return;
+    }
+    auto commandStatus = getStatusFromCommandResult(rcbd.response.data);
+    if (!commandStatus.isOK()) {
+        fallBack(commandStatus);
+        return;
+    }
+    auto sampleResponse = CursorResponse::parseFromBSON(rcbd.response.data);
+    if (!sampleResponse.isOK()) {
+        fallBack(sampleResponse.getStatus());
+        return;
+    }
+    const auto& sampledIds = sampleResponse.getValue().getBatch();
+    if (sampleResponse.getValue().getCursorId() != 0 || sampledIds.size() < numRanges) {
+        fallBack({ErrorCodes::NoSuchKey, "too few _id values sampled"});
+        return;
+    }
+
+    // Range i covers [splitKeys[i - 1], splitKeys[i]), with the first and last ranges open ended.
+    std::vector<BSONObj> splitKeys;
+    for (size_t i = 1; i < numRanges; ++i) {
+        const auto splitKey = sampledIds[i * sampledIds.size() / numRanges]["_id"].wrap();
+        if (splitKeys.empty() || splitKeys.back().woCompare(splitKey) < 0) {
+            splitKeys.push_back(splitKey.getOwned());
+        }
+    }
+    if (splitKeys.empty()) {
+        fallBack({ErrorCodes::NoSuchKey, "sampled _id values are all equal"});
+        return;
+    }
+
+    const auto idIndexKey = _idIndexSpec["key"].Obj().getOwned();
+
+    UniqueLock lk(_mutex);
+    _idRangeCursors.resize(splitKeys.size() + 1);
+    _idRangeCursorsPending = _idRangeCursors.size();
+    for (size_t rangeIndex = 0; rangeIndex < _idRangeCursors.size(); ++rangeIndex) {
+        BSONObjBuilder cmdObj;
+        cmdObj.appendElements(
+            makeCommandWithUUIDorCollectionName("find", _options.uuid, _sourceNss));
+        cmdObj.append("noCursorTimeout", true);
+        cmdObj.append("batchSize", 0);
+        cmdObj.append("hint", idIndexKey);
+        if (rangeIndex > 0) {
+            cmdObj.append("min", splitKeys[rangeIndex - 1]);
+        }
+        if (rangeIndex < splitKeys.size()) {
+            cmdObj.append("max", splitKeys[rangeIndex]);
+        }
+
+        _idRangeCursorSchedulers.push_back(stdx::make_unique<RemoteCommandRetryScheduler>(
+            _executor,
+            RemoteCommandRequest(_source,
+                                 _sourceNss.db().toString(),
+                                 cmdObj.obj(),
+                                 ReadPreferenceSetting::secondaryPreferredMetadata(),
+                                 nullptr,
+                                 RemoteCommandRequest::kNoTimeout),
+            [=](const RemoteCommandCallbackArgs& rangeRcbd) {
+                _establishIdRangeCursorCallback(rangeRcbd, rangeIndex);
+            },
+            RemoteCommandRetryScheduler::makeRetryPolicy(
+                numInitialSyncCollectionFindAttempts.load(),
+                executor::RemoteCommandRequest::kNoTimeout,
+                RemoteCommandRetryScheduler::kAllRetriableErrors)));
+
+        auto scheduleStatus = _idRangeCursorSchedulers.back()->startup();
+        if (!scheduleStatus.isOK()) {
+            // Ranges which were scheduled still report back, and the last one to do so reports
+            // this error.
+            _idRangeCursorsStatus = scheduleStatus;
+            _idRangeCursorsPending -= _idRangeCursors.size() - rangeIndex;
+            if (_idRangeCursorsPending == 0) {
+                lk.unlock();
+                _finishCallback(scheduleStatus);
+            }
+            return;
+        }
+    }
+
+    LOG(1) << "Cloning " << _sourceNss.ns() << " over " << _idRangeCursors.size()
+           << " _id ranges";
+}
+
+void CollectionCloner::_establishIdRangeCursorCallback(const RemoteCommandCallbackArgs& rcbd,
+                                                       size_t rangeIndex) {
+    Status status = rcbd.response.status;
+    if (status.isOK()) {
+        status = getStatusFromCommandResult(rcbd.response.data);
+    }
+    boost::optional<CursorResponse> cursor;
+    if (status.isOK()) {
+        auto cursorResponse = CursorResponse::parseFromBSON(rcbd.response.data);
+        if (cursorResponse.isOK()) {
+            cursor = std::move(cursorResponse.getValue());
+        } else {
+            status = cursorResponse.getStatus();
+        }
+    }
+
+    std::vector<CursorResponse> cursors;
+    {
+        LockGuard lk(_mutex);
+        if (cursor) {
+            _idRangeCursors[rangeIndex] = std::move(cursor);
+        } else if (_idRangeCursorsStatus.isOK()) {
+            _idRangeCursorsStatus = status;
+        }
+        if (_state == State::kShuttingDown && _idRangeCursorsStatus.isOK()) {
+            _idRangeCursorsStatus = {ErrorCodes::CallbackCanceled, "Cloner shutting down."};
+        }
+
+        invariant(_idRangeCursorsPending > 0);
+        if (--_idRangeCursorsPending > 0) {
+            return;
+        }
+
+        for (auto&& rangeCursor : _idRangeCursors) {
+            if (rangeCursor) {
+                cursors.push_back(std::move(*rangeCursor));
+            }
+        }
+        _idRangeCursors.clear();
+        status = _idRangeCursorsStatus;
+    }
+
+    if (status.isOK()) {
+        _startCloningFromCursors(std::move(cursors));
+        return;
+    }
+
+    // Release the cursors which were opened, since they do not time out on their own.
+    for (const auto& openCursor : cursors) {
+        if (openCursor.getCursorId() == 0) {
+            continue;
+        }
+        RemoteCommandRequest killCursorsRequest(
+            _source,
+            _sourceNss.db().toString(),
+            BSON("killCursors" << _sourceNss.coll() << "cursors"
+                               << BSON_ARRAY(openCursor.getCursorId())),
+            nullptr);
+        _executor
+            ->scheduleRemoteCommand(killCursorsRequest, [](const RemoteCommandCallbackArgs&) {})
+            .getStatus()
+            .ignore();
+    }
+
+    if (status == ErrorCodes::NamespaceNotFound) {
+        _finishCallback(Status::OK());
+        return;
+    }
+    _finishCallback(status.withContext(str::stream() << "Error querying collection '"
+                                                     << _sourceNss.ns()
+                                                     << "'"));
 }
 
 Status CollectionCloner::_parseCursorResponse(BSONObj response,
@@ -617,6 +872,10 @@ void CollectionCloner::_establishCollectionCursorsCallback(const RemoteCommandCa
         _finishCallback(parseResponseStatus);
         return;
     }
+    _startCloningFromCursors(std::move(cursorResponses));
+}
+
+void CollectionCloner::_startCloningFromCursors(std::vector<CursorResponse> cursorResponses) {
     LOG(1) << "Collection cloner running with " << cursorResponses.size()
            << " cursors established.";
 
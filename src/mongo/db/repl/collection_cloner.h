@@ -46,6 +46,7 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/task_runner.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/query/async_results_merger.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
@@ -59,6 +60,10 @@ namespace repl {
 
 class StorageInterface;
 
+// The minimum number of documents in each _id range when a collection is split into ranges which
+// are cloned over separate cursors. 0 by default, meaning collections are not split.
+extern AtomicInt32 initialSyncCollectionClonerMinDocsPerIdRange;
+
 class CollectionCloner : public BaseCloner {
     MONGO_DISALLOW_COPYING(CollectionCloner);
 
@@ -196,6 +201,12 @@ private:
      */
     enum EstablishCursorsCommand { Find, ParallelCollScan };
 
+    /**
+     * Schedules the 'find' or 'parallelCollectionScan' command which establishes the cursor or
+     * cursors over the whole remote collection.
+     */
+    Status _scheduleEstablishCollectionCursors(OperationContext* opCtx);
+
     /**
      * Parses the cursor responses from the 'find' or 'parallelCollectionScan' command
      * and passes them into the 'AsyncResultsMerger'.
@@ -203,6 +214,32 @@ private:
     void _establishCollectionCursorsCallback(const RemoteCommandCallbackArgs& rcbd,
                                              EstablishCursorsCommand cursorCommand);
 
+    /**
+     * Returns the number of _id ranges to split the collection into, one cursor each, or 0 if the
+     * collection should be cloned through the 'find' or 'parallelCollectionScan' cursors instead.
+     */
+    size_t _numIdRangesToClone() const;
+
+    /**
+     * Reads the sorted sample of _id values taken from the remote collection, picks the range
+     * boundaries from it and schedules a 'find' for every range. Falls back on the regular cursors
+     * if the sample cannot be used.
+     */
+    void _sampleIdsCallback(const RemoteCommandCallbackArgs& rcbd, size_t numRanges);
+
+    /**
+     * Records the cursor established on the _id range 'rangeIndex'. Once every range has
+     * responded, starts cloning from all of the cursors, or kills the established ones and fails
+     * if any range could not be opened.
+     */
+    void _establishIdRangeCursorCallback(const RemoteCommandCallbackArgs& rcbd, size_t rangeIndex);
+
+    /**
+     * Passes the established cursors to a new 'AsyncResultsMerger' and schedules the handling of
+     * its first results.
+     */
+    void _startCloningFromCursors(std::vector<CursorResponse> cursorResponses);
+
     /**
      * Parses the response from a 'parallelCollectionScan' command into a vector of cursor
      * elements.
@@ -311,6 +348,19 @@ private:
     // (M) Scheduler used to determine if a cursor was closed because the collection was dropped.
     std::unique_ptr<RemoteCommandRetryScheduler> _verifyCollectionDroppedScheduler;
 
+    // (M) Scheduler used to sample the _id values which bound the ranges, when the collection is
+    // split.
+    std::unique_ptr<RemoteCommandRetryScheduler> _sampleIdsScheduler;
+
+    // (M) Schedulers used to establish one cursor per _id range, when the collection is split.
+    std::vector<std::unique_ptr<RemoteCommandRetryScheduler>> _idRangeCursorSchedulers;
+
+    // (M) The cursor established on each _id range so far, the number of ranges which have not
+    // responded yet and the first error returned by any of them.
+    std::vector<boost::optional<CursorResponse>> _idRangeCursors;
+    size_t _idRangeCursorsPending = 0;
+    Status _idRangeCursorsStatus = Status::OK();
+
     // State transitions:
     // PreStart --> Running --> ShuttingDown --> Complete
     // It is possible to skip intermediate states. For example,
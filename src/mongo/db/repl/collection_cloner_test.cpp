@@ -41,6 +41,7 @@
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -1913,6 +1914,74 @@ TEST_F(ParallelCollectionClonerTest, InsertDocumentsWithMultipleCursorsOfDiffere
     ASSERT_FALSE(collectionCloner->isActive());
 }
 
+TEST_F(ParallelCollectionClonerTest, SplitsCollectionIntoIdRangesClonedOverSeparateCursors) {
+    initialSyncCollectionClonerMinDocsPerIdRange.store(1);
+    ON_BLOCK_EXIT([] { initialSyncCollectionClonerMinDocsPerIdRange.store(0); });
+
+    ASSERT_OK(collectionCloner->startup());
+    ASSERT_TRUE(collectionCloner->isActive());
+
+    auto generatedDocs = generateDocs(6);
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(6));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->waitForDbWorker();
+    ASSERT_TRUE(collectionCloner->isActive());
+
+    // The range boundaries come from a sample of the _id values.
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+        auto noi = net->getNextReadyRequest();
+        ASSERT_EQUALS("aggregate", noi->getRequest().cmdObj.firstElementFieldName());
+        BSONArrayBuilder sampledIds;
+        for (const auto& doc : generatedDocs) {
+            sampledIds.append(doc);
+        }
+        scheduleNetworkResponse(noi, createCursorResponse(0, sampledIds.arr()));
+        net->runReadyNetworkOperations();
+    }
+
+    // One cursor is opened on each of the three ranges.
+    const std::vector<std::pair<BSONObj, BSONObj>> expectedRanges = {
+        {BSONObj(), generatedDocs[2]},
+        {generatedDocs[2], generatedDocs[4]},
+        {generatedDocs[4], BSONObj()}};
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+        for (size_t i = 0; i < expectedRanges.size(); ++i) {
+            auto noi = net->getNextReadyRequest();
+            const auto& cmdObj = noi->getRequest().cmdObj;
+            ASSERT_EQUALS("find", cmdObj.firstElementFieldName());
+            ASSERT_BSONOBJ_EQ(expectedRanges[i].first, cmdObj.getObjectField("min"));
+            ASSERT_BSONOBJ_EQ(expectedRanges[i].second, cmdObj.getObjectField("max"));
+            scheduleNetworkResponse(noi, createCursorResponse(i + 1, BSONArray()));
+        }
+        net->runReadyNetworkOperations();
+    }
+    collectionCloner->waitForDbWorker();
+    ASSERT_TRUE(collectionCloner->isActive());
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+        processNetworkResponse(
+            createFinalCursorResponse(BSON_ARRAY(generatedDocs[0] << generatedDocs[1])));
+        processNetworkResponse(
+            createFinalCursorResponse(BSON_ARRAY(generatedDocs[2] << generatedDocs[3])));
+        processNetworkResponse(
+            createFinalCursorResponse(BSON_ARRAY(generatedDocs[4] << generatedDocs[5])));
+    }
+
+    collectionCloner->join();
+    ASSERT_EQUALS(6, collectionStats.insertCount);
+    ASSERT_TRUE(collectionStats.commitCalled);
+
+    ASSERT_OK(getStatus());
+    ASSERT_FALSE(collectionCloner->isActive());
+}
+
 TEST_F(ParallelCollectionClonerTest, LastBatchContainsNoDocumentsWithMultipleCursors) {
     ASSERT_OK(collectionCloner->startup());
     ASSERT_TRUE(collectionCloner->isActive());
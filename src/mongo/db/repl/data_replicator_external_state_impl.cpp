@@ -37,11 +37,13 @@
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 #include "mongo/db/repl/oplog_buffer_collection.h"
 #include "mongo/db/repl/oplog_buffer_proxy.h"
+#include "mongo/db/repl/oplog_buffer_segment_file.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_external_state.h"
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -50,6 +52,7 @@ namespace {
 
 const char kCollectionOplogBufferName[] = "collection";
 const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kSegmentFileOplogBufferName[] = "segmentFile";
 
 // Set this to specify whether to use a collection to buffer the oplog on the destination server
 // during initial sync to prevent rolling over the oplog.
@@ -60,9 +63,13 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBuffer,
 // Set this to specify size of read ahead buffer in the OplogBufferCollection.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBufferPeekCacheSize, int, 10000);
 
+// Set this to specify the size in bytes at which the OplogBufferSegmentFile starts a new segment.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBufferSegmentSize, int, 64 * 1024 * 1024);
+
 MONGO_INITIALIZER(initialSyncOplogBuffer)(InitializerContext*) {
     if ((initialSyncOplogBuffer != kCollectionOplogBufferName) &&
-        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName)) {
+        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (initialSyncOplogBuffer != kSegmentFileOplogBufferName)) {
         return Status(ErrorCodes::BadValue,
                       "unsupported initial sync oplog buffer option: " + initialSyncOplogBuffer);
     }
@@ -141,6 +148,12 @@ std::unique_ptr<OplogBuffer> DataReplicatorExternalStateImpl::makeInitialSyncOpl
         options.peekCacheSize = std::size_t(initialSyncOplogBufferPeekCacheSize);
         return stdx::make_unique<OplogBufferProxy>(
             stdx::make_unique<OplogBufferCollection>(StorageInterface::get(opCtx), options));
+    } else if (initialSyncOplogBuffer == kSegmentFileOplogBufferName) {
+        invariant(initialSyncOplogBufferSegmentSize > 0);
+        OplogBufferSegmentFile::Options options;
+        options.directory = storageGlobalParams.dbpath + "/_tmp/initialSyncOplogBuffer";
+        options.maxSegmentSize = std::size_t(initialSyncOplogBufferSegmentSize);
+        return stdx::make_unique<OplogBufferSegmentFile>(options);
     } else {
         return stdx::make_unique<OplogBufferBlockingQueue>();
     }
@@ -112,6 +112,10 @@ namespace {
 
 MONGO_FAIL_POINT_DEFINE(sleepBetweenInsertOpTimeGenerationAndLogOp);
 
+// When true, secondaries build every replicated index in the background, including those the
+// primary built in the foreground, so that oplog application continues while the index is built.
+MONGO_EXPORT_SERVER_PARAMETER(buildIndexesInBackgroundOnSecondaries, bool, false);
+
 /**
  * This structure contains per-service-context state related to the oplog.
  */
@@ -243,7 +247,16 @@ void createIndexForApplyOps(OperationContext* opCtx,
 
     bool relaxIndexConstraints =
         ReplicationCoordinator::get(opCtx)->shouldRelaxIndexConstraints(opCtx, indexNss);
-    if (indexSpec["background"].trueValue()) {
+    BSONObj builderSpec = indexSpec;
+    if (!indexSpec["background"].trueValue() && mode == OplogApplication::Mode::kSecondary &&
+        buildIndexesInBackgroundOnSecondaries.load()) {
+        LOG(3) << "apply op: building foreground index " << indexSpec
+               << " in the background on a secondary";
+        builderSpec = BSONObjBuilder(indexSpec.removeField("background"))
+                          .append("background", true)
+                          .obj();
+    }
+    if (builderSpec["background"].trueValue()) {
         if (mode == OplogApplication::Mode::kRecovering) {
             LOG(3) << "apply op: building background index " << indexSpec
                    << " in the foreground because the node is in recovery";
@@ -260,8 +273,10 @@ void createIndexForApplyOps(OperationContext* opCtx,
                 Status status = builder.buildInForeground(opCtx, db);
                 uassertStatusOK(status);
             } else {
-                IndexBuilder* builder = new IndexBuilder(
-                    indexSpec, relaxIndexConstraints, opCtx->recoveryUnit()->getCommitTimestamp());
+                IndexBuilder* builder =
+                    new IndexBuilder(builderSpec,
+                                     relaxIndexConstraints,
+                                     opCtx->recoveryUnit()->getCommitTimestamp());
                 // This spawns a new thread and returns immediately.
                 builder->go();
                 // Wait for thread to start and register itself
@@ -318,11 +333,15 @@ void appendSessionInfo(OperationContext* opCtx,
     }
 }
 
-OplogDocWriter _logOpWriter(OperationContext* opCtx,
+/**
+ * Appends every field of the oplog entry except for 'o' to 'b'. The 'o' field is added by the
+ * OplogDocWriter when the entry is written, so the document is copied only once.
+ */
+void _appendOplogEntryFrame(OperationContext* opCtx,
+                            BSONObjBuilder* b,
                             const char* opstr,
                             const NamespaceString& nss,
                             OptionalCollectionUUID uuid,
-                            const BSONObj& obj,
                             const BSONObj* o2,
                             bool fromMigrate,
                             OpTime optime,
@@ -331,28 +350,55 @@ OplogDocWriter _logOpWriter(OperationContext* opCtx,
                             const OperationSessionInfo& sessionInfo,
                             StmtId statementId,
                             const OplogLink& oplogLink) {
-    BSONObjBuilder b(256);
-
-    b.append("ts", optime.getTimestamp());
+    b->append("ts", optime.getTimestamp());
     if (optime.getTerm() != -1)
-        b.append("t", optime.getTerm());
-    b.append("h", hashNew);
-    b.append("v", OplogEntry::kOplogVersion);
-    b.append("op", opstr);
-    b.append("ns", nss.ns());
+        b->append("t", optime.getTerm());
+    b->append("h", hashNew);
+    b->append("v", OplogEntry::kOplogVersion);
+    b->append("op", opstr);
+    b->append("ns", nss.ns());
     if (uuid)
-        uuid->appendToBuilder(&b, "ui");
+        uuid->appendToBuilder(b, "ui");
 
     if (fromMigrate)
-        b.appendBool("fromMigrate", true);
+        b->appendBool("fromMigrate", true);
 
     if (o2)
-        b.append("o2", *o2);
+        b->append("o2", *o2);
 
     invariant(wallTime != Date_t{});
-    b.appendDate("wall", wallTime);
+    b->appendDate("wall", wallTime);
 
-    appendSessionInfo(opCtx, &b, statementId, sessionInfo, oplogLink);
+    appendSessionInfo(opCtx, b, statementId, sessionInfo, oplogLink);
+}
+
+OplogDocWriter _logOpWriter(OperationContext* opCtx,
+                            const char* opstr,
+                            const NamespaceString& nss,
+                            OptionalCollectionUUID uuid,
+                            const BSONObj& obj,
+                            const BSONObj* o2,
+                            bool fromMigrate,
+                            OpTime optime,
+                            long long hashNew,
+                            Date_t wallTime,
+                            const OperationSessionInfo& sessionInfo,
+                            StmtId statementId,
+                            const OplogLink& oplogLink) {
+    BSONObjBuilder b(256);
+    _appendOplogEntryFrame(opCtx,
+                           &b,
+                           opstr,
+                           nss,
+                           uuid,
+                           o2,
+                           fromMigrate,
+                           optime,
+                           hashNew,
+                           wallTime,
+                           sessionInfo,
+                           statementId,
+                           oplogLink);
     return OplogDocWriter(OplogDocWriter(b.obj(), obj));
 }
 }  // end anon namespace
@@ -506,31 +552,57 @@ std::vector<OpTime> logInsertOps(OperationContext* opCtx,
         oplogLink.prevOpTime = session->getLastWriteOpTime(*opCtx->getTxnNumber());
     }
 
+    // Fetch the optimes not already fetched by the caller, all at once.
+    std::vector<OplogSlot> slots(count);
+    std::vector<size_t> unreservedSlots;
+    for (size_t i = 0; i < count; i++) {
+        slots[i] = begin[i].oplogSlot;
+        if (slots[i].opTime.isNull()) {
+            unreservedSlots.push_back(i);
+        }
+    }
+    if (!unreservedSlots.empty()) {
+        std::vector<OplogSlot> reserved(unreservedSlots.size());
+        _getNextOpTimes(opCtx, oplog, reserved.size(), reserved.data());
+        for (size_t i = 0; i < unreservedSlots.size(); i++) {
+            slots[unreservedSlots[i]] = reserved[i];
+        }
+    }
+
+    // Build every entry's frame into one buffer rather than allocating one per document. The
+    // frames are only referenced once they are all built since the buffer may move as it grows.
+    const int kFrameSizeEstimate = 128;
+    BufBuilder frames(count * kFrameSizeEstimate);
+    std::vector<int> frameOffsets;
+    frameOffsets.reserve(count);
+
     auto timestamps = stdx::make_unique<Timestamp[]>(count);
     std::vector<OpTime> opTimes;
+    opTimes.reserve(count);
     for (size_t i = 0; i < count; i++) {
-        // Make a mutable copy.
-        auto insertStatementOplogSlot = begin[i].oplogSlot;
-        // Fetch optime now, if not already fetched.
-        if (insertStatementOplogSlot.opTime.isNull()) {
-            _getNextOpTimes(opCtx, oplog, 1, &insertStatementOplogSlot);
+        frameOffsets.push_back(frames.len());
+        {
+            BSONObjBuilder frameBuilder(frames);
+            _appendOplogEntryFrame(opCtx,
+                                   &frameBuilder,
+                                   "i",
+                                   nss,
+                                   uuid,
+                                   NULL,
+                                   fromMigrate,
+                                   slots[i].opTime,
+                                   slots[i].hash,
+                                   wallClockTime,
+                                   sessionInfo,
+                                   begin[i].stmtId,
+                                   oplogLink);
         }
-        writers.emplace_back(_logOpWriter(opCtx,
-                                          "i",
-                                          nss,
-                                          uuid,
-                                          begin[i].doc,
-                                          NULL,
-                                          fromMigrate,
-                                          insertStatementOplogSlot.opTime,
-                                          insertStatementOplogSlot.hash,
-                                          wallClockTime,
-                                          sessionInfo,
-                                          begin[i].stmtId,
-                                          oplogLink));
-        oplogLink.prevOpTime = insertStatementOplogSlot.opTime;
+        oplogLink.prevOpTime = slots[i].opTime;
         timestamps[i] = oplogLink.prevOpTime.getTimestamp();
-        opTimes.push_back(insertStatementOplogSlot.opTime);
+        opTimes.push_back(slots[i].opTime);
+    }
+    for (size_t i = 0; i < count; i++) {
+        writers.emplace_back(BSONObj(frames.buf() + frameOffsets[i]), begin[i].doc);
     }
 
     MONGO_FAIL_POINT_BLOCK(sleepBetweenInsertOpTimeGenerationAndLogOp, customWait) {
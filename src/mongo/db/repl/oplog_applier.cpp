@@ -37,6 +37,7 @@
 #include "mongo/db/repl/sync_tail.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa_placement.h"
 
 namespace mongo {
 namespace repl {
@@ -86,6 +87,7 @@ std::unique_ptr<ThreadPool> OplogApplier::makeWriterPool(int threadCount) {
             Client::initThreadIfNotAlready();
             AuthorizationSession::get(cc())->grantInternalAuthorization();
         }
+        NumaPlacement::get().placeCurrentThread(NumaPlacement::ThreadKind::kWorker);
     };
     auto pool = stdx::make_unique<ThreadPool>(options);
     pool->startup();
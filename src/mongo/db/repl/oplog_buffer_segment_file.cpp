@@ -0,0 +1,292 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_segment_file.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <cstring>
+
+#include "mongo/base/data_view.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+const char kSegmentFileNamePrefix[] = "segment.";
+
+}  // namespace
+
+OplogBufferSegmentFile::OplogBufferSegmentFile(Options options) : _options(std::move(options)) {
+    invariant(!_options.directory.empty());
+    invariant(_options.maxSegmentSize > 0);
+}
+
+void OplogBufferSegmentFile::startup(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    // Segments left behind by a previous initial sync attempt are not resumed.
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(_options.directory, ec);
+    if (!ec) {
+        boost::filesystem::create_directories(_options.directory, ec);
+    }
+    if (ec) {
+        fassertFailedWithStatus(50861,
+                                Status(ErrorCodes::FileOpenFailed,
+                                       str::stream() << "failed to create oplog buffer directory "
+                                                     << _options.directory
+                                                     << ": "
+                                                     << ec.message()));
+    }
+}
+
+void OplogBufferSegmentFile::shutdown(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _clear_inlock();
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(_options.directory, ec);
+    if (ec) {
+        warning() << "failed to remove oplog buffer directory " << _options.directory << ": "
+                  << ec.message();
+    }
+}
+
+void OplogBufferSegmentFile::pushEvenIfFull(OperationContext* opCtx, const Value& value) {
+    push(opCtx, value);
+}
+
+void OplogBufferSegmentFile::push(OperationContext*, const Value& value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _push_inlock(value);
+    _flush_inlock();
+}
+
+void OplogBufferSegmentFile::pushAllNonBlocking(OperationContext*,
+                                                Batch::const_iterator begin,
+                                                Batch::const_iterator end) {
+    if (begin == end) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto it = begin; it != end; ++it) {
+        _push_inlock(*it);
+    }
+    _flush_inlock();
+}
+
+void OplogBufferSegmentFile::waitForSpace(OperationContext*, std::size_t) {}
+
+bool OplogBufferSegmentFile::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count == 0;
+}
+
+std::size_t OplogBufferSegmentFile::getMaxSize() const {
+    return 0;
+}
+
+std::size_t OplogBufferSegmentFile::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _size;
+}
+
+std::size_t OplogBufferSegmentFile::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count;
+}
+
+void OplogBufferSegmentFile::clear(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _clear_inlock();
+}
+
+bool OplogBufferSegmentFile::tryPop(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_count == 0) {
+        return false;
+    }
+    if (!_nextValue) {
+        _readNext_inlock();
+    }
+    *value = std::move(*_nextValue);
+    _nextValue = boost::none;
+    _count--;
+    _size -= std::size_t(value->objsize());
+    return true;
+}
+
+bool OplogBufferSegmentFile::waitForData(Seconds waitDuration) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    return _cvNoLongerEmpty.wait_for(
+        lk, waitDuration.toSystemDuration(), [&]() { return _count != 0; });
+}
+
+bool OplogBufferSegmentFile::peek(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_count == 0) {
+        return false;
+    }
+    if (!_nextValue) {
+        _readNext_inlock();
+    }
+    *value = *_nextValue;
+    return true;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferSegmentFile::lastObjectPushed(
+    OperationContext*) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_count == 0) {
+        return boost::none;
+    }
+    return _lastPushedValue;
+}
+
+std::size_t OplogBufferSegmentFile::getSegmentCount_forTest() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _segments.size();
+}
+
+std::string OplogBufferSegmentFile::_getSegmentFileName(std::size_t id) const {
+    return str::stream() << _options.directory << "/" << kSegmentFileNamePrefix << id;
+}
+
+void OplogBufferSegmentFile::_push_inlock(const Value& value) {
+    if (_segments.empty() || _segments.back().size >= _options.maxSegmentSize) {
+        _writer.close();
+        _segments.push_back({_nextSegmentId++, 0});
+        const auto fileName = _getSegmentFileName(_segments.back().id);
+        _writer.open(fileName.c_str(), std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!_writer.is_open()) {
+            fassertFailedWithStatus(50862,
+                                    Status(ErrorCodes::FileOpenFailed,
+                                           str::stream() << "failed to open oplog buffer segment "
+                                                         << fileName
+                                                         << " for writing: "
+                                                         << errnoWithDescription()));
+        }
+    }
+
+    const auto objSize = std::size_t(value.objsize());
+    _writer.write(value.objdata(), objSize);
+    _segments.back().size += objSize;
+    _count++;
+    _size += objSize;
+    _lastPushedValue = value.getOwned();
+}
+
+void OplogBufferSegmentFile::_flush_inlock() {
+    _writer.flush();
+    if (!_writer.good()) {
+        fassertFailedWithStatus(50863,
+                                Status(ErrorCodes::FileStreamFailed,
+                                       str::stream() << "failed to write oplog buffer segment "
+                                                     << _getSegmentFileName(_segments.back().id)
+                                                     << ": "
+                                                     << errnoWithDescription()));
+    }
+    _cvNoLongerEmpty.notify_all();
+}
+
+void OplogBufferSegmentFile::_readNext_inlock() {
+    invariant(_count > 0);
+    invariant(!_nextValue);
+
+    // Every byte of the last segment was pushed, so the first segment can only have been read
+    // completely if the writer has moved on to a later one.
+    if (_readOffset == _segments.front().size) {
+        invariant(_segments.size() > 1);
+        _reader.close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(_getSegmentFileName(_segments.front().id), ec);
+        _segments.pop_front();
+        _readOffset = 0;
+    }
+
+    const auto fileName = _getSegmentFileName(_segments.front().id);
+    if (!_reader.is_open()) {
+        _reader.open(fileName.c_str(), std::ios::binary | std::ios::in);
+        if (!_reader.is_open()) {
+            fassertFailedWithStatus(50864,
+                                    Status(ErrorCodes::FileOpenFailed,
+                                           str::stream() << "failed to open oplog buffer segment "
+                                                         << fileName
+                                                         << " for reading: "
+                                                         << errnoWithDescription()));
+        }
+    }
+
+    char sizeBytes[sizeof(int32_t)];
+    _reader.read(sizeBytes, sizeof(sizeBytes));
+    const auto objSize = ConstDataView(sizeBytes).read<LittleEndian<int32_t>>();
+    if (_reader.good() && objSize >= BSONObj::kMinBSONLength) {
+        auto buffer = SharedBuffer::allocate(objSize);
+        std::memcpy(buffer.get(), sizeBytes, sizeof(sizeBytes));
+        _reader.read(buffer.get() + sizeof(sizeBytes), objSize - sizeof(sizeBytes));
+        if (_reader.good()) {
+            _readOffset += objSize;
+            _nextValue = BSONObj(std::move(buffer));
+            return;
+        }
+    }
+    fassertFailedWithStatus(50865,
+                            Status(ErrorCodes::FileStreamFailed,
+                                   str::stream() << "failed to read oplog buffer segment "
+                                                 << fileName
+                                                 << " at offset "
+                                                 << _readOffset
+                                                 << ": "
+                                                 << errnoWithDescription()));
+}
+
+void OplogBufferSegmentFile::_clear_inlock() {
+    _writer.close();
+    _reader.close();
+    for (const auto& segment : _segments) {
+        boost::system::error_code ec;
+        boost::filesystem::remove(_getSegmentFileName(segment.id), ec);
+    }
+    _segments.clear();
+    _readOffset = 0;
+    _count = 0;
+    _size = 0;
+    _nextValue = boost::none;
+    _lastPushedValue = boost::none;
+}
+
+}  // namespace repl
+}  // namespace mongo
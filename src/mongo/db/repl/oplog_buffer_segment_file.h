@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <fstream>
+#include <string>
+
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer backed by an append-only log split over segment files in a temporary directory.
+ * Entries are written to the last segment and read back sequentially from the first one, which is
+ * deleted once it has been read completely. The directory is created in startup() and removed in
+ * shutdown().
+ *
+ * Unlike OplogBufferCollection, pushing and popping does not go through the storage engine, and
+ * unlike OplogBufferBlockingQueue, the buffer is bounded by disk space rather than memory.
+ */
+class OplogBufferSegmentFile final : public OplogBuffer {
+public:
+    /**
+     * Structure used to configure an instance of OplogBufferSegmentFile.
+     */
+    struct Options {
+        // Directory holding the segment files. Anything already in it is removed at startup.
+        std::string directory;
+        // A new segment is started once the last one holds at least this many bytes.
+        std::size_t maxSegmentSize = 64 * 1024 * 1024;
+    };
+
+    explicit OplogBufferSegmentFile(Options options);
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override;
+    void push(OperationContext* opCtx, const Value& value) override;
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+    // ---- Testing API ----
+    std::size_t getSegmentCount_forTest() const;
+
+private:
+    struct Segment {
+        std::size_t id;
+        // Number of bytes written to the segment file so far.
+        std::size_t size;
+    };
+
+    std::string _getSegmentFileName(std::size_t id) const;
+
+    /**
+     * Appends 'value' to the last segment, starting a new one first if it is full. The caller
+     * flushes the writer once it is done pushing.
+     */
+    void _push_inlock(const Value& value);
+
+    /**
+     * Flushes the writer so the values pushed so far can be read back, and wakes up waiters.
+     */
+    void _flush_inlock();
+
+    /**
+     * Reads the next value from the first segment into '_nextValue', moving on to the next segment
+     * when the first one has been read completely. The buffer must not be empty.
+     */
+    void _readNext_inlock();
+
+    void _clear_inlock();
+
+    const Options _options;
+
+    // Protects member data below.
+    mutable stdx::mutex _mutex;
+
+    stdx::condition_variable _cvNoLongerEmpty;
+
+    // Segments which have not been read completely, in order. The first segment is being read
+    // and the last one is being written.
+    std::deque<Segment> _segments;
+    std::size_t _nextSegmentId = 0;
+
+    std::ofstream _writer;
+    std::ifstream _reader;
+
+    // Number of bytes of the first segment read so far.
+    std::size_t _readOffset = 0;
+
+    // Count and total size of the values which have been pushed but not popped.
+    std::size_t _count = 0;
+    std::size_t _size = 0;
+
+    // The next value to pop, once it has been read from the first segment by peek().
+    boost::optional<Value> _nextValue;
+
+    boost::optional<Value> _lastPushedValue;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,181 @@
+/**
+ *    Copyright 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_segment_file.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+BSONObj makeOplogEntry(int t) {
+    return BSON("ts" << Timestamp(t, t) << "h" << t << "ns"
+                     << "a.a"
+                     << "v"
+                     << 2
+                     << "op"
+                     << "i"
+                     << "o"
+                     << BSON("_id" << t << "a" << t));
+}
+
+class OplogBufferSegmentFileTest : public unittest::Test {
+protected:
+    OplogBufferSegmentFile::Options makeOptions(std::size_t maxSegmentSize) {
+        OplogBufferSegmentFile::Options options;
+        options.directory = _tempDir.path() + "/oplogBuffer";
+        options.maxSegmentSize = maxSegmentSize;
+        return options;
+    }
+
+private:
+    unittest::TempDir _tempDir{"oplog_buffer_segment_file_test"};
+};
+
+TEST_F(OplogBufferSegmentFileTest, StartupCreatesDirectoryAndShutdownRemovesIt) {
+    const auto options = makeOptions(1024);
+    OplogBufferSegmentFile oplogBuffer(options);
+
+    oplogBuffer.startup(nullptr);
+    ASSERT_TRUE(boost::filesystem::is_directory(options.directory));
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(0UL, oplogBuffer.getMaxSize());
+
+    oplogBuffer.push(nullptr, makeOplogEntry(1));
+    oplogBuffer.shutdown(nullptr);
+    ASSERT_FALSE(boost::filesystem::exists(options.directory));
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+}
+
+TEST_F(OplogBufferSegmentFileTest, PopReturnsValuesInPushOrderAcrossSegments) {
+    // Every value fills a segment of its own.
+    OplogBufferSegmentFile oplogBuffer(makeOptions(1));
+    oplogBuffer.startup(nullptr);
+
+    const OplogBuffer::Batch values = {makeOplogEntry(1), makeOplogEntry(2), makeOplogEntry(3)};
+    oplogBuffer.pushAllNonBlocking(nullptr, values.cbegin(), values.cend());
+    ASSERT_EQUALS(3UL, oplogBuffer.getCount());
+    ASSERT_EQUALS(std::size_t(values[0].objsize() + values[1].objsize() + values[2].objsize()),
+                  oplogBuffer.getSize());
+    ASSERT_EQUALS(3UL, oplogBuffer.getSegmentCount_forTest());
+    ASSERT_BSONOBJ_EQ(values[2], *oplogBuffer.lastObjectPushed(nullptr));
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(oplogBuffer.peek(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(values[0], value);
+    ASSERT_EQUALS(3UL, oplogBuffer.getCount());
+
+    for (const auto& expected : values) {
+        ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(expected, value);
+    }
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(0UL, oplogBuffer.getSize());
+    ASSERT_FALSE(oplogBuffer.tryPop(nullptr, &value));
+    ASSERT_FALSE(oplogBuffer.lastObjectPushed(nullptr));
+
+    // Segments which have been read completely are deleted, except for the one being written.
+    ASSERT_EQUALS(1UL, oplogBuffer.getSegmentCount_forTest());
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSegmentFileTest, PopsValuesPushedAfterReadingStarted) {
+    OplogBufferSegmentFile oplogBuffer(makeOptions(1024 * 1024));
+    oplogBuffer.startup(nullptr);
+
+    OplogBuffer::Value value;
+    for (int i = 1; i <= 3; ++i) {
+        oplogBuffer.push(nullptr, makeOplogEntry(i));
+        ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), value);
+    }
+    ASSERT_EQUALS(1UL, oplogBuffer.getSegmentCount_forTest());
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSegmentFileTest, SentinelsArePoppedAsEmptyDocuments) {
+    OplogBufferSegmentFile oplogBuffer(makeOptions(1024));
+    oplogBuffer.startup(nullptr);
+
+    oplogBuffer.push(nullptr, makeOplogEntry(1));
+    oplogBuffer.pushEvenIfFull(nullptr, BSONObj());
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(1), value);
+    ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &value));
+    ASSERT_TRUE(value.isEmpty());
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSegmentFileTest, ClearRemovesAllSegments) {
+    const auto options = makeOptions(1);
+    OplogBufferSegmentFile oplogBuffer(options);
+    oplogBuffer.startup(nullptr);
+
+    oplogBuffer.push(nullptr, makeOplogEntry(1));
+    oplogBuffer.push(nullptr, makeOplogEntry(2));
+    OplogBuffer::Value value;
+    ASSERT_TRUE(oplogBuffer.peek(nullptr, &value));
+
+    oplogBuffer.clear(nullptr);
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(0UL, oplogBuffer.getSegmentCount_forTest());
+    ASSERT_TRUE(boost::filesystem::is_empty(options.directory));
+    ASSERT_FALSE(oplogBuffer.peek(nullptr, &value));
+
+    // The buffer can be used again after being cleared.
+    oplogBuffer.push(nullptr, makeOplogEntry(3));
+    ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(3), value);
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSegmentFileTest, WaitForDataReturnsTrueOnlyWhenNotEmpty) {
+    OplogBufferSegmentFile oplogBuffer(makeOptions(1024));
+    oplogBuffer.startup(nullptr);
+
+    ASSERT_FALSE(oplogBuffer.waitForData(Seconds(0)));
+    oplogBuffer.push(nullptr, makeOplogEntry(1));
+    ASSERT_TRUE(oplogBuffer.waitForData(Seconds(0)));
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+}  // namespace
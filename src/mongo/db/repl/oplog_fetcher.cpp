@@ -478,7 +478,10 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
 
-    // TODO: back pressure handling will be added in SERVER-23499.
+    // The enqueue function provides the flow control for the fetcher: it blocks until the oplog
+    // buffer has room for the batch, and the next getMore is not sent until it returns. Each
+    // batch therefore costs one round trip to the sync source, since a getMore on a cursor cannot
+    // be issued while the previous one is outstanding.
     auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
     if (!status.isOK()) {
         return status;
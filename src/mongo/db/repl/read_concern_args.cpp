@@ -61,7 +61,7 @@ const string ReadConcernArgs::kAtClusterTimeFieldName("atClusterTime");
 const string ReadConcernArgs::kLevelFieldName("level");
 
 const OperationContext::Decoration<ReadConcernArgs> ReadConcernArgs::get =
-    OperationContext::declareDecoration<ReadConcernArgs>();
+    OperationContext::declareHotDecoration<ReadConcernArgs>();
 
 ReadConcernArgs::ReadConcernArgs() = default;
 
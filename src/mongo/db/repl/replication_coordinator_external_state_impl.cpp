@@ -70,6 +70,7 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/s/balancer/balancer.h"
 #include "mongo/db/s/chunk_splitter.h"
+#include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/config/sharding_catalog_manager.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/sharding_state_recovery.h"
@@ -679,6 +680,9 @@ void ReplicationCoordinatorExternalStateImpl::shardingOnStepDownHook() {
         invariant(serverGlobalParams.clusterRole == ClusterRole::ShardServer);
         ChunkSplitter::get(_service).onStepDown();
         CatalogCacheLoader::get(_service).onStepDown();
+
+        // A new primary may roll back writes which the per-chunk document counts include.
+        CollectionShardingState::clearAllChunkDocumentCounts(_service);
     }
 
     if (auto validator = LogicalTimeValidator::get(_service)) {
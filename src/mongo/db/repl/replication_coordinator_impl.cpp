@@ -250,51 +250,73 @@ private:
     Waiter* _waiter;
 };
 
+ReplicationCoordinatorImpl::WaiterList::WriteConcernKey
+ReplicationCoordinatorImpl::WaiterList::_getWriteConcernKey(WaiterType waiter) {
+    if (!waiter->writeConcern) {
+        return WriteConcernKey();
+    }
+    return WriteConcernKey(waiter->writeConcern->wMode,
+                           waiter->writeConcern->wNumNodes,
+                           static_cast<int>(waiter->writeConcern->syncMode));
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
-    _list.push_back(waiter);
+    _waiters[_getWriteConcernKey(waiter)].emplace(waiter->opTime, waiter);
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveIf_inlock(
     stdx::function<bool(WaiterType)> func) {
-    // Only advance iterator when the element doesn't match.
-    for (auto it = _list.begin(); it != _list.end();) {
-        if (!func(*it)) {
+    std::vector<WaiterType> ready;
+    for (auto group = _waiters.begin(); group != _waiters.end();) {
+        auto& waiters = group->second;
+        auto it = waiters.begin();
+        while (it != waiters.end() && func(it->second)) {
+            ready.push_back(it->second);
             ++it;
-            continue;
         }
+        waiters.erase(waiters.begin(), it);
 
-        WaiterType waiter = std::move(*it);
-        if (it == std::prev(_list.end())) {
-            // Iterator will be invalid after erasing the last element, so set it to the
-            // next one (i.e. end()).
-            it = _list.erase(it);
+        if (waiters.empty()) {
+            group = _waiters.erase(group);
         } else {
-            // Iterator is still valid after pop_back().
-            std::swap(*it, _list.back());
-            _list.pop_back();
+            ++group;
         }
+    }
 
-        // It's important to call notify() after the waiter has been removed from the list
-        // since notify() might remove the waiter itself.
+    // It's important to call notify() after the waiters have been removed from the list
+    // since notify() might remove the waiter itself.
+    for (auto& waiter : ready) {
         waiter->notify_inlock();
     }
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveAll_inlock() {
-    std::vector<WaiterType> list = std::move(_list);
+    auto waiters = std::move(_waiters);
+    _waiters.clear();
     // Call notify() after removing the waiters from the list.
-    for (auto& waiter : list) {
-        waiter->notify_inlock();
+    for (auto& group : waiters) {
+        for (auto& waiter : group.second) {
+            waiter.second->notify_inlock();
+        }
     }
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
-    auto it = std::find(_list.begin(), _list.end(), waiter);
-    if (it == _list.end()) {
+    auto group = _waiters.find(_getWriteConcernKey(waiter));
+    if (group == _waiters.end()) {
         return false;
     }
-    std::swap(*it, _list.back());
-    _list.pop_back();
+    auto& waiters = group->second;
+    auto range = waiters.equal_range(waiter->opTime);
+    auto it = std::find_if(
+        range.first, range.second, [waiter](const auto& entry) { return entry.second == waiter; });
+    if (it == range.second) {
+        return false;
+    }
+    waiters.erase(it);
+    if (waiters.empty()) {
+        _waiters.erase(group);
+    }
     return true;
 }
 
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -503,13 +505,23 @@ private:
         void add_inlock(WaiterType waiter);
         // Returns whether waiter is found and removed.
         bool remove_inlock(WaiterType waiter);
-        // Signals and removes all waiters that satisfy the condition.
+        // Signals and removes all waiters that satisfy the condition. The condition must also hold
+        // for every waiter with the same write concern and an earlier opTime than a waiter it
+        // holds for, so that only the satisfied waiters and the first unsatisfied one of each
+        // write concern need to be checked.
         void signalAndRemoveIf_inlock(stdx::function<bool(WaiterType)> fun);
         // Signals and removes all waiters from the list.
         void signalAndRemoveAll_inlock();
 
     private:
-        std::vector<WaiterType> _list;
+        // Identifies the waiters whose write concerns are satisfied by the same replication
+        // progress: the wMode, wNumNodes and syncMode of the write concern, if any.
+        using WriteConcernKey = std::tuple<std::string, int, int>;
+
+        static WriteConcernKey _getWriteConcernKey(WaiterType waiter);
+
+        // Waiters grouped by write concern, each group ordered by opTime.
+        std::map<WriteConcernKey, std::multimap<OpTime, WaiterType>> _waiters;
     };
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
@@ -1169,6 +1169,72 @@ TEST_F(ReplCoordTest, NodeReturnsWriteConcernFailedWhenAWriteConcernTimesOutBefo
     awaiter.reset();
 }
 
+TEST_F(ReplCoordTest, NodeWakesSatisfiedWaitersRegardlessOfEarlierWaitersWithOtherWriteConcerns) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id"
+                                                  << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id"
+                                                  << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(100, 1));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermOne(100, 1));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermOne time1(100, 1);
+    OpTimeWithTermOne time2(100, 2);
+
+    WriteConcernOptions writeConcern;
+    writeConcern.wTimeout = WriteConcernOptions::kNoTimeout;
+    writeConcern.syncMode = WriteConcernOptions::SyncMode::NONE;
+
+    // 3 nodes waiting for time1
+    ReplicationAwaiter awaiterThreeNodes(getReplCoord(), getServiceContext());
+    writeConcern.wNumNodes = 3;
+    awaiterThreeNodes.setOpTime(time1);
+    awaiterThreeNodes.setWriteConcern(writeConcern);
+    awaiterThreeNodes.start();
+
+    // 2 nodes waiting for time1 and for time2
+    ReplicationAwaiter awaiterTwoNodesTime1(getReplCoord(), getServiceContext());
+    writeConcern.wNumNodes = 2;
+    awaiterTwoNodesTime1.setOpTime(time1);
+    awaiterTwoNodesTime1.setWriteConcern(writeConcern);
+    awaiterTwoNodesTime1.start();
+    ReplicationAwaiter awaiterTwoNodesTime2(getReplCoord(), getServiceContext());
+    awaiterTwoNodesTime2.setOpTime(time2);
+    awaiterTwoNodesTime2.setWriteConcern(writeConcern);
+    awaiterTwoNodesTime2.start();
+
+    // The waiters for 2 nodes are satisfied in opTime order, while the one for 3 nodes still
+    // waits.
+    getReplCoord()->setMyLastAppliedOpTime(time2);
+    getReplCoord()->setMyLastDurableOpTime(time2);
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    ASSERT_OK(awaiterTwoNodesTime1.getResult().status);
+    awaiterTwoNodesTime1.reset();
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(awaiterTwoNodesTime2.getResult().status);
+    awaiterTwoNodesTime2.reset();
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 2, time1));
+    ASSERT_OK(awaiterThreeNodes.getResult().status);
+    awaiterThreeNodes.reset();
+}
+
 TEST_F(ReplCoordTest,
        NodeReturnsShutDownInProgressWhenANodeShutsDownPriorToSatisfyingAWriteConcern) {
     assertStartSuccess(BSON("_id"
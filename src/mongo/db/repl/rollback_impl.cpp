@@ -55,6 +55,7 @@
 #include "mongo/s/catalog/type_config_version.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -73,6 +74,37 @@ MONGO_EXPORT_SERVER_PARAMETER(createRollbackDataFiles, bool, createRollbackFiles
 constexpr auto kInsertCmdName = "insert"_sd;
 constexpr auto kUpdateCmdName = "update"_sd;
 constexpr auto kDeleteCmdName = "delete"_sd;
+
+/**
+ * Records how long each phase of rollback takes in the given RollbackStats. Starting a phase ends
+ * the previous one, and the last phase ends when the timer goes out of scope.
+ */
+class RollbackPhaseTimer {
+public:
+    explicit RollbackPhaseTimer(RollbackStats* stats) : _stats(stats) {}
+
+    ~RollbackPhaseTimer() {
+        _endPhase();
+    }
+
+    void startPhase(StringData phase) {
+        _endPhase();
+        _phase = phase.toString();
+        _timer.reset();
+    }
+
+private:
+    void _endPhase() {
+        if (_phase) {
+            _stats->phaseDurations.emplace_back(*_phase, Milliseconds(_timer.millis()));
+            _phase = boost::none;
+        }
+    }
+
+    RollbackStats* const _stats;
+    boost::optional<std::string> _phase;
+    Timer _timer;
+};
 }  // namespace
 
 constexpr const char* RollbackImpl::kRollbackRemoveSaverType;
@@ -133,13 +165,18 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     ON_BLOCK_EXIT([this, opCtx] { _transitionFromRollbackToSecondary(opCtx); });
     ON_BLOCK_EXIT([this, opCtx] { _summarizeRollback(opCtx); });
 
+    // Declared after the summary so that the last phase is recorded before it is logged.
+    RollbackPhaseTimer phaseTimer(&_rollbackStats);
+
     // Wait for all background index builds to complete before starting the rollback process.
+    phaseTimer.startPhase("await background index builds");
     status = _awaitBgIndexCompletion(opCtx);
     if (!status.isOK()) {
         return status;
     }
     _listener->onBgIndexesComplete();
 
+    phaseTimer.startPhase("find common point");
     auto commonPointSW = _findCommonPoint(opCtx);
     if (!commonPointSW.isOK()) {
         return commonPointSW.getStatus();
@@ -162,6 +199,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     // point, we keep track of how much each collection's count will change during the rollback.
     // Note: these numbers are relative to the common point, not the stable timestamp, and thus
     // must be set after recovering from the oplog.
+    phaseTimer.startPhase("find record store counts");
     status = _findRecordStoreCounts(opCtx);
     if (!status.isOK()) {
         return status;
@@ -179,6 +217,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     if (shouldCreateDataFiles()) {
         // Write a rollback file for each namespace that has documents that would be deleted by
         // rollback.
+        phaseTimer.startPhase("write rollback files");
         status = _writeRollbackFiles(opCtx);
         if (!status.isOK()) {
             return status;
@@ -188,6 +227,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     }
 
     // Recover to the stable timestamp.
+    phaseTimer.startPhase("recover to stable timestamp");
     auto stableTimestampSW = _recoverToStableTimestamp(opCtx);
     if (!stableTimestampSW.isOK()) {
         return stableTimestampSW.getStatus();
@@ -235,6 +275,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     _resetDropPendingState(opCtx);
 
     // Run the recovery process.
+    phaseTimer.startPhase("recover from oplog");
     _replicationProcess->getReplicationRecovery()->recoverFromOplog(opCtx,
                                                                     stableTimestampSW.getValue());
     _listener->onRecoverFromOplog();
@@ -248,6 +289,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     // oplog, which should now be at the common point.
     _replicationCoordinator->resetLastOpTimesFromOplog(
         opCtx, ReplicationCoordinator::DataConsistency::Consistent);
+    phaseTimer.startPhase("run op observers");
     status = _triggerOpObserver(opCtx);
     if (!status.isOK()) {
         return status;
@@ -914,6 +956,11 @@ void RollbackImpl::_summarizeRollback(OperationContext* opCtx) const {
     }
     log() << "\ttotal number of entries rolled back (including no-ops): "
           << _observerInfo.numberOfEntriesObserved;
+    log() << "\ttime spent in each phase: "
+          << (_rollbackStats.phaseDurations.empty() ? "none" : "");
+    for (const auto& phase : _rollbackStats.phaseDurations) {
+        log() << "\t\t" << phase.first << ": " << phase.second;
+    }
 }
 
 /**
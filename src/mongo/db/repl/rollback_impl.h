@@ -103,6 +103,12 @@ struct RollbackStats {
      * The wall clock time at the common point, if known.
      */
     boost::optional<Date_t> commonPointWallClockTime;
+
+    /**
+     * How long each phase of rollback took, in the order the phases ran. If rollback fails, the
+     * failing phase is the last one recorded.
+     */
+    std::vector<std::pair<std::string, Milliseconds>> phaseDurations;
 };
 
 /**
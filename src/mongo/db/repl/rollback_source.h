@@ -28,15 +28,19 @@
 
 #pragma once
 
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
 
-class NamespaceString;
 class OperationContext;
 
 namespace repl {
@@ -88,6 +92,28 @@ public:
                                                               UUID uuid,
                                                               const BSONObj& filter) const = 0;
 
+    /**
+     * Fetches the documents with the given '_id' values from the sync source using the UUID, in no
+     * particular order. Ids with no matching document are left out of the result. Returns the
+     * namespace matching the UUID on the sync source as well.
+     *
+     * The default implementation issues one findOneByUUID() per id; implementations talking to a
+     * remote node should override it to fetch all the ids in a single query.
+     */
+    virtual std::pair<std::vector<BSONObj>, NamespaceString> findByUUID(
+        const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+        std::vector<BSONObj> docs;
+        NamespaceString nss;
+        for (const auto& id : ids) {
+            BSONObj doc;
+            std::tie(doc, nss) = findOneByUUID(db, uuid, id.wrap());
+            if (!doc.isEmpty()) {
+                docs.push_back(doc);
+            }
+        }
+        return {std::move(docs), std::move(nss)};
+    }
+
     /**
      * Clones a single collection from the sync source.
      */
@@ -35,6 +35,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/oplogreader.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -80,6 +81,55 @@ std::pair<BSONObj, NamespaceString> RollbackSourceImpl::findOneByUUID(const std:
     return _getConnection()->findOneByUUID(db, uuid, filter);
 }
 
+std::pair<std::vector<BSONObj>, NamespaceString> RollbackSourceImpl::findByUUID(
+    const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+    BSONObjBuilder cmdBuilder;
+    uuid.appendToBuilder(&cmdBuilder, "find");
+    {
+        BSONObjBuilder filterBuilder(cmdBuilder.subobjStart("filter"));
+        BSONObjBuilder idBuilder(filterBuilder.subobjStart("_id"));
+        BSONArrayBuilder inBuilder(idBuilder.subarrayStart("$in"));
+        for (const auto& id : ids) {
+            inBuilder.append(id);
+        }
+    }
+    BSONObj cmd = cmdBuilder.obj();
+
+    auto conn = _getConnection();
+    std::vector<BSONObj> docs;
+    BSONObj res;
+    if (!conn->runCommand(db, cmd, res, QueryOption_SlaveOk)) {
+        uassertStatusOKWithContext(getStatusFromCommandResult(res),
+                                   str::stream() << "find command using UUID failed. Command: "
+                                                 << cmd);
+    }
+
+    BSONObj cursorObj = res.getObjectField("cursor");
+    NamespaceString resNss(cursorObj["ns"].valueStringData());
+    for (auto&& elem : cursorObj.getObjectField("firstBatch")) {
+        docs.push_back(elem.Obj().getOwned());
+    }
+
+    // The ids are bounded by the caller but the documents are not, so drain the cursor.
+    long long cursorId = cursorObj["id"].numberLong();
+    while (cursorId != 0) {
+        BSONObj getMoreCmd = BSON("getMore" << cursorId << "collection" << resNss.coll());
+        BSONObj getMoreRes;
+        if (!conn->runCommand(db, getMoreCmd, getMoreRes, QueryOption_SlaveOk)) {
+            uassertStatusOKWithContext(getStatusFromCommandResult(getMoreRes),
+                                       str::stream() << "getMore on " << resNss.ns()
+                                                     << " failed while refetching by UUID");
+        }
+        BSONObj getMoreCursor = getMoreRes.getObjectField("cursor");
+        for (auto&& elem : getMoreCursor.getObjectField("nextBatch")) {
+            docs.push_back(elem.Obj().getOwned());
+        }
+        cursorId = getMoreCursor["id"].numberLong();
+    }
+
+    return {std::move(docs), resNss};
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* opCtx,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
@@ -71,6 +71,9 @@ public:
                                                       UUID uuid,
                                                       const BSONObj& filter) const override;
 
+    std::pair<std::vector<BSONObj>, NamespaceString> findByUUID(
+        const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const override;
+
     void copyCollectionFromRemote(OperationContext* opCtx,
                                   const NamespaceString& nss) const override;
 
@@ -580,6 +580,11 @@ Status rollback_internal::updateFixUpInfoFromLocalOplogEntry(FixUpInfo& fixUpInf
 
 namespace {
 
+// Bounds on the number and total size of the _ids refetched from the sync source in one query, so
+// that the $in filter stays well under the maximum BSON object size.
+const size_t kRefetchBatchMaxDocs = 1000;
+const int kRefetchBatchMaxBytes = BSONObjMaxUserSize / 4;
+
 /**
  * This must be called before making any changes to our local data and after fetching any
  * information from the upstream node. If any information is fetched from the upstream node after we
@@ -978,27 +983,37 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
     stdx::unordered_map<UUID, std::map<DocID, BSONObj>, UUID::Hash> goodVersions;
     auto& catalog = UUIDCatalog::get(opCtx);
 
-    // Fetches all the goodVersions of each document from the current sync source.
+    // Fetches all the goodVersions of each document from the current sync source. The documents
+    // to refetch are ordered by collection UUID, so each run of ids in the same collection is
+    // fetched with one query per batch instead of one round trip per document.
     unsigned long long numFetched = 0;
 
     log() << "Starting refetching documents";
 
-    for (auto&& doc : fixUpInfo.docsToRefetch) {
-        invariant(!doc._id.eoo());  // This is checked when we insert to the set.
-
-        UUID uuid = doc.uuid;
+    const auto& docsToRefetch = fixUpInfo.docsToRefetch;
+    for (auto batchBegin = docsToRefetch.begin(); batchBegin != docsToRefetch.end();) {
+        UUID uuid = batchBegin->uuid;
         NamespaceString nss = catalog.lookupNSSByUUID(uuid);
 
+        std::vector<BSONElement> ids;
+        int idsSize = 0;
+        auto batchEnd = batchBegin;
+        while (batchEnd != docsToRefetch.end() && batchEnd->uuid == uuid &&
+               ids.size() < kRefetchBatchMaxDocs && idsSize < kRefetchBatchMaxBytes) {
+            invariant(!batchEnd->_id.eoo());  // This is checked when we insert to the set.
+            ids.push_back(batchEnd->_id);
+            idsSize += batchEnd->_id.size();
+            ++batchEnd;
+        }
+
         try {
-            LOG(2) << "Refetching document, collection: " << nss << ", UUID: " << uuid << ", "
-                   << redact(doc._id);
-            // TODO : Slow. Lots of round trips.
-            numFetched++;
+            LOG(2) << "Refetching " << ids.size() << " documents, collection: " << nss
+                   << ", UUID: " << uuid;
+            numFetched += ids.size();
 
-            BSONObj good;
+            std::vector<BSONObj> docs;
             NamespaceString resNss;
-            std::tie(good, resNss) =
-                rollbackSource.findOneByUUID(nss.db().toString(), uuid, doc._id.wrap());
+            std::tie(docs, resNss) = rollbackSource.findByUUID(nss.db().toString(), uuid, ids);
 
             // To prevent inconsistencies in the transactions collection, rollback fails if the UUID
             // of the collection is different on the sync source than on the node rolling back,
@@ -1015,7 +1030,21 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
                        "resync is required.");
             }
 
-            totalSize += good.objsize();
+            // Every id in the batch starts out with an empty good version, indicating we should
+            // delete it, and is then matched up with the document returned for it, if any.
+            auto& collectionGoodVersions = goodVersions[uuid];
+            for (auto it = batchBegin; it != batchEnd; ++it) {
+                collectionGoodVersions.emplace(*it, BSONObj());
+            }
+            for (auto&& good : docs) {
+                auto it = collectionGoodVersions.find(DocID(good, good["_id"], uuid));
+                if (it == collectionGoodVersions.end()) {
+                    continue;
+                }
+                it->second = good;
+
+                totalSize += good.objsize();
+            }
 
             // Checks that the total amount of data that needs to be refetched is at most
             // 300 MB. We do not roll back more than 300 MB of documents in order to
@@ -1023,10 +1052,6 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
             if (totalSize >= 300 * 1024 * 1024) {
                 throw RSFatalException("replSet too much data to roll back.");
             }
-
-            // Note good might be empty, indicating we should delete it.
-            goodVersions[uuid].insert(std::pair<DocID, BSONObj>(doc, good));
-
         } catch (const DBException& ex) {
             // If the collection turned into a view, we might get an error trying to
             // refetch documents, but these errors should be ignored, as we'll be creating
@@ -1034,15 +1059,16 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
             // Collection may be dropped on the sync source, in which case it will be dropped during
             // oplog replay. So it is safe to ignore NamespaceNotFound errors while trying to
             // refetch documents.
-            if (ex.code() == ErrorCodes::CommandNotSupportedOnView ||
-                ex.code() == ErrorCodes::NamespaceNotFound)
-                continue;
-
-            log() << "Rollback couldn't re-fetch from uuid: " << uuid << " _id: " << redact(doc._id)
-                  << ' ' << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": "
-                  << redact(ex);
-            throw;
+            if (ex.code() != ErrorCodes::CommandNotSupportedOnView &&
+                ex.code() != ErrorCodes::NamespaceNotFound) {
+                log() << "Rollback couldn't re-fetch " << ids.size()
+                      << " documents from uuid: " << uuid << ' ' << numFetched << '/'
+                      << docsToRefetch.size() << ": " << redact(ex);
+                throw;
+            }
         }
+
+        batchBegin = batchEnd;
     }
 
     log() << "Finished refetching documents. Total size of documents refetched: "
@@ -1778,6 +1778,91 @@ TEST_F(RSRollbackTest, RollbackApplyOpsCommand) {
         << result;
 }
 
+TEST_F(RSRollbackTest, RollbackRefetchesDocumentsOfACollectionInOneBatch) {
+    createOplog(_opCtx.get());
+    CollectionOptions options;
+    options.uuid = UUID::gen();
+    auto coll = _createCollection(_opCtx.get(), "test.t", options);
+    {
+        AutoGetCollection autoColl(_opCtx.get(), NamespaceString("test.t"), MODE_X);
+        WriteUnitOfWork wuow(_opCtx.get());
+        OpDebug* const nullOpDebug = nullptr;
+        for (int id = 1; id <= 3; ++id) {
+            ASSERT_OK(coll->insertDocument(_opCtx.get(),
+                                           InsertStatement(BSON("_id" << id << "v" << 2)),
+                                           nullOpDebug,
+                                           false));
+        }
+        wuow.commit();
+    }
+    UUID uuid = coll->uuid().get();
+
+    auto makeInsertOperation = [&](int id) {
+        return std::make_pair(BSON("ts" << Timestamp(Seconds(id + 1), 0) << "h" << 1LL << "op"
+                                        << "i"
+                                        << "ui"
+                                        << uuid
+                                        << "ns"
+                                        << "test.t"
+                                        << "o"
+                                        << BSON("_id" << id << "v" << 2)),
+                              RecordId(id + 1));
+    };
+    auto commonOperation = makeOpAndRecordId(1, 1);
+
+    class RollbackSourceLocal : public RollbackSourceMock {
+    public:
+        RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+            : RollbackSourceMock(std::move(oplog)) {}
+
+        std::pair<BSONObj, NamespaceString> findOneByUUID(const std::string& db,
+                                                          UUID uuid,
+                                                          const BSONObj& filter) const override {
+            FAIL("Unexpected findOneByUUID request") << filter;
+            return {};
+        }
+
+        std::pair<std::vector<BSONObj>, NamespaceString> findByUUID(
+            const std::string& db,
+            UUID uuid,
+            const std::vector<BSONElement>& ids) const override {
+            ++numCalls;
+            for (const auto& id : ids) {
+                searchedIds.insert(id.numberInt());
+            }
+            // Only the document with _id 2 still exists on the sync source.
+            return {{BSON("_id" << 2 << "v" << 1)}, NamespaceString("test.t")};
+        }
+
+        mutable int numCalls = 0;
+        mutable std::multiset<int> searchedIds;
+    } rollbackSource(std::unique_ptr<OplogInterface>(new OplogInterfaceMock({commonOperation})));
+
+    ASSERT_OK(syncRollback(_opCtx.get(),
+                           OplogInterfaceMock({makeInsertOperation(3),
+                                               makeInsertOperation(2),
+                                               makeInsertOperation(1),
+                                               commonOperation}),
+                           rollbackSource,
+                           {},
+                           _coordinator,
+                           _replicationProcess.get()));
+    ASSERT_EQUALS(1, rollbackSource.numCalls);
+    ASSERT_EQUALS(3U, rollbackSource.searchedIds.size());
+    ASSERT_EQUALS(1U, rollbackSource.searchedIds.count(1));
+    ASSERT_EQUALS(1U, rollbackSource.searchedIds.count(2));
+    ASSERT_EQUALS(1U, rollbackSource.searchedIds.count(3));
+
+    AutoGetCollectionForReadCommand acr(_opCtx.get(), NamespaceString("test.t"));
+    BSONObj result;
+    ASSERT_FALSE(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 1), result))
+        << result;
+    ASSERT(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 2), result));
+    ASSERT_EQUALS(1, result["v"].numberInt()) << result;
+    ASSERT_FALSE(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 3), result))
+        << result;
+}
+
 TEST_F(RSRollbackTest, RollbackCreateCollectionCommand) {
     createOplog(_opCtx.get());
     CollectionOptions options;
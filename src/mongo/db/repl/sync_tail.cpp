@@ -34,7 +34,11 @@
 
 #include "third_party/murmurhash3/MurmurHash3.h"
 #include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <numeric>
+#include <queue>
 
 #include "mongo/base/counter.h"
 #include "mongo/bson/bsonelement_comparator.h"
@@ -72,6 +76,7 @@
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -102,6 +107,38 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// Time the applier spends waiting for the batcher to hand it the next non-empty batch. Time spent
+// here means the applier is starved by fetching and buffering rather than slowed by application.
+TimerStats batchWaitStats;
+ServerStatusMetricField<TimerStats> displayBatchWaits("repl.apply.batchWaits", &batchWaitStats);
+
+// Number and time of each writer thread's share of the oplog writes for a batch.
+TimerStats oplogWriteStats;
+ServerStatusMetricField<TimerStats> displayOplogWrites("repl.apply.oplogWrites", &oplogWriteStats);
+
+// Number and time of each writer thread's share of the op application for a batch.
+TimerStats writerApplyStats;
+ServerStatusMetricField<TimerStats> displayWriterApplies("repl.apply.writers", &writerApplyStats);
+
+// Time taken by the slowest writer thread in each batch, which bounds the application time of the
+// batch. Dividing 'repl.apply.writers' by this times the number of writer threads gives the writer
+// pool utilization.
+TimerStats slowestWriterStats;
+ServerStatusMetricField<TimerStats> displaySlowestWriters("repl.apply.slowestWriter",
+                                                          &slowestWriterStats);
+
+// Sum over the writer threads given work in each batch of how long they finished before the
+// slowest one. A large value relative to 'repl.apply.writers' means the ops are skewed towards a
+// few writer threads.
+Counter64 writerIdleMillis;
+ServerStatusMetricField<Counter64> displayWriterIdleMillis("repl.apply.writerIdleMillis",
+                                                           &writerIdleMillis);
+
+// Number and time of the waits for the journal made on behalf of applied batches.
+TimerStats journalWaitStats;
+ServerStatusMetricField<TimerStats> displayJournalWaits("repl.apply.journalWaits",
+                                                        &journalWaitStats);
+
 class ApplyBatchFinalizer {
 public:
     ApplyBatchFinalizer(ReplicationCoordinator* replCoord) : _replCoord(replCoord) {}
@@ -200,7 +237,10 @@ void ApplyBatchFinalizerForJournal::_run() {
         }
 
         auto opCtx = cc().makeOperationContext();
-        opCtx->recoveryUnit()->waitUntilDurable();
+        {
+            TimerHolder timer(&journalWaitStats);
+            opCtx->recoveryUnit()->waitUntilDurable();
+        }
         _recordDurable(latestOpTime);
     }
 }
@@ -321,6 +361,68 @@ Status SyncTail::syncApply(OperationContext* opCtx,
     MONGO_UNREACHABLE;
 }
 
+// static
+Status SyncTail::syncApplyUpdatesAndDeletes(OperationContext* opCtx,
+                                            const MultiApplier::OperationPtrs& ops,
+                                            OplogApplication::Mode oplogApplicationMode) {
+    invariant(!ops.empty());
+
+    CurOp individualOp(opCtx);
+    UnreplicatedWritesBlock uwb(opCtx);
+    DisableDocumentValidation validationDisabler(opCtx);
+
+    const auto& firstOp = *ops.front();
+    const auto& nss = firstOp.getNamespace();
+
+    // applyOperation_inlock leaves timestamping to the caller when it runs inside a wrapping
+    // WriteUnitOfWork, so each write is stamped here instead, under the same rules it applies to
+    // standalone operations.
+    const auto replMode = ReplicationCoordinator::get(opCtx)->getReplicationMode();
+    const bool assignOperationTimestamps = replMode == ReplicationCoordinator::modeReplSet ||
+        oplogApplicationMode == OplogApplication::Mode::kRecovering;
+
+    // See syncApply for why updates are converted to upserts outside of initial sync.
+    const bool shouldAlwaysUpsert = (oplogApplicationMode != OplogApplication::Mode::kInitialSync);
+
+    size_t opsApplied = 0;
+    auto status = writeConflictRetry(opCtx, "syncApply_updatesAndDeletes", nss.ns(), [&] {
+        opsApplied = 0;
+
+        AutoGetCollection autoColl(opCtx, getNsOrUUID(nss, firstOp.raw), MODE_IX);
+        auto db = autoColl.getDb();
+        if (!db || !autoColl.getCollection()) {
+            return Status(ErrorCodes::NamespaceNotFound,
+                          str::stream() << "missing collection " << nss.ns());
+        }
+        OldClientContext ctx(opCtx, autoColl.getNss().ns(), db);
+
+        WriteUnitOfWork wuow(opCtx);
+        for (const auto op : ops) {
+            if (assignOperationTimestamps) {
+                uassertStatusOK(opCtx->recoveryUnit()->setTimestamp(op->getTimestamp()));
+            }
+
+            auto status = applyOperation_inlock(
+                opCtx, ctx.db(), op->raw, shouldAlwaysUpsert, oplogApplicationMode, [&opsApplied] {
+                    ++opsApplied;
+                });
+            if (status.code() == ErrorCodes::WriteConflict) {
+                throw WriteConflictException();
+            }
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        wuow.commit();
+        return Status::OK();
+    });
+
+    if (status.isOK()) {
+        opsAppliedStats.increment(opsApplied);
+    }
+    return status;
+}
+
 SyncTail::SyncTail(OplogApplier::Observer* observer,
                    ReplicationConsistencyMarkers* consistencyMarkers,
                    StorageInterface* storageInterface,
@@ -388,8 +490,10 @@ void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
               const SyncTail::MultiSyncApplyFunc& func,
               SyncTail* st,
               std::vector<Status>* statusVector,
-              std::vector<WorkerMultikeyPathInfo>* workerMultikeyPathInfo) {
+              std::vector<WorkerMultikeyPathInfo>* workerMultikeyPathInfo,
+              std::vector<int>* writerMillis) {
     invariant(writerVectors.size() == statusVector->size());
+    invariant(writerVectors.size() == writerMillis->size());
     for (size_t i = 0; i < writerVectors.size(); i++) {
         if (!writerVectors[i].empty()) {
             invariant(writerPool->schedule([
@@ -397,15 +501,43 @@ void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
                 st,
                 &writer = writerVectors.at(i),
                 &status = statusVector->at(i),
-                &workerMultikeyPathInfo = workerMultikeyPathInfo->at(i)
+                &workerMultikeyPathInfo = workerMultikeyPathInfo->at(i),
+                &millis = writerMillis->at(i)
             ] {
+                Timer timer;
                 auto opCtx = cc().makeOperationContext();
+                PrioritizedTicketAcquisitionBlock prioritizedTickets(opCtx->lockState());
                 status = func(opCtx.get(), &writer, st, &workerMultikeyPathInfo);
+                millis = static_cast<int>(timer.millis());
+                writerApplyStats.recordMillis(millis);
             }));
         }
     }
 }
 
+/**
+ * Records how much earlier than the slowest writer thread each writer thread that was given work in
+ * a batch finished.
+ */
+void recordWriterSkew(const std::vector<MultiApplier::OperationPtrs>& writerVectors,
+                      const std::vector<int>& writerMillis) {
+    int slowest = 0;
+    long long total = 0;
+    int numWriters = 0;
+    for (size_t i = 0; i < writerVectors.size(); i++) {
+        if (!writerVectors[i].empty()) {
+            slowest = std::max(slowest, writerMillis[i]);
+            total += writerMillis[i];
+            numWriters++;
+        }
+    }
+    if (numWriters == 0) {
+        return;
+    }
+    slowestWriterStats.recordMillis(slowest);
+    writerIdleMillis.increment(static_cast<long long>(slowest) * numWriters - total);
+}
+
 // Schedules the writes to the oplog for 'ops' into threadPool. The caller must guarantee that 'ops'
 // stays valid until all scheduled work in the thread pool completes.
 void scheduleWritesToOplog(OperationContext* opCtx,
@@ -418,10 +550,12 @@ void scheduleWritesToOplog(OperationContext* opCtx,
         // captures other than 'ops' must be by value since they will not be available. The caller
         // guarantees that 'ops' will stay in scope until the spawned threads complete.
         return [storageInterface, &ops, begin, end] {
+            TimerHolder timer(&oplogWriteStats);
             auto opCtx = cc().makeOperationContext();
             UnreplicatedWritesBlock uwb(opCtx.get());
             ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
                 opCtx->lockState());
+            PrioritizedTicketAcquisitionBlock prioritizedTickets(opCtx->lockState());
 
             std::vector<InsertStatement> docs;
             docs.reserve(end - begin);
@@ -512,24 +646,78 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * The operations of a batch grouped into chains by the hash which orders them. Operations in one
+ * chain must be applied by a single writer in batch order, while separate chains are independent
+ * of each other and may go to any writer.
+ */
+class OperationChains {
+public:
+    void add(uint32_t hash, const OplogEntry* op) {
+        auto it = _chainIndexByHash.find(hash);
+        if (it == _chainIndexByHash.end()) {
+            it = _chainIndexByHash.emplace(hash, _chains.size()).first;
+            _chains.emplace_back();
+        }
+        _chains[it->second].push_back(op);
+    }
+
+    /**
+     * Hands out the chains so that each writer ends up with a similar number of operations. The
+     * longest chains are placed first, each on the writer with the fewest operations so far, so
+     * that a few busy documents or collections no longer pile onto whichever writer their hashes
+     * happen to share.
+     */
+    void assignToWriters(std::vector<MultiApplier::OperationPtrs>* writerVectors) {
+        std::vector<size_t> order(_chains.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+            return _chains[lhs].size() > _chains[rhs].size();
+        });
+
+        // Pairs of (number of operations, writer index), least loaded writer on top
+        using WriterLoad = std::pair<size_t, size_t>;
+        std::priority_queue<WriterLoad, std::vector<WriterLoad>, std::greater<WriterLoad>>
+            writerLoads;
+        for (size_t i = 0; i < writerVectors->size(); ++i) {
+            writerLoads.emplace((*writerVectors)[i].size(), i);
+        }
+
+        for (const auto chainIndex : order) {
+            const auto& chain = _chains[chainIndex];
+            auto leastLoaded = writerLoads.top();
+            writerLoads.pop();
+
+            auto& writer = (*writerVectors)[leastLoaded.second];
+            writer.insert(writer.end(), chain.begin(), chain.end());
+
+            leastLoaded.first += chain.size();
+            writerLoads.push(leastLoaded);
+        }
+    }
+
+private:
+    stdx::unordered_map<uint32_t, size_t> _chainIndexByHash;
+    std::vector<MultiApplier::OperationPtrs> _chains;
+};
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
- * writerVectors - Set of operations for each worker thread to apply.
+ * chains - Receives the operations, grouped by the hash which orders them.
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
  */
-void fillWriterVectors(OperationContext* opCtx,
-                       MultiApplier::Operations* ops,
-                       std::vector<MultiApplier::OperationPtrs>* writerVectors,
-                       std::vector<MultiApplier::Operations>* derivedOps,
-                       SessionUpdateTracker* sessionUpdateTracker) {
+void fillOperationChains(OperationContext* opCtx,
+                         MultiApplier::Operations* ops,
+                         OperationChains* chains,
+                         std::vector<MultiApplier::Operations>* derivedOps,
+                         SessionUpdateTracker* sessionUpdateTracker) {
     const auto serviceContext = opCtx->getServiceContext();
     const auto storageEngine = serviceContext->getStorageEngine();
 
     const bool supportsDocLocking = storageEngine->supportsDocLocking();
-    const uint32_t numWriters = writerVectors->size();
 
     CachedCollectionProperties collPropertiesCache;
 
@@ -542,7 +730,7 @@ void fillWriterVectors(OperationContext* opCtx,
         if (sessionUpdateTracker) {
             if (auto newOplogWrites = sessionUpdateTracker->updateOrFlush(op)) {
                 derivedOps->emplace_back(std::move(*newOplogWrites));
-                fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                fillOperationChains(opCtx, &derivedOps->back(), chains, derivedOps, nullptr);
             }
         }
 
@@ -574,8 +762,8 @@ void fillWriterVectors(OperationContext* opCtx,
         if (op.isCommand() && op.getCommandType() == OplogEntry::CommandType::kApplyOps) {
             try {
                 derivedOps->emplace_back(ApplyOps::extractOperations(op));
-                fillWriterVectors(
-                    opCtx, &derivedOps->back(), writerVectors, derivedOps, sessionUpdateTracker);
+                fillOperationChains(
+                    opCtx, &derivedOps->back(), chains, derivedOps, sessionUpdateTracker);
             } catch (...) {
                 fassertFailedWithStatusNoTrace(
                     50711,
@@ -586,26 +774,28 @@ void fillWriterVectors(OperationContext* opCtx,
             continue;
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
-        if (writer.empty()) {
-            writer.reserve(8);  // Skip a few growth rounds
-        }
-        writer.push_back(&op);
+        chains->add(hash, &op);
     }
 }
 
+/**
+ * writerVectors - Set of operations for each worker thread to apply.
+ */
 void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
                        std::vector<MultiApplier::OperationPtrs>* writerVectors,
                        std::vector<MultiApplier::Operations>* derivedOps) {
+    OperationChains chains;
     SessionUpdateTracker sessionUpdateTracker;
-    fillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    fillOperationChains(opCtx, ops, &chains, derivedOps, &sessionUpdateTracker);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        fillOperationChains(opCtx, &derivedOps->back(), &chains, derivedOps, nullptr);
     }
+
+    chains.assignToWriters(writerVectors);
 }
 
 }  // namespace
@@ -675,6 +865,7 @@ public:
     }
 
     OpQueue getNextBatch(Seconds maxWaitTime) {
+        Timer timer;
         stdx::unique_lock<stdx::mutex> lk(_mutex);
         if (_ops.empty() && !_ops.mustShutdown()) {
             // We intentionally don't care about whether this returns due to signaling or timeout
@@ -686,6 +877,9 @@ public:
         _ops = OpQueue(0);
         _cv.notify_all();
 
+        if (!ops.empty()) {
+            batchWaitStats.recordMillis(timer.millis());
+        }
         return ops;
     }
 
@@ -1179,6 +1373,7 @@ Status multiSyncApply(OperationContext* opCtx,
                : OplogApplication::Mode::kSecondary);
 
     ApplierHelpers::InsertGroup insertGroup(ops, opCtx, oplogApplicationMode);
+    ApplierHelpers::UpdateDeleteGroup updateDeleteGroup(ops, opCtx, oplogApplicationMode);
 
     {  // Ensure that the MultikeyPathTracker stops tracking paths.
         ON_BLOCK_EXIT([opCtx] { MultikeyPathTracker::get(opCtx).stopTrackingMultikeyPathInfo(); });
@@ -1195,6 +1390,13 @@ Status multiSyncApply(OperationContext* opCtx,
                 continue;
             }
 
+            // Likewise for a group of updates and deletes.
+            groupResult = updateDeleteGroup.groupAndApplyUpdatesAndDeletes(it);
+            if (groupResult.isOK()) {
+                it = groupResult.getValue();
+                continue;
+            }
+
             // If we didn't create a group, try to apply the op individually.
             try {
                 const Status status = SyncTail::syncApply(opCtx, entry.raw, oplogApplicationMode);
@@ -1269,9 +1471,13 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         // because the spawned threads refer to objects on the stack
         ON_BLOCK_EXIT([&] { _writerPool->waitForIdle(); });
 
-        // Write batch of ops into oplog.
+        // Write batch of ops into oplog. The writes overlap with applying the ops below, so
+        // 'minValid' is moved to the end of the batch first: if the node fails before the batch
+        // is complete, the oplog is truncated back to the start of the batch, and the partially
+        // applied data is not considered consistent until the batch has been applied again.
         if (!_options.skipWritesToOplog) {
             _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
+            _consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
             scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
         }
 
@@ -1287,19 +1493,20 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         std::vector<MultiApplier::OperationPtrs> writerVectors(_writerPool->getStats().numThreads);
         fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
 
-        // Wait for writes to finish before applying ops.
-        _writerPool->waitForIdle();
-
-        // Reset consistency markers in case the node fails while applying ops.
-        if (!_options.skipWritesToOplog) {
-            _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
-            _consistencyMarkers->setMinValidToAtLeast(opCtx, ops.back().getOpTime());
-        }
-
         {
+            // The writer threads move on to applying ops as soon as they are done with their share
+            // of the oplog writes.
             std::vector<Status> statusVector(_writerPool->getStats().numThreads, Status::OK());
-            applyOps(writerVectors, _writerPool, _applyFunc, this, &statusVector, &multikeyVector);
+            std::vector<int> writerMillis(_writerPool->getStats().numThreads, 0);
+            applyOps(writerVectors,
+                     _writerPool,
+                     _applyFunc,
+                     this,
+                     &statusVector,
+                     &multikeyVector,
+                     &writerMillis);
             _writerPool->waitForIdle();
+            recordWriterSkew(writerVectors, writerMillis);
 
             // If any of the statuses is not ok, return error.
             for (auto it = statusVector.cbegin(); it != statusVector.cend(); ++it) {
@@ -1316,6 +1523,11 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
             }
         }
 
+        // Every op in the batch is now both in the oplog and applied.
+        if (!_options.skipWritesToOplog) {
+            _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, Timestamp());
+        }
+
         // Notify the storage engine that a replication batch has completed.
         // This means that all the writes associated with the oplog entries in the batch are
         // finished and no new writes with timestamps associated with those oplog entries will show
@@ -79,6 +79,16 @@ public:
                             const BSONObj& o,
                             OplogApplication::Mode oplogApplicationMode);
 
+    /**
+     * Applies the update and delete operations in 'ops', which must all target the same
+     * collection, under a single collection lock and WriteUnitOfWork. Each write is stamped with
+     * the timestamp of its own oplog entry. Any error abandons the whole group, leaving the caller
+     * to apply the operations one at a time with syncApply.
+     */
+    static Status syncApplyUpdatesAndDeletes(OperationContext* opCtx,
+                                             const MultiApplier::OperationPtrs& ops,
+                                             OplogApplication::Mode oplogApplicationMode);
+
     /**
      *
      * Constructs a SyncTail.
@@ -518,6 +518,104 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_EQUALS(op2, lastEntry);
 }
 
+TEST_F(SyncTailTest, MultiApplyBalancesOperationChainsAcrossWriterThreads) {
+    auto writerPool = OplogApplier::makeWriterPool(2);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn =
+        [&mutex, &operationsApplied](OperationContext* opCtx,
+                                     MultiApplier::OperationPtrs* operationsForWriterThreadToApply,
+                                     SyncTail* st,
+                                     WorkerMultikeyPathInfo*) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    // Three operations on a single hot document, which must stay together and in order, and one
+    // operation on each of three other collections.
+    NamespaceString hotNss("test.hot");
+    MultiApplier::Operations ops;
+    for (int i = 1; i <= 3; ++i) {
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(i), 0), 1LL}, hotNss, BSON("_id" << 1 << "x" << i)));
+    }
+    for (int i = 4; i <= 6; ++i) {
+        NamespaceString nss("test.t" + std::to_string(i));
+        ops.push_back(
+            makeInsertDocumentOplogEntry({Timestamp(Seconds(i), 0), 1LL}, nss, BSON("_id" << i)));
+    }
+    const auto hotOps = MultiApplier::Operations(ops.begin(), ops.begin() + 3);
+
+    SyncTail syncTail(nullptr,
+                      getConsistencyMarkers(),
+                      getStorageInterface(),
+                      applyOperationFn,
+                      writerPool.get());
+    ASSERT_EQUALS(ops.back().getOpTime(),
+                  unittest::assertGet(syncTail.multiApply(_opCtx.get(), ops)));
+
+    // The hot document's chain fills one writer and the independent operations go to the other.
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(2U, operationsApplied.size());
+    for (auto&& operationsAppliedByThread : operationsApplied) {
+        ASSERT_EQUALS(3U, operationsAppliedByThread.size());
+        if (operationsAppliedByThread.front().getNamespace() == hotNss) {
+            ASSERT(std::equal(hotOps.begin(), hotOps.end(), operationsAppliedByThread.begin()));
+        } else {
+            for (auto&& op : operationsAppliedByThread) {
+                ASSERT_NOT_EQUALS(hotNss, op.getNamespace());
+            }
+        }
+    }
+}
+
+TEST_F(SyncTailTest, MultiApplyMovesMinValidToEndOfBatchBeforeApplyingOperations) {
+    NamespaceString nss("test.t");
+    auto writerPool = OplogApplier::makeWriterPool(2);
+
+    auto op1 = makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, BSON("x" << 1));
+    auto op2 = makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("x" << 2));
+
+    // Operations are applied while the oplog writes may still be in progress, so the batch must
+    // already be covered by 'minValid' and the oplog truncate point.
+    auto consistencyMarkers = getConsistencyMarkers();
+    stdx::mutex mutex;
+    std::vector<OpTime> minValidSeenByWriters;
+    std::vector<Timestamp> truncateAfterPointSeenByWriters;
+    auto applyOperationFn = [&](OperationContext* opCtx,
+                                MultiApplier::OperationPtrs*,
+                                SyncTail*,
+                                WorkerMultikeyPathInfo*) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        minValidSeenByWriters.push_back(consistencyMarkers->getMinValid(opCtx));
+        truncateAfterPointSeenByWriters.push_back(
+            consistencyMarkers->getOplogTruncateAfterPoint(opCtx));
+        return Status::OK();
+    };
+
+    SyncTail syncTail(
+        nullptr, consistencyMarkers, getStorageInterface(), applyOperationFn, writerPool.get());
+    ASSERT_EQUALS(op2.getOpTime(),
+                  unittest::assertGet(syncTail.multiApply(_opCtx.get(), {op1, op2})));
+
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_FALSE(minValidSeenByWriters.empty());
+    for (const auto& minValid : minValidSeenByWriters) {
+        ASSERT_EQUALS(op2.getOpTime(), minValid);
+    }
+    for (const auto& truncateAfterPoint : truncateAfterPointSeenByWriters) {
+        ASSERT_EQUALS(op1.getOpTime().getTimestamp(), truncateAfterPoint);
+    }
+
+    // The truncate point is cleared once the batch is both written to the oplog and applied.
+    ASSERT_EQUALS(Timestamp(), consistencyMarkers->getOplogTruncateAfterPoint(_opCtx.get()));
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     auto op = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
@@ -992,6 +1090,44 @@ TEST_F(SyncTailTest, MultiSyncApplyFallsBackOnApplyingInsertsIndividuallyWhenGro
     ASSERT_EQUALS(1U, numFailedGroupedInserts);
 }
 
+TEST_F(SyncTailTest, MultiSyncApplyFallsBackToIndividualUpdatesAndDeletesWhenGroupFails) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto makeOpTime = [](int seconds) { return OpTime(Timestamp(Seconds(seconds), 0), 1LL); };
+
+    MultiApplier::Operations operationsToApply;
+    operationsToApply.push_back(makeCreateCollectionOplogEntry(makeOpTime(1), nss));
+    operationsToApply.push_back(makeInsertDocumentOplogEntry(makeOpTime(2), nss, BSON("_id" << 1)));
+    operationsToApply.push_back(makeInsertDocumentOplogEntry(makeOpTime(3), nss, BSON("_id" << 2)));
+    operationsToApply.push_back(makeUpdateDocumentOplogEntry(
+        makeOpTime(4), nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 1)));
+    operationsToApply.push_back(makeDeleteDocumentOplogEntry(makeOpTime(5), nss, BSON("_id" << 2)));
+    operationsToApply.push_back(makeUpdateDocumentOplogEntry(
+        makeOpTime(6), nss, BSON("_id" << 1), BSON("_id" << 1 << "x" << 2)));
+
+    // Fail the first delete, which aborts the whole update/delete group.
+    std::size_t numDeletes = 0;
+    _opObserver->onDeleteFn = [&](OperationContext*,
+                                  const NamespaceString&,
+                                  OptionalCollectionUUID,
+                                  StmtId,
+                                  bool,
+                                  const boost::optional<BSONObj>&) {
+        if (numDeletes++ == 0) {
+            uasserted(ErrorCodes::OperationFailed, "grouped delete failed");
+        }
+    };
+
+    ASSERT_OK(runOpsSteadyState(operationsToApply));
+
+    // The group's writes were rolled back and reapplied one operation at a time.
+    ASSERT_EQUALS(2U, numDeletes);
+
+    OplogInterfaceLocal collectionReader(_opCtx.get(), nss.ns());
+    auto iter = collectionReader.makeIterator();
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1 << "x" << 2), unittest::assertGet(iter->next()).first);
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, iter->next().getStatus());
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyIgnoresUpdateOperationIfDocumentIsMissingFromSyncSource) {
     BSONObj emptyDoc;
     SyncTailWithLocalDocumentFetcher syncTail(emptyDoc);
@@ -34,6 +34,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/session_catalog.h"
 #include "mongo/db/transactions_stats_gen.h"
 
 namespace mongo {
@@ -82,6 +83,7 @@ public:
                                     const BSONElement& configElement) const {
         TransactionsStats stats;
         RetryableWritesStats::get(opCtx)->updateStats(&stats);
+        SessionCatalog::get(opCtx)->updateStats(&stats);
         return stats.toBSON();
     }
 
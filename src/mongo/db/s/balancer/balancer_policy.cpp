@@ -32,6 +32,7 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -45,6 +46,14 @@ using std::set;
 using std::string;
 using std::vector;
 
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadImbalanceRatio, double, 0.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "balancerLoadImbalanceRatio must be non-negative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 // These values indicate the minimum deviation shard's number of chunks need to have from the
@@ -432,6 +441,17 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                                   &migrations,
                                   usedShards))
             ;
+
+        // 4) for each tag balanced by chunk count, balance the load
+        if (balancerLoadImbalanceRatio.load() > 0) {
+            _singleZoneLoadBalance(shardStats,
+                                   distribution,
+                                   tag,
+                                   idealNumberOfChunksPerShardForTag,
+                                   imbalanceThreshold,
+                                   &migrations,
+                                   usedShards);
+        }
     }
 
     return migrations;
@@ -524,6 +544,99 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            const string& tag,
+                                            size_t idealNumberOfChunksPerShardForTag,
+                                            size_t imbalanceThreshold,
+                                            vector<MigrateInfo>* migrations,
+                                            set<ShardId>* usedShards) {
+    double totalSizeMB = 0;
+    double totalOpsPerSec = 0;
+    size_t numShards = 0;
+
+    for (const auto& stat : shardStats) {
+        if (stat.isDraining || !(tag.empty() || stat.shardTags.count(tag)))
+            continue;
+
+        totalSizeMB += stat.currSizeMB;
+        totalOpsPerSec += stat.opsPerSec;
+        numShards++;
+    }
+
+    if (numShards < 2 || (totalSizeMB == 0 && totalOpsPerSec == 0))
+        return false;
+
+    const auto loadOf = [&](const ClusterStatistics::ShardStatistics& stat) {
+        return (totalSizeMB ? stat.currSizeMB / totalSizeMB : 0) +
+            (totalOpsPerSec ? stat.opsPerSec / totalOpsPerSec : 0);
+    };
+
+    // Every shard has the same share of the zone's total load when it is perfectly balanced
+    const double averageLoad =
+        ((totalSizeMB ? 1 : 0) + (totalOpsPerSec ? 1 : 0)) / double(numShards);
+
+    const ClusterStatistics::ShardStatistics* from = nullptr;
+    const ClusterStatistics::ShardStatistics* to = nullptr;
+
+    for (const auto& stat : shardStats) {
+        if (stat.isDraining || !(tag.empty() || stat.shardTags.count(tag)))
+            continue;
+
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        if (!from || loadOf(stat) > loadOf(*from)) {
+            from = &stat;
+        }
+
+        if (isShardSuitableReceiver(stat, tag).isOK() && (!to || loadOf(stat) < loadOf(*to))) {
+            to = &stat;
+        }
+    }
+
+    if (!from || !to || from == to)
+        return false;
+
+    const double maxLoad = loadOf(*from);
+    const double minLoad = loadOf(*to);
+
+    if (maxLoad <= averageLoad * (1 + balancerLoadImbalanceRatio.load()) || minLoad >= averageLoad)
+        return false;
+
+    // Do not give the receiver so many chunks that balancing by chunk count would move them back
+    const size_t receiverChunks = distribution.numberOfChunksInShardWithTag(to->shardId, tag);
+    if (receiverChunks + 1 >= idealNumberOfChunksPerShardForTag + imbalanceThreshold)
+        return false;
+
+    // Nor take so many from the donor that balancing by chunk count would give them back to it
+    const size_t donorChunks = distribution.numberOfChunksInShardWithTag(from->shardId, tag);
+    if (donorChunks == 0 ||
+        donorChunks - 1 + imbalanceThreshold <= idealNumberOfChunksPerShardForTag)
+        return false;
+
+    LOG(1) << "collection : " << distribution.nss().ns();
+    LOG(1) << "zone       : " << tag;
+    LOG(1) << "donor      : " << from->shardId << " load " << maxLoad;
+    LOG(1) << "receiver   : " << to->shardId << " load " << minLoad;
+    LOG(1) << "average    : " << averageLoad;
+
+    for (const auto& chunk : distribution.getChunks(from->shardId)) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo())
+            continue;
+
+        migrations->emplace_back(to->shardId, chunk);
+        invariant(usedShards->insert(from->shardId).second);
+        invariant(usedShards->insert(to->shardId).second);
+        return true;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
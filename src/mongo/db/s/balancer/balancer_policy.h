@@ -36,11 +36,17 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/platform/atomic_proxy.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_id.h"
 
 namespace mongo {
 
+// When greater than 0, the balancer also moves chunks off a shard whose share of the data size and
+// operation rate of a zone exceeds the average share by more than this fraction. 0 by default,
+// meaning that shards are balanced by chunk count only.
+extern AtomicDouble balancerLoadImbalanceRatio;
+
 struct ZoneRange {
     ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone);
 
@@ -184,6 +190,10 @@ public:
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
      *
+     * If balancerLoadImbalanceRatio is set, once a zone is balanced by chunk count, a chunk may
+     * also be moved from the shard which carries the most load in the zone to the one which carries
+     * the least, as long as the chunk counts stay balanced.
+     *
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
      * shard.
@@ -239,6 +249,23 @@ private:
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * Selects at most one chunk for the specified zone to be moved from the shard carrying the most
+     * load to the shard carrying the least, if the former exceeds the zone's average load by more
+     * than balancerLoadImbalanceRatio. A shard's load is the sum of its shares of the zone's total
+     * data size and operation rate. The move is only suggested if it leaves the receiver below the
+     * chunk count at which _singleZoneBalance would move the chunk back.
+     *
+     * Returns true if a migration was suggested, false otherwise.
+     */
+    static bool _singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                       const DistributionStatus& distribution,
+                                       const std::string& tag,
+                                       size_t idealNumberOfChunksPerShardForTag,
+                                       size_t imbalanceThreshold,
+                                       std::vector<MigrateInfo>* migrations,
+                                       std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -609,6 +610,81 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+ShardStatistics makeShardStatsWithLoad(const ShardId& shardId, uint64_t sizeMB, double opsPerSec) {
+    ShardStatistics stats(shardId, kNoMaxSize, sizeMB, false, emptyTagSet, emptyShardVersion);
+    stats.opsPerSec = opsPerSec;
+    return stats;
+}
+
+TEST(BalancerPolicy, LoadImbalanceIsIgnoredByDefault) {
+    auto cluster = generateCluster({{makeShardStatsWithLoad(kShardId0, 100, 400), 10},
+                                    {makeShardStatsWithLoad(kShardId1, 50, 100), 10},
+                                    {makeShardStatsWithLoad(kShardId2, 50, 100), 10}});
+
+    ASSERT(balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadImbalanceMovesChunkOffHotShard) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    balancerLoadImbalanceRatio.store(0.5);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+
+    auto cluster = generateCluster({{makeShardStatsWithLoad(kShardId0, 100, 400), 10},
+                                    {makeShardStatsWithLoad(kShardId1, 50, 100), 10},
+                                    {makeShardStatsWithLoad(kShardId2, 50, 100), 10}});
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, LoadImbalanceWithinRatioIsNotBalanced) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    balancerLoadImbalanceRatio.store(0.5);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+
+    auto cluster = generateCluster({{makeShardStatsWithLoad(kShardId0, 60, 120), 10},
+                                    {makeShardStatsWithLoad(kShardId1, 50, 100), 10},
+                                    {makeShardStatsWithLoad(kShardId2, 50, 100), 10}});
+
+    ASSERT(balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadImbalanceDoesNotUnbalanceChunkCounts) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    balancerLoadImbalanceRatio.store(0.5);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+
+    // Giving the cold shard another chunk would make it a donor when balancing by chunk count
+    auto cluster = generateCluster({{makeShardStatsWithLoad(kShardId0, 100, 400), 2},
+                                    {makeShardStatsWithLoad(kShardId1, 50, 100), 2},
+                                    {makeShardStatsWithLoad(kShardId2, 50, 100), 2}});
+
+    ASSERT(balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadImbalanceDoesNotTakeDonorBelowChunkCount) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    balancerLoadImbalanceRatio.store(0.5);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+
+    // Taking a chunk from the hot shard would leave it short enough of the ideal count for
+    // balancing by chunk count to give chunks back to it
+    auto cluster = generateCluster({{makeShardStatsWithLoad(kShardId0, 100, 400), 9},
+                                    {makeShardStatsWithLoad(kShardId1, 50, 100), 10},
+                                    {makeShardStatsWithLoad(kShardId2, 50, 100), 11}});
+
+    ASSERT(balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -72,6 +72,9 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    if (opsPerSec > 0) {
+        builder.append("opsPerSec", opsPerSec);
+    }
     return builder.obj();
 }
 
@@ -92,6 +92,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // The number of operations per second served by this shard's primary since the previous
+        // time statistics were collected. Zero if the rate is not known.
+        double opsPerSec{0};
     };
 
     virtual ~ClusterStatistics();
@@ -37,6 +37,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/db/s/balancer/balancer_policy.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
@@ -48,16 +49,15 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns the serverStatus response or an error. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -78,15 +78,21 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
-    if (!status.isOK()) {
-        return status;
+/**
+ * Returns the total number of operations of all kinds which the 'serverStatus' response reports
+ * the node has served since it started.
+ */
+long long totalOpCount(const BSONObj& serverStatus) {
+    long long total = 0;
+    for (const auto& counter : serverStatus[kOpCountersField].Obj()) {
+        if (counter.isNumber()) {
+            total += counter.safeNumberLong();
+        }
     }
-
-    return version;
+    return total;
 }
 
 }  // namespace
@@ -97,6 +103,29 @@ ClusterStatisticsImpl::ClusterStatisticsImpl(BalancerRandomSource& random) : _ra
 
 ClusterStatisticsImpl::~ClusterStatisticsImpl() = default;
 
+double ClusterStatisticsImpl::_updateOpsPerSec(const ShardId& shardId,
+                                               long long opCount,
+                                               Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _lastOpCounts.find(shardId);
+    if (it == _lastOpCounts.end()) {
+        _lastOpCounts.emplace(shardId, std::make_pair(opCount, now));
+        return 0;
+    }
+
+    const auto lastOpCount = it->second.first;
+    const auto elapsed = now - it->second.second;
+    it->second = std::make_pair(opCount, now);
+
+    // The counters restart from zero when the shard's primary changes or restarts.
+    if (opCount < lastOpCount || elapsed <= Milliseconds(0)) {
+        return 0;
+    }
+
+    return static_cast<double>(opCount - lastOpCount) * 1000 / durationCount<Milliseconds>(elapsed);
+}
+
 StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationContext* opCtx) {
     // Get a list of all the shards that are participating in this balance round along with any
     // maximum allowed quotas and current utilization. We get the latter by issuing
@@ -115,9 +144,13 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
 
     std::vector<ShardStatistics> stats;
 
+    // Load-aware balancing compares the data sizes of the shards, so they are needed even for
+    // shards without a maximum size.
+    const bool needShardSizes = balancerLoadImbalanceRatio.load() > 0;
+
     for (const auto& shard : shards) {
         const auto shardSizeStatus = [&]() -> StatusWith<long long> {
-            if (!shard.getMaxSizeMB()) {
+            if (!shard.getMaxSizeMB() && !needShardSizes) {
                 return 0;
             }
 
@@ -133,15 +166,27 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        double opsPerSec = 0;
+
+        // Since the mongod version is only used for reporting and the operation rate only refines
+        // balancing, there is no need to fail the entire round if they cannot be retrieved, so just
+        // leave them empty
+        auto serverStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatus.isOK()) {
+            auto versionStatus =
+                bsonExtractStringField(serverStatus.getValue(), kVersionField, &mongoDVersion);
+            if (!versionStatus.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(versionStatus);
+            }
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
+            if (serverStatus.getValue()[kOpCountersField].type() == Object) {
+                opsPerSec = _updateOpsPerSec(
+                    shard.getName(), totalOpCount(serverStatus.getValue()), Date_t::now());
+            }
         } else {
-            // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(serverStatus.getStatus());
         }
 
         std::set<std::string> shardTags;
@@ -156,6 +201,7 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().opsPerSec = opsPerSec;
     }
 
     return stats;
@@ -28,8 +28,12 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -46,8 +50,21 @@ public:
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
 
 private:
+    /**
+     * Records that the primary of 'shardId' had served 'opCount' operations in total as of 'now'
+     * and returns its rate of operations per second since the previous call for that shard, or zero
+     * if there was no previous call.
+     */
+    double _updateOpsPerSec(const ShardId& shardId, long long opCount, Date_t now);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Protects '_lastOpCounts'.
+    stdx::mutex _mutex;
+
+    // The total operation count last reported by each shard's primary and when it was reported.
+    std::map<ShardId, std::pair<long long, Date_t>> _lastOpCounts;
 };
 
 }  // namespace mongo
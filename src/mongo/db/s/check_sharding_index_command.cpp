@@ -149,13 +149,21 @@ public:
         // NOTE A local copy of 'missingField' is made because indices may be
         // invalidated during a db lock yield.
         BSONObj missingFieldObj = IndexLegacy::getMissingField(opCtx, collection, idx->infoObj());
-        BSONElement missingField = missingFieldObj.firstElement();
 
         // for now, the only check is that all shard keys are filled
         // a 'missingField' valued index key is ok if the field is present in the document,
         // TODO if $exist for nulls were picking the index, it could be used instead efficiently
         int keyPatternLength = keyPattern.nFields();
 
+        // A compound hashed index represents a missing field differently in each position, so
+        // 'missingFieldObj' has one element per index field. Otherwise its single element
+        // applies to every position.
+        std::vector<BSONElement> missingFields(keyPatternLength, missingFieldObj.firstElement());
+        BSONObjIterator missingIt(missingFieldObj);
+        for (int k = 0; k < keyPatternLength && missingIt.more(); k++) {
+            missingFields[k] = missingIt.next();
+        }
+
         RecordId loc;
         BSONObj currKey;
         PlanExecutor::ExecState state;
@@ -173,7 +181,7 @@ public:
                 const StringData::ComparatorInterface* stringComparator = nullptr;
                 BSONElementComparator eltCmp(BSONElementComparator::FieldNamesMode::kIgnore,
                                              stringComparator);
-                if (!currKeyElt.eoo() && eltCmp.evaluate(currKeyElt != missingField))
+                if (!currKeyElt.eoo() && eltCmp.evaluate(currKeyElt != missingFields[k]))
                     continue;
 
                 // This is a fetch, but it's OK.  The underlying code won't throw a page fault
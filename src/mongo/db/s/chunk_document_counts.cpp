@@ -0,0 +1,203 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_document_counts.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/s/shard_key_pattern.h"
+
+namespace mongo {
+
+boost::optional<long long> ChunkDocumentCounts::getOwnedCount(
+    const CollectionMetadata& metadata) const {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    if (!_shardVersion || !_shardVersion->isStrictlyEqualTo(metadata.getShardVersion()))
+        return boost::none;
+
+    if (_chunkCounts.size() != _numOwnedChunks)
+        return boost::none;
+
+    return _total;
+}
+
+std::vector<ChunkRange> ChunkDocumentCounts::getUncountedChunks(
+    const CollectionMetadata& metadata) {
+    const auto chunks = metadata.getChunks();
+
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    if (!_shardVersion) {
+        _shardVersion = metadata.getShardVersion();
+        _numOwnedChunks = chunks.size();
+    } else if (!_shardVersion->isStrictlyEqualTo(metadata.getShardVersion())) {
+        return {};
+    }
+
+    std::vector<ChunkRange> uncounted;
+    for (const auto& chunk : chunks) {
+        if (!_chunkCounts.count(metadata.encodeKey(chunk.first))) {
+            uncounted.emplace_back(chunk.first, chunk.second);
+        }
+    }
+
+    return uncounted;
+}
+
+bool ChunkDocumentCounts::setChunkCount(const CollectionMetadata& metadata,
+                                        const ChunkRange& chunk,
+                                        long long count) {
+    auto minKeyString = metadata.encodeKey(chunk.getMin());
+    auto maxKeyString = metadata.encodeKey(chunk.getMax());
+
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    if (!_shardVersion || !_shardVersion->isStrictlyEqualTo(metadata.getShardVersion()))
+        return false;
+
+    auto& chunkCount = _chunkCounts[std::move(minKeyString)];
+    _total += count - chunkCount.count;
+    chunkCount = {std::move(maxKeyString), count};
+    return true;
+}
+
+void ChunkDocumentCounts::onWrite(OperationContext* opCtx,
+                                  const CollectionMetadata& metadata,
+                                  const std::vector<BSONObj>& docs,
+                                  long long delta) {
+    {
+        // Counts only appear while writers are locked out, so if there are none now, there will be
+        // none to adjust when this write commits either
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+        if (_chunkCounts.empty())
+            return;
+    }
+
+    const auto& shardKeyPattern = metadata.getChunkManager()->getShardKeyPattern();
+
+    std::vector<std::string> keyStrings;
+    keyStrings.reserve(docs.size());
+    for (const auto& doc : docs) {
+        auto shardKey = shardKeyPattern.extractShardKeyFromDoc(doc);
+        if (shardKey.isEmpty()) {
+            clear();
+            return;
+        }
+
+        keyStrings.push_back(metadata.encodeKey(shardKey));
+    }
+
+    // The writer holds its collection lock until after the commit, so the chunk counts this
+    // applies to cannot be recounted or carried over to new metadata in between.
+    opCtx->recoveryUnit()->onCommit(
+        [ this, keyStrings = std::move(keyStrings), delta ](boost::optional<Timestamp>) {
+            _applyDeltas(keyStrings, delta);
+        });
+}
+
+void ChunkDocumentCounts::onMetadataRefresh(const CollectionMetadata* metadata) {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    if (!_shardVersion)
+        return;
+
+    if (!metadata || _shardVersion->epoch() != metadata->getCollVersion().epoch()) {
+        _clear(lg);
+        return;
+    }
+
+    if (_shardVersion->isStrictlyEqualTo(metadata->getShardVersion()))
+        return;
+
+    const auto chunks = metadata->getChunks();
+
+    std::map<std::string, ChunkCount> chunkCounts;
+    long long total = 0;
+
+    for (const auto& chunk : chunks) {
+        auto minKeyString = metadata->encodeKey(chunk.first);
+        auto maxKeyString = metadata->encodeKey(chunk.second);
+
+        // Sum the counted chunks which tile this one exactly: a single unchanged chunk, or the
+        // chunks it was merged from
+        long long count = 0;
+        StringData reached(minKeyString);
+        auto it = _chunkCounts.find(minKeyString);
+        while (reached < maxKeyString && it != _chunkCounts.end() && it->first == reached) {
+            count += it->second.count;
+            reached = it->second.max;
+            ++it;
+        }
+
+        if (reached != maxKeyString)
+            continue;
+
+        chunkCounts.emplace(std::move(minKeyString), ChunkCount{std::move(maxKeyString), count});
+        total += count;
+    }
+
+    _shardVersion = metadata->getShardVersion();
+    _numOwnedChunks = chunks.size();
+    _chunkCounts = std::move(chunkCounts);
+    _total = total;
+}
+
+void ChunkDocumentCounts::clear() {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    _clear(lg);
+}
+
+void ChunkDocumentCounts::_clear(WithLock) {
+    _shardVersion = boost::none;
+    _numOwnedChunks = 0;
+    _chunkCounts.clear();
+    _total = 0;
+}
+
+void ChunkDocumentCounts::_applyDeltas(const std::vector<std::string>& keyStrings,
+                                       long long delta) {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    for (const auto& keyString : keyStrings) {
+        // The last chunk starting at or before the key is the only one which may contain it
+        auto it = _chunkCounts.upper_bound(keyString);
+        if (it == _chunkCounts.begin())
+            continue;
+
+        --it;
+        if (keyString < it->second.max) {
+            it->second.count += delta;
+            _total += delta;
+        }
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class CollectionMetadata;
+class OperationContext;
+
+/**
+ * Keeps the number of documents in each chunk this shard owns, so that an unfiltered count of a
+ * sharded collection can be answered without scanning it and without counting orphans or the
+ * documents of chunks still being migrated in.
+ *
+ * Only owned chunks are counted. Documents written to other ranges, such as those cloned by an
+ * incoming migration or removed by the range deleter, fall outside every counted chunk and are
+ * ignored. Tracking starts with the first call to getUncountedChunks and stops when the collection
+ * becomes unsharded or is dropped.
+ *
+ * Synchronization rules: a chunk's count must be recorded while holding the collection lock in a
+ * mode which excludes writers (S or X), and metadata refreshes must hold the collection X lock.
+ * Writes adjust the counts when they commit, while still holding their intent lock, so a count is
+ * never adjusted for a write it already includes.
+ */
+class ChunkDocumentCounts {
+    MONGO_DISALLOW_COPYING(ChunkDocumentCounts);
+
+public:
+    ChunkDocumentCounts() = default;
+
+    /**
+     * Returns the number of documents in the chunks 'metadata' assigns to this shard, or
+     * boost::none if the counts were not tracked for this version of the metadata or some of its
+     * chunks have not been counted yet.
+     */
+    boost::optional<long long> getOwnedCount(const CollectionMetadata& metadata) const;
+
+    /**
+     * Starts tracking counts for 'metadata' if they are not tracked yet, and returns the owned
+     * chunks which have no count. Returns an empty vector if the counts are tracked for a
+     * different version of the metadata.
+     */
+    std::vector<ChunkRange> getUncountedChunks(const CollectionMetadata& metadata);
+
+    /**
+     * Records that the owned chunk 'chunk' holds 'count' documents. Returns false, and records
+     * nothing, if 'metadata' is not the version of the metadata the counts are tracked for.
+     */
+    bool setChunkCount(const CollectionMetadata& metadata,
+                       const ChunkRange& chunk,
+                       long long count);
+
+    /**
+     * Adds 'delta' to the counts of the chunks containing each of 'docs' when the current
+     * WriteUnitOfWork of 'opCtx' commits. A document without the shard key fields, which can only
+     * be written directly to the shard, stops tracking altogether, because the chunk its index key
+     * falls in is not known here.
+     */
+    void onWrite(OperationContext* opCtx,
+                 const CollectionMetadata& metadata,
+                 const std::vector<BSONObj>& docs,
+                 long long delta);
+
+    /**
+     * Carries the counts over to 'metadata', which is null if the collection became unsharded.
+     * Chunks which are unchanged, or which are exactly the merge of counted chunks, keep their
+     * count. Split chunks and chunks which were migrated in must be counted again, and the counts
+     * of chunks which were migrated out are dropped.
+     */
+    void onMetadataRefresh(const CollectionMetadata* metadata);
+
+    /**
+     * Stops tracking and drops all counts.
+     */
+    void clear();
+
+private:
+    struct ChunkCount {
+        // KeyString encoding of the chunk's exclusive upper bound
+        std::string max;
+
+        long long count{0};
+    };
+
+    void _clear(WithLock);
+
+    void _applyDeltas(const std::vector<std::string>& keyStrings, long long delta);
+
+    mutable stdx::mutex _mutex;
+
+    // Shard version of the metadata the counts are tracked for, or boost::none if they are not
+    // being tracked
+    boost::optional<ChunkVersion> _shardVersion;
+
+    // Number of chunks owned under '_shardVersion'. The counts are complete when every one of them
+    // has an entry in '_chunkCounts'.
+    size_t _numOwnedChunks{0};
+
+    // Counted chunks, keyed by the KeyString encoding of their inclusive lower bound
+    std::map<std::string, ChunkCount> _chunkCounts;
+
+    // Sum of the counts in '_chunkCounts'
+    long long _total{0};
+};
+
+}  // namespace mongo
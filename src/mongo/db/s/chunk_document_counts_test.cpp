@@ -0,0 +1,257 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_document_counts.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/shard_server_op_observer.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const KeyPattern kShardKeyPattern(BSON("a" << 1));
+const ShardId kThisShard("thisShard");
+const ShardId kOtherShard("otherShard");
+
+ChunkRange range(int min, int max) {
+    return {BSON("a" << min), BSON("a" << max)};
+}
+
+/**
+ * Returns metadata in which this shard owns 'ownedChunks', which must be sorted, and another shard
+ * owns the rest of the key space. Chunk versions start at 'majorVersion'.
+ */
+std::unique_ptr<CollectionMetadata> makeMetadata(const OID& epoch,
+                                                 int majorVersion,
+                                                 const std::vector<ChunkRange>& ownedChunks) {
+    std::vector<ChunkType> allChunks;
+    ChunkVersion version(majorVersion, 0, epoch);
+    auto nextMinKey = kShardKeyPattern.globalMin();
+    for (const auto& chunk : ownedChunks) {
+        if (SimpleBSONObjComparator::kInstance.evaluate(nextMinKey < chunk.getMin())) {
+            allChunks.emplace_back(
+                kNss, ChunkRange{nextMinKey, chunk.getMin()}, version, kOtherShard);
+            version.incMajor();
+        }
+        allChunks.emplace_back(kNss, chunk, version, kThisShard);
+        version.incMajor();
+        nextMinKey = chunk.getMax();
+    }
+    allChunks.emplace_back(
+        kNss, ChunkRange{nextMinKey, kShardKeyPattern.globalMax()}, version, kOtherShard);
+
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), kShardKeyPattern, nullptr, false, epoch, allChunks);
+    auto cm = std::make_shared<ChunkManager>(rt, boost::none);
+    return stdx::make_unique<CollectionMetadata>(cm, kThisShard);
+}
+
+class ChunkDocumentCountsTest : public ShardServerTestFixture {
+protected:
+    /**
+     * Counts every uncounted chunk of 'metadata' as holding as many documents as its lower bound.
+     */
+    void countAll(const CollectionMetadata& metadata) {
+        for (const auto& chunk : _counts.getUncountedChunks(metadata)) {
+            ASSERT(_counts.setChunkCount(metadata, chunk, chunk.getMin()["a"].numberLong()));
+        }
+    }
+
+    /**
+     * Writes documents with the given shard key values in a WriteUnitOfWork, which commits only if
+     * 'commit' is true.
+     */
+    void write(const CollectionMetadata& metadata,
+               const std::vector<int>& keys,
+               long long delta,
+               bool commit = true) {
+        std::vector<BSONObj> docs;
+        for (int key : keys) {
+            docs.push_back(BSON("_id" << OID::gen() << "a" << key));
+        }
+
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IX);
+        WriteUnitOfWork wuow(operationContext());
+        _counts.onWrite(operationContext(), metadata, docs, delta);
+        if (commit) {
+            wuow.commit();
+        }
+    }
+
+    const OID _epoch = OID::gen();
+    ChunkDocumentCounts _counts;
+};
+
+TEST_F(ChunkDocumentCountsTest, OwnedCountIsKnownOnceEveryChunkIsCounted) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20), range(30, 40)});
+    ASSERT(!_counts.getOwnedCount(*metadata));
+
+    auto uncounted = _counts.getUncountedChunks(*metadata);
+    ASSERT_EQ(2U, uncounted.size());
+    ASSERT(_counts.setChunkCount(*metadata, uncounted[0], 5));
+    ASSERT(!_counts.getOwnedCount(*metadata));
+
+    uncounted = _counts.getUncountedChunks(*metadata);
+    ASSERT_EQ(1U, uncounted.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 30), uncounted[0].getMin());
+    ASSERT(_counts.setChunkCount(*metadata, uncounted[0], 7));
+    ASSERT_EQ(12, *_counts.getOwnedCount(*metadata));
+}
+
+TEST_F(ChunkDocumentCountsTest, NoOwnedChunksCountsZero) {
+    auto metadata = makeMetadata(_epoch, 1, {});
+    ASSERT(_counts.getUncountedChunks(*metadata).empty());
+    ASSERT_EQ(0, *_counts.getOwnedCount(*metadata));
+}
+
+TEST_F(ChunkDocumentCountsTest, CommittedWritesToOwnedChunksAdjustTheCount) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20), range(30, 40)});
+    countAll(*metadata);
+    ASSERT_EQ(40, *_counts.getOwnedCount(*metadata));
+
+    write(*metadata, {10, 19, 35}, 1);
+    ASSERT_EQ(43, *_counts.getOwnedCount(*metadata));
+
+    write(*metadata, {30}, -1);
+    ASSERT_EQ(42, *_counts.getOwnedCount(*metadata));
+
+    // Orphans, documents of chunks being migrated in, and writes which roll back don't count
+    write(*metadata, {0, 20, 25, 40, 100}, 1);
+    write(*metadata, {0, 25}, -1);
+    write(*metadata, {15}, 1, false);
+    ASSERT_EQ(42, *_counts.getOwnedCount(*metadata));
+}
+
+TEST_F(ChunkDocumentCountsTest, DocumentWithoutShardKeyStopsTracking) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20)});
+    countAll(*metadata);
+
+    AutoGetCollection autoColl(operationContext(), kNss, MODE_IX);
+    WriteUnitOfWork wuow(operationContext());
+    _counts.onWrite(operationContext(), *metadata, {BSON("_id" << 1)}, 1);
+    wuow.commit();
+
+    ASSERT(!_counts.getOwnedCount(*metadata));
+    ASSERT_EQ(1U, _counts.getUncountedChunks(*metadata).size());
+}
+
+TEST_F(ChunkDocumentCountsTest, RefreshKeepsUnchangedAndMergedChunks) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20), range(20, 30), range(40, 50)});
+    countAll(*metadata);
+    ASSERT_EQ(70, *_counts.getOwnedCount(*metadata));
+
+    auto merged = makeMetadata(_epoch, 10, {range(10, 30), range(40, 50)});
+    _counts.onMetadataRefresh(merged.get());
+    ASSERT(!_counts.getOwnedCount(*metadata));
+    ASSERT_EQ(70, *_counts.getOwnedCount(*merged));
+}
+
+TEST_F(ChunkDocumentCountsTest, RefreshDropsSplitAndMigratedChunks) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20), range(40, 50)});
+    countAll(*metadata);
+
+    // [40, 50) is split, [10, 20) is migrated out and [60, 70) is migrated in
+    auto refreshed = makeMetadata(_epoch, 10, {range(40, 45), range(45, 50), range(60, 70)});
+    _counts.onMetadataRefresh(refreshed.get());
+    ASSERT(!_counts.getOwnedCount(*refreshed));
+
+    auto uncounted = _counts.getUncountedChunks(*refreshed);
+    ASSERT_EQ(3U, uncounted.size());
+
+    countAll(*refreshed);
+    ASSERT_EQ(40 + 45 + 60, *_counts.getOwnedCount(*refreshed));
+}
+
+TEST_F(ChunkDocumentCountsTest, StaleMetadataIsIgnored) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20)});
+    countAll(*metadata);
+
+    auto newer = makeMetadata(_epoch, 10, {range(10, 15), range(15, 20)});
+    _counts.onMetadataRefresh(newer.get());
+
+    ASSERT(_counts.getUncountedChunks(*metadata).empty());
+    ASSERT(!_counts.setChunkCount(*metadata, range(10, 20), 10));
+    ASSERT(!_counts.getOwnedCount(*metadata));
+}
+
+TEST_F(ChunkDocumentCountsTest, EpochChangeOrUnshardingStopsTracking) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20)});
+    countAll(*metadata);
+
+    auto recreated = makeMetadata(OID::gen(), 1, {range(10, 20)});
+    _counts.onMetadataRefresh(recreated.get());
+    ASSERT(!_counts.getOwnedCount(*recreated));
+
+    countAll(*recreated);
+    ASSERT_EQ(10, *_counts.getOwnedCount(*recreated));
+
+    _counts.onMetadataRefresh(nullptr);
+    ASSERT(!_counts.getOwnedCount(*recreated));
+}
+
+TEST_F(ChunkDocumentCountsTest, ReplicationRollbackClearsTheCounts) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20)});
+    AutoGetCollection autoColl(operationContext(), kNss, MODE_IX);
+    auto& counts = CollectionShardingState::get(operationContext(), kNss)->getChunkDocumentCounts();
+    for (const auto& chunk : counts.getUncountedChunks(*metadata)) {
+        ASSERT(counts.setChunkCount(*metadata, chunk, 10));
+    }
+    ASSERT_EQ(10, *counts.getOwnedCount(*metadata));
+
+    ShardServerOpObserver().onReplicationRollback(operationContext(),
+                                                  OpObserver::RollbackObserverInfo{});
+    ASSERT(!counts.getOwnedCount(*metadata));
+    ASSERT_EQ(1U, counts.getUncountedChunks(*metadata).size());
+}
+
+TEST_F(ChunkDocumentCountsTest, StepDownClearsTheCounts) {
+    auto metadata = makeMetadata(_epoch, 1, {range(10, 20)});
+    AutoGetCollection autoColl(operationContext(), kNss, MODE_IX);
+    auto& counts = CollectionShardingState::get(operationContext(), kNss)->getChunkDocumentCounts();
+    for (const auto& chunk : counts.getUncountedChunks(*metadata)) {
+        ASSERT(counts.setChunkCount(*metadata, chunk, 10));
+    }
+    ASSERT_EQ(10, *counts.getOwnedCount(*metadata));
+
+    // This is what the replication coordinator's sharding stepdown hook calls on a shard.
+    CollectionShardingState::clearAllChunkDocumentCounts(getServiceContext());
+    ASSERT(!counts.getOwnedCount(*metadata));
+    ASSERT_EQ(1U, counts.getUncountedChunks(*metadata).size());
+}
+
+}  // namespace
+}  // namespace mongo
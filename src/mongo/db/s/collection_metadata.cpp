@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/collection_metadata.h"
 
+#include <algorithm>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -48,6 +50,77 @@ CollectionMetadata::CollectionMetadata(std::shared_ptr<ChunkManager> cm, const S
     invariant(_cm->getVersion() >= getShardVersion());
 }
 
+void CollectionMetadata::_buildOwnedRanges() const {
+    // Appends the chunk [min, max) to 'ranges', merging it into the last range if they are adjacent
+    auto appendRange = [](std::vector<OwnedRange>* ranges, std::string min, std::string max) {
+        if (!ranges->empty() && ranges->back().max == min) {
+            ranges->back().max = std::move(max);
+            return;
+        }
+        ranges->push_back({std::move(min), std::move(max)});
+    };
+
+    for (const auto& chunk : _cm->chunks()) {
+        auto minKeyString = _cm->extractKeyString(chunk.getMin());
+        auto maxKeyString = _cm->extractKeyString(chunk.getMax());
+
+        // Only the chunk manager resolves a chunk's owner at its cluster time
+        bool owned;
+        try {
+            owned = _cm->keyBelongsToShard(chunk.getMin(), _thisShardId);
+        } catch (const ExceptionFor<ErrorCodes::StaleChunkHistory>& ex) {
+            appendRange(&_staleRanges, std::move(minKeyString), std::move(maxKeyString));
+            _staleChunkHistoryStatus = ex.toStatus();
+            continue;
+        }
+
+        if (owned) {
+            appendRange(&_ownedRanges, std::move(minKeyString), std::move(maxKeyString));
+        }
+    }
+}
+
+const CollectionMetadata::OwnedRange* CollectionMetadata::_findRange(
+    const std::vector<OwnedRange>& ranges, StringData keyString) {
+    // The first range whose max is beyond the key is the only one which may contain it
+    const auto it = std::upper_bound(
+        ranges.begin(), ranges.end(), keyString, [](StringData key, const OwnedRange& range) {
+            return key < StringData(range.max);
+        });
+
+    if (it == ranges.end() || !it->contains(keyString))
+        return nullptr;
+
+    return &*it;
+}
+
+bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
+    if (key.isEmpty())
+        return false;
+
+    return findOwnedRange(encodeKey(key)) != nullptr;
+}
+
+const CollectionMetadata::OwnedRange* CollectionMetadata::findOwnedRange(
+    StringData keyString) const {
+    if (!_ownedRangesBuilt.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_ownedRangesMutex);
+        if (!_ownedRangesBuilt.load()) {
+            _buildOwnedRanges();
+            _ownedRangesBuilt.store(true);
+        }
+    }
+
+    if (const auto ownedRange = _findRange(_ownedRanges, keyString))
+        return ownedRange;
+
+    // Only keys in a chunk whose owner is unknown at the cluster time fail the lookup
+    if (_findRange(_staleRanges, keyString))
+        uassertStatusOK(_staleChunkHistoryStatus);
+
+    return nullptr;
+}
+
 RangeMap CollectionMetadata::getChunks() const {
     RangeMap chunksMap(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<BSONObj>());
 
@@ -29,7 +29,9 @@
 #pragma once
 
 #include "mongo/db/range_arithmetic.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/chunk_manager.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -66,10 +68,38 @@ public:
      * Returns true if the document with the given key belongs to this chunkset. If the key is empty
      * returns false. If key is not a valid shard key, the behaviour is undefined.
      */
-    bool keyBelongsToMe(const BSONObj& key) const {
-        return _cm->keyBelongsToShard(key, _thisShardId);
+    bool keyBelongsToMe(const BSONObj& key) const;
+
+    /**
+     * A contiguous range of the shard key space owned by this shard, with both bounds KeyString
+     * encoded by the chunk manager. The range includes 'min' and excludes 'max'.
+     */
+    struct OwnedRange {
+        bool contains(StringData keyString) const {
+            return StringData(min) <= keyString && keyString < StringData(max);
+        }
+
+        std::string min;
+        std::string max;
+    };
+
+    /**
+     * Returns the KeyString encoding of the shard key 'key', suitable for passing to
+     * findOwnedRange. The key must not be empty.
+     */
+    std::string encodeKey(const BSONObj& key) const {
+        return _cm->extractKeyString(key);
     }
 
+    /**
+     * Returns the owned range containing the KeyString encoded shard key 'keyString', or nullptr
+     * if this shard does not own it. The returned range stays valid for as long as this metadata
+     * object, so callers filtering keys which arrive in order can check the last range returned
+     * before searching again. Throws StaleChunkHistory if the key lies in a chunk whose owner at
+     * the chunk manager's cluster time is not known from the chunk's history.
+     */
+    const OwnedRange* findOwnedRange(StringData keyString) const;
+
     /**
      * Given a key 'lookupKey' in the shard key range, get the next chunk which overlaps or is
      * greater than this key.  Returns true if a chunk exists, false otherwise.
@@ -171,6 +201,32 @@ private:
 
     // The identity of this shard, for the purpose of answering "key belongs to me" queries.
     ShardId _thisShardId;
+
+    /**
+     * Fills in '_ownedRanges' and '_staleRanges' from the chunk manager.
+     */
+    void _buildOwnedRanges() const;
+
+    /**
+     * Returns the range of the sorted 'ranges' which contains 'keyString', or nullptr if none does.
+     */
+    static const OwnedRange* _findRange(const std::vector<OwnedRange>& ranges,
+                                        StringData keyString);
+
+    // Guards building the ranges below. They are built on the first ownership lookup rather than
+    // with the metadata, since most metadata is replaced by the next refresh without ever being
+    // used to filter documents, and are never modified afterwards.
+    mutable stdx::mutex _ownedRangesMutex;
+    mutable AtomicWord<bool> _ownedRangesBuilt{false};
+
+    // The ranges owned by this shard, sorted and with adjacent chunks merged.
+    mutable std::vector<OwnedRange> _ownedRanges;
+
+    // The ranges of the chunks whose owner at the chunk manager's cluster time is not known from
+    // their history, sorted and merged like '_ownedRanges', and the StaleChunkHistory error which
+    // lookups of keys in them report.
+    mutable std::vector<OwnedRange> _staleRanges;
+    mutable Status _staleChunkHistoryStatus{Status::OK()};
 };
 
 }  // namespace mongo
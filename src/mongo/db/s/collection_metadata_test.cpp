@@ -357,6 +357,25 @@ TEST_F(ThreeChunkWithRangeGapFixture, KeyBelongsToMe) {
     ASSERT(!makeCollectionMetadata()->keyBelongsToMe(BSONObj()));
 }
 
+TEST_F(ThreeChunkWithRangeGapFixture, FindOwnedRangeMergesAdjacentChunks) {
+    auto metadata(makeCollectionMetadata());
+
+    const auto firstRange = metadata->findOwnedRange(metadata->encodeKey(BSON("a" << 5)));
+    ASSERT(firstRange);
+    ASSERT_EQ(firstRange, metadata->findOwnedRange(metadata->encodeKey(BSON("a" << 15))));
+    ASSERT_EQ(metadata->encodeKey(BSON("a" << MINKEY)), firstRange->min);
+    ASSERT_EQ(metadata->encodeKey(BSON("a" << 20)), firstRange->max);
+
+    const auto lastRange = metadata->findOwnedRange(metadata->encodeKey(BSON("a" << 30)));
+    ASSERT(lastRange);
+    ASSERT_NE(firstRange, lastRange);
+    ASSERT(lastRange->contains(metadata->encodeKey(BSON("a" << 40))));
+    ASSERT(!lastRange->contains(metadata->encodeKey(BSON("a" << 25))));
+
+    ASSERT(!metadata->findOwnedRange(metadata->encodeKey(BSON("a" << 20))));
+    ASSERT(!metadata->findOwnedRange(metadata->encodeKey(BSON("a" << MAXKEY))));
+}
+
 TEST_F(ThreeChunkWithRangeGapFixture, GetNextChunkFromBeginning) {
     ChunkType nextChunk;
     ASSERT(
@@ -48,16 +48,43 @@
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxBatchSize, int, 1024)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterMaxBatchSize must be at least 1");
+        }
+        return Status::OK();
+    });
+
+// How long a batch of range deletions may hold the collection lock before the range deleter
+// considers itself to be competing with the rest of the workload, and backs off.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterTargetBatchTimeMS, int, 50)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterTargetBatchTimeMS must be at least 1");
+        }
+        return Status::OK();
+    });
+
+// How far the majority commit point may trail this node's last applied write before the range
+// deleter slows down. Range deletions must be majority committed before they complete, so deleting
+// faster than the secondaries can apply only adds to the lag.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxReplicationLagSecs, int, 10);
+
 namespace {
 
 using Deletion = CollectionRangeDeleter::Deletion;
@@ -80,6 +107,21 @@ boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& dele
     return boost::none;
 }
 
+/**
+ * Returns how far the majority commit point trails this node's last applied optime, or zero if this
+ * node is not part of a replica set.
+ */
+Seconds majorityReplicationLag(OperationContext* opCtx) {
+    auto const replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+        return Seconds(0);
+    }
+
+    const auto lastAppliedSecs = replCoord->getMyLastAppliedOpTime().getSecs();
+    const auto lastCommittedSecs = replCoord->getLastCommittedOpTime().getSecs();
+    return Seconds(std::max(lastAppliedSecs - lastCommittedSecs, 0LL));
+}
+
 }  // namespace
 
 CollectionRangeDeleter::CollectionRangeDeleter() = default;
@@ -101,6 +143,11 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     auto range = boost::optional<ChunkRange>(boost::none);
     auto notification = DeleteNotification();
 
+    // The first batch of a collection's range deletions is one yield period's worth of documents.
+    int batchSize =
+        std::min(std::max(int(internalQueryExecYieldIterations.load()), 1), maxToDelete);
+    Milliseconds delay(0);
+
     {
         UninterruptibleLockGuard noInterrupt(opCtx->lockState());
         AutoGetCollection autoColl(opCtx, nss, MODE_IX);
@@ -161,6 +208,10 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
             const auto& frontRange = orphans.front().range;
             range.emplace(frontRange.getMin().getOwned(), frontRange.getMax().getOwned());
             notification = orphans.front().notification;
+
+            if (self->_batchSize > 0) {
+                batchSize = std::min(self->_batchSize, maxToDelete);
+            }
         }
 
         invariant(range);
@@ -197,7 +248,18 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
         try {
             const auto keyPattern = scopedCollectionMetadata->getKeyPattern();
-            wrote = self->_doDeletion(opCtx, collection, keyPattern, *range, maxToDelete);
+            Timer batchTimer;
+            wrote = self->_doDeletion(opCtx, collection, keyPattern, *range, batchSize);
+
+            if (wrote.isOK() && wrote.getValue() > 0) {
+                const auto nextBatchSize = paceNextBatch(wrote.getValue(),
+                                                         Milliseconds(batchTimer.millis()),
+                                                         majorityReplicationLag(opCtx),
+                                                         &delay);
+
+                stdx::lock_guard<stdx::mutex> scopedLock(css->_metadataManager->_managerLock);
+                self->_batchSize = nextBatchSize;
+            }
         } catch (const DBException& e) {
             wrote = e.toStatus();
             warning() << e.what();
@@ -272,9 +334,37 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     invariant(wrote.getValue() > 0);
 
     notification.abandon();
+    if (delay > Milliseconds(0)) {
+        LOG(1) << "Pausing range deletion in " << nss.ns() << " for " << delay;
+        return Date_t::now() + delay;
+    }
     return Date_t{};
 }
 
+int CollectionRangeDeleter::paceNextBatch(int lastBatchSize,
+                                          Milliseconds lastBatchTime,
+                                          Seconds replicationLag,
+                                          Milliseconds* delay) {
+    const int maxBatchSize = std::max(rangeDeleterMaxBatchSize.load(), 1);
+    const Milliseconds targetBatchTime(std::max(rangeDeleterTargetBatchTimeMS.load(), 1));
+
+    if (replicationLag > Seconds(rangeDeleterMaxReplicationLagSecs.load())) {
+        *delay = Seconds(1);
+        return std::max(lastBatchSize / 2, 1);
+    }
+
+    if (lastBatchTime > targetBatchTime) {
+        *delay = lastBatchTime;
+        return std::max(lastBatchSize / 2, 1);
+    }
+
+    *delay = Milliseconds(0);
+    if (lastBatchTime * 2 <= targetBatchTime) {
+        return std::min(lastBatchSize * 2, maxBatchSize);
+    }
+    return std::min(lastBatchSize, maxBatchSize);
+}
+
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
                                                     Collection* collection,
                                                     BSONObj const& keyPattern,
@@ -321,16 +411,18 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         saver.emplace("moveChunk", nss.ns(), "cleaning");
     }
 
-    int numDeleted = 0;
-    do {
-        auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
-        auto manual = PlanExecutor::YIELD_MANUAL;
-        auto forward = InternalPlanner::FORWARD;
-        auto fetch = InternalPlanner::IXSCAN_FETCH;
+    auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
+    auto manual = PlanExecutor::YIELD_MANUAL;
+    auto forward = InternalPlanner::FORWARD;
+    auto fetch = InternalPlanner::IXSCAN_FETCH;
 
-        auto exec = InternalPlanner::indexScan(
-            opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
+    // Walk the range with a single index scan for the whole batch, rather than seeking to the
+    // start of the range again for every document.
+    auto exec = InternalPlanner::indexScan(
+        opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
 
+    int numDeleted = 0;
+    do {
         RecordId rloc;
         BSONObj obj;
         PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
@@ -346,6 +438,7 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         }
         invariant(PlanExecutor::ADVANCED == state);
 
+        exec->saveState();
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
             WriteUnitOfWork wuow(opCtx);
             if (saver) {
@@ -354,6 +447,16 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
             collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
             wuow.commit();
         });
+
+        const auto restoreStatus = exec->restoreState();
+        if (!restoreStatus.isOK()) {
+            warning() << "error restoring cursor state while trying to delete " << redact(min)
+                      << " to " << redact(max) << " in " << nss
+                      << ", stats: " << Explain::getWinningPlanStats(exec.get()) << ": "
+                      << redact(restoreStatus);
+            ++numDeleted;
+            break;
+        }
     } while (++numDeleted < maxToDelete);
 
     return numDeleted;
@@ -32,12 +32,16 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+// The largest number of documents the range deleter removes under a single collection lock.
+extern AtomicInt32 rangeDeleterMaxBatchSize;
+
 class BSONObj;
 class Collection;
 class OperationContext;
@@ -169,6 +173,22 @@ public:
                                                     int maxToDelete,
                                                     CollectionRangeDeleter* forTestOnly = nullptr);
 
+    /**
+     * Paces range deletion against the rest of the workload. Given that the last batch deleted
+     * 'lastBatchSize' documents in 'lastBatchTime' while the majority commit point trailed the last
+     * applied optime by 'replicationLag', returns the number of documents to delete in the next
+     * batch and sets 'delay' to how long to wait before deleting them.
+     *
+     * Batches grow while they finish well within rangeDeleterTargetBatchTimeMS and shrink when
+     * they take longer, in which case the deleter also rests for as long as the batch took. While
+     * replication lags by more than rangeDeleterMaxReplicationLagSecs, batches shrink and are one
+     * second apart.
+     */
+    static int paceNextBatch(int lastBatchSize,
+                             Milliseconds lastBatchTime,
+                             Seconds replicationLag,
+                             Milliseconds* delay);
+
 private:
     /**
      * Performs the deletion of up to maxToDelete entries within the range in progress. Must be
@@ -195,6 +215,10 @@ private:
      */
     std::list<Deletion> _orphans;
     std::list<Deletion> _delayedOrphans;
+
+    // The number of documents to delete in the next batch, as chosen by paceNextBatch(). Zero
+    // until the first batch has been deleted.
+    int _batchSize{0};
 };
 
 }  // namespace mongo
@@ -391,5 +391,33 @@ TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     ASSERT_FALSE(next(rangeDeleter, 1));
 }
 
+TEST(CollectionRangeDeleterPacingTest, GrowsQuickBatchesUpToTheMaximum) {
+    Milliseconds delay(-1);
+    ASSERT_EQ(256, CollectionRangeDeleter::paceNextBatch(128, Milliseconds(1), Seconds(0), &delay));
+    ASSERT_EQ(Milliseconds(0), delay);
+
+    const int maxBatchSize = rangeDeleterMaxBatchSize.load();
+    ASSERT_EQ(maxBatchSize,
+              CollectionRangeDeleter::paceNextBatch(
+                  maxBatchSize, Milliseconds(1), Seconds(0), &delay));
+    ASSERT_EQ(Milliseconds(0), delay);
+}
+
+TEST(CollectionRangeDeleterPacingTest, ShrinksAndRestsAfterSlowBatches) {
+    Milliseconds delay(0);
+    ASSERT_EQ(64,
+              CollectionRangeDeleter::paceNextBatch(128, Milliseconds(500), Seconds(0), &delay));
+    ASSERT_EQ(Milliseconds(500), delay);
+
+    ASSERT_EQ(1, CollectionRangeDeleter::paceNextBatch(1, Milliseconds(500), Seconds(0), &delay));
+}
+
+TEST(CollectionRangeDeleterPacingTest, BacksOffWhileReplicationLags) {
+    Milliseconds delay(0);
+    ASSERT_EQ(64,
+              CollectionRangeDeleter::paceNextBatch(128, Milliseconds(1), Seconds(3600), &delay));
+    ASSERT_EQ(Milliseconds(Seconds(1)), delay);
+}
+
 }  // namespace
 }  // namespace mongo
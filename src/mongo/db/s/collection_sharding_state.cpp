@@ -34,9 +34,17 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/keypattern.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/server_parameters.h"
@@ -54,6 +62,62 @@ namespace {
 // How long to wait before starting cleanup of an emigrated chunk range
 MONGO_EXPORT_SERVER_PARAMETER(orphanCleanupDelaySecs, int, 900);  // 900s = 15m
 
+// Whether versioned, unfiltered counts are answered from the per-chunk document counts. The first
+// such count of a collection reads its whole shard key index, in chunk-sized steps which each block
+// writes to the collection, so it is opt-in.
+MONGO_EXPORT_SERVER_PARAMETER(countFromChunkDocumentCounts, bool, false);
+
+/**
+ * Returns the number of documents in 'range' of 'collection', counted from the keys of a shard key
+ * index without fetching the documents.
+ */
+StatusWith<long long> countDocumentsInRange(OperationContext* opCtx,
+                                            Collection* collection,
+                                            const BSONObj& keyPattern,
+                                            const ChunkRange& range) {
+    // A multikey or sparse index does not hold exactly one key per document
+    const bool requireSingleKey = true;
+    const IndexDescriptor* idx = collection->getIndexCatalog()->findShardKeyPrefixedIndex(
+        opCtx, keyPattern, requireSingleKey);
+    if (!idx || idx->isSparse()) {
+        return {ErrorCodes::IndexNotFound,
+                str::stream() << "Unable to find a single-key, non-sparse shard key index for "
+                              << keyPattern.toString()
+                              << " in "
+                              << collection->ns().ns()};
+    }
+
+    // Extend bounds to match the index we found
+    const KeyPattern indexKeyPattern(idx->keyPattern());
+    const auto extend = [&](const auto& key) {
+        return Helpers::toKeyFormat(indexKeyPattern.extendRangeBound(key, false));
+    };
+
+    // Must not yield, since yielding would let writers into the range before its count is recorded
+    auto exec = InternalPlanner::indexScan(opCtx,
+                                           collection,
+                                           idx,
+                                           extend(range.getMin()),
+                                           extend(range.getMax()),
+                                           BoundInclusion::kIncludeStartKeyOnly,
+                                           PlanExecutor::NO_YIELD,
+                                           InternalPlanner::FORWARD,
+                                           InternalPlanner::IXSCAN_DEFAULT);
+
+    long long count = 0;
+    BSONObj obj;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+        ++count;
+    }
+
+    if (state != PlanExecutor::IS_EOF) {
+        return WorkingSetCommon::getMemberObjectStatus(obj);
+    }
+
+    return count;
+}
+
 /**
  * Lazy-instantiated task executor shared by the collection range deleters. Must outlive the
  * CollectionShardingStateMap below.
@@ -135,6 +199,13 @@ public:
         }
     }
 
+    void clearAllChunkDocumentCounts() {
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+        for (auto& coll : _collections) {
+            coll.second->getChunkDocumentCounts().clear();
+        }
+    }
+
     void report(OperationContext* opCtx, BSONObjBuilder* builder) {
         BSONObjBuilder versionB(builder->subobjStart("versions"));
 
@@ -190,6 +261,11 @@ void CollectionShardingState::resetAll(OperationContext* opCtx) {
     collectionsMap.resetAll();
 }
 
+void CollectionShardingState::clearAllChunkDocumentCounts(ServiceContext* serviceContext) {
+    auto& collectionsMap = CollectionShardingStateMap::get(serviceContext);
+    collectionsMap.clearAllChunkDocumentCounts();
+}
+
 void CollectionShardingState::report(OperationContext* opCtx, BSONObjBuilder* builder) {
     auto& collectionsMap = CollectionShardingStateMap::get(opCtx->getServiceContext());
     collectionsMap.report(opCtx, builder);
@@ -207,10 +283,15 @@ void CollectionShardingState::refreshMetadata(OperationContext* opCtx,
     invariant(opCtx->lockState()->isCollectionLockedForMode(_nss.ns(), MODE_X));
 
     _metadataManager->refreshActiveMetadata(std::move(newMetadata));
+
+    // The manager may have kept its own metadata, so carry the counts over to whichever is active
+    auto activeMetadata = _metadataManager->getActiveMetadata(_metadataManager);
+    _chunkDocumentCounts.onMetadataRefresh(activeMetadata.getMetadata());
 }
 
 void CollectionShardingState::markNotShardedAtStepdown() {
     _metadataManager->refreshActiveMetadata(nullptr);
+    _chunkDocumentCounts.clear();
 }
 
 auto CollectionShardingState::beginReceive(ChunkRange const& range) -> CleanupNotification {
@@ -324,6 +405,75 @@ boost::optional<ChunkRange> CollectionShardingState::getNextOrphanRange(BSONObj
     return _metadataManager->getNextOrphanRange(from);
 }
 
+bool CollectionShardingState::canCountOwnedDocuments(OperationContext* opCtx) {
+    if (!countFromChunkDocumentCounts.load())
+        return false;
+
+    if (!OperationShardingState::get(opCtx).hasShardVersion())
+        return false;
+
+    // The counts reflect the latest writes, not a snapshot at some point in the past
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern ||
+        readConcernArgs.getArgsAtClusterTime()) {
+        return false;
+    }
+
+    if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, _nss))
+        return false;
+
+    return bool(getMetadata(opCtx));
+}
+
+boost::optional<long long> CollectionShardingState::getOwnedDocumentCount(
+    OperationContext* opCtx) {
+    auto metadata = getMetadata(opCtx);
+    if (!metadata)
+        return boost::none;
+
+    return _chunkDocumentCounts.getOwnedCount(*metadata.getMetadata());
+}
+
+void CollectionShardingState::countUncountedChunks(OperationContext* opCtx,
+                                                   const NamespaceString& nss) {
+    std::vector<ChunkRange> uncounted;
+    {
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+        auto css = CollectionShardingState::get(opCtx, nss);
+        auto metadata = css->_metadataManager->getActiveMetadata(css->_metadataManager);
+        if (!metadata)
+            return;
+
+        uncounted = css->_chunkDocumentCounts.getUncountedChunks(*metadata.getMetadata());
+    }
+
+    for (const auto& range : uncounted) {
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS, MODE_S);
+        auto collection = autoColl.getCollection();
+        if (!collection)
+            return;
+
+        auto css = CollectionShardingState::get(opCtx, nss);
+        auto metadata = css->_metadataManager->getActiveMetadata(css->_metadataManager);
+        if (!metadata)
+            return;
+
+        auto swCount = countDocumentsInRange(opCtx, collection, metadata->getKeyPattern(), range);
+        if (!swCount.isOK()) {
+            LOG(0) << "Unable to count the documents of " << nss.ns() << " range "
+                   << redact(range.toString()) << causedBy(redact(swCount.getStatus()));
+            return;
+        }
+
+        // Fails if the metadata changed since the chunk was listed, in which case the remaining
+        // ranges may no longer be chunks either
+        if (!css->_chunkDocumentCounts.setChunkCount(
+                *metadata.getMetadata(), range, swCount.getValue())) {
+            return;
+        }
+    }
+}
+
 bool CollectionShardingState::_checkShardVersionOk(OperationContext* opCtx,
                                                    std::string* errmsg,
                                                    ChunkVersion* expectedShardVersion,
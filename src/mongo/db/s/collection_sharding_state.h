@@ -34,6 +34,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_document_counts.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/s/sharding_migration_critical_section.h"
 #include "mongo/util/decorable.h"
@@ -72,6 +73,12 @@ public:
     static CollectionShardingState* get(OperationContext* opCtx, const std::string& ns);
 
     static void resetAll(OperationContext* opCtx);
+
+    /**
+     * Forgets the per-chunk document counts of every collection, for when the data they were
+     * counted from may have been rolled back. They are counted again on demand.
+     */
+    static void clearAllChunkDocumentCounts(ServiceContext* serviceContext);
     static void report(OperationContext* opCtx, BSONObjBuilder* builder);
 
     /**
@@ -193,6 +200,35 @@ public:
      */
     boost::optional<ChunkRange> getNextOrphanRange(BSONObj const& startingFrom);
 
+    /**
+     * Returns whether an unfiltered count of this collection by the current operation may be
+     * answered from the per-chunk document counts. That requires the countFromChunkDocumentCounts
+     * server parameter, a sharded collection, a versioned request reading the latest local data,
+     * and this node to be primary, since only the primary keeps the counts.
+     */
+    bool canCountOwnedDocuments(OperationContext* opCtx);
+
+    /**
+     * Returns the number of documents in the chunks this shard owns, leaving out orphans and the
+     * documents of chunks still being migrated in, or boost::none if some of those chunks have not
+     * been counted yet. Call countUncountedChunks to count them.
+     */
+    boost::optional<long long> getOwnedDocumentCount(OperationContext* opCtx);
+
+    /**
+     * Counts the documents of every owned chunk of the collection which has no count yet, from the
+     * shard key index. Each chunk is counted while holding the collection lock in mode S, which
+     * keeps writers out until its count is recorded, and the lock is released between chunks.
+     * Returns early if the metadata changes or the collection has no usable shard key index.
+     *
+     * Call with the collection unlocked.
+     */
+    static void countUncountedChunks(OperationContext* opCtx, const NamespaceString& nss);
+
+    ChunkDocumentCounts& getChunkDocumentCounts() {
+        return _chunkDocumentCounts;
+    }
+
 private:
     /**
      * Checks whether the shard version of the operation matches that of the collection.
@@ -220,6 +256,9 @@ private:
 
     ShardingMigrationCriticalSection _critSec;
 
+    // Number of documents in each owned chunk, maintained by the shard server op observer
+    ChunkDocumentCounts _chunkDocumentCounts;
+
     // for access to _metadataManager
     friend auto CollectionRangeDeleter::cleanUpNextRange(OperationContext*,
                                                          NamespaceString const&,
@@ -478,16 +478,28 @@ void determinePresplittingPoints(OperationContext* opCtx,
         long long intervalSize = (std::numeric_limits<long long>::max() / numChunks) * 2;
         long long current = 0;
 
+        // Split points must be full shard keys. When the hashed field is followed by others, as in
+        // {a: "hashed", b: 1}, those take MinKey so that each split point starts its hash value.
+        auto makeSplitPoint = [&proposedKey](long long hashValue) {
+            BSONObjBuilder splitPoint;
+            BSONObjIterator keyIt(proposedKey);
+            splitPoint.append(keyIt.next().fieldName(), hashValue);
+            while (keyIt.more()) {
+                splitPoint.appendMinKey(keyIt.next().fieldName());
+            }
+            return splitPoint.obj();
+        };
+
         if (numChunks % 2 == 0) {
-            allSplits->push_back(BSON(proposedKey.firstElementFieldName() << current));
+            allSplits->push_back(makeSplitPoint(current));
             current += intervalSize;
         } else {
             current += intervalSize / 2;
         }
 
         for (int i = 0; i < (numChunks - 1) / 2; i++) {
-            allSplits->push_back(BSON(proposedKey.firstElementFieldName() << current));
-            allSplits->push_back(BSON(proposedKey.firstElementFieldName() << -current));
+            allSplits->push_back(makeSplitPoint(current));
+            allSplits->push_back(makeSplitPoint(-current));
             current += intervalSize;
         }
 
@@ -771,6 +783,15 @@ public:
         auto proposedKey(request.getKey().getOwned());
         ShardKeyPattern shardKeyPattern(proposedKey);
 
+        // Shards running a binary before 4.0 can't load the index behind a compound hashed shard
+        // key, so these keys require the cluster to have finished upgrading to 4.0.
+        uassert(ErrorCodes::IllegalOperation,
+                str::stream() << "Compound hashed shard key " << proposedKey
+                              << " requires featureCompatibilityVersion 4.0",
+                !shardKeyPattern.isHashedPattern() || proposedKey.nFields() == 1 ||
+                    serverGlobalParams.featureCompatibility.getVersion() ==
+                        ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo40);
+
         std::vector<ShardId> shardIds;
         shardRegistry->getAllShardIds(opCtx, &shardIds);
         const int numShards = shardIds.size();
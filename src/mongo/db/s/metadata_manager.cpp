@@ -69,6 +69,10 @@
 // _metadata.back()'s usage count differently from the snapshots because it can't reliably be
 // compared to zero; a new query may increment it at any time.
 //
+// Queries find _metadata.back() through _activeMetadataTracker without taking _managerLock, and
+// counters are updated atomically. Only a query releasing a snapshot that is no longer active
+// takes the lock, to retire it.
+//
 // (Note that the collection may be dropped or become unsharded, and even get made and sharded
 // again, between construction and destruction of a ScopedCollectionMetadata).
 //
@@ -136,7 +140,7 @@ void scheduleCleanup(executor::TaskExecutor* executor,
             auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
             auto opCtx = uniqueOpCtx.get();
 
-            const int maxToDelete = std::max(int(internalQueryExecYieldIterations.load()), 1);
+            const int maxToDelete = std::max(int(rangeDeleterMaxBatchSize.load()), 1);
 
             MONGO_FAIL_POINT_PAUSE_WHILE_SET(suspendRangeDeletion);
 
@@ -166,6 +170,7 @@ MetadataManager::~MetadataManager() {
     stdx::lock_guard<stdx::mutex> lg(_managerLock);
     _clearAllCleanups(lg);
     _metadata.clear();
+    std::atomic_store(&_activeMetadataTracker, {});  // NOLINT
 }
 
 void MetadataManager::_clearAllCleanups(WithLock lock) {
@@ -184,9 +189,15 @@ void MetadataManager::_clearAllCleanups(WithLock, Status status) {
 }
 
 ScopedCollectionMetadata MetadataManager::getActiveMetadata(std::shared_ptr<MetadataManager> self) {
-    stdx::lock_guard<stdx::mutex> lg(_managerLock);
-    if (!_metadata.empty()) {
-        return ScopedCollectionMetadata(lg, std::move(self), _metadata.back());
+    while (auto tracker = std::atomic_load(&_activeMetadataTracker)) {  // NOLINT
+        ScopedCollectionMetadata metadata(self, tracker);
+
+        // If the tracker is still the active one after its usageCounter went up, any refresh that
+        // retires it or checks its ranges for use will see the increment. Otherwise it may have
+        // been judged unused already, so let it go and try again.
+        if (std::atomic_load(&_activeMetadataTracker) == tracker) {  // NOLINT
+            return metadata;
+        }
     }
 
     return ScopedCollectionMetadata();
@@ -241,6 +252,7 @@ void MetadataManager::refreshActiveMetadata(std::unique_ptr<CollectionMetadata>
         _receivingChunks.clear();
         _clearAllCleanups(lg);
         _metadata.clear();
+        std::atomic_store(&_activeMetadataTracker, {});  // NOLINT
         return;
     }
 
@@ -303,11 +315,12 @@ void MetadataManager::refreshActiveMetadata(std::unique_ptr<CollectionMetadata>
 
 void MetadataManager::_setActiveMetadata(WithLock wl, CollectionMetadata newMetadata) {
     _metadata.emplace_back(std::make_shared<CollectionMetadataTracker>(std::move(newMetadata)));
+    std::atomic_store(&_activeMetadataTracker, _metadata.back());  // NOLINT
     _retireExpiredMetadata(wl);
 }
 
 void MetadataManager::_retireExpiredMetadata(WithLock lock) {
-    while (_metadata.size() > 1 && !_metadata.front()->usageCounter) {
+    while (_metadata.size() > 1 && !_metadata.front()->usageCounter.load()) {
         if (!_metadata.front()->orphans.empty()) {
             log() << "Queries possibly dependent on " << _nss.ns()
                   << " range(s) finished; scheduling ranges for deletion";
@@ -461,7 +474,7 @@ std::vector<ScopedCollectionMetadata> MetadataManager::overlappingMetadata(
     auto it = _metadata.rbegin();
     if ((*it)->metadata.rangeOverlapsChunk(range)) {
         // We ignore the refcount of the active mapping; effectively, we assume it is in use.
-        result.push_back(ScopedCollectionMetadata(lg, self, (*it)));
+        result.push_back(ScopedCollectionMetadata(self, (*it)));
     }
 
     // Continue to snapshots
@@ -470,8 +483,8 @@ std::vector<ScopedCollectionMetadata> MetadataManager::overlappingMetadata(
         auto& tracker = *it;
 
         // We want all the overlapping snapshot mappings still possibly in use by a query.
-        if (tracker->usageCounter > 0 && tracker->metadata.rangeOverlapsChunk(range)) {
-            result.push_back(ScopedCollectionMetadata(lg, self, tracker));
+        if (tracker->usageCounter.load() > 0 && tracker->metadata.rangeOverlapsChunk(range)) {
+            result.push_back(ScopedCollectionMetadata(self, tracker));
         }
     }
 
@@ -515,7 +528,7 @@ auto MetadataManager::_findNewestOverlappingMetadata(WithLock, ChunkRange const&
     ++it;
     for (; it != _metadata.rend(); ++it) {
         auto& tracker = *it;
-        if (tracker->usageCounter && tracker->metadata.rangeOverlapsChunk(range)) {
+        if (tracker->usageCounter.load() && tracker->metadata.rangeOverlapsChunk(range)) {
             return tracker.get();
         }
     }
@@ -554,13 +567,12 @@ boost::optional<ChunkRange> MetadataManager::getNextOrphanRange(BSONObj const& f
 ScopedCollectionMetadata::ScopedCollectionMetadata() = default;
 
 ScopedCollectionMetadata::ScopedCollectionMetadata(
-    WithLock,
     std::shared_ptr<MetadataManager> metadataManager,
     std::shared_ptr<MetadataManager::CollectionMetadataTracker> metadataTracker)
     : _metadataManager(std::move(metadataManager)), _metadataTracker(std::move(metadataTracker)) {
     invariant(_metadataManager);
     invariant(_metadataTracker);
-    ++_metadataTracker->usageCounter;
+    _metadataTracker->usageCounter.fetchAndAdd(1);
 }
 
 ScopedCollectionMetadata::ScopedCollectionMetadata(
@@ -614,9 +626,16 @@ void ScopedCollectionMetadata::_clear() {
         return;
     }
 
-    stdx::lock_guard<stdx::mutex> managerLock(_metadataManager->_managerLock);
-    invariant(_metadataTracker->usageCounter != 0);
-    if (--_metadataTracker->usageCounter == 0) {
+    const auto previousCount = _metadataTracker->usageCounter.fetchAndSubtract(1);
+    invariant(previousCount != 0);
+
+    // The active metadata is never retired, so the lock is only needed when one that has been
+    // replaced goes out of use. A refresh that replaces this metadata after the decrement above
+    // retires it itself.
+    if (previousCount == 1 &&
+        std::atomic_load(&_metadataManager->_activeMetadataTracker) !=  // NOLINT
+            _metadataTracker) {
+        stdx::lock_guard<stdx::mutex> managerLock(_metadataManager->_managerLock);
         // MetadataManager doesn't care which usageCounter went to zero. It just retires all that
         // are older than the oldest metadata still in use by queries (some start out at zero, some
         // go to zero but can't be expired yet).
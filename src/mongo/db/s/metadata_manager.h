@@ -29,6 +29,7 @@
 #pragma once
 
 #include <list>
+#include <memory>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
@@ -38,6 +39,7 @@
 #include "mongo/db/s/collection_range_deleter.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/concurrency/notification.h"
@@ -65,6 +67,9 @@ public:
      * Increments the usage counter of the active metadata and returns an RAII object, which
      * contains the currently active metadata.  When the usageCounter goes to zero, the RAII
      * object going out of scope will call _removeMetadata.
+     *
+     * Does not take the manager's mutex, so that concurrent operations on the collection do not
+     * contend on it.
      */
     ScopedCollectionMetadata getActiveMetadata(std::shared_ptr<MetadataManager> self);
 
@@ -167,14 +172,14 @@ private:
             : metadata(std::move(inMetadata)) {}
 
         ~CollectionMetadataTracker() {
-            invariant(!usageCounter);
+            invariant(!usageCounter.load());
         }
 
         CollectionMetadata metadata;
 
         std::list<Deletion> orphans;
 
-        uint32_t usageCounter{0};
+        AtomicUInt32 usageCounter{0};
     };
 
     /**
@@ -249,6 +254,11 @@ private:
     // in use by active server operations or cursors.
     std::list<std::shared_ptr<CollectionMetadataTracker>> _metadata;
 
+    // The same tracker as _metadata.back(), or null if _metadata is empty. It is always written
+    // with _managerLock held, but is read and written through the std::atomic_* functions for
+    // shared_ptr so that getActiveMetadata() can read it without the lock.
+    std::shared_ptr<CollectionMetadataTracker> _activeMetadataTracker;
+
     // Chunk ranges being migrated into to the shard. Indexed by the min key of the range.
     RangeMap _receivingChunks;
 
@@ -310,12 +320,9 @@ private:
     ScopedCollectionMetadata();
 
     /**
-     * Increments the usageCounter in the specified CollectionMetadata.
-     *
-     * Must be called with manager->_managerLock held.  Arguments must be non-null.
+     * Increments the usageCounter in the specified CollectionMetadata. Arguments must be non-null.
      */
     ScopedCollectionMetadata(
-        WithLock,
         std::shared_ptr<MetadataManager> metadataManager,
         std::shared_ptr<MetadataManager::CollectionMetadataTracker> metadataTracker);
 
@@ -47,6 +47,7 @@
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 
@@ -296,6 +297,36 @@ TEST_F(MetadataManagerTest, RefreshMetadataAfterDropAndRecreate) {
     ASSERT_BSONOBJ_EQ(BSON("key" << 30), chunkEntry->second);
 }
 
+TEST_F(MetadataManagerTest, ConcurrentReadersDuringRefresh) {
+    _manager->refreshActiveMetadata(makeEmptyMetadata());
+
+    AtomicBool done{false};
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto metadata = _manager->getActiveMetadata(_manager);
+                ASSERT_TRUE(bool(metadata));
+                ASSERT_LTE(metadata->getChunks().size(), 1UL);
+            }
+        });
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        addChunk(_manager);
+        _manager->refreshActiveMetadata(makeEmptyMetadata());
+    }
+
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    // Every replaced metadata was retired once its readers were done with it.
+    ASSERT_EQ(_manager->numberOfMetadataSnapshots(), 0UL);
+    ASSERT_EQ(_manager->getActiveMetadata(_manager)->getChunks().size(), 0UL);
+}
+
 // Tests membership functions for _rangesToClean
 TEST_F(MetadataManagerTest, RangesToCleanMembership) {
     _manager->refreshActiveMetadata(makeEmptyMetadata());
@@ -51,6 +51,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -64,8 +65,23 @@
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
+
+// Number of threads which insert the batches of documents cloned from the donor shard during a
+// migration. Each batch is inserted by a single thread, so batches are applied concurrently.
+MONGO_EXPORT_SERVER_PARAMETER(migrationCloneInsertionThreads, int, 2)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "migrationCloneInsertionThreads must be between 1 and 16");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
+// Maximum number of cloned documents inserted under a single acquisition of the collection lock.
+const int kMaxDocsPerCloneInsertBatch = 100;
+
 const auto getMigrationDestinationManager =
     ServiceContext::declareDecoration<MigrationDestinationManager>();
 
@@ -375,11 +391,16 @@ void MigrationDestinationManager::cloneDocumentsFromDonor(
     stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
     stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
 
-    ProducerConsumerQueue<BSONObj> batches(1);
-    stdx::thread inserterThread{[&] {
+    const size_t numInserterThreads = migrationCloneInsertionThreads.load();
+
+    // Allow each inserter thread to have one batch waiting for it while it inserts another, so
+    // that fetching from the donor is not held up by the inserts.
+    ProducerConsumerQueue<BSONObj> batches(numInserterThreads);
+
+    auto inserterFn = [&] {
         Client::initThreadIfNotAlready("chunkInserter");
         auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
+        PrioritizedTicketAcquisitionBlock prioritizedTickets(inserterOpCtx->lockState());
         try {
             while (true) {
                 auto nextBatch = batches.pop(inserterOpCtx.get());
@@ -390,30 +411,52 @@ void MigrationDestinationManager::cloneDocumentsFromDonor(
                 insertBatchFn(inserterOpCtx.get(), BSONObjIterator(arr));
             }
         } catch (...) {
-            stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
+            {
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
+            }
             log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+
+            // Only close the consumer end once the operation has been killed, so that the fetcher
+            // reports the insertion error rather than the closed queue.
+            batches.closeConsumerEnd();
         }
-    }};
-    auto inserterThreadJoinGuard = MakeGuard([&] {
+    };
+
+    std::vector<stdx::thread> inserterThreads;
+    auto inserterThreadsJoinGuard = MakeGuard([&] {
         batches.closeProducerEnd();
-        inserterThread.join();
+        for (auto& inserterThread : inserterThreads) {
+            inserterThread.join();
+        }
     });
 
+    for (size_t i = 0; i < numInserterThreads; ++i) {
+        inserterThreads.emplace_back(inserterFn);
+    }
+
     while (true) {
         opCtx->checkForInterrupt();
 
         auto res = fetchBatchFn(opCtx);
 
         opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
         auto arr = res["objects"].Obj();
         if (arr.isEmpty()) {
-            inserterThreadJoinGuard.Dismiss();
-            inserterThread.join();
+            // Every inserter thread stops once it receives an empty batch.
+            for (size_t i = 0; i < numInserterThreads; ++i) {
+                batches.push(res.getOwned(), opCtx);
+            }
+
+            inserterThreadsJoinGuard.Dismiss();
+            for (auto& inserterThread : inserterThreads) {
+                inserterThread.join();
+            }
             opCtx->checkForInterrupt();
             break;
         }
+
+        batches.push(res.getOwned(), opCtx);
     }
 }
 
@@ -502,6 +545,7 @@ void MigrationDestinationManager::_migrateThread(BSONObj min,
                                                  WriteConcernOptions writeConcern) {
     Client::initThread("migrateThread");
     auto opCtx = Client::getCurrent()->makeOperationContext();
+    PrioritizedTicketAcquisitionBlock prioritizedTickets(opCtx->lockState());
 
 
     if (AuthorizationManager::get(opCtx->getServiceContext())->isAuthEnabled()) {
@@ -773,33 +817,42 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
                     uasserted(50748, message);
                 }
 
-                BSONObj docToClone = docs.next().Obj();
+                // Insert the documents in small groups, so that the collection lock is not taken
+                // once per document but is still released regularly.
+                long long numInserted = 0;
+                long long bytesInserted = 0;
                 {
                     OldClientWriteContext cx(opCtx, _nss.ns());
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(opCtx,
-                                            _nss,
-                                            min,
-                                            max,
-                                            shardKeyPattern,
-                                            cx.db(),
-                                            docToClone,
-                                            &localDoc)) {
-                        const std::string errMsg = str::stream()
-                            << "cannot migrate chunk, local document " << redact(localDoc)
-                            << " has same _id as cloned "
-                            << "remote document " << redact(docToClone);
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
+                    while (docs.more() && numInserted < kMaxDocsPerCloneInsertBatch) {
+                        BSONObj docToClone = docs.next().Obj();
+                        BSONObj localDoc;
+                        if (willOverrideLocalId(opCtx,
+                                                _nss,
+                                                min,
+                                                max,
+                                                shardKeyPattern,
+                                                cx.db(),
+                                                docToClone,
+                                                &localDoc)) {
+                            const std::string errMsg = str::stream()
+                                << "cannot migrate chunk, local document " << redact(localDoc)
+                                << " has same _id as cloned "
+                                << "remote document " << redact(docToClone);
+                            warning() << errMsg;
+
+                            // Exception will abort migration cleanly
+                            uasserted(16976, errMsg);
+                        }
+                        Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
+
+                        ++numInserted;
+                        bytesInserted += docToClone.objsize();
                     }
-                    Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
                 }
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    _numCloned += numInserted;
+                    _clonedBytes += bytesInserted;
                 }
                 if (writeConcern.shouldWaitForOtherNodes()) {
                     repl::ReplicationCoordinator::StatusAndDuration replStatus =
@@ -28,8 +28,11 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/db/s/migration_destination_manager.h"
 #include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -104,6 +107,47 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that every batch fetched from the donor is inserted, even though batches may be inserted
+// concurrently and out of order.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorInsertsEveryBatch) {
+    const int kNumBatches = 10;
+    int numBatchesFetched = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+
+        if (numBatchesFetched == kNumBatches) {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        } else {
+            BSONArrayBuilder arrayBuilder;
+            arrayBuilder.append(createDocument(numBatchesFetched++));
+            fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        }
+
+        return fetchBatchResultBuilder.obj();
+    };
+
+    stdx::mutex resultDocsMutex;
+    std::vector<int> resultIds;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObjIterator docs) {
+        while (docs.more()) {
+            auto id = docs.next().Obj()["_id"].numberInt();
+            stdx::lock_guard<stdx::mutex> lk(resultDocsMutex);
+            resultIds.push_back(id);
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn);
+
+    std::sort(resultIds.begin(), resultIds.end());
+    ASSERT_EQ(static_cast<size_t>(kNumBatches), resultIds.size());
+    for (int i = 0; i < kNumBatches; ++i) {
+        ASSERT_EQ(i, resultIds[i]);
+    }
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
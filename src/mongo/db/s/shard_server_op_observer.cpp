@@ -50,7 +50,7 @@
 namespace mongo {
 namespace {
 
-const auto getDeleteState = OperationContext::declareDecoration<ShardObserverDeleteState>();
+const auto getDeleteState = OperationContext::declareLazyDecoration<ShardObserverDeleteState>();
 
 bool isStandaloneOrPrimary(OperationContext* opCtx) {
     auto replCoord = repl::ReplicationCoordinator::get(opCtx);
@@ -204,6 +204,7 @@ void ShardServerOpObserver::onInserts(OperationContext* opCtx,
     auto const css = CollectionShardingState::get(opCtx, nss);
     const auto metadata = css->getMetadata(opCtx);
 
+    std::vector<BSONObj> insertedDocs;
     for (auto it = begin; it != end; ++it) {
         const auto& insertedDoc = it->doc;
 
@@ -222,8 +223,13 @@ void ShardServerOpObserver::onInserts(OperationContext* opCtx,
         if (metadata) {
             incrementChunkOnInsertOrUpdate(
                 opCtx, *metadata->getChunkManager(), insertedDoc, insertedDoc.objsize());
+            insertedDocs.push_back(insertedDoc);
         }
     }
+
+    if (metadata) {
+        css->getChunkDocumentCounts().onWrite(opCtx, *metadata.getMetadata(), insertedDocs, 1);
+    }
 }
 
 void ShardServerOpObserver::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs& args) {
@@ -327,6 +333,13 @@ void ShardServerOpObserver::aboutToDelete(OperationContext* opCtx,
                                           BSONObj const& doc) {
     auto css = CollectionShardingState::get(opCtx, nss.ns());
     getDeleteState(opCtx) = ShardObserverDeleteState::make(opCtx, css, doc);
+
+    // The document key might not hold the shard key values the way the chunk bounds do (hashed or
+    // nested fields), so count the delete while the whole document is at hand. The count is only
+    // adjusted if the delete commits.
+    if (const auto metadata = css->getMetadata(opCtx)) {
+        css->getChunkDocumentCounts().onWrite(opCtx, *metadata.getMetadata(), {doc}, -1);
+    }
 }
 
 void ShardServerOpObserver::onDelete(OperationContext* opCtx,
@@ -390,9 +403,18 @@ repl::OpTime ShardServerOpObserver::onDropCollection(OperationContext* opCtx,
         ShardIdentityRollbackNotifier::get(opCtx)->recordThatRollbackHappened();
     }
 
+    // Called with the collection X lock held
+    CollectionShardingState::get(opCtx, collectionName)->getChunkDocumentCounts().clear();
+
     return {};
 }
 
+void ShardServerOpObserver::onReplicationRollback(OperationContext* opCtx,
+                                                  const RollbackObserverInfo& rbInfo) {
+    // The counts may include writes which were rolled back.
+    CollectionShardingState::clearAllChunkDocumentCounts(opCtx->getServiceContext());
+}
+
 void shardObserveInsertOp(OperationContext* opCtx,
                           CollectionShardingState* css,
                           const BSONObj& insertedDoc,
@@ -125,7 +125,8 @@ public:
 
     void onTransactionAbort(OperationContext* opCtx) override {}
 
-    void onReplicationRollback(OperationContext* opCtx, const RollbackObserverInfo& rbInfo) {}
+    void onReplicationRollback(OperationContext* opCtx,
+                               const RollbackObserverInfo& rbInfo) override;
 };
 
 
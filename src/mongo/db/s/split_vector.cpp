@@ -38,22 +38,149 @@
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorSamplesPerChunk, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "splitVectorSamplesPerChunk must be non-negative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 const int kMaxObjectPerChunk{250000};
 
+// Bounds on the number of documents sampled to estimate split points. Fewer sampled keys in the
+// range make the estimate too coarse. A range which needs more random reads than this to find its
+// keys is small enough to scan.
+const long long kMinSampledKeysInRange{100};
+const long long kMaxSamples{10000};
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
+/**
+ * Estimates split points for the range [minKey, maxKey) of the index 'idx' from a random sample of
+ * the collection's documents, so that each chunk holds about 'keyCount' documents. The split keys
+ * are keys of sampled documents, so each one exists in the range.
+ *
+ * Documents are drawn from the whole collection until the keys in the range give each of the
+ * range's estimated chunks its share of samples, which takes fewer draws the more of the collection
+ * the range holds. Returns boost::none if the storage engine does not support random cursors, or if
+ * that takes more than kMaxSamples draws or more draws than the range holds documents, in which
+ * case the caller should scan.
+ */
+boost::optional<std::vector<BSONObj>> sampleSplitKeys(OperationContext* opCtx,
+                                                      Collection* collection,
+                                                      const IndexDescriptor* idx,
+                                                      const BSONObj& keyPattern,
+                                                      const BSONObj& minKey,
+                                                      const BSONObj& maxKey,
+                                                      long long recCount,
+                                                      long long keyCount,
+                                                      boost::optional<long long> maxSplitPoints) {
+    const long long samplesPerChunkWanted = splitVectorSamplesPerChunk.load();
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return boost::none;
+    }
+
+    const IndexAccessMethod* const iam = collection->getIndexCatalog()->getIndex(idx);
+    const Ordering ordering = Ordering::make(idx->keyPattern());
+    const bool considerFieldName = false;
+
+    long long numSampled = 0;
+    std::vector<BSONObj> sampledKeys;
+    bool enoughSamples = false;
+    while (!enoughSamples && numSampled < kMaxSamples) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        numSampled++;
+
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        iam->getKeys(record->data.releaseToBson(),
+                     IndexAccessMethod::GetKeysMode::kRelaxConstraints,
+                     &keys,
+                     nullptr);
+        if (keys.empty()) {
+            continue;
+        }
+
+        const BSONObj& key = *keys.begin();
+        if (key.woCompare(minKey, ordering, considerFieldName) < 0 ||
+            key.woCompare(maxKey, ordering, considerFieldName) >= 0) {
+            continue;
+        }
+        sampledKeys.push_back(key.getOwned());
+
+        // The share of the draws which fell in the range estimates how many documents it holds
+        const long long numInRange = sampledKeys.size();
+        const double rangeRecCount = double(recCount) * numInRange / numSampled;
+
+        // Reading more documents at random than the range holds costs more than scanning it
+        if (numSampled >= rangeRecCount) {
+            break;
+        }
+
+        enoughSamples = numInRange >= kMinSampledKeysInRange &&
+            numInRange >= samplesPerChunkWanted * (rangeRecCount / keyCount + 1);
+    }
+
+    if (!enoughSamples) {
+        return boost::none;
+    }
+
+    std::sort(sampledKeys.begin(), sampledKeys.end(), [&](const BSONObj& a, const BSONObj& b) {
+        return a.woCompare(b, ordering, considerFieldName) < 0;
+    });
+
+    // Each sampled document stands for 'recCount / numSampled' documents of the collection
+    const double samplesPerChunk = double(keyCount) * numSampled / recCount;
+
+    const BSONObj rangeMin = dotted_path_support::extractElementsBasedOnTemplate(
+        prettyKey(idx->keyPattern(), sampledKeys.front()), keyPattern);
+
+    std::vector<BSONObj> splitKeys;
+    for (double position = samplesPerChunk; position < sampledKeys.size();
+         position += samplesPerChunk) {
+        const BSONObj splitKey = dotted_path_support::extractElementsBasedOnTemplate(
+            prettyKey(idx->keyPattern(), sampledKeys[static_cast<size_t>(position)]), keyPattern);
+
+        // As when scanning, all instances of a given key value must live in the same chunk
+        const BSONObj& previousKey = splitKeys.empty() ? rangeMin : splitKeys.back();
+        if (splitKey.woCompare(previousKey) == 0) {
+            continue;
+        }
+
+        splitKeys.push_back(splitKey.getOwned());
+
+        if (maxSplitPoints && maxSplitPoints.get() &&
+            static_cast<long long>(splitKeys.size()) >= maxSplitPoints.get()) {
+            break;
+        }
+    }
+
+    LOG(1) << "estimated " << splitKeys.size() << " split points from " << sampledKeys.size()
+           << " of " << numSampled << " sampled documents";
+    return splitKeys;
+}
+
 }  // namespace
 
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
@@ -151,6 +278,25 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
             keyCount = maxChunkObjects.get();
         }
 
+        if (!force && splitVectorSamplesPerChunk.load() > 0) {
+            auto sampledSplitKeys = sampleSplitKeys(opCtx,
+                                                    collection,
+                                                    idx,
+                                                    keyPattern,
+                                                    minKey,
+                                                    maxKey,
+                                                    recCount,
+                                                    keyCount,
+                                                    maxSplitPoints);
+            if (sampledSplitKeys) {
+                splitKeys = std::move(*sampledSplitKeys);
+                std::sort(splitKeys.begin(),
+                          splitKeys.end(),
+                          SimpleBSONObjComparator::kInstance.makeLessThan());
+                return splitKeys;
+            }
+        }
+
         //
         // Traverse the index and add the keyCount-th key to the result vector. If that key
         // appeared in the vector before, we omit it. The invariant here is that all the
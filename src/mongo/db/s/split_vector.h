@@ -31,6 +31,8 @@
 #include <boost/optional.hpp>
 #include <vector>
 
+#include "mongo/platform/atomic_word.h"
+
 namespace mongo {
 
 class BSONObj;
@@ -39,6 +41,13 @@ class OperationContext;
 template <typename T>
 class StatusWith;
 
+// When greater than 0, splitVector estimates split points from a random sample of the collection,
+// drawing about this many sampled documents for each chunk the collection would be split into,
+// instead of scanning the range's index keys. The range is still scanned when forcing a split, if
+// the storage engine cannot sample randomly, or if the sample would be too small or too large. 0 by
+// default.
+extern AtomicInt32 splitVectorSamplesPerChunk;
+
 /**
  * Given a chunk, determines whether it can be split and returns the split points if so. This
  * function is functionally equivalent to the splitVector command.
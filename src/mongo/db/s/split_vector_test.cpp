@@ -35,6 +35,7 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -300,5 +301,26 @@ TEST_F(SplitVectorTest, NoMaxChunkSize) {
     ASSERT_EQUALS(status.code(), ErrorCodes::InvalidOptions);
 }
 
+TEST_F(SplitVectorTest, SamplingScansRangeWhenSampleIsTooSmall) {
+    const auto originalSamplesPerChunk = splitVectorSamplesPerChunk.load();
+    splitVectorSamplesPerChunk.store(10);
+    ON_BLOCK_EXIT([&] { splitVectorSamplesPerChunk.store(originalSamplesPerChunk); });
+
+    // Enough keys in the range to estimate from would take more random reads than the range holds
+    // documents, so the split points are found by scanning, exactly as without sampling.
+    std::vector<BSONObj> splitKeys = unittest::assertGet(splitVector(operationContext(),
+                                                                     kNss,
+                                                                     BSON(kPattern << 1),
+                                                                     BSON(kPattern << 0),
+                                                                     BSON(kPattern << 100),
+                                                                     false,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     getDocSizeBytes() * 100LL));
+    ASSERT_EQ(1U, splitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 50), splitKeys.front());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -72,6 +72,7 @@
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/snapshot_window_util.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -90,6 +91,7 @@
 #include "mongo/s/stale_exception.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -617,6 +619,8 @@ void execCommandDatabase(OperationContext* opCtx,
                          const OpMsgRequest& request,
                          rpc::ReplyBuilderInterface* replyBuilder,
                          const ServiceEntryPointCommon::Hooks& behaviors) {
+    // Attributes CPU profile samples taken on this thread to the command.
+    SamplingProfiler::TagGuard profilerTag(command->getName().c_str());
     CommandHelpers::uassertShouldAttemptParse(opCtx, command, request);
     BSONObjBuilder extraFieldsBuilder;
     auto startOperationTime = getClientOperationTime(opCtx);
@@ -964,12 +968,59 @@ void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request) {
     curop->setNS_inlock(nss.ns());
 }
 
+/**
+ * Returns the getMore that continues an OP_MSG exhaust stream after 'request' produced 'reply', or
+ * boost::none if the stream should end here. Only a find or getMore whose cursor is still open and
+ * which returned a non-empty batch is continued, so that a tailable cursor which has caught up
+ * waits for the client to ask again rather than spinning on empty batches.
+ */
+boost::optional<BSONObj> makeExhaustNextInvocation(const OpMsgRequest& request,
+                                                   const BSONObj& reply) {
+    const auto commandName = request.getCommandName();
+    if ((commandName != "find" && commandName != "getMore") || !reply["ok"].trueValue() ||
+        request.body.hasField("txnNumber")) {
+        return boost::none;
+    }
+
+    const auto cursor = reply["cursor"];
+    if (cursor.type() != Object) {
+        return boost::none;
+    }
+    const auto cursorObj = cursor.Obj();
+    const auto cursorId = cursorObj["id"];
+    const auto batch = cursorObj[commandName == "find" ? "firstBatch" : "nextBatch"];
+    if (cursorId.type() != NumberLong || cursorId.Long() == 0 || batch.type() != Array ||
+        batch.Obj().isEmpty()) {
+        return boost::none;
+    }
+
+    // A getMore continues its cursor by running again exactly as it was sent.
+    if (commandName == "getMore") {
+        return request.body.getOwned();
+    }
+
+    // The find reply names the namespace its cursor iterates, which differs from the request's
+    // for a find on a view.
+    const NamespaceString nss(cursorObj["ns"].valueStringData());
+    BSONObjBuilder bob;
+    bob.append("getMore", cursorId.Long());
+    bob.append("collection", nss.coll());
+    if (auto batchSize = request.body["batchSize"]) {
+        bob.append(batchSize);
+    }
+    if (auto lsid = request.body["lsid"]) {
+        bob.append(lsid);
+    }
+    bob.append("$db", nss.db());
+    return bob.obj();
+}
+
 DbResponse runCommands(OperationContext* opCtx,
                        const Message& message,
                        const ServiceEntryPointCommon::Hooks& behaviors) {
     auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
+    OpMsgRequest request;
     [&] {
-        OpMsgRequest request;
         try {  // Parse.
             request = rpc::opMsgRequestFromAnyProtocol(message);
         } catch (const DBException& ex) {
@@ -1049,8 +1100,12 @@ DbResponse runCommands(OperationContext* opCtx,
     auto response = replyBuilder->done();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
-    return DbResponse{std::move(response)};
+    DbResponse dbResponse{std::move(response)};
+    if (OpMsg::isFlagSet(message, OpMsg::kExhaustSupported) && !request.body.isEmpty()) {
+        dbResponse.nextInvocation =
+            makeExhaustNextInvocation(request, OpMsg::parse(dbResponse.response).body);
+    }
+    return dbResponse;
 }
 
 DbResponse receivedQuery(OperationContext* opCtx,
@@ -1370,6 +1425,20 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
             currentOp.getReadWriteType());
 
+    if (debug.queryHash) {
+        const std::string ns = currentOp.getNS();
+        QueryShapeStats::Execution execution;
+        execution.ns = ns;
+        execution.queryHash = *debug.queryHash;
+        execution.planSummary = currentOp.getPlanSummary();
+        execution.isGetMore = currentOp.getLogicalOp() == LogicalOp::opGetMore;
+        execution.latencyMicros = debug.executionTimeMicros;
+        execution.keysExamined = std::max(0LL, debug.keysExamined);
+        execution.docsExamined = std::max(0LL, debug.docsExamined);
+        execution.nreturned = std::max(0LL, debug.nreturned);
+        QueryShapeStats::get(opCtx->getServiceContext()).record(execution);
+    }
+
     if (currentOp.shouldDBProfile(shouldSample)) {
         // Performance profiling is on
         if (opCtx->lockState()->isReadLocked()) {
@@ -666,11 +666,18 @@ void Session::_checkTxnValid(WithLock, TxnNumber txnNumber) const {
             txnNumber >= _activeTxnNumber);
 }
 
-Session::TxnResources::TxnResources(OperationContext* opCtx) {
+Session::TxnResources::TxnResources(OperationContext* opCtx,
+                                    std::unique_ptr<Locker> locker,
+                                    std::unique_ptr<RecoveryUnit> recoveryUnit) {
     _ruState = opCtx->getWriteUnitOfWork()->release();
     opCtx->setWriteUnitOfWork(nullptr);
 
-    _locker = opCtx->swapLockState(stdx::make_unique<DefaultLockerImpl>());
+    const bool recycledLocker = bool(locker);
+    _locker = opCtx->swapLockState(recycledLocker ? std::move(locker)
+                                                  : stdx::make_unique<DefaultLockerImpl>());
+    if (recycledLocker) {
+        opCtx->lockState()->updateThreadIdToCurrentThread();
+    }
     _locker->releaseTicket();
     _locker->unsetThreadId();
 
@@ -682,7 +689,9 @@ Session::TxnResources::TxnResources(OperationContext* opCtx) {
     }
 
     _recoveryUnit = std::unique_ptr<RecoveryUnit>(opCtx->releaseRecoveryUnit());
-    opCtx->setRecoveryUnit(opCtx->getServiceContext()->getStorageEngine()->newRecoveryUnit(),
+    opCtx->setRecoveryUnit(recoveryUnit
+                               ? recoveryUnit.release()
+                               : opCtx->getServiceContext()->getStorageEngine()->newRecoveryUnit(),
                            WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
 
     _readConcernArgs = repl::ReadConcernArgs::get(opCtx);
@@ -699,22 +708,32 @@ Session::TxnResources::~TxnResources() {
     }
 }
 
-void Session::TxnResources::release(OperationContext* opCtx) {
+void Session::TxnResources::release(OperationContext* opCtx,
+                                    std::unique_ptr<Locker>* replacedLocker,
+                                    std::unique_ptr<RecoveryUnit>* replacedRecoveryUnit) {
     // Perform operations that can fail the release before marking the TxnResources as released.
     _locker->reacquireTicket(opCtx);
 
     invariant(!_released);
     _released = true;
 
-    // We intentionally do not capture the return value of swapLockState(), which is just an empty
-    // locker. At the end of the operation, if the transaction is not complete, we will stash the
-    // operation context's locker and replace it with a new empty locker.
+    // The operation context's own locker holds no locks, so it can be kept to replace the
+    // transaction's locker when the operation stashes it again.
     invariant(opCtx->lockState()->getClientState() == Locker::ClientState::kInactive);
-    opCtx->swapLockState(std::move(_locker));
+    auto opLocker = opCtx->swapLockState(std::move(_locker));
     opCtx->lockState()->updateThreadIdToCurrentThread();
+    if (replacedLocker) {
+        *replacedLocker = std::move(opLocker);
+    }
 
+    std::unique_ptr<RecoveryUnit> opRecoveryUnit(opCtx->releaseRecoveryUnit());
     opCtx->setRecoveryUnit(_recoveryUnit.release(),
                            WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+    if (replacedRecoveryUnit) {
+        // Don't hold a storage snapshot open on the operation's behalf while it is set aside.
+        opRecoveryUnit->abandonSnapshot();
+        *replacedRecoveryUnit = std::move(opRecoveryUnit);
+    }
 
     opCtx->setWriteUnitOfWork(WriteUnitOfWork::createForSnapshotResume(opCtx, _ruState));
 
@@ -756,7 +775,8 @@ void Session::stashTransactionResources(OperationContext* opCtx) {
         _commitTransaction(std::move(lg), opCtx);
     } else {
         invariant(!_txnResourceStash);
-        _txnResourceStash = TxnResources(opCtx);
+        _txnResourceStash = TxnResources(
+            opCtx, std::move(_setAsideLocker), std::move(_setAsideRecoveryUnit));
     }
 }
 
@@ -807,7 +827,7 @@ void Session::unstashTransactionResources(OperationContext* opCtx, const std::st
                     "Only the first command in a transaction may specify a readConcern",
                     readConcernArgs.isEmpty());
 
-            _txnResourceStash->release(opCtx);
+            _txnResourceStash->release(opCtx, &_setAsideLocker, &_setAsideRecoveryUnit);
             _txnResourceStash = boost::none;
         } else {
             // Stashed transaction resources do not exist for this transaction.  If this is a
@@ -913,7 +933,7 @@ void Session::abortActiveTransaction(OperationContext* opCtx) {
         }
         // We must clear the recovery unit and locker so any post-transaction writes can run without
         // transactional settings such as a read timestamp.
-        opCtx->setRecoveryUnit(opCtx->getServiceContext()->getStorageEngine()->newRecoveryUnit(),
+        opCtx->setRecoveryUnit(_takeSetAsideRecoveryUnit(opCtx),
                                WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
         opCtx->lockState()->unsetMaxLockTimeout();
     }
@@ -922,6 +942,13 @@ void Session::abortActiveTransaction(OperationContext* opCtx) {
     }
 }
 
+RecoveryUnit* Session::_takeSetAsideRecoveryUnit(OperationContext* opCtx) {
+    if (_setAsideRecoveryUnit) {
+        return _setAsideRecoveryUnit.release();
+    }
+    return opCtx->getServiceContext()->getStorageEngine()->newRecoveryUnit();
+}
+
 void Session::killTransactionCursors(OperationContext* opCtx) {
     TxnNumber txnNumberAtStart;
     {
@@ -1038,7 +1065,10 @@ void Session::_commitTransaction(stdx::unique_lock<stdx::mutex> lk, OperationCon
     invariant(_txnState == MultiDocumentTransactionState::kInProgress ||
               _txnState == MultiDocumentTransactionState::kInSnapshotRead);
     const bool isMultiDocumentTransaction = _txnState == MultiDocumentTransactionState::kInProgress;
-    if (isMultiDocumentTransaction) {
+    // A transaction that made no writes has nothing to replicate, so it can skip the opObserver
+    // and the unlocked window in which another thread could abort it.
+    const bool isReadOnly = _transactionOperations.empty();
+    if (isMultiDocumentTransaction && !isReadOnly) {
         // We need to unlock the session to run the opObserver onTransactionCommit, which calls back
         // into the session.
         lk.unlock();
@@ -1069,7 +1099,7 @@ void Session::_commitTransaction(stdx::unique_lock<stdx::mutex> lk, OperationCon
         }
         // We must clear the recovery unit and locker so any post-transaction writes can run without
         // transactional settings such as a read timestamp.
-        opCtx->setRecoveryUnit(opCtx->getServiceContext()->getStorageEngine()->newRecoveryUnit(),
+        opCtx->setRecoveryUnit(_takeSetAsideRecoveryUnit(opCtx),
                                WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
         opCtx->lockState()->unsetMaxLockTimeout();
         _commitcv.notify_all();
@@ -75,9 +75,12 @@ public:
     class TxnResources {
     public:
         /**
-         * Stashes transaction state from 'opCtx' in the newly constructed TxnResources.
+         * Stashes transaction state from 'opCtx' in the newly constructed TxnResources. The
+         * operation carries on with 'locker' and 'recoveryUnit' if given, or with new ones.
          */
-        TxnResources(OperationContext* opCtx);
+        TxnResources(OperationContext* opCtx,
+                     std::unique_ptr<Locker> locker = nullptr,
+                     std::unique_ptr<RecoveryUnit> recoveryUnit = nullptr);
 
         ~TxnResources();
 
@@ -94,9 +97,13 @@ public:
         }
 
         /**
-         * Releases stashed transaction state onto 'opCtx'. Must only be called once.
+         * Releases stashed transaction state onto 'opCtx'. Must only be called once. The locker
+         * and recovery unit 'opCtx' had before are moved to 'replacedLocker' and
+         * 'replacedRecoveryUnit' if given, or destroyed.
          */
-        void release(OperationContext* opCtx);
+        void release(OperationContext* opCtx,
+                     std::unique_ptr<Locker>* replacedLocker = nullptr,
+                     std::unique_ptr<RecoveryUnit>* replacedRecoveryUnit = nullptr);
 
     private:
         bool _released = false;
@@ -330,6 +337,15 @@ public:
         return _txnState == MultiDocumentTransactionState::kAborted;
     }
 
+    /**
+     * Returns whether the current multi-document transaction has written anything yet. Its
+     * uncommitted writes are visible only through the transaction's own recovery unit.
+     */
+    bool transactionHasOperations() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return !_transactionOperations.empty();
+    }
+
     /**
      * Adds a stored operation to the list of stored operations for the current multi-document
      * (non-autocommit) transaction.  It is illegal to add operations when no multi-document
@@ -438,6 +454,10 @@ private:
 
     void _abortArbitraryTransaction(WithLock, OperationContext* opCtx, bool* canKillCursors);
 
+    // Returns the recovery unit set aside when the transaction resources were unstashed, or a new
+    // one, to replace the transaction's recovery unit on 'opCtx' once the transaction completes.
+    RecoveryUnit* _takeSetAsideRecoveryUnit(OperationContext* opCtx);
+
     // Releases stashed transaction resources to abort the transaction.
     // 'canKillCursors' is an output parameter, which when set to true indicates that transaction
     // client cursors may be killed.
@@ -491,6 +511,13 @@ private:
     // Holds transaction resources between network operations.
     boost::optional<TxnResources> _txnResourceStash;
 
+    // The locker and recovery unit of the operation which unstashed the transaction resources,
+    // set aside while it runs on the transaction's. Stashing hands them back to the operation
+    // instead of allocating new ones, so a transaction statement swaps its resources rather than
+    // creating them.
+    std::unique_ptr<Locker> _setAsideLocker;
+    std::unique_ptr<RecoveryUnit> _setAsideRecoveryUnit;
+
     // Indicates the state of the current multi-document transaction or snapshot read, if any.  If
     // the transaction is in any state but kInProgress, no more operations can be collected.
     enum class MultiDocumentTransactionState {
@@ -40,6 +40,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/transactions_stats_gen.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -55,16 +56,20 @@ const auto operationSessionDecoration =
 }  // namespace
 
 SessionCatalog::~SessionCatalog() {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-    for (const auto& entry : _txnTable) {
-        auto& sri = entry.second;
-        invariant(!sri->checkedOut);
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lg(stripe.mutex);
+        for (const auto& entry : stripe.txnTable) {
+            auto& sri = entry.second;
+            invariant(!sri->checkedOut);
+        }
     }
 }
 
 void SessionCatalog::reset_forTest() {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-    _txnTable.clear();
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lg(stripe.mutex);
+        stripe.txnTable.clear();
+    }
 }
 
 SessionCatalog* SessionCatalog::get(OperationContext* opCtx) {
@@ -125,16 +130,22 @@ ScopedCheckedOutSession SessionCatalog::checkOutSession(OperationContext* opCtx)
 
     const auto lsid = *opCtx->getLogicalSessionId();
 
-    stdx::unique_lock<stdx::mutex> ul(_mutex);
+    auto& stripe = _getStripe(lsid);
+    stdx::unique_lock<stdx::mutex> ul(stripe.mutex);
 
-    auto sri = _getOrCreateSessionRuntimeInfo(ul, opCtx, lsid);
+    auto sri = _getOrCreateSessionRuntimeInfo(ul, stripe, opCtx, lsid);
 
     // Wait until the session is no longer checked out
-    opCtx->waitForConditionOrInterrupt(
-        sri->availableCondVar, ul, [&sri]() { return !sri->checkedOut; });
+    if (sri->checkedOut) {
+        _numCheckOutWaits.fetchAndAdd(1);
+        opCtx->waitForConditionOrInterrupt(
+            sri->availableCondVar, ul, [&sri]() { return !sri->checkedOut; });
+    }
 
     invariant(!sri->checkedOut);
     sri->checkedOut = true;
+    _numCheckedOut.fetchAndAdd(1);
+    _numCheckOuts.fetchAndAdd(1);
 
     return ScopedCheckedOutSession(opCtx, ScopedSession(std::move(sri)));
 }
@@ -146,8 +157,9 @@ ScopedSession SessionCatalog::getOrCreateSession(OperationContext* opCtx,
     invariant(!opCtx->getTxnNumber());
 
     auto ss = [&] {
-        stdx::unique_lock<stdx::mutex> ul(_mutex);
-        return ScopedSession(_getOrCreateSessionRuntimeInfo(ul, opCtx, lsid));
+        auto& stripe = _getStripe(lsid);
+        stdx::unique_lock<stdx::mutex> ul(stripe.mutex);
+        return ScopedSession(_getOrCreateSessionRuntimeInfo(ul, stripe, opCtx, lsid));
     }();
 
     // Perform the refresh outside of the mutex
@@ -164,31 +176,35 @@ void SessionCatalog::invalidateSessions(OperationContext* opCtx,
                           << " cannot be performed using a transaction or on a session.",
             !opCtx->getLogicalSessionId());
 
-    const auto invalidateSessionFn = [&](WithLock, SessionRuntimeInfoMap::iterator it) {
-        auto& sri = it->second;
-        sri->txnState.invalidate();
+    const auto invalidateSessionFn =
+        [&](WithLock, Stripe& stripe, SessionRuntimeInfoMap::iterator it) {
+            auto& sri = it->second;
+            sri->txnState.invalidate();
 
-        // We cannot remove checked-out sessions from the cache, because operations expect to find
-        // them there to check back in
-        if (!sri->checkedOut) {
-            _txnTable.erase(it);
-        }
-    };
-
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+            // We cannot remove checked-out sessions from the cache, because operations expect to
+            // find them there to check back in
+            if (!sri->checkedOut) {
+                stripe.txnTable.erase(it);
+            }
+        };
 
     if (singleSessionDoc) {
         const auto lsid = LogicalSessionId::parse(IDLParserErrorContext("lsid"),
                                                   singleSessionDoc->getField("_id").Obj());
 
-        auto it = _txnTable.find(lsid);
-        if (it != _txnTable.end()) {
-            invalidateSessionFn(lg, it);
+        auto& stripe = _getStripe(lsid);
+        stdx::lock_guard<stdx::mutex> lg(stripe.mutex);
+        auto it = stripe.txnTable.find(lsid);
+        if (it != stripe.txnTable.end()) {
+            invalidateSessionFn(lg, stripe, it);
         }
     } else {
-        auto it = _txnTable.begin();
-        while (it != _txnTable.end()) {
-            invalidateSessionFn(lg, it++);
+        for (auto& stripe : _stripes) {
+            stdx::lock_guard<stdx::mutex> lg(stripe.mutex);
+            auto it = stripe.txnTable.begin();
+            while (it != stripe.txnTable.end()) {
+                invalidateSessionFn(lg, stripe, it++);
+            }
         }
     }
 }
@@ -196,42 +212,63 @@ void SessionCatalog::invalidateSessions(OperationContext* opCtx,
 void SessionCatalog::scanSessions(OperationContext* opCtx,
                                   const SessionKiller::Matcher& matcher,
                                   stdx::function<void(OperationContext*, Session*)> workerFn) {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-
-    LOG(2) << "Beginning scanSessions. Scanning " << _txnTable.size() << " sessions.";
-
-    for (auto it = _txnTable.begin(); it != _txnTable.end(); ++it) {
-        // TODO SERVER-33850: Rename KillAllSessionsByPattern and
-        // ScopedKillAllSessionsByPatternImpersonator to not refer to session kill.
-        if (const KillAllSessionsByPattern* pattern = matcher.match(it->first)) {
-            ScopedKillAllSessionsByPatternImpersonator impersonator(opCtx, *pattern);
-            workerFn(opCtx, &(it->second->txnState));
+    LOG(2) << "Beginning scanSessions.";
+
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lg(stripe.mutex);
+
+        for (auto it = stripe.txnTable.begin(); it != stripe.txnTable.end(); ++it) {
+            // TODO SERVER-33850: Rename KillAllSessionsByPattern and
+            // ScopedKillAllSessionsByPatternImpersonator to not refer to session kill.
+            if (const KillAllSessionsByPattern* pattern = matcher.match(it->first)) {
+                ScopedKillAllSessionsByPatternImpersonator impersonator(opCtx, *pattern);
+                workerFn(opCtx, &(it->second->txnState));
+            }
         }
     }
 }
 
+void SessionCatalog::updateStats(TransactionsStats* stats) {
+    long long numSessions = 0;
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lg(stripe.mutex);
+        numSessions += stripe.txnTable.size();
+    }
+
+    stats->setSessionsCount(numSessions);
+    stats->setSessionsCheckedOutCount(_numCheckedOut.load());
+    stats->setSessionCheckOutsCount(_numCheckOuts.load());
+    stats->setSessionCheckOutWaitsCount(_numCheckOutWaits.load());
+}
+
+SessionCatalog::Stripe& SessionCatalog::_getStripe(const LogicalSessionId& lsid) {
+    return _stripes[LogicalSessionIdHash()(lsid) % kNumStripes];
+}
+
 std::shared_ptr<SessionCatalog::SessionRuntimeInfo> SessionCatalog::_getOrCreateSessionRuntimeInfo(
-    WithLock, OperationContext* opCtx, const LogicalSessionId& lsid) {
+    WithLock, Stripe& stripe, OperationContext* opCtx, const LogicalSessionId& lsid) {
     invariant(!opCtx->lockState()->inAWriteUnitOfWork());
 
-    auto it = _txnTable.find(lsid);
-    if (it == _txnTable.end()) {
-        it = _txnTable.emplace(lsid, std::make_shared<SessionRuntimeInfo>(lsid)).first;
+    auto it = stripe.txnTable.find(lsid);
+    if (it == stripe.txnTable.end()) {
+        it = stripe.txnTable.emplace(lsid, std::make_shared<SessionRuntimeInfo>(lsid)).first;
     }
 
     return it->second;
 }
 
 void SessionCatalog::_releaseSession(const LogicalSessionId& lsid) {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    auto& stripe = _getStripe(lsid);
+    stdx::lock_guard<stdx::mutex> lg(stripe.mutex);
 
-    auto it = _txnTable.find(lsid);
-    invariant(it != _txnTable.end());
+    auto it = stripe.txnTable.find(lsid);
+    invariant(it != stripe.txnTable.end());
 
     auto& sri = it->second;
     invariant(sri->checkedOut);
 
     sri->checkedOut = false;
+    _numCheckedOut.subtractAndFetch(1);
     sri->availableCondVar.notify_one();
 }
 
@@ -28,10 +28,13 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/session.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
@@ -42,9 +45,14 @@ class OperationContext;
 class ScopedSession;
 class ScopedCheckedOutSession;
 class ServiceContext;
+class TransactionsStats;
 
 /**
  * Keeps track of the transaction runtime state for every active session on this instance.
+ *
+ * The sessions are split into stripes by the hash of their id, and each stripe has its own mutex,
+ * which also protects the check-out state of its sessions. Operations on different sessions
+ * therefore rarely contend with each other.
  */
 class SessionCatalog {
     MONGO_DISALLOW_COPYING(SessionCatalog);
@@ -118,14 +126,21 @@ public:
     void invalidateSessions(OperationContext* opCtx, boost::optional<BSONObj> singleSessionDoc);
 
     /**
-     * Iterates through the SessionCatalog and applies 'workerFn' to each Session. This locks the
-     * SessionCatalog.
+     * Iterates through the SessionCatalog and applies 'workerFn' to each Session. This locks each
+     * stripe of the SessionCatalog in turn.
      * TODO SERVER-33850: Take Matcher out of the SessionKiller namespace.
      */
     void scanSessions(OperationContext* opCtx,
                       const SessionKiller::Matcher& matcher,
                       stdx::function<void(OperationContext*, Session*)> workerFn);
 
+    /**
+     * Reports the number of cached and checked-out sessions, and how many check-outs had to wait
+     * for another operation to check the session back in, into the transactions section of
+     * serverStatus.
+     */
+    void updateStats(TransactionsStats* stats);
+
 private:
     struct SessionRuntimeInfo {
         SessionRuntimeInfo(LogicalSessionId lsid) : txnState(std::move(lsid)) {}
@@ -135,8 +150,8 @@ private:
         // check it out.
         bool checkedOut{false};
 
-        // Signaled when the state becomes available. Uses the transaction table's mutex to protect
-        // the state transitions.
+        // Signaled when the state becomes available. Uses the mutex of the session's stripe to
+        // protect the state transitions.
         stdx::condition_variable availableCondVar;
 
         // Must only be accessed when the state is kInUse and only by the operation context, which
@@ -148,21 +163,33 @@ private:
                                                       std::shared_ptr<SessionRuntimeInfo>,
                                                       LogicalSessionIdHash>;
 
+    struct Stripe {
+        stdx::mutex mutex;
+        SessionRuntimeInfoMap txnTable;
+    };
+
+    static const size_t kNumStripes = 64;
+
+    Stripe& _getStripe(const LogicalSessionId& lsid);
+
     /**
-     * May release and re-acquire it zero or more times before returning. The returned
-     * 'SessionRuntimeInfo' is guaranteed to be linked on the catalog's _txnTable as long as the
-     * lock is held.
+     * May release and re-acquire the stripe's lock zero or more times before returning. The
+     * returned 'SessionRuntimeInfo' is guaranteed to be linked on the stripe's txnTable as long as
+     * the lock is held.
      */
     std::shared_ptr<SessionRuntimeInfo> _getOrCreateSessionRuntimeInfo(
-        WithLock, OperationContext* opCtx, const LogicalSessionId& lsid);
+        WithLock, Stripe& stripe, OperationContext* opCtx, const LogicalSessionId& lsid);
 
     /**
      * Makes a session, previously checked out through 'checkoutSession', available again.
      */
     void _releaseSession(const LogicalSessionId& lsid);
 
-    stdx::mutex _mutex;
-    SessionRuntimeInfoMap _txnTable;
+    std::array<Stripe, kNumStripes> _stripes;
+
+    AtomicWord<long long> _numCheckedOut{0};
+    AtomicWord<long long> _numCheckOuts{0};
+    AtomicWord<long long> _numCheckOutWaits{0};
 };
 
 /**
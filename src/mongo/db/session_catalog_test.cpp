@@ -35,6 +35,7 @@
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/db/transactions_stats_gen.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
@@ -293,5 +294,37 @@ TEST_F(SessionCatalogTest, ScanSessions) {
     ASSERT_EQ(lsids.front(), lsid2);
 }
 
+TEST_F(SessionCatalogTest, StatsCountSessionsAndCheckOuts) {
+    TransactionsStats before;
+    catalog()->updateStats(&before);
+    ASSERT_EQ(0, before.getSessionsCount());
+
+    // Create sessions spread over the catalog's stripes.
+    std::vector<LogicalSessionId> lsids;
+    for (int i = 0; i < 100; ++i) {
+        lsids.push_back(makeLogicalSessionIdForTest());
+        catalog()->getOrCreateSession(opCtx(), lsids.back());
+    }
+
+    // Invalidating a single session only removes that session from its stripe.
+    catalog()->invalidateSessions(opCtx(), BSON("_id" << lsids.back().toBSON()));
+
+    opCtx()->setLogicalSessionId(lsids.front());
+    {
+        auto scopedSession = catalog()->checkOutSession(opCtx());
+
+        TransactionsStats stats;
+        catalog()->updateStats(&stats);
+        ASSERT_EQ(99, stats.getSessionsCount());
+        ASSERT_EQ(before.getSessionsCheckedOutCount() + 1, stats.getSessionsCheckedOutCount());
+        ASSERT_EQ(before.getSessionCheckOutsCount() + 1, stats.getSessionCheckOutsCount());
+        ASSERT_EQ(before.getSessionCheckOutWaitsCount(), stats.getSessionCheckOutWaitsCount());
+    }
+
+    TransactionsStats after;
+    catalog()->updateStats(&after);
+    ASSERT_EQ(before.getSessionsCheckedOutCount(), after.getSessionsCheckedOutCount());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -708,6 +708,52 @@ TEST_F(SessionTest, StashAndUnstashResources) {
     session.commitTransaction(opCtx());
 }
 
+TEST_F(SessionTest, StashReusesOperationLockerAndRecoveryUnit) {
+    const auto sessionId = makeLogicalSessionIdForTest();
+    const TxnNumber txnNum = 20;
+    opCtx()->setLogicalSessionId(sessionId);
+    opCtx()->setTxnNumber(txnNum);
+
+    Session::registerCursorKillFunction(noopKillCursorFunction);
+    Session::registerCursorExistsFunction(noopCursorExistsFunction);
+    Session session(sessionId);
+    session.refreshFromStorageIfNeeded(opCtx());
+
+    session.beginOrContinueTxn(opCtx(), txnNum, false, true, "testDB", "find");
+
+    repl::ReadConcernArgs readConcernArgs;
+    ASSERT_OK(readConcernArgs.initialize(BSON("find"
+                                              << "test"
+                                              << repl::ReadConcernArgs::kReadConcernFieldName
+                                              << BSON(repl::ReadConcernArgs::kLevelFieldName
+                                                      << "snapshot"))));
+    repl::ReadConcernArgs::get(opCtx()) = readConcernArgs;
+
+    session.unstashTransactionResources(opCtx(), "find");
+    Lock::GlobalRead lk(opCtx(), Date_t::now(), Lock::InterruptBehavior::kThrow);
+    ASSERT(lk.isLocked());
+
+    // The first stash gives the OperationContext a new Locker and RecoveryUnit.
+    session.stashTransactionResources(opCtx());
+    Locker* operationLocker = opCtx()->lockState();
+    RecoveryUnit* operationRecoveryUnit = opCtx()->recoveryUnit();
+    repl::ReadConcernArgs::get(opCtx()) = repl::ReadConcernArgs();
+
+    // Unstashing sets them aside, and the next stash hands them back.
+    session.unstashTransactionResources(opCtx(), "find");
+    ASSERT_NOT_EQUALS(operationLocker, opCtx()->lockState());
+    ASSERT_NOT_EQUALS(operationRecoveryUnit, opCtx()->recoveryUnit());
+    session.stashTransactionResources(opCtx());
+    ASSERT_EQUALS(operationLocker, opCtx()->lockState());
+    ASSERT_EQUALS(operationRecoveryUnit, opCtx()->recoveryUnit());
+    repl::ReadConcernArgs::get(opCtx()) = repl::ReadConcernArgs();
+
+    // Committing replaces the transaction's RecoveryUnit with the one set aside.
+    session.unstashTransactionResources(opCtx(), "find");
+    session.commitTransaction(opCtx());
+    ASSERT_EQUALS(operationRecoveryUnit, opCtx()->recoveryUnit());
+}
+
 TEST_F(SessionTest, ReportStashedResources) {
     Session::registerCursorKillFunction(noopKillCursorFunction);
     Session::registerCursorExistsFunction(noopCursorExistsFunction);
@@ -30,6 +30,8 @@
 
 #include "mongo/db/sessions_collection_sharded.h"
 
+#include <map>
+
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/canonical_query.h"
@@ -94,7 +96,38 @@ Status SessionsCollectionSharded::refreshSessions(OperationContext* opCtx,
         return response.toStatus();
     };
 
-    return doRefresh(NamespaceString::kLogicalSessionsNamespace, sessions, send);
+    // Group the sessions by the shard that owns their chunk, so that every batch of updates only
+    // targets a single shard.
+    auto routingInfo = Grid::get(opCtx)->catalogCache()->getCollectionRoutingInfo(
+        opCtx, NamespaceString::kLogicalSessionsNamespace);
+    if (!routingInfo.isOK() || !routingInfo.getValue().cm()) {
+        return doRefresh(NamespaceString::kLogicalSessionsNamespace, sessions, send);
+    }
+
+    std::vector<BSONObj> shardKeys;
+    shardKeys.reserve(sessions.size());
+    for (const auto& record : sessions) {
+        shardKeys.push_back(lsidQuery(record.getId()));
+    }
+
+    const auto chunks =
+        routingInfo.getValue().cm()->findIntersectingChunksWithSimpleCollation(shardKeys);
+
+    std::map<ShardId, LogicalSessionRecordSet> sessionsByShard;
+    auto chunkIt = chunks.begin();
+    for (const auto& record : sessions) {
+        sessionsByShard[(chunkIt++)->getShardId()].insert(record);
+    }
+
+    for (const auto& shardSessions : sessionsByShard) {
+        auto status =
+            doRefresh(NamespaceString::kLogicalSessionsNamespace, shardSessions.second, send);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    return Status::OK();
 }
 
 Status SessionsCollectionSharded::removeRecords(OperationContext* opCtx,
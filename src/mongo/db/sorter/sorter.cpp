@@ -47,8 +47,10 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <snappy.h>
+#include <third_party/murmurhash3/MurmurHash3.h>
 #include <vector>
 
 #include "mongo/base/string_data.h"
@@ -59,9 +61,11 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/memory_usage_tracker.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/unowned_ptr.h"
 
@@ -155,16 +159,7 @@ public:
     FileIterator(const std::string& fileName,
                  const Settings& settings,
                  std::shared_ptr<FileDeleter> fileDeleter)
-        : _settings(settings),
-          _done(false),
-          _fileName(fileName),
-          _fileDeleter(fileDeleter),
-          _file(_fileName.c_str(), std::ios::in | std::ios::binary) {
-        massert(16814,
-                str::stream() << "error opening file \"" << _fileName << "\": "
-                              << myErrnoWithDescription(),
-                _file.good());
-
+        : _settings(settings), _done(false), _fileName(fileName), _fileDeleter(fileDeleter) {
         massert(16815,
                 str::stream() << "unexpected empty file: " << _fileName,
                 boost::filesystem::file_size(_fileName) != 0);
@@ -194,12 +189,31 @@ private:
             fill();
     }
 
+    // The file is only opened once it is first read, so that a sorter with many spilled runs
+    // only holds descriptors and read-ahead buffers for the runs currently being merged.
+    void open() {
+        _readAheadBuffer.reset(new char[kReadAheadBytes]);
+        _file.rdbuf()->pubsetbuf(_readAheadBuffer.get(), kReadAheadBytes);
+        _file.open(_fileName.c_str(), std::ios::in | std::ios::binary);
+        massert(16814,
+                str::stream() << "error opening file \"" << _fileName << "\": "
+                              << myErrnoWithDescription(),
+                _file.good());
+    }
+
     void fill() {
+        if (!_file.is_open())
+            open();
+
         int32_t rawSize;
         read(&rawSize, sizeof(rawSize));
         if (_done)
             return;
 
+        uint32_t expectedChecksum;
+        read(&expectedChecksum, sizeof(expectedChecksum));
+        massert(50856, "file too short?", !_done);
+
         // negative size means compressed
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
@@ -208,6 +222,12 @@ private:
         read(_buffer.get(), blockSize);
         massert(16816, "file too short?", !_done);
 
+        uint32_t checksum;
+        MurmurHash3_x86_32(_buffer.get(), blockSize, 0, &checksum);
+        massert(50857,
+                str::stream() << "checksum mismatch in sort spill file \"" << _fileName << "\"",
+                checksum == expectedChecksum);
+
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
@@ -263,12 +283,17 @@ private:
         verify(_file.gcount() == static_cast<std::streamsize>(size));
     }
 
+    // Spilled blocks are around 64KB, so reading ahead by several blocks at a time turns the
+    // small reads of a merge that alternates between many files into larger sequential ones.
+    static const size_t kReadAheadBytes = 256 * 1024;
+
     const Settings _settings;
     bool _done;
     std::unique_ptr<char[]> _buffer;
     std::unique_ptr<BufReader> _reader;
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
+    std::unique_ptr<char[]> _readAheadBuffer;   // Must outlive _file
     std::ifstream _file;
 };
 
@@ -396,6 +421,72 @@ private:
     STLComparator _greater;                      // named so calls make sense
 };
 
+/**
+ * Merges groups of 'opts.mergeFanIn' consecutive spilled runs into new runs until there are no more
+ * than 'opts.mergeFanIn' runs left, so that the final merge reads from a bounded number of files.
+ * The groups of each pass are merged concurrently. Merging consecutive runs keeps the merge
+ * stable.
+ */
+template <typename Key, typename Value, typename Comparator>
+void mergeSpilledRuns(std::vector<std::shared_ptr<SortIteratorInterface<Key, Value>>>* runs,
+                      const SortOptions& opts,
+                      const Comparator& comp,
+                      const typename SortedFileWriter<Key, Value>::Settings& settings,
+                      SorterSpillStats* stats) {
+    typedef SortIteratorInterface<Key, Value> Iterator;
+    static const size_t kMaxMergeThreads = 4;
+
+    const size_t fanIn = std::max<size_t>(2, opts.mergeFanIn);
+    while (runs->size() > fanIn) {
+        const size_t numGroups = (runs->size() + fanIn - 1) / fanIn;
+        std::vector<std::shared_ptr<Iterator>> merged(numGroups);
+        std::vector<SorterSpillStats> groupStats(numGroups);
+        std::vector<Status> groupStatuses(numGroups, Status::OK());
+
+        AtomicUInt32 nextGroup;
+        auto mergeGroups = [&] {
+            for (size_t group; (group = nextGroup.fetchAndAdd(1)) < numGroups;) {
+                try {
+                    const auto begin = runs->begin() + group * fanIn;
+                    const auto end = runs->begin() + std::min(runs->size(), (group + 1) * fanIn);
+                    std::unique_ptr<Iterator> in(Iterator::merge(
+                        std::vector<std::shared_ptr<Iterator>>(begin, end), opts, comp));
+
+                    SortedFileWriter<Key, Value> writer(opts, settings);
+                    while (in->more()) {
+                        auto next = in->next();
+                        writer.addAlreadySorted(next.first, next.second);
+                    }
+                    merged[group].reset(writer.done());
+                    groupStats[group] = writer.getStats();
+                } catch (...) {
+                    groupStatuses[group] = exceptionToStatus();
+                }
+            }
+        };
+
+        std::vector<stdx::thread> threads;
+        for (size_t i = 1; i < std::min(numGroups, kMaxMergeThreads); i++) {
+            threads.emplace_back(mergeGroups);
+        }
+        mergeGroups();
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+
+        for (auto&& status : groupStatuses) {
+            uassertStatusOK(status);
+        }
+        for (auto&& groupStat : groupStats) {
+            stats->add(groupStat);
+        }
+        stats->mergePasses++;
+
+        // Dropping the merged runs deletes their files.
+        runs->swap(merged);
+    }
+}
+
 template <typename Key, typename Value, typename Comparator>
 class NoLimitSorter : public Sorter<Key, Value> {
 public:
@@ -417,6 +508,7 @@ public:
 
         _memUsed += key.memUsageForSorter();
         _memUsed += val.memUsageForSorter();
+        _trackedMemory.set(_memUsed);
 
         if (_memUsed > _opts.maxMemoryUsageBytes)
             spill();
@@ -429,6 +521,7 @@ public:
         }
 
         spill();
+        mergeSpilledRuns(&_iters, _opts, _comp, _settings, &_spillStats);
         return Iterator::merge(_iters, _opts, _comp);
     }
 
@@ -439,6 +532,12 @@ public:
     size_t memUsed() const {
         return _memUsed;
     }
+    size_t peakMemUsed() const {
+        return _trackedMemory.peakBytes();
+    }
+    SorterSpillStats spillStats() const {
+        return _spillStats;
+    }
 
 private:
     class STLComparator {
@@ -487,16 +586,21 @@ private:
         }
 
         _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+        _spillStats.add(writer.getStats());
+        ++_spillStats.spills;
 
         _memUsed = 0;
+        _trackedMemory.set(0);
     }
 
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
     size_t _memUsed;
+    TrackedMemory _trackedMemory{MemoryUsageTracker::Category::kSorter};
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+    SorterSpillStats _spillStats;
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -541,6 +645,12 @@ public:
     size_t memUsed() const {
         return _best.first.memUsageForSorter() + _best.second.memUsageForSorter();
     }
+    size_t peakMemUsed() const {
+        return memUsed();
+    }
+    SorterSpillStats spillStats() const {
+        return SorterSpillStats();
+    }
 
 private:
     const Comparator _comp;
@@ -590,6 +700,7 @@ public:
 
             _memUsed += key.memUsageForSorter();
             _memUsed += val.memUsageForSorter();
+            _trackedMemory.set(_memUsed);
 
             if (_data.size() == _opts.limit)
                 std::make_heap(_data.begin(), _data.end(), less);
@@ -612,6 +723,7 @@ public:
 
         _memUsed -= _data.front().first.memUsageForSorter();
         _memUsed -= _data.front().second.memUsageForSorter();
+        _trackedMemory.set(_memUsed);
 
         std::pop_heap(_data.begin(), _data.end(), less);
         _data.back() = contender;
@@ -628,6 +740,7 @@ public:
         }
 
         spill();
+        mergeSpilledRuns(&_iters, _opts, _comp, _settings, &_spillStats);
         return Iterator::merge(_iters, _opts, _comp);
     }
 
@@ -638,6 +751,12 @@ public:
     size_t memUsed() const {
         return _memUsed;
     }
+    size_t peakMemUsed() const {
+        return _trackedMemory.peakBytes();
+    }
+    SorterSpillStats spillStats() const {
+        return _spillStats;
+    }
 
 private:
     class STLComparator {
@@ -772,16 +891,21 @@ private:
         std::vector<Data>().swap(_data);
 
         _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+        _spillStats.add(writer.getStats());
+        ++_spillStats.spills;
 
         _memUsed = 0;
+        _trackedMemory.set(0);
     }
 
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
     size_t _memUsed;
+    TrackedMemory _trackedMemory{MemoryUsageTracker::Category::kSorter};
     std::vector<Data> _data;  // the "current" data. Organized as max-heap if size == limit.
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+    SorterSpillStats _spillStats;
 
     // See updateCutoff() for a full description of how these members are used.
     bool _haveCutoff;
@@ -856,6 +980,8 @@ void SortedFileWriter<Key, Value>::spill() {
     if (size == 0)
         return;
 
+    _stats.bytesSpilledUncompressed += size;
+
     std::string compressed;
     snappy::Compress(outBuffer, size, &compressed);
     verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
@@ -884,10 +1010,17 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
+    // Each block is checksummed as it is stored, so that a corrupted spill file fails the sort
+    // rather than producing wrong results.
+    uint32_t checksum;
+    MurmurHash3_x86_32(outBuffer, size, 0, &checksum);
+    _stats.bytesSpilled += sizeof(size) + sizeof(checksum) + size;
+
     // negative size means compressed
     size = shouldCompress ? -size : size;
     try {
         _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        _file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
         _file.write(outBuffer, std::abs(size));
 
     } catch (const std::exception&) {
@@ -98,8 +98,11 @@ struct SortOptions {
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
+    size_t mergeFanIn;           /// Most spilled runs merged at once. More runs than this are
+                                 /// first merged into larger runs, in parallel.
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    SortOptions()
+        : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false), mergeFanIn(64) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -122,6 +125,33 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& MergeFanIn(size_t newMergeFanIn) {
+        mergeFanIn = newMergeFanIn;
+        return *this;
+    }
+};
+
+/**
+ * Statistics about the data that a Sorter or SortedFileWriter wrote to disk.
+ */
+struct SorterSpillStats {
+    long long bytesSpilled = 0;              /// Bytes written to spill files.
+    long long bytesSpilledUncompressed = 0;  /// The same data before compression.
+    int mergePasses = 0;                     /// Passes that merged spilled runs into larger ones.
+    int spills = 0;                          /// Times the in-memory data was written to disk.
+
+    void add(const SorterSpillStats& other) {
+        bytesSpilled += other.bytesSpilled;
+        bytesSpilledUncompressed += other.bytesSpilledUncompressed;
+        mergePasses += other.mergePasses;
+        spills += other.spills;
+    }
+
+    /// Uncompressed bytes per byte written, or 0 if nothing was spilled.
+    double compressionRatio() const {
+        return bytesSpilled ? static_cast<double>(bytesSpilledUncompressed) / bytesSpilled : 0;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -175,6 +205,8 @@ public:
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     virtual int numFiles() const = 0;
     virtual size_t memUsed() const = 0;
+    virtual size_t peakMemUsed() const = 0;
+    virtual SorterSpillStats spillStats() const = 0;
 
 protected:
     Sorter() {}  // can only be constructed as a base
@@ -196,10 +228,15 @@ public:
     void addAlreadySorted(const Key&, const Value&);
     Iterator* done();  /// Can't add more data after calling done()
 
+    const SorterSpillStats& getStats() const {
+        return _stats;
+    }
+
 private:
     void spill();
 
     const Settings _settings;
+    SorterSpillStats _stats;
     std::string _fileName;
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/db/service_context_registrar.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/platform/random.h"
+#include "mongo/unittest/temp_dir.h"
+
+// Need the definitions of the sorter templates
+#include "mongo/db/sorter/sorter.cpp"
+
+namespace mongo {
+namespace {
+
+// Stub to avoid including the server environment library.
+ServiceContextRegistrar serviceContextCreator([]() {
+    return std::make_unique<ServiceContextNoop>();
+});
+
+/**
+ * Orders index keys the way an index build on {a: 1} does.
+ */
+class KeyComparator {
+public:
+    typedef std::pair<BSONObj, RecordId> Data;
+
+    int operator()(const Data& lhs, const Data& rhs) const {
+        int result = lhs.first.woCompare(rhs.first, BSONObj(), false);
+        if (result != 0) {
+            return result;
+        }
+        return lhs.second.compare(rhs.second);
+    }
+};
+
+using KeySorter = Sorter<BSONObj, RecordId>;
+
+/**
+ * Returns 'numKeys' index keys in random order.
+ */
+std::vector<BSONObj> makeKeys(int numKeys) {
+    PseudoRandom random(1);
+    std::vector<BSONObj> keys;
+    keys.reserve(numKeys);
+    for (int i = 0; i < numKeys; ++i) {
+        keys.push_back(BSON("" << random.nextInt64()));
+    }
+    return keys;
+}
+
+/**
+ * Adds 'keys' to a sorter with the given options and reads back the sorted output, as an index
+ * build does.
+ */
+void sortKeys(const std::vector<BSONObj>& keys, const SortOptions& opts) {
+    std::unique_ptr<KeySorter> sorter(KeySorter::make(opts, KeyComparator()));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        sorter->add(keys[i], RecordId(static_cast<long long>(i + 1)));
+    }
+
+    std::unique_ptr<KeySorter::Iterator> it(sorter->done());
+    while (it->more()) {
+        benchmark::DoNotOptimize(it->next());
+    }
+}
+
+/**
+ * Benchmark sorting keys which fit in the memory limit.
+ */
+void BM_SorterInMemory(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0));
+    const SortOptions opts = SortOptions().MaxMemoryUsageBytes(256 * 1024 * 1024);
+    for (auto keepRunning : state) {
+        sortKeys(keys, opts);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/**
+ * Benchmark sorting keys which exceed the memory limit, so that runs are spilled to disk and
+ * merged.
+ */
+void BM_SorterSpilling(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0));
+    unittest::TempDir tempDir("sorterBenchmark");
+    const SortOptions opts =
+        SortOptions().MaxMemoryUsageBytes(1024 * 1024).ExtSortAllowed().TempDir(tempDir.path());
+    for (auto keepRunning : state) {
+        sortKeys(keys, opts);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(BM_SorterInMemory)->Arg(10 * 1000)->Arg(100 * 1000);
+BENCHMARK(BM_SorterSpilling)->Arg(100 * 1000)->Arg(1000 * 1000);
+
+}  // namespace
+}  // namespace mongo
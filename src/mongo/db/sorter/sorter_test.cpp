@@ -544,6 +544,50 @@ class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     }
     enum { MEM_LIMIT = 32 * 1024 };
 };
+
+class MultiLevelMerge {
+public:
+    void run() {
+        unittest::TempDir tempDir("sorterTests");
+        const SortOptions opts = SortOptions()
+                                     .TempDir(tempDir.path())
+                                     .MaxMemoryUsageBytes(MEM_LIMIT)
+                                     .ExtSortAllowed()
+                                     .MergeFanIn(4);
+        {
+            std::vector<int> values;
+            for (int i = 0; i < NUM_ITEMS; i++)
+                values.push_back(i);
+            PseudoRandom random(int64_t(time(0)));
+            std::shuffle(values.begin(), values.end(), random.urbg());
+
+            std::shared_ptr<IWSorter> sorter(IWSorter::make(opts, IWComparator(ASC)));
+            for (int value : values)
+                sorter->add(value, -value);
+            ASSERT_GREATER_THAN(sorter->numFiles(), 16);
+            const int runsBeforeDone = sorter->numFiles();
+
+            std::shared_ptr<IWIterator> result(sorter->done());
+
+            // The runs are merged four at a time until no more than four are left.
+            const SorterSpillStats stats = sorter->spillStats();
+            ASSERT_GREATER_THAN_OR_EQUALS(stats.mergePasses, 2);
+            ASSERT_LESS_THAN_OR_EQUALS(sorter->numFiles(), 4);
+            ASSERT_GREATER_THAN(stats.bytesSpilled, 0);
+            ASSERT_GREATER_THAN(stats.bytesSpilledUncompressed, 0);
+            ASSERT_GREATER_THAN_OR_EQUALS(stats.spills, runsBeforeDone);
+            ASSERT_GREATER_THAN(sorter->peakMemUsed(), 0U);
+
+            ASSERT_ITERATORS_EQUIVALENT(result, make_shared<IntIterator>(0, NUM_ITEMS));
+        }
+        ASSERT(boost::filesystem::is_empty(tempDir.path()));
+    }
+
+    enum Constants {
+        NUM_ITEMS = 100 * 1000,
+        MEM_LIMIT = 16 * 1024,
+    };
+};
 }
 
 class SorterSuite : public mongo::unittest::Suite {
@@ -565,6 +609,7 @@ public:
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/true>>();    // fits in mem
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/false>>();  // spills
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/true>>();   // spills
+        add<SorterTests::MultiLevelMerge>();
     }
 };
 
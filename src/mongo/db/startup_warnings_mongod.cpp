@@ -44,6 +44,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/numa_placement.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/version.h"
 
@@ -182,7 +183,8 @@ void logMongodStartupWarnings(const StorageGlobalParams& storageParams,
               << "Failed to probe \"" << e.path1().string() << "\": " << e.code().message()
               << startupWarningsLog;
     }
-    if (hasMultipleNumaNodes) {
+    // With numaThreadPlacement, threads prefer memory on their own node rather than interleaving.
+    if (hasMultipleNumaNodes && !NumaPlacement::get().isEnabled()) {
         // We are on a box with a NUMA enabled kernel and more than 1 numa node (they start at
         // node0)
         // Now we look at the first line of /proc/self/numa_maps
@@ -191,12 +191,44 @@ void NetworkCounter::hitLogicalOut(long long bytes) {
     }
 }
 
+void NetworkCounter::TLSHandshakes::hit(bool wasResumed, long long micros) {
+    total.fetchAndAdd(1);
+    if (wasResumed) {
+        resumed.fetchAndAdd(1);
+    }
+    totalMicros.fetchAndAdd(micros);
+}
+
+void NetworkCounter::TLSHandshakes::append(BSONObjBuilder& b) const {
+    b.append("total", static_cast<long long>(total.loadRelaxed()));
+    b.append("resumed", static_cast<long long>(resumed.loadRelaxed()));
+    b.append("totalMicros", static_cast<long long>(totalMicros.loadRelaxed()));
+}
+
+void NetworkCounter::hitIngressTLSHandshake(bool resumed, long long micros) {
+    _ingressTLSHandshakes.hit(resumed, micros);
+}
+
+void NetworkCounter::hitEgressTLSHandshake(bool resumed, long long micros) {
+    _egressTLSHandshakes.hit(resumed, micros);
+}
+
 void NetworkCounter::append(BSONObjBuilder& b) {
     b.append("bytesIn", static_cast<long long>(_together.logicalBytesIn.loadRelaxed()));
     b.append("bytesOut", static_cast<long long>(_logicalBytesOut.loadRelaxed()));
     b.append("physicalBytesIn", static_cast<long long>(_physicalBytesIn.loadRelaxed()));
     b.append("physicalBytesOut", static_cast<long long>(_physicalBytesOut.loadRelaxed()));
     b.append("numRequests", static_cast<long long>(_together.requests.loadRelaxed()));
+
+    BSONObjBuilder tlsBuilder(b.subobjStart("tlsHandshakes"));
+    {
+        BSONObjBuilder ingressBuilder(tlsBuilder.subobjStart("ingress"));
+        _ingressTLSHandshakes.append(ingressBuilder);
+    }
+    {
+        BSONObjBuilder egressBuilder(tlsBuilder.subobjStart("egress"));
+        _egressTLSHandshakes.append(egressBuilder);
+    }
 }
 
 
@@ -103,9 +103,23 @@ public:
     void hitLogicalIn(long long bytes);
     void hitLogicalOut(long long bytes);
 
+    // Count a successful TLS handshake on an incoming or outgoing connection, and whether it
+    // resumed an earlier session
+    void hitIngressTLSHandshake(bool resumed, long long micros);
+    void hitEgressTLSHandshake(bool resumed, long long micros);
+
     void append(BSONObjBuilder& b);
 
 private:
+    struct TLSHandshakes {
+        AtomicInt64 total{0};
+        AtomicInt64 resumed{0};
+        AtomicInt64 totalMicros{0};
+
+        void hit(bool resumed, long long micros);
+        void append(BSONObjBuilder& b) const;
+    };
+
     CacheAligned<AtomicInt64> _physicalBytesIn{0};
     CacheAligned<AtomicInt64> _physicalBytesOut{0};
 
@@ -120,6 +134,9 @@ private:
                   "cache line spill");
 
     CacheAligned<AtomicInt64> _logicalBytesOut{0};
+
+    CacheAligned<TLSHandshakes> _ingressTLSHandshakes{};
+    CacheAligned<TLSHandshakes> _egressTLSHandshakes{};
 };
 
 extern NetworkCounter networkCounter;
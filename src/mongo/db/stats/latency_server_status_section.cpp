@@ -49,11 +49,13 @@ public:
     BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const {
         BSONObjBuilder latencyBuilder;
         bool includeHistograms = false;
+        bool includePercentiles = false;
         if (configElem.type() == BSONType::Object) {
             includeHistograms = configElem.Obj()["histograms"].trueValue();
+            includePercentiles = configElem.Obj()["percentiles"].trueValue();
         }
         Top::get(opCtx->getServiceContext())
-            .appendGlobalLatencyStats(includeHistograms, &latencyBuilder);
+            .appendGlobalLatencyStats(includeHistograms, includePercentiles, &latencyBuilder);
         return latencyBuilder.obj();
     }
 } globalHistogramServerStatusSection;
@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/latency_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+int LatencySketch::getBucket(uint64_t latency) {
+    // Latencies below kSubBuckets each have a bucket of their own.
+    if (latency < static_cast<uint64_t>(kSubBuckets)) {
+        return static_cast<int>(latency);
+    }
+
+    int log2 = 63 - countLeadingZeros64(latency);
+    if (log2 >= kMaxExponent) {
+        return kNumBuckets - 1;
+    }
+
+    int subBucket = static_cast<int>(latency >> (log2 - kSubBucketBits)) & (kSubBuckets - 1);
+    return (log2 - kSubBucketBits + 1) * kSubBuckets + subBucket;
+}
+
+uint64_t LatencySketch::getBucketLowerBound(int bucket) {
+    int group = bucket / kSubBuckets;
+    uint64_t subBucket = bucket % kSubBuckets;
+    if (group == 0) {
+        return subBucket;
+    }
+    int log2 = group + kSubBucketBits - 1;
+    return (1ULL << log2) + (subBucket << (log2 - kSubBucketBits));
+}
+
+uint64_t LatencySketch::getBucketWidth(int bucket) {
+    int group = bucket / kSubBuckets;
+    if (group == 0) {
+        return 1;
+    }
+    return 1ULL << (group - 1);
+}
+
+void LatencySketch::increment(uint64_t latency) {
+    _buckets[getBucket(latency)]++;
+    _count++;
+}
+
+void LatencySketch::merge(const LatencySketch& other) {
+    for (int i = 0; i < kNumBuckets; i++) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+}
+
+uint64_t LatencySketch::getQuantile(double quantile) const {
+    invariant(quantile >= 0 && quantile <= 1);
+    if (_count == 0) {
+        return 0;
+    }
+
+    // The rank of the latency at the quantile, counting from 1.
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * _count)));
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; i++) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            // Report the middle of the bucket, which halves the worst case error.
+            return getBucketLowerBound(i) + (getBucketWidth(i) - 1) / 2;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
+void LatencySketch::appendPercentiles(BSONObjBuilder* builder) const {
+    builder->append("p50", static_cast<long long>(getQuantile(0.5)));
+    builder->append("p90", static_cast<long long>(getQuantile(0.9)));
+    builder->append("p99", static_cast<long long>(getQuantile(0.99)));
+    builder->append("p999", static_cast<long long>(getQuantile(0.999)));
+}
+
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Records latencies into log-linear buckets in order to estimate percentiles of their
+ * distribution. Each power of two is split into kSubBuckets buckets of equal width, so an estimated
+ * percentile is off by at most 1 / (2 * kSubBuckets) of the true value, while the memory used is
+ * fixed. Sketches can be merged without losing accuracy.
+ *
+ * Note: This class is not thread-safe.
+ */
+class LatencySketch {
+public:
+    static const int kSubBucketBits = 3;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+
+    // Latencies of 2^kMaxExponent micros (about 12.7 days) or more share the last bucket.
+    static const int kMaxExponent = 40;
+
+    static const int kNumBuckets = kSubBuckets * (kMaxExponent - kSubBucketBits + 1);
+
+    /**
+     * Records one latency.
+     */
+    void increment(uint64_t latency);
+
+    /**
+     * Adds the latencies recorded in 'other' to this sketch.
+     */
+    void merge(const LatencySketch& other);
+
+    /**
+     * Returns the number of latencies recorded.
+     */
+    uint64_t count() const {
+        return _count;
+    }
+
+    /**
+     * Returns an estimate of the latency below which the fraction 'quantile' of the recorded
+     * latencies fall, or 0 if nothing was recorded. 'quantile' must be in [0, 1].
+     */
+    uint64_t getQuantile(double quantile) const;
+
+    /**
+     * Appends the estimated 50th, 90th, 99th and 99.9th percentiles.
+     */
+    void appendPercentiles(BSONObjBuilder* builder) const;
+
+    static int getBucket(uint64_t latency);
+
+    static uint64_t getBucketLowerBound(int bucket);
+
+    static uint64_t getBucketWidth(int bucket);
+
+private:
+    std::array<uint64_t, kNumBuckets> _buckets{};
+    uint64_t _count = 0;
+};
+
+}  // namespace mongo
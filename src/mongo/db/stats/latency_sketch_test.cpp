@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/latency_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(LatencySketch, BucketsCoverTheLatenciesMappedToThem) {
+    for (int i = 0; i < LatencySketch::kNumBuckets - 1; i++) {
+        uint64_t lowerBound = LatencySketch::getBucketLowerBound(i);
+        uint64_t upperBound = lowerBound + LatencySketch::getBucketWidth(i);
+        ASSERT_EQUALS(i, LatencySketch::getBucket(lowerBound));
+        ASSERT_EQUALS(i, LatencySketch::getBucket(upperBound - 1));
+        ASSERT_EQUALS(upperBound, LatencySketch::getBucketLowerBound(i + 1));
+    }
+    ASSERT_EQUALS(LatencySketch::kNumBuckets - 1,
+                  LatencySketch::getBucket(1ULL << LatencySketch::kMaxExponent));
+    ASSERT_EQUALS(LatencySketch::kNumBuckets - 1,
+                  LatencySketch::getBucket(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(LatencySketch, EmptySketchReportsZero) {
+    LatencySketch sketch;
+    ASSERT_EQUALS(0U, sketch.count());
+    ASSERT_EQUALS(0U, sketch.getQuantile(0.99));
+}
+
+TEST(LatencySketch, QuantilesAreWithinTheRelativeErrorBound) {
+    LatencySketch sketch;
+    const uint64_t kNumLatencies = 100000;
+    for (uint64_t i = 1; i <= kNumLatencies; i++) {
+        sketch.increment(i);
+    }
+    ASSERT_EQUALS(kNumLatencies, sketch.count());
+
+    const double kMaxRelativeError = 1.0 / (2 * LatencySketch::kSubBuckets);
+    for (double quantile : {0.0, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+        double expected = std::max(1.0, std::ceil(quantile * kNumLatencies));
+        double estimate = sketch.getQuantile(quantile);
+        ASSERT_LTE(std::abs(estimate - expected), expected * kMaxRelativeError)
+            << "quantile: " << quantile << ", estimate: " << estimate;
+    }
+}
+
+TEST(LatencySketch, MergingMatchesRecordingIntoOneSketch) {
+    LatencySketch combined, first, second;
+    for (uint64_t i = 0; i < 1000; i++) {
+        combined.increment(i * 7);
+        (i % 2 ? first : second).increment(i * 7);
+    }
+    first.merge(second);
+
+    ASSERT_EQUALS(combined.count(), first.count());
+    for (double quantile : {0.5, 0.9, 0.99, 0.999}) {
+        ASSERT_EQUALS(combined.getQuantile(quantile), first.getQuantile(quantile));
+    }
+}
+
+TEST(LatencySketch, AppendsPercentiles) {
+    LatencySketch sketch;
+    for (uint64_t i = 0; i < 1000; i++) {
+        sketch.increment(5);
+    }
+    sketch.increment(1ULL << 30);
+
+    BSONObjBuilder builder;
+    sketch.appendPercentiles(&builder);
+    BSONObj out = builder.obj();
+    ASSERT_EQUALS(5, out["p50"].Long());
+    ASSERT_EQUALS(5, out["p90"].Long());
+    ASSERT_EQUALS(5, out["p99"].Long());
+    ASSERT_EQUALS(5, out["p999"].Long());
+}
+
+}  // namespace
+}  // namespace mongo
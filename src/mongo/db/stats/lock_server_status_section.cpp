@@ -124,5 +124,28 @@ public:
 
 } lockStatsServerStatusSection;
 
+
+class LockWaitTimeHistogramsServerStatusSection : public ServerStatusSection {
+public:
+    LockWaitTimeHistogramsServerStatusSection() : ServerStatusSection("lockWaitTimeHistograms") {}
+
+    virtual bool includeByDefault() const {
+        return true;
+    }
+
+    virtual BSONObj generateSection(OperationContext* opCtx,
+                                    const BSONElement& configElement) const {
+        BSONObjBuilder ret;
+
+        SingleThreadedLockWaitTimeHistograms histograms;
+        reportGlobalLockWaitTimeHistograms(&histograms);
+
+        histograms.report(&ret);
+
+        return ret.obj();
+    }
+
+} lockWaitTimeHistogramsServerStatusSection;
+
 }  // namespace
 }  // namespace mongo
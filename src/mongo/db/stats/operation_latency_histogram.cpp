@@ -94,6 +94,7 @@ const std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets>
 void OperationLatencyHistogram::_append(const HistogramData& data,
                                         const char* key,
                                         bool includeHistograms,
+                                        bool includePercentiles,
                                         BSONObjBuilder* builder) const {
 
     BSONObjBuilder histogramBuilder(builder->subobjStart(key));
@@ -109,15 +110,22 @@ void OperationLatencyHistogram::_append(const HistogramData& data,
         }
         arrayBuilder.doneFast();
     }
+    if (includePercentiles) {
+        BSONObjBuilder percentilesBuilder(histogramBuilder.subobjStart("percentiles"));
+        data.sketch.appendPercentiles(&percentilesBuilder);
+        percentilesBuilder.doneFast();
+    }
     histogramBuilder.append("latency", static_cast<long long>(data.sum));
     histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
     histogramBuilder.doneFast();
 }
 
-void OperationLatencyHistogram::append(bool includeHistograms, BSONObjBuilder* builder) const {
-    _append(_reads, "reads", includeHistograms, builder);
-    _append(_writes, "writes", includeHistograms, builder);
-    _append(_commands, "commands", includeHistograms, builder);
+void OperationLatencyHistogram::append(bool includeHistograms,
+                                       bool includePercentiles,
+                                       BSONObjBuilder* builder) const {
+    _append(_reads, "reads", includeHistograms, includePercentiles, builder);
+    _append(_writes, "writes", includeHistograms, includePercentiles, builder);
+    _append(_commands, "commands", includeHistograms, includePercentiles, builder);
 }
 
 // Computes the log base 2 of value, and checks for cases of split buckets.
@@ -151,6 +159,7 @@ void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, His
     data->buckets[bucket]++;
     data->entryCount++;
     data->sum += latency;
+    data->sketch.increment(latency);
 }
 
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
@@ -30,6 +30,7 @@
 #include <array>
 
 #include "mongo/db/commands.h"
+#include "mongo/db/stats/latency_sketch.h"
 
 namespace mongo {
 
@@ -53,15 +54,17 @@ public:
     void increment(uint64_t latency, Command::ReadWriteType type);
 
     /**
-     * Appends the three histograms with latency totals and operation counts.
+     * Appends the three histograms with latency totals and operation counts, and optionally the
+     * buckets and the estimated latency percentiles of each.
      */
-    void append(bool includeHistograms, BSONObjBuilder* builder) const;
+    void append(bool includeHistograms, bool includePercentiles, BSONObjBuilder* builder) const;
 
 private:
     struct HistogramData {
         std::array<uint64_t, kMaxBuckets> buckets{};
         uint64_t entryCount = 0;
         uint64_t sum = 0;
+        LatencySketch sketch;
     };
 
     static int _getBucket(uint64_t latency);
@@ -71,6 +74,7 @@ private:
     void _append(const HistogramData& data,
                  const char* key,
                  bool includeHistograms,
+                 bool includePercentiles,
                  BSONObjBuilder* builder) const;
 
     void _incrementData(uint64_t latency, int bucket, HistogramData* data);
@@ -54,7 +54,7 @@ TEST(OperationLatencyHistogram, EnsureIncrementsStored) {
         hist.increment(i, Command::ReadWriteType::kCommand);
     }
     BSONObjBuilder outBuilder;
-    hist.append(false, &outBuilder);
+    hist.append(false, false, &outBuilder);
     BSONObj out = outBuilder.done();
     ASSERT_EQUALS(out["reads"]["ops"].Long(), kMaxBuckets);
     ASSERT_EQUALS(out["writes"]["ops"].Long(), kMaxBuckets);
@@ -75,7 +75,7 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
     // The additional +1 because of the first boundary.
     uint64_t expectedSum = 3 * std::accumulate(kLowerBounds.begin(), kLowerBounds.end(), 0ULL) + 1;
     BSONObjBuilder outBuilder;
-    hist.append(true, &outBuilder);
+    hist.append(true, false, &outBuilder);
     BSONObj out = outBuilder.done();
     ASSERT_EQUALS(static_cast<uint64_t>(out["reads"]["latency"].Long()), expectedSum);
 
@@ -89,4 +89,23 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, AppendsPercentilesOnlyWhenRequested) {
+    OperationLatencyHistogram hist;
+    for (int i = 1; i <= 100; i++) {
+        hist.increment(i, Command::ReadWriteType::kWrite);
+    }
+
+    BSONObjBuilder withoutBuilder;
+    hist.append(false, false, &withoutBuilder);
+    ASSERT_FALSE(withoutBuilder.done()["writes"].Obj().hasField("percentiles"));
+
+    BSONObjBuilder withBuilder;
+    hist.append(false, true, &withBuilder);
+    BSONObj out = withBuilder.done();
+    ASSERT_EQUALS(out["reads"]["percentiles"]["p99"].Long(), 0);
+    // The estimates are the middles of the buckets [48, 51] and [96, 103].
+    ASSERT_EQUALS(out["writes"]["percentiles"]["p50"].Long(), 49);
+    ASSERT_EQUALS(out["writes"]["percentiles"]["p99"].Long(), 99);
+}
 }  // namespace mongo
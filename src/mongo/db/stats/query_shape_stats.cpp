@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(queryShapeStatsMaxEntries, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "queryShapeStatsMaxEntries must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+const auto getQueryShapeStats = ServiceContext::declareDecoration<QueryShapeStats>();
+
+}  // namespace
+
+QueryShapeStats& QueryShapeStats::get(ServiceContext* service) {
+    return getQueryShapeStats(service);
+}
+
+std::size_t QueryShapeStats::Key::Hasher::operator()(const Key& key) const {
+    return std::hash<std::string>()(key.ns) ^ static_cast<std::size_t>(key.queryHash);
+}
+
+void QueryShapeStats::record(const Execution& execution) {
+    const int maxEntries = queryShapeStatsMaxEntries.load();
+    if (maxEntries == 0) {
+        return;
+    }
+    const std::size_t maxPartitionEntries = (maxEntries + kNumPartitions - 1) / kNumPartitions;
+
+    Key key{execution.ns.toString(), execution.queryHash};
+    const Date_t now = Date_t::now();
+
+    auto& partition = _partitions[execution.queryHash % kNumPartitions];
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+
+    auto it = partition.entries.find(key);
+    if (it == partition.entries.end()) {
+        Entry entry;
+        entry.firstExecuted = now;
+        partition.entries.add(key, std::move(entry));
+        it = partition.entries.begin();
+
+        // The new entry is the most recently used, so eviction starts from the other end.
+        while (partition.entries.size() > maxPartitionEntries) {
+            partition.entries.erase(std::prev(partition.entries.end()));
+        }
+    }
+
+    Entry& entry = it->second;
+    entry.lastExecuted = now;
+    if (execution.isGetMore) {
+        entry.getMores++;
+    } else {
+        entry.executions++;
+        entry.planSummary = execution.planSummary.toString();
+    }
+    entry.totalLatencyMicros += execution.latencyMicros;
+    entry.keysExamined += execution.keysExamined;
+    entry.docsExamined += execution.docsExamined;
+    entry.nreturned += execution.nreturned;
+    // Latencies can be negative if the system clock was reset during the operation.
+    entry.latencies.increment(std::max(0LL, execution.latencyMicros));
+}
+
+std::vector<BSONObj> QueryShapeStats::getStats() const {
+    std::vector<BSONObj> stats;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& keyAndEntry : partition.entries) {
+            stats.push_back(keyAndEntry.second.toBSON(keyAndEntry.first));
+        }
+    }
+    return stats;
+}
+
+void QueryShapeStats::clear() {
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.entries.clear();
+    }
+}
+
+BSONObj QueryShapeStats::Entry::toBSON(const Key& key) const {
+    BSONObjBuilder builder;
+    builder.append("ns", key.ns);
+    builder.append("queryHash", unsignedIntToFixedLengthHex(key.queryHash));
+    builder.append("planSummary", planSummary);
+    builder.append("firstExecuted", firstExecuted);
+    builder.append("lastExecuted", lastExecuted);
+    builder.append("executions", executions);
+    builder.append("getMores", getMores);
+    builder.append("totalLatencyMicros", totalLatencyMicros);
+    {
+        BSONObjBuilder latencyBuilder(builder.subobjStart("latencyMicros"));
+        latencies.appendPercentiles(&latencyBuilder);
+    }
+    builder.append("keysExamined", keysExamined);
+    builder.append("docsExamined", docsExamined);
+    builder.append("nreturned", nreturned);
+    return builder.obj();
+}
+
+}  // namespace mongo
@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/stats/latency_sketch.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A bounded, in-memory table of execution statistics aggregated by query shape, in the spirit of
+ * Postgres's pg_stat_statements. Entries are keyed by namespace and plan cache query hash, so every
+ * operation that planned a query of the same shape against the same collection is added to the
+ * same entry. Once the table holds "queryShapeStatsMaxEntries" entries, recording a new shape
+ * evicts the least recently executed one.
+ *
+ * The table is split into partitions by query hash, each with its own mutex, so that concurrent
+ * operations rarely contend on recording.
+ */
+class QueryShapeStats {
+    MONGO_DISALLOW_COPYING(QueryShapeStats);
+
+public:
+    static const int kNumPartitions = 16;
+
+    /**
+     * Describes one completed operation.
+     */
+    struct Execution {
+        StringData ns;
+        std::uint64_t queryHash = 0;
+        StringData planSummary;
+        bool isGetMore = false;
+        long long latencyMicros = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+    };
+
+    static QueryShapeStats& get(ServiceContext* service);
+
+    QueryShapeStats() = default;
+
+    /**
+     * Adds 'execution' to the entry for its shape, creating the entry if needed. Does nothing if
+     * the table is disabled by setting "queryShapeStatsMaxEntries" to 0.
+     */
+    void record(const Execution& execution);
+
+    /**
+     * Returns a document describing each entry, in no particular order.
+     */
+    std::vector<BSONObj> getStats() const;
+
+    /**
+     * Removes every entry.
+     */
+    void clear();
+
+private:
+    struct Key {
+        bool operator==(const Key& other) const {
+            return queryHash == other.queryHash && ns == other.ns;
+        }
+
+        struct Hasher {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        std::string ns;
+        std::uint64_t queryHash;
+    };
+
+    struct Entry {
+        BSONObj toBSON(const Key& key) const;
+
+        std::string planSummary;
+        Date_t firstExecuted;
+        Date_t lastExecuted;
+        long long executions = 0;
+        long long getMores = 0;
+        long long totalLatencyMicros = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        LatencySketch latencies;
+    };
+
+    struct Partition {
+        // Eviction is done by QueryShapeStats, since the size limit can change at runtime.
+        mutable stdx::mutex mutex;
+        LRUCache<Key, Entry, Key::Hasher> entries{std::numeric_limits<std::size_t>::max()};
+    };
+
+    std::array<Partition, kNumPartitions> _partitions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+namespace {
+
+QueryShapeStats::Execution makeExecution(StringData ns, std::uint64_t queryHash) {
+    QueryShapeStats::Execution execution;
+    execution.ns = ns;
+    execution.queryHash = queryHash;
+    execution.planSummary = "IXSCAN { a: 1 }";
+    execution.latencyMicros = 5;
+    execution.keysExamined = 10;
+    execution.docsExamined = 5;
+    execution.nreturned = 2;
+    return execution;
+}
+
+TEST(QueryShapeStats, AggregatesExecutionsOfTheSameShape) {
+    QueryShapeStats stats;
+    stats.record(makeExecution("test.coll", 42));
+    stats.record(makeExecution("test.coll", 42));
+
+    auto getMore = makeExecution("test.coll", 42);
+    getMore.isGetMore = true;
+    stats.record(getMore);
+
+    auto entries = stats.getStats();
+    ASSERT_EQUALS(1U, entries.size());
+    ASSERT_EQUALS("test.coll", entries[0]["ns"].String());
+    ASSERT_EQUALS("IXSCAN { a: 1 }", entries[0]["planSummary"].String());
+    ASSERT_EQUALS(2, entries[0]["executions"].Long());
+    ASSERT_EQUALS(1, entries[0]["getMores"].Long());
+    ASSERT_EQUALS(15, entries[0]["totalLatencyMicros"].Long());
+    ASSERT_EQUALS(30, entries[0]["keysExamined"].Long());
+    ASSERT_EQUALS(15, entries[0]["docsExamined"].Long());
+    ASSERT_EQUALS(6, entries[0]["nreturned"].Long());
+    ASSERT_EQUALS(5, entries[0]["latencyMicros"]["p50"].Long());
+}
+
+TEST(QueryShapeStats, SeparatesShapesByNamespaceAndHash) {
+    QueryShapeStats stats;
+    stats.record(makeExecution("test.coll", 42));
+    stats.record(makeExecution("test.other", 42));
+    stats.record(makeExecution("test.coll", 43));
+
+    ASSERT_EQUALS(3U, stats.getStats().size());
+
+    stats.clear();
+    ASSERT_EQUALS(0U, stats.getStats().size());
+}
+
+TEST(QueryShapeStats, EvictsShapesBeyondTheSizeLimit) {
+    QueryShapeStats stats;
+    for (std::uint64_t queryHash = 0; queryHash < 5000; queryHash++) {
+        stats.record(makeExecution("test.coll", queryHash));
+    }
+
+    // Each partition keeps its share of the default limit of 1000 entries, rounded up.
+    const std::size_t maxEntries = QueryShapeStats::kNumPartitions *
+        ((1000 + QueryShapeStats::kNumPartitions - 1) / QueryShapeStats::kNumPartitions);
+    auto entries = stats.getStats();
+    ASSERT_EQUALS(maxEntries, entries.size());
+
+    // The most recently executed shape is kept.
+    bool foundLast = false;
+    for (const auto& entry : entries) {
+        foundLast = foundLast || entry["queryHash"].String() == unsignedIntToFixedLengthHex(4999);
+    }
+    ASSERT_TRUE(foundLast);
+}
+
+}  // namespace
+}  // namespace mongo
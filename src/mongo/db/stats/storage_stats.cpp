@@ -109,6 +109,45 @@ Status appendCollectionStorageStats(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status appendCollectionCacheStats(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  BSONObjBuilder* result) {
+    AutoGetCollectionForReadCommand ctx(opCtx, nss);
+    if (!ctx.getDb()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Database [" << nss.db().toString() << "] not found."};
+    }
+
+    Collection* collection = ctx.getCollection();
+    if (!collection) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Collection [" << nss.toString() << "] not found."};
+    }
+
+    // Nothing is appended for collections that have not been sampled yet, or when the storage
+    // engine does not sample its cache at all.
+    collection->getRecordStore()->appendCacheStats(opCtx, result);
+
+    IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    BSONObjBuilder indexDetails;
+
+    IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator(opCtx, false);
+    while (i.more()) {
+        const IndexDescriptor* descriptor = i.next();
+        IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
+        invariant(iam);
+
+        BSONObjBuilder bob;
+        if (iam->appendCacheStats(opCtx, &bob)) {
+            indexDetails.append(descriptor->indexName(), bob.obj());
+        }
+    }
+
+    result->append("indexDetails", indexDetails.obj());
+
+    return Status::OK();
+}
+
 Status appendCollectionRecordCount(OperationContext* opCtx,
                                    const NamespaceString& nss,
                                    BSONObjBuilder* result) {
@@ -44,6 +44,14 @@ Status appendCollectionStorageStats(OperationContext* opCtx,
                                     const BSONObj& param,
                                     BSONObjBuilder* builder);
 
+/**
+ * Appends to 'builder' the storage engine's cache residency and eviction statistics for the
+ * collection represented by 'nss' and for each of its indexes.
+ */
+Status appendCollectionCacheStats(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  BSONObjBuilder* builder);
+
 /**
  * Appends the collection record count to 'builder' for the collection represented by 'nss'.
  */
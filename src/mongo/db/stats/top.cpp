@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -48,6 +49,24 @@ namespace {
 
 const auto getTop = ServiceContext::declareDecoration<Top>();
 
+/**
+ * Spreads threads round-robin over 'nBuffers' record buffers. A thread keeps the same buffer for
+ * its lifetime, so the lock of that buffer is rarely contended.
+ */
+size_t bufferIndexForThisThread(size_t nBuffers) {
+    static AtomicUInt32 nextBufferIndex;
+    thread_local const size_t bufferIndex = nextBufferIndex.fetchAndAdd(1);
+    return bufferIndex % nBuffers;
+}
+
+/**
+ * Only operations that came from a user count towards the latency histograms.
+ */
+bool shouldCountLatency(OperationContext* opCtx) {
+    Client* client = opCtx->getClient();
+    return client->isFromUserConnection() && !client->isInDirectClient();
+}
+
 }  // namespace
 
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
@@ -67,6 +86,8 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       remove(older.remove, newer.remove),
       commands(older.commands, newer.commands) {}
 
+Top::Top() = default;
+
 // static
 Top& Top::get(ServiceContext* service) {
     return getTop(service);
@@ -82,35 +103,89 @@ void Top::record(OperationContext* opCtx,
     if (ns[0] == '?')
         return;
 
-    auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    _bufferRecord(opCtx, ns, logicalOp, lockType, micros, command, readWriteType);
+}
 
-    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped) {
-        _lastDropped = "";
-        return;
+void Top::_bufferRecord(OperationContext* opCtx,
+                        StringData ns,
+                        LogicalOp logicalOp,
+                        LockType lockType,
+                        long long micros,
+                        bool command,
+                        Command::ReadWriteType readWriteType) {
+    RecordBuffer& buffer = _buffers[bufferIndexForThisThread(kNumRecordBuffers)];
+    stdx::lock_guard<SimpleMutex> bufferLk(buffer.lock);
+
+    PendingRecord& pending = buffer.records[buffer.size++];
+    pending.ns.assign(ns.rawData(), ns.size());
+    pending.logicalOp = logicalOp;
+    pending.lockType = lockType;
+    pending.micros = micros;
+    pending.command = command;
+    pending.countLatency = shouldCountLatency(opCtx);
+    pending.readWriteType = readWriteType;
+
+    if (buffer.size == kRecordBufferSize) {
+        stdx::lock_guard<SimpleMutex> lk(_lock);
+        _flushBuffer_inlock(&buffer);
+    }
+}
+
+void Top::_flushAll() {
+    for (RecordBuffer& buffer : _buffers) {
+        stdx::lock_guard<SimpleMutex> bufferLk(buffer.lock);
+        if (buffer.size == 0)
+            continue;
+        stdx::lock_guard<SimpleMutex> lk(_lock);
+        _flushBuffer_inlock(&buffer);
+    }
+}
+
+void Top::_flushBuffer_inlock(RecordBuffer* buffer) {
+    // Consecutive records usually name the same collection, so the usage map is only searched
+    // when the namespace changes.
+    CollectionData* coll = nullptr;
+    StringData collNs;
+
+    for (size_t i = 0; i < buffer->size; ++i) {
+        const PendingRecord& pending = buffer->records[i];
+
+        if (pending.ns.empty()) {
+            if (pending.countLatency)
+                _globalHistogramStats.increment(pending.micros, pending.readWriteType);
+            continue;
+        }
+
+        if ((pending.command || pending.logicalOp == LogicalOp::opQuery) &&
+            pending.ns == _lastDropped) {
+            _lastDropped = "";
+            continue;
+        }
+
+        if (!coll || collNs != pending.ns) {
+            coll = &_usage[pending.ns];
+            collNs = pending.ns;
+        }
+        _record(*coll, pending);
     }
 
-    CollectionData& coll = _usage[hashedNs];
-    _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
+    buffer->size = 0;
 }
 
-void Top::_record(OperationContext* opCtx,
-                  CollectionData& c,
-                  LogicalOp logicalOp,
-                  LockType lockType,
-                  long long micros,
-                  Command::ReadWriteType readWriteType) {
+void Top::_record(CollectionData& c, const PendingRecord& record) {
+    const long long micros = record.micros;
 
-    _incrementHistogram(opCtx, micros, &c.opLatencyHistogram, readWriteType);
+    if (record.countLatency)
+        c.opLatencyHistogram.increment(micros, record.readWriteType);
 
     c.total.inc(micros);
 
-    if (lockType == LockType::WriteLocked)
+    if (record.lockType == LockType::WriteLocked)
         c.writeLock.inc(micros);
-    else if (lockType == LockType::ReadLocked)
+    else if (record.lockType == LockType::ReadLocked)
         c.readLock.inc(micros);
 
-    switch (logicalOp) {
+    switch (record.logicalOp) {
         case LogicalOp::opInvalid:
             // use 0 for unknown, non-specific
             break;
@@ -140,6 +215,9 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
+    // Apply the records made before the drop, so that none of them survive it.
+    _flushAll();
+
     stdx::lock_guard<SimpleMutex> lk(_lock);
     _usage.erase(ns);
     if (!databaseDropped) {
@@ -149,12 +227,14 @@ void Top::collectionDropped(StringData ns, bool databaseDropped) {
     }
 }
 
-void Top::cloneMap(Top::UsageMap& out) const {
+void Top::cloneMap(Top::UsageMap& out) {
+    _flushAll();
     stdx::lock_guard<SimpleMutex> lk(_lock);
     out = _usage;
 }
 
 void Top::append(BSONObjBuilder& b) {
+    _flushAll();
     stdx::lock_guard<SimpleMutex> lk(_lock);
     _appendToUsageMap(b, _usage);
 }
@@ -197,11 +277,16 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
     bb.done();
 }
 
-void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
+void Top::appendLatencyStats(StringData ns,
+                             bool includeHistograms,
+                             bool includePercentiles,
+                             BSONObjBuilder* builder) {
+    _flushAll();
     auto hashedNs = UsageMap::HashedKey(ns);
     stdx::lock_guard<SimpleMutex> lk(_lock);
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    _usage[hashedNs].opLatencyHistogram.append(
+        includeHistograms, includePercentiles, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -209,23 +294,21 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    _bufferRecord(opCtx,
+                  StringData(),
+                  LogicalOp::opInvalid,
+                  LockType::NotLocked,
+                  static_cast<long long>(latency),
+                  false,
+                  readWriteType);
 }
 
-void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
+void Top::appendGlobalLatencyStats(bool includeHistograms,
+                                   bool includePercentiles,
+                                   BSONObjBuilder* builder) {
+    _flushAll();
     stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    _globalHistogramStats.append(includeHistograms, includePercentiles, builder);
 }
 
-void Top::_incrementHistogram(OperationContext* opCtx,
-                              long long latency,
-                              OperationLatencyHistogram* histogram,
-                              Command::ReadWriteType readWriteType) {
-    // Only update histogram if operation came from a user.
-    Client* client = opCtx->getClient();
-    if (client->isFromUserConnection() && !client->isInDirectClient()) {
-        histogram->increment(latency, readWriteType);
-    }
-}
 }  // namespace mongo
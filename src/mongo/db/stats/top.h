@@ -29,13 +29,17 @@
 
 #pragma once
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <string>
+#include <vector>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -43,12 +47,16 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * Recording an operation only appends it to a buffer picked by the calling thread. The buffered
+ * records are applied to the shared usage map in batches, when a buffer fills up and before any
+ * of the statistics are read, so the hot path seldom takes the lock that guards the map.
  */
 class Top {
 public:
     static Top& get(ServiceContext* service);
 
-    Top() = default;
+    Top();
 
     struct UsageData {
         UsageData() : time(0), count(0) {}
@@ -102,14 +110,17 @@ public:
 
     void append(BSONObjBuilder& b);
 
-    void cloneMap(UsageMap& out) const;
+    void cloneMap(UsageMap& out);
 
     void collectionDropped(StringData ns, bool databaseDropped = false);
 
     /**
      * Appends the collection-level latency statistics
      */
-    void appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder);
+    void appendLatencyStats(StringData ns,
+                            bool includeHistograms,
+                            bool includePercentiles,
+                            BSONObjBuilder* builder);
 
     /**
      * Increments the global histogram.
@@ -121,26 +132,67 @@ public:
     /**
      * Appends the global latency statistics.
      */
-    void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
+    void appendGlobalLatencyStats(bool includeHistograms,
+                                  bool includePercentiles,
+                                  BSONObjBuilder* builder);
 
 private:
+    // The number of buffers that threads spread their records over, and the number of records a
+    // buffer holds before it is applied to the usage map.
+    static const size_t kNumRecordBuffers = 16;
+    static const size_t kRecordBufferSize = 64;
+
+    struct PendingRecord {
+        // Empty for an operation that only counts towards the global latency statistics.
+        std::string ns;
+        LogicalOp logicalOp = LogicalOp::opInvalid;
+        LockType lockType = LockType::NotLocked;
+        long long micros = 0;
+        bool command = false;
+        bool countLatency = false;
+        Command::ReadWriteType readWriteType = Command::ReadWriteType::kCommand;
+    };
+
+    struct RecordBuffer {
+        RecordBuffer() : records(kRecordBufferSize) {}
+
+        SimpleMutex lock;
+        // The slots are reused, so the namespace strings keep their capacity between batches.
+        std::vector<PendingRecord> records;
+        size_t size = 0;
+    };
+
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
 
-    void _record(OperationContext* opCtx,
-                 CollectionData& c,
-                 LogicalOp logicalOp,
-                 LockType lockType,
-                 long long micros,
-                 Command::ReadWriteType readWriteType);
+    /**
+     * Appends a record to the calling thread's buffer, and applies the buffer to the usage map if
+     * that fills it up.
+     */
+    void _bufferRecord(OperationContext* opCtx,
+                       StringData ns,
+                       LogicalOp logicalOp,
+                       LockType lockType,
+                       long long micros,
+                       bool command,
+                       Command::ReadWriteType readWriteType);
+
+    /**
+     * Applies the records of every buffer to the usage map. Must be called without '_lock' held.
+     */
+    void _flushAll();
+
+    /**
+     * Applies and then discards the records of 'buffer'. Both the lock of 'buffer' and '_lock'
+     * must be held.
+     */
+    void _flushBuffer_inlock(RecordBuffer* buffer);
 
-    void _incrementHistogram(OperationContext* opCtx,
-                             long long latency,
-                             OperationLatencyHistogram* histogram,
-                             Command::ReadWriteType readWriteType);
+    void _record(CollectionData& c, const PendingRecord& record);
 
     mutable SimpleMutex _lock;
+    std::array<CacheAligned<RecordBuffer>, kNumRecordBuffers> _buffers;
     OperationLatencyHistogram _globalHistogramStats;
     UsageMap _usage;
     std::string _lastDropped;
@@ -29,6 +29,10 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/stats/top.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -39,4 +43,70 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+class TopRecordTest : public unittest::Test {
+protected:
+    void setUp() final {
+        _service = stdx::make_unique<ServiceContextNoop>();
+        _client = _service->makeClient("TopRecordTest");
+        _opCtx = _client->makeOperationContext();
+    }
+
+    void tearDown() final {
+        _opCtx.reset();
+        _client.reset();
+    }
+
+    void recordQuery(Top* top, StringData ns) {
+        top->record(_opCtx.get(),
+                    ns,
+                    LogicalOp::opQuery,
+                    Top::LockType::ReadLocked,
+                    10,
+                    false,
+                    Command::ReadWriteType::kRead);
+    }
+
+    static Top::CollectionData getCollectionData(Top* top, StringData ns) {
+        Top::UsageMap usage;
+        top->cloneMap(usage);
+        auto it = usage.find(ns);
+        ASSERT(it != usage.end());
+        return it->second;
+    }
+
+private:
+    std::unique_ptr<ServiceContextNoop> _service;
+    ServiceContext::UniqueClient _client;
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+TEST_F(TopRecordTest, ReadsSeeBufferedRecords) {
+    Top top;
+    // More records than fit in one buffer, so that some are applied on the write path and the
+    // rest when the map is read.
+    for (int i = 0; i < 100; ++i) {
+        recordQuery(&top, "test.a");
+    }
+    recordQuery(&top, "test.b");
+
+    auto a = getCollectionData(&top, "test.a");
+    ASSERT_EQ(100, a.total.count);
+    ASSERT_EQ(1000, a.total.time);
+    ASSERT_EQ(100, a.queries.count);
+    ASSERT_EQ(100, a.readLock.count);
+    ASSERT_EQ(0, a.writeLock.count);
+    ASSERT_EQ(1, getCollectionData(&top, "test.b").queries.count);
+}
+
+TEST_F(TopRecordTest, CollectionDroppedDiscardsEarlierRecordsAndIgnoresTheNextQuery) {
+    Top top;
+    recordQuery(&top, "test.a");
+    top.collectionDropped("test.a");
+
+    // The first query or command recorded after a drop is normally the drop, so it is skipped.
+    recordQuery(&top, "test.a");
+    recordQuery(&top, "test.a");
+    ASSERT_EQ(1, getCollectionData(&top, "test.a").queries.count);
+}
+
 }  // namespace
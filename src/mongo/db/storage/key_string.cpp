@@ -34,6 +34,7 @@
 
 #include "mongo/db/storage/key_string.h"
 
+#include <algorithm>
 #include <cmath>
 #include <type_traits>
 
@@ -2039,7 +2040,12 @@ BSONObj KeyString::toBsonSafe(const char* buffer,
                               size_t len,
                               Ordering ord,
                               const TypeBits& typeBits) {
-    BSONObjBuilder builder;
+    // Index keys are typically much smaller than the builder's default buffer, and the decoded
+    // object keeps the whole buffer alive for as long as it is referenced (e.g. by a working set
+    // member buffered in a SORT stage). Each encoded byte decodes to at most a few BSON bytes, so
+    // size the buffer from the encoded length instead.
+    const size_t kMaxInitialSize = 512;
+    BSONObjBuilder builder(static_cast<int>(std::min(4 * len + 5, kMaxInitialSize)));
     BufReader reader(buffer, len);
     TypeBits::Reader typeBitsReader(typeBits);
     for (int i = 0; reader.remaining(); i++) {
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/key_string.h"
+
+namespace mongo {
+namespace {
+
+const Ordering kAllAscending = Ordering::make(BSONObj());
+const KeyString::Version kVersion = KeyString::Version::V1;
+
+/**
+ * Returns an index key of the shape selected by 'keyShape': 0 for a single integer, 1 for a single
+ * string and 2 for a compound key of an integer, a string and a double.
+ */
+BSONObj makeKey(int keyShape, int i) {
+    const std::string str(24, static_cast<char>('a' + i % 26));
+    switch (keyShape) {
+        case 0:
+            return BSON("" << i);
+        case 1:
+            return BSON("" << str);
+        default:
+            return BSON("" << i << "" << str << "" << i * 0.5);
+    }
+}
+
+/**
+ * Benchmark encoding an index key with a record id, as is done for every key inserted into or
+ * looked up in an index.
+ */
+void BM_KeyStringEncode(benchmark::State& state) {
+    const BSONObj key = makeKey(state.range(0), 12345);
+    KeyString ks(kVersion);
+    for (auto keepRunning : state) {
+        ks.resetToKey(key, kAllAscending, RecordId(42));
+        benchmark::DoNotOptimize(ks.getBuffer());
+    }
+}
+
+/**
+ * Benchmark decoding an index key back into BSON, as covered queries and index scans returning
+ * keys do.
+ */
+void BM_KeyStringDecode(benchmark::State& state) {
+    const KeyString ks(kVersion, makeKey(state.range(0), 12345), kAllAscending);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(
+            KeyString::toBson(ks.getBuffer(), ks.getSize(), kAllAscending, ks.getTypeBits()));
+    }
+}
+
+/**
+ * Benchmark comparing two encoded keys which differ only in their last byte.
+ */
+void BM_KeyStringCompare(benchmark::State& state) {
+    const KeyString left(kVersion, makeKey(state.range(0), 12345), kAllAscending, RecordId(1));
+    const KeyString right(kVersion, makeKey(state.range(0), 12345), kAllAscending, RecordId(2));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(left.compare(right));
+    }
+}
+
+BENCHMARK(BM_KeyStringEncode)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_KeyStringDecode)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_KeyStringCompare)->Arg(0)->Arg(1)->Arg(2);
+
+}  // namespace
+}  // namespace mongo
@@ -244,21 +244,27 @@ Status KVDatabaseCatalogEntryBase::createCollection(OperationContext* opCtx,
 void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
                                                 const std::string& ns,
                                                 bool forRepair) {
-    invariant(!_collections.count(ns));
-
-    const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
-
     std::unique_ptr<RecordStore> rs;
     if (forRepair) {
         // Using a NULL rs since we don't want to open this record store before it has been
         // repaired. This also ensures that if we try to use it, it will blow up.
         rs = nullptr;
     } else {
+        const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
         BSONCollectionCatalogEntry::MetaData md = _engine->getCatalog()->getMetaData(opCtx, ns);
         rs = _engine->getEngine()->getGroupedRecordStore(opCtx, ns, ident, md.options, md.prefix);
         invariant(rs);
     }
 
+    initCollection(ns, std::move(rs));
+}
+
+void KVDatabaseCatalogEntryBase::initCollection(const std::string& ns,
+                                                std::unique_ptr<RecordStore> rs) {
+    invariant(!_collections.count(ns));
+
+    const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
+
     // No change registration since this is only for committed collections
     _collections[ns] = new KVCollectionCatalogEntry(
         _engine->getEngine(), _engine->getCatalog(), ns, ident, std::move(rs));
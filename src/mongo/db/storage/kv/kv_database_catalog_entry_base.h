@@ -87,6 +87,12 @@ public:
 
     void initCollection(OperationContext* opCtx, const std::string& ns, bool forRepair);
 
+    /**
+     * Registers the committed collection 'ns' with its record store 'rs', which the caller has
+     * already opened. 'rs' is null when the collection is loaded for repair.
+     */
+    void initCollection(const std::string& ns, std::unique_ptr<RecordStore> rs);
+
     void initCollectionBeforeRepair(OperationContext* opCtx, const std::string& ns);
     void reinitCollectionAfterRepair(OperationContext* opCtx, const std::string& ns);
 
@@ -37,10 +37,12 @@
 #include "mongo/db/catalog/catalog_control.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/unclean_shutdown.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -54,8 +56,24 @@ using std::vector;
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
 const auto kCatalogLogLevel = logger::LogSeverity::Debug(2);
+
+// Each loading thread opens at least this many collections, so that small catalogs aren't
+// loaded by threads that have almost nothing to do.
+const size_t kMinCollectionsPerLoadThread = 100;
 }
 
+// The number of threads that read the metadata and open the record store of every collection
+// when the catalog is loaded at startup. Loading tens of thousands of collections on one thread
+// delays startup by minutes.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(storageEngineCatalogLoadThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "storageEngineCatalogLoadThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
 class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
 public:
     RemoveDBChange(KVStorageEngine* engine, StringData db, KVDatabaseCatalogEntryBase* entry)
@@ -137,11 +155,8 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
     std::vector<std::string> collectionsKnownToCatalog;
     _catalog->getAllCollections(&collectionsKnownToCatalog);
 
-    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    std::vector<std::string> collectionsToOpen;
     for (const auto& coll : collectionsKnownToCatalog) {
-        NamespaceString nss(coll);
-        std::string dbName = nss.db().toString();
-
         if (loadingFromUncleanShutdown) {
             // If we are loading the catalog after an unclean shutdown, it's possible that there are
             // collections in the catalog that are unknown to the storage engine. If we can't find
@@ -160,6 +175,16 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
                 continue;
             }
         }
+        collectionsToOpen.push_back(coll);
+    }
+
+    std::vector<OpenedCollection> opened = _openCollections(opCtx, collectionsToOpen);
+
+    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    for (size_t i = 0; i < collectionsToOpen.size(); ++i) {
+        const auto& coll = collectionsToOpen[i];
+        NamespaceString nss(coll);
+        std::string dbName = nss.db().toString();
 
         // No rollback since this is only for committed dbs.
         KVDatabaseCatalogEntryBase*& db = _dbs[dbName];
@@ -167,9 +192,8 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
             db = _databaseCatalogEntryFactory(dbName, this).release();
         }
 
-        db->initCollection(opCtx, coll, _options.forRepair);
-        auto maxPrefixForCollection = _catalog->getMetaData(opCtx, coll).getMaxPrefix();
-        maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
+        db->initCollection(coll, std::move(opened[i].recordStore));
+        maxSeenPrefix = std::max(maxSeenPrefix, opened[i].maxPrefix);
     }
 
     KVPrefix::setLargestPrefix(maxSeenPrefix);
@@ -180,6 +204,60 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
     startingAfterUncleanShutdown(getGlobalServiceContext()) = false;
 }
 
+std::vector<KVStorageEngine::OpenedCollection> KVStorageEngine::_openCollections(
+    OperationContext* opCtx, const std::vector<std::string>& collections) {
+    std::vector<OpenedCollection> opened(collections.size());
+
+    // Reads the metadata of every 'numThreads'th collection, starting at 'first', and opens its
+    // record store unless the collections are loaded for repair.
+    auto openEvery = [&](OperationContext* threadOpCtx, size_t first, size_t numThreads) {
+        for (size_t i = first; i < collections.size(); i += numThreads) {
+            const auto& coll = collections[i];
+            auto md = _catalog->getMetaData(threadOpCtx, coll);
+            opened[i].maxPrefix = md.getMaxPrefix();
+            if (!_options.forRepair) {
+                opened[i].recordStore =
+                    _engine->getGroupedRecordStore(threadOpCtx,
+                                                   coll,
+                                                   _catalog->getCollectionIdent(coll),
+                                                   md.options,
+                                                   md.prefix);
+                invariant(opened[i].recordStore);
+            }
+        }
+    };
+
+    const size_t numThreads =
+        std::min(static_cast<size_t>(storageEngineCatalogLoadThreads.load()),
+                 std::max<size_t>(1, collections.size() / kMinCollectionsPerLoadThread));
+    if (numThreads <= 1) {
+        openEvery(opCtx, 0, 1);
+        return opened;
+    }
+
+    log() << "Loading " << collections.size() << " collections on " << numThreads << " threads";
+    std::vector<Status> statuses(numThreads, Status::OK());
+    std::vector<stdx::thread> threads;
+    for (size_t thread = 0; thread < numThreads; ++thread) {
+        threads.emplace_back([&, thread] {
+            try {
+                OperationContextNoop threadOpCtx(_engine->newRecoveryUnit());
+                openEvery(&threadOpCtx, thread, numThreads);
+                threadOpCtx.recoveryUnit()->abandonSnapshot();
+            } catch (const DBException& ex) {
+                statuses[thread] = ex.toStatus();
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+    return opened;
+}
+
 void KVStorageEngine::closeCatalog(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isLocked());
     if (shouldLog(::mongo::logger::LogComponent::kStorageRecovery, kCatalogLogLevel)) {
@@ -30,6 +30,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
@@ -189,6 +190,18 @@ private:
 
     void _dumpCatalog(OperationContext* opCtx);
 
+    struct OpenedCollection {
+        std::unique_ptr<RecordStore> recordStore;
+        KVPrefix maxPrefix = KVPrefix::kNotPrefixed;
+    };
+
+    /**
+     * Reads the metadata of 'collections' and opens their record stores, on several threads when
+     * there are enough collections. The results are in the order of 'collections'.
+     */
+    std::vector<OpenedCollection> _openCollections(OperationContext* opCtx,
+                                                   const std::vector<std::string>& collections);
+
     class RemoveDBChange;
 
     stdx::function<KVDatabaseCatalogEntryFactory> _databaseCatalogEntryFactory;
@@ -38,6 +38,7 @@
 #include "mongo/db/repair_database.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_engine.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
@@ -46,6 +47,7 @@
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -229,4 +231,34 @@ TEST_F(KVStorageEngineTest, RecreateIndexes) {
                       return str.find("index-") == 0;
                   }));
 }
+
+TEST_F(KVStorageEngineTest, LoadCatalogOnSeveralThreads) {
+    auto opCtx = cc().makeOperationContext();
+
+    const int kNumCollections = 250;
+    for (int i = 0; i < kNumCollections; ++i) {
+        NamespaceString nss(str::stream() << "db" << i % 3 << ".coll" << i);
+        ASSERT_OK(createCollection(opCtx.get(), nss).getStatus());
+    }
+
+    auto loadThreads =
+        ServerParameterSet::getGlobal()->getMap().find("storageEngineCatalogLoadThreads")->second;
+    ASSERT_OK(loadThreads->setFromString("4"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(loadThreads->setFromString("1")); });
+
+    {
+        Lock::GlobalWrite lk(opCtx.get());
+        _storageEngine->closeCatalog(opCtx.get());
+        _storageEngine->loadCatalog(opCtx.get());
+    }
+
+    // Every collection is loaded with its record store, in the right database.
+    for (int i = 0; i < kNumCollections; ++i) {
+        NamespaceString nss(str::stream() << "db" << i % 3 << ".coll" << i);
+        DatabaseCatalogEntry* dbce = _storageEngine->getDatabaseCatalogEntry(opCtx.get(), nss.db());
+        CollectionCatalogEntry* cce = dbce->getCollectionCatalogEntry(nss.ns());
+        ASSERT(cce);
+        ASSERT(dbce->getRecordStore(nss.ns()));
+    }
+}
 }  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/index/haystack_access_method.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/s2_access_method.h"
+#include "mongo/db/index/wildcard_access_method.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/server_parameters.h"
@@ -809,6 +810,9 @@ IndexAccessMethod* MMAPV1DatabaseCatalogEntry::getIndex(OperationContext* opCtx,
     if (IndexNames::GEO_2D == type)
         return new TwoDAccessMethod(entry, btree.release());
 
+    if (IndexNames::WILDCARD == type)
+        return new WildcardAccessMethod(entry, btree.release());
+
     log() << "Can't find index for keyPattern " << entry->descriptor()->keyPattern();
     fassertFailed(17489);
 }
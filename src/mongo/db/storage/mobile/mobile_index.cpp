@@ -406,7 +406,8 @@ public:
         cursorQuery << "SELECT key, value FROM \"" << _index.getIdent() << "\" WHERE key ";
         cursorQuery << (_isForward ? ">=" : "<=") << " ? ORDER BY key ";
         cursorQuery << (_isForward ? "ASC" : "DESC") << ";";
-        _stmt = stdx::make_unique<SqliteStatement>(*session, cursorQuery);
+        _stmt = stdx::make_unique<SqliteStatement>(
+            *session, cursorQuery, SqliteStatement::CachePolicy::kUncached);
     }
 
     virtual ~CursorBase() {}
@@ -67,7 +67,8 @@ public:
                     << "ORDER BY rec_id " << (forward ? "ASC" : "DESC") << ';';
 
         MobileSession* session = MobileRecoveryUnit::get(_opCtx)->getSession(_opCtx);
-        _stmt = stdx::make_unique<SqliteStatement>(*session, cursorQuery);
+        _stmt = stdx::make_unique<SqliteStatement>(
+            *session, cursorQuery, SqliteStatement::CachePolicy::kUncached);
 
         _startIdNum = (forward ? RecordId::min().repr() : RecordId::max().repr());
         _savedId = RecordId(_startIdNum);
@@ -139,5 +139,63 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     mongo::registerHarnessHelperFactory(makeHarnessHelper);
     return Status::OK();
 }
+
+TEST(MobileRecordStoreTest, InsertsReusePreparedStatements) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    std::unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    MobileSession* session = MobileRecoveryUnit::get(opCtx.get())->getSession(opCtx.get());
+    SqliteStatementCache* cache = session->getStatementCache();
+    ASSERT(cache);
+
+    size_t cachedAfterFirstInsert = 0;
+    for (int i = 0; i < 10; i++) {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), "abc", 4, Timestamp(), false).getStatus());
+        uow.commit();
+        if (i == 0) {
+            cachedAfterFirstInsert = cache->size();
+            ASSERT_GT(cachedAfterFirstInsert, 0U);
+        }
+    }
+
+    // Later inserts reuse the statements prepared by the first one.
+    ASSERT_EQUALS(cachedAfterFirstInsert, cache->size());
+    ASSERT_EQUALS(10, rs->numRecords(opCtx.get()));
+}
+
+TEST(MobileRecordStoreTest, StatementCacheEvictsLeastRecentlyUsed) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    MobileSession* session = MobileRecoveryUnit::get(opCtx.get())->getSession(opCtx.get());
+
+    auto prepare = [&](const std::string& query) {
+        sqlite3_stmt* stmt;
+        int status = sqlite3_prepare_v2(session->getSession(), query.c_str(), -1, &stmt, NULL);
+        ASSERT_EQUALS(SQLITE_OK, status);
+        return stmt;
+    };
+
+    SqliteStatementCache cache(2);
+    for (auto&& query : {"SELECT 1;", "SELECT 2;", "SELECT 3;"}) {
+        cache.put(query, prepare(query));
+    }
+    ASSERT_EQUALS(2U, cache.size());
+    ASSERT(!cache.take("SELECT 1;"));
+
+    sqlite3_stmt* stmt = cache.take("SELECT 3;");
+    ASSERT(stmt);
+    ASSERT_EQUALS(1U, cache.size());
+    sqlite3_finalize(stmt);
+
+    // Uncached statements are finalized rather than returned to the session's cache.
+    size_t sessionCacheSize = session->getStatementCache()->size();
+    {
+        SqliteStatement uncached(*session, "SELECT 4;", SqliteStatement::CachePolicy::kUncached);
+        uncached.step(SQLITE_ROW);
+    }
+    ASSERT_EQUALS(sessionCacheSize, session->getStatementCache()->size());
+}
 }  // namespace
 }  // namespace mongo
@@ -143,7 +143,7 @@ void MobileRecoveryUnit::_txnOpen(OperationContext* opCtx) {
      * tries to create a transaction in parallel, it receives a busy error and then retries.
      * Reads outside these explicit transactions proceed unaffected.
      */
-    SqliteStatement::execQuery(_session.get(), "BEGIN IMMEDIATE");
+    SqliteStatement::execCachedQuery(_session.get(), "BEGIN IMMEDIATE");
 
     _active = true;
 }
@@ -152,9 +152,9 @@ void MobileRecoveryUnit::_txnClose(bool commit) {
     invariant(_active);
 
     if (commit) {
-        SqliteStatement::execQuery(_session.get(), "COMMIT");
+        SqliteStatement::execCachedQuery(_session.get(), "COMMIT");
     } else {
-        SqliteStatement::execQuery(_session.get(), "ROLLBACK");
+        SqliteStatement::execCachedQuery(_session.get(), "ROLLBACK");
     }
 
     _active = false;
@@ -94,8 +94,12 @@ bool MobileDelayedOpQueue::isEmpty() {
     return (_isEmpty.load());
 }
 
+const Milliseconds MobileSessionPool::kMinWalCheckpointInterval{100};
+
 MobileSessionPool::MobileSessionPool(const std::string& path, std::uint64_t maxPoolSize)
-    : _path(path), _maxPoolSize(maxPoolSize) {}
+    : _path(path), _maxPoolSize(maxPoolSize) {
+    _checkpointThread = stdx::thread([this] { _checkpointLoop(); });
+}
 
 MobileSessionPool::~MobileSessionPool() {
     shutDown();
@@ -111,16 +115,12 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
     // Checks if there is an open session available.
     if (!_sessions.empty()) {
         sqlite3* session = _popSession_inlock();
-        return stdx::make_unique<MobileSession>(session, this);
+        return stdx::make_unique<MobileSession>(session, this, _statementCaches[session].get());
     }
 
     // Checks if a new session can be opened.
     if (_curPoolSize < _maxPoolSize) {
-        sqlite3* session;
-        int status = sqlite3_open(_path.c_str(), &session);
-        checkStatus(status, SQLITE_OK, "sqlite3_open");
-        _curPoolSize++;
-        return stdx::make_unique<MobileSession>(session, this);
+        return _openSession_inlock();
     }
 
     // There are no open sessions available and the maxPoolSize has been reached.
@@ -129,7 +129,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         _releasedSessionNotifier, lk, [&] { return !_sessions.empty(); });
 
     sqlite3* session = _popSession_inlock();
-    return stdx::make_unique<MobileSession>(session, this);
+    return stdx::make_unique<MobileSession>(session, this, _statementCaches[session].get());
 }
 
 void MobileSessionPool::releaseSession(MobileSession* session) {
@@ -172,6 +172,10 @@ void MobileSessionPool::shutDown() {
         sqlite3_close(session);
     }
 
+    _shutDownCheckpointThread();
+
+    // Cached statements must be finalized before their connections can be closed.
+    _statementCaches.clear();
     for (auto&& session : _sessions) {
         sqlite3_close(session);
     }
@@ -184,4 +188,85 @@ sqlite3* MobileSessionPool::_popSession_inlock() {
     return session;
 }
 
+std::unique_ptr<MobileSession> MobileSessionPool::_openSession_inlock() {
+    sqlite3* session;
+    int status = sqlite3_open(_path.c_str(), &session);
+    checkStatus(status, SQLITE_OK, "sqlite3_open");
+    sqlite3_wal_hook(session, &MobileSessionPool::_walHook, this);
+    _curPoolSize++;
+
+    auto& cache = _statementCaches[session];
+    cache = stdx::make_unique<SqliteStatementCache>();
+    return stdx::make_unique<MobileSession>(session, this, cache.get());
+}
+
+int MobileSessionPool::_walHook(void* sessionPool,
+                                sqlite3* session,
+                                const char* dbName,
+                                int numPages) {
+    if (numPages >= kWalCheckpointPages) {
+        auto pool = static_cast<MobileSessionPool*>(sessionPool);
+        stdx::lock_guard<stdx::mutex> lk(pool->_checkpointMutex);
+        pool->_checkpointRequested = true;
+        pool->_checkpointNotifier.notify_one();
+    }
+    return SQLITE_OK;
+}
+
+void MobileSessionPool::_checkpointLoop() {
+    // The checkpoint connection is opened on first use so that read-only workloads never open it.
+    sqlite3* session = nullptr;
+
+    stdx::unique_lock<stdx::mutex> lk(_checkpointMutex);
+    while (true) {
+        _checkpointNotifier.wait(
+            lk, [&] { return _checkpointRequested || _checkpointThreadShuttingDown; });
+        if (_checkpointThreadShuttingDown) {
+            break;
+        }
+        _checkpointRequested = false;
+        lk.unlock();
+
+        if (!session) {
+            int status = sqlite3_open(_path.c_str(), &session);
+            checkStatus(status, SQLITE_OK, "sqlite3_open");
+        }
+
+        // A passive checkpoint copies as much of the WAL as it can without waiting on readers or
+        // writers. Whatever it leaves behind is picked up by a later checkpoint.
+        int logPages = 0;
+        int checkpointedPages = 0;
+        int status = sqlite3_wal_checkpoint_v2(
+            session, nullptr, SQLITE_CHECKPOINT_PASSIVE, &logPages, &checkpointedPages);
+        if (status != SQLITE_OK && status != SQLITE_BUSY) {
+            warning() << "MobileSE: WAL checkpoint failed: " << sqlite3_errstr(status);
+        } else {
+            LOG(2) << "MobileSE: WAL checkpoint copied " << checkpointedPages << " of " << logPages
+                   << " pages";
+        }
+
+        lk.lock();
+        // Commits that arrive during the interval are folded into the next checkpoint.
+        _checkpointNotifier.wait_for(lk, kMinWalCheckpointInterval.toSystemDuration(), [&] {
+            return _checkpointThreadShuttingDown;
+        });
+    }
+    lk.unlock();
+
+    if (session) {
+        sqlite3_close(session);
+    }
+}
+
+void MobileSessionPool::_shutDownCheckpointThread() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_checkpointMutex);
+        _checkpointThreadShuttingDown = true;
+        _checkpointNotifier.notify_one();
+    }
+    if (_checkpointThread.joinable()) {
+        _checkpointThread.join();
+    }
+}
+
 }  // namespace mongo
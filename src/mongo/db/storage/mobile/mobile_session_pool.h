@@ -36,10 +36,15 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/mobile/mobile_session.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 class MobileSession;
+class SqliteStatementCache;
 
 /**
  * This class manages a queue of operations delayed for some reason
@@ -67,6 +72,18 @@ class MobileSessionPool final {
     MONGO_DISALLOW_COPYING(MobileSessionPool);
 
 public:
+    /**
+     * Number of pages in the write-ahead log after which a commit requests a checkpoint. This
+     * matches SQLite's default auto-checkpoint threshold.
+     */
+    static const int kWalCheckpointPages = 1000;
+
+    /**
+     * Minimum time between two background checkpoints, so that a burst of commits is checkpointed
+     * as a single batch.
+     */
+    static const Milliseconds kMinWalCheckpointInterval;
+
     MobileSessionPool(const std::string& path, std::uint64_t maxPoolSize = 80);
 
     ~MobileSessionPool();
@@ -96,6 +113,25 @@ private:
      */
     sqlite3* _popSession_inlock();
 
+    /**
+     * Opens a new connection along with its statement cache. Commits on the connection hand WAL
+     * checkpoints off to the checkpoint thread instead of running them inline.
+     */
+    std::unique_ptr<MobileSession> _openSession_inlock();
+
+    /**
+     * Replaces SQLite's auto-checkpoint hook, which checkpoints on the committing thread.
+     */
+    static int _walHook(void* sessionPool, sqlite3* session, const char* dbName, int numPages);
+
+    /**
+     * Body of the checkpoint thread. Runs passive checkpoints on a dedicated connection whenever
+     * a commit finds the WAL over kWalCheckpointPages.
+     */
+    void _checkpointLoop();
+
+    void _shutDownCheckpointThread();
+
     // This is used to lock the _sessions vector.
     stdx::mutex _mutex;
     stdx::condition_variable _releasedSessionNotifier;
@@ -111,5 +147,16 @@ private:
 
     using SessionPool = std::vector<sqlite3*>;
     SessionPool _sessions;
+
+    // Prepared statements for each open connection. Only the thread currently holding a
+    // connection uses its cache.
+    stdx::unordered_map<sqlite3*, std::unique_ptr<SqliteStatementCache>> _statementCaches;
+
+    // Protects the checkpoint thread state below.
+    stdx::mutex _checkpointMutex;
+    stdx::condition_variable _checkpointNotifier;
+    bool _checkpointRequested = false;
+    bool _checkpointThreadShuttingDown = false;
+    stdx::thread _checkpointThread;
 };
 }  // namespace mongo
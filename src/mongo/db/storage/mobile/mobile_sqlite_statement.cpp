@@ -42,7 +42,58 @@
 
 namespace mongo {
 
-SqliteStatement::SqliteStatement(const MobileSession& session, const std::string& sqlQuery) {
+SqliteStatementCache::SqliteStatementCache(size_t capacity) : _capacity(capacity) {}
+
+SqliteStatementCache::~SqliteStatementCache() {
+    for (auto&& entry : _lru) {
+        sqlite3_finalize(entry.second);
+    }
+}
+
+sqlite3_stmt* SqliteStatementCache::take(const std::string& sqlQuery) {
+    auto it = _index.find(sqlQuery);
+    if (it == _index.end()) {
+        return nullptr;
+    }
+
+    sqlite3_stmt* stmt = it->second->second;
+    _lru.erase(it->second);
+    _index.erase(it);
+    return stmt;
+}
+
+void SqliteStatementCache::put(const std::string& sqlQuery, sqlite3_stmt* stmt) {
+    // Another statement with the same text may have been cached while this one was in use; only
+    // one of them is kept.
+    if (_capacity == 0 || _index.count(sqlQuery)) {
+        sqlite3_finalize(stmt);
+        return;
+    }
+
+    if (_index.size() >= _capacity) {
+        auto& oldest = _lru.back();
+        sqlite3_finalize(oldest.second);
+        _index.erase(oldest.first);
+        _lru.pop_back();
+    }
+
+    _lru.emplace_front(sqlQuery, stmt);
+    _index.emplace(sqlQuery, _lru.begin());
+}
+
+SqliteStatement::SqliteStatement(const MobileSession& session,
+                                 const std::string& sqlQuery,
+                                 CachePolicy cachePolicy) {
+    SqliteStatementCache* cache = session.getStatementCache();
+    if (cache && cachePolicy == CachePolicy::kCached) {
+        _cache = cache;
+        _sqlQuery = sqlQuery;
+        _stmt = cache->take(sqlQuery);
+        if (_stmt) {
+            return;
+        }
+    }
+
     int status = sqlite3_prepare_v2(
         session.getSession(), sqlQuery.c_str(), sqlQuery.length() + 1, &_stmt, NULL);
     if (status == SQLITE_BUSY) {
@@ -57,7 +108,19 @@ SqliteStatement::SqliteStatement(const MobileSession& session, const std::string
 }
 
 SqliteStatement::~SqliteStatement() {
-    int status = sqlite3_finalize(_stmt);
+    int status;
+    if (_cache && _exceptionStatus == SQLITE_OK) {
+        status = sqlite3_reset(_stmt);
+        if (status == SQLITE_OK) {
+            // Bindings point at caller-owned memory, so they must not outlive this object.
+            sqlite3_clear_bindings(_stmt);
+            _cache->put(_sqlQuery, _stmt);
+            return;
+        }
+        sqlite3_finalize(_stmt);
+    } else {
+        status = sqlite3_finalize(_stmt);
+    }
     fassert(37053, status == _exceptionStatus);
 }
 
@@ -130,6 +193,18 @@ void SqliteStatement::execQuery(MobileSession* session, const std::string& query
     sqlite3_free(errMsg);
 }
 
+void SqliteStatement::execCachedQuery(MobileSession* session, const std::string& query) {
+    SqliteStatement stmt(*session, query);
+    int status = stmt.step();
+
+    if (status == SQLITE_BUSY || status == SQLITE_LOCKED) {
+        stmt.setExceptionStatus(status);
+        throw WriteConflictException();
+    }
+
+    checkStatus(status, SQLITE_DONE, "sqlite3_step");
+}
+
 void SqliteStatement::reset() {
     int status = sqlite3_reset(_stmt);
     checkStatus(status, SQLITE_OK, "sqlite3_reset");
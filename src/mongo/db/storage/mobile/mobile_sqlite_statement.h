@@ -28,26 +28,86 @@
 
 #pragma once
 
+#include <list>
 #include <sqlite3.h>
 #include <string>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/mobile/mobile_session.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
+/**
+ * A per-connection LRU cache of prepared statements keyed by their SQL text. Preparing a statement
+ * costs more than executing most of the small queries the mobile storage engine issues, so
+ * statements are reset and kept here for reuse instead of being finalized.
+ *
+ * A connection is only used by one thread at a time, so the cache is not synchronized.
+ */
+class SqliteStatementCache final {
+    MONGO_DISALLOW_COPYING(SqliteStatementCache);
+
+public:
+    static const size_t kDefaultCapacity = 64;
+
+    explicit SqliteStatementCache(size_t capacity = kDefaultCapacity);
+
+    /**
+     * Finalizes all of the cached statements. This must happen before the connection is closed.
+     */
+    ~SqliteStatementCache();
+
+    /**
+     * Removes and returns the cached statement prepared from 'sqlQuery', or returns nullptr if
+     * there is none.
+     */
+    sqlite3_stmt* take(const std::string& sqlQuery);
+
+    /**
+     * Caches 'stmt', which must already be reset, as the most recently used statement. Evicts and
+     * finalizes the least recently used statement if the cache is full.
+     */
+    void put(const std::string& sqlQuery, sqlite3_stmt* stmt);
+
+    size_t size() const {
+        return _index.size();
+    }
+
+private:
+    using LruList = std::list<std::pair<std::string, sqlite3_stmt*>>;
+
+    const size_t _capacity;
+
+    // Ordered from most to least recently used.
+    LruList _lru;
+    stdx::unordered_map<std::string, LruList::iterator> _index;
+};
+
 /**
  * SqliteStatement is a wrapper around the sqlite3_stmt object. All calls to the SQLite API that
  * involve a sqlite_stmt object are made in this class.
  */
 class SqliteStatement final {
 public:
+    enum class CachePolicy {
+        // Reuse a statement from the session's statement cache and return it there when done.
+        kCached,
+        // Always prepare and finalize the statement. Used for statements that may outlive the
+        // session they were prepared on, such as those held by cursors.
+        kUncached,
+    };
+
     /**
-     * Creates and prepares a SQLite statement.
+     * Creates and prepares a SQLite statement, or reuses one from the session's statement cache.
      */
-    SqliteStatement(const MobileSession& session, const std::string& sqlQuery);
+    SqliteStatement(const MobileSession& session,
+                    const std::string& sqlQuery,
+                    CachePolicy cachePolicy = CachePolicy::kCached);
 
     /**
-     * Finalizes the prepared statement.
+     * Returns the prepared statement to the session's statement cache, or finalizes it if it is
+     * uncached or its last step failed.
      */
     ~SqliteStatement();
 
@@ -115,9 +175,19 @@ public:
      */
     static void execQuery(MobileSession* session, const std::string& query);
 
+    /**
+     * Like execQuery(), but reuses a prepared statement from the session's statement cache. The
+     * query must be a single statement that returns no rows, such as "BEGIN IMMEDIATE".
+     */
+    static void execCachedQuery(MobileSession* session, const std::string& query);
+
 private:
     sqlite3_stmt* _stmt;
 
+    // Set when the statement should be returned to this cache on destruction.
+    SqliteStatementCache* _cache = nullptr;
+    std::string _sqlQuery;
+
     // If the most recent call to sqlite3_step on this statement returned an error, the error is
     // returned again when the statement is finalized. This is used to verify that the last error
     // code returned matches the finalize error code, if there is any.
@@ -586,6 +586,15 @@ public:
                                    BSONObjBuilder* result,
                                    double scale) const = 0;
 
+    /**
+     * Appends the storage engine's most recent view of how much of this RecordStore is resident
+     * in its cache and how much cache traffic it causes. Returns false, appending nothing, if the
+     * storage engine does not track this.
+     */
+    virtual bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const {
+        return false;
+    }
+
     /**
      * Load all data into cache.
      * What cache depends on implementation.
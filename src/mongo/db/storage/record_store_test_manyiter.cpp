@@ -113,5 +113,41 @@ TEST(RecordStoreTestHarness, GetManyIteratorsNonEmpty) {
     }
 }
 
+// Create multiple iterators over a record store large enough to be split into several ranges.
+TEST(RecordStoreTestHarness, GetManyIteratorsLarge) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 10000;
+    set<RecordId> remain;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < nToInsert; i++) {
+            stringstream ss;
+            ss << "record " << i;
+            string data = ss.str();
+
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            remain.insert(res.getValue());
+        }
+        uow.commit();
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        for (auto&& cursor : rs->getManyCursors(opCtx.get())) {
+            while (auto record = cursor->next()) {
+                ASSERT_EQ(remain.erase(record->id), size_t(1));
+            }
+
+            ASSERT(!cursor->next());
+        }
+        ASSERT(remain.empty());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
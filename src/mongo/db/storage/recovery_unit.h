@@ -126,6 +126,16 @@ public:
      */
     virtual void preallocateSnapshot() {}
 
+    /**
+     * Appends statistics about the storage engine work done on behalf of the operation using this
+     * recovery unit, such as time spent blocked by the storage engine. Appends nothing by default.
+     *
+     * May be called by threads other than the one using the recovery unit while they hold the lock
+     * of the operation's Client, so implementations must only read values that are safe to access
+     * concurrently.
+     */
+    virtual void appendOperationStatistics(BSONObjBuilder* builder) const {}
+
     /**
      * Obtains a majority committed snapshot. Snapshots should still be separately acquired and
      * newer committed snapshots should be used if available whenever implementations would normally
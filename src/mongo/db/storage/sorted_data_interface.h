@@ -113,6 +113,21 @@ public:
                          const RecordId& loc,
                          bool dupsAllowed) = 0;
 
+    /**
+     * Remove every entry in 'entries' from the index. The entries must be sorted in index order,
+     * so that an implementation can remove them in a single forward sweep rather than searching
+     * for each one from scratch.
+     *
+     * The default implementation calls unindex() once per entry.
+     */
+    virtual void unindexMany(OperationContext* opCtx,
+                             const std::vector<IndexKeyEntry>& entries,
+                             bool dupsAllowed) {
+        for (auto&& entry : entries) {
+            unindex(opCtx, entry.key, entry.loc, dupsAllowed);
+        }
+    }
+
     /**
      * Return ErrorCodes::DuplicateKey if 'key' already exists in 'this'
      * index at a RecordId other than 'loc', and Status::OK() otherwise.
@@ -148,6 +163,15 @@ public:
                                    BSONObjBuilder* output,
                                    double scale) const = 0;
 
+    /**
+     * Appends the storage engine's most recent view of how much of this index is resident in its
+     * cache and how much cache traffic it causes. Returns false, appending nothing, if the storage
+     * engine does not track this.
+     */
+    virtual bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+        return false;
+    }
+
 
     /**
      * Return the number of bytes consumed by 'this' index.
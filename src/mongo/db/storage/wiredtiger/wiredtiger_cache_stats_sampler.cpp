@@ -0,0 +1,256 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_cache_stats_sampler.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <wiredtiger.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+// How often, in seconds, every table's cache statistics are sampled. 0 disables sampling. Each pass
+// opens a statistics cursor per table, so this should be well above the time one pass takes on a
+// deployment with many collections and indexes.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCacheStatsSampleIntervalSecs, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerCacheStatsSampleIntervalSecs must be greater than or equal "
+                          "to 0");
+        }
+        return Status::OK();
+    });
+
+const std::string kTablePrefix = "table:";
+
+/**
+ * Positions 'cursor', a statistics cursor, on 'key' and returns its value, or 0 if the key is not
+ * present.
+ */
+long long readStat(WT_CURSOR* cursor, int key) {
+    cursor->set_key(cursor, key);
+    if (cursor->search(cursor) != 0) {
+        return 0;
+    }
+    uint64_t value;
+    if (cursor->get_value(cursor, NULL, NULL, &value) != 0) {
+        return 0;
+    }
+    return static_cast<long long>(std::min<uint64_t>(value, std::numeric_limits<long long>::max()));
+}
+
+double ratePerSec(long long current, long long previous, long long elapsedMillis) {
+    if (elapsedMillis <= 0 || current < previous) {
+        return 0;
+    }
+    return static_cast<double>(current - previous) * 1000 / elapsedMillis;
+}
+
+}  // namespace
+
+WiredTigerCacheStatsSampler::WiredTigerCacheStatsSampler(WiredTigerSessionCache* sessionCache)
+    : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+void WiredTigerCacheStatsSampler::run() {
+    Client::initThread(name().c_str());
+
+    LOG(1) << "starting " << name() << " thread";
+
+    Date_t lastSample;
+    while (!_shuttingDown.load()) {
+        {
+            // Wake up every second so that changes to the interval take effect promptly.
+            stdx::unique_lock<stdx::mutex> lk(_shutdownMutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            _shutdownCondVar.wait_for(lk, stdx::chrono::seconds(1), [&] {
+                return _shuttingDown.load();
+            });
+        }
+        if (_shuttingDown.load()) {
+            break;
+        }
+
+        const int intervalSecs = wiredTigerCacheStatsSampleIntervalSecs.load();
+        if (intervalSecs <= 0) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _samples.clear();
+            continue;
+        }
+        if (Date_t::now() - lastSample < Seconds(intervalSecs)) {
+            continue;
+        }
+
+        try {
+            _sampleAll();
+        } catch (const AssertionException& exc) {
+            invariant(ErrorCodes::isShutdownError(exc.code()), exc.what());
+        }
+        lastSample = Date_t::now();
+    }
+    LOG(1) << "stopping " << name() << " thread";
+}
+
+void WiredTigerCacheStatsSampler::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_shutdownMutex);
+        _shuttingDown.store(true);
+    }
+    _shutdownCondVar.notify_one();
+    wait();
+}
+
+void WiredTigerCacheStatsSampler::_sampleAll() {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+
+    std::vector<std::string> uris;
+    {
+        WT_CURSOR* metadata = NULL;
+        invariantWTOK(s->open_cursor(s, "metadata:", NULL, NULL, &metadata));
+        ON_BLOCK_EXIT(metadata->close, metadata);
+
+        metadata->set_key(metadata, kTablePrefix.c_str());
+        int exact;
+        int ret = metadata->search_near(metadata, &exact);
+        if (ret == 0 && exact < 0) {
+            ret = metadata->next(metadata);
+        }
+        while (ret == 0) {
+            const char* key;
+            invariantWTOK(metadata->get_key(metadata, &key));
+            StringData uri(key);
+            if (!uri.startsWith(kTablePrefix)) {
+                break;
+            }
+            uris.push_back(uri.toString());
+            ret = metadata->next(metadata);
+        }
+        invariant(ret == 0 || ret == WT_NOTFOUND);
+    }
+
+    std::map<std::string, Sample> previous;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        previous = _samples;
+    }
+
+    std::map<std::string, Sample> samples;
+    for (const auto& uri : uris) {
+        if (_shuttingDown.load()) {
+            return;
+        }
+
+        // Tables that are being dropped, or are otherwise busy, are skipped for this pass.
+        WT_CURSOR* stats = NULL;
+        const std::string statsUri = "statistics:" + uri;
+        if (s->open_cursor(s, statsUri.c_str(), NULL, "statistics=(fast)", &stats) != 0) {
+            continue;
+        }
+        ON_BLOCK_EXIT(stats->close, stats);
+
+        Sample sample;
+        sample.sampledAtMillis = Date_t::now().toMillisSinceEpoch();
+        sample.bytesInCache = readStat(stats, WT_STAT_DSRC_CACHE_BYTES_INUSE);
+        sample.bytesReadIntoCache = readStat(stats, WT_STAT_DSRC_CACHE_BYTES_READ);
+        sample.pagesReadIntoCache = readStat(stats, WT_STAT_DSRC_CACHE_READ);
+        sample.pagesEvictedDirty = readStat(stats, WT_STAT_DSRC_CACHE_EVICTION_DIRTY);
+        sample.pagesEvicted =
+            readStat(stats, WT_STAT_DSRC_CACHE_EVICTION_CLEAN) + sample.pagesEvictedDirty;
+
+        auto it = previous.find(uri);
+        if (it != previous.end()) {
+            const Sample& prev = it->second;
+            const long long elapsed = sample.sampledAtMillis - prev.sampledAtMillis;
+            sample.bytesReadIntoCachePerSec =
+                ratePerSec(sample.bytesReadIntoCache, prev.bytesReadIntoCache, elapsed);
+            sample.pagesReadIntoCachePerSec =
+                ratePerSec(sample.pagesReadIntoCache, prev.pagesReadIntoCache, elapsed);
+            sample.pagesEvictedPerSec = ratePerSec(sample.pagesEvicted, prev.pagesEvicted, elapsed);
+        }
+        samples.emplace(uri, sample);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _samples = std::move(samples);
+}
+
+bool WiredTigerCacheStatsSampler::appendStats(const std::string& uri,
+                                              BSONObjBuilder* builder) const {
+    Sample sample;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _samples.find(uri);
+        if (it == _samples.end()) {
+            return false;
+        }
+        sample = it->second;
+    }
+
+    builder->appendDate("sampledAt", Date_t::fromMillisSinceEpoch(sample.sampledAtMillis));
+    builder->appendNumber("bytesInCache", sample.bytesInCache);
+    builder->appendNumber("bytesReadIntoCache", sample.bytesReadIntoCache);
+    builder->appendNumber("pagesReadIntoCache", sample.pagesReadIntoCache);
+    builder->appendNumber("pagesEvicted", sample.pagesEvicted);
+    builder->appendNumber("pagesEvictedDirty", sample.pagesEvictedDirty);
+    builder->append("bytesReadIntoCachePerSec", sample.bytesReadIntoCachePerSec);
+    builder->append("pagesReadIntoCachePerSec", sample.pagesReadIntoCachePerSec);
+    builder->append("pagesEvictedPerSec", sample.pagesEvictedPerSec);
+    return true;
+}
+
+// static
+bool WiredTigerCacheStatsSampler::appendStatsForURI(OperationContext* opCtx,
+                                                    const std::string& uri,
+                                                    BSONObjBuilder* builder) {
+    WiredTigerKVEngine* engine =
+        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->getKVEngine();
+    if (!engine || !engine->getCacheStatsSampler()) {
+        return false;
+    }
+    return engine->getCacheStatsSampler()->appendStats(uri, builder);
+}
+
+}  // namespace mongo
@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/background.h"
+
+namespace mongo {
+
+class OperationContext;
+class WiredTigerSessionCache;
+
+/**
+ * Periodically walks every table in the WiredTiger metadata and records how much of it is resident
+ * in the cache and how much cache traffic it has caused. Readers such as $collStats then get a
+ * recent per-collection and per-index view without having to open statistics cursors themselves.
+ *
+ * Sampling is off unless the "wiredTigerCacheStatsSampleIntervalSecs" parameter is positive. The
+ * parameter can be changed at runtime.
+ */
+class WiredTigerCacheStatsSampler : public BackgroundJob {
+    MONGO_DISALLOW_COPYING(WiredTigerCacheStatsSampler);
+
+public:
+    explicit WiredTigerCacheStatsSampler(WiredTigerSessionCache* sessionCache);
+
+    std::string name() const override {
+        return "WTCacheStatsSampler";
+    }
+
+    void run() override;
+
+    void shutdown();
+
+    /**
+     * Appends the most recent sample for the table at 'uri' to 'builder'. Returns false, appending
+     * nothing, if sampling is disabled or the table has not been sampled yet.
+     */
+    bool appendStats(const std::string& uri, BSONObjBuilder* builder) const;
+
+    /**
+     * Looks up the sampler of the engine that 'opCtx' is running against and appends its sample
+     * for 'uri'. Returns false if there is no sampler, as when the session cache was created
+     * without an engine in unit tests.
+     */
+    static bool appendStatsForURI(OperationContext* opCtx,
+                                  const std::string& uri,
+                                  BSONObjBuilder* builder);
+
+private:
+    struct Sample {
+        long long sampledAtMillis = 0;
+        long long bytesInCache = 0;
+        long long bytesReadIntoCache = 0;
+        long long pagesReadIntoCache = 0;
+        long long pagesEvicted = 0;
+        long long pagesEvictedDirty = 0;
+
+        // Rates since the previous sample of the same table, per second.
+        double bytesReadIntoCachePerSec = 0;
+        double pagesReadIntoCachePerSec = 0;
+        double pagesEvictedPerSec = 0;
+    };
+
+    /**
+     * Takes one sample of every table, replacing '_samples' wholesale so that dropped tables fall
+     * out of the map.
+     */
+    void _sampleAll();
+
+    WiredTigerSessionCache* const _sessionCache;
+    AtomicBool _shuttingDown{false};
+    stdx::mutex _shutdownMutex;
+    stdx::condition_variable _shutdownCondVar;
+
+    mutable stdx::mutex _mutex;
+    std::map<std::string, Sample> _samples;  // Keyed by table URI; guarded by '_mutex'.
+};
+
+}  // namespace mongo
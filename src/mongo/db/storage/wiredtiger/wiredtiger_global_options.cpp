@@ -63,8 +63,8 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
         .addOptionChaining("storage.wiredTiger.engineConfig.journalCompressor",
                            "wiredTigerJournalCompressor",
                            moe::String,
-                           "use a compressor for log records [none|snappy|zlib]")
-        .format("(:?none)|(:?snappy)|(:?zlib)", "(none/snappy/zlib)")
+                           "use a compressor for log records [none|snappy|zlib|zstd]")
+        .format("(:?none)|(:?snappy)|(:?zlib)|(:?zstd)", "(none/snappy/zlib/zstd)")
         .setDefault(moe::Value(std::string("snappy")));
     wiredTigerOptions.addOptionChaining("storage.wiredTiger.engineConfig.directoryForIndexes",
                                         "wiredTigerDirectoryForIndexes",
@@ -78,14 +78,28 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
                            "configuration settings")
         .hidden();
 
+    // In-memory storage engine options
+    wiredTigerOptions.addOptionChaining("storage.inMemory.engineConfig.inMemorySizeGB",
+                                        "inMemorySizeGB",
+                                        moe::Double,
+                                        "maximum amount of memory to allocate for in-memory "
+                                        "storage engine data, including indexes, oplog and "
+                                        "internal structures; defaults to 1/2 of physical RAM");
+    wiredTigerOptions
+        .addOptionChaining("storage.inMemory.engineConfig.configString",
+                           "inMemoryEngineConfigString",
+                           moe::String,
+                           "In-memory storage engine custom configuration settings")
+        .hidden();
+
     // WiredTiger collection options
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.collectionConfig.blockCompressor",
                            "wiredTigerCollectionBlockCompressor",
                            moe::String,
                            "block compression algorithm for collection data "
-                           "[none|snappy|zlib]")
-        .format("(:?none)|(:?snappy)|(:?zlib)", "(none/snappy/zlib)")
+                           "[none|snappy|zlib|zstd]")
+        .format("(:?none)|(:?snappy)|(:?zlib)|(:?zstd)", "(none/snappy/zlib/zstd)")
         .setDefault(moe::Value(std::string("snappy")));
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.collectionConfig.configString",
@@ -141,6 +155,18 @@ Status WiredTigerGlobalOptions::store(const moe::Environment& params,
         log() << "Engine custom option: " << wiredTigerGlobalOptions.engineConfig;
     }
 
+    // In-memory storage engine options
+    if (params.count("storage.inMemory.engineConfig.inMemorySizeGB")) {
+        wiredTigerGlobalOptions.inMemorySizeGB =
+            params["storage.inMemory.engineConfig.inMemorySizeGB"].as<double>();
+    }
+    if (params.count("storage.inMemory.engineConfig.configString")) {
+        wiredTigerGlobalOptions.inMemoryEngineConfig =
+            params["storage.inMemory.engineConfig.configString"].as<std::string>();
+        log() << "In-memory engine custom option: "
+              << wiredTigerGlobalOptions.inMemoryEngineConfig;
+    }
+
     // WiredTiger collection options
     if (params.count("storage.wiredTiger.collectionConfig.blockCompressor")) {
         wiredTigerGlobalOptions.collectionBlockCompressor =
@@ -41,6 +41,7 @@ class WiredTigerGlobalOptions {
 public:
     WiredTigerGlobalOptions()
         : cacheSizeGB(0),
+          inMemorySizeGB(0),
           checkpointDelaySecs(0),
           statisticsLogDelaySecs(0),
           directoryForIndexes(false),
@@ -51,6 +52,8 @@ public:
     Status store(const moe::Environment& params, const std::vector<std::string>& args);
 
     double cacheSizeGB;
+    double inMemorySizeGB;
+    std::string inMemoryEngineConfig;
     size_t checkpointDelaySecs;
     size_t statisticsLogDelaySecs;
     std::string journalCompressor;
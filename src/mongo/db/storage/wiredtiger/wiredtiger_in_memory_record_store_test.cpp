@@ -0,0 +1,184 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <string>
+
+#include "mongo/base/checked_cast.h"
+#include "mongo/base/init.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+using std::string;
+using std::unique_ptr;
+
+/**
+ * Runs the record store harness against a WiredTigerKVEngine opened in memory, as used by the
+ * inMemory storage engine.
+ */
+class InMemoryWiredTigerHarnessHelper final : public RecordStoreHarnessHelper {
+public:
+    InMemoryWiredTigerHarnessHelper()
+        : _dbpath("wt_in_memory_test"),
+          _engine(kWiredTigerInMemoryEngineName,
+                  _dbpath.path(),
+                  &_cs,
+                  "",
+                  kCacheSizeMB,
+                  false,
+                  true,
+                  false,
+                  false) {
+        repl::ReplicationCoordinator::set(
+            getGlobalServiceContext(),
+            std::unique_ptr<repl::ReplicationCoordinator>(new repl::ReplicationCoordinatorMock(
+                getGlobalServiceContext(), repl::ReplSettings())));
+    }
+
+    virtual std::unique_ptr<RecordStore> newNonCappedRecordStore() {
+        return newNonCappedRecordStore("a.b");
+    }
+
+    virtual std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns) {
+        return _newRecordStore(ns, CollectionOptions(), -1, -1);
+    }
+
+    virtual std::unique_ptr<RecordStore> newCappedRecordStore(int64_t cappedSizeBytes,
+                                                              int64_t cappedMaxDocs) final {
+        return newCappedRecordStore("a.b", cappedSizeBytes, cappedMaxDocs);
+    }
+
+    virtual std::unique_ptr<RecordStore> newCappedRecordStore(const std::string& ns,
+                                                              int64_t cappedMaxSize,
+                                                              int64_t cappedMaxDocs) {
+        CollectionOptions options;
+        options.capped = true;
+        return _newRecordStore(ns, options, cappedMaxSize, cappedMaxDocs);
+    }
+
+    virtual std::unique_ptr<RecoveryUnit> newRecoveryUnit() final {
+        return std::unique_ptr<WiredTigerRecoveryUnit>(
+            checked_cast<WiredTigerRecoveryUnit*>(_engine.newRecoveryUnit()));
+    }
+
+    virtual bool supportsDocLocking() final {
+        return true;
+    }
+
+private:
+    // Everything lives in the cache, so leave room for the larger harness tests.
+    static const size_t kCacheSizeMB = 256;
+
+    std::unique_ptr<RecordStore> _newRecordStore(const std::string& ns,
+                                                 const CollectionOptions& options,
+                                                 int64_t cappedMaxSize,
+                                                 int64_t cappedMaxDocs) {
+        WiredTigerRecoveryUnit* ru =
+            checked_cast<WiredTigerRecoveryUnit*>(_engine.newRecoveryUnit());
+        OperationContextNoop opCtx(ru);
+        string uri = "table:" + ns;
+
+        const bool prefixed = false;
+        StatusWith<std::string> result = WiredTigerRecordStore::generateCreateString(
+            kWiredTigerInMemoryEngineName, ns, options, "", prefixed);
+        ASSERT_TRUE(result.isOK());
+        std::string config = result.getValue();
+
+        {
+            WriteUnitOfWork uow(&opCtx);
+            WT_SESSION* s = ru->getSession()->getSession();
+            invariantWTOK(s->create(s, uri.c_str(), config.c_str()));
+            uow.commit();
+        }
+
+        WiredTigerRecordStore::Params params;
+        params.ns = ns;
+        params.uri = uri;
+        params.engineName = kWiredTigerInMemoryEngineName;
+        params.isCapped = options.capped;
+        params.isEphemeral = true;
+        params.cappedMaxSize = cappedMaxSize;
+        params.cappedMaxDocs = cappedMaxDocs;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = nullptr;
+
+        auto ret = stdx::make_unique<StandardWiredTigerRecordStore>(&_engine, &opCtx, params);
+        ret->postConstructorInit(&opCtx);
+        return std::move(ret);
+    }
+
+    unittest::TempDir _dbpath;
+    ClockSourceMock _cs;
+
+    WiredTigerKVEngine _engine;
+};
+
+std::unique_ptr<HarnessHelper> makeHarnessHelper() {
+    return stdx::make_unique<InMemoryWiredTigerHarnessHelper>();
+}
+
+MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
+    mongo::registerHarnessHelperFactory(makeHarnessHelper);
+    return Status::OK();
+}
+
+TEST(WiredTigerInMemoryRecordStoreTest, EngineIsEphemeral) {
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+    unique_ptr<RecordStore> rs = harnessHelper->newNonCappedRecordStore("a.b");
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), "abc", 4, Timestamp(), false).getStatus());
+        uow.commit();
+    }
+    ASSERT_EQUALS(1, rs->numRecords(opCtx.get()));
+
+    // Waiting for durability is a no-op rather than a journal flush or checkpoint.
+    ASSERT_TRUE(opCtx->recoveryUnit()->waitUntilDurable());
+}
+
+}  // namespace
+}  // namespace mongo
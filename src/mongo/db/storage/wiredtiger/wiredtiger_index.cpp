@@ -46,6 +46,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cache_stats_sampler.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
@@ -347,6 +348,26 @@ void WiredTigerIndex::unindex(OperationContext* opCtx,
     _unindex(opCtx, c, key, id, dupsAllowed);
 }
 
+void WiredTigerIndex::unindexMany(OperationContext* opCtx,
+                                  const std::vector<IndexKeyEntry>& entries,
+                                  bool dupsAllowed) {
+    dassert(opCtx->lockState()->isWriteLocked());
+
+    // Reuse one cursor for the whole batch. Because the entries arrive in index order, each
+    // search lands at or just past the position of the previous removal, so the pages it needs
+    // are already in cache.
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+
+    for (auto&& entry : entries) {
+        invariant(entry.loc.isNormal());
+        dassert(!hasFieldNames(entry.key));
+        _unindex(opCtx, c, entry.key, entry.loc, dupsAllowed);
+    }
+}
+
 void WiredTigerIndex::fullValidate(OperationContext* opCtx,
                                    long long* numKeysOut,
                                    ValidateResults* fullResults) const {
@@ -427,6 +448,10 @@ bool WiredTigerIndex::appendCustomStats(OperationContext* opCtx,
     return true;
 }
 
+bool WiredTigerIndex::appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+    return WiredTigerCacheStatsSampler::appendStatsForURI(opCtx, uri(), output);
+}
+
 Status WiredTigerIndex::dupKeyCheck(OperationContext* opCtx,
                                     const BSONObj& key,
                                     const RecordId& id) {
@@ -1293,15 +1318,13 @@ bool WiredTigerIndexUnique::isDup(OperationContext* opCtx,
         0)
         return true;
 
-    int ret;
-    if (cmp < 0) {
-        // We got the smaller key adjacent to prefix key, check the next key too.
-        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->next(c); });
-    } else {
-        // We got the larger key adjacent to prefix key, check the previous key too.
-        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->prev(c); });
-    }
+    // Every key starting with the prefix key sorts after it, so if we got the larger key adjacent to
+    // the prefix key and it doesn't start with the prefix key, no key does.
+    if (cmp > 0)
+        return false;
 
+    // We got the smaller key adjacent to prefix key, check the next key too.
+    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->next(c); });
     if (ret == 0) {
         invariantWTOK(c->get_key(c, &item));
         return (std::memcmp(prefixKey.getBuffer(),
@@ -1309,8 +1332,8 @@ bool WiredTigerIndexUnique::isDup(OperationContext* opCtx,
                             std::min(prefixKey.getSize(), item.size)) == 0);
     }
 
-    // Make sure that next or prev did not fail due to any other error but not found. In case of
-    // another error, we are not good to move forward.
+    // Make sure that next did not fail due to any other error but not found. In case of another
+    // error, we are not good to move forward.
     if (ret == WT_NOTFOUND)
         return false;
     fassertFailedWithStatus(40685, wtRCToStatus(ret));
@@ -1438,21 +1461,16 @@ Status WiredTigerIndexUnique::_insertTimestampSafe(OperationContext* opCtx,
     KeyString tableKey(keyStringVersion(), key, _ordering, id);
     WiredTigerItem keyItem(tableKey.getBuffer(), tableKey.getSize());
 
-    // Pre-check before inserting on a secondary. An entry with same prefix key is allowed but not
-    // with the exactly same table key.
-    if (dupsAllowed) {
-        setKey(c, keyItem.Get());
-        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
-        if (ret == 0)
-            return dupKeyError(key);
-    }
-
+    // An entry with same prefix key is allowed on a secondary but not with the exactly same table
+    // key. The cursor doesn't overwrite, so the insert itself detects that without a prior search.
     WiredTigerItem valueItem = tableKey.getTypeBits().isAllZeros()
         ? emptyItem
         : WiredTigerItem(tableKey.getTypeBits().getBuffer(), tableKey.getTypeBits().getSize());
     setKey(c, keyItem.Get());
     c->set_value(c, valueItem.Get());
     ret = WT_OP_CHECK(c->insert(c));
+    if (ret == WT_DUPLICATE_KEY)
+        return dupKeyError(key);
     invariantWTOK(ret);
 
     return Status::OK();
@@ -100,12 +100,17 @@ public:
                          const RecordId& id,
                          bool dupsAllowed);
 
+    void unindexMany(OperationContext* opCtx,
+                     const std::vector<IndexKeyEntry>& entries,
+                     bool dupsAllowed) override;
+
     virtual void fullValidate(OperationContext* opCtx,
                               long long* numKeysOut,
                               ValidateResults* fullResults) const;
     virtual bool appendCustomStats(OperationContext* opCtx,
                                    BSONObjBuilder* output,
                                    double scale) const;
+    bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const override;
     virtual Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key, const RecordId& id);
 
     virtual bool isEmpty(OperationContext* opCtx);
@@ -116,6 +116,7 @@ public:
         kv->setSortedDataInterfaceExtraOptions(wiredTigerGlobalOptions.indexConfig);
         // Intentionally leaked.
         new WiredTigerServerStatusSection(kv);
+        new WiredTigerConcurrentTransactionsServerStatusSection();
         new WiredTigerEngineRuntimeConfigParameter(kv);
 
         KVStorageEngineOptions options;
@@ -179,11 +180,80 @@ public:
         return true;
     }
 };
+
+/**
+ * Creates a non-durable WiredTiger engine that keeps every table in the cache. It retains
+ * document-level concurrency and snapshot isolation, but never takes checkpoints or writes a
+ * journal, so all data is lost when the process exits. The data set, including the oplog, must fit
+ * in --inMemorySizeGB; writes fail with ExceededMemoryLimit once it is full.
+ */
+class WiredTigerInMemoryFactory : public StorageEngine::Factory {
+public:
+    virtual ~WiredTigerInMemoryFactory() {}
+    virtual StorageEngine* create(const StorageGlobalParams& params,
+                                  const StorageEngineLockFile* lockFile) const {
+        if (params.dur) {
+            log() << "The " << getCanonicalName()
+                  << " storage engine does not support journaling; ignoring the journal setting";
+        }
+
+        size_t cacheMB = WiredTigerUtil::getCacheSizeMB(wiredTigerGlobalOptions.inMemorySizeGB);
+        const bool durable = false;
+        const bool ephemeral = true;
+        const bool readOnly = false;
+        WiredTigerKVEngine* kv =
+            new WiredTigerKVEngine(getCanonicalName().toString(),
+                                   params.dbpath,
+                                   getGlobalServiceContext()->getFastClockSource(),
+                                   wiredTigerGlobalOptions.inMemoryEngineConfig,
+                                   cacheMB,
+                                   durable,
+                                   ephemeral,
+                                   params.repair,
+                                   readOnly);
+        kv->setRecordStoreExtraOptions(wiredTigerGlobalOptions.collectionConfig);
+        kv->setSortedDataInterfaceExtraOptions(wiredTigerGlobalOptions.indexConfig);
+        // Intentionally leaked.
+        new WiredTigerServerStatusSection(kv);
+        new WiredTigerConcurrentTransactionsServerStatusSection();
+        new WiredTigerEngineRuntimeConfigParameter(kv);
+
+        KVStorageEngineOptions options;
+        options.directoryPerDB = params.directoryperdb;
+        options.directoryForIndexes = wiredTigerGlobalOptions.directoryForIndexes;
+        options.forRepair = params.repair;
+        return new KVStorageEngine(kv, options);
+    }
+
+    virtual StringData getCanonicalName() const {
+        return kWiredTigerInMemoryEngineName;
+    }
+
+    virtual Status validateCollectionStorageOptions(const BSONObj& options) const {
+        return WiredTigerRecordStore::parseOptionsField(options).getStatus();
+    }
+
+    virtual Status validateIndexStorageOptions(const BSONObj& options) const {
+        return WiredTigerIndex::parseIndexOptions(options).getStatus();
+    }
+
+    virtual Status validateMetadata(const StorageEngineMetadata& metadata,
+                                    const StorageGlobalParams& params) const {
+        // Nothing survives a restart, so there is no on-disk format to stay compatible with.
+        return Status::OK();
+    }
+
+    virtual BSONObj createMetadataOptions(const StorageGlobalParams& params) const {
+        return BSONObj();
+    }
+};
 }  // namespace
 
 MONGO_INITIALIZER_WITH_PREREQUISITES(WiredTigerEngineInit, ("ServiceContext"))
 (InitializerContext* context) {
     registerStorageEngine(getGlobalServiceContext(), std::make_unique<WiredTigerFactory>());
+    registerStorageEngine(getGlobalServiceContext(),
+                          std::make_unique<WiredTigerInMemoryFactory>());
     return Status::OK();
 }
 }
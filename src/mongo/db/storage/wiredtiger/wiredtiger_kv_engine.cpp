@@ -68,6 +68,7 @@
 #include "mongo/db/snapshot_window_options.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cache_stats_sampler.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
@@ -76,6 +77,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
@@ -247,6 +249,39 @@ private:
     AtomicBool _shuttingDown{false};
 };
 
+namespace {
+
+// When positive, the checkpoint thread starts a checkpoint before the regular 'syncdelay' interval
+// is up once the dirty bytes in the cache would take about this many seconds to write at the
+// throughput observed during recent checkpoints. Smaller, more frequent checkpoints spread the
+// write load that a single large checkpoint would otherwise issue all at once. 0 disables early
+// checkpoints.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCheckpointTargetDurationSecs, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerCheckpointTargetDurationSecs must be greater than or equal "
+                          "to 0");
+        }
+        return Status::OK();
+    });
+
+// Early checkpoints never start sooner than this many seconds after the previous checkpoint
+// finished.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCheckpointMinIntervalSecs, int, 10)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerCheckpointMinIntervalSecs must be greater than or equal to 1");
+        }
+        return Status::OK();
+    });
+
+// How often the checkpoint thread re-evaluates whether an early checkpoint is warranted.
+const Seconds kCheckpointSchedulerTick(1);
+
+}  // namespace
+
 class WiredTigerKVEngine::WiredTigerCheckpointThread : public BackgroundJob {
 public:
     explicit WiredTigerCheckpointThread(WiredTigerSessionCache* sessionCache)
@@ -264,17 +299,44 @@ public:
 
         LOG(1) << "starting " << name() << " thread";
 
+        Date_t lastCheckpointEnd = Date_t::now();
         while (!_shuttingDown.load()) {
+            const Seconds checkpointDelay(
+                static_cast<std::int64_t>(wiredTigerGlobalOptions.checkpointDelaySecs));
+            bool early = false;
             {
+                // Without early checkpoints, sleep for the whole interval as we always have.
+                // Otherwise wake every tick to see whether enough dirty data has built up. A
+                // notification, for shutdown or for the first stable checkpoint, takes a
+                // checkpoint right away.
                 stdx::unique_lock<stdx::mutex> lock(_mutex);
-                MONGO_IDLE_THREAD_BLOCK;
-                _condvar.wait_for(lock,
-                                  stdx::chrono::seconds(static_cast<std::int64_t>(
-                                      wiredTigerGlobalOptions.checkpointDelaySecs)));
+                const Date_t deadline = lastCheckpointEnd + checkpointDelay;
+                while (!_checkpointRequested && Date_t::now() < deadline) {
+                    const Date_t wakeUp = wiredTigerCheckpointTargetDurationSecs.load() > 0
+                        ? std::min(deadline, Date_t::now() + kCheckpointSchedulerTick)
+                        : deadline;
+                    stdx::cv_status waitStatus;
+                    {
+                        MONGO_IDLE_THREAD_BLOCK;
+                        waitStatus = _condvar.wait_until(lock, wakeUp.toSystemTimePoint());
+                    }
+                    if (waitStatus != stdx::cv_status::timeout || wakeUp == deadline) {
+                        continue;
+                    }
+                    lock.unlock();
+                    early = _shouldCheckpointEarly(lastCheckpointEnd);
+                    lock.lock();
+                    if (early) {
+                        break;
+                    }
+                }
+                _checkpointRequested = false;
             }
 
             const Timestamp stableTimestamp(_stableTimestamp.load());
             const Timestamp initialDataTimestamp(_initialDataTimestamp.load());
+            const Date_t checkpointStart = Date_t::now();
+            bool checkpointed = false;
             try {
                 // Three cases:
                 //
@@ -289,9 +351,8 @@ public:
                 // Third, stableTimestamp >= initialDataTimestamp: Take stable checkpoint. Steady
                 // state case.
                 if (initialDataTimestamp.asULL() <= 1) {
-                    UniqueWiredTigerSession session = _sessionCache->getSession();
-                    WT_SESSION* s = session->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=false"));
+                    _checkpoint("use_timestamp=false");
+                    checkpointed = true;
                 } else if (stableTimestamp < initialDataTimestamp) {
                     LOG_FOR_RECOVERY(2)
                         << "Stable timestamp is behind the initial data timestamp, skipping "
@@ -306,9 +367,8 @@ public:
                     // at.
                     auto stableTimestamp = _stableTimestamp.load();
 
-                    UniqueWiredTigerSession session = _sessionCache->getSession();
-                    WT_SESSION* s = session->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=true"));
+                    _checkpoint("use_timestamp=true");
+                    checkpointed = true;
 
                     // Publish the checkpoint time after the checkpoint becomes durable.
                     _lastStableCheckpointTimestamp.store(stableTimestamp);
@@ -319,10 +379,31 @@ public:
             } catch (const AssertionException& exc) {
                 invariant(ErrorCodes::isShutdownError(exc.code()), exc.what());
             }
+
+            lastCheckpointEnd = Date_t::now();
+            if (checkpointed) {
+                (early ? _earlyCheckpoints : _scheduledCheckpoints).fetchAndAdd(1);
+                const auto durationMillis =
+                    durationCount<Milliseconds>(lastCheckpointEnd - checkpointStart);
+                _lastDurationMillis.store(durationMillis);
+                _totalDurationMillis.fetchAndAdd(durationMillis);
+            }
         }
         LOG(1) << "stopping " << name() << " thread";
     }
 
+    void appendStats(BSONObjBuilder* builder) const {
+        BSONObjBuilder bob(builder->subobjStart("checkpointScheduler"));
+        bob.append("scheduledCheckpoints", _scheduledCheckpoints.load());
+        bob.append("earlyCheckpoints", _earlyCheckpoints.load());
+        bob.append("lastDurationMillis", _lastDurationMillis.load());
+        bob.append("totalDurationMillis", _totalDurationMillis.load());
+        bob.append("lastBytesWritten", _lastBytesWritten.load());
+        bob.append("totalBytesWritten", _totalBytesWritten.load());
+        bob.append("observedWriteBytesPerSec", _observedWriteBytesPerSec.load());
+        bob.append("dirtyBytesTrigger", _dirtyBytesTrigger.load());
+    }
+
     bool canRecoverToStableTimestamp() {
         static const std::uint64_t allowUnstableCheckpointsSentinel =
             static_cast<std::uint64_t>(Timestamp::kAllowUnstableCheckpointsSentinel.asULL());
@@ -347,6 +428,7 @@ public:
                   << Timestamp(initialData) << " PrevStable: " << Timestamp(prevStable)
                   << " CurrStable: " << stableTimestamp;
             stdx::unique_lock<stdx::mutex> lock(_mutex);
+            _checkpointRequested = true;
             _condvar.notify_one();
         }
     }
@@ -369,18 +451,106 @@ public:
     }
 
     void shutdown() {
-        _shuttingDown.store(true);
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            _shuttingDown.store(true);
+            _checkpointRequested = true;
+        }
         _condvar.notify_one();
         wait();
     }
 
 private:
+    std::int64_t _getConnectionStat(WT_SESSION* s, int key) {
+        auto swValue = WiredTigerUtil::getStatisticsValueAs<std::int64_t>(
+            s, "statistics:", "statistics=(fast)", key);
+        return swValue.isOK() ? swValue.getValue() : 0;
+    }
+
+    /**
+     * Takes a checkpoint with 'config', and records how many bytes it wrote and how quickly, which
+     * sizes later early checkpoints.
+     */
+    void _checkpoint(const char* config) {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+
+        const auto bytesBefore = _getConnectionStat(s, WT_STAT_CONN_BLOCK_BYTE_WRITE_CHECKPOINT);
+        const auto start = curTimeMicros64();
+        invariantWTOK(s->checkpoint(s, config));
+        const auto elapsedMicros = std::max<std::int64_t>(curTimeMicros64() - start, 1);
+        const auto bytesWritten = std::max<std::int64_t>(
+            _getConnectionStat(s, WT_STAT_CONN_BLOCK_BYTE_WRITE_CHECKPOINT) - bytesBefore, 0);
+
+        _lastBytesWritten.store(bytesWritten);
+        _totalBytesWritten.fetchAndAdd(bytesWritten);
+
+        // Checkpoints that write very little are dominated by fixed costs and say nothing about
+        // what the device can sustain.
+        const std::int64_t kMinBytesForThroughput = 16 * 1024 * 1024;
+        if (bytesWritten >= kMinBytesForThroughput) {
+            const std::int64_t observed = bytesWritten * 1000 * 1000 / elapsedMicros;
+            const std::int64_t previous = _observedWriteBytesPerSec.load();
+            _observedWriteBytesPerSec.store(previous ? (previous + observed) / 2 : observed);
+        }
+    }
+
+    /**
+     * Returns true if the dirty data in the cache has grown to the point that a checkpoint
+     * started now would take about 'wiredTigerCheckpointTargetDurationSecs' to write.
+     */
+    bool _shouldCheckpointEarly(Date_t lastCheckpointEnd) {
+        const int targetSecs = wiredTigerCheckpointTargetDurationSecs.load();
+        const std::int64_t throughput = _observedWriteBytesPerSec.load();
+        if (targetSecs <= 0 || throughput <= 0) {
+            _dirtyBytesTrigger.store(0);
+            return false;
+        }
+        const std::int64_t trigger = throughput * targetSecs;
+        _dirtyBytesTrigger.store(trigger);
+
+        if (Date_t::now() - lastCheckpointEnd <
+            Seconds(wiredTigerCheckpointMinIntervalSecs.load())) {
+            return false;
+        }
+
+        // A stable checkpoint only persists data up to the stable timestamp, so if it has not
+        // moved since the last one, an early checkpoint would write almost nothing of value.
+        const std::uint64_t initialData = _initialDataTimestamp.load();
+        const std::uint64_t stable = _stableTimestamp.load();
+        if (initialData > 1 &&
+            (stable < initialData || stable == _lastStableCheckpointTimestamp.load())) {
+            return false;
+        }
+
+        try {
+            UniqueWiredTigerSession session = _sessionCache->getSession();
+            return _getConnectionStat(session->getSession(), WT_STAT_CONN_CACHE_BYTES_DIRTY) >=
+                trigger;
+        } catch (const AssertionException& exc) {
+            invariant(ErrorCodes::isShutdownError(exc.code()), exc.what());
+            return false;
+        }
+    }
+
     WiredTigerSessionCache* _sessionCache;
 
-    // _mutex/_condvar used to notify when _shuttingDown is flipped.
+    // _mutex/_condvar used to notify when _shuttingDown is flipped, or when a checkpoint should be
+    // taken right away. '_checkpointRequested' is guarded by '_mutex'.
     stdx::mutex _mutex;
     stdx::condition_variable _condvar;
     AtomicBool _shuttingDown{false};
+    bool _checkpointRequested = false;
+
+    // Statistics reported in serverStatus, and hence in FTDC.
+    AtomicInt64 _scheduledCheckpoints{0};
+    AtomicInt64 _earlyCheckpoints{0};
+    AtomicInt64 _lastDurationMillis{0};
+    AtomicInt64 _totalDurationMillis{0};
+    AtomicInt64 _lastBytesWritten{0};
+    AtomicInt64 _totalBytesWritten{0};
+    AtomicInt64 _observedWriteBytesPerSec{0};
+    AtomicInt64 _dirtyBytesTrigger{0};
 
     AtomicWord<std::uint64_t> _stableTimestamp;
     AtomicWord<std::uint64_t> _initialDataTimestamp;
@@ -435,9 +605,23 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// Fallback pools for internal operations, such as oplog application and chunk migration, which
+// must not queue behind user operations when the regular pools are exhausted.
+TicketHolder openPriorityWriteTransaction(16);
+TicketServerParameter openPriorityWriteTransactionParam(
+    &openPriorityWriteTransaction, "wiredTigerConcurrentPriorityWriteTransactions");
+
+TicketHolder openPriorityReadTransaction(16);
+TicketServerParameter openPriorityReadTransactionParam(
+    &openPriorityReadTransaction, "wiredTigerConcurrentPriorityReadTransactions");
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
+
+stdx::function<bool(StringData)> requestCappedDeletionCallback = [](StringData) -> bool {
+    return false;
+};
 }  // namespace
 
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
@@ -505,6 +689,13 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     ss << WiredTigerCustomizationHooks::get(getGlobalServiceContext())
               ->getTableCreateConfig("system");
     ss << WiredTigerExtensions::get(getGlobalServiceContext())->getOpenExtensionsConfig();
+    if (_ephemeral) {
+        // An ephemeral engine keeps all of its tables in the cache and never writes data files,
+        // checkpoints or log records. Writes fail with WT_CACHE_FULL once the cache is full.
+        invariant(!_durable);
+        invariant(!_readOnly);
+        ss << "in_memory=true,";
+    }
     ss << extraOpenOptions;
     if (_readOnly) {
         invariant(!_durable);
@@ -514,7 +705,7 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         // If we started without the journal, but previously used the journal then open with the
         // WT log enabled to perform any unclean shutdown recovery and then close and reopen in
         // the normal path without the journal.
-        if (boost::filesystem::exists(journalPath)) {
+        if (!_ephemeral && boost::filesystem::exists(journalPath)) {
             string config = ss.str();
             log() << "Detected WT journal files.  Running recovery from last checkpoint.";
             log() << "journal to nojournal transition config: " << config;
@@ -569,6 +760,15 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         _checkpointThread->go();
     }
 
+    _cacheStatsSampler = stdx::make_unique<WiredTigerCacheStatsSampler>(_sessionCache.get());
+    _cacheStatsSampler->go();
+
+    if (!_readOnly) {
+        _ticketTuner = stdx::make_unique<WiredTigerTicketTuner>(
+            _sessionCache.get(), &openReadTransaction, &openWriteTransaction);
+        _ticketTuner->go();
+    }
+
     _sizeStorerUri = "table:sizeStorer";
     WiredTigerSession session(_conn);
     if (!_readOnly && repair && _hasUri(session.getSession(), _sizeStorerUri)) {
@@ -579,7 +779,10 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sizeStorer.reset(new WiredTigerSizeStorer(_conn, _sizeStorerUri, _readOnly));
     _sizeStorer->fillCache();
 
-    Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+    Locker::setGlobalThrottling(&openReadTransaction,
+                                &openWriteTransaction,
+                                &openPriorityReadTransaction,
+                                &openPriorityWriteTransaction);
 }
 
 
@@ -595,21 +798,38 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
         BSONObjBuilder bbb(bb.subobjStart("write"));
-        bbb.append("out", openWriteTransaction.used());
-        bbb.append("available", openWriteTransaction.available());
-        bbb.append("totalTickets", openWriteTransaction.outof());
+        openWriteTransaction.appendStats(&bbb);
         bbb.done();
     }
     {
         BSONObjBuilder bbb(bb.subobjStart("read"));
-        bbb.append("out", openReadTransaction.used());
-        bbb.append("available", openReadTransaction.available());
-        bbb.append("totalTickets", openReadTransaction.outof());
+        openReadTransaction.appendStats(&bbb);
+        bbb.done();
+    }
+    {
+        BSONObjBuilder bbb(bb.subobjStart("priorityWrite"));
+        openPriorityWriteTransaction.appendStats(&bbb);
+        bbb.done();
+    }
+    {
+        BSONObjBuilder bbb(bb.subobjStart("priorityRead"));
+        openPriorityReadTransaction.appendStats(&bbb);
+        bbb.done();
+    }
+    if (_ticketTuner) {
+        BSONObjBuilder bbb(bb.subobjStart("adaptive"));
+        _ticketTuner->appendStats(&bbb);
         bbb.done();
     }
     bb.done();
 }
 
+void WiredTigerKVEngine::appendCheckpointStats(BSONObjBuilder* builder) const {
+    if (_checkpointThread) {
+        _checkpointThread->appendStats(builder);
+    }
+}
+
 void WiredTigerKVEngine::cleanShutdown() {
     log() << "WiredTigerKVEngine shutting down";
     if (!_readOnly)
@@ -619,6 +839,10 @@ void WiredTigerKVEngine::cleanShutdown() {
     }
 
     // these must be the last things we do before _conn->close();
+    if (_ticketTuner)
+        _ticketTuner->shutdown();
+    if (_cacheStatsSampler)
+        _cacheStatsSampler->shutdown();
     if (_journalFlusher)
         _journalFlusher->shutdown();
     if (_checkpointThread) {
@@ -649,7 +873,9 @@ void WiredTigerKVEngine::cleanShutdown() {
         closeConfig = "leak_memory=true,";
     }
 
-    if (!_fileVersion.shouldDowngrade(_readOnly, _inRepairMode, !_recoveryTimestamp.isNull())) {
+    // There are no data files to downgrade when running in memory.
+    if (_ephemeral ||
+        !_fileVersion.shouldDowngrade(_readOnly, _inRepairMode, !_recoveryTimestamp.isNull())) {
         closeConfig += "use_timestamp=true,";
         invariantWTOK(_conn->close(_conn, closeConfig.c_str()));
         return;
@@ -1154,6 +1380,14 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
     return initRsOplogBackgroundThreadCallback(ns);
 }
 
+void WiredTigerKVEngine::setRequestCappedDeletionCallback(stdx::function<bool(StringData)> cb) {
+    requestCappedDeletionCallback = std::move(cb);
+}
+
+bool WiredTigerKVEngine::requestCappedDeletion(StringData ns) {
+    return requestCappedDeletionCallback(ns);
+}
+
 namespace {
 
 MONGO_FAIL_POINT_DEFINE(WTPreserveSnapshotHistoryIndefinitely);
@@ -50,6 +50,8 @@ namespace mongo {
 
 class ClockSource;
 class JournalListener;
+class WiredTigerCacheStatsSampler;
+class WiredTigerTicketTuner;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
@@ -209,6 +211,12 @@ public:
     WT_CONNECTION* getConnection() {
         return _conn;
     }
+    WiredTigerSessionCache* getSessionCache() const {
+        return _sessionCache.get();
+    }
+    WiredTigerCacheStatsSampler* getCacheStatsSampler() const {
+        return _cacheStatsSampler.get();
+    }
     void dropSomeQueuedIdents();
     std::list<WiredTigerCachedCursor> filterCursorsWithQueuedDrops(
         std::list<WiredTigerCachedCursor>* cache);
@@ -265,8 +273,26 @@ public:
      */
     static bool initRsOplogBackgroundThread(StringData ns);
 
+    /**
+     * Sets the implementation for `requestCappedDeletion`. Intended to be called from a
+     * MONGO_INITIALIZER and therefore in a single threaded context.
+     */
+    static void setRequestCappedDeletionCallback(stdx::function<bool(StringData)> cb);
+
+    /**
+     * Asks the background capped deleter to remove excess documents from the capped collection
+     * 'ns'. Returns false if there is no background deleter, in which case the caller must delete
+     * the excess documents itself.
+     */
+    static bool requestCappedDeletion(StringData ns);
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Appends the checkpoint thread's scheduling statistics, if there is a checkpoint thread.
+     */
+    void appendCheckpointStats(BSONObjBuilder* builder) const;
+
     bool isCacheUnderPressure(OperationContext* opCtx) const override;
 
     /**
@@ -328,6 +354,8 @@ private:
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerCacheStatsSampler> _cacheStatsSampler;
+    std::unique_ptr<WiredTigerTicketTuner> _ticketTuner;
 
     std::string _rsOptions;
     std::string _indexOptions;
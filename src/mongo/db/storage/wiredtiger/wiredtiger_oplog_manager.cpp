@@ -33,12 +33,16 @@
 
 #include <cstring>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -121,7 +125,21 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
     // Close transaction before we wait.
     opCtx->recoveryUnit()->abandonSnapshot();
 
+    // The read timestamp is published atomically, so there is no need to take the mutex if the
+    // last oplog entry is already visible. _oplogMaxAtStartup is only written before the manager
+    // starts running.
+    if (std::max(RecordId(getOplogReadTimestamp()), _oplogMaxAtStartup) >= waitingFor) {
+        return;
+    }
+
     stdx::unique_lock<stdx::mutex> lk(_oplogVisibilityStateMutex);
+
+    // Let the oplog journal thread know that someone is blocked on visibility, so that it stops
+    // delaying the next refresh.
+    ++_visibilityWaiters;
+    ON_BLOCK_EXIT([&] { --_visibilityWaiters; });
+    _opsWaitingForJournalCV.notify_one();
+
     opCtx->waitForConditionOrInterrupt(_opsBecameVisibleCV, lk, [&] {
         auto newLatestVisibleTimestamp = getOplogReadTimestamp();
         if (newLatestVisibleTimestamp < currentLatestVisibleTimestamp) {
@@ -147,9 +165,19 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
 }
 
 void WiredTigerOplogManager::triggerJournalFlush() {
+    if (_opsWaitingSinceMicros.load() == 0) {
+        _opsWaitingSinceMicros.compareAndSwap(0, curTimeMicros64());
+    }
+
+    // If a refresh is already pending, it has not yet queried all_committed, so it covers this
+    // commit as well.
+    if (_opsWaitingForJournal.load()) {
+        return;
+    }
+
     stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
-    if (!_opsWaitingForJournal) {
-        _opsWaitingForJournal = true;
+    if (!_opsWaitingForJournal.load()) {
+        _opsWaitingForJournal.store(true);
         _opsWaitingForJournalCV.notify_one();
     }
 }
@@ -165,8 +193,8 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
         stdx::unique_lock<stdx::mutex> lk(_oplogVisibilityStateMutex);
         {
             MONGO_IDLE_THREAD_BLOCK;
-            _opsWaitingForJournalCV.wait(lk,
-                                         [&] { return _shuttingDown || _opsWaitingForJournal; });
+            _opsWaitingForJournalCV.wait(
+                lk, [&] { return _shuttingDown || _opsWaitingForJournal.load(); });
 
             // If we're not shutting down and nobody is actively waiting for the oplog to become
             // durable, delay journaling a bit to reduce the sync rate.
@@ -177,7 +205,8 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
             auto now = Date_t::now();
             auto deadline = now + journalDelay;
             auto shouldSyncOpsWaitingForJournal = [&] {
-                return _shuttingDown || oplogRecordStore->haveCappedWaiters();
+                return _shuttingDown || _visibilityWaiters > 0 ||
+                    oplogRecordStore->haveCappedWaiters();
             };
 
             // Eventually it would be more optimal to merge this with the normal journal flushing
@@ -203,8 +232,9 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
             log() << "oplog journal thread loop shutting down";
             return;
         }
-        invariant(_opsWaitingForJournal);
-        _opsWaitingForJournal = false;
+        invariant(_opsWaitingForJournal.load());
+        _opsWaitingForJournal.store(false);
+        const uint64_t pendingSinceMicros = _opsWaitingSinceMicros.swap(0);
         lk.unlock();
 
         const uint64_t newTimestamp = fetchAllCommittedValue(sessionCache->conn());
@@ -229,11 +259,50 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
         }
         lk.unlock();
 
+        _recordVisibilityLatency(pendingSinceMicros);
+
         // Wake up any await_data cursors and tell them more data might be visible now.
         oplogRecordStore->notifyCappedWaitersIfNeeded();
     }
 }
 
+void WiredTigerOplogManager::_recordVisibilityLatency(uint64_t pendingSinceMicros) {
+    if (pendingSinceMicros == 0) {
+        return;
+    }
+
+    const uint64_t now = curTimeMicros64();
+    const uint64_t latencyMicros = now > pendingSinceMicros ? now - pendingSinceMicros : 0;
+
+    int bucket = 0;
+    for (uint64_t millis = latencyMicros / 1000; millis > 0; millis >>= 1) {
+        if (++bucket == kVisibilityLatencyBuckets - 1) {
+            break;
+        }
+    }
+    _visibilityLatencyBuckets[bucket].fetchAndAdd(1);
+    _visibilityLatencyCount.fetchAndAdd(1);
+    _visibilityLatencyTotalMicros.fetchAndAdd(latencyMicros);
+}
+
+void WiredTigerOplogManager::appendVisibilityLatencyStats(BSONObjBuilder* builder) const {
+    BSONObjBuilder visibility(builder->subobjStart("oplogVisibility"));
+    visibility.append("refreshes", static_cast<long long>(_visibilityLatencyCount.load()));
+    visibility.append("totalLatencyMicros",
+                      static_cast<long long>(_visibilityLatencyTotalMicros.load()));
+
+    BSONObjBuilder histogram(visibility.subobjStart("latencyHistogram"));
+    for (int i = 0; i < kVisibilityLatencyBuckets; ++i) {
+        std::string key;
+        if (i < kVisibilityLatencyBuckets - 1) {
+            key = str::stream() << "<" << (1 << i) << "ms";
+        } else {
+            key = str::stream() << ">=" << (1 << (i - 1)) << "ms";
+        }
+        histogram.append(key, static_cast<long long>(_visibilityLatencyBuckets[i].load()));
+    }
+}
+
 std::uint64_t WiredTigerOplogManager::getOplogReadTimestamp() const {
     return _oplogReadTimestamp.load();
 }
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/stdx/condition_variable.h"
@@ -38,6 +40,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 
@@ -71,6 +74,8 @@ public:
     void setOplogReadTimestamp(Timestamp ts);
 
     // Triggers the oplogJournal thread to update its oplog read timestamp, by flushing the journal.
+    // Called on every commit that may make oplog entries visible, so this avoids taking the mutex
+    // when a refresh is already pending.
     void triggerJournalFlush();
 
     // Waits until all committed writes at this point to become visible (that is, no holes exist in
@@ -82,12 +87,18 @@ public:
     // all committed timestamp are committed.
     uint64_t fetchAllCommittedValue(WT_CONNECTION* conn);
 
+    // Appends an "oplogVisibility" subobject with a histogram of how long it takes an oplog write
+    // to become visible to oplog readers after it commits.
+    void appendVisibilityLatencyStats(BSONObjBuilder* builder) const;
+
 private:
     void _oplogJournalThreadLoop(WiredTigerSessionCache* sessionCache,
                                  WiredTigerRecordStore* oplogRecordStore) noexcept;
 
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
+    void _recordVisibilityLatency(uint64_t pendingSinceMicros);
+
     stdx::thread _oplogJournalThread;
     mutable stdx::mutex _oplogVisibilityStateMutex;
     mutable stdx::condition_variable
@@ -101,8 +112,26 @@ private:
     // This is the RecordId of the newest oplog document in the oplog on startup.  It is used as a
     // floor in waitForAllEarlierOplogWritesToBeVisible().
     RecordId _oplogMaxAtStartup = RecordId(0);  // Guarded by oplogVisibilityStateMutex.
-    bool _opsWaitingForJournal = false;         // Guarded by oplogVisibilityStateMutex.
+
+    // Set by committers that need the oplog read timestamp refreshed. Only set while holding the
+    // oplogVisibilityStateMutex, but read without it so that commits can skip the mutex when a
+    // refresh is already pending. Cleared by the oplog journal thread before each refresh.
+    AtomicBool _opsWaitingForJournal{false};
+
+    // Time of the earliest commit that the next refresh will cover, or 0 if there is none.
+    AtomicUInt64 _opsWaitingSinceMicros;
+
+    // Number of threads blocked in waitForAllEarlierOplogWritesToBeVisible(). While non-zero, the
+    // oplog journal thread refreshes immediately instead of delaying to batch journal flushes.
+    mutable int _visibilityWaiters = 0;  // Guarded by oplogVisibilityStateMutex.
 
     AtomicUInt64 _oplogReadTimestamp;
+
+    // Commit-to-visible latency histogram. Bucket 0 counts latencies under 1ms, bucket i counts
+    // latencies in [2^(i-1), 2^i) ms, and the last bucket counts everything longer.
+    static constexpr int kVisibilityLatencyBuckets = 12;
+    std::array<AtomicUInt64, kVisibilityLatencyBuckets> _visibilityLatencyBuckets;
+    AtomicUInt64 _visibilityLatencyCount;
+    AtomicUInt64 _visibilityLatencyTotalMicros;
 };
 }  // namespace mongo
@@ -47,9 +47,11 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cache_stats_sampler.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
@@ -62,6 +64,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -81,6 +84,48 @@ static const int kMaximumRecordStoreVersion = 1;
 MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion >= kMinimumRecordStoreVersion);
 MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion);
 
+// getManyCursors() splits a collection into at most this many RecordId ranges, each of which
+// should cover at least kMinRecordsPerManyCursor records. Smaller ranges aren't worth the cost of
+// opening another cursor.
+const int64_t kMaxManyCursors = 64;
+const int64_t kMinRecordsPerManyCursor = 1000;
+
+// Forward oplog cursors ask for this many stones beyond the one they are reading to be read into
+// the cache in the background, so that readers that have fallen behind, such as the oplog fetcher
+// of a lagged secondary, find the pages already resident. 0 disables read-ahead.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOplogReadAheadStones, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerOplogReadAheadStones must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+// The most oplog stones reclaimed with a single range truncate.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOplogTruncateMaxStonesPerBatch, int, 10)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerOplogTruncateMaxStonesPerBatch must be greater than or equal "
+                          "to 1");
+        }
+        return Status::OK();
+    });
+
+// When positive, the oplog reclaim thread truncates one batch of stones at a time and then pauses
+// for this long, with its locks released, so that reclaiming a large backlog does not compete
+// with foreground writes.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOplogTruncateBatchDelayMillis, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerOplogTruncateBatchDelayMillis must be greater than or equal "
+                          "to 0");
+        }
+        return Status::OK();
+    });
+
 void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
     StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
     fassert(39999, appMetadata);
@@ -93,6 +138,7 @@ MONGO_FAIL_POINT_DEFINE(WTWriteConflictException);
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictExceptionForReads);
 
 const std::string kWiredTigerEngineName = "wiredTiger";
+const std::string kWiredTigerInMemoryEngineName = "inMemory";
 
 // For a capped collection, the number of documents that can be removed directly, rather than via a
 // truncate.  The value has been determined somewhat by experimentation, but there's no clear win
@@ -156,7 +202,9 @@ private:
 };
 
 WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTigerRecordStore* rs)
-    : _rs(rs) {
+    : _rs(rs),
+      _sessionCache(WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()),
+      _uri(rs->getURI()) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     invariant(rs->isCapped());
@@ -175,6 +223,10 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
 }
 
+WiredTigerRecordStore::OplogStones::~OplogStones() {
+    _shutDownReadAhead();
+}
+
 bool WiredTigerRecordStore::OplogStones::isDead() {
     stdx::lock_guard<stdx::mutex> lk(_oplogReclaimMutex);
     return _isDead;
@@ -186,6 +238,7 @@ void WiredTigerRecordStore::OplogStones::kill() {
         _isDead = true;
     }
     _oplogReclaimCv.notify_one();
+    _shutDownReadAhead();
 }
 
 void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
@@ -203,20 +256,139 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
     }
 }
 
-boost::optional<WiredTigerRecordStore::OplogStones::Stone>
-WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
+std::vector<WiredTigerRecordStore::OplogStones::Stone>
+WiredTigerRecordStore::OplogStones::peekOldestStonesIfNeeded(size_t maxStones) const {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    if (!hasExcessStones_inlock()) {
-        return {};
+    int64_t totalBytes = 0;
+    for (const auto& stone : _stones) {
+        totalBytes += stone.bytes;
     }
 
-    return _stones.front();
+    std::vector<OplogStones::Stone> stones;
+    for (auto it = _stones.begin();
+         it != _stones.end() && stones.size() < maxStones && totalBytes > _rs->cappedMaxSize();
+         ++it) {
+        stones.push_back(*it);
+        totalBytes -= it->bytes;
+    }
+    return stones;
 }
 
-void WiredTigerRecordStore::OplogStones::popOldestStone() {
+void WiredTigerRecordStore::OplogStones::popOldestStones(size_t numStones) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    _stones.pop_front();
+    invariant(numStones <= _stones.size());
+    _stones.erase(_stones.begin(), _stones.begin() + numStones);
+}
+
+RecordId WiredTigerRecordStore::OplogStones::requestReadAhead(const RecordId& id) {
+    const int numStones = wiredTigerOplogReadAheadStones.load();
+
+    RecordId boundary = RecordId::max();
+    RecordId end;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = std::lower_bound(
+            _stones.begin(), _stones.end(), id, [](const Stone& stone, const RecordId& id) {
+                return stone.lastRecord < id;
+            });
+        if (it == _stones.end()) {
+            // 'id' is in the stone still being filled, which is recent enough to be in cache.
+            return boundary;
+        }
+        boundary = it->lastRecord;
+
+        const auto remaining = std::distance(it, _stones.end()) - 1;
+        if (numStones <= 0 || remaining == 0) {
+            return boundary;
+        }
+        end = (it + std::min<std::ptrdiff_t>(numStones, remaining))->lastRecord;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_readAheadMutex);
+        if (_readAheadShutdown || end <= _readAheadScheduledThrough) {
+            return boundary;
+        }
+        const RecordId start = std::max(boundary, _readAheadScheduledThrough);
+        _readAheadPending = std::make_pair(start, end);
+        _readAheadScheduledThrough = end;
+        if (!_readAheadThread.joinable()) {
+            _readAheadThread = stdx::thread([this] { _readAheadLoop(); });
+        }
+    }
+    _readAheadCv.notify_one();
+    return boundary;
+}
+
+void WiredTigerRecordStore::OplogStones::_readAheadLoop() {
+    setThreadName("WTOplogReadAhead");
+
+    stdx::unique_lock<stdx::mutex> lk(_readAheadMutex);
+    while (true) {
+        {
+            MONGO_IDLE_THREAD_BLOCK;
+            _readAheadCv.wait(lk, [&] { return _readAheadShutdown || _readAheadPending; });
+        }
+        if (_readAheadShutdown) {
+            return;
+        }
+        const auto range = *_readAheadPending;
+        _readAheadPending = boost::none;
+
+        lk.unlock();
+        _readAhead(range.first, range.second);
+        lk.lock();
+    }
+}
+
+void WiredTigerRecordStore::OplogStones::_readAhead(const RecordId& start, const RecordId& end) {
+    LOG(2) << "Reading the oplog between " << start << " and " << end << " into the cache";
+    try {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+
+        WT_CURSOR* c = nullptr;
+        if (s->open_cursor(s, _uri.c_str(), nullptr, nullptr, &c) != 0) {
+            return;
+        }
+        ON_BLOCK_EXIT(c->close, c);
+
+        // Walking the keys is enough to bring the leaf pages, and the values on them, into cache.
+        c->set_key(c, start.repr());
+        int cmp;
+        int ret = c->search_near(c, &cmp);
+        if (ret == 0 && cmp < 0) {
+            ret = c->next(c);
+        }
+        for (int64_t n = 0; ret == 0; ++n) {
+            int64_t key;
+            if (c->get_key(c, &key) != 0 || RecordId(key) > end) {
+                break;
+            }
+            if (n % 1000 == 0) {
+                stdx::lock_guard<stdx::mutex> lk(_readAheadMutex);
+                if (_readAheadShutdown) {
+                    break;
+                }
+            }
+            ret = c->next(c);
+        }
+    } catch (const AssertionException& exc) {
+        // The session cache refuses new sessions once shutdown has started.
+        invariant(ErrorCodes::isShutdownError(exc.code()), exc.what());
+    }
+}
+
+void WiredTigerRecordStore::OplogStones::_shutDownReadAhead() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_readAheadMutex);
+        _readAheadShutdown = true;
+    }
+    _readAheadCv.notify_one();
+    if (_readAheadThread.joinable()) {
+        _readAheadThread.join();
+    }
 }
 
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRecord) {
@@ -904,6 +1076,19 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* opCtx,
     if (!cappedAndNeedDelete())
         return 0;
 
+    // A collection capped only by size may grow into its slack while the background deleter, if
+    // there is one, catches up. Inserts then never wait on deletes.
+    if (!_isOplog && _cappedMaxDocs == -1 &&
+        (_dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack)) {
+        if (_cappedDeletePending.load() || _cappedDeletePending.swap(true)) {
+            return 0;  // Already requested.
+        }
+        if (WiredTigerKVEngine::requestCappedDeletion(ns())) {
+            return 0;
+        }
+        _cappedDeletePending.store(false);
+    }
+
     // ensure only one thread at a time can do deletes, otherwise they'll conflict.
     stdx::unique_lock<stdx::timed_mutex> lock(_cappedDeleterMutex, stdx::defer_lock);
 
@@ -1115,6 +1300,23 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded_inlock(OperationContext* opC
     return docsRemoved;
 }
 
+void WiredTigerRecordStore::reclaimCapped(OperationContext* opCtx) {
+    invariant(_isCapped && !_oplogStones);
+
+    // Inserts from here on must ask again.
+    _cappedDeletePending.store(false);
+
+    stdx::lock_guard<stdx::timed_mutex> lock(_cappedDeleterMutex);
+    while (cappedAndNeedDelete() && !inShutdown()) {
+        // There is no just-inserted record to stop at; any record may go.
+        if (cappedDeleteAsNeeded_inlock(opCtx, RecordId(_nextIdNum.load())) == 0) {
+            // Nothing could be removed, for instance because of a write conflict. The next insert
+            // past the cap will ask again.
+            break;
+        }
+    }
+}
+
 bool WiredTigerRecordStore::yieldAndAwaitOplogDeletionRequest(OperationContext* opCtx) {
     // Create another reference to the oplog stones while holding a lock on the collection to
     // prevent it from being destructed.
@@ -1154,18 +1356,37 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
                  lastStableCheckpointTimestamp ? *lastStableCheckpointTimestamp : Timestamp::min());
 }
 
+int WiredTigerRecordStore::oplogTruncateBatchDelayMillis() {
+    return wiredTigerOplogTruncateBatchDelayMillis.load();
+}
+
 void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp persistedTimestamp) {
-    while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
-        invariant(stone->lastRecord.isNormal());
+    while (true) {
+        auto stones =
+            _oplogStones->peekOldestStonesIfNeeded(wiredTigerOplogTruncateMaxStonesPerBatch.load());
+
+        // Do not truncate oplogs needed for replication recovery.
+        auto neededForRecovery = std::find_if(stones.begin(), stones.end(), [&](const auto& stone) {
+            invariant(stone.lastRecord.isNormal());
+            return static_cast<std::uint64_t>(stone.lastRecord.repr()) >=
+                persistedTimestamp.asULL();
+        });
+        stones.erase(neededForRecovery, stones.end());
+        if (stones.empty()) {
+            break;
+        }
 
-        if (static_cast<std::uint64_t>(stone->lastRecord.repr()) >= persistedTimestamp.asULL()) {
-            // Do not truncate oplogs needed for replication recovery.
-            return;
+        // Truncate the whole batch of stones with a single range truncate.
+        OplogStones::Stone batch = {0, 0, stones.back().lastRecord};
+        for (const auto& stone : stones) {
+            batch.records += stone.records;
+            batch.bytes += stone.bytes;
         }
 
         LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
-               << stone->lastRecord << " to remove approximately " << stone->records
-               << " records totaling to " << stone->bytes << " bytes";
+               << batch.lastRecord << " to remove approximately " << batch.records
+               << " records totaling to " << batch.bytes << " bytes in " << stones.size()
+               << " stones";
 
         WiredTigerRecoveryUnit* ru = WiredTigerRecoveryUnit::get(opCtx);
         WT_SESSION* session = ru->getSession()->getSession();
@@ -1180,25 +1401,31 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp pers
             int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
             invariantWTOK(ret);
             RecordId firstRecord = getKey(cursor);
-            if (firstRecord < _oplogStones->firstRecord || firstRecord > stone->lastRecord) {
+            if (firstRecord < _oplogStones->firstRecord || firstRecord > batch.lastRecord) {
                 warning() << "First oplog record " << firstRecord << " is not in truncation range ("
-                          << _oplogStones->firstRecord << ", " << stone->lastRecord << ")";
+                          << _oplogStones->firstRecord << ", " << batch.lastRecord << ")";
             }
 
-            setKey(cursor, stone->lastRecord);
+            setKey(cursor, batch.lastRecord);
             invariantWTOK(session->truncate(session, nullptr, nullptr, cursor, nullptr));
-            _changeNumRecords(opCtx, -stone->records);
-            _increaseDataSize(opCtx, -stone->bytes);
+            _changeNumRecords(opCtx, -batch.records);
+            _increaseDataSize(opCtx, -batch.bytes);
 
             wuow.commit();
 
-            // Remove the stone after a successful truncation.
-            _oplogStones->popOldestStone();
+            // Remove the stones after a successful truncation.
+            _oplogStones->popOldestStones(stones.size());
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
-            _oplogStones->firstRecord = stone->lastRecord;
+            _oplogStones->firstRecord = batch.lastRecord;
         } catch (const WriteConflictException&) {
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
+            continue;
+        }
+
+        if (oplogTruncateBatchDelayMillis() > 0) {
+            // Let the reclaim thread pause, with its locks released, before the next batch.
+            return;
         }
     }
 
@@ -1236,23 +1463,30 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 
     RecordId highestId = RecordId();
     dassert(nRecords != 0);
-    for (size_t i = 0; i < nRecords; i++) {
-        auto& record = records[i];
-        if (_isOplog) {
+    if (_isOplog) {
+        for (size_t i = 0; i < nRecords; i++) {
+            auto& record = records[i];
             StatusWith<RecordId> status =
                 oploghack::extractKey(record.data.data(), record.data.size());
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
-        } else if (_isCapped) {
-            record.id = _nextId();
-        } else {
-            record.id = _nextId();
+            dassert(record.id > highestId);
+            highestId = record.id;
+        }
+    } else {
+        // Reserve the ids for the whole batch at once rather than contending on the counter for
+        // every record.
+        const RecordId firstId = _reserveIds(nRecords);
+        for (size_t i = 0; i < nRecords; i++) {
+            records[i].id = RecordId(firstId.repr() + i);
         }
-        dassert(record.id > highestId);
-        highestId = record.id;
+        highestId = records[nRecords - 1].id;
     }
 
+    // Only set the commit timestamp when it changes, as batches are commonly inserted with a single
+    // timestamp or with none at all.
+    Timestamp lastTs;
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         Timestamp ts;
@@ -1268,9 +1502,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         } else {
             ts = timestamps[i];
         }
-        if (!ts.isNull()) {
+        if (!ts.isNull() && ts != lastTs) {
             LOG(4) << "inserting record with timestamp " << ts;
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
+            lastTs = ts;
         }
         setKey(c, record.id);
         WiredTigerItem value(record.data.data(), record.data.size());
@@ -1451,8 +1686,47 @@ std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
 
 std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors(
     OperationContext* opCtx) const {
-    std::vector<std::unique_ptr<RecordCursor>> cursors(1);
-    cursors[0] = getCursor(opCtx, /*forward=*/true);
+    std::vector<std::unique_ptr<RecordCursor>> cursors;
+
+    // Capped collections and the oplog must be read in insertion order by a single cursor.
+    int64_t numRanges = 1;
+    if (!_isCapped && !_isOplog) {
+        numRanges =
+            std::min<int64_t>(kMaxManyCursors, numRecords(opCtx) / kMinRecordsPerManyCursor);
+    }
+
+    boost::optional<Record> first;
+    boost::optional<Record> last;
+    if (numRanges > 1) {
+        first = getCursor(opCtx, /*forward=*/true)->next();
+        last = getCursor(opCtx, /*forward=*/false)->next();
+    }
+
+    if (!first || !last || first->id >= last->id) {
+        cursors.push_back(getCursor(opCtx, /*forward=*/true));
+        return cursors;
+    }
+
+    // RecordIds are assigned in increasing order, so splitting the id space evenly between the
+    // first and last records approximates an even split of the records themselves. The first and
+    // last ranges are left unbounded so that records outside of [first, last] are still seen.
+    const int64_t firstId = first->id.repr();
+    const int64_t span = last->id.repr() - firstId;
+    numRanges = std::min(numRanges, span);
+
+    RecordId rangeStart;
+    for (int64_t i = 1; i <= numRanges; ++i) {
+        const RecordId rangeEnd =
+            i == numRanges ? RecordId() : RecordId(firstId + (span / numRanges) * i);
+
+        auto cursor = getCursor(opCtx, /*forward=*/true);
+        checked_cast<WiredTigerRecordStoreCursorBase*>(cursor.get())
+            ->setRange(rangeStart, rangeEnd);
+        cursors.push_back(std::move(cursor));
+
+        rangeStart = rangeEnd;
+    }
+
     return cursors;
 }
 
@@ -1609,6 +1883,11 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
     }
 }
 
+bool WiredTigerRecordStore::appendCacheStats(OperationContext* opCtx,
+                                             BSONObjBuilder* result) const {
+    return WiredTigerCacheStatsSampler::appendStatsForURI(opCtx, getURI(), result);
+}
+
 Status WiredTigerRecordStore::touch(OperationContext* opCtx, BSONObjBuilder* output) const {
     if (_isEphemeral) {
         // Everything is already in memory.
@@ -1666,9 +1945,15 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
 }
 
 RecordId WiredTigerRecordStore::_nextId() {
+    return _reserveIds(1);
+}
+
+RecordId WiredTigerRecordStore::_reserveIds(size_t nRecords) {
     invariant(!_isOplog);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
+    invariant(nRecords > 0);
+    RecordId out = RecordId(_nextIdNum.fetchAndAdd(nRecords));
     invariant(out.isNormal());
+    invariant(RecordId(out.repr() + nRecords - 1).isNormal());
     return out;
 }
 
@@ -1855,6 +2140,7 @@ WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContex
                                                                  bool forward)
     : _rs(rs), _opCtx(opCtx), _forward(forward) {
     _cursor.emplace(rs.getURI(), rs.tableId(), true, opCtx);
+    _readAhead = forward && rs._oplogStones && wiredTigerOplogReadAheadStones.load() > 0;
 }
 
 boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
@@ -1868,8 +2154,16 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
         // Nothing after the next line can throw WCEs.
         // Note that an unpositioned (or eof) WT_CURSOR returns the first/last entry in the
         // table when you call next/prev.
-        int advanceRet = wiredTigerPrepareConflictRetry(
-            _opCtx, [&] { return _forward ? c->next(c) : c->prev(c); });
+        int advanceRet = wiredTigerPrepareConflictRetry(_opCtx, [&] {
+            if (_lastReturnedId.isNull() && !_rangeStart.isNull()) {
+                // Position on the first record at or after the start of our range.
+                int cmp;
+                setKey(c, _rangeStart);
+                int ret = c->search_near(c, &cmp);
+                return (ret == 0 && cmp < 0) ? c->next(c) : ret;
+            }
+            return _forward ? c->next(c) : c->prev(c);
+        });
         if (advanceRet == WT_NOTFOUND) {
             _eof = true;
             return {};
@@ -1886,6 +2180,11 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
         id = getKey(c);
     }
 
+    if (!_rangeEnd.isNull() && id >= _rangeEnd) {
+        _eof = true;
+        return {};
+    }
+
     if (_forward && _lastReturnedId >= id) {
         log() << "WTCursor::next -- c->next_key ( " << id
               << ") was not greater than _lastReturnedId (" << _lastReturnedId
@@ -1898,6 +2197,10 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
 
+    if (_readAhead && id > _readAheadThrough) {
+        _readAheadThrough = _rs._oplogStones->requestReadAhead(id);
+    }
+
     _lastReturnedId = id;
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
@@ -1924,6 +2227,13 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
 }
 
 
+void WiredTigerRecordStoreCursorBase::setRange(const RecordId& start, const RecordId& end) {
+    invariant(_forward);
+    invariant(_lastReturnedId.isNull());
+    _rangeStart = start;
+    _rangeEnd = end;
+}
+
 void WiredTigerRecordStoreCursorBase::save() {
     try {
         if (_cursor)
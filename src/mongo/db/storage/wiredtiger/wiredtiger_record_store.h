@@ -67,6 +67,7 @@ class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
 
 extern const std::string kWiredTigerEngineName;
+extern const std::string kWiredTigerInMemoryEngineName;
 
 class WiredTigerRecordStore : public RecordStore {
     friend class WiredTigerRecordStoreCursorBase;
@@ -206,6 +207,8 @@ public:
                                    BSONObjBuilder* result,
                                    double scale) const;
 
+    bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const override;
+
     virtual Status touch(OperationContext* opCtx, BSONObjBuilder* output) const;
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
@@ -257,10 +260,23 @@ public:
      */
     void reclaimOplog(OperationContext* opCtx, Timestamp persistedTimestamp);
 
+    /**
+     * How long the oplog reclaim thread should pause, with its locks released, after each call to
+     * reclaimOplog(). When positive, reclaimOplog() truncates at most one batch of stones per
+     * call.
+     */
+    static int oplogTruncateBatchDelayMillis();
+
     int64_t cappedDeleteAsNeeded(OperationContext* opCtx, const RecordId& justInserted);
 
     int64_t cappedDeleteAsNeeded_inlock(OperationContext* opCtx, const RecordId& justInserted);
 
+    /**
+     * Called by the background capped deleter: removes documents from this capped collection
+     * until it is back within its limits, truncating them by RecordId range.
+     */
+    void reclaimCapped(OperationContext* opCtx);
+
     // Returns false if the oplog was dropped while waiting for a deletion request.
     bool yieldAndAwaitOplogDeletionRequest(OperationContext* opCtx);
 
@@ -294,6 +310,11 @@ private:
                           size_t nRecords);
 
     RecordId _nextId();
+
+    /**
+     * Reserves 'nRecords' consecutive ids and returns the first of them.
+     */
+    RecordId _reserveIds(size_t nRecords);
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
@@ -353,6 +374,8 @@ private:
     // See comment in ::cappedDeleteAsNeeded
     int _cappedDeleteCheckCount;
     mutable stdx::timed_mutex _cappedDeleterMutex;
+    // True while a request to the background capped deleter is outstanding.
+    AtomicBool _cappedDeletePending{false};
 
     AtomicInt64 _nextIdNum;
     AtomicInt64 _dataSize;
@@ -432,6 +455,13 @@ public:
 
     void reattachToOperationContext(OperationContext* opCtx);
 
+    /**
+     * Restricts this forward cursor to the records with ids in the range ['start', 'end'). A null
+     * 'start' means the beginning of the store and a null 'end' means its end. Must be called
+     * before the first call to next().
+     */
+    void setRange(const RecordId& start, const RecordId& end);
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const = 0;
 
@@ -459,6 +489,15 @@ protected:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
 
+    // Bounds set by setRange(). Null if the cursor is not restricted in that direction.
+    RecordId _rangeStart;
+    RecordId _rangeEnd;
+
+    // Set for forward oplog cursors when oplog read-ahead is enabled. The cursor asks the oplog
+    // stones for more read-ahead each time it moves past '_readAheadThrough'.
+    bool _readAhead = false;
+    RecordId _readAheadThrough;
+
 private:
     bool isVisible(const RecordId& id);
 };
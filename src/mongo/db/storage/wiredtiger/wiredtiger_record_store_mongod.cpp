@@ -31,6 +31,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <deque>
 #include <set>
 
 #include "mongo/base/checked_cast.h"
@@ -41,12 +42,15 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
@@ -120,6 +124,9 @@ public:
         while (!globalInShutdownDeprecated()) {
             if (!_deleteExcessDocuments()) {
                 sleepmillis(1000);  // Back off in case there were problems deleting.
+            } else if (int delayMillis = WiredTigerRecordStore::oplogTruncateBatchDelayMillis()) {
+                MONGO_IDLE_THREAD_BLOCK;
+                sleepmillis(delayMillis);  // Throttle truncation behind foreground writes.
             }
         }
     }
@@ -158,5 +165,100 @@ MONGO_INITIALIZER(SetInitRsOplogBackgroundThreadCallback)(InitializerContext* co
     return Status::OK();
 }
 
+// When true, capped collections other than the oplog that are limited only by size have their
+// excess documents removed by a background thread rather than by the inserting threads. Such a
+// collection may then exceed its size by up to twice its slack before inserts delete inline.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCappedDeleteInBackground, bool, false);
+
+/**
+ * Removes excess documents from capped collections on behalf of their inserters. Namespaces are
+ * queued by requestCappedDeletion() and served in order.
+ */
+class WiredTigerCappedDeleterThread : public BackgroundJob {
+public:
+    WiredTigerCappedDeleterThread() : BackgroundJob(true /* deleteSelf */) {}
+
+    virtual std::string name() const {
+        return "WT CappedDeleterThread";
+    }
+
+    void request(const NamespaceString& nss) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _queue.push_back(nss);
+        _cv.notify_one();
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        while (!globalInShutdownDeprecated()) {
+            NamespaceString nss;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                if (_queue.empty()) {
+                    MONGO_IDLE_THREAD_BLOCK;
+                    _cv.wait_for(lk, stdx::chrono::seconds(1));
+                    continue;
+                }
+                nss = _queue.front();
+                _queue.pop_front();
+            }
+            _deleteExcessDocuments(nss);
+        }
+    }
+
+private:
+    void _deleteExcessDocuments(const NamespaceString& nss) {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+
+        try {
+            AutoGetCollection autoColl(&opCtx, nss, MODE_IX);
+            Collection* collection = autoColl.getCollection();
+            if (!collection || !collection->isCapped()) {
+                LOG(2) << "no capped collection " << nss;
+                return;
+            }
+
+            checked_cast<WiredTigerRecordStore*>(collection->getRecordStore())
+                ->reclaimCapped(&opCtx);
+        } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+            return;
+        } catch (const std::exception& e) {
+            severe() << "error in WiredTigerCappedDeleterThread: " << e.what();
+            fassertFailedNoTrace(!"error in WiredTigerCappedDeleterThread");
+        } catch (...) {
+            fassertFailedNoTrace(!"unknown error in WiredTigerCappedDeleterThread");
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    std::deque<NamespaceString> _queue;
+};
+
+WiredTigerCappedDeleterThread* _cappedDeleterThread = nullptr;
+
+bool requestCappedDeletion(StringData ns) {
+    if (!wiredTigerCappedDeleteInBackground.load() || storageGlobalParams.repair ||
+        storageGlobalParams.readOnly) {
+        return false;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_backgroundThreadMutex);
+    if (!_cappedDeleterThread) {
+        log() << "Starting WiredTigerCappedDeleterThread";
+        _cappedDeleterThread = new WiredTigerCappedDeleterThread();
+        _cappedDeleterThread->go();
+    }
+    _cappedDeleterThread->request(NamespaceString(ns));
+    return true;
+}
+
+MONGO_INITIALIZER(SetRequestCappedDeletionCallback)(InitializerContext* context) {
+    WiredTigerKVEngine::setRequestCappedDeletionCallback(requestCappedDeletion);
+    return Status::OK();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -30,16 +30,21 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 
 class OperationContext;
 class RecordId;
+class WiredTigerSessionCache;
 
 // Keep "milestones" against the oplog to efficiently remove the old records when the collection
 // grows beyond its desired maximum size.
@@ -53,6 +58,8 @@ public:
 
     OplogStones(OperationContext* opCtx, WiredTigerRecordStore* rs);
 
+    ~OplogStones();
+
     bool isDead();
 
     void kill();
@@ -69,9 +76,21 @@ public:
 
     void awaitHasExcessStonesOrDead();
 
-    boost::optional<OplogStones::Stone> peekOldestStoneIfNeeded() const;
+    /**
+     * Returns the oldest stones whose removal is needed to bring the oplog back under its maximum
+     * size, at most 'maxStones' of them, oldest first.
+     */
+    std::vector<OplogStones::Stone> peekOldestStonesIfNeeded(size_t maxStones) const;
+
+    void popOldestStones(size_t numStones);
 
-    void popOldestStone();
+    /**
+     * Called by forward oplog cursors when they reach 'id'. If read-ahead is enabled, schedules
+     * the stones following the one that contains 'id' to be read into the cache in the
+     * background. Returns the last RecordId of the stone containing 'id'; the cursor need not call
+     * again until it moves past it.
+     */
+    RecordId requestReadAhead(const RecordId& id);
 
     void createNewStoneIfNeeded(RecordId lastRecord);
 
@@ -125,6 +144,10 @@ private:
 
     void _pokeReclaimThreadIfNeeded();
 
+    void _readAheadLoop();
+    void _readAhead(const RecordId& start, const RecordId& end);
+    void _shutDownReadAhead();
+
     static const uint64_t kRandomSamplesPerStone = 10;
 
     WiredTigerRecordStore* _rs;
@@ -145,6 +168,18 @@ private:
 
     mutable stdx::mutex _mutex;  // Protects against concurrent access to the deque of oplog stones.
     std::deque<OplogStones::Stone> _stones;  // front = oldest, back = newest.
+
+    // Read-ahead runs on its own sessions, so it only needs the table, not '_rs', and may outlive
+    // the record store until kill() returns.
+    WiredTigerSessionCache* const _sessionCache;
+    const std::string _uri;
+
+    stdx::mutex _readAheadMutex;  // Protects the members below.
+    stdx::condition_variable _readAheadCv;
+    stdx::thread _readAheadThread;  // Started on the first read-ahead request.
+    bool _readAheadShutdown = false;
+    boost::optional<std::pair<RecordId, RecordId>> _readAheadPending;  // Inclusive range.
+    RecordId _readAheadScheduledThrough;  // Highest RecordId already handed to the thread.
 };
 
 }  // namespace mongo
@@ -222,6 +222,36 @@ StatusWith<RecordId> insertBSON(ServiceContext::UniqueOperationContext& opCtx,
     return res;
 }
 
+TEST(WiredTigerRecordStoreTest, InsertRecordsReservesConsecutiveIds) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    WriteUnitOfWork uow(opCtx.get());
+
+    StatusWith<RecordId> first = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+    ASSERT_OK(first.getStatus());
+
+    std::vector<Record> records = {{RecordId(), RecordData("b", 2)},
+                                   {RecordId(), RecordData("c", 2)},
+                                   {RecordId(), RecordData("d", 2)}};
+    std::vector<Timestamp> timestamps(records.size());
+    ASSERT_OK(rs->insertRecords(opCtx.get(), &records, &timestamps, false));
+
+    StatusWith<RecordId> last = rs->insertRecord(opCtx.get(), "e", 2, Timestamp(), false);
+    ASSERT_OK(last.getStatus());
+
+    for (size_t i = 0; i < records.size(); i++) {
+        ASSERT_EQ(first.getValue().repr() + 1 + static_cast<int64_t>(i), records[i].id.repr());
+        ASSERT_EQ(records[i].data.data()[0], rs->dataFor(opCtx.get(), records[i].id).data()[0]);
+    }
+    ASSERT_EQ(records.back().id.repr() + 1, last.getValue().repr());
+    ASSERT_EQ(5, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(10, rs->dataSize(opCtx.get()));
+
+    uow.commit();
+}
+
 TEST(WiredTigerRecordStoreTest, CappedCursorRollover) {
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 10000, 5));
@@ -820,6 +850,83 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that only the oldest stones needed to get back under cappedMaxSize are handed out for
+// truncation, and no more than requested at a time.
+TEST(WiredTigerRecordStoreTest, OplogStones_PeekOldestStonesInBatches) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 230U));
+    }
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 110), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 120), RecordId(1, 3));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 4), 130), RecordId(1, 4));
+        ASSERT_EQ(4U, oplogStones->numStones());
+    }
+
+    // 460 bytes are in stones, so the oldest three must go to get back under 230 bytes.
+    auto stones = oplogStones->peekOldestStonesIfNeeded(10);
+    ASSERT_EQ(3U, stones.size());
+    ASSERT_EQ(RecordId(1, 1), stones[0].lastRecord);
+    ASSERT_EQ(RecordId(1, 3), stones[2].lastRecord);
+
+    stones = oplogStones->peekOldestStonesIfNeeded(2);
+    ASSERT_EQ(2U, stones.size());
+    ASSERT_EQ(RecordId(1, 2), stones[1].lastRecord);
+
+    oplogStones->popOldestStones(2);
+    ASSERT_EQ(2U, oplogStones->numStones());
+
+    stones = oplogStones->peekOldestStonesIfNeeded(10);
+    ASSERT_EQ(1U, stones.size());
+    ASSERT_EQ(RecordId(1, 3), stones[0].lastRecord);
+}
+
+// Verify that forward oplog cursors are told to ask for read-ahead again at the end of the stone
+// they are in, and not at all once they reach the stone still being filled.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReadAheadBoundary) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 50), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 50), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 100), RecordId(1, 3));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 4), 50), RecordId(1, 4));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+
+    ASSERT_EQ(RecordId(1, 2), oplogStones->requestReadAhead(RecordId(1, 1)));
+    ASSERT_EQ(RecordId(1, 2), oplogStones->requestReadAhead(RecordId(1, 2)));
+    ASSERT_EQ(RecordId(1, 3), oplogStones->requestReadAhead(RecordId(1, 3)));
+    ASSERT_EQ(RecordId::max(), oplogStones->requestReadAhead(RecordId(1, 4)));
+}
+
 // Verify that an oplog stone isn't created if it would cause the logical representation of the
 // records to not be in increasing order.
 TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
@@ -260,7 +260,9 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
             _isTimestamped = true;
         }
 
+        Timer commitTimer;
         wtRet = s->commit_transaction(s, nullptr);
+        _cacheWaitMicros.fetchAndAdd(commitTimer.micros());
         LOG(3) << "WT commit_transaction for snapshot id " << _mySnapshotId;
     } else {
         wtRet = s->rollback_transaction(s, nullptr);
@@ -298,6 +300,14 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
     _orderedCommit = true;  // Default value is true; we assume all writes are ordered.
 }
 
+void WiredTigerRecoveryUnit::appendOperationStatistics(BSONObjBuilder* builder) const {
+    const long long cacheWaitMicros = _cacheWaitMicros.load();
+    if (cacheWaitMicros > 0) {
+        BSONObjBuilder timeWaiting(builder->subobjStart("timeWaitingMicros"));
+        timeWaiting.append("cache", cacheWaitMicros);
+    }
+}
+
 SnapshotId WiredTigerRecoveryUnit::getSnapshotId() const {
     // TODO: use actual wiredtiger txn id
     return SnapshotId(_mySnapshotId);
@@ -342,6 +352,7 @@ void WiredTigerRecoveryUnit::_txnOpen() {
         _timer.reset(new Timer());
     }
     WT_SESSION* session = _session->getSession();
+    Timer beginTimer;
 
     switch (_timestampReadSource) {
         case ReadSource::kNone: {
@@ -397,6 +408,8 @@ void WiredTigerRecoveryUnit::_txnOpen() {
         }
     }
 
+    _cacheWaitMicros.fetchAndAdd(beginTimer.micros());
+
     LOG(3) << "WT begin_transaction for snapshot id " << _mySnapshotId;
     _active = true;
 }
@@ -43,6 +43,7 @@
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -77,6 +78,8 @@ public:
     void abandonSnapshot() override;
     void preallocateSnapshot() override;
 
+    void appendOperationStatistics(BSONObjBuilder* builder) const override;
+
     Status obtainMajorityCommittedSnapshot() override;
 
     boost::optional<Timestamp> getPointInTimeReadTimestamp() const override;
@@ -177,6 +180,10 @@ private:
     Timestamp _readAtTimestamp;
     std::unique_ptr<Timer> _timer;
     bool _isOplogReader = false;
+
+    // Time spent beginning and committing WT transactions, which is where WT makes application
+    // threads help with eviction when the cache is full. Read by $currentOp from other threads.
+    AtomicInt64 _cacheWaitMicros{0};
     typedef std::vector<std::unique_ptr<Change>> Changes;
     Changes _changes;
 };
@@ -78,9 +78,28 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    _engine->getSessionCache()->appendGroupCommitStats(&bob);
+    _engine->getOplogManager()->appendVisibilityLatencyStats(&bob);
+    _engine->appendCheckpointStats(&bob);
+
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
     return bob.obj();
 }
 
+WiredTigerConcurrentTransactionsServerStatusSection::
+    WiredTigerConcurrentTransactionsServerStatusSection()
+    : ServerStatusSection("wiredTigerConcurrentTransactions") {}
+
+bool WiredTigerConcurrentTransactionsServerStatusSection::includeByDefault() const {
+    return false;
+}
+
+BSONObj WiredTigerConcurrentTransactionsServerStatusSection::generateSection(
+    OperationContext* opCtx, const BSONElement& configElement) const {
+    BSONObjBuilder bob;
+    WiredTigerKVEngine::appendGlobalStats(bob);
+    return bob.obj().getObjectField("concurrentTransactions").getOwned();
+}
+
 }  // namespace mongo
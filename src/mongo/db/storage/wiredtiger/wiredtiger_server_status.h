@@ -50,4 +50,18 @@ private:
     WiredTigerKVEngine* _engine;
 };
 
+/**
+ * Adds "wiredTigerConcurrentTransactions" to the results of db.serverStatus() when requested. It
+ * reports the same ticket statistics as the "concurrentTransactions" field of the "wiredTiger"
+ * section, but without taking any locks or opening a WiredTiger session, so it is cheap enough to
+ * sample many times a second.
+ */
+class WiredTigerConcurrentTransactionsServerStatusSection : public ServerStatusSection {
+public:
+    WiredTigerConcurrentTransactionsServerStatusSection();
+    virtual bool includeByDefault() const;
+    virtual BSONObj generateSection(OperationContext* opCtx,
+                                    const BSONElement& configElement) const;
+};
+
 }  // namespace mongo
@@ -35,17 +35,23 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/chrono.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -81,6 +87,17 @@ ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
                                      "wiredTigerCursorCacheSize",
                                      &kWiredTigerCursorCacheSize);
 
+// The longest that a caller of waitUntilDurable waits for other callers to join its journal flush
+// before issuing it. The actual window adapts to the observed flush latency, and is only used
+// while flushes are being shared by more than one caller. Setting this to 0 disables batching
+// beyond the callers that queue up behind a flush already in progress.
+AtomicInt32 kWiredTigerGroupCommitMaxWindowMicros(1000);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerGroupCommitMaxWindowMicrosSetting(ServerParameterSet::getGlobal(),
+                                                "wiredTigerGroupCommitMaxWindowMicros",
+                                                &kWiredTigerGroupCommitMaxWindowMicros);
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, uint64_t epoch, uint64_t cursorEpoch)
     : _epoch(epoch), _cursorEpoch(cursorEpoch), _session(NULL), _cursorGen(0), _cursorsOut(0) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
@@ -184,11 +201,31 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
+namespace {
+
+// Upper bound on the number of session cache partitions, regardless of the number of cores.
+const size_t kMaxSessionCachePartitions = 64;
+
+size_t numSessionCachePartitions() {
+    const size_t cores = ProcessInfo::getNumAvailableCores();
+    return std::max<size_t>(1, std::min(cores, kMaxSessionCachePartitions));
+}
+
+// Threads are bound to partitions round-robin, in the order in which they first use a session
+// cache. The binding is shared by all session caches in the process.
+AtomicUInt32 nextSessionCachePartitionTicket;
+thread_local uint32_t sessionCachePartitionTicket = nextSessionCachePartitionTicket.fetchAndAdd(1);
+
+}  // namespace
+
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _shuttingDown(0),
+      _partitions(numSessionCachePartitions()) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _shuttingDown(0) {}
+    : _engine(NULL), _conn(conn), _shuttingDown(0), _partitions(numSessionCachePartitions()) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -206,11 +243,19 @@ void WiredTigerSessionCache::shuttingDown() {
             return;
     } while (actual != expected);
 
-    // Spin as long as there are threads in releaseSession
+    // Spin as long as there are threads in waitUntilDurable
     while (_shuttingDown.load() != kShuttingDownMask) {
         sleepmillis(1);
     }
 
+    // Spin as long as there are threads in releaseSession. A release that starts after this point
+    // observes the flag set above and leaks its session instead of caching it.
+    for (auto& partition : _partitions) {
+        while (partition.releasesInProgress.load() != 0) {
+            sleepmillis(1);
+        }
+    }
+
     closeAll();
 }
 
@@ -253,19 +298,60 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
     stdx::unique_lock<stdx::mutex> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
-        return;
+
+    // Register for the next flush to start. Any flush that starts after this point covers our
+    // writes, since they completed before we got here.
+    const uint64_t target = _flushesStarted + 1;
+    ++_waitersForNextFlush;
+
+    while (_flushInProgress) {
+        _flushCompletedCond.wait(lk);
+        if (_flushesCompleted >= target) {
+            // Someone else synced on our behalf, so we're done!
+            return;
+        }
     }
-    _lastSyncTime.store(current + 1);
 
-    // Nobody has synched yet, so we have to sync ourselves.
+    // Nobody is flushing, so we have to sync ourselves and everyone that joins before we start.
+    _flushInProgress = true;
+
+    // When recent flushes were shared, give other callers a chance to join this one. The window
+    // is a fraction of the typical flush so that batching never costs more than it saves.
+    const uint64_t window = _lastFlushWaiters > 1
+        ? std::min<uint64_t>(std::max(0, kWiredTigerGroupCommitMaxWindowMicros.load()),
+                             _avgFlushMicros / 2)
+        : 0;
+    _lastWindowMicros = window;
+    if (window > 0) {
+        const auto deadline =
+            stdx::chrono::steady_clock::now() + stdx::chrono::microseconds(window);
+        while (stdx::chrono::steady_clock::now() < deadline) {
+            _flushCompletedCond.wait_until(lk, deadline);
+        }
+    }
 
+    const uint64_t flushNumber = ++_flushesStarted;
+    invariant(flushNumber == target);
+    const uint64_t waiters = _waitersForNextFlush;
+    _waitersForNextFlush = 0;
+    lk.unlock();
+
+    Timer timer;
+    _flushForGroupCommit();
+    const uint64_t elapsedMicros = timer.micros();
+
+    lk.lock();
+    _flushesCompleted = flushNumber;
+    _flushInProgress = false;
+    _totalFlushWaiters += waiters;
+    _lastFlushWaiters = waiters;
+    _avgFlushMicros = _avgFlushMicros ? (_avgFlushMicros * 7 + elapsedMicros) / 8 : elapsedMicros;
+    lk.unlock();
+    _flushCompletedCond.notify_all();
+}
+
+void WiredTigerSessionCache::_flushForGroupCommit() {
     // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
     // checkpoint), and then reports that token (OpTime) as a durable write.
     stdx::unique_lock<stdx::mutex> jlk(_journalListenerMutex);
@@ -288,6 +374,17 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
     _journalListener->onDurable(token);
 }
 
+void WiredTigerSessionCache::appendGroupCommitStats(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> lk(_lastSyncMutex);
+    BSONObjBuilder bb(builder->subobjStart("groupCommit"));
+    bb.append("flushes", static_cast<long long>(_flushesCompleted));
+    bb.append("waiters", static_cast<long long>(_totalFlushWaiters));
+    bb.append("lastBatchSize", static_cast<long long>(_lastFlushWaiters));
+    bb.append("avgFlushMicros", static_cast<long long>(_avgFlushMicros));
+    bb.append("windowMicros", static_cast<long long>(_lastWindowMicros));
+    bb.done();
+}
+
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx) {
     invariant(opCtx);
     stdx::unique_lock<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
@@ -308,9 +405,12 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        for (SessionCache::iterator i = partition.sessions.begin(); i != partition.sessions.end();
+             i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -318,20 +418,26 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        for (SessionCache::iterator i = partition.sessions.begin(); i != partition.sessions.end();
+             i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. This happens before
+    // any partition is emptied, so a concurrent release either sees the new epoch and deletes its
+    // session, or caches it in a partition that has not been emptied yet.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    SessionCache swap;
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        swap.insert(swap.end(), partition.sessions.begin(), partition.sessions.end());
+        partition.sessions.clear();
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -348,13 +454,28 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
+    SessionCachePartition& ownPartition = _partitionForCurrentThread();
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+        stdx::lock_guard<stdx::mutex> lock(ownPartition.lock);
+        if (!ownPartition.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = ownPartition.sessions.back();
+            ownPartition.sessions.pop_back();
+            return UniqueWiredTigerSession(cachedSession);
+        }
+    }
+
+    // Our own partition is empty, so look for an idle session released by another thread before
+    // paying for a new one. Partitions that are busy are skipped rather than waited for.
+    for (auto& partition : _partitions) {
+        if (&partition == &ownPartition)
+            continue;
+
+        stdx::unique_lock<stdx::mutex> lock(partition.lock, stdx::try_to_lock);
+        if (lock && !partition.sessions.empty()) {
+            WiredTigerSession* cachedSession = partition.sessions.back();
+            partition.sessions.pop_back();
             return UniqueWiredTigerSession(cachedSession);
         }
     }
@@ -368,10 +489,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     invariant(session);
     invariant(session->cursorsOut() == 0);
 
-    const int shuttingDown = _shuttingDown.fetchAndAdd(1);
-    ON_BLOCK_EXIT([this] { _shuttingDown.fetchAndSubtract(1); });
+    SessionCachePartition& partition = _partitionForCurrentThread();
+    partition.releasesInProgress.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&partition] { partition.releasesInProgress.fetchAndSubtract(1); });
 
-    if (shuttingDown & kShuttingDownMask) {
+    if (_shuttingDown.load() & kShuttingDownMask) {
         // There is a race condition with clean shutdown, where the storage engine is ripped from
         // underneath OperationContexts, which are not "active" (i.e., do not have any locks), but
         // are just about to delete the recovery unit. See SERVER-16031 for more information. Since
@@ -413,10 +535,10 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->dropQueuedIdentsAtSessionEndAllowed(true);
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -428,6 +550,10 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         _engine->dropSomeQueuedIdents();
 }
 
+WiredTigerSessionCache::SessionCachePartition&
+WiredTigerSessionCache::_partitionForCurrentThread() {
+    return _partitions[sessionCachePartitionTicket % _partitions.size()];
+}
 
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
@@ -33,17 +33,23 @@
 
 #include <list>
 #include <string>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
 
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -152,6 +158,11 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  The pool is split into cache-line aligned partitions, one per available core. Each thread is
+ *  bound to a partition, so that getting and releasing a session normally only touches an
+ *  uncontended mutex and counter. A thread whose partition is empty takes an idle session from
+ *  another partition before creating a new one.
  */
 class WiredTigerSessionCache {
 public:
@@ -208,9 +219,20 @@ public:
      * Waits until all commits that happened before this call are durable, either by flushing
      * the log or forcing a checkpoint if forceCheckpoint is true or the journal is disabled.
      * Uses a temporary session. Safe to call without any locks, even during shutdown.
+     *
+     * Concurrent callers that do not force a checkpoint are group committed: the first caller
+     * performs the flush on behalf of every caller that arrives before it starts, and callers that
+     * arrive while a flush is in progress are covered together by the next one. When recent
+     * flushes covered more than one caller, the flushing caller first waits for a short window,
+     * bounded by "wiredTigerGroupCommitMaxWindowMicros", to let more callers join.
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
+    /**
+     * Appends the group commit statistics of waitUntilDurable to 'builder'.
+     */
+    void appendGroupCommitStats(BSONObjBuilder* builder);
+
     /**
      * Waits until a prepared unit of work has ended (either been commited or aborted). This
      * should be used when encountering WT_PREPARE_CONFLICT errors. The caller is required to retry
@@ -258,14 +280,26 @@ private:
     WiredTigerSnapshotManager _snapshotManager;
 
     // Used as follows:
-    //   The low 31 bits are a count of active calls to releaseSession.
+    //   The low 31 bits are a count of active calls to waitUntilDurable.
     //   The high bit is a flag that is set if and only if we're shutting down.
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    struct SessionCachePartition {
+        stdx::mutex lock;
+        SessionCache sessions;  // guarded by 'lock'
+
+        // Count of active calls to releaseSession on this partition. Kept per partition so that
+        // releasing a session does not write to a cache line shared by every thread.
+        AtomicUInt32 releasesInProgress;
+    };
+
+    // The number of partitions is fixed at construction.
+    std::vector<CacheAligned<SessionCachePartition>,
+                boost::alignment::aligned_allocator<CacheAligned<SessionCachePartition>>>
+        _partitions;
 
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
@@ -273,9 +307,22 @@ private:
     // Bumped when all open cursors need to be closed
     AtomicUInt64 _cursorEpoch;  // atomic so we can check it outside of the lock
 
-    // Counter and critical section mutex for waitUntilDurable
-    AtomicUInt32 _lastSyncTime;
+    // Group commit state for waitUntilDurable. A flush covers every caller that registered before
+    // it started. Everything below is guarded by _lastSyncMutex.
     stdx::mutex _lastSyncMutex;
+    stdx::condition_variable _flushCompletedCond;
+    std::uint64_t _flushesStarted = 0;
+    std::uint64_t _flushesCompleted = 0;
+    // Also set while the flushing caller waits for more callers to join its batch.
+    bool _flushInProgress = false;
+    // The number of callers that the next flush to start will cover.
+    std::uint64_t _waitersForNextFlush = 0;
+
+    // Group commit statistics, also guarded by _lastSyncMutex.
+    std::uint64_t _totalFlushWaiters = 0;
+    std::uint64_t _lastFlushWaiters = 0;
+    std::uint64_t _avgFlushMicros = 0;  // exponentially weighted
+    std::uint64_t _lastWindowMicros = 0;
 
     // Mutex and cond var for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
@@ -290,6 +337,18 @@ private:
     WT_SESSION* _waitUntilDurableSession = nullptr;  // owned, and never explicitly closed
                                                      // (uses connection close to clean up)
 
+    /**
+     * Flushes the journal, or takes a checkpoint if the journal is disabled, and reports the last
+     * write before the flush as durable. Must only be called by the caller performing a group
+     * commit.
+     */
+    void _flushForGroupCommit();
+
+    /**
+     * Returns the partition that the calling thread gets and releases its sessions through.
+     */
+    SessionCachePartition& _partitionForCurrentThread();
+
     /**
      * Returns a session to the cache for later reuse. If closeAll was called between getting this
      * session and releasing it, the session is directly released. This method is thread safe.
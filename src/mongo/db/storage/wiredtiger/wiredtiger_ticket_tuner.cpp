@@ -0,0 +1,287 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+
+#include <algorithm>
+#include <limits>
+#include <wiredtiger.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactions, bool, false);
+
+// TicketHolder::resize() does not accept fewer than 5 tickets.
+const int kMinResizableTickets = 5;
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactionsMin, int, 16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < kMinResizableTickets) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerAdaptiveConcurrentTransactionsMin must be greater than or "
+                          "equal to 5");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactionsMax, int, 512)
+    ->withValidator([](const int& newVal) {
+        if (newVal < kMinResizableTickets) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerAdaptiveConcurrentTransactionsMax must be greater than or "
+                          "equal to 5");
+        }
+        return Status::OK();
+    });
+
+// How often the ticket counts are reconsidered.
+const Seconds kTuneInterval(1);
+
+// Tickets added per interval while operations queue and throughput keeps up.
+const int kAdditiveIncrease = 8;
+
+// Factor the ticket counts are cut by under cache pressure.
+const double kMultiplicativeDecrease = 0.75;
+
+// WiredTiger starts making application threads evict at 95% cache fill by default, so staying just
+// below that keeps user operations out of eviction.
+const double kCachePressureFillRatio = 0.94;
+
+// Application threads spending more than 5% of a second per second in eviction means operations
+// are being stalled by it.
+const double kEvictionStallMicrosPerSec = 50 * 1000;
+
+// An increase is undone if the throughput after it fell by more than this ratio.
+const double kThroughputDropRatio = 0.95;
+
+/**
+ * Positions 'cursor', a statistics cursor, on 'key' and returns its value, or 0 if the key is not
+ * present.
+ */
+long long readStat(WT_CURSOR* cursor, int key) {
+    cursor->set_key(cursor, key);
+    if (cursor->search(cursor) != 0) {
+        return 0;
+    }
+    uint64_t value;
+    if (cursor->get_value(cursor, NULL, NULL, &value) != 0) {
+        return 0;
+    }
+    return static_cast<long long>(std::min<uint64_t>(value, std::numeric_limits<long long>::max()));
+}
+
+double ratePerSec(long long current, long long previous, long long elapsedMillis) {
+    if (previous < 0 || elapsedMillis <= 0 || current < previous) {
+        return 0;
+    }
+    return static_cast<double>(current - previous) * 1000 / elapsedMillis;
+}
+
+}  // namespace
+
+int WiredTigerTicketTuner::computeTarget(int current,
+                                         int minTickets,
+                                         int maxTickets,
+                                         const Signals& signals,
+                                         State* state,
+                                         Adjustment* adjustment) {
+    const bool wasIncrease = state->lastWasIncrease;
+    state->lastWasIncrease = false;
+
+    int target = current;
+    if (signals.cacheFillRatio >= kCachePressureFillRatio ||
+        signals.appEvictionMicrosPerSec >= kEvictionStallMicrosPerSec) {
+        target = static_cast<int>(current * kMultiplicativeDecrease);
+    } else if (wasIncrease && signals.transactionsPerSec <
+                   state->transactionsPerSecBeforeIncrease * kThroughputDropRatio) {
+        target = current - kAdditiveIncrease;
+    } else if (signals.ticketsExhausted) {
+        target = current + kAdditiveIncrease;
+        state->lastWasIncrease = true;
+        state->transactionsPerSecBeforeIncrease = signals.transactionsPerSec;
+    }
+
+    target = std::max(minTickets, std::min(maxTickets, target));
+    if (target > current) {
+        *adjustment = Adjustment::kIncrease;
+    } else if (target < current) {
+        *adjustment = Adjustment::kDecrease;
+    } else {
+        *adjustment = Adjustment::kNone;
+        state->lastWasIncrease = false;
+    }
+    return target;
+}
+
+WiredTigerTicketTuner::WiredTigerTicketTuner(WiredTigerSessionCache* sessionCache,
+                                             TicketHolder* readTickets,
+                                             TicketHolder* writeTickets)
+    : BackgroundJob(false /* deleteSelf */),
+      _sessionCache(sessionCache),
+      _readTickets(readTickets),
+      _writeTickets(writeTickets) {}
+
+void WiredTigerTicketTuner::run() {
+    Client::initThread(name().c_str());
+
+    LOG(1) << "starting " << name() << " thread";
+
+    Date_t lastTune = Date_t::now();
+    while (!_shuttingDown.load()) {
+        {
+            stdx::unique_lock<stdx::mutex> lk(_shutdownMutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            _shutdownCondVar.wait_for(lk, kTuneInterval.toSystemDuration(), [&] {
+                return _shuttingDown.load();
+            });
+        }
+        if (_shuttingDown.load()) {
+            break;
+        }
+
+        const Date_t now = Date_t::now();
+        const long long elapsedMillis = durationCount<Milliseconds>(now - lastTune);
+        lastTune = now;
+
+        if (!wiredTigerAdaptiveConcurrentTransactions.load()) {
+            // Start over from fresh counters once re-enabled, rather than from stale ones.
+            _readState = State();
+            _writeState = State();
+            _lastTransactions = -1;
+            _lastAppEvictionMicros = -1;
+            continue;
+        }
+
+        try {
+            _tune(elapsedMillis);
+        } catch (const AssertionException& exc) {
+            invariant(ErrorCodes::isShutdownError(exc.code()), exc.what());
+        }
+    }
+    LOG(1) << "stopping " << name() << " thread";
+}
+
+void WiredTigerTicketTuner::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_shutdownMutex);
+        _shuttingDown.store(true);
+    }
+    _shutdownCondVar.notify_one();
+    wait();
+}
+
+void WiredTigerTicketTuner::appendStats(BSONObjBuilder* builder) const {
+    builder->append("enabled", wiredTigerAdaptiveConcurrentTransactions.load());
+    builder->append("increases", _numIncreases.load());
+    builder->append("decreases", _numDecreases.load());
+}
+
+void WiredTigerTicketTuner::_tune(long long elapsedMillis) {
+    long long transactions;
+    long long appEvictionMicros;
+    long long cacheBytesInUse;
+    long long cacheBytesMax;
+    {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+
+        WT_CURSOR* cursor = NULL;
+        invariantWTOK(s->open_cursor(s, "statistics:", NULL, "statistics=(fast)", &cursor));
+        ON_BLOCK_EXIT(cursor->close, cursor);
+
+        transactions = readStat(cursor, WT_STAT_CONN_TXN_BEGIN);
+        appEvictionMicros = readStat(cursor, WT_STAT_CONN_APPLICATION_EVICT_TIME);
+        cacheBytesInUse = readStat(cursor, WT_STAT_CONN_CACHE_BYTES_INUSE);
+        cacheBytesMax = readStat(cursor, WT_STAT_CONN_CACHE_BYTES_MAX);
+    }
+
+    Signals signals;
+    signals.transactionsPerSec = ratePerSec(transactions, _lastTransactions, elapsedMillis);
+    signals.appEvictionMicrosPerSec =
+        ratePerSec(appEvictionMicros, _lastAppEvictionMicros, elapsedMillis);
+    signals.cacheFillRatio =
+        cacheBytesMax > 0 ? static_cast<double>(cacheBytesInUse) / cacheBytesMax : 0;
+
+    // The first interval only establishes the baseline for the rates.
+    const bool haveBaseline = _lastTransactions >= 0;
+    _lastTransactions = transactions;
+    _lastAppEvictionMicros = appEvictionMicros;
+    if (!haveBaseline) {
+        _readState.lastNumWaits = _readTickets->numWaits();
+        _writeState.lastNumWaits = _writeTickets->numWaits();
+        return;
+    }
+
+    _tuneOne(_readTickets, signals, &_readState);
+    _tuneOne(_writeTickets, signals, &_writeState);
+}
+
+void WiredTigerTicketTuner::_tuneOne(TicketHolder* holder, Signals signals, State* state) {
+    const long long numWaits = holder->numWaits();
+    signals.ticketsExhausted = numWaits > state->lastNumWaits;
+    state->lastNumWaits = numWaits;
+
+    const int minTickets = wiredTigerAdaptiveConcurrentTransactionsMin.load();
+    const int maxTickets = std::max(minTickets, wiredTigerAdaptiveConcurrentTransactionsMax.load());
+    const int current = holder->outof();
+
+    Adjustment adjustment;
+    const int target = computeTarget(current, minTickets, maxTickets, signals, state, &adjustment);
+    if (adjustment == Adjustment::kNone) {
+        return;
+    }
+
+    LOG(2) << name() << " resizing ticket pool from " << current << " to " << target
+           << "; transactions/s: " << signals.transactionsPerSec
+           << ", cache fill: " << signals.cacheFillRatio
+           << ", application eviction us/s: " << signals.appEvictionMicrosPerSec;
+
+    // Shrinking takes tickets out of circulation, and so waits for enough of them to be released.
+    uassertStatusOK(holder->resize(target));
+    (adjustment == Adjustment::kIncrease ? _numIncreases : _numDecreases).fetchAndAdd(1);
+
+    // Resizing down waits for tickets like any other acquisition, which must not look like demand.
+    state->lastNumWaits = holder->numWaits();
+}
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/background.h"
+
+namespace mongo {
+
+class TicketHolder;
+class WiredTigerSessionCache;
+
+/**
+ * Periodically resizes the read and write TicketHolders that bound the number of concurrent
+ * WiredTiger transactions, based on what the storage engine is observed to sustain:
+ *
+ *  - when the cache is nearly full, or application threads spend noticeable time doing eviction,
+ *    the ticket counts are cut multiplicatively;
+ *  - otherwise, when operations had to queue for tickets, the count for that kind of operation is
+ *    grown additively, unless the previous increase was followed by a drop in transaction
+ *    throughput, in which case it is undone.
+ *
+ * The tuner is off unless the "wiredTigerAdaptiveConcurrentTransactions" parameter is true, and
+ * then keeps the counts within "wiredTigerAdaptiveConcurrentTransactionsMin/Max". Explicitly set
+ * "wiredTigerConcurrentRead/WriteTransactions" values are only used as starting points.
+ */
+class WiredTigerTicketTuner : public BackgroundJob {
+    MONGO_DISALLOW_COPYING(WiredTigerTicketTuner);
+
+public:
+    /**
+     * What happened during the last interval, as seen by the tuner.
+     */
+    struct Signals {
+        // Transactions started per second, reads and writes together.
+        double transactionsPerSec = 0;
+
+        // Bytes in the cache over the configured cache size.
+        double cacheFillRatio = 0;
+
+        // Microseconds per second that application threads spent doing eviction.
+        double appEvictionMicrosPerSec = 0;
+
+        // Whether any operation had to wait for a ticket of the kind being tuned.
+        bool ticketsExhausted = false;
+    };
+
+    /**
+     * Per-TicketHolder state carried from one adjustment to the next.
+     */
+    struct State {
+        bool lastWasIncrease = false;
+        double transactionsPerSecBeforeIncrease = 0;
+        long long lastNumWaits = 0;
+    };
+
+    enum class Adjustment { kNone, kIncrease, kDecrease };
+
+    /**
+     * Returns the ticket count to use after an interval with 'signals', given 'current' tickets,
+     * and updates 'state'. Never returns a value outside of [minTickets, maxTickets].
+     */
+    static int computeTarget(int current,
+                             int minTickets,
+                             int maxTickets,
+                             const Signals& signals,
+                             State* state,
+                             Adjustment* adjustment);
+
+    WiredTigerTicketTuner(WiredTigerSessionCache* sessionCache,
+                          TicketHolder* readTickets,
+                          TicketHolder* writeTickets);
+
+    std::string name() const override {
+        return "WTTicketTuner";
+    }
+
+    void run() override;
+
+    void shutdown();
+
+    /**
+     * Appends whether the tuner is enabled and how often it resized the ticket pools.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    /**
+     * Reads the storage engine signals and resizes both TicketHolders as needed.
+     */
+    void _tune(long long elapsedMillis);
+
+    void _tuneOne(TicketHolder* holder, Signals signals, State* state);
+
+    WiredTigerSessionCache* const _sessionCache;
+    TicketHolder* const _readTickets;
+    TicketHolder* const _writeTickets;
+
+    AtomicBool _shuttingDown{false};
+    stdx::mutex _shutdownMutex;
+    stdx::condition_variable _shutdownCondVar;
+
+    // Only used by the tuner thread.
+    State _readState;
+    State _writeState;
+    long long _lastTransactions = -1;
+    long long _lastAppEvictionMicros = -1;
+
+    AtomicInt64 _numIncreases;
+    AtomicInt64 _numDecreases;
+};
+
+}  // namespace mongo
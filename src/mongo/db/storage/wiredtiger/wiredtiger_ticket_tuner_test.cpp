@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Adjustment = WiredTigerTicketTuner::Adjustment;
+using Signals = WiredTigerTicketTuner::Signals;
+using State = WiredTigerTicketTuner::State;
+
+TEST(WiredTigerTicketTunerTest, NoChangeWithoutQueueing) {
+    Signals signals;
+    signals.transactionsPerSec = 1000;
+    signals.cacheFillRatio = 0.5;
+    State state;
+    Adjustment adjustment;
+    ASSERT_EQ(WiredTigerTicketTuner::computeTarget(128, 16, 512, signals, &state, &adjustment),
+              128);
+    ASSERT(adjustment == Adjustment::kNone);
+}
+
+TEST(WiredTigerTicketTunerTest, IncreasesAdditivelyWhenQueueing) {
+    Signals signals;
+    signals.transactionsPerSec = 1000;
+    signals.ticketsExhausted = true;
+    State state;
+    Adjustment adjustment;
+    ASSERT_EQ(WiredTigerTicketTuner::computeTarget(128, 16, 512, signals, &state, &adjustment),
+              136);
+    ASSERT(adjustment == Adjustment::kIncrease);
+    ASSERT(state.lastWasIncrease);
+}
+
+TEST(WiredTigerTicketTunerTest, UndoesIncreaseThatLowersThroughput) {
+    Signals signals;
+    signals.transactionsPerSec = 1000;
+    signals.ticketsExhausted = true;
+    State state;
+    Adjustment adjustment;
+    int tickets = WiredTigerTicketTuner::computeTarget(128, 16, 512, signals, &state, &adjustment);
+
+    signals.transactionsPerSec = 800;
+    ASSERT_EQ(WiredTigerTicketTuner::computeTarget(tickets, 16, 512, signals, &state, &adjustment),
+              128);
+    ASSERT(adjustment == Adjustment::kDecrease);
+    ASSERT_FALSE(state.lastWasIncrease);
+}
+
+TEST(WiredTigerTicketTunerTest, DecreasesMultiplicativelyUnderCachePressure) {
+    Signals signals;
+    signals.ticketsExhausted = true;
+    signals.cacheFillRatio = 0.97;
+    State state;
+    Adjustment adjustment;
+    ASSERT_EQ(WiredTigerTicketTuner::computeTarget(128, 16, 512, signals, &state, &adjustment),
+              96);
+    ASSERT(adjustment == Adjustment::kDecrease);
+
+    signals.cacheFillRatio = 0.5;
+    signals.appEvictionMicrosPerSec = 200 * 1000;
+    ASSERT_EQ(WiredTigerTicketTuner::computeTarget(96, 16, 512, signals, &state, &adjustment), 72);
+    ASSERT(adjustment == Adjustment::kDecrease);
+}
+
+TEST(WiredTigerTicketTunerTest, StaysWithinBounds) {
+    Signals signals;
+    signals.ticketsExhausted = true;
+    State state;
+    Adjustment adjustment;
+    ASSERT_EQ(WiredTigerTicketTuner::computeTarget(510, 16, 512, signals, &state, &adjustment),
+              512);
+    ASSERT_EQ(WiredTigerTicketTuner::computeTarget(512, 16, 512, signals, &state, &adjustment),
+              512);
+    ASSERT(adjustment == Adjustment::kNone);
+
+    signals.cacheFillRatio = 1.0;
+    ASSERT_EQ(WiredTigerTicketTuner::computeTarget(18, 16, 512, signals, &state, &adjustment), 16);
+    ASSERT(adjustment == Adjustment::kDecrease);
+}
+
+}  // namespace
+}  // namespace mongo
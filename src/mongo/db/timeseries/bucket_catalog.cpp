@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+constexpr int BucketCatalog::kMaxMeasurementsPerBucket;
+constexpr Seconds BucketCatalog::kBucketWindow;
+constexpr size_t BucketCatalog::kMaxOpenBuckets;
+
+namespace {
+
+const auto getBucketCatalog = ServiceContext::declareDecoration<BucketCatalog>();
+
+std::string makeKeyPrefix(const NamespaceString& bucketsNss) {
+    std::string prefix = bucketsNss.ns();
+    prefix.push_back('\0');
+    return prefix;
+}
+
+Date_t getWindowStart(Date_t time) {
+    const long long windowMillis = durationCount<Milliseconds>(BucketCatalog::kBucketWindow);
+    long long millis = time.toMillisSinceEpoch();
+    millis -= millis % windowMillis;
+    if (time.toMillisSinceEpoch() < 0 && millis != time.toMillisSinceEpoch()) {
+        millis -= windowMillis;
+    }
+    return Date_t::fromMillisSinceEpoch(millis);
+}
+
+}  // namespace
+
+BucketCatalog& BucketCatalog::get(ServiceContext* svcCtx) {
+    return getBucketCatalog(svcCtx);
+}
+
+BucketCatalog& BucketCatalog::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+BucketCatalog::Placement BucketCatalog::insert(const NamespaceString& bucketsNss,
+                                               const BSONObj& meta,
+                                               Date_t time) {
+    std::string key = makeKeyPrefix(bucketsNss);
+    key.append(meta.objdata(), meta.objsize());
+    const Date_t windowStart = getWindowStart(time);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _openBuckets.find(key);
+    if (it == _openBuckets.end()) {
+        if (_openBuckets.size() >= kMaxOpenBuckets) {
+            _openBuckets.clear();
+        }
+        it = _openBuckets.emplace(std::move(key), Bucket()).first;
+    }
+
+    Bucket& bucket = it->second;
+    if (!bucket.id.isSet() || bucket.numMeasurements >= kMaxMeasurementsPerBucket ||
+        bucket.windowStart != windowStart) {
+        // Bucket _ids start with the beginning of their window, so they sort roughly by time.
+        const auto windowStartSecs = durationCount<Seconds>(windowStart.toDurationSinceEpoch());
+        bucket.id = OID::gen();
+        bucket.id.setTimestamp(static_cast<OID::Timestamp>(windowStartSecs));
+        bucket.windowStart = windowStart;
+        bucket.numMeasurements = 0;
+    }
+    return {bucket.id, bucket.numMeasurements++};
+}
+
+void BucketCatalog::clear(const NamespaceString& bucketsNss) {
+    const std::string prefix = makeKeyPrefix(bucketsNss);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto it = _openBuckets.begin(); it != _openBuckets.end();) {
+        if (StringData(it->first).startsWith(prefix)) {
+            it = _openBuckets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace mongo
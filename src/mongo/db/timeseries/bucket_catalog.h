@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/oid.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Tracks the open bucket of each series of each time-series collection, meaning the bucket new
+ * measurements of the series are added to, and hands out the index of each new measurement within
+ * its bucket.
+ *
+ * The catalog lives in memory only. After a restart or failover, each series simply starts a new
+ * bucket with its next measurement.
+ */
+class BucketCatalog {
+    MONGO_DISALLOW_COPYING(BucketCatalog);
+
+public:
+    // A bucket holds at most this many measurements, all of them taken within one window of time
+    // of this length. Windows are aligned to multiples of their length since the epoch.
+    static constexpr int kMaxMeasurementsPerBucket = 1000;
+    static constexpr Seconds kBucketWindow{3600};
+
+    // The catalog forgets every open bucket when it reaches this many, to bound its memory use.
+    static constexpr size_t kMaxOpenBuckets = 100000;
+
+    struct Placement {
+        // The _id of the bucket the measurement belongs to.
+        OID bucketId;
+
+        // The index of the measurement within the bucket, starting at 0 for a new bucket.
+        int index;
+    };
+
+    static BucketCatalog& get(ServiceContext* svcCtx);
+    static BucketCatalog& get(OperationContext* opCtx);
+
+    BucketCatalog() = default;
+
+    /**
+     * Places a measurement of the series 'meta', taken at 'time', into the open bucket of that
+     * series in the time-series collection whose buckets are stored in 'bucketsNss'. A new bucket
+     * is opened if the series has none yet, or if its open bucket is full or covers another window
+     * of time. 'meta' holds the value of the meta field as its only element, or is empty.
+     */
+    Placement insert(const NamespaceString& bucketsNss, const BSONObj& meta, Date_t time);
+
+    /**
+     * Forgets the open buckets of the time-series collection whose buckets are stored in
+     * 'bucketsNss'.
+     */
+    void clear(const NamespaceString& bucketsNss);
+
+private:
+    struct Bucket {
+        OID id;
+        Date_t windowStart;
+        int numMeasurements = 0;
+    };
+
+    stdx::mutex _mutex;
+
+    // The open buckets, keyed by the namespace of the buckets collection followed by the binary
+    // representation of the series' meta value.
+    stdx::unordered_map<std::string, Bucket> _openBuckets;
+};
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kBucketsNss("test.system.buckets.coll");
+const Date_t kWindowStart = Date_t::fromMillisSinceEpoch(1000LL * 3600 * 24 * 365 * 50);
+
+TEST(BucketCatalogTest, MeasurementsOfOneSeriesShareABucket) {
+    BucketCatalog catalog;
+    auto first = catalog.insert(kBucketsNss, BSON("meta" << 1), kWindowStart);
+    auto second = catalog.insert(kBucketsNss, BSON("meta" << 1), kWindowStart + Seconds(1));
+    ASSERT_EQ(first.bucketId, second.bucketId);
+    ASSERT_EQ(0, first.index);
+    ASSERT_EQ(1, second.index);
+    ASSERT_EQ(kWindowStart, first.bucketId.asDateT());
+}
+
+TEST(BucketCatalogTest, EachSeriesHasItsOwnBucket) {
+    BucketCatalog catalog;
+    auto a = catalog.insert(kBucketsNss, BSON("meta" << 1), kWindowStart);
+    auto b = catalog.insert(kBucketsNss, BSON("meta" << 2), kWindowStart);
+    auto noMeta = catalog.insert(kBucketsNss, BSONObj(), kWindowStart);
+    auto otherColl = catalog.insert(
+        NamespaceString("test.system.buckets.other"), BSON("meta" << 1), kWindowStart);
+    ASSERT_NE(a.bucketId, b.bucketId);
+    ASSERT_NE(a.bucketId, noMeta.bucketId);
+    ASSERT_NE(a.bucketId, otherColl.bucketId);
+    ASSERT_EQ(0, b.index);
+    ASSERT_EQ(0, noMeta.index);
+    ASSERT_EQ(0, otherColl.index);
+}
+
+TEST(BucketCatalogTest, FullBucketIsReplaced) {
+    BucketCatalog catalog;
+    auto first = catalog.insert(kBucketsNss, BSONObj(), kWindowStart);
+    for (int i = 1; i < BucketCatalog::kMaxMeasurementsPerBucket; ++i) {
+        ASSERT_EQ(first.bucketId, catalog.insert(kBucketsNss, BSONObj(), kWindowStart).bucketId);
+    }
+    auto next = catalog.insert(kBucketsNss, BSONObj(), kWindowStart);
+    ASSERT_NE(first.bucketId, next.bucketId);
+    ASSERT_EQ(0, next.index);
+}
+
+TEST(BucketCatalogTest, NewWindowStartsANewBucket) {
+    BucketCatalog catalog;
+    auto first = catalog.insert(kBucketsNss, BSONObj(), kWindowStart + Seconds(10));
+    auto next = catalog.insert(kBucketsNss, BSONObj(), kWindowStart + BucketCatalog::kBucketWindow);
+    ASSERT_NE(first.bucketId, next.bucketId);
+    ASSERT_EQ(kWindowStart + BucketCatalog::kBucketWindow, next.bucketId.asDateT());
+
+    // Measurements from before the epoch belong to the window that contains them.
+    auto early = catalog.insert(kBucketsNss, BSONObj(), Date_t::fromMillisSinceEpoch(-1));
+    ASSERT_NE(next.bucketId, early.bucketId);
+    ASSERT_EQ(0, early.index);
+}
+
+TEST(BucketCatalogTest, ClearForgetsOnlyThatCollection) {
+    BucketCatalog catalog;
+    const NamespaceString otherNss("test.system.buckets.other");
+    auto a = catalog.insert(kBucketsNss, BSONObj(), kWindowStart);
+    auto b = catalog.insert(otherNss, BSONObj(), kWindowStart);
+
+    catalog.clear(kBucketsNss);
+    ASSERT_NE(a.bucketId, catalog.insert(kBucketsNss, BSONObj(), kWindowStart).bucketId);
+    ASSERT_EQ(b.bucketId, catalog.insert(otherNss, BSONObj(), kWindowStart).bucketId);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/timeseries_options.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace timeseries {
+
+constexpr StringData TimeseriesOptions::kTimeFieldName;
+constexpr StringData TimeseriesOptions::kMetaFieldName;
+
+namespace {
+
+Status validateFieldName(const BSONElement& elem) {
+    if (elem.type() != BSONType::String) {
+        return {ErrorCodes::TypeMismatch,
+                str::stream() << "'" << elem.fieldNameStringData() << "' must be a string"};
+    }
+    auto name = elem.valueStringData();
+    if (name.empty() || name[0] == '$' || name.find('.') != std::string::npos) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'" << elem.fieldNameStringData()
+                              << "' must name a top-level field, not '"
+                              << name
+                              << "'"};
+    }
+    return Status::OK();
+}
+
+}  // namespace
+
+StatusWith<TimeseriesOptions> TimeseriesOptions::parse(const BSONObj& obj) {
+    TimeseriesOptions options;
+    bool hasTimeField = false;
+    for (auto&& elem : obj) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kTimeFieldName) {
+            auto status = validateFieldName(elem);
+            if (!status.isOK()) {
+                return status;
+            }
+            options.timeField = elem.str();
+            hasTimeField = true;
+        } else if (fieldName == kMetaFieldName) {
+            auto status = validateFieldName(elem);
+            if (!status.isOK()) {
+                return status;
+            }
+            options.metaField = elem.str();
+        } else {
+            return {ErrorCodes::InvalidOptions,
+                    str::stream() << "unrecognized time-series option '" << fieldName << "'"};
+        }
+    }
+
+    if (!hasTimeField) {
+        return {ErrorCodes::InvalidOptions, "time-series options must include a 'timeField'"};
+    }
+    if (options.metaField && *options.metaField == options.timeField) {
+        return {ErrorCodes::InvalidOptions,
+                "the 'timeField' and 'metaField' of a time-series collection must differ"};
+    }
+    return options;
+}
+
+BSONObj TimeseriesOptions::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append(kTimeFieldName, timeField);
+    if (metaField) {
+        builder.append(kMetaFieldName, *metaField);
+    }
+    return builder.obj();
+}
+
+}  // namespace timeseries
+}  // namespace mongo
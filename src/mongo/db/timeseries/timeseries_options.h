@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+namespace timeseries {
+
+/**
+ * A time-series collection stores its measurements in the collection named by
+ * NamespaceString::makeTimeseriesBucketsNamespace(), grouped into bucket documents of the form
+ *
+ *   {_id: <ObjectId>,
+ *    control: {version: 1, min: {<field>: <min>, ...}, max: {<field>: <max>, ...}},
+ *    meta: <value of the meta field>,
+ *    data: {<field>: {'0': <value>, '1': <value>, ...}, ...}}
+ *
+ * Each bucket holds the measurements of one series, meaning one value of the meta field, over a
+ * bounded window of time. Every field of the measurements is stored as a column in 'data', keyed by
+ * the index of the measurement within the bucket, and summarized by its minimum and maximum.
+ */
+constexpr StringData kBucketControlFieldName = "control"_sd;
+constexpr StringData kBucketControlVersionFieldName = "version"_sd;
+constexpr StringData kBucketControlMinFieldName = "min"_sd;
+constexpr StringData kBucketControlMaxFieldName = "max"_sd;
+constexpr StringData kBucketMetaFieldName = "meta"_sd;
+constexpr StringData kBucketDataFieldName = "data"_sd;
+
+constexpr int kBucketControlVersion = 1;
+
+/**
+ * The 'timeseries' option of the create command, which makes the new collection a time-series
+ * collection.
+ */
+struct TimeseriesOptions {
+    static constexpr StringData kTimeFieldName = "timeField"_sd;
+    static constexpr StringData kMetaFieldName = "metaField"_sd;
+
+    /**
+     * Parses {timeField: <string>, metaField: <string>}, where 'metaField' is optional.
+     */
+    static StatusWith<TimeseriesOptions> parse(const BSONObj& obj);
+
+    BSONObj toBSON() const;
+
+    // The field of each measurement holding its time, which must be a date.
+    std::string timeField;
+
+    // The field of each measurement identifying the series it belongs to, if any.
+    boost::optional<std::string> metaField;
+};
+
+}  // namespace timeseries
+}  // namespace mongo
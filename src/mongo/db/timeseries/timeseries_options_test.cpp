@@ -0,0 +1,73 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/timeseries/timeseries_options.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace timeseries {
+namespace {
+
+TEST(TimeseriesOptionsTest, ParsesTimeAndMetaFields) {
+    auto swOptions = TimeseriesOptions::parse(BSON("timeField" << "t" << "metaField" << "m"));
+    ASSERT_OK(swOptions.getStatus());
+    ASSERT_EQ("t", swOptions.getValue().timeField);
+    ASSERT_EQ("m", *swOptions.getValue().metaField);
+    ASSERT_BSONOBJ_EQ(BSON("timeField" << "t" << "metaField" << "m"),
+                      swOptions.getValue().toBSON());
+
+    swOptions = TimeseriesOptions::parse(BSON("timeField" << "t"));
+    ASSERT_OK(swOptions.getStatus());
+    ASSERT_FALSE(swOptions.getValue().metaField);
+    ASSERT_BSONOBJ_EQ(BSON("timeField" << "t"), swOptions.getValue().toBSON());
+}
+
+TEST(TimeseriesOptionsTest, RejectsInvalidOptions) {
+    ASSERT_EQ(ErrorCodes::InvalidOptions, TimeseriesOptions::parse(BSONObj()).getStatus());
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              TimeseriesOptions::parse(BSON("metaField" << "m")).getStatus());
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              TimeseriesOptions::parse(BSON("timeField" << "t" << "other" << 1)).getStatus());
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              TimeseriesOptions::parse(BSON("timeField" << "t" << "metaField" << "t")).getStatus());
+    ASSERT_EQ(ErrorCodes::TypeMismatch,
+              TimeseriesOptions::parse(BSON("timeField" << 1)).getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue, TimeseriesOptions::parse(BSON("timeField" << "")).getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue,
+              TimeseriesOptions::parse(BSON("timeField" << "$t")).getStatus());
+    ASSERT_EQ(
+        ErrorCodes::BadValue,
+        TimeseriesOptions::parse(BSON("timeField" << "t" << "metaField" << "a.b")).getStatus());
+}
+
+}  // namespace
+}  // namespace timeseries
+}  // namespace mongo
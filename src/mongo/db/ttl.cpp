@@ -34,6 +34,8 @@
 
 #include "mongo/db/ttl.h"
 
+#include <algorithm>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -55,6 +57,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/ttl_collection_cache.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
@@ -72,6 +75,47 @@ ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocume
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// The most documents deleted from one TTL index before the monitor moves on to the next one. A
+// pass keeps cycling through the TTL indexes until none has expired documents left, so one large
+// backlog can't hold up expiry on every other collection. 0 deletes each index's backlog in one go.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 10000);
+
+// The most documents per second the monitor deletes, across all TTL indexes. 0 means no limit.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxDeletesPerSecond, int, 0);
+
+namespace {
+
+// Counting the expired keys left in a TTL index stops here, so that estimating a large backlog
+// doesn't cost as much as deleting it.
+const long long kMaxBacklogKeysCounted = 1000 * 1000;
+
+/**
+ * Reports, for each TTL index seen by the latest pass, the documents deleted so far in that pass
+ * and an estimate of the expired documents still to be deleted.
+ */
+class TTLIndexesMetric : public ServerStatusMetric {
+public:
+    TTLIndexesMetric() : ServerStatusMetric("ttl.indexes") {}
+
+    void set(BSONArray indexes) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _indexes = std::move(indexes);
+    }
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        b.append(_leafName, _indexes);
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    BSONArray _indexes;
+};
+
+TTLIndexesMetric ttlIndexesMetric;
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -116,6 +160,22 @@ public:
     }
 
 private:
+    /**
+     * A TTL index's progress during one pass.
+     */
+    struct IndexProgress {
+        BSONObj spec;
+
+        // Documents deleted through this index during the pass.
+        long long deleted = 0;
+
+        // Estimate of the expired documents left to delete, or -1 before the first estimate.
+        long long backlog = -1;
+
+        // Whether the index has no expired documents left, or has to be skipped for this pass.
+        bool done = false;
+    };
+
     void doTTLPass() {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
@@ -128,7 +188,7 @@ private:
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
-        std::vector<BSONObj> ttlIndexes;
+        std::vector<IndexProgress> ttlIndexes;
 
         ttlPasses.increment();
 
@@ -149,27 +209,106 @@ private:
             for (const std::string& name : indexNames) {
                 BSONObj spec = collEntry->getIndexSpec(&opCtx, name);
                 if (spec.hasField(secondsExpireField)) {
-                    ttlIndexes.push_back(spec.getOwned());
+                    ttlIndexes.emplace_back();
+                    ttlIndexes.back().spec = spec.getOwned();
                 }
             }
         }
 
-        for (const BSONObj& idx : ttlIndexes) {
-            try {
-                doTTLForIndex(&opCtx, idx);
-            } catch (const DBException& dbex) {
-                error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
-                // Continue on to the next index.
-                continue;
+        // Take turns between the TTL indexes, deleting a bounded batch from each, until all of
+        // them are done.
+        const long long maxDeletesPerSecond = ttlMonitorMaxDeletesPerSecond.load();
+        long long batchSize = ttlMonitorBatchSize.load();
+        if (maxDeletesPerSecond > 0 && (batchSize <= 0 || batchSize > maxDeletesPerSecond)) {
+            // Keep each turn to at most a second's worth of the rate limit.
+            batchSize = maxDeletesPerSecond;
+        }
+
+        const Date_t passStart = Date_t::now();
+        long long deletedThisPass = 0;
+        bool anyPending = true;
+        while (anyPending && !globalInShutdownDeprecated()) {
+            anyPending = false;
+            for (auto&& progress : ttlIndexes) {
+                if (progress.done) {
+                    continue;
+                }
+
+                const long long deletedBefore = progress.deleted;
+                try {
+                    doTTLForIndex(&opCtx, &progress, std::max(0LL, batchSize));
+                } catch (const DBException& dbex) {
+                    error() << "Error processing ttl index: " << progress.spec << " -- "
+                            << dbex.toString();
+                    // Continue on to the next index.
+                    progress.done = true;
+                }
+                anyPending = anyPending || !progress.done;
+                deletedThisPass += progress.deleted - deletedBefore;
+                publishProgress(ttlIndexes);
+
+                if (maxDeletesPerSecond > 0) {
+                    // Stay within the rate limit, measured from the start of the pass.
+                    const Date_t due =
+                        passStart + Milliseconds(deletedThisPass * 1000 / maxDeletesPerSecond);
+                    const Date_t now = Date_t::now();
+                    if (due > now) {
+                        MONGO_IDLE_THREAD_BLOCK;
+                        sleepFor(due - now);
+                    }
+                }
             }
         }
     }
 
+    static void publishProgress(const std::vector<IndexProgress>& ttlIndexes) {
+        BSONArrayBuilder indexes;
+        for (auto&& progress : ttlIndexes) {
+            BSONObjBuilder index(indexes.subobjStart());
+            index.append("ns", progress.spec["ns"].valueStringData());
+            index.append("name", progress.spec["name"].valueStringData());
+            index.append("deleted", progress.deleted);
+            index.append("backlog", std::max(0LL, progress.backlog));
+        }
+        ttlIndexesMetric.set(indexes.arr());
+    }
+
+    /**
+     * Returns the number of keys in the range ['startKey', 'endKey'] of the index 'desc', counting
+     * no further than kMaxBacklogKeysCounted.
+     */
+    static long long countExpiredKeys(OperationContext* opCtx,
+                                      Collection* collection,
+                                      const IndexDescriptor* desc,
+                                      const BSONObj& startKey,
+                                      const BSONObj& endKey,
+                                      InternalPlanner::Direction direction) {
+        auto exec = InternalPlanner::indexScan(opCtx,
+                                               collection,
+                                               desc,
+                                               startKey,
+                                               endKey,
+                                               BoundInclusion::kIncludeBothStartAndEndKeys,
+                                               PlanExecutor::YIELD_AUTO,
+                                               direction);
+        long long count = 0;
+        while (count < kMaxBacklogKeysCounted &&
+               exec->getNext(nullptr, nullptr) == PlanExecutor::ADVANCED) {
+            ++count;
+        }
+        return count;
+    }
+
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
      * of time has passed according to its expiry specification.
+     *
+     * At most 'limit' documents are removed, or all expired documents if 'limit' is 0. The index is
+     * marked done unless the limit stopped the deletion early.
      */
-    void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
+    void doTTLForIndex(OperationContext* opCtx, IndexProgress* progress, long long limit) {
+        progress->done = true;
+        BSONObj idx = progress->spec;
         const NamespaceString collectionNSS(idx["ns"].String());
         if (collectionNSS.isDropPendingNamespace()) {
             return;
@@ -249,6 +388,7 @@ private:
         DeleteStageParams params;
         params.isMulti = true;
         params.canonicalQuery = canonicalQuery.getValue().get();
+        params.limit = limit;
 
         auto exec =
             InternalPlanner::deleteWithIndexScan(opCtx,
@@ -270,7 +410,23 @@ private:
 
         const long long numDeleted = DeleteStage::getNumDeleted(*exec);
         ttlDeletedDocuments.increment(numDeleted);
+        progress->deleted += numDeleted;
         LOG(1) << "deleted: " << numDeleted;
+
+        if (limit == 0 || numDeleted < limit) {
+            progress->backlog = 0;
+            return;
+        }
+
+        // The limit was reached, so there may be more to delete on the next turn. Count what is
+        // left the first time, and after that assume nothing new expires during the pass.
+        progress->done = false;
+        if (progress->backlog < 0) {
+            progress->backlog =
+                countExpiredKeys(opCtx, collection, desc, startKey, endKey, direction);
+        } else {
+            progress->backlog = std::max(0LL, progress->backlog - numDeleted);
+        }
     }
 };
 
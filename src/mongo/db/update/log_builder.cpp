@@ -27,6 +27,10 @@
  */
 
 #include "mongo/db/update/log_builder.h"
+
+#include <utility>
+#include <vector>
+
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -37,6 +41,76 @@ namespace str = mongoutils::str;
 namespace {
 const char kSet[] = "$set";
 const char kUnset[] = "$unset";
+
+// Values smaller than this are always logged whole. Every entry of a delta costs the secondary a
+// path to parse and walk, which is only worth it when it saves copying a large value.
+const int kMinDeltaValueSize = 1024;
+
+// A delta may log at most this many entries, and only while its size in the log stays under this
+// fraction of the whole value's.
+const size_t kMaxDeltaEntries = 128;
+const int kMaxDeltaSizeRatio = 2;
+
+bool isDeltaFieldName(StringData fieldName) {
+    return !fieldName.empty() && fieldName[0] != '$' && fieldName.find('.') == std::string::npos;
+}
+
+/**
+ * Appends to 'entries' the $set entries which turn 'original' into 'updated' at 'path', and adds
+ * their size in the log to 'logSize'. Returns false if the change can't be logged as a delta, or if
+ * the delta grows larger than 'maxLogSize'.
+ */
+bool appendDelta(const std::string& path,
+                 const BSONElement& original,
+                 const BSONElement& updated,
+                 std::vector<std::pair<std::string, BSONElement>>* entries,
+                 int* logSize,
+                 int maxLogSize) {
+    if (original.type() == updated.type() && original.binaryEqualValues(updated)) {
+        return true;
+    }
+
+    if (original.type() == BSONType::Object && updated.type() == BSONType::Object) {
+        BSONObjIterator originalFields(original.Obj());
+        BSONObjIterator updatedFields(updated.Obj());
+        while (originalFields.more() && updatedFields.more()) {
+            auto originalField = originalFields.next();
+            auto updatedField = updatedFields.next();
+            if (originalField.fieldNameStringData() != updatedField.fieldNameStringData() ||
+                !isDeltaFieldName(updatedField.fieldNameStringData()) ||
+                !appendDelta(path + '.' + updatedField.fieldName(),
+                             originalField,
+                             updatedField,
+                             entries,
+                             logSize,
+                             maxLogSize)) {
+                return false;
+            }
+        }
+        // A $set of a new field could place it differently than the update did.
+        return !originalFields.more() && !updatedFields.more();
+    }
+
+    if (original.type() == BSONType::Array && updated.type() == BSONType::Array) {
+        BSONObjIterator originalElements(original.Obj());
+        size_t index = 0;
+        for (auto&& updatedElement : updated.Obj()) {
+            const std::string elementPath = str::stream() << path << '.' << index++;
+            const BSONElement originalElement =
+                originalElements.more() ? originalElements.next() : BSONElement();
+            if (!appendDelta(
+                    elementPath, originalElement, updatedElement, entries, logSize, maxLogSize)) {
+                return false;
+            }
+        }
+        // There is no $set which removes array elements.
+        return !originalElements.more();
+    }
+
+    entries->emplace_back(path, updated);
+    *logSize += path.size() + updated.valuesize() + 2;
+    return entries->size() <= kMaxDeltaEntries && *logSize < maxLogSize;
+}
 }  // namespace
 
 constexpr StringData LogBuilder::kUpdateSemanticsFieldName;
@@ -111,6 +185,42 @@ Status LogBuilder::addToSetsWithNewFieldName(StringData name, const BSONElement&
     return addToSets(elemToSet);
 }
 
+Status LogBuilder::addDeltaToSets(StringData path,
+                                  const BSONElement& original,
+                                  const mutablebson::Element updated) {
+    if (original.eoo() || (original.type() != BSONType::Object &&
+                           original.type() != BSONType::Array)) {
+        return addToSetsWithNewFieldName(path, updated);
+    }
+
+    BSONObjBuilder updatedBuilder;
+    updated.writeTo(&updatedBuilder);
+    const BSONObj updatedObj = updatedBuilder.obj();
+    const BSONElement updatedValue = updatedObj.firstElement();
+    if (updatedValue.valuesize() < kMinDeltaValueSize) {
+        return addToSetsWithNewFieldName(path, updated);
+    }
+
+    std::vector<std::pair<std::string, BSONElement>> entries;
+    int logSize = 0;
+    if (!appendDelta(path.toString(),
+                     original,
+                     updatedValue,
+                     &entries,
+                     &logSize,
+                     updatedValue.valuesize() / kMaxDeltaSizeRatio)) {
+        return addToSetsWithNewFieldName(path, updated);
+    }
+
+    for (auto&& entry : entries) {
+        auto status = addToSetsWithNewFieldName(entry.first, entry.second);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
 Status LogBuilder::addToSets(StringData name, const SafeNum& val) {
     mutablebson::Element elemToSet = _logRoot.getDocument().makeElementSafeNum(name, val);
     if (!elemToSet.ok())
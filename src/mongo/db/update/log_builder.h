@@ -104,6 +104,18 @@ public:
      */
     Status addToSetsWithNewFieldName(StringData name, const BSONElement& val);
 
+    /**
+     * Logs the change of the value at 'path' from 'original' to 'updated' as a delta when that is
+     * substantially smaller than the updated value: objects which kept the same fields in the same
+     * order log each changed field, and arrays which did not shrink log each changed or appended
+     * element, both recursively, as $set entries on the dotted paths. Applying the entries is
+     * idempotent, like applying the whole value. Otherwise, or if 'original' is EOO, the whole
+     * updated value is logged as with addToSetsWithNewFieldName().
+     */
+    Status addDeltaToSets(StringData path,
+                          const BSONElement& original,
+                          const mutablebson::Element updated);
+
     /** Add the given path as a new entry in the '$unset' section of the log. If an
      *  '$unset' section does not yet exist, it will be created. If this LogBuilder is
      *  currently configured to contain an object replacement, the request to add to the
@@ -269,4 +269,90 @@ TEST(LogBuilder, CantReacquireObjectReplacementData) {
     ASSERT_FALSE(again.ok());
 }
 
+mongo::BSONArray makeLargeArray(int size) {
+    mongo::BSONArrayBuilder builder;
+    for (int i = 0; i < size; ++i) {
+        builder.append(i);
+    }
+    return builder.arr();
+}
+
+TEST(LogBuilder, AddDeltaOfLargeArrayLogsChangedAndAppendedElements) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    const mongo::BSONObj original = BSON("a" << makeLargeArray(200));
+    mongo::BSONArrayBuilder updatedArray;
+    for (int i = 0; i < 202; ++i) {
+        updatedArray.append(i == 5 ? -1 : i);
+    }
+    mmb::Document updatedDoc(BSON("a" << updatedArray.arr()));
+
+    ASSERT_OK(lb.addDeltaToSets("x.a", original["a"], updatedDoc.root()["a"]));
+    ASSERT_EQUALS(mongo::fromjson("{$set: {'x.a.5': -1, 'x.a.200': 200, 'x.a.201': 201}}"), doc);
+}
+
+TEST(LogBuilder, AddDeltaOfLargeObjectLogsChangedFields) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    const mongo::BSONObj original = BSON("a" << BSON("big" << makeLargeArray(200) << "x" << 1));
+    mmb::Document updatedDoc(BSON("a" << BSON("big" << makeLargeArray(200) << "x" << 2)));
+
+    ASSERT_OK(lb.addDeltaToSets("a", original["a"], updatedDoc.root()["a"]));
+    ASSERT_EQUALS(mongo::fromjson("{$set: {'a.x': 2}}"), doc);
+}
+
+TEST(LogBuilder, AddDeltaLogsWholeValueWhenFieldsWereReordered) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    const mongo::BSONObj original = BSON("a" << BSON("x" << 1 << "big" << makeLargeArray(200)));
+    const mongo::BSONObj updated = BSON("a" << BSON("big" << makeLargeArray(200) << "x" << 2));
+    mmb::Document updatedDoc(updated);
+
+    ASSERT_OK(lb.addDeltaToSets("a", original["a"], updatedDoc.root()["a"]));
+    ASSERT_EQUALS(BSON("$set" << updated), doc);
+}
+
+TEST(LogBuilder, AddDeltaLogsWholeValueWhenArrayShrank) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    const mongo::BSONObj original = BSON("a" << makeLargeArray(200));
+    const mongo::BSONObj updated = BSON("a" << makeLargeArray(199));
+    mmb::Document updatedDoc(updated);
+
+    ASSERT_OK(lb.addDeltaToSets("a", original["a"], updatedDoc.root()["a"]));
+    ASSERT_EQUALS(BSON("$set" << updated), doc);
+}
+
+TEST(LogBuilder, AddDeltaLogsWholeValueWhenSmall) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    const mongo::BSONObj original = mongo::fromjson("{a: [1, 2, 3]}");
+    const mongo::BSONObj updated = mongo::fromjson("{a: [1, 2, 3, 4]}");
+    mmb::Document updatedDoc(updated);
+
+    ASSERT_OK(lb.addDeltaToSets("a", original["a"], updatedDoc.root()["a"]));
+    ASSERT_EQUALS(BSON("$set" << updated), doc);
+}
+
+TEST(LogBuilder, AddDeltaLogsWholeValueWhenMostElementsChanged) {
+    mmb::Document doc;
+    LogBuilder lb(doc.root());
+
+    const mongo::BSONObj original = BSON("a" << makeLargeArray(200));
+    mongo::BSONArrayBuilder updatedArray;
+    for (int i = 0; i < 200; ++i) {
+        updatedArray.append(-i);
+    }
+    const mongo::BSONObj updated = BSON("a" << updatedArray.arr());
+    mmb::Document updatedDoc(updated);
+
+    ASSERT_OK(lb.addDeltaToSets("a", original["a"], updatedDoc.root()["a"]));
+    ASSERT_EQUALS(BSON("$set" << updated), doc);
+}
+
 }  // namespace
@@ -165,6 +165,15 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
         }
     }
 
+    // An unmodified object or array still refers to the original document, which the update does
+    // not overwrite, so it can later be compared with the updated value to log only the changes.
+    BSONElement originalValue;
+    if (applyParams.logBuilder && applyParams.element.hasValue() &&
+        (applyParams.element.getType() == BSONType::Object ||
+         applyParams.element.getType() == BSONType::Array)) {
+        originalValue = applyParams.element.getValue();
+    }
+
     // We have two different ways of checking for changes to immutable paths, depending on the style
     // of update. See the comments above checkImmutablePathsNotModifiedFromOriginal() and
     // checkImmutablePathsNotModified().
@@ -192,6 +201,9 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
     if (!applyParams.indexData ||
         !applyParams.indexData->mightBeIndexed(applyParams.pathTaken->dottedField())) {
         applyResult.indexesAffected = false;
+    } else if (applyParams.modifiedIndexedPaths) {
+        applyParams.modifiedIndexedPaths->push_back(
+            applyParams.pathTaken->dottedField().toString());
     }
 
     if (applyParams.validateForStorage) {
@@ -204,6 +216,7 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
         logUpdate(applyParams.logBuilder,
                   applyParams.pathTaken->dottedField(),
                   applyParams.element,
+                  originalValue,
                   updateResult);
     }
 
@@ -286,15 +299,21 @@ UpdateNode::ApplyResult ModifierNode::applyToNonexistentElement(ApplyParams appl
         // an index {"a.b": 1}, and we set "a.1.c" and implicitly create an array element in "a",
         // then we may need to add a null key to the index, even though "a.1.c" does not appear to
         // affect the index.
-        if (!applyParams.indexData ||
-            !applyParams.indexData->mightBeIndexed(applyParams.element.getType() != BSONType::Array
-                                                       ? fullPath
-                                                       : applyParams.pathTaken->dottedField())) {
+        StringData affectedPath = applyParams.element.getType() != BSONType::Array
+            ? StringData(fullPath)
+            : applyParams.pathTaken->dottedField();
+        if (!applyParams.indexData || !applyParams.indexData->mightBeIndexed(affectedPath)) {
             applyResult.indexesAffected = false;
+        } else if (applyParams.modifiedIndexedPaths) {
+            applyParams.modifiedIndexedPaths->push_back(affectedPath.toString());
         }
 
         if (applyParams.logBuilder) {
-            logUpdate(applyParams.logBuilder, fullPath, newElement, ModifyResult::kCreated);
+            logUpdate(applyParams.logBuilder,
+                      fullPath,
+                      newElement,
+                      BSONElement(),
+                      ModifyResult::kCreated);
         }
 
         return applyResult;
@@ -334,11 +353,12 @@ void ModifierNode::validateUpdate(mutablebson::ConstElement updatedElement,
 void ModifierNode::logUpdate(LogBuilder* logBuilder,
                              StringData pathTaken,
                              mutablebson::Element element,
+                             const BSONElement& originalValue,
                              ModifyResult modifyResult) const {
     invariant(logBuilder);
     invariant(modifyResult == ModifyResult::kNormalUpdate ||
               modifyResult == ModifyResult::kCreated);
-    uassertStatusOK(logBuilder->addToSetsWithNewFieldName(pathTaken, element));
+    uassertStatusOK(logBuilder->addDeltaToSets(pathTaken, originalValue, element));
 }
 
 }  // namespace mongo
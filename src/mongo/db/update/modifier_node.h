@@ -125,12 +125,15 @@ protected:
      * - 'pathTaken' is the path of the applied update.
      * - 'element' is the element that was set by either updateExistingElement() or
      *   setValueForNewElement().
+     * - 'originalValue' is the object or array value of 'element' before the update, or EOO if it
+     *   was created or held any other type.
      * - 'modifyResult' is either the value returned by updateExistingElement() or the value
      *    ModifyResult::kCreated.
      */
     virtual void logUpdate(LogBuilder* logBuilder,
                            StringData pathTaken,
                            mutablebson::Element element,
+                           const BSONElement& originalValue,
                            ModifyResult modifyResult) const;
 
     /**
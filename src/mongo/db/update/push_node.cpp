@@ -282,12 +282,13 @@ ModifierNode::ModifyResult PushNode::updateExistingElement(
 void PushNode::logUpdate(LogBuilder* logBuilder,
                          StringData pathTaken,
                          mutablebson::Element element,
+                         const BSONElement& originalValue,
                          ModifyResult modifyResult) const {
     invariant(logBuilder);
 
     if (modifyResult == ModifyResult::kNormalUpdate || modifyResult == ModifyResult::kCreated) {
-        // Simple case: log the entires contents of the updated array.
-        uassertStatusOK(logBuilder->addToSetsWithNewFieldName(pathTaken, element));
+        // Simple case: log the changes to the updated array, or its entire contents.
+        uassertStatusOK(logBuilder->addDeltaToSets(pathTaken, originalValue, element));
     } else if (modifyResult == ModifyResult::kArrayAppendUpdate) {
         // This update only modified the array by appending entries to the end. Rather than writing
         // out the entire contents of the array, we create oplog entries for the newly appended
@@ -63,6 +63,7 @@ protected:
     void logUpdate(LogBuilder* logBuilder,
                    StringData pathTaken,
                    mutablebson::Element element,
+                   const BSONElement& originalValue,
                    ModifyResult modifyResult) const final;
 
     bool allowCreation() const final {
@@ -1386,5 +1386,28 @@ TEST_F(SetNodeTest, ApplySetOnInsertExistingPath) {
     ASSERT_TRUE(doc.isInPlaceModeEnabled());
 }
 
+TEST_F(SetNodeTest, ApplyLogsOnlyChangedElementsOfLargeArray) {
+    BSONArrayBuilder original;
+    BSONArrayBuilder updated;
+    for (int i = 0; i < 200; ++i) {
+        original.append(i);
+        updated.append(i == 7 ? -7 : i);
+    }
+    updated.append(200);
+    auto update = BSON("$set" << BSON("a" << updated.arr()));
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    SetNode node;
+    ASSERT_OK(node.init(update["$set"]["a"], expCtx));
+
+    mutablebson::Document doc(BSON("a" << original.arr()));
+    setPathTaken("a");
+    addIndexedPath("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]));
+    ASSERT_FALSE(result.noop);
+    ASSERT_TRUE(result.indexesAffected);
+    ASSERT_EQUALS(BSON("a" << update["$set"]["a"]), doc);
+    ASSERT_EQUALS(fromjson("{$set: {'a.7': -7, 'a.200': 200}}"), getLogDoc());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -80,6 +80,7 @@ void UnsetNode::validateUpdate(mutablebson::ConstElement updatedElement,
 void UnsetNode::logUpdate(LogBuilder* logBuilder,
                           StringData pathTaken,
                           mutablebson::Element element,
+                          const BSONElement& originalValue,
                           ModifyResult modifyResult) const {
     invariant(logBuilder);
     invariant(modifyResult == ModifyResult::kNormalUpdate);
@@ -58,6 +58,7 @@ public:
     void logUpdate(LogBuilder* logBuilder,
                    StringData pathTaken,
                    mutablebson::Element element,
+                   const BSONElement& originalValue,
                    ModifyResult modifyResult) const final;
 
     bool allowNonViablePath() const final {
@@ -253,6 +253,7 @@ Status UpdateDriver::update(StringData matchedField,
     // TODO: assert that update() is called at most once in a !_multi case.
 
     _affectIndices = (isDocReplacement() && (_indexedFields != NULL));
+    _modifiedIndexedPaths.clear();
 
     _logDoc.reset();
     LogBuilder logBuilder(_logDoc.root());
@@ -263,6 +264,7 @@ Status UpdateDriver::update(StringData matchedField,
     applyParams.fromOplogApplication = _fromOplogApplication;
     applyParams.validateForStorage = validateForStorage;
     applyParams.indexData = _indexedFields;
+    applyParams.modifiedIndexedPaths = &_modifiedIndexedPaths;
     if (_logOp && logOpRec) {
         applyParams.logBuilder = &logBuilder;
     }
@@ -302,6 +304,10 @@ bool UpdateDriver::modsAffectIndices() const {
     return _affectIndices;
 }
 
+const std::vector<std::string>* UpdateDriver::getModifiedIndexedPaths() const {
+    return isDocReplacement() ? nullptr : &_modifiedIndexedPaths;
+}
+
 void UpdateDriver::refreshIndexKeys(const UpdateIndexData* indexedFields) {
     _indexedFields = indexedFields;
 }
@@ -110,6 +110,13 @@ public:
     static bool isDocReplacement(const BSONObj& updateExpr);
 
     bool modsAffectIndices() const;
+
+    /**
+     * Returns the possibly indexed paths modified by the last call to update(), or nullptr if
+     * every index must be considered affected, as for a full document replacement.
+     */
+    const std::vector<std::string>* getModifiedIndexedPaths() const;
+
     void refreshIndexKeys(const UpdateIndexData* indexedFields);
 
     bool logOp() const;
@@ -178,6 +185,10 @@ private:
     // at each call to update.
     bool _affectIndices = false;
 
+    // Which of the fields mentioned in the mods might participate in an index? Is refilled at
+    // each call to update.
+    std::vector<std::string> _modifiedIndexedPaths;
+
     // Do any of the mods require positional match details when calling 'prepare'?
     bool _positional = false;
 
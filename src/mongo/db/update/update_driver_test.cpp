@@ -156,6 +156,54 @@ TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     ASSERT_TRUE(modified);
 }
 
+TEST(ModifiedIndexedPaths, RecordsOnlyIndexedPaths) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_OK(driver.parse(fromjson("{$set: {a: 2, c: 2}, $inc: {'b.x': 1}}"), arrayFilters));
+
+    UpdateIndexData indexData;
+    indexData.addPath("a");
+    indexData.addPath("b");
+    driver.refreshIndexKeys(&indexData);
+
+    const FieldRefSet emptyImmutablePaths;
+    mutablebson::Document doc(fromjson("{a: 1, b: {x: 1}, c: 1}"));
+    ASSERT_OK(driver.update(StringData(), &doc, true, emptyImmutablePaths));
+
+    ASSERT_TRUE(driver.modsAffectIndices());
+    ASSERT(driver.getModifiedIndexedPaths());
+    ASSERT_EQ((std::vector<std::string>{"a", "b.x"}), *driver.getModifiedIndexedPaths());
+
+}
+
+TEST(ModifiedIndexedPaths, EmptyForUnindexedMods) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_OK(driver.parse(fromjson("{$set: {c: 2}}"), arrayFilters));
+
+    UpdateIndexData indexData;
+    indexData.addPath("a");
+    driver.refreshIndexKeys(&indexData);
+
+    const FieldRefSet emptyImmutablePaths;
+    mutablebson::Document doc(fromjson("{a: 1, c: 1}"));
+    ASSERT_OK(driver.update(StringData(), &doc, true, emptyImmutablePaths));
+
+    ASSERT_FALSE(driver.modsAffectIndices());
+    ASSERT(driver.getModifiedIndexedPaths());
+    ASSERT(driver.getModifiedIndexedPaths()->empty());
+}
+
+TEST(ModifiedIndexedPaths, UnknownForReplacement) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_OK(driver.parse(fromjson("{a: 2}"), arrayFilters));
+    ASSERT_FALSE(driver.getModifiedIndexedPaths());
+}
+
 //
 // Tests of creating a base for an upsert from a query document
 // $or, $and, $all get special handling, as does the _id field
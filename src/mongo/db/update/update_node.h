@@ -119,6 +119,10 @@ public:
         // Used to determine whether indexes are affected.
         const UpdateIndexData* indexData = nullptr;
 
+        // If provided, UpdateNode::apply appends each modified path which 'indexData' reports as
+        // possibly indexed, so that only the indexes on those paths need to be maintained.
+        std::vector<std::string>* modifiedIndexedPaths = nullptr;
+
         // If provided, UpdateNode::apply will log the update here.
         LogBuilder* logBuilder = nullptr;
     };
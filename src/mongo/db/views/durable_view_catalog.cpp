@@ -91,7 +91,8 @@ Status DurableViewCatalogImpl::iterate(OperationContext* opCtx, Callback callbac
         bool valid = true;
         for (const BSONElement& e : viewDef) {
             std::string name(e.fieldName());
-            valid &= name == "_id" || name == "viewOn" || name == "pipeline" || name == "collation";
+            valid &= name == "_id" || name == "viewOn" || name == "pipeline" || name == "collation" ||
+                name == "materialized";
         }
 
         const auto viewName = viewDef["_id"].str();
@@ -116,6 +117,14 @@ Status DurableViewCatalogImpl::iterate(OperationContext* opCtx, Callback callbac
         valid &=
             (!viewDef.hasField("collation") || viewDef["collation"].type() == BSONType::Object);
 
+        if (viewDef.hasField("materialized")) {
+            valid &= viewDef["materialized"].type() == BSONType::Object;
+            if (valid) {
+                auto refreshedAt = viewDef["materialized"]["refreshedAt"];
+                valid &= refreshedAt.eoo() || refreshedAt.type() == BSONType::bsonTimestamp;
+            }
+        }
+
         if (!valid) {
             return {ErrorCodes::InvalidViewDefinition,
                     str::stream() << "found invalid view definition " << viewDef["_id"]
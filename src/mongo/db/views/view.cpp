@@ -40,8 +40,14 @@ ViewDefinition::ViewDefinition(StringData dbName,
                                StringData viewName,
                                StringData viewOnName,
                                const BSONObj& pipeline,
-                               std::unique_ptr<CollatorInterface> collator)
-    : _viewNss(dbName, viewName), _viewOnNss(dbName, viewOnName), _collator(std::move(collator)) {
+                               std::unique_ptr<CollatorInterface> collator,
+                               bool materialized,
+                               Timestamp refreshedAt)
+    : _viewNss(dbName, viewName),
+      _viewOnNss(dbName, viewOnName),
+      _collator(std::move(collator)),
+      _materialized(materialized),
+      _refreshedAt(refreshedAt) {
     for (BSONElement e : pipeline) {
         _pipeline.push_back(e.Obj().getOwned());
     }
@@ -51,17 +57,30 @@ ViewDefinition::ViewDefinition(const ViewDefinition& other)
     : _viewNss(other._viewNss),
       _viewOnNss(other._viewOnNss),
       _collator(CollatorInterface::cloneCollator(other._collator.get())),
-      _pipeline(other._pipeline) {}
+      _pipeline(other._pipeline),
+      _materialized(other._materialized),
+      _refreshedAt(other._refreshedAt) {}
 
 ViewDefinition& ViewDefinition::operator=(const ViewDefinition& other) {
     _viewNss = other._viewNss;
     _viewOnNss = other._viewOnNss;
     _collator = CollatorInterface::cloneCollator(other._collator.get());
     _pipeline = other._pipeline;
+    _materialized = other._materialized;
+    _refreshedAt = other._refreshedAt;
 
     return *this;
 }
 
+NamespaceString ViewDefinition::materializedNss() const {
+    return NamespaceString(_viewNss.db(), "system.materialized." + _viewNss.coll().toString());
+}
+
+bool ViewDefinition::isTimeseries() const {
+    return _viewOnNss == _viewNss.makeTimeseriesBucketsNamespace() && _pipeline.size() == 1 &&
+        _pipeline[0].firstElement().fieldNameStringData() == "$_internalUnpackBucket";
+}
+
 void ViewDefinition::setViewOn(const NamespaceString& viewOnNss) {
     invariant(_viewNss.db() == viewOnNss.db());
     _viewOnNss = viewOnNss;
@@ -33,6 +33,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
 
@@ -46,12 +47,18 @@ public:
     /**
      * In the database 'dbName', create a new view 'viewName' on the view or collection
      * 'viewOnName'. Neither 'viewName' nor 'viewOnName' should include the name of the database.
+     *
+     * A 'materialized' view stores the results of its pipeline in the collection named by
+     * materializedNss(). They reflect every write to 'viewOnName' up to the oplog timestamp
+     * 'refreshedAt', or have never been computed if 'refreshedAt' is null.
      */
     ViewDefinition(StringData dbName,
                    StringData viewName,
                    StringData viewOnName,
                    const BSONObj& pipeline,
-                   std::unique_ptr<CollatorInterface> collation);
+                   std::unique_ptr<CollatorInterface> collation,
+                   bool materialized = false,
+                   Timestamp refreshedAt = Timestamp());
 
     /**
      * Copying a view 'other' clones its collator and does a simple copy of all other fields.
@@ -89,6 +96,29 @@ public:
         return _collator.get();
     }
 
+    bool isMaterialized() const {
+        return _materialized;
+    }
+
+    /**
+     * Returns the oplog timestamp up to which the stored results of a materialized view are
+     * current, or a null timestamp if they have not been computed yet.
+     */
+    Timestamp refreshedAt() const {
+        return _refreshedAt;
+    }
+
+    /**
+     * Returns the namespace of the collection which stores the results of a materialized view.
+     */
+    NamespaceString materializedNss() const;
+
+    /**
+     * Returns true if this view is a time-series collection, meaning it unpacks the buckets stored
+     * in the collection named by NamespaceString::makeTimeseriesBucketsNamespace().
+     */
+    bool isTimeseries() const;
+
     void setViewOn(const NamespaceString& viewOnNss);
 
     /**
@@ -101,5 +131,7 @@ private:
     NamespaceString _viewOnNss;
     std::unique_ptr<CollatorInterface> _collator;
     std::vector<BSONObj> _pipeline;
+    bool _materialized;
+    Timestamp _refreshedAt;
 };
 }  // namespace mongo
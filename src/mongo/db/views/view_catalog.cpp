@@ -66,6 +66,52 @@ StatusWith<std::unique_ptr<CollatorInterface>> parseCollator(OperationContext* o
     }
     return CollatorFactoryInterface::get(opCtx->getServiceContext())->makeFromBSON(collationSpec);
 }
+
+/**
+ * Returns Status::OK if the results of 'pipeline' can be kept up to date by running it over just
+ * the documents inserted since they were computed, and merging its output into them. That holds
+ * for a $group with only $sum, $min and $max accumulators, preceded by stages which each look at
+ * one document at a time.
+ */
+Status validateMaterializedPipeline(const std::vector<BSONObj>& pipeline) {
+    if (pipeline.empty() || pipeline.back().firstElementFieldNameStringData() != "$group") {
+        return {ErrorCodes::OptionNotSupportedOnView,
+                "The pipeline of a materialized view must end with a $group stage"};
+    }
+
+    for (size_t i = 0; i + 1 < pipeline.size(); ++i) {
+        auto stage = pipeline[i].firstElement();
+        const auto stageName = stage.fieldNameStringData();
+        if (stageName != "$match" && stageName != "$project" && stageName != "$addFields" &&
+            stageName != "$unwind" && stageName != "$replaceRoot") {
+            return {ErrorCodes::OptionNotSupportedOnView,
+                    str::stream() << stageName << " cannot be used in the pipeline of a "
+                                                  "materialized view"};
+        }
+        if (stageName == "$match" && stage.type() == BSONType::Object &&
+            stage.Obj().hasField("$text")) {
+            return {ErrorCodes::OptionNotSupportedOnView,
+                    "$text cannot be used in the pipeline of a materialized view"};
+        }
+    }
+
+    for (auto&& field : pipeline.back().firstElement().Obj()) {
+        if (field.fieldNameStringData() == "_id") {
+            continue;
+        }
+        const auto accumulatorName = field.Obj().firstElementFieldNameStringData();
+        if (accumulatorName != "$sum" && accumulatorName != "$min" && accumulatorName != "$max") {
+            return {ErrorCodes::OptionNotSupportedOnView,
+                    str::stream() << "The $group of a materialized view can only use $sum, $min "
+                                     "and $max, but field '"
+                                  << field.fieldNameStringData()
+                                  << "' uses "
+                                  << accumulatorName};
+        }
+    }
+
+    return Status::OK();
+}
 }  // namespace
 
 Status ViewCatalog::reloadIfNeeded(OperationContext* opCtx) {
@@ -81,6 +127,7 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
 
     // Need to reload, first clear our cache.
     _viewMap.clear();
+    _resolvedViews.clear();
 
     Status status = _durable->iterate(opCtx, [&](const BSONObj& view) -> Status {
         BSONObj collationSpec = view.hasField("collation") ? view["collation"].Obj() : BSONObj();
@@ -90,6 +137,9 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
         }
 
         NamespaceString viewName(view["_id"].str());
+        const bool materialized = view.hasField("materialized");
+        const Timestamp refreshedAt =
+            materialized ? view["materialized"]["refreshedAt"].timestamp() : Timestamp();
 
         auto pipeline = view["pipeline"].Obj();
         for (auto&& stage : pipeline) {
@@ -106,7 +156,9 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
                                                                    viewName.coll(),
                                                                    view["viewOn"].str(),
                                                                    pipeline,
-                                                                   std::move(collator.getValue()));
+                                                                   std::move(collator.getValue()),
+                                                                   materialized,
+                                                                   refreshedAt);
         return Status::OK();
     });
     _valid.store(status.isOK());
@@ -131,7 +183,9 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
                                                const NamespaceString& viewName,
                                                const NamespaceString& viewOn,
                                                const BSONArray& pipeline,
-                                               std::unique_ptr<CollatorInterface> collator) {
+                                               std::unique_ptr<CollatorInterface> collator,
+                                               bool materialized,
+                                               Timestamp refreshedAt) {
     _requireValidCatalog_inlock(opCtx);
 
     // Build the BSON definition for this view to be saved in the durable view catalog. If the
@@ -143,10 +197,21 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
     if (collator) {
         viewDefBuilder.append("collation", collator->getSpec().toBSON());
     }
+    if (materialized) {
+        BSONObjBuilder materializedBuilder(viewDefBuilder.subobjStart("materialized"));
+        if (!refreshedAt.isNull()) {
+            materializedBuilder.append("refreshedAt", refreshedAt);
+        }
+    }
 
     BSONObj ownedPipeline = pipeline.getOwned();
-    auto view = std::make_shared<ViewDefinition>(
-        viewName.db(), viewName.coll(), viewOn.coll(), ownedPipeline, std::move(collator));
+    auto view = std::make_shared<ViewDefinition>(viewName.db(),
+                                                 viewName.coll(),
+                                                 viewOn.coll(),
+                                                 ownedPipeline,
+                                                 std::move(collator),
+                                                 materialized,
+                                                 refreshedAt);
 
     // Check that the resulting dependency graph is acyclic and within the maximum depth.
     Status graphStatus = _upsertIntoGraph(opCtx, *(view.get()));
@@ -156,8 +221,10 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    _resolvedViews.clear();
     opCtx->recoveryUnit()->onRollback([this, viewName]() {
         this->_viewMap.erase(viewName.ns());
+        this->_resolvedViews.clear();
         this->_viewGraphNeedsRefresh = true;
     });
 
@@ -273,6 +340,13 @@ StatusWith<stdx::unordered_set<NamespaceString>> ViewCatalog::_validatePipeline_
                 "$changeStream cannot be used in a view definition"};
     }
 
+    if (viewDef.isMaterialized()) {
+        auto materializedStatus = validateMaterializedPipeline(viewDef.pipeline());
+        if (!materializedStatus.isOK()) {
+            return materializedStatus;
+        }
+    }
+
     return std::move(involvedNamespaces);
 }
 
@@ -297,7 +371,8 @@ Status ViewCatalog::createView(OperationContext* opCtx,
                                const NamespaceString& viewName,
                                const NamespaceString& viewOn,
                                const BSONArray& pipeline,
-                               const BSONObj& collation) {
+                               const BSONObj& collation,
+                               bool materialized) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     if (viewName.db() != viewOn.db())
@@ -320,8 +395,13 @@ Status ViewCatalog::createView(OperationContext* opCtx,
     if (!collator.isOK())
         return collator.getStatus();
 
-    return _createOrUpdateView_inlock(
-        opCtx, viewName, viewOn, pipeline, std::move(collator.getValue()));
+    return _createOrUpdateView_inlock(opCtx,
+                                      viewName,
+                                      viewOn,
+                                      pipeline,
+                                      std::move(collator.getValue()),
+                                      materialized,
+                                      Timestamp());
 }
 
 Status ViewCatalog::modifyView(OperationContext* opCtx,
@@ -346,6 +426,7 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
     ViewDefinition savedDefinition = *viewPtr;
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
     });
 
     return _createOrUpdateView_inlock(
@@ -353,7 +434,44 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
         viewName,
         viewOn,
         pipeline,
-        CollatorInterface::cloneCollator(savedDefinition.defaultCollator()));
+        CollatorInterface::cloneCollator(savedDefinition.defaultCollator()),
+        savedDefinition.isMaterialized(),
+        Timestamp());
+}
+
+Status ViewCatalog::setRefreshedAt(OperationContext* opCtx,
+                                   const NamespaceString& viewName,
+                                   Timestamp refreshedAt) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto viewPtr = _lookup_inlock(opCtx, viewName.ns());
+    if (!viewPtr)
+        return Status(ErrorCodes::NamespaceNotFound,
+                      str::stream() << "cannot refresh missing view " << viewName.ns());
+
+    if (!viewPtr->isMaterialized())
+        return Status(ErrorCodes::InvalidOptions,
+                      str::stream() << "view " << viewName.ns() << " is not materialized");
+
+    ViewDefinition savedDefinition = *viewPtr;
+    opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
+        this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
+    });
+
+    BSONArrayBuilder pipeline;
+    for (auto&& stage : savedDefinition.pipeline()) {
+        pipeline.append(stage);
+    }
+
+    return _createOrUpdateView_inlock(
+        opCtx,
+        viewName,
+        savedDefinition.viewOn(),
+        pipeline.arr(),
+        CollatorInterface::cloneCollator(savedDefinition.defaultCollator()),
+        true,
+        refreshedAt);
 }
 
 Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& viewName) {
@@ -373,9 +491,11 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    _resolvedViews.clear();
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewGraphNeedsRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -416,6 +536,25 @@ std::shared_ptr<ViewDefinition> ViewCatalog::lookup(OperationContext* opCtx, Str
 StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                                                   const NamespaceString& nss) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // Looking up the view reloads the catalog if it was invalidated, which empties the cache.
+    const bool cacheable = _lookup_inlock(opCtx, nss.ns()) && _valid.load();
+    if (cacheable) {
+        auto it = _resolvedViews.find(nss.ns());
+        if (it != _resolvedViews.end()) {
+            return *it->second;
+        }
+    }
+
+    auto resolvedView = _resolveView_inlock(opCtx, nss);
+    if (cacheable && resolvedView.isOK()) {
+        _resolvedViews[nss.ns()] = std::make_shared<const ResolvedView>(resolvedView.getValue());
+    }
+    return resolvedView;
+}
+
+StatusWith<ResolvedView> ViewCatalog::_resolveView_inlock(OperationContext* opCtx,
+                                                          const NamespaceString& nss) {
     const NamespaceString* resolvedNss = &nss;
     std::vector<BSONObj> resolvedPipeline;
     BSONObj collation;
@@ -437,10 +576,17 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                 {*resolvedNss, std::move(resolvedPipeline), std::move(collation)});
         }
 
-        resolvedNss = &(view->viewOn());
         collation = view->defaultCollator() ? view->defaultCollator()->getSpec().toBSON()
                                             : CollationSpec::kSimpleSpec;
 
+        // The stored results of a materialized view already have its pipeline applied.
+        if (view->isMaterialized() && !view->refreshedAt().isNull()) {
+            return StatusWith<ResolvedView>(
+                {view->materializedNss(), std::move(resolvedPipeline), std::move(collation)});
+        }
+
+        resolvedNss = &(view->viewOn());
+
         // Prepend the underlying view's pipeline to the current working pipeline.
         const std::vector<BSONObj>& toPrepend = view->pipeline();
         resolvedPipeline.insert(resolvedPipeline.begin(), toPrepend.begin(), toPrepend.end());
@@ -79,13 +79,18 @@ public:
      * database's catalog, so the check for an existing collection with the same name must be done
      * before calling createView.
      *
+     * If 'materialized' is true, the results of the pipeline are stored rather than computed on
+     * every read. Reads fall back to running the pipeline until the stored results are first
+     * computed, and setRefreshedAt() records that they have been.
+     *
      * Must be in WriteUnitOfWork. View creation rolls back if the unit of work aborts.
      */
     Status createView(OperationContext* opCtx,
                       const NamespaceString& viewName,
                       const NamespaceString& viewOn,
                       const BSONArray& pipeline,
-                      const BSONObj& collation);
+                      const BSONObj& collation,
+                      bool materialized = false);
 
     /**
      * Drop the view named 'viewName'.
@@ -95,7 +100,8 @@ public:
     Status dropView(OperationContext* opCtx, const NamespaceString& viewName);
 
     /**
-     * Modify the view named 'viewName' to have the new 'viewOn' and 'pipeline'.
+     * Modify the view named 'viewName' to have the new 'viewOn' and 'pipeline'. The stored results
+     * of a materialized view are no longer used until they are recomputed.
      *
      * Must be in WriteUnitOfWork. The modification rolls back if the unit of work aborts.
      */
@@ -104,6 +110,17 @@ public:
                       const NamespaceString& viewOn,
                       const BSONArray& pipeline);
 
+    /**
+     * Records that the stored results of the materialized view 'viewName' reflect every write to
+     * the collection it is defined on up to the oplog timestamp 'refreshedAt'. Reads of the view
+     * are served from the stored results from then on.
+     *
+     * Must be in WriteUnitOfWork. The modification rolls back if the unit of work aborts.
+     */
+    Status setRefreshedAt(OperationContext* opCtx,
+                          const NamespaceString& viewName,
+                          Timestamp refreshedAt);
+
     /**
      * Look up the 'nss' in the view catalog, returning a shared pointer to a View definition, or
      * nullptr if it doesn't exist.
@@ -113,7 +130,10 @@ public:
     /**
      * Resolve the views on 'nss', transforming the pipeline appropriately. This function returns a
      * fully-resolved view definition containing the backing namespace, the resolved pipeline and
-     * the collation to use for the operation.
+     * the collation to use for the operation. Resolution stops at a materialized view whose results
+     * have been computed, which is backed by the collection storing them.
+     *
+     * Views are only resolved again after the catalog changes, so repeated calls are cheap.
      */
     StatusWith<ResolvedView> resolveView(OperationContext* opCtx, const NamespaceString& nss);
 
@@ -140,7 +160,9 @@ private:
                                       const NamespaceString& viewName,
                                       const NamespaceString& viewOn,
                                       const BSONArray& pipeline,
-                                      std::unique_ptr<CollatorInterface> collator);
+                                      std::unique_ptr<CollatorInterface> collator,
+                                      bool materialized,
+                                      Timestamp refreshedAt);
     /**
      * Parses the view definition pipeline, attempts to upsert into the view graph, and refreshes
      * the graph if necessary. Returns an error status if the resulting graph would be invalid.
@@ -163,6 +185,8 @@ private:
                                      const std::vector<NamespaceString>& refs);
 
     std::shared_ptr<ViewDefinition> _lookup_inlock(OperationContext* opCtx, StringData ns);
+    StatusWith<ResolvedView> _resolveView_inlock(OperationContext* opCtx,
+                                                 const NamespaceString& nss);
     Status _reloadIfNeeded_inlock(OperationContext* opCtx);
 
     void _requireValidCatalog_inlock(OperationContext* opCtx) {
@@ -172,6 +196,10 @@ private:
 
     stdx::mutex _mutex;  // Protects all members, except for _valid.
     ViewMap _viewMap;
+
+    // Views resolved since the catalog last changed. Emptied by every change to '_viewMap', so an
+    // entry always matches the current definitions of the views it was resolved from.
+    StringMap<std::shared_ptr<const ResolvedView>> _resolvedViews;
     DurableViewCatalog* _durable;
     AtomicBool _valid;
     ViewGraph _viewGraph;
@@ -514,6 +514,161 @@ TEST_F(ViewCatalogFixture, ResolveViewCorrectPipeline) {
     }
 }
 
+TEST_F(ViewCatalogFixture, ResolveViewReflectsChangesToViewsItDependsOn) {
+    const NamespaceString innerView("db.innerView");
+    const NamespaceString outerView("db.outerView");
+    const NamespaceString viewOn("db.coll");
+    const auto innerStage = BSON("$match" << BSON("foo" << 1));
+    const auto outerStage = BSON("$match" << BSON("bar" << 1));
+    const auto modifiedStage = BSON("$match" << BSON("foo" << 2));
+
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(), innerView, viewOn, BSON_ARRAY(innerStage), emptyCollation));
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(), outerView, innerView, BSON_ARRAY(outerStage), emptyCollation));
+
+    // Resolving the same view twice gives the same result.
+    for (int i = 0; i < 2; i++) {
+        auto resolvedView = viewCatalog.resolveView(opCtx.get(), outerView);
+        ASSERT_OK(resolvedView.getStatus());
+        ASSERT_EQ(viewOn, resolvedView.getValue().getNamespace());
+        ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+        ASSERT_BSONOBJ_EQ(innerStage, resolvedView.getValue().getPipeline()[0]);
+    }
+
+    // Modifying the inner view changes how the outer view resolves.
+    ASSERT_OK(
+        viewCatalog.modifyView(opCtx.get(), innerView, viewOn, BSON_ARRAY(modifiedStage)));
+    auto resolvedView = viewCatalog.resolveView(opCtx.get(), outerView);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_BSONOBJ_EQ(modifiedStage, resolvedView.getValue().getPipeline()[0]);
+
+    // Once the inner view is dropped, the outer view is defined on a collection of that name.
+    ASSERT_OK(viewCatalog.dropView(opCtx.get(), innerView));
+    resolvedView = viewCatalog.resolveView(opCtx.get(), outerView);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(innerView, resolvedView.getValue().getNamespace());
+    ASSERT_EQ(1U, resolvedView.getValue().getPipeline().size());
+
+    // Reloading from the durable catalog, which holds no views here, leaves nothing to resolve.
+    viewCatalog.invalidate();
+    resolvedView = viewCatalog.resolveView(opCtx.get(), outerView);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(outerView, resolvedView.getValue().getNamespace());
+    ASSERT_EQ(0U, resolvedView.getValue().getPipeline().size());
+}
+
+TEST_F(ViewCatalogFixture, CreateMaterializedViewRequiresDecomposablePipeline) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString viewOn("db.coll");
+    const bool materialized = true;
+
+    ASSERT_EQ(ErrorCodes::OptionNotSupportedOnView,
+              viewCatalog.createView(opCtx.get(),
+                                     viewName,
+                                     viewOn,
+                                     BSON_ARRAY(BSON("$match" << BSON("x" << 1))),
+                                     emptyCollation,
+                                     materialized));
+    ASSERT_EQ(ErrorCodes::OptionNotSupportedOnView,
+              viewCatalog.createView(
+                  opCtx.get(),
+                  viewName,
+                  viewOn,
+                  BSON_ARRAY(BSON("$sort" << BSON("x" << 1))
+                             << BSON("$group" << BSON("_id"
+                                                      << "$a"
+                                                      << "n"
+                                                      << BSON("$sum" << 1)))),
+                  emptyCollation,
+                  materialized));
+    ASSERT_EQ(ErrorCodes::OptionNotSupportedOnView,
+              viewCatalog.createView(opCtx.get(),
+                                     viewName,
+                                     viewOn,
+                                     BSON_ARRAY(BSON("$group" << BSON("_id"
+                                                                      << "$a"
+                                                                      << "avg"
+                                                                      << BSON("$avg"
+                                                                              << "$x")))),
+                                     emptyCollation,
+                                     materialized));
+
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(),
+        viewName,
+        viewOn,
+        BSON_ARRAY(BSON("$match" << BSON("x" << BSON("$gt" << 0)))
+                   << BSON("$project" << BSON("a" << 1 << "x" << 1))
+                   << BSON("$group" << BSON("_id"
+                                            << "$a"
+                                            << "n"
+                                            << BSON("$sum" << 1)
+                                            << "total"
+                                            << BSON("$sum"
+                                                    << "$x")
+                                            << "lo"
+                                            << BSON("$min"
+                                                    << "$x")
+                                            << "hi"
+                                            << BSON("$max"
+                                                    << "$x")))),
+        emptyCollation,
+        materialized));
+}
+
+TEST_F(ViewCatalogFixture, ResolveMaterializedViewRunsPipelineUntilRefreshed) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString outerView("db.outerView");
+    const NamespaceString viewOn("db.coll");
+    const auto groupStage = BSON("$group" << BSON("_id"
+                                                  << "$a"
+                                                  << "n"
+                                                  << BSON("$sum" << 1)));
+    const auto matchStage = BSON("$match" << BSON("n" << BSON("$gt" << 1)));
+    const bool materialized = true;
+
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(), viewName, viewOn, BSON_ARRAY(groupStage), emptyCollation, materialized));
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(), outerView, viewName, BSON_ARRAY(matchStage), emptyCollation));
+
+    auto resolvedView = viewCatalog.resolveView(opCtx.get(), outerView);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(viewOn, resolvedView.getValue().getNamespace());
+    ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+
+    ASSERT_OK(viewCatalog.setRefreshedAt(opCtx.get(), viewName, Timestamp(1, 1)));
+    ASSERT_EQ(Timestamp(1, 1), viewCatalog.lookup(opCtx.get(), viewName.ns())->refreshedAt());
+
+    resolvedView = viewCatalog.resolveView(opCtx.get(), outerView);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(NamespaceString("db.system.materialized.view"),
+              resolvedView.getValue().getNamespace());
+    ASSERT_EQ(1U, resolvedView.getValue().getPipeline().size());
+    ASSERT_BSONOBJ_EQ(matchStage, resolvedView.getValue().getPipeline()[0]);
+
+    // Changing the pipeline makes the stored results unusable until they are recomputed.
+    ASSERT_OK(viewCatalog.modifyView(opCtx.get(), viewName, viewOn, BSON_ARRAY(groupStage)));
+    auto view = viewCatalog.lookup(opCtx.get(), viewName.ns());
+    ASSERT_TRUE(view->isMaterialized());
+    ASSERT_TRUE(view->refreshedAt().isNull());
+    resolvedView = viewCatalog.resolveView(opCtx.get(), outerView);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(viewOn, resolvedView.getValue().getNamespace());
+}
+
+TEST_F(ViewCatalogFixture, SetRefreshedAtRequiresMaterializedView) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString viewOn("db.coll");
+    ASSERT_EQ(ErrorCodes::NamespaceNotFound,
+              viewCatalog.setRefreshedAt(opCtx.get(), viewName, Timestamp(1, 1)));
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), viewName, viewOn, emptyPipeline, emptyCollation));
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              viewCatalog.setRefreshedAt(opCtx.get(), viewName, Timestamp(1, 1)));
+}
+
 TEST_F(ViewCatalogFixture, ResolveViewCorrectlyExtractsDefaultCollation) {
     const NamespaceString view1("db.view1");
     const NamespaceString view2("db.view2");
@@ -281,6 +281,32 @@ TEST_F(PlanExecutorTest, DropIndexScanAgg) {
         outerExec->getNext(&objOut, nullptr), AssertionException, ErrorCodes::QueryPlanKilled);
 }
 
+/**
+ * Test that results the executor buffered from a batch of work on the plan survive yields and are
+ * returned in order.
+ */
+TEST_F(PlanExecutorTest, BufferedResultsSurviveYields) {
+    OldClientWriteContext ctx(&_opCtx, nss.ns());
+    const int numDocs = 50;
+    for (int i = 1; i <= numDocs; ++i) {
+        insert(BSON("_id" << i << "a" << i));
+    }
+
+    BSONObj filterObj = fromjson("{_id: {$gt: 0}}");
+
+    Collection* coll = ctx.getCollection();
+    auto exec = makeCollScanExec(coll, filterObj);
+
+    BSONObj objOut;
+    for (int i = 1; i <= numDocs; ++i) {
+        ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&objOut, NULL));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i << "a" << i), objOut);
+        exec->saveState();
+        ASSERT_OK(exec->restoreState());
+    }
+    ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&objOut, NULL));
+}
+
 TEST_F(PlanExecutorTest, ShouldReportErrorIfExceedsTimeLimitDuringYield) {
     OldClientWriteContext ctx(&_opCtx, nss.ns());
     insert(BSON("_id" << 1));
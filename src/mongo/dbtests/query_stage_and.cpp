@@ -404,6 +404,13 @@ public:
         // foo == bar == baz, and foo<=20, bar>=10, so our values are:
         // foo == 10, 11, 12, 13, 14, 15. 16, 17, 18, 19, 20
         ASSERT_EQUALS(11, countResults(ah.get()));
+
+        // Each of the 40 results from the second child was checked against the filter, and the 29
+        // which are not in the first child were discarded either by the filter or the hash table.
+        const AndHashStats* stats = static_cast<const AndHashStats*>(ah->getSpecificStats());
+        ASSERT_EQUALS(40U, stats->filterTested);
+        ASSERT_EQUALS(29U, stats->filterRejected + stats->filterFalsePositives);
+        ASSERT_GT(stats->filterMemUsage, 0U);
     }
 };
 
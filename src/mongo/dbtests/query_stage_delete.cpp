@@ -41,7 +41,9 @@
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
@@ -60,7 +62,8 @@ static const NamespaceString nss("unittests.QueryStageDelete");
 
 class QueryStageDeleteBase {
 public:
-    QueryStageDeleteBase() : _client(&_opCtx) {
+    QueryStageDeleteBase()
+        : _deleteBatchSize(internalQueryExecDeleteBatchSize.load()), _client(&_opCtx) {
         OldClientWriteContext ctx(&_opCtx, nss.ns());
 
         for (size_t i = 0; i < numObj(); ++i) {
@@ -74,6 +77,7 @@ public:
     virtual ~QueryStageDeleteBase() {
         OldClientWriteContext ctx(&_opCtx, nss.ns());
         _client.dropCollection(nss.ns());
+        internalQueryExecDeleteBatchSize.store(_deleteBatchSize);
     }
 
     void remove(const BSONObj& obj) {
@@ -119,6 +123,7 @@ protected:
     OperationContext& _opCtx = *_txnPtr;
 
 private:
+    const int _deleteBatchSize;
     DBDirectClient _client;
 };
 
@@ -130,6 +135,10 @@ private:
 class QueryStageDeleteInvalidateUpcomingObject : public QueryStageDeleteBase {
 public:
     void run() {
+        // Delete one document per call to work(), so that the deletes can be interleaved with the
+        // invalidation.
+        internalQueryExecDeleteBatchSize.store(1);
+
         OldClientWriteContext ctx(&_opCtx, nss.ns());
 
         Collection* coll = ctx.getCollection();
@@ -304,6 +313,62 @@ public:
     }
 };
 
+/**
+ * Test that a multi delete buffers the documents from its child and deletes them in batches, and
+ * that each batch removes the documents' index keys.
+ */
+class QueryStageDeleteBatched : public QueryStageDeleteBase {
+public:
+    void run() {
+        const size_t batchSize = 8;
+        internalQueryExecDeleteBatchSize.store(batchSize);
+        ASSERT_OK(dbtests::createIndex(&_opCtx, nss.ns(), BSON("foo" << 1)));
+
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        Collection* coll = ctx.getCollection();
+        const unique_ptr<CanonicalQuery> cq(canonicalize(BSON("foo" << BSON("$gte" << 10))));
+
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+        deleteStageParams.canonicalQuery = cq.get();
+
+        WorkingSet ws;
+        DeleteStage deleteStage(&_opCtx,
+                                deleteStageParams,
+                                &ws,
+                                coll,
+                                new CollectionScan(&_opCtx, collScanParams, &ws, cq->root()));
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+
+            // Documents are deleted a whole batch at a time until the child runs out.
+            if (!deleteStage.isEOF() && supportsDocLocking()) {
+                ASSERT_EQUALS(0U, stats->docsDeleted % batchSize);
+            }
+        }
+
+        ASSERT_EQUALS(numObj() - 10, stats->docsDeleted);
+        ASSERT_EQUALS(10U, coll->numRecords(&_opCtx));
+
+        std::vector<IndexDescriptor*> indexes;
+        coll->getIndexCatalog()->findIndexesByKeyPattern(
+            &_opCtx, BSON("foo" << 1), false, &indexes);
+        ASSERT_EQUALS(1U, indexes.size());
+        int64_t numKeys;
+        ValidateResults results;
+        coll->getIndexCatalog()->getIndex(indexes[0])->validate(&_opCtx, &numKeys, &results);
+        ASSERT_EQUALS(10, numKeys);
+    }
+};
 
 class All : public Suite {
 public:
@@ -314,6 +379,7 @@ public:
         add<QueryStageDeleteInvalidateUpcomingObject>();
         add<QueryStageDeleteReturnOldDoc>();
         add<QueryStageDeleteSkipOwnedObjects>();
+        add<QueryStageDeleteBatched>();
     }
 };
 
@@ -199,6 +199,75 @@ TEST_F(QueryStageSubplanTest, QueryStageSubplanPlanFromCache) {
     ASSERT_FALSE(subplan->branchPlannedFromCache(1));
 }
 
+/**
+ * Ensure that $or branches of the same shape are planned once, and the later ones reuse the plan
+ * picked for the first.
+ */
+TEST_F(QueryStageSubplanTest, QueryStageSubplanSharesPlanAcrossBranchesOfSameShape) {
+    OldClientWriteContext ctx(opCtx(), nss.ns());
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("c" << 1));
+
+    for (int i = 0; i < 10; i++) {
+        insert(BSON("a" << 1 << "b" << i << "c" << i));
+    }
+
+    // The first two branches differ only in their constants.
+    BSONObj query = fromjson("{$or: [{a: 1, b: 3}, {a: 1, b: 4}, {c: 1}]}");
+
+    Collection* collection = ctx.getCollection();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(query);
+    auto statusWithCQ = CanonicalQuery::canonicalize(opCtx(), std::move(qr));
+    ASSERT_OK(statusWithCQ.getStatus());
+    std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+    // Get planner params.
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(opCtx(), collection, cq.get(), &plannerParams);
+
+    WorkingSet ws;
+    std::unique_ptr<SubplanStage> subplan(
+        new SubplanStage(opCtx(), collection, &ws, plannerParams, cq.get()));
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(subplan->pickBestPlan(&yieldPolicy));
+
+    ASSERT_FALSE(subplan->branchPlannedFromCache(0));
+    ASSERT_FALSE(subplan->branchSharedPlan(0));
+    ASSERT_FALSE(subplan->branchPlannedFromCache(1));
+    ASSERT_TRUE(subplan->branchSharedPlan(1));
+    ASSERT_FALSE(subplan->branchSharedPlan(2));
+
+    // The composite plan still returns the documents matching each branch.
+    size_t numResults = 0;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (state != PlanStage::IS_EOF) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        state = subplan->work(&id);
+        ASSERT_NE(state, PlanStage::DEAD);
+        ASSERT_NE(state, PlanStage::FAILURE);
+        if (state == PlanStage::ADVANCED) {
+            ++numResults;
+        }
+    }
+    ASSERT_EQ(numResults, 3U);
+
+    // Once the first branch's plan is cached, both branches of its shape are planned from the
+    // cache.
+    ws.clear();
+    subplan.reset(new SubplanStage(opCtx(), collection, &ws, plannerParams, cq.get()));
+
+    ASSERT_OK(subplan->pickBestPlan(&yieldPolicy));
+
+    ASSERT_TRUE(subplan->branchPlannedFromCache(0));
+    ASSERT_TRUE(subplan->branchPlannedFromCache(1));
+    ASSERT_FALSE(subplan->branchSharedPlan(1));
+}
+
 /**
  * Ensure that the subplan stage doesn't create a plan cache entry if there are no query results.
  */
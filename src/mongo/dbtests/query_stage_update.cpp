@@ -49,6 +49,7 @@
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/update/update_driver.h"
 #include "mongo/dbtests/dbtests.h"
@@ -64,7 +65,8 @@ static const NamespaceString nss("unittests.QueryStageUpdate");
 
 class QueryStageUpdateBase {
 public:
-    QueryStageUpdateBase() : _client(&_opCtx) {
+    QueryStageUpdateBase()
+        : _updateBatchSize(internalQueryExecUpdateBatchSize.load()), _client(&_opCtx) {
         OldClientWriteContext ctx(&_opCtx, nss.ns());
         _client.dropCollection(nss.ns());
         _client.createCollection(nss.ns());
@@ -73,6 +75,7 @@ public:
     virtual ~QueryStageUpdateBase() {
         OldClientWriteContext ctx(&_opCtx, nss.ns());
         _client.dropCollection(nss.ns());
+        internalQueryExecUpdateBatchSize.store(_updateBatchSize);
     }
 
     void insert(const BSONObj& doc) {
@@ -175,6 +178,7 @@ protected:
     OperationContext& _opCtx = *_txnPtr;
 
 private:
+    const int _updateBatchSize;
     DBDirectClient _client;
 };
 
@@ -248,6 +252,10 @@ public:
 class QueryStageUpdateSkipInvalidatedDoc : public QueryStageUpdateBase {
 public:
     void run() {
+        // Update one document per call to work(), so that the updates can be interleaved with the
+        // invalidation.
+        internalQueryExecUpdateBatchSize.store(1);
+
         // Run the update.
         {
             OldClientWriteContext ctx(&_opCtx, nss.ns());
@@ -606,6 +614,77 @@ public:
     }
 };
 
+/**
+ * Test that a multi-update buffers the documents from its child and updates them in batches.
+ */
+class QueryStageUpdateBatched : public QueryStageUpdateBase {
+public:
+    void run() {
+        const size_t batchSize = 4;
+        internalQueryExecUpdateBatchSize.store(batchSize);
+
+        {
+            OldClientWriteContext ctx(&_opCtx, nss.ns());
+
+            for (int i = 0; i < 30; ++i) {
+                insert(BSON("_id" << i << "foo" << i));
+            }
+
+            CurOp& curOp = *CurOp::get(_opCtx);
+            OpDebug* opDebug = &curOp.debug();
+            const CollatorInterface* collator = nullptr;
+            UpdateDriver driver(new ExpressionContext(&_opCtx, collator));
+            Collection* coll = ctx.db()->getCollection(&_opCtx, nss);
+
+            UpdateRequest request(nss);
+            UpdateLifecycleImpl updateLifecycle(nss);
+            request.setLifecycle(&updateLifecycle);
+
+            // Set 'bar' in every document where foo is less than 21.
+            BSONObj query = fromjson("{foo: {$lt: 21}}");
+            request.setMulti();
+            request.setQuery(query);
+            request.setUpdates(fromjson("{$set: {bar: 1}}"));
+
+            const std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+            ASSERT_OK(driver.parse(request.getUpdates(), arrayFilters, request.isMulti()));
+
+            CollectionScanParams collScanParams;
+            collScanParams.collection = coll;
+            collScanParams.direction = CollectionScanParams::FORWARD;
+            collScanParams.tailable = false;
+
+            UpdateStageParams updateParams(&request, &driver, opDebug);
+            unique_ptr<CanonicalQuery> cq(canonicalize(query));
+            updateParams.canonicalQuery = cq.get();
+
+            auto ws = make_unique<WorkingSet>();
+            auto cs = make_unique<CollectionScan>(&_opCtx, collScanParams, ws.get(), cq->root());
+            auto updateStage =
+                make_unique<UpdateStage>(&_opCtx, updateParams, ws.get(), coll, cs.release());
+            const UpdateStats* stats =
+                static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+            while (!updateStage->isEOF()) {
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                PlanStage::StageState state = updateStage->work(&id);
+                ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+
+                // Documents are updated a whole batch at a time until the child runs out.
+                if (!updateStage->isEOF() && supportsDocLocking()) {
+                    ASSERT_EQUALS(0U, stats->nModified % batchSize);
+                }
+            }
+
+            ASSERT_EQUALS(21U, stats->nMatched);
+            ASSERT_EQUALS(21U, stats->nModified);
+        }
+
+        ASSERT_EQUALS(21U, count(BSON("bar" << 1)));
+        ASSERT_EQUALS(9U, count(BSON("bar" << BSON("$exists" << false))));
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_update") {}
@@ -617,6 +696,7 @@ public:
         add<QueryStageUpdateReturnOldDoc>();
         add<QueryStageUpdateReturnNewDoc>();
         add<QueryStageUpdateSkipOwnedObjects>();
+        add<QueryStageUpdateBatched>();
     }
 };
 
@@ -955,6 +955,90 @@ public:
     }
 };
 
+template <bool full, bool background>
+class ValidateManyIndexes : public ValidateBase {
+public:
+    ValidateManyIndexes() : ValidateBase(full, background) {}
+
+    void run() {
+
+        // Can't do it in background is the RecordStore is not in RecordId order.
+        if (_background && !_isInRecordIdOrder) {
+            return;
+        }
+
+        // Create a new collection with more indexes than validate scans at once.
+        lockDb(MODE_X);
+        OpDebug* const nullOpDebug = nullptr;
+        Collection* coll;
+        RecordId id1;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            ASSERT_OK(_db->dropCollection(&_opCtx, _ns));
+            coll = _db->createCollection(&_opCtx, _ns);
+
+            for (int i = 0; i < 100; ++i) {
+                ASSERT_OK(coll->insertDocument(&_opCtx,
+                                               InsertStatement(BSON("_id" << i << "a" << i << "b"
+                                                                          << -i
+                                                                          << "c"
+                                                                          << BSON_ARRAY(i << i + 1)
+                                                                          << "d"
+                                                                          << (i % 7))),
+                                               nullOpDebug,
+                                               true));
+            }
+            id1 = coll->getCursor(&_opCtx)->next()->id;
+            wunit.commit();
+        }
+
+        const std::vector<BSONObj> keyPatterns = {BSON("a" << 1),
+                                                  BSON("b" << -1),
+                                                  BSON("c" << 1),
+                                                  BSON("d" << 1 << "a" << 1),
+                                                  BSON("a" << 1 << "b" << 1),
+                                                  BSON("d" << -1)};
+        for (size_t i = 0; i < keyPatterns.size(); ++i) {
+            auto status = dbtests::createIndexFromSpec(
+                &_opCtx,
+                coll->ns().ns(),
+                BSON("name" << ("index_" + std::to_string(i)) << "ns" << coll->ns().ns() << "key"
+                            << keyPatterns[i]
+                            << "v"
+                            << static_cast<int>(kIndexVersion)
+                            << "background"
+                            << false));
+            ASSERT_OK(status);
+        }
+
+        ASSERT_TRUE(checkValid());
+
+        lockDb(MODE_X);
+
+        // Remove a single entry from one of the indexes and check that it's noticed.
+        IndexCatalog* indexCatalog = coll->getIndexCatalog();
+        IndexDescriptor* descriptor = indexCatalog->findIndexByName(&_opCtx, "index_3");
+        IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
+
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            int64_t numDeleted;
+            InsertDeleteOptions options;
+            options.dupsAllowed = true;
+            options.logIfError = true;
+            auto removeStatus =
+                iam->remove(&_opCtx, BSON("d" << 0 << "a" << 0), id1, options, &numDeleted);
+
+            ASSERT_EQUALS(numDeleted, 1);
+            ASSERT_OK(removeStatus);
+            wunit.commit();
+        }
+
+        ASSERT_FALSE(checkValid());
+        releaseDb();
+    }
+};
+
 class ValidateTests : public Suite {
 public:
     ValidateTests() : Suite("validate_tests") {}
@@ -989,6 +1073,9 @@ public:
         add<ValidateIndexEntry<false, true>>();
         add<ValidateIndexOrdering<false, false>>();
         add<ValidateIndexOrdering<false, true>>();
+
+        add<ValidateManyIndexes<false, false>>();
+        add<ValidateManyIndexes<true, false>>();
     }
 } validateTests;
 }  // namespace ValidateTests
@@ -39,6 +39,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/embedded/embedded.h"
 #include "mongo/embedded/embedded_log_appender.h"
+#include "mongo/embedded/embedded_options.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event_utf8_encoder.h"
 #include "mongo/rpc/message.h"
@@ -46,6 +47,7 @@
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/shared_buffer.h"
 
@@ -379,6 +381,36 @@ void instance_destroy(mongo_embedded_v1_instance* const db, mongo_embedded_v1_st
     library->onlyDB = nullptr;
 }
 
+void instance_memory_usage(mongo_embedded_v1_instance* const db,
+                           mongo_embedded_v1_memory_usage* const usage,
+                           mongo_embedded_v1_status& status) {
+    if (!library) {
+        throw MobileException{MONGO_EMBEDDED_V1_ERROR_LIBRARY_NOT_INITIALIZED,
+                              "Cannot report memory usage when the MongoDB Embedded Library is "
+                              "not yet initialized."};
+    }
+
+    if (!db || db != library->onlyDB.get()) {
+        throw MobileException{MONGO_EMBEDDED_V1_ERROR_INVALID_DB_HANDLE,
+                              "Cannot report memory usage for the specified MongoDB Embedded "
+                              "Database, as it is not a valid instance."};
+    }
+
+    invariant(usage);
+
+    // ProcessInfo reports megabytes, and a negative or zero size where it isn't supported.
+    ProcessInfo processInfo;
+    const auto toBytes = [](int megabytes) -> uint64_t {
+        return megabytes > 0 ? static_cast<uint64_t>(megabytes) * 1024 * 1024 : 0;
+    };
+
+    mongo_embedded_v1_memory_usage result{};
+    result.resident_bytes = toBytes(processInfo.getResidentSize());
+    result.virtual_bytes = toBytes(processInfo.getVirtualMemorySize());
+    result.compact_memory_profile = embedded::embeddedParams.compactMemory ? 1 : 0;
+    *usage = result;
+}
+
 mongo_embedded_v1_client* client_new(mongo_embedded_v1_instance* const db,
                                      mongo_embedded_v1_status& status) {
     if (!library) {
@@ -593,6 +625,14 @@ int mongo_embedded_v1_instance_destroy(mongo_embedded_v1_instance* const db,
     });
 }
 
+int mongo_embedded_v1_instance_memory_usage(mongo_embedded_v1_instance* const db,
+                                            mongo_embedded_v1_memory_usage* const usage,
+                                            mongo_embedded_v1_status* const statusPtr) {
+    return enterCXX(statusPtr, [&](mongo_embedded_v1_status& status) {
+        return mongo::instance_memory_usage(db, usage, status);
+    });
+}
+
 mongo_embedded_v1_client* mongo_embedded_v1_client_create(
     mongo_embedded_v1_instance* const db, mongo_embedded_v1_status* const statusPtr) {
     return enterCXX(
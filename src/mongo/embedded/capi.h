@@ -563,6 +563,60 @@ mongo_embedded_v1_instance* mongo_embedded_v1_instance_create(mongo_embedded_v1_
 int mongo_embedded_v1_instance_destroy(mongo_embedded_v1_instance* instance,
                                        mongo_embedded_v1_status* status);
 
+/**
+ * A report of the memory used by the process hosting an Embedded MongoDB Server instance, filled in
+ * by `mongo_embedded_v1_instance_memory_usage`.
+ */
+typedef struct mongo_embedded_v1_memory_usage mongo_embedded_v1_memory_usage;
+
+// See the documentation of this object on the comments above its forward declaration
+struct mongo_embedded_v1_memory_usage {
+    /**
+     * Resident set size of the process, in bytes. Zero when the platform cannot report it.
+     */
+    uint64_t resident_bytes;
+
+    /**
+     * Virtual memory size of the process, in bytes. Zero when the platform cannot report it.
+     */
+    uint64_t virtual_bytes;
+
+    /**
+     * Nonzero when the instance was created with "embedded.memoryProfile: compact", which shrinks
+     * the caches, buffers and thread pools sized for servers.
+     */
+    int compact_memory_profile;
+};
+
+/**
+ * Reports the memory used by the process hosting an Embedded MongoDB Server instance.
+ *
+ * @pre The specified `instance` object must not be `NULL`.
+ * @pre The specified `instance` object must be a valid `mongo_embedded_v1_instance` object.
+ * @pre The specified `usage` object must not be `NULL`.
+ * @pre The specified `status` object must be either a valid `mongo_embedded_v1_status` object or
+ * `NULL`.
+ *
+ * @param instance The Embedded MongoDB Server instance to report on.
+ *
+ * @param usage A pointer to a `mongo_embedded_v1_memory_usage` object which will be filled in on
+ * success.
+ *
+ * @param status A pointer to a `mongo_embedded_v1_status` object which will not be modified unless
+ * this function reports a failure.
+ *
+ * @post Either `usage` will be filled in, or an error will be reported.
+ *
+ * @returns Returns `MONGO_EMBEDDED_V1_SUCCESS` on success.
+ * @returns Returns `MONGO_EMBEDDED_V1_ERROR_INVALID_DB_HANDLE` and modifies `status` if `instance`
+ * is not a valid instance.
+ *
+ * @invariant This function is completely threadsafe, as long as its preconditions are met.
+ */
+int mongo_embedded_v1_instance_memory_usage(mongo_embedded_v1_instance* instance,
+                                            mongo_embedded_v1_memory_usage* usage,
+                                            mongo_embedded_v1_status* status);
+
 /**
  * An object which represents "client connection" to an Embedded MongoDB Server.
  *
@@ -0,0 +1,222 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/embedded/capi.h"
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <iostream>
+#include <yaml-cpp/yaml.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_options.h"
+#include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/shared_buffer.h"
+#include "mongo/util/signal_handlers_synchronous.h"
+
+namespace mongo {
+namespace {
+
+const StringData kDbName = "capi_bm"_sd;
+
+mongo_embedded_v1_instance* globalInstance = nullptr;
+
+/**
+ * A client of the embedded instance that runs commands through the C API, the same way an
+ * application linking libmongo_embedded would.
+ */
+class CapiClient {
+public:
+    CapiClient() : _status(mongo_embedded_v1_status_create()) {
+        _client = mongo_embedded_v1_client_create(globalInstance, _status);
+        invariant(_client);
+    }
+
+    ~CapiClient() {
+        mongo_embedded_v1_client_destroy(_client, _status);
+        mongo_embedded_v1_status_destroy(_status);
+    }
+
+    BSONObj run(const BSONObj& cmd) {
+        auto request = OpMsgRequest::fromDBAndBody(kDbName, cmd).serialize();
+
+        void* output;
+        size_t outputSize;
+        int err = mongo_embedded_v1_client_invoke(
+            _client, request.buf(), request.size(), &output, &outputSize, _status);
+        invariant(err == MONGO_EMBEDDED_V1_SUCCESS);
+
+        auto sb = SharedBuffer::allocate(outputSize);
+        memcpy(sb.get(), output, outputSize);
+        BSONObj reply = OpMsg::parseOwned(Message(std::move(sb))).body;
+        invariant(reply["ok"].trueValue());
+        return reply;
+    }
+
+    void drop(StringData coll) {
+        // Ignore the result; the collection may not exist yet.
+        auto request = OpMsgRequest::fromDBAndBody(kDbName, BSON("drop" << coll)).serialize();
+        void* output;
+        size_t outputSize;
+        mongo_embedded_v1_client_invoke(
+            _client, request.buf(), request.size(), &output, &outputSize, _status);
+    }
+
+    void insert(StringData coll, long long firstId, int count) {
+        BSONArrayBuilder docs;
+        for (long long id = firstId; id < firstId + count; id++) {
+            docs.append(BSON("_id" << id << "device"
+                                   << "sensor"
+                                   << "reading"
+                                   << static_cast<double>(id % 1000)
+                                   << "seq"
+                                   << id));
+        }
+        run(BSON("insert" << coll << "documents" << docs.arr()));
+    }
+
+    void findById(StringData coll, long long id) {
+        BSONObj reply = run(BSON("find" << coll << "filter" << BSON("_id" << id) << "limit" << 1
+                                        << "singleBatch"
+                                        << true));
+        invariant(reply["cursor"]["firstBatch"].Obj().nFields() == 1);
+    }
+
+private:
+    mongo_embedded_v1_status* _status;
+    mongo_embedded_v1_client* _client;
+};
+
+// Inserts range(0) documents per insert command.
+void BM_Insert(benchmark::State& state) {
+    const int batchSize = state.range(0);
+    CapiClient client;
+    client.drop("insert");
+
+    long long nextId = 0;
+    for (auto keepRunning : state) {
+        client.insert("insert", nextId, batchSize);
+        nextId += batchSize;
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+void BM_FindById(benchmark::State& state) {
+    const int numDocs = 1000;
+    CapiClient client;
+    client.drop("find");
+    client.insert("find", 0, numDocs);
+
+    long long id = 0;
+    for (auto keepRunning : state) {
+        client.findById("find", id++ % numDocs);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Single-document inserts and point finds, where range(0) percent of the operations are inserts.
+void BM_InsertFindMix(benchmark::State& state) {
+    const int insertPercent = state.range(0);
+    CapiClient client;
+    client.drop("mix");
+    client.insert("mix", 0, 1);
+
+    long long numDocs = 1;
+    long long op = 0;
+    for (auto keepRunning : state) {
+        if (op++ % 100 < insertPercent) {
+            client.insert("mix", numDocs++, 1);
+        } else {
+            client.findById("mix", op % numDocs);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Insert)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_FindById);
+BENCHMARK(BM_InsertFindMix)->Arg(10)->Arg(50)->Arg(90);
+
+}  // namespace
+}  // namespace mongo
+
+// The embedded C API calls runGlobalInitializers() when the library is initialized, so this cannot
+// use the main() from benchmark_main.
+int main(int argc, char** argv) {
+    ::mongo::clearSignalMask();
+    ::mongo::setupSynchronousSignalHandlers();
+    ::mongo::serverGlobalParams.noUnixSocket = true;
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    mongo::unittest::TempDir tempDir("embedded_capi_bm");
+
+    YAML::Emitter yaml;
+    yaml << YAML::BeginMap;
+    yaml << YAML::Key << "storage";
+    yaml << YAML::Value << YAML::BeginMap;
+    yaml << YAML::Key << "dbPath";
+    yaml << YAML::Value << tempDir.path();
+    yaml << YAML::EndMap;  // storage
+    yaml << YAML::EndMap;
+
+    mongo_embedded_v1_init_params params;
+    params.log_flags = MONGO_EMBEDDED_V1_LOG_NONE;
+    params.log_callback = nullptr;
+    params.log_user_data = nullptr;
+    params.yaml_config = yaml.c_str();
+
+    mongo_embedded_v1_status* status = mongo_embedded_v1_status_create();
+    mongo_embedded_v1_lib* lib = mongo_embedded_v1_lib_init(&params, status);
+    if (!lib) {
+        std::cerr << "mongo_embedded_v1_lib_init() failed: "
+                  << mongo_embedded_v1_status_get_explanation(status) << std::endl;
+        return 1;
+    }
+
+    mongo::globalInstance = mongo_embedded_v1_instance_create(lib, yaml.c_str(), status);
+    if (!mongo::globalInstance) {
+        std::cerr << "mongo_embedded_v1_instance_create() failed: "
+                  << mongo_embedded_v1_status_get_explanation(status) << std::endl;
+        return 1;
+    }
+
+    ::benchmark::RunSpecifiedBenchmarks();
+
+    mongo_embedded_v1_instance_destroy(mongo::globalInstance, status);
+    mongo_embedded_v1_lib_fini(lib, status);
+    mongo_embedded_v1_status_destroy(status);
+    return 0;
+}
@@ -289,6 +289,51 @@ TEST_F(MongodbCAPITest, BatteryLevel) {
     performRpc(client, inputOpMsg);
 }
 
+TEST_F(MongodbCAPITest, MemoryUsage) {
+    auto getCacheSize = [this] {
+        auto client = createClient();
+        mongo::BSONObj inputObj = mongo::fromjson("{getParameter: 1, internalQueryCacheSize: 1}");
+        auto inputOpMsg = mongo::OpMsgRequest::fromDBAndBody("admin", inputObj);
+        return performRpc(client, inputOpMsg).getIntField("internalQueryCacheSize");
+    };
+    auto recreateDB = [this](const std::string& memoryProfile) {
+        ASSERT_EQUALS(mongo_embedded_v1_instance_destroy(db, status), MONGO_EMBEDDED_V1_SUCCESS);
+
+        YAML::Emitter yaml;
+        yaml << YAML::BeginMap;
+        yaml << YAML::Key << "storage" << YAML::Value << YAML::BeginMap;
+        yaml << YAML::Key << "dbPath" << YAML::Value << globalTempDir->path();
+        yaml << YAML::EndMap;  // storage
+        yaml << YAML::Key << "embedded" << YAML::Value << YAML::BeginMap;
+        yaml << YAML::Key << "memoryProfile" << YAML::Value << memoryProfile;
+        yaml << YAML::EndMap;  // embedded
+        yaml << YAML::EndMap;
+
+        db = mongo_embedded_v1_instance_create(lib, yaml.c_str(), status);
+        ASSERT(db != nullptr) << mongo_embedded_v1_status_get_explanation(status);
+    };
+
+    mongo_embedded_v1_memory_usage usage;
+    ASSERT_EQUALS(mongo_embedded_v1_instance_memory_usage(db, &usage, status),
+                  MONGO_EMBEDDED_V1_SUCCESS);
+    ASSERT_EQUALS(usage.compact_memory_profile, 0);
+    ASSERT_LTE(usage.resident_bytes, usage.virtual_bytes);
+    const int defaultCacheSize = getCacheSize();
+
+    // The compact profile shrinks the server parameters sized for servers.
+    recreateDB("compact");
+    ASSERT_EQUALS(mongo_embedded_v1_instance_memory_usage(db, &usage, status),
+                  MONGO_EMBEDDED_V1_SUCCESS);
+    ASSERT_EQUALS(usage.compact_memory_profile, 1);
+    ASSERT_LT(getCacheSize(), defaultCacheSize);
+
+    // A later instance with the default profile gets the original values back.
+    recreateDB("default");
+    ASSERT_EQUALS(getCacheSize(), defaultCacheSize);
+
+    ASSERT_EQUALS(mongo_embedded_v1_instance_memory_usage(nullptr, &usage, status),
+                  MONGO_EMBEDDED_V1_ERROR_INVALID_DB_HANDLE);
+}
 
 TEST_F(MongodbCAPITest, InsertDocument) {
     auto client = createClient();
@@ -32,16 +32,96 @@
 
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_options_helpers.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/util/log.h"
+#include "mongo/util/map_util.h"
 
 #include <boost/filesystem.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace mongo {
 namespace embedded {
 
 using std::string;
 
+EmbeddedParams embeddedParams;
+
+namespace {
+
+struct ParameterOverride {
+    StringData name;
+    StringData value;
+};
+
+// Server parameters changed by the compact memory profile. Parameters that aren't linked into this
+// library are skipped.
+const ParameterOverride kCompactMemoryParameters[] = {
+    // Caches kept for every collection and query shape.
+    {"internalQueryCacheSize"_sd, "100"_sd},
+    {"internalQueryGeoCoveringCacheSizeBytes"_sd, "1048576"_sd},
+
+    // Buffers for blocking sorts, index builds and aggregation stages.
+    {"internalQueryExecMaxBlockingSortBytes"_sd, "8388608"_sd},
+    {"maxIndexBuildMemoryUsageMegabytes"_sd, "100"_sd},
+    {"internalQueryFacetBufferSizeBytes"_sd, "8388608"_sd},
+    {"internalDocumentSourceLookupCacheSizeBytes"_sd, "8388608"_sd},
+    {"internalDocumentSourceGraphLookupMaxMemoryBytes"_sd, "8388608"_sd},
+
+    // Results buffered by open cursors.
+    {"internalDocumentSourceCursorBatchSizeBytes"_sd, "1048576"_sd},
+    {"cursorPrefetchBytes"_sd, "0"_sd},
+
+    // Thread pools, which all run on one thread.
+    {"cursorPrefetchThreads"_sd, "1"_sd},
+    {"dbHashCollectionThreads"_sd, "1"_sd},
+    {"indexBuildKeyGenerationThreads"_sd, "1"_sd},
+    {"mapReduceReduceThreads"_sd, "1"_sd},
+    {"startupRecoveryThreads"_sd, "1"_sd},
+    {"storageEngineCatalogLoadThreads"_sd, "1"_sd},
+    {"validateIndexScanThreads"_sd, "1"_sd},
+};
+
+// The values the compact memory profile replaced, so that an instance that is created later in the
+// same process with the default profile gets them back.
+std::vector<std::pair<ServerParameter*, BSONObj>> replacedParameterValues;
+
+Status applyCompactMemoryProfile() {
+    const auto& parameters = ServerParameterSet::getGlobal()->getMap();
+    for (const auto& entry : kCompactMemoryParameters) {
+        ServerParameter* parameter = mapFindWithDefault(
+            parameters, entry.name.toString(), static_cast<ServerParameter*>(nullptr));
+        if (!parameter) {
+            continue;
+        }
+
+        BSONObjBuilder previous;
+        parameter->append(nullptr, previous, entry.name.toString());
+        Status status = parameter->setFromString(entry.value.toString());
+        if (!status.isOK()) {
+            return status.withContext(str::stream() << "Cannot set \"" << entry.name
+                                                    << "\" for the compact memory profile");
+        }
+        replacedParameterValues.emplace_back(parameter, previous.obj());
+    }
+    return Status::OK();
+}
+
+Status restoreDefaultMemoryProfile() {
+    for (const auto& replaced : replacedParameterValues) {
+        Status status = replaced.first->set(replaced.second.firstElement());
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    replacedParameterValues.clear();
+    return Status::OK();
+}
+
+}  // namespace
+
 Status addOptions(optionenvironment::OptionSection* options) {
     moe::OptionSection general_options("General options");
 
@@ -82,8 +162,19 @@ Status addOptions(optionenvironment::OptionSection* options) {
                                       optionenvironment::String,
                                       "root directory for repair files - defaults to dbpath");
 
+    moe::OptionSection embedded_options("Embedded options");
+
+    embedded_options
+        .addOptionChaining("embedded.memoryProfile",
+                           "memoryProfile",
+                           moe::String,
+                           "size of caches, buffers and thread pools (default/compact)")
+        .format("(:?default)|(:?compact)", "(default/compact)")
+        .setDefault(optionenvironment::Value("default"));
+
     options->addSection(general_options).transitional_ignore();
     options->addSection(storage_options).transitional_ignore();
+    options->addSection(embedded_options).transitional_ignore();
 
     return Status::OK();
 }
@@ -170,6 +261,21 @@ Status storeOptions(const moe::Environment& params) {
         storageGlobalParams.repairpath = storageGlobalParams.dbpath;
     }
 
+    // Server parameters outlive the instance, so undo an earlier instance's profile first.
+    Status status = restoreDefaultMemoryProfile();
+    if (!status.isOK()) {
+        return status;
+    }
+    embeddedParams.compactMemory = params.count("embedded.memoryProfile") &&
+        params["embedded.memoryProfile"].as<std::string>() == "compact";
+    if (embeddedParams.compactMemory) {
+        status = applyCompactMemoryProfile();
+        if (!status.isOK()) {
+            return status;
+        }
+        log() << "Using the compact memory profile";
+    }
+
     return Status::OK();
 }
 
@@ -35,6 +35,14 @@
 namespace mongo {
 namespace embedded {
 
+struct EmbeddedParams {
+    // Set by "embedded.memoryProfile: compact". Shrinks the caches, buffers and thread pools that
+    // are sized for servers, for devices with only a few hundred megabytes of memory.
+    bool compactMemory = false;
+};
+
+extern EmbeddedParams embeddedParams;
+
 Status addOptions(optionenvironment::OptionSection* options);
 
 /**
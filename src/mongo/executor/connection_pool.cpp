@@ -35,6 +35,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/remote_command_request.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
@@ -43,11 +44,18 @@
 #include "mongo/util/scopeguard.h"
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the pool's lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
 // ourselves to operations over the connection).
+//
+// Locking is split in two levels. ConnectionPool::_mutex only guards the map
+// of specific pools, and is held just long enough to find (or create) the
+// pool for a host and lock it. Everything else, including the setup, refresh
+// and expiry callbacks, runs under the specific pool's own mutex, so requests
+// to different hosts don't contend with each other. When both are needed the
+// parent's mutex is always acquired first.
 
 namespace mongo {
 namespace executor {
@@ -68,7 +76,7 @@ public:
      *
      * The complexity comes from the need to hold a lock when writing to the
      * _activeClients param on the specific pool.  Because the code beneath the client needs to lock
-     * and unlock the parent mutex (and can leave unlocked), we want to start the client with the
+     * and unlock the pool's mutex (and can leave unlocked), we want to start the client with the
      * lock acquired, move it into the client, then re-acquire to decrement the counter on the way
      * out.
      *
@@ -78,8 +86,7 @@ public:
      */
     template <typename Callback>
     auto runWithActiveClient(Callback&& cb) {
-        return runWithActiveClient(stdx::unique_lock<stdx::mutex>(_parent->_mutex),
-                                   std::forward<Callback>(cb));
+        return runWithActiveClient(lock(), std::forward<Callback>(cb));
     }
 
     template <typename Callback>
@@ -90,7 +97,7 @@ public:
 
         const auto guard = MakeGuard([&] {
             invariant(!lk.owns_lock());
-            stdx::lock_guard<stdx::mutex> lk(_parent->_mutex);
+            auto decLk = lock();
             _activeClients--;
         });
 
@@ -104,8 +111,27 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Acquires this pool's mutex, counting the acquisitions that had to wait for another thread.
+     */
+    stdx::unique_lock<stdx::mutex> lock() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
+        if (!lk.owns_lock()) {
+            _contendedLockAcquisitions.fetchAndAdd(1);
+            lk.lock();
+        }
+        return lk;
+    }
+
+    /**
+     * Returns the number of times acquiring this pool's mutex had to wait.
+     */
+    size_t contendedLockAcquisitions() const {
+        return _contendedLockAcquisitions.load();
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock on this
+     * pool's _mutex
      */
     Future<ConnectionHandle> getConnection(const HostAndPort& hostAndPort,
                                            Milliseconds timeout,
@@ -119,8 +145,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock on this
+     * pool's _mutex
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -212,6 +238,10 @@ private:
 
     const HostAndPort _hostAndPort;
 
+    // Guards all of the state below. Acquire it through lock().
+    stdx::mutex _mutex;
+    AtomicUInt64 _contendedLockAcquisitions;
+
     LRUOwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -294,43 +324,41 @@ void ConnectionPool::shutdown() {
     // Ensure we decrement active clients for all pools that we inc on (because we intend to process
     // failures)
     const auto guard = MakeGuard([&] {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-
         for (const auto& pool : pools) {
+            auto lk = pool->lock();
             pool->decActiveClients(lk);
         }
     });
 
     // Grab all current pools (under the lock)
     {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
 
         for (auto& pair : _pools) {
             pools.push_back(pair.second.get());
-            pair.second->incActiveClients(lk);
+            auto poolLk = pair.second->lock();
+            pair.second->incActiveClients(poolLk);
         }
     }
 
     // Reacquire the lock per pool and process failures.  We'll dec active clients when we're all
     // through in the guard
     for (const auto& pool : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
         pool->processFailure(
             Status(ErrorCodes::ShutdownInProgress, "Shuting down the connection pool"),
-            std::move(lk));
+            pool->lock());
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lockPool(hostAndPort);
 
-    auto iter = _pools.find(hostAndPort);
-
-    if (iter == _pools.end())
+    if (!lk.second)
         return;
 
-    iter->second->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
-        iter->second->processFailure(
+    auto pool = lk.second;
+    pool->runWithActiveClient(std::move(lk.first), [&](stdx::unique_lock<stdx::mutex> lk) {
+        pool->processFailure(
             Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
             std::move(lk));
     });
@@ -342,21 +370,21 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     // Ensure we decrement active clients for all pools that we inc on (because we intend to process
     // failures)
     const auto guard = MakeGuard([&] {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-
         for (const auto& pool : pools) {
+            auto lk = pool->lock();
             pool->decActiveClients(lk);
         }
     });
 
     // Grab all current pools that don't match tags (under the lock)
     {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
 
         for (auto& pair : _pools) {
-            if (!pair.second->matchesTags(lk, tags)) {
+            auto poolLk = pair.second->lock();
+            if (!pair.second->matchesTags(poolLk, tags)) {
                 pools.push_back(pair.second.get());
-                pair.second->incActiveClients(lk);
+                pair.second->incActiveClients(poolLk);
             }
         }
     }
@@ -364,24 +392,21 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     // Reacquire the lock per pool and process failures.  We'll dec active clients when we're all
     // through in the guard
     for (const auto& pool : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
         pool->processFailure(
             Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
-            std::move(lk));
+            pool->lock());
     }
 }
 
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const stdx::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
+    auto lk = _lockPool(hostAndPort);
 
-    if (iter == _pools.end())
+    if (!lk.second)
         return;
 
-    iter->second->mutateTags(lk, mutateFunc);
+    lk.second->mutateTags(lk.first, mutateFunc);
 }
 
 void ConnectionPool::get(const HostAndPort& hostAndPort,
@@ -393,65 +418,84 @@ void ConnectionPool::get(const HostAndPort& hostAndPort,
 Future<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                              Milliseconds timeout) {
     SpecificPool* pool;
+    stdx::unique_lock<stdx::mutex> poolLk;
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    auto iter = _pools.find(hostAndPort);
+        auto iter = _pools.find(hostAndPort);
 
-    if (iter == _pools.end()) {
-        auto handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
-        pool = handle.get();
-        _pools[hostAndPort] = std::move(handle);
-    } else {
-        pool = iter->second.get();
-    }
+        if (iter == _pools.end()) {
+            auto handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
+            pool = handle.get();
+            _pools[hostAndPort] = std::move(handle);
+        } else {
+            pool = iter->second.get();
+        }
 
-    invariant(pool);
+        invariant(pool);
 
-    return pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
+        // Lock the specific pool before letting go of the map, so it can't be removed between
+        // the two.
+        poolLk = pool->lock();
+    }
+
+    return pool->runWithActiveClient(std::move(poolLk), [&](stdx::unique_lock<stdx::mutex> lk) {
         return pool->getConnection(hostAndPort, timeout, std::move(lk));
     });
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     for (const auto& kv : _pools) {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(lk),
-                                     pool->availableConnections(lk),
-                                     pool->createdConnections(lk),
-                                     pool->refreshingConnections(lk)};
+        auto poolLk = pool->lock();
+        ConnectionStatsPer hostStats{pool->inUseConnections(poolLk),
+                                     pool->availableConnections(poolLk),
+                                     pool->createdConnections(poolLk),
+                                     pool->refreshingConnections(poolLk)};
+        hostStats.contendedLockAcquisitions = pool->contendedLockAcquisitions();
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections(lk);
+    auto lk = _lockPool(hostAndPort);
+    if (lk.second) {
+        return lk.second->openConnections(lk.first);
     }
 
     return 0;
 }
 
 void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lockPool(conn->getHostAndPort());
 
-    auto iter = _pools.find(conn->getHostAndPort());
-
-    invariant(iter != _pools.end(),
+    invariant(lk.second,
               str::stream() << "Tried to return connection but no pool found for "
                             << conn->getHostAndPort());
 
-    iter->second->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
-        iter->second->returnConnection(conn, std::move(lk));
+    auto pool = lk.second;
+    pool->runWithActiveClient(std::move(lk.first), [&](stdx::unique_lock<stdx::mutex> lk) {
+        pool->returnConnection(conn, std::move(lk));
     });
 }
 
+std::pair<stdx::unique_lock<stdx::mutex>, ConnectionPool::SpecificPool*>
+ConnectionPool::_lockPool(const HostAndPort& hostAndPort) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto iter = _pools.find(hostAndPort);
+    if (iter == _pools.end()) {
+        return {stdx::unique_lock<stdx::mutex>(), nullptr};
+    }
+
+    return {iter->second->lock(), iter->second.get()};
+}
+
 ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort)
     : _parent(parent),
       _hostAndPort(hostAndPort),
@@ -807,7 +851,7 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+    auto lk = lock();
 
     // We're racing:
     //
@@ -830,9 +874,30 @@ void ConnectionPool::SpecificPool::shutdown() {
 
     _state = State::kInShutdown;
 
+    auto isBusy = [&] {
+        return _processingPool.size() || _droppedProcessingPool.size() || _activeClients;
+    };
+
     // If we have processing connections, wait for them to finish or timeout
     // before shutdown
-    if (_processingPool.size() || _droppedProcessingPool.size() || _activeClients) {
+    if (isBusy()) {
+        _requestTimer->setTimeout(Seconds(1), [this]() { shutdown(); });
+
+        return;
+    }
+
+    // Removing the pool needs the parent's mutex, which must be acquired before ours. Only take
+    // it now that the pool looks removable, and check again since a consumer may have come in
+    // while we held neither.
+    lk.unlock();
+    stdx::lock_guard<stdx::mutex> parentLk(_parent->_mutex);
+    lk.lock();
+
+    if (_state != State::kInShutdown) {
+        return;
+    }
+
+    if (isBusy()) {
         _requestTimer->setTimeout(Seconds(1), [this]() { shutdown(); });
 
         return;
@@ -841,6 +906,9 @@ void ConnectionPool::SpecificPool::shutdown() {
     invariant(_requests.empty());
     invariant(_checkedOutPool.empty());
 
+    // Nothing can reach this pool without going through the parent's mutex, which we hold, so it
+    // is safe to release our own before destroying it.
+    lk.unlock();
     _parent->_pools.erase(_hostAndPort);
 }
 
@@ -29,6 +29,7 @@
 
 #include <memory>
 #include <queue>
+#include <utility>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/executor/egress_tag_closer.h"
@@ -157,6 +158,13 @@ public:
 private:
     void returnConnection(ConnectionInterface* connection);
 
+    /**
+     * Returns the specific pool for 'hostAndPort' together with a lock on its mutex, or a null
+     * pool if there isn't one. The map of pools is only locked for the lookup.
+     */
+    std::pair<stdx::unique_lock<stdx::mutex>, SpecificPool*> _lockPool(
+        const HostAndPort& hostAndPort) const;
+
     std::string _name;
 
     // Options are set at startup and never changed at run time, so these are
@@ -165,7 +173,8 @@ private:
 
     const std::unique_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards the map of specific pools. Each specific pool has its own mutex for its state, which
+    // is acquired after this one when both are needed.
     mutable stdx::mutex _mutex;
     stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
 
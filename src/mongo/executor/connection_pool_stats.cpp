@@ -49,6 +49,7 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    contendedLockAcquisitions += other.contendedLockAcquisitions;
 
     return *this;
 }
@@ -66,6 +67,12 @@ void ConnectionPoolStats::updateStatsForHost(std::string pool,
     totalAvailable += newStats.available;
     totalCreated += newStats.created;
     totalRefreshing += newStats.refreshing;
+    totalContendedLockAcquisitions += newStats.contendedLockAcquisitions;
+}
+
+void ConnectionPoolStats::updateStatsForReactors(std::string pool,
+                                                 std::vector<ReactorStats> reactors) {
+    reactorsByPool[pool] = std::move(reactors);
 }
 
 void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
@@ -73,6 +80,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
     result.appendNumber("totalRefreshing", totalRefreshing);
+    result.appendNumber("totalContendedLockAcquisitions", totalContendedLockAcquisitions);
 
     {
         BSONObjBuilder poolBuilder(result.subobjStart("pools"));
@@ -83,6 +91,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            poolInfo.appendNumber("poolContendedLockAcquisitions",
+                                  poolStats.contendedLockAcquisitions);
             for (auto&& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
                 auto hostStats = host.second;
@@ -90,6 +100,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostInfo.appendNumber("contendedLockAcquisitions",
+                                      hostStats.contendedLockAcquisitions);
             }
         }
     }
@@ -102,6 +114,20 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostInfo.appendNumber("contendedLockAcquisitions", hostStats.contendedLockAcquisitions);
+        }
+    }
+    if (!reactorsByPool.empty()) {
+        BSONObjBuilder reactorsBuilder(result.subobjStart("reactors"));
+        for (auto&& pool : reactorsByPool) {
+            BSONArrayBuilder poolReactors(reactorsBuilder.subarrayStart(pool.first));
+            for (auto&& reactor : pool.second) {
+                BSONObjBuilder reactorInfo(poolReactors.subobjStart());
+                reactorInfo.appendNumber("scheduled", reactor.scheduled);
+                reactorInfo.appendNumber("queued", reactor.queued);
+                reactorInfo.appendNumber("totalQueuedMicros", reactor.totalQueuedMicros);
+                reactorInfo.appendNumber("maxQueuedMicros", reactor.maxQueuedMicros);
+            }
         }
     }
 }
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/net/hostandport.h"
 
@@ -49,6 +51,22 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+
+    // The number of times acquiring a specific pool's mutex had to wait for another thread.
+    size_t contendedLockAcquisitions = 0u;
+};
+
+/**
+ * Describes the load on one of the reactor threads that run a network interface's networking.
+ */
+struct ReactorStats {
+    // Tasks the network interface scheduled on the reactor, and how many of them haven't run yet.
+    size_t scheduled = 0u;
+    size_t queued = 0u;
+
+    // How long those tasks waited for the reactor's event loop to get to them.
+    long long totalQueuedMicros = 0;
+    long long maxQueuedMicros = 0;
 };
 
 /**
@@ -59,17 +77,24 @@ struct ConnectionStatsPer {
 struct ConnectionPoolStats {
     void updateStatsForHost(std::string pool, HostAndPort host, ConnectionStatsPer newStats);
 
+    /**
+     * Records the per-reactor load of the network interface behind 'pool', in reactor order.
+     */
+    void updateStatsForReactors(std::string pool, std::vector<ReactorStats> reactors);
+
     void appendToBSON(mongo::BSONObjBuilder& result);
 
     size_t totalInUse = 0u;
     size_t totalAvailable = 0u;
     size_t totalCreated = 0u;
     size_t totalRefreshing = 0u;
+    size_t totalContendedLockAcquisitions = 0u;
 
     stdx::unordered_map<std::string, ConnectionStatsPer> statsByPool;
     stdx::unordered_map<HostAndPort, ConnectionStatsPer> statsByHost;
     stdx::unordered_map<std::string, stdx::unordered_map<HostAndPort, ConnectionStatsPer>>
         statsByPoolHost;
+    stdx::unordered_map<std::string, std::vector<ReactorStats>> reactorsByPool;
 };
 
 }  // namespace executor
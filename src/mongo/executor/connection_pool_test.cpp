@@ -33,7 +33,9 @@
 
 #include "mongo/executor/connection_pool_test_fixture.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -333,6 +335,44 @@ TEST_F(ConnectionPoolTest, DifferentHostDifferentConn) {
     ASSERT_NE(conn1Id, conn2Id);
 }
 
+/**
+ * Verify that each host's pool reports its own connections, including its lock contention.
+ */
+TEST_F(ConnectionPoolTest, StatsArePerHost) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    std::vector<ConnectionPool::ConnectionHandle> connections;
+    for (auto host : {"localhost:30000", "localhost:30000", "localhost:30001"}) {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get(HostAndPort(host),
+                 Milliseconds(5000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+                     connections.push_back(std::move(swConn.getValue()));
+                 });
+    }
+    ASSERT_EQ(connections.size(), 3u);
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+    ASSERT_EQ(stats.totalInUse, 3u);
+    ASSERT_EQ(stats.statsByHost[HostAndPort("localhost:30000")].inUse, 2u);
+    ASSERT_EQ(stats.statsByHost[HostAndPort("localhost:30001")].inUse, 1u);
+
+    // Nothing else touched the pool concurrently.
+    ASSERT_EQ(stats.totalContendedLockAcquisitions, 0u);
+
+    BSONObjBuilder bob;
+    stats.appendToBSON(bob);
+    auto obj = bob.obj();
+    ASSERT(obj.hasField("totalContendedLockAcquisitions"));
+    ASSERT(obj["hosts"]["localhost:30000"].Obj().hasField("contendedLockAcquisitions"));
+
+    for (auto& conn : connections) {
+        doneWith(conn);
+    }
+}
+
 /**
  * Verify that not returning handle's to the pool spins up new connections.
  */
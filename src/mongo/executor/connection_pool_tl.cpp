@@ -215,16 +215,17 @@ size_t TLConnection::getGeneration() const {
 
 std::shared_ptr<ConnectionPool::ConnectionInterface> TLTypeFactory::makeConnection(
     const HostAndPort& hostAndPort, size_t generation) {
+    const auto& reactor = _reactors[_nextReactor.fetchAndAdd(1) % _reactors.size()];
     return std::make_shared<TLConnection>(
-        _reactor, getGlobalServiceContext(), hostAndPort, generation, _onConnectHook.get());
+        reactor, getGlobalServiceContext(), hostAndPort, generation, _onConnectHook.get());
 }
 
 std::unique_ptr<ConnectionPool::TimerInterface> TLTypeFactory::makeTimer() {
-    return std::make_unique<TLTimer>(_reactor);
+    return std::make_unique<TLTimer>(_reactors.front());
 }
 
 Date_t TLTypeFactory::now() {
-    return _reactor->now();
+    return _reactors.front()->now();
 }
 
 }  // namespace connection_pool_tl
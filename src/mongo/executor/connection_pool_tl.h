@@ -29,22 +29,31 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/client/async_client.h"
 #include "mongo/executor/connection_pool.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 namespace executor {
 namespace connection_pool_tl {
 
+/**
+ * Makes connections and timers for a ConnectionPool over a set of reactors. Pool timers run on the
+ * first reactor. Each new connection is pinned to the next reactor in turn, so its networking,
+ * and the completion of commands run over it, happens on that reactor's thread.
+ */
 class TLTypeFactory final : public ConnectionPool::DependentTypeFactoryInterface {
 public:
-    TLTypeFactory(transport::ReactorHandle reactor,
+    TLTypeFactory(std::vector<transport::ReactorHandle> reactors,
                   transport::TransportLayer* tl,
                   std::unique_ptr<NetworkConnectionHook> onConnectHook)
-        : _reactor(std::move(reactor)), _tl(tl), _onConnectHook(std::move(onConnectHook)) {}
+        : _reactors(std::move(reactors)), _tl(tl), _onConnectHook(std::move(onConnectHook)) {
+        invariant(!_reactors.empty());
+    }
 
     std::shared_ptr<ConnectionPool::ConnectionInterface> makeConnection(
         const HostAndPort& hostAndPort, size_t generation) override;
@@ -53,7 +62,8 @@ public:
     Date_t now() override;
 
 private:
-    transport::ReactorHandle _reactor;
+    const std::vector<transport::ReactorHandle> _reactors;
+    AtomicWord<unsigned> _nextReactor{0};
     transport::TransportLayer* _tl;
     std::unique_ptr<NetworkConnectionHook> _onConnectHook;
 };
@@ -91,6 +101,13 @@ public:
     bool isHealthy() override;
     AsyncDBClient* client();
 
+    /**
+     * Returns the reactor this connection is pinned to.
+     */
+    const transport::ReactorHandle& reactor() const {
+        return _reactor;
+    }
+
 private:
     void indicateUsed() override;
     Date_t getLastUsed() const override;
@@ -32,16 +32,35 @@
 
 #include "mongo/executor/network_interface_tl.h"
 
+#include <algorithm>
+#include <string>
+
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/connection_pool_tl.h"
 #include "mongo/transport/transport_layer_manager.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace executor {
+namespace {
+
+// The number of reactor threads each NetworkInterfaceTL runs its egress networking on.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(networkInterfaceTLReactorThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "networkInterfaceTLReactorThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+}  // namespace
 
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
@@ -69,6 +88,21 @@ void NetworkInterfaceTL::appendConnectionStats(ConnectionPoolStats* stats) const
     }();
     if (pool)
         pool->appendConnectionStats(stats);
+
+    std::vector<ReactorStats> reactors;
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& metrics : _reactorMetrics) {
+        ReactorStats reactorStats;
+        reactorStats.scheduled = metrics->scheduled.load();
+        reactorStats.queued = metrics->queued.load();
+        reactorStats.totalQueuedMicros = metrics->totalQueuedMicros.load();
+        reactorStats.maxQueuedMicros = metrics->maxQueuedMicros.load();
+        reactors.push_back(reactorStats);
+    }
+    if (!reactors.empty()) {
+        stats->updateStatsForReactors(std::string("NetworkInterfaceTL-") + _instanceName,
+                                      std::move(reactors));
+    }
 }
 
 NetworkInterface::Counters NetworkInterfaceTL::getCounters() const {
@@ -94,22 +128,33 @@ void NetworkInterfaceTL::startup() {
         _tl = _ownedTransportLayer.get();
     }
 
-    _reactor = _tl->getReactor(transport::TransportLayer::kNewReactor);
+    for (int i = 0; i < networkInterfaceTLReactorThreads; ++i) {
+        _reactors.push_back(_tl->getReactor(transport::TransportLayer::kNewReactor));
+        _reactorMetrics.push_back(std::make_unique<ReactorMetrics>());
+    }
+    _reactor = _reactors.front();
+
     auto typeFactory = std::make_unique<connection_pool_tl::TLTypeFactory>(
-        _reactor, _tl, std::move(_onConnectHook));
+        _reactors, _tl, std::move(_onConnectHook));
     _pool = std::make_unique<ConnectionPool>(
         std::move(typeFactory), std::string("NetworkInterfaceTL-") + _instanceName, _connPoolOpts);
-    _ioThread = stdx::thread([this] {
-        setThreadName(_instanceName);
-        LOG(2) << "The NetworkInterfaceTL reactor thread is spinning up";
-        _reactor->run();
-    });
+    for (size_t i = 0; i < _reactors.size(); ++i) {
+        _ioThreads.emplace_back([this, i] {
+            setThreadName(i ? _instanceName + "-" + std::to_string(i) : _instanceName);
+            LOG(2) << "The NetworkInterfaceTL reactor thread is spinning up";
+            _reactors[i]->run();
+        });
+    }
 }
 
 void NetworkInterfaceTL::shutdown() {
     _inShutdown.store(true);
-    _reactor->stop();
-    _ioThread.join();
+    for (auto& reactor : _reactors) {
+        reactor->stop();
+    }
+    for (auto& ioThread : _ioThreads) {
+        ioThread.join();
+    }
     _pool->shutdown();
     LOG(2) << "NetworkInterfaceTL shutdown successfully";
 }
@@ -199,7 +244,7 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
     // return on the reactor thread.
     //
     // TODO: get rid of this cruft once we have a connection pool that's executor aware.
-    auto connFuture = _reactor->execute([this, state, request, baton] {
+    auto getConn = [this, state, request, baton] {
         return makeReadyFutureWith(
                    [this, request] { return _pool->get(request.target, request.timeout); })
             .tapError([state](Status error) {
@@ -211,8 +256,14 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
 
                 // TODO: drop out this shared_ptr once we have a unique_function capable future
                 return std::make_shared<CommandState::ConnHandle>(
-                    conn.release(), CommandState::Deleter{deleter, _reactor});
+                    conn.release(), CommandState::Deleter{deleter, this});
             });
+    };
+
+    auto pf = makePromiseFuture<std::shared_ptr<CommandState::ConnHandle>>();
+    auto connFuture = std::move(pf.future);
+    _schedule(0, transport::Reactor::kPost, [ getConn, sp = pf.promise.share() ]() mutable {
+        sp.setWith(getConn);
     });
 
     auto remainingWork = [this, state, baton, onFinish](
@@ -295,7 +346,8 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
                                     << state->request.timeout);
         }
 
-        state->timer = _reactor->makeTimer();
+        // The timer runs on the connection's reactor, with the rest of the command's networking.
+        state->timer = tlconn->reactor()->makeTimer();
         state->timer->waitUntil(state->deadline, baton)
             .getAsync([this, client, state, baton](Status status) {
                 if (status == ErrorCodes::CallbackCanceled) {
@@ -368,6 +420,27 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
     return std::move(state->mergedFuture);
 }
 
+void NetworkInterfaceTL::_schedule(size_t index,
+                                   transport::Reactor::ScheduleMode mode,
+                                   transport::Reactor::Task task) {
+    auto metrics = _reactorMetrics[index].get();
+    metrics->scheduled.fetchAndAdd(1);
+    metrics->queued.fetchAndAdd(1);
+
+    _reactors[index]->schedule(mode, [ metrics, task = std::move(task), timer = Timer() ] {
+        const auto queuedMicros = timer.micros();
+        metrics->queued.subtractAndFetch(1);
+        metrics->totalQueuedMicros.fetchAndAdd(queuedMicros);
+        auto maxQueuedMicros = metrics->maxQueuedMicros.load();
+        while (queuedMicros > maxQueuedMicros) {
+            maxQueuedMicros =
+                metrics->maxQueuedMicros.compareAndSwap(maxQueuedMicros, queuedMicros);
+        }
+
+        task();
+    });
+}
+
 void NetworkInterfaceTL::_eraseInUseConn(const TaskExecutor::CallbackHandle& cbHandle) {
     stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
     _inProgress.erase(cbHandle);
@@ -414,7 +487,7 @@ Status NetworkInterfaceTL::setAlarm(Date_t when,
         if (baton) {
             baton->schedule(std::move(action));
         } else {
-            _reactor->schedule(transport::Reactor::kPost, std::move(action));
+            _schedule(0, transport::Reactor::kPost, std::move(action));
         }
         return Status::OK();
     }
@@ -453,7 +526,7 @@ Status NetworkInterfaceTL::setAlarm(Date_t when,
                 if (baton) {
                     baton->schedule(std::move(action));
                 } else {
-                    _reactor->schedule(transport::Reactor::kPost, std::move(action));
+                    _schedule(0, transport::Reactor::kPost, std::move(action));
                 }
             } else if (status != ErrorCodes::CallbackCanceled) {
                 warning() << "setAlarm() received an error: " << status;
@@ -463,7 +536,9 @@ Status NetworkInterfaceTL::setAlarm(Date_t when,
 }
 
 bool NetworkInterfaceTL::onNetworkThread() {
-    return _reactor->onReactorThread();
+    return std::any_of(_reactors.begin(), _reactors.end(), [](const auto& reactor) {
+        return reactor->onReactorThread();
+    });
 }
 
 void NetworkInterfaceTL::dropConnections(const HostAndPort& hostAndPort) {
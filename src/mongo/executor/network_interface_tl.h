@@ -29,11 +29,13 @@
 #pragma once
 
 #include <deque>
+#include <vector>
 
 #include "mongo/client/async_client.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/connection_pool.h"
 #include "mongo/executor/network_interface.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/rpc/metadata/metadata_hook.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/stdx/unordered_map.h"
@@ -90,11 +92,12 @@ private:
 
         struct Deleter {
             ConnectionPool::ConnectionHandleDeleter returner;
-            transport::ReactorHandle reactor;
+            NetworkInterfaceTL* interface;
 
             void operator()(ConnectionPool::ConnectionInterface* ptr) const {
-                reactor->schedule(transport::Reactor::kDispatch,
-                                  [ ret = returner, ptr ] { ret(ptr); });
+                interface->_schedule(0,
+                                     transport::Reactor::kDispatch,
+                                     [ ret = returner, ptr ] { ret(ptr); });
             }
         };
         using ConnHandle = std::unique_ptr<ConnectionPool::ConnectionInterface, Deleter>;
@@ -107,6 +110,23 @@ private:
         Future<RemoteCommandResponse> mergedFuture = promise.getFuture();
     };
 
+    /**
+     * Load counters for one of the reactors, updated by _schedule().
+     */
+    struct ReactorMetrics {
+        AtomicUInt64 scheduled;
+        AtomicInt64 queued;
+        AtomicInt64 totalQueuedMicros;
+        AtomicInt64 maxQueuedMicros;
+    };
+
+    /**
+     * Schedules 'task' on the reactor at 'index', counting it in that reactor's metrics.
+     */
+    void _schedule(size_t index,
+                   transport::Reactor::ScheduleMode mode,
+                   transport::Reactor::Task task);
+
     void _eraseInUseConn(const TaskExecutor::CallbackHandle& handle);
     Future<RemoteCommandResponse> _onAcquireConn(std::shared_ptr<CommandState> state,
                                                  CommandState::ConnHandle conn,
@@ -117,7 +137,12 @@ private:
     transport::TransportLayer* _tl;
     // Will be created if ServiceContext is null, or if no TransportLayer was configured at startup
     std::unique_ptr<transport::TransportLayer> _ownedTransportLayer;
+
+    // The connection pool and alarms run on the first reactor, which _reactor also refers to.
+    // Connections are spread over all of them.
     transport::ReactorHandle _reactor;
+    std::vector<transport::ReactorHandle> _reactors;
+    std::vector<std::unique_ptr<ReactorMetrics>> _reactorMetrics;
 
     mutable stdx::mutex _mutex;
     ConnectionPool::Options _connPoolOpts;
@@ -127,7 +152,7 @@ private:
 
     std::unique_ptr<rpc::EgressMetadataHook> _metadataHook;
     AtomicBool _inShutdown;
-    stdx::thread _ioThread;
+    std::vector<stdx::thread> _ioThreads;
 
     stdx::mutex _inProgressMutex;
     stdx::unordered_map<TaskExecutor::CallbackHandle, std::shared_ptr<CommandState>> _inProgress;
@@ -743,6 +743,53 @@ TEST(IDLNestedStruct, TestDuplicateTypes) {
     }
 }
 
+// Positive: Unowned string fields point into the parsed document instead of copying it
+TEST(IDLUnownedTests, TestUnownedFields) {
+    IDLParserErrorContext ctxt("root");
+
+    auto testDoc = BSON("field1"
+                        << "Foo"
+                        << "field2"
+                        << "Bar"
+                        << "field3"
+                        << BSON_ARRAY("Baz"
+                                      << "???"));
+    auto testStruct = Unowned_fields::parse(ctxt, testDoc);
+
+    assert_same_types<decltype(testStruct.getField1()), const StringData>();
+    assert_same_types<decltype(testStruct.getField2()), const boost::optional<StringData>>();
+    assert_same_types<decltype(testStruct.getField3()), const std::vector<StringData>>();
+
+    ASSERT_EQUALS("Foo", testStruct.getField1());
+    ASSERT_EQUALS(testDoc["field1"].valueStringData().rawData(),
+                  testStruct.getField1().rawData());
+    ASSERT_EQUALS("Bar", testStruct.getField2().get());
+    ASSERT_EQUALS(testDoc["field2"].valueStringData().rawData(),
+                  testStruct.getField2()->rawData());
+    std::vector<StringData> field3{"Baz", "???"};
+    ASSERT_TRUE(field3 == testStruct.getField3());
+    ASSERT_EQUALS(testDoc["field3"].Obj().firstElement().valueStringData().rawData(),
+                  testStruct.getField3()[0].rawData());
+
+    // Positive: Test we can roundtrip from the just parsed document
+    {
+        BSONObjBuilder builder;
+        testStruct.serialize(&builder);
+        ASSERT_BSONOBJ_EQ(testDoc, builder.obj());
+    }
+
+    // Positive: Test we can serialize from nothing the same document
+    {
+        BSONObjBuilder builder;
+        Unowned_fields unownedFields;
+        unownedFields.setField1("Foo");
+        unownedFields.setField2(StringData("Bar"));
+        unownedFields.setField3(field3);
+        unownedFields.serialize(&builder);
+        ASSERT_BSONOBJ_EQ(testDoc, builder.obj());
+    }
+}
+
 // Positive: Arrays of simple types
 TEST(IDLArrayTests, TestSimpleArrays) {
     IDLParserErrorContext ctxt("root");
@@ -45,7 +45,8 @@
 namespace mongo {
 namespace {
 
-auto kAllSupportedFlags = OpMsg::kChecksumPresent | OpMsg::kMoreToCome;
+auto kAllSupportedFlags =
+    OpMsg::kChecksumPresent | OpMsg::kMoreToCome | OpMsg::kExhaustSupported;
 
 bool containsUnknownRequiredFlags(uint32_t flags) {
     const uint32_t kRequiredFlagMask = 0xffff;  // Low 2 bytes are required, high 2 are optional.
@@ -158,8 +159,19 @@ OpMsg OpMsg::parse(const Message& message) try {
     throw;
 }
 
+int OpMsg::serializedSize() const {
+    int size = sizeof(MSGHEADER::Layout) + sizeof(uint32_t);  // header and flags.
+    for (auto&& seq : sequences) {
+        size += sizeof(Section) + sizeof(int32_t) + seq.name.size() + 1;
+        for (auto&& obj : seq.objs) {
+            size += obj.objsize();
+        }
+    }
+    return size + sizeof(Section) + body.objsize();
+}
+
 Message OpMsg::serialize() const {
-    OpMsgBuilder builder;
+    OpMsgBuilder builder(serializedSize());
     for (auto&& seq : sequences) {
         auto docSeq = builder.beginDocSequence(seq.name);
         for (auto&& obj : seq.objs) {
@@ -46,6 +46,9 @@ struct OpMsg {
 
     static constexpr uint32_t kChecksumPresent = 1 << 0;
     static constexpr uint32_t kMoreToCome = 1 << 1;
+    // Set by a client on a find or getMore to let the server stream the following batches as
+    // kMoreToCome replies, without waiting for a getMore for each of them.
+    static constexpr uint32_t kExhaustSupported = 1 << 16;
 
     /**
      * Returns the unvalidated flags for the given message if it is an OP_MSG message.
@@ -87,6 +90,11 @@ struct OpMsg {
 
     Message serialize() const;
 
+    /**
+     * Returns the exact number of bytes serialize() will produce, including the message header.
+     */
+    int serializedSize() const;
+
     /**
      * Makes all BSONObjs in this object share ownership with buffer.
      */
@@ -165,6 +173,16 @@ public:
         skipHeaderAndFlags();
     }
 
+    /**
+     * Constructs a builder whose buffer is sized to hold 'initialCapacity' bytes up front. Callers
+     * that know the size of the finished message (see OpMsg::serialize()) should use this so that
+     * the message is built in a single allocation, without reallocating and copying the documents
+     * already appended each time the buffer grows.
+     */
+    explicit OpMsgBuilder(int initialCapacity) : _buf(initialCapacity) {
+        skipHeaderAndFlags();
+    }
+
     /**
      * See the documentation for DocSequenceBuilder below.
      */
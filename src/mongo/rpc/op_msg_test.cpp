@@ -694,6 +694,27 @@ TEST(OpMsgSerializer, BodyAndTwoSequences) {
                    });
 }
 
+TEST(OpMsgSerializer, SerializesIntoExactlySizedBuffer) {
+    OpMsg msg;
+    msg.body = fromjson("{insert: 'coll'}");
+    msg.sequences = {
+        {"empty", {}},  //
+        {"documents", {}},
+    };
+    for (int i = 0; i < 1000; i++) {
+        msg.sequences[1].objs.push_back(BSON("_id" << i << "str" << std::string(100, 'x')));
+    }
+
+    auto message = msg.serialize();
+    ASSERT_EQ(message.size(), msg.serializedSize());
+    ASSERT_EQ(message.sharedBuffer().capacity(), size_t(msg.serializedSize()));
+
+    auto parsed = OpMsg::parseOwned(message);
+    ASSERT_BSONOBJ_EQ(parsed.body, msg.body);
+    ASSERT_EQ(parsed.sequences.size(), 2u);
+    ASSERT_EQ(parsed.sequences[1].objs.size(), 1000u);
+}
+
 TEST(OpMsgSerializer, BodyAndSequenceInPlace) {
     OpMsgBuilder builder;
 
@@ -33,11 +33,15 @@
 #include "mongo/s/async_requests_sender.h"
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/client/replica_set_monitor.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/killcursors_request.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/host_latency_tracker.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/transport_layer.h"
@@ -49,11 +53,52 @@ namespace mongo {
 
 MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderUseBaton, bool, true);
 
+// Whether reads with a read preference other than primary are hedged to a second host.
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderHedgeReads, bool, false);
+
+// The minimum time a read is outstanding before it is hedged, whatever the shard's latency.
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderHedgeMinDelayMillis, int, 5)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "AsyncRequestsSenderHedgeMinDelayMillis must be non-negative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+/**
+ * Makes a best-effort attempt to kill the cursor, if any, which the command answered by
+ * 'responseData' opened on 'host'.
+ */
+void killCursorFromResponse(executor::TaskExecutor* executor,
+                            const HostAndPort& host,
+                            const BSONObj& responseData) {
+    if (!responseData.hasField("cursor")) {
+        return;
+    }
+
+    auto swCursorResponse = CursorResponse::parseFromBSON(responseData);
+    if (!swCursorResponse.isOK() || swCursorResponse.getValue().getCursorId() == 0) {
+        return;
+    }
+
+    const auto& nss = swCursorResponse.getValue().getNSS();
+    BSONObj cmdObj = KillCursorsRequest(nss, {swCursorResponse.getValue().getCursorId()}).toBSON();
+    executor::RemoteCommandRequest request(host, nss.db().toString(), cmdObj, nullptr);
+
+    // We do not process the response to the killCursors request (we make a good-faith attempt at
+    // cleaning up the cursor, but ignore any returned errors).
+    executor
+        ->scheduleRemoteCommand(
+            request, [](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {})
+        .status_with_transitional_ignore();
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -67,7 +112,9 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
       _baton(opCtx),
       _db(dbName.toString()),
       _readPreference(readPreference),
-      _retryPolicy(retryPolicy) {
+      _retryPolicy(retryPolicy),
+      _hedgeReads(AsyncRequestsSenderHedgeReads.load() &&
+                  readPreference.pref != ReadPreference::PrimaryOnly) {
     for (const auto& request : requests) {
         _remotes.emplace_back(request.shardId, request.cmdObj);
     }
@@ -113,8 +160,29 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() {
     return *readyResponse;
 }
 
+void AsyncRequestsSender::addRequests(const std::vector<AsyncRequestsSender::Request>& requests) {
+    for (const auto& request : requests) {
+        _remotes.emplace_back(request.shardId, request.cmdObj);
+
+        // Requests made after an interruption fail straight away, like the canceled ones did.
+        if (!_interruptStatus.isOK()) {
+            _remotes.back().swResponse = _interruptStatus;
+        }
+    }
+
+    if (_interruptStatus.isOK()) {
+        invariant(!_stopRetrying);
+        _scheduleRequests();
+    }
+}
+
 void AsyncRequestsSender::stopRetrying() {
     _stopRetrying = true;
+
+    // Hedging sends new requests as well, so stop that too.
+    for (auto& remote : _remotes) {
+        remote.hedgeDeadline = boost::none;
+    }
 }
 
 bool AsyncRequestsSender::done() {
@@ -123,13 +191,16 @@ bool AsyncRequestsSender::done() {
 }
 
 void AsyncRequestsSender::_cancelPendingRequests() {
-    _stopRetrying = true;
+    stopRetrying();
 
     // Cancel all outstanding requests so they return immediately.
     for (auto& remote : _remotes) {
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
     }
 }
 
@@ -145,24 +216,31 @@ boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
 
     // Check if any remote is ready.
     invariant(!_remotes.empty());
-    for (auto& remote : _remotes) {
-        if (remote.swResponse && !remote.done) {
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        auto& remote = _remotes[i];
+
+        // Wait for the callback of a canceled hedged request before returning the response.
+        if (remote.swResponse && !remote.done && !remote.hasPendingRequest()) {
             remote.done = true;
-            if (remote.swResponse->isOK()) {
-                invariant(remote.shardHostAndPort);
-                return Response(std::move(remote.shardId),
-                                std::move(remote.swResponse->getValue()),
-                                std::move(*remote.shardHostAndPort));
-            } else {
-                // If _interruptStatus is set, promote CallbackCanceled errors to it.
-                if (!_interruptStatus.isOK() &&
-                    ErrorCodes::CallbackCanceled == remote.swResponse->getStatus().code()) {
-                    remote.swResponse = _interruptStatus;
+            auto response = [&] {
+                if (remote.swResponse->isOK()) {
+                    invariant(remote.shardHostAndPort);
+                    return Response(std::move(remote.shardId),
+                                    std::move(remote.swResponse->getValue()),
+                                    std::move(*remote.shardHostAndPort));
+                } else {
+                    // If _interruptStatus is set, promote CallbackCanceled errors to it.
+                    if (!_interruptStatus.isOK() &&
+                        ErrorCodes::CallbackCanceled == remote.swResponse->getStatus().code()) {
+                        remote.swResponse = _interruptStatus;
+                    }
+                    return Response(std::move(remote.shardId),
+                                    std::move(remote.swResponse->getStatus()),
+                                    std::move(remote.shardHostAndPort));
                 }
-                return Response(std::move(remote.shardId),
-                                std::move(remote.swResponse->getStatus()),
-                                std::move(remote.shardHostAndPort));
-            }
+            }();
+            response.requestIndex = i;
+            return response;
         }
     }
     // No remotes were ready.
@@ -177,7 +255,7 @@ void AsyncRequestsSender::_scheduleRequests() {
 
         // First check if the remote had a retriable error, and if so, clear its response field so
         // it will be retried.
-        if (remote.swResponse && !remote.done) {
+        if (remote.swResponse && !remote.done && !remote.hasPendingRequest()) {
             // We check both the response status and command status for a retriable error.
             Status status = remote.swResponse->getStatus();
             if (status.isOK()) {
@@ -209,7 +287,7 @@ void AsyncRequestsSender::_scheduleRequests() {
         }
 
         // If the remote does not have a response or pending request, schedule remote work for it.
-        if (!remote.swResponse && !remote.cbHandle.isValid()) {
+        if (!remote.swResponse && !remote.hasPendingRequest()) {
             auto scheduleStatus = _scheduleRequest(i);
             if (!scheduleStatus.isOK()) {
                 remote.swResponse = std::move(scheduleStatus);
@@ -224,6 +302,12 @@ void AsyncRequestsSender::_scheduleRequests() {
                 _responseQueue.push(boost::none);
             }
         }
+
+        // If the request has been outstanding past its hedge deadline, hedge it.
+        if (remote.hedgeDeadline && !remote.swResponse && Date_t::now() >= *remote.hedgeDeadline) {
+            remote.hedgeDeadline = boost::none;
+            _scheduleHedgedRequest(i);
+        }
     }
 }
 
@@ -238,6 +322,15 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
         return resolveStatus;
     }
 
+    // When hedging, prefer the eligible host with the lowest observed latency over the host
+    // chosen by the targeter.
+    if (_hedgeReads) {
+        auto hosts = _getEligibleHosts(remote);
+        if (!hosts.empty()) {
+            remote.shardHostAndPort = std::move(hosts.front());
+        }
+    }
+
     executor::RemoteCommandRequest request(
         *remote.shardHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
 
@@ -249,7 +342,7 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
                 _baton->schedule([this] { _batonRequests--; });
             }
 
-            _responseQueue.push(Job{cbData, remoteIndex});
+            _responseQueue.push(Job{cbData, remoteIndex, false});
         },
         _baton);
     if (!callbackStatus.isOK()) {
@@ -257,21 +350,118 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    remote.hedgeDeadline = boost::none;
+
+    if (_hedgeReads) {
+        auto percentile95 = HostLatencyTracker::get(_opCtx->getServiceContext())
+                                .getLatencyPercentile95(remote.shardId);
+        if (percentile95) {
+            remote.hedgeDeadline = Date_t::now() +
+                std::max(*percentile95,
+                         Milliseconds(AsyncRequestsSenderHedgeMinDelayMillis.load()));
+        }
+    }
+
     return Status::OK();
 }
 
+void AsyncRequestsSender::_scheduleHedgedRequest(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    invariant(remote.cbHandle.isValid());
+    invariant(!remote.hedgeCbHandle.isValid());
+
+    auto hosts = _getEligibleHosts(remote);
+    auto it = std::find_if(hosts.begin(), hosts.end(), [&](const HostAndPort& host) {
+        return host != *remote.shardHostAndPort;
+    });
+    if (it == hosts.end()) {
+        return;
+    }
+
+    executor::RemoteCommandRequest request(*it, _db, remote.cmdObj, _metadataObj, _opCtx);
+
+    auto callbackStatus = _executor->scheduleRemoteCommand(
+        request,
+        [remoteIndex, this](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+            if (_baton) {
+                _batonRequests++;
+                _baton->schedule([this] { _batonRequests--; });
+            }
+
+            _responseQueue.push(Job{cbData, remoteIndex, true});
+        },
+        _baton);
+    if (!callbackStatus.isOK()) {
+        // The original request is still outstanding, so carry on without the hedge.
+        LOG(1) << "Failed to hedge command to remote " << remote.shardId << " at host " << *it
+               << causedBy(redact(callbackStatus.getStatus()));
+        return;
+    }
+
+    LOG(2) << "Hedging command to remote " << remote.shardId << " at host "
+           << *remote.shardHostAndPort << " to host " << *it;
+
+    remote.hedgeCbHandle = callbackStatus.getValue();
+}
+
+std::vector<HostAndPort> AsyncRequestsSender::_getEligibleHosts(RemoteData& remote) {
+    const auto shard = remote.getShard();
+    if (!shard) {
+        return {};
+    }
+
+    const auto connStr = shard->getConnString();
+    if (connStr.type() != ConnectionString::SET) {
+        return {};
+    }
+
+    const auto rsm = ReplicaSetMonitor::get(connStr.getSetName());
+    if (!rsm) {
+        return {};
+    }
+
+    return HostLatencyTracker::get(_opCtx->getServiceContext())
+        .orderByLatency(rsm->getMatchingHosts(_readPreference));
+}
+
+boost::optional<Date_t> AsyncRequestsSender::_nextHedgeDeadline() const {
+    boost::optional<Date_t> deadline;
+    for (const auto& remote : _remotes) {
+        if (remote.hedgeDeadline && (!deadline || *remote.hedgeDeadline < *deadline)) {
+            deadline = remote.hedgeDeadline;
+        }
+    }
+    return deadline;
+}
+
 // Passing opCtx means you'd like to opt into opCtx interruption.  During cleanup we actually don't.
 void AsyncRequestsSender::_makeProgress(OperationContext* opCtx) {
     invariant(!opCtx || opCtx == _opCtx);
 
     boost::optional<Job> job;
 
+    // Stop waiting when the next request is due to be hedged.
+    const auto hedgeDeadline = _nextHedgeDeadline();
+
     if (_baton) {
         // If we're using a baton, we peek the queue, and block on the baton if it's empty
         if (boost::optional<boost::optional<Job>> tryJob = _responseQueue.tryPop()) {
             job = std::move(*tryJob);
         } else {
-            _baton->run(opCtx, boost::none);
+            _baton->run(opCtx, hedgeDeadline);
+        }
+    } else if (hedgeDeadline) {
+        try {
+            job = opCtx ? _responseQueue.pop(opCtx, *hedgeDeadline)
+                        : _responseQueue.pop(*hedgeDeadline);
+        } catch (const ExceptionFor<ErrorCodes::ExceededTimeLimit>&) {
+            // The wait times out with the same error as an expired operation deadline, so check
+            // for the latter before treating this as the hedge deadline passing.
+            if (opCtx) {
+                opCtx->checkForInterrupt();
+            }
+            return;
         }
     } else {
         // Otherwise we block on the queue
@@ -283,17 +473,51 @@ void AsyncRequestsSender::_makeProgress(OperationContext* opCtx) {
     }
 
     auto& remote = _remotes[job->remoteIndex];
-    invariant(!remote.swResponse);
+    const auto& host = job->cbData.request.target;
 
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
-    // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    // 'host'.
+    if (job->hedged) {
+        remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+    } else {
+        remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    auto& response = job->cbData.response;
+    if (_hedgeReads && response.status.isOK() && response.elapsedMillis) {
+        HostLatencyTracker::get(_opCtx->getServiceContext())
+            .recordLatency(remote.shardId, host, *response.elapsedMillis);
+    }
+
+    // The response to a request whose counterpart has already answered is dropped. Canceling the
+    // losing request does not stop a command which already ran, so if it opened a cursor, kill it
+    // rather than leave it open on the host until it times out.
+    if (remote.swResponse) {
+        if (response.status.isOK()) {
+            killCursorFromResponse(_executor, host, response.data);
+        }
+        return;
+    }
+
+    // While a hedged request or the original is still outstanding, wait for it rather than fail.
+    if (!response.status.isOK() && remote.hasPendingRequest()) {
+        return;
+    }
+
+    // Store the response or error, and cancel the losing request if there is one.
+    remote.hedgeDeadline = boost::none;
+    remote.shardHostAndPort = host;
+    if (remote.cbHandle.isValid()) {
+        _executor->cancel(remote.cbHandle);
+    }
+    if (remote.hedgeCbHandle.isValid()) {
+        _executor->cancel(remote.hedgeCbHandle);
+    }
 
-    // Store the response or error.
-    if (job->cbData.response.status.isOK()) {
-        remote.swResponse = std::move(job->cbData.response);
+    if (response.status.isOK()) {
+        remote.swResponse = std::move(response);
     } else {
-        remote.swResponse = std::move(job->cbData.response.status);
+        remote.swResponse = std::move(response.status);
     }
 }
 
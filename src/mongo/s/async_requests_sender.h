@@ -76,6 +76,13 @@ namespace mongo {
  *     }
  * }
  *
+ * If the AsyncRequestsSenderHedgeReads server parameter is enabled and the read preference allows
+ * reading from more than one host, requests are hedged: when a request has been outstanding for
+ * longer than the recent 95th percentile latency of its shard, the same command is also sent to
+ * another host eligible under the read preference. The first successful response is used and the
+ * other request is canceled. If the other request still returns a cursor, the cursor is killed.
+ * Hosts are tried in order of the average latency the router has observed for them.
+ *
  * Does not throw exceptions.
  */
 class AsyncRequestsSender {
@@ -114,6 +121,10 @@ public:
         // The exact host on which the remote command was run. Is unset if the shard could not be
         // found or no shard hosts matching the readPreference could be found.
         boost::optional<HostAndPort> shardHostAndPort;
+
+        // The position of the request among all the requests given to the ARS, counting those
+        // passed to the constructor first and then those passed to addRequests() in order.
+        size_t requestIndex = 0;
     };
 
     /**
@@ -150,6 +161,16 @@ public:
      */
     Response next();
 
+    /**
+     * Schedules more requests, whose responses are then returned by next() along with those of the
+     * requests already given to the ARS. Lets callers keep requests flowing to each shard as
+     * earlier ones complete, rather than waiting for all of them.
+     *
+     * If the operation has been interrupted, the new requests fail with the interruption status.
+     * Invalid to call after stopRetrying().
+     */
+    void addRequests(const std::vector<AsyncRequestsSender::Request>& requests);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -199,8 +220,23 @@ private:
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // When to hedge the outstanding request to this remote. Is unset if the request is not to
+        // be hedged, or has already been hedged.
+        boost::optional<Date_t> hedgeDeadline;
+
+        // The callback handle to an outstanding hedged request for this remote. Once either
+        // request gets a response, shardHostAndPort is set to the host which sent it.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+
         // Whether this remote's result has been returned.
         bool done = false;
+
+        /**
+         * Returns true if a request or hedged request to this remote is outstanding.
+         */
+        bool hasPendingRequest() const {
+            return cbHandle.isValid() || hedgeCbHandle.isValid();
+        }
     };
 
     /**
@@ -210,6 +246,7 @@ private:
     struct Job {
         executor::TaskExecutor::RemoteCommandCallbackArgs cbData;
         size_t remoteIndex;
+        bool hedged;
     };
 
     /**
@@ -278,11 +315,30 @@ private:
      */
     Status _scheduleRequest(size_t remoteIndex);
 
+    /**
+     * Sends a second copy of the outstanding request for the remote at 'remoteIndex' to another
+     * host matching the read preference. Does nothing if there is no other such host.
+     */
+    void _scheduleHedgedRequest(size_t remoteIndex);
+
+    /**
+     * Returns the hosts of the remote's shard which match the read preference, ordered by their
+     * observed latency. Returns an empty vector if the shard is not a replica set.
+     */
+    std::vector<HostAndPort> _getEligibleHosts(RemoteData& remote);
+
+    /**
+     * Returns the earliest hedge deadline among the remotes, if any.
+     */
+    boost::optional<Date_t> _nextHedgeDeadline() const;
+
     /**
      * Waits for forward progress in gathering responses from a remote.
      *
      * If the opCtx is non-null, use it while waiting on completion.
      *
+     * Returns without progress once the earliest hedge deadline has passed.
+     *
      * Stores the response or error in the remote.
      */
     void _makeProgress(OperationContext* opCtx);
@@ -306,6 +362,9 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
+    // Whether requests are hedged.
+    const bool _hedgeReads;
+
     // Is set to a non-OK status if the client operation is interrupted.
     // When waiting for a remote to be ready, we only check for interrupt if the _interruptStatus
     // has not already been set to an error (so we can wait for callbacks for (canceled) outstanding
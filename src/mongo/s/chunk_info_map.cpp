@@ -0,0 +1,279 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_info_map.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// Returns the first eight bytes of 'key' as a big-endian integer, zero padded if it is shorter.
+// Comparing the prefixes of two keys as integers orders them like comparing their first bytes.
+uint64_t extractKeyPrefix(StringData key) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < std::min<size_t>(key.size(), 8); ++i) {
+        prefix |= uint64_t(static_cast<unsigned char>(key[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+// Returns whether key 'a', with prefix 'aPrefix', sorts before key 'b', with prefix 'bPrefix'.
+bool keyLess(uint64_t aPrefix, StringData a, uint64_t bPrefix, StringData b) {
+    if (aPrefix != bPrefix) {
+        return aPrefix < bPrefix;
+    }
+    return a.compare(b) < 0;
+}
+
+// Returns the first position in [0, len) at which 'isPast' is true, or 'len' if there is none.
+// 'isPast' must be false up to some position and true from there on.
+//
+// The answer is always in [base, base + len]. Each step halves 'len' whatever the outcome of the
+// comparison, so the loop runs a fixed number of times and the comparison only selects the new
+// 'base'.
+template <typename Predicate>
+size_t partitionPoint(size_t len, Predicate isPast) {
+    if (len == 0) {
+        return 0;
+    }
+
+    size_t base = 0;
+    while (len > 1) {
+        const size_t half = len / 2;
+        base += isPast(base + half - 1) ? 0 : half;
+        len -= half;
+    }
+
+    return base + (isPast(base) ? 0 : 1);
+}
+
+}  // namespace
+
+constexpr size_t ChunkInfoMap::kMaxLeafSize;
+
+ChunkInfoMap::const_iterator& ChunkInfoMap::const_iterator::operator++() {
+    if (++_pos == _map->_leaves[_leaf]->entries.size()) {
+        ++_leaf;
+        _pos = 0;
+    }
+    return *this;
+}
+
+ChunkInfoMap::const_iterator& ChunkInfoMap::const_iterator::operator--() {
+    if (_pos == 0) {
+        --_leaf;
+        _pos = _map->_leaves[_leaf]->entries.size();
+    }
+    --_pos;
+    return *this;
+}
+
+ChunkInfoMap::Leaf::Leaf(std::vector<value_type>::const_iterator first,
+                         std::vector<value_type>::const_iterator last)
+    : entries(first, last) {
+    prefixes.reserve(entries.size());
+    for (const auto& entry : entries) {
+        prefixes.push_back(extractKeyPrefix(entry.first));
+    }
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upper_bound(StringData key) const {
+    const uint64_t keyPrefix = extractKeyPrefix(key);
+
+    const size_t leafPos = _findLeaf(keyPrefix, key, false);
+    if (leafPos == _leaves.size()) {
+        return end();
+    }
+
+    const auto& leaf = *_leaves[leafPos];
+    const size_t pos = partitionPoint(leaf.entries.size(), [&](size_t i) {
+        return keyLess(keyPrefix, key, leaf.prefixes[i], leaf.entries[i].first);
+    });
+    return {this, leafPos, pos};
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::lower_bound(StringData key) const {
+    const uint64_t keyPrefix = extractKeyPrefix(key);
+
+    const size_t leafPos = _findLeaf(keyPrefix, key, true);
+    if (leafPos == _leaves.size()) {
+        return end();
+    }
+
+    const auto& leaf = *_leaves[leafPos];
+    const size_t pos = partitionPoint(leaf.entries.size(), [&](size_t i) {
+        return !keyLess(leaf.prefixes[i], leaf.entries[i].first, keyPrefix, key);
+    });
+    return {this, leafPos, pos};
+}
+
+void ChunkInfoMap::erase(const_iterator first, const_iterator last) {
+    invariant(first._map == this && last._map == this);
+    if (first == last) {
+        return;
+    }
+
+    if (first._leaf == last._leaf) {
+        auto& leaf = _mutableLeaf(first._leaf);
+        leaf.entries.erase(leaf.entries.begin() + first._pos, leaf.entries.begin() + last._pos);
+        leaf.prefixes.erase(leaf.prefixes.begin() + first._pos, leaf.prefixes.begin() + last._pos);
+        _size -= last._pos - first._pos;
+        _leafChanged(first._leaf);
+        return;
+    }
+
+    // Trim the head of the last leaf, drop the leaves in between, then trim the tail of the first.
+    if (last._leaf < _leaves.size() && last._pos > 0) {
+        auto& leaf = _mutableLeaf(last._leaf);
+        leaf.entries.erase(leaf.entries.begin(), leaf.entries.begin() + last._pos);
+        leaf.prefixes.erase(leaf.prefixes.begin(), leaf.prefixes.begin() + last._pos);
+        _size -= last._pos;
+    }
+
+    for (size_t i = first._leaf + 1; i < last._leaf; ++i) {
+        _size -= _leaves[i]->entries.size();
+    }
+    _leaves.erase(_leaves.begin() + first._leaf + 1, _leaves.begin() + last._leaf);
+    _lastKeyPrefixes.erase(_lastKeyPrefixes.begin() + first._leaf + 1,
+                           _lastKeyPrefixes.begin() + last._leaf);
+
+    auto& leaf = _mutableLeaf(first._leaf);
+    _size -= leaf.entries.size() - first._pos;
+    leaf.entries.erase(leaf.entries.begin() + first._pos, leaf.entries.end());
+    leaf.prefixes.erase(leaf.prefixes.begin() + first._pos, leaf.prefixes.end());
+
+    // The former last leaf now follows the first one. Handle it first, as that may only change
+    // the leaves after it.
+    if (first._leaf + 1 < _leaves.size()) {
+        _leafChanged(first._leaf + 1);
+    }
+    _leafChanged(first._leaf);
+}
+
+void ChunkInfoMap::insert(value_type value) {
+    const uint64_t keyPrefix = extractKeyPrefix(value.first);
+
+    if (_leaves.empty()) {
+        _leaves.push_back(std::make_shared<Leaf>());
+        _leaves.back()->entries.push_back(std::move(value));
+        _leaves.back()->prefixes.push_back(keyPrefix);
+        _lastKeyPrefixes.push_back(keyPrefix);
+        _size = 1;
+        return;
+    }
+
+    // Keys past the end of the last leaf go into the last leaf.
+    const size_t leafPos = std::min(_findLeaf(keyPrefix, value.first, false), _leaves.size() - 1);
+
+    auto& leaf = _mutableLeaf(leafPos);
+    const size_t pos = partitionPoint(leaf.entries.size(), [&](size_t i) {
+        return keyLess(keyPrefix, value.first, leaf.prefixes[i], leaf.entries[i].first);
+    });
+    dassert(pos == 0 || leaf.entries[pos - 1].first != value.first);
+
+    leaf.entries.insert(leaf.entries.begin() + pos, std::move(value));
+    leaf.prefixes.insert(leaf.prefixes.begin() + pos, keyPrefix);
+    ++_size;
+    _leafChanged(leafPos);
+}
+
+size_t ChunkInfoMap::_findLeaf(uint64_t keyPrefix, StringData key, bool inclusive) const {
+    return partitionPoint(_leaves.size(), [&](size_t i) {
+        if (inclusive) {
+            return !keyLess(_lastKeyPrefixes[i], _leaves[i]->lastKey(), keyPrefix, key);
+        }
+        return keyLess(keyPrefix, key, _lastKeyPrefixes[i], _leaves[i]->lastKey());
+    });
+}
+
+ChunkInfoMap::Leaf& ChunkInfoMap::_mutableLeaf(size_t leaf) {
+    auto& ptr = _leaves[leaf];
+
+    // Only this map can add references to a leaf it holds the only reference to, so checking the
+    // count is safe even while other maps drop their references concurrently.
+    if (ptr.use_count() != 1) {
+        ptr = std::make_shared<Leaf>(*ptr);
+    }
+    return *ptr;
+}
+
+void ChunkInfoMap::_leafChanged(size_t leaf) {
+    if (_leaves[leaf]->entries.empty()) {
+        _leaves.erase(_leaves.begin() + leaf);
+        _lastKeyPrefixes.erase(_lastKeyPrefixes.begin() + leaf);
+        if (leaf > 0) {
+            _mergeWithNextIfSmall(leaf - 1);
+        }
+        return;
+    }
+
+    if (_leaves[leaf]->entries.size() > kMaxLeafSize) {
+        auto& lower = _mutableLeaf(leaf);
+        const size_t half = lower.entries.size() / 2;
+
+        auto upper = std::make_shared<Leaf>(lower.entries.begin() + half, lower.entries.end());
+        lower.entries.erase(lower.entries.begin() + half, lower.entries.end());
+        lower.prefixes.resize(half);
+
+        _lastKeyPrefixes[leaf] = lower.prefixes.back();
+        _lastKeyPrefixes.insert(_lastKeyPrefixes.begin() + leaf + 1, upper->prefixes.back());
+        _leaves.insert(_leaves.begin() + leaf + 1, std::move(upper));
+        return;
+    }
+
+    _lastKeyPrefixes[leaf] = _leaves[leaf]->prefixes.back();
+
+    // Keep erasures from leaving many small leaves behind.
+    _mergeWithNextIfSmall(leaf);
+    if (leaf > 0) {
+        _mergeWithNextIfSmall(leaf - 1);
+    }
+}
+
+void ChunkInfoMap::_mergeWithNextIfSmall(size_t leaf) {
+    if (leaf + 1 >= _leaves.size() ||
+        _leaves[leaf]->entries.size() + _leaves[leaf + 1]->entries.size() > kMaxLeafSize / 2) {
+        return;
+    }
+
+    const auto next = std::move(_leaves[leaf + 1]);
+    _leaves.erase(_leaves.begin() + leaf + 1);
+    _lastKeyPrefixes.erase(_lastKeyPrefixes.begin() + leaf + 1);
+
+    auto& merged = _mutableLeaf(leaf);
+    merged.entries.insert(merged.entries.end(), next->entries.begin(), next->entries.end());
+    merged.prefixes.insert(merged.prefixes.end(), next->prefixes.begin(), next->prefixes.end());
+    _lastKeyPrefixes[leaf] = merged.prefixes.back();
+}
+
+}  // namespace mongo
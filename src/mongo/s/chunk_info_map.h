@@ -0,0 +1,211 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+class ChunkInfo;
+
+/**
+ * Ordered map from the KeyString of the max of each chunk to an entry describing the chunk. It is
+ * cheap to copy, and a copy is cheap to change.
+ *
+ * Entries live in sorted leaves of at most kMaxLeafSize entries, which copies of the map share.
+ * Copying the map copies only its array of leaves, and changing a copy replaces just the leaves
+ * it touches, the way a B-tree with path copying would. Applying k changed chunks to a copy of a
+ * map with n chunks therefore costs O(n / kMaxLeafSize + k * kMaxLeafSize), where copying a
+ * std::map would cost O(n). A leaf which is not shared with any other copy is changed in place.
+ *
+ * Every leaf also keeps the first eight bytes of each of its keys as a big-endian integer, and the
+ * map keeps those of the last key of each leaf, so that most steps of a lookup compare integers
+ * held in one contiguous array.
+ *
+ * Not thread safe to change. Copies may be read and changed concurrently with the original.
+ */
+class ChunkInfoMap {
+public:
+    using value_type = std::pair<std::string, std::shared_ptr<ChunkInfo>>;
+
+    // Leaves split once they grow beyond this many entries.
+    static constexpr size_t kMaxLeafSize = 256;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return _map->_leaves[_leaf]->entries[_pos];
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++();
+
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        const_iterator& operator--();
+
+        const_iterator operator--(int) {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _leaf == other._leaf && _pos == other._pos;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkInfoMap;
+
+        const_iterator(const ChunkInfoMap* map, size_t leaf, size_t pos)
+            : _map(map), _leaf(leaf), _pos(pos) {}
+
+        const ChunkInfoMap* _map = nullptr;
+        size_t _leaf = 0;
+        size_t _pos = 0;
+    };
+
+    const_iterator begin() const {
+        return {this, 0, 0};
+    }
+
+    const_iterator end() const {
+        return {this, _leaves.size(), 0};
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Returns the first entry whose key is greater than 'key'.
+     */
+    const_iterator upper_bound(StringData key) const;
+
+    /**
+     * Returns the first entry whose key is not less than 'key'.
+     */
+    const_iterator lower_bound(StringData key) const;
+
+    /**
+     * Removes the entries in [first, last). Invalidates all iterators into this map.
+     */
+    void erase(const_iterator first, const_iterator last);
+
+    /**
+     * Inserts 'value', whose key must not already be in the map. Invalidates all iterators into
+     * this map.
+     */
+    void insert(value_type value);
+
+private:
+    struct Leaf {
+        Leaf() = default;
+        Leaf(std::vector<value_type>::const_iterator first,
+             std::vector<value_type>::const_iterator last);
+
+        StringData lastKey() const {
+            return entries.back().first;
+        }
+
+        // Sorted entries, with the prefix of each entry's key at the same position in 'prefixes'.
+        std::vector<value_type> entries;
+        std::vector<uint64_t> prefixes;
+    };
+
+    /**
+     * Returns the position of the first leaf whose last key is greater than 'key', or not less
+     * than 'key' if 'inclusive' is set.
+     */
+    size_t _findLeaf(uint64_t keyPrefix, StringData key, bool inclusive) const;
+
+    /**
+     * Returns the leaf at 'leaf', copying it first if another map shares it.
+     */
+    Leaf& _mutableLeaf(size_t leaf);
+
+    /**
+     * Must be called after the entries of the leaf at 'leaf' change. Updates the cached prefix of
+     * its last key, removes it if it is empty, splits it if it is too large, and merges it with a
+     * neighbour if they are both small.
+     */
+    void _leafChanged(size_t leaf);
+
+    /**
+     * Merges the leaf after 'leaf' into it if they hold few enough entries between them.
+     */
+    void _mergeWithNextIfSmall(size_t leaf);
+
+    std::vector<std::shared_ptr<Leaf>> _leaves;
+
+    // The prefix of the last key of each leaf.
+    std::vector<uint64_t> _lastKeyPrefixes;
+
+    size_t _size = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+
+#include "mongo/platform/random.h"
+#include "mongo/s/chunk_info_map.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+using ReferenceMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+
+// Keys which share long prefixes, so that lookups have to look past the first eight bytes.
+std::string makeKey(int i) {
+    return str::stream() << "key" << std::string(i % 7, 'x') << i;
+}
+
+void assertSameContents(const ReferenceMap& expected, const ChunkInfoMap& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    ASSERT_EQ(expected.empty(), actual.empty());
+
+    auto expectedIt = expected.begin();
+    for (auto it = actual.begin(); it != actual.end(); ++it, ++expectedIt) {
+        ASSERT_EQ(expectedIt->first, it->first);
+    }
+    ASSERT(expectedIt == expected.end());
+
+    // Also walk backwards, across leaf boundaries.
+    auto expectedRit = expected.rbegin();
+    for (auto it = actual.end(); it != actual.begin(); ++expectedRit) {
+        --it;
+        ASSERT_EQ(expectedRit->first, it->first);
+    }
+}
+
+void assertSameBounds(const ReferenceMap& expected, const ChunkInfoMap& actual, StringData key) {
+    const auto expectedUpper = expected.upper_bound(key.toString());
+    const auto upper = actual.upper_bound(key);
+    if (expectedUpper == expected.end()) {
+        ASSERT(upper == actual.end()) << key;
+    } else {
+        ASSERT(upper != actual.end()) << key;
+        ASSERT_EQ(expectedUpper->first, upper->first);
+    }
+
+    const auto expectedLower = expected.lower_bound(key.toString());
+    const auto lower = actual.lower_bound(key);
+    if (expectedLower == expected.end()) {
+        ASSERT(lower == actual.end()) << key;
+    } else {
+        ASSERT(lower != actual.end()) << key;
+        ASSERT_EQ(expectedLower->first, lower->first);
+    }
+}
+
+TEST(ChunkInfoMapTest, Empty) {
+    ChunkInfoMap map;
+    ASSERT(map.empty());
+    ASSERT(map.begin() == map.end());
+    ASSERT(map.upper_bound("a") == map.end());
+    ASSERT(map.lower_bound("a") == map.end());
+    map.erase(map.begin(), map.end());
+    ASSERT(map.empty());
+}
+
+TEST(ChunkInfoMapTest, MatchesStdMapUnderRandomChanges) {
+    PseudoRandom random(1);
+    ReferenceMap expected;
+    ChunkInfoMap actual;
+
+    const int kKeySpace = 20 * ChunkInfoMap::kMaxLeafSize;
+    for (int round = 0; round < 4000; ++round) {
+        auto first = makeKey(random.nextInt32(kKeySpace));
+        auto last = makeKey(random.nextInt32(kKeySpace));
+        if (last < first) {
+            std::swap(first, last);
+        }
+
+        // Mostly inserts, with some erasures of ranges of every size.
+        if (round % 5 == 4) {
+            expected.erase(expected.lower_bound(first), expected.upper_bound(last));
+            actual.erase(actual.lower_bound(first), actual.upper_bound(last));
+        } else if (!expected.count(first)) {
+            expected.emplace(first, nullptr);
+            actual.insert({first, nullptr});
+        }
+
+        if (round % 100 == 0) {
+            assertSameContents(expected, actual);
+        }
+    }
+
+    assertSameContents(expected, actual);
+    for (int i = 0; i <= kKeySpace; ++i) {
+        assertSameBounds(expected, actual, makeKey(i));
+    }
+    assertSameBounds(expected, actual, "");
+    assertSameBounds(expected, actual, "zzz");
+
+    actual.erase(actual.begin(), actual.end());
+    ASSERT(actual.empty());
+    ASSERT(actual.begin() == actual.end());
+}
+
+TEST(ChunkInfoMapTest, ChangesToCopiesAreIndependent) {
+    ReferenceMap expected;
+    ChunkInfoMap original;
+    for (int i = 0; i < 10 * int(ChunkInfoMap::kMaxLeafSize); ++i) {
+        expected.emplace(makeKey(i), nullptr);
+        original.insert({makeKey(i), nullptr});
+    }
+
+    auto copy = original;
+    copy.erase(copy.lower_bound(makeKey(100)), copy.upper_bound(makeKey(2000)));
+    copy.insert({makeKey(1000), nullptr});
+    copy.insert({"zzz", nullptr});
+
+    assertSameContents(expected, original);
+
+    ReferenceMap expectedCopy = expected;
+    expectedCopy.erase(expectedCopy.lower_bound(makeKey(100)),
+                       expectedCopy.upper_bound(makeKey(2000)));
+    expectedCopy.emplace(makeKey(1000), nullptr);
+    expectedCopy.emplace("zzz", nullptr);
+    assertSameContents(expectedCopy, copy);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,9 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -74,6 +77,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          std::unique_ptr<CollatorInterface> defaultCollator,
                                          bool unique,
                                          ChunkInfoMap chunkMap,
+                                         ShardVersionMap shardVersions,
                                          ChunkVersion collectionVersion)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
@@ -83,8 +87,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _defaultCollator(std::move(defaultCollator)),
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
-      _shardVersions(
-          _constructShardVersionMap(collectionVersion.epoch(), _chunkMap, _shardKeyOrdering)),
+      _shardVersions(std::move(shardVersions)),
       _collectionVersion(collectionVersion) {}
 
 Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
@@ -107,6 +110,46 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
     return Chunk(*(it->second), _clusterTime);
 }
 
+std::vector<Chunk> ChunkManager::findIntersectingChunksWithSimpleCollation(
+    const std::vector<BSONObj>& shardKeys) const {
+    std::vector<std::string> keyStrings;
+    keyStrings.reserve(shardKeys.size());
+    for (const auto& shardKey : shardKeys) {
+        keyStrings.push_back(_rt->_extractKeyString(shardKey));
+    }
+
+    std::vector<size_t> sortedKeys(shardKeys.size());
+    std::iota(sortedKeys.begin(), sortedKeys.end(), 0);
+    std::sort(sortedKeys.begin(), sortedKeys.end(), [&](size_t lhs, size_t rhs) {
+        return keyStrings[lhs] < keyStrings[rhs];
+    });
+
+    const auto& chunkMap = _rt->getChunkMap();
+    std::vector<ChunkInfo*> chunkInfos(shardKeys.size(), nullptr);
+
+    auto it = chunkMap.end();
+    for (const auto i : sortedKeys) {
+        // The keys are visited in ascending order, so a key which sorts below the max of the chunk
+        // which contained the previous key is also inside that chunk
+        if (it == chunkMap.end() || keyStrings[i] >= it->first) {
+            it = chunkMap.upper_bound(keyStrings[i]);
+            uassert(ErrorCodes::ShardKeyNotFound,
+                    str::stream() << "Cannot target single shard using key " << shardKeys[i],
+                    it != chunkMap.end() && it->second->containsKey(shardKeys[i]));
+        }
+
+        chunkInfos[i] = it->second.get();
+    }
+
+    std::vector<Chunk> chunks;
+    chunks.reserve(shardKeys.size());
+    for (const auto chunkInfo : chunkInfos) {
+        chunks.emplace_back(*chunkInfo, _clusterTime);
+    }
+
+    return chunks;
+}
+
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
@@ -120,10 +163,56 @@ bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& sha
     return it->second->getShardIdAt(_clusterTime) == shardId;
 }
 
+bool ChunkManager::isColocatedWith(const ChunkManager& other,
+                                   const boost::optional<ShardId>& shardId) const {
+    const BSONObj kAscending;
+    if (getShardKeyPattern().toBSON().woCompare(
+            other.getShardKeyPattern().toBSON(), kAscending, false) != 0) {
+        return false;
+    }
+
+    // Both routing tables cover the whole key space in order, so walk them together, each time
+    // stepping past whichever chunk ends first, and compare the owners of every overlapping pair.
+    const auto chunkRange = chunks();
+    const auto otherChunkRange = other.chunks();
+    auto it = chunkRange.begin();
+    auto otherIt = otherChunkRange.begin();
+    while (it != chunkRange.end() && otherIt != otherChunkRange.end()) {
+        const auto chunk = *it;
+        const auto otherChunk = *otherIt;
+        if ((!shardId || chunk.getShardId() == *shardId) &&
+            chunk.getShardId() != otherChunk.getShardId()) {
+            return false;
+        }
+
+        const int cmp = chunk.getMax().woCompare(otherChunk.getMax(), kAscending, false);
+        if (cmp <= 0) {
+            ++it;
+        }
+        if (cmp >= 0) {
+            ++otherIt;
+        }
+    }
+    return true;
+}
+
 void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
                                        const BSONObj& query,
                                        const BSONObj& collation,
                                        std::set<ShardId>* shardIds) const {
+    // Fastest path for plain equalities on the shard key, which are found without canonicalizing
+    // the query. Most targeted queries take it.
+    auto shardKeyToFind = _rt->getShardKeyPattern().extractShardKeyFromTopLevelEqualities(query);
+    if (!shardKeyToFind.isEmpty()) {
+        try {
+            auto chunk = findIntersectingChunk(shardKeyToFind, collation);
+            shardIds->insert(chunk.getShardId());
+            return;
+        } catch (const DBException&) {
+            // Collation prevents targeting a single shard, leave it to the slow path
+        }
+    }
+
     auto qr = stdx::make_unique<QueryRequest>(_rt->getns());
     qr->setFilter(query);
 
@@ -142,7 +231,7 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
                                      MatchExpressionParser::kAllowAllSpecialFeatures));
 
     // Fast path for targeting equalities on the shard key.
-    auto shardKeyToFind = _rt->getShardKeyPattern().extractShardKeyFromQuery(*cq);
+    shardKeyToFind = _rt->getShardKeyPattern().extractShardKeyFromQuery(*cq);
     if (!shardKeyToFind.isEmpty()) {
         try {
             auto chunk = findIntersectingChunk(shardKeyToFind, collation);
@@ -377,7 +466,7 @@ ChunkVersion RoutingTableHistory::getVersion(const ShardId& shardName) const {
         return ChunkVersion(0, 0, _collectionVersion.epoch());
     }
 
-    return it->second;
+    return it->second.version;
 }
 
 std::string RoutingTableHistory::toString() const {
@@ -391,7 +480,7 @@ std::string RoutingTableHistory::toString() const {
 
     sb << "Shard versions:\n";
     for (const auto& entry : _shardVersions) {
-        sb << "\t" << entry.first << ": " << entry.second.toString() << '\n';
+        sb << "\t" << entry.first << ": " << entry.second.version.toString() << '\n';
     }
 
     return sb.str();
@@ -414,27 +503,29 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap(const OID& epoch,
         if (shardVersionIt == shardVersions.end()) {
             shardVersionIt = shardVersions
                                  .emplace(firstChunkInRange->getShardIdAt(boost::none),
-                                          ChunkVersion(0, 0, epoch))
+                                          ShardVersionInfo{ChunkVersion(0, 0, epoch), 0})
                                  .first;
         }
 
-        auto& maxShardVersion = shardVersionIt->second;
+        auto& maxShardVersion = shardVersionIt->second.version;
+        auto& numChunks = shardVersionIt->second.numChunks;
 
-        current = std::find_if(
-            current,
-            chunkMap.cend(),
-            [&firstChunkInRange, &maxShardVersion](const ChunkInfoMap::value_type& chunkMapEntry) {
-                const auto& currentChunk = chunkMapEntry.second;
+        current = std::find_if(current,
+                               chunkMap.cend(),
+                               [&firstChunkInRange, &maxShardVersion, &numChunks](
+                                   const ChunkInfoMap::value_type& chunkMapEntry) {
+                                   const auto& currentChunk = chunkMapEntry.second;
 
-                if (currentChunk->getShardIdAt(boost::none) !=
-                    firstChunkInRange->getShardIdAt(boost::none))
-                    return true;
+                                   if (currentChunk->getShardIdAt(boost::none) !=
+                                       firstChunkInRange->getShardIdAt(boost::none))
+                                       return true;
 
-                if (currentChunk->getLastmod() > maxShardVersion)
-                    maxShardVersion = currentChunk->getLastmod();
+                                   if (currentChunk->getLastmod() > maxShardVersion)
+                                       maxShardVersion = currentChunk->getLastmod();
 
-                return false;
-            });
+                                   ++numChunks;
+                                   return false;
+                               });
 
         const auto rangeLast = std::prev(current);
 
@@ -481,6 +572,44 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap(const OID& epoch,
     return shardVersions;
 }
 
+void RoutingTableHistory::_checkChangedChunksAreContiguous(
+    const ChunkInfoMap& chunkMap, const std::vector<std::string>& changedKeys) {
+    for (const auto& key : changedKeys) {
+        const auto it = chunkMap.lower_bound(key);
+        if (it == chunkMap.end() || it->first != key) {
+            // Replaced by a later chunk in the same update
+            continue;
+        }
+
+        const auto& chunk = it->second;
+
+        if (it == chunkMap.begin()) {
+            checkAllElementsAreOfType(MinKey, chunk->getMin());
+        } else {
+            const auto& prevMax = std::prev(it)->second->getMax();
+            uassert(ErrorCodes::ConflictingOperationInProgress,
+                    str::stream() << "Gap or an overlap between ranges "
+                                  << ChunkRange(chunk->getMin(), chunk->getMax()).toString()
+                                  << " and "
+                                  << prevMax,
+                    SimpleBSONObjComparator::kInstance.evaluate(prevMax == chunk->getMin()));
+        }
+
+        const auto next = std::next(it);
+        if (next == chunkMap.end()) {
+            checkAllElementsAreOfType(MaxKey, chunk->getMax());
+        } else {
+            const auto& nextMin = next->second->getMin();
+            uassert(ErrorCodes::ConflictingOperationInProgress,
+                    str::stream() << "Gap or an overlap between ranges "
+                                  << ChunkRange(chunk->getMin(), chunk->getMax()).toString()
+                                  << " and "
+                                  << nextMin,
+                    SimpleBSONObjComparator::kInstance.evaluate(chunk->getMax() == nextMin));
+        }
+    }
+}
+
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
@@ -499,6 +628,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeNew(
                                std::move(defaultCollator),
                                std::move(unique),
                                {},
+                               {},
                                {0, 0, epoch})
         .makeUpdated(chunks);
 }
@@ -507,8 +637,21 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
 
     const auto startingCollectionVersion = getVersion();
+
+    // Copying the map only copies references to its leaves, which are copied on first change.
     auto chunkMap = _chunkMap;
 
+    // Unless the whole routing table is being built, the shard versions are maintained as the
+    // chunks change, rather than recomputed with a scan of all chunks.
+    const bool incremental = !_chunkMap.empty();
+    auto shardVersions = _shardVersions;
+
+    // Shards which lost a chunk that had their max version, and whose version must be recomputed
+    std::set<ShardId> staleShardVersions;
+
+    // The KeyStrings of the max of the changed chunks, whose neighbours must be checked
+    std::vector<std::string> changedKeys;
+
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
         const auto& chunkVersion = chunk.getVersion();
@@ -534,11 +677,39 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         // not overlap max
         const auto high = chunkMap.upper_bound(chunkMaxKeyString);
 
+        if (incremental) {
+            for (auto it = low; it != high; ++it) {
+                const auto& removedChunk = it->second;
+                auto& shardVersion = shardVersions.at(removedChunk->getShardIdAt(boost::none));
+                --shardVersion.numChunks;
+                if (removedChunk->getLastmod() == shardVersion.version) {
+                    staleShardVersions.insert(removedChunk->getShardIdAt(boost::none));
+                }
+            }
+        }
+
         // Erase all chunks from the map, which overlap the chunk we got from the persistent store
         chunkMap.erase(low, high);
 
         // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, std::make_shared<ChunkInfo>(chunk)));
+        auto chunkInfo = std::make_shared<ChunkInfo>(chunk);
+
+        if (incremental) {
+            const auto& shardId = chunkInfo->getShardIdAt(boost::none);
+            auto& shardVersion =
+                shardVersions
+                    .emplace(shardId, ShardVersionInfo{ChunkVersion(0, 0, chunkVersion.epoch()), 0})
+                    .first->second;
+            ++shardVersion.numChunks;
+
+            // Chunks come in increasing version order, so this is now the max on its shard
+            shardVersion.version = chunkVersion;
+            staleShardVersions.erase(shardId);
+
+            changedKeys.push_back(chunkMaxKeyString);
+        }
+
+        chunkMap.insert(std::make_pair(chunkMaxKeyString, std::move(chunkInfo)));
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -552,6 +723,42 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    if (incremental) {
+        _checkChangedChunksAreContiguous(chunkMap, changedKeys);
+
+        for (auto it = shardVersions.begin(); it != shardVersions.end();) {
+            if (it->second.numChunks == 0) {
+                staleShardVersions.erase(it->first);
+                it = shardVersions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // A shard can lose the chunk with its max version without getting a newer one, so
+        // recompute the versions of such shards from their remaining chunks.
+        if (!staleShardVersions.empty()) {
+            for (const auto& shardId : staleShardVersions) {
+                shardVersions.at(shardId).version = ChunkVersion(0, 0, collectionVersion.epoch());
+            }
+
+            for (const auto& entry : chunkMap) {
+                const auto& shardId = entry.second->getShardIdAt(boost::none);
+                if (!staleShardVersions.count(shardId)) {
+                    continue;
+                }
+
+                auto& shardVersion = shardVersions.at(shardId);
+                if (entry.second->getLastmod() > shardVersion.version) {
+                    shardVersion.version = entry.second->getLastmod();
+                }
+            }
+        }
+    } else {
+        shardVersions =
+            _constructShardVersionMap(collectionVersion.epoch(), chunkMap, _shardKeyOrdering);
+    }
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
@@ -559,6 +766,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
                                 CollatorInterface::cloneCollator(getDefaultCollator()),
                                 isUnique(),
                                 std::move(chunkMap),
+                                std::move(shardVersions),
                                 collectionVersion));
 }
 
@@ -37,6 +37,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/s/chunk.h"
+#include "mongo/s/chunk_info_map.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -49,11 +50,14 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+// Max chunk version on a shard and the number of chunks it owns
+struct ShardVersionInfo {
+    ChunkVersion version;
+    size_t numChunks;
+};
 
-// Map from a shard is to the max chunk version on that shard
-using ShardVersionMap = std::map<ShardId, ChunkVersion>;
+// Map from a shard id to the max chunk version on that shard
+using ShardVersionMap = std::map<ShardId, ShardVersionInfo>;
 
 /**
  * In-memory representation of the routing table for a single sharded collection at various points
@@ -157,12 +161,20 @@ private:
                                                      const ChunkInfoMap& chunkMap,
                                                      Ordering shardKeyOrdering);
 
+    /**
+     * Checks that each chunk whose max has a KeyString in 'changedKeys' and is still in 'chunkMap'
+     * adjoins its neighbours, or the ends of the key space if it has none.
+     */
+    static void _checkChangedChunksAreContiguous(const ChunkInfoMap& chunkMap,
+                                                 const std::vector<std::string>& changedKeys);
+
     RoutingTableHistory(NamespaceString nss,
                         boost::optional<UUID> uuid,
                         KeyPattern shardKeyPattern,
                         std::unique_ptr<CollatorInterface> defaultCollator,
                         bool unique,
                         ChunkInfoMap chunkMap,
+                        ShardVersionMap shardVersions,
                         ChunkVersion collectionVersion);
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
@@ -313,6 +325,15 @@ public:
         return _rt->getChunkMap().size();
     }
 
+    /**
+     * Returns the KeyString encoding of "shardKeyValue" under the shard key ordering, which is the
+     * form in which the routing table stores chunk bounds. Encoded keys compare bytewise in the
+     * same order as the shard key values they were built from.
+     */
+    std::string extractKeyString(const BSONObj& shardKeyValue) const {
+        return _rt->_extractKeyString(shardKeyValue);
+    }
+
     /**
      * Returns true if a document with the given "shardKey" is owned by the shard with the given
      * "shardId" in this routing table. If "shardKey" is empty returns false. If "shardKey" is not a
@@ -325,6 +346,16 @@ public:
      */
     bool rangeOverlapsShard(const ChunkRange& range, const ShardId& shardId) const;
 
+    /**
+     * Returns true if "other" is sharded by a key pattern of the same shape and every shard key
+     * value is owned by the same shard in both routing tables, so that documents with equal shard
+     * key values always live together. Shard key values are compared regardless of their field
+     * names. If "shardId" is given, only the values owned by that shard in this routing table are
+     * checked.
+     */
+    bool isColocatedWith(const ChunkManager& other,
+                         const boost::optional<ShardId>& shardId = boost::none) const;
+
     /**
      * Given a shardKey, returns the first chunk which is owned by shardId and overlaps or sorts
      * after that shardKey. The returned iterator range always contains one or zero entries. If zero
@@ -353,6 +384,19 @@ public:
         return findIntersectingChunk(shardKey, CollationSpec::kSimpleSpec);
     }
 
+    /**
+     * Batch form of findIntersectingChunkWithSimpleCollation. Returns the chunk containing each of
+     * 'shardKeys', in the same order as the keys.
+     *
+     * The keys are encoded and sorted up front and the chunk map is then visited in key order, so
+     * that consecutive keys which fall in the same chunk share a single lookup.
+     *
+     * Throws a DBException with the ShardKeyNotFound code if any key does not match the shard key
+     * pattern.
+     */
+    std::vector<Chunk> findIntersectingChunksWithSimpleCollation(
+        const std::vector<BSONObj>& shardKeys) const;
+
     /**
      * Finds the shard IDs for a given filter and collation. If collation is empty, we use the
      * collection default collation for targeting.
@@ -487,5 +487,102 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunkOnSharedKeyPrefixes) {
+    // Split points whose KeyStrings share their first eight bytes and differ only in length or in
+    // later bytes, mixed with numbers and with each chunk boundary probed exactly.
+    const std::vector<BSONObj> splitPoints{BSON("a" << -100),
+                                           BSON("a" << 0),
+                                           BSON("a" << 100),
+                                           BSON("a"
+                                                << "aaaaaaaa"),
+                                           BSON("a"
+                                                << "aaaaaaaaa"),
+                                           BSON("a"
+                                                << "aaaaaaaab"),
+                                           BSON("a"
+                                                << "aaaaaaab"),
+                                           BSON("a"
+                                                << "b")};
+
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(kNss, shardKeyPattern, nullptr, false, splitPoints);
+
+    std::vector<BSONObj> keys = splitPoints;
+    keys.push_back(BSON("a" << -101));
+    keys.push_back(BSON("a" << 50));
+    keys.push_back(BSON("a"
+                        << "aaaaaaa"));
+    keys.push_back(BSON("a"
+                        << "aaaaaaaaaa"));
+    keys.push_back(BSON("a"
+                        << "aaaaaaaac"));
+    keys.push_back(BSON("a"
+                        << "zzz"));
+
+    for (const auto& key : keys) {
+        auto chunk = chunkManager->findIntersectingChunkWithSimpleCollation(key);
+        ASSERT(chunk.containsKey(key)) << key << " is not in " << chunk.toString();
+    }
+}
+
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunksMatchesFindIntersectingChunk) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(
+        kNss, shardKeyPattern, nullptr, false, {BSON("a" << 0), BSON("a" << 10), BSON("a" << 20)});
+
+    // Unsorted keys, with duplicates, which land on every chunk and on its exact boundaries
+    std::vector<BSONObj> keys;
+    for (int i : {25, -5, 10, 3, 20, 9, 3, 0, 19, -100, 100}) {
+        keys.push_back(BSON("a" << i));
+    }
+
+    auto chunks = chunkManager->findIntersectingChunksWithSimpleCollation(keys);
+    ASSERT_EQ(keys.size(), chunks.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto chunk = chunkManager->findIntersectingChunkWithSimpleCollation(keys[i]);
+        ASSERT_BSONOBJ_EQ(chunk.getMin(), chunks[i].getMin());
+        ASSERT_EQ(chunk.getShardId(), chunks[i].getShardId());
+    }
+
+    ASSERT(chunkManager->findIntersectingChunksWithSimpleCollation({}).empty());
+}
+
+TEST_F(ChunkManagerQueryTest, IsColocatedWith) {
+    const NamespaceString kOtherNss("TestDB", "OtherColl");
+    auto chunkManager = makeChunkManager(
+        kNss, ShardKeyPattern(BSON("a" << 1)), nullptr, false, {BSON("a" << 0), BSON("a" << 10)});
+
+    // The same chunks and owners are co-located, whatever the shard key fields are called.
+    auto sameChunks = makeChunkManager(kOtherNss,
+                                       ShardKeyPattern(BSON("b" << 1)),
+                                       nullptr,
+                                       false,
+                                       {BSON("b" << 0), BSON("b" << 10)});
+    ASSERT(chunkManager->isColocatedWith(*sameChunks));
+    ASSERT(sameChunks->isColocatedWith(*chunkManager));
+
+    // Moving the second split point gives [10, 20) to a different shard in each.
+    auto otherChunks = makeChunkManager(kOtherNss,
+                                        ShardKeyPattern(BSON("b" << 1)),
+                                        nullptr,
+                                        false,
+                                        {BSON("b" << 0), BSON("b" << 20)});
+    ASSERT_FALSE(chunkManager->isColocatedWith(*otherChunks));
+    ASSERT_FALSE(otherChunks->isColocatedWith(*chunkManager));
+
+    // Only the values owned by the given shard are compared. Shard "1" owns [0, 10) here and the
+    // wider [0, 20) in the other, but shard "2" does not own [10, 20) in the other.
+    ASSERT(chunkManager->isColocatedWith(*otherChunks, ShardId("0")));
+    ASSERT(chunkManager->isColocatedWith(*otherChunks, ShardId("1")));
+    ASSERT_FALSE(chunkManager->isColocatedWith(*otherChunks, ShardId("2")));
+    ASSERT(otherChunks->isColocatedWith(*chunkManager, ShardId("2")));
+
+    // Hashed and ranged shard keys never place values alike.
+    auto hashedChunks =
+        makeChunkManager(kOtherNss, ShardKeyPattern(BSON("b" << "hashed")), nullptr, false, {});
+    ASSERT_FALSE(chunkManager->isColocatedWith(*hashedChunks));
+}
+
 }  // namespace
 }  // namespace mongo
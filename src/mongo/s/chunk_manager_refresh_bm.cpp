@@ -120,7 +120,9 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
     }
 }
 
-BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
+BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 400000});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
@@ -245,6 +247,23 @@ void BM_FindIntersectingChunk(benchmark::State& state,
     state.SetItemsProcessed(state.iterations());
 }
 
+template <typename CollectionMetadataBuilderFn>
+void BM_FindIntersectingChunks(benchmark::State& state,
+                               CollectionMetadataBuilderFn makeCollectionMetadata) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+
+    auto cm = makeCollectionMetadata(nShards, nChunks);
+    auto keys = makeKeys(nChunks);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(
+            cm->getChunkManager()->findIntersectingChunksWithSimpleCollation(keys));
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
 template <typename CollectionMetadataBuilderFn>
 void BM_GetShardIdsForRange(benchmark::State& state,
                             CollectionMetadataBuilderFn makeCollectionMetadata) {
@@ -349,6 +368,25 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({2, 2});
     }
 
+    // Point lookups against a routing table too large for the CPU caches.
+    std::initializer_list<benchmark::internal::Benchmark*> largeBmCases{
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunk,
+                                   PessimalLarge,
+                                   makeChunkManagerWithPessimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunk,
+                                   OptimalLarge,
+                                   makeChunkManagerWithOptimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_KeyBelongsToMe, OptimalLarge, makeChunkManagerWithOptimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunks,
+                                   OptimalLarge,
+                                   makeChunkManagerWithOptimalBalancedDistribution),
+    };
+
+    for (auto bmCase : largeBmCases) {
+        bmCase->Args({100, 400000})->Args({1000, 400000});
+    }
+
     return Status::OK();
 }
 
@@ -33,6 +33,8 @@
 #include "mongo/s/commands/cluster_aggregate.h"
 
 #include <boost/intrusive_ptr.hpp>
+#include <cmath>
+#include <map>
 
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/auth/authorization_session.h"
@@ -43,8 +45,11 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/cluster_aggregation_planner.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_lookup.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_out.h"
+#include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline.h"
@@ -197,7 +202,8 @@ BSONObj createCommandForTargetedShards(
     const BSONObj originalCmdObj,
     const std::unique_ptr<Pipeline, PipelineDeleter>& pipelineForTargetedShards,
     const BSONObj collationObj,
-    boost::optional<LogicalTime> atClusterTime) {
+    boost::optional<LogicalTime> atClusterTime,
+    const boost::optional<ExchangeSpec>& exchangeSpec) {
 
     // Create the command for the shards.
     MutableDocument targetedCmd(request.serializeToCommandObj());
@@ -212,6 +218,11 @@ BSONObj createCommandForTargetedShards(
             targetedCmd[AggregationRequest::kNeedsMergeName] = Value(true);
             targetedCmd[AggregationRequest::kCursorName] =
                 Value(DOC(AggregationRequest::kBatchSizeName << 0));
+
+            // Ask the shards to partition their results across several merging shards.
+            if (exchangeSpec) {
+                targetedCmd[AggregationRequest::kExchangeName] = Value(exchangeSpec->toBSON());
+            }
         }
     }
 
@@ -268,6 +279,95 @@ BSONObj createCommandForMergingShard(
     return appendAllowImplicitCreate(mergeCmd.freeze().toBson(), true);
 }
 
+/**
+ * Returns the sample size each targeted shard should draw, if the shards part of the pipeline
+ * begins with a $sample which the shards can satisfy from a random cursor. The requested size is
+ * split across the shards in proportion to their document counts, plus a margin of
+ * internalQuerySampleShardOversampleStdDevs standard deviations, so that the merged sample is
+ * still uniform but no shard draws documents which the merge would mostly throw away. Returns an
+ * empty map if each shard should draw the full sample size, including when the counts cannot be
+ * obtained.
+ */
+std::map<ShardId, long long> getShardSampleSizes(
+    OperationContext* opCtx,
+    const NamespaceString& nss,
+    const CachedCollectionRoutingInfo& routingInfo,
+    const Pipeline* pipelineForTargetedShards) {
+    const double oversampleStdDevs = internalQuerySampleShardOversampleStdDevs.load();
+    if (oversampleStdDevs < 0) {
+        return {};
+    }
+
+    const auto& sources = pipelineForTargetedShards->getSources();
+    const auto sample =
+        sources.empty() ? nullptr : dynamic_cast<DocumentSourceSample*>(sources.front().get());
+    if (!sample) {
+        return {};
+    }
+
+    // A $sample at the front of the pipeline is not preceded by any filter, so unfiltered counts
+    // weigh the shards correctly. These are cheap to answer, from the collection's record count.
+    const auto countResponses =
+        scatterGatherVersionedTargetByRoutingTable(opCtx,
+                                                   nss.db(),
+                                                   nss,
+                                                   routingInfo,
+                                                   BSON("count" << nss.coll()),
+                                                   ReadPreferenceSetting::get(opCtx),
+                                                   Shard::RetryPolicy::kIdempotent,
+                                                   BSONObj(),
+                                                   BSONObj());
+
+    std::map<ShardId, long long> shardCounts;
+    long long totalCount = 0;
+    for (const auto& response : countResponses) {
+        if (!response.swResponse.isOK() ||
+            !getStatusFromCommandResult(response.swResponse.getValue().data).isOK()) {
+            return {};
+        }
+
+        const long long count = response.swResponse.getValue().data["n"].numberLong();
+        shardCounts.emplace(response.shardId, count);
+        totalCount += count;
+    }
+
+    if (totalCount <= 0) {
+        return {};
+    }
+
+    const long long sampleSize = sample->getSampleSize();
+    std::map<ShardId, long long> shardSampleSizes;
+    for (const auto& shardCount : shardCounts) {
+        // The merge keeps the documents with the lowest of the random sort keys, so the number it
+        // takes from a shard follows a hypergeometric distribution. Its mean is the shard's share
+        // of the sample, and its variance is at most that mean. A shard which drew fewer than the
+        // merge takes from it would skew the sample towards the other shards, so each shard draws
+        // enough to cover all but the far tail, and never more than the full sample size.
+        const double share = static_cast<double>(sampleSize) * shardCount.second / totalCount;
+        const double margin = oversampleStdDevs * std::sqrt(share);
+        shardSampleSizes.emplace(
+            shardCount.first,
+            std::min(sampleSize, static_cast<long long>(std::ceil(share + margin))));
+    }
+
+    return shardSampleSizes;
+}
+
+/**
+ * Returns 'cmdObj', a command for the targeted shards whose pipeline begins with $sample, with the
+ * size of that $sample replaced by 'sampleSize'.
+ */
+BSONObj setSampleSize(const BSONObj& cmdObj, long long sampleSize) {
+    MutableDocument cmd{Document(cmdObj)};
+
+    auto pipeline = cmd.peek()[AggregationRequest::kPipelineName].getArray();
+    invariant(!pipeline.empty());
+    pipeline.front() = Value(DOC(DocumentSourceSample::kStageName << DOC("size" << sampleSize)));
+    cmd[AggregationRequest::kPipelineName] = Value(std::move(pipeline));
+
+    return cmd.freeze().toBson();
+}
+
 std::vector<RemoteCursor> establishShardCursors(
     OperationContext* opCtx,
     const NamespaceString& nss,
@@ -276,7 +376,8 @@ std::vector<RemoteCursor> establishShardCursors(
     const BSONObj& cmdObj,
     const ReadPreferenceSetting& readPref,
     const BSONObj& shardQuery,
-    const BSONObj& collation) {
+    const BSONObj& collation,
+    const std::map<ShardId, long long>& shardSampleSizes) {
     LOG(1) << "Dispatching command " << redact(cmdObj) << " to establish cursors on shards";
 
     const bool mustRunOnAll = mustRunOnAllShards(nss, litePipe);
@@ -297,8 +398,11 @@ std::vector<RemoteCursor> establishShardCursors(
         // The collection is sharded. Use the routing table to decide which shards to target
         // based on the query and collation, and build versioned requests for them.
         for (auto& shardId : shardIds) {
-            auto versionedCmdObj =
-                appendShardVersion(cmdObj, routingInfo->cm()->getVersion(shardId));
+            auto sampleSize = shardSampleSizes.find(shardId);
+            auto versionedCmdObj = appendShardVersion(
+                sampleSize == shardSampleSizes.end() ? cmdObj
+                                                     : setSampleSize(cmdObj, sampleSize->second),
+                routingInfo->cm()->getVersion(shardId));
             requests.emplace_back(std::move(shardId), std::move(versionedCmdObj));
         }
     } else {
@@ -347,8 +451,50 @@ struct DispatchShardPipelineResults {
 
     // The command object to send to the targeted shards.
     BSONObj commandForTargetedShards;
+
+    // Populated if the shards were asked to partition their results across several merging
+    // shards, in which case 'remoteCursors' holds one cursor per merging shard from each shard.
+    boost::optional<ExchangeSpec> exchangeSpec;
 };
 
+/**
+ * Returns the specification of an exchange which partitions the output of the shards part of a
+ * split pipeline across several merging shards, if the internalQueryExchangeNumMergingShards knob
+ * allows it and the pipeline is eligible. Otherwise, returns boost::none and the pipeline is merged
+ * on a single node as usual.
+ */
+boost::optional<ExchangeSpec> checkIfEligibleForExchange(OperationContext* opCtx,
+                                                         const Pipeline* pipelineForMerging,
+                                                         bool mustRunOnAllShards,
+                                                         bool needsPrimaryShardMerge,
+                                                         size_t numTargetedShards) {
+    const auto maxMergingShards = internalQueryExchangeNumMergingShards.load();
+    if (maxMergingShards < 2 || numTargetedShards < 2 || mustRunOnAllShards ||
+        needsPrimaryShardMerge) {
+        return boost::none;
+    }
+
+    // The merging shards' results are unioned on mongoS, so the merging half must not need to run
+    // there, and nor can it be tailable or explained. Merging on a shard also rules out
+    // transactions; see SERVER-33683.
+    const auto& mergeCtx = pipelineForMerging->getContext();
+    if (mergeCtx->explain || mergeCtx->tailableMode != TailableModeEnum::kNormal ||
+        pipelineForMerging->requiredToRunOnMongos() || opCtx->getTxnNumber()) {
+        return boost::none;
+    }
+
+    auto key = cluster_aggregation_planner::getExchangeKey(pipelineForMerging);
+    if (!key) {
+        return boost::none;
+    }
+
+    // Each merging shard is chosen from amongst the targeted shards.
+    ExchangeSpec exchangeSpec;
+    exchangeSpec.key = std::move(*key);
+    exchangeSpec.consumers = std::min(static_cast<size_t>(maxMergingShards), numTargetedShards);
+    return exchangeSpec;
+}
+
 /**
  * Targets shards for the pipeline and returns a struct with the remote cursors or results, and
  * the pipeline that will need to be executed to merge the results from the remotes. If a stale
@@ -413,14 +559,26 @@ DispatchShardPipelineResults dispatchShardPipeline(
                              (needsPrimaryShardMerge && executionNsRoutingInfo &&
                               *(shardIds.begin()) != executionNsRoutingInfo->db().primaryId()));
 
+    boost::optional<ExchangeSpec> exchangeSpec;
     if (needsSplit) {
         pipelineForMerging = std::move(pipelineForTargetedShards);
         pipelineForTargetedShards = pipelineForMerging->splitForSharded();
+
+        exchangeSpec = checkIfEligibleForExchange(opCtx,
+                                                  pipelineForMerging.get(),
+                                                  mustRunOnAll,
+                                                  needsPrimaryShardMerge,
+                                                  shardIds.size());
     }
 
     // Generate the command object for the targeted shards.
-    BSONObj targetedCommand = createCommandForTargetedShards(
-        opCtx, aggRequest, originalCmdObj, pipelineForTargetedShards, collationObj, atClusterTime);
+    BSONObj targetedCommand = createCommandForTargetedShards(opCtx,
+                                                             aggRequest,
+                                                             originalCmdObj,
+                                                             pipelineForTargetedShards,
+                                                             collationObj,
+                                                             atClusterTime,
+                                                             exchangeSpec);
 
     // Refresh the shard registry if we're targeting all shards.  We need the shard registry
     // to be at least as current as the logical time used when creating the command for
@@ -459,6 +617,14 @@ DispatchShardPipelineResults dispatchShardPipeline(
                                                            aggRequest.getCollation());
         }
     } else {
+        // Split a leading $sample across the shards rather than drawing it in full from each.
+        std::map<ShardId, long long> shardSampleSizes;
+        if (needsSplit && !mustRunOnAll && shardIds.size() > 1u && executionNsRoutingInfo &&
+            executionNsRoutingInfo->cm()) {
+            shardSampleSizes = getShardSampleSizes(
+                opCtx, executionNss, *executionNsRoutingInfo, pipelineForTargetedShards.get());
+        }
+
         cursors = establishShardCursors(opCtx,
                                         executionNss,
                                         liteParsedPipeline,
@@ -466,7 +632,8 @@ DispatchShardPipelineResults dispatchShardPipeline(
                                         targetedCommand,
                                         ReadPreferenceSetting::get(opCtx),
                                         shardQuery,
-                                        aggRequest.getCollation());
+                                        aggRequest.getCollation(),
+                                        shardSampleSizes);
     }
 
     // Record the number of shards involved in the aggregation. If we are required to merge on
@@ -481,7 +648,8 @@ DispatchShardPipelineResults dispatchShardPipeline(
                                         std::move(shardResults),
                                         std::move(pipelineForTargetedShards),
                                         std::move(pipelineForMerging),
-                                        targetedCommand};
+                                        targetedCommand,
+                                        std::move(exchangeSpec)};
 }
 
 Shard::CommandResponse establishMergingShardCursor(OperationContext* opCtx,
@@ -729,30 +897,39 @@ ShardId pickMergingShard(OperationContext* opCtx,
 // able to have a resolved view definition. It's okay that this is incorrect, we will repopulate the
 // real namespace map on the mongod. Note that this function must be called before forwarding an
 // aggregation command on an unsharded collection, in order to validate that none of the involved
-// collections are sharded.
+// collections are sharded. If 'shardedNamespaces' is given, sharded namespaces are collected there
+// instead, for the caller to validate once it knows which of them are read shard-locally.
 StringMap<ExpressionContext::ResolvedNamespace> resolveInvolvedNamespaces(
-    OperationContext* opCtx, const LiteParsedPipeline& litePipe) {
+    OperationContext* opCtx,
+    const LiteParsedPipeline& litePipe,
+    std::set<NamespaceString>* shardedNamespaces = nullptr) {
 
     StringMap<ExpressionContext::ResolvedNamespace> resolvedNamespaces;
     for (auto&& nss : litePipe.getInvolvedNamespaces()) {
         const auto resolvedNsRoutingInfo =
             uassertStatusOK(Grid::get(opCtx)->catalogCache()->getCollectionRoutingInfo(opCtx, nss));
-        uassert(
-            28769, str::stream() << nss.ns() << " cannot be sharded", !resolvedNsRoutingInfo.cm());
+        if (shardedNamespaces && resolvedNsRoutingInfo.cm()) {
+            shardedNamespaces->insert(nss);
+        }
+        uassert(28769,
+                str::stream() << nss.ns() << " cannot be sharded",
+                shardedNamespaces || !resolvedNsRoutingInfo.cm());
         resolvedNamespaces.try_emplace(nss.coll(), nss, std::vector<BSONObj>{});
     }
     return resolvedNamespaces;
 }
 
-// Build an appropriate ExpressionContext for the pipeline. This helper validates that all involved
-// namespaces are unsharded, instantiates an appropriate collator, creates a MongoProcessInterface
-// for use by the pipeline's stages, and optionally extracts the UUID from the collection info if
-// present.
-boost::intrusive_ptr<ExpressionContext> makeExpressionContext(OperationContext* opCtx,
-                                                              const AggregationRequest& request,
-                                                              const LiteParsedPipeline& litePipe,
-                                                              BSONObj collationObj,
-                                                              boost::optional<UUID> uuid) {
+// Build an appropriate ExpressionContext for the pipeline. This helper collects the involved
+// namespaces which are sharded into 'shardedNss', instantiates an appropriate collator, creates a
+// MongoProcessInterface for use by the pipeline's stages, and optionally extracts the UUID from the
+// collection info if present.
+boost::intrusive_ptr<ExpressionContext> makeExpressionContext(
+    OperationContext* opCtx,
+    const AggregationRequest& request,
+    const LiteParsedPipeline& litePipe,
+    BSONObj collationObj,
+    boost::optional<UUID> uuid,
+    std::set<NamespaceString>* shardedNss) {
 
     std::unique_ptr<CollatorInterface> collation;
     if (!collationObj.isEmpty()) {
@@ -767,13 +944,41 @@ boost::intrusive_ptr<ExpressionContext> makeExpressionContext(OperationContext*
                                           request,
                                           std::move(collation),
                                           std::make_shared<PipelineS::MongoSInterface>(),
-                                          resolveInvolvedNamespaces(opCtx, litePipe),
+                                          resolveInvolvedNamespaces(opCtx, litePipe, shardedNss),
                                           uuid);
 
     mergeCtx->inMongos = true;
     return mergeCtx;
 }
 
+// Marks the $lookup stages of 'pipeline' which each shard can run against its own part of their
+// 'from' collection. This requires both collections to be sharded on exactly the joined fields,
+// with their chunks split at the same points and owned by the same shards.
+void markColocatedLookups(OperationContext* opCtx,
+                          const ChunkManager& localCm,
+                          Pipeline* pipeline) {
+    cluster_aggregation_planner::markShardLocalLookups(
+        pipeline,
+        [&](const NamespaceString& fromNss,
+            const FieldPath& localField,
+            const FieldPath& foreignField) {
+            auto fromRoutingInfo = uassertStatusOK(
+                Grid::get(opCtx)->catalogCache()->getCollectionRoutingInfo(opCtx, fromNss));
+            auto fromCm = fromRoutingInfo.cm();
+            if (!fromCm) {
+                return false;
+            }
+
+            auto isKeyedOn = [](const ChunkManager& cm, const FieldPath& field) {
+                const auto& keyPattern = cm.getShardKeyPattern().toBSON();
+                return keyPattern.nFields() == 1 &&
+                    keyPattern.firstElementFieldName() == field.fullPath();
+            };
+            return isKeyedOn(localCm, localField) && isKeyedOn(*fromCm, foreignField) &&
+                localCm.isColocatedWith(*fromCm);
+        });
+}
+
 // Runs a pipeline on mongoS, having first validated that it is eligible to do so. This can be a
 // pipeline which is split for merging, or an intact pipeline which must run entirely on mongoS.
 Status runPipelineOnMongoS(const boost::intrusive_ptr<ExpressionContext>& expCtx,
@@ -818,6 +1023,87 @@ Status runPipelineOnMongoS(const boost::intrusive_ptr<ExpressionContext>& expCtx
     return getStatusFromCommandResult(result->asTempObj());
 }
 
+// Merges the output of shards which partitioned their results with an exchange. Each partition is
+// merged by a different shard, running its own copy of the merging half of the pipeline, and the
+// mergers' results are then unioned on mongoS.
+Status dispatchExchangeMergingPipelines(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                        const ClusterAggregate::Namespaces& namespaces,
+                                        const AggregationRequest& request,
+                                        BSONObj cmdObj,
+                                        const LiteParsedPipeline& litePipe,
+                                        DispatchShardPipelineResults& shardDispatchResults,
+                                        BSONObjBuilder* result) {
+    const auto opCtx = expCtx->opCtx;
+    const auto numConsumers = shardDispatchResults.exchangeSpec->consumers;
+
+    // Each shard returned one cursor per consumer of its exchange, in consumer order. Gather the
+    // cursors for each consumer, and pick a distinct merging shard for each consumer from amongst
+    // the shards which returned them.
+    std::vector<std::vector<RemoteCursor>> cursorsByConsumer(numConsumers);
+    std::vector<ShardId> mergingShardIds;
+    std::map<ShardId, size_t> numCursorsByShard;
+    for (auto&& remoteCursor : shardDispatchResults.remoteCursors) {
+        ShardId shardId(remoteCursor.getShardId().toString());
+        const auto consumerId = numCursorsByShard[shardId]++;
+        uassert(50855,
+                str::stream() << "Shard " << shardId.toString()
+                              << " returned more cursors than the "
+                              << numConsumers
+                              << " requested for an exchange",
+                consumerId < numConsumers);
+        if (consumerId == 0) {
+            mergingShardIds.push_back(shardId);
+        }
+        cursorsByConsumer[consumerId].push_back(std::move(remoteCursor));
+    }
+    invariant(mergingShardIds.size() >= numConsumers);
+
+    // Copy the merging half of the pipeline for each consumer, front it with a $mergeCursors over
+    // that consumer's cursors and build the command to send to its merging shard.
+    std::vector<BSONObj> serializedMergingPipeline;
+    for (auto&& stage : shardDispatchResults.pipelineForMerging->serialize()) {
+        invariant(stage.getType() == BSONType::Object);
+        serializedMergingPipeline.push_back(stage.getDocument().toBson());
+    }
+
+    auto executor = Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor();
+    std::vector<std::pair<ShardId, BSONObj>> requests;
+    for (size_t consumerId = 0; consumerId < numConsumers; ++consumerId) {
+        auto consumerPipeline =
+            uassertStatusOK(Pipeline::parse(serializedMergingPipeline, expCtx));
+        cluster_aggregation_planner::addMergeCursorsSource(
+            consumerPipeline.get(), std::move(cursorsByConsumer[consumerId]), executor);
+
+        // A merger cannot produce its first result until the exchanges on the shards have been
+        // drained by the other mergers, so do not wait for a first batch from any of them.
+        auto mergeCmdObj = createCommandForMergingShard(request, expCtx, cmdObj, consumerPipeline);
+        BSONObjBuilder mergeCmdBuilder(mergeCmdObj.removeField(AggregationRequest::kCursorName));
+        mergeCmdBuilder.append(AggregationRequest::kCursorName,
+                               BSON(AggregationRequest::kBatchSizeName << 0));
+        requests.emplace_back(mergingShardIds[consumerId], mergeCmdBuilder.obj());
+    }
+
+    auto mergerCursors = establishCursors(opCtx,
+                                          executor,
+                                          namespaces.executionNss,
+                                          ReadPreferenceSetting::get(opCtx),
+                                          requests,
+                                          false /* do not allow partial results */);
+
+    // Union the mergers' results on mongoS.
+    auto cursorResponse =
+        establishMergingMongosCursor(opCtx,
+                                     request,
+                                     namespaces.requestedNss,
+                                     cmdObj,
+                                     litePipe,
+                                     uassertStatusOK(Pipeline::create({}, expCtx)),
+                                     std::move(mergerCursors));
+
+    CommandHelpers::filterCommandReplyForPassthrough(cursorResponse, result);
+    return getStatusFromCommandResult(result->asTempObj());
+}
+
 Status dispatchMergingPipeline(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                const ClusterAggregate::Namespaces& namespaces,
                                const AggregationRequest& request,
@@ -832,6 +1118,12 @@ Status dispatchMergingPipeline(const boost::intrusive_ptr<ExpressionContext>& ex
 
     const auto opCtx = expCtx->opCtx;
 
+    // If the shards partitioned their results, merge each partition on a different shard.
+    if (shardDispatchResults.exchangeSpec) {
+        return dispatchExchangeMergingPipelines(
+            expCtx, namespaces, request, cmdObj, litePipe, shardDispatchResults, result);
+    }
+
     // First, check whether we can merge on the mongoS. If the merge pipeline MUST run on mongoS,
     // then ignore the internalQueryProhibitMergingOnMongoS parameter.
     if (mergingPipeline->requiredToRunOnMongos() ||
@@ -939,12 +1231,34 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
     // Build an ExpressionContext for the pipeline. This instantiates an appropriate collator,
     // resolves all involved namespaces, and creates a shared MongoProcessInterface for use by the
     // pipeline's stages.
-    auto expCtx = makeExpressionContext(opCtx, request, litePipe, collationObj, uuid);
+    std::set<NamespaceString> shardedNamespaces;
+    auto expCtx =
+        makeExpressionContext(opCtx, request, litePipe, collationObj, uuid, &shardedNamespaces);
 
     // Parse and optimize the full pipeline.
     auto pipeline = uassertStatusOK(Pipeline::parse(request.getPipeline(), expCtx));
     pipeline->optimizePipeline();
 
+    // Involved collections may only be sharded if they are read by a $lookup which each shard can
+    // run against its own part of the collection.
+    if (!shardedNamespaces.empty()) {
+        if (routingInfo && routingInfo->cm()) {
+            markColocatedLookups(opCtx, *routingInfo->cm(), pipeline.get());
+        }
+        std::vector<NamespaceString> involvedNamespaces;
+        for (auto&& stage : pipeline->getSources()) {
+            auto lookup = dynamic_cast<DocumentSourceLookUp*>(stage.get());
+            if (!lookup || !lookup->isShardLocal()) {
+                stage->addInvolvedCollections(&involvedNamespaces);
+            }
+        }
+        for (auto&& nss : involvedNamespaces) {
+            uassert(28769,
+                    str::stream() << nss.ns() << " cannot be sharded",
+                    !shardedNamespaces.count(nss));
+        }
+    }
+
     // Check whether the entire pipeline must be run on mongoS.
     if (pipeline->requiredToRunOnMongos()) {
         return runPipelineOnMongoS(
@@ -1029,7 +1343,7 @@ Status ClusterAggregate::aggPassthrough(OperationContext* opCtx,
     // Format the command for the shard. This adds the 'fromMongos' field, wraps the command as an
     // explain if necessary, and rewrites the result into a format safe to forward to shards.
     cmdObj = CommandHelpers::filterCommandRequestForPassthrough(createCommandForTargetedShards(
-        opCtx, aggRequest, cmdObj, nullptr, BSONObj(), atClusterTime));
+        opCtx, aggRequest, cmdObj, nullptr, BSONObj(), atClusterTime, boost::none));
 
     auto cmdResponse = uassertStatusOK(shard->runCommandWithFixedRetryAttempts(
         opCtx,
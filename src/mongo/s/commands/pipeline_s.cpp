@@ -185,6 +185,90 @@ boost::optional<Document> PipelineS::MongoSInterface::lookupSingleDocument(
     return (!batch.empty() ? Document(batch.front()) : boost::optional<Document>{});
 }
 
+std::vector<Document> PipelineS::MongoSInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
+
+    auto shardResults = std::vector<RemoteCursor>();
+    bool established = false;
+    size_t numAttempts = 0;
+    while (++numAttempts <= kMaxNumStaleVersionRetries) {
+        // Verify that the collection exists, with the correct UUID.
+        auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
+        auto swRoutingInfo = getCollectionRoutingInfo(foreignExpCtx);
+        if (swRoutingInfo == ErrorCodes::NamespaceNotFound) {
+            return {};
+        }
+        auto routingInfo = uassertStatusOK(std::move(swRoutingInfo));
+
+        // Group the document keys by the shard which owns each of them.
+        std::map<ShardId, std::pair<ChunkVersion, std::vector<BSONObj>>> keysByShard;
+        for (auto&& documentKey : documentKeys) {
+            auto keyObj = documentKey.toBson();
+            auto shardInfo = getSingleTargetedShardForQuery(expCtx->opCtx, routingInfo, keyObj);
+            auto& shardKeys = keysByShard[shardInfo.first];
+            shardKeys.first = shardInfo.second;
+            shardKeys.second.push_back(std::move(keyObj));
+        }
+
+        // Send each shard one find for all of its keys. Find by UUID is only used for unsharded
+        // collections, for the same reason as in lookupSingleDocument().
+        std::vector<std::pair<ShardId, BSONObj>> requests;
+        for (auto&& shardKeys : keysByShard) {
+            BSONObjBuilder cmdBuilder;
+            if (foreignExpCtx->uuid && !routingInfo.cm()) {
+                foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
+            } else {
+                cmdBuilder.append("find", nss.coll());
+            }
+            cmdBuilder.append("filter", _makeDocumentKeysFilter(shardKeys.second.second));
+            cmdBuilder.append("comment", expCtx->comment);
+            cmdBuilder.append("batchSize", static_cast<long long>(shardKeys.second.second.size()));
+            cmdBuilder.append("singleBatch", true);
+            if (readConcern) {
+                cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
+            }
+            requests.emplace_back(shardKeys.first,
+                                  appendShardVersion(cmdBuilder.obj(), shardKeys.second.first));
+        }
+
+        try {
+            shardResults = establishCursors(
+                expCtx->opCtx,
+                Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                nss,
+                ReadPreferenceSetting::get(expCtx->opCtx),
+                requests,
+                false);
+            established = true;
+            break;
+        } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+            return {};
+        } catch (const ExceptionForCat<ErrorCategory::StaleShardVersionError>&) {
+            catalogCache->onStaleShardVersion(std::move(routingInfo));
+            continue;
+        }
+    }
+    uassert(ErrorCodes::StaleShardVersion,
+            str::stream() << "Unable to look up documents in " << nss.ns()
+                          << " after retrying on stale routing information",
+            established);
+
+    // 'singleBatch' closes each cursor after its first batch. Any documents which did not fit are
+    // left for the caller to look up individually.
+    std::vector<Document> lookedUpDocuments;
+    for (auto&& shardResult : shardResults) {
+        for (auto&& obj : shardResult.getCursorResponse().getBatch()) {
+            lookedUpDocuments.emplace_back(obj);
+        }
+    }
+    return lookedUpDocuments;
+}
+
 BSONObj PipelineS::MongoSInterface::_reportCurrentOpForClient(
     OperationContext* opCtx, Client* client, CurrentOpTruncateMode truncateOps) const {
     BSONObjBuilder builder;
@@ -58,6 +58,13 @@ public:
             const Document& documentKey,
             boost::optional<BSONObj> readConcern) final;
 
+        std::vector<Document> lookupDocuments(
+            const boost::intrusive_ptr<ExpressionContext>& expCtx,
+            const NamespaceString& nss,
+            UUID collectionUUID,
+            const std::vector<Document>& documentKeys,
+            boost::optional<BSONObj> readConcern) final;
+
         std::vector<GenericCursor> getCursors(
             const boost::intrusive_ptr<ExpressionContext>& expCtx) const final;
 
@@ -83,6 +90,7 @@ public:
         void appendLatencyStats(OperationContext* opCtx,
                                 const NamespaceString& nss,
                                 bool includeHistograms,
+                                bool includePercentiles,
                                 BSONObjBuilder* builder) const final {
             MONGO_UNREACHABLE;
         }
@@ -94,6 +102,12 @@ public:
             MONGO_UNREACHABLE;
         }
 
+        Status appendCacheStats(OperationContext* opCtx,
+                                const NamespaceString& nss,
+                                BSONObjBuilder* builder) const final {
+            MONGO_UNREACHABLE;
+        }
+
         Status appendRecordCount(OperationContext* opCtx,
                                  const NamespaceString& nss,
                                  BSONObjBuilder* builder) const final {
@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/host_latency_tracker.h"
+
+#include <algorithm>
+
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getHostLatencyTracker = ServiceContext::declareDecoration<HostLatencyTracker>();
+
+}  // namespace
+
+constexpr double HostLatencyTracker::kAverageWeight;
+constexpr size_t HostLatencyTracker::kSamplesPerShard;
+constexpr size_t HostLatencyTracker::kMinSamplesForPercentile;
+
+HostLatencyTracker& HostLatencyTracker::get(ServiceContext* serviceContext) {
+    return getHostLatencyTracker(serviceContext);
+}
+
+void HostLatencyTracker::recordLatency(const ShardId& shardId,
+                                       const HostAndPort& host,
+                                       Milliseconds latency) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _averageLatencyMillis.find(host);
+    if (it == _averageLatencyMillis.end()) {
+        _averageLatencyMillis.emplace(host, durationCount<Milliseconds>(latency));
+    } else {
+        it->second += kAverageWeight * (durationCount<Milliseconds>(latency) - it->second);
+    }
+
+    auto& shardSamples = _shardSamples[shardId];
+    if (shardSamples.samples.size() < kSamplesPerShard) {
+        shardSamples.samples.push_back(latency);
+    } else {
+        shardSamples.samples[shardSamples.next] = latency;
+        shardSamples.next = (shardSamples.next + 1) % kSamplesPerShard;
+    }
+}
+
+boost::optional<Milliseconds> HostLatencyTracker::getAverageLatency(const HostAndPort& host) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _averageLatencyMillis.find(host);
+    if (it == _averageLatencyMillis.end()) {
+        return boost::none;
+    }
+    return Milliseconds(static_cast<Milliseconds::rep>(it->second));
+}
+
+boost::optional<Milliseconds> HostLatencyTracker::getLatencyPercentile95(
+    const ShardId& shardId) const {
+    std::vector<Milliseconds> samples;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        auto it = _shardSamples.find(shardId);
+        if (it == _shardSamples.end() || it->second.samples.size() < kMinSamplesForPercentile) {
+            return boost::none;
+        }
+        samples = it->second.samples;
+    }
+
+    auto percentile = samples.begin() + (samples.size() * 95) / 100;
+    std::nth_element(samples.begin(), percentile, samples.end());
+    return *percentile;
+}
+
+std::vector<HostAndPort> HostLatencyTracker::orderByLatency(std::vector<HostAndPort> hosts) const {
+    std::vector<std::pair<double, HostAndPort>> ordered;
+    ordered.reserve(hosts.size());
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto& host : hosts) {
+            auto it = _averageLatencyMillis.find(host);
+            ordered.emplace_back(it == _averageLatencyMillis.end() ? -1.0 : it->second,
+                                 std::move(host));
+        }
+    }
+
+    std::stable_sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    hosts.clear();
+    for (auto& entry : ordered) {
+        hosts.push_back(std::move(entry.second));
+    }
+    return hosts;
+}
+
+}  // namespace mongo
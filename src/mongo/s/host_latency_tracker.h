@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/s/shard_id.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Decoration on ServiceContext which keeps track of the latencies observed for requests that
+ * a router sends to shards. Used by the AsyncRequestsSender to decide when to hedge a read and to
+ * which host.
+ *
+ * For each host it keeps an exponentially weighted moving average (EWMA) of latency. For each
+ * shard it keeps a window of recent samples, from which it estimates the 95th percentile.
+ *
+ * Thread safe.
+ */
+class HostLatencyTracker {
+    MONGO_DISALLOW_COPYING(HostLatencyTracker);
+
+public:
+    // The weight given to the newest sample in a host's moving average.
+    static constexpr double kAverageWeight = 0.2;
+
+    // The number of most recent samples kept per shard to estimate its latency percentile.
+    static constexpr size_t kSamplesPerShard = 128;
+
+    // The number of samples a shard needs before its latency percentile is reported.
+    static constexpr size_t kMinSamplesForPercentile = 16;
+
+    HostLatencyTracker() = default;
+
+    static HostLatencyTracker& get(ServiceContext* serviceContext);
+
+    /**
+     * Records that a request to 'host', which belongs to 'shardId', took 'latency' to complete.
+     */
+    void recordLatency(const ShardId& shardId, const HostAndPort& host, Milliseconds latency);
+
+    /**
+     * Returns the moving average of the latency of 'host', or boost::none if no latency has been
+     * recorded for it.
+     */
+    boost::optional<Milliseconds> getAverageLatency(const HostAndPort& host) const;
+
+    /**
+     * Returns the 95th percentile of the recent latencies of 'shardId', or boost::none if fewer
+     * than kMinSamplesForPercentile have been recorded for it.
+     */
+    boost::optional<Milliseconds> getLatencyPercentile95(const ShardId& shardId) const;
+
+    /**
+     * Returns 'hosts' ordered by ascending moving average latency. Hosts without any recorded
+     * latency go first, in their original order, so that they get measured.
+     */
+    std::vector<HostAndPort> orderByLatency(std::vector<HostAndPort> hosts) const;
+
+private:
+    // Ring buffer of the most recent latencies recorded for a shard.
+    struct ShardSamples {
+        std::vector<Milliseconds> samples;
+        size_t next = 0;
+    };
+
+    mutable stdx::mutex _mutex;
+
+    // Moving average of the latency of each host, in milliseconds.
+    std::map<HostAndPort, double> _averageLatencyMillis;
+
+    std::map<ShardId, ShardSamples> _shardSamples;
+};
+
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/host_latency_tracker.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const ShardId kShard("shard0");
+const HostAndPort kHostA("a", 27017);
+const HostAndPort kHostB("b", 27017);
+const HostAndPort kHostC("c", 27017);
+
+TEST(HostLatencyTrackerTest, AverageFavorsRecentLatencies) {
+    HostLatencyTracker tracker;
+    ASSERT_FALSE(tracker.getAverageLatency(kHostA));
+
+    tracker.recordLatency(kShard, kHostA, Milliseconds(10));
+    ASSERT_EQ(Milliseconds(10), *tracker.getAverageLatency(kHostA));
+
+    for (int i = 0; i < 50; ++i) {
+        tracker.recordLatency(kShard, kHostA, Milliseconds(100));
+    }
+    ASSERT_EQ(Milliseconds(99), *tracker.getAverageLatency(kHostA));
+    ASSERT_FALSE(tracker.getAverageLatency(kHostB));
+}
+
+TEST(HostLatencyTrackerTest, Percentile95NeedsEnoughSamples) {
+    HostLatencyTracker tracker;
+    for (size_t i = 0; i + 1 < HostLatencyTracker::kMinSamplesForPercentile; ++i) {
+        tracker.recordLatency(kShard, kHostA, Milliseconds(1));
+    }
+    ASSERT_FALSE(tracker.getLatencyPercentile95(kShard));
+
+    tracker.recordLatency(kShard, kHostA, Milliseconds(1));
+    ASSERT_EQ(Milliseconds(1), *tracker.getLatencyPercentile95(kShard));
+    ASSERT_FALSE(tracker.getLatencyPercentile95(ShardId("shard1")));
+}
+
+TEST(HostLatencyTrackerTest, Percentile95IgnoresOutliersAndOldSamples) {
+    HostLatencyTracker tracker;
+
+    // Fill the window with slow samples, then replace all of them.
+    for (size_t i = 0; i < HostLatencyTracker::kSamplesPerShard; ++i) {
+        tracker.recordLatency(kShard, kHostA, Milliseconds(1000));
+    }
+    for (size_t i = 0; i < HostLatencyTracker::kSamplesPerShard; ++i) {
+        tracker.recordLatency(kShard, kHostA, Milliseconds(i < 4 ? 500 : 10));
+    }
+    ASSERT_EQ(Milliseconds(10), *tracker.getLatencyPercentile95(kShard));
+}
+
+TEST(HostLatencyTrackerTest, OrderByLatencyPutsUnmeasuredHostsFirst) {
+    HostLatencyTracker tracker;
+    tracker.recordLatency(kShard, kHostA, Milliseconds(20));
+    tracker.recordLatency(kShard, kHostB, Milliseconds(5));
+
+    auto ordered = tracker.orderByLatency({kHostA, kHostB, kHostC});
+    ASSERT_EQ(3U, ordered.size());
+    ASSERT_EQ(kHostC, ordered[0]);
+    ASSERT_EQ(kHostB, ordered[1]);
+    ASSERT_EQ(kHostA, ordered[2]);
+}
+
+}  // namespace
+}  // namespace mongo
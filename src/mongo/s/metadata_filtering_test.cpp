@@ -83,7 +83,9 @@ protected:
     //      time (now,75) shard0(chunk1, chunk3) shard1(chunk2, chunk4)
     //      time (75,25) shard0(chunk2, chunk4) shard1(chunk1, chunk3)
     //      time (25,0) - no history
-    void prepareTestData() {
+    // If 'chunk4OnShard0Since' is given, chunk4 is on shard0 from then until (75), instead of
+    // from (25).
+    void prepareTestData(Timestamp chunk4OnShard0Since = Timestamp(25, 0)) {
         const OID epoch = OID::gen();
         const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
 
@@ -119,7 +121,7 @@ protected:
                              version,
                              {"1"});
             chunk4.setHistory({ChunkHistory(Timestamp(75, 0), ShardId("1")),
-                               ChunkHistory(Timestamp(25, 0), ShardId("0"))});
+                               ChunkHistory(chunk4OnShard0Since, ShardId("0"))});
             version.incMinor();
 
             return std::vector<BSONObj>{chunk1.toConfigBSON(),
@@ -188,6 +190,23 @@ TEST_F(MetadataFilteringTest, FilterDocumentsStale) {
                        ErrorCodes::StaleChunkHistory);
 }
 
+// Verifies that only keys in the chunks without history that far back get the stale error.
+TEST_F(MetadataFilteringTest, FilterDocumentsPartlyStale) {
+    prepareTestData(Timestamp(5, 0));
+
+    ShardingState::get(operationContext())->setEnabledForTest(ShardId("0").toString());
+
+    auto metadata = _manager->createMetadataAt(operationContext(), LogicalTime(Timestamp(10, 0)));
+
+    ASSERT_THROWS_CODE(metadata->keyBelongsToMe(BSON("_id" << -500)),
+                       AssertionException,
+                       ErrorCodes::StaleChunkHistory);
+    ASSERT_THROWS_CODE(metadata->keyBelongsToMe(BSON("_id" << 50)),
+                       AssertionException,
+                       ErrorCodes::StaleChunkHistory);
+    ASSERT_TRUE(metadata->keyBelongsToMe(BSON("_id" << 500)));
+}
+
 // The same test as FilterDocumentsPresent but using "readConcern"
 TEST_F(MetadataFilteringTest, FilterDocumentsPresentShardingState) {
     prepareTestData();
@@ -97,6 +97,22 @@ public:
     virtual StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                                    const BSONObj& doc) const = 0;
 
+    /**
+     * Returns the ShardEndpoint, or the reason it could not be targeted, for each of 'docs' in
+     * the same order as the documents. Equivalent to calling targetInsert for each document, but
+     * lets implementations target a batch of inserts in one pass.
+     */
+    virtual std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+        std::vector<StatusWith<ShardEndpoint>> endpoints;
+        endpoints.reserve(docs.size());
+        for (const auto& doc : docs) {
+            endpoints.push_back(targetInsert(opCtx, doc));
+        }
+
+        return endpoints;
+    }
+
     /**
      * Returns a vector of ShardEndpoints for a potentially multi-shard update.
      *
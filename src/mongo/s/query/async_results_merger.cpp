@@ -38,6 +38,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -67,6 +68,23 @@ BSONObj extractSortKey(BSONObj obj, bool compareWholeSortKey) {
     return key.Obj();
 }
 
+/**
+ * Returns the sort key of 'obj' as a KeyString, which compares bytewise like compareSortKeys()
+ * compares the keys under the pattern 'sortKeyOrdering' was made from.
+ */
+std::string encodeSortKey(const BSONObj& obj, bool compareWholeSortKey, Ordering sortKeyOrdering) {
+    KeyString ks(
+        KeyString::Version::V1, extractSortKey(obj, compareWholeSortKey), sortKeyOrdering);
+    return {ks.getBuffer(), ks.getSize()};
+}
+
+/**
+ * Returns the number of bytes 'result' occupies in a remote's buffer, for prefetch accounting.
+ */
+long long bufferedSize(const ClusterQueryResult& result) {
+    return result.getResult() ? result.getResult()->objsize() : 0;
+}
+
 /**
  * Returns an int less than 0 if 'leftSortKey' < 'rightSortKey', 0 if the two are equal, and an int
  * > 0 if 'leftSortKey' > 'rightSortKey' according to the pattern 'sortKeyPattern'.
@@ -91,13 +109,15 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       _tailableMode(params.getTailableMode() ? *params.getTailableMode()
                                              : TailableModeEnum::kNormal),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(_remotes,
-                                    _params.getSort() ? *_params.getSort() : BSONObj(),
-                                    _params.getCompareWholeSortKey())) {
+      _sortKeyOrdering(Ordering::make(_params.getSort() ? *_params.getSort() : BSONObj())),
+      _mergeTree(_params.getRemotes().size()) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
     }
 
+    // The merge tree refers to the sort keys buffered in '_remotes', so they must not move.
+    _remotes.reserve(_params.getRemotes().size());
+
     size_t remoteIndex = 0;
     for (const auto& remote : _params.getRemotes()) {
         _remotes.emplace_back(remote.getHostAndPort(),
@@ -179,6 +199,17 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
                               remote.getCursorResponse().getNSS(),
                               remote.getCursorResponse().getCursorId());
     }
+
+    // Adding remotes may have moved the buffered sort keys of the existing ones, so the merge tree
+    // is rebuilt over all the remotes.
+    if (_params.getSort()) {
+        _mergeTree = TournamentTree(_remotes.size());
+        for (size_t i = 0; i < _remotes.size(); ++i) {
+            if (!_remotes[i].sortKeyBuffer.empty()) {
+                _mergeTree.setKey(i, _remotes[i].sortKeyBuffer.front());
+            }
+        }
+    }
 }
 
 bool AsyncResultsMerger::_ready(WithLock lk) {
@@ -220,11 +251,12 @@ bool AsyncResultsMerger::_readySorted(WithLock lk) {
 }
 
 bool AsyncResultsMerger::_readySortedTailable(WithLock) {
-    if (_mergeQueue.empty()) {
+    const auto top = _mergeTree.top();
+    if (!top) {
         return false;
     }
 
-    auto smallestRemote = _mergeQueue.top();
+    auto smallestRemote = *top;
     auto smallestResult = _remotes[smallestRemote].docBuffer.front();
     auto keyWeWantToReturn =
         extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
@@ -277,41 +309,43 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
-    if (_mergeQueue.empty()) {
+    const auto top = _mergeTree.top();
+    if (!top) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
+    const size_t smallestRemote = *top;
+    auto& remote = _remotes[smallestRemote];
 
-    invariant(!_remotes[smallestRemote].docBuffer.empty());
-    invariant(_remotes[smallestRemote].status.isOK());
+    invariant(!remote.docBuffer.empty());
+    invariant(remote.status.isOK());
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    ClusterQueryResult front = _popFront(lk, smallestRemote);
+    remote.sortKeyBuffer.pop();
 
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+    // Replay 'smallestRemote' in the merge tree with its next result, if it has a next result.
+    if (!remote.sortKeyBuffer.empty()) {
+        _mergeTree.setKey(smallestRemote, remote.sortKeyBuffer.front());
+    } else {
+        _mergeTree.clearKey(smallestRemote);
     }
 
+    _maybePrefetchNextBatch(lk, smallestRemote);
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            ClusterQueryResult front = _popFront(lk, _gettingFromRemote);
 
             if (_tailableMode == TailableModeEnum::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -321,6 +355,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            _maybePrefetchNextBatch(lk, _gettingFromRemote);
             return front;
         }
 
@@ -334,6 +369,19 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
+ClusterQueryResult AsyncResultsMerger::_popFront(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    ClusterQueryResult front = std::move(remote.docBuffer.front());
+    remote.docBuffer.pop();
+
+    const auto resultSize = bufferedSize(front);
+    remote.bufferedBytes -= resultSize;
+    _bufferedBytes -= resultSize;
+
+    return front;
+}
+
 Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
     auto& remote = _remotes[remoteIndex];
@@ -388,6 +436,33 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     return Status::OK();
 }
 
+void AsyncResultsMerger::_maybePrefetchNextBatch(WithLock lk, size_t remoteIndex) {
+    const auto prefetchBufferBytes = _params.getPrefetchBufferBytes();
+    if (!prefetchBufferBytes || !_opCtx || _lifecycleState != kAlive ||
+        _tailableMode != TailableModeEnum::kNormal) {
+        return;
+    }
+
+    auto& remote = _remotes[remoteIndex];
+
+    // A remote with an empty buffer is asked for its next batch as soon as it is needed, so there
+    // is nothing to gain by prefetching for it here.
+    if (!remote.status.isOK() || !remote.hasNext() || remote.exhausted() ||
+        remote.cbHandle.isValid()) {
+        return;
+    }
+
+    // Wait until half of the last batch has been consumed, so that the next batch has time to
+    // arrive before the buffer runs dry, and stop prefetching once the buffered results exceed the
+    // budget.
+    if (remote.docBuffer.size() > remote.lastBatchSize / 2 ||
+        _bufferedBytes >= *prefetchBufferBytes) {
+        return;
+    }
+
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
 Status AsyncResultsMerger::scheduleGetMores() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     return _scheduleGetMores(lk);
@@ -409,6 +484,11 @@ Status AsyncResultsMerger::_scheduleGetMores(WithLock lk) {
             if (!nextBatchStatus.isOK()) {
                 return nextBatchStatus;
             }
+        } else {
+            _maybePrefetchNextBatch(lk, i);
+            if (!remote.status.isOK()) {
+                return remote.status;
+            }
         }
     }
     return Status::OK();
@@ -569,7 +649,15 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
+        _bufferedBytes -= remote.bufferedBytes;
+        remote.bufferedBytes = 0;
         remote.cursorId = 0;
+
+        if (_params.getSort()) {
+            _mergeTree.clearKey(remoteIndex);
+        }
     }
 }
 
@@ -620,6 +708,7 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
     updateRemoteMetadata(&remote, response);
+    remote.lastBatchSize = response.getBatch().size();
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (_params.getSort()) {
@@ -642,15 +731,24 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
         }
 
         ClusterQueryResult result(obj);
-        remote.docBuffer.push(result);
+        const auto resultSize = bufferedSize(result);
+        remote.docBuffer.push(std::move(result));
+        remote.bufferedBytes += resultSize;
+        _bufferedBytes += resultSize;
         ++remote.fetchedCount;
-    }
 
-    // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
-    // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+        if (_params.getSort()) {
+            remote.sortKeyBuffer.push(
+                encodeSortKey(obj, _params.getCompareWholeSortKey(), _sortKeyOrdering));
+
+            // If we're doing a sorted merge, then we have to make sure this remote takes part in
+            // the merge from its first buffered result.
+            if (remote.sortKeyBuffer.size() == 1) {
+                _mergeTree.setKey(remoteIndex, remote.sortKeyBuffer.front());
+            }
+        }
     }
+
     return true;
 }
 
@@ -756,19 +854,6 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
     return cursorId == 0;
 }
 
-//
-// AsyncResultsMerger::MergingComparator
-//
-
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
-
-    return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
-                           extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
-}
-
 void AsyncResultsMerger::blockingKill(OperationContext* opCtx) {
     auto killEvent = kill(opCtx);
     if (!killEvent) {
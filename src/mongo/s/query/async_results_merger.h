@@ -30,15 +30,18 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
+#include "mongo/s/query/tournament_tree.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
@@ -88,7 +91,7 @@ public:
      *
      * Additionally copies each remote's first batch of results, if one exists, into that remote's
      * docBuffer. If a sort is specified in the ClusterClientCursorParams, places the remotes with
-     * buffered results onto _mergeQueue.
+     * buffered results onto _mergeTree.
      *
      * The TaskExecutor* must remain valid for the lifetime of the ARM.
      *
@@ -291,6 +294,10 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // If there is a sort, the sort key of each result in 'docBuffer', encoded as a KeyString so
+        // that the results of different remotes can be merged by comparing bytes.
+        std::queue<std::string> sortKeyBuffer;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -301,26 +308,13 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
-    };
-
-    class MergingComparator {
-    public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes,
-                          const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
-
-        bool operator()(const size_t& lhs, const size_t& rhs);
 
-    private:
-        const std::vector<RemoteCursorData>& _remotes;
+        // The number of documents in the most recent batch received from this remote. Used to
+        // decide when to prefetch the next batch.
+        size_t lastBatchSize = 0;
 
-        const BSONObj _sort;
-
-        // When '_compareWholeSortKey' is true, $sortKey is a scalar value, rather than an object.
-        // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
-        // be {$sortKey: 1}.
-        const bool _compareWholeSortKey;
+        // The total size in bytes of the documents currently held in 'docBuffer'.
+        long long bufferedBytes = 0;
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
@@ -343,6 +337,14 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * If prefetching is enabled, asks the remote at 'remoteIndex' for its next batch ahead of time
+     * once it has consumed at least half of its last batch, provided that the documents buffered
+     * across all remotes fit within the prefetch budget. Must only be called while an
+     * OperationContext is attached.
+     */
+    void _maybePrefetchNextBatch(WithLock, size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -364,6 +366,11 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
+    /**
+     * Removes the result at the front of the remote's buffer and returns it.
+     */
+    ClusterQueryResult _popFront(WithLock, size_t remoteIndex);
+
     using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
     using CbResponse = executor::TaskExecutor::ResponseStatus;
 
@@ -438,14 +445,22 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // Orders the sort keys of the results at the front of each remote's buffer. When the sort key
+    // is an object, its fields are encoded in the directions of the sort pattern.
+    const Ordering _sortKeyOrdering;
+
+    // The top of this tree is the index into '_remotes' for the remote host that has the next
+    // document to return, according to the sort order. Each remote with buffered results has the
+    // front of its 'sortKeyBuffer' as its key. Used only if there is a sort.
+    TournamentTree _mergeTree;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
 
+    // The total size in bytes of the documents buffered across all remotes.
+    long long _bufferedBytes = 0;
+
     Status _status = Status::OK();
 
     executor::TaskExecutor::EventHandle _currentEvent;
@@ -113,14 +113,18 @@ protected:
      *
      * 'findCmd' should not have a 'batchSize', since the find's batchSize is used just in the
      * initial find. The getMore 'batchSize' can be passed in through 'getMoreBatchSize.'
+     *
+     * If 'prefetchBufferBytes' is set, the ARM prefetches batches within that budget.
      */
     std::unique_ptr<AsyncResultsMerger> makeARMFromExistingCursors(
         std::vector<RemoteCursor> remoteCursors,
         boost::optional<BSONObj> findCmd = boost::none,
-        boost::optional<std::int64_t> getMoreBatchSize = boost::none) {
+        boost::optional<std::int64_t> getMoreBatchSize = boost::none,
+        boost::optional<long long> prefetchBufferBytes = boost::none) {
         AsyncResultsMergerParams params;
         params.setNss(kTestNss);
         params.setRemotes(std::move(remoteCursors));
+        params.setPrefetchBufferBytes(prefetchBufferBytes);
 
 
         if (findCmd) {
@@ -636,6 +640,52 @@ TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortKeysOfMixedTypes) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: 1}}");
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, {})));
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 6, {})));
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[2], kTestShardHosts[2], CursorResponse(kTestNss, 7, {})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    // Schedule requests.
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    auto makeResult = [](auto value) { return BSON("$sortKey" << BSON("" << value)); };
+
+    // Numbers of different types compare by value, and types compare in BSON order.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {makeResult(1), makeResult(3LL), makeResult("a")};
+    responses.emplace_back(kTestNss, CursorId(0), batch1);
+    std::vector<BSONObj> batch2 = {makeResult(BSONNULL), makeResult(2.5), makeResult(BSONObj())};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    std::vector<BSONObj> batch3 = {makeResult(1.5), makeResult("B")};
+    responses.emplace_back(kTestNss, CursorId(0), batch3);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    // ARM returns all results in sorted order.
+    for (const auto& expected : {makeResult(BSONNULL),
+                                 makeResult(1),
+                                 makeResult(1.5),
+                                 makeResult(2.5),
+                                 makeResult(3LL),
+                                 makeResult("B"),
+                                 makeResult("a"),
+                                 makeResult(BSONObj())}) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(expected, *unittest::assertGet(arm->nextReady()).getResult());
+    }
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<RemoteCursor> cursors;
@@ -721,6 +771,67 @@ TEST_F(AsyncResultsMergerTest, HasFirstBatch) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, PrefetchesNextBatchOnceHalfOfLastBatchIsConsumed) {
+    std::vector<BSONObj> firstBatch = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, std::move(firstBatch))));
+    auto arm =
+        makeARMFromExistingCursors(std::move(cursors), boost::none, boost::none, 1024 * 1024);
+
+    // No getMore is sent until half of the first batch has been returned.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+
+    // The prefetched batch arrives while results from the first batch are still buffered.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{_id: 5}"), fromjson("{_id: 6}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses));
+    ASSERT_TRUE(arm->remotesExhausted());
+
+    // ARM returns every result without having to wait for another batch.
+    for (int i = 3; i <= 6; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i), *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, DoesNotPrefetchBeyondBufferBudget) {
+    std::vector<BSONObj> firstBatch = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, std::move(firstBatch))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), boost::none, boost::none, 1);
+
+    // The buffered results exceed the budget, so no getMore is sent while results remain.
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i), *unittest::assertGet(arm->nextReady()).getResult());
+        ASSERT_FALSE(networkHasReadyRequests());
+    }
+    ASSERT_FALSE(arm->ready());
+
+    // Once the buffer is empty, the next batch is requested as usual.
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{_id: 5}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 5}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, OneShardHasInitialBatchOtherShardExhausted) {
     std::vector<BSONObj> firstBatch = {
         fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
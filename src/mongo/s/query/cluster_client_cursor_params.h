@@ -85,6 +85,7 @@ struct ClusterClientCursorParams {
         armParams.setBatchSize(batchSize);
         armParams.setNss(nsString);
         armParams.setAllowPartialResults(isAllowPartialResults);
+        armParams.setPrefetchBufferBytes(prefetchBufferBytes);
 
         OperationSessionInfo sessionInfo;
         sessionInfo.setSessionId(lsid);
@@ -143,6 +144,10 @@ struct ClusterClientCursorParams {
     // unreachable host.
     bool isAllowPartialResults = false;
 
+    // If set, each remote's next batch is requested before its buffer runs dry, for as long as the
+    // results buffered by the cursor total fewer than this many bytes.
+    boost::optional<long long> prefetchBufferBytes;
+
     // The logical session id of the command that created the cursor.
     boost::optional<LogicalSessionId> lsid;
 
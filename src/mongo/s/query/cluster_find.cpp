@@ -256,6 +256,13 @@ CursorId runQueryWithoutRetrying(OperationContext* opCtx,
         params.batchSize = boost::none;
     }
 
+    // Tailable cursors pass each batch from the shards through to the client as-is, so there is
+    // nothing to prefetch for them.
+    const auto prefetchBufferBytes = internalQueryMongosPrefetchBufferBytes.load();
+    if (prefetchBufferBytes > 0 && params.tailableMode == TailableModeEnum::kNormal) {
+        params.prefetchBufferBytes = prefetchBufferBytes;
+    }
+
     // $natural sort is actually a hint to use a collection scan, and shouldn't be treated like a
     // sort on mongos. Including a $natural anywhere in the sort spec results in the whole sort
     // being considered a hint to use a collection scan.
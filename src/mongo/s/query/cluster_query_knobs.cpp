@@ -36,5 +36,16 @@ namespace mongo {
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryAlwaysMergeOnPrimaryShard, bool, false);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitMergingOnMongoS, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExchangeNumMergingShards, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMongosPrefetchBufferBytes, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryMongosPrefetchBufferBytes must be non-negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQuerySampleShardOversampleStdDevs, double, 4.0);
 
 }  // namespace mongo
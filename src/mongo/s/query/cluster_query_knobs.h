@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "mongo/platform/atomic_proxy.h"
 #include "mongo/platform/atomic_word.h"
 
 namespace mongo {
@@ -45,4 +46,21 @@ extern AtomicBool internalQueryAlwaysMergeOnPrimaryShard;
 // of merging on mongoS will always do so.
 extern AtomicBool internalQueryProhibitMergingOnMongoS;
 
+// When greater than 1, a split pipeline whose merging half begins with a $group may be merged by up
+// to this many shards in parallel, each merging the partial groups for its own share of the group
+// keys. 0 by default, meaning that every split pipeline is merged by a single node.
+extern AtomicInt32 internalQueryExchangeNumMergingShards;
+
+// When greater than 0, a find cursor on mongos requests the next batch from a shard once half of
+// that shard's last batch has been consumed, instead of waiting for it to run out, as long as the
+// cursor buffers fewer than this many bytes of results. 0 by default, meaning that batches are only
+// requested once needed.
+extern AtomicInt32 internalQueryMongosPrefetchBufferBytes;
+
+// A $sample at the start of an aggregation over several shards is split across them in proportion
+// to their document counts. Each shard draws its expected share of the merged sample plus this many
+// standard deviations, so that it almost never has fewer documents than the merged sample takes
+// from it. Negative values send every shard the full sample size instead.
+extern AtomicDouble internalQuerySampleShardOversampleStdDevs;
+
 }  // namespace mongo
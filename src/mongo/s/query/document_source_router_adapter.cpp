@@ -42,7 +42,13 @@ boost::intrusive_ptr<DocumentSourceRouterAdapter> DocumentSourceRouterAdapter::c
 }
 
 DocumentSource::GetNextResult DocumentSourceRouterAdapter::getNext() {
-    auto next = uassertStatusOK(_child->next(_execContext));
+    // A stage reading ahead already has results to return, so it must not wait here for more.
+    auto execContext = _execContext;
+    if (pExpCtx->prefetchingInput &&
+        execContext == RouterExecStage::ExecContext::kGetMoreNoResultsYet) {
+        execContext = RouterExecStage::ExecContext::kGetMoreWithAtLeastOneResultInBatch;
+    }
+    auto next = uassertStatusOK(_child->next(execContext));
     if (auto nextObj = next.getResult()) {
         return Document::fromBsonWithMetaData(*nextObj);
     }
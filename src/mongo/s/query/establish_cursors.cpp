@@ -32,6 +32,8 @@
 
 #include "mongo/s/query/establish_cursors.h"
 
+#include <iterator>
+
 #include "mongo/client/remote_command_retry_scheduler.h"
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/query/cursor_response.h"
@@ -47,6 +49,35 @@
 
 namespace mongo {
 
+namespace {
+/**
+ * Parses the cursors established by the command whose reply is 'data'. This is normally a single
+ * cursor, but a shard asked to partition its results with an exchange replies with an array of
+ * cursor responses under 'cursors', one per consumer of the exchange.
+ */
+std::vector<StatusWith<CursorResponse>> parseCursorResponses(const BSONObj& data) {
+    std::vector<StatusWith<CursorResponse>> cursorResponses;
+
+    auto cursorsElem = data["cursors"];
+    if (cursorsElem.type() != BSONType::Array) {
+        cursorResponses.push_back(CursorResponse::parseFromBSON(data));
+        return cursorResponses;
+    }
+
+    for (auto&& elem : cursorsElem.Obj()) {
+        if (elem.type() != BSONType::Object) {
+            cursorResponses.push_back({ErrorCodes::TypeMismatch,
+                                       str::stream() << "each element of 'cursors' must be an "
+                                                        "object, but found: "
+                                                     << typeName(elem.type())});
+            continue;
+        }
+        cursorResponses.push_back(CursorResponse::parseFromBSON(elem.Obj()));
+    }
+    return cursorResponses;
+}
+}  // namespace
+
 std::vector<RemoteCursor> establishCursors(OperationContext* opCtx,
                                            executor::TaskExecutor* executor,
                                            const NamespaceString& nss,
@@ -78,12 +109,17 @@ std::vector<RemoteCursor> establishCursors(OperationContext* opCtx,
                 // Additionally, be careful not to push into 'remoteCursors' until we are sure we
                 // have a valid cursor, since the error handling path will attempt to clean up
                 // anything in 'remoteCursors'
-                RemoteCursor cursor;
-                cursor.setCursorResponse(CursorResponse::parseFromBSONThrowing(
-                    uassertStatusOK(std::move(response.swResponse)).data));
-                cursor.setShardId(std::move(response.shardId));
-                cursor.setHostAndPort(*response.shardHostAndPort);
-                remoteCursors.push_back(std::move(cursor));
+                auto cursorResponses =
+                    parseCursorResponses(uassertStatusOK(std::move(response.swResponse)).data);
+                std::vector<RemoteCursor> cursors;
+                for (auto&& swCursorResponse : cursorResponses) {
+                    RemoteCursor cursor;
+                    cursor.setCursorResponse(uassertStatusOK(std::move(swCursorResponse)));
+                    cursor.setShardId(response.shardId);
+                    cursor.setHostAndPort(*response.shardHostAndPort);
+                    cursors.push_back(std::move(cursor));
+                }
+                std::move(cursors.begin(), cursors.end(), std::back_inserter(remoteCursors));
             } catch (const DBException& ex) {
                 // Retriable errors are swallowed if 'allowPartialResults' is true.
                 if (allowPartialResults &&
@@ -109,18 +145,20 @@ std::vector<RemoteCursor> establishCursors(OperationContext* opCtx,
             while (!ars.done()) {
                 auto response = ars.next();
 
-                // Check if the response contains an established cursor, and if so, store it.
-                StatusWith<CursorResponse> swCursorResponse(
-                    response.swResponse.isOK()
-                        ? CursorResponse::parseFromBSON(response.swResponse.getValue().data)
-                        : response.swResponse.getStatus());
+                if (!response.swResponse.isOK()) {
+                    continue;
+                }
 
-                if (swCursorResponse.isOK()) {
-                    RemoteCursor cursor;
-                    cursor.setShardId(std::move(response.shardId));
-                    cursor.setHostAndPort(*response.shardHostAndPort);
-                    cursor.setCursorResponse(std::move(swCursorResponse.getValue()));
-                    remoteCursors.push_back(std::move(cursor));
+                // Check if the response contains established cursors, and if so, store them.
+                for (auto&& swCursorResponse :
+                     parseCursorResponses(response.swResponse.getValue().data)) {
+                    if (swCursorResponse.isOK()) {
+                        RemoteCursor cursor;
+                        cursor.setShardId(response.shardId);
+                        cursor.setHostAndPort(*response.shardHostAndPort);
+                        cursor.setCursorResponse(std::move(swCursorResponse.getValue()));
+                        remoteCursors.push_back(std::move(cursor));
+                    }
                 }
             }
 
@@ -57,6 +57,9 @@ class CursorResponse;
  * On success, the ownership of the cursors is transferred to the caller. This means the caller is
  * now responsible for either exhausting the cursors or sending killCursors to them.
  *
+ * A remote which replies with several cursors, as a shard does when asked to partition its results
+ * with an exchange, contributes all of them, in the order it returned them.
+ *
  * @param allowPartialResults: If true, unreachable hosts are ignored, and only cursors established
  *                             on reachable hosts are returned.
  *
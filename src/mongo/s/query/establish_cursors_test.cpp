@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <map>
+
 #include "mongo/client/remote_command_targeter_factory_mock.h"
 #include "mongo/client/remote_command_targeter_mock.h"
 #include "mongo/db/json.h"
@@ -317,6 +319,55 @@ TEST_F(EstablishCursorsTest, MultipleRemotesRespondWithSuccess) {
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(EstablishCursorsTest, MultipleRemotesRespondWithSeveralCursorsEach) {
+    BSONObj cmdObj = fromjson("{aggregate: 'testcoll'}");
+    std::vector<std::pair<ShardId, BSONObj>> remotes{{kTestShardIds[0], cmdObj},
+                                                     {kTestShardIds[1], cmdObj}};
+
+    auto future = launchAsync([&] {
+        auto cursors = establishCursors(operationContext(),
+                                        executor(),
+                                        _nss,
+                                        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                                        remotes,
+                                        false);  // allowPartialResults
+        ASSERT_EQUALS(2 * remotes.size(), cursors.size());
+
+        // Each remote's cursors are returned in the order the remote listed them.
+        std::map<std::string, std::vector<CursorId>> cursorIdsByShard;
+        for (auto&& cursor : cursors) {
+            cursorIdsByShard[cursor.getShardId().toString()].push_back(
+                cursor.getCursorResponse().getCursorId());
+        }
+        ASSERT_EQUALS(remotes.size(), cursorIdsByShard.size());
+        for (auto&& shardCursorIds : cursorIdsByShard) {
+            ASSERT_EQUALS(2U, shardCursorIds.second.size());
+            ASSERT_EQUALS(CursorId(123), shardCursorIds.second[0]);
+            ASSERT_EQUALS(CursorId(456), shardCursorIds.second[1]);
+        }
+    });
+
+    // All remotes respond with one cursor for each consumer of an exchange.
+    for (auto it = remotes.begin(); it != remotes.end(); ++it) {
+        onCommand([&](const RemoteCommandRequest& request) {
+            ASSERT_EQ(_nss.coll(), request.cmdObj.firstElement().valueStringData());
+
+            BSONObjBuilder response;
+            BSONArrayBuilder cursorsBuilder(response.subarrayStart("cursors"));
+            for (auto cursorId : {CursorId(123), CursorId(456)}) {
+                CursorResponse cursorResponse(_nss, cursorId, std::vector<BSONObj>{});
+                cursorsBuilder.append(
+                    cursorResponse.toBSON(CursorResponse::ResponseType::InitialResponse));
+            }
+            cursorsBuilder.doneFast();
+            response.append("ok", 1);
+            return response.obj();
+        });
+    }
+
+    future.timed_get(kFutureTimeout);
+}
+
 TEST_F(EstablishCursorsTest, MultipleRemotesOneRemoteRespondsWithNonretriableError) {
     BSONObj cmdObj = fromjson("{find: 'testcoll'}");
     std::vector<std::pair<ShardId, BSONObj>> remotes{
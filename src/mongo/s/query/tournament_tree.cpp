@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/tournament_tree.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+TournamentTree::TournamentTree(size_t numStreams) : _keys(numStreams) {
+    _numLeaves = 1;
+    while (_numLeaves < numStreams) {
+        _numLeaves *= 2;
+    }
+
+    // No stream has a key yet, so every match is won by the stream of its leftmost leaf. Leaves
+    // past the last stream hold no stream at all.
+    _winners.assign(2 * _numLeaves, kNoStream);
+    for (size_t stream = 0; stream < numStreams; ++stream) {
+        _winners[_numLeaves + stream] = static_cast<int>(stream);
+    }
+    for (size_t node = _numLeaves - 1; node >= 1; --node) {
+        _winners[node] = _winners[2 * node] != kNoStream ? _winners[2 * node]
+                                                          : _winners[2 * node + 1];
+    }
+}
+
+void TournamentTree::setKey(size_t stream, StringData key) {
+    invariant(stream < _keys.size());
+    _keys[stream] = key;
+    _replay(stream);
+}
+
+void TournamentTree::clearKey(size_t stream) {
+    invariant(stream < _keys.size());
+    _keys[stream] = boost::none;
+    _replay(stream);
+}
+
+boost::optional<size_t> TournamentTree::top() const {
+    const int winner = _winners[1];
+    if (winner == kNoStream || !_keys[winner]) {
+        return boost::none;
+    }
+
+    return static_cast<size_t>(winner);
+}
+
+bool TournamentTree::_beats(int lhs, int rhs) const {
+    if (rhs == kNoStream || !_keys[rhs]) {
+        return true;
+    }
+    if (lhs == kNoStream || !_keys[lhs]) {
+        return false;
+    }
+
+    // Streams only meet with the lower index on the left, so ties go to 'lhs'.
+    return _keys[lhs]->compare(*_keys[rhs]) <= 0;
+}
+
+void TournamentTree::_replay(size_t stream) {
+    for (size_t node = (_numLeaves + stream) / 2; node >= 1; node /= 2) {
+        const int left = _winners[2 * node];
+        const int right = _winners[2 * node + 1];
+        _winners[node] = _beats(left, right) ? left : right;
+    }
+}
+
+}  // namespace mongo
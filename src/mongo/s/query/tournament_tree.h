@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * A tournament tree for merging a fixed number of sorted streams. Each stream, identified by its
+ * index, either has a current key or has none (it has nothing buffered), and the tree keeps track
+ * of the stream with the smallest key.
+ *
+ * Changing the key of one stream replays only the matches on its path to the root, which costs at
+ * most ceil(log2(numStreams)) key comparisons, against up to twice that for a binary heap.
+ *
+ * Keys are compared as byte strings, so they must be encoded such that byte order is sort order,
+ * as KeyStrings are. The tree does not own the keys: each must stay valid until the key of its
+ * stream is next changed or cleared.
+ */
+class TournamentTree {
+public:
+    explicit TournamentTree(size_t numStreams);
+
+    /**
+     * Sets the current key of 'stream'.
+     */
+    void setKey(size_t stream, StringData key);
+
+    /**
+     * Marks 'stream' as having no current key.
+     */
+    void clearKey(size_t stream);
+
+    /**
+     * Returns the stream with the smallest current key, ties going to the lowest stream index, or
+     * boost::none if no stream has a key.
+     */
+    boost::optional<size_t> top() const;
+
+private:
+    static constexpr int kNoStream = -1;
+
+    /**
+     * Returns true if 'lhs' wins a match against 'rhs'. A stream without a key loses to any stream
+     * with one.
+     */
+    bool _beats(int lhs, int rhs) const;
+
+    /**
+     * Replays the matches on the path from the leaf of 'stream' to the root.
+     */
+    void _replay(size_t stream);
+
+    // The number of leaves, which is the number of streams rounded up to a power of two.
+    size_t _numLeaves;
+
+    // The current key of each stream, if it has one.
+    std::vector<boost::optional<StringData>> _keys;
+
+    // The winner of each match, as a stream index or kNoStream. Laid out as an implicit binary
+    // tree: the root is at 1, the children of node i are at 2i and 2i + 1, and the leaf of stream
+    // s is at _numLeaves + s.
+    std::vector<int> _winners;
+};
+
+}  // namespace mongo
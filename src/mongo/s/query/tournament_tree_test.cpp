@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/tournament_tree.h"
+
+#include <string>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(TournamentTreeTest, NoStreams) {
+    TournamentTree tree(0);
+    ASSERT_FALSE(tree.top());
+}
+
+TEST(TournamentTreeTest, NoKeys) {
+    TournamentTree tree(5);
+    ASSERT_FALSE(tree.top());
+
+    tree.setKey(3, "a");
+    ASSERT_EQ(3U, *tree.top());
+
+    tree.clearKey(3);
+    ASSERT_FALSE(tree.top());
+}
+
+TEST(TournamentTreeTest, TiesGoToLowestStream) {
+    TournamentTree tree(3);
+    tree.setKey(2, "b");
+    tree.setKey(1, "b");
+    ASSERT_EQ(1U, *tree.top());
+
+    tree.setKey(0, "b");
+    ASSERT_EQ(0U, *tree.top());
+
+    // A key which is a prefix of another sorts before it
+    tree.setKey(2, "");
+    ASSERT_EQ(2U, *tree.top());
+}
+
+TEST(TournamentTreeTest, MergesLikeLinearScan) {
+    PseudoRandom random(1);
+
+    for (size_t numStreams : {1, 2, 3, 7, 8, 9, 100}) {
+        TournamentTree tree(numStreams);
+        std::vector<boost::optional<std::string>> keys(numStreams);
+
+        for (int i = 0; i < 2000; ++i) {
+            const size_t stream = random.nextInt32(numStreams);
+            if (random.nextInt32(4) == 0) {
+                keys[stream] = boost::none;
+                tree.clearKey(stream);
+            } else {
+                keys[stream] = std::string(random.nextInt32(3), 'a' + random.nextInt32(3));
+                tree.setKey(stream, *keys[stream]);
+            }
+
+            boost::optional<size_t> expected;
+            for (size_t s = 0; s < numStreams; ++s) {
+                if (keys[s] && (!expected || *keys[s] < *keys[*expected])) {
+                    expected = s;
+                }
+            }
+
+            ASSERT(expected == tree.top());
+        }
+    }
+}
+
+}  // namespace
+}  // namespace mongo
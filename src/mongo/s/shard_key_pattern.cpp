@@ -59,7 +59,8 @@ bool isHashedPatternEl(const BSONElement& el) {
 
 /**
  * Currently the allowable shard keys are either:
- * i) a hashed single field, e.g. { a : "hashed" }, or
+ * i) a hashed field, optionally followed by ascending fields, e.g. { a : "hashed" } or
+ *    { a : "hashed", b.c : 1 }, or
  * ii) a compound list of ascending, potentially-nested field paths, e.g. { a : 1 , b.c : 1 }
  */
 std::vector<std::unique_ptr<FieldRef>> parseShardKeyPattern(const BSONObj& keyPattern) {
@@ -89,12 +90,12 @@ std::vector<std::unique_ptr<FieldRef>> parseShardKeyPattern(const BSONObj& keyPa
                     !newFieldRef->getPart(i).empty());
         }
 
-        // Numeric and ascending (1.0), or "hashed" and single field
+        // Numeric and ascending (1.0), or "hashed" and the first field
         uassert(ErrorCodes::BadValue,
                 str::stream() << "Field " << patternEl.fieldNameStringData()
-                              << " can only be 1 or 'hashed'",
+                              << " can only be 1, or 'hashed' if it is the first field",
                 (patternEl.isNumber() && patternEl.numberInt() == 1) ||
-                    (keyPattern.nFields() == 1 && isHashedPatternEl(patternEl)));
+                    (parsedPaths.empty() && isHashedPatternEl(patternEl)));
 
         parsedPaths.emplace_back(std::move(newFieldRef));
     }
@@ -314,14 +315,16 @@ BSONObj ShardKeyPattern::extractShardKeyFromQuery(const CanonicalQuery& query) c
 
     BSONObjBuilder keyBuilder;
     // Iterate the parsed paths to avoid re-parsing
+    BSONObjIterator patternIt(_keyPattern.toBSON());
     for (auto it = _keyPatternPaths.begin(); it != _keyPatternPaths.end(); ++it) {
         const FieldRef& patternPath = **it;
+        const BSONElement patternEl = patternIt.next();
         BSONElement equalEl = findEqualityElement(equalities, patternPath);
 
         if (!isValidShardKeyElementForStorage(equalEl))
             return BSONObj();
 
-        if (isHashedPattern()) {
+        if (isHashedPatternEl(patternEl)) {
             keyBuilder.append(
                 patternPath.dottedField(),
                 BSONElementHasher::hash64(equalEl, BSONElementHasher::DEFAULT_HASH_SEED));
@@ -336,6 +339,47 @@ BSONObj ShardKeyPattern::extractShardKeyFromQuery(const CanonicalQuery& query) c
     return keyBuilder.obj();
 }
 
+BSONObj ShardKeyPattern::extractShardKeyFromTopLevelEqualities(const BSONObj& query) const {
+    std::vector<BSONElement> equalities(_keyPatternPaths.size());
+    for (auto&& elem : query) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName.startsWith("$"))
+            return BSONObj();
+
+        for (size_t i = 0; i < _keyPatternPaths.size(); ++i) {
+            if (_keyPatternPaths[i]->dottedField() == fieldName) {
+                // Conflicting equalities are left for the query parser to sort out
+                if (!equalities[i].eoo())
+                    return BSONObj();
+                equalities[i] = elem;
+            }
+        }
+    }
+
+    BSONObjBuilder keyBuilder;
+    BSONObjIterator patternIt(_keyPattern.toBSON());
+    for (size_t i = 0; i < _keyPatternPaths.size(); ++i) {
+        const BSONElement patternEl = patternIt.next();
+        const BSONElement& equalEl = equalities[i];
+
+        // An object may hold operators rather than be an equality
+        if (!isValidShardKeyElementForStorage(equalEl) || equalEl.type() == Object ||
+            equalEl.type() == Undefined)
+            return BSONObj();
+
+        if (isHashedPatternEl(patternEl)) {
+            keyBuilder.append(
+                _keyPatternPaths[i]->dottedField(),
+                BSONElementHasher::hash64(equalEl, BSONElementHasher::DEFAULT_HASH_SEED));
+        } else {
+            keyBuilder.appendAs(equalEl, _keyPatternPaths[i]->dottedField());
+        }
+    }
+
+    dassert(isShardKey(keyBuilder.asTempObj()));
+    return keyBuilder.obj();
+}
+
 bool ShardKeyPattern::isUniqueIndexCompatible(const BSONObj& uniqueIndexPattern) const {
     dassert(!KeyPattern::isHashedKeyPattern(uniqueIndexPattern));
 
@@ -62,6 +62,9 @@ typedef std::vector<std::pair<BSONObj, BSONObj>> BoundList;
  *
  * Shard key pattern paths may be nested, but are not traversable through arrays - this means
  * a shard key pattern path always yields a single value.
+ *
+ * The first field of a shard key pattern may be "hashed", in which case the hash of its value
+ * stands in for the value in extracted shard keys. The remaining fields are always ascending.
  */
 class ShardKeyPattern {
 public:
@@ -90,6 +93,10 @@ public:
      */
     explicit ShardKeyPattern(const KeyPattern& keyPattern);
 
+    /**
+     * Returns true if the first field of the pattern is hashed, e.g. {a: "hashed"} or
+     * {a: "hashed", b: 1}.
+     */
     bool isHashedPattern() const;
 
     const KeyPattern& getKeyPattern() const;
@@ -173,6 +180,23 @@ public:
                                                  const BSONObj& basicQuery) const;
     BSONObj extractShardKeyFromQuery(const CanonicalQuery& query) const;
 
+    /**
+     * Like extractShardKeyFromQuery(), but without parsing the query: only finds the shard key
+     * when every key pattern path is a top-level field of 'query' compared to a plain value, and
+     * the query has no top-level operators. Returns an empty BSONObj() otherwise, in which case
+     * the query may still contain the shard key.
+     *
+     * Examples:
+     *  If the key pattern is { a : 1 }
+     *   { a : "hi", b : { $gt : 4 } } --> returns { a : "hi" }
+     *   { a : { $eq : "hi" } } --> returns {}
+     *   { $and : [{ a : "hi" }] } --> returns {}
+     *  If the key pattern is { 'a.b' : 1 }
+     *   { 'a.b' : "hi" } --> returns { 'a.b' : "hi" }
+     *   { a : { b : "hi" } } --> returns {}
+     */
+    BSONObj extractShardKeyFromTopLevelEqualities(const BSONObj& query) const;
+
     /**
      * Returns true if the shard key pattern can ensure that the unique index pattern is
      * respected across all shards.
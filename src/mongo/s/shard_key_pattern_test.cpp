@@ -72,6 +72,33 @@ TEST(ShardKeyPattern, CompositeShardKeyPatternsValidityCheck) {
     ASSERT_THROWS(ShardKeyPattern(BSON("a" << 1 << "" << 1.0)), DBException);
 }
 
+TEST(ShardKeyPattern, CompoundHashedShardKeyPatternsValidityCheck) {
+    ShardKeyPattern(BSON("a"
+                         << "hashed"
+                         << "b"
+                         << 1));
+    ShardKeyPattern(BSON("a.b"
+                         << "hashed"
+                         << "c"
+                         << 1
+                         << "d.e"
+                         << 1.0));
+
+    ASSERT_THROWS(ShardKeyPattern(BSON("a" << 1 << "b"
+                                           << "hashed")),
+                  DBException);
+    ASSERT_THROWS(ShardKeyPattern(BSON("a"
+                                       << "hashed"
+                                       << "b"
+                                       << "hashed")),
+                  DBException);
+    ASSERT_THROWS(ShardKeyPattern(BSON("a"
+                                       << "hashed"
+                                       << "b"
+                                       << -1)),
+                  DBException);
+}
+
 TEST(ShardKeyPattern, NestedShardKeyPatternsValidtyCheck) {
     ShardKeyPattern(BSON("a.b" << 1));
     ShardKeyPattern(BSON("a.b.c.d" << 1.0));
@@ -417,6 +444,66 @@ TEST(ShardKeyPattern, ExtractQueryShardKeyHashed) {
     ASSERT_BSONOBJ_EQ(queryKey(pattern, BSON("a" << BSON_ARRAY(BSON("b" << value)))), BSONObj());
 }
 
+TEST(ShardKeyPattern, ExtractQueryShardKeyCompoundHashed) {
+    const string value = "12345";
+    const BSONObj bsonValue = BSON("" << value);
+    const long long hashValue =
+        BSONElementHasher::hash64(bsonValue.firstElement(), BSONElementHasher::DEFAULT_HASH_SEED);
+
+    // Only the hashed field is hashed, the others are extracted as is
+    ShardKeyPattern pattern(BSON("a"
+                                 << "hashed"
+                                 << "b"
+                                 << 1));
+    ASSERT(pattern.isHashedPattern());
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, BSON("a" << value << "b" << 10)),
+                      BSON("a" << hashValue << "b" << 10));
+    ASSERT_BSONOBJ_EQ(docKey(pattern, BSON("a" << value << "b" << 10 << "c" << 30)),
+                      BSON("a" << hashValue << "b" << 10));
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, BSON("a" << value)), BSONObj());
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, BSON("a" << value << "b" << BSON("$gt" << 10))),
+                      BSONObj());
+}
+
+TEST(ShardKeyPattern, ExtractTopLevelEqualitiesShardKey) {
+    ShardKeyPattern pattern(BSON("a" << 1 << "b.c" << 1));
+    auto topLevelKey = [&](const BSONObj& query) {
+        return pattern.extractShardKeyFromTopLevelEqualities(query);
+    };
+
+    // Whatever is found agrees with parsing the query
+    for (auto&& query : {fromjson("{a:10, 'b.c':'20'}"),
+                         fromjson("{'b.c':'20', a:10, d:{$gt:5}}"),
+                         fromjson("{a:null, 'b.c':[]}"),
+                         fromjson("{a:{$gt:10}, 'b.c':20}")}) {
+        auto key = topLevelKey(query);
+        if (!key.isEmpty()) {
+            ASSERT_BSONOBJ_EQ(queryKey(pattern, query), key);
+        }
+    }
+    ASSERT_BSONOBJ_EQ(topLevelKey(fromjson("{'b.c':'20', a:10, d:{$gt:5}}")),
+                      fromjson("{a:10, 'b.c':'20'}"));
+
+    // Anything that needs the query parser is not found
+    ASSERT_BSONOBJ_EQ(topLevelKey(fromjson("{a:10}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(topLevelKey(fromjson("{a:10, b:{c:20}}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(topLevelKey(fromjson("{a:{$eq:10}, 'b.c':20}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(topLevelKey(fromjson("{a:[10], 'b.c':20}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(topLevelKey(fromjson("{a:10, 'b.c':20, a:11}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(topLevelKey(fromjson("{a:10, 'b.c':20, $or:[{d:1}]}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(topLevelKey(BSON("a" << BSONRegEx("abc") << "b.c" << 20)), BSONObj());
+
+    // Hashed fields are hashed
+    ShardKeyPattern hashedPattern(BSON("a"
+                                       << "hashed"));
+    const BSONObj query = BSON("a"
+                               << "12345"
+                               << "b"
+                               << 1);
+    ASSERT_BSONOBJ_EQ(hashedPattern.extractShardKeyFromTopLevelEqualities(query),
+                      queryKey(hashedPattern, query));
+}
+
 static bool indexComp(const ShardKeyPattern& pattern, const BSONObj& indexPattern) {
     return pattern.isUniqueIndexCompatible(indexPattern);
 }
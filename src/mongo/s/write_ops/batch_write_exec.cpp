@@ -32,12 +32,15 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <deque>
+#include <memory>
+
 #include "mongo/base/error_codes.h"
-#include "mongo/base/owned_pointer_map.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/async_requests_sender.h"
 #include "mongo/s/client/shard_registry.h"
@@ -47,17 +50,20 @@
 #include "mongo/util/log.h"
 
 namespace mongo {
-namespace {
 
-const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly);
+// The number of child batches of an unordered write which may be outstanding on each shard.
+MONGO_EXPORT_SERVER_PARAMETER(BatchWriteExecMaxPendingBatchesPerShard, int, 2)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "BatchWriteExecMaxPendingBatchesPerShard must be at least 1");
+        }
+        return Status::OK();
+    });
 
-//
-// Map which allows associating ConnectionString hosts with TargetedWriteBatches
-// This is needed since the dispatcher only returns hosts with responses.
-//
+namespace {
 
-// TODO: Unordered map?
-typedef OwnedPointerMap<ShardId, TargetedWriteBatch> OwnedShardBatchMap;
+const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly);
 
 WriteErrorDetail errorFromStatus(const Status& status) {
     WriteErrorDetail error;
@@ -91,6 +97,15 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
     BatchWriteOp batchOp(opCtx, clientRequest);
 
+    const bool ordered = clientRequest.getWriteCommandBase().getOrdered();
+
+    // Ordered batches only ever have one child batch per shard at a time. Retryable writes send
+    // one child batch per shard at a time, because the shard runs the requests of a session one
+    // after the other anyway.
+    const size_t maxPendingBatchesPerShard = opCtx->getTxnNumber()
+        ? 1
+        : static_cast<size_t>(BatchWriteExecMaxPendingBatchesPerShard.load());
+
     // Current batch status
     bool refreshedTargeter = false;
     int rounds = 0;
@@ -122,96 +137,101 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         //    exactly when the metadata changed.
         //
 
-        OwnedPointerMap<ShardId, TargetedWriteBatch> childBatchesOwned;
-        std::map<ShardId, TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableMap();
+        // Child batches which have been targeted but not yet sent, in targeting order for each
+        // shard. All of them are owned by 'childBatchesOwned'.
+        std::vector<std::unique_ptr<TargetedWriteBatch>> childBatchesOwned;
+        std::map<ShardId, std::deque<TargetedWriteBatch*>> queuedBatches;
 
         // If we've already had a targeting error, we've refreshed the metadata once and can
         // record target errors definitively.
         bool recordTargetErrors = refreshedTargeter;
-        Status targetStatus = batchOp.targetBatch(targeter, recordTargetErrors, &childBatches);
-        if (!targetStatus.isOK()) {
-            // Don't do anything until a targeter refresh
-            targeter.noteCouldNotTarget();
-            refreshedTargeter = true;
-            ++stats->numTargetErrors;
-            dassert(childBatches.size() == 0u);
+
+        // An unordered batch is targeted in full up front, so that each shard works through its
+        // own queue of child batches without waiting for the other shards. An ordered batch only
+        // targets as far as it can send at once.
+        while (true) {
+            std::map<ShardId, TargetedWriteBatch*> childBatches;
+            Status targetStatus = batchOp.targetBatch(targeter, recordTargetErrors, &childBatches);
+            if (!targetStatus.isOK()) {
+                // Don't do anything until a targeter refresh
+                targeter.noteCouldNotTarget();
+                refreshedTargeter = true;
+                ++stats->numTargetErrors;
+                dassert(childBatches.size() == 0u);
+                break;
+            }
+
+            for (const auto& childBatch : childBatches) {
+                childBatchesOwned.emplace_back(childBatch.second);
+                queuedBatches[childBatch.first].push_back(childBatch.second);
+            }
+
+            if (ordered || childBatches.empty())
+                break;
         }
 
         //
-        // Send all child batches
+        // Send all child batches, keeping up to 'maxPendingBatchesPerShard' outstanding per shard
         //
 
-        const size_t numToSend = childBatches.size();
-        size_t numSent = 0;
-
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedShardBatchMap ownedPendingBatches;
-            OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
-
-            //
-            // Construct the requests.
-            //
+        // The child batch sent by each request, indexed like the requests of the ARS
+        std::vector<TargetedWriteBatch*> sentBatches;
+        std::map<ShardId, size_t> numPendingBatches;
 
+        const auto makeRequestsForQueuedBatches = [&] {
             std::vector<AsyncRequestsSender::Request> requests;
 
-            // Get as many batches as we can at once
-            for (auto& childBatch : childBatches) {
-                TargetedWriteBatch* const nextBatch = childBatch.second;
+            for (auto& shardQueue : queuedBatches) {
+                const auto& targetShardId = shardQueue.first;
+                auto& queue = shardQueue.second;
+                auto& numPending = numPendingBatches[targetShardId];
 
-                // If the batch is nullptr, we sent it previously, so skip
-                if (!nextBatch)
-                    continue;
+                while (!queue.empty() && numPending < maxPendingBatchesPerShard) {
+                    TargetedWriteBatch* const nextBatch = queue.front();
+                    queue.pop_front();
 
-                // If we already have a batch for this shard, wait until the next time
-                const auto& targetShardId = nextBatch->getEndpoint().shardName;
+                    stats->noteTargetedShard(targetShardId);
 
-                if (pendingBatches.count(targetShardId))
-                    continue;
-
-                stats->noteTargetedShard(targetShardId);
+                    const auto request = [&] {
+                        const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
 
-                const auto request = [&] {
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
+                        BSONObjBuilder requestBuilder;
+                        shardBatchRequest.serialize(&requestBuilder);
 
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
+                        {
+                            OperationSessionInfo sessionInfo;
 
-                    {
-                        OperationSessionInfo sessionInfo;
+                            if (opCtx->getLogicalSessionId()) {
+                                sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+                            }
 
-                        if (opCtx->getLogicalSessionId()) {
-                            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+                            sessionInfo.setTxnNumber(opCtx->getTxnNumber());
+                            sessionInfo.serialize(&requestBuilder);
                         }
 
-                        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
-                        sessionInfo.serialize(&requestBuilder);
-                    }
-
-                    return requestBuilder.obj();
-                }();
-
-                LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
+                        return requestBuilder.obj();
+                    }();
 
-                requests.emplace_back(targetShardId, request);
+                    LOG(4) << "Sending write batch to " << targetShardId << ": "
+                           << redact(request);
 
-                // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
-                // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
-                // so this should be pretty efficient without moving stuff around.
-                childBatch.second = nullptr;
-
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.emplace(targetShardId, nextBatch);
+                    requests.emplace_back(targetShardId, request);
+                    sentBatches.push_back(nextBatch);
+                    ++numPending;
+                }
             }
 
+            return requests;
+        };
+
+        if (!childBatchesOwned.empty()) {
             AsyncRequestsSender ars(opCtx,
                                     Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
                                     clientRequest.getTargetingNS().db().toString(),
-                                    requests,
+                                    makeRequestsForQueuedBatches(),
                                     kPrimaryOnlyReadPreference,
                                     opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
                                                           : Shard::RetryPolicy::kNoRetry);
-            numSent += pendingBatches.size();
 
             //
             // Receive the responses.
@@ -222,8 +242,15 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 auto response = ars.next();
 
                 // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
+                invariant(response.requestIndex < sentBatches.size());
+                TargetedWriteBatch* batch = sentBatches[response.requestIndex];
+
+                // Keep the shard busy with its next child batch, if it has any
+                --numPendingBatches[batch->getEndpoint().shardName];
+                auto moreRequests = makeRequestsForQueuedBatches();
+                if (!moreRequests.empty()) {
+                    ars.addRequests(moreRequests);
+                }
 
                 // First check if we were able to target a shard host.
                 if (!response.shardHostAndPort) {
@@ -237,12 +264,6 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                     // and retarget the batch
                     LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
                            << causedBy(response.swResponse.getStatus());
-
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
                     continue;
                 }
 
@@ -64,6 +64,9 @@ public:
      * Executes a client batch write request by sending child batches to several shard
      * endpoints, and returns a client batch write response.
      *
+     * The child batches of an unordered request are sent to each shard as soon as the shard has
+     * room for them, so that a slow shard does not hold up the writes to the others.
+     *
      * This function does not throw, any errors are reported via the clientResponse.
      */
     static void executeBatch(OperationContext* opCtx,
@@ -259,6 +259,18 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // Inserts are targeted in bulk, over windows of the ready write ops ahead of the current one.
+    // The window starts with a single write and doubles each time it is used up, so that ordered
+    // batches, which stop at the first write going to a different shard, target at most about
+    // twice as many writes as they send.
+    const bool bulkTargetInserts =
+        _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert &&
+        !_clientRequest.isInsertIndexRequest();
+
+    std::vector<StatusWith<ShardEndpoint>> bulkEndpoints;
+    size_t nextBulkEndpoint = 0;
+    size_t bulkWindowSize = 1;
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -274,7 +286,28 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        Status targetStatus = Status::OK();
+
+        if (bulkTargetInserts) {
+            if (nextBulkEndpoint == bulkEndpoints.size()) {
+                std::vector<BSONObj> docs;
+                for (size_t j = i; j < numWriteOps && docs.size() < bulkWindowSize; ++j) {
+                    if (_writeOps[j].getWriteState() == WriteOpState_Ready)
+                        docs.push_back(_writeOps[j].getWriteItem().getDocument());
+                }
+
+                bulkEndpoints = targeter.targetInserts(_opCtx, docs);
+                invariant(bulkEndpoints.size() == docs.size());
+
+                nextBulkEndpoint = 0;
+                bulkWindowSize *= 2;
+            }
+
+            targetStatus =
+                writeOp.targetWrites(std::move(bulkEndpoints[nextBulkEndpoint++]), &writes);
+        } else {
+            targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        }
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
@@ -277,26 +277,11 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
     BSONObj shardKey;
 
     if (_routingInfo->cm()) {
-        //
-        // Sharded collections have the following requirements for targeting:
-        //
-        // Inserts must contain the exact shard key.
-        //
+        auto swShardKey = _extractInsertShardKey(doc);
+        if (!swShardKey.isOK())
+            return swShardKey.getStatus();
 
-        shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
-
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return {ErrorCodes::ShardKeyNotFound,
-                    str::stream() << "document " << doc
-                                  << " does not contain shard key for pattern "
-                                  << _routingInfo->cm()->getShardKeyPattern().toString()};
-        }
-
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
-        if (!status.isOK())
-            return status;
+        shardKey = std::move(swShardKey.getValue());
     }
 
     // Target the shard key or database primary
@@ -315,6 +300,52 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
     return Status::OK();
 }
 
+std::vector<StatusWith<ShardEndpoint>> ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    if (!_routingInfo->cm()) {
+        // All inserts into an unsharded collection go to the database primary
+        return NSTargeter::targetInserts(opCtx, docs);
+    }
+
+    // Extract the shard keys of all the documents, keeping the errors of the ones which cannot be
+    // targeted in their place, so that the chunks of the rest can be found in a single pass
+    std::vector<Status> shardKeyStatuses;
+    shardKeyStatuses.reserve(docs.size());
+    std::vector<BSONObj> shardKeys;
+    shardKeys.reserve(docs.size());
+
+    for (const auto& doc : docs) {
+        auto swShardKey = _extractInsertShardKey(doc);
+        shardKeyStatuses.push_back(swShardKey.getStatus());
+        if (swShardKey.isOK()) {
+            shardKeys.push_back(std::move(swShardKey.getValue()));
+        }
+    }
+
+    const auto chunks = _routingInfo->cm()->findIntersectingChunksWithSimpleCollation(shardKeys);
+
+    std::vector<StatusWith<ShardEndpoint>> endpoints;
+    endpoints.reserve(docs.size());
+
+    auto chunkIt = chunks.begin();
+    for (size_t i = 0; i < docs.size(); ++i) {
+        if (!shardKeyStatuses[i].isOK()) {
+            endpoints.push_back(std::move(shardKeyStatuses[i]));
+            continue;
+        }
+
+        const auto& chunk = *(chunkIt++);
+
+        // Track autosplit stats for sharded collections, same as _targetShardKey
+        _stats->chunkSizeDelta[chunk.getMin()] += docs[i].objsize();
+
+        endpoints.push_back(
+            ShardEndpoint(chunk.getShardId(), _routingInfo->cm()->getVersion(chunk.getShardId())));
+    }
+
+    return endpoints;
+}
+
 StatusWith<std::vector<ShardEndpoint>> ChunkManagerTargeter::targetUpdate(
     OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const {
     //
@@ -554,6 +585,30 @@ StatusWith<std::vector<ShardEndpoint>> ChunkManagerTargeter::_targetQuery(
     return endpoints;
 }
 
+StatusWith<BSONObj> ChunkManagerTargeter::_extractInsertShardKey(const BSONObj& doc) const {
+    //
+    // Sharded collections have the following requirements for targeting:
+    //
+    // Inserts must contain the exact shard key.
+    //
+
+    BSONObj shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return {ErrorCodes::ShardKeyNotFound,
+                str::stream() << "document " << doc << " does not contain shard key for pattern "
+                              << _routingInfo->cm()->getShardKeyPattern().toString()};
+    }
+
+    // Check shard key size on insert
+    Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    if (!status.isOK())
+        return status;
+
+    return shardKey;
+}
+
 ShardEndpoint ChunkManagerTargeter::_targetShardKey(const BSONObj& shardKey,
                                                     const BSONObj& collation,
                                                     long long estDataSize) const {
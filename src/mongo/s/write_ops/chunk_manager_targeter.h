@@ -70,6 +70,10 @@ public:
     StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                            const BSONObj& doc) const override;
 
+    // Extracts the shard keys of all the documents first and looks up their chunks together.
+    std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const override;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     StatusWith<std::vector<ShardEndpoint>> targetUpdate(
         OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const override;
@@ -105,6 +109,14 @@ private:
      */
     Status _refreshNow(OperationContext* opCtx);
 
+    /**
+     * Returns the shard key of a document to be inserted into a sharded collection.
+     *
+     * Returns ShardKeyNotFound if the document does not contain the full shard key, or an error if
+     * the shard key is too large.
+     */
+    StatusWith<BSONObj> _extractInsertShardKey(const BSONObj& doc) const;
+
     /**
      * Returns a vector of ShardEndpoints where a document might need to be placed.
      *
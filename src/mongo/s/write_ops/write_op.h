@@ -121,6 +121,13 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as above, but for an insert whose endpoint was already determined by a call to
+     * NSTargeter::targetInserts for several write items at once.
+     */
+    Status targetWrites(StatusWith<ShardEndpoint> swEndpoint,
+                        std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -164,6 +171,12 @@ private:
      */
     void _updateOpState();
 
+    /**
+     * Creates a pending child write for each of 'endpoints' and moves this op to _Pending.
+     */
+    void _addChildWrites(std::vector<ShardEndpoint> endpoints,
+                         std::vector<TargetedWrite*>* targetedWrites);
+
     // Owned elsewhere, reference to a batch with a write item
     const BatchItemRef _itemRef;
 
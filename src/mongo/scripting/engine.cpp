@@ -42,6 +42,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/file.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/text.h"
 
 namespace mongo {
@@ -369,10 +370,62 @@ public:
         return std::shared_ptr<Scope>();
     }
 
+    /**
+     * Returns one of the unused scopes created ahead of time by refillWarm(), if any, so that the
+     * first use of a pool doesn't have to wait for a new JavaScript runtime.
+     */
+    std::shared_ptr<Scope> tryAcquireWarm(OperationContext* opCtx) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        if (_warm.empty()) {
+            return std::shared_ptr<Scope>();
+        }
+
+        std::shared_ptr<Scope> scope = std::move(_warm.back());
+        _warm.pop_back();
+        scope->registerOperation(opCtx);
+        return scope;
+    }
+
+    /**
+     * Creates unused scopes until kNumWarmScopes are available. The scopes are created without
+     * holding the mutex, and only one thread refills at a time.
+     */
+    void refillWarm(ScriptEngine* engine) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_refillingWarm || _warm.size() >= kNumWarmScopes) {
+                return;
+            }
+            _refillingWarm = true;
+        }
+
+        std::vector<std::shared_ptr<Scope>> created;
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            for (auto&& scope : created) {
+                if (_warm.size() < kNumWarmScopes) {
+                    _warm.push_back(std::move(scope));
+                }
+            }
+            _refillingWarm = false;
+        });
+
+        size_t needed;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            needed = kNumWarmScopes - _warm.size();
+        }
+        for (size_t i = 0; i < needed; ++i) {
+            created.emplace_back(engine->newScope());
+        }
+    }
+
     void clear() {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
 
         _pools.clear();
+        _warm.clear();
     }
 
 private:
@@ -384,9 +437,12 @@ private:
     // Note: if these numbers change, reconsider choice of datastructure for _pools
     static const unsigned kMaxPoolSize = 10;
     static const int kMaxScopeReuse = 10;
+    static const size_t kNumWarmScopes = 2;
 
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
+    std::vector<std::shared_ptr<Scope>> _warm;  // protected by _mutex
+    bool _refillingWarm = false;                // protected by _mutex
     stdx::mutex _mutex;
 };
 
@@ -404,6 +460,11 @@ public:
 
     virtual ~PooledScope() {
         scopeCache.release(_pool, _real);
+        try {
+            scopeCache.refillWarm(getGlobalScriptEngine());
+        } catch (const DBException& ex) {
+            LOG(1) << "Unable to create a JavaScript scope ahead of time: " << redact(ex);
+        }
     }
 
     // wrappers for the derived (_real) scope
@@ -547,6 +608,9 @@ unique_ptr<Scope> ScriptEngine::getPooledScope(OperationContext* opCtx,
                                                const string& scopeType) {
     const string fullPoolName = db + scopeType;
     std::shared_ptr<Scope> s = scopeCache.tryAcquire(opCtx, fullPoolName);
+    if (!s) {
+        s = scopeCache.tryAcquireWarm(opCtx);
+    }
     if (!s) {
         s.reset(newScope());
         s->registerOperation(opCtx);
@@ -52,6 +52,10 @@ MONGO_EXPORT_SERVER_PARAMETER(disableJavaScriptJIT, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(javascriptProtection, bool, false);
 MONGO_EXPORT_SERVER_PARAMETER(jsHeapLimitMB, int, 1100);
 
+// Upper bound on the memory used by the bytecode of compiled functions shared between scopes. 0
+// disables the cache.
+MONGO_EXPORT_SERVER_PARAMETER(jsCompiledFunctionCacheSizeKB, int, 16 * 1024);
+
 }  // namespace
 
 void ScriptEngine::setup() {
@@ -71,6 +75,42 @@ std::string ScriptEngine::getInterpreterVersionString() {
 
 namespace mozjs {
 
+CompiledFunctionCache::Bytecode CompiledFunctionCache::find(const std::string& source) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _bySource.find(source);
+    if (it == _bySource.end()) {
+        return nullptr;
+    }
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->second;
+}
+
+void CompiledFunctionCache::insert(const std::string& source, Bytecode bytecode) {
+    const int maxKB = jsCompiledFunctionCacheSizeKB.load();
+    const size_t maxBytes = maxKB > 0 ? static_cast<size_t>(maxKB) * 1024 : 0;
+    const size_t entryBytes = 2 * source.size() + bytecode->size();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (entryBytes > maxBytes || _bySource.count(source)) {
+        _evict_inlock(maxBytes);
+        return;
+    }
+
+    _entries.emplace_front(source, std::move(bytecode));
+    _bySource.emplace(source, _entries.begin());
+    _bytes += entryBytes;
+    _evict_inlock(maxBytes);
+}
+
+void CompiledFunctionCache::_evict_inlock(size_t maxBytes) {
+    while (_bytes > maxBytes) {
+        auto& oldest = _entries.back();
+        _bytes -= 2 * oldest.first.size() + oldest.second->size();
+        _bySource.erase(oldest.first);
+        _entries.pop_back();
+    }
+}
+
 MozJSScriptEngine::MozJSScriptEngine() {
     uassert(ErrorCodes::JSInterpreterFailure, "Failed to JS_Init()", JS_Init());
     js::DisableExtraThreads();
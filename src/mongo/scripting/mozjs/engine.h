@@ -29,6 +29,9 @@
 #pragma once
 
 #include <jsapi.h>
+#include <list>
+#include <memory>
+#include <string>
 
 #include "mongo/scripting/deadline_monitor.h"
 #include "mongo/scripting/engine.h"
@@ -41,6 +44,33 @@ namespace mozjs {
 
 class MozJSImplScope;
 
+/**
+ * Holds compiled functions as XDR-encoded bytecode, keyed by their source, so that any scope can
+ * decode a function instead of compiling it again. The least recently used functions are evicted
+ * once the cache holds more than jsCompiledFunctionCacheSizeKB.
+ */
+class CompiledFunctionCache {
+public:
+    using Bytecode = std::shared_ptr<const std::string>;
+
+    /**
+     * Returns the bytecode of the function compiled from 'source', or null if it isn't cached.
+     */
+    Bytecode find(const std::string& source);
+
+    void insert(const std::string& source, Bytecode bytecode);
+
+private:
+    using Entries = std::list<std::pair<std::string, Bytecode>>;
+
+    void _evict_inlock(size_t maxBytes);
+
+    stdx::mutex _mutex;
+    Entries _entries;  // Most recently used first.
+    stdx::unordered_map<std::string, Entries::iterator> _bySource;
+    size_t _bytes = 0;
+};
+
 /**
  * Implements the global ScriptEngine interface for MozJS.  The associated TU
  * pulls this in for the polymorphic globalScriptEngine.
@@ -84,6 +114,10 @@ public:
         return _deadlineMonitor;
     }
 
+    CompiledFunctionCache& getCompiledFunctionCache() {
+        return _compiledFunctionCache;
+    }
+
 private:
     std::string printKnownOps_inlock();
 
@@ -97,6 +131,8 @@ private:
                                    // _globalInterruptLock).
 
     DeadlineMonitor<MozJSImplScope> _deadlineMonitor;
+
+    CompiledFunctionCache _compiledFunctionCache;
 };
 
 }  // namespace mozjs
@@ -599,6 +599,19 @@ void MozJSImplScope::_MozJSCreateFunction(StringData raw, JS::MutableHandleValue
     std::string code = str::stream()
         << "(" << parseJSFunctionOrExpression(_context, StringData(raw)) << ")";
 
+    // Decoding the bytecode another scope compiled from the same source is cheaper than
+    // compiling it again.
+    auto& cache = _engine->getCompiledFunctionCache();
+    if (auto bytecode = cache.find(code)) {
+        JS::RootedObject funObj(
+            _context, JS_DecodeInterpretedFunction(_context, bytecode->data(), bytecode->size()));
+        if (funObj) {
+            fun.setObject(*funObj);
+            return;
+        }
+        JS_ClearPendingException(_context);
+    }
+
     JS::CompileOptions co(_context);
     setCompileOptions(&co);
 
@@ -606,6 +619,18 @@ void MozJSImplScope::_MozJSCreateFunction(StringData raw, JS::MutableHandleValue
     uassert(10232,
             "not a function",
             fun.isObject() && JS_ObjectIsFunction(_context, fun.toObjectOrNull()));
+
+    // Not every function can be encoded, in which case it just isn't cached.
+    JS::RootedObject funObj(_context, fun.toObjectOrNull());
+    uint32_t length = 0;
+    void* encoded = JS_EncodeInterpretedFunction(_context, funObj, &length);
+    if (!encoded) {
+        JS_ClearPendingException(_context);
+        return;
+    }
+    cache.insert(code,
+                 std::make_shared<const std::string>(static_cast<const char*>(encoded), length));
+    JS_free(_context, encoded);
 }
 
 BSONObj MozJSImplScope::callThreadArgs(const BSONObj& args) {
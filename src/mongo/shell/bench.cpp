@@ -32,6 +32,8 @@
 
 #include "mongo/shell/bench.h"
 
+#include <algorithm>
+#include <cmath>
 #include <pcrecpp.h>
 
 #include "mongo/client/dbclientcursor.h"
@@ -39,6 +41,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/platform/bits.h"
 #include "mongo/scripting/bson_template_evaluator.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/thread.h"
@@ -280,13 +283,89 @@ int runQueryWithReadCommands(DBClientBase* conn,
 
 void doNothing(const BSONObj&) {}
 
+// Values below 2 * kLatencySubBuckets get a bucket of their own. Every power of two above that
+// is split into kLatencySubBuckets buckets.
+const int kLatencySubBucketBits = 5;
+const long long kLatencySubBuckets = 1LL << kLatencySubBucketBits;
+
+size_t latencyBucketIndex(long long micros) {
+    if (micros < 2 * kLatencySubBuckets) {
+        return micros;
+    }
+    const int shift = 63 - countLeadingZeros64(micros) - kLatencySubBucketBits;
+    return (shift + 1) * kLatencySubBuckets + ((micros >> shift) - kLatencySubBuckets);
+}
+
+long long latencyBucketUpperBound(size_t index) {
+    if (index < 2 * kLatencySubBuckets) {
+        return index;
+    }
+    const int shift = index / kLatencySubBuckets - 1;
+    const long long subBucket = index % kLatencySubBuckets + kLatencySubBuckets;
+    return ((subBucket + 1) << shift) - 1;
+}
+
 }  // namespace
 
+void BenchRunLatencyHistogram::record(long long micros) {
+    micros = std::max(micros, 0LL);
+    const size_t index = latencyBucketIndex(micros);
+    if (index >= _buckets.size()) {
+        _buckets.resize(index + 1);
+    }
+    ++_buckets[index];
+    ++_count;
+    _max = std::max(_max, micros);
+}
+
+void BenchRunLatencyHistogram::updateFrom(const BenchRunLatencyHistogram& other) {
+    if (other._buckets.size() > _buckets.size()) {
+        _buckets.resize(other._buckets.size());
+    }
+    for (size_t i = 0; i < other._buckets.size(); ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _max = std::max(_max, other._max);
+}
+
+long long BenchRunLatencyHistogram::getPercentile(double percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+    const auto rank = std::max(
+        1ULL,
+        static_cast<unsigned long long>(std::ceil(std::min(percentile, 100.0) / 100.0 * _count)));
+    unsigned long long seen = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            return std::min(latencyBucketUpperBound(i), _max);
+        }
+    }
+    return _max;
+}
+
+void BenchRunLatencyHistogram::appendPercentiles(BSONObjBuilder* builder) const {
+    builder->append("p50", getPercentile(50));
+    builder->append("p90", getPercentile(90));
+    builder->append("p99", getPercentile(99));
+    builder->append("p99_9", getPercentile(99.9));
+    builder->append("max", _max);
+}
+
 BenchRunEventCounter::BenchRunEventCounter() = default;
 
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _latencies.updateFrom(other._latencies);
+}
+
+void BenchRunIntervalStats::updateFrom(const BenchRunIntervalStats& other) {
+    opCount += other.opCount;
+    errCount += other.errCount;
+    latencies.updateFrom(other.latencies);
 }
 
 void BenchRunStats::updateFrom(const BenchRunStats& other) {
@@ -305,6 +384,13 @@ void BenchRunStats::updateFrom(const BenchRunStats& other) {
     for (const auto& trappedError : other.trappedErrors) {
         trappedErrors.push_back(trappedError);
     }
+
+    if (other.intervals.size() > intervals.size()) {
+        intervals.resize(other.intervals.size());
+    }
+    for (size_t i = 0; i < other.intervals.size(); ++i) {
+        intervals[i].updateFrom(other.intervals[i]);
+    }
 }
 
 BenchRunConfig::BenchRunConfig() {
@@ -331,6 +417,8 @@ void BenchRunConfig::initializeToDefaults() {
     throwGLE = false;
     breakOnTrap = true;
     randomSeed = 1314159265358979323;
+    targetOpsPerSecond = 0;
+    reportIntervalSecs = 0;
 }
 
 BenchRunConfig* BenchRunConfig::createFromBson(const BSONObj& args) {
@@ -607,6 +695,20 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             seconds = arg.number();
+        } else if (name == "targetOpsPerSecond") {
+            uassert(50875,
+                    str::stream() << "Field '" << name
+                                  << "' should be a non-negative number. Type is "
+                                  << typeName(arg.type()),
+                    arg.isNumber() && arg.number() >= 0);
+            targetOpsPerSecond = arg.number();
+        } else if (name == "reportIntervalSecs") {
+            uassert(50876,
+                    str::stream() << "Field '" << name
+                                  << "' should be a non-negative number. Type is "
+                                  << typeName(arg.type()),
+                    arg.isNumber() && arg.number() >= 0);
+            reportIntervalSecs = arg.number();
         } else if (name == "useSessions") {
             uassert(40641,
                     str::stream() << "Field '" << name << "' should be a boolean. . Type is "
@@ -720,6 +822,7 @@ void BenchRunState::tellWorkersToFinish() {
 }
 
 void BenchRunState::tellWorkersToCollectStats() {
+    _collectStatsStartMicros.store(curTimeMicros64());
     _isCollectingStats.store(1);
 }
 
@@ -736,6 +839,10 @@ bool BenchRunState::shouldWorkerCollectStats() const {
     return (_isCollectingStats.loadRelaxed() == 1);
 }
 
+unsigned long long BenchRunState::getCollectStatsStartMicros() const {
+    return _collectStatsStartMicros.load();
+}
+
 void BenchRunState::onWorkerStarted() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     verify(_numUnstartedWorkers > 0);
@@ -775,6 +882,35 @@ bool BenchRunWorker::shouldCollectStats() const {
     return _brState.shouldWorkerCollectStats();
 }
 
+void BenchRunWorker::waitForScheduledStart(const Timer& timer,
+                                           long long intendedStartMicros) const {
+    // Sleep in short slices so that a low target rate doesn't delay the end of the run.
+    const long long kMaxSleepMicros = 100 * 1000;
+    long long remaining;
+    while ((remaining = intendedStartMicros - timer.micros()) > 0 && !shouldStop()) {
+        sleepmicros(std::min(remaining, kMaxSleepMicros));
+    }
+}
+
+void BenchRunWorker::recordInterval(BenchRunStats* stats,
+                                    long long latencyMicros,
+                                    bool failed) const {
+    const unsigned long long startMicros = _brState.getCollectStatsStartMicros();
+    const unsigned long long nowMicros = curTimeMicros64();
+    const size_t index = nowMicros > startMicros
+        ? static_cast<size_t>((nowMicros - startMicros) / (_config->reportIntervalSecs * 1000000))
+        : 0;
+    if (index >= stats->intervals.size()) {
+        stats->intervals.resize(index + 1);
+    }
+    auto& interval = stats->intervals[index];
+    ++interval.opCount;
+    if (failed) {
+        ++interval.errCount;
+    }
+    interval.latencies.record(latencyMicros);
+}
+
 void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
     verify(conn);
     long long count = 0;
@@ -815,6 +951,13 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
     std::unique_ptr<Scope> scope{getGlobalScriptEngine()->newScopeForCurrentThread()};
     verify(scope.get());
 
+    // In open-loop mode every worker owns an equal share of the target rate, and the workers'
+    // schedules are staggered evenly so that their operations don't arrive in bursts.
+    const bool openLoop = _config->targetOpsPerSecond > 0;
+    const double scheduleIntervalMicros =
+        openLoop ? _config->parallel * 1000 * 1000 / _config->targetOpsPerSecond : 0;
+    double intendedStartMicros = scheduleIntervalMicros * _id / _config->parallel;
+
     while (!shouldStop()) {
         for (const auto& op : _config->ops) {
             if (shouldStop())
@@ -837,6 +980,19 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                 invariant(scopeFunc);
             }
 
+            // A LET only evaluates a template locally, so it doesn't take a slot in the schedule.
+            long long scheduleLagMicros = 0;
+            if (openLoop && op.op != OpType::LET) {
+                waitForScheduledStart(timer, intendedStartMicros);
+                if (shouldStop())
+                    break;
+                scheduleLagMicros = std::max(
+                    0LL, timer.micros() - static_cast<long long>(intendedStartMicros));
+                intendedStartMicros += scheduleIntervalMicros;
+            }
+
+            const auto errCountBefore = stats.errCount;
+            Timer opTimer;
             try {
                 switch (op.op) {
                     case OpType::NOP:
@@ -869,7 +1025,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             }
                             invariant(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, scheduleLagMicros);
                             boost::optional<TxnNumber> txnNumberForOp;
                             if (_config->useSnapshotReads) {
                                 ++txnNumber;
@@ -879,7 +1035,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             runQueryWithReadCommands(
                                 conn, lsid, txnNumberForOp, std::move(qr), &result);
                         } else {
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, scheduleLagMicros);
                             result = conn->findOne(op.ns,
                                                    fixedQuery,
                                                    nullptr,
@@ -905,7 +1061,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         bool ok;
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.commandCounter);
+                            BenchRunEventTrace _bret(&stats.commandCounter, scheduleLagMicros);
                             ok = runCommandWithSession(conn,
                                                        op.ns,
                                                        fixQuery(op.command, bsonTemplateEvaluator),
@@ -995,7 +1151,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             }
                             invariant(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.queryCounter);
+                            BenchRunEventTrace _bret(&stats.queryCounter, scheduleLagMicros);
                             boost::optional<TxnNumber> txnNumberForOp;
                             if (_config->useSnapshotReads) {
                                 ++txnNumber;
@@ -1007,7 +1163,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         } else {
                             // Use special query function for exhaust query option.
                             if (op.options & QueryOption_Exhaust) {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, scheduleLagMicros);
                                 stdx::function<void(const BSONObj&)> castedDoNothing(doNothing);
                                 count = conn->query(
                                     castedDoNothing,
@@ -1016,7 +1172,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                                     &op.projection,
                                     op.options | DBClientCursor::QueryOptionLocal_forceOpQuery);
                             } else {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, scheduleLagMicros);
                                 std::unique_ptr<DBClientCursor> cursor(conn->query(
                                     op.ns,
                                     fixedQuery,
@@ -1054,7 +1210,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::UPDATE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.updateCounter);
+                            BenchRunEventTrace _bret(&stats.updateCounter, scheduleLagMicros);
                             BSONObj query = fixQuery(op.query, bsonTemplateEvaluator);
                             BSONObj update = fixQuery(op.update, bsonTemplateEvaluator);
 
@@ -1119,7 +1275,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::INSERT: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.insertCounter);
+                            BenchRunEventTrace _bret(&stats.insertCounter, scheduleLagMicros);
 
                             BSONObj insertDoc;
                             if (op.useWriteCmd) {
@@ -1196,7 +1352,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::REMOVE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.deleteCounter);
+                            BenchRunEventTrace _bret(&stats.deleteCounter, scheduleLagMicros);
                             BSONObj predicate = fixQuery(op.query, bsonTemplateEvaluator);
                             if (op.useWriteCmd) {
                                 BSONObjBuilder builder;
@@ -1315,6 +1471,12 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                 stats.errCount++;
             }
 
+            if (&stats == &_stats && _config->reportIntervalSecs > 0) {
+                recordInterval(&stats,
+                               opTimer.micros() + scheduleLagMicros,
+                               stats.errCount != errCountBefore);
+            }
+
             if (++count % 100 == 0 && !op.useWriteCmd) {
                 conn->getLastError();
             }
@@ -1471,6 +1633,21 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendAverageMicrosIfAvailable("queryLatencyAverageMicros", stats.queryCounter);
     appendAverageMicrosIfAvailable("commandsLatencyAverageMicros", stats.commandCounter);
 
+    const auto appendPercentilesIfAvailable = [&buf](StringData name,
+                                                     const BenchRunEventCounter& counter) {
+        if (counter.getNumEvents() > 0) {
+            BSONObjBuilder percentiles(buf.subobjStart(name));
+            counter.getLatencies().appendPercentiles(&percentiles);
+        }
+    };
+
+    appendPercentilesIfAvailable("findOneLatencyPercentilesMicros", stats.findOneCounter);
+    appendPercentilesIfAvailable("insertLatencyPercentilesMicros", stats.insertCounter);
+    appendPercentilesIfAvailable("deleteLatencyPercentilesMicros", stats.deleteCounter);
+    appendPercentilesIfAvailable("updateLatencyPercentilesMicros", stats.updateCounter);
+    appendPercentilesIfAvailable("queryLatencyPercentilesMicros", stats.queryCounter);
+    appendPercentilesIfAvailable("commandsLatencyPercentilesMicros", stats.commandCounter);
+
     buf.append("totalOps", static_cast<long long>(stats.opCount));
 
     const auto appendPerSec = [&buf, runner](StringData name, double total) {
@@ -1485,6 +1662,32 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendPerSec("query", stats.queryCounter.getNumEvents());
     appendPerSec("command", stats.commandCounter.getNumEvents());
 
+    const auto& config = runner->config();
+    if (config.targetOpsPerSecond > 0) {
+        buf.append("targetOps/s", config.targetOpsPerSecond);
+    }
+
+    if (config.reportIntervalSecs > 0) {
+        const double elapsedSecs = runner->_microsElapsed / 1000000.0;
+        BSONArrayBuilder intervals(buf.subarrayStart("intervals"));
+        for (size_t i = 0; i < stats.intervals.size(); ++i) {
+            const auto& interval = stats.intervals[i];
+            const double startSecs = i * config.reportIntervalSecs;
+            // The last interval is usually cut short by the end of the run.
+            const double lengthSecs = std::min(config.reportIntervalSecs, elapsedSecs - startSecs);
+
+            BSONObjBuilder intervalBuilder(intervals.subobjStart());
+            intervalBuilder.append("startSecs", startSecs);
+            intervalBuilder.append("totalOps", static_cast<long long>(interval.opCount));
+            intervalBuilder.append("errCount", static_cast<long long>(interval.errCount));
+            if (lengthSecs > 0) {
+                intervalBuilder.append("totalOps/s", interval.opCount / lengthSecs);
+            }
+            BSONObjBuilder percentiles(intervalBuilder.subobjStart("latencyPercentilesMicros"));
+            interval.latencies.appendPercentiles(&percentiles);
+        }
+    }
+
     BSONObj zoo = buf.obj();
 
     delete runner;
@@ -30,6 +30,7 @@
 
 #include <boost/optional.hpp>
 #include <string>
+#include <vector>
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/jsobj.h"
@@ -156,6 +157,21 @@ public:
      */
     double seconds;
 
+    /**
+     * Aggregate rate, across all threads, at which operations should be issued. When zero, each
+     * thread issues its next operation as soon as the previous one completes. Otherwise each
+     * thread runs open-loop against a fixed schedule of intended start times, and operation
+     * latencies are measured from the intended start rather than from when the request was
+     * actually sent, so that time spent queued behind a slow operation is not hidden.
+     */
+    double targetOpsPerSecond{0};
+
+    /**
+     * Length, in seconds, of the intervals over which throughput and latency percentiles are
+     * reported as a time series. Zero disables the time series.
+     */
+    double reportIntervalSecs{0};
+
     /**
      * Whether the individual benchRun thread connections should be creating and using sessions.
      */
@@ -203,6 +219,52 @@ private:
     void initializeToDefaults();
 };
 
+/**
+ * A histogram of latencies, in microseconds, with bounded relative error.
+ *
+ * Values below 64 are counted exactly. Above that, every power of two is split into 32
+ * equally sized buckets, so a reported percentile is never more than about 3% above the value it
+ * stands for. Buckets are allocated on demand, so an empty histogram is cheap.
+ *
+ * Not thread safe.
+ */
+class BenchRunLatencyHistogram {
+public:
+    /**
+     * Record one event which took "micros" microseconds. Negative values are recorded as zero.
+     */
+    void record(long long micros);
+
+    /**
+     * Conceptually the equivalent of "+=". Adds the events recorded in "other" into this.
+     */
+    void updateFrom(const BenchRunLatencyHistogram& other);
+
+    /**
+     * Returns the smallest recorded value such that at least "percentile" percent of the events
+     * took no longer than it, rounded up to its bucket's upper bound. Returns 0 if empty.
+     */
+    long long getPercentile(double percentile) const;
+
+    unsigned long long getCount() const {
+        return _count;
+    }
+
+    long long getMax() const {
+        return _max;
+    }
+
+    /**
+     * Appends the median, the 90th, 99th and 99.9th percentiles and the maximum to "builder".
+     */
+    void appendPercentiles(BSONObjBuilder* builder) const;
+
+private:
+    std::vector<unsigned long long> _buckets;
+    unsigned long long _count{0};
+    long long _max{0};
+};
+
 /**
  * An event counter for events that have an associated duration.
  *
@@ -223,6 +285,7 @@ public:
     void countOne(long long timeMicros) {
         ++_numEvents;
         _totalTimeMicros += timeMicros;
+        _latencies.record(timeMicros);
     }
 
     /**
@@ -239,9 +302,17 @@ public:
         return _numEvents;
     }
 
+    /**
+     * Get the distribution of the durations of the observed events.
+     */
+    const BenchRunLatencyHistogram& getLatencies() const {
+        return _latencies;
+    }
+
 private:
     long long _totalTimeMicros{0};
     unsigned long long _numEvents{0};
+    BenchRunLatencyHistogram _latencies;
 };
 
 /**
@@ -261,7 +332,13 @@ class BenchRunEventTrace {
     MONGO_DISALLOW_COPYING(BenchRunEventTrace);
 
 public:
-    explicit BenchRunEventTrace(BenchRunEventCounter* eventCounter) {
+    /**
+     * "scheduleLagMicros" is how long after its intended start time the event actually started,
+     * and is added to the measured duration.
+     */
+    explicit BenchRunEventTrace(BenchRunEventCounter* eventCounter,
+                                long long scheduleLagMicros = 0)
+        : _scheduleLagMicros(scheduleLagMicros) {
         initialize(eventCounter, eventCounter, false);
     }
 
@@ -272,7 +349,8 @@ public:
     }
 
     ~BenchRunEventTrace() {
-        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros());
+        (_succeeded ? _successCounter : _failCounter)
+            ->countOne(_timer.micros() + _scheduleLagMicros);
     }
 
     void succeed() {
@@ -292,11 +370,23 @@ private:
     }
 
     Timer _timer;
+    long long _scheduleLagMicros{0};
     BenchRunEventCounter* _successCounter;
     BenchRunEventCounter* _failCounter;
     bool _succeeded;
 };
 
+/**
+ * Throughput and latency of all operations completed during one reporting interval.
+ */
+struct BenchRunIntervalStats {
+    void updateFrom(const BenchRunIntervalStats& other);
+
+    unsigned long long opCount{0};
+    unsigned long long errCount{0};
+    BenchRunLatencyHistogram latencies;
+};
+
 /**
  * Statistics object representing the result of a bench run activity.
  */
@@ -317,6 +407,10 @@ struct BenchRunStats {
 
     std::map<std::string, long long> opcounters;
     std::vector<BSONObj> trappedErrors;
+
+    // Indexed by the number of whole reporting intervals elapsed since stats collection began.
+    // Only populated when BenchRunConfig::reportIntervalSecs is set.
+    std::vector<BenchRunIntervalStats> intervals;
 };
 
 /**
@@ -376,6 +470,12 @@ public:
     */
     bool shouldWorkerCollectStats() const;
 
+    /**
+     * Time, per curTimeMicros64(), at which the workers were told to start collecting stats.
+     * Only meaningful once shouldWorkerCollectStats() returns true.
+     */
+    unsigned long long getCollectStatsStartMicros() const;
+
     /**
      * Called by each BenchRunWorker from within its thread context, immediately before it
      * starts sending requests to the configured mongo instance.
@@ -398,6 +498,7 @@ private:
 
     AtomicUInt32 _isShuttingDown;
     AtomicUInt32 _isCollectingStats;
+    AtomicUInt64 _collectStatsStartMicros;
 };
 
 /**
@@ -449,6 +550,12 @@ private:
     /// Predicate, used to decide whether or not it's time to collect statistics
     bool shouldCollectStats() const;
 
+    /// In open-loop mode, sleeps until "intendedStartMicros" on "timer", unless told to stop.
+    void waitForScheduledStart(const Timer& timer, long long intendedStartMicros) const;
+
+    /// Counts an operation into the reporting interval in which it completed.
+    void recordInterval(BenchRunStats* stats, long long latencyMicros, bool failed) const;
+
     const size_t _id;
 
     const BenchRunConfig* _config;
@@ -1533,6 +1533,8 @@ PlanCache.prototype.help = function() {
           "displays all query shapes in a collection");
     print("\tdb." + shortName + ".getPlanCache().clear() - " +
           "drops all cached queries in a collection");
+    print("\tdb." + shortName + ".getPlanCache().warm(shapes) - " +
+          "plans and caches query shapes in the format returned by listQueryShapes()");
     print("\tdb." + shortName +
           ".getPlanCache().clearPlansByQuery(query[, projection, sort, collation]) - " +
           "drops query shape from plan cache");
@@ -1629,6 +1631,13 @@ PlanCache.prototype.clear = function() {
     return;
 };
 
+/**
+ * Plans and caches each query shape in 'shapes', as returned by listQueryShapes().
+ */
+PlanCache.prototype.warm = function(shapes) {
+    return this._runCommandThrowOnError("planCacheWarm", {shapes: shapes});
+};
+
 /**
  * List plans for a query shape.
  */
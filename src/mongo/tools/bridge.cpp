@@ -45,6 +45,7 @@
 #include "mongo/rpc/command_request.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
@@ -276,6 +277,15 @@ DbResponse ServiceEntryPointBridge::handleRequest(OperationContext* opCtx, const
             response = uassertStatusOK(compressorMgr.decompressMessage(response));
         }
 
+        if (response.operation() == dbMsg) {
+            // An OP_MSG stream ends with the first reply that doesn't have moreToCome set.
+            if (OpMsg::isFlagSet(response, OpMsg::kMoreToCome)) {
+                return {std::move(response), "", rpc::opMsgRequestFromAnyProtocol(request).body};
+            }
+            dest.setExhaust(false);
+            return {std::move(response)};
+        }
+
         MsgData::View header = response.header();
         QueryResult::View qr = header.view2ptr();
         if (qr.getCursorId()) {
@@ -357,7 +367,6 @@ DbResponse ServiceEntryPointBridge::handleRequest(OperationContext* opCtx, const
     if (!isFireAndForgetCommand &&
         (request.operation() == dbQuery || request.operation() == dbGetMore ||
          request.operation() == dbCommand || request.operation() == dbMsg)) {
-        // TODO dbMsg moreToCome
         // Forward the message to 'dest' and receive its reply in 'response'.
         auto response = uassertStatusOK(dest->sourceMessage());
         uassert(50765,
@@ -377,6 +386,20 @@ DbResponse ServiceEntryPointBridge::handleRequest(OperationContext* opCtx, const
             return {Message()};
         }
 
+        // If 'dest' started streaming OP_MSG replies, keep passing them on to 'source' without
+        // waiting for requests it will never send.
+        if (request.operation() == dbMsg &&
+            OpMsg::isFlagSet(request, OpMsg::kExhaustSupported)) {
+            if (response.operation() == dbCompressed) {
+                MessageCompressorManager compressorMgr;
+                response = uassertStatusOK(compressorMgr.decompressMessage(response));
+            }
+            if (OpMsg::isFlagSet(response, OpMsg::kMoreToCome)) {
+                dest.setExhaust(true);
+                return {std::move(response), "", cmdRequest->body};
+            }
+        }
+
         std::string exhaustNS;
         if (request.operation() == dbQuery) {
             DbMessage d(request);
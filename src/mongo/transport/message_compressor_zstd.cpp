@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd.h"
+
+#include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/util/mongoutils/str.h"
+
+#include <zstd.h>
+
+namespace mongo {
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(zstdNetworkMessageCompressionLevel, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 19) {
+            return Status(ErrorCodes::BadValue,
+                          "zstdNetworkMessageCompressionLevel must be between 0 (adaptive) and 19");
+        }
+        return Status::OK();
+    });
+
+// Compression and decompression contexts are expensive to create, so each thread keeps one of
+// each for its lifetime rather than allocating them for every message.
+struct ZstdContextDeleter {
+    void operator()(ZSTD_CCtx* ctx) const {
+        ZSTD_freeCCtx(ctx);
+    }
+    void operator()(ZSTD_DCtx* ctx) const {
+        ZSTD_freeDCtx(ctx);
+    }
+};
+
+thread_local std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> compressionContext;
+thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> decompressionContext;
+
+ZSTD_CCtx* getCompressionContext() {
+    if (!compressionContext) {
+        compressionContext.reset(ZSTD_createCCtx());
+        invariant(compressionContext);
+    }
+    return compressionContext.get();
+}
+
+ZSTD_DCtx* getDecompressionContext() {
+    if (!decompressionContext) {
+        decompressionContext.reset(ZSTD_createDCtx());
+        invariant(decompressionContext);
+    }
+    return decompressionContext.get();
+}
+
+}  // namespace
+
+ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
+
+int ZstdMessageCompressor::adaptiveLevel(size_t inputSize) {
+    if (inputSize <= 16 * 1024) {
+        return 6;
+    }
+    if (inputSize <= 1024 * 1024) {
+        return 3;
+    }
+    return 1;
+}
+
+std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    int level = zstdNetworkMessageCompressionLevel.load();
+    if (level == 0) {
+        level = adaptiveLevel(input.length());
+    }
+
+    size_t ret = ZSTD_compressCCtx(getCompressionContext(),
+                                   const_cast<char*>(output.data()),
+                                   output.length(),
+                                   input.data(),
+                                   input.length(),
+                                   level);
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    size_t ret = ZSTD_decompressDCtx(getDecompressionContext(),
+                                     const_cast<char*>(output.data()),
+                                     output.length(),
+                                     input.data(),
+                                     input.length());
+
+    if (ZSTD_isError(ret) || ret != output.length()) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    counterHitDecompress(input.length(), output.length());
+    return {output.length()};
+}
+
+
+MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    compressorRegistry.registerImplementation(stdx::make_unique<ZstdMessageCompressor>());
+    return Status::OK();
+}
+}  // namespace mongo
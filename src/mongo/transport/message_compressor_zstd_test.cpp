@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd.h"
+
+#include "mongo/unittest/unittest.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace mongo {
+namespace {
+
+std::string buildTestData(size_t size) {
+    const std::string pattern = "{find: \"coll\", filter: {_id: 1234}, $db: \"test\"} ";
+    std::string data;
+    while (data.size() < size) {
+        data += pattern;
+    }
+    data.resize(size);
+    return data;
+}
+
+void checkRoundTrip(const std::string& data) {
+    ZstdMessageCompressor compressor;
+    ConstDataRange input(data.data(), data.size());
+
+    std::vector<char> compressed(compressor.getMaxCompressedSize(data.size()));
+    auto sws = compressor.compressData(input, DataRange(compressed.data(), compressed.size()));
+    ASSERT_OK(sws);
+    ASSERT_LT(sws.getValue(), data.size());
+
+    std::vector<char> decompressed(data.size());
+    ASSERT_OK(compressor.decompressData(ConstDataRange(compressed.data(), sws.getValue()),
+                                        DataRange(decompressed.data(), decompressed.size())));
+    ASSERT_EQ(memcmp(decompressed.data(), data.data(), data.size()), 0);
+}
+
+TEST(ZstdMessageCompressor, RoundTripsSmallMessage) {
+    checkRoundTrip(buildTestData(200));
+}
+
+TEST(ZstdMessageCompressor, RoundTripsLargeMessage) {
+    checkRoundTrip(buildTestData(4 * 1024 * 1024));
+}
+
+TEST(ZstdMessageCompressor, AdaptiveLevelDecreasesWithSize) {
+    ASSERT_GT(ZstdMessageCompressor::adaptiveLevel(1024),
+              ZstdMessageCompressor::adaptiveLevel(512 * 1024));
+    ASSERT_GT(ZstdMessageCompressor::adaptiveLevel(512 * 1024),
+              ZstdMessageCompressor::adaptiveLevel(8 * 1024 * 1024));
+}
+
+TEST(ZstdMessageCompressor, Overflow) {
+    ZstdMessageCompressor compressor;
+    const std::string data = buildTestData(1000);
+    ConstDataRange input(data.data(), data.size());
+
+    std::array<char, 16> smallBuffer;
+    DataRange smallOutput(smallBuffer.data(), smallBuffer.size());
+
+    std::vector<char> normalBuffer(compressor.getMaxCompressedSize(data.size()));
+    auto sws = compressor.compressData(input, DataRange(normalBuffer.data(), normalBuffer.size()));
+    ASSERT_OK(sws);
+    ConstDataRange normalRange(normalBuffer.data(), sws.getValue());
+
+    // Compressing into, and decompressing into, a buffer that is too small must fail.
+    ASSERT_NOT_OK(compressor.compressData(input, smallOutput));
+    ASSERT_NOT_OK(compressor.decompressData(normalRange, smallOutput));
+
+    // Decompressing a truncated frame must fail without reading past the input.
+    std::vector<char> scratch(data.size());
+    ConstDataRange truncated(normalBuffer.data(), sws.getValue() / 2);
+    ASSERT_NOT_OK(compressor.decompressData(truncated, DataRange(scratch.data(), scratch.size())));
+}
+
+}  // namespace
+}  // namespace mongo
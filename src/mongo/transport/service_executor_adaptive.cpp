@@ -42,6 +42,7 @@
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa_placement.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/stringutils.h"
@@ -79,6 +80,15 @@ MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorIdlePctThreshold, int, 60);
 // value.
 MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorRecursionLimit, int, 8);
 
+// Tasks scheduled from within a task are kept on the scheduling worker's own run queue, so that a
+// connection keeps running on the same thread, instead of going through the shared reactor queue.
+// Workers which stay busy for longer than the max queue latency have their queue stolen.
+MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorLocalRunQueues, bool, false);
+
+// The most tasks a worker runs off its local queue in a row before handing the rest to the reactor,
+// so that it regularly gets back to servicing network events.
+constexpr int kMaxLocalTasksPerDrain = 64;
+
 constexpr auto kTotalQueued = "totalQueued"_sd;
 constexpr auto kTotalExecuted = "totalExecuted"_sd;
 constexpr auto kTotalTimeExecutingUs = "totalTimeExecutingMicros"_sd;
@@ -93,6 +103,8 @@ constexpr auto kStuckDetection = "stuckThreadsDetected"_sd;
 constexpr auto kStarvation = "starvation"_sd;
 constexpr auto kReserveMinimum = "belowReserveMinimum"_sd;
 constexpr auto kThreadReasons = "threadCreationCauses"_sd;
+constexpr auto kTotalLocalQueued = "totalLocalQueued"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
 
 int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
     invariant(tickSource->getTicksPerSecond() >= 1000000);
@@ -145,6 +157,10 @@ struct ServerParameterOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return adaptiveServiceExecutorRecursionLimit.load();
     }
+
+    bool localRunQueues() const final {
+        return adaptiveServiceExecutorLocalRunQueues.load();
+    }
 };
 
 }  // namespace
@@ -212,35 +228,43 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
 
     auto wrappedTask =
         [ this, task = std::move(task), scheduleTime, pendingCounterPtr, taskName, flags ] {
-        pendingCounterPtr->subtractAndFetch(1);
-        auto start = _tickSource->getTicks();
-        _totalSpentQueued.addAndFetch(start - scheduleTime);
+        {
+            pendingCounterPtr->subtractAndFetch(1);
+            auto start = _tickSource->getTicks();
+            _totalSpentQueued.addAndFetch(start - scheduleTime);
 
-        _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
-            ._totalSpentQueued.addAndFetch(start - scheduleTime);
+            _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
+                ._totalSpentQueued.addAndFetch(start - scheduleTime);
 
-        if (_localThreadState->recursionDepth++ == 0) {
-            _localThreadState->executing.markRunning();
-            _threadsInUse.addAndFetch(1);
-        }
-        const auto guard = MakeGuard([this, taskName] {
-            if (--_localThreadState->recursionDepth == 0) {
-                _localThreadState->executingCurRun += _localThreadState->executing.markStopped();
-                _threadsInUse.subtractAndFetch(1);
+            if (_localThreadState->recursionDepth++ == 0) {
+                _localThreadState->executing.markRunning();
+                _threadsInUse.addAndFetch(1);
             }
-            _totalExecuted.addAndFetch(1);
+            const auto guard = MakeGuard([this, taskName] {
+                if (--_localThreadState->recursionDepth == 0) {
+                    _localThreadState->executingCurRun +=
+                        _localThreadState->executing.markStopped();
+                    _threadsInUse.subtractAndFetch(1);
+                }
+                _totalExecuted.addAndFetch(1);
+                _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
+                    ._totalExecuted.addAndFetch(1);
+            });
+
+            TickTimer _localTimer(_tickSource);
+            task();
             _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
-                ._totalExecuted.addAndFetch(1);
-        });
+                ._totalSpentExecuting.addAndFetch(_localTimer.sinceStartTicks());
 
-        TickTimer _localTimer(_tickSource);
-        task();
-        _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
-            ._totalSpentExecuting.addAndFetch(_localTimer.sinceStartTicks());
+            if ((flags & ServiceExecutor::kMayYieldBeforeSchedule) &&
+                (_localThreadState->markIdleCounter++ & 0xf)) {
+                markThreadIdle();
+            }
+        }
 
-        if ((flags & ServiceExecutor::kMayYieldBeforeSchedule) &&
-            (_localThreadState->markIdleCounter++ & 0xf)) {
-            markThreadIdle();
+        // Run what this task left on the local queue, now that its stack has unwound.
+        if (_localThreadState->recursionDepth == 0 && !_localThreadState->drainingLocalQueue) {
+            _drainLocalQueue();
         }
     };
 
@@ -251,9 +275,17 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     //
     // If the task is allowed to recurse and we are not over the depth limit, dispatch it so it
     // can be called immediately and recursively.
+    //
+    // Otherwise, if it is scheduled from within a task on a worker thread, it can go on that
+    // worker's local queue, which the worker drains when the current task completes.
     if ((flags & kMayRecurse) &&
         (_localThreadState->recursionDepth + 1 < _config->recursionLimit())) {
         _reactorHandle->schedule(Reactor::kDispatch, std::move(wrappedTask));
+    } else if (_localThreadState && _localThreadState->recursionDepth > 0 &&
+               _config->localRunQueues()) {
+        stdx::lock_guard<stdx::mutex> lk(_localThreadState->localQueueMutex);
+        _localThreadState->localQueue.emplace_back(scheduleTime, std::move(wrappedTask));
+        _totalLocalQueued.addAndFetch(1);
     } else {
         _reactorHandle->schedule(Reactor::kPost, std::move(wrappedTask));
     }
@@ -274,6 +306,62 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     return Status::OK();
 }
 
+void ServiceExecutorAdaptive::_drainLocalQueue() {
+    auto state = _localThreadState;
+    state->drainingLocalQueue = true;
+    const auto guard = MakeGuard([state] { state->drainingLocalQueue = false; });
+
+    for (int ran = 0; ran < kMaxLocalTasksPerDrain; ran++) {
+        Task next;
+        {
+            stdx::lock_guard<stdx::mutex> lk(state->localQueueMutex);
+            if (state->localQueue.empty()) {
+                return;
+            }
+            next = std::move(state->localQueue.front().second);
+            state->localQueue.pop_front();
+        }
+        next();
+    }
+
+    _stealLocalQueue(state);
+}
+
+int ServiceExecutorAdaptive::_stealLocalQueue(ThreadState* state) {
+    std::deque<std::pair<TickSource::Tick, Task>> stolen;
+    {
+        stdx::lock_guard<stdx::mutex> lk(state->localQueueMutex);
+        stolen.swap(state->localQueue);
+    }
+
+    // The tasks keep their original schedule time, so the time they spent on the local queue is
+    // accounted as queued time.
+    for (auto& task : stolen) {
+        _reactorHandle->schedule(Reactor::kPost, std::move(task.second));
+    }
+    return static_cast<int>(stolen.size());
+}
+
+void ServiceExecutorAdaptive::_stealStaleLocalQueues() {
+    const auto now = _tickSource->getTicks();
+    const auto maxQueueLatencyTicks =
+        durationCount<Microseconds>(_config->maxQueueLatency()) *
+        (_tickSource->getTicksPerSecond() / 1000000);
+
+    stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+    for (auto& thread : _threads) {
+        bool stale;
+        {
+            stdx::lock_guard<stdx::mutex> queueLk(thread.localQueueMutex);
+            stale = !thread.localQueue.empty() &&
+                now - thread.localQueue.front().first > maxQueueLatencyTicks;
+        }
+        if (stale) {
+            _totalStolen.addAndFetch(_stealLocalQueue(&thread));
+        }
+    }
+}
+
 bool ServiceExecutorAdaptive::_isStarved() const {
     // If threads are still starting, then assume we won't be starved pretty soon, return false
     if (_threadsPending.load() > 0)
@@ -361,6 +449,12 @@ void ServiceExecutorAdaptive::_controllerThreadRoutine() {
         if (!_isRunning.load())
             break;
 
+        // Tasks stuck behind a busy or blocked worker are handed to the reactor for any worker to
+        // pick up, before considering whether more threads are needed.
+        if (_config->localRunQueues()) {
+            _stealStaleLocalQueues();
+        }
+
         if (sinceLastStuckThreadCheck.sinceStart() >= stuckThreadTimeout) {
             // Reset our timer so we know how long to sleep for the next time around;
             sinceLastStuckThreadCheck.reset();
@@ -448,6 +542,10 @@ void ServiceExecutorAdaptive::_controllerThreadRoutine() {
         } while ((_threadsPending.load() > 0) &&
                  (sinceLastStuckThreadCheck.sinceStart() < stuckThreadTimeout));
 
+        if (_config->localRunQueues()) {
+            _stealStaleLocalQueues();
+        }
+
         // If the number of pending tasks is greater than the number of running threads minus the
         // number of tasks executing (the number of free threads), then start a new worker to
         // avoid starvation.
@@ -558,6 +656,7 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
         std::string threadName = str::stream() << "worker-" << threadId;
         setThreadName(threadName);
     }
+    NumaPlacement::get().placeCurrentThread(NumaPlacement::ThreadKind::kWorker);
 
     log() << "Started new database worker thread " << threadId;
 
@@ -569,6 +668,7 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
         _pastThreadsSpentExecuting.addAndFetch(state->executing.totalTime());
 
         _accumulateTaskMetrics(&_accumulatedMetrics, state->threadMetrics);
+        _stealLocalQueue(&(*state));
         {
             stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
             _threads.erase(state);
@@ -675,7 +775,9 @@ void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
             << ticksToMicros(_getThreadTimerTotal(ThreadTimer::kExecuting, lk), _tickSource)  //
             << kTotalTimeQueuedUs << ticksToMicros(_totalSpentQueued.load(), _tickSource)     //
             << kThreadsRunning << _threadsRunning.load()                                      //
-            << kThreadsPending << _threadsPending.load();
+            << kThreadsPending << _threadsPending.load()                                      //
+            << kTotalLocalQueued << _totalLocalQueued.load()                                  //
+            << kTotalStolen << _totalStolen.load();
 
     BSONObjBuilder threadStartReasons(section.subobjStart(kThreadReasons));
     for (size_t i = 0; i < _threadStartCounters.size(); i++) {
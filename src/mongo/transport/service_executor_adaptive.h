@@ -29,6 +29,7 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include <vector>
 
 #include "mongo/db/service_context.h"
@@ -79,6 +80,10 @@ public:
         // The maximum allowable depth of recursion for tasks scheduled with the MayRecurse flag
         // before stack unwinding is forced.
         virtual int recursionLimit() const = 0;
+
+        // Whether tasks scheduled from a worker thread are queued on that worker, to run once its
+        // current task completes, rather than on the shared reactor.
+        virtual bool localRunQueues() const = 0;
     };
 
     explicit ServiceExecutorAdaptive(ServiceContext* ctx, ReactorHandle reactor);
@@ -188,6 +193,13 @@ private:
         MetricsArray threadMetrics;
         std::int64_t markIdleCounter = 0;
         int recursionDepth = 0;
+
+        // Tasks scheduled by this worker, which it runs itself once its current task is done unless
+        // the controller thread hands them to the reactor first. Guarded by localQueueMutex, which
+        // only the controller contends for.
+        stdx::mutex localQueueMutex;
+        std::deque<std::pair<TickSource::Tick, Task>> localQueue;
+        bool drainingLocalQueue = false;
     };
 
     using ThreadList = stdx::list<ThreadState>;
@@ -197,6 +209,24 @@ private:
     void _workerThreadRoutine(int threadId, ThreadList::iterator it);
     void _controllerThreadRoutine();
     bool _isStarved() const;
+
+    /**
+     * Runs the tasks in the current worker's local queue, up to a limit after which the remainder
+     * is posted to the reactor so that the worker goes back to servicing network events.
+     */
+    void _drainLocalQueue();
+
+    /**
+     * Posts the local queue of 'state' to the reactor, so that any worker can run its tasks.
+     * Returns the number of tasks moved.
+     */
+    int _stealLocalQueue(ThreadState* state);
+
+    /**
+     * Steals the local queues of all workers which have had a task waiting in it for longer than
+     * maxQueueLatency(), because that worker is busy or blocked.
+     */
+    void _stealStaleLocalQueues();
     Milliseconds _getThreadJitter() const;
 
     void _accumulateTaskMetrics(MetricsArray* outArray, const MetricsArray& inputArray) const;
@@ -233,6 +263,8 @@ private:
     AtomicWord<int64_t> _totalQueued{0};
     AtomicWord<int64_t> _totalExecuted{0};
     AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+    AtomicWord<int64_t> _totalLocalQueued{0};
+    AtomicWord<int64_t> _totalStolen{0};
 
     // Threads signal this condition variable when they exit so we can gracefully shutdown
     // the executor.
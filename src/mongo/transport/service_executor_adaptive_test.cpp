@@ -72,6 +72,10 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 0;
     }
+
+    bool localRunQueues() const final {
+        return false;
+    }
 };
 
 struct RecursionOptions : public ServiceExecutorAdaptive::Options {
@@ -102,6 +106,44 @@ struct RecursionOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 10;
     }
+
+    bool localRunQueues() const final {
+        return false;
+    }
+};
+
+struct LocalRunQueueOptions : public ServiceExecutorAdaptive::Options {
+    int reservedThreads() const final {
+        return 2;
+    }
+
+    Milliseconds workerThreadRunTime() const final {
+        return Milliseconds{1000};
+    }
+
+    int runTimeJitter() const final {
+        return 0;
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{100};
+    }
+
+    Microseconds maxQueueLatency() const final {
+        return duration_cast<Microseconds>(Milliseconds{5});
+    }
+
+    int idlePctThreshold() const final {
+        return 0;
+    }
+
+    int recursionLimit() const final {
+        return 0;
+    }
+
+    bool localRunQueues() const final {
+        return true;
+    }
 };
 
 class ServiceExecutorAdaptiveFixture : public unittest::Test {
@@ -391,5 +433,75 @@ TEST_F(ServiceExecutorAdaptiveFixture, TestDeferredTasks) {
     waitForCallback(0);
 }
 
+/*
+ * This tests that a task scheduled from within a task runs on the same worker thread once the
+ * scheduling task completes.
+ */
+TEST_F(ServiceExecutorAdaptiveFixture, TestLocalRunQueue) {
+    auto exec = makeAndStartExecutor<LocalRunQueueOptions>();
+    auto guard = MakeGuard([&] { ASSERT_OK(exec->shutdown(config->workerThreadRunTime() * 2)); });
+
+    stdx::thread::id firstThread;
+    stdx::thread::id secondThread;
+    bool firstDone = false;
+    bool secondRanAfterFirst = false;
+
+    waitFor.store(2);
+    ASSERT_OK(exec->schedule(
+        [&] {
+            firstThread = stdx::this_thread::get_id();
+            ASSERT_OK(exec->schedule(
+                [&] {
+                    secondThread = stdx::this_thread::get_id();
+                    secondRanAfterFirst = firstDone;
+                    notifyCallback();
+                },
+                ServiceExecutor::kDeferredTask,
+                ServiceExecutorTaskName::kSSMSourceMessage));
+            firstDone = true;
+            notifyCallback();
+        },
+        ServiceExecutor::kEmptyFlags,
+        ServiceExecutorTaskName::kSSMProcessMessage));
+
+    waitForCallback(0, config->stuckThreadTimeout());
+    ASSERT(firstThread == secondThread);
+    ASSERT_TRUE(secondRanAfterFirst);
+}
+
+/*
+ * This tests that a task left on the local queue of a blocked worker is stolen and run by another
+ * worker.
+ */
+TEST_F(ServiceExecutorAdaptiveFixture, TestLocalRunQueueStealing) {
+    stdx::mutex blockedMutex;
+    stdx::unique_lock<stdx::mutex> blockedLock(blockedMutex);
+
+    auto exec = makeAndStartExecutor<LocalRunQueueOptions>();
+    auto guard = MakeGuard([&] {
+        if (blockedLock)
+            blockedLock.unlock();
+        ASSERT_OK(exec->shutdown(config->workerThreadRunTime() * 2));
+    });
+
+    waitFor.store(2);
+    ASSERT_OK(exec->schedule(
+        [this, &exec, &blockedMutex] {
+            ASSERT_OK(exec->schedule(notifyCallback,
+                                     ServiceExecutor::kEmptyFlags,
+                                     ServiceExecutorTaskName::kSSMProcessMessage));
+            stdx::unique_lock<stdx::mutex> lk(blockedMutex);
+            notifyCallback();
+        },
+        ServiceExecutor::kEmptyFlags,
+        ServiceExecutorTaskName::kSSMProcessMessage));
+
+    log() << "Waiting for the queued task to be stolen from the blocked worker";
+    waitForCallback(1, config->stuckThreadTimeout() * 5);
+
+    blockedLock.unlock();
+    waitForCallback(0);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/transport/thread_idle_callback.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa_placement.h"
 #include "mongo/util/processinfo.h"
 
 namespace mongo {
@@ -125,6 +126,7 @@ Status ServiceExecutorSynchronous::schedule(Task task,
 
     Status status = launchServiceWorkerThread([ this, task = std::move(task) ] {
         _numRunningWorkerThreads.addAndFetch(1);
+        NumaPlacement::get().placeCurrentThread(NumaPlacement::ThreadKind::kConnection);
 
         _localWorkQueue.emplace_back(std::move(task));
         while (!_localWorkQueue.empty() && _stillRunning.loadRelaxed()) {
@@ -37,6 +37,7 @@
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/service_entry_point.h"
@@ -87,6 +88,30 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return true;
 }
 
+// Sets up the next request of an OP_MSG exhaust stream in place of the one just processed, if
+// the client allowed exhaust and the command asked to run again. The response being sent is then
+// marked as having more to come.
+bool setOpMsgExhaustMessage(Message* m, DbResponse* dbresponse) {
+    if (!dbresponse->nextInvocation || !OpMsg::isFlagSet(*m, OpMsg::kExhaustSupported) ||
+        dbresponse->response.operation() != dbMsg) {
+        return false;
+    }
+
+    OpMsg next;
+    next.body = *dbresponse->nextInvocation;
+    Message nextMessage = next.serialize();
+
+    // The client never sends the next request, so the reply to it must claim to answer the
+    // response being sent now, which is the last message the client has seen.
+    nextMessage.header().setId(dbresponse->response.header().getId());
+    nextMessage.header().setResponseToMsgId(dbresponse->response.header().getResponseToMsgId());
+    OpMsg::setFlag(&nextMessage, OpMsg::kExhaustSupported);
+
+    OpMsg::setFlag(&dbresponse->response, OpMsg::kMoreToCome);
+    *m = std::move(nextMessage);
+    return true;
+}
+
 }  // namespace
 
 using transport::ServiceExecutor;
@@ -391,6 +416,8 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         // If this is an exhaust cursor, don't source more Messages
         if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
             _inExhaust = true;
+        } else if (setOpMsgExhaustMessage(&_inMessage, &dbresponse)) {
+            _inExhaust = true;
         } else {
             _inExhaust = false;
             _inMessage.reset();
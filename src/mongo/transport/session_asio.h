@@ -38,9 +38,11 @@
 #include "mongo/transport/transport_layer_asio.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/shared_buffer_pool.h"
 #ifdef MONGO_CONFIG_SSL
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_types.h"
+#include "mongo/util/timer.h"
 #endif
 
 #include "asio.hpp"
@@ -81,7 +83,8 @@ public:
     ASIOSession(TransportLayerASIO* tl, GenericSocket socket, bool isIngressSession) try
         : _socket(std::move(socket)),
           _tl(tl),
-          _isIngressSession(isIngressSession) {
+          _isIngressSession(isIngressSession),
+          _readAheadBytes(isIngressSession ? tl->_listenerOptions.readAheadBytes : 0) {
         auto family = endpointToSockAddr(_socket.local_endpoint()).getType();
         if (family == AF_INET || family == AF_INET6) {
             _socket.set_option(asio::ip::tcp::no_delay(true));
@@ -218,6 +221,9 @@ protected:
 
         _sslSocket.emplace(
             std::move(_socket), *_tl->_egressSSLContext, removeFQDNRoot(target.host()));
+        const auto remote = target.toString();
+        getSSLManager()->resumeEgressSession(_sslSocket->native_handle(), remote);
+        Timer handshakeTimer;
         auto doHandshake = [&] {
             if (_blockingMode == Sync) {
                 std::error_code ec;
@@ -227,10 +233,14 @@ protected:
                 return _sslSocket->async_handshake(asio::ssl::stream_base::client, UseFuture{});
             }
         };
-        return doHandshake().then([this, target] {
+        return doHandshake().then([this, target, remote, handshakeTimer] {
             _ranHandshake = true;
 
             auto sslManager = getSSLManager();
+            const bool resumed =
+                sslManager->stashEgressSession(_sslSocket->native_handle(), remote);
+            networkCounter.hitEgressTLSHandshake(resumed, handshakeTimer.micros());
+
             auto swPeerInfo = uassertStatusOK(sslManager->parseAndValidatePeerCertificate(
                 _sslSocket->native_handle(), target.host()));
 
@@ -332,6 +342,10 @@ private:
     Future<Message> sourceMessageImpl(const transport::BatonHandle& baton = nullptr) {
         static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
 
+        if (canReadAhead()) {
+            return sourceMessageFromReadAhead(baton);
+        }
+
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
         return read(asio::buffer(ptr, kHeaderSize), baton)
@@ -359,7 +373,7 @@ private:
                     return Future<Message>::makeReady(Message(std::move(headerBuffer)));
                 }
 
-                auto buffer = SharedBuffer::allocate(msgLen);
+                auto buffer = SharedBufferPool::get().allocate(msgLen);
                 memcpy(buffer.get(), headerBuffer.get(), kHeaderSize);
 
                 MsgData::View msgView(buffer.get());
@@ -373,6 +387,108 @@ private:
             });
     }
 
+    /**
+     * Whether messages are sourced through the read-ahead buffer. This is only done for plain
+     * ingress sockets, and only once the first read has decided that the connection is not TLS.
+     */
+    bool canReadAhead() const {
+        if (!_readAheadBytes) {
+            return false;
+        }
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket || !_ranHandshake) {
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    size_t readAheadBuffered() const {
+        return _readAheadEnd - _readAheadBegin;
+    }
+
+    /**
+     * Sources a message by reading as many bytes as the socket has available into the read-ahead
+     * buffer, rather than the header and the body separately. A small message, and often the next
+     * pipelined one too, then costs a single receive. Whatever follows the message stays buffered
+     * for the next call. Bodies that don't fit are read directly into the message.
+     */
+    Future<Message> sourceMessageFromReadAhead(const transport::BatonHandle& baton) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        if (readAheadBuffered() < kHeaderSize) {
+            return fillReadAhead(baton).then(
+                [this, baton] { return sourceMessageFromReadAhead(baton); });
+        }
+
+        const char* header = _readAhead.get() + _readAheadBegin;
+        if (checkForHTTPRequest(asio::buffer(header, kHeaderSize))) {
+            return sendHTTPResponse(baton);
+        }
+
+        const auto msgLen = size_t(MSGHEADER::ConstView(header).getMessageLength());
+        if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+            StringBuilder sb;
+            sb << "recv(): message msgLen " << msgLen << " is invalid. "
+               << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+            const auto str = sb.str();
+            LOG(0) << str;
+
+            return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
+        }
+
+        auto buffer = SharedBufferPool::get().allocate(msgLen);
+        const auto fromReadAhead = std::min(msgLen, readAheadBuffered());
+        memcpy(buffer.get(), header, fromReadAhead);
+        _readAheadBegin += fromReadAhead;
+
+        if (fromReadAhead == msgLen) {
+            networkCounter.hitPhysicalIn(msgLen);
+            return Future<Message>::makeReady(Message(std::move(buffer)));
+        }
+
+        auto remaining = asio::buffer(buffer.get() + fromReadAhead, msgLen - fromReadAhead);
+        return read(remaining, baton).then([ buffer = std::move(buffer), msgLen ]() mutable {
+            networkCounter.hitPhysicalIn(msgLen);
+            return Message(std::move(buffer));
+        });
+    }
+
+    /**
+     * Receives at least one more byte into the read-ahead buffer, and as many as are available up
+     * to its size.
+     */
+    Future<void> fillReadAhead(const transport::BatonHandle& baton) {
+        if (!_readAhead) {
+            _readAhead = SharedBuffer::allocate(_readAheadBytes);
+        }
+        if (_readAheadBegin > 0) {
+            memmove(_readAhead.get(), _readAhead.get() + _readAheadBegin, readAheadBuffered());
+            _readAheadEnd -= _readAheadBegin;
+            _readAheadBegin = 0;
+        }
+
+        auto freeSpace =
+            asio::buffer(_readAhead.get() + _readAheadEnd, _readAheadBytes - _readAheadEnd);
+        std::error_code ec;
+        const auto size = _socket.read_some(freeSpace, ec);
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            if (baton) {
+                return baton->addSession(*this, Baton::Type::In).then([this, baton] {
+                    return fillReadAhead(baton);
+                });
+            }
+
+            return _socket.async_read_some(freeSpace, UseFuture{}).then([this](size_t size) {
+                _readAheadEnd += size;
+            });
+        }
+
+        _readAheadEnd += size;
+        return futurize(ec);
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers,
                       const transport::BatonHandle& baton = nullptr) {
@@ -588,6 +704,7 @@ private:
             }
 
             _sslSocket.emplace(std::move(_socket), *_tl->_ingressSSLContext, "");
+            Timer handshakeTimer;
             auto doHandshake = [&] {
                 if (_blockingMode == Sync) {
                     std::error_code ec;
@@ -598,7 +715,11 @@ private:
                         asio::ssl::stream_base::server, buffer, UseFuture{});
                 }
             };
-            return doHandshake().then([this](size_t size) {
+            return doHandshake().then([this, handshakeTimer](size_t size) {
+                networkCounter.hitIngressTLSHandshake(
+                    getSSLManager()->isResumedSession(_sslSocket->native_handle()),
+                    handshakeTimer.micros());
+
                 auto& sslPeerInfo = SSLPeerInfo::forSession(shared_from_this());
 
                 if (sslPeerInfo.subjectName.empty()) {
@@ -698,6 +819,14 @@ private:
 
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
+
+    // Size of the read-ahead buffer, or 0 if messages are read header first, then body. The buffer
+    // is allocated on the first read through it, and holds bytes [_readAheadBegin, _readAheadEnd)
+    // that have been received but not yet sourced.
+    const size_t _readAheadBytes;
+    SharedBuffer _readAhead;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
 };
 
 }  // namespace transport
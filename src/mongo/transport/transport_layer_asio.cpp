@@ -38,8 +38,10 @@
 
 #include "mongo/config.h"
 
+#include "mongo/base/parse_number.h"
 #include "mongo/base/system_error.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/service_entry_point.h"
@@ -48,6 +50,7 @@
 #include "mongo/util/net/sockaddr.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_options.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 #ifdef MONGO_CONFIG_SSL
 #include "mongo/util/net/ssl.hpp"
@@ -268,6 +271,73 @@ private:
 thread_local TransportLayerASIO::ASIOReactor* TransportLayerASIO::ASIOReactor::_reactorForThread =
     nullptr;
 
+namespace {
+
+// Size of the buffer each ingress session receives into, so that the header and body of a small
+// message, and possibly the messages pipelined behind it, arrive with a single receive. 0 reads
+// the header and the body of each message separately.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(transportLayerASIOReadAheadBytes, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal != 0 && (newVal < 1024 || newVal > 1024 * 1024)) {
+            return Status(ErrorCodes::BadValue,
+                          "transportLayerASIOReadAheadBytes must be 0, or between 1024 and "
+                          "1048576");
+        }
+        return Status::OK();
+    });
+
+/**
+ * Caps the memory the pool of incoming message and BufBuilder buffers keeps idle for reuse. 0
+ * disables the pool.
+ */
+class MessageBufferPoolMaxBytesParameter final : public ServerParameter {
+    MONGO_DISALLOW_COPYING(MessageBufferPoolMaxBytesParameter);
+
+public:
+    static constexpr auto kName = "messageBufferPoolMaxBytes"_sd;
+
+    MessageBufferPoolMaxBytesParameter()
+        : ServerParameter(ServerParameterSet::getGlobal(), kName.toString(), true, true) {}
+
+    void append(OperationContext* opCtx, BSONObjBuilder& builder, const std::string& name) final {
+        builder.append(name, SharedBufferPool::get().getStats().maxPooledBytes);
+    }
+
+    Status set(const BSONElement& newValueElement) final {
+        long long newValue;
+        if (!newValueElement.coerce(&newValue)) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Invalid value for " << kName << ": "
+                                        << newValueElement);
+        }
+        return _set(newValue);
+    }
+
+    Status setFromString(const std::string& str) final {
+        long long newValue;
+        Status status = parseNumberFromString(str, &newValue);
+        if (!status.isOK())
+            return status;
+        return _set(newValue);
+    }
+
+private:
+    Status _set(long long newValue) {
+        if (newValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Invalid value for " << kName << ": " << newValue
+                                        << ". Must be a non-negative integer.");
+        }
+        SharedBufferPool::get().setMaxPooledBytes(newValue);
+        return Status::OK();
+    }
+} messageBufferPoolMaxBytes;
+
+constexpr decltype(MessageBufferPoolMaxBytesParameter::kName)
+    MessageBufferPoolMaxBytesParameter::kName;
+
+}  // namespace
+
 TransportLayerASIO::Options::Options(const ServerGlobalParams* params)
     : port(params->port),
       ipList(params->bind_ip),
@@ -275,7 +345,8 @@ TransportLayerASIO::Options::Options(const ServerGlobalParams* params)
       useUnixSockets(!params->noUnixSocket),
 #endif
       enableIPv6(params->enableIPv6),
-      maxConns(params->maxConns) {
+      maxConns(params->maxConns),
+      readAheadBytes(transportLayerASIOReadAheadBytes) {
 }
 
 TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
@@ -103,6 +103,7 @@ public:
         Mode transportMode = Mode::kSynchronous;  // whether accepted sockets should be put into
                                                   // non-blocking mode after they're accepted
         size_t maxConns = DEFAULT_MAX_CONN;       // maximum number of active connections
+        size_t readAheadBytes = 0;  // per ingress session read-ahead buffer size, 0 to disable
     };
 
     TransportLayerASIO(const Options& opts, ServiceEntryPoint* sep);
@@ -249,29 +249,50 @@ public:
     }
 
     void sendMessage() {
-        OpMsgBuilder builder;
-        builder.setBody(BSON("ping" << 1));
-        Message msg = builder.finish();
-        msg.header().setResponseToMsgId(0);
-        msg.header().setId(0);
+        Message msg = makeMessage(BSON("ping" << 1));
 
         std::error_code ec;
         asio::write(_sock, asio::buffer(msg.buf(), msg.size()), ec);
         ASSERT_FALSE(ec);
     }
 
+    /**
+     * Sends 'msgs' back to back with a single write, as a client pipelining requests would.
+     */
+    void sendMessages(const std::vector<Message>& msgs) {
+        std::string bytes;
+        for (const auto& msg : msgs) {
+            bytes.append(msg.buf(), msg.size());
+        }
+
+        std::error_code ec;
+        asio::write(_sock, asio::buffer(bytes.data(), bytes.size()), ec);
+        ASSERT_FALSE(ec);
+    }
+
+    static Message makeMessage(const BSONObj& body) {
+        OpMsgBuilder builder;
+        builder.setBody(body);
+        Message msg = builder.finish();
+        msg.header().setResponseToMsgId(0);
+        msg.header().setId(0);
+        return msg;
+    }
+
 private:
     asio::io_context _ctx;
     asio::ip::tcp::socket _sock;
     asio::ip::tcp::endpoint _endpoint;
 };
 
-std::unique_ptr<transport::TransportLayerASIO> makeAndStartTL(ServiceEntryPoint* sep) {
-    auto options = [] {
+std::unique_ptr<transport::TransportLayerASIO> makeAndStartTL(ServiceEntryPoint* sep,
+                                                               size_t readAheadBytes = 0) {
+    auto options = [readAheadBytes] {
         ServerGlobalParams params;
         params.noUnixSocket = true;
         transport::TransportLayerASIO::Options opts(&params);
         opts.port = 0;
+        opts.readAheadBytes = readAheadBytes;
         return opts;
     }();
 
@@ -358,5 +379,57 @@ TEST(TransportLayerASIO, SwitchTimeoutModes) {
     tla->shutdown();
 }
 
+/* check that messages are split correctly when they are received through the read-ahead buffer */
+class ReadAheadSEP : public TimeoutSEP {
+public:
+    explicit ReadAheadSEP(std::vector<int> expectedSizes)
+        : _expectedSizes(std::move(expectedSizes)) {}
+
+    void startSession(transport::SessionHandle session) override {
+        log() << "Accepted connection from " << session->remote();
+        stdx::thread([ this, session = std::move(session) ]() mutable {
+            for (auto expectedSize : _expectedSizes) {
+                auto swMsg = session->sourceMessage();
+                ASSERT_OK(swMsg.getStatus());
+                ASSERT_EQ(swMsg.getValue().size(), expectedSize);
+            }
+
+            session.reset();
+            notifyComplete();
+        }).detach();
+    }
+
+private:
+    const std::vector<int> _expectedSizes;
+};
+
+TEST(TransportLayerASIO, SourceThroughReadAhead) {
+    const size_t kReadAheadBytes = 1024;
+
+    std::vector<Message> msgs;
+    msgs.push_back(TimeoutConnector::makeMessage(BSON("ping" << 1)));
+    msgs.push_back(TimeoutConnector::makeMessage(BSON("ping" << 2)));
+    msgs.push_back(TimeoutConnector::makeMessage(BSON("ping" << 3)));
+    // Larger than the read-ahead buffer, so that its body is completed by a separate read.
+    msgs.push_back(
+        TimeoutConnector::makeMessage(BSON("ping" << std::string(4 * kReadAheadBytes, 'x'))));
+    msgs.push_back(TimeoutConnector::makeMessage(BSON("ping" << 4)));
+
+    std::vector<int> sizes;
+    for (const auto& msg : msgs) {
+        sizes.push_back(msg.size());
+    }
+
+    ReadAheadSEP sep(sizes);
+    auto tla = makeAndStartTL(&sep, kReadAheadBytes);
+
+    TimeoutConnector connector(tla->listenerPort(), false);
+    connector.sendMessages({msgs[0]});
+    connector.sendMessages({msgs[1], msgs[2], msgs[3], msgs[4]});
+
+    ASSERT_TRUE(sep.waitForTimeout(Milliseconds{10000}));
+    tla->shutdown();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -31,9 +31,11 @@
 #include <benchmark/benchmark.h>
 
 #include "mongo/util/clock_source.h"
+#include "mongo/util/cycle_tick_source.h"
 #include "mongo/util/fast_clock_source_factory.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/system_clock_source.h"
+#include "mongo/util/system_tick_source.h"
 
 namespace mongo {
 namespace {
@@ -75,5 +77,41 @@ BENCHMARK(BM_ClockNow)
     ->Arg(1)
     ->Arg(10);
 
+/**
+ * Benchmark reading a tick source, as hot paths do to time operations and lock waits. With an
+ * argument of 0, reads SystemTickSource, and with 1, reads CycleTickSource.
+ */
+void BM_TickSourceNow(benchmark::State& state) {
+    TickSource* tickSource;
+    if (state.range(0) == 0) {
+        tickSource = SystemTickSource::get();
+    } else {
+        tickSource = CycleTickSource::get();
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(tickSource->getTicks());
+    }
+}
+
+BENCHMARK(BM_TickSourceNow)
+    ->ThreadRange(1, ProcessInfo::getNumAvailableCores())
+    ->ArgName("cycle counter")
+    ->Arg(0)
+    ->Arg(1);
+
+/**
+ * Benchmark timing an interval with CycleTickSource and converting it to microseconds, as CurOp
+ * and lock wait accounting do.
+ */
+void BM_CycleTickSourceElapsedMicros(benchmark::State& state) {
+    for (auto keepRunning : state) {
+        const auto start = CycleTickSource::now();
+        benchmark::DoNotOptimize(CycleTickSource::ticksToMicros(CycleTickSource::now() - start));
+    }
+}
+
+BENCHMARK(BM_CycleTickSourceElapsedMicros);
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace mongo {
+namespace {
+
+const int kTasksPerIteration = 1024;
+
+template <typename Pool>
+std::unique_ptr<Pool> makePool(size_t numThreads);
+
+template <>
+std::unique_ptr<ThreadPool> makePool<ThreadPool>(size_t numThreads) {
+    ThreadPool::Options options;
+    options.minThreads = numThreads;
+    options.maxThreads = numThreads;
+    return stdx::make_unique<ThreadPool>(options);
+}
+
+template <>
+std::unique_ptr<WorkStealingThreadPool> makePool<WorkStealingThreadPool>(size_t numThreads) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = numThreads;
+    return stdx::make_unique<WorkStealingThreadPool>(options);
+}
+
+/**
+ * Counts down the tasks of one iteration, and lets the benchmark thread wait for the last one.
+ */
+class Countdown {
+public:
+    explicit Countdown(int count) : _remaining(count) {}
+
+    void countDown() {
+        if (_remaining.subtractAndFetch(1) == 0) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _done = true;
+            _cv.notify_one();
+        }
+    }
+
+    void wait() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [&] { return _done; });
+    }
+
+private:
+    AtomicWord<int> _remaining;
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    bool _done = false;
+};
+
+// Many tiny tasks scheduled from outside the pool, as by an executor.
+template <typename Pool>
+void BM_ScheduleFromOutside(benchmark::State& state) {
+    auto pool = makePool<Pool>(state.range(0));
+    pool->startup();
+
+    for (auto keepRunning : state) {
+        Countdown countdown(kTasksPerIteration);
+        for (int i = 0; i < kTasksPerIteration; ++i) {
+            invariant(pool->schedule([&] { countdown.countDown(); }));
+        }
+        countdown.wait();
+    }
+
+    pool->shutdown();
+    pool->join();
+    state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+// One task fans out into many tiny tasks, as when a batch of work is split up inside the pool.
+template <typename Pool>
+void BM_ScheduleFromTask(benchmark::State& state) {
+    auto pool = makePool<Pool>(state.range(0));
+    pool->startup();
+
+    for (auto keepRunning : state) {
+        Countdown countdown(kTasksPerIteration);
+        invariant(pool->schedule([&] {
+            for (int i = 0; i < kTasksPerIteration; ++i) {
+                invariant(pool->schedule([&] { countdown.countDown(); }));
+            }
+        }));
+        countdown.wait();
+    }
+
+    pool->shutdown();
+    pool->join();
+    state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+BENCHMARK_TEMPLATE(BM_ScheduleFromOutside, ThreadPool)->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_ScheduleFromOutside, WorkStealingThreadPool)
+    ->RangeMultiplier(2)
+    ->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_ScheduleFromTask, ThreadPool)->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_ScheduleFromTask, WorkStealingThreadPool)->RangeMultiplier(2)->Range(1, 64);
+
+}  // namespace
+}  // namespace mongo
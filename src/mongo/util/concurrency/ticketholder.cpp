@@ -33,11 +33,94 @@
 
 #include <iostream>
 
+#include "mongo/base/static_assert.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
+namespace {
+
+// Upper bounds of the wait time histogram buckets, in microseconds.
+const long long kWaitTimeBucketBoundsMicros[] = {100, 1000, 10000, 100000, 1000000, 10000000};
+const char* const kWaitTimeBucketNames[] = {
+    "lt100us", "lt1ms", "lt10ms", "lt100ms", "lt1s", "lt10s", "ge10s"};
+
+MONGO_STATIC_ASSERT(sizeof(kWaitTimeBucketNames) / sizeof(kWaitTimeBucketNames[0]) ==
+                    TicketHolder::kNumWaitTimeBuckets);
+MONGO_STATIC_ASSERT(sizeof(kWaitTimeBucketBoundsMicros) / sizeof(kWaitTimeBucketBoundsMicros[0]) ==
+                    TicketHolder::kNumWaitTimeBuckets - 1);
+
+}  // namespace
+
+constexpr int TicketHolder::kNumWaitTimeBuckets;
+
+void TicketHolder::waitForTicket(OperationContext* opCtx) {
+    if (tryAcquire()) {
+        return;
+    }
+
+    const auto startMicros = _beginWait();
+    ON_BLOCK_EXIT([&] { _endWait(startMicros); });
+    _waitForTicket(opCtx);
+}
+
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+    if (tryAcquire()) {
+        return true;
+    }
+
+    const auto startMicros = _beginWait();
+    ON_BLOCK_EXIT([&] { _endWait(startMicros); });
+    return _waitForTicketUntil(opCtx, until);
+}
+
+int TicketHolder::queued() const {
+    return _queued.load();
+}
+
+long long TicketHolder::numWaits() const {
+    return _numWaits.load();
+}
+
+void TicketHolder::appendStats(BSONObjBuilder* builder) const {
+    builder->append("out", used());
+    builder->append("available", available());
+    builder->append("totalTickets", outof());
+    builder->append("queued", queued());
+
+    BSONObjBuilder waits(builder->subobjStart("waits"));
+    waits.append("count", numWaits());
+    waits.append("totalTimeMicros", _totalWaitMicros.load());
+    BSONObjBuilder histogram(waits.subobjStart("timeHistogram"));
+    for (int b = 0; b < kNumWaitTimeBuckets; b++) {
+        histogram.append(kWaitTimeBucketNames[b], _waitTimeBuckets[b].load());
+    }
+}
+
+int TicketHolder::waitTimeBucketFor(long long waitMicros) {
+    int bucket = 0;
+    while (bucket < kNumWaitTimeBuckets - 1 && waitMicros >= kWaitTimeBucketBoundsMicros[bucket]) {
+        bucket++;
+    }
+    return bucket;
+}
+
+uint64_t TicketHolder::_beginWait() {
+    _queued.fetchAndAdd(1);
+    return curTimeMicros64();
+}
+
+void TicketHolder::_endWait(uint64_t startMicros) {
+    const long long waitMicros = curTimeMicros64() - startMicros;
+    _queued.fetchAndSubtract(1);
+    _numWaits.fetchAndAdd(1);
+    _totalWaitMicros.fetchAndAdd(waitMicros);
+    _waitTimeBuckets[waitTimeBucketFor(waitMicros)].fetchAndAdd(1);
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -86,11 +169,11 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
+void TicketHolder::_waitForTicket(OperationContext* opCtx) {
+    _waitForTicketUntil(opCtx, Date_t::max());
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     const Milliseconds intervalMs(500);
     struct timespec ts;
 
@@ -177,7 +260,7 @@ bool TicketHolder::tryAcquire() {
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
+void TicketHolder::_waitForTicket(OperationContext* opCtx) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     if (opCtx) {
@@ -187,7 +270,7 @@ void TicketHolder::waitForTicket(OperationContext* opCtx) {
     }
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     if (opCtx) {
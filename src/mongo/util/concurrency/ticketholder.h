@@ -32,6 +32,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -39,6 +40,8 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
+
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
@@ -79,7 +82,52 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of threads currently waiting for a ticket.
+     */
+    int queued() const;
+
+    /**
+     * Returns how many acquisitions so far could not get a ticket right away and had to wait.
+     */
+    long long numWaits() const;
+
+    /**
+     * Appends the ticket counts, the number of queued threads, and the count, total time and
+     * histogram of the waits for a ticket to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    // Number of buckets in the wait time histogram. Each bucket counts the waits shorter than its
+    // upper bound and at least as long as the previous one's; the last bucket is unbounded.
+    static constexpr int kNumWaitTimeBuckets = 7;
+
+    /**
+     * Returns the index of the wait time histogram bucket that a wait of 'waitMicros' falls in.
+     */
+    static int waitTimeBucketFor(long long waitMicros);
+
 private:
+    /**
+     * Blocking part of waitForTicket/waitForTicketUntil, only entered once tryAcquire() failed.
+     */
+    void _waitForTicket(OperationContext* opCtx);
+    bool _waitForTicketUntil(OperationContext* opCtx, Date_t until);
+
+    /**
+     * Account for a thread that starts waiting for a ticket, and returns the start of the wait.
+     * Must be paired with _endWait().
+     */
+    uint64_t _beginWait();
+    void _endWait(uint64_t startMicros);
+
+    // Only updated by threads which could not get a ticket right away, so that acquisitions on
+    // the uncontended path do not share any cache lines.
+    AtomicInt32 _queued;
+    AtomicInt64 _numWaits;
+    AtomicInt64 _totalWaitMicros;
+    AtomicInt64 _waitTimeBuckets[kNumWaitTimeBuckets];
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
@@ -31,6 +31,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -71,4 +72,44 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, WaitStats) {
+    TicketHolder holder(1);
+    ASSERT_EQ(holder.queued(), 0);
+    ASSERT_EQ(holder.numWaits(), 0);
+
+    // Getting a ticket right away is not a wait.
+    holder.waitForTicket();
+    ASSERT_EQ(holder.numWaits(), 0);
+
+    // Timing out is, and it lands in the histogram.
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(2)));
+    ASSERT_EQ(holder.numWaits(), 1);
+    ASSERT_EQ(holder.queued(), 0);
+    holder.release();
+
+    BSONObjBuilder builder;
+    holder.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["out"].numberInt(), 0);
+    ASSERT_EQ(stats["available"].numberInt(), 1);
+    ASSERT_EQ(stats["totalTickets"].numberInt(), 1);
+    ASSERT_EQ(stats["queued"].numberInt(), 0);
+    ASSERT_EQ(stats["waits"]["count"].numberLong(), 1);
+
+    long long histogramTotal = 0;
+    for (auto&& bucket : stats["waits"]["timeHistogram"].Obj()) {
+        histogramTotal += bucket.numberLong();
+    }
+    ASSERT_EQ(histogramTotal, 1);
+}
+
+TEST(TicketholderTest, WaitTimeBuckets) {
+    ASSERT_EQ(TicketHolder::waitTimeBucketFor(0), 0);
+    ASSERT_EQ(TicketHolder::waitTimeBucketFor(99), 0);
+    ASSERT_EQ(TicketHolder::waitTimeBucketFor(100), 1);
+    ASSERT_EQ(TicketHolder::waitTimeBucketFor(999999), 4);
+    ASSERT_EQ(TicketHolder::waitTimeBucketFor(1000000), 5);
+    ASSERT_EQ(TicketHolder::waitTimeBucketFor(10000000), 6);
+}
 }  // namespace
@@ -0,0 +1,412 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/status.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicInt32 nextUnnamedWorkStealingThreadPoolId{1};
+
+// Every this many tasks, a worker looks at the injection queue before its own deque.
+const size_t kInjectionQueueInterval = 61;
+
+// The most tasks a worker moves from the injection queue to its own deque at once, where other
+// workers can steal them without taking the pool's mutex.
+const size_t kMaxInjectedBatchSize = 32;
+
+// The pool the calling thread is a worker of, if any, and its index in that pool.
+thread_local const WorkStealingThreadPool* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+/**
+ * Sets defaults and checks bounds limits on "options", and returns it.
+ */
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedWorkStealingThreadPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with "
+                 << options.numThreads << " threads, but it must have at least 1";
+        fassertFailed(50869);
+    }
+    return options;
+}
+
+Status shutdownInProgressStatus(const std::string& poolName) {
+    return Status(ErrorCodes::ShutdownInProgress,
+                  str::stream() << "Shutdown of thread pool " << poolName << " in progress");
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))),
+      _workers(new CacheAligned<Worker>[_options.numThreads]) {}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+    if (shutdownComplete != _state) {
+        _join_inlock(&lk);
+    }
+
+    if (shutdownComplete != _state) {
+        severe() << "Failed to shutdown pool during destruction";
+        fassertFailed(50870);
+    }
+    invariant(_threads.empty());
+    invariant(!_numPendingTasks.load());
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(50871);
+    }
+    _setState_inlock(running);
+    invariant(_threads.empty());
+    for (size_t i = 0; i < _options.numThreads; ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        try {
+            _threads.emplace_back(
+                [this, i, threadName] { _workerThreadBody(this, i, threadName); });
+        } catch (const std::exception& ex) {
+            // The other workers steal from this one's deque, which only it would have filled, so
+            // the pool carries on with fewer threads.
+            error() << "Failed to start " << threadName << "; " << _threads.size()
+                    << " other thread(s) running in pool " << _options.poolName
+                    << "; caught exception: " << redact(ex.what());
+        }
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+}
+
+void WorkStealingThreadPool::_shutdown_inlock() {
+    switch (_state) {
+        case preStart:
+        case running:
+            _acceptingTasks.store(false);
+            _setState_inlock(joinRequired);
+            _workAvailable.notify_all();
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    try {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _join_inlock(&lk);
+    } catch (...) {
+        severe() << "Exception escaped join in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_join_inlock(stdx::unique_lock<stdx::mutex>* lk) {
+    _stateChange.wait(*lk, [this] {
+        switch (_state) {
+            case preStart:
+                return false;
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(50872);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+    std::vector<stdx::thread> threadsToJoin;
+    swap(threadsToJoin, _threads);
+    lk->unlock();
+
+    // The workers run every remaining task before they exit. Tasks are only left over if the pool
+    // never started, or none of its threads did.
+    for (auto& t : threadsToJoin) {
+        t.join();
+    }
+    if (_numPendingTasks.load()) {
+        _drainPendingTasks();
+    }
+
+    lk->lock();
+    invariant(_state == joining);
+    _setState_inlock(shutdownComplete);
+}
+
+void WorkStealingThreadPool::_drainPendingTasks() {
+    // Tasks cannot be run inline because they can create OperationContexts and the join() caller
+    // may already have one associated with the thread.
+    stdx::thread cleanThread = stdx::thread([&] {
+        const std::string threadName = str::stream() << _options.threadNamePrefix
+                                                     << _options.numThreads;
+        setThreadName(threadName);
+        _options.onCreateThread(threadName);
+        while (Task task = _findTask(0, true)) {
+            _runTask(task);
+        }
+    });
+    cleanThread.join();
+}
+
+Status WorkStealingThreadPool::schedule(Task task) {
+    if (currentPool == this) {
+        // A task in this pool is scheduling more work. Keep it on this worker, where it will run
+        // next unless another worker steals it first.
+        if (!_acceptingTasks.load()) {
+            return shutdownInProgressStatus(_options.poolName);
+        }
+
+        // Count the task before it becomes visible, so that no worker decides the pool has run out
+        // of work while it is on its way in.
+        _numPendingTasks.fetchAndAdd(1);
+        auto& worker = _workers[currentWorkerIndex];
+        {
+            stdx::lock_guard<stdx::mutex> lk(worker.mutex);
+            worker.tasks.emplace_back(std::move(task));
+        }
+        _wakeWorker();
+        return Status::OK();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    switch (_state) {
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return shutdownInProgressStatus(_options.poolName);
+        case preStart:
+        case running:
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+    _numPendingTasks.fetchAndAdd(1);
+    _injectedTasks.emplace_back(std::move(task));
+    _numInjectedTasks.fetchAndAdd(1);
+    if (_numSleepingWorkers.load()) {
+        _workAvailable.notify_one();
+    }
+    return Status::OK();
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Stats result;
+    result.numThreads = _threads.size();
+    result.numPendingTasks = static_cast<size_t>(_numPendingTasks.load());
+    result.numStolenTasks = _numStolenTasks.load();
+    return result;
+}
+
+void WorkStealingThreadPool::_workerThreadBody(WorkStealingThreadPool* pool,
+                                               size_t workerIndex,
+                                               const std::string& threadName) {
+    currentPool = pool;
+    currentWorkerIndex = workerIndex;
+    setThreadName(threadName);
+    pool->_options.onCreateThread(threadName);
+    const auto poolName = pool->_options.poolName;
+    LOG(1) << "starting thread in pool " << poolName;
+    try {
+        pool->_consumeTasks(workerIndex);
+    } catch (...) {
+        severe() << "Exception reached top of stack in thread pool " << poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+    currentPool = nullptr;
+    LOG(1) << "shutting down thread in pool " << poolName;
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t workerIndex) {
+    size_t tasksRun = 0;
+    while (true) {
+        const bool injectionQueueFirst = ++tasksRun % kInjectionQueueInterval == 0;
+        if (Task task = _findTask(workerIndex, injectionQueueFirst)) {
+            _runTask(task);
+            continue;
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (_numPendingTasks.load() > 0) {
+            // A task has been counted but isn't visible yet. Look again.
+            continue;
+        }
+        if (_state != running) {
+            // Shutting down, and every task has been taken.
+            return;
+        }
+
+        // Whoever makes a task available increments _numPendingTasks before checking for sleeping
+        // workers, so either the wait below sees the task, or the scheduler sees this worker.
+        _numSleepingWorkers.fetchAndAdd(1);
+        LOG(3) << "waiting for work in pool " << _options.poolName;
+        MONGO_IDLE_THREAD_BLOCK;
+        _workAvailable.wait(lk, [&] { return _numPendingTasks.load() > 0 || _state != running; });
+        _numSleepingWorkers.fetchAndSubtract(1);
+    }
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::_findTask(size_t workerIndex,
+                                                              bool injectionQueueFirst) {
+    Task task;
+    if (injectionQueueFirst) {
+        task = _popInjectedTask(workerIndex);
+    }
+
+    if (!task) {
+        auto& worker = _workers[workerIndex];
+        stdx::lock_guard<stdx::mutex> lk(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+    }
+
+    if (!task && !injectionQueueFirst) {
+        task = _popInjectedTask(workerIndex);
+    }
+
+    if (!task) {
+        task = _stealTask(workerIndex);
+    }
+
+    if (task) {
+        _numPendingTasks.fetchAndSubtract(1);
+    }
+    return task;
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::_popInjectedTask(size_t workerIndex) {
+    if (!_numInjectedTasks.load()) {
+        return Task();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_injectedTasks.empty()) {
+        return Task();
+    }
+
+    Task task = std::move(_injectedTasks.front());
+    _injectedTasks.pop_front();
+
+    // Take a share of the rest, so that the workers don't all come back to _mutex for each task.
+    const size_t batchSize =
+        std::min(_injectedTasks.size() / _options.numThreads, kMaxInjectedBatchSize);
+    if (batchSize) {
+        auto& worker = _workers[workerIndex];
+        stdx::lock_guard<stdx::mutex> workerLk(worker.mutex);
+        for (size_t i = 0; i < batchSize; ++i) {
+            worker.tasks.emplace_front(std::move(_injectedTasks.front()));
+            _injectedTasks.pop_front();
+        }
+        if (_numSleepingWorkers.load()) {
+            _workAvailable.notify_one();
+        }
+    }
+
+    _numInjectedTasks.store(_injectedTasks.size());
+    return task;
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::_stealTask(size_t thiefIndex) {
+    for (size_t offset = 1; offset < _options.numThreads; ++offset) {
+        auto& victim = _workers[(thiefIndex + offset) % _options.numThreads];
+        stdx::lock_guard<stdx::mutex> lk(victim.mutex);
+        if (!victim.tasks.empty()) {
+            Task task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            _numStolenTasks.fetchAndAdd(1);
+            return task;
+        }
+    }
+    return Task();
+}
+
+void WorkStealingThreadPool::_runTask(Task& task) {
+    try {
+        LOG(3) << "Executing a task on behalf of pool " << _options.poolName;
+        task();
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_wakeWorker() {
+    if (_numSleepingWorkers.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+}
+
+void WorkStealingThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state) {
+        return;
+    }
+    _state = newState;
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
@@ -0,0 +1,227 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+class Status;
+
+/**
+ * A fixed-size thread pool in which every worker has its own task deque, for workloads made of
+ * many small tasks that would contend on the single queue of ThreadPool.
+ *
+ * Tasks scheduled from outside the pool go to a global injection queue. Tasks scheduled by a task
+ * running in the pool go to the back of its worker's deque, and the worker runs them newest first.
+ * A worker that runs out of work takes from the injection queue, then steals the oldest task from
+ * another worker's deque. Every so often a worker looks at the injection queue before its own
+ * deque, so that a task that keeps rescheduling itself can't starve outside work.
+ *
+ * Tasks run in no particular order. Unlike ThreadPool, the number of threads does not adapt to the
+ * load: all of them start with the pool and stay until it is joined.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    MONGO_DISALLOW_COPYING(WorkStealingThreadPool);
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a name
+        // unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. An integer will be appended to this
+        // string to create the thread name for each thread in the pool. If you leave this empty,
+        // the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of worker threads, each with its own deque.
+        size_t numThreads = 8;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        // The number of threads in the pool.
+        size_t numThreads;
+
+        // The number of tasks waiting to be executed by the pool.
+        size_t numPendingTasks;
+
+        // The number of tasks a worker has taken from another worker's deque.
+        long long numStolenTasks;
+    };
+
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    Status schedule(Task task) override;
+
+    /**
+     * Returns statistics about the thread pool's utilization.
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * Representation of the stage of life of the pool. See ThreadPool::LifecycleState.
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * A worker's deque. The owner pushes and pops at the back, thieves take from the front.
+     */
+    struct Worker {
+        stdx::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    static void _workerThreadBody(WorkStealingThreadPool* pool,
+                                  size_t workerIndex,
+                                  const std::string& threadName);
+
+    /**
+     * The run loop of worker 'workerIndex'. Returns once the pool is shutting down and no tasks
+     * remain.
+     */
+    void _consumeTasks(size_t workerIndex);
+
+    /**
+     * Takes a task for worker 'workerIndex' to run, or returns an empty Task if there is none.
+     */
+    Task _findTask(size_t workerIndex, bool injectionQueueFirst);
+
+    /**
+     * Takes the oldest task from the injection queue, moving a share of the rest to the deque of
+     * worker 'workerIndex'.
+     */
+    Task _popInjectedTask(size_t workerIndex);
+
+    /**
+     * Takes the oldest task from the deque of some worker other than 'thiefIndex'.
+     */
+    Task _stealTask(size_t thiefIndex);
+
+    /**
+     * Runs 'task', killing the process if it throws.
+     */
+    void _runTask(Task& task);
+
+    /**
+     * Wakes one sleeping worker, if any. Called after a task becomes available.
+     */
+    void _wakeWorker();
+
+    /**
+     * Implementation of shutdown once _mutex is locked.
+     */
+    void _shutdown_inlock();
+
+    /**
+     * Implementation of join once _mutex is owned by "lk".
+     */
+    void _join_inlock(stdx::unique_lock<stdx::mutex>* lk);
+
+    /**
+     * Runs the remaining tasks on a new thread as part of the join process, blocking until
+     * complete. Caller must not hold the mutex!
+     */
+    void _drainPendingTasks();
+
+    /**
+     * Changes the lifecycle state (_state) of the pool and wakes up any threads waiting for a state
+     * change. Has no effect if _state == newState.
+     */
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    // One per worker thread.
+    const std::unique_ptr<CacheAligned<Worker>[]> _workers;
+
+    // Guards _state, _injectedTasks and _threads, and is the mutex sleeping workers wait on.
+    mutable stdx::mutex _mutex;
+
+    LifecycleState _state = preStart;
+
+    // False once shutdown has been requested. Lets tasks in the pool schedule without _mutex.
+    AtomicWord<bool> _acceptingTasks{true};
+
+    // Tasks scheduled from outside the pool, and any scheduled before startup().
+    std::deque<Task> _injectedTasks;
+
+    // The size of _injectedTasks, so that workers can see it is empty without taking _mutex.
+    AtomicWord<long long> _numInjectedTasks;
+
+    std::vector<stdx::thread> _threads;
+
+    // Condition signaled when a task becomes available to sleeping workers, or when the pool
+    // starts shutting down.
+    stdx::condition_variable _workAvailable;
+
+    // Condition signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+
+    // Tasks scheduled and not yet taken by a worker, across the injection queue and all deques.
+    // Workers only sleep while this is zero.
+    CacheAligned<AtomicWord<long long>> _numPendingTasks;
+
+    // Workers waiting on _workAvailable. Schedulers only take _mutex to wake one if this is
+    // non-zero.
+    AtomicWord<long long> _numSleepingWorkers;
+
+    AtomicWord<long long> _numStolenTasks;
+};
+
+}  // namespace mongo
@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/barrier.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", [] {
+        return stdx::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+TEST(WorkStealingThreadPoolTest, StartsAllThreads) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    ASSERT_EQ(0U, pool.getStats().numThreads);
+    pool.startup();
+    ASSERT_EQ(4U, pool.getStats().numThreads);
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(0U, pool.getStats().numThreads);
+}
+
+TEST(WorkStealingThreadPoolTest, RunsTasksScheduledFromManyThreads) {
+    const size_t kSchedulers = 4;
+    const size_t kTasksPerScheduler = 10000;
+
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    AtomicWord<long long> count;
+    std::vector<stdx::thread> schedulers;
+    for (size_t i = 0; i < kSchedulers; ++i) {
+        schedulers.emplace_back([&] {
+            for (size_t j = 0; j < kTasksPerScheduler; ++j) {
+                ASSERT_OK(pool.schedule([&] { count.fetchAndAdd(1); }));
+            }
+        });
+    }
+    for (auto& scheduler : schedulers) {
+        scheduler.join();
+    }
+
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(static_cast<long long>(kSchedulers * kTasksPerScheduler), count.load());
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkersStealNestedTasks) {
+    const size_t kThreads = 4;
+
+    WorkStealingThreadPool::Options options;
+    options.numThreads = kThreads;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    // One task schedules a blocking task per worker onto its own deque. They can only all be
+    // running at once if the other workers steal them.
+    unittest::Barrier barrier(kThreads + 1);
+    ASSERT_OK(pool.schedule([&] {
+        for (size_t i = 0; i < kThreads; ++i) {
+            ASSERT_OK(pool.schedule([&] { barrier.countDownAndWait(); }));
+        }
+    }));
+    barrier.countDownAndWait();
+
+    ASSERT_GTE(pool.getStats().numStolenTasks, static_cast<long long>(kThreads - 1));
+    pool.shutdown();
+    pool.join();
+}
+
+TEST(WorkStealingThreadPoolTest, TasksRescheduledByTasksRunUntilShutdown) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 2;
+    WorkStealingThreadPool pool(options);
+
+    AtomicWord<long long> count;
+    stdx::function<void()> task = [&] {
+        if (count.addAndFetch(1) < 1000) {
+            ASSERT_OK(pool.schedule(task));
+        } else {
+            pool.shutdown();
+            ASSERT_EQ(ErrorCodes::ShutdownInProgress, pool.schedule(task));
+        }
+    };
+    ASSERT_OK(pool.schedule(task));
+    pool.startup();
+    pool.join();
+    ASSERT_EQ(1000, count.load());
+}
+
+TEST(WorkStealingThreadPoolTest, RunsOnCreateThreadFunctionBeforeConsumingTasks) {
+    unittest::Barrier barrier(2U);
+
+    bool onCreateThreadCalled = false;
+    std::string taskThreadName;
+    WorkStealingThreadPool::Options options;
+    options.threadNamePrefix = "mythread";
+    options.numThreads = 1U;
+    options.onCreateThread = [&onCreateThreadCalled,
+                              &taskThreadName](const std::string& threadName) {
+        onCreateThreadCalled = true;
+        taskThreadName = threadName;
+    };
+
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    ASSERT_OK(pool.schedule([&barrier] { barrier.countDownAndWait(); }));
+    barrier.countDownAndWait();
+
+    ASSERT_TRUE(onCreateThreadCalled);
+    ASSERT_EQUALS(options.threadNamePrefix + "0", taskThreadName);
+}
+
+DEATH_TEST(WorkStealingThreadPoolTest, NoThreadsDies, "but it must have at least 1") {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 0;
+    WorkStealingThreadPool pool(options);
+}
+
+}  // namespace
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/cycle_tick_source.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MONGO_CYCLE_TICK_SOURCE_HAVE_TSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+#include <cmath>
+
+#include "mongo/base/init.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/system_tick_source.h"
+
+namespace mongo {
+
+namespace {
+
+// Calibrate the cycle counter over at least this many system ticks' worth of wall time.
+const int64_t kCalibrationMicros = 2000;
+
+// The cycle counter is only used if two calibration rounds agree to within this fraction.
+const double kMaxCalibrationSkew = 0.01;
+
+bool useCycleCounter = false;
+TickSource::Tick cycleTicksPerSecond = 0;
+double microsPerTick = 0;
+
+#if defined(MONGO_CYCLE_TICK_SOURCE_HAVE_TSC)
+
+/**
+ * Returns true if CPUID reports an invariant TSC, i.e. one that ticks at a constant rate across
+ * P-, C- and T-state transitions.
+ */
+bool hasInvariantTsc() {
+    const unsigned int kAdvancedPowerManagementLeaf = 0x80000007;
+    const unsigned int kInvariantTscBit = 1u << 8;
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned int>(regs[0]) < kAdvancedPowerManagementLeaf) {
+        return false;
+    }
+    __cpuid(regs, kAdvancedPowerManagementLeaf);
+    return regs[3] & kInvariantTscBit;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0x80000000, nullptr) < kAdvancedPowerManagementLeaf) {
+        return false;
+    }
+    __get_cpuid(kAdvancedPowerManagementLeaf, &eax, &ebx, &ecx, &edx);
+    return edx & kInvariantTscBit;
+#endif
+}
+
+TickSource::Tick readTsc() {
+    return static_cast<TickSource::Tick>(__rdtsc());
+}
+
+/**
+ * Measures the cycle counter's rate against SystemTickSource, returning 0 if it didn't advance.
+ */
+TickSource::Tick calibrateTsc() {
+    SystemTickSource* systemTicks = SystemTickSource::get();
+    const TickSource::Tick systemTicksPerSecond = systemTicks->getTicksPerSecond();
+    const TickSource::Tick calibrationTicks = systemTicksPerSecond * kCalibrationMicros / 1000000;
+
+    const TickSource::Tick systemStart = systemTicks->getTicks();
+    const TickSource::Tick tscStart = readTsc();
+    TickSource::Tick systemEnd;
+    do {
+        systemEnd = systemTicks->getTicks();
+    } while (systemEnd - systemStart < calibrationTicks);
+    const TickSource::Tick tscEnd = readTsc();
+
+    if (tscEnd <= tscStart) {
+        return 0;
+    }
+
+    return static_cast<TickSource::Tick>(static_cast<double>(tscEnd - tscStart) *
+                                         systemTicksPerSecond / (systemEnd - systemStart));
+}
+
+void initCycleTickSource() {
+    if (!hasInvariantTsc()) {
+        return;
+    }
+
+    const TickSource::Tick first = calibrateTsc();
+    const TickSource::Tick second = calibrateTsc();
+    if (first <= 0 || second <= 0) {
+        return;
+    }
+
+    // A hypervisor may advertise an invariant TSC that it doesn't keep steady.
+    if (std::abs(static_cast<double>(first - second)) > kMaxCalibrationSkew * first) {
+        return;
+    }
+
+    cycleTicksPerSecond = (first + second) / 2;
+    useCycleCounter = true;
+}
+
+#else
+void initCycleTickSource() {}
+#endif
+
+}  // namespace
+
+MONGO_INITIALIZER_WITH_PREREQUISITES(CycleTickSourceInit, ("SystemTickSourceInit"))
+(InitializerContext* context) {
+    initCycleTickSource();
+    microsPerTick = 1000000.0 / CycleTickSource::get()->getTicksPerSecond();
+    return Status::OK();
+}
+
+TickSource::Tick CycleTickSource::now() {
+#if defined(MONGO_CYCLE_TICK_SOURCE_HAVE_TSC)
+    if (useCycleCounter) {
+        return readTsc();
+    }
+#endif
+    return SystemTickSource::get()->getTicks();
+}
+
+TickSource::Tick CycleTickSource::getTicksPerSecond() {
+    return useCycleCounter ? cycleTicksPerSecond : SystemTickSource::get()->getTicksPerSecond();
+}
+
+Microseconds CycleTickSource::ticksToMicros(TickSource::Tick ticks) {
+    return Microseconds(static_cast<long long>(ticks * microsPerTick));
+}
+
+bool CycleTickSource::usesCycleCounter() {
+    return useCycleCounter;
+}
+
+CycleTickSource* CycleTickSource::get() {
+    static const auto globalCycleTickSource = stdx::make_unique<CycleTickSource>();
+    return globalCycleTickSource.get();
+}
+
+}  // namespace mongo
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/util/duration.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+/**
+ * Tick source backed by the CPU's time stamp counter where it is known to tick at a constant rate
+ * (x86-64 with an invariant TSC). Reading it costs a handful of cycles, which makes it suitable for
+ * timing very short intervals on hot paths. The counter frequency is calibrated once at startup
+ * against SystemTickSource.
+ *
+ * On platforms without a usable cycle counter, or if two calibration rounds disagree (as they can
+ * on virtual machines that don't keep the counter stable), this falls back to SystemTickSource.
+ */
+class CycleTickSource final : public TickSource {
+public:
+    TickSource::Tick getTicks() override {
+        return now();
+    }
+
+    TickSource::Tick getTicksPerSecond() override;
+
+    /**
+     * Returns the current tick count without a virtual call.
+     */
+    static TickSource::Tick now();
+
+    /**
+     * Converts a difference between two values of now() into microseconds. Only valid once the
+     * global initializers have run.
+     */
+    static Microseconds ticksToMicros(TickSource::Tick ticks);
+
+    /**
+     * Returns true if ticks come from the CPU cycle counter rather than SystemTickSource.
+     */
+    static bool usesCycleCounter();
+
+    /**
+     * Gets the singleton instance of CycleTickSource. Should not be called before the global
+     * initializers are done.
+     */
+    static CycleTickSource* get();
+};
+
+}  // namespace mongo
@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/cycle_tick_source.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+TEST(CycleTickSourceTest, TicksAreMonotonic) {
+    auto previous = CycleTickSource::now();
+    for (int i = 0; i < 1000; ++i) {
+        auto current = CycleTickSource::now();
+        ASSERT_GTE(current, previous);
+        previous = current;
+    }
+}
+
+TEST(CycleTickSourceTest, FallsBackToSystemTickRate) {
+    auto ticksPerSecond = CycleTickSource::get()->getTicksPerSecond();
+    ASSERT_GT(ticksPerSecond, 0);
+    if (!CycleTickSource::usesCycleCounter()) {
+        ASSERT_EQUALS(SystemTickSource::get()->getTicksPerSecond(), ticksPerSecond);
+    }
+}
+
+TEST(CycleTickSourceTest, MeasuresElapsedTime) {
+    auto tickSource = CycleTickSource::get();
+    auto start = tickSource->getTicks();
+    sleepmillis(50);
+    auto elapsedMillis = (tickSource->getTicks() - start) * 1000 / tickSource->getTicksPerSecond();
+
+    // Sleeping may overshoot, but the calibration should never make us read less than we slept
+    // by more than a few percent.
+    ASSERT_GTE(elapsedMillis, 45);
+}
+
+TEST(CycleTickSourceTest, ConvertsTicksToMicros) {
+    auto ticksPerSecond = CycleTickSource::get()->getTicksPerSecond();
+    ASSERT_EQUALS(Microseconds(0), CycleTickSource::ticksToMicros(0));
+
+    // Allow for rounding in the conversion.
+    auto oneSecond = CycleTickSource::ticksToMicros(ticksPerSecond);
+    ASSERT_GTE(oneSecond, Microseconds(999999));
+    ASSERT_LTE(oneSecond, Microseconds(1000001));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -131,6 +131,24 @@ public:
         return Decoration<T>(getRegistry()->template declareDecoration<T>());
     }
 
+    /**
+     * Declares a decoration used by nearly every instance, which is placed next to the other
+     * decorations declared this way. See DecorationRegistry::declareHotDecoration().
+     */
+    template <typename T>
+    static Decoration<T> declareHotDecoration() {
+        return Decoration<T>(getRegistry()->template declareHotDecoration<T>());
+    }
+
+    /**
+     * Declares a decoration which is only constructed when first accessed. See
+     * DecorationRegistry::declareLazyDecoration().
+     */
+    template <typename T>
+    static Decoration<T> declareLazyDecoration() {
+        return Decoration<T>(getRegistry()->template declareLazyDecoration<T>());
+    }
+
 protected:
     Decorable() : _decorations(this, getRegistry()) {}
     ~Decorable() = default;
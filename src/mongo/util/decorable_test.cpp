@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <array>
 #include <boost/utility.hpp>
 
 #include "mongo/unittest/unittest.h"
@@ -178,6 +179,68 @@ TEST(DecorableTest, Alignment) {
                   std::alignment_of<int>::value);
 }
 
+TEST(DecorableTest, LazyDecorationConstructedOnFirstAccess) {
+    numConstructedAs = 0;
+    numDestructedAs = 0;
+    DecorationRegistry<MyDecorable> registry;
+    const auto eager = registry.declareDecoration<A>();
+    const auto lazy = registry.declareLazyDecoration<A>();
+    const auto lazyInt = registry.declareLazyDecoration<int>();
+
+    {
+        DecorationContainer<MyDecorable> unused(nullptr, &registry);
+        DecorationContainer<MyDecorable> used(nullptr, &registry);
+        ASSERT_EQ(2, numConstructedAs);
+
+        used.getDecoration(lazy).value = 1;
+        ASSERT_EQ(3, numConstructedAs);
+        ASSERT_EQ(1, used.getDecoration(lazy).value);
+        ASSERT_EQ(3, numConstructedAs);
+
+        const auto& constUsed = used;
+        ASSERT_EQ(0, constUsed.getDecoration(lazyInt));
+        ASSERT_EQ(0, used.getDecoration(eager).value);
+    }
+    // The lazy decoration of 'unused' was never constructed, so it is not destroyed either.
+    ASSERT_EQ(3, numDestructedAs);
+}
+
+#ifndef __s390x__
+// TODO(SERVER-34872) Re-enable this test, when we know that s390x will have correct exception
+// unwind handling.
+TEST(DecorableTest, ThrowingLazyConstructor) {
+    DecorationRegistry<MyDecorable> registry;
+    const auto lazy = registry.declareLazyDecoration<ThrowA>();
+
+    DecorationContainer<MyDecorable> d(nullptr, &registry);
+    ASSERT_THROWS_CODE(d.getDecoration(lazy), AssertionException, ErrorCodes::Unauthorized);
+    // A failed construction is retried on the next access.
+    ASSERT_THROWS_CODE(d.getDecoration(lazy), AssertionException, ErrorCodes::Unauthorized);
+}
+#endif
+
+TEST(DecorableTest, HotDecorationsShareTheFirstCacheLines) {
+    DecorationRegistry<MyDecorable> registry;
+    const auto large = registry.declareDecoration<std::array<char, 256>>();
+    const auto hotInt = registry.declareHotDecoration<int>();
+    const auto hotLong = registry.declareHotDecoration<long long>();
+    // Too large to fit in the first cache lines, so placed like any other decoration.
+    const auto hotLarge = registry.declareHotDecoration<std::array<char, 512>>();
+
+    DecorationContainer<MyDecorable> d(nullptr, &registry);
+    const auto address = [](const void* p) { return reinterpret_cast<uintptr_t>(p); };
+    ASSERT_LT(address(&d.getDecoration(hotInt)), address(&d.getDecoration(large)));
+    ASSERT_LT(address(&d.getDecoration(hotLong)), address(&d.getDecoration(large)));
+    ASSERT_GT(address(&d.getDecoration(hotLarge)), address(&d.getDecoration(large)));
+    ASSERT_EQ(0U, address(&d.getDecoration(hotLong)) % std::alignment_of<long long>::value);
+}
+
+TEST(DecorableTest, LazyDecorationWithOwner) {
+    const auto lazy = MyDecorable::declareLazyDecoration<A>();
+    MyDecorable decorable;
+    ASSERT_EQ(&decorable, lazy.owner(&lazy(decorable)));
+}
+
 struct DecoratedOwnerChecker : public Decorable<DecoratedOwnerChecker> {
     const char answer[100] = "The answer to life the universe and everything is 42";
 };
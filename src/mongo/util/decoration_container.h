@@ -31,6 +31,9 @@
 #include <cstdint>
 #include <memory>
 
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/new.h"
+
 namespace mongo {
 
 template <typename DecoratedType>
@@ -41,6 +44,11 @@ class Decorable;
 
 /**
  * An container for decorations.
+ *
+ * The decorations live in a single buffer aligned to a cache line, which starts with a pointer
+ * back to the decorated object followed by the decorations the registry placed first because they
+ * are used by nearly every instance. Decorations declared lazy are only constructed when first
+ * accessed.
  */
 template <typename DecoratedType>
 class DecorationContainer {
@@ -48,6 +56,11 @@ class DecorationContainer {
     DecorationContainer& operator=(const DecorationContainer&) = delete;
 
 public:
+    /**
+     * Function that constructs (initializes) a single instance of a decoration.
+     */
+    using DecorationConstructorFn = void (*)(void*);
+
     /**
      * Opaque descriptor of a decoration.  It is an identifier to a field on the
      * DecorationContainer that is private to those modules that have access to the descriptor.
@@ -63,7 +76,19 @@ public:
 
         explicit DecorationDescriptor(size_t index) : _index(index) {}
 
+        DecorationDescriptor(size_t index,
+                             size_t constructedFlagIndex,
+                             DecorationConstructorFn lazyConstructor)
+            : _index(index),
+              _constructedFlagIndex(constructedFlagIndex),
+              _lazyConstructor(lazyConstructor) {}
+
         size_t _index;
+
+        // For a lazy decoration, the offset of the flag recording whether it has been constructed,
+        // and the function constructing it. Zero and null for other decorations.
+        size_t _constructedFlagIndex = 0;
+        DecorationConstructorFn _lazyConstructor = nullptr;
     };
 
     /**
@@ -96,14 +121,15 @@ public:
     explicit DecorationContainer(Decorable<DecoratedType>* const decorated,
                                  const DecorationRegistry<DecoratedType>* const registry)
         : _registry(registry),
-          _decorationData(new unsigned char[registry->getDecorationBufferSizeBytes()]) {
+          _storage(new unsigned char[registry->getDecorationBufferSizeBytes() + kAlignment - 1]),
+          _decorationData(_alignedData(_storage.get())) {
         // Because the decorations live in the externally allocated storage buffer at
         // `_decorationData`, there needs to be a way to get back from a known location within this
         // buffer to the type which owns those decorations.  We place a pointer to ourselves, a
         // "back link" in the front of this storage buffer, as this is the easiest "well known
         // location" to compute.
         Decorable<DecoratedType>** const backLink =
-            reinterpret_cast<Decorable<DecoratedType>**>(_decorationData.get());
+            reinterpret_cast<Decorable<DecoratedType>**>(_decorationData);
         *backLink = decorated;
         _registry->construct(this);
     }
@@ -113,19 +139,26 @@ public:
     }
 
     /**
-     * Gets the decorated value for the given descriptor.
+     * Gets the decorated value for the given descriptor, constructing it first if it is a lazy
+     * decoration that has not been accessed before.
      *
      * The descriptor must be one returned from this DecorationContainer's associated _registry.
      */
     void* getDecoration(DecorationDescriptor descriptor) {
-        return _decorationData.get() + descriptor._index;
+        void* const decoration = _decorationData + descriptor._index;
+        if (MONGO_unlikely(descriptor._lazyConstructor != nullptr) && !_isConstructed(descriptor)) {
+            descriptor._lazyConstructor(decoration);
+            _setConstructed(descriptor, true);
+        }
+        return decoration;
     }
 
     /**
-     * Same as the non-const form above, but returns a const result.
+     * Same as the non-const form above, but returns a const result. Constructing a lazy decoration
+     * on first access does not change the container's observable state.
      */
     const void* getDecoration(DecorationDescriptor descriptor) const {
-        return _decorationData.get() + descriptor._index;
+        return const_cast<DecorationContainer*>(this)->getDecoration(descriptor);
     }
 
     /**
@@ -145,8 +178,33 @@ public:
     }
 
 private:
+    friend DecorationRegistry<DecoratedType>;
+
+    static constexpr size_t kAlignment = stdx::hardware_constructive_interference_size;
+
+    static unsigned char* _alignedData(unsigned char* storage) {
+        const auto misalignment = reinterpret_cast<uintptr_t>(storage) % kAlignment;
+        return misalignment ? storage + (kAlignment - misalignment) : storage;
+    }
+
+    /**
+     * Returns the storage of a decoration without constructing it.
+     */
+    void* _getStorage(DecorationDescriptor descriptor) {
+        return _decorationData + descriptor._index;
+    }
+
+    bool _isConstructed(DecorationDescriptor descriptor) const {
+        return _decorationData[descriptor._constructedFlagIndex];
+    }
+
+    void _setConstructed(DecorationDescriptor descriptor, bool constructed) {
+        _decorationData[descriptor._constructedFlagIndex] = constructed;
+    }
+
     const DecorationRegistry<DecoratedType>* const _registry;
-    const std::unique_ptr<unsigned char[]> _decorationData;
+    const std::unique_ptr<unsigned char[]> _storage;
+    unsigned char* const _decorationData;
 };
 
 }  // namespace mongo
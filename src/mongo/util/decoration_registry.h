@@ -37,6 +37,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/stdx/new.h"
 #include "mongo/util/decoration_container.h"
 #include "mongo/util/scopeguard.h"
 
@@ -65,12 +66,30 @@ public:
      */
     template <typename T>
     auto declareDecoration() {
-        MONGO_STATIC_ASSERT_MSG(std::is_nothrow_destructible<T>::value,
-                                "Decorations must be nothrow destructible");
-        return
-            typename DecorationContainer<DecoratedType>::template DecorationDescriptorWithType<T>(
-                std::move(declareDecoration(
-                    sizeof(T), std::alignment_of<T>::value, &constructAt<T>, &destroyAt<T>)));
+        return _declareDecoration<T>(Placement::kDefault);
+    }
+
+    /**
+     * Like declareDecoration(), but places the decoration in the first cache lines of the
+     * container, next to the pointer back to the decorated object, while there is room left there.
+     * Meant for the few decorations that nearly every instance uses.
+     */
+    template <typename T>
+    auto declareHotDecoration() {
+        return _declareDecoration<T>(Placement::kHot);
+    }
+
+    /**
+     * Like declareDecoration(), but the decoration is only constructed on first access, and only
+     * destroyed if it was constructed. Meant for decorations that most instances never use.
+     *
+     * Since the first access constructs the decoration, even a const access must be synchronized
+     * like a write. Decorations read by other threads, such as through currentOp, should not be
+     * lazy.
+     */
+    template <typename T>
+    auto declareLazyDecoration() {
+        return _declareDecoration<T>(Placement::kLazy);
     }
 
     size_t getDecorationBufferSizeBytes() const {
@@ -79,13 +98,17 @@ public:
 
     /**
      * Constructs the decorations declared in this registry on the given instance of
-     * "decorable".
+     * "decorable". Lazy decorations are only marked as not yet constructed.
      *
      * Called by the DecorationContainer constructor. Do not call directly.
      */
     void construct(DecorationContainer<DecoratedType>* const container) const {
         using std::cbegin;
 
+        for (auto& decoration : _lazyDecorationInfo) {
+            container->_setConstructed(decoration.descriptor, false);
+        }
+
         auto iter = cbegin(_decorationInfo);
 
         auto cleanupFunction = [&iter, container, this ]() noexcept->void {
@@ -94,7 +117,7 @@ public:
                           crend(this->_decorationInfo),
                           [&](auto&& decoration) {
                               decoration.destructor(
-                                  container->getDecoration(decoration.descriptor));
+                                  container->_getStorage(decoration.descriptor));
                           });
         };
 
@@ -103,30 +126,39 @@ public:
         using std::cend;
 
         for (; iter != cend(_decorationInfo); ++iter) {
-            iter->constructor(container->getDecoration(iter->descriptor));
+            iter->constructor(container->_getStorage(iter->descriptor));
         }
 
         cleanup.Dismiss();
     }
 
     /**
-     * Destroys the decorations declared in this registry on the given instance of "decorable".
+     * Destroys the decorations declared in this registry on the given instance of "decorable",
+     * starting with the lazy decorations that were constructed.
      *
      * Called by the DecorationContainer destructor.  Do not call directly.
      */
     void destroy(DecorationContainer<DecoratedType>* const container) const noexcept try {
+        for (auto iter = _lazyDecorationInfo.rbegin(); iter != _lazyDecorationInfo.rend(); ++iter) {
+            if (container->_isConstructed(iter->descriptor)) {
+                iter->destructor(container->_getStorage(iter->descriptor));
+            }
+        }
         for (auto& decoration : _decorationInfo) {
-            decoration.destructor(container->getDecoration(decoration.descriptor));
+            decoration.destructor(container->_getStorage(decoration.descriptor));
         }
     } catch (...) {
         std::terminate();
     }
 
 private:
+    enum class Placement { kDefault, kHot, kLazy };
+
     /**
      * Function that constructs (initializes) a single instance of a decoration.
      */
-    using DecorationConstructorFn = void (*)(void*);
+    using DecorationConstructorFn =
+        typename DecorationContainer<DecoratedType>::DecorationConstructorFn;
 
     /**
      * Function that destroys (deinitializes) a single instance of a decoration.
@@ -150,6 +182,19 @@ private:
 
     using DecorationInfoVector = std::vector<DecorationInfo>;
 
+    template <typename T>
+    auto _declareDecoration(Placement placement) {
+        MONGO_STATIC_ASSERT_MSG(std::is_nothrow_destructible<T>::value,
+                                "Decorations must be nothrow destructible");
+        return
+            typename DecorationContainer<DecoratedType>::template DecorationDescriptorWithType<T>(
+                std::move(declareDecoration(sizeof(T),
+                                            std::alignment_of<T>::value,
+                                            &constructAt<T>,
+                                            &destroyAt<T>,
+                                            placement)));
+    }
+
     template <typename T>
     static void constructAt(void* location) {
         new (location) T();
@@ -160,6 +205,11 @@ private:
         static_cast<T*>(location)->~T();
     }
 
+    static size_t alignOffset(size_t offset, size_t alignBytes) {
+        const size_t misalignment = offset % alignBytes;
+        return misalignment ? offset + (alignBytes - misalignment) : offset;
+    }
+
     /**
      * Declares a decoration with given "constructor" and "destructor" functions,
      * of "sizeBytes" bytes.
@@ -170,19 +220,45 @@ private:
         const size_t sizeBytes,
         const size_t alignBytes,
         const DecorationConstructorFn constructor,
-        const DecorationDestructorFn destructor) {
-        const size_t misalignment = _totalSizeBytes % alignBytes;
-        if (misalignment) {
-            _totalSizeBytes += alignBytes - misalignment;
+        const DecorationDestructorFn destructor,
+        const Placement placement) {
+        if (placement == Placement::kHot) {
+            const size_t offset = alignOffset(_hotSizeBytes, alignBytes);
+            if (offset + sizeBytes <= kHotRegionSizeBytes) {
+                typename DecorationContainer<DecoratedType>::DecorationDescriptor result(offset);
+                _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+                _hotSizeBytes = offset + sizeBytes;
+                return result;
+            }
+            // Once the first cache lines are full, hot decorations are placed like any other.
         }
-        typename DecorationContainer<DecoratedType>::DecorationDescriptor result(_totalSizeBytes);
+
+        if (placement == Placement::kLazy) {
+            const size_t constructedFlagIndex = _totalSizeBytes;
+            const size_t offset = alignOffset(constructedFlagIndex + 1, alignBytes);
+            typename DecorationContainer<DecoratedType>::DecorationDescriptor result(
+                offset, constructedFlagIndex, constructor);
+            _lazyDecorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+            _totalSizeBytes = offset + sizeBytes;
+            return result;
+        }
+
+        const size_t offset = alignOffset(_totalSizeBytes, alignBytes);
+        typename DecorationContainer<DecoratedType>::DecorationDescriptor result(offset);
         _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
-        _totalSizeBytes += sizeBytes;
+        _totalSizeBytes = offset + sizeBytes;
         return result;
     }
 
+    // The first cache lines of the buffer, which hold the back link and the hot decorations.
+    static constexpr size_t kHotRegionSizeBytes = 2 * stdx::hardware_constructive_interference_size;
+
+    // Decorations constructed with their container, in declaration order.
     DecorationInfoVector _decorationInfo;
-    size_t _totalSizeBytes{sizeof(void*)};
+    // Decorations constructed on first access.
+    DecorationInfoVector _lazyDecorationInfo;
+    size_t _hotSizeBytes{sizeof(void*)};
+    size_t _totalSizeBytes{kHotRegionSizeBytes};
 };
 
 }  // namespace mongo
@@ -30,6 +30,8 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
+#include <cstddef>
+#include <new>
 #include <type_traits>
 
 #include "mongo/base/checked_cast.h"
@@ -302,6 +304,155 @@ boost::intrusive_ptr<T> make_intrusive(Args&&... args) {
 }
 
 
+#if !defined(__has_feature)
+#define __has_feature(x) 0
+#endif
+
+/**
+ * Recycles the memory of SharedStates of the same rounded-up size on the thread that frees them, so
+ * that a steady stream of continuations stops going to the allocator. Each thread keeps at most
+ * kMaxCachedPerThread blocks per size; the rest are freed as usual. Pooling is skipped for large
+ * or over-aligned SharedStates, and under ASAN so it can still catch uses after free.
+ */
+template <size_t kBytes, bool kPooled>
+class SharedStatePool {
+public:
+    static constexpr size_t kMaxCachedPerThread = 64;
+
+    static void* allocate() {
+        auto& list = _threadList();
+        if (list.head) {
+            auto node = list.head;
+            list.head = node->next;
+            --list.size;
+            return node;
+        }
+        return ::operator new(kBytes);
+    }
+
+    static void free(void* ptr) noexcept {
+        auto& list = _threadList();
+        if (list.size >= kMaxCachedPerThread) {
+            ::operator delete(ptr);
+            return;
+        }
+        auto node = static_cast<Node*>(ptr);
+        node->next = list.head;
+        list.head = node;
+        ++list.size;
+    }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    struct List {
+        ~List() {
+            while (head) {
+                auto node = head;
+                head = node->next;
+                ::operator delete(node);
+            }
+            // SharedStates freed later in thread exit go straight to the allocator.
+            size = kMaxCachedPerThread;
+        }
+
+        Node* head = nullptr;
+        size_t size = 0;
+    };
+
+    static List& _threadList() {
+        static thread_local List list;
+        return list;
+    }
+};
+
+template <size_t kBytes>
+class SharedStatePool<kBytes, false> {
+public:
+    static void* allocate() {
+        return ::operator new(kBytes);
+    }
+
+    static void free(void* ptr) noexcept {
+        ::operator delete(ptr);
+    }
+};
+
+template <typename T>
+using SharedStatePoolFor =
+    SharedStatePool<(sizeof(T) + 63) / 64 * 64,
+                    !__has_feature(address_sanitizer) && sizeof(T) <= 512 &&
+                        alignof(T) <= alignof(std::max_align_t)>;
+
+class SharedStateBase;
+
+/**
+ * The type-erased callback run when a SharedState completes. It is set at most once and never
+ * moved, since it lives inside the SharedState, so callables of up to kInlineBytes are stored in
+ * place. That covers nearly every continuation and avoids the allocation std::function would make.
+ * Larger callables go on the heap.
+ */
+class SharedStateCallback {
+public:
+    static constexpr size_t kInlineBytes = 6 * sizeof(void*);
+
+    SharedStateCallback() = default;
+
+    SharedStateCallback(const SharedStateCallback&) = delete;
+    SharedStateCallback& operator=(const SharedStateCallback&) = delete;
+
+    ~SharedStateCallback() {
+        if (_target) {
+            _destroy(_target);
+        }
+    }
+
+    template <typename Func>
+    void operator=(Func&& func) {
+        using F = std::decay_t<Func>;
+        dassert(!_target);
+        constexpr bool kFitsInline = sizeof(F) <= kInlineBytes && alignof(F) <= alignof(Storage);
+        _emplace<F>(std::forward<Func>(func), std::integral_constant<bool, kFitsInline>());
+        _invoke = [](void* target, SharedStateBase* ssb) noexcept {
+            (*static_cast<F*>(target))(ssb);
+        };
+    }
+
+    explicit operator bool() const {
+        return _target;
+    }
+
+    void operator()(SharedStateBase* ssb) noexcept {
+        _invoke(_target, ssb);
+    }
+
+private:
+    using Storage = std::aligned_storage_t<kInlineBytes>;
+
+    template <typename F, typename Func>
+    void _emplace(Func&& func, std::true_type /* fits inline */) {
+        _target = new (&_storage) F(std::forward<Func>(func));
+        _destroy = [](void* target) noexcept {
+            static_cast<F*>(target)->~F();
+        };
+    }
+
+    template <typename F, typename Func>
+    void _emplace(Func&& func, std::false_type /* fits inline */) {
+        _target = new F(std::forward<Func>(func));
+        _destroy = [](void* target) noexcept {
+            delete static_cast<F*>(target);
+        };
+    }
+
+    void* _target = nullptr;
+    void (*_invoke)(void*, SharedStateBase*) = nullptr;
+    void (*_destroy)(void*) = nullptr;
+    Storage _storage;
+};
+
 template <typename T>
 struct SharedStateImpl;
 
@@ -422,7 +573,7 @@ public:
     boost::intrusive_ptr<SharedStateBase> continuation;  // F
 
     // Takes this as argument and usually writes to continuation.
-    std::function<void(SharedStateBase* input)> callback;  // F
+    SharedStateCallback callback;  // F
 
 
     // These are only used to signal completion to blocking waiters. Benchmarks showed that it was
@@ -440,6 +591,15 @@ template <typename T>
 struct SharedStateImpl final : SharedStateBase {
     MONGO_STATIC_ASSERT(!std::is_void<T>::value);
 
+    static void* operator new(size_t size) {
+        dassert(size == sizeof(SharedStateImpl));
+        return SharedStatePoolFor<SharedStateImpl>::allocate();
+    }
+
+    static void operator delete(void* ptr) noexcept {
+        SharedStatePoolFor<SharedStateImpl>::free(ptr);
+    }
+
     // Remaining methods only called by promise side.
     void fillFrom(SharedState<T>&& other) {
         dassert(state.load() < SSBState::kFinished);
@@ -705,8 +865,8 @@ public:
 
     static Future<T> makeReady(Status status) {
         invariant(!status.isOK());
-        auto out = Future<T>(make_intrusive<SharedState<T>>());
-        out.shared->setError(std::move(status));
+        Future out;
+        out.immediateError = std::move(status);
         return out;
     }
 
@@ -732,7 +892,8 @@ public:
     bool isReady() const {
         // This can be a relaxed load because callers are not allowed to use it to establish
         // ordering.
-        return immediate || shared->state.load(std::memory_order_relaxed) == SSBState::kFinished;
+        return immediate || !immediateError.isOK() ||
+            shared->state.load(std::memory_order_relaxed) == SSBState::kFinished;
     }
 
     /**
@@ -755,6 +916,9 @@ public:
         if (immediate) {
             return std::move(*immediate);
         }
+        if (!immediateError.isOK()) {
+            return std::move(immediateError);
+        }
 
         shared->wait();
         if (!shared->status.isOK())
@@ -765,6 +929,9 @@ public:
         if (immediate) {
             return *immediate;
         }
+        if (!immediateError.isOK()) {
+            return immediateError;
+        }
 
         shared->wait();
         if (!shared->status.isOK())
@@ -976,7 +1143,7 @@ public:
                 (std::is_same<T, FakeVoid>::value && std::is_same<Result, Future<void>>::value),
             "func passed to Future<T>::onError must return T, StatusWith<T>, or Future<T>");
 
-        if (immediate || (isReady() && shared->status.isOK()))
+        if (immediate || (shared && isReady() && shared->status.isOK()))
             return std::move(*this);  // Avoid copy/moving func if we know we won't call it.
 
         // TODO in C++17 with constexpr if this can be done cleaner and more efficiently by not
@@ -1079,6 +1246,7 @@ private:
         if (immediate) {
             return *immediate;
         }
+        uassertStatusOK(immediateError);
 
         shared->wait();
         uassertStatusOK(shared->status);
@@ -1092,6 +1260,9 @@ private:
         if (immediate) {
             return success(std::move(*immediate));
         }
+        if (!immediateError.isOK()) {
+            return fail(std::move(immediateError));
+        }
 
         if (shared->state.load(std::memory_order_acquire) == SSBState::kFinished) {
             if (shared->status.isOK()) {
@@ -1193,8 +1364,10 @@ private:
 
     explicit Future(boost::intrusive_ptr<SharedState<T>> ptr) : shared(std::move(ptr)) {}
 
-    // At most one of these will be active.
+    // At most one of these will be active. A ready value or error is held directly, so that
+    // makeReady() never allocates.
     boost::optional<T> immediate;
+    Status immediateError = Status::OK();
     boost::intrusive_ptr<SharedState<T>> shared;
 };
 
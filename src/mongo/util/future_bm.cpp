@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <array>
 #include <benchmark/benchmark.h>
 
 #include "mongo/bson/inline_decls.h"
@@ -63,6 +64,23 @@ void BM_futureIntReadyThen(benchmark::State& state) {
     }
 }
 
+NOINLINE_DECL Future<int> makeReadyErrorFut() {
+    benchmark::ClobberMemory();
+    return Future<int>::makeReady(Status(ErrorCodes::InternalError, "error"));
+}
+
+void BM_futureIntReadyError(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(makeReadyErrorFut().getNoThrow());
+    }
+}
+
+void BM_futureIntReadyErrorOnError(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(makeReadyErrorFut().onError([](Status) { return 1; }).get());
+    }
+}
+
 NOINLINE_DECL Future<int> makeReadyFutWithPromise() {
     benchmark::ClobberMemory();
     Promise<int> p;
@@ -129,6 +147,18 @@ void BM_futureIntDeferredThenReady(benchmark::State& state) {
     }
 }
 
+void BM_futureIntDeferredThenLargeCapture(benchmark::State& state) {
+    // The capture is too large to be stored inline in the SharedState.
+    std::array<int, 32> addends{};
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        Promise<int> p;
+        auto fut = p.getFuture().then([addends](int i) { return i + addends[0]; });
+        p.emplaceValue(1);
+        benchmark::DoNotOptimize(std::move(fut).get());
+    }
+}
+
 void BM_futureIntDoubleDeferredThen(benchmark::State& state) {
     for (auto _ : state) {
         benchmark::ClobberMemory();
@@ -215,12 +245,15 @@ void BM_futureInt4xDeferredThenChained(benchmark::State& state) {
 BENCHMARK(BM_plainIntReady);
 BENCHMARK(BM_futureIntReady);
 BENCHMARK(BM_futureIntReadyThen);
+BENCHMARK(BM_futureIntReadyError);
+BENCHMARK(BM_futureIntReadyErrorOnError);
 BENCHMARK(BM_futureIntReadyWithPromise);
 BENCHMARK(BM_futureIntReadyWithPromiseThen);
 BENCHMARK(BM_futureIntReadyWithPromise2);
 BENCHMARK(BM_futureIntDeferredThen);
 BENCHMARK(BM_futureIntDeferredThenImmediate);
 BENCHMARK(BM_futureIntDeferredThenReady);
+BENCHMARK(BM_futureIntDeferredThenLargeCapture);
 BENCHMARK(BM_futureIntDoubleDeferredThen);
 BENCHMARK(BM_futureInt3xDeferredThenNested);
 BENCHMARK(BM_futureInt3xDeferredThenChained);
@@ -30,6 +30,9 @@
 
 #include "mongo/util/future.h"
 
+#include <array>
+
+#include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
@@ -298,6 +301,45 @@ TEST(Future, Success_thenSimpleAuto) {
                         });
 }
 
+TEST(Future, Success_thenLargeCapture) {
+    // Too big to be stored inline in the SharedState's callback.
+    std::array<int, 32> addends;
+    addends.fill(1);
+    FUTURE_SUCCESS_TEST([] { return 1; },
+                        [&](Future<int>&& fut) {
+                            ASSERT_EQ(std::move(fut)
+                                          .then([addends](int i) {
+                                              for (auto addend : addends) {
+                                                  i += addend;
+                                              }
+                                              return i;
+                                          })
+                                          .get(),
+                                      33);
+                        });
+}
+
+TEST(Future, Success_thenMoveOnlyCapture) {
+    FUTURE_SUCCESS_TEST([] { return 1; },
+                        [](Future<int>&& fut) {
+                            auto addend = stdx::make_unique<int>(2);
+                            ASSERT_EQ(std::move(fut)
+                                          .then([addend = std::move(addend)](int i) {
+                                              return i + *addend;
+                                          })
+                                          .get(),
+                                      3);
+                        });
+}
+
+TEST(Future, Fail_immediateIsReadyWithoutSharedState) {
+    auto fut = Future<int>::makeReady(failStatus);
+    ASSERT(fut.isReady());
+    ASSERT_EQ(fut.getNoThrow(), failStatus);
+    ASSERT_EQ(std::move(fut).onError<ErrorCodes::Error(50728)>([](Status) { return 3; }).get(),
+              3);
+}
+
 TEST(Future, Success_thenVoid) {
     FUTURE_SUCCESS_TEST(
         [] { return 1; },
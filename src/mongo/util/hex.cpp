@@ -90,6 +90,17 @@ std::string integerToHex<unsigned long long>(unsigned long long val) {
     return integerToHexDef(val);
 }
 
+std::string unsignedIntToFixedLengthHex(std::uint64_t val) {
+    static const char hexchars[] = "0123456789ABCDEF";
+
+    char outbuf[sizeof(val) * 2];
+    for (int j = int(sizeof(outbuf)) - 1; j >= 0; j--) {
+        outbuf[j] = hexchars[val & 0xF];
+        val = val >> 4;
+    }
+    return std::string(outbuf, sizeof(outbuf));
+}
+
 
 std::string hexdump(const char* data, unsigned len) {
     verify(len < 1000000);
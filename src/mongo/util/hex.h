@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <string>
 
 #include "mongo/base/string_data.h"
@@ -95,6 +96,11 @@ inline std::string toHex(const void* inRaw, int len) {
 template <typename T>
 std::string integerToHex(T val);
 
+/**
+ * Returns 'val' as exactly 16 upper-case hexadecimal digits, including leading zeros.
+ */
+std::string unsignedIntToFixedLengthHex(std::uint64_t val);
+
 inline std::string toHexLower(const void* inRaw, int len) {
     static const char hexchars[] = "0123456789abcdef";
 
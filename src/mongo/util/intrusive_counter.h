@@ -102,7 +102,9 @@ public:
     };
 
     friend void intrusive_ptr_release(const RefCountable* ptr) {
-        if (ptr->_count.subtractAndFetch(1) == 0) {
+        // The holder of the only reference has exclusive access, and no other thread can acquire a
+        // new reference without it, so we can skip the atomic decrement before deleting.
+        if (ptr->_count.load() == 1 || ptr->_count.subtractAndFetch(1) == 0) {
             delete ptr;  // uses subclass destructor and operator delete
         }
     };
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/memory_usage_tracker.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr size_t MemoryUsageTracker::kNumCategories;
+
+namespace {
+
+MemoryUsageTracker::CurrentOperationUsageFn currentOperationUsageFn = nullptr;
+
+void raisePeak(AtomicWord<long long>* peak, long long value) {
+    long long seen = peak->load();
+    while (value > seen) {
+        const long long previous = peak->compareAndSwap(seen, value);
+        if (previous == seen) {
+            return;
+        }
+        seen = previous;
+    }
+}
+
+}  // namespace
+
+void MemoryUsageTracker::OperationUsage::add(long long delta) {
+    raisePeak(&_peak, _current.addAndFetch(delta));
+}
+
+void MemoryUsageTracker::setCurrentOperationUsageFn(CurrentOperationUsageFn fn) {
+    currentOperationUsageFn = fn;
+}
+
+MemoryUsageTracker& MemoryUsageTracker::get() {
+    static MemoryUsageTracker tracker;
+    return tracker;
+}
+
+StringData MemoryUsageTracker::categoryName(Category category) {
+    switch (category) {
+        case Category::kSorter:
+            return "sorter"_sd;
+        case Category::kBlockingSort:
+            return "blockingSort"_sd;
+        case Category::kGroup:
+            return "group"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void MemoryUsageTracker::add(Category category, long long delta) {
+    auto& counters = _counters[static_cast<size_t>(category)];
+    raisePeak(&counters.peak, counters.current.addAndFetch(delta));
+
+    if (currentOperationUsageFn) {
+        if (auto opUsage = currentOperationUsageFn()) {
+            opUsage->add(delta);
+        }
+    }
+}
+
+MemoryUsageTracker::Usage MemoryUsageTracker::getUsage(Category category) const {
+    const auto& counters = _counters[static_cast<size_t>(category)];
+    return {counters.current.load(), counters.peak.load()};
+}
+
+void MemoryUsageTracker::report(BSONObjBuilder* builder) const {
+    for (size_t i = 0; i < kNumCategories; ++i) {
+        const auto category = static_cast<Category>(i);
+        const auto usage = getUsage(category);
+        BSONObjBuilder categoryBuilder(builder->subobjStart(categoryName(category)));
+        categoryBuilder.append("currentBytes", usage.currentBytes);
+        categoryBuilder.append("peakBytes", usage.peakBytes);
+    }
+}
+
+}  // namespace mongo
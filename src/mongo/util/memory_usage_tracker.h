@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Accounts for the memory held by server subsystems that buffer large amounts of data, so that
+ * heap growth can be attributed to them. The allocator is not hooked: each subsystem reports the
+ * bytes it holds through a TrackedMemory handle, using the estimate it already keeps to enforce its
+ * memory limit.
+ *
+ * Usage is aggregated per category for the whole process, and per operation for whichever
+ * operation is running on the reporting thread. Per-operation usage is the net change made while
+ * the operation runs. Memory an operation releases on behalf of an earlier one, such as a getMore
+ * freeing a buffer its find filled, can take it below zero, so its peak is what gets reported.
+ */
+class MemoryUsageTracker {
+    MONGO_DISALLOW_COPYING(MemoryUsageTracker);
+
+public:
+    enum class Category {
+        kSorter,        // In-memory data of the external Sorter, used by $sort and index builds.
+        kBlockingSort,  // Working set members buffered by the find SORT stage.
+        kGroup,         // Groups held in memory by $group.
+    };
+    static constexpr size_t kNumCategories = 3;
+
+    struct Usage {
+        long long currentBytes = 0;
+        long long peakBytes = 0;
+    };
+
+    /**
+     * The memory attributed to a single operation. Updated by the operation's own thread, and read
+     * by others for currentOp.
+     */
+    class OperationUsage {
+    public:
+        void add(long long delta);
+
+        Usage get() const {
+            return {_current.load(), _peak.load()};
+        }
+
+    private:
+        AtomicWord<long long> _current{0};
+        AtomicWord<long long> _peak{0};
+    };
+
+    /**
+     * Returns the usage of the operation running on the calling thread, or nullptr if there is
+     * none. Installed by the layer that knows about operations.
+     */
+    using CurrentOperationUsageFn = OperationUsage* (*)();
+    static void setCurrentOperationUsageFn(CurrentOperationUsageFn fn);
+
+    /**
+     * Returns the process-wide tracker.
+     */
+    static MemoryUsageTracker& get();
+
+    static StringData categoryName(Category category);
+
+    /**
+     * Adds 'delta' bytes, which may be negative, to 'category' and to the current operation.
+     */
+    void add(Category category, long long delta);
+
+    Usage getUsage(Category category) const;
+
+    /**
+     * Appends a subdocument per category with its current and peak bytes.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    MemoryUsageTracker() = default;
+
+    struct Counters {
+        AtomicWord<long long> current{0};
+        AtomicWord<long long> peak{0};
+    };
+
+    std::array<Counters, kNumCategories> _counters;
+};
+
+/**
+ * The bytes one object holds in a MemoryUsageTracker category. Changes are reported to the tracker
+ * as they are made, and whatever is still held is released on destruction.
+ */
+class TrackedMemory {
+    MONGO_DISALLOW_COPYING(TrackedMemory);
+
+public:
+    explicit TrackedMemory(MemoryUsageTracker::Category category) : _category(category) {}
+
+    ~TrackedMemory() {
+        set(0);
+    }
+
+    /**
+     * Records that the object now holds 'bytes' bytes.
+     */
+    void set(long long bytes) {
+        const long long delta = bytes - _bytes;
+        if (delta) {
+            _bytes = bytes;
+            _peakBytes = std::max(_peakBytes, bytes);
+            MemoryUsageTracker::get().add(_category, delta);
+        }
+    }
+
+    long long bytes() const {
+        return _bytes;
+    }
+
+    /**
+     * Returns the most bytes the object has held at once.
+     */
+    long long peakBytes() const {
+        return _peakBytes;
+    }
+
+private:
+    const MemoryUsageTracker::Category _category;
+    long long _bytes = 0;
+    long long _peakBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/memory_usage_tracker.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Category = MemoryUsageTracker::Category;
+
+MemoryUsageTracker::OperationUsage* testOperationUsage = nullptr;
+
+class MemoryUsageTrackerTest : public unittest::Test {
+public:
+    void setUp() override {
+        MemoryUsageTracker::setCurrentOperationUsageFn([] { return testOperationUsage; });
+    }
+
+    void tearDown() override {
+        testOperationUsage = nullptr;
+        MemoryUsageTracker::setCurrentOperationUsageFn(nullptr);
+    }
+
+    long long currentBytes(Category category) {
+        return MemoryUsageTracker::get().getUsage(category).currentBytes;
+    }
+};
+
+TEST_F(MemoryUsageTrackerTest, TrackedMemoryUpdatesCategory) {
+    const auto before = currentBytes(Category::kSorter);
+    {
+        TrackedMemory tracked(Category::kSorter);
+        tracked.set(1000);
+        ASSERT_EQ(currentBytes(Category::kSorter), before + 1000);
+        tracked.set(400);
+        ASSERT_EQ(currentBytes(Category::kSorter), before + 400);
+        ASSERT_EQ(tracked.bytes(), 400);
+    }
+    ASSERT_EQ(currentBytes(Category::kSorter), before);
+}
+
+TEST_F(MemoryUsageTrackerTest, CategoriesAreIndependent) {
+    const auto sorterBefore = currentBytes(Category::kSorter);
+    const auto groupBefore = currentBytes(Category::kGroup);
+
+    TrackedMemory tracked(Category::kGroup);
+    tracked.set(2048);
+    ASSERT_EQ(currentBytes(Category::kGroup), groupBefore + 2048);
+    ASSERT_EQ(currentBytes(Category::kSorter), sorterBefore);
+}
+
+TEST_F(MemoryUsageTrackerTest, PeakIsRetainedAfterRelease) {
+    const auto before = MemoryUsageTracker::get().getUsage(Category::kBlockingSort);
+    {
+        TrackedMemory tracked(Category::kBlockingSort);
+        tracked.set(before.peakBytes + 5000);
+    }
+    const auto after = MemoryUsageTracker::get().getUsage(Category::kBlockingSort);
+    ASSERT_EQ(after.currentBytes, before.currentBytes);
+    ASSERT_GTE(after.peakBytes, before.peakBytes + 5000);
+}
+
+TEST_F(MemoryUsageTrackerTest, TrackedMemoryKeepsPeak) {
+    TrackedMemory tracked(Category::kGroup);
+    tracked.set(300);
+    tracked.set(900);
+    tracked.set(100);
+    ASSERT_EQ(tracked.bytes(), 100);
+    ASSERT_EQ(tracked.peakBytes(), 900);
+}
+
+TEST_F(MemoryUsageTrackerTest, AttributesToCurrentOperation) {
+    MemoryUsageTracker::OperationUsage opUsage;
+    testOperationUsage = &opUsage;
+
+    TrackedMemory sorter(Category::kSorter);
+    TrackedMemory group(Category::kGroup);
+    sorter.set(300);
+    group.set(700);
+    sorter.set(0);
+
+    const auto usage = opUsage.get();
+    ASSERT_EQ(usage.currentBytes, 700);
+    ASSERT_EQ(usage.peakBytes, 1000);
+}
+
+TEST_F(MemoryUsageTrackerTest, ReleaseByLaterOperationKeepsPeak) {
+    MemoryUsageTracker::OperationUsage first;
+    MemoryUsageTracker::OperationUsage second;
+
+    testOperationUsage = &first;
+    TrackedMemory tracked(Category::kSorter);
+    tracked.set(500);
+
+    testOperationUsage = &second;
+    tracked.set(0);
+
+    ASSERT_EQ(first.get().peakBytes, 500);
+    ASSERT_EQ(second.get().currentBytes, -500);
+    ASSERT_EQ(second.get().peakBytes, 0);
+}
+
+TEST_F(MemoryUsageTrackerTest, NoCurrentOperation) {
+    const auto before = currentBytes(Category::kGroup);
+    TrackedMemory tracked(Category::kGroup);
+    tracked.set(64);
+    ASSERT_EQ(currentBytes(Category::kGroup), before + 64);
+}
+
+TEST_F(MemoryUsageTrackerTest, ReportsEveryCategory) {
+    BSONObjBuilder builder;
+    MemoryUsageTracker::get().report(&builder);
+    const auto obj = builder.obj();
+
+    ASSERT_EQ(obj.nFields(), static_cast<int>(MemoryUsageTracker::kNumCategories));
+    for (auto name : {"sorter", "blockingSort", "group"}) {
+        const auto category = obj[name];
+        ASSERT_EQ(category.type(), Object);
+        ASSERT(category.Obj().hasField("currentBytes"));
+        ASSERT(category.Obj().hasField("peakBytes"));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -188,6 +188,27 @@ public:
      */
     virtual StatusWith<boost::optional<SSLPeerInfo>> parseAndValidatePeerCertificate(
         SSLConnectionType ssl, const std::string& remoteHost) = 0;
+
+    /**
+     * Prepares the outgoing connection "ssl" to resume the TLS session last negotiated with
+     * "remote", if there is one. Providers which don't support resumption leave it alone.
+     */
+    virtual void resumeEgressSession(SSLConnectionType ssl, const std::string& remote) {}
+
+    /**
+     * Remembers the TLS session negotiated on the outgoing connection "ssl" so that later
+     * connections to "remote" can resume it. Returns whether "ssl" itself resumed a session.
+     */
+    virtual bool stashEgressSession(SSLConnectionType ssl, const std::string& remote) {
+        return false;
+    }
+
+    /**
+     * Returns whether the incoming connection "ssl" resumed an earlier TLS session.
+     */
+    virtual bool isResumedSession(SSLConnectionType ssl) {
+        return false;
+    }
 };
 
 // Access SSL functions through this instance.
@@ -36,6 +36,7 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <stack>
 #include <string>
@@ -48,6 +49,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/debug_util.h"
@@ -116,6 +118,15 @@ struct BIOFree {
 };
 using UniqueBIO = std::unique_ptr<BIO, BIOFree>;
 
+struct SSLSessionFree {
+    void operator()(SSL_SESSION* const session) noexcept {
+        if (session) {
+            ::SSL_SESSION_free(session);
+        }
+    }
+};
+using UniqueSSLSession = std::unique_ptr<SSL_SESSION, SSLSessionFree>;
+
 UniqueBIO makeUniqueMemBio(std::vector<std::uint8_t>& v) {
     UniqueBIO rv(::BIO_new_mem_buf(v.data(), v.size()));
     if (!rv) {
@@ -316,6 +327,11 @@ using UniqueSSLContext = std::unique_ptr<SSL_CTX, decltype(&free_ssl_context)>;
 static const int BUFFER_SIZE = 8 * 1024;
 static const int DATE_LEN = 128;
 
+// The most TLS sessions kept for resumption, on either side of a connection.
+static const long kMaxTLSSessions = 20 * 1024;
+// How long a TLS session may be resumed after it was negotiated.
+static const long kTLSSessionTimeoutSecs = 60 * 60;
+
 class SSLManagerOpenSSL : public SSLManagerInterface {
 public:
     explicit SSLManagerOpenSSL(const SSLParams& params, bool isServer);
@@ -348,6 +364,14 @@ public:
 
     int SSL_shutdown(SSLConnectionInterface* conn) final;
 
+    void resumeEgressSession(SSL* ssl, const std::string& remote) final;
+
+    bool stashEgressSession(SSL* ssl, const std::string& remote) final;
+
+    bool isResumedSession(SSL* ssl) final {
+        return ::SSL_session_reused(ssl);
+    }
+
 private:
     const int _rolesNid = OBJ_create(mongodbRolesOID.identifier.c_str(),
                                      mongodbRolesOID.shortDescription.c_str(),
@@ -359,6 +383,10 @@ private:
     bool _allowInvalidHostnames;
     SSLConfiguration _sslConfiguration;
 
+    // The TLS session last negotiated with each remote host, for outgoing connections to resume.
+    stdx::mutex _egressSessionsMutex;
+    std::map<std::string, UniqueSSLSession> _egressSessions;
+
     /**
      * creates an SSL object to be used for this file descriptor.
      * caller must SSL_free it.
@@ -668,6 +696,37 @@ int SSLManagerOpenSSL::SSL_shutdown(SSLConnectionInterface* connInterface) {
     return status;
 }
 
+void SSLManagerOpenSSL::resumeEgressSession(SSL* ssl, const std::string& remote) {
+    stdx::lock_guard<stdx::mutex> lk(_egressSessionsMutex);
+    auto it = _egressSessions.find(remote);
+    if (it != _egressSessions.end()) {
+        // Failing to set the session only costs the resumption, the handshake will be a full one.
+        if (1 != ::SSL_set_session(ssl, it->second.get())) {
+            ERR_clear_error();
+        }
+    }
+}
+
+bool SSLManagerOpenSSL::stashEgressSession(SSL* ssl, const std::string& remote) {
+    const bool resumed = ::SSL_session_reused(ssl);
+    if (resumed) {
+        return true;
+    }
+
+    UniqueSSLSession session(::SSL_get1_session(ssl));
+    if (!session) {
+        return false;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_egressSessionsMutex);
+    if (_egressSessions.size() >= static_cast<size_t>(kMaxTLSSessions) &&
+        !_egressSessions.count(remote)) {
+        _egressSessions.clear();
+    }
+    _egressSessions[remote] = std::move(session);
+    return false;
+}
+
 Status SSLManagerOpenSSL::initSSLContext(SSL_CTX* context,
                                          const SSLParams& params,
                                          ConnectionDirection direction) {
@@ -714,6 +773,17 @@ Status SSLManagerOpenSSL::initSSLContext(SSL_CTX* context,
                                     << getSSLErrorMessage(ERR_get_error()));
     }
 
+    // Let reconnecting peers resume their TLS session, either from the server's session cache or
+    // from a session ticket, rather than run a full handshake. Outgoing connections keep their
+    // sessions in _egressSessions instead, keyed by remote host.
+    if (direction == ConnectionDirection::kIncoming) {
+        ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+        ::SSL_CTX_sess_set_cache_size(context, kMaxTLSSessions);
+    } else {
+        ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_OFF);
+    }
+    ::SSL_CTX_set_timeout(context, kTLSSessionTimeoutSecs);
+
     if (direction == ConnectionDirection::kOutgoing && !params.sslClusterFile.empty()) {
         ::EVP_set_pw_prompt("Enter cluster certificate passphrase");
         if (!_setupPEM(context, params.sslClusterFile, params.sslClusterPassword)) {
@@ -0,0 +1,258 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa_placement.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+#if defined(__linux__)
+const char kSysNodePath[] = "/sys/devices/system/node/";
+
+// MPOL_PREFERRED from <linux/mempolicy.h>: allocate from the given node, falling back to others
+// when it has no free memory.
+const int kMpolPreferred = 1;
+
+std::string readFirstLine(const std::string& path) {
+    std::ifstream f(path);
+    std::string line;
+    std::getline(f, line);
+    return line;
+}
+#endif
+
+/**
+ * Returns the nodes the kernel reports as online. Falls back to a single node with every CPU when
+ * the topology can't be read, or the platform doesn't expose it.
+ */
+std::vector<NumaPlacement::Node> discoverNodes() {
+    std::vector<NumaPlacement::Node> nodes;
+#if defined(__linux__)
+    auto onlineNodes = NumaPlacement::parseCpuList(readFirstLine(str::stream() << kSysNodePath
+                                                                               << "online"));
+    if (onlineNodes.isOK()) {
+        for (int id : onlineNodes.getValue()) {
+            auto cpus = NumaPlacement::parseCpuList(
+                readFirstLine(str::stream() << kSysNodePath << "node" << id << "/cpulist"));
+            // Memory-only nodes have no CPUs for threads to run on.
+            if (cpus.isOK() && !cpus.getValue().empty()) {
+                nodes.push_back({id, std::move(cpus.getValue())});
+            }
+        }
+    }
+#endif
+    if (nodes.empty()) {
+        NumaPlacement::Node node{0, {}};
+        const int numCpus = std::max(1u, stdx::thread::hardware_concurrency());
+        for (int cpu = 0; cpu < numCpus; ++cpu) {
+            node.cpus.push_back(cpu);
+        }
+        nodes.push_back(std::move(node));
+    }
+    return nodes;
+}
+
+/**
+ * The placement of the current thread. Removes the thread from its node's count when it exits.
+ */
+struct ThreadPlacement {
+    ~ThreadPlacement() {
+        if (count) {
+            count->subtractAndFetch(1);
+        }
+    }
+
+    int nodeIndex = -1;
+    bool attempted = false;
+    AtomicWord<long long>* count = nullptr;
+};
+
+thread_local ThreadPlacement threadPlacement;
+
+}  // namespace
+
+NumaPlacement& NumaPlacement::get() {
+    // Intentionally leaked, since threads placed on a node decrement its count as they exit.
+    static NumaPlacement* placement = new NumaPlacement(discoverNodes());
+    return *placement;
+}
+
+StatusWith<std::vector<int>> NumaPlacement::parseCpuList(StringData cpuList) {
+    std::vector<int> cpus;
+    const auto parseNumber = [&](StringData number) -> StatusWith<int> {
+        const auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+        if (number.empty() || number.size() > 9 ||
+            !std::all_of(number.begin(), number.end(), isDigit)) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Invalid number '" << number << "' in CPU list '" << cpuList
+                                  << "'"};
+        }
+        return std::stoi(number.toString());
+    };
+
+    size_t start = 0;
+    while (start < cpuList.size()) {
+        size_t end = cpuList.find(',', start);
+        if (end == std::string::npos) {
+            end = cpuList.size();
+        }
+        const StringData range = cpuList.substr(start, end - start);
+        const size_t dash = range.find('-');
+
+        auto first = parseNumber(range.substr(0, dash));
+        if (!first.isOK()) {
+            return first.getStatus();
+        }
+        auto last = first;
+        if (dash != std::string::npos) {
+            last = parseNumber(range.substr(dash + 1));
+            if (!last.isOK()) {
+                return last.getStatus();
+            }
+            if (last.getValue() < first.getValue()) {
+                return {ErrorCodes::FailedToParse,
+                        str::stream() << "Invalid range '" << range << "' in CPU list '" << cpuList
+                                      << "'"};
+            }
+        }
+        for (int cpu = first.getValue(); cpu <= last.getValue(); ++cpu) {
+            cpus.push_back(cpu);
+        }
+        start = end + 1;
+    }
+    return cpus;
+}
+
+int NumaPlacement::currentNodeIndex() {
+    return threadPlacement.nodeIndex;
+}
+
+NumaPlacement::NumaPlacement(std::vector<Node> nodes)
+    : _nodes(std::move(nodes)), _stats(new NodeStats[_nodes.size()]) {
+    invariant(!_nodes.empty());
+}
+
+size_t NumaPlacement::nextNodeIndex() {
+    return _nextNode.fetchAndAdd(1) % _nodes.size();
+}
+
+int NumaPlacement::placeCurrentThread(ThreadKind kind) {
+    if (!isEnabled() || threadPlacement.attempted) {
+        return threadPlacement.nodeIndex;
+    }
+    threadPlacement.attempted = true;
+
+    const size_t nodeIndex = nextNodeIndex();
+    const Status status = bindCurrentThread(nodeIndex);
+    if (!status.isOK()) {
+        // Only the first failure is logged, since it would usually repeat for every thread.
+        if (_failedPlacements.fetchAndAdd(1) == 0) {
+            warning() << "Failed to place thread on NUMA node " << _nodes[nodeIndex].id << ": "
+                      << status;
+        }
+        return -1;
+    }
+
+    NodeStats& stats = _stats[nodeIndex];
+    stats.totalPlaced.fetchAndAdd(1);
+    stats.current(kind).fetchAndAdd(1);
+    threadPlacement.nodeIndex = static_cast<int>(nodeIndex);
+    threadPlacement.count = &stats.current(kind);
+    return threadPlacement.nodeIndex;
+}
+
+Status NumaPlacement::bindCurrentThread(size_t nodeIndex) const {
+    invariant(nodeIndex < _nodes.size());
+#if defined(__linux__)
+    const Node& node = _nodes[nodeIndex];
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu : node.cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (err) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "pthread_setaffinity_np failed: " << errnoWithDescription(err)};
+    }
+
+    const size_t bitsPerWord = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> nodeMask(node.id / bitsPerWord + 1);
+    nodeMask[node.id / bitsPerWord] = 1UL << (node.id % bitsPerWord);
+    // The kernel ignores the last bit of 'maxnode', so pass one more than the mask holds.
+    const unsigned long maxNode = nodeMask.size() * bitsPerWord + 1;
+    if (syscall(SYS_set_mempolicy, kMpolPreferred, nodeMask.data(), maxNode)) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "set_mempolicy failed: " << errnoWithDescription()};
+    }
+    return Status::OK();
+#else
+    return {ErrorCodes::IllegalOperation,
+            "Placing threads on NUMA nodes is only supported on Linux"};
+#endif
+}
+
+void NumaPlacement::report(BSONObjBuilder* builder) const {
+    builder->append("enabled", isEnabled());
+    builder->append("failedPlacements", _failedPlacements.load());
+    BSONArrayBuilder nodes(builder->subarrayStart("nodes"));
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        BSONObjBuilder node(nodes.subobjStart());
+        node.append("id", _nodes[i].id);
+        node.append("cpus", static_cast<int>(_nodes[i].cpus.size()));
+        node.append("connections", _stats[i].connections.load());
+        node.append("workers", _stats[i].workers.load());
+        node.append("totalPlaced", _stats[i].totalPlaced.load());
+    }
+}
+
+}  // namespace mongo
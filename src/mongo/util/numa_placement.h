@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Places server threads on NUMA nodes. When enabled, each long-lived worker thread is assigned a
+ * node round-robin as it starts, is bound to that node's CPUs, and prefers that node's memory for
+ * the pages it touches first, such as its allocator cache and stack. Disabled by default, in which
+ * case threads float freely and placeCurrentThread() does nothing.
+ *
+ * Only Linux is supported. Elsewhere the machine is treated as a single node and binding fails.
+ */
+class NumaPlacement {
+    MONGO_DISALLOW_COPYING(NumaPlacement);
+
+public:
+    /**
+     * What a placed thread does, for the per-node stats.
+     */
+    enum class ThreadKind {
+        kConnection,  // A thread dedicated to one client connection.
+        kWorker,      // A pool thread, such as a service executor or repl writer worker.
+    };
+
+    struct Node {
+        int id;
+        std::vector<int> cpus;
+    };
+
+    /**
+     * Returns the process-wide instance, built from the machine's topology.
+     */
+    static NumaPlacement& get();
+
+    /**
+     * Parses a kernel CPU list such as "0-3,8,10-11".
+     */
+    static StatusWith<std::vector<int>> parseCpuList(StringData cpuList);
+
+    /**
+     * Returns the index into nodes() of the node the calling thread was placed on, or -1.
+     */
+    static int currentNodeIndex();
+
+    explicit NumaPlacement(std::vector<Node> nodes);
+
+    void setEnabled(bool enabled) {
+        _enabled.store(enabled);
+    }
+
+    bool isEnabled() const {
+        return _enabled.load();
+    }
+
+    const std::vector<Node>& nodes() const {
+        return _nodes;
+    }
+
+    /**
+     * Picks the node for the next thread, round-robin. Returns an index into nodes().
+     */
+    size_t nextNodeIndex();
+
+    /**
+     * If placement is enabled, binds the calling thread to the next node and counts it there until
+     * the thread exits. Failure to bind is logged and counted, and leaves the thread unbound.
+     * Returns the node index the thread was placed on, or -1. Each thread is placed at most once.
+     */
+    int placeCurrentThread(ThreadKind kind);
+
+    /**
+     * Binds the calling thread to the CPUs of the node at 'nodeIndex', and sets its memory policy
+     * to prefer that node.
+     */
+    Status bindCurrentThread(size_t nodeIndex) const;
+
+    /**
+     * Appends whether placement is enabled and, per node, its CPUs and the threads placed on it.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    struct NodeStats {
+        AtomicWord<long long> connections{0};
+        AtomicWord<long long> workers{0};
+        AtomicWord<long long> totalPlaced{0};
+
+        AtomicWord<long long>& current(ThreadKind kind) {
+            return kind == ThreadKind::kConnection ? connections : workers;
+        }
+    };
+
+    const std::vector<Node> _nodes;
+    std::unique_ptr<NodeStats[]> _stats;
+    AtomicWord<bool> _enabled{false};
+    AtomicWord<unsigned long long> _nextNode{0};
+    AtomicWord<long long> _failedPlacements{0};
+};
+
+}  // namespace mongo
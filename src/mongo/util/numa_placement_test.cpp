@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa_placement.h"
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using ThreadKind = NumaPlacement::ThreadKind;
+
+std::vector<int> parse(StringData cpuList) {
+    auto swCpus = NumaPlacement::parseCpuList(cpuList);
+    ASSERT_OK(swCpus.getStatus());
+    return swCpus.getValue();
+}
+
+BSONObj report(const NumaPlacement& placement) {
+    BSONObjBuilder builder;
+    placement.report(&builder);
+    return builder.obj();
+}
+
+TEST(NumaPlacementTest, ParsesCpuLists) {
+    ASSERT(parse("").empty());
+    ASSERT(parse("0") == std::vector<int>({0}));
+    ASSERT(parse("0-3") == std::vector<int>({0, 1, 2, 3}));
+    ASSERT(parse("0-1,8,10-11") == std::vector<int>({0, 1, 8, 10, 11}));
+}
+
+TEST(NumaPlacementTest, RejectsMalformedCpuLists) {
+    for (auto cpuList : {"a", "1-", "-1", "3-1", "1,,2", "1-2-3", "1 "}) {
+        ASSERT_EQ(NumaPlacement::parseCpuList(cpuList).getStatus(), ErrorCodes::FailedToParse)
+            << cpuList;
+    }
+}
+
+TEST(NumaPlacementTest, DiscoversAtLeastOneNodeWithCpus) {
+    const auto& nodes = NumaPlacement::get().nodes();
+    ASSERT_FALSE(nodes.empty());
+    for (const auto& node : nodes) {
+        ASSERT_FALSE(node.cpus.empty());
+    }
+}
+
+TEST(NumaPlacementTest, AssignsNodesRoundRobin) {
+    NumaPlacement placement({{0, {0}}, {1, {1}}, {3, {2}}});
+    ASSERT_EQ(placement.nextNodeIndex(), 0U);
+    ASSERT_EQ(placement.nextNodeIndex(), 1U);
+    ASSERT_EQ(placement.nextNodeIndex(), 2U);
+    ASSERT_EQ(placement.nextNodeIndex(), 0U);
+}
+
+TEST(NumaPlacementTest, DoesNotPlaceThreadsWhenDisabled) {
+    NumaPlacement placement({{0, {0}}});
+    stdx::thread([&] {
+        ASSERT_EQ(placement.placeCurrentThread(ThreadKind::kWorker), -1);
+        ASSERT_EQ(NumaPlacement::currentNodeIndex(), -1);
+    }).join();
+
+    const auto node = report(placement)["nodes"].Array()[0].Obj();
+    ASSERT_EQ(node["totalPlaced"].numberLong(), 0);
+}
+
+#if defined(__linux__)
+TEST(NumaPlacementTest, CountsPlacedThreadsUntilTheyExit) {
+    // Use the machine's first node, which every thread is allowed to run on.
+    NumaPlacement placement({NumaPlacement::get().nodes()[0]});
+    placement.setEnabled(true);
+
+    stdx::thread([&] {
+        ASSERT_EQ(placement.placeCurrentThread(ThreadKind::kConnection), 0);
+        ASSERT_EQ(NumaPlacement::currentNodeIndex(), 0);
+        // A thread is only placed once.
+        ASSERT_EQ(placement.placeCurrentThread(ThreadKind::kWorker), 0);
+
+        const auto node = report(placement)["nodes"].Array()[0].Obj();
+        ASSERT_EQ(node["connections"].numberLong(), 1);
+        ASSERT_EQ(node["workers"].numberLong(), 0);
+    }).join();
+
+    const auto status = report(placement);
+    ASSERT_TRUE(status["enabled"].trueValue());
+    ASSERT_EQ(status["failedPlacements"].numberLong(), 0);
+    const auto node = status["nodes"].Array()[0].Obj();
+    ASSERT_EQ(node["connections"].numberLong(), 0);
+    ASSERT_EQ(node["totalPlaced"].numberLong(), 1);
+}
+#endif
+
+}  // namespace
+}  // namespace mongo
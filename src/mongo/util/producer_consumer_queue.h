@@ -30,15 +30,22 @@
 
 #include <boost/optional.hpp>
 #include <deque>
+#include <limits>
 #include <list>
+#include <memory>
 #include <queue>
 #include <stack>
+#include <type_traits>
 
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/pause.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -93,8 +100,79 @@ constexpr std::true_type areInterruptionArgs() {
     return {};
 }
 
+// Waits on 'condvar' until 'pred' holds, honoring whichever interruption args the caller passed.
+template <typename Callback>
+void waitFor(stdx::unique_lock<stdx::mutex>& lk,
+             stdx::condition_variable& condvar,
+             Callback&& pred,
+             OperationContext* opCtx) {
+    opCtx->waitForConditionOrInterrupt(condvar, lk, pred);
+}
+
+template <typename Callback>
+void waitFor(stdx::unique_lock<stdx::mutex>& lk,
+             stdx::condition_variable& condvar,
+             Callback&& pred) {
+    condvar.wait(lk, pred);
+}
+
+template <typename Callback>
+void waitFor(stdx::unique_lock<stdx::mutex>& lk,
+             stdx::condition_variable& condvar,
+             Callback&& pred,
+             OperationContext* opCtx,
+             Date_t deadline) {
+    uassert(ErrorCodes::ExceededTimeLimit,
+            "exceeded timeout",
+            opCtx->waitForConditionOrInterruptUntil(condvar, lk, deadline, pred));
+}
+
+template <typename Callback>
+void waitFor(stdx::unique_lock<stdx::mutex>& lk,
+             stdx::condition_variable& condvar,
+             Callback&& pred,
+             Date_t deadline) {
+    uassert(ErrorCodes::ExceededTimeLimit,
+            "exceeded timeout",
+            condvar.wait_until(lk, deadline.toSystemTimePoint(), pred));
+}
+
+template <typename Callback>
+void waitFor(stdx::unique_lock<stdx::mutex>& lk,
+             stdx::condition_variable& condvar,
+             Callback&& pred,
+             OperationContext* opCtx,
+             Milliseconds duration) {
+    uassert(ErrorCodes::ExceededTimeLimit,
+            "exceeded timeout",
+            opCtx->waitForConditionOrInterruptFor(condvar, lk, duration, pred));
+}
+
+template <typename Callback>
+void waitFor(stdx::unique_lock<stdx::mutex>& lk,
+             stdx::condition_variable& condvar,
+             Callback&& pred,
+             Milliseconds duration) {
+    uassert(ErrorCodes::ExceededTimeLimit,
+            "exceeded timeout",
+            condvar.wait_for(lk, duration.toSystemDuration(), pred));
+}
+
 }  // namespace producer_consumer_queue_detail
 
+/**
+ * Selects how a ProducerConsumerQueue synchronizes its callers.
+ */
+enum class ProducerConsumerQueueMode {
+    // A std::queue guarded by a mutex. Every push and pop takes the mutex.
+    kMutex,
+
+    // A ring buffer whose pushes and pops are lock free. Callers that must block spin briefly and
+    // then park on a condition variable. The ring's slot count bounds the number of items in
+    // addition to the cost, and any number of threads may push.
+    kLockFree,
+};
+
 /**
  * A bounded, blocking, thread safe, cost parametrizable, single producer, multi-consumer queue.
  *
@@ -134,8 +212,14 @@ constexpr std::true_type areInterruptionArgs() {
  *   the cost function is to express the kind of bounds the queue provides, rather than to
  *   specialize behavior for a type. I.e. you should not specialize the default cost function and
  *   the cost function should always be explicit in the type.
+ *
+ * Mode:
+ *   ProducerConsumerQueueMode::kMutex, the default, is described above. kLockFree trades the
+ *   unbounded item count for lock free pushes and pops. See the specialization below.
  */
-template <typename T, typename CostFunc = producer_consumer_queue_detail::DefaultCostFunction>
+template <typename T,
+          typename CostFunc = producer_consumer_queue_detail::DefaultCostFunction,
+          ProducerConsumerQueueMode mode = ProducerConsumerQueueMode::kMutex>
 class ProducerConsumerQueue {
 
 public:
@@ -458,13 +542,14 @@ private:
         _producerWants = cost;
         const auto guard = MakeGuard([&] { _producerWants = 0; });
 
-        _waitFor(lk,
-                 _condvarProducer,
-                 [&] {
-                     _checkProducerClosed(lk);
-                     return _current + cost <= _max;
-                 },
-                 std::forward<InterruptionArgs>(interruptionArgs)...);
+        producer_consumer_queue_detail::waitFor(
+            lk,
+            _condvarProducer,
+            [&] {
+                _checkProducerClosed(lk);
+                return _current + cost <= _max;
+            },
+            std::forward<InterruptionArgs>(interruptionArgs)...);
     }
 
     template <typename... InterruptionArgs>
@@ -474,75 +559,491 @@ private:
         _consumers++;
         const auto guard = MakeGuard([&] { _consumers--; });
 
-        _waitFor(lk,
-                 _condvarConsumer,
-                 [&] {
-                     _checkConsumerClosed(lk);
-                     return _queue.size();
-                 },
-                 std::forward<InterruptionArgs>(interruptionArgs)...);
+        producer_consumer_queue_detail::waitFor(
+            lk,
+            _condvarConsumer,
+            [&] {
+                _checkConsumerClosed(lk);
+                return _queue.size();
+            },
+            std::forward<InterruptionArgs>(interruptionArgs)...);
     }
 
-    template <typename Callback>
-    void _waitFor(stdx::unique_lock<stdx::mutex>& lk,
-                  stdx::condition_variable& condvar,
-                  Callback&& pred,
-                  OperationContext* opCtx) {
-        opCtx->waitForConditionOrInterrupt(condvar, lk, pred);
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _condvarConsumer;
+    stdx::condition_variable _condvarProducer;
+
+    // Max size of the queue
+    const size_t _max;
+
+    // User's cost function
+    CostFunc _costFunc;
+
+    // Current size of the queue
+    size_t _current = 0;
+
+    std::queue<T> _queue;
+
+    // Counter for consumers in the queue
+    size_t _consumers = 0;
+
+    // Size of batch the blocking producer wants to insert
+    size_t _producerWants = 0;
+
+    // Flags that we're shutting down the queue
+    bool _consumerEndClosed = false;
+    bool _producerEndClosed = false;
+};
+
+/**
+ * The lock free mode of ProducerConsumerQueue. It offers the interface and semantics described
+ * above, with these differences:
+ *
+ *   multi-producer - Any number of threads may push. Each batch passed to pushMany is admitted as a
+ *                    whole, but consumers may see it before all of it has been pushed, and batches
+ *                    from different producers may interleave.
+ *   item bound - Items live in a ring of at least 'maxItems' slots, which bounds their number
+ *                whatever their cost. A batch with more items than the ring has slots is rejected
+ *                with ErrorCodes::ProducerConsumerQueueBatchTooLarge.
+ *   blocking - Pushes and pops are lock free while the queue is neither full nor empty. Otherwise
+ *              the caller spins for a short while, then parks until another thread makes progress.
+ *
+ * The cost function may be called concurrently from several threads, and T's move constructor must
+ * not throw.
+ *
+ * The ring follows Vyukov's bounded MPMC queue. Each slot has a sequence number which says whether
+ * it is free for the push at its position or holds the item for the pop at its position. The cost
+ * and item counts are reserved before a push claims a position, so a push never fails after that;
+ * at worst it waits for the consumer of its slot's previous occupant to finish moving it out.
+ */
+template <typename T, typename CostFunc>
+class ProducerConsumerQueue<T, CostFunc, ProducerConsumerQueueMode::kLockFree> {
+
+public:
+    // The default minimum number of slots in the ring
+    static constexpr size_t kDefaultMaxItems = 1024;
+
+    ProducerConsumerQueue()
+        : ProducerConsumerQueue(std::numeric_limits<size_t>::max(), CostFunc{}) {}
+
+    explicit ProducerConsumerQueue(size_t size) : ProducerConsumerQueue(size, CostFunc{}) {}
+
+    explicit ProducerConsumerQueue(size_t size,
+                                   CostFunc costFunc,
+                                   size_t maxItems = kDefaultMaxItems)
+        : _max(size),
+          _costFunc(std::move(costFunc)),
+          _capacity(_ringCapacity(size, maxItems)),
+          _slots(new Slot[_capacity]) {
+        for (size_t i = 0; i < _capacity; ++i) {
+            _slots[i].sequence.store(i);
+        }
     }
 
-    template <typename Callback>
-    void _waitFor(stdx::unique_lock<stdx::mutex>& lk,
-                  stdx::condition_variable& condvar,
-                  Callback&& pred) {
-        condvar.wait(lk, pred);
+    ProducerConsumerQueue(const ProducerConsumerQueue&) = delete;
+    ProducerConsumerQueue& operator=(const ProducerConsumerQueue&) = delete;
+
+    ProducerConsumerQueue(ProducerConsumerQueue&&) = delete;
+    ProducerConsumerQueue& operator=(ProducerConsumerQueue&&) = delete;
+
+    ~ProducerConsumerQueue() {
+        invariant(!_activeProducers.load());
+        invariant(!_parkedProducers.load());
+        invariant(!_parkedConsumers.load());
+
+        while (_tryPop()) {
+        }
     }
 
-    template <typename Callback>
-    void _waitFor(stdx::unique_lock<stdx::mutex>& lk,
-                  stdx::condition_variable& condvar,
-                  Callback&& pred,
-                  OperationContext* opCtx,
-                  Date_t deadline) {
-        uassert(ErrorCodes::ExceededTimeLimit,
-                "exceeded timeout",
-                opCtx->waitForConditionOrInterruptUntil(condvar, lk, deadline, pred));
+    template <
+        typename... InterruptionArgs,
+        typename = std::enable_if_t<decltype(producer_consumer_queue_detail::areInterruptionArgs(
+            std::declval<InterruptionArgs>()...))::value>>
+    void push(T&& t, InterruptionArgs&&... interruptionArgs) {
+        _pushRunner([&] {
+            const auto cost = _invokeCostFunc(t);
+            uassert(ErrorCodes::ProducerConsumerQueueBatchTooLarge,
+                    str::stream() << "cost of item (" << cost
+                                  << ") larger than maximum queue size ("
+                                  << _max
+                                  << ")",
+                    cost <= _max);
+
+            _waitForSpace(cost, 1, std::forward<InterruptionArgs>(interruptionArgs)...);
+            _push(std::move(t));
+            _notifyConsumers();
+        });
     }
 
-    template <typename Callback>
-    void _waitFor(stdx::unique_lock<stdx::mutex>& lk,
-                  stdx::condition_variable& condvar,
-                  Callback&& pred,
-                  Date_t deadline) {
-        uassert(ErrorCodes::ExceededTimeLimit,
-                "exceeded timeout",
-                condvar.wait_until(lk, deadline.toSystemTimePoint(), pred));
+    template <
+        typename StartIterator,
+        typename EndIterator,
+        typename... InterruptionArgs,
+        typename = std::enable_if_t<decltype(producer_consumer_queue_detail::areInterruptionArgs(
+            std::declval<InterruptionArgs>()...))::value>>
+    void pushMany(StartIterator start, EndIterator last, InterruptionArgs&&... interruptionArgs) {
+        _pushRunner([&] {
+            size_t cost = 0;
+            size_t count = 0;
+            for (auto iter = start; iter != last; ++iter) {
+                cost += _invokeCostFunc(*iter);
+                ++count;
+            }
+
+            uassert(ErrorCodes::ProducerConsumerQueueBatchTooLarge,
+                    str::stream() << "cost of items in batch (" << cost
+                                  << ") larger than maximum queue size ("
+                                  << _max
+                                  << ")",
+                    cost <= _max);
+            uassert(ErrorCodes::ProducerConsumerQueueBatchTooLarge,
+                    str::stream() << "number of items in batch (" << count
+                                  << ") larger than queue capacity ("
+                                  << _capacity
+                                  << ")",
+                    count <= _capacity);
+
+            if (!count) {
+                return;
+            }
+
+            _waitForSpace(cost, count, std::forward<InterruptionArgs>(interruptionArgs)...);
+
+            for (auto iter = start; iter != last; ++iter) {
+                _push(std::move(*iter));
+            }
+            _notifyConsumers();
+        });
     }
 
-    template <typename Callback>
-    void _waitFor(stdx::unique_lock<stdx::mutex>& lk,
-                  stdx::condition_variable& condvar,
-                  Callback&& pred,
-                  OperationContext* opCtx,
-                  Milliseconds duration) {
-        uassert(ErrorCodes::ExceededTimeLimit,
-                "exceeded timeout",
-                opCtx->waitForConditionOrInterruptFor(condvar, lk, duration, pred));
+    bool tryPush(T&& t) {
+        return _pushRunner([&] {
+            if (!_tryReserve(_invokeCostFunc(t), 1, nullptr)) {
+                return false;
+            }
+
+            _push(std::move(t));
+            _notifyConsumers();
+            return true;
+        });
+    }
+
+    template <
+        typename... InterruptionArgs,
+        typename = std::enable_if_t<decltype(producer_consumer_queue_detail::areInterruptionArgs(
+            std::declval<InterruptionArgs>()...))::value>>
+    T pop(InterruptionArgs&&... interruptionArgs) {
+        _checkConsumerClosed();
+
+        return std::move(*_waitForItem(std::forward<InterruptionArgs>(interruptionArgs)...));
+    }
+
+    template <
+        typename OutputIterator,
+        typename... InterruptionArgs,
+        typename = std::enable_if_t<decltype(producer_consumer_queue_detail::areInterruptionArgs(
+            std::declval<InterruptionArgs>()...))::value>>
+    std::pair<size_t, OutputIterator> popMany(OutputIterator iterator,
+                                              InterruptionArgs&&... interruptionArgs) {
+        return popManyUpTo(_max, iterator, std::forward<InterruptionArgs>(interruptionArgs)...);
+    }
+
+    template <
+        typename OutputIterator,
+        typename... InterruptionArgs,
+        typename = std::enable_if_t<decltype(producer_consumer_queue_detail::areInterruptionArgs(
+            std::declval<InterruptionArgs>()...))::value>>
+    std::pair<size_t, OutputIterator> popManyUpTo(size_t budget,
+                                                  OutputIterator iterator,
+                                                  InterruptionArgs&&... interruptionArgs) {
+        _checkConsumerClosed();
+
+        auto out = _waitForItem(std::forward<InterruptionArgs>(interruptionArgs)...);
+
+        size_t cost = 0;
+        do {
+            cost += _invokeCostFunc(*out);
+            *iterator = std::move(*out);
+            ++iterator;
+        } while (cost < budget && (out = _tryPop()));
+
+        return std::make_pair(cost, iterator);
+    }
+
+    boost::optional<T> tryPop() {
+        _checkConsumerClosed();
+
+        return _tryPop();
+    }
+
+    void closeProducerEnd() {
+        _producerEndClosed.store(true);
+
+        _notifyAll();
+    }
+
+    void closeConsumerEnd() {
+        _consumerEndClosed.store(true);
+        _producerEndClosed.store(true);
+
+        _notifyAll();
+    }
+
+    // TEST ONLY FUNCTIONS
+
+    size_t sizeForTest() const {
+        return _current.load();
+    }
+
+    bool emptyForTest() const {
+        return sizeForTest() == 0;
+    }
+
+private:
+    // How many times a blocked caller retries before parking
+    static constexpr int kSpinsBeforePark = 64;
+
+    struct Slot {
+        T* item() {
+            return reinterpret_cast<T*>(&storage);
+        }
+
+        // Equal to the slot's position when it is free for a push, and one more than that when it
+        // holds the item for the pop at that position. Popping advances it by the ring's capacity.
+        AtomicWord<unsigned long long> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static size_t _ringCapacity(size_t maxCost, size_t maxItems) {
+        // Every item costs at least one, so there is no point in more slots than the maximum cost.
+        const size_t wanted = std::max<size_t>(std::min(maxCost, maxItems), 1);
+
+        size_t capacity = 1;
+        while (capacity < wanted) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    // Adds 'amount' to 'counter' if that keeps it within 'limit'
+    static bool _tryAdd(AtomicWord<size_t>* counter, size_t amount, size_t limit) {
+        auto current = counter->load();
+        while (amount <= limit - current) {
+            const auto previous = counter->compareAndSwap(current, current + amount);
+            if (previous == current) {
+                return true;
+            }
+            current = previous;
+        }
+        return false;
+    }
+
+    size_t _invokeCostFunc(const T& t) const {
+        auto cost = _costFunc(t);
+        invariant(cost);
+        return cost;
+    }
+
+    void _checkProducerClosed() const {
+        uassert(ErrorCodes::ProducerConsumerQueueEndClosed,
+                "Producer end closed",
+                !_producerEndClosed.load());
+        uassert(ErrorCodes::ProducerConsumerQueueEndClosed,
+                "Consumer end closed",
+                !_consumerEndClosed.load());
+    }
+
+    void _checkConsumerClosed() const {
+        uassert(ErrorCodes::ProducerConsumerQueueEndClosed,
+                "Consumer end closed",
+                !_consumerEndClosed.load());
+
+        // A producer that got past its closed check before the producer end closed may still be
+        // pushing, so the queue is only exhausted once no producer is active. Producers register
+        // before checking, so one that is not yet counted here will see the close and give up.
+        uassert(ErrorCodes::ProducerConsumerQueueEndClosed,
+                "Producer end closed and values exhausted",
+                !(_producerEndClosed.load() && !_activeProducers.load() && !_items.load()));
     }
 
     template <typename Callback>
-    void _waitFor(stdx::unique_lock<stdx::mutex>& lk,
+    auto _pushRunner(Callback&& cb) {
+        _activeProducers.fetchAndAdd(1);
+        const auto guard = MakeGuard([&] {
+            // The last producer out after the producer end closed may leave consumers that are
+            // waiting for an item that will never come.
+            if (_activeProducers.subtractAndFetch(1) == 0 && _producerEndClosed.load()) {
+                _notifyAll();
+            }
+        });
+
+        _checkProducerClosed();
+
+        return cb();
+    }
+
+    // Reserves room for 'count' items totalling 'cost', which a push then cannot fail to use.
+    // 'heldLock' is the caller's lock on _mutex, if it holds one.
+    bool _tryReserve(size_t cost, size_t count, stdx::unique_lock<stdx::mutex>* heldLock) {
+        if (!_tryAdd(&_items, count, _capacity)) {
+            return false;
+        }
+
+        if (!_tryAdd(&_current, cost, _max)) {
+            _items.fetchAndSubtract(count);
+            _notify(_parkedProducers, _condvarProducer, heldLock);
+            return false;
+        }
+
+        return true;
+    }
+
+    // Pushes into a slot the caller has already reserved room for
+    void _push(T&& t) {
+        const auto position = _pushPosition.fetchAndAdd(1);
+        auto& slot = _slots[position & (_capacity - 1)];
+
+        // The reservation means every earlier occupant of the slot has been claimed by a consumer,
+        // but the last one may still be moving its item out.
+        for (int spins = 0; slot.sequence.load() != position; ++spins) {
+            if (spins < kSpinsBeforePark) {
+                MONGO_YIELD_CORE_FOR_SMT();
+            } else {
+                stdx::this_thread::yield();
+            }
+        }
+
+        new (slot.item()) T(std::move(t));
+        slot.sequence.store(position + 1);
+    }
+
+    // 'heldLock' is the caller's lock on _mutex, if it holds one
+    boost::optional<T> _tryPop(stdx::unique_lock<stdx::mutex>* heldLock = nullptr) {
+        boost::optional<T> out;
+
+        auto position = _popPosition.load();
+        for (;;) {
+            auto& slot = _slots[position & (_capacity - 1)];
+            const auto sequence = slot.sequence.load();
+
+            if (sequence == position + 1) {
+                const auto previous = _popPosition.compareAndSwap(position, position + 1);
+                if (previous != position) {
+                    position = previous;
+                    continue;
+                }
+
+                out.emplace(std::move(*slot.item()));
+                slot.item()->~T();
+                slot.sequence.store(position + _capacity);
+                break;
+            }
+
+            if (sequence <= position) {
+                // Empty, or the push at this position has not finished writing its item
+                return out;
+            }
+
+            // Another consumer took this position, so try the next
+            position = _popPosition.load();
+        }
+
+        _current.fetchAndSubtract(_invokeCostFunc(*out));
+        _items.fetchAndSubtract(1);
+        _notify(_parkedProducers, _condvarProducer, heldLock);
+
+        // The last item out of a closed queue leaves waiting consumers with nothing to wait for
+        if (_producerEndClosed.load()) {
+            _notify(_parkedConsumers, _condvarConsumer, heldLock);
+        }
+
+        return out;
+    }
+
+    template <typename... InterruptionArgs>
+    void _waitForSpace(size_t cost, size_t count, InterruptionArgs&&... interruptionArgs) {
+        _waitFor(_parkedProducers,
+                 _condvarProducer,
+                 [&](stdx::unique_lock<stdx::mutex>* heldLock) {
+                     _checkProducerClosed();
+                     return _tryReserve(cost, count, heldLock);
+                 },
+                 std::forward<InterruptionArgs>(interruptionArgs)...);
+    }
+
+    template <typename... InterruptionArgs>
+    boost::optional<T> _waitForItem(InterruptionArgs&&... interruptionArgs) {
+        boost::optional<T> out;
+
+        _waitFor(_parkedConsumers,
+                 _condvarConsumer,
+                 [&](stdx::unique_lock<stdx::mutex>* heldLock) {
+                     _checkConsumerClosed();
+                     out = _tryPop(heldLock);
+                     return bool(out);
+                 },
+                 std::forward<InterruptionArgs>(interruptionArgs)...);
+
+        return out;
+    }
+
+    // Retries 'pred' for a while, then parks until it holds. 'pred' is passed the lock on _mutex
+    // once parking, so that any notifications it makes don't take the mutex again.
+    //
+    // Whoever changes the state 'pred' depends on checks 'parked' afterwards and notifies under the
+    // mutex, so a waiter either sees the change when it checks 'pred' under the mutex, or is
+    // already waiting when notified.
+    template <typename Callback, typename... InterruptionArgs>
+    void _waitFor(AtomicWord<size_t>& parked,
                   stdx::condition_variable& condvar,
                   Callback&& pred,
-                  Milliseconds duration) {
-        uassert(ErrorCodes::ExceededTimeLimit,
-                "exceeded timeout",
-                condvar.wait_for(lk, duration.toSystemDuration(), pred));
+                  InterruptionArgs&&... interruptionArgs) {
+        for (int spins = 0; spins < kSpinsBeforePark; ++spins) {
+            if (pred(nullptr)) {
+                return;
+            }
+            MONGO_YIELD_CORE_FOR_SMT();
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+        parked.fetchAndAdd(1);
+        const auto guard = MakeGuard([&] { parked.fetchAndSubtract(1); });
+
+        producer_consumer_queue_detail::waitFor(
+            lk,
+            condvar,
+            [&] { return pred(&lk); },
+            std::forward<InterruptionArgs>(interruptionArgs)...);
     }
 
-    mutable stdx::mutex _mutex;
-    stdx::condition_variable _condvarConsumer;
-    stdx::condition_variable _condvarProducer;
+    // Wakes the threads parked on 'condvar', if any. 'heldLock' is the caller's lock on _mutex, if
+    // it holds one.
+    void _notify(AtomicWord<size_t>& parked,
+                 stdx::condition_variable& condvar,
+                 stdx::unique_lock<stdx::mutex>* heldLock) {
+        if (!parked.load()) {
+            return;
+        }
+
+        if (heldLock) {
+            condvar.notify_all();
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        condvar.notify_all();
+    }
+
+    void _notifyConsumers() {
+        _notify(_parkedConsumers, _condvarConsumer, nullptr);
+    }
+
+    void _notifyAll() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _condvarProducer.notify_all();
+        _condvarConsumer.notify_all();
+    }
 
     // Max size of the queue
     const size_t _max;
@@ -550,20 +1051,40 @@ private:
     // User's cost function
     CostFunc _costFunc;
 
-    // Current size of the queue
-    size_t _current = 0;
+    // Number of slots in the ring, a power of two
+    const size_t _capacity;
+    const std::unique_ptr<Slot[]> _slots;
 
-    std::queue<T> _queue;
+    // The positions of the next push and pop. Each is contended only among its own side.
+    CacheAligned<AtomicWord<unsigned long long>> _pushPosition;
+    CacheAligned<AtomicWord<unsigned long long>> _popPosition;
 
-    // Counter for consumers in the queue
-    size_t _consumers = 0;
+    // Cost and number of the items in the ring, counting pushes from when they reserve room and
+    // pops until they have moved their item out
+    CacheAligned<AtomicWord<size_t>> _current;
+    AtomicWord<size_t> _items;
 
-    // Size of batch the blocking producer wants to insert
-    size_t _producerWants = 0;
+    // Number of threads inside a push, and threads parked waiting to push or pop
+    AtomicWord<size_t> _activeProducers;
+    AtomicWord<size_t> _parkedProducers;
+    AtomicWord<size_t> _parkedConsumers;
 
     // Flags that we're shutting down the queue
-    bool _consumerEndClosed = false;
-    bool _producerEndClosed = false;
+    AtomicWord<bool> _consumerEndClosed;
+    AtomicWord<bool> _producerEndClosed;
+
+    // Only taken to park and to wake parked threads
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvarConsumer;
+    stdx::condition_variable _condvarProducer;
 };
 
+template <typename T, typename CostFunc>
+constexpr size_t
+    ProducerConsumerQueue<T, CostFunc, ProducerConsumerQueueMode::kLockFree>::kDefaultMaxItems;
+
+template <typename T, typename CostFunc>
+constexpr int
+    ProducerConsumerQueue<T, CostFunc, ProducerConsumerQueueMode::kLockFree>::kSpinsBeforePark;
+
 }  // namespace mongo
@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <limits>
+#include <vector>
+
+#include "mongo/util/producer_consumer_queue.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 128;
+
+// Every benchmark thread runs the same number of iterations, so with an even number of threads the
+// producers push exactly as many items as the consumers pop. A single thread does both.
+template <typename T, ProducerConsumerQueueMode mode>
+using Queue = ProducerConsumerQueue<T, producer_consumer_queue_detail::DefaultCostFunction, mode>;
+
+template <ProducerConsumerQueueMode mode, size_t kMaxQueueDepth>
+void BM_PushPop(benchmark::State& state) {
+    static Queue<int, mode> queue(kMaxQueueDepth);
+
+    const bool single = state.threads == 1;
+    const bool producer = state.thread_index % 2 == 0;
+    for (auto keepRunning : state) {
+        if (single || producer) {
+            queue.push(1);
+        }
+        if (single || !producer) {
+            benchmark::DoNotOptimize(queue.pop());
+        }
+    }
+}
+
+// The lock free queue is never unbounded, but its default ring of 1024 slots rarely fills here.
+template <ProducerConsumerQueueMode mode>
+void BM_PushPopUnbounded(benchmark::State& state) {
+    BM_PushPop<mode, std::numeric_limits<size_t>::max()>(state);
+}
+
+// A small queue makes producers block on a full queue as well as consumers on an empty one.
+template <ProducerConsumerQueueMode mode>
+void BM_PushPopBounded(benchmark::State& state) {
+    BM_PushPop<mode, 16>(state);
+}
+
+template <ProducerConsumerQueueMode mode>
+void BM_PushManyPopMany(benchmark::State& state) {
+    static Queue<int, mode> queue;
+    const int kBatchSize = 64;
+
+    const bool single = state.threads == 1;
+    const bool producer = state.thread_index % 2 == 0;
+    std::vector<int> batch(kBatchSize, 1);
+    std::vector<int> out(kBatchSize);
+    for (auto keepRunning : state) {
+        if (single || producer) {
+            queue.pushMany(batch.begin(), batch.end());
+        }
+        if (single || !producer) {
+            // Never take more than one batch, so that no consumer starves the others for good.
+            benchmark::DoNotOptimize(queue.popManyUpTo(kBatchSize, out.begin()));
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_PushPopUnbounded, ProducerConsumerQueueMode::kMutex)
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_TEMPLATE(BM_PushPopUnbounded, ProducerConsumerQueueMode::kLockFree)
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_TEMPLATE(BM_PushPopBounded, ProducerConsumerQueueMode::kMutex)
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_TEMPLATE(BM_PushPopBounded, ProducerConsumerQueueMode::kLockFree)
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_TEMPLATE(BM_PushManyPopMany, ProducerConsumerQueueMode::kMutex)
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_TEMPLATE(BM_PushManyPopMany, ProducerConsumerQueueMode::kLockFree)
+    ->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,7 @@
 #include "mongo/util/producer_consumer_queue.h"
 
 #include "mongo/db/service_context_noop.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
@@ -701,6 +702,178 @@ TEST_F(ProducerConsumerQueueTest, tryPushWithSpecialStatefulCost) {
     ASSERT_TRUE(pcq.emptyForTest());
 }
 
+template <typename T, typename CostFunc = producer_consumer_queue_detail::DefaultCostFunction>
+using LockFreeProducerConsumerQueue =
+    ProducerConsumerQueue<T, CostFunc, ProducerConsumerQueueMode::kLockFree>;
+
+TEST_F(ProducerConsumerQueueTest, lockFreeMultipleStepPushPopWithBlocking) {
+    runPermutations([](auto helper) {
+        LockFreeProducerConsumerQueue<MoveOnly> pcq{1};
+
+        auto consumer = helper.runThread("Consumer", [&](auto... interruptionArgs) {
+            for (int i = 0; i < 10; ++i) {
+                ASSERT_EQUALS(pcq.pop(interruptionArgs...), MoveOnly(i));
+            }
+        });
+
+        auto producer = helper.runThread("Producer", [&](auto... interruptionArgs) {
+            for (int i = 0; i < 10; ++i) {
+                pcq.push(MoveOnly(i), interruptionArgs...);
+            }
+        });
+
+        consumer.join();
+        producer.join();
+
+        ASSERT_TRUE(pcq.emptyForTest());
+    });
+}
+
+TEST_F(ProducerConsumerQueueTest, lockFreeCloseProducerEnd) {
+    runPermutations([](auto helper) {
+        LockFreeProducerConsumerQueue<MoveOnly> pcq{};
+
+        auto consumer = helper.runThread("Consumer", [&](auto... interruptionArgs) {
+            ASSERT_EQUALS(pcq.pop(interruptionArgs...), MoveOnly(1));
+            ASSERT_THROWS_CODE(pcq.pop(interruptionArgs...),
+                               DBException,
+                               ErrorCodes::ProducerConsumerQueueEndClosed);
+        });
+
+        pcq.push(MoveOnly(1));
+        pcq.closeProducerEnd();
+
+        consumer.join();
+
+        ASSERT_THROWS_CODE(
+            pcq.push(MoveOnly(2)), DBException, ErrorCodes::ProducerConsumerQueueEndClosed);
+    });
+}
+
+TEST_F(ProducerConsumerQueueTest, lockFreeCloseConsumerEnd) {
+    runPermutations([](auto helper) {
+        LockFreeProducerConsumerQueue<MoveOnly> pcq{1};
+
+        pcq.push(MoveOnly(1));
+
+        auto producer = helper.runThread("Producer", [&](auto... interruptionArgs) {
+            ASSERT_THROWS_CODE(pcq.push(MoveOnly(2), interruptionArgs...),
+                               DBException,
+                               ErrorCodes::ProducerConsumerQueueEndClosed);
+        });
+
+        pcq.closeConsumerEnd();
+
+        ASSERT_THROWS_CODE(pcq.pop(), DBException, ErrorCodes::ProducerConsumerQueueEndClosed);
+
+        producer.join();
+    });
+}
+
+TEST_F(ProducerConsumerQueueTest, lockFreeTimeouts) {
+    runTimeoutPermutations([](auto helper) {
+        LockFreeProducerConsumerQueue<MoveOnly, MoveOnly::CostFunc> pcq{3};
+
+        helper
+            .runThread("Consumer",
+                       [&](auto... interruptionArgs) {
+                           std::vector<MoveOnly> vec;
+                           ASSERT_THROWS_CODE(
+                               pcq.popManyUpTo(10, std::back_inserter(vec), interruptionArgs...),
+                               DBException,
+                               ErrorCodes::ExceededTimeLimit);
+                       })
+            .join();
+
+        pcq.push(MoveOnly(2));
+
+        helper
+            .runThread("Producer",
+                       [&](auto... interruptionArgs) {
+                           MoveOnly mo(2);
+                           ASSERT_THROWS_CODE(pcq.push(std::move(mo), interruptionArgs...),
+                                              DBException,
+                                              ErrorCodes::ExceededTimeLimit);
+                           ASSERT_EQUALS(mo, MoveOnly(2));
+                       })
+            .join();
+
+        ASSERT_EQUALS(pcq.sizeForTest(), 2ul);
+    });
+}
+
+TEST_F(ProducerConsumerQueueTest, lockFreeItemCountIsBounded) {
+    LockFreeProducerConsumerQueue<MoveOnly, MoveOnly::CostFunc> pcq{100, MoveOnly::CostFunc(), 2};
+
+    ASSERT_TRUE(pcq.tryPush(MoveOnly(1)));
+    ASSERT_TRUE(pcq.tryPush(MoveOnly(1)));
+    ASSERT_FALSE(pcq.tryPush(MoveOnly(1)));
+
+    std::vector<MoveOnly> vec;
+    vec.push_back(MoveOnly(1));
+    vec.push_back(MoveOnly(1));
+    vec.push_back(MoveOnly(1));
+    ASSERT_THROWS_CODE(pcq.pushMany(begin(vec), end(vec)),
+                       DBException,
+                       ErrorCodes::ProducerConsumerQueueBatchTooLarge);
+
+    std::vector<MoveOnly> out;
+    ASSERT_EQUALS(pcq.popMany(std::back_inserter(out)).first, 2ul);
+    ASSERT_TRUE(pcq.emptyForTest());
+}
+
+TEST_F(ProducerConsumerQueueTest, lockFreeMultiProducerMultiConsumer) {
+    LockFreeProducerConsumerQueue<int> pcq{16};
+
+    const int kProducers = 4;
+    const int kConsumers = 4;
+    const int kItemsPerProducer = 10000;
+
+    std::vector<stdx::thread> producers;
+    for (int i = 0; i < kProducers; ++i) {
+        producers.emplace_back([&] {
+            for (int j = 0; j < kItemsPerProducer; j += 2) {
+                if (j % 10 == 0) {
+                    std::vector<int> batch{1, 1};
+                    pcq.pushMany(batch.begin(), batch.end());
+                } else {
+                    pcq.push(1);
+                    pcq.push(1);
+                }
+            }
+        });
+    }
+
+    AtomicWord<long long> popped{0};
+    std::vector<stdx::thread> consumers;
+    for (int i = 0; i < kConsumers; ++i) {
+        consumers.emplace_back([&, i] {
+            try {
+                while (true) {
+                    if (i % 2) {
+                        std::vector<int> out;
+                        popped.fetchAndAdd(pcq.popManyUpTo(4, std::back_inserter(out)).first);
+                    } else {
+                        popped.fetchAndAdd(pcq.pop());
+                    }
+                }
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+            }
+        });
+    }
+
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    pcq.closeProducerEnd();
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    ASSERT_EQUALS(popped.load(), kProducers * kItemsPerProducer);
+    ASSERT_TRUE(pcq.emptyForTest());
+}
+
 }  // namespace
 
 }  // namespace mongo
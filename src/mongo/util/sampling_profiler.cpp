@@ -0,0 +1,280 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+namespace mongo {
+
+namespace {
+
+// The tag recorded with samples of this thread. Read by the signal handler, so it must stay a
+// trivially constructible thread local.
+thread_local const char* threadTag = nullptr;
+
+}  // namespace
+
+SamplingProfiler::TagGuard::TagGuard(const char* tag) : _previousTag(threadTag) {
+    threadTag = tag;
+}
+
+SamplingProfiler::TagGuard::~TagGuard() {
+    threadTag = _previousTag;
+}
+
+void SamplingProfiler::Profile::append(BSONObjBuilder* builder, int maxBytes) const {
+    builder->append("samples", samples);
+    builder->append("droppedSamples", droppedSamples);
+
+    std::vector<std::pair<long long, const std::string*>> stacksByCount;
+    stacksByCount.reserve(stacks.size());
+    for (const auto& stackAndCount : stacks) {
+        stacksByCount.emplace_back(stackAndCount.second, &stackAndCount.first);
+    }
+    std::sort(stacksByCount.begin(), stacksByCount.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    bool truncated = false;
+    {
+        BSONArrayBuilder stacksBuilder(builder->subarrayStart("stacks"));
+        for (const auto& countAndStack : stacksByCount) {
+            std::string line = str::stream() << *countAndStack.second << ' ' << countAndStack.first;
+            // Leave room for the element's type byte, index and terminator.
+            if (stacksBuilder.len() + static_cast<int>(line.size()) + 16 > maxBytes) {
+                truncated = true;
+                break;
+            }
+            stacksBuilder.append(line);
+        }
+    }
+
+    if (truncated) {
+        builder->append("truncated", true);
+    }
+}
+
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+
+namespace {
+
+struct Sample {
+    AtomicBool complete;
+    const char* tag;
+    int numFrames;
+    void* frames[SamplingProfiler::kMaxFrames];
+};
+
+// Allocated on first use and never freed, since a signal handler may still be writing a sample
+// when a profile stops.
+Sample* samples = nullptr;
+AtomicInt32 nextSample;
+
+// Serializes start() and stop().
+stdx::mutex profilerMutex;
+bool running = false;
+
+// The signal handler and the signal trampoline are the innermost frames of every sample.
+const int kSkipFrames = 2;
+
+void recordSample(int) {
+    const int savedErrno = errno;
+    const int index = nextSample.fetchAndAdd(1);
+    if (index < SamplingProfiler::kMaxSamples) {
+        Sample& sample = samples[index];
+        sample.tag = threadTag;
+        sample.numFrames = backtrace(sample.frames, SamplingProfiler::kMaxFrames);
+        sample.complete.store(true);
+    }
+    errno = savedErrno;
+}
+
+/**
+ * Returns the demangled name of the function containing 'address', without its parameters, or
+ * the address itself if it has no symbol.
+ */
+std::string symbolize(void* address) {
+    Dl_info dli;
+    if (dladdr(address, &dli) && dli.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+        if (!demangled) {
+            return dli.dli_sname;
+        }
+
+        // Function parameters are verbose and rarely help tell frames apart.
+        std::string name(demangled, strcspn(demangled, "("));
+        free(demangled);
+        return name;
+    }
+
+    return str::stream() << address;
+}
+
+}  // namespace
+
+Status SamplingProfiler::start(int hz) {
+    invariant(hz > 0 && hz <= 1000 * 1000);
+    stdx::lock_guard<stdx::mutex> lk(profilerMutex);
+    if (running) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      "A CPU sampling profile is already running");
+    }
+
+    struct sigaction currentAction;
+    invariant(sigaction(SIGPROF, nullptr, &currentAction) == 0);
+    if (currentAction.sa_handler != SIG_DFL && currentAction.sa_handler != SIG_IGN &&
+        currentAction.sa_handler != recordSample) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      "Another SIGPROF handler, such as the gperftools CPU profiler, is installed");
+    }
+
+    if (!samples) {
+        samples = new Sample[kMaxSamples];
+    }
+    for (int i = 0; i < kMaxSamples; i++) {
+        samples[i].complete.store(false);
+    }
+    nextSample.store(0);
+
+    // The first call to backtrace() may load libgcc and allocate, which is not safe in a signal
+    // handler.
+    void* frame;
+    backtrace(&frame, 1);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = recordSample;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "Failed to install the SIGPROF handler: "
+                                    << errnoWithDescription());
+    }
+
+    const long long periodMicros = 1000 * 1000 / hz;
+    struct itimerval timer;
+    timer.it_interval.tv_sec = periodMicros / (1000 * 1000);
+    timer.it_interval.tv_usec = periodMicros % (1000 * 1000);
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "Failed to start the profiling timer: "
+                                    << errnoWithDescription());
+    }
+
+    running = true;
+    return Status::OK();
+}
+
+SamplingProfiler::Profile SamplingProfiler::stop() {
+    stdx::lock_guard<stdx::mutex> lk(profilerMutex);
+    Profile profile;
+    if (!running) {
+        return profile;
+    }
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    invariant(setitimer(ITIMER_PROF, &timer, nullptr) == 0);
+
+    // SIGPROF is left ignored rather than restored to its default action, which would terminate
+    // the process if a signal were still pending.
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_IGN;
+    sigemptyset(&action.sa_mask);
+    invariant(sigaction(SIGPROF, &action, nullptr) == 0);
+    running = false;
+
+    const int numSamples = std::min(nextSample.load(), static_cast<int>(kMaxSamples));
+    profile.droppedSamples = std::max(0, nextSample.load() - kMaxSamples);
+
+    std::map<void*, std::string> symbols;
+    for (int i = 0; i < numSamples; i++) {
+        const Sample& sample = samples[i];
+        if (!sample.complete.load()) {
+            continue;
+        }
+
+        std::string stack = sample.tag ? sample.tag : "[untagged]";
+        for (int j = sample.numFrames - 1; j >= kSkipFrames; j--) {
+            auto it = symbols.find(sample.frames[j]);
+            if (it == symbols.end()) {
+                it = symbols.emplace(sample.frames[j], symbolize(sample.frames[j])).first;
+            }
+            stack += ';';
+            stack += it->second;
+        }
+
+        profile.stacks[stack]++;
+        profile.samples++;
+    }
+
+    return profile;
+}
+
+#else
+
+Status SamplingProfiler::start(int hz) {
+    return Status(ErrorCodes::IllegalOperation,
+                  "CPU sampling profiling is not supported on this platform");
+}
+
+SamplingProfiler::Profile SamplingProfiler::stop() {
+    return Profile();
+}
+
+#endif
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * An in-process CPU sampling profiler. While a profile runs, the process receives SIGPROF each
+ * time it has consumed 1/hz seconds of CPU time across all of its threads (ITIMER_PROF), so busy
+ * threads are sampled in proportion to the CPU they use. The signal handler records the stack of
+ * the interrupted thread and that thread's tag into a preallocated buffer without allocating or
+ * locking. Stacks are only symbolized and aggregated when the profile stops.
+ *
+ * Only one profile can run at a time. Profiling is only supported on POSIX systems which provide
+ * backtrace(); elsewhere start() returns an error.
+ */
+class SamplingProfiler {
+    MONGO_DISALLOW_COPYING(SamplingProfiler);
+
+public:
+    // Deepest stack recorded per sample; deeper stacks lose their outermost frames.
+    static const int kMaxFrames = 48;
+
+    // Samples recorded per profile; later samples are counted as dropped.
+    static const int kMaxSamples = 16 * 1024;
+
+    /**
+     * The aggregated result of one profile.
+     */
+    struct Profile {
+        /**
+         * Appends the number of samples and the stacks in collapsed flamegraph format, that is
+         * "tag;outermost frame;...;innermost frame count", most frequent first. Stops appending
+         * stacks once they would exceed 'maxBytes' and sets "truncated".
+         */
+        void append(BSONObjBuilder* builder, int maxBytes) const;
+
+        // Sample count by collapsed stack, without the trailing count.
+        std::map<std::string, long long> stacks;
+        long long samples = 0;
+        long long droppedSamples = 0;
+    };
+
+    /**
+     * Sets the tag recorded with samples of the calling thread, such as the name of the command it
+     * is running, for the lifetime of the guard. 'tag' must outlive the guard.
+     */
+    class TagGuard {
+        MONGO_DISALLOW_COPYING(TagGuard);
+
+    public:
+        explicit TagGuard(const char* tag);
+        ~TagGuard();
+
+    private:
+        const char* const _previousTag;
+    };
+
+    /**
+     * Starts profiling at 'hz' samples per second of CPU time. Fails if a profile is already
+     * running, if another SIGPROF handler is installed, or if the platform is not supported.
+     */
+    static Status start(int hz);
+
+    /**
+     * Stops the running profile and returns its symbolized, aggregated stacks.
+     */
+    static Profile stop();
+};
+
+}  // namespace mongo
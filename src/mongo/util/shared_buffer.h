@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <boost/intrusive_ptr.hpp>
+#include <cstring>
 
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/allocator.h"
@@ -62,6 +64,15 @@ public:
     void realloc(size_t size) {
         invariant(!_holder || !_holder->isShared());
 
+        if (_holder && _holder->_pooled) {
+            // Pooled memory goes back to its pool rather than to the allocator, so it can't be
+            // resized in place.
+            auto tmp = SharedBuffer::allocate(size);
+            memcpy(tmp.get(), get(), std::min(size, capacity()));
+            swap(tmp);
+            return;
+        }
+
         const size_t realSize = size + sizeof(Holder);
         void* newPtr = mongoRealloc(_holder.get(), realSize);
 
@@ -97,10 +108,12 @@ public:
     }
 
 private:
+    friend class SharedBufferPool;
+
     class Holder {
     public:
-        explicit Holder(AtomicUInt32::WordType initial, size_t capacity)
-            : _refCount(initial), _capacity(capacity) {
+        explicit Holder(AtomicUInt32::WordType initial, size_t capacity, bool pooled = false)
+            : _refCount(initial), _capacity(capacity), _pooled(pooled) {
             invariant(capacity == _capacity);
         }
 
@@ -111,6 +124,11 @@ private:
 
         friend void intrusive_ptr_release(Holder* h) {
             if (h->_refCount.subtractAndFetch(1) == 0) {
+                if (h->_pooled) {
+                    releaseToPool(h);
+                    return;
+                }
+
                 // We placement new'ed a Holder in takeOwnership above,
                 // so we must destroy the object here.
                 h->~Holder();
@@ -131,9 +149,19 @@ private:
         }
 
         AtomicUInt32 _refCount;
-        uint32_t _capacity;
+        uint32_t _capacity : 31;
+
+        // Set for buffers handed out by SharedBufferPool, which get their memory back when the
+        // last reference goes away.
+        uint32_t _pooled : 1;
     };
 
+    /**
+     * Returns the memory of a pooled Holder whose last reference was dropped to its pool. Defined
+     * in shared_buffer_pool.cpp.
+     */
+    static void releaseToPool(Holder* h);
+
     explicit SharedBuffer(Holder* holder) : _holder(holder, /*add_ref=*/false) {
         // NOTE: The 'false' above is because we have already initialized the Holder with a
         // refcount of '1' in takeOwnership below. This avoids an atomic increment.
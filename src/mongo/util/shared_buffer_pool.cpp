@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include <cstdlib>
+
+#include "mongo/util/allocator.h"
+
+namespace mongo {
+
+constexpr size_t SharedBufferPool::kMinPooledBytes;
+constexpr size_t SharedBufferPool::kMaxPooledBytes;
+constexpr size_t SharedBufferPool::kNumSizeClasses;
+constexpr size_t SharedBufferPool::kNumConsumers;
+constexpr size_t SharedBufferPool::kThreadCacheBuffersPerClass;
+
+struct SharedBufferPool::ThreadCache {
+    ~ThreadCache();
+
+    std::array<std::vector<void*>, kNumSizeClasses> buffers;
+};
+
+namespace {
+
+// Buffers can be released while other thread_locals are being destroyed at thread exit, after
+// the thread's cache is gone. This is trivially destructible, so it can still be checked then.
+thread_local bool threadCacheDestroyed = false;
+
+}  // namespace
+
+thread_local SharedBufferPool::ThreadCache SharedBufferPool::_threadCache;
+
+SharedBufferPool::ThreadCache::~ThreadCache() {
+    threadCacheDestroyed = true;
+
+    // The memory here is already counted in the pool's pooled bytes, so hand it to the shared
+    // lists as is.
+    auto& pool = SharedBufferPool::get();
+    for (size_t sizeClass = 0; sizeClass < kNumSizeClasses; ++sizeClass) {
+        auto& cached = buffers[sizeClass];
+        if (cached.empty()) {
+            continue;
+        }
+        auto& shared = pool._sizeClasses[sizeClass];
+        stdx::lock_guard<stdx::mutex> lk(shared.mutex);
+        shared.buffers.insert(shared.buffers.end(), cached.begin(), cached.end());
+    }
+}
+
+SharedBufferPool& SharedBufferPool::get() {
+    // Intentionally leaked so that buffers released during shutdown still have a pool to go to.
+    static SharedBufferPool* pool = new SharedBufferPool();
+    return *pool;
+}
+
+size_t SharedBufferPool::sizeClassFor(size_t bytes) {
+    invariant(bytes <= kMaxPooledBytes);
+    size_t sizeClass = 0;
+    while (sizeClassBytes(sizeClass) < bytes) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+SharedBuffer SharedBufferPool::allocate(size_t bytes, Consumer consumer) {
+    if (!_maxPooledBytes.load()) {
+        return SharedBuffer::allocate(bytes);
+    }
+
+    auto& counters = _counters[static_cast<size_t>(consumer)];
+    if (bytes < kMinPooledBytes || bytes > kMaxPooledBytes) {
+        counters.unpooled.fetchAndAdd(1);
+        return SharedBuffer::allocate(bytes);
+    }
+
+    const auto sizeClass = sizeClassFor(bytes);
+    const auto classBytes = sizeClassBytes(sizeClass);
+
+    void* memory = nullptr;
+    if (!threadCacheDestroyed && !_threadCache.buffers[sizeClass].empty()) {
+        memory = _threadCache.buffers[sizeClass].back();
+        _threadCache.buffers[sizeClass].pop_back();
+    } else {
+        auto& shared = _sizeClasses[sizeClass];
+        stdx::lock_guard<stdx::mutex> lk(shared.mutex);
+        if (!shared.buffers.empty()) {
+            memory = shared.buffers.back();
+            shared.buffers.pop_back();
+        }
+    }
+
+    if (memory) {
+        _pooledBytes.subtractAndFetch(classBytes);
+        counters.hits.fetchAndAdd(1);
+    } else {
+        memory = mongoMalloc(sizeof(SharedBuffer::Holder) + classBytes);
+        counters.misses.fetchAndAdd(1);
+    }
+
+    return SharedBuffer(new (memory) SharedBuffer::Holder(1U, classBytes, /*pooled=*/true));
+}
+
+void SharedBufferPool::_release(SharedBuffer::Holder* holder) {
+    const size_t sizeClass = sizeClassFor(holder->_capacity);
+    const long long classBytes = sizeClassBytes(sizeClass);
+    holder->~Holder();
+    void* memory = holder;
+
+    if (_pooledBytes.addAndFetch(classBytes) > _maxPooledBytes.load()) {
+        _pooledBytes.subtractAndFetch(classBytes);
+        _free(memory);
+        return;
+    }
+
+    if (!threadCacheDestroyed &&
+        _threadCache.buffers[sizeClass].size() < kThreadCacheBuffersPerClass) {
+        _threadCache.buffers[sizeClass].push_back(memory);
+        return;
+    }
+
+    auto& shared = _sizeClasses[sizeClass];
+    stdx::lock_guard<stdx::mutex> lk(shared.mutex);
+    shared.buffers.push_back(memory);
+}
+
+void SharedBufferPool::_free(void* holderMemory) {
+    std::free(holderMemory);
+}
+
+void SharedBufferPool::setMaxPooledBytes(size_t bytes) {
+    const long long maxPooledBytes = bytes;
+    if (maxPooledBytes < _maxPooledBytes.swap(maxPooledBytes)) {
+        clear();
+    }
+}
+
+void SharedBufferPool::clear() {
+    for (size_t sizeClass = 0; sizeClass < kNumSizeClasses; ++sizeClass) {
+        std::vector<void*> buffers;
+        {
+            auto& shared = _sizeClasses[sizeClass];
+            stdx::lock_guard<stdx::mutex> lk(shared.mutex);
+            buffers.swap(shared.buffers);
+        }
+        _pooledBytes.subtractAndFetch(buffers.size() * sizeClassBytes(sizeClass));
+        for (auto memory : buffers) {
+            _free(memory);
+        }
+    }
+}
+
+auto SharedBufferPool::getStats(Consumer consumer) const -> Stats {
+    const auto& counters = _counters[static_cast<size_t>(consumer)];
+    Stats stats;
+    stats.hits = counters.hits.load();
+    stats.misses = counters.misses.load();
+    stats.unpooled = counters.unpooled.load();
+    stats.pooledBytes = _pooledBytes.load();
+    stats.maxPooledBytes = _maxPooledBytes.load();
+    return stats;
+}
+
+void SharedBuffer::releaseToPool(Holder* h) {
+    SharedBufferPool::get()._release(h);
+}
+
+}  // namespace mongo
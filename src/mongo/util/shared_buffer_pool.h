@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+/**
+ * A size-classed pool of SharedBuffers, used for the payloads of incoming network messages and for
+ * the buffers of BufBuilders.
+ *
+ * Requests are rounded up to a power of two between kMinPooledBytes and kMaxPooledBytes. When
+ * the last reference to a pooled buffer goes away its memory is kept in a small per-thread cache,
+ * or failing that in a shared per-size-class list, instead of being freed. Memory sitting idle in
+ * the pool is capped by setMaxPooledBytes(); the pool is disabled while the cap is 0.
+ */
+class SharedBufferPool {
+    MONGO_DISALLOW_COPYING(SharedBufferPool);
+
+public:
+    static constexpr size_t kMinPooledBytes = 1024;
+    static constexpr size_t kMaxPooledBytes = 16 * 1024 * 1024;
+    static constexpr size_t kNumSizeClasses = 15;  // 1KB through 16MB.
+
+    // The number of idle buffers of each size class a thread keeps for itself.
+    static constexpr size_t kThreadCacheBuffersPerClass = 4;
+
+    // What a buffer is allocated for. Hits, misses and unpooled allocations are counted per
+    // consumer; the pooled memory and its cap are shared.
+    enum class Consumer { kNetworkMessage, kBufBuilder };
+    static constexpr size_t kNumConsumers = 2;
+
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long unpooled = 0;
+        long long pooledBytes = 0;
+        long long maxPooledBytes = 0;
+    };
+
+    /**
+     * Returns the process-wide pool. Pooled buffers always return to this pool.
+     */
+    static SharedBufferPool& get();
+
+    /**
+     * Returns a buffer of at least 'bytes' bytes. Its capacity() is that of the size class it was
+     * drawn from. Sizes outside the pooled range, or any size while the pool is disabled, are
+     * allocated with SharedBuffer::allocate().
+     */
+    SharedBuffer allocate(size_t bytes, Consumer consumer = Consumer::kNetworkMessage);
+
+    /**
+     * Returns whether allocate() would currently draw a buffer of 'bytes' bytes from the pool.
+     */
+    bool isPooledSize(size_t bytes) const {
+        return _maxPooledBytes.load() && bytes >= kMinPooledBytes && bytes <= kMaxPooledBytes;
+    }
+
+    void setMaxPooledBytes(size_t bytes);
+
+    Stats getStats(Consumer consumer = Consumer::kNetworkMessage) const;
+
+    /**
+     * Frees every idle buffer held in the shared lists. Buffers in per-thread caches are freed
+     * when their thread exits.
+     */
+    void clear();
+
+    /**
+     * Returns the index of the size class holding 'bytes', which must be in the pooled range.
+     */
+    static size_t sizeClassFor(size_t bytes);
+
+    static size_t sizeClassBytes(size_t sizeClass) {
+        return kMinPooledBytes << sizeClass;
+    }
+
+private:
+    friend class SharedBuffer;
+
+    struct ThreadCache;
+
+    SharedBufferPool() = default;
+
+    void _release(SharedBuffer::Holder* holder);
+    void _free(void* holderMemory);
+
+    struct SizeClass {
+        stdx::mutex mutex;
+        std::vector<void*> buffers;
+    };
+
+    std::array<SizeClass, kNumSizeClasses> _sizeClasses;
+
+    AtomicWord<long long> _maxPooledBytes{0};
+    AtomicWord<long long> _pooledBytes{0};
+
+    struct Counters {
+        AtomicWord<long long> hits{0};
+        AtomicWord<long long> misses{0};
+        AtomicWord<long long> unpooled{0};
+    };
+
+    std::array<Counters, kNumConsumers> _counters;
+
+    static thread_local ThreadCache _threadCache;
+};
+
+}  // namespace mongo
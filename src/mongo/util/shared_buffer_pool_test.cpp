@@ -0,0 +1,185 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/builder.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class SharedBufferPoolTest : public unittest::Test {
+public:
+    void setUp() override {
+        pool().setMaxPooledBytes(64 * 1024 * 1024);
+    }
+
+    void tearDown() override {
+        pool().setMaxPooledBytes(0);
+    }
+
+    SharedBufferPool& pool() {
+        return SharedBufferPool::get();
+    }
+};
+
+TEST_F(SharedBufferPoolTest, RoundsUpToSizeClass) {
+    ASSERT_EQ(SharedBufferPool::sizeClassFor(1024), 0u);
+    ASSERT_EQ(SharedBufferPool::sizeClassFor(1025), 1u);
+    ASSERT_EQ(SharedBufferPool::sizeClassFor(SharedBufferPool::kMaxPooledBytes),
+              SharedBufferPool::kNumSizeClasses - 1);
+
+    auto buf = pool().allocate(5000);
+    ASSERT_EQ(buf.capacity(), 8192u);
+}
+
+TEST_F(SharedBufferPoolTest, ReusesReleasedBuffer) {
+    const auto before = pool().getStats();
+
+    auto buf = pool().allocate(100 * 1024);
+    const char* memory = buf.get();
+    buf = {};
+    ASSERT_EQ(pool().getStats().pooledBytes, before.pooledBytes + 128 * 1024);
+
+    auto reused = pool().allocate(90 * 1024);
+    ASSERT_EQ(reused.get(), memory);
+
+    const auto after = pool().getStats();
+    ASSERT_EQ(after.hits, before.hits + 1);
+    ASSERT_EQ(after.misses, before.misses + 1);
+}
+
+TEST_F(SharedBufferPoolTest, DoesNotPoolOutsideSizeClasses) {
+    const auto before = pool().getStats();
+
+    auto small = pool().allocate(16);
+    auto large = pool().allocate(SharedBufferPool::kMaxPooledBytes + 1);
+    ASSERT_EQ(small.capacity(), 16u);
+    small = {};
+    large = {};
+
+    const auto after = pool().getStats();
+    ASSERT_EQ(after.unpooled, before.unpooled + 2);
+    ASSERT_EQ(after.pooledBytes, before.pooledBytes);
+}
+
+TEST_F(SharedBufferPoolTest, RespectsMaxPooledBytes) {
+    // Lowering the cap frees the shared lists, leaving only what this thread caches itself.
+    pool().setMaxPooledBytes(0);
+    const auto cached = pool().getStats().pooledBytes;
+    pool().setMaxPooledBytes(cached + 4096);
+
+    auto first = pool().allocate(4096);
+    auto second = pool().allocate(4096);
+    first = {};
+    second = {};
+
+    // Only one of the two buffers fits under the cap, the other is freed.
+    ASSERT_EQ(pool().getStats().pooledBytes, cached + 4096);
+}
+
+TEST_F(SharedBufferPoolTest, BuffersReleasedOnOtherThreadsAreShared) {
+    std::vector<char*> memory;
+    stdx::thread worker([&] {
+        // More buffers than a thread keeps for itself, so some go to the shared list, and the
+        // rest join it when this thread exits.
+        std::vector<SharedBuffer> buffers;
+        for (size_t i = 0; i < SharedBufferPool::kThreadCacheBuffersPerClass + 2; ++i) {
+            buffers.push_back(pool().allocate(2048));
+            memory.push_back(buffers.back().get());
+        }
+    });
+    worker.join();
+
+    const auto before = pool().getStats();
+    std::vector<SharedBuffer> buffers;
+    for (size_t i = 0; i < memory.size(); ++i) {
+        buffers.push_back(pool().allocate(2048));
+    }
+    ASSERT_EQ(pool().getStats().hits, before.hits + long(memory.size()));
+}
+
+TEST_F(SharedBufferPoolTest, ReallocOfPooledBufferCopies) {
+    auto buf = pool().allocate(2048);
+    memcpy(buf.get(), "pooled", 7);
+    buf.realloc(64 * 1024 * 1024);
+    ASSERT_EQ(buf.capacity(), 64u * 1024 * 1024);
+    ASSERT_EQ(std::string(buf.get()), "pooled");
+}
+
+TEST_F(SharedBufferPoolTest, CountsStatsPerConsumer) {
+    const auto messagesBefore = pool().getStats();
+    const auto buildersBefore = pool().getStats(SharedBufferPool::Consumer::kBufBuilder);
+
+    pool().allocate(4096, SharedBufferPool::Consumer::kBufBuilder);
+    pool().allocate(4096, SharedBufferPool::Consumer::kBufBuilder);
+
+    const auto messagesAfter = pool().getStats();
+    const auto buildersAfter = pool().getStats(SharedBufferPool::Consumer::kBufBuilder);
+    ASSERT_EQ(buildersAfter.hits + buildersAfter.misses,
+              buildersBefore.hits + buildersBefore.misses + 2);
+    ASSERT_EQ(messagesAfter.hits, messagesBefore.hits);
+    ASSERT_EQ(messagesAfter.misses, messagesBefore.misses);
+}
+
+TEST_F(SharedBufferPoolTest, BufBuilderRecyclesReleasedBuffers) {
+    const char* memory;
+    {
+        BufBuilder builder(2048);
+        builder.appendStr("first");
+        memory = builder.buf();
+        ConstSharedBuffer released(builder.release());
+    }
+
+    const auto before = pool().getStats(SharedBufferPool::Consumer::kBufBuilder);
+    BufBuilder builder(2048);
+    ASSERT_EQ(builder.buf(), memory);
+    ASSERT_EQ(pool().getStats(SharedBufferPool::Consumer::kBufBuilder).hits, before.hits + 1);
+}
+
+TEST_F(SharedBufferPoolTest, BufBuilderGrowsThroughPool) {
+    BufBuilder builder(1024);
+    const std::string chunk(1000, 'x');
+    for (int i = 0; i < 100; ++i) {
+        builder.appendStr(chunk, false);
+    }
+    ASSERT_EQ(builder.len(), 100 * 1000);
+    ASSERT_EQ(std::string(builder.buf(), 1000), chunk);
+    ASSERT_EQ(std::string(builder.buf() + 99 * 1000, 1000), chunk);
+}
+
+}  // namespace
+}  // namespace mongo
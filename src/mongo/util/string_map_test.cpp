@@ -157,6 +157,56 @@ TEST(StringMapTest, Erase2) {
     ASSERT_EQUALS(true, m.empty());
 }
 
+TEST(StringMapTest, Erase3) {
+    // Churn through many keys while keeping a few hundred live, which leaves deleted slots in
+    // full groups that later inserts must reuse or clean up.
+    StringMap<int> m;
+    char buf[64];
+    for (int i = 0; i < 20000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+        if (i >= 300) {
+            sprintf(buf, "foo%d", i - 300);
+            ASSERT_EQUALS(1U, m.erase(buf));
+        }
+    }
+    ASSERT_EQUALS(300U, m.size());
+    ASSERT_LESS_THAN_OR_EQUALS(m.capacity(), 1024U);
+
+    int sum = 0;
+    for (auto&& entry : m) {
+        sum += entry.second;
+    }
+    ASSERT_EQUALS(300 * (19700 + 19999) / 2, sum);
+
+    for (int i = 19700; i < 20000; i++) {
+        sprintf(buf, "foo%d", i);
+        ASSERT_EQUALS(i, m.find(buf)->second);
+    }
+    sprintf(buf, "foo%d", 19699);
+    ASSERT(m.end() == m.find(buf));
+}
+
+TEST(StringMapTest, EraseWhileIterating) {
+    StringMap<int> m;
+    char buf[64];
+    for (int i = 0; i < 1000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+    }
+
+    for (auto it = m.begin(); it != m.end();) {
+        auto current = it++;
+        if (current->second % 2) {
+            m.erase(current);
+        }
+    }
+    ASSERT_EQUALS(500U, m.size());
+    for (auto&& entry : m) {
+        ASSERT_EQUALS(0, entry.second % 2);
+    }
+}
+
 TEST(StringMapTest, Iterator1) {
     StringMap<int> m;
     ASSERT(m.begin() == m.end());
@@ -194,6 +194,13 @@ TEST(StringUtilsTest, VariousConversions) {
                   integerToHex(std::numeric_limits<long long>::min()));
 }
 
+TEST(StringUtilsTest, FixedLengthHexConversions) {
+    ASSERT_EQUALS(std::string("0000000000000000"), unsignedIntToFixedLengthHex(0));
+    ASSERT_EQUALS(std::string("0000000000001337"), unsignedIntToFixedLengthHex(0x1337));
+    ASSERT_EQUALS(std::string("FFFFFFFFFFFFFFFF"),
+                  unsignedIntToFixedLengthHex(std::numeric_limits<std::uint64_t>::max()));
+}
+
 TEST(StringUtilsTest, CanParseZero) {
     boost::optional<size_t> result = parseUnsignedBase10Integer("0");
     ASSERT(result && *result == 0);
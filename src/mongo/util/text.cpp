@@ -32,6 +32,7 @@
 #include "mongo/util/text.h"
 
 #include <boost/integer_traits.hpp>
+#include <cstring>
 #include <errno.h>
 #include <iostream>
 #include <memory>
@@ -123,9 +124,30 @@ bool isValidUTF8(const std::string& s) {
 }
 
 bool isValidUTF8(const char* s) {
+    return isValidUTF8(StringData(s));
+}
+
+bool isValidUTF8(StringData s) {
+    const char* p = s.rawData();
+    const char* const end = p + s.size();
     int left = 0;  // how many bytes are left in the current codepoint
-    while (*s) {
-        const unsigned char c = (unsigned char)*(s++);
+    while (p != end) {
+        if (!left) {
+            // Between codepoints, skip runs of ASCII a word at a time. Most strings are entirely
+            // ASCII, so this is the common path.
+            const uint64_t kHighBits = 0x8080808080808080ULL;
+            uint64_t word;
+            while (end - p >= static_cast<ptrdiff_t>(sizeof(word))) {
+                memcpy(&word, p, sizeof(word));
+                if (word & kHighBits)
+                    break;
+                p += sizeof(word);
+            }
+            if (p == end)
+                break;
+        }
+
+        const unsigned char c = (unsigned char)*(p++);
         const int ones = leadingOnes(c);
         if (left) {
             if (ones != 1)
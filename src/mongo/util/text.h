@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
 #include "mongo/config.h"
 
 namespace mongo {
@@ -69,9 +70,13 @@ private:
 /* This doesn't defend against ALL bad UTF8, but it will guarantee that the
  * std::string can be converted to sequence of codepoints. However, it doesn't
  * guarantee that the codepoints are valid.
+ *
+ * The const char* and std::string overloads stop at the first NUL byte. The StringData overload
+ * checks all of 's', treating embedded NUL bytes as ASCII.
  */
 bool isValidUTF8(const char* s);
 bool isValidUTF8(const std::string& s);
+bool isValidUTF8(StringData s);
 
 #if defined(_WIN32)
 
@@ -89,3 +89,57 @@ TEST(WindowsCommandLineConstruction, RegressionSERVER_7252) {
                                              "--service",
                                              NULL)));
 }
+
+namespace {
+
+// The byte at a time validation which isValidUTF8 skips ASCII runs around.
+bool isValidUTF8ByteAtATime(StringData s) {
+    int left = 0;
+    for (unsigned char c : s) {
+        int ones = 0;
+        while (ones < 8 && (c & (0x80 >> ones)))
+            ones++;
+        if (left) {
+            if (ones != 1)
+                return false;
+            left--;
+        } else if (ones != 0) {
+            if (ones == 1 || c > 0xF4 || c == 0xC0 || c == 0xC1)
+                return false;
+            left = ones - 1;
+        }
+    }
+    return left == 0;
+}
+
+TEST(IsValidUTF8, MatchesByteAtATimeAroundASCIIRuns) {
+    const std::vector<std::string> sequences = {"\xC2\xA2",
+                                                "\xE2\x82\xAC",
+                                                "\xF0\x9D\x90\x80",
+                                                "\xC2",
+                                                "\xE2\x82",
+                                                "\xF0\x9D\x90",
+                                                "\xF8\x80\x80\x80\x80",
+                                                "\xF5\x80\x80\x80",
+                                                "\x80",
+                                                "\xC0\x80",
+                                                "\xC2\xA2\x80"};
+    for (const auto& sequence : sequences) {
+        for (size_t prefix = 0; prefix <= 24; prefix++) {
+            for (size_t suffix = 0; suffix <= 17; suffix++) {
+                const std::string s =
+                    std::string(prefix, 'a') + sequence + std::string(suffix, 'b');
+                ASSERT_EQ(isValidUTF8ByteAtATime(s), isValidUTF8(StringData(s))) << s;
+                ASSERT_EQ(isValidUTF8ByteAtATime(s), isValidUTF8(s.c_str())) << s;
+            }
+        }
+    }
+}
+
+TEST(IsValidUTF8, StringDataChecksPastEmbeddedNul) {
+    const std::string s("abcdefghijk\0\x80", 13);
+    ASSERT_TRUE(isValidUTF8(s));
+    ASSERT_FALSE(isValidUTF8(StringData(s)));
+}
+
+}  // namespace
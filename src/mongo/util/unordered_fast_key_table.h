@@ -29,15 +29,87 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#endif
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+namespace unordered_fast_key_table_detail {
+
+/**
+ * Every slot in the table has a control byte. A full slot's control byte holds the low 7 bits of
+ * its key's hash, so it is never negative. Empty and deleted slots use the negative values below.
+ */
+using Ctrl = int8_t;
+constexpr Ctrl kEmpty = -128;
+constexpr Ctrl kDeleted = -2;
+
+// Slots are probed a group at a time. Capacities are always a multiple of this.
+constexpr unsigned kGroupWidth = 16;
+
+/**
+ * A view of the kGroupWidth control bytes starting at 'pos'. Each match function returns a bitmask
+ * with bit i set if the i'th control byte in the group matches.
+ */
+class Group {
+public:
+#if defined(_M_AMD64) || defined(__amd64__)
+    explicit Group(const Ctrl* pos)
+        : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+    uint32_t match(Ctrl tag) const {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), _ctrl));
+    }
+
+    uint32_t matchEmptyOrDeleted() const {
+        // kEmpty and kDeleted are the only control values less than -1.
+        return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl));
+    }
+#else
+    explicit Group(const Ctrl* pos) : _ctrl(pos) {}
+
+    uint32_t match(Ctrl tag) const {
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < kGroupWidth; ++i) {
+            mask |= uint32_t(_ctrl[i] == tag) << i;
+        }
+        return mask;
+    }
+
+    uint32_t matchEmptyOrDeleted() const {
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < kGroupWidth; ++i) {
+            mask |= uint32_t(_ctrl[i] < -1) << i;
+        }
+        return mask;
+    }
+#endif
+
+    uint32_t matchEmpty() const {
+        return match(kEmpty);
+    }
+
+private:
+#if defined(_M_AMD64) || defined(__amd64__)
+    __m128i _ctrl;
+#else
+    const Ctrl* _ctrl;
+#endif
+};
+
+}  // namespace unordered_fast_key_table_detail
+
 /**
  * A hash map that allows a different type to be used stored (K_S) than is used for lookups (K_L).
  *
@@ -55,6 +127,14 @@ namespace mongo {
  *     const K_L& key() const;
  *     uint32_t hash() const; // Should be free to call repeatedly.
  * };
+ *
+ * The table uses open addressing over groups of 16 slots. Each slot has a one byte control entry
+ * holding either its state (empty or deleted) or the low 7 bits of its key's hash, and the rest of
+ * the hash picks the first group to probe. A lookup compares a whole group of control bytes at once
+ * and only looks at the entries whose 7 bits match, so most misses never touch an entry.
+ *
+ * Erasing never moves other entries, so it only invalidates iterators to the erased entry.
+ * Inserting may grow the table, which invalidates all iterators and references.
  */
 template <typename K_L,  // key lookup
           typename K_S,  // key storage
@@ -70,86 +150,45 @@ public:
     using HashedKey = typename Traits::HashedKey;
 
 private:
+    using Ctrl = unordered_fast_key_table_detail::Ctrl;
+    using Group = unordered_fast_key_table_detail::Group;
+
+    /**
+     * Storage for a single slot. Whether it holds a value is tracked by the owning Area's control
+     * bytes, so construction and destruction of the value are left to the Area.
+     */
     class Entry {
     public:
-        Entry() = default;
-
-        Entry(const Entry& other)
-            : _used(other._used), _everUsed(other.everUsed), _curHash(other._curHash) {
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
-        }
-
-        Entry& operator=(const Entry& other) {
-            if (this == &other) {
-                return *this;
-            }
-
-            if (isUsed()) {
-                unUse();
-            }
-
-            _used = other._used;
-            _everUsed = other._everUsed;
-            _curHash = other._curHash;
-
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
-
-            return *this;
-        }
-
-        ~Entry() {
-            if (isUsed()) {
-                unUse();
-            }
-        }
-
         template <typename... Args>
         void emplaceData(const HashedKey& key, Args&&... args) {
-            dassert(!isUsed());
-            _used = true;
-            _everUsed = true;
-            _curHash = key.hash();
             new (&_data) value_type(std::piecewise_construct,
                                     std::forward_as_tuple(Traits::toStorage(key.key())),
                                     std::forward_as_tuple(std::forward<Args>(args)...));
+            _curHash = key.hash();
         }
 
-        bool isUsed() const {
-            return _used;
+        void copyData(const Entry& other) {
+            new (&_data) value_type(other.getData());
+            _curHash = other._curHash;
         }
 
-        bool wasEverUsed() const {
-            return _everUsed;
+        void destroyData() {
+            getData().~value_type();
         }
 
         uint32_t getCurHash() const {
-            dassert(isUsed());
             return _curHash;
         }
 
-        void unUse() {
-            dassert(isUsed());
-            _used = false;
-            reinterpret_cast<value_type*>(&_data)->~value_type();
-        }
-
         value_type& getData() {
-            dassert(isUsed());
             return *reinterpret_cast<value_type*>(&_data);
         }
 
         const value_type& getData() const {
-            dassert(isUsed());
             return *reinterpret_cast<const value_type*>(&_data);
         }
 
     private:
-        bool _used = false;
-        bool _everUsed = false;
         uint32_t _curHash;
         typename std::aligned_storage<sizeof(value_type),
                                       std::alignment_of<value_type>::value>::type _data;
@@ -158,16 +197,26 @@ private:
     struct Area {
         Area() = default;  // TODO constexpr
 
-        Area(unsigned capacity, unsigned maxProbe)
+        explicit Area(unsigned capacity)
             : _hashMask(capacity - 1),
-              _maxProbe(maxProbe),
+              _growthLeft(capacity - capacity / 8),
+              _ctrl(capacity ? new Ctrl[capacity] : nullptr),
               _entries(capacity ? new Entry[capacity] : nullptr) {
-            // Capacity must be a power of two or zero. See the comment on _hashMask for why.
+            // Capacity must be zero or a power of two that holds at least one group. See the
+            // comment on _hashMask for why.
             dassert((capacity & (capacity - 1)) == 0);
+            dassert(capacity == 0 || capacity >= unordered_fast_key_table_detail::kGroupWidth);
+            std::fill(_ctrl.get(), _ctrl.get() + capacity, unordered_fast_key_table_detail::kEmpty);
         }
 
-        Area(const Area& other) : Area(other.capacity(), other._maxProbe) {
-            std::copy(other.begin(), other.end(), begin());
+        Area(const Area& other) : Area(other.capacity()) {
+            _growthLeft = other._growthLeft;
+            for (unsigned pos = 0; pos < capacity(); ++pos) {
+                if (other.isFull(pos)) {
+                    _entries[pos].copyData(other._entries[pos]);
+                }
+                _ctrl[pos] = other._ctrl[pos];
+            }
         }
 
         Area& operator=(const Area& other) {
@@ -175,14 +224,40 @@ private:
             return *this;
         }
 
+        ~Area() {
+            for (unsigned pos = 0; pos < capacity(); ++pos) {
+                if (isFull(pos)) {
+                    _entries[pos].destroyData();
+                }
+            }
+        }
+
+        /**
+         * Returns the position of 'key', or -1 if it is not present. If 'firstEmpty' is non-null,
+         * it is set to the first slot on the key's probe sequence that can take a new entry.
+         */
         int find(const HashedKey& key, int* firstEmpty) const;
 
-        bool transfer(Area* newArea) const;
+        /**
+         * Returns the first slot on the probe sequence for 'hash' that is empty or deleted.
+         */
+        unsigned findInsertSlot(uint32_t hash) const;
+
+        template <typename... Args>
+        void emplaceAt(unsigned pos, const HashedKey& key, Args&&... args);
+
+        void eraseAt(unsigned pos);
+
+        /**
+         * Copies every entry into 'newArea', which must be empty.
+         */
+        void transfer(Area* newArea) const;
 
         void swap(Area* other) {
             using std::swap;
             swap(_hashMask, other->_hashMask);
-            swap(_maxProbe, other->_maxProbe);
+            swap(_growthLeft, other->_growthLeft);
+            swap(_ctrl, other->_ctrl);
             swap(_entries, other->_entries);
         }
 
@@ -190,6 +265,14 @@ private:
             return _hashMask + 1;
         }
 
+        unsigned groupMask() const {
+            return (capacity() / unordered_fast_key_table_detail::kGroupWidth) - 1;
+        }
+
+        bool isFull(unsigned pos) const {
+            return _ctrl[pos] >= 0;
+        }
+
         Entry* begin() {
             return _entries.get();
         }
@@ -204,12 +287,28 @@ private:
             return _entries.get() + capacity();
         }
 
+        // The control byte for a full slot holding a key with this hash.
+        static Ctrl hashTag(uint32_t hash) {
+            return hash & 0x7f;
+        }
+
+        // The first group probed for a key with this hash. Uses the bits not in the hash tag, so
+        // that keys sharing a group rarely share a tag.
+        unsigned firstGroup(uint32_t hash) const {
+            return (hash >> 7) & groupMask();
+        }
+
         // Capacity is always a power of two. This means that the operation (hash % capacity) can be
         // preformed by (hash & (capacity - 1)). Since we need the mask more than the capacity we
         // store it directly and derive the capacity from it. The default capacity is 0 so the
         // default hashMask is -1.
         unsigned _hashMask = -1;
-        unsigned _maxProbe = 0;
+
+        // How many more empty slots can be filled before the table must grow. Keeping an eighth of
+        // the slots empty bounds probe lengths and guarantees every probe sequence ends.
+        unsigned _growthLeft = 0;
+
+        std::unique_ptr<Ctrl[]> _ctrl = {};
         std::unique_ptr<Entry[]> _entries = {};
     };
 
@@ -283,7 +382,7 @@ public:
         iterator_impl(AreaPtr area, int pos) {
             _area = area;
             _position = pos;
-            _max = pos;
+            _max = _area->capacity() - 1;
         }
 
         template <typename... Args>
@@ -291,11 +390,11 @@ public:
             : _area(other._area), _position(other._position), _max(other._max) {}
 
         pointer operator->() const {
-            return &_area->_entries[_position].getData();
+            return &_area->begin()[_position].getData();
         }
 
         reference operator*() const {
-            return _area->_entries[_position].getData();
+            return _area->begin()[_position].getData();
         }
 
         iterator_impl& operator++() {
@@ -326,7 +425,7 @@ public:
                     _position = -1;
                     break;
                 }
-                if (_area->_entries[_position].isUsed())
+                if (_area->isFull(_position))
                     break;
                 ++_position;
             }
@@ -343,7 +442,7 @@ public:
     void erase(const_iterator it);
 
     /**
-     * @return either a one-shot iterator with the key, or end()
+     * @return an iterator to the key, or end()
      */
     const_iterator find(const K_L& key) const {
         if (empty())
@@ -423,6 +522,10 @@ public:
     }
 
 private:
+    /**
+     * Moves the entries into a new Area: twice the size if the table is mostly full, or the same
+     * size if it is mostly deleted slots, which this reclaims.
+     */
     void _grow();
 
     size_t _size = 0;
@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+std::vector<std::string> makeKeys(int64_t count, StringData prefix) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (int64_t i = 0; i < count; ++i) {
+        keys.push_back(prefix.toString() + std::to_string(i));
+    }
+    return keys;
+}
+
+/**
+ * Benchmark building a map of state.range(0) string keys, as a $group or a projection does.
+ */
+template <typename Map>
+void BM_Insert(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    for (auto keepRunning : state) {
+        Map map;
+        for (auto&& key : keys) {
+            map[key] = 1;
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Benchmark looking up keys that are all present in a map of state.range(0) keys.
+ */
+template <typename Map>
+void BM_FindHit(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    Map map;
+    for (auto&& key : keys) {
+        map[key] = 1;
+    }
+
+    for (auto keepRunning : state) {
+        for (auto&& key : keys) {
+            benchmark::DoNotOptimize(map.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Benchmark looking up keys that are all absent from a map of state.range(0) keys.
+ */
+template <typename Map>
+void BM_FindMiss(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    const auto missing = makeKeys(state.range(0), "other");
+    Map map;
+    for (auto&& key : keys) {
+        map[key] = 1;
+    }
+
+    for (auto keepRunning : state) {
+        for (auto&& key : missing) {
+            benchmark::DoNotOptimize(map.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Benchmark a map that keeps a steady size while keys are inserted and erased, which leaves
+ * deleted slots behind in an open addressing table.
+ */
+template <typename Map>
+void BM_InsertErase(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0) * 2, "field");
+    Map map;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        map[keys[i]] = 1;
+    }
+
+    size_t next = 0;
+    for (auto keepRunning : state) {
+        map.erase(keys[next]);
+        map[keys[(next + state.range(0)) % keys.size()]] = 1;
+        next = (next + 1) % keys.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+using StdMap = stdx::unordered_map<std::string, int>;
+
+BENCHMARK_TEMPLATE(BM_Insert, StringMap<int>)->Range(8, 64 * 1024);
+BENCHMARK_TEMPLATE(BM_Insert, StdMap)->Range(8, 64 * 1024);
+BENCHMARK_TEMPLATE(BM_FindHit, StringMap<int>)->Range(8, 64 * 1024);
+BENCHMARK_TEMPLATE(BM_FindHit, StdMap)->Range(8, 64 * 1024);
+BENCHMARK_TEMPLATE(BM_FindMiss, StringMap<int>)->Range(8, 64 * 1024);
+BENCHMARK_TEMPLATE(BM_FindMiss, StdMap)->Range(8, 64 * 1024);
+BENCHMARK_TEMPLATE(BM_InsertErase, StringMap<int>)->Range(8, 64 * 1024);
+BENCHMARK_TEMPLATE(BM_InsertErase, StdMap)->Range(8, 64 * 1024);
+
+}  // namespace
+}  // namespace mongo
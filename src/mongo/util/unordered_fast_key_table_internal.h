@@ -40,55 +40,103 @@ inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKe
     dassert(capacity());                        // Caller must special-case empty tables.
     dassert(!firstEmpty || *firstEmpty == -1);  // Caller must initialize *firstEmpty.
 
-    unsigned probe = 0;
-    do {
-        unsigned pos = (key.hash() + probe) & _hashMask;
-
-        if (!_entries[pos].isUsed()) {
-            // space is empty
-            if (firstEmpty && *firstEmpty == -1)
-                *firstEmpty = pos;
-            if (!_entries[pos].wasEverUsed())
-                return -1;
-            continue;
+    using unordered_fast_key_table_detail::kGroupWidth;
+
+    const Ctrl tag = hashTag(key.hash());
+    unsigned group = firstGroup(key.hash());
+
+    // Triangular probing visits every group once when the number of groups is a power of two.
+    for (unsigned probe = 1; probe <= groupMask() + 1; ++probe) {
+        const unsigned base = group * kGroupWidth;
+        const Group ctrl(&_ctrl[base]);
+
+        for (uint32_t matches = ctrl.match(tag); matches; matches &= matches - 1) {
+            const unsigned pos = base + countTrailingZeros64(matches);
+            if (_entries[pos].getCurHash() == key.hash() &&
+                Traits::equals(key.key(), Traits::toLookup(_entries[pos].getData().first))) {
+                return pos;
+            }
         }
 
-        if (_entries[pos].getCurHash() != key.hash()) {
-            // space has something else
-            continue;
+        if (firstEmpty && *firstEmpty == -1) {
+            if (uint32_t available = ctrl.matchEmptyOrDeleted()) {
+                *firstEmpty = base + countTrailingZeros64(available);
+            }
         }
 
-        if (!Traits::equals(key.key(), Traits::toLookup(_entries[pos].getData().first))) {
-            // hashes match
-            // strings are not equals
-            continue;
+        // The key would have been placed in this group if it had been inserted, so stop here.
+        if (ctrl.matchEmpty()) {
+            return -1;
         }
 
-        // hashes and strings are equal
-        // yay!
-        return pos;
-    } while (++probe < _maxProbe);
+        group = (group + probe) & groupMask();
+    }
     return -1;
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline bool UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) const {
-    for (auto&& entry : *this) {
-        if (!entry.isUsed())
-            continue;
+inline unsigned UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::findInsertSlot(
+    uint32_t hash) const {
+    using unordered_fast_key_table_detail::kGroupWidth;
+
+    unsigned group = firstGroup(hash);
+    for (unsigned probe = 1;; ++probe) {
+        const unsigned base = group * kGroupWidth;
+        if (uint32_t available = Group(&_ctrl[base]).matchEmptyOrDeleted()) {
+            return base + countTrailingZeros64(available);
+        }
 
-        int firstEmpty = -1;
-        int loc = newArea->find(
-            HashedKey(Traits::toLookup(entry.getData().first), entry.getCurHash()), &firstEmpty);
+        // An eighth of the slots are always empty, so this terminates.
+        dassert(probe <= groupMask());
+        group = (group + probe) & groupMask();
+    }
+}
 
-        verify(loc == -1);
-        if (firstEmpty < 0) {
-            return false;
-        }
+template <typename K_L, typename K_S, typename V, typename Traits>
+template <typename... Args>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::emplaceAt(unsigned pos,
+                                                                        const HashedKey& key,
+                                                                        Args&&... args) {
+    dassert(!isFull(pos));
+
+    _entries[pos].emplaceData(key, std::forward<Args>(args)...);
+    if (_ctrl[pos] == unordered_fast_key_table_detail::kEmpty) {
+        dassert(_growthLeft > 0);
+        --_growthLeft;
+    }
+    _ctrl[pos] = hashTag(key.hash());
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::eraseAt(unsigned pos) {
+    using unordered_fast_key_table_detail::kGroupWidth;
+
+    dassert(isFull(pos));
+    _entries[pos].destroyData();
+
+    // A group that still has an empty slot has never been full, so no probe has ever passed
+    // through it to a later group. Such a slot can go straight back to empty rather than leaving
+    // a deleted marker that lookups must probe past.
+    if (Group(&_ctrl[pos & ~(kGroupWidth - 1)]).matchEmpty()) {
+        _ctrl[pos] = unordered_fast_key_table_detail::kEmpty;
+        ++_growthLeft;
+    } else {
+        _ctrl[pos] = unordered_fast_key_table_detail::kDeleted;
+    }
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) const {
+    for (unsigned pos = 0; pos < capacity(); ++pos) {
+        if (!isFull(pos))
+            continue;
 
-        newArea->_entries[firstEmpty] = entry;
+        // The new area has no deleted slots, so every insert into it consumes an empty one.
+        const unsigned newPos = newArea->findInsertSlot(_entries[pos].getCurHash());
+        newArea->_entries[newPos].copyData(_entries[pos]);
+        newArea->_ctrl[newPos] = _ctrl[pos];
+        --newArea->_growthLeft;
     }
-    return true;
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -121,7 +169,7 @@ inline size_t UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const HashedKey&
         return 0;
 
     --_size;
-    _area._entries[pos].unUse();
+    _area.eraseAt(pos);
     return 1;
 }
 
@@ -131,7 +179,7 @@ void UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const_iterator it) {
     dassert(it._area == &_area);
 
     --_size;
-    _area._entries[it._position].unUse();
+    _area.eraseAt(it._position);
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -139,58 +187,51 @@ template <typename... Args>
 inline auto UnorderedFastKeyTable<K_L, K_S, V, Traits>::try_emplace(const HashedKey& key,
                                                                     Args&&... args)
     -> std::pair<iterator, bool> {
-    if (!_area._entries) {
+    if (!_area.capacity()) {
         // This is the first insert ever. Need to allocate initial space.
-        dassert(_area.capacity() == 0);
         _grow();
     }
 
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        int firstEmpty = -1;
-        int pos = _area.find(key, &firstEmpty);
-        if (pos >= 0) {
-            // This is only possible the first pass through the loop, since you're allocating space
-            // for a new element after that.
-            dassert(numGrowTries == 0);
-            return {iterator(&_area, pos), false};
-        }
-
-        // key not in map
-        // need to add
-        if (firstEmpty >= 0) {
-            _size++;
-            _area._entries[firstEmpty].emplaceData(key, std::forward<Args>(args)...);
-            return {iterator(&_area, firstEmpty), true};
-        }
+    int firstEmpty = -1;
+    int pos = _area.find(key, &firstEmpty);
+    if (pos >= 0) {
+        return {iterator(&_area, pos), false};
+    }
 
-        // no space left in map
+    // key not in map
+    // need to add
+    dassert(firstEmpty >= 0);
+    if (_area._growthLeft == 0 &&
+        _area._ctrl[firstEmpty] == unordered_fast_key_table_detail::kEmpty) {
+        // Reusing a deleted slot is always allowed, but filling another empty one is not.
         _grow();
+        firstEmpty = _area.findInsertSlot(key.hash());
     }
-    msgasserted(16471, "UnorderedFastKeyTable couldn't add entry after growing many times");
+
+    _area.emplaceAt(firstEmpty, key, std::forward<Args>(args)...);
+    _size++;
+    return {iterator(&_area, firstEmpty), true};
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
 inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::_grow() {
-    unsigned capacity = _area.capacity();
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        if (capacity == 0) {
-            const unsigned kDefaultStartingCapacity = 16;
-            capacity = kDefaultStartingCapacity;
-        } else {
-            capacity *= 2;
+    const unsigned capacity = _area.capacity();
+    unsigned newCapacity;
+    if (capacity == 0) {
+        const unsigned kDefaultStartingCapacity = 16;
+        newCapacity = kDefaultStartingCapacity;
+    } else if (_size >= capacity / 16 * 7) {
+        // At least half of the usable slots hold entries.
+        newCapacity = capacity * 2;
+        if (newCapacity == 0) {
+            msgasserted(16845, "UnorderedFastKeyTable::_grow couldn't grow past its maximum size");
         }
-
-        const double kMaxProbeRatio = 0.05;
-        unsigned maxProbes = (capacity * kMaxProbeRatio) + 1;  // Round up
-
-        Area newArea(capacity, maxProbes);
-        bool success = _area.transfer(&newArea);
-        if (!success) {
-            continue;
-        }
-        _area.swap(&newArea);
-        return;
+    } else {
+        newCapacity = capacity;
     }
-    msgasserted(16845, "UnorderedFastKeyTable::_grow couldn't add entry after growing many times");
+
+    Area newArea(newCapacity);
+    _area.transfer(&newArea);
+    _area.swap(&newArea);
 }
 }
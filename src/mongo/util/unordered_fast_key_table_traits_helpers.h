@@ -79,6 +79,57 @@ struct UnorderedFastKeyTableTraitsFactoryForPtrKey {
     using type = UnorderedFastKeyTable<Key*, Key, V, Traits>;
 };
 
+/**
+ * Like UnorderedFastKeyTableTraitsFactoryForPtrKey, but for small keys that are cheap to copy and
+ * are looked up by value. The Hasher must spread its output over all 32 bits, since the table
+ * picks groups from the high bits and compares the low 7 bits against its control bytes.
+ */
+template <typename Key, typename Hasher>
+struct UnorderedFastKeyTableTraitsFactoryForValueKey {
+    struct Traits {
+        static uint32_t hash(const Key& a) {
+            return Hasher()(a);
+        }
+
+        static bool equals(const Key& a, const Key& b) {
+            return a == b;
+        }
+
+        static Key toStorage(const Key& s) {
+            return s;
+        }
+
+        static const Key& toLookup(const Key& s) {
+            return s;
+        }
+
+        class HashedKey {
+        public:
+            explicit HashedKey(const Key& key = Key()) : _key(key), _hash(Traits::hash(_key)) {}
+
+            HashedKey(const Key& key, uint32_t hash) : _key(key), _hash(hash) {
+                // If you claim to know the hash, it better be correct.
+                dassert(_hash == Traits::hash(_key));
+            }
+
+            const Key& key() const {
+                return _key;
+            }
+
+            uint32_t hash() const {
+                return _hash;
+            }
+
+        private:
+            Key _key;
+            uint32_t _hash;
+        };
+    };
+
+    template <typename V>
+    using type = UnorderedFastKeyTable<Key, Key, V, Traits>;
+};
+
 /**
  * Provides a Hasher which forwards to an instance's .hash() method.  This should only be used with
  * high quality hashing functions because UnorderedFastKeyMap uses bit masks, rather than % by